@@ -40,7 +40,9 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 // Most of the work is done by this class.  It must be included first.
 #include "CardiacSimulation.hpp"
+#include "CardiacSimulationBatch.hpp"
 
+#include <cstdlib>
 #include <string>
 
 #include "ExecutableSupport.hpp"
@@ -53,11 +55,22 @@ int main(int argc, char *argv[])
 
     try
     {
-        if (argc<2)
+        if (argc<2 || (std::string(argv[1]) == "--batch" && (argc<3 || argc>4)))
         {
-            ExecutableSupport::PrintError("Usage: Chaste parameters_file", true);
+            ExecutableSupport::PrintError("Usage: Chaste parameters_file\n"
+                                          "   or: Chaste --batch manifest_file [num_concurrent_groups]", true);
             exit_code = ExecutableSupport::EXIT_BAD_ARGUMENTS;
         }
+        else if (std::string(argv[1]) == "--batch")
+        {
+            // Runs each parameters file listed in the manifest, sharing meshes between them
+            unsigned num_groups = (argc == 4) ? std::atoi(argv[3]) : 1u;
+            CardiacSimulationBatch batch(argv[2], num_groups, true);
+            if (batch.GetNumFailed() > 0u)
+            {
+                exit_code = ExecutableSupport::EXIT_ERROR;
+            }
+        }
         else
         {
             std::string xml_file_name(argv[1]);
@@ -73,6 +73,7 @@ int main(int argc, char *argv[])
 #else
             ExecutableSupport::Print("Note: VTK reading is not supported");
 #endif
+            ExecutableSupport::Print("Note: for Gmsh reading, give the full file path (including '.msh' extension); version 4.1 binary files are read in parallel");
 
             ExecutableSupport::Print("Opening "+base+" mesh file(s).");
 
@@ -91,6 +92,7 @@ int main(int argc, char *argv[])
             }
             base_for_output = base_for_output + "_bin";
             TrianglesMeshWriter<3,3> mesh_writer("", base_for_output);
+            // Binary output includes the node connectivity (.ncl) file, so that the converted mesh can be read in parallel
             ExecutableSupport::Print("Writing  " + base_for_output + ".node etc. mesh file in " + mesh_writer.GetOutputDirectory());
             mesh_writer.SetWriteFilesAsBinary();
             mesh_writer.WriteFilesUsingMesh(mesh);
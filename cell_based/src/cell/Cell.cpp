@@ -35,6 +35,9 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "Cell.hpp"
 
+#include <boost/make_shared.hpp>
+#include <boost/pool/pool_alloc.hpp>
+
 #include "ApoptoticCellProperty.hpp"
 #include "CellAncestor.hpp"
 #include "CellId.hpp"
@@ -157,17 +160,15 @@ void Cell::SetCellProliferativeType(boost::shared_ptr<AbstractCellProperty> pPro
 
 boost::shared_ptr<AbstractCellProliferativeType> Cell::GetCellProliferativeType()  const
 {
-    CellPropertyCollection proliferative_type_collection = mCellPropertyCollection.GetPropertiesType<AbstractCellProliferativeType>();
-
     /*
      * Note: In its current form the code requires each cell to have exactly
      * one proliferative type. This is reflected in the assertion below. If a user
      * wishes to include cells with multiple proliferative types, each possible
      * combination must be created as a separate proliferative type class.
      */
-    assert(proliferative_type_collection.GetSize() == 1);
+    assert(mCellPropertyCollection.GetPropertiesType<AbstractCellProliferativeType>().GetSize() == 1);
 
-    return boost::static_pointer_cast<AbstractCellProliferativeType>(proliferative_type_collection.GetProperty());
+    return mCellPropertyCollection.GetPropertyType<AbstractCellProliferativeType>();
 }
 
 void Cell::SetCellCycleModel(AbstractCellCycleModel* pCellCycleModel)
@@ -241,30 +242,26 @@ void Cell::SetMutationState(boost::shared_ptr<AbstractCellProperty> pMutationSta
 
 boost::shared_ptr<AbstractCellMutationState> Cell::GetMutationState() const
 {
-    CellPropertyCollection mutation_state_collection = mCellPropertyCollection.GetPropertiesType<AbstractCellMutationState>();
-
     /*
      * Note: In its current form the code requires each cell to have exactly
      * one mutation state. This is reflected in the assertion below. If a user
      * wishes to include cells with multiple mutation states, each possible
      * combination must be created as a separate mutation state class.
      */
-    assert(mutation_state_collection.GetSize() == 1);
+    assert(mCellPropertyCollection.GetPropertiesType<AbstractCellMutationState>().GetSize() == 1);
 
-    return boost::static_pointer_cast<AbstractCellMutationState>(mutation_state_collection.GetProperty());
+    return mCellPropertyCollection.GetPropertyType<AbstractCellMutationState>();
 }
 
 boost::shared_ptr<CellData> Cell::GetCellData() const
 {
-    CellPropertyCollection cell_data_collection = mCellPropertyCollection.GetPropertiesType<CellData>();
-
     /*
      * Note: In its current form the code requires each cell to have exactly
      * one CellData object. This is reflected in the assertion below.
      */
-    assert(cell_data_collection.GetSize() <= 1);
+    assert(mCellPropertyCollection.GetPropertiesType<CellData>().GetSize() == 1);
 
-    return boost::static_pointer_cast<CellData>(cell_data_collection.GetProperty());
+    return mCellPropertyCollection.GetPropertyType<CellData>();
 }
 
 bool Cell::HasCellVecData() const
@@ -276,15 +273,13 @@ boost::shared_ptr<CellVecData> Cell::GetCellVecData() const
 {
     assert(HasCellVecData());
 
-    CellPropertyCollection cell_data_collection = mCellPropertyCollection.GetPropertiesType<CellVecData>();
-
     /*
      * Note: In its current form the code requires each cell to have exactly
      * one CellVecData object. This is reflected in the assertion below.
      */
-    assert(cell_data_collection.GetSize() <= 1);
+    assert(mCellPropertyCollection.GetPropertiesType<CellVecData>().GetSize() == 1);
 
-    return boost::static_pointer_cast<CellVecData>(cell_data_collection.GetProperty());
+    return mCellPropertyCollection.GetPropertyType<CellVecData>();
 }
 
 CellPropertyCollection& Cell::rGetCellPropertyCollection()
@@ -417,26 +412,22 @@ void Cell::SetAncestor(boost::shared_ptr<AbstractCellProperty> pCellAncestor)
 
 unsigned Cell::GetAncestor() const
 {
-    CellPropertyCollection ancestor_collection = mCellPropertyCollection.GetPropertiesType<CellAncestor>();
+    assert(mCellPropertyCollection.GetPropertiesType<CellAncestor>().GetSize() <= 1);
 
-    assert(ancestor_collection.GetSize() <= 1);
-    if (ancestor_collection.GetSize() == 0)
+    boost::shared_ptr<CellAncestor> p_ancestor = mCellPropertyCollection.GetPropertyType<CellAncestor>();
+    if (!p_ancestor)
     {
         return UNSIGNED_UNSET;
     }
 
-    boost::shared_ptr<CellAncestor> p_ancestor = boost::static_pointer_cast<CellAncestor>(ancestor_collection.GetProperty());
-
     return p_ancestor->GetAncestor();
 }
 
 unsigned Cell::GetCellId() const
 {
-    CellPropertyCollection cell_id_collection = mCellPropertyCollection.GetPropertiesType<CellId>();
-
-    assert(cell_id_collection.GetSize() == 1);
+    assert(mCellPropertyCollection.GetPropertiesType<CellId>().GetSize() == 1);
 
-    boost::shared_ptr<CellId> p_cell_id = boost::static_pointer_cast<CellId>(cell_id_collection.GetProperty());
+    boost::shared_ptr<CellId> p_cell_id = mCellPropertyCollection.GetPropertyType<CellId>();
 
     return p_cell_id->GetCellId();
 }
@@ -481,8 +472,13 @@ CellPtr Cell::Divide()
     boost::shared_ptr<CellData> p_cell_data = GetCellData();
     daughter_property_collection.RemoveProperty(p_cell_data);
 
-    // Create a new cell data object using the copy constructor and add this to the daughter cell
-    MAKE_PTR_ARGS(CellData, p_daughter_cell_data, (*p_cell_data));
+    /*
+     * Create a new cell data object using the copy constructor and add this to the daughter cell.
+     * Cells and their cell data are created and destroyed at a high rate in proliferating
+     * populations, so they are allocated (together with their reference counts) from a pool.
+     * The memory is returned to the pool when the last pointer to the object goes away.
+     */
+    boost::shared_ptr<CellData> p_daughter_cell_data = boost::allocate_shared<CellData>(boost::fast_pool_allocator<CellData>(), *p_cell_data);
     daughter_property_collection.AddProperty(p_daughter_cell_data);
 
     // Copy all cell Vec data (note we create a new object not just copying the pointer)
@@ -498,7 +494,12 @@ CellPtr Cell::Divide()
     }
 
     // Create daughter cell with modified cell property collection
-    CellPtr p_new_cell(new Cell(GetMutationState(), mpCellCycleModel->CreateCellCycleModel(), mpSrnModel->CreateSrnModel(), false, daughter_property_collection));
+    CellPtr p_new_cell = boost::allocate_shared<Cell>(boost::fast_pool_allocator<Cell>(),
+                                                      GetMutationState(),
+                                                      mpCellCycleModel->CreateCellCycleModel(),
+                                                      mpSrnModel->CreateSrnModel(),
+                                                      false,
+                                                      daughter_property_collection);
 
     // Initialise properties of daughter cell
     p_new_cell->GetCellCycleModel()->InitialiseDaughterCell();
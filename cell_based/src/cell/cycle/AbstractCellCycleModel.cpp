@@ -108,6 +108,16 @@ unsigned AbstractCellCycleModel::GetDimension() const
     return mDimension;
 }
 
+bool AbstractCellCycleModel::CanPredictNextEventTime()
+{
+    return false;
+}
+
+double AbstractCellCycleModel::GetNextEventTime()
+{
+    return DOUBLE_UNSET;
+}
+
 bool AbstractCellCycleModel::CanCellTerminallyDifferentiate()
 {
     return true;
@@ -232,6 +232,25 @@ public:
      */
     virtual bool ReadyToDivide()=0;
 
+    /**
+     * @return whether this model can say in advance, through GetNextEventTime(),
+     * when ReadyToDivide() next needs to be called. If so, a simulation using a
+     * CellCycleEventQueue need not call ReadyToDivide() at every timestep.
+     *
+     * Defaults to false, so that the model is polled at every timestep. This is
+     * the correct choice for any model whose progress through the cell cycle
+     * depends on ODEs or on the cell's environment.
+     */
+    virtual bool CanPredictNextEventTime();
+
+    /**
+     * @return the earliest time at which a call to ReadyToDivide() may change
+     * the state of this model or return true, or DBL_MAX if this will never
+     * happen. Only called if CanPredictNextEventTime() returns true, so the
+     * default implementation simply returns DOUBLE_UNSET.
+     */
+    virtual double GetNextEventTime();
+
     /**
      * Each cell-cycle model must be able to be reset 'after' a cell division.
      *
@@ -34,7 +34,12 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "AbstractCellCycleModelOdeSolver.hpp"
+#include <typeinfo>
 #include "CvodeAdaptor.hpp"
+#include "EulerIvpOdeSolver.hpp"
+#include "HeunIvpOdeSolver.hpp"
+#include "RungeKutta2IvpOdeSolver.hpp"
+#include "RungeKutta4IvpOdeSolver.hpp"
 
 AbstractCellCycleModelOdeSolver::AbstractCellCycleModelOdeSolver()
     : mSizeOfOdeSystem(UNSIGNED_UNSET)
@@ -121,3 +126,29 @@ bool AbstractCellCycleModelOdeSolver::IsAdaptive()
 #endif //CHASTE_CVODE
     return adaptive;
 }
+
+boost::shared_ptr<AbstractIvpOdeSolver> AbstractCellCycleModelOdeSolver::CreateIndependentOdeSolver()
+{
+    assert(IsSetUp());
+    boost::shared_ptr<AbstractIvpOdeSolver> p_solver;
+
+    // Compare exact types, so that subclasses (such as MockEulerIvpOdeSolver) are not copied
+    const std::type_info& r_type = typeid(*mpOdeSolver);
+    if (r_type == typeid(EulerIvpOdeSolver))
+    {
+        p_solver.reset(new EulerIvpOdeSolver);
+    }
+    else if (r_type == typeid(HeunIvpOdeSolver))
+    {
+        p_solver.reset(new HeunIvpOdeSolver);
+    }
+    else if (r_type == typeid(RungeKutta2IvpOdeSolver))
+    {
+        p_solver.reset(new RungeKutta2IvpOdeSolver);
+    }
+    else if (r_type == typeid(RungeKutta4IvpOdeSolver))
+    {
+        p_solver.reset(new RungeKutta4IvpOdeSolver);
+    }
+    return p_solver;
+}
@@ -186,6 +186,20 @@ public:
      * The base class version just returns true iff the solver is the CvodeAdaptor class.
      */
     virtual bool IsAdaptive();
+
+    /**
+     * Create a new ODE solver of the same type as the one wrapped here, which
+     * does not share any working memory with it. This allows several models
+     * that use this (shared) solver to be solved at the same time by different
+     * threads, each using its own copy.
+     *
+     * Only the simple fixed-step solvers (forward Euler, Heun, second- and
+     * fourth-order Runge-Kutta) can be copied like this; for any other solver
+     * an empty pointer is returned.
+     *
+     * @return a new, independent ODE solver, or an empty pointer.
+     */
+    boost::shared_ptr<AbstractIvpOdeSolver> CreateIndependentOdeSolver();
 };
 
 #endif /*ABSTRACTCELLCYCLEMODELODESOLVER_HPP_*/
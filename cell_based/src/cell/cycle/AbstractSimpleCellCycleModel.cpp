@@ -85,6 +85,20 @@ bool AbstractSimpleCellCycleModel::ReadyToDivide()
     return mReadyToDivide;
 }
 
+bool AbstractSimpleCellCycleModel::CanPredictNextEventTime()
+{
+    return true;
+}
+
+double AbstractSimpleCellCycleModel::GetNextEventTime()
+{
+    if (mCellCycleDuration == DBL_MAX)
+    {
+        return DBL_MAX;
+    }
+    return mBirthTime + mCellCycleDuration;
+}
+
 void AbstractSimpleCellCycleModel::ResetForDivision()
 {
     AbstractCellCycleModel::ResetForDivision();
@@ -113,6 +113,21 @@ public:
      */
     virtual bool ReadyToDivide();
 
+    /**
+     * Overridden CanPredictNextEventTime() method.
+     *
+     * @return true, since the cell divides as soon as its age reaches mCellCycleDuration.
+     */
+    virtual bool CanPredictNextEventTime();
+
+    /**
+     * Overridden GetNextEventTime() method.
+     *
+     * @return the time at which the cell's age reaches mCellCycleDuration,
+     * or DBL_MAX if the cell cycle duration is infinite.
+     */
+    virtual double GetNextEventTime();
+
     /** See AbstractCellCycleModel::ResetForDivision() */
     virtual void ResetForDivision();
 
@@ -129,6 +129,41 @@ void AbstractSimplePhaseBasedCellCycleModel::UpdateCellCyclePhase()
     }
 }
 
+bool AbstractSimplePhaseBasedCellCycleModel::CanPredictNextEventTime()
+{
+    return true;
+}
+
+double AbstractSimplePhaseBasedCellCycleModel::GetNextEventTime()
+{
+    if (mpCell->GetCellProliferativeType()->IsType<DifferentiatedCellProliferativeType>())
+    {
+        // The phase is set to G0 the next time UpdateCellCyclePhase() is called
+        return (mCurrentCellCyclePhase == G_ZERO_PHASE) ? DBL_MAX : SimulationTime::Instance()->GetTime();
+    }
+
+    // These are the phase boundaries used in UpdateCellCyclePhase()
+    double time_since_birth = GetAge();
+    double boundary = GetMDuration();
+    if (time_since_birth < boundary)
+    {
+        return mBirthTime + boundary;
+    }
+    boundary += mG1Duration;
+    if (time_since_birth < boundary)
+    {
+        return mBirthTime + boundary;
+    }
+    boundary += GetSDuration();
+    if (time_since_birth < boundary)
+    {
+        return mBirthTime + boundary;
+    }
+
+    // This is the age at which ReadyToDivide() returns true
+    return mBirthTime + GetMDuration() + GetG1Duration() + GetSDuration() + GetG2Duration();
+}
+
 void AbstractSimplePhaseBasedCellCycleModel::OutputCellCycleModelParameters(out_stream& rParamsFile)
 {
     // No new parameters to output, so just call method on direct parent class
@@ -118,6 +118,28 @@ public:
      */
     virtual void UpdateCellCyclePhase();
 
+    /**
+     * Overridden CanPredictNextEventTime() method.
+     *
+     * Subclasses that override UpdateCellCyclePhase() so that the phase
+     * depends on anything other than the cell's age and proliferative type
+     * must override this method to return false.
+     *
+     * @return true
+     */
+    virtual bool CanPredictNextEventTime();
+
+    /**
+     * Overridden GetNextEventTime() method.
+     *
+     * @return the time at which the cell next enters a new phase or becomes
+     * ready to divide. A differentiated cell that is already in G0 phase has
+     * no further events, so DBL_MAX is returned; a change of proliferative
+     * type that is made outside the cell-cycle model is therefore only seen
+     * once this model is next asked whether it is ready to divide.
+     */
+    virtual double GetNextEventTime();
+
     /**
      * Set the new cell's G1 duration once it has been created after division.
      * The duration will be based on cell type.
@@ -0,0 +1,134 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#include "CellCycleEventQueue.hpp"
+#include <algorithm>
+#include <climits>
+#include "AbstractCellCycleModel.hpp"
+#include "ApoptoticCellProperty.hpp"
+#include "NullSrnModel.hpp"
+
+/**
+ * @param pA a cell
+ * @param pB another cell
+ * @return whether pA has a smaller cell identifier than pB
+ */
+static bool HasSmallerCellId(const CellPtr& pA, const CellPtr& pB)
+{
+    return pA->GetCellId() < pB->GetCellId();
+}
+
+CellCycleEventQueue::CellCycleEventQueue()
+    : mMaxCellId(UINT_MAX)
+{
+}
+
+void CellCycleEventQueue::Clear()
+{
+    mScheduledCells = std::priority_queue<ScheduledCell, std::vector<ScheduledCell>, LaterEventTime>();
+    mPolledCells.clear();
+    mMaxCellId = UINT_MAX;
+}
+
+void CellCycleEventQueue::AddCell(CellPtr pCell)
+{
+    if (pCell->IsDead() || pCell->HasApoptosisBegun() || pCell->HasCellProperty<ApoptoticCellProperty>())
+    {
+        // Cell::ReadyToDivide() always returns false for these cells
+        return;
+    }
+
+    AbstractCellCycleModel* p_model = pCell->GetCellCycleModel();
+    if (p_model->CanPredictNextEventTime() && dynamic_cast<NullSrnModel*>(pCell->GetSrnModel()) != nullptr)
+    {
+        double event_time = p_model->GetNextEventTime();
+        if (event_time < DBL_MAX)
+        {
+            mScheduledCells.push(ScheduledCell(event_time, pCell));
+        }
+    }
+    else
+    {
+        mPolledCells.push_back(pCell);
+    }
+}
+
+std::vector<CellPtr> CellCycleEventQueue::GetCellsToCheck(double time)
+{
+    std::vector<CellPtr> cells;
+    cells.reserve(mPolledCells.size());
+    for (std::vector<CellPtr>::iterator it = mPolledCells.begin(); it != mPolledCells.end(); ++it)
+    {
+        if (!(*it)->IsDead())
+        {
+            cells.push_back(*it);
+        }
+    }
+    mPolledCells.clear();
+
+    while (!mScheduledCells.empty() && mScheduledCells.top().first <= time)
+    {
+        CellPtr p_cell = mScheduledCells.top().second;
+        mScheduledCells.pop();
+        if (!p_cell->IsDead())
+        {
+            cells.push_back(p_cell);
+        }
+    }
+
+    std::sort(cells.begin(), cells.end(), HasSmallerCellId);
+    return cells;
+}
+
+unsigned CellCycleEventQueue::GetNumScheduledCells() const
+{
+    return mScheduledCells.size();
+}
+
+unsigned CellCycleEventQueue::GetNumPolledCells() const
+{
+    return mPolledCells.size();
+}
+
+void CellCycleEventQueue::SetMaxCellId(unsigned maxCellId)
+{
+    mMaxCellId = maxCellId;
+}
+
+unsigned CellCycleEventQueue::GetMaxCellId() const
+{
+    return mMaxCellId;
+}
@@ -0,0 +1,151 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef CELLCYCLEEVENTQUEUE_HPP_
+#define CELLCYCLEEVENTQUEUE_HPP_
+
+#include <queue>
+#include <utility>
+#include <vector>
+#include "Cell.hpp"
+
+/**
+ * A priority queue of cells, ordered by the time at which each cell next
+ * needs to be asked whether it is ready to divide.
+ *
+ * A cell is scheduled if its cell-cycle model can predict its next event
+ * time (see AbstractCellCycleModel::CanPredictNextEventTime()) and it has a
+ * NullSrnModel, since any other SRN model is advanced each time the cell is
+ * asked whether it is ready to divide. Cells with no further events, and
+ * apoptotic cells, are not stored at all. All other cells, for example those
+ * with ODE-based cell-cycle models, are polled at every timestep.
+ *
+ * Each cell returned by GetCellsToCheck() is removed from the queue, and
+ * should be added back once it has been checked (and any daughter added).
+ * Dead cells are dropped as they come due, so cells removed from a
+ * population need not be removed from the queue.
+ */
+class CellCycleEventQueue
+{
+private:
+
+    /** A cell, paired with the time at which it next needs to be checked. */
+    typedef std::pair<double, CellPtr> ScheduledCell;
+
+    /** Orders scheduled cells so that the earliest is at the top of the queue. */
+    struct LaterEventTime
+    {
+        /**
+         * @param rA a scheduled cell
+         * @param rB another scheduled cell
+         * @return whether rA is due after rB
+         */
+        bool operator()(const ScheduledCell& rA, const ScheduledCell& rB) const
+        {
+            return rA.first > rB.first;
+        }
+    };
+
+    /** The cells whose next event times are known. */
+    std::priority_queue<ScheduledCell, std::vector<ScheduledCell>, LaterEventTime> mScheduledCells;
+
+    /** The cells that must be checked at every timestep. */
+    std::vector<CellPtr> mPolledCells;
+
+    /**
+     * The maximum cell identifier (see CellId::GetMaxCellId()) at the time the
+     * queue was last brought up to date, or UINT_MAX if it has not been filled.
+     */
+    unsigned mMaxCellId;
+
+public:
+
+    /**
+     * Default constructor.
+     */
+    CellCycleEventQueue();
+
+    /**
+     * Remove all cells from the queue.
+     */
+    void Clear();
+
+    /**
+     * Add a cell to the queue, either at its next event time or to the list
+     * of cells that are polled at every timestep.
+     *
+     * @param pCell the cell
+     */
+    void AddCell(CellPtr pCell);
+
+    /**
+     * Remove and return every live cell that needs to be checked at the given
+     * time, that is, all polled cells and all scheduled cells whose next event
+     * time is no later than this time. The cells are sorted by cell identifier,
+     * so the order does not depend on how the queue was filled.
+     *
+     * @param time the current time
+     * @return the cells to check
+     */
+    std::vector<CellPtr> GetCellsToCheck(double time);
+
+    /**
+     * @return the number of scheduled cells (including any that have died since they were added).
+     */
+    unsigned GetNumScheduledCells() const;
+
+    /**
+     * @return the number of cells that are polled at every timestep.
+     */
+    unsigned GetNumPolledCells() const;
+
+    /**
+     * Record the maximum cell identifier when the queue was brought up to date.
+     * A cell created after this time, other than one added to the queue on
+     * division, shows that the queue needs to be refilled.
+     *
+     * @param maxCellId the maximum cell identifier
+     */
+    void SetMaxCellId(unsigned maxCellId);
+
+    /**
+     * @return the maximum cell identifier when the queue was last brought up
+     * to date, or UINT_MAX if it has been cleared since.
+     */
+    unsigned GetMaxCellId() const;
+};
+
+#endif /* CELLCYCLEEVENTQUEUE_HPP_ */
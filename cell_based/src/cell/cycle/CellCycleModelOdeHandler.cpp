@@ -120,6 +120,28 @@ bool CellCycleModelOdeHandler::SolveOdeToTime(double currentTime)
     return stopping_event_occurred;
 }
 
+bool CellCycleModelOdeHandler::SolveOdeToTime(double currentTime, AbstractIvpOdeSolver& rOdeSolver)
+{
+    bool stopping_event_occurred = false;
+    if (mLastTime < currentTime)
+    {
+        AdjustOdeParameters(currentTime);
+
+        rOdeSolver.SolveAndUpdateStateVariable(mpOdeSystem, mLastTime, currentTime, GetDt());
+
+        stopping_event_occurred = rOdeSolver.StoppingEventOccurred();
+        if (stopping_event_occurred)
+        {
+            mLastTime = rOdeSolver.GetStoppingTime();
+        }
+        else
+        {
+            mLastTime = currentTime;
+        }
+    }
+    return stopping_event_occurred;
+}
+
 void CellCycleModelOdeHandler::AdjustOdeParameters(double currentTime)
 {
 }
@@ -119,6 +119,17 @@ protected:
      */
     bool SolveOdeToTime(double currentTime);
 
+    /**
+     * Solves the ODE system to a given time using the given ODE solver, rather
+     * than the (possibly shared) solver in #mpOdeSolver.
+     *
+     * @param currentTime the current time
+     * @param rOdeSolver the ODE solver to use
+     *
+     * @return whether a stopping event occurred.
+     */
+    bool SolveOdeToTime(double currentTime, AbstractIvpOdeSolver& rOdeSolver);
+
     /**
      * Adjust any ODE parameters needed before solving until currentTime.
      * Defaults to do nothing.
@@ -138,6 +138,11 @@ void ContactInhibitionCellCycleModel::UpdateCellCyclePhase()
     }
 }
 
+bool ContactInhibitionCellCycleModel::CanPredictNextEventTime()
+{
+    return false;
+}
+
 AbstractCellCycleModel* ContactInhibitionCellCycleModel::CreateCellCycleModel()
 {
     return new ContactInhibitionCellCycleModel(*this);
@@ -125,6 +125,13 @@ public:
      */
     void UpdateCellCyclePhase();
 
+    /**
+     * Overridden CanPredictNextEventTime() method.
+     *
+     * @return false, since the length of G1 phase depends on the cell's volume.
+     */
+    bool CanPredictNextEventTime();
+
     /**
      * Overridden builder method to create new instances of
      * the cell-cycle model.
@@ -45,6 +45,16 @@ bool NoCellCycleModel::ReadyToDivide()
     return false;
 }
 
+bool NoCellCycleModel::CanPredictNextEventTime()
+{
+    return true;
+}
+
+double NoCellCycleModel::GetNextEventTime()
+{
+    return DBL_MAX;
+}
+
 // LCOV_EXCL_START
 AbstractCellCycleModel* NoCellCycleModel::CreateCellCycleModel()
 {
@@ -76,6 +76,20 @@ public:
      */
     bool ReadyToDivide();
 
+    /**
+     * Overridden CanPredictNextEventTime() method.
+     *
+     * @return true
+     */
+    bool CanPredictNextEventTime();
+
+    /**
+     * Overridden GetNextEventTime() method.
+     *
+     * @return DBL_MAX, since the cell never divides
+     */
+    double GetNextEventTime();
+
     /**
      * Overridden builder method to create new copies of
      * this cell-cycle model.
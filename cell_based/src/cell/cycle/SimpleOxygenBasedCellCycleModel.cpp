@@ -84,6 +84,11 @@ void SimpleOxygenBasedCellCycleModel::UpdateCellCyclePhase()
     }
 }
 
+bool SimpleOxygenBasedCellCycleModel::CanPredictNextEventTime()
+{
+    return false;
+}
+
 SimpleOxygenBasedCellCycleModel::SimpleOxygenBasedCellCycleModel(const SimpleOxygenBasedCellCycleModel& rModel)
    : AbstractSimplePhaseBasedCellCycleModel(rModel),
      mCurrentHypoxicDuration(rModel.mCurrentHypoxicDuration),
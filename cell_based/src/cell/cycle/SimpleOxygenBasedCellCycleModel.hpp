@@ -129,6 +129,13 @@ public:
      */
     void UpdateCellCyclePhase();
 
+    /**
+     * Overridden CanPredictNextEventTime() method.
+     *
+     * @return false, since the length of G1 phase and the hypoxic duration depend on the local oxygen concentration.
+     */
+    bool CanPredictNextEventTime();
+
     /**
      * Method for updating mCurrentHypoxicDuration,
      * called at the start of ReadyToDivide().
@@ -36,6 +36,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef ABSTRACTCELLPROPERTY_HPP_
 #define ABSTRACTCELLPROPERTY_HPP_
 
+#include <typeinfo>
 #include <boost/shared_ptr.hpp>
 #include "ChasteSerialization.hpp"
 #include "Identifiable.hpp"
@@ -84,18 +85,13 @@ public:
      * @return whether this property is a particular class.  This tests for exact
      * run-time class identity, and doesn't match subclasses.
      *
-     * The current implementation requires that all cell properties have a default
-     * constructor.  For this method to be efficient, the default constructor must
-     * also be cheap.
-     *
      * It should be called like:
      *   bool healthy = p_property->IsType<HealthyMutationState>();
      */
     template <class CLASS>
     bool IsType() const
     {
-        CLASS ref_obj;
-        return IsSame(&ref_obj);
+        return typeid(*this) == typeid(CLASS);
     }
 
     /**
@@ -35,29 +35,115 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "CellData.hpp"
 
+#include <algorithm>
+#include <deque>
+
 CellData::~CellData()
 {
 }
 
+/**
+ * @return the item names, indexed by item index. This is a function-local static
+ * so that it is constructed before it is first used, and a std::deque so that
+ * references to names remain valid as names are added.
+ */
+static std::deque<std::string>& rGetItemNames()
+{
+    static std::deque<std::string> s_item_names;
+    return s_item_names;
+}
+
+unsigned CellData::FindItemIndex(const std::string& rVariableName, bool create)
+{
+    static std::map<std::string, unsigned> s_item_indices;
+
+    unsigned index = UNSIGNED_UNSET;
+#ifdef CHASTE_OPENMP
+#pragma omp critical(chaste_cell_data_item_index)
+#endif // CHASTE_OPENMP
+    {
+        std::map<std::string, unsigned>::const_iterator it = s_item_indices.find(rVariableName);
+        if (it != s_item_indices.end())
+        {
+            index = it->second;
+        }
+        else if (create)
+        {
+            index = rGetItemNames().size();
+            rGetItemNames().push_back(rVariableName);
+            s_item_indices[rVariableName] = index;
+        }
+    }
+    return index;
+}
+
+unsigned CellData::GetItemIndex(const std::string& rVariableName)
+{
+    return FindItemIndex(rVariableName, true);
+}
+
+const std::string& CellData::GetItemName(unsigned itemIndex)
+{
+    const std::string* p_name;
+#ifdef CHASTE_OPENMP
+#pragma omp critical(chaste_cell_data_item_index)
+#endif // CHASTE_OPENMP
+    {
+        assert(itemIndex < rGetItemNames().size());
+        p_name = &(rGetItemNames()[itemIndex]);
+    }
+    return *p_name;
+}
+
+/**
+ * Comparison of an item in CellData with an item index, used to search the items.
+ *
+ * @param rItem an item
+ * @param itemIndex an item index
+ * @return whether the item comes before the item index
+ */
+static bool ItemIsBefore(const std::pair<unsigned, double>& rItem, unsigned itemIndex)
+{
+    return rItem.first < itemIndex;
+}
+
 void CellData::SetItem(const std::string& rVariableName, double data)
 {
-    mCellData[rVariableName] = data;
+    SetItem(GetItemIndex(rVariableName), data);
 }
 
 double CellData::GetItem(const std::string& rVariableName) const
 {
-    /*
-     * Note that mCellData[rVariableName] is not const. If rVariableName is not
-     * a key, then mCellData[rVariableName] will create a new item in the map
-     * and increase the size by one.  Using a const_iterator ensures that the
-     * map remains const.
-     */
-    std::map<std::string, double>::const_iterator it = mCellData.find(rVariableName);
-    if (it == mCellData.end())
+    // Don't assign an index to a name that has not been used, since it can't be stored
+    unsigned index = FindItemIndex(rVariableName, false);
+    if (index == UNSIGNED_UNSET)
     {
         EXCEPTION("The item " << rVariableName << " is not stored");
     }
-    return(it->second);
+    return GetItem(index);
+}
+
+void CellData::SetItem(unsigned itemIndex, double data)
+{
+    std::vector<std::pair<unsigned, double> >::iterator it = std::lower_bound(mCellData.begin(), mCellData.end(), itemIndex, ItemIsBefore);
+    if (it != mCellData.end() && it->first == itemIndex)
+    {
+        it->second = data;
+    }
+    else
+    {
+        mCellData.insert(it, std::make_pair(itemIndex, data));
+    }
+}
+
+double CellData::GetItem(unsigned itemIndex) const
+{
+    std::vector<std::pair<unsigned, double> >::const_iterator it = std::lower_bound(mCellData.begin(), mCellData.end(), itemIndex, ItemIsBefore);
+    if (it == mCellData.end() || it->first != itemIndex)
+    {
+        EXCEPTION("The item " << GetItemName(itemIndex) << " is not stored");
+    }
+    return it->second;
 }
 
 unsigned CellData::GetNumItems() const
@@ -68,12 +154,13 @@ unsigned CellData::GetNumItems() const
 std::vector<std::string> CellData::GetKeys() const
 {
     std::vector<std::string> keys;
-    for (std::map<std::string, double>::const_iterator it = mCellData.begin(); it != mCellData.end(); ++it)
+    for (unsigned i=0; i<mCellData.size(); i++)
     {
-        keys.push_back(it->first);
+        keys.push_back(GetItemName(mCellData[i].first));
     }
 
-    // From STL documentation we assume that the iterator is returning sorted keys sort(keys.begin(), keys.end());
+    // Sort the keys in lexicographical order, as they are stored in order of item index
+    std::sort(keys.begin(), keys.end());
     return keys;
 }
 
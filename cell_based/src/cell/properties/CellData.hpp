@@ -45,6 +45,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ChasteSerialization.hpp"
 #include <boost/serialization/base_object.hpp>
 #include <boost/serialization/map.hpp>
+#include <boost/serialization/split_member.hpp>
 #include "Exception.hpp"
 
 /**
@@ -56,31 +57,73 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  *
  * Within the Cell constructor, an empty CellData object is created and passed to the Cell
  * (unless there is already a CellData object present in mCellPropertyCollection).
+ *
+ * Each item name is interned: the first time a name is used it is given an integer
+ * item index, which is the same for every cell. Classes that access the same item
+ * for many cells, such as PDE modifiers and writers, can look up the index once
+ * using GetItemIndex() and then use the index-based GetItem() and SetItem() methods,
+ * avoiding a string comparison for each cell. Item indices are not archived, since
+ * they depend on the order in which names are first used.
  */
 class CellData : public AbstractCellProperty
 {
 private:
 
     /**
-     * The cell data.
+     * The cell data, as pairs of item index and value sorted by item index.
      */
-    std::map<std::string, double> mCellData;
+    std::vector<std::pair<unsigned, double> > mCellData;
 
     /** Needed for serialization. */
     friend class boost::serialization::access;
     /**
-     * Archive the member variables.
+     * Save the member variables. The items are archived by name, in the same
+     * format as a std::map from names to values.
      *
      * @param archive the archive
      * @param version the current version of this class
      */
     template <class Archive>
-    void serialize(Archive & archive, const unsigned int version)
+    void save(Archive & archive, const unsigned int version) const
     {
         archive & boost::serialization::base_object<AbstractCellProperty>(*this);
-        archive & mCellData;
+        std::map<std::string, double> cell_data;
+        for (unsigned i=0; i<mCellData.size(); i++)
+        {
+            cell_data[GetItemName(mCellData[i].first)] = mCellData[i].second;
+        }
+        archive & cell_data;
     }
 
+    /**
+     * Load the member variables.
+     *
+     * @param archive the archive
+     * @param version the current version of this class
+     */
+    template <class Archive>
+    void load(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<AbstractCellProperty>(*this);
+        std::map<std::string, double> cell_data;
+        archive & cell_data;
+        mCellData.clear();
+        for (std::map<std::string, double>::const_iterator it = cell_data.begin(); it != cell_data.end(); ++it)
+        {
+            SetItem(it->first, it->second);
+        }
+    }
+    BOOST_SERIALIZATION_SPLIT_MEMBER()
+
+    /**
+     * @return the index of the given item name, or UNSIGNED_UNSET if this name has
+     * not been used before.
+     *
+     * @param rVariableName the name of the item
+     * @param create whether to assign a new index to the name if it has not been used before
+     */
+    static unsigned FindItemIndex(const std::string& rVariableName, bool create);
+
 public:
 
     /**
@@ -105,6 +148,38 @@ public:
      */
     double GetItem(const std::string& rVariableName) const;
 
+    /**
+     * This assigns the cell data using an index from GetItemIndex().
+     *
+     * @param itemIndex the index of the data to be set.
+     * @param data the value to set it to.
+     */
+    void SetItem(unsigned itemIndex, double data);
+
+    /**
+     * @return data.
+     *
+     * @param itemIndex the index, from GetItemIndex(), of the data required.
+     * throws if the item has not been stored
+     */
+    double GetItem(unsigned itemIndex) const;
+
+    /**
+     * @return the index used to access the given item with the index-based GetItem()
+     * and SetItem() methods. This is the same for every CellData object, and a new
+     * index is assigned if the name has not been used before.
+     *
+     * @param rVariableName the name of the item.
+     */
+    static unsigned GetItemIndex(const std::string& rVariableName);
+
+    /**
+     * @return the name of the item with the given index.
+     *
+     * @param itemIndex the index of the item.
+     */
+    static const std::string& GetItemName(unsigned itemIndex);
+
     /**
      * @return number of data items
      */
@@ -35,9 +35,57 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "CellPropertyCollection.hpp"
 
+#include <map>
+#include <typeindex>
+
 CellPropertyCollection::CellPropertyCollection()
-    : mpCellPropertyRegistry(nullptr)
+    : mpCellPropertyRegistry(nullptr),
+      mPropertyTypeMask(0),
+      mHasUnmaskedPropertyTypes(false)
+{
+}
+
+unsigned CellPropertyCollection::GetPropertyTypeIndex(const std::type_info& rType)
+{
+    static std::map<std::type_index, unsigned> s_type_indices;
+
+    unsigned index;
+#ifdef CHASTE_OPENMP
+#pragma omp critical(chaste_cell_property_type_index)
+#endif // CHASTE_OPENMP
+    {
+        std::map<std::type_index, unsigned>::iterator it = s_type_indices.find(std::type_index(rType));
+        if (it == s_type_indices.end())
+        {
+            index = s_type_indices.size();
+            s_type_indices[std::type_index(rType)] = index;
+        }
+        else
+        {
+            index = it->second;
+        }
+    }
+    return index;
+}
+
+void CellPropertyCollection::UpdatePropertyTypeIndices()
 {
+    mPropertyTypeIndices.clear();
+    mPropertyTypeMask = 0;
+    mHasUnmaskedPropertyTypes = false;
+    for (ConstIteratorType it = mProperties.begin(); it != mProperties.end(); ++it)
+    {
+        unsigned index = GetPropertyTypeIndex(typeid(**it));
+        mPropertyTypeIndices.push_back(index);
+        if (index < NUM_MASKED_TYPES)
+        {
+            mPropertyTypeMask |= (TypeMaskType(1) << index);
+        }
+        else
+        {
+            mHasUnmaskedPropertyTypes = true;
+        }
+    }
 }
 
 CellPropertyRegistry* CellPropertyCollection::GetCellPropertyRegistry()
@@ -65,6 +113,7 @@ void CellPropertyCollection::AddProperty(const boost::shared_ptr<AbstractCellPro
         EXCEPTION("That property object is already in the collection.");
     }
     mProperties.insert(rProp);
+    UpdatePropertyTypeIndices();
 }
 
 bool CellPropertyCollection::HasProperty(const boost::shared_ptr<AbstractCellProperty>& rProp) const
@@ -82,6 +131,7 @@ void CellPropertyCollection::RemoveProperty(const boost::shared_ptr<AbstractCell
     else
     {
         mProperties.erase(it);
+        UpdatePropertyTypeIndices();
     }
 }
 
@@ -36,12 +36,17 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef CELLPROPERTYCOLLECTION_HPP_
 #define CELLPROPERTYCOLLECTION_HPP_
 
+#include <atomic>
 #include <set>
+#include <typeinfo>
+#include <vector>
+#include <boost/cstdint.hpp>
 #include <boost/shared_ptr.hpp>
 
 #include "ChasteSerialization.hpp"
 #include <boost/serialization/shared_ptr.hpp>
 #include <boost/serialization/set.hpp>
+#include <boost/serialization/split_member.hpp>
 
 #include "AbstractCellProperty.hpp"
 #include "CellPropertyRegistry.hpp"
@@ -51,6 +56,14 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  * Cell property collection class.
  *
  * Contains methods for accessing and interrogating a set of cell properties.
+ *
+ * Each property class is given a small integer type index the first time it is
+ * used, and the collection keeps a bitmask of the type indices of its properties.
+ * Checking whether the collection contains a property of a given class, or of a
+ * subclass of a given class, is then a constant-time bit test rather than a search
+ * with a run-time type check on each property. Only the first 64 property classes
+ * to be used can be looked up in this way; properties of any further classes are
+ * handled by searching the collection.
  */
 class CellPropertyCollection
 {
@@ -64,27 +77,141 @@ private:
     /** Type of an iterator over the container */
     typedef CollectionType::iterator IteratorType;
 
+    /** A bitmask of property type indices, as used by #mPropertyTypeMask. */
+    typedef boost::uint64_t TypeMaskType;
+
+    /** The number of property type indices that can be stored in a TypeMaskType. */
+    static const unsigned NUM_MASKED_TYPES = 64u;
+
     /** The properties stored in this collection. */
     CollectionType mProperties;
 
     /** Cell property registry. */
     CellPropertyRegistry* mpCellPropertyRegistry;
 
+    /**
+     * The type index of each property in #mProperties, in the same order.
+     * Not archived, since type indices may differ between runs; it is
+     * recomputed when the collection is loaded.
+     */
+    std::vector<unsigned> mPropertyTypeIndices;
+
+    /**
+     * Bit i is set if the collection contains a property whose class has
+     * type index i (for i < NUM_MASKED_TYPES).
+     */
+    TypeMaskType mPropertyTypeMask;
+
+    /** Whether the collection contains a property whose type index is too large for #mPropertyTypeMask. */
+    bool mHasUnmaskedPropertyTypes;
+
     /** Needed for serialization. */
     friend class boost::serialization::access;
     /**
-     * Save/load our member variables.
+     * Save our member variables.
      *
      * @param archive the archive
      * @param version the current version of this class
      */
     template <class Archive>
-    void serialize(Archive & archive, const unsigned int version)
+    void save(Archive & archive, const unsigned int version) const
     {
         archive & mProperties;
         // archive & mpCellPropertyRegistry; Not required as archived by the CellPopulation.
     }
 
+    /**
+     * Load our member variables.
+     *
+     * @param archive the archive
+     * @param version the current version of this class
+     */
+    template <class Archive>
+    void load(Archive & archive, const unsigned int version)
+    {
+        archive & mProperties;
+        UpdatePropertyTypeIndices();
+    }
+    BOOST_SERIALIZATION_SPLIT_MEMBER()
+
+    /**
+     * Recompute #mPropertyTypeIndices, #mPropertyTypeMask and #mHasUnmaskedPropertyTypes
+     * from #mProperties. This is called whenever the collection changes.
+     */
+    void UpdatePropertyTypeIndices();
+
+    /**
+     * @return the type index of the property class with the given type information,
+     * assigning a new one if this class has not been seen before.
+     *
+     * @param rType  the type information for the (most derived) property class
+     */
+    static unsigned GetPropertyTypeIndex(const std::type_info& rType);
+
+    /**
+     * @return the type index of the property class CLASS. This is looked up once
+     * for each class, and then stored.
+     */
+    template <typename CLASS>
+    static unsigned GetPropertyTypeIndex()
+    {
+        static const unsigned index = GetPropertyTypeIndex(typeid(CLASS));
+        return index;
+    }
+
+    /**
+     * @return a bitmask of those property classes stored in this collection that
+     * are BASECLASS or one of its subclasses (for type indices below NUM_MASKED_TYPES).
+     *
+     * Whether each class is a subclass of BASECLASS is only worked out the first
+     * time that a collection containing that class is asked about BASECLASS; the
+     * results are shared by all collections.
+     */
+    template <typename BASECLASS>
+    TypeMaskType GetSubTypeMask() const
+    {
+        static std::atomic<TypeMaskType> s_checked_types(0);
+        static std::atomic<TypeMaskType> s_sub_types(0);
+
+        TypeMaskType unchecked_types = mPropertyTypeMask & ~s_checked_types.load(std::memory_order_acquire);
+        if (unchecked_types != 0)
+        {
+            unsigned i = 0;
+            for (ConstIteratorType it = mProperties.begin(); it != mProperties.end(); ++it, ++i)
+            {
+                unsigned index = mPropertyTypeIndices[i];
+                if (index < NUM_MASKED_TYPES && (unchecked_types & (TypeMaskType(1) << index)))
+                {
+                    if ((*it)->IsSubType<BASECLASS>())
+                    {
+                        s_sub_types.fetch_or(TypeMaskType(1) << index, std::memory_order_relaxed);
+                    }
+                    s_checked_types.fetch_or(TypeMaskType(1) << index, std::memory_order_release);
+                }
+            }
+        }
+        return mPropertyTypeMask & s_sub_types.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @return whether the property at the given position in this collection is
+     * BASECLASS or one of its subclasses.
+     *
+     * @param it  an iterator pointing to the property
+     * @param position  the position of the property in the collection
+     * @param subTypeMask  the result of GetSubTypeMask<BASECLASS>()
+     */
+    template <typename BASECLASS>
+    bool IsSubType(ConstIteratorType it, unsigned position, TypeMaskType subTypeMask) const
+    {
+        unsigned index = mPropertyTypeIndices[position];
+        if (index < NUM_MASKED_TYPES)
+        {
+            return (subTypeMask & (TypeMaskType(1) << index)) != 0;
+        }
+        return (*it)->IsSubType<BASECLASS>();
+    }
+
 public:
     /**
      * Create an empty collection of cell properties.
@@ -126,9 +253,14 @@ public:
     template <typename CLASS>
     bool HasProperty() const
     {
-        for (ConstIteratorType it = mProperties.begin(); it != mProperties.end(); ++it)
+        unsigned index = GetPropertyTypeIndex<CLASS>();
+        if (index < NUM_MASKED_TYPES)
+        {
+            return (mPropertyTypeMask & (TypeMaskType(1) << index)) != 0;
+        }
+        for (unsigned i=0; i<mPropertyTypeIndices.size(); i++)
         {
-            if ((*it)->IsType<CLASS>())
+            if (mPropertyTypeIndices[i] == index)
             {
                 return true;
             }
@@ -145,11 +277,20 @@ public:
     template <typename BASECLASS>
     bool HasPropertyType() const
     {
-        for (ConstIteratorType it = mProperties.begin(); it != mProperties.end(); ++it)
+        TypeMaskType sub_type_mask = GetSubTypeMask<BASECLASS>();
+        if (sub_type_mask != 0)
+        {
+            return true;
+        }
+        if (mHasUnmaskedPropertyTypes)
         {
-            if ((*it)->IsSubType<BASECLASS>())
+            unsigned i = 0;
+            for (ConstIteratorType it = mProperties.begin(); it != mProperties.end(); ++it, ++i)
             {
-                return true;
+                if (IsSubType<BASECLASS>(it, i, sub_type_mask))
+                {
+                    return true;
+                }
             }
         }
         return false;
@@ -161,12 +302,18 @@ public:
     template <typename CLASS>
     void RemoveProperty()
     {
-        for (IteratorType it = mProperties.begin(); it != mProperties.end(); ++it)
+        if (HasProperty<CLASS>())
         {
-            if ((*it)->IsType<CLASS>())
+            unsigned index = GetPropertyTypeIndex<CLASS>();
+            unsigned i = 0;
+            for (IteratorType it = mProperties.begin(); it != mProperties.end(); ++it, ++i)
             {
-                mProperties.erase(it);
-                return;
+                if (mPropertyTypeIndices[i] == index)
+                {
+                    mProperties.erase(it);
+                    UpdatePropertyTypeIndices();
+                    return;
+                }
             }
         }
         EXCEPTION("Collection does not contain the given property type.");
@@ -214,11 +361,16 @@ public:
     CellPropertyCollection GetProperties() const
     {
         CellPropertyCollection result;
-        for (ConstIteratorType it = mProperties.begin(); it != mProperties.end(); ++it)
+        if (HasProperty<CLASS>())
         {
-            if ((*it)->IsType<CLASS>())
+            unsigned index = GetPropertyTypeIndex<CLASS>();
+            unsigned i = 0;
+            for (ConstIteratorType it = mProperties.begin(); it != mProperties.end(); ++it, ++i)
             {
-                result.AddProperty(*it);
+                if (mPropertyTypeIndices[i] == index)
+                {
+                    result.AddProperty(*it);
+                }
             }
         }
         return result;
@@ -232,15 +384,47 @@ public:
     CellPropertyCollection GetPropertiesType() const
     {
         CellPropertyCollection result;
-        for (ConstIteratorType it = mProperties.begin(); it != mProperties.end(); ++it)
+        TypeMaskType sub_type_mask = GetSubTypeMask<BASECLASS>();
+        if (sub_type_mask != 0 || mHasUnmaskedPropertyTypes)
         {
-            if ((*it)->IsSubType<BASECLASS>())
+            unsigned i = 0;
+            for (ConstIteratorType it = mProperties.begin(); it != mProperties.end(); ++it, ++i)
             {
-                result.AddProperty(*it);
+                if (IsSubType<BASECLASS>(it, i, sub_type_mask))
+                {
+                    result.AddProperty(*it);
+                }
             }
         }
         return result;
     }
+
+    /**
+     * @return the first of our properties that is an instance of the given class
+     * or any of its subclasses, or an empty pointer if there is none.
+     *
+     * Unlike GetPropertiesType(), this does not create a new collection, so is
+     * suitable for frequently accessed properties of which each cell has one,
+     * such as its CellData or mutation state. Should be used like
+     *   boost::shared_ptr<CellData> p_data = collection.GetPropertyType<CellData>();
+     */
+    template <typename BASECLASS>
+    boost::shared_ptr<BASECLASS> GetPropertyType() const
+    {
+        TypeMaskType sub_type_mask = GetSubTypeMask<BASECLASS>();
+        if (sub_type_mask != 0 || mHasUnmaskedPropertyTypes)
+        {
+            unsigned i = 0;
+            for (ConstIteratorType it = mProperties.begin(); it != mProperties.end(); ++it, ++i)
+            {
+                if (IsSubType<BASECLASS>(it, i, sub_type_mask))
+                {
+                    return boost::static_pointer_cast<BASECLASS>(*it);
+                }
+            }
+        }
+        return boost::shared_ptr<BASECLASS>();
+    }
 };
 
 #endif /* CELLPROPERTYCOLLECTION_HPP_ */
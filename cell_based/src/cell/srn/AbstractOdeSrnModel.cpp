@@ -94,6 +94,33 @@ void AbstractOdeSrnModel::SimulateToCurrentTime()
     SetSimulatedToTime(current_time);
 }
 
+bool AbstractOdeSrnModel::CanBeSimulatedInBatch()
+{
+    return false;
+}
+
+void AbstractOdeSrnModel::UpdateCouplingParameters()
+{
+}
+
+void AbstractOdeSrnModel::SimulateToCurrentTimeWithSolver(AbstractIvpOdeSolver& rOdeSolver)
+{
+    assert(mpOdeSystem != nullptr);
+    assert(SimulationTime::Instance()->IsStartTimeSetUp());
+
+    double current_time = SimulationTime::Instance()->GetTime();
+
+    // Run ODEs if needed
+    if (current_time > mLastTime && !this->mFinishedRunningOdes)
+    {
+        this->mFinishedRunningOdes = SolveOdeToTime(current_time, rOdeSolver);
+    }
+
+    // Update the SimulatedToTime value
+    mLastTime = current_time;
+    SetSimulatedToTime(current_time);
+}
+
 void AbstractOdeSrnModel::Initialise(AbstractOdeSystem* pOdeSystem)
 {
     assert(mpOdeSystem == nullptr);
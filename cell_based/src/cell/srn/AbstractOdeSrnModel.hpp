@@ -130,6 +130,35 @@ public:
      */
     virtual void SimulateToCurrentTime();
 
+    /**
+     * @return whether this model may be advanced by SrnModelBatchSimulator, that is
+     * whether SimulateToCurrentTime() is equivalent to calling UpdateCouplingParameters()
+     * followed by SimulateToCurrentTimeWithSolver().
+     *
+     * This defaults to false, since subclasses may override SimulateToCurrentTime().
+     */
+    virtual bool CanBeSimulatedInBatch();
+
+    /**
+     * Update any ODE parameters that depend on other cells, such as neighbouring
+     * levels of Delta, before the ODEs are solved. This is called serially for
+     * every model in a batch before any of them are solved.
+     *
+     * Defaults to do nothing.
+     */
+    virtual void UpdateCouplingParameters();
+
+    /**
+     * Solve the ODEs associated with the SRN up to the current time using the
+     * given ODE solver, rather than the solver shared by all models of this type.
+     * This allows different models to be solved at the same time on different
+     * threads, each with its own solver. Any coupling parameters must have been
+     * updated already.
+     *
+     * @param rOdeSolver the ODE solver to use
+     */
+    void SimulateToCurrentTimeWithSolver(AbstractIvpOdeSolver& rOdeSolver);
+
      /**
      * For a naturally cycling model this does not need to be overridden in the
      * subclasses. But most models should override this function and then
@@ -89,6 +89,16 @@ void DeltaNotchSrnModel::SimulateToCurrentTime()
     AbstractOdeSrnModel::SimulateToCurrentTime();
 }
 
+bool DeltaNotchSrnModel::CanBeSimulatedInBatch()
+{
+    return true;
+}
+
+void DeltaNotchSrnModel::UpdateCouplingParameters()
+{
+    UpdateDeltaNotch();
+}
+
 void DeltaNotchSrnModel::Initialise()
 {
     AbstractOdeSrnModel::Initialise(new DeltaNotchOdeSystem);
@@ -111,6 +111,18 @@ public:
      */
     void SimulateToCurrentTime();
 
+    /**
+     * Overridden CanBeSimulatedInBatch() method.
+     *
+     * @return true, since this model can be advanced by SrnModelBatchSimulator.
+     */
+    bool CanBeSimulatedInBatch();
+
+    /**
+     * Overridden UpdateCouplingParameters() method, which calls UpdateDeltaNotch().
+     */
+    void UpdateCouplingParameters();
+
     /**
      * Update the current levels of Delta and Notch in the cell.
      *
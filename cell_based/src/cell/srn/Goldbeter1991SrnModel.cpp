@@ -81,6 +81,11 @@ void Goldbeter1991SrnModel::SimulateToCurrentTime()
     AbstractOdeSrnModel::SimulateToCurrentTime();
 }
 
+bool Goldbeter1991SrnModel::CanBeSimulatedInBatch()
+{
+    return true;
+}
+
 void Goldbeter1991SrnModel::Initialise()
 {
     AbstractOdeSrnModel::Initialise(new Goldbeter1991OdeSystem);
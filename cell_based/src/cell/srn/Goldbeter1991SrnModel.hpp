@@ -112,6 +112,13 @@ public:
      */
     void SimulateToCurrentTime();
 
+    /**
+     * Overridden CanBeSimulatedInBatch() method.
+     *
+     * @return true, since this model can be advanced by SrnModelBatchSimulator.
+     */
+    bool CanBeSimulatedInBatch();
+
     /**
      * Output SRN model parameters to file.
      *
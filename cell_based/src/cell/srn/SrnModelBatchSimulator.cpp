@@ -0,0 +1,150 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "SrnModelBatchSimulator.hpp"
+#include <algorithm>
+#include <map>
+#include "Exception.hpp"
+#include "OpenMpExceptionCollector.hpp"
+
+SrnModelBatchSimulator::SrnModelBatchSimulator()
+    : mNumThreads(1u),
+      mBlockSize(32u)
+{
+}
+
+void SrnModelBatchSimulator::SetNumberOfThreads(unsigned numThreads)
+{
+    if (numThreads == 0u)
+    {
+        EXCEPTION("The number of SRN model threads must be at least one.");
+    }
+    mNumThreads = numThreads;
+}
+
+unsigned SrnModelBatchSimulator::GetNumberOfThreads() const
+{
+    return mNumThreads;
+}
+
+void SrnModelBatchSimulator::SetBlockSize(unsigned blockSize)
+{
+    if (blockSize == 0u)
+    {
+        EXCEPTION("The SRN model block size must be at least one.");
+    }
+    mBlockSize = blockSize;
+}
+
+unsigned SrnModelBatchSimulator::GetBlockSize() const
+{
+    return mBlockSize;
+}
+
+void SrnModelBatchSimulator::SimulateToCurrentTime(const std::list<CellPtr>& rCells)
+{
+    /*
+     * Update the coupling parameters of all the batched models first, and group
+     * them by the solver they share. Any other models are simulated straight away,
+     * in the order in which they are given.
+     */
+    std::vector<AbstractCellCycleModelOdeSolver*> solvers;
+    std::map<AbstractCellCycleModelOdeSolver*, std::vector<AbstractOdeSrnModel*> > models_using_solver;
+    for (std::list<CellPtr>::const_iterator cell_iter = rCells.begin();
+         cell_iter != rCells.end();
+         ++cell_iter)
+    {
+        AbstractSrnModel* p_srn_model = (*cell_iter)->GetSrnModel();
+        AbstractOdeSrnModel* p_ode_srn_model = dynamic_cast<AbstractOdeSrnModel*>(p_srn_model);
+        if (p_ode_srn_model != nullptr && p_ode_srn_model->CanBeSimulatedInBatch())
+        {
+            AbstractCellCycleModelOdeSolver* p_solver = p_ode_srn_model->GetOdeSolver().get();
+            if (models_using_solver.find(p_solver) == models_using_solver.end())
+            {
+                solvers.push_back(p_solver);
+            }
+            p_ode_srn_model->UpdateCouplingParameters();
+            models_using_solver[p_solver].push_back(p_ode_srn_model);
+        }
+        else
+        {
+            p_srn_model->SimulateToCurrentTime();
+        }
+    }
+
+    for (unsigned solver_index=0; solver_index<solvers.size(); solver_index++)
+    {
+        AbstractCellCycleModelOdeSolver* p_solver = solvers[solver_index];
+        const std::vector<AbstractOdeSrnModel*>& r_models = models_using_solver[p_solver];
+
+        // Fall back to the shared solver if it cannot be copied
+        if (!p_solver->CreateIndependentOdeSolver())
+        {
+            for (unsigned i=0; i<r_models.size(); i++)
+            {
+                r_models[i]->SimulateToCurrentTime();
+            }
+            continue;
+        }
+
+        /*
+         * Each block of models is solved with its own copy of the solver, since
+         * the solvers hold working memory. The first exception thrown by any
+         * block is re-thrown once all have finished.
+         */
+        const int num_blocks = static_cast<int>((r_models.size() + mBlockSize - 1)/mBlockSize);
+        OpenMpExceptionCollector exception_collector;
+#ifdef CHASTE_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mNumThreads)
+#endif // CHASTE_OPENMP
+        for (int block=0; block<num_blocks; block++)
+        {
+            try
+            {
+                boost::shared_ptr<AbstractIvpOdeSolver> p_block_solver = p_solver->CreateIndependentOdeSolver();
+                unsigned block_end = std::min(static_cast<unsigned>(r_models.size()), (block + 1)*mBlockSize);
+                for (unsigned i=block*mBlockSize; i<block_end; i++)
+                {
+                    r_models[i]->SimulateToCurrentTimeWithSolver(*p_block_solver);
+                }
+            }
+            catch (...)
+            {
+                exception_collector.Capture();
+            }
+        }
+        exception_collector.RethrowIfAny();
+    }
+}
@@ -0,0 +1,114 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef SRNMODELBATCHSIMULATOR_HPP_
+#define SRNMODELBATCHSIMULATOR_HPP_
+
+#include <list>
+#include <vector>
+#include "Cell.hpp"
+#include "AbstractOdeSrnModel.hpp"
+
+/**
+ * A helper class that advances the ODE-based SRN models of a whole population
+ * of cells to the current time in one pass, rather than one at a time as each
+ * cell is asked whether it is ready to divide.
+ *
+ * The coupling parameters of every model (for example the mean level of Delta
+ * in neighbouring cells, for DeltaNotchSrnModel) are first updated serially,
+ * so all the ODE systems see the same snapshot of the population. The models
+ * are then grouped by the ODE solver they share, and each group is split into
+ * blocks which are solved independently, each block using its own copy of the
+ * solver. If Chaste was built with OpenMP (Chaste_USE_OPENMP) the blocks are
+ * shared out between threads.
+ *
+ * Only models whose CanBeSimulatedInBatch() method returns true, and whose
+ * solver can be copied by AbstractCellCycleModelOdeSolver::CreateIndependentOdeSolver(),
+ * are solved in blocks; all other SRN models are simply asked to simulate
+ * themselves to the current time, in order. Each model's ODEs are solved
+ * exactly as they would be otherwise, so the results do not depend on whether
+ * this class is used, or on the number of threads.
+ */
+class SrnModelBatchSimulator
+{
+private:
+
+    /** The number of threads used to solve the ODEs. Defaults to 1. */
+    unsigned mNumThreads;
+
+    /** The number of models in each block solved by a single thread. Defaults to 32. */
+    unsigned mBlockSize;
+
+public:
+
+    /**
+     * Default constructor.
+     */
+    SrnModelBatchSimulator();
+
+    /**
+     * Set the number of threads used to solve the ODEs. This is ignored unless
+     * Chaste was built with OpenMP support.
+     *
+     * @param numThreads the number of threads (at least 1)
+     */
+    void SetNumberOfThreads(unsigned numThreads);
+
+    /**
+     * @return the number of threads used to solve the ODEs.
+     */
+    unsigned GetNumberOfThreads() const;
+
+    /**
+     * Set the number of models in each block solved by a single thread.
+     *
+     * @param blockSize the block size (at least 1)
+     */
+    void SetBlockSize(unsigned blockSize);
+
+    /**
+     * @return the number of models in each block solved by a single thread.
+     */
+    unsigned GetBlockSize() const;
+
+    /**
+     * Simulate the SRN model of each of the given cells to the current time.
+     *
+     * @param rCells the cells whose SRN models are to be simulated
+     */
+    void SimulateToCurrentTime(const std::list<CellPtr>& rCells);
+};
+
+#endif /* SRNMODELBATCHSIMULATOR_HPP_ */
@@ -36,6 +36,9 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "AbstractBoxDomainPdeModifier.hpp"
 #include "ReplicatableVector.hpp"
 #include "LinearBasisFunction.hpp"
+#include "BoxDomainMultigridSolver.hpp"
+#include <algorithm>
+#include <cmath>
 
 template <unsigned DIM>
 AbstractBoxDomainPdeModifier<DIM>::AbstractBoxDomainPdeModifier(boost::shared_ptr<AbstractLinearPde<DIM,DIM> > pPde,
@@ -50,7 +53,8 @@ AbstractBoxDomainPdeModifier<DIM>::AbstractBoxDomainPdeModifier(boost::shared_pt
                                solution),
       mpMeshCuboid(pMeshCuboid),
       mStepSize(stepSize),
-      mSetBcsOnBoxBoundary(true)
+      mSetBcsOnBoxBoundary(true),
+      mUseMultigridSolver(false)
 {
     if (pMeshCuboid)
     {
@@ -83,6 +87,18 @@ bool AbstractBoxDomainPdeModifier<DIM>::AreBcsSetOnBoxBoundary()
     return mSetBcsOnBoxBoundary;
 }
 
+template <unsigned DIM>
+void AbstractBoxDomainPdeModifier<DIM>::SetUseMultigridSolver(bool useMultigridSolver)
+{
+    mUseMultigridSolver = useMultigridSolver;
+}
+
+template <unsigned DIM>
+bool AbstractBoxDomainPdeModifier<DIM>::GetUseMultigridSolver() const
+{
+    return mUseMultigridSolver;
+}
+
 template <unsigned DIM>
 void AbstractBoxDomainPdeModifier<DIM>::SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory)
 {
@@ -111,6 +127,9 @@ void AbstractBoxDomainPdeModifier<DIM>::GenerateFeMesh(boost::shared_ptr<ChasteC
             NEVER_REACHED;
     }
 
+    // The mesh does not move, so whole-mesh point location can use the spatial search structures
+    this->mpFeMesh->SetUseSpatialSearch();
+
     // Get centroid of meshCuboid
     ChastePoint<DIM> upper = pMeshCuboid->rGetUpperCorner();
     ChastePoint<DIM> lower = pMeshCuboid->rGetLowerCorner();
@@ -126,6 +145,9 @@ void AbstractBoxDomainPdeModifier<DIM>::GenerateFeMesh(boost::shared_ptr<ChasteC
 
     // Now move the mesh to the correct location
     this->mpFeMesh->Translate(centre_of_cuboid - centre_of_coarse_mesh);
+
+    // The element locator is rebuilt for the new mesh when next needed
+    mElementsInGridCell.clear();
 }
 
 template <unsigned DIM>
@@ -134,6 +156,13 @@ void AbstractBoxDomainPdeModifier<DIM>::UpdateCellData(AbstractCellPopulation<DI
     // Store the PDE solution in an accessible form
     ReplicatableVector solution_repl(this->mSolution);
 
+    // Look up the CellData items once, rather than by name for each cell
+    unsigned solution_item_index = CellData::GetItemIndex(this->mDependentVariableName);
+    c_vector<unsigned, 3> gradient_item_indices;
+    gradient_item_indices[0] = CellData::GetItemIndex(this->mDependentVariableName + "_grad_x");
+    gradient_item_indices[1] = CellData::GetItemIndex(this->mDependentVariableName + "_grad_y");
+    gradient_item_indices[2] = CellData::GetItemIndex(this->mDependentVariableName + "_grad_z");
+
     for (typename AbstractCellPopulation<DIM>::Iterator cell_iter = rCellPopulation.Begin();
          cell_iter != rCellPopulation.End();
          ++cell_iter)
@@ -155,7 +184,7 @@ void AbstractBoxDomainPdeModifier<DIM>::UpdateCellData(AbstractCellPopulation<DI
             solution_at_cell += nodal_value * weights(i);
         }
 
-        cell_iter->GetCellData()->SetItem(this->mDependentVariableName, solution_at_cell);
+        cell_iter->GetCellData()->SetItem(solution_item_index, solution_at_cell);
 
         if (this->mOutputGradient)
         {
@@ -183,16 +212,16 @@ void AbstractBoxDomainPdeModifier<DIM>::UpdateCellData(AbstractCellPopulation<DI
             switch (DIM)
             {
                 case 1:
-                    cell_iter->GetCellData()->SetItem(this->mDependentVariableName+"_grad_x", solution_gradient(0));
+                    cell_iter->GetCellData()->SetItem(gradient_item_indices[0], solution_gradient(0));
                     break;
                 case 2:
-                    cell_iter->GetCellData()->SetItem(this->mDependentVariableName+"_grad_x", solution_gradient(0));
-                    cell_iter->GetCellData()->SetItem(this->mDependentVariableName+"_grad_y", solution_gradient(1));
+                    cell_iter->GetCellData()->SetItem(gradient_item_indices[0], solution_gradient(0));
+                    cell_iter->GetCellData()->SetItem(gradient_item_indices[1], solution_gradient(1));
                     break;
                 case 3:
-                    cell_iter->GetCellData()->SetItem(this->mDependentVariableName+"_grad_x", solution_gradient(0));
-                    cell_iter->GetCellData()->SetItem(this->mDependentVariableName+"_grad_y", solution_gradient(1));
-                    cell_iter->GetCellData()->SetItem(this->mDependentVariableName+"_grad_z", solution_gradient(2));
+                    cell_iter->GetCellData()->SetItem(gradient_item_indices[0], solution_gradient(0));
+                    cell_iter->GetCellData()->SetItem(gradient_item_indices[1], solution_gradient(1));
+                    cell_iter->GetCellData()->SetItem(gradient_item_indices[2], solution_gradient(2));
                     break;
                 default:
                     NEVER_REACHED;
@@ -212,7 +241,7 @@ void AbstractBoxDomainPdeModifier<DIM>::InitialiseCellPdeElementMap(AbstractCell
          ++cell_iter)
     {
         const ChastePoint<DIM>& r_position_of_cell = rCellPopulation.GetLocationOfCellCentre(*cell_iter);
-        unsigned elem_index = this->mpFeMesh->GetContainingElementIndex(r_position_of_cell);
+        unsigned elem_index = GetContainingElementIndex(r_position_of_cell);
         mCellPdeElementMap[*cell_iter] = elem_index;
     }
 }
@@ -226,11 +255,199 @@ void AbstractBoxDomainPdeModifier<DIM>::UpdateCellPdeElementMap(AbstractCellPopu
          ++cell_iter)
     {
         const ChastePoint<DIM>& r_position_of_cell = rCellPopulation.GetLocationOfCellCentre(*cell_iter);
-        unsigned elem_index = this->mpFeMesh->GetContainingElementIndexWithInitialGuess(r_position_of_cell, mCellPdeElementMap[*cell_iter]);
+        unsigned elem_index = GetContainingElementIndex(r_position_of_cell, mCellPdeElementMap[*cell_iter]);
         mCellPdeElementMap[*cell_iter] = elem_index;
     }
 }
 
+template <unsigned DIM>
+void AbstractBoxDomainPdeModifier<DIM>::SetUpElementLocator()
+{
+    // Find the extent of the mesh
+    c_vector<double,DIM> upper = this->mpFeMesh->GetNode(0)->rGetLocation();
+    mGridLowerCorner = upper;
+    for (unsigned i=1; i<this->mpFeMesh->GetNumNodes(); i++)
+    {
+        const c_vector<double,DIM>& r_location = this->mpFeMesh->GetNode(i)->rGetLocation();
+        for (unsigned d=0; d<DIM; d++)
+        {
+            mGridLowerCorner[d] = std::min(mGridLowerCorner[d], r_location[d]);
+            upper[d] = std::max(upper[d], r_location[d]);
+        }
+    }
+
+    unsigned num_grid_cells = 1;
+    for (unsigned d=0; d<DIM; d++)
+    {
+        mNumGridCells[d] = std::max(1u, (unsigned)floor((upper[d] - mGridLowerCorner[d])/mStepSize + 0.5));
+        num_grid_cells *= mNumGridCells[d];
+    }
+
+    // Bin each element by its centroid; each element of the regular mesh lies inside a single grid cell
+    mElementsInGridCell.assign(num_grid_cells, std::vector<unsigned>());
+    for (unsigned elem_index=0; elem_index<this->mpFeMesh->GetNumElements(); elem_index++)
+    {
+        c_vector<double,DIM> centroid = this->mpFeMesh->GetElement(elem_index)->CalculateCentroid();
+        unsigned grid_index = 0;
+        unsigned stride = 1;
+        for (unsigned d=0; d<DIM; d++)
+        {
+            int cell_index = (int)floor((centroid[d] - mGridLowerCorner[d])/mStepSize);
+            cell_index = std::max(0, std::min((int)mNumGridCells[d] - 1, cell_index));
+            grid_index += cell_index*stride;
+            stride *= mNumGridCells[d];
+        }
+        mElementsInGridCell[grid_index].push_back(elem_index);
+    }
+}
+
+template <unsigned DIM>
+unsigned AbstractBoxDomainPdeModifier<DIM>::GetContainingElementIndex(const ChastePoint<DIM>& rPoint, unsigned elementGuess)
+{
+    // Cells move only a short distance per time step, so usually remain in the same element
+    if (elementGuess != UNSIGNED_UNSET && this->mpFeMesh->GetElement(elementGuess)->IncludesPoint(rPoint))
+    {
+        return elementGuess;
+    }
+
+    if (mElementsInGridCell.empty())
+    {
+        SetUpElementLocator();
+    }
+
+    // Otherwise look up the candidate elements in the grid cell containing the point
+    unsigned grid_index = 0;
+    unsigned stride = 1;
+    for (unsigned d=0; d<DIM; d++)
+    {
+        int cell_index = (int)floor((rPoint[d] - mGridLowerCorner[d])/mStepSize);
+        cell_index = std::max(0, std::min((int)mNumGridCells[d] - 1, cell_index));
+        grid_index += cell_index*stride;
+        stride *= mNumGridCells[d];
+    }
+    const std::vector<unsigned>& r_candidates = mElementsInGridCell[grid_index];
+    for (unsigned i=0; i<r_candidates.size(); i++)
+    {
+        if (this->mpFeMesh->GetElement(r_candidates[i])->IncludesPoint(rPoint))
+        {
+            return r_candidates[i];
+        }
+    }
+
+    // Fall back to searching the whole mesh, which throws if the point is not in the mesh
+    if (elementGuess != UNSIGNED_UNSET)
+    {
+        return this->mpFeMesh->GetContainingElementIndexWithInitialGuess(rPoint, elementGuess);
+    }
+    return this->mpFeMesh->GetContainingElementIndex(rPoint);
+}
+
+template <unsigned DIM>
+Vec AbstractBoxDomainPdeModifier<DIM>::SolveUsingMultigridSolver(double diffusionCoefficient,
+                                                                 const std::vector<double>& rReactionCoefficients,
+                                                                 const std::vector<double>& rSourceTerms)
+{
+    unsigned num_nodes = this->mpFeMesh->GetNumNodes();
+    assert(rReactionCoefficients.size() == num_nodes);
+    assert(rSourceTerms.size() == num_nodes);
+
+    // Find the extent of the regular FE mesh, and hence the dimensions of the structured grid
+    c_vector<double,DIM> lower = this->mpFeMesh->GetNode(0)->rGetLocation();
+    c_vector<double,DIM> upper = lower;
+    for (unsigned i=1; i<num_nodes; i++)
+    {
+        const c_vector<double,DIM>& r_location = this->mpFeMesh->GetNode(i)->rGetLocation();
+        for (unsigned d=0; d<DIM; d++)
+        {
+            lower[d] = std::min(lower[d], r_location[d]);
+            upper[d] = std::max(upper[d], r_location[d]);
+        }
+    }
+    c_vector<unsigned,DIM> num_grid_nodes;
+    c_vector<unsigned,DIM> strides;
+    unsigned num_grid_nodes_so_far = 1;
+    for (unsigned d=0; d<DIM; d++)
+    {
+        num_grid_nodes[d] = (unsigned)floor((upper[d] - lower[d])/mStepSize + 0.5) + 1;
+        strides[d] = num_grid_nodes_so_far;
+        num_grid_nodes_so_far *= num_grid_nodes[d];
+    }
+
+    BoxDomainMultigridSolver<DIM> solver(num_grid_nodes, mStepSize);
+    assert(solver.GetNumNodes() == num_nodes);
+    solver.SetDiffusionCoefficient(diffusionCoefficient);
+    solver.SetUseNeumannBoundaryConditions(this->IsNeumannBoundaryCondition());
+
+    // Copy the nodal data onto the grid
+    bool has_initial_guess = (this->mSolution != nullptr);
+    ReplicatableVector initial_guess_repl;
+    if (has_initial_guess)
+    {
+        initial_guess_repl.ReplicatePetscVector(this->mSolution);
+    }
+
+    std::vector<unsigned> grid_indices(num_nodes);
+    std::vector<double> reaction_coefficients(num_nodes);
+    std::vector<double> source_terms(num_nodes);
+    std::vector<double> boundary_values(num_nodes, 0.0);
+    std::vector<double> initial_guess(has_initial_guess ? num_nodes : 0);
+    for (unsigned i=0; i<num_nodes; i++)
+    {
+        const c_vector<double,DIM>& r_location = this->mpFeMesh->GetNode(i)->rGetLocation();
+        unsigned grid_index = 0;
+        for (unsigned d=0; d<DIM; d++)
+        {
+            grid_index += (unsigned)floor((r_location[d] - lower[d])/mStepSize + 0.5)*strides[d];
+        }
+        grid_indices[i] = grid_index;
+
+        reaction_coefficients[grid_index] = rReactionCoefficients[i];
+        source_terms[grid_index] = rSourceTerms[i];
+        if (solver.IsBoundaryNode(grid_index))
+        {
+            boundary_values[grid_index] = this->mpBoundaryCondition->GetValue(ChastePoint<DIM>(r_location));
+        }
+        if (has_initial_guess)
+        {
+            initial_guess[grid_index] = initial_guess_repl[i];
+        }
+    }
+
+    solver.SetReactionCoefficients(reaction_coefficients);
+    std::vector<double> grid_solution = solver.Solve(source_terms, boundary_values, initial_guess);
+
+    std::vector<double> solution(num_nodes);
+    for (unsigned i=0; i<num_nodes; i++)
+    {
+        solution[i] = grid_solution[grid_indices[i]];
+    }
+    return PetscTools::CreateVec(solution);
+}
+
+template <unsigned DIM>
+bool AbstractBoxDomainPdeModifier<DIM>::IsIsotropicDiffusionTerm(const c_matrix<double,DIM,DIM>& rDiffusionTerm, double& rDiffusionCoefficient) const
+{
+    double coefficient = rDiffusionTerm(0,0);
+    double tolerance = 1e-12*fabs(coefficient);
+    for (unsigned i=0; i<DIM; i++)
+    {
+        for (unsigned j=0; j<DIM; j++)
+        {
+            double expected = (i == j) ? coefficient : 0.0;
+            if (fabs(rDiffusionTerm(i,j) - expected) > tolerance)
+            {
+                return false;
+            }
+        }
+    }
+
+    if (rDiffusionCoefficient < 0.0)
+    {
+        rDiffusionCoefficient = coefficient;
+    }
+    return (coefficient > 0.0 && fabs(coefficient - rDiffusionCoefficient) <= tolerance);
+}
+
 template <unsigned DIM>
 void AbstractBoxDomainPdeModifier<DIM>::OutputSimulationModifierParameters(out_stream& rParamsFile)
 {
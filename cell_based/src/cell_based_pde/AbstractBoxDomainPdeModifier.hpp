@@ -96,6 +96,70 @@ protected:
      */
     bool mSetBcsOnBoxBoundary;
 
+    /**
+     * Whether to solve the PDE using BoxDomainMultigridSolver, rather than the finite element
+     * solver, whenever the PDE is of a form that it can handle. Defaults to false.
+     * This is a run-time option, so is not archived.
+     */
+    bool mUseMultigridSolver;
+
+    /**
+     * For each cell of a uniform grid with spacing mStepSize covering mpFeMesh, the indices
+     * of the elements whose centroids lie in that grid cell. Since mpFeMesh is a regular
+     * tessellation of the box, this gives the few candidate elements containing any point.
+     * Built on first use by SetUpElementLocator(), so is not archived.
+     */
+    std::vector<std::vector<unsigned> > mElementsInGridCell;
+
+    /** The lower corner of the uniform grid used by mElementsInGridCell. */
+    c_vector<double,DIM> mGridLowerCorner;
+
+    /** The number of cells in each direction of the uniform grid used by mElementsInGridCell. */
+    c_vector<unsigned,DIM> mNumGridCells;
+
+    /**
+     * Helper method to set up mElementsInGridCell, mGridLowerCorner and mNumGridCells.
+     */
+    void SetUpElementLocator();
+
+    /**
+     * Helper method to find the element of mpFeMesh containing a point.
+     *
+     * The element containing the point at the previous time step is tried first, then the
+     * elements in the grid cell of mElementsInGridCell containing the point; only if both
+     * fail (for example, if the point lies outside the box) is the mesh searched.
+     *
+     * @param rPoint the point
+     * @param elementGuess the index of an element likely to contain the point (UNSIGNED_UNSET if none)
+     * @return the index of an element containing the point
+     */
+    unsigned GetContainingElementIndex(const ChastePoint<DIM>& rPoint, unsigned elementGuess=UNSIGNED_UNSET);
+
+    /**
+     * Helper method to solve the PDE -D Laplacian(u) + c(x) u = f(x) on the nodes of mpFeMesh
+     * using BoxDomainMultigridSolver, with mpBoundaryCondition imposed on the box boundary.
+     * The current solution, if any, is used as the initial guess.
+     *
+     * @param diffusionCoefficient the (constant) diffusion coefficient D
+     * @param rReactionCoefficients the non-negative reaction coefficient c at each node of mpFeMesh
+     * @param rSourceTerms the source term f at each node of mpFeMesh
+     * @return the solution, as a newly created vector
+     */
+    Vec SolveUsingMultigridSolver(double diffusionCoefficient,
+                                  const std::vector<double>& rReactionCoefficients,
+                                  const std::vector<double>& rSourceTerms);
+
+    /**
+     * Helper method to check whether a diffusion tensor is a multiple of the identity,
+     * and that multiple is the same as at any previous point.
+     *
+     * @param rDiffusionTerm the diffusion tensor
+     * @param rDiffusionCoefficient the diffusion coefficient found so far (negative if none);
+     *     set to the multiple if it was not already known
+     * @return whether rDiffusionTerm is rDiffusionCoefficient times the identity
+     */
+    bool IsIsotropicDiffusionTerm(const c_matrix<double,DIM,DIM>& rDiffusionTerm, double& rDiffusionCoefficient) const;
+
 public:
 
     /**
@@ -138,6 +202,25 @@ public:
      */
     bool AreBcsSetOnBoxBoundary();
 
+    /**
+     * Set mUseMultigridSolver.
+     *
+     * The multigrid solver discretises the PDE with a finite difference stencil on the nodes
+     * of the box domain mesh, so its solution agrees with that of the finite element solver
+     * to within discretisation error. It is only used if the boundary condition is imposed on
+     * the box boundary and the PDE has a constant isotropic diffusion coefficient with any
+     * dependence on u in the source term being a sink; otherwise the finite element solver is
+     * used as before.
+     *
+     * @param useMultigridSolver whether to use the multigrid solver where possible
+     */
+    void SetUseMultigridSolver(bool useMultigridSolver=true);
+
+    /**
+     * @return mUseMultigridSolver.
+     */
+    bool GetUseMultigridSolver() const;
+
     /**
      * Overridden SetupSolve() method.
      *
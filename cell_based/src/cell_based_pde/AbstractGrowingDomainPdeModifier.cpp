@@ -38,6 +38,8 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "MeshBasedCellPopulation.hpp"
 #include "CaBasedCellPopulation.hpp"
 #include "NodeBasedCellPopulation.hpp"
+#include "MutableMesh.hpp"
+#include "NodeMap.hpp"
 #include "ReplicatableVector.hpp"
 #include "LinearBasisFunction.hpp"
 
@@ -49,7 +51,9 @@ AbstractGrowingDomainPdeModifier<DIM>::AbstractGrowingDomainPdeModifier(boost::s
         : AbstractPdeModifier<DIM>(pPde,
                                    pBoundaryCondition,
                                    isNeumannBoundaryCondition,
-                                   solution)
+                                   solution),
+          mReuseFeMesh(false),
+          mFeMeshWasReused(false)
 {
 }
 
@@ -61,6 +65,24 @@ AbstractGrowingDomainPdeModifier<DIM>::~AbstractGrowingDomainPdeModifier()
 template <unsigned DIM>
 void AbstractGrowingDomainPdeModifier<DIM>::GenerateFeMesh(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
 {
+    mFeMeshWasReused = false;
+    std::vector<unsigned> cell_ids;
+    if (mReuseFeMesh)
+    {
+        for (typename AbstractCellPopulation<DIM>::Iterator cell_iter = rCellPopulation.Begin();
+             cell_iter != rCellPopulation.End();
+             ++cell_iter)
+        {
+            cell_ids.push_back(cell_iter->GetCellId());
+        }
+
+        if (UpdateExistingFeMesh(rCellPopulation, cell_ids))
+        {
+            mFeMeshWasReused = true;
+            return;
+        }
+    }
+
     if (this->mDeleteFeMesh)
     {
         // If a mesh has been created on a previous time step then we need to tidy it up
@@ -78,6 +100,62 @@ void AbstractGrowingDomainPdeModifier<DIM>::GenerateFeMesh(AbstractCellPopulatio
     // Get the finite element mesh via the cell population. Set to NULL first in case mesh generation fails.
     this->mpFeMesh = nullptr;
     this->mpFeMesh = rCellPopulation.GetTetrahedralMeshForPdeModifier();
+    mFeMeshCellIds = cell_ids;
+}
+
+template <unsigned DIM>
+bool AbstractGrowingDomainPdeModifier<DIM>::UpdateExistingFeMesh(AbstractCellPopulation<DIM,DIM>& rCellPopulation, const std::vector<unsigned>& rCellIds)
+{
+    /*
+     * The existing mesh can only be updated if it was generated by the population, from the
+     * nodes of a NodeBasedCellPopulation, and no cells have been born or have died since.
+     */
+    NodeBasedCellPopulation<DIM>* p_node_population = dynamic_cast<NodeBasedCellPopulation<DIM>*>(&rCellPopulation);
+    MutableMesh<DIM,DIM>* p_fe_mesh = dynamic_cast<MutableMesh<DIM,DIM>*>(this->mpFeMesh);
+    if (!this->mDeleteFeMesh || p_node_population == nullptr || p_fe_mesh == nullptr
+        || rCellIds != mFeMeshCellIds || p_fe_mesh->GetNumAllNodes() != rCellPopulation.GetNumNodes())
+    {
+        return false;
+    }
+
+    // Move the nodes of the finite element mesh to the node locations, in the order used by GetTetrahedralMeshForPdeModifier()
+    NodesOnlyMesh<DIM>& r_nodes_only_mesh = p_node_population->rGetMesh();
+    unsigned fe_node_index = 0;
+    for (typename AbstractMesh<DIM,DIM>::NodeIterator node_iter = r_nodes_only_mesh.GetNodeIteratorBegin();
+         node_iter != r_nodes_only_mesh.GetNodeIteratorEnd();
+         ++node_iter)
+    {
+        p_fe_mesh->GetNode(fe_node_index)->rGetModifiableLocation() = node_iter->rGetLocation();
+        fe_node_index++;
+    }
+
+    // Repair the triangulation; the node indices must be unchanged for the mesh to be used as before
+    if (DIM == 2)
+    {
+        p_fe_mesh->SetUseIncrementalReMesh();
+    }
+    NodeMap map(p_fe_mesh->GetNumNodes());
+    p_fe_mesh->ReMesh(map);
+
+    return map.IsIdentityMap() && p_fe_mesh->GetNumNodes() == fe_node_index;
+}
+
+template <unsigned DIM>
+void AbstractGrowingDomainPdeModifier<DIM>::SetReuseFeMesh(bool reuseFeMesh)
+{
+    mReuseFeMesh = reuseFeMesh;
+}
+
+template <unsigned DIM>
+bool AbstractGrowingDomainPdeModifier<DIM>::GetReuseFeMesh() const
+{
+    return mReuseFeMesh;
+}
+
+template <unsigned DIM>
+bool AbstractGrowingDomainPdeModifier<DIM>::GetFeMeshWasReused() const
+{
+    return mFeMeshWasReused;
 }
 
 template <unsigned DIM>
@@ -90,6 +168,14 @@ void AbstractGrowingDomainPdeModifier<DIM>::UpdateCellData(AbstractCellPopulatio
     unsigned cell_index = 0;
 
     unsigned index_in_solution_repl = 0;
+
+    // Look up the CellData items once, rather than by name for each cell
+    unsigned solution_item_index = CellData::GetItemIndex(this->mDependentVariableName);
+    c_vector<unsigned, 3> gradient_item_indices;
+    gradient_item_indices[0] = CellData::GetItemIndex(this->mDependentVariableName + "_grad_x");
+    gradient_item_indices[1] = CellData::GetItemIndex(this->mDependentVariableName + "_grad_y");
+    gradient_item_indices[2] = CellData::GetItemIndex(this->mDependentVariableName + "_grad_z");
+
     for (typename AbstractCellPopulation<DIM>::Iterator cell_iter = rCellPopulation.Begin();
          cell_iter != rCellPopulation.End();
          ++cell_iter)
@@ -116,7 +202,7 @@ void AbstractGrowingDomainPdeModifier<DIM>::UpdateCellData(AbstractCellPopulatio
 
         double solution_at_node = solution_repl[tet_node_index];
 
-        cell_iter->GetCellData()->SetItem(this->mDependentVariableName, solution_at_node);
+        cell_iter->GetCellData()->SetItem(solution_item_index, solution_at_node);
 
         if (this->mOutputGradient)
         {
@@ -156,16 +242,16 @@ void AbstractGrowingDomainPdeModifier<DIM>::UpdateCellData(AbstractCellPopulatio
             switch (DIM)
             {
                 case 1:
-                    cell_iter->GetCellData()->SetItem(this->mDependentVariableName+"_grad_x", solution_gradient(0));
+                    cell_iter->GetCellData()->SetItem(gradient_item_indices[0], solution_gradient(0));
                     break;
                 case 2:
-                    cell_iter->GetCellData()->SetItem(this->mDependentVariableName+"_grad_x", solution_gradient(0));
-                    cell_iter->GetCellData()->SetItem(this->mDependentVariableName+"_grad_y", solution_gradient(1));
+                    cell_iter->GetCellData()->SetItem(gradient_item_indices[0], solution_gradient(0));
+                    cell_iter->GetCellData()->SetItem(gradient_item_indices[1], solution_gradient(1));
                     break;
                 case 3:
-                    cell_iter->GetCellData()->SetItem(this->mDependentVariableName+"_grad_x", solution_gradient(0));
-                    cell_iter->GetCellData()->SetItem(this->mDependentVariableName+"_grad_y", solution_gradient(1));
-                    cell_iter->GetCellData()->SetItem(this->mDependentVariableName+"_grad_z", solution_gradient(2));
+                    cell_iter->GetCellData()->SetItem(gradient_item_indices[0], solution_gradient(0));
+                    cell_iter->GetCellData()->SetItem(gradient_item_indices[1], solution_gradient(1));
+                    cell_iter->GetCellData()->SetItem(gradient_item_indices[2], solution_gradient(2));
                     break;
                 default:
                     NEVER_REACHED;
@@ -39,6 +39,8 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ChasteSerialization.hpp"
 #include <boost/serialization/base_object.hpp>
 
+#include <vector>
+
 #include "AbstractPdeModifier.hpp"
 
 /**
@@ -54,6 +56,31 @@ class AbstractGrowingDomainPdeModifier : public AbstractPdeModifier<DIM>
 
 private:
 
+    /**
+     * Whether GenerateFeMesh() should update the existing finite element mesh, rather than
+     * generate a new one, when the cells are unchanged since it was generated. Not archived,
+     * since it is a property of the run. Defaults to false.
+     */
+    bool mReuseFeMesh;
+
+    /** Whether the most recent call to GenerateFeMesh() updated the existing mesh. */
+    bool mFeMeshWasReused;
+
+    /** The ids of the cells, in population order, when mpFeMesh was last generated. */
+    std::vector<unsigned> mFeMeshCellIds;
+
+    /**
+     * Helper method for GenerateFeMesh(). Try to move the nodes of the existing finite element
+     * mesh to the current node locations, and repair its triangulation, if the cells are
+     * unchanged. This is only done for a NodeBasedCellPopulation, whose finite element mesh is a
+     * MutableMesh with one node per cell.
+     *
+     * @param rCellPopulation reference to the cell population
+     * @param rCellIds the ids of the cells, in population order
+     * @return whether the existing mesh was updated
+     */
+    bool UpdateExistingFeMesh(AbstractCellPopulation<DIM,DIM>& rCellPopulation, const std::vector<unsigned>& rCellIds);
+
     /** Needed for serialization. */
     friend class boost::serialization::access;
     /**
@@ -97,6 +124,29 @@ public:
      */
     void GenerateFeMesh(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
 
+    /**
+     * Set whether the finite element mesh should be reused between time steps when the cells are
+     * unchanged. If so, and no cells have been born or have died since the mesh was generated, the
+     * nodes of the existing mesh are moved and its triangulation repaired (in 2D using the
+     * incremental remeshing in MutableMesh), instead of a new mesh being generated. Only used for
+     * NodeBasedCellPopulations; for other populations a new mesh is always generated. The element
+     * numbering of the repaired mesh may differ from that of a new mesh, so results may differ
+     * at the level of round-off.
+     *
+     * @param reuseFeMesh whether to reuse the mesh (defaults to true)
+     */
+    void SetReuseFeMesh(bool reuseFeMesh=true);
+
+    /**
+     * @return mReuseFeMesh
+     */
+    bool GetReuseFeMesh() const;
+
+    /**
+     * @return whether the most recent call to GenerateFeMesh() reused the existing mesh.
+     */
+    bool GetFeMeshWasReused() const;
+
     /**
      * Helper method to copy the PDE solution to CellData
      *
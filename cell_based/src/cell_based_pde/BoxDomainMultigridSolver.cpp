@@ -0,0 +1,594 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "BoxDomainMultigridSolver.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include "Exception.hpp"
+
+template <unsigned DIM>
+BoxDomainMultigridSolver<DIM>::BoxDomainMultigridSolver(const c_vector<unsigned, DIM>& rNumNodes, double stepSize)
+    : mDiffusionCoefficient(1.0),
+      mUseNeumannBoundaryConditions(false),
+      mTolerance(1e-10),
+      mMaxIterations(1000),
+      mNumIterations(0),
+      mLevelsAreCurrent(false)
+{
+    if (stepSize <= 0.0)
+    {
+        EXCEPTION("The grid spacing must be positive.");
+    }
+
+    GridLevel finest;
+    finest.mTotalNumNodes = 1;
+    for (unsigned d=0; d<DIM; d++)
+    {
+        if (rNumNodes[d] < 2)
+        {
+            EXCEPTION("There must be at least two grid nodes in each direction.");
+        }
+        finest.mNumNodes[d] = rNumNodes[d];
+        finest.mStrides[d] = finest.mTotalNumNodes;
+        finest.mTotalNumNodes *= rNumNodes[d];
+    }
+    finest.mStepSize = stepSize;
+    finest.mReactionCoefficients.assign(finest.mTotalNumNodes, 0.0);
+    mLevels.push_back(finest);
+}
+
+template <unsigned DIM>
+c_vector<unsigned, DIM> BoxDomainMultigridSolver<DIM>::GetGridIndices(const GridLevel& rLevel, unsigned index) const
+{
+    c_vector<unsigned, DIM> indices;
+    for (unsigned d=0; d<DIM; d++)
+    {
+        indices[d] = index%rLevel.mNumNodes[d];
+        index /= rLevel.mNumNodes[d];
+    }
+    return indices;
+}
+
+template <unsigned DIM>
+void BoxDomainMultigridSolver<DIM>::SetUpBoundaryData(GridLevel& rLevel) const
+{
+    rLevel.mRowWeights.assign(rLevel.mTotalNumNodes, 1.0);
+    rLevel.mIsDirichletNode.assign(rLevel.mTotalNumNodes, false);
+
+    for (unsigned i=0; i<rLevel.mTotalNumNodes; i++)
+    {
+        c_vector<unsigned, DIM> indices = GetGridIndices(rLevel, i);
+        for (unsigned d=0; d<DIM; d++)
+        {
+            if (indices[d] == 0 || indices[d] == rLevel.mNumNodes[d]-1)
+            {
+                if (mUseNeumannBoundaryConditions)
+                {
+                    // Only half of the control volume lies inside the box in this direction
+                    rLevel.mRowWeights[i] *= 0.5;
+                }
+                else
+                {
+                    rLevel.mIsDirichletNode[i] = true;
+                }
+            }
+        }
+    }
+}
+
+template <unsigned DIM>
+void BoxDomainMultigridSolver<DIM>::SetUpCoarseLevels()
+{
+    mLevels.resize(1);
+    SetUpBoundaryData(mLevels[0]);
+
+    while (true)
+    {
+        // Coarsen only if every direction has an even number (at least four) of intervals
+        bool can_coarsen = true;
+        for (unsigned d=0; d<DIM; d++)
+        {
+            unsigned num_intervals = mLevels.back().mNumNodes[d] - 1;
+            if (num_intervals%2 != 0 || num_intervals < 4)
+            {
+                can_coarsen = false;
+            }
+        }
+        if (!can_coarsen)
+        {
+            break;
+        }
+
+        const GridLevel& r_fine = mLevels.back();
+        GridLevel coarse;
+        coarse.mTotalNumNodes = 1;
+        for (unsigned d=0; d<DIM; d++)
+        {
+            coarse.mNumNodes[d] = (r_fine.mNumNodes[d] - 1)/2 + 1;
+            coarse.mStrides[d] = coarse.mTotalNumNodes;
+            coarse.mTotalNumNodes *= coarse.mNumNodes[d];
+        }
+        coarse.mStepSize = 2.0*r_fine.mStepSize;
+
+        // Inject the reaction coefficients from the coincident fine nodes
+        coarse.mReactionCoefficients.resize(coarse.mTotalNumNodes);
+        for (unsigned i=0; i<coarse.mTotalNumNodes; i++)
+        {
+            c_vector<unsigned, DIM> indices = GetGridIndices(coarse, i);
+            unsigned fine_index = 0;
+            for (unsigned d=0; d<DIM; d++)
+            {
+                fine_index += 2*indices[d]*r_fine.mStrides[d];
+            }
+            coarse.mReactionCoefficients[i] = r_fine.mReactionCoefficients[fine_index];
+        }
+        SetUpBoundaryData(coarse);
+
+        mLevels.push_back(coarse);
+    }
+
+    mLevelsAreCurrent = true;
+}
+
+template <unsigned DIM>
+double BoxDomainMultigridSolver<DIM>::SumNeighbours(const GridLevel& rLevel, const std::vector<double>& rX, unsigned index) const
+{
+    c_vector<unsigned, DIM> indices = GetGridIndices(rLevel, index);
+
+    double sum = 0.0;
+    for (unsigned d=0; d<DIM; d++)
+    {
+        unsigned stride = rLevel.mStrides[d];
+
+        // Neighbours outside the box are replaced by their mirror image (only needed for Neumann conditions)
+        unsigned minus = (indices[d] > 0) ? index - stride : index + stride;
+        unsigned plus = (indices[d] < rLevel.mNumNodes[d]-1) ? index + stride : index - stride;
+        sum += rX[minus] + rX[plus];
+    }
+    return sum;
+}
+
+template <unsigned DIM>
+double BoxDomainMultigridSolver<DIM>::GetDiagonal(const GridLevel& rLevel, unsigned index) const
+{
+    double h = rLevel.mStepSize;
+    return 2.0*DIM*mDiffusionCoefficient/(h*h) + rLevel.mReactionCoefficients[index];
+}
+
+template <unsigned DIM>
+void BoxDomainMultigridSolver<DIM>::ApplyOperator(unsigned level, const std::vector<double>& rX, std::vector<double>& rY) const
+{
+    const GridLevel& r_level = mLevels[level];
+    double off_diagonal = mDiffusionCoefficient/(r_level.mStepSize*r_level.mStepSize);
+
+    rY.resize(r_level.mTotalNumNodes);
+    for (unsigned i=0; i<r_level.mTotalNumNodes; i++)
+    {
+        if (r_level.mIsDirichletNode[i])
+        {
+            rY[i] = 0.0;
+        }
+        else
+        {
+            rY[i] = r_level.mRowWeights[i]*(GetDiagonal(r_level, i)*rX[i] - off_diagonal*SumNeighbours(r_level, rX, i));
+        }
+    }
+}
+
+template <unsigned DIM>
+void BoxDomainMultigridSolver<DIM>::Smooth(unsigned level, const std::vector<double>& rRhs, std::vector<double>& rX, bool redFirst) const
+{
+    const GridLevel& r_level = mLevels[level];
+    double off_diagonal = mDiffusionCoefficient/(r_level.mStepSize*r_level.mStepSize);
+
+    for (unsigned pass=0; pass<2; pass++)
+    {
+        unsigned colour = (pass + (redFirst ? 0 : 1))%2;
+        for (unsigned i=0; i<r_level.mTotalNumNodes; i++)
+        {
+            if (r_level.mIsDirichletNode[i])
+            {
+                continue;
+            }
+
+            c_vector<unsigned, DIM> indices = GetGridIndices(r_level, i);
+            unsigned index_sum = 0;
+            for (unsigned d=0; d<DIM; d++)
+            {
+                index_sum += indices[d];
+            }
+            if (index_sum%2 != colour)
+            {
+                continue;
+            }
+
+            rX[i] = (rRhs[i]/r_level.mRowWeights[i] + off_diagonal*SumNeighbours(r_level, rX, i))/GetDiagonal(r_level, i);
+        }
+    }
+}
+
+template <unsigned DIM>
+void BoxDomainMultigridSolver<DIM>::GetInterpolatingNodes(unsigned fineLevel, unsigned index,
+                                                          std::vector<unsigned>& rIndices, std::vector<double>& rWeights) const
+{
+    const GridLevel& r_fine = mLevels[fineLevel];
+    const GridLevel& r_coarse = mLevels[fineLevel+1];
+    c_vector<unsigned, DIM> indices = GetGridIndices(r_fine, index);
+
+    rIndices.assign(1, 0);
+    rWeights.assign(1, 1.0);
+    for (unsigned d=0; d<DIM; d++)
+    {
+        unsigned stride = r_coarse.mStrides[d];
+        if (indices[d]%2 == 0)
+        {
+            // This fine node lies on a coarse grid line in this direction
+            for (unsigned k=0; k<rIndices.size(); k++)
+            {
+                rIndices[k] += (indices[d]/2)*stride;
+            }
+        }
+        else
+        {
+            // Interpolate between the two neighbouring coarse grid lines
+            unsigned num_so_far = rIndices.size();
+            for (unsigned k=0; k<num_so_far; k++)
+            {
+                rIndices.push_back(rIndices[k] + ((indices[d]+1)/2)*stride);
+                rWeights.push_back(0.5*rWeights[k]);
+                rIndices[k] += ((indices[d]-1)/2)*stride;
+                rWeights[k] *= 0.5;
+            }
+        }
+    }
+}
+
+template <unsigned DIM>
+void BoxDomainMultigridSolver<DIM>::ApplyVCycle(unsigned level, const std::vector<double>& rRhs, std::vector<double>& rX) const
+{
+    const GridLevel& r_level = mLevels[level];
+    rX.assign(r_level.mTotalNumNodes, 0.0);
+
+    if (level+1 == mLevels.size())
+    {
+        // On the coarsest grid, apply a symmetric sequence of smoothing sweeps
+        unsigned num_sweeps = 0;
+        for (unsigned d=0; d<DIM; d++)
+        {
+            num_sweeps = std::max(num_sweeps, r_level.mNumNodes[d]);
+        }
+        for (unsigned k=0; k<num_sweeps; k++)
+        {
+            Smooth(level, rRhs, rX, true);
+        }
+        for (unsigned k=0; k<num_sweeps; k++)
+        {
+            Smooth(level, rRhs, rX, false);
+        }
+        return;
+    }
+
+    // Pre-smoothing
+    Smooth(level, rRhs, rX, true);
+    Smooth(level, rRhs, rX, true);
+
+    // Restrict the residual to the coarse grid using the transpose of linear interpolation
+    std::vector<double> residual;
+    ApplyOperator(level, rX, residual);
+    const GridLevel& r_coarse = mLevels[level+1];
+    std::vector<double> coarse_rhs(r_coarse.mTotalNumNodes, 0.0);
+    std::vector<unsigned> coarse_indices;
+    std::vector<double> weights;
+    double scaling = pow(0.5, (double)DIM);
+    for (unsigned i=0; i<r_level.mTotalNumNodes; i++)
+    {
+        if (!r_level.mIsDirichletNode[i])
+        {
+            double residual_at_node = rRhs[i] - residual[i];
+            GetInterpolatingNodes(level, i, coarse_indices, weights);
+            for (unsigned k=0; k<coarse_indices.size(); k++)
+            {
+                coarse_rhs[coarse_indices[k]] += scaling*weights[k]*residual_at_node;
+            }
+        }
+    }
+    for (unsigned i=0; i<r_coarse.mTotalNumNodes; i++)
+    {
+        if (r_coarse.mIsDirichletNode[i])
+        {
+            coarse_rhs[i] = 0.0;
+        }
+    }
+
+    // Solve for the coarse grid correction and interpolate it back
+    std::vector<double> coarse_correction;
+    ApplyVCycle(level+1, coarse_rhs, coarse_correction);
+    for (unsigned i=0; i<r_level.mTotalNumNodes; i++)
+    {
+        if (!r_level.mIsDirichletNode[i])
+        {
+            GetInterpolatingNodes(level, i, coarse_indices, weights);
+            for (unsigned k=0; k<coarse_indices.size(); k++)
+            {
+                rX[i] += weights[k]*coarse_correction[coarse_indices[k]];
+            }
+        }
+    }
+
+    // Post-smoothing, in the reverse order to keep the preconditioner symmetric
+    Smooth(level, rRhs, rX, false);
+    Smooth(level, rRhs, rX, false);
+}
+
+template <unsigned DIM>
+unsigned BoxDomainMultigridSolver<DIM>::GetNumNodes() const
+{
+    return mLevels[0].mTotalNumNodes;
+}
+
+template <unsigned DIM>
+unsigned BoxDomainMultigridSolver<DIM>::GetNumLevels()
+{
+    if (!mLevelsAreCurrent)
+    {
+        SetUpCoarseLevels();
+    }
+    return mLevels.size();
+}
+
+template <unsigned DIM>
+bool BoxDomainMultigridSolver<DIM>::IsBoundaryNode(unsigned index) const
+{
+    assert(index < mLevels[0].mTotalNumNodes);
+    c_vector<unsigned, DIM> indices = GetGridIndices(mLevels[0], index);
+    for (unsigned d=0; d<DIM; d++)
+    {
+        if (indices[d] == 0 || indices[d] == mLevels[0].mNumNodes[d]-1)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <unsigned DIM>
+void BoxDomainMultigridSolver<DIM>::SetDiffusionCoefficient(double diffusionCoefficient)
+{
+    if (diffusionCoefficient <= 0.0)
+    {
+        EXCEPTION("The diffusion coefficient must be positive.");
+    }
+    mDiffusionCoefficient = diffusionCoefficient;
+}
+
+template <unsigned DIM>
+void BoxDomainMultigridSolver<DIM>::SetReactionCoefficients(const std::vector<double>& rReactionCoefficients)
+{
+    if (rReactionCoefficients.size() != mLevels[0].mTotalNumNodes)
+    {
+        EXCEPTION("The number of reaction coefficients must match the number of grid nodes.");
+    }
+    for (unsigned i=0; i<rReactionCoefficients.size(); i++)
+    {
+        if (rReactionCoefficients[i] < 0.0)
+        {
+            EXCEPTION("The reaction coefficients must be non-negative.");
+        }
+    }
+    mLevels[0].mReactionCoefficients = rReactionCoefficients;
+    mLevelsAreCurrent = false;
+}
+
+template <unsigned DIM>
+void BoxDomainMultigridSolver<DIM>::SetUseNeumannBoundaryConditions(bool useNeumannBoundaryConditions)
+{
+    mUseNeumannBoundaryConditions = useNeumannBoundaryConditions;
+    mLevelsAreCurrent = false;
+}
+
+template <unsigned DIM>
+void BoxDomainMultigridSolver<DIM>::SetTolerance(double tolerance)
+{
+    assert(tolerance > 0.0);
+    mTolerance = tolerance;
+}
+
+template <unsigned DIM>
+void BoxDomainMultigridSolver<DIM>::SetMaxIterations(unsigned maxIterations)
+{
+    mMaxIterations = maxIterations;
+}
+
+template <unsigned DIM>
+unsigned BoxDomainMultigridSolver<DIM>::GetNumIterations() const
+{
+    return mNumIterations;
+}
+
+template <unsigned DIM>
+std::vector<double> BoxDomainMultigridSolver<DIM>::Solve(const std::vector<double>& rRhs,
+                                                         const std::vector<double>& rBoundaryValues,
+                                                         const std::vector<double>& rInitialGuess)
+{
+    unsigned num_nodes = mLevels[0].mTotalNumNodes;
+    if (rRhs.size() != num_nodes || rBoundaryValues.size() != num_nodes
+        || (!rInitialGuess.empty() && rInitialGuess.size() != num_nodes))
+    {
+        EXCEPTION("The size of each vector passed to Solve() must match the number of grid nodes.");
+    }
+
+    if (!mLevelsAreCurrent)
+    {
+        SetUpCoarseLevels();
+    }
+    const GridLevel& r_fine = mLevels[0];
+
+    if (mUseNeumannBoundaryConditions)
+    {
+        bool has_positive_reaction = false;
+        for (unsigned i=0; i<num_nodes; i++)
+        {
+            if (r_fine.mReactionCoefficients[i] > 0.0)
+            {
+                has_positive_reaction = true;
+                break;
+            }
+        }
+        if (!has_positive_reaction)
+        {
+            EXCEPTION("With Neumann boundary conditions the reaction coefficient must be positive somewhere.");
+        }
+    }
+
+    // Form the weighted right-hand side, including the ghost node contributions from any Neumann fluxes
+    std::vector<double> rhs(num_nodes, 0.0);
+    std::vector<double> dirichlet_data(num_nodes, 0.0);
+    for (unsigned i=0; i<num_nodes; i++)
+    {
+        if (r_fine.mIsDirichletNode[i])
+        {
+            dirichlet_data[i] = rBoundaryValues[i];
+        }
+        else
+        {
+            double source = rRhs[i];
+            if (mUseNeumannBoundaryConditions)
+            {
+                c_vector<unsigned, DIM> indices = GetGridIndices(r_fine, i);
+                for (unsigned d=0; d<DIM; d++)
+                {
+                    if (indices[d] == 0 || indices[d] == r_fine.mNumNodes[d]-1)
+                    {
+                        source += 2.0*rBoundaryValues[i]/r_fine.mStepSize;
+                    }
+                }
+            }
+            rhs[i] = r_fine.mRowWeights[i]*source;
+        }
+    }
+
+    // Measure convergence relative to the residual of the zero interior guess
+    std::vector<double> residual;
+    ApplyOperator(0, dirichlet_data, residual);
+    double reference_norm_squared = 0.0;
+    for (unsigned i=0; i<num_nodes; i++)
+    {
+        reference_norm_squared += (rhs[i] - residual[i])*(rhs[i] - residual[i]);
+    }
+    double threshold_squared = mTolerance*mTolerance*reference_norm_squared;
+
+    std::vector<double> solution = rInitialGuess.empty() ? std::vector<double>(num_nodes, 0.0) : rInitialGuess;
+    for (unsigned i=0; i<num_nodes; i++)
+    {
+        if (r_fine.mIsDirichletNode[i])
+        {
+            solution[i] = dirichlet_data[i];
+        }
+    }
+
+    mNumIterations = 0;
+    if (reference_norm_squared == 0.0)
+    {
+        // The solution vanishes away from the Dirichlet nodes
+        return dirichlet_data;
+    }
+
+    ApplyOperator(0, solution, residual);
+    double residual_norm_squared = 0.0;
+    for (unsigned i=0; i<num_nodes; i++)
+    {
+        residual[i] = rhs[i] - residual[i];
+        residual_norm_squared += residual[i]*residual[i];
+    }
+
+    // Preconditioned conjugate gradient iteration
+    std::vector<double> preconditioned_residual;
+    std::vector<double> search_direction;
+    std::vector<double> operator_times_direction;
+    double residual_dot_preconditioned = 0.0;
+    while (residual_norm_squared > threshold_squared)
+    {
+        if (mNumIterations == mMaxIterations)
+        {
+            EXCEPTION("BoxDomainMultigridSolver did not converge within " << mMaxIterations << " iterations.");
+        }
+
+        ApplyVCycle(0, residual, preconditioned_residual);
+        double new_residual_dot_preconditioned = 0.0;
+        for (unsigned i=0; i<num_nodes; i++)
+        {
+            new_residual_dot_preconditioned += residual[i]*preconditioned_residual[i];
+        }
+
+        if (mNumIterations == 0)
+        {
+            search_direction = preconditioned_residual;
+        }
+        else
+        {
+            double beta = new_residual_dot_preconditioned/residual_dot_preconditioned;
+            for (unsigned i=0; i<num_nodes; i++)
+            {
+                search_direction[i] = preconditioned_residual[i] + beta*search_direction[i];
+            }
+        }
+        residual_dot_preconditioned = new_residual_dot_preconditioned;
+
+        ApplyOperator(0, search_direction, operator_times_direction);
+        double curvature = 0.0;
+        for (unsigned i=0; i<num_nodes; i++)
+        {
+            curvature += search_direction[i]*operator_times_direction[i];
+        }
+        double alpha = residual_dot_preconditioned/curvature;
+
+        residual_norm_squared = 0.0;
+        for (unsigned i=0; i<num_nodes; i++)
+        {
+            solution[i] += alpha*search_direction[i];
+            residual[i] -= alpha*operator_times_direction[i];
+            residual_norm_squared += residual[i]*residual[i];
+        }
+        mNumIterations++;
+    }
+
+    return solution;
+}
+
+// Explicit instantiation
+template class BoxDomainMultigridSolver<1>;
+template class BoxDomainMultigridSolver<2>;
+template class BoxDomainMultigridSolver<3>;
@@ -0,0 +1,279 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef BOXDOMAINMULTIGRIDSOLVER_HPP_
+#define BOXDOMAINMULTIGRIDSOLVER_HPP_
+
+#include <vector>
+#include "UblasVectorInclude.hpp"
+
+/**
+ * A matrix-free solver for the linear PDE
+ *
+ *   -D Laplacian(u) + c(x) u = f(x)
+ *
+ * on a regular grid of nodes covering a box, with either Dirichlet or Neumann
+ * conditions imposed on the whole of the box boundary. Here D is a constant
+ * diffusion coefficient and c(x) >= 0 is a nodal reaction (uptake) coefficient.
+ *
+ * The PDE is discretised with the standard (2*DIM+1)-point finite difference
+ * stencil, which is applied directly to the nodal values rather than assembled
+ * into a matrix. Neumann conditions are imposed using mirrored ghost nodes, with
+ * the boundary rows scaled by the fraction of their control volume lying inside
+ * the box so that the operator remains symmetric. The resulting symmetric positive
+ * definite system is solved by the conjugate gradient method, preconditioned by
+ * a geometric multigrid V-cycle with red-black Gauss-Seidel smoothing.
+ *
+ * Nodes are indexed with the x index varying fastest. The grid is coarsened for
+ * as long as the number of intervals in every direction is even, so grids with
+ * 2^k+1 nodes in each direction give the best convergence.
+ */
+template <unsigned DIM>
+class BoxDomainMultigridSolver
+{
+private:
+
+    /**
+     * The data describing one level of the multigrid hierarchy.
+     */
+    struct GridLevel
+    {
+        /** The number of nodes in each direction. */
+        c_vector<unsigned, DIM> mNumNodes;
+
+        /** The index stride in each direction. */
+        c_vector<unsigned, DIM> mStrides;
+
+        /** The total number of nodes. */
+        unsigned mTotalNumNodes;
+
+        /** The grid spacing. */
+        double mStepSize;
+
+        /** The reaction coefficient at each node. */
+        std::vector<double> mReactionCoefficients;
+
+        /** The fraction of the control volume of each node lying inside the box. */
+        std::vector<double> mRowWeights;
+
+        /** Whether each node is a Dirichlet node. */
+        std::vector<bool> mIsDirichletNode;
+    };
+
+    /** The grid hierarchy, with the finest grid stored first. */
+    std::vector<GridLevel> mLevels;
+
+    /** The diffusion coefficient D. */
+    double mDiffusionCoefficient;
+
+    /** Whether Neumann (rather than Dirichlet) conditions are imposed on the box boundary. */
+    bool mUseNeumannBoundaryConditions;
+
+    /** The relative residual tolerance used to stop the conjugate gradient iteration. */
+    double mTolerance;
+
+    /** The maximum number of conjugate gradient iterations. */
+    unsigned mMaxIterations;
+
+    /** The number of conjugate gradient iterations taken by the last call to Solve(). */
+    unsigned mNumIterations;
+
+    /** Whether the coarser levels need to be rebuilt before the next solve. */
+    bool mLevelsAreCurrent;
+
+    /**
+     * Compute the grid indices of a node.
+     *
+     * @param rLevel the grid level
+     * @param index the global index of the node on this level
+     * @return the index of the node in each direction
+     */
+    c_vector<unsigned, DIM> GetGridIndices(const GridLevel& rLevel, unsigned index) const;
+
+    /**
+     * Fill in the row weights and Dirichlet flags of a level from its dimensions.
+     *
+     * @param rLevel the grid level
+     */
+    void SetUpBoundaryData(GridLevel& rLevel) const;
+
+    /**
+     * Rebuild the coarser levels of the hierarchy from the finest level.
+     */
+    void SetUpCoarseLevels();
+
+    /**
+     * Compute the sum of the stencil neighbours of a node, using mirrored
+     * ghost values for neighbours that lie outside the box.
+     *
+     * @param rLevel the grid level
+     * @param rX the nodal values
+     * @param index the global index of the node
+     * @return the sum of the 2*DIM neighbouring values
+     */
+    double SumNeighbours(const GridLevel& rLevel, const std::vector<double>& rX, unsigned index) const;
+
+    /**
+     * Compute the (unweighted) diagonal entry of the stencil at a node.
+     *
+     * @param rLevel the grid level
+     * @param index the global index of the node
+     * @return the diagonal entry
+     */
+    double GetDiagonal(const GridLevel& rLevel, unsigned index) const;
+
+    /**
+     * Apply the discrete operator on a level. Rows corresponding to Dirichlet
+     * nodes are set to zero.
+     *
+     * @param level the grid level
+     * @param rX the nodal values
+     * @param rY the result (resized if necessary)
+     */
+    void ApplyOperator(unsigned level, const std::vector<double>& rX, std::vector<double>& rY) const;
+
+    /**
+     * Perform one red-black Gauss-Seidel sweep on a level.
+     *
+     * @param level the grid level
+     * @param rRhs the right-hand side
+     * @param rX the current iterate, updated in place
+     * @param redFirst whether to update the red nodes (even index sum) before the black nodes;
+     *     alternating the order between pre- and post-smoothing keeps the V-cycle symmetric
+     */
+    void Smooth(unsigned level, const std::vector<double>& rRhs, std::vector<double>& rX, bool redFirst) const;
+
+    /**
+     * Compute the coarse nodes from which a fine node is linearly interpolated.
+     *
+     * @param fineLevel the fine grid level (the coarse level is fineLevel+1)
+     * @param index the global index of the fine node
+     * @param rIndices the global indices of the coarse nodes (filled in)
+     * @param rWeights the corresponding interpolation weights (filled in)
+     */
+    void GetInterpolatingNodes(unsigned fineLevel, unsigned index,
+                               std::vector<unsigned>& rIndices, std::vector<double>& rWeights) const;
+
+    /**
+     * Apply one multigrid V-cycle, starting from a zero initial guess.
+     *
+     * @param level the grid level
+     * @param rRhs the right-hand side on this level
+     * @param rX the approximate solution (resized if necessary)
+     */
+    void ApplyVCycle(unsigned level, const std::vector<double>& rRhs, std::vector<double>& rX) const;
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param rNumNodes the number of nodes in each direction (each at least two)
+     * @param stepSize the grid spacing
+     */
+    BoxDomainMultigridSolver(const c_vector<unsigned, DIM>& rNumNodes, double stepSize);
+
+    /**
+     * @return the total number of nodes on the finest grid.
+     */
+    unsigned GetNumNodes() const;
+
+    /**
+     * @return the number of levels in the multigrid hierarchy.
+     */
+    unsigned GetNumLevels();
+
+    /**
+     * @return whether a node of the finest grid lies on the box boundary.
+     *
+     * @param index the global index of the node
+     */
+    bool IsBoundaryNode(unsigned index) const;
+
+    /**
+     * Set mDiffusionCoefficient.
+     *
+     * @param diffusionCoefficient the diffusion coefficient, which must be positive
+     */
+    void SetDiffusionCoefficient(double diffusionCoefficient);
+
+    /**
+     * Set the nodal reaction coefficients c(x). Defaults to zero.
+     *
+     * @param rReactionCoefficients the (non-negative) reaction coefficient at each node
+     */
+    void SetReactionCoefficients(const std::vector<double>& rReactionCoefficients);
+
+    /**
+     * Set whether Neumann conditions are imposed on the box boundary. Defaults to false.
+     *
+     * @param useNeumannBoundaryConditions whether to use Neumann boundary conditions
+     */
+    void SetUseNeumannBoundaryConditions(bool useNeumannBoundaryConditions=true);
+
+    /**
+     * Set mTolerance.
+     *
+     * @param tolerance the relative residual tolerance
+     */
+    void SetTolerance(double tolerance);
+
+    /**
+     * Set mMaxIterations.
+     *
+     * @param maxIterations the maximum number of conjugate gradient iterations
+     */
+    void SetMaxIterations(unsigned maxIterations);
+
+    /**
+     * @return the number of conjugate gradient iterations taken by the last solve.
+     */
+    unsigned GetNumIterations() const;
+
+    /**
+     * Solve the PDE.
+     *
+     * @param rRhs the source term f at each node
+     * @param rBoundaryValues the Dirichlet value, or the outward flux D du/dn for Neumann
+     *     conditions, at each node (only entries at boundary nodes are used)
+     * @param rInitialGuess an initial guess at the solution (may be empty, in which case zero is used)
+     * @return the solution at each node
+     */
+    std::vector<double> Solve(const std::vector<double>& rRhs,
+                              const std::vector<double>& rBoundaryValues,
+                              const std::vector<double>& rInitialGuess=std::vector<double>());
+};
+
+#endif /*BOXDOMAINMULTIGRIDSOLVER_HPP_*/
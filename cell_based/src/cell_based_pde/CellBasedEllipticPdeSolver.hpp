@@ -112,6 +112,15 @@ protected:
      */
     void IncrementInterpolatedQuantities(double phiI, const Node<DIM>* pNode);
 
+    /**
+     * @return false, as the interpolated quantities are stored in members,
+     * so elements cannot be assembled concurrently.
+     */
+    bool IsThreadSafe() const
+    {
+        return false;
+    }
+
     /**
      * Create the linear system object if it hasn't been already.
      * Can use an initial solution as PETSc template, or base it on the mesh size.
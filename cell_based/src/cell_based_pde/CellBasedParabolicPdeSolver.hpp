@@ -109,6 +109,15 @@ protected:
      */
     void IncrementInterpolatedQuantities(double phiI, const Node<DIM>*);
 
+    /**
+     * @return false, as the interpolated quantities are stored in members,
+     * so elements cannot be assembled concurrently.
+     */
+    bool IsThreadSafe() const
+    {
+        return false;
+    }
+
 public:
 
     /**
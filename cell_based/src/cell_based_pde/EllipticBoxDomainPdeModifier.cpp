@@ -69,15 +69,26 @@ void EllipticBoxDomainPdeModifier<DIM>::UpdateAtEndOfTimeStep(AbstractCellPopula
     // Pass in already updated CellPdeElementMap to speed up finding cells.
     this->SetUpSourceTermsForAveragedSourcePde(this->mpFeMesh, &this->mCellPdeElementMap);
 
-    // Use SimpleLinearEllipticSolver as Averaged Source PDE
-    ///\todo allow other PDE classes to be used with this modifier
-    SimpleLinearEllipticSolver<DIM,DIM> solver(this->mpFeMesh,
-                                               boost::static_pointer_cast<AbstractLinearEllipticPde<DIM,DIM> >(this->GetPde()).get(),
-                                               p_bcc.get());
+    Vec new_solution = nullptr;
+    if (this->mUseMultigridSolver && this->mSetBcsOnBoxBoundary)
+    {
+        new_solution = SolveUsingMultigridSolverIfPossible();
+    }
+
+    if (new_solution == nullptr)
+    {
+        // Use SimpleLinearEllipticSolver as Averaged Source PDE
+        ///\todo allow other PDE classes to be used with this modifier
+        SimpleLinearEllipticSolver<DIM,DIM> solver(this->mpFeMesh,
+                                                   boost::static_pointer_cast<AbstractLinearEllipticPde<DIM,DIM> >(this->GetPde()).get(),
+                                                   p_bcc.get());
+
+        ///\todo Use solution at previous time step as an initial guess for Solve()
+        new_solution = solver.Solve();
+    }
 
-    ///\todo Use solution at previous time step as an initial guess for Solve()
     Vec old_solution_copy = this->mSolution;
-    this->mSolution = solver.Solve();
+    this->mSolution = new_solution;
     if (old_solution_copy != nullptr)
     {
         PetscTools::Destroy(old_solution_copy);
@@ -152,6 +163,54 @@ std::shared_ptr<BoundaryConditionsContainer<DIM,DIM,1> > EllipticBoxDomainPdeMod
     return p_bcc;
 }
 
+template <unsigned DIM>
+Vec EllipticBoxDomainPdeModifier<DIM>::SolveUsingMultigridSolverIfPossible()
+{
+    AbstractLinearEllipticPde<DIM,DIM>* p_pde = boost::static_pointer_cast<AbstractLinearEllipticPde<DIM,DIM> >(this->GetPde()).get();
+
+    /*
+     * The PDE is div(D grad u) + a(x) + b(x) u = 0. Lump the source terms onto the nodes by
+     * averaging over the elements containing each node; the elements of the box domain mesh
+     * all have the same size, so this is equivalent to a lumped mass matrix.
+     */
+    unsigned num_nodes = this->mpFeMesh->GetNumNodes();
+    std::vector<double> reaction_coefficients(num_nodes);
+    std::vector<double> source_terms(num_nodes);
+    double diffusion_coefficient = -1.0;
+    for (unsigned i=0; i<num_nodes; i++)
+    {
+        Node<DIM>* p_node = this->mpFeMesh->GetNode(i);
+        ChastePoint<DIM> point(p_node->rGetLocation());
+
+        if (!this->IsIsotropicDiffusionTerm(p_pde->ComputeDiffusionTerm(point), diffusion_coefficient))
+        {
+            return nullptr;
+        }
+
+        double constant_in_u = 0.0;
+        double linear_in_u = 0.0;
+        std::set<unsigned>& r_element_indices = p_node->rGetContainingElementIndices();
+        for (std::set<unsigned>::iterator iter = r_element_indices.begin();
+             iter != r_element_indices.end();
+             ++iter)
+        {
+            Element<DIM,DIM>* p_element = this->mpFeMesh->GetElement(*iter);
+            constant_in_u += p_pde->ComputeConstantInUSourceTerm(point, p_element);
+            linear_in_u += p_pde->ComputeLinearInUCoeffInSourceTerm(point, p_element);
+        }
+
+        // The multigrid solver requires any dependence of the source term on u to be a sink
+        source_terms[i] = constant_in_u/r_element_indices.size();
+        reaction_coefficients[i] = -linear_in_u/r_element_indices.size();
+        if (reaction_coefficients[i] < 0.0)
+        {
+            return nullptr;
+        }
+    }
+
+    return this->SolveUsingMultigridSolver(diffusion_coefficient, reaction_coefficients, source_terms);
+}
+
 template <unsigned DIM>
 void EllipticBoxDomainPdeModifier<DIM>::OutputSimulationModifierParameters(out_stream& rParamsFile)
 {
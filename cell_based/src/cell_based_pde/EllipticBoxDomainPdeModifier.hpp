@@ -137,6 +137,13 @@ public:
      */
     virtual std::shared_ptr<BoundaryConditionsContainer<DIM,DIM,1> > ConstructBoundaryConditionsContainer(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
 
+    /**
+     * Helper method to solve the PDE using BoxDomainMultigridSolver.
+     *
+     * @return the solution, or nullptr if the PDE is not of a form that the multigrid solver can handle
+     */
+    Vec SolveUsingMultigridSolverIfPossible();
+
     /**
      * Overridden OutputSimulationModifierParameters() method.
      * Output any simulation modifier parameters to file.
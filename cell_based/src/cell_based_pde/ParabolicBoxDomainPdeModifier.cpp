@@ -34,7 +34,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "ParabolicBoxDomainPdeModifier.hpp"
-#include "SimpleLinearParabolicSolver.hpp"
+#include "ReplicatableVector.hpp"
 
 template <unsigned DIM>
 ParabolicBoxDomainPdeModifier<DIM>::ParabolicBoxDomainPdeModifier(boost::shared_ptr<AbstractLinearPde<DIM,DIM> > pPde,
@@ -48,7 +48,10 @@ ParabolicBoxDomainPdeModifier<DIM>::ParabolicBoxDomainPdeModifier(boost::shared_
                                         isNeumannBoundaryCondition,
                                         pMeshCuboid,
                                         stepSize,
-                                        solution)
+                                        solution),
+      mReuseFeSolver(false),
+      mFeSolverTimeStep(0.0),
+      mpTimeAdaptivityController(nullptr)
 {
 }
 
@@ -69,34 +72,84 @@ void ParabolicBoxDomainPdeModifier<DIM>::UpdateAtEndOfTimeStep(AbstractCellPopul
     // Pass in already updated CellPdeElementMap to speed up finding cells.
     this->SetUpSourceTermsForAveragedSourcePde(this->mpFeMesh, &this->mCellPdeElementMap);
 
-    // Use SimpleLinearParabolicSolver as averaged Source PDE
-    SimpleLinearParabolicSolver<DIM,DIM> solver(this->mpFeMesh,
-                                                boost::static_pointer_cast<AbstractLinearParabolicPde<DIM,DIM> >(this->GetPde()).get(),
-                                                p_bcc.get());
+    // Note that each solver creates a vector, so we have to keep a handle on the old one
+    // in order to destroy it
+    Vec previous_solution = this->mSolution;
+    Vec new_solution = nullptr;
+    if (this->mUseMultigridSolver)
+    {
+        new_solution = SolveUsingMultigridSolverIfPossible();
+    }
 
-    ///\todo Investigate more than one PDE time step per spatial step
-    SimulationTime* p_simulation_time = SimulationTime::Instance();
-    double current_time = p_simulation_time->GetTime();
-    double dt = p_simulation_time->GetTimeStep();
-    solver.SetTimes(current_time,current_time + dt);
-    solver.SetTimeStep(dt);
+    if (new_solution == nullptr)
+    {
+        // Without a time adaptivity controller, take one PDE time step per spatial step
+        SimulationTime* p_simulation_time = SimulationTime::Instance();
+        double current_time = p_simulation_time->GetTime();
+        double dt = p_simulation_time->GetTimeStep();
 
-    // Use previous solution as the initial condition
-    Vec previous_solution = this->mSolution;
-    solver.SetInitialCondition(previous_solution);
+        // Use SimpleLinearParabolicSolver as averaged Source PDE, keeping it (and so its matrix) if required
+        std::shared_ptr<SimpleLinearParabolicSolver<DIM,DIM> > p_solver = mpFeSolver;
+        if (!mReuseFeSolver || !p_solver || dt != mFeSolverTimeStep)
+        {
+            p_solver.reset(new SimpleLinearParabolicSolver<DIM,DIM>(this->mpFeMesh,
+                                                                    boost::static_pointer_cast<AbstractLinearParabolicPde<DIM,DIM> >(this->GetPde()).get(),
+                                                                    p_bcc.get()));
+            p_solver->SetTimeStep(dt);
+            if (mpTimeAdaptivityController)
+            {
+                p_solver->SetTimeAdaptivityController(mpTimeAdaptivityController);
+            }
+            if (mReuseFeSolver)
+            {
+                mpFeSolver = p_solver;
+                mpFeSolverBcc = p_bcc;
+                mFeSolverTimeStep = dt;
+            }
+        }
+        p_solver->SetTimes(current_time,current_time + dt);
 
-    // Note that the linear solver creates a vector, so we have to keep a handle on the old one
-    // in order to destroy it
-    this->mSolution = solver.Solve();
+        // Use previous solution as the initial condition
+        p_solver->SetInitialCondition(previous_solution);
+        new_solution = p_solver->Solve();
+    }
+
+    this->mSolution = new_solution;
     PetscTools::Destroy(previous_solution);
     this->UpdateCellData(rCellPopulation);
 }
 
+template <unsigned DIM>
+void ParabolicBoxDomainPdeModifier<DIM>::SetReuseFeSolver(bool reuseFeSolver)
+{
+    mReuseFeSolver = reuseFeSolver;
+    mpFeSolver.reset();
+    mpFeSolverBcc.reset();
+}
+
+template <unsigned DIM>
+void ParabolicBoxDomainPdeModifier<DIM>::SetTimeAdaptivityController(AbstractTimeAdaptivityController* pController)
+{
+    mpTimeAdaptivityController = pController;
+    mpFeSolver.reset();
+    mpFeSolverBcc.reset();
+}
+
+template <unsigned DIM>
+bool ParabolicBoxDomainPdeModifier<DIM>::GetReuseFeSolver() const
+{
+    return mReuseFeSolver;
+}
+
 template <unsigned DIM>
 void ParabolicBoxDomainPdeModifier<DIM>::SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory)
 {
     AbstractBoxDomainPdeModifier<DIM>::SetupSolve(rCellPopulation,outputDirectory);
 
+    // Any solver kept from a previous simulation is no longer valid
+    mpFeSolver.reset();
+    mpFeSolverBcc.reset();
+
     // Copy the cell data to mSolution (this is the initial condition)
     SetupInitialSolutionVector(rCellPopulation);
 
@@ -140,6 +193,58 @@ std::shared_ptr<BoundaryConditionsContainer<DIM,DIM,1> > ParabolicBoxDomainPdeMo
     return p_bcc;
 }
 
+template <unsigned DIM>
+Vec ParabolicBoxDomainPdeModifier<DIM>::SolveUsingMultigridSolverIfPossible()
+{
+    AbstractLinearParabolicPde<DIM,DIM>* p_pde = boost::static_pointer_cast<AbstractLinearParabolicPde<DIM,DIM> >(this->GetPde()).get();
+    double dt = SimulationTime::Instance()->GetTimeStep();
+    ReplicatableVector previous_solution_repl(this->mSolution);
+
+    /*
+     * As in SimpleLinearParabolicSolver, take a backward Euler step in which the source term
+     * is evaluated at the previous solution:
+     *
+     *   (c/dt) u - div(D grad u) = (c/dt) u_old + f(x, u_old).
+     *
+     * The source term is lumped onto the nodes by averaging over the elements containing
+     * each node; the elements of the box domain mesh all have the same size.
+     */
+    unsigned num_nodes = this->mpFeMesh->GetNumNodes();
+    std::vector<double> reaction_coefficients(num_nodes);
+    std::vector<double> source_terms(num_nodes);
+    double diffusion_coefficient = -1.0;
+    for (unsigned i=0; i<num_nodes; i++)
+    {
+        Node<DIM>* p_node = this->mpFeMesh->GetNode(i);
+        ChastePoint<DIM> point(p_node->rGetLocation());
+        double previous_u = previous_solution_repl[i];
+
+        double source = 0.0;
+        std::set<unsigned>& r_element_indices = p_node->rGetContainingElementIndices();
+        for (std::set<unsigned>::iterator iter = r_element_indices.begin();
+             iter != r_element_indices.end();
+             ++iter)
+        {
+            Element<DIM,DIM>* p_element = this->mpFeMesh->GetElement(*iter);
+            if (!this->IsIsotropicDiffusionTerm(p_pde->ComputeDiffusionTerm(point, p_element), diffusion_coefficient))
+            {
+                return nullptr;
+            }
+            source += p_pde->ComputeSourceTerm(point, previous_u, p_element);
+        }
+
+        double du_dt_coefficient = p_pde->ComputeDuDtCoefficientFunction(point);
+        if (du_dt_coefficient <= 0.0)
+        {
+            return nullptr;
+        }
+        reaction_coefficients[i] = du_dt_coefficient/dt;
+        source_terms[i] = du_dt_coefficient*previous_u/dt + source/r_element_indices.size();
+    }
+
+    return this->SolveUsingMultigridSolver(diffusion_coefficient, reaction_coefficients, source_terms);
+}
+
 template <unsigned DIM>
 void ParabolicBoxDomainPdeModifier<DIM>::SetupInitialSolutionVector(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
 {
@@ -41,6 +41,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "AbstractBoxDomainPdeModifier.hpp"
 #include "BoundaryConditionsContainer.hpp"
+#include "SimpleLinearParabolicSolver.hpp"
 
 /**
  * A modifier class in which a linear parabolic PDE coupled to a cell-based simulation
@@ -82,6 +83,29 @@ private:
         archive & boost::serialization::base_object<AbstractBoxDomainPdeModifier<DIM> >(*this);
     }
 
+    /**
+     * Whether to keep the finite element solver, and hence its assembled matrix and
+     * preconditioner, from one time step to the next. Defaults to false.
+     * This is a run-time option, so is not archived.
+     */
+    bool mReuseFeSolver;
+
+    /** The boundary conditions used by mpFeSolver, which keeps a pointer to them. */
+    std::shared_ptr<BoundaryConditionsContainer<DIM,DIM,1> > mpFeSolverBcc;
+
+    /** The finite element solver kept between time steps if mReuseFeSolver is true. */
+    std::shared_ptr<SimpleLinearParabolicSolver<DIM,DIM> > mpFeSolver;
+
+    /** The time step for which the matrix of mpFeSolver was assembled. */
+    double mFeSolverTimeStep;
+
+    /**
+     * A time adaptivity controller for the finite element solver (defaults to NULL,
+     * meaning one PDE time step per cell-based time step).
+     * This is a run-time option, so is not archived.
+     */
+    AbstractTimeAdaptivityController* mpTimeAdaptivityController;
+
 public:
 
     /**
@@ -126,6 +150,38 @@ public:
      */
     virtual void SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory);
 
+    /**
+     * Set mReuseFeSolver.
+     *
+     * The box domain mesh does not change, so when the diffusion and du/dt coefficients of
+     * the PDE do not change either, the finite element matrix is the same at every time step.
+     * Keeping the solver then means the matrix is only assembled, and the KSP preconditioner
+     * (for example an LU or AMG factorisation) only set up, once; each time step just
+     * assembles the right-hand side from the current source terms. The solver is rebuilt if
+     * the time step changes. Do not use this option with a PDE whose diffusion or du/dt
+     * coefficient varies with time or with the cells.
+     *
+     * @param reuseFeSolver whether to keep the finite element solver between time steps
+     */
+    void SetReuseFeSolver(bool reuseFeSolver=true);
+
+    /**
+     * Set a time adaptivity controller for the finite element solver, so that
+     * each cell-based time step may be split into several PDE time steps of
+     * sizes chosen by the controller (at most the cell-based time step).
+     * The controller is not used by the multigrid solver.
+     * This is a run-time option, so is not archived. The controller is not
+     * owned by this class and must outlive the simulation.
+     *
+     * @param pController the controller, or NULL to use a single PDE step per time step
+     */
+    void SetTimeAdaptivityController(AbstractTimeAdaptivityController* pController);
+
+    /**
+     * @return mReuseFeSolver.
+     */
+    bool GetReuseFeSolver() const;
+
     /**
      * Helper method to construct the boundary conditions container for the PDE.
      *
@@ -135,6 +191,13 @@ public:
      */
     virtual std::shared_ptr<BoundaryConditionsContainer<DIM,DIM,1> > ConstructBoundaryConditionsContainer(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
 
+    /**
+     * Helper method to solve the PDE at the end of the current time step using BoxDomainMultigridSolver.
+     *
+     * @return the solution, or nullptr if the PDE is not of a form that the multigrid solver can handle
+     */
+    Vec SolveUsingMultigridSolverIfPossible();
+
     /**
      * Helper method to initialise the PDE solution using the CellData.
      *
@@ -45,7 +45,8 @@ ParabolicGrowingDomainPdeModifier<DIM>::ParabolicGrowingDomainPdeModifier(boost:
     : AbstractGrowingDomainPdeModifier<DIM>(pPde,
                                             pBoundaryCondition,
                                             isNeumannBoundaryCondition,
-                                            solution)
+                                            solution),
+      mpTimeAdaptivityController(nullptr)
 {
 }
 
@@ -70,12 +71,16 @@ void ParabolicGrowingDomainPdeModifier<DIM>::UpdateAtEndOfTimeStep(AbstractCellP
                                             boost::static_pointer_cast<AbstractLinearParabolicPde<DIM,DIM> >(this->mpPde).get(),
                                             p_bcc.get());
 
-    ///\todo Investigate more than one PDE time step per spatial step
+    // Without a time adaptivity controller, take one PDE time step per spatial step
     SimulationTime* p_simulation_time = SimulationTime::Instance();
     double current_time = p_simulation_time->GetTime();
     double dt = p_simulation_time->GetTimeStep();
     solver.SetTimes(current_time,current_time + dt);
     solver.SetTimeStep(dt);
+    if (mpTimeAdaptivityController)
+    {
+        solver.SetTimeAdaptivityController(mpTimeAdaptivityController);
+    }
 
     // Use previous solution as the initial condition
     Vec previous_solution = this->mSolution;
@@ -88,6 +93,12 @@ void ParabolicGrowingDomainPdeModifier<DIM>::UpdateAtEndOfTimeStep(AbstractCellP
     this->UpdateCellData(rCellPopulation);
 }
 
+template <unsigned DIM>
+void ParabolicGrowingDomainPdeModifier<DIM>::SetTimeAdaptivityController(AbstractTimeAdaptivityController* pController)
+{
+    mpTimeAdaptivityController = pController;
+}
+
 template <unsigned DIM>
 void ParabolicGrowingDomainPdeModifier<DIM>::SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory)
 {
@@ -41,6 +41,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "AbstractGrowingDomainPdeModifier.hpp"
 #include "BoundaryConditionsContainer.hpp"
+#include "AbstractTimeAdaptivityController.hpp"
 
 /**
  * A modifier class in which a linear parabolic PDE coupled to a cell-based simulation
@@ -79,6 +80,13 @@ private:
         archive & boost::serialization::base_object<AbstractGrowingDomainPdeModifier<DIM> >(*this);
     }
 
+    /**
+     * A time adaptivity controller for the finite element solver (defaults to NULL,
+     * meaning one PDE time step per cell-based time step).
+     * This is a run-time option, so is not archived.
+     */
+    AbstractTimeAdaptivityController* mpTimeAdaptivityController;
+
 public:
 
     /**
@@ -133,6 +141,17 @@ public:
      */
     void UpdateSolutionVector(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
 
+    /**
+     * Set a time adaptivity controller for the finite element solver, so that
+     * each cell-based time step may be split into several PDE time steps of
+     * sizes chosen by the controller (at most the cell-based time step).
+     * This is a run-time option, so is not archived. The controller is not
+     * owned by this class and must outlive the simulation.
+     *
+     * @param pController the controller, or NULL to use a single PDE step per time step
+     */
+    void SetTimeAdaptivityController(AbstractTimeAdaptivityController* pController);
+
     /**
      * Overridden OutputSimulationModifierParameters() method.
      * Output any simulation modifier parameters to file.
@@ -34,7 +34,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "AveragedSourceEllipticPde.hpp"
-#include "ApoptoticCellProperty.hpp"
+#include "AveragedSourcePdeHelper.hpp"
 
 template <unsigned DIM>
 AveragedSourceEllipticPde<DIM>::AveragedSourceEllipticPde(AbstractCellPopulation<DIM>& rCellPopulation,
@@ -61,47 +61,7 @@ double AveragedSourceEllipticPde<DIM>::GetCoefficient() const
 template <unsigned DIM>
 void AveragedSourceEllipticPde<DIM>::SetupSourceTerms(TetrahedralMesh<DIM,DIM>& rCoarseMesh, std::map< CellPtr, unsigned >* pCellPdeElementMap) // must be called before solve
 {
-    // Allocate memory
-    mCellDensityOnCoarseElements.resize(rCoarseMesh.GetNumElements());
-    for (unsigned elem_index=0; elem_index<mCellDensityOnCoarseElements.size(); elem_index++)
-    {
-        mCellDensityOnCoarseElements[elem_index] = 0.0;
-    }
-
-    // Loop over cells, find which coarse element it is in, and add 1 to mSourceTermOnCoarseElements[elem_index]
-    for (typename AbstractCellPopulation<DIM>::Iterator cell_iter = mrCellPopulation.Begin();
-         cell_iter != mrCellPopulation.End();
-         ++cell_iter)
-    {
-        unsigned elem_index = 0;
-        const ChastePoint<DIM>& r_position_of_cell = mrCellPopulation.GetLocationOfCellCentre(*cell_iter);
-
-        if (pCellPdeElementMap != nullptr)
-        {
-            elem_index = (*pCellPdeElementMap)[*cell_iter];
-        }
-        else
-        {
-            elem_index = rCoarseMesh.GetContainingElementIndex(r_position_of_cell);
-        }
-
-        // Update element map if cell has moved
-        bool cell_is_apoptotic = cell_iter->template HasCellProperty<ApoptoticCellProperty>();
-
-        if (!cell_is_apoptotic)
-        {
-            mCellDensityOnCoarseElements[elem_index] += 1.0;
-        }
-    }
-
-    // Then divide each entry of mSourceTermOnCoarseElements by the element's area
-    c_matrix<double, DIM, DIM> jacobian;
-    double det;
-    for (unsigned elem_index=0; elem_index<mCellDensityOnCoarseElements.size(); elem_index++)
-    {
-        rCoarseMesh.GetElement(elem_index)->CalculateJacobian(jacobian, det);
-        mCellDensityOnCoarseElements[elem_index] /= rCoarseMesh.GetElement(elem_index)->GetVolume(det);
-    }
+    AveragedSourcePdeHelper<DIM>::ComputeCellDensityOnCoarseElements(mrCellPopulation, rCoarseMesh, pCellPdeElementMap, mCellDensityOnCoarseElements);
 }
 
 template <unsigned DIM>
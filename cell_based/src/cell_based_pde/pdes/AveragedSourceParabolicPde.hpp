@@ -127,8 +127,6 @@ public:
     /**
      * Set up the source terms.
      *
-     * \todo this is identical to the one in AveragedSourceEllipticPde so refactor.
-     *
      * @param rCoarseMesh reference to the coarse mesh
      * @param pCellPdeElementMap optional pointer to the map from cells to coarse elements
      */
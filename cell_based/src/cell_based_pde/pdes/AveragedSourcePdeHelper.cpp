@@ -0,0 +1,103 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "AveragedSourcePdeHelper.hpp"
+#include "ApoptoticCellProperty.hpp"
+#include "PetscTools.hpp"
+
+template<unsigned DIM>
+void AveragedSourcePdeHelper<DIM>::ComputeCellDensityOnCoarseElements(AbstractCellPopulation<DIM>& rCellPopulation,
+                                                                      TetrahedralMesh<DIM,DIM>& rCoarseMesh,
+                                                                      std::map<CellPtr, unsigned>* pCellPdeElementMap,
+                                                                      std::vector<double>& rCellDensityOnCoarseElements)
+{
+    const unsigned num_elements = rCoarseMesh.GetNumElements();
+
+    // Bin each non-apoptotic cell into the coarse element containing it
+    std::vector<unsigned> cell_elements;
+    cell_elements.reserve(rCellPopulation.GetNumRealCells());
+    for (typename AbstractCellPopulation<DIM>::Iterator cell_iter = rCellPopulation.Begin();
+         cell_iter != rCellPopulation.End();
+         ++cell_iter)
+    {
+        if (cell_iter->template HasCellProperty<ApoptoticCellProperty>())
+        {
+            continue;
+        }
+
+        std::map<CellPtr, unsigned>::const_iterator map_iter;
+        if (pCellPdeElementMap != nullptr
+            && (map_iter = pCellPdeElementMap->find(*cell_iter)) != pCellPdeElementMap->end())
+        {
+            cell_elements.push_back(map_iter->second);
+        }
+        else
+        {
+            // Only locate cells that are not in the map, since computing a cell centre may itself be costly
+            const ChastePoint<DIM>& r_position_of_cell = rCellPopulation.GetLocationOfCellCentre(*cell_iter);
+            cell_elements.push_back(rCoarseMesh.GetContainingElementIndex(r_position_of_cell));
+        }
+    }
+
+    // Scatter-add the bins into per-element counts
+    std::vector<double> cell_counts(num_elements, 0.0);
+    for (unsigned i=0; i<cell_elements.size(); i++)
+    {
+        assert(cell_elements[i] < num_elements);
+        cell_counts[cell_elements[i]] += 1.0;
+    }
+
+    // Sum the counts over the cells owned by each process
+    if (PetscTools::IsParallel() && num_elements > 0)
+    {
+        std::vector<double> local_counts(cell_counts);
+        MPI_Allreduce(&local_counts[0], &cell_counts[0], num_elements, MPI_DOUBLE, MPI_SUM, PetscTools::GetWorld());
+    }
+
+    // Then divide each count by the element's volume
+    rCellDensityOnCoarseElements.resize(num_elements);
+    c_matrix<double, DIM, DIM> jacobian;
+    double det;
+    for (unsigned elem_index=0; elem_index<num_elements; elem_index++)
+    {
+        rCoarseMesh.GetElement(elem_index)->CalculateJacobian(jacobian, det);
+        rCellDensityOnCoarseElements[elem_index] = cell_counts[elem_index]/rCoarseMesh.GetElement(elem_index)->GetVolume(det);
+    }
+}
+
+// Explicit instantiation
+template class AveragedSourcePdeHelper<1>;
+template class AveragedSourcePdeHelper<2>;
+template class AveragedSourcePdeHelper<3>;
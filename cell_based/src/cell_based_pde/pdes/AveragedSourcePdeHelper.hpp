@@ -0,0 +1,80 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef AVERAGEDSOURCEPDEHELPER_HPP_
+#define AVERAGEDSOURCEPDEHELPER_HPP_
+
+#include <map>
+#include <vector>
+
+#include "AbstractCellPopulation.hpp"
+#include "TetrahedralMesh.hpp"
+
+/**
+ * Helper shared by AveragedSourceEllipticPde and AveragedSourceParabolicPde,
+ * which compute the density of non-apoptotic cells on each element of a
+ * coarse finite element mesh in the same way.
+ *
+ * Each cell is first binned into a coarse element, using the map from cells
+ * to elements maintained by the box domain PDE modifiers where one is
+ * supplied, and the counts are then accumulated in a single pass over the
+ * bins. Point location on the coarse mesh is only needed for cells that are
+ * missing from the map.
+ */
+template<unsigned DIM>
+class AveragedSourcePdeHelper
+{
+public:
+
+    /**
+     * Compute the number of non-apoptotic cells in each element of a coarse
+     * mesh, divided by the element's volume.
+     *
+     * When running in parallel each process only visits its own cells, and
+     * the per-element counts are summed over all processes, so that every
+     * process ends up with the densities for the whole population.
+     *
+     * @param rCellPopulation the cell population
+     * @param rCoarseMesh the coarse mesh
+     * @param pCellPdeElementMap optional pointer to the map from cells to coarse elements
+     * @param rCellDensityOnCoarseElements vector to fill with the density on each element
+     */
+    static void ComputeCellDensityOnCoarseElements(AbstractCellPopulation<DIM>& rCellPopulation,
+                                                   TetrahedralMesh<DIM,DIM>& rCoarseMesh,
+                                                   std::map<CellPtr, unsigned>* pCellPdeElementMap,
+                                                   std::vector<double>& rCellDensityOnCoarseElements);
+};
+
+#endif /*AVERAGEDSOURCEPDEHELPER_HPP_*/
@@ -119,6 +119,10 @@ unsigned PottsMesh<DIM>::SolveBoundaryElementMapping(unsigned index) const
 template <unsigned DIM>
 void PottsMesh<DIM>::Clear()
 {
+    mMooreNeighbourStencilIsCurrent = false;
+    mVonNeumannNeighbourStencilIsCurrent = false;
+    mElementSurfaceAreasAreCurrent = false;
+
     // Delete elements
     for (unsigned i=0; i<mElements.size(); i++)
     {
@@ -196,6 +200,99 @@ double PottsMesh<DIM>::GetVolumeOfElement(unsigned index)
 
 template <unsigned DIM>
 double PottsMesh<DIM>::GetSurfaceAreaOfElement(unsigned index)
+{
+    assert(index < mElements.size());
+    UpdateElementSurfaceAreas();
+
+    return mElementSurfaceAreas[index];
+}
+
+template <unsigned DIM>
+void PottsMesh<DIM>::UpdateElementSurfaceAreas()
+{
+    if (!mElementSurfaceAreasAreCurrent)
+    {
+        mElementSurfaceAreas.resize(mElements.size());
+        for (unsigned elem_index=0; elem_index<mElements.size(); elem_index++)
+        {
+            mElementSurfaceAreas[elem_index] = mElements[elem_index]->IsDeleted() ? 0.0 : CalculateSurfaceAreaOfElement(elem_index);
+        }
+        mElementSurfaceAreasAreCurrent = true;
+    }
+}
+
+template <unsigned DIM>
+void PottsMesh<DIM>::InvalidateElementSurfaceAreas()
+{
+    mElementSurfaceAreasAreCurrent = false;
+}
+
+template <unsigned DIM>
+void PottsMesh<DIM>::MoveNodeToElement(unsigned nodeIndex, unsigned elementIndex)
+{
+    Node<DIM>* p_node = this->mNodes[nodeIndex];
+
+    // Each node in the mesh must be in at most one element
+    assert(p_node->GetNumContainingElements() <= 1);
+    unsigned old_element_index = p_node->rGetContainingElementIndices().empty() ? UNSIGNED_UNSET : *(p_node->rGetContainingElementIndices().begin());
+    if (old_element_index == elementIndex)
+    {
+        return;
+    }
+
+    if (mElementSurfaceAreasAreCurrent)
+    {
+        /*
+         * Each lattice edge between the node and a neighbour in its old element becomes
+         * part of that element's surface, and each of the node's other edges stops being;
+         * the reverse holds for the new element.
+         */
+        unsigned neighbours_in_old_element = 0;
+        unsigned neighbours_in_new_element = 0;
+        const std::set<unsigned>& r_neighbours = mVonNeumannNeighbouringNodeIndices[nodeIndex];
+        for (std::set<unsigned>::const_iterator iter = r_neighbours.begin();
+             iter != r_neighbours.end();
+             ++iter)
+        {
+            const std::set<unsigned>& r_neighbour_elements = this->mNodes[*iter]->rGetContainingElementIndices();
+            if (!r_neighbour_elements.empty())
+            {
+                unsigned neighbour_element_index = *(r_neighbour_elements.begin());
+                if (neighbour_element_index == old_element_index)
+                {
+                    neighbours_in_old_element++;
+                }
+                else if (neighbour_element_index == elementIndex)
+                {
+                    neighbours_in_new_element++;
+                }
+            }
+        }
+
+        if (old_element_index != UNSIGNED_UNSET)
+        {
+            mElementSurfaceAreas[old_element_index] += 2.0*neighbours_in_old_element - 2.0*DIM;
+        }
+        if (elementIndex != UNSIGNED_UNSET)
+        {
+            mElementSurfaceAreas[elementIndex] += 2.0*DIM - 2.0*neighbours_in_new_element;
+        }
+    }
+
+    if (old_element_index != UNSIGNED_UNSET)
+    {
+        mElements[old_element_index]->DeleteNode(mElements[old_element_index]->GetNodeLocalIndex(nodeIndex));
+
+        ///\todo If this causes the element to have no nodes then flag the element and cell to be deleted
+    }
+    if (elementIndex != UNSIGNED_UNSET)
+    {
+        mElements[elementIndex]->AddNode(p_node);
+    }
+}
+
+template <unsigned DIM>
+double PottsMesh<DIM>::CalculateSurfaceAreaOfElement(unsigned index)
 {
     ///\todo not implemented in 3d yet
     assert(DIM==2 || DIM==3); // LCOV_EXCL_LINE
@@ -207,13 +304,13 @@ double PottsMesh<DIM>::GetSurfaceAreaOfElement(unsigned index)
     double surface_area = 0.0;
     for (unsigned node_index=0; node_index<num_nodes; node_index++)
     {
-        std::set<unsigned> neighbouring_node_indices = GetVonNeumannNeighbouringNodeIndices(p_element->GetNode(node_index)->GetIndex());
+        const std::set<unsigned>& r_neighbouring_node_indices = mVonNeumannNeighbouringNodeIndices[p_element->GetNode(node_index)->GetIndex()];
         unsigned local_edges = 2*DIM;
-        for (std::set<unsigned>::iterator iter = neighbouring_node_indices.begin();
-             iter != neighbouring_node_indices.end();
+        for (std::set<unsigned>::const_iterator iter = r_neighbouring_node_indices.begin();
+             iter != r_neighbouring_node_indices.end();
              iter++)
         {
-            std::set<unsigned> neighbouring_node_element_indices = this->mNodes[*iter]->rGetContainingElementIndices();
+            const std::set<unsigned>& neighbouring_node_element_indices = this->mNodes[*iter]->rGetContainingElementIndices();
 
             if (!(neighbouring_node_element_indices.empty()) && (local_edges!=0))
             {
@@ -235,15 +332,97 @@ std::set<unsigned> PottsMesh<DIM>::GetMooreNeighbouringNodeIndices(unsigned node
     return mMooreNeighbouringNodeIndices[nodeIndex];
 }
 
+template <unsigned DIM>
+const std::set<unsigned>& PottsMesh<DIM>::rGetMooreNeighbouringNodeIndices(unsigned nodeIndex) const
+{
+    return mMooreNeighbouringNodeIndices[nodeIndex];
+}
+
 template <unsigned DIM>
 std::set<unsigned> PottsMesh<DIM>::GetVonNeumannNeighbouringNodeIndices(unsigned nodeIndex)
 {
     return mVonNeumannNeighbouringNodeIndices[nodeIndex];
 }
 
+/**
+ * Flatten a vector of neighbour sets into compressed sparse row form.
+ *
+ * @param rNeighbourSets  the neighbours of each node
+ * @param rOffsets  filled in with the offsets of each node's neighbours
+ * @param rIndices  filled in with the neighbours of all nodes
+ */
+static void FlattenNeighbourSets(const std::vector<std::set<unsigned> >& rNeighbourSets,
+                                 std::vector<unsigned>& rOffsets,
+                                 std::vector<unsigned>& rIndices)
+{
+    rOffsets.assign(1, 0);
+    rIndices.clear();
+    for (unsigned node_index=0; node_index<rNeighbourSets.size(); node_index++)
+    {
+        rIndices.insert(rIndices.end(), rNeighbourSets[node_index].begin(), rNeighbourSets[node_index].end());
+        rOffsets.push_back(rIndices.size());
+    }
+}
+
+template <unsigned DIM>
+void PottsMesh<DIM>::UpdateMooreNeighbourStencil()
+{
+    if (!mMooreNeighbourStencilIsCurrent)
+    {
+        FlattenNeighbourSets(mMooreNeighbouringNodeIndices, mMooreNeighbourOffsets, mMooreNeighbourIndices);
+        mMooreNeighbourStencilIsCurrent = true;
+    }
+}
+
+template <unsigned DIM>
+void PottsMesh<DIM>::UpdateVonNeumannNeighbourStencil()
+{
+    if (!mVonNeumannNeighbourStencilIsCurrent)
+    {
+        FlattenNeighbourSets(mVonNeumannNeighbouringNodeIndices, mVonNeumannNeighbourOffsets, mVonNeumannNeighbourIndices);
+        mVonNeumannNeighbourStencilIsCurrent = true;
+    }
+}
+
+template <unsigned DIM>
+const std::vector<unsigned>& PottsMesh<DIM>::rGetMooreNeighbourOffsets()
+{
+    UpdateMooreNeighbourStencil();
+    return mMooreNeighbourOffsets;
+}
+
+template <unsigned DIM>
+const std::vector<unsigned>& PottsMesh<DIM>::rGetMooreNeighbourIndices()
+{
+    UpdateMooreNeighbourStencil();
+    return mMooreNeighbourIndices;
+}
+
+template <unsigned DIM>
+const std::set<unsigned>& PottsMesh<DIM>::rGetVonNeumannNeighbouringNodeIndices(unsigned nodeIndex) const
+{
+    return mVonNeumannNeighbouringNodeIndices[nodeIndex];
+}
+
+template <unsigned DIM>
+const std::vector<unsigned>& PottsMesh<DIM>::rGetVonNeumannNeighbourOffsets()
+{
+    UpdateVonNeumannNeighbourStencil();
+    return mVonNeumannNeighbourOffsets;
+}
+
+template <unsigned DIM>
+const std::vector<unsigned>& PottsMesh<DIM>::rGetVonNeumannNeighbourIndices()
+{
+    UpdateVonNeumannNeighbourStencil();
+    return mVonNeumannNeighbourIndices;
+}
+
 template <unsigned DIM>
 void PottsMesh<DIM>::DeleteElement(unsigned index)
 {
+    mElementSurfaceAreasAreCurrent = false;
+
     // Mark this element as deleted; this also updates the nodes containing element indices
     this->mElements[index]->MarkAsDeleted();
     mDeletedElementIndices.push_back(index);
@@ -252,6 +431,8 @@ void PottsMesh<DIM>::DeleteElement(unsigned index)
 template <unsigned DIM>
 void PottsMesh<DIM>::RemoveDeletedElements()
 {
+    mElementSurfaceAreasAreCurrent = false;
+
     // Remove any elements that have been removed and re-order the remaining ones
     unsigned num_deleted_elements = mDeletedElementIndices.size();
 
@@ -271,6 +452,10 @@ void PottsMesh<DIM>::RemoveDeletedElements()
 template <unsigned DIM>
 void PottsMesh<DIM>::DeleteNode(unsigned index)
 {
+    mMooreNeighbourStencilIsCurrent = false;
+    mVonNeumannNeighbourStencilIsCurrent = false;
+    mElementSurfaceAreasAreCurrent = false;
+
     //Mark node as deleted so we don't consider it when iterating over nodes
     this->mNodes[index]->MarkAsDeleted();
 
@@ -386,6 +571,8 @@ template <unsigned DIM>
 unsigned PottsMesh<DIM>::DivideElement(PottsElement<DIM>* pElement,
                                        bool placeOriginalElementBelow)
 {
+    mElementSurfaceAreasAreCurrent = false;
+
     /// Not implemented in 1d
     assert(DIM==2 || DIM==3); // LCOV_EXCL_LINE
 
@@ -512,6 +699,8 @@ unsigned PottsMesh<DIM>::DivideElement(PottsElement<DIM>* pElement,
 template <unsigned DIM>
 unsigned PottsMesh<DIM>::AddElement(PottsElement<DIM>* pNewElement)
 {
+    mElementSurfaceAreasAreCurrent = false;
+
     unsigned new_element_index = pNewElement->GetIndex();
 
     if (new_element_index == this->mElements.size())
@@ -573,6 +762,10 @@ std::set<unsigned> PottsMesh<DIM>::GetNeighbouringElementIndices(unsigned elemen
 template <unsigned DIM>
 void PottsMesh<DIM>::ConstructFromMeshReader(AbstractMeshReader<DIM, DIM>& rMeshReader)
 {
+    mMooreNeighbourStencilIsCurrent = false;
+    mVonNeumannNeighbourStencilIsCurrent = false;
+    mElementSurfaceAreasAreCurrent = false;
+
     assert(rMeshReader.HasNodePermutation() == false);
 
     // Store numbers of nodes and elements
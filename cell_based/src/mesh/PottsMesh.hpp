@@ -80,6 +80,64 @@ protected:
     /** Vector of set of Moore neighbours for each node. */
     std::vector< std::set<unsigned> > mMooreNeighbouringNodeIndices;
 
+    /**
+     * Running totals of the surface area (or perimeter in 2D) of each element, used by
+     * GetSurfaceAreaOfElement(). Computed in full when first needed and then updated
+     * by MoveNodeToElement(). Not archived.
+     */
+    std::vector<double> mElementSurfaceAreas;
+
+    /** Whether mElementSurfaceAreas is up to date. */
+    bool mElementSurfaceAreasAreCurrent;
+
+    /**
+     * The Moore neighbours of each node, stored contiguously in compressed sparse row form:
+     * the neighbours of node i are mMooreNeighbourIndices[mMooreNeighbourOffsets[i]] to
+     * mMooreNeighbourIndices[mMooreNeighbourOffsets[i+1]-1], in increasing order. Built from
+     * mMooreNeighbouringNodeIndices when first needed. Not archived.
+     */
+    std::vector<unsigned> mMooreNeighbourOffsets;
+
+    /** The Moore neighbour indices of all nodes; see mMooreNeighbourOffsets. */
+    std::vector<unsigned> mMooreNeighbourIndices;
+
+    /** Whether mMooreNeighbourOffsets and mMooreNeighbourIndices are up to date. */
+    bool mMooreNeighbourStencilIsCurrent;
+
+    /**
+     * Helper method for rGetMooreNeighbourOffsets() and rGetMooreNeighbourIndices().
+     * Rebuild the flat Moore neighbour stencil, if it is not up to date.
+     */
+    void UpdateMooreNeighbourStencil();
+
+    /**
+     * The Von Neumann neighbours of each node, stored contiguously in the same form as
+     * mMooreNeighbourOffsets and mMooreNeighbourIndices. Built from
+     * mVonNeumannNeighbouringNodeIndices when first needed. Not archived.
+     */
+    std::vector<unsigned> mVonNeumannNeighbourOffsets;
+
+    /** The Von Neumann neighbour indices of all nodes; see mVonNeumannNeighbourOffsets. */
+    std::vector<unsigned> mVonNeumannNeighbourIndices;
+
+    /** Whether mVonNeumannNeighbourOffsets and mVonNeumannNeighbourIndices are up to date. */
+    bool mVonNeumannNeighbourStencilIsCurrent;
+
+    /**
+     * Helper method for rGetVonNeumannNeighbourOffsets() and rGetVonNeumannNeighbourIndices().
+     * Rebuild the flat Von Neumann neighbour stencil, if it is not up to date.
+     */
+    void UpdateVonNeumannNeighbourStencil();
+
+    /**
+     * Helper method for UpdateElementSurfaceAreas(). Compute the surface area of a
+     * PottsElement by counting the lattice edges between its nodes and other sites.
+     *
+     * @param index  the global index of a specified PottsElement
+     * @return the surface area of the element
+     */
+    double CalculateSurfaceAreaOfElement(unsigned index);
+
     /**
      * Solve node mapping method. This overridden method is required
      * as it is pure virtual in the base class.
@@ -268,6 +326,29 @@ public:
      */
     virtual double GetSurfaceAreaOfElement(unsigned index);
 
+    /**
+     * Recompute the running totals of element surface areas used by GetSurfaceAreaOfElement(),
+     * if they are not up to date. This is called automatically when needed, but must be called
+     * before GetSurfaceAreaOfElement() is used concurrently from several threads.
+     */
+    void UpdateElementSurfaceAreas();
+
+    /**
+     * Mark the running totals of element surface areas as out of date. This must be called
+     * if PottsElements are changed directly, rather than through the methods of this class.
+     */
+    void InvalidateElementSurfaceAreas();
+
+    /**
+     * Move a lattice site to another element, or to the medium, updating the running totals
+     * of element surface areas in constant time.
+     *
+     * @param nodeIndex  the global index of the node
+     * @param elementIndex  the global index of the element the node is to move to,
+     *     or UNSIGNED_UNSET to move it to the medium
+     */
+    void MoveNodeToElement(unsigned nodeIndex, unsigned elementIndex);
+
     /**
      * Given a node, return a set containing the indices of its Moore neighbouring nodes.
      *
@@ -276,6 +357,29 @@ public:
      */
     std::set<unsigned> GetMooreNeighbouringNodeIndices(unsigned nodeIndex);
 
+    /**
+     * Given a node, return a reference to the set of indices of its Moore neighbouring nodes,
+     * avoiding the copy made by GetMooreNeighbouringNodeIndices().
+     *
+     * @param nodeIndex global index of the node
+     * @return neighbouring node indices in Moore neighbourhood
+     */
+    const std::set<unsigned>& rGetMooreNeighbouringNodeIndices(unsigned nodeIndex) const;
+
+    /**
+     * Get the offsets into rGetMooreNeighbourIndices() of the Moore neighbours of each node. This
+     * flat form of the neighbourhoods avoids set traversal in the inner loops of lattice-based
+     * simulations, and allows a random neighbour to be chosen in constant time.
+     *
+     * @return a vector of length GetNumNodes()+1, whose entries i and i+1 bound the neighbours of node i
+     */
+    const std::vector<unsigned>& rGetMooreNeighbourOffsets();
+
+    /**
+     * @return the Moore neighbour indices of all nodes, indexed by rGetMooreNeighbourOffsets().
+     */
+    const std::vector<unsigned>& rGetMooreNeighbourIndices();
+
     /**
      * Given a node, return a set containing the indices of its Von Neumann neighbouring nodes.
      *
@@ -284,6 +388,28 @@ public:
      */
     std::set<unsigned> GetVonNeumannNeighbouringNodeIndices(unsigned nodeIndex);
 
+    /**
+     * Given a node, return a reference to the set of indices of its Von Neumann neighbouring nodes,
+     * avoiding the copy made by GetVonNeumannNeighbouringNodeIndices().
+     *
+     * @param nodeIndex global index of the node
+     * @return neighbouring node indices in Von Neumann neighbourhood
+     */
+    const std::set<unsigned>& rGetVonNeumannNeighbouringNodeIndices(unsigned nodeIndex) const;
+
+    /**
+     * Get the offsets into rGetVonNeumannNeighbourIndices() of the Von Neumann neighbours of each
+     * node; the Von Neumann counterpart of rGetMooreNeighbourOffsets().
+     *
+     * @return a vector of length GetNumNodes()+1, whose entries i and i+1 bound the neighbours of node i
+     */
+    const std::vector<unsigned>& rGetVonNeumannNeighbourOffsets();
+
+    /**
+     * @return the Von Neumann neighbour indices of all nodes, indexed by rGetVonNeumannNeighbourOffsets().
+     */
+    const std::vector<unsigned>& rGetVonNeumannNeighbourIndices();
+
     /**
      * Mark a node as deleted. Note that in a Potts mesh this requires the elements and connectivity to be updated accordingley.
      *
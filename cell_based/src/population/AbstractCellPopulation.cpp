@@ -43,6 +43,9 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "SmartPointers.hpp"
 #include "CellAncestor.hpp"
 #include "ApoptoticCellProperty.hpp"
+#include "BackgroundResultsWriter.hpp"
+#include "CellBasedBinaryResultsFile.hpp"
+#include "Warnings.hpp"
 
 // Cell writers
 #include "BoundaryNodeWriter.hpp"
@@ -68,11 +71,15 @@ template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>::AbstractCellPopulation( AbstractMesh<ELEMENT_DIM, SPACE_DIM>& rMesh,
                                     std::vector<CellPtr>& rCells,
                                     const std::vector<unsigned> locationIndices)
-    : mrMesh(rMesh),
+    : AbstractMemoryAccountable(MemoryAccounting::CELL_POPULATION),
+      mrMesh(rMesh),
       mCells(rCells.begin(), rCells.end()),
       mCentroid(zero_vector<double>(SPACE_DIM)),
       mpCellPropertyRegistry(CellPropertyRegistry::Instance()->TakeOwnership()),
-      mOutputResultsForChasteVisualizer(true)
+      mOutputResultsForChasteVisualizer(true),
+      mOutputResultsInBinaryFile(false),
+      mVtkOutputSamplingMultiple(1),
+      mNumResultsWritten(0)
 {
     /*
      * To avoid double-counting problems, clear the passed-in cells vector.
@@ -104,7 +111,11 @@ AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>::AbstractCellPopulation( Abstract
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>::AbstractCellPopulation(AbstractMesh<ELEMENT_DIM, SPACE_DIM>& rMesh)
-    : mrMesh(rMesh)
+    : AbstractMemoryAccountable(MemoryAccounting::CELL_POPULATION),
+      mrMesh(rMesh),
+      mOutputResultsInBinaryFile(false),
+      mVtkOutputSamplingMultiple(1),
+      mNumResultsWritten(0)
 {
 }
 
@@ -113,6 +124,23 @@ AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>::~AbstractCellPopulation()
 {
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+double AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>::GetMemoryUsage() const
+{
+    // Each std::list/std::map/std::set node carries roughly three or four pointers of overhead
+    const double node_overhead = 4*sizeof(void*);
+    double bytes = mCells.size()*(sizeof(Cell) + sizeof(CellPtr) + node_overhead);
+    bytes += mCellLocationMap.size()*(sizeof(std::pair<Cell*, unsigned>) + node_overhead);
+    for (typename std::map<unsigned, std::set<CellPtr> >::const_iterator it = mLocationCellMap.begin();
+         it != mLocationCellMap.end();
+         ++it)
+    {
+        bytes += sizeof(std::pair<unsigned, std::set<CellPtr> >) + node_overhead;
+        bytes += it->second.size()*(sizeof(CellPtr) + node_overhead);
+    }
+    return bytes;
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>::InitialiseCells()
 {
@@ -481,6 +509,12 @@ void AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>::CloseRoundRobinWritersFiles
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>::CloseWritersFiles()
 {
+    // Wait for any results still being written in the background
+    if (mpBackgroundResultsWriter)
+    {
+        mpBackgroundResultsWriter->Flush();
+    }
+
     typedef AbstractCellWriter<ELEMENT_DIM, SPACE_DIM> cell_writer_t;
     BOOST_FOREACH(boost::shared_ptr<cell_writer_t> p_cell_writer, mCellWriters)
     {
@@ -503,8 +537,18 @@ void AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>::CloseWritersFiles()
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>::OpenWritersFiles(OutputFileHandler& rOutputFileHandler)
 {
+    mNumResultsWritten = 0;
+
 #ifdef CHASTE_VTK
-    mpVtkMetaFile = rOutputFileHandler.OpenOutputFile("results.pvd");
+    if (PetscTools::AmMaster())
+    {
+        mpVtkMetaFile = rOutputFileHandler.OpenOutputFile("results.pvd");
+    }
+    else
+    {
+        // Only the master process writes the .pvd file; other processes write to a stream with no file attached
+        mpVtkMetaFile.reset(new std::ofstream);
+    }
     *mpVtkMetaFile << "<?xml version=\"1.0\"?>\n";
     *mpVtkMetaFile << "<VTKFile type=\"Collection\" version=\"0.1\" byte_order=\"LittleEndian\" compressor=\"vtkZLibDataCompressor\">\n";
     *mpVtkMetaFile << "    <Collection>\n";
@@ -526,28 +570,73 @@ void AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>::OpenWritersFiles(OutputFile
         }
     }
 
-    // Open output files for any cell writers
+    // Open output files (or buffers) for any cell writers
     typedef AbstractCellWriter<ELEMENT_DIM, SPACE_DIM> cell_writer_t;
     BOOST_FOREACH(boost::shared_ptr<cell_writer_t> p_cell_writer, mCellWriters)
     {
-        p_cell_writer->OpenOutputFile(rOutputFileHandler);
+        if (mOutputResultsInBinaryFile)
+        {
+            p_cell_writer->OpenOutputBuffer();
+        }
+        else
+        {
+            p_cell_writer->OpenOutputFile(rOutputFileHandler);
+        }
     }
 
-    // Open output files and write headers for any population writers
+    // Open output files (or buffers) and write headers for any population writers
     typedef AbstractCellPopulationWriter<ELEMENT_DIM, SPACE_DIM> pop_writer_t;
     BOOST_FOREACH(boost::shared_ptr<pop_writer_t> p_pop_writer, mCellPopulationWriters)
     {
-        p_pop_writer->OpenOutputFile(rOutputFileHandler);
+        if (mOutputResultsInBinaryFile)
+        {
+            p_pop_writer->OpenOutputBuffer();
+        }
+        else
+        {
+            p_pop_writer->OpenOutputFile(rOutputFileHandler);
+        }
         p_pop_writer->WriteHeader(this);
     }
 
-    // Open output files and write headers for any population count writers
+    // Open output files (or buffers) and write headers for any population count writers
     typedef AbstractCellPopulationCountWriter<ELEMENT_DIM, SPACE_DIM> count_writer_t;
     BOOST_FOREACH(boost::shared_ptr<count_writer_t> p_count_writer, mCellPopulationCountWriters)
     {
-        p_count_writer->OpenOutputFile(rOutputFileHandler);
+        if (mOutputResultsInBinaryFile)
+        {
+            p_count_writer->OpenOutputBuffer();
+        }
+        else
+        {
+            p_count_writer->OpenOutputFile(rOutputFileHandler);
+        }
         p_count_writer->WriteHeader(this);
     }
+
+    // The master process creates the binary results file, starting with the headers
+    if (mOutputResultsInBinaryFile && PetscTools::AmMaster())
+    {
+        if (mpBackgroundResultsWriter)
+        {
+            mpBackgroundResultsWriter->Flush();
+        }
+
+        CellBasedBinaryResultsFile results_file;
+        BOOST_FOREACH(boost::shared_ptr<cell_writer_t> p_cell_writer, mCellWriters)
+        {
+            results_file.AddEntry(p_cell_writer->GetFileName(), p_cell_writer->TakeBufferedOutput());
+        }
+        BOOST_FOREACH(boost::shared_ptr<pop_writer_t> p_pop_writer, mCellPopulationWriters)
+        {
+            results_file.AddEntry(p_pop_writer->GetFileName(), p_pop_writer->TakeBufferedOutput());
+        }
+        BOOST_FOREACH(boost::shared_ptr<count_writer_t> p_count_writer, mCellPopulationCountWriters)
+        {
+            results_file.AddEntry(p_count_writer->GetFileName(), p_count_writer->TakeBufferedOutput());
+        }
+        results_file.WriteChunk(rOutputFileHandler, false);
+    }
 }
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
@@ -565,6 +654,39 @@ void AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>::OpenRoundRobinWritersFilesF
     }
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>::OpenRoundRobinWritersBuffers()
+{
+    typedef AbstractCellWriter<ELEMENT_DIM, SPACE_DIM> cell_writer_t;
+    typedef AbstractCellPopulationWriter<ELEMENT_DIM, SPACE_DIM> pop_writer_t;
+    BOOST_FOREACH(boost::shared_ptr<cell_writer_t> p_cell_writer, mCellWriters)
+    {
+        p_cell_writer->OpenOutputBuffer();
+    }
+    BOOST_FOREACH(boost::shared_ptr<pop_writer_t> p_pop_writer, mCellPopulationWriters)
+    {
+        p_pop_writer->OpenOutputBuffer();
+    }
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>::WriteRoundRobinWritersBuffers(OutputFileHandler& rOutputFileHandler)
+{
+    typedef AbstractCellWriter<ELEMENT_DIM, SPACE_DIM> cell_writer_t;
+    typedef AbstractCellPopulationWriter<ELEMENT_DIM, SPACE_DIM> pop_writer_t;
+
+    CellBasedBinaryResultsFile results_file;
+    BOOST_FOREACH(boost::shared_ptr<cell_writer_t> p_cell_writer, mCellWriters)
+    {
+        results_file.AddEntry(p_cell_writer->GetFileName(), p_cell_writer->TakeBufferedOutput());
+    }
+    BOOST_FOREACH(boost::shared_ptr<pop_writer_t> p_pop_writer, mCellPopulationWriters)
+    {
+        results_file.AddEntry(p_pop_writer->GetFileName(), p_pop_writer->TakeBufferedOutput());
+    }
+    WriteBinaryResultsChunk(results_file, rOutputFileHandler);
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>::WriteResultsToFiles(const std::string& rDirectory)
 {
@@ -579,7 +701,14 @@ void AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>::WriteResultsToFiles(const s
 
         PetscTools::BeginRoundRobin();
         {
-            OpenRoundRobinWritersFilesForAppend(output_file_handler);
+            if (mOutputResultsInBinaryFile)
+            {
+                OpenRoundRobinWritersBuffers();
+            }
+            else
+            {
+                OpenRoundRobinWritersFilesForAppend(output_file_handler);
+            }
 
             // The master process writes time stamps
             if (PetscTools::AmMaster())
@@ -615,6 +744,10 @@ void AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>::WriteResultsToFiles(const s
                     p_pop_writer->WriteNewline();
                 }
             }
+            if (mOutputResultsInBinaryFile)
+            {
+                WriteRoundRobinWritersBuffers(output_file_handler);
+            }
             CloseRoundRobinWritersFiles();
         }
         PetscTools::EndRoundRobin();
@@ -624,10 +757,17 @@ void AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>::WriteResultsToFiles(const s
 
         if (PetscTools::AmMaster())
         {
-            // Open mCellPopulationCountWriters in append mode for writing, and write time stamps
+            // Open mCellPopulationCountWriters in append mode (or buffers) for writing, and write time stamps
             BOOST_FOREACH(boost::shared_ptr<count_writer_t> p_count_writer, mCellPopulationCountWriters)
             {
-                p_count_writer->OpenOutputFileForAppend(output_file_handler);
+                if (mOutputResultsInBinaryFile)
+                {
+                    p_count_writer->OpenOutputBuffer();
+                }
+                else
+                {
+                    p_count_writer->OpenOutputFileForAppend(output_file_handler);
+                }
                 p_count_writer->WriteTimeStamp();
             }
         }
@@ -641,19 +781,29 @@ void AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>::WriteResultsToFiles(const s
         if (PetscTools::AmMaster())
         {
             // Add a newline and close any output files
+            CellBasedBinaryResultsFile results_file;
             BOOST_FOREACH(boost::shared_ptr<count_writer_t> p_count_writer, mCellPopulationCountWriters)
             {
                 p_count_writer->WriteNewline();
+                if (mOutputResultsInBinaryFile)
+                {
+                    results_file.AddEntry(p_count_writer->GetFileName(), p_count_writer->TakeBufferedOutput());
+                }
                 p_count_writer->CloseFile();
             }
+            if (results_file.GetNumEntries() > 0)
+            {
+                WriteBinaryResultsChunk(results_file, output_file_handler);
+            }
         }
     }
 
     // VTK can only be written in 2 or 3 dimensions
-    if (SPACE_DIM > 1)
+    if (SPACE_DIM > 1 && mNumResultsWritten%mVtkOutputSamplingMultiple == 0)
     {
        WriteVtkResultsToFile(rDirectory);
     }
+    mNumResultsWritten++;
 }
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
@@ -767,6 +917,81 @@ void AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>::SetOutputResultsForChasteVi
     mOutputResultsForChasteVisualizer = outputResultsForChasteVisualizer;
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>::SetOutputResultsInBinaryFile(bool outputResultsInBinaryFile)
+{
+    mOutputResultsInBinaryFile = outputResultsInBinaryFile;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>::GetOutputResultsInBinaryFile() const
+{
+    return mOutputResultsInBinaryFile;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>::SetVtkOutputSamplingMultiple(unsigned vtkOutputSamplingMultiple)
+{
+    if (vtkOutputSamplingMultiple == 0)
+    {
+        EXCEPTION("The VTK output sampling multiple must be at least one.");
+    }
+    mVtkOutputSamplingMultiple = vtkOutputSamplingMultiple;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>::GetVtkOutputSamplingMultiple() const
+{
+    return mVtkOutputSamplingMultiple;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>::SetWriteResultsAsynchronously(bool writeAsynchronously, unsigned maxQueueLength)
+{
+    if (writeAsynchronously && !mOutputResultsInBinaryFile)
+    {
+        EXCEPTION("Asynchronous output requires results to be written to a binary file; call SetOutputResultsInBinaryFile() first.");
+    }
+
+    // Finish writing anything queued by an existing background writer
+    if (mpBackgroundResultsWriter)
+    {
+        mpBackgroundResultsWriter->Flush();
+        mpBackgroundResultsWriter.reset();
+    }
+
+    if (writeAsynchronously)
+    {
+        if (!PetscTools::IsSequential())
+        {
+            WARNING("Processes must append to the binary results file in turn, so results will be written synchronously.");
+        }
+        else
+        {
+            mpBackgroundResultsWriter.reset(new BackgroundResultsWriter(maxQueueLength));
+        }
+    }
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>::GetWriteResultsAsynchronously() const
+{
+    return bool(mpBackgroundResultsWriter);
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>::WriteBinaryResultsChunk(CellBasedBinaryResultsFile& rResultsFile, OutputFileHandler& rOutputFileHandler)
+{
+    if (mpBackgroundResultsWriter)
+    {
+        mpBackgroundResultsWriter->Enqueue(rResultsFile, rOutputFileHandler);
+    }
+    else
+    {
+        rResultsFile.WriteChunk(rOutputFileHandler);
+    }
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 bool AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>::IsRoomToDivide(CellPtr pCell)
 {
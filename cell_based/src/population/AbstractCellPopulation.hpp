@@ -59,6 +59,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "TetrahedralMesh.hpp"
 #include "CellPropertyRegistry.hpp"
 #include "Identifiable.hpp"
+#include "AbstractMemoryAccountable.hpp"
 #include "AbstractCellPopulationCountWriter.hpp"
 #include "AbstractCellPopulationWriter.hpp"
 #include "AbstractCellWriter.hpp"
@@ -66,13 +67,17 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // Forward declaration prevents circular include chain
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM> class AbstractCellBasedSimulation;
 
+// Forward declaration keeps the threading headers out of this header
+class BackgroundResultsWriter;
+class CellBasedBinaryResultsFile;
+
 /**
  * An abstract facade class encapsulating a cell population.
  *
  * Contains a group of cells and associated methods.
  */
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM=ELEMENT_DIM>
-class AbstractCellPopulation : public Identifiable
+class AbstractCellPopulation : public Identifiable, public AbstractMemoryAccountable
 {
 private:
 
@@ -117,6 +122,20 @@ private:
      */
     void CloseRoundRobinWritersFiles();
 
+    /**
+     * Open all writers in mCellPopulationWriters and mCellWriters for writing into
+     * in-memory buffers, for use when mOutputResultsInBinaryFile is true.
+     */
+    void OpenRoundRobinWritersBuffers();
+
+    /**
+     * Append the output buffered by all writers in mCellPopulationWriters and mCellWriters
+     * to the binary results file as a single chunk.
+     *
+     * @param rOutputFileHandler handler for the directory containing the binary results file.
+     */
+    void WriteRoundRobinWritersBuffers(OutputFileHandler& rOutputFileHandler);
+
 protected:
 
     /** Map location (node or VertexElement) indices back to cells. */
@@ -143,6 +162,37 @@ protected:
     /** Whether to write results to file for visualization using the Chaste java visualizer (defaults to true). */
     bool mOutputResultsForChasteVisualizer;
 
+    /**
+     * Whether to collect the output of all writers into a single binary results file
+     * (see CellBasedBinaryResultsFile), rather than writing a text file per writer
+     * (defaults to false). This is a run-time setting and is not archived.
+     */
+    bool mOutputResultsInBinaryFile;
+
+    /**
+     * VTK results are written on every mVtkOutputSamplingMultiple-th call to
+     * WriteResultsToFiles() (defaults to 1). This is a run-time setting and is not archived.
+     */
+    unsigned mVtkOutputSamplingMultiple;
+
+    /** The number of calls to WriteResultsToFiles() since OpenWritersFiles() was called. */
+    unsigned mNumResultsWritten;
+
+    /**
+     * If set, writes the binary results file from a background thread (see
+     * SetWriteResultsAsynchronously()). This is a run-time setting and is not archived.
+     */
+    boost::shared_ptr<BackgroundResultsWriter> mpBackgroundResultsWriter;
+
+    /**
+     * Append a chunk to the binary results file, either directly or by handing it to
+     * mpBackgroundResultsWriter.
+     *
+     * @param rResultsFile the chunk
+     * @param rOutputFileHandler handler for the directory containing the binary results file.
+     */
+    void WriteBinaryResultsChunk(CellBasedBinaryResultsFile& rResultsFile, OutputFileHandler& rOutputFileHandler);
+
     /** A list of cell writers. */
     std::vector<boost::shared_ptr<AbstractCellWriter<ELEMENT_DIM, SPACE_DIM> > > mCellWriters;
 
@@ -207,6 +257,16 @@ public:
      */
     virtual ~AbstractCellPopulation();
 
+    /**
+     * Estimate the memory held by this cell population, for MemoryAccounting.
+     * Counts the cells themselves, the list of cells and the location maps.
+     * Cell-cycle models, SRN models and cell data are not included, so this is
+     * a lower bound; the mesh is accounted for separately.
+     *
+     * @return the estimated number of bytes
+     */
+    virtual double GetMemoryUsage() const;
+
     /**
      * Initialise each cell's cell-cycle model.
      */
@@ -806,6 +866,61 @@ public:
      */
     void SetOutputResultsForChasteVisualizer(bool outputResultsForChasteVisualizer);
 
+    /**
+     * Set mOutputResultsInBinaryFile. If true, the output of all cell, population and
+     * population count writers is written to a single binary results file named
+     * CellBasedBinaryResultsFile::DEFAULT_FILE_NAME, from which the usual text files may
+     * be recovered using CellBasedBinaryResultsFile::ConvertToLegacyFiles().
+     *
+     * This must be called before OpenWritersFiles().
+     *
+     * @param outputResultsInBinaryFile the new value of mOutputResultsInBinaryFile
+     */
+    void SetOutputResultsInBinaryFile(bool outputResultsInBinaryFile=true);
+
+    /**
+     * @return mOutputResultsInBinaryFile
+     */
+    bool GetOutputResultsInBinaryFile() const;
+
+    /**
+     * Set mVtkOutputSamplingMultiple, so that VTK results are written only on every
+     * vtkOutputSamplingMultiple-th output time step. Each VTK output step writes a
+     * new .vtu file (or, in parallel, a .vtu piece per process and a .pvtu index), so
+     * this bounds the number of files produced by long simulations with frequent output
+     * without affecting the other results files.
+     *
+     * @param vtkOutputSamplingMultiple the new value of mVtkOutputSamplingMultiple
+     */
+    void SetVtkOutputSamplingMultiple(unsigned vtkOutputSamplingMultiple);
+
+    /**
+     * @return mVtkOutputSamplingMultiple
+     */
+    unsigned GetVtkOutputSamplingMultiple() const;
+
+    /**
+     * Set whether the binary results file is written from a background thread. The
+     * output of the writers is still gathered at each output time step, while the
+     * simulation waits, but the simulation can then carry on while it is written to
+     * disk. At most maxQueueLength output time steps may be waiting to be written
+     * before the simulation waits for the oldest of them; all outstanding output is
+     * written by CloseWritersFiles().
+     *
+     * This requires SetOutputResultsInBinaryFile() to have been called. In parallel,
+     * processes must append to the binary results file in turn, so a warning is given
+     * and results are written synchronously.
+     *
+     * @param writeAsynchronously whether to write the binary results file from a background thread
+     * @param maxQueueLength the maximum number of output time steps waiting to be written (defaults to 4)
+     */
+    void SetWriteResultsAsynchronously(bool writeAsynchronously=true, unsigned maxQueueLength=4);
+
+    /**
+     * @return whether the binary results file is written from a background thread
+     */
+    bool GetWriteResultsAsynchronously() const;
+
     /**
      * @return The width (maximum distance to centroid) of the cell population
      *     in each dimension
@@ -178,6 +178,12 @@ void AbstractCentreBasedCellPopulation<ELEMENT_DIM, SPACE_DIM>::UnmarkSpring(std
     mMarkedSprings.erase(rCellPair);
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned AbstractCentreBasedCellPopulation<ELEMENT_DIM, SPACE_DIM>::GetNumMarkedSprings() const
+{
+    return mMarkedSprings.size();
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 bool AbstractCentreBasedCellPopulation<ELEMENT_DIM, SPACE_DIM>::IsCellAssociatedWithADeletedLocation(CellPtr pCell)
 {
@@ -208,6 +208,11 @@ public:
      */
     void UnmarkSpring(std::pair<CellPtr,CellPtr>& rCellPair);
 
+    /**
+     * @return the number of marked springs.
+     */
+    unsigned GetNumMarkedSprings() const;
+
     /**
      * Overridden IsCellAssociatedWithADeletedLocation() method.
      *
@@ -171,11 +171,11 @@ template <unsigned DIM>
 std::set<unsigned> CaBasedCellPopulation<DIM>::GetNeighbouringLocationIndices(CellPtr pCell)
 {
     unsigned index = this->GetLocationIndexUsingCell(pCell);
-    std::set<unsigned> candidates = static_cast<PottsMesh<DIM>& >((this->mrMesh)).GetMooreNeighbouringNodeIndices(index);
+    const std::set<unsigned>& r_candidates = static_cast<PottsMesh<DIM>& >((this->mrMesh)).rGetMooreNeighbouringNodeIndices(index);
 
     std::set<unsigned> neighbour_indices;
-    for (std::set<unsigned>::iterator iter = candidates.begin();
-         iter != candidates.end();
+    for (std::set<unsigned>::const_iterator iter = r_candidates.begin();
+         iter != r_candidates.end();
          ++iter)
     {
         if (!IsSiteAvailable(*iter, pCell))
@@ -282,12 +282,19 @@ unsigned CaBasedCellPopulation<DIM>::RemoveDeadCells()
 template <unsigned DIM>
 void CaBasedCellPopulation<DIM>::UpdateCellLocations(double dt)
 {
+    // Use the flat form of the Moore neighbourhoods to avoid set traversal in the loops below
+    PottsMesh<DIM>& r_mesh = static_cast<PottsMesh<DIM>& >((this->mrMesh));
+    const std::vector<unsigned>& r_neighbour_offsets = r_mesh.rGetMooreNeighbourOffsets();
+    const std::vector<unsigned>& r_neighbour_indices = r_mesh.rGetMooreNeighbourIndices();
+
     /*
      * Here we loop over the nodes and calculate the probability of moving
      * and then select the node to move to.
      */
     if (!(this->mUpdateRuleCollection.empty()))
     {
+        std::vector<double> neighbouring_node_propensities;
+
         // Iterate over cells
         ///\todo make this sweep random
         for (std::list<CellPtr>::iterator cell_iter = this->mCells.begin();
@@ -298,24 +305,20 @@ void CaBasedCellPopulation<DIM>::UpdateCellLocations(double dt)
             unsigned node_index = this->GetLocationIndexUsingCell(*cell_iter);
 
             // Find a random available neighbouring node to overwrite current site
-            std::set<unsigned> neighbouring_node_indices = static_cast<PottsMesh<DIM>& >((this->mrMesh)).GetMooreNeighbouringNodeIndices(node_index);
-            std::vector<double> neighbouring_node_propensities;
-            std::vector<unsigned> neighbouring_node_indices_vector;
+            unsigned first_neighbour = r_neighbour_offsets[node_index];
+            unsigned num_neighbours = r_neighbour_offsets[node_index + 1] - first_neighbour;
 
-            if (!neighbouring_node_indices.empty())
+            if (num_neighbours > 0)
             {
-                unsigned num_neighbours = neighbouring_node_indices.size();
                 double probability_of_not_moving = 1.0;
+                neighbouring_node_propensities.assign(num_neighbours, 0.0);
 
-                for (std::set<unsigned>::iterator iter = neighbouring_node_indices.begin();
-                     iter != neighbouring_node_indices.end();
-                     ++iter)
+                for (unsigned counter=0; counter<num_neighbours; counter++)
                 {
+                    unsigned neighbour_index = r_neighbour_indices[first_neighbour + counter];
                     double probability_of_moving = 0.0;
 
-                    neighbouring_node_indices_vector.push_back(*iter);
-
-                    if (IsSiteAvailable(*iter, *cell_iter))
+                    if (IsSiteAvailable(neighbour_index, *cell_iter))
                     {
                         // Iterating over the update rule
                         for (typename std::vector<boost::shared_ptr<AbstractUpdateRule<DIM> > >::iterator iter_rule = this->mUpdateRuleCollection.begin();
@@ -323,7 +326,7 @@ void CaBasedCellPopulation<DIM>::UpdateCellLocations(double dt)
                              ++iter_rule)
                         {
                             // This static cast is fine, since we assert the update rule must be a CA update rule in AddUpdateRule()
-                            double p = (boost::static_pointer_cast<AbstractCaUpdateRule<DIM> >(*iter_rule))->EvaluateProbability(node_index, *iter, *this, dt, 1, *cell_iter);
+                            double p = (boost::static_pointer_cast<AbstractCaUpdateRule<DIM> >(*iter_rule))->EvaluateProbability(node_index, neighbour_index, *this, dt, 1, *cell_iter);
                             probability_of_moving += p;
                             if (probability_of_moving < 0)
                             {
@@ -337,11 +340,7 @@ void CaBasedCellPopulation<DIM>::UpdateCellLocations(double dt)
                         }
 
                         probability_of_not_moving -= probability_of_moving;
-                        neighbouring_node_propensities.push_back(probability_of_moving);
-                    }
-                    else
-                    {
-                        neighbouring_node_propensities.push_back(0.0);
+                        neighbouring_node_propensities[counter] = probability_of_moving;
                     }
                 }
                 if (probability_of_not_moving < 0)
@@ -360,7 +359,7 @@ void CaBasedCellPopulation<DIM>::UpdateCellLocations(double dt)
                     if (total_probability >= random_number)
                     {
                         // Move the cell to this neighbour location
-                        unsigned chosen_neighbour_location_index = neighbouring_node_indices_vector[counter];
+                        unsigned chosen_neighbour_location_index = r_neighbour_indices[first_neighbour + counter];
                         this->MoveCellInLocationMap((*cell_iter), node_index, chosen_neighbour_location_index);
                         break;
                     }
@@ -410,21 +409,13 @@ void CaBasedCellPopulation<DIM>::UpdateCellLocations(double dt)
             }
 
             // Find a random available neighbouring node to switch cells with the current site
-            std::set<unsigned> neighbouring_node_indices = static_cast<PottsMesh<DIM>& >((this->mrMesh)).GetMooreNeighbouringNodeIndices(node_index);
-
-            unsigned neighbour_location_index;
+            unsigned first_neighbour = r_neighbour_offsets[node_index];
+            unsigned num_neighbours = r_neighbour_offsets[node_index + 1] - first_neighbour;
 
-            if (!neighbouring_node_indices.empty())
+            if (num_neighbours > 0)
             {
-                unsigned num_neighbours = neighbouring_node_indices.size();
                 unsigned chosen_neighbour = p_gen->randMod(num_neighbours);
-
-                std::set<unsigned>::iterator neighbour_iter = neighbouring_node_indices.begin();
-                for (unsigned j=0; j<chosen_neighbour; j++)
-                {
-                    neighbour_iter++;
-                }
-                neighbour_location_index = *neighbour_iter;
+                unsigned neighbour_location_index = r_neighbour_indices[first_neighbour + chosen_neighbour];
 
                 bool is_cell_on_node_index = mAvailableSpaces[node_index] == 0 ? true : false;
                 bool is_cell_on_neighbour_location_index = mAvailableSpaces[neighbour_location_index] == 0 ? true : false;
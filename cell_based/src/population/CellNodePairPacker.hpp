@@ -0,0 +1,217 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef CELLNODEPAIRPACKER_HPP_
+#define CELLNODEPAIRPACKER_HPP_
+
+// Needs to be first as includes archive headers
+#include "ObjectCommunicator.hpp"
+
+#include <boost/serialization/vector.hpp>
+
+#include <vector>
+#include <utility>
+
+#include "Cell.hpp"
+#include "Node.hpp"
+
+/**
+ * Specialisation of ObjectPacker for the lists of cells and nodes which a
+ * NodeBasedCellPopulation sends to neighbouring processes when cells migrate
+ * and when halo cells are refreshed.
+ *
+ * The nodes are written field by field as raw bytes: location, index, boundary
+ * flag and, if present, attributes, region, radius, particle flag and applied
+ * force. The cells, whose cell-cycle models, SRN models and properties may
+ * be of any type, are written together in a single boost binary archive, so
+ * only one archive is built per message and none of it is spent on the nodes.
+ */
+template <unsigned DIM>
+class ObjectPacker<std::vector<std::pair<CellPtr, Node<DIM>* > > >
+{
+private:
+
+    /**
+     * Append the bytes of a value to a buffer.
+     *
+     * @param rBuffer the buffer
+     * @param rValue the value
+     */
+    template <typename T>
+    static void Write(std::string& rBuffer, const T& rValue)
+    {
+        rBuffer.append(reinterpret_cast<const char*>(&rValue), sizeof(T));
+    }
+
+    /**
+     * Read a value from a buffer and advance the read position past it.
+     *
+     * @param pBuffer the buffer
+     * @param rPosition the read position, updated
+     * @param bufferLength the number of bytes in the buffer
+     * @return the value.
+     */
+    template <typename T>
+    static T Read(const char* pBuffer, unsigned& rPosition, unsigned bufferLength)
+    {
+        assert(rPosition + sizeof(T) <= bufferLength);
+        T value;
+        memcpy(&value, pBuffer + rPosition, sizeof(T));
+        rPosition += sizeof(T);
+        return value;
+    }
+
+public:
+
+    /**
+     * Pack a list of cells and nodes into a string of bytes.
+     *
+     * @param pObject the list to pack
+     * @param rBuffer filled in with the packed list
+     */
+    static void Pack(boost::shared_ptr<std::vector<std::pair<CellPtr, Node<DIM>* > > > const pObject, std::string& rBuffer)
+    {
+        const std::vector<std::pair<CellPtr, Node<DIM>* > >& r_pairs = *pObject;
+
+        rBuffer.clear();
+        Write(rBuffer, (unsigned)r_pairs.size());
+
+        std::vector<CellPtr> cells(r_pairs.size());
+        for (unsigned i=0; i<r_pairs.size(); i++)
+        {
+            Node<DIM>* p_node = r_pairs[i].second;
+            for (unsigned d=0; d<DIM; d++)
+            {
+                Write(rBuffer, p_node->rGetLocation()[d]);
+            }
+            Write(rBuffer, p_node->GetIndex());
+            Write(rBuffer, (char)p_node->IsBoundaryNode());
+
+            bool has_attributes = p_node->HasNodeAttributes();
+            Write(rBuffer, (char)has_attributes);
+            if (has_attributes)
+            {
+                std::vector<double>& r_attributes = p_node->rGetNodeAttributes();
+                Write(rBuffer, (unsigned)r_attributes.size());
+                for (unsigned j=0; j<r_attributes.size(); j++)
+                {
+                    Write(rBuffer, r_attributes[j]);
+                }
+                Write(rBuffer, p_node->GetRegion());
+                Write(rBuffer, p_node->GetRadius());
+                Write(rBuffer, (char)p_node->IsParticle());
+                for (unsigned d=0; d<DIM; d++)
+                {
+                    Write(rBuffer, p_node->rGetAppliedForce()[d]);
+                }
+            }
+
+            cells[i] = r_pairs[i].first;
+        }
+
+        // The cells go through boost, which knows how to save their models and properties
+        std::ostringstream ss(std::ios::binary);
+        {
+            boost::archive::binary_oarchive output_arch(ss);
+            output_arch << cells;
+        }
+        rBuffer.append(ss.str());
+    }
+
+    /**
+     * Unpack a list of cells and nodes from a string of bytes created by Pack().
+     * The nodes are newly allocated; the caller takes ownership of them.
+     *
+     * @param pBuffer the packed list
+     * @param bufferLength the number of bytes in the buffer
+     * @return the list.
+     */
+    static boost::shared_ptr<std::vector<std::pair<CellPtr, Node<DIM>* > > > Unpack(const char* pBuffer, unsigned bufferLength)
+    {
+        unsigned position = 0;
+        unsigned num_pairs = Read<unsigned>(pBuffer, position, bufferLength);
+
+        boost::shared_ptr<std::vector<std::pair<CellPtr, Node<DIM>* > > > p_pairs(new std::vector<std::pair<CellPtr, Node<DIM>* > >(num_pairs));
+        for (unsigned i=0; i<num_pairs; i++)
+        {
+            c_vector<double, DIM> location;
+            for (unsigned d=0; d<DIM; d++)
+            {
+                location[d] = Read<double>(pBuffer, position, bufferLength);
+            }
+            unsigned index = Read<unsigned>(pBuffer, position, bufferLength);
+            bool is_boundary = Read<char>(pBuffer, position, bufferLength);
+
+            Node<DIM>* p_node = new Node<DIM>(index, location, is_boundary);
+
+            bool has_attributes = Read<char>(pBuffer, position, bufferLength);
+            if (has_attributes)
+            {
+                unsigned num_attributes = Read<unsigned>(pBuffer, position, bufferLength);
+                for (unsigned j=0; j<num_attributes; j++)
+                {
+                    p_node->AddNodeAttribute(Read<double>(pBuffer, position, bufferLength));
+                }
+                p_node->SetRegion(Read<unsigned>(pBuffer, position, bufferLength));
+                p_node->SetRadius(Read<double>(pBuffer, position, bufferLength));
+                p_node->SetIsParticle(Read<char>(pBuffer, position, bufferLength));
+                c_vector<double, DIM> applied_force;
+                for (unsigned d=0; d<DIM; d++)
+                {
+                    applied_force[d] = Read<double>(pBuffer, position, bufferLength);
+                }
+                p_node->AddAppliedForceContribution(applied_force);
+            }
+
+            (*p_pairs)[i].second = p_node;
+        }
+
+        std::vector<CellPtr> cells;
+        std::string cell_string(pBuffer + position, bufferLength - position);
+        std::istringstream ss(cell_string, std::ios::binary);
+        boost::archive::binary_iarchive input_arch(ss);
+        input_arch >> cells;
+
+        assert(cells.size() == num_pairs);
+        for (unsigned i=0; i<num_pairs; i++)
+        {
+            (*p_pairs)[i].first = cells[i];
+        }
+
+        return p_pairs;
+    }
+};
+
+#endif /*CELLNODEPAIRPACKER_HPP_*/
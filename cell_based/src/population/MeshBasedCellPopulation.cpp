@@ -59,7 +59,8 @@ MeshBasedCellPopulation<ELEMENT_DIM,SPACE_DIM>::MeshBasedCellPopulation(MutableM
       mAreaBasedDampingConstantParameter(0.1),
       mWriteVtkAsPoints(false),
       mOutputMeshInVtk(false),
-      mHasVariableRestLength(false)
+      mHasVariableRestLength(false),
+      mBoundaryCellRadius(0.0)
 {
     mpMutableMesh = static_cast<MutableMesh<ELEMENT_DIM,SPACE_DIM>* >(&(this->mrMesh));
 
@@ -156,12 +157,20 @@ double MeshBasedCellPopulation<ELEMENT_DIM,SPACE_DIM>::GetDampingConstant(unsign
          */
         double d1 = 2.0*(1.0 - d0)/(sqrt(3.0)*rest_length*rest_length);
 
-        double area_cell = GetVolumeOfVoronoiElement(nodeIndex);
+        double area_cell;
+        if (mBoundaryCellRadius > 0.0 && this->GetNode(nodeIndex)->IsBoundaryNode())
+        {
+            area_cell = GetBoundedVoronoiArea(nodeIndex);
+        }
+        else
+        {
+            area_cell = GetVolumeOfVoronoiElement(nodeIndex);
+        }
 
         /**
          * The cell area should not be too large - the next assertion is to avoid
          * getting an infinite cell area, which may occur if area-based viscosity
-         * is chosen in the absence of ghost nodes.
+         * is chosen in the absence of ghost nodes without a boundary cell radius.
          */
         assert(area_cell < 1000);
 
@@ -213,40 +222,14 @@ template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 unsigned MeshBasedCellPopulation<ELEMENT_DIM,SPACE_DIM>::RemoveDeadCells()
 {
     unsigned num_removed = 0;
+    std::set<CellPtr> dead_cells;
     for (std::list<CellPtr>::iterator it = this->mCells.begin();
          it != this->mCells.end();
          )
     {
         if ((*it)->IsDead())
         {
-            // Check if this cell is in a marked spring
-            std::vector<const std::pair<CellPtr,CellPtr>*> pairs_to_remove; // Pairs that must be purged
-            for (std::set<std::pair<CellPtr,CellPtr> >::iterator it1 = this->mMarkedSprings.begin();
-                 it1 != this->mMarkedSprings.end();
-                 ++it1)
-            {
-                const std::pair<CellPtr,CellPtr>& r_pair = *it1;
-
-                for (unsigned i=0; i<2; i++)
-                {
-                    CellPtr p_cell = (i==0 ? r_pair.first : r_pair.second);
-
-                    if (p_cell == *it)
-                    {
-                        // Remember to purge this spring
-                        pairs_to_remove.push_back(&r_pair);
-                        break;
-                    }
-                }
-            }
-
-            // Purge any marked springs that contained this cell
-            for (std::vector<const std::pair<CellPtr,CellPtr>* >::iterator pair_it = pairs_to_remove.begin();
-                 pair_it != pairs_to_remove.end();
-                 ++pair_it)
-            {
-                this->mMarkedSprings.erase(**pair_it);
-            }
+            dead_cells.insert(*it);
 
             // Remove the node from the mesh
             num_removed++;
@@ -265,6 +248,25 @@ unsigned MeshBasedCellPopulation<ELEMENT_DIM,SPACE_DIM>::RemoveDeadCells()
         }
     }
 
+    // Purge any marked springs that contained a removed cell, in a single pass over the springs
+    if (!dead_cells.empty())
+    {
+        for (std::set<std::pair<CellPtr,CellPtr> >::iterator spring_iter = this->mMarkedSprings.begin();
+             spring_iter != this->mMarkedSprings.end();
+             )
+        {
+            if (dead_cells.find(spring_iter->first) != dead_cells.end()
+                || dead_cells.find(spring_iter->second) != dead_cells.end())
+            {
+                this->mMarkedSprings.erase(spring_iter++);
+            }
+            else
+            {
+                ++spring_iter;
+            }
+        }
+    }
+
     return num_removed;
 }
 
@@ -323,6 +325,9 @@ void MeshBasedCellPopulation<ELEMENT_DIM,SPACE_DIM>::Update(bool hasHadBirthsOrD
     // We must use a static_cast to call ReMesh() as this method is not defined in parent mesh classes
     static_cast<MutableMesh<ELEMENT_DIM,SPACE_DIM>&>((this->mrMesh)).ReMesh(node_map);
 
+    // The connectivity may have changed even where nodes haven't moved
+    mVoronoiTessellationNodeLocations.clear();
+
     if (!node_map.IsIdentityMap())
     {
         UpdateGhostNodesAfterReMesh(node_map);
@@ -440,6 +445,48 @@ void MeshBasedCellPopulation<ELEMENT_DIM,SPACE_DIM>::TessellateIfNeeded()
     }
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool MeshBasedCellPopulation<ELEMENT_DIM,SPACE_DIM>::IsVoronoiTessellationUpToDate()
+{
+    if (mpVoronoiTessellation == nullptr
+        || mVoronoiTessellationNodeLocations.size() != this->mrMesh.GetNumNodes())
+    {
+        return false;
+    }
+
+    unsigned i = 0;
+    for (typename AbstractMesh<ELEMENT_DIM, SPACE_DIM>::NodeIterator node_iter = this->mrMesh.GetNodeIteratorBegin();
+         node_iter != this->mrMesh.GetNodeIteratorEnd();
+         ++node_iter, ++i)
+    {
+        const c_vector<double, SPACE_DIM>& r_location = node_iter->rGetLocation();
+        for (unsigned d=0; d<SPACE_DIM; d++)
+        {
+            if (r_location[d] != mVoronoiTessellationNodeLocations[i][d])
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void MeshBasedCellPopulation<ELEMENT_DIM,SPACE_DIM>::RecordVoronoiTessellationNodeLocations()
+{
+    mVoronoiTessellationNodeLocations.clear();
+    mVoronoiTessellationNodeLocations.reserve(this->mrMesh.GetNumNodes());
+    for (typename AbstractMesh<ELEMENT_DIM, SPACE_DIM>::NodeIterator node_iter = this->mrMesh.GetNodeIteratorBegin();
+         node_iter != this->mrMesh.GetNodeIteratorEnd();
+         ++node_iter)
+    {
+        mVoronoiTessellationNodeLocations.push_back(node_iter->rGetLocation());
+    }
+
+    mVoronoiElementVolumes.assign(mpVoronoiTessellation->GetNumAllElements(), DOUBLE_UNSET);
+    mVoronoiElementSurfaceAreas.assign(mpVoronoiTessellation->GetNumAllElements(), DOUBLE_UNSET);
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void MeshBasedCellPopulation<ELEMENT_DIM,SPACE_DIM>::DivideLongSprings(double springDivisionThreshold)
 {
@@ -778,12 +825,12 @@ double MeshBasedCellPopulation<ELEMENT_DIM,SPACE_DIM>::GetVolumeOfCell(CellPtr p
             unsigned element_index = mpVoronoiTessellation->GetVoronoiElementIndexCorrespondingToDelaunayNodeIndex(node_index);
 
             // Get the cell's volume from the Voronoi tessellation
-            cell_volume = mpVoronoiTessellation->GetVolumeOfElement(element_index);
+            cell_volume = GetVolumeOfVoronoiElement(node_index);
         }
         catch (Exception&)
         {
-            // If it doesn't exist this must be a boundary cell, so return infinite volume
-            cell_volume = DBL_MAX;
+            // If it doesn't exist this must be a boundary cell, so return infinite volume unless it is bounded
+            cell_volume = (mBoundaryCellRadius > 0.0) ? GetBoundedVoronoiArea(node_index) : DBL_MAX;
         }
     }
     else if (SPACE_DIM==3 && ELEMENT_DIM==2)
@@ -947,6 +994,10 @@ typename MeshBasedCellPopulation<ELEMENT_DIM,SPACE_DIM>::SpringIterator MeshBase
 template <>
 void MeshBasedCellPopulation<2>::CreateVoronoiTessellation()
 {
+    if (IsVoronoiTessellationUpToDate())
+    {
+        return;
+    }
     delete mpVoronoiTessellation;
 
     // Check if the mesh associated with this cell population is periodic
@@ -960,6 +1011,7 @@ void MeshBasedCellPopulation<2>::CreateVoronoiTessellation()
     {
         mpVoronoiTessellation = new VertexMesh<2, 2>(static_cast<MutableMesh<2, 2> &>((this->mrMesh)), is_mesh_periodic);
     }
+    RecordVoronoiTessellationNodeLocations();
 }
 
 /**
@@ -982,8 +1034,13 @@ void MeshBasedCellPopulation<2,3>::CreateVoronoiTessellation()
 template <>
 void MeshBasedCellPopulation<3>::CreateVoronoiTessellation()
 {
+    if (IsVoronoiTessellationUpToDate())
+    {
+        return;
+    }
     delete mpVoronoiTessellation;
     mpVoronoiTessellation = new VertexMesh<3, 3>(static_cast<MutableMesh<3, 3> &>((this->mrMesh)));
+    RecordVoronoiTessellationNodeLocations();
 }
 
 /**
@@ -1037,16 +1094,32 @@ template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 double MeshBasedCellPopulation<ELEMENT_DIM,SPACE_DIM>::GetVolumeOfVoronoiElement(unsigned index)
 {
     unsigned element_index = mpVoronoiTessellation->GetVoronoiElementIndexCorrespondingToDelaunayNodeIndex(index);
-    double volume = mpVoronoiTessellation->GetVolumeOfElement(element_index);
-    return volume;
+    if (element_index >= mVoronoiElementVolumes.size())
+    {
+        // The tessellation has been modified since it was created
+        return mpVoronoiTessellation->GetVolumeOfElement(element_index);
+    }
+    if (mVoronoiElementVolumes[element_index] == DOUBLE_UNSET)
+    {
+        mVoronoiElementVolumes[element_index] = mpVoronoiTessellation->GetVolumeOfElement(element_index);
+    }
+    return mVoronoiElementVolumes[element_index];
 }
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 double MeshBasedCellPopulation<ELEMENT_DIM,SPACE_DIM>::GetSurfaceAreaOfVoronoiElement(unsigned index)
 {
     unsigned element_index = mpVoronoiTessellation->GetVoronoiElementIndexCorrespondingToDelaunayNodeIndex(index);
-    double surface_area = mpVoronoiTessellation->GetSurfaceAreaOfElement(element_index);
-    return surface_area;
+    if (element_index >= mVoronoiElementSurfaceAreas.size())
+    {
+        // The tessellation has been modified since it was created
+        return mpVoronoiTessellation->GetSurfaceAreaOfElement(element_index);
+    }
+    if (mVoronoiElementSurfaceAreas[element_index] == DOUBLE_UNSET)
+    {
+        mVoronoiElementSurfaceAreas[element_index] = mpVoronoiTessellation->GetSurfaceAreaOfElement(element_index);
+    }
+    return mVoronoiElementSurfaceAreas[element_index];
 }
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
@@ -1159,6 +1232,83 @@ void MeshBasedCellPopulation<ELEMENT_DIM,SPACE_DIM>::SetAreaBasedDampingConstant
     mAreaBasedDampingConstantParameter = areaBasedDampingConstantParameter;
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+double MeshBasedCellPopulation<ELEMENT_DIM,SPACE_DIM>::GetBoundaryCellRadius()
+{
+    return mBoundaryCellRadius;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void MeshBasedCellPopulation<ELEMENT_DIM,SPACE_DIM>::SetBoundaryCellRadius(double boundaryCellRadius)
+{
+    if (!(ELEMENT_DIM == 2 && SPACE_DIM == 2))
+    {
+        EXCEPTION("Bounded boundary cell areas are only implemented in 2D");
+    }
+    if (boundaryCellRadius <= 0.0)
+    {
+        EXCEPTION("The boundary cell radius must be positive");
+    }
+    mBoundaryCellRadius = boundaryCellRadius;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+double MeshBasedCellPopulation<ELEMENT_DIM,SPACE_DIM>::GetBoundedVoronoiArea(unsigned nodeIndex)
+{
+    assert(SPACE_DIM == 2); // LCOV_EXCL_LINE
+    assert(mBoundaryCellRadius > 0.0);
+
+    // Start from a regular polygon inscribed in the disc, in coordinates centred on the node
+    const unsigned num_sides = 36;
+    std::vector<c_vector<double, 2> > polygon(num_sides);
+    for (unsigned i=0; i<num_sides; i++)
+    {
+        double angle = 2.0*M_PI*i/num_sides;
+        polygon[i][0] = mBoundaryCellRadius*cos(angle);
+        polygon[i][1] = mBoundaryCellRadius*sin(angle);
+    }
+
+    // Clip it to the half-plane x.d <= |d|^2/2 on the node's side of each bisector
+    c_vector<double, SPACE_DIM> node_location = this->GetNode(nodeIndex)->rGetLocation();
+    std::set<unsigned> neighbours = this->GetNeighbouringNodeIndices(nodeIndex);
+    for (std::set<unsigned>::iterator iter = neighbours.begin();
+         iter != neighbours.end() && !polygon.empty();
+         ++iter)
+    {
+        c_vector<double, SPACE_DIM> d = rGetMesh().GetVectorFromAtoB(node_location, this->GetNode(*iter)->rGetLocation());
+        double half_length_squared = 0.5*inner_prod(d, d);
+
+        std::vector<c_vector<double, 2> > clipped;
+        for (unsigned i=0; i<polygon.size(); i++)
+        {
+            const c_vector<double, 2>& r_a = polygon[i];
+            const c_vector<double, 2>& r_b = polygon[(i+1)%polygon.size()];
+            double f_a = r_a[0]*d[0] + r_a[1]*d[1] - half_length_squared;
+            double f_b = r_b[0]*d[0] + r_b[1]*d[1] - half_length_squared;
+
+            if (f_a <= 0.0)
+            {
+                clipped.push_back(r_a);
+            }
+            if ((f_a < 0.0 && f_b > 0.0) || (f_a > 0.0 && f_b < 0.0))
+            {
+                clipped.push_back(r_a + (f_a/(f_a - f_b))*(r_b - r_a));
+            }
+        }
+        polygon = clipped;
+    }
+
+    // Shoelace formula
+    double area = 0.0;
+    for (unsigned i=0; i<polygon.size(); i++)
+    {
+        const c_vector<double, 2>& r_a = polygon[i];
+        const c_vector<double, 2>& r_b = polygon[(i+1)%polygon.size()];
+        area += r_a[0]*r_b[1] - r_b[0]*r_a[1];
+    }
+    return 0.5*fabs(area);
+}
+
 // LCOV_EXCL_START
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 std::vector< std::pair<Node<SPACE_DIM>*, Node<SPACE_DIM>* > >& MeshBasedCellPopulation<ELEMENT_DIM,SPACE_DIM>::rGetNodePairs()
@@ -1177,6 +1327,7 @@ void MeshBasedCellPopulation<ELEMENT_DIM,SPACE_DIM>::OutputCellPopulationParamet
     *rParamsFile << "\t\t<WriteVtkAsPoints>" << mWriteVtkAsPoints << "</WriteVtkAsPoints>\n";
     *rParamsFile << "\t\t<OutputMeshInVtk>" << mOutputMeshInVtk << "</OutputMeshInVtk>\n";
     *rParamsFile << "\t\t<HasVariableRestLength>" << mHasVariableRestLength << "</HasVariableRestLength>\n";
+    *rParamsFile << "\t\t<BoundaryCellRadius>" << mBoundaryCellRadius << "</BoundaryCellRadius>\n";
 
     // Call method on direct parent class
     AbstractCentreBasedCellPopulation<ELEMENT_DIM,SPACE_DIM>::OutputCellPopulationParameters(rParamsFile);
@@ -89,6 +89,7 @@ private:
         archive & mWriteVtkAsPoints;
         archive & mOutputMeshInVtk;
         archive & mHasVariableRestLength;
+        archive & mBoundaryCellRadius;
 
         this->Validate();
     }
@@ -111,6 +112,26 @@ protected:
      */
     VertexMesh<ELEMENT_DIM, SPACE_DIM>* mpVoronoiTessellation;
 
+    /**
+     * The locations of the nodes of the mesh when mpVoronoiTessellation was last created,
+     * in node iterator order. CreateVoronoiTessellation() reuses the existing tessellation
+     * if the nodes have not moved since (e.g. when several modifiers and writers ask for it
+     * in the same time step). Cleared whenever the mesh is remeshed. Not archived.
+     */
+    std::vector<c_vector<double, SPACE_DIM> > mVoronoiTessellationNodeLocations;
+
+    /**
+     * The volumes of the elements of mpVoronoiTessellation, indexed by element index and
+     * computed on first use. Entries not yet computed are DOUBLE_UNSET.
+     */
+    std::vector<double> mVoronoiElementVolumes;
+
+    /**
+     * The surface areas of the elements of mpVoronoiTessellation, computed on first use
+     * as for #mVoronoiElementVolumes.
+     */
+    std::vector<double> mVoronoiElementSurfaceAreas;
+
     /** Static cast of the mesh from AbstractCellPopulation */
     MutableMesh<ELEMENT_DIM, SPACE_DIM>* mpMutableMesh;
 
@@ -140,9 +161,28 @@ protected:
     /** Whether springs have variable rest lengths. */
     bool mHasVariableRestLength;
 
+    /**
+     * The radius used to bound the area of boundary cells, whose Voronoi regions are
+     * unbounded, in populations without ghost nodes. Zero (the default) means that
+     * boundary cells are left unbounded. See SetBoundaryCellRadius().
+     */
+    double mBoundaryCellRadius;
+
     /** Node pairs for force calculations. */
     std::vector< std::pair<Node<SPACE_DIM>*, Node<SPACE_DIM>* > > mNodePairs;
 
+    /**
+     * @return whether mpVoronoiTessellation exists and was created from the current node
+     * locations, so does not need to be created again.
+     */
+    bool IsVoronoiTessellationUpToDate();
+
+    /**
+     * Record the node locations from which mpVoronoiTessellation has just been created,
+     * and reset the cached element volumes and surface areas.
+     */
+    void RecordVoronoiTessellationNodeLocations();
+
     /**
      * Update mIsGhostNode if required by a remesh.
      *
@@ -526,6 +566,35 @@ public:
      */
     void SetAreaBasedDampingConstantParameter(double areaBasedDampingConstantParameter);
 
+    /**
+     * @return mBoundaryCellRadius
+     */
+    double GetBoundaryCellRadius();
+
+    /**
+     * Set mBoundaryCellRadius. Only implemented in 2D.
+     *
+     * Once set, each boundary cell is given the area of its Voronoi region clipped to a
+     * disc of this radius about the cell centre, rather than an infinite area. This is used
+     * by GetVolumeOfCell() and by the area-based damping constant, so a population can be
+     * simulated without a layer of ghost nodes. Long springs across the convex hull of the
+     * population should then be removed using SetCutOffLength() on the spring force.
+     *
+     * @param boundaryCellRadius the new value of mBoundaryCellRadius (must be positive)
+     */
+    void SetBoundaryCellRadius(double boundaryCellRadius);
+
+    /**
+     * Compute the area of the Voronoi region of a given node clipped to a disc of radius
+     * mBoundaryCellRadius. The region is found by clipping a regular polygon inscribed in
+     * the disc by the perpendicular bisector of each edge from the node in the Delaunay mesh.
+     * Only implemented in 2D.
+     *
+     * @param nodeIndex the index of the node
+     * @return the clipped area
+     */
+    double GetBoundedVoronoiArea(unsigned nodeIndex);
+
     /**
      * Overridden rGetNodePairs method which uses the Delaunay triangulatiuon
      *
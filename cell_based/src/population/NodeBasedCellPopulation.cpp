@@ -37,6 +37,8 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "MathsCustomFunctions.hpp"
 #include "VtkMeshWriter.hpp"
 
+#include <algorithm>
+
 template <unsigned DIM>
 NodeBasedCellPopulation<DIM>::NodeBasedCellPopulation(NodesOnlyMesh<DIM>& rMesh,
                                       std::vector<CellPtr>& rCells,
@@ -47,7 +49,9 @@ NodeBasedCellPopulation<DIM>::NodeBasedCellPopulation(NodesOnlyMesh<DIM>& rMesh,
       mDeleteMesh(deleteMesh),
       mUseVariableRadii(false),
       mLoadBalanceMesh(false),
-      mLoadBalanceFrequency(100)
+      mLoadBalanceFrequency(100),
+      mSpatialSortFrequency(0),
+      mNeighbourListsAreCurrent(false)
 {
     mpNodesOnlyMesh = static_cast<NodesOnlyMesh<DIM>* >(&(this->mrMesh));
 
@@ -63,7 +67,9 @@ NodeBasedCellPopulation<DIM>::NodeBasedCellPopulation(NodesOnlyMesh<DIM>& rMesh)
       mDeleteMesh(true),
       mUseVariableRadii(false), // will be set by serialize() method
       mLoadBalanceMesh(false),
-      mLoadBalanceFrequency(100)
+      mLoadBalanceFrequency(100),
+      mSpatialSortFrequency(0),
+      mNeighbourListsAreCurrent(false)
 {
     mpNodesOnlyMesh = static_cast<NodesOnlyMesh<DIM>* >(&(this->mrMesh));
 }
@@ -143,15 +149,26 @@ template <unsigned DIM>
 void NodeBasedCellPopulation<DIM>::SetNode(unsigned nodeIndex, ChastePoint<DIM>& rNewLocation)
 {
     mpNodesOnlyMesh->SetNode(nodeIndex, rNewLocation, false);
+    mNeighbourListsAreCurrent = false;
 }
 
 template <unsigned DIM>
 void NodeBasedCellPopulation<DIM>::Update(bool hasHadBirthsOrDeaths)
 {
+    mNeighbourListsAreCurrent = false;
+
     UpdateCellProcessLocation();
 
+    // Sorting re-allocates the nodes, so any existing node pairs are invalidated
+    bool has_sorted_nodes = false;
+    if (mSpatialSortFrequency > 0 && (SimulationTime::Instance()->GetTimeStepsElapsed() % mSpatialSortFrequency) == 0)
+    {
+        has_sorted_nodes = mpNodesOnlyMesh->ReorderNodesSpatially();
+    }
+
     mpNodesOnlyMesh->UpdateBoxCollection();
 
+    bool has_load_balanced = false;
     if (mLoadBalanceMesh)
     {
         if ((SimulationTime::Instance()->GetTimeStepsElapsed() % mLoadBalanceFrequency) == 0)
@@ -161,16 +178,33 @@ void NodeBasedCellPopulation<DIM>::Update(bool hasHadBirthsOrDeaths)
             UpdateCellProcessLocation();
 
             mpNodesOnlyMesh->UpdateBoxCollection();
+
+            has_load_balanced = true;
         }
     }
 
     RefreshHaloCells();
 
-    mpNodesOnlyMesh->CalculateInteriorNodePairs(mNodePairs);
+    /*
+     * With a Verlet skin (see NodesOnlyMesh::SetVerletSkin()) the node pairs from a
+     * previous update can be kept until some node has moved by half the skin, as long
+     * as no nodes have been added, removed or moved between processes since.
+     */
+    bool reuse_node_pairs = !hasHadBirthsOrDeaths && !has_load_balanced && !has_sorted_nodes && !mNodePairs.empty()
+                            && mpNodesOnlyMesh->AreNodePairsStillValid();
+
+    if (!reuse_node_pairs)
+    {
+        mpNodesOnlyMesh->CalculateInteriorNodePairs(mNodePairs);
+    }
 
     AddReceivedHaloCells();
 
-    mpNodesOnlyMesh->CalculateBoundaryNodePairs(mNodePairs);
+    if (!reuse_node_pairs)
+    {
+        mpNodesOnlyMesh->CalculateBoundaryNodePairs(mNodePairs);
+        mpNodesOnlyMesh->RecordNodeLocationsForNodePairs();
+    }
 
     /*
      * Update cell radii based on CellData
@@ -257,6 +291,7 @@ unsigned NodeBasedCellPopulation<DIM>::RemoveDeadCells()
 template <unsigned DIM>
 unsigned NodeBasedCellPopulation<DIM>::AddNode(Node<DIM>* pNewNode)
 {
+    mNeighbourListsAreCurrent = false;
     return mpNodesOnlyMesh->AddNode(pNewNode);
 }
 
@@ -349,6 +384,18 @@ void NodeBasedCellPopulation<DIM>::SetLoadBalanceFrequency(unsigned loadBalanceF
     mLoadBalanceFrequency = loadBalanceFrequency;
 }
 
+template <unsigned DIM>
+void NodeBasedCellPopulation<DIM>::SetSpatialSortFrequency(unsigned spatialSortFrequency)
+{
+    mSpatialSortFrequency = spatialSortFrequency;
+}
+
+template <unsigned DIM>
+unsigned NodeBasedCellPopulation<DIM>::GetSpatialSortFrequency() const
+{
+    return mSpatialSortFrequency;
+}
+
 template <unsigned DIM>
 double NodeBasedCellPopulation<DIM>::GetWidth(const unsigned& rDimension)
 {
@@ -426,10 +473,8 @@ std::set<unsigned> NodeBasedCellPopulation<DIM>::GetNodesWithinNeighbourhoodRadi
 }
 
 template <unsigned DIM>
-std::set<unsigned> NodeBasedCellPopulation<DIM>::GetNeighbouringNodeIndices(unsigned index)
+void NodeBasedCellPopulation<DIM>::FindNeighbouringNodeIndices(unsigned index, std::vector<unsigned>& rNeighbours)
 {
-    std::set<unsigned> neighbouring_node_indices;
-
     // Get location and radius of node
     Node<DIM>* p_node_i = this->GetNode(index);
     const c_vector<double, DIM>& r_node_i_location = p_node_i->rGetLocation();
@@ -482,13 +527,62 @@ std::set<unsigned> NodeBasedCellPopulation<DIM>::GetNeighbouringNodeIndices(unsi
             }
             if (distance_between_nodes <= max_interaction_distance)// + DBL_EPSILSON) //Assumes that max_interaction_distance is of order 1
             {
-                // ...then add this node index to the set of neighbouring node indices
-                neighbouring_node_indices.insert((*iter));
+                // ...then add this node index to the neighbouring node indices
+                rNeighbours.push_back(*iter);
             }
         }
     }
+}
 
-    return neighbouring_node_indices;
+template <unsigned DIM>
+std::set<unsigned> NodeBasedCellPopulation<DIM>::GetNeighbouringNodeIndices(unsigned index)
+{
+    std::vector<unsigned> neighbours;
+    FindNeighbouringNodeIndices(index, neighbours);
+
+    return std::set<unsigned>(neighbours.begin(), neighbours.end());
+}
+
+template <unsigned DIM>
+void NodeBasedCellPopulation<DIM>::CalculateNeighbourLists()
+{
+    unsigned num_all_nodes = mpNodesOnlyMesh->GetNumAllNodes();
+    mNeighbourListIndices.clear();
+    mNeighbourListStarts.assign(num_all_nodes, 0);
+    mNeighbourListEnds.assign(num_all_nodes, 0);
+
+    for (typename AbstractMesh<DIM,DIM>::NodeIterator node_iter = mpNodesOnlyMesh->GetNodeIteratorBegin();
+         node_iter != mpNodesOnlyMesh->GetNodeIteratorEnd();
+         ++node_iter)
+    {
+        unsigned position = mpNodesOnlyMesh->SolveNodeMapping(node_iter->GetIndex());
+        unsigned start = mNeighbourListIndices.size();
+        FindNeighbouringNodeIndices(node_iter->GetIndex(), mNeighbourListIndices);
+
+        // Sort and remove duplicates, to match the set returned by GetNeighbouringNodeIndices()
+        std::sort(mNeighbourListIndices.begin() + start, mNeighbourListIndices.end());
+        mNeighbourListIndices.erase(std::unique(mNeighbourListIndices.begin() + start, mNeighbourListIndices.end()),
+                                    mNeighbourListIndices.end());
+
+        mNeighbourListStarts[position] = start;
+        mNeighbourListEnds[position] = mNeighbourListIndices.size();
+    }
+
+    mNeighbourListsAreCurrent = true;
+}
+
+template <unsigned DIM>
+NodeIndexRange NodeBasedCellPopulation<DIM>::GetCachedNeighbouringNodeIndices(unsigned index)
+{
+    if (!mNeighbourListsAreCurrent)
+    {
+        CalculateNeighbourLists();
+    }
+
+    unsigned position = mpNodesOnlyMesh->SolveNodeMapping(index);
+    const unsigned* p_indices = mNeighbourListIndices.empty() ? nullptr : &mNeighbourListIndices[0];
+
+    return NodeIndexRange(p_indices + mNeighbourListStarts[position], p_indices + mNeighbourListEnds[position]);
 }
 
 template <unsigned DIM>
@@ -511,8 +605,8 @@ double NodeBasedCellPopulation<DIM>::GetVolumeOfCell(CellPtr pCell)
     // Get the location of this node
     const c_vector<double, DIM>& r_node_i_location = GetNode(node_index)->rGetLocation();
 
-    // Get the set of node indices corresponding to this cell's neighbours
-    std::set<unsigned> neighbouring_node_indices = GetNeighbouringNodeIndices(node_index);
+    // Get the node indices corresponding to this cell's neighbours
+    NodeIndexRange neighbouring_node_indices = GetCachedNeighbouringNodeIndices(node_index);
 
     // THe number of neighbours in equilibrium configuration, from sphere packing problem
     unsigned num_neighbours_equil;
@@ -526,8 +620,8 @@ double NodeBasedCellPopulation<DIM>::GetVolumeOfCell(CellPtr pCell)
         num_neighbours_equil = 12;
     }
 
-    // Loop over this set
-    for (std::set<unsigned>::iterator iter = neighbouring_node_indices.begin();
+    // Loop over these neighbours
+    for (const unsigned* iter = neighbouring_node_indices.begin();
          iter != neighbouring_node_indices.end();
          ++iter)
     {
@@ -41,8 +41,10 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 
 #include "ObjectCommunicator.hpp"
+#include "CellNodePairPacker.hpp"
 #include "AbstractCentreBasedCellPopulation.hpp"
 #include "NodesOnlyMesh.hpp"
+#include "NodeIndexRange.hpp"
 
 /**
  * A NodeBasedCellPopulation is a CellPopulation consisting of only nodes in space with associated cells.
@@ -112,6 +114,43 @@ private:
     /** The frequency at which the mesh is rebalanced */
     unsigned mLoadBalanceFrequency;
 
+    /**
+     * The frequency, in time steps, at which the nodes are sorted spatially in memory
+     * (see NodesOnlyMesh::ReorderNodesSpatially()). Zero, the default, means never.
+     */
+    unsigned mSpatialSortFrequency;
+
+    /**
+     * Neighbour lists cached by GetCachedNeighbouringNodeIndices(), stored flat: the
+     * neighbours of the node at position i of the mesh's node vector are entries
+     * mNeighbourListStarts[i] to mNeighbourListEnds[i] - 1.
+     */
+    std::vector<unsigned> mNeighbourListIndices;
+
+    /** Start of each node's neighbours in #mNeighbourListIndices. */
+    std::vector<unsigned> mNeighbourListStarts;
+
+    /** End of each node's neighbours in #mNeighbourListIndices. */
+    std::vector<unsigned> mNeighbourListEnds;
+
+    /** Whether the cached neighbour lists are up to date. Not archived. */
+    bool mNeighbourListsAreCurrent;
+
+    /**
+     * Find the nodes whose cells touch that of a given node, as used by
+     * GetNeighbouringNodeIndices(), appending them to a vector in the order
+     * found.
+     *
+     * @param index the node index
+     * @param rNeighbours vector to which neighbouring node indices are appended
+     */
+    void FindNeighbouringNodeIndices(unsigned index, std::vector<unsigned>& rNeighbours);
+
+    /**
+     * Fill the cached neighbour lists for all local nodes.
+     */
+    void CalculateNeighbourLists();
+
     /** Needed for serialization. */
     friend class boost::serialization::access;
     /**
@@ -407,6 +446,19 @@ public:
      */
     void SetLoadBalanceFrequency(unsigned loadBalanceFrequency);
 
+    /**
+     * Set the frequency, in number of time steps, with which the nodes of the underlying
+     * mesh should be re-sorted into spatial order on Update(), to reduce cache misses when
+     * accumulating forces.
+     * @param spatialSortFrequency the frequency for sorting, or zero to never sort.
+     */
+    void SetSpatialSortFrequency(unsigned spatialSortFrequency);
+
+    /**
+     * @return #mSpatialSortFrequency.
+     */
+    unsigned GetSpatialSortFrequency() const;
+
     /**
      * Overridden GetWidth() method.
      *
@@ -448,6 +500,20 @@ public:
      */
     std::set<unsigned> GetNeighbouringNodeIndices(unsigned index);
 
+    /**
+     * Get the same neighbours as GetNeighbouringNodeIndices(), in increasing order, from
+     * lists cached for all local nodes on the first call after each Update(), so that
+     * code that visits every cell does not allocate a set per cell.
+     *
+     * The lists are refreshed by Update(), SetNode() and AddNode(); radii or locations
+     * changed directly on the mesh are only seen after the next Update(). The returned
+     * range is invalidated by any of these.
+     *
+     * @param index the node index of a node owned by this process
+     * @return a view of the neighbouring node indices.
+     */
+    NodeIndexRange GetCachedNeighbouringNodeIndices(unsigned index);
+
     /**
      * Overridden AddCell() method.
      *
@@ -0,0 +1,114 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef NODEINDEXRANGE_HPP_
+#define NODEINDEXRANGE_HPP_
+
+#include <cassert>
+#include <cstddef>
+
+/**
+ * A read-only view of a contiguous run of node indices held elsewhere, such as one
+ * row of the neighbour lists cached by NodeBasedCellPopulation. It owns no memory,
+ * so is cheap to copy, but is only valid while the storage it points into is unchanged.
+ */
+class NodeIndexRange
+{
+private:
+
+    /** Pointer to the first index. */
+    const unsigned* mpBegin;
+
+    /** Pointer to one past the last index. */
+    const unsigned* mpEnd;
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param pBegin pointer to the first index
+     * @param pEnd pointer to one past the last index
+     */
+    NodeIndexRange(const unsigned* pBegin, const unsigned* pEnd)
+        : mpBegin(pBegin),
+          mpEnd(pEnd)
+    {
+    }
+
+    /**
+     * @return pointer to the first index.
+     */
+    const unsigned* begin() const
+    {
+        return mpBegin;
+    }
+
+    /**
+     * @return pointer to one past the last index.
+     */
+    const unsigned* end() const
+    {
+        return mpEnd;
+    }
+
+    /**
+     * @return the number of indices.
+     */
+    unsigned size() const
+    {
+        return mpEnd - mpBegin;
+    }
+
+    /**
+     * @return whether there are no indices.
+     */
+    bool empty() const
+    {
+        return mpBegin == mpEnd;
+    }
+
+    /**
+     * @param i position in the range
+     * @return the i-th index.
+     */
+    unsigned operator[](unsigned i) const
+    {
+        assert(i < size());
+        return mpBegin[i];
+    }
+};
+
+#endif /*NODEINDEXRANGE_HPP_*/
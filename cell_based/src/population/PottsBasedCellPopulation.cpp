@@ -34,9 +34,14 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "PottsBasedCellPopulation.hpp"
+#include <algorithm>
+#include <climits>
+#include <iterator>
+#include <boost/random.hpp>
 #include "RandomNumberGenerator.hpp"
 #include "AbstractPottsUpdateRule.hpp"
 #include "NodesOnlyMesh.hpp"
+#include "OpenMpExceptionCollector.hpp"
 #include "CellPopulationElementWriter.hpp"
 #include "CellIdWriter.hpp"
 
@@ -81,7 +86,9 @@ PottsBasedCellPopulation<DIM>::PottsBasedCellPopulation(PottsMesh<DIM>& rMesh,
       mpElementTessellation(nullptr),
       mpMutableMesh(nullptr),
       mTemperature(0.1),
-      mNumSweepsPerTimestep(1)
+      mNumSweepsPerTimestep(1),
+      mUseSublatticeUpdates(false),
+      mNumThreads(1u)
 {
     mpPottsMesh = static_cast<PottsMesh<DIM>* >(&(this->mrMesh));
     // Check each element has only one cell associated with it
@@ -97,7 +104,9 @@ PottsBasedCellPopulation<DIM>::PottsBasedCellPopulation(PottsMesh<DIM>& rMesh)
       mpElementTessellation(nullptr),
       mpMutableMesh(nullptr),
       mTemperature(0.1),
-      mNumSweepsPerTimestep(1)
+      mNumSweepsPerTimestep(1),
+      mUseSublatticeUpdates(false),
+      mNumThreads(1u)
 {
     mpPottsMesh = static_cast<PottsMesh<DIM>* >(&(this->mrMesh));
 }
@@ -260,6 +269,12 @@ void PottsBasedCellPopulation<DIM>::UpdateCellLocations(double dt)
         p_gen->Shuffle(this->mUpdateRuleCollection);
     }
 
+    if (mUseSublatticeUpdates)
+    {
+        UpdateCellLocationsOnSublattices();
+        return;
+    }
+
     for (unsigned i=0; i<num_nodes*mNumSweepsPerTimestep; i++)
     {
         unsigned node_index;
@@ -274,73 +289,225 @@ void PottsBasedCellPopulation<DIM>::UpdateCellLocations(double dt)
             node_index = i%num_nodes;
         }
 
-        Node<DIM>* p_node = this->mrMesh.GetNode(node_index);
-
-        // Each node in the mesh must be in at most one element
-        assert(p_node->GetNumContainingElements() <= 1);
-
         // Find a random available neighbouring node to overwrite current site
-        std::set<unsigned> neighbouring_node_indices = mpPottsMesh->GetMooreNeighbouringNodeIndices(node_index);
-        unsigned neighbour_location_index;
+        const std::set<unsigned>& r_neighbouring_node_indices = mpPottsMesh->rGetMooreNeighbouringNodeIndices(node_index);
 
-        if (!neighbouring_node_indices.empty())
+        if (!r_neighbouring_node_indices.empty())
         {
-            unsigned num_neighbours = neighbouring_node_indices.size();
+            unsigned num_neighbours = r_neighbouring_node_indices.size();
             unsigned chosen_neighbour = p_gen->randMod(num_neighbours);
 
-            std::set<unsigned>::iterator neighbour_iter = neighbouring_node_indices.begin();
+            std::set<unsigned>::const_iterator neighbour_iter = r_neighbouring_node_indices.begin();
             for (unsigned j=0; j<chosen_neighbour; j++)
             {
                 neighbour_iter++;
             }
 
-            neighbour_location_index = *neighbour_iter;
+            unsigned neighbour_location_index = *neighbour_iter;
 
-            std::set<unsigned> containing_elements = p_node->rGetContainingElementIndices();
-            std::set<unsigned> neighbour_containing_elements = GetNode(neighbour_location_index)->rGetContainingElementIndices();
-            // Only calculate Hamiltonian and update elements if the nodes are from different elements, or one is from the medium
-            if ((!containing_elements.empty() && neighbour_containing_elements.empty())
-                || (containing_elements.empty() && !neighbour_containing_elements.empty())
-                || (!containing_elements.empty() && !neighbour_containing_elements.empty() && *containing_elements.begin() != *neighbour_containing_elements.begin()))
+            double delta_H = 0.0; // This is H_1-H_0.
+            if (EvaluateHamiltonianDifference(node_index, neighbour_location_index, delta_H))
             {
-                double delta_H = 0.0; // This is H_1-H_0.
-
-                // Now add contributions to the Hamiltonian from each AbstractPottsUpdateRule
-                for (typename std::vector<boost::shared_ptr<AbstractUpdateRule<DIM> > >::iterator iter = this->mUpdateRuleCollection.begin();
-                     iter != this->mUpdateRuleCollection.end();
-                     ++iter)
-                {
-                    // This static cast is fine, since we assert the update rule must be a Potts update rule in AddUpdateRule()
-                    double dH = (boost::static_pointer_cast<AbstractPottsUpdateRule<DIM> >(*iter))->EvaluateHamiltonianContribution(neighbour_location_index, p_node->GetIndex(), *this);
-                    delta_H += dH;
-                }
-
                 // Generate a uniform random number to do the random motion
                 double random_number = p_gen->ranf();
 
                 double p = exp(-delta_H/mTemperature);
                 if (delta_H <= 0 || random_number < p)
                 {
-                    // Do swap
+                    SwitchLatticeSite(node_index, neighbour_location_index);
+                }
+            }
+        }
+    }
+}
 
-                    // Remove the current node from any elements containing it (there should be at most one such element)
-                    for (std::set<unsigned>::iterator iter = containing_elements.begin();
-                         iter != containing_elements.end();
-                         ++iter)
-                    {
-                        GetElement(*iter)->DeleteNode(GetElement(*iter)->GetNodeLocalIndex(node_index));
+template <unsigned DIM>
+bool PottsBasedCellPopulation<DIM>::EvaluateHamiltonianDifference(unsigned nodeIndex, unsigned neighbourIndex, double& rDeltaH)
+{
+    Node<DIM>* p_node = this->mrMesh.GetNode(nodeIndex);
 
-                        ///\todo If this causes the element to have no nodes then flag the element and cell to be deleted
-                    }
+    // Each node in the mesh must be in at most one element
+    assert(p_node->GetNumContainingElements() <= 1);
+
+    const std::set<unsigned>& r_containing_elements = p_node->rGetContainingElementIndices();
+    const std::set<unsigned>& r_neighbour_containing_elements = this->mrMesh.GetNode(neighbourIndex)->rGetContainingElementIndices();
+
+    // Only calculate Hamiltonian and update elements if the nodes are from different elements, or one is from the medium
+    if ((!r_containing_elements.empty() && r_neighbour_containing_elements.empty())
+        || (r_containing_elements.empty() && !r_neighbour_containing_elements.empty())
+        || (!r_containing_elements.empty() && !r_neighbour_containing_elements.empty() && *r_containing_elements.begin() != *r_neighbour_containing_elements.begin()))
+    {
+        rDeltaH = 0.0;
+
+        // Now add contributions to the Hamiltonian from each AbstractPottsUpdateRule
+        for (typename std::vector<boost::shared_ptr<AbstractUpdateRule<DIM> > >::iterator iter = this->mUpdateRuleCollection.begin();
+             iter != this->mUpdateRuleCollection.end();
+             ++iter)
+        {
+            // This static cast is fine, since we assert the update rule must be a Potts update rule in AddUpdateRule()
+            double dH = (boost::static_pointer_cast<AbstractPottsUpdateRule<DIM> >(*iter))->EvaluateHamiltonianContribution(neighbourIndex, nodeIndex, *this);
+            rDeltaH += dH;
+        }
+        return true;
+    }
+    return false;
+}
 
-                    // Next add the current node to any elements containing the neighbouring node (there should be at most one such element)
-                    for (std::set<unsigned>::iterator iter = neighbour_containing_elements.begin();
-                         iter != neighbour_containing_elements.end();
-                         ++iter)
+template <unsigned DIM>
+void PottsBasedCellPopulation<DIM>::SwitchLatticeSite(unsigned nodeIndex, unsigned neighbourIndex)
+{
+    // Move the current node into the element containing the neighbouring node (there should be at most one such element)
+    const std::set<unsigned>& r_neighbour_containing_elements = this->mrMesh.GetNode(neighbourIndex)->rGetContainingElementIndices();
+    unsigned new_element_index = r_neighbour_containing_elements.empty() ? UNSIGNED_UNSET : *(r_neighbour_containing_elements.begin());
+
+    mpPottsMesh->MoveNodeToElement(nodeIndex, new_element_index);
+}
+
+template <unsigned DIM>
+void PottsBasedCellPopulation<DIM>::ComputeSublattices()
+{
+    unsigned num_nodes = this->mrMesh.GetNumNodes();
+    std::vector<unsigned> node_colours(num_nodes, UINT_MAX);
+    mSublattices.clear();
+
+    for (unsigned node_index=0; node_index<num_nodes; node_index++)
+    {
+        // Find the colours already used by neighbours of this node
+        const std::set<unsigned>& r_neighbours = mpPottsMesh->rGetMooreNeighbouringNodeIndices(node_index);
+        std::vector<bool> colour_is_used(mSublattices.size() + 1, false);
+        for (std::set<unsigned>::const_iterator iter = r_neighbours.begin();
+             iter != r_neighbours.end();
+             ++iter)
+        {
+            if (node_colours[*iter] < colour_is_used.size())
+            {
+                colour_is_used[node_colours[*iter]] = true;
+            }
+        }
+
+        // Give this node the lowest free colour
+        unsigned colour = 0;
+        while (colour_is_used[colour])
+        {
+            colour++;
+        }
+        if (colour == mSublattices.size())
+        {
+            mSublattices.push_back(std::vector<unsigned>());
+        }
+        node_colours[node_index] = colour;
+        mSublattices[colour].push_back(node_index);
+    }
+}
+
+template <unsigned DIM>
+void PottsBasedCellPopulation<DIM>::UpdateCellLocationsOnSublattices()
+{
+    // Each block of sites has its own random number stream; a fixed block size makes the results independent of the number of threads
+    const unsigned block_size = 1024;
+
+    RandomNumberGenerator* p_gen = RandomNumberGenerator::Instance();
+
+    unsigned num_nodes_in_sublattices = 0;
+    for (unsigned colour=0; colour<mSublattices.size(); colour++)
+    {
+        num_nodes_in_sublattices += mSublattices[colour].size();
+    }
+    if (num_nodes_in_sublattices != this->mrMesh.GetNumNodes())
+    {
+        ComputeSublattices();
+    }
+
+    std::vector<unsigned> sublattice_order(mSublattices.size());
+    std::vector<unsigned> neighbours_to_copy;
+    std::vector<unsigned int> block_seeds;
+
+    for (unsigned sweep=0; sweep<mNumSweepsPerTimestep; sweep++)
+    {
+        for (unsigned colour=0; colour<sublattice_order.size(); colour++)
+        {
+            sublattice_order[colour] = colour;
+        }
+        if (this->mUpdateNodesInRandomOrder && !sublattice_order.empty())
+        {
+            // Fisher-Yates shuffle of the order in which the sublattices are visited
+            for (unsigned end=sublattice_order.size()-1; end>0; end--)
+            {
+                std::swap(sublattice_order[end], sublattice_order[p_gen->randMod(end + 1)]);
+            }
+        }
+
+        for (unsigned order_index=0; order_index<sublattice_order.size(); order_index++)
+        {
+            const std::vector<unsigned>& r_sites = mSublattices[sublattice_order[order_index]];
+            const int num_blocks = static_cast<int>((r_sites.size() + block_size - 1)/block_size);
+
+            block_seeds.resize(num_blocks);
+            for (int block=0; block<num_blocks; block++)
+            {
+                block_seeds[block] = p_gen->randMod(UINT_MAX);
+            }
+
+            // Make sure the cached element surface areas are not computed concurrently
+            if (DIM > 1)
+            {
+                mpPottsMesh->UpdateElementSurfaceAreas();
+            }
+
+            // Propose an update at each site; UINT_MAX means that the site is unchanged
+            neighbours_to_copy.assign(r_sites.size(), UINT_MAX);
+            OpenMpExceptionCollector exception_collector;
+#ifdef CHASTE_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mNumThreads)
+#endif // CHASTE_OPENMP
+            for (int block=0; block<num_blocks; block++)
+            {
+                try
+                {
+                    boost::mt19937 block_generator(block_seeds[block]);
+                    boost::uniform_real<> unit_interval(0.0, 1.0);
+                    boost::variate_generator<boost::mt19937&, boost::uniform_real<> > generate_unit_real(block_generator, unit_interval);
+
+                    unsigned block_end = std::min(static_cast<unsigned>(r_sites.size()), (block + 1)*block_size);
+                    for (unsigned i=block*block_size; i<block_end; i++)
                     {
-                        GetElement(*iter)->AddNode(this->mrMesh.GetNode(node_index));
+                        unsigned node_index = r_sites[i];
+                        const std::set<unsigned>& r_neighbouring_node_indices = mpPottsMesh->rGetMooreNeighbouringNodeIndices(node_index);
+                        if (r_neighbouring_node_indices.empty())
+                        {
+                            continue;
+                        }
+
+                        unsigned num_neighbours = r_neighbouring_node_indices.size();
+                        unsigned chosen_neighbour = std::min(static_cast<unsigned>(generate_unit_real()*num_neighbours), num_neighbours - 1);
+                        std::set<unsigned>::const_iterator neighbour_iter = r_neighbouring_node_indices.begin();
+                        std::advance(neighbour_iter, chosen_neighbour);
+
+                        double delta_H = 0.0;
+                        if (EvaluateHamiltonianDifference(node_index, *neighbour_iter, delta_H))
+                        {
+                            double random_number = generate_unit_real();
+                            if (delta_H <= 0 || random_number < exp(-delta_H/mTemperature))
+                            {
+                                neighbours_to_copy[i] = *neighbour_iter;
+                            }
+                        }
                     }
                 }
+                catch (...)
+                {
+                    exception_collector.Capture();
+                }
+            }
+            exception_collector.RethrowIfAny();
+
+            // The neighbours are not in this sublattice, so the switches do not affect each other
+            for (unsigned i=0; i<r_sites.size(); i++)
+            {
+                if (neighbours_to_copy[i] != UINT_MAX)
+                {
+                    SwitchLatticeSite(r_sites[i], neighbours_to_copy[i]);
+                }
             }
         }
     }
@@ -509,6 +676,34 @@ unsigned PottsBasedCellPopulation<DIM>::GetNumSweepsPerTimestep()
     return mNumSweepsPerTimestep;
 }
 
+template <unsigned DIM>
+void PottsBasedCellPopulation<DIM>::SetUseSublatticeUpdates(bool useSublatticeUpdates)
+{
+    mUseSublatticeUpdates = useSublatticeUpdates;
+}
+
+template <unsigned DIM>
+bool PottsBasedCellPopulation<DIM>::GetUseSublatticeUpdates()
+{
+    return mUseSublatticeUpdates;
+}
+
+template <unsigned DIM>
+void PottsBasedCellPopulation<DIM>::SetNumberOfThreads(unsigned numThreads)
+{
+    if (numThreads == 0u)
+    {
+        EXCEPTION("The number of threads must be at least one.");
+    }
+    mNumThreads = numThreads;
+}
+
+template <unsigned DIM>
+unsigned PottsBasedCellPopulation<DIM>::GetNumberOfThreads()
+{
+    return mNumThreads;
+}
+
 template <unsigned DIM>
 void PottsBasedCellPopulation<DIM>::WriteVtkResultsToFile(const std::string& rDirectory)
 {
@@ -635,9 +830,9 @@ void PottsBasedCellPopulation<DIM>::WriteVtkResultsToFile(const std::string& rDi
             unsigned node_index = iter->GetIndex();
             std::set<unsigned> element_indices = iter->rGetContainingElementIndices();
 
-            std::set<unsigned> target_neighbouring_node_indices = this->rGetMesh().GetVonNeumannNeighbouringNodeIndices(node_index);
+            const std::set<unsigned>& target_neighbouring_node_indices = this->rGetMesh().rGetVonNeumannNeighbouringNodeIndices(node_index);
 
-            for (std::set<unsigned>::iterator neighbour_iter = target_neighbouring_node_indices.begin();
+            for (std::set<unsigned>::const_iterator neighbour_iter = target_neighbouring_node_indices.begin();
                  neighbour_iter != target_neighbouring_node_indices.end();
                  ++neighbour_iter)
             {
@@ -91,6 +91,25 @@ private:
      */
     unsigned mNumSweepsPerTimestep;
 
+    /**
+     * Whether UpdateCellLocations() updates the lattice one sublattice at a time, so that the
+     * sites of each sublattice can be updated concurrently. Not archived, since it is a
+     * property of the run. Defaults to false.
+     */
+    bool mUseSublatticeUpdates;
+
+    /**
+     * The number of threads used to update each sublattice when mUseSublatticeUpdates is true.
+     * Not archived, since it is a property of the run. Defaults to 1.
+     */
+    unsigned mNumThreads;
+
+    /**
+     * The sublattices used when mUseSublatticeUpdates is true. No two nodes in the same sublattice
+     * are Moore neighbours. Computed by ComputeSublattices() when first needed.
+     */
+    std::vector<std::vector<unsigned> > mSublattices;
+
     friend class boost::serialization::access;
     /**
      * Serialize the object and its member variables.
@@ -125,6 +144,46 @@ private:
      */
     void Validate();
 
+    /**
+     * Helper method for UpdateCellLocations().
+     *
+     * @param nodeIndex the index of the lattice site to be updated
+     * @param neighbourIndex the index of the neighbouring site whose element the site would join
+     * @param rDeltaH the change in the Hamiltonian if the switch is made
+     * @return whether the two sites are in different elements (or one is in the medium), in which
+     *     case the switch is considered and rDeltaH has been evaluated
+     */
+    bool EvaluateHamiltonianDifference(unsigned nodeIndex, unsigned neighbourIndex, double& rDeltaH);
+
+    /**
+     * Helper method for UpdateCellLocations(). Move a lattice site into the element containing a
+     * neighbouring site (or into the medium, if the neighbouring site is in the medium), using
+     * PottsMesh::MoveNodeToElement() so that the running totals of element surface areas are kept.
+     *
+     * @param nodeIndex the index of the lattice site to be moved
+     * @param neighbourIndex the index of the neighbouring site
+     */
+    void SwitchLatticeSite(unsigned nodeIndex, unsigned neighbourIndex);
+
+    /**
+     * Helper method for UpdateCellLocations(). Partition the nodes of the mesh into sublattices
+     * by greedily colouring the Moore neighbourhood graph in node index order, storing the
+     * result in mSublattices. On a regular lattice this gives the 2^DIM checkerboard sublattices.
+     */
+    void ComputeSublattices();
+
+    /**
+     * Helper method for UpdateCellLocations(), used when mUseSublatticeUpdates is true.
+     *
+     * Each sweep visits every sublattice once (in a random order if mUpdateNodesInRandomOrder is
+     * true) and proposes an update at every site of that sublattice. As no two sites of a
+     * sublattice are neighbours, the proposals are evaluated concurrently against the
+     * configuration at the start of the sublattice update; the accepted switches are then made in
+     * node index order. The sites are split into fixed blocks, each with its own random number
+     * stream seeded from RandomNumberGenerator, so the results do not depend on the number of threads.
+     */
+    void UpdateCellLocationsOnSublattices();
+
     /**
      * Overridden WriteVtkResultsToFile() method.
      *
@@ -386,6 +445,37 @@ public:
      */
     unsigned GetNumSweepsPerTimestep();
 
+    /**
+     * Set whether UpdateCellLocations() should update the lattice one sublattice at a time. Within
+     * each sublattice no two sites are neighbours, so the adhesion energy changes of their updates
+     * are independent; other contributions to the Hamiltonian, such as volume and surface area
+     * constraints, are evaluated against the configuration at the start of each sublattice update.
+     * This allows the updates to be shared out between threads (see SetNumberOfThreads()), but
+     * gives different (though statistically similar) dynamics to the default sequential updates.
+     *
+     * @param useSublatticeUpdates whether to use sublattice updates (defaults to true)
+     */
+    void SetUseSublatticeUpdates(bool useSublatticeUpdates=true);
+
+    /**
+     * @return mUseSublatticeUpdates
+     */
+    bool GetUseSublatticeUpdates();
+
+    /**
+     * Set the number of threads used to update each sublattice, if sublattice updates are used.
+     * This is ignored unless Chaste was built with OpenMP support (Chaste_USE_OPENMP). The update
+     * rules' EvaluateHamiltonianContribution() methods must then be safe to call concurrently.
+     *
+     * @param numThreads the number of threads (at least 1)
+     */
+    void SetNumberOfThreads(unsigned numThreads);
+
+    /**
+     * @return the number of threads used to update each sublattice.
+     */
+    unsigned GetNumberOfThreads();
+
     /**
      * Create a Element tessellation of the mesh for use in visualising the mesh.
      */
@@ -75,7 +75,7 @@ unsigned ShovingCaBasedDivisionRule<SPACE_DIM>::CalculateDaughterNodeIndex(CellP
     PottsMesh<SPACE_DIM>* p_static_cast_mesh = static_cast<PottsMesh<SPACE_DIM>*>(&(rCellPopulation.rGetMesh()));
 
     // Get the set of neighbouring node indices
-    std::set<unsigned> neighbouring_node_indices = p_static_cast_mesh->GetMooreNeighbouringNodeIndices(parent_node_index);
+    const std::set<unsigned>& neighbouring_node_indices = p_static_cast_mesh->rGetMooreNeighbouringNodeIndices(parent_node_index);
     unsigned num_neighbours = neighbouring_node_indices.size();
 
     // Check cell is not on the boundary
@@ -87,7 +87,7 @@ unsigned ShovingCaBasedDivisionRule<SPACE_DIM>::CalculateDaughterNodeIndex(CellP
     double total_propensity = 0.0;
 
     // Select neighbour at random
-    for (std::set<unsigned>::iterator neighbour_iter = neighbouring_node_indices.begin();
+    for (std::set<unsigned>::const_iterator neighbour_iter = neighbouring_node_indices.begin();
          neighbour_iter != neighbouring_node_indices.end();
          ++neighbour_iter)
     {
@@ -138,25 +138,23 @@ unsigned ShovingCaBasedDivisionRule<SPACE_DIM>::CalculateDaughterNodeIndex(CellP
         int move_number = 0;
         unsigned current_node_index = parent_node_index;
         unsigned target_node_index = daughter_node_index;
+
+        // Use the flat form of the Moore neighbourhoods to pick out the neighbour in constant time
+        const std::vector<unsigned>& r_neighbour_offsets = p_static_cast_mesh->rGetMooreNeighbourOffsets();
+        const std::vector<unsigned>& r_neighbour_indices = p_static_cast_mesh->rGetMooreNeighbourIndices();
         while (is_neighbour_occupied && move_number < max_moves)
         {
             move_number++;
             current_node_index = target_node_index;
 
-            std::set<unsigned> neighbouring_node_indices = p_static_cast_mesh->GetMooreNeighbouringNodeIndices(current_node_index);
+            unsigned num_current_neighbours = r_neighbour_offsets[current_node_index+1] - r_neighbour_offsets[current_node_index];
 
             // Check cell is not on the boundary
-            IsNodeOnBoundary(neighbouring_node_indices.size());
+            IsNodeOnBoundary(num_current_neighbours);
 
             // Select the appropriate neighbour
-            std::set<unsigned>::iterator neighbour_iter = neighbouring_node_indices.begin();
-            for (unsigned i=0; i<counter; i++)
-            {
-                ++neighbour_iter;
-            }
-            assert(neighbour_iter != neighbouring_node_indices.end());
-
-            target_node_index = *neighbour_iter;
+            assert(counter < num_current_neighbours);
+            target_node_index = r_neighbour_indices[r_neighbour_offsets[current_node_index] + counter];
 
             std::pair<unsigned, unsigned> new_move(current_node_index, target_node_index);
 
@@ -45,6 +45,30 @@ AbstractForce<ELEMENT_DIM, SPACE_DIM>::~AbstractForce()
 {
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool AbstractForce<ELEMENT_DIM, SPACE_DIM>::AddForceJacobianContribution(AbstractCellPopulation<ELEMENT_DIM,SPACE_DIM>& rCellPopulation,
+                                                                         std::vector<std::map<unsigned, c_matrix<double, SPACE_DIM, SPACE_DIM> > >& rJacobian)
+{
+    return false;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool AbstractForce<ELEMENT_DIM, SPACE_DIM>::AddForceContributionOnBackend(AbstractCellPopulation<ELEMENT_DIM,SPACE_DIM>& rCellPopulation,
+                                                                          NodeBasedMechanicsBackend<SPACE_DIM>& rBackend)
+{
+    return false;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+c_matrix<double, SPACE_DIM, SPACE_DIM>& AbstractForce<ELEMENT_DIM, SPACE_DIM>::rGetJacobianBlock(std::vector<std::map<unsigned, c_matrix<double, SPACE_DIM, SPACE_DIM> > >& rJacobian,
+                                                                                                 unsigned rowNodeIndex,
+                                                                                                 unsigned columnNodeIndex)
+{
+    assert(rowNodeIndex < rJacobian.size());
+    c_matrix<double, SPACE_DIM, SPACE_DIM> zero_block = zero_matrix<double>(SPACE_DIM, SPACE_DIM);
+    return rJacobian[rowNodeIndex].insert(std::make_pair(columnNodeIndex, zero_block)).first->second;
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void AbstractForce<ELEMENT_DIM, SPACE_DIM>::OutputForceInfo(out_stream& rParamsFile)
 {
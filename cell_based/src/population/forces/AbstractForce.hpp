@@ -36,11 +36,16 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef ABSTRACTFORCE_HPP_
 #define ABSTRACTFORCE_HPP_
 
+#include <map>
+#include <vector>
+
 #include "ChasteSerialization.hpp"
 #include "ClassIsAbstract.hpp"
 
 #include "AbstractCellPopulation.hpp"
 
+template <unsigned DIM> class NodeBasedMechanicsBackend;
+
 /**
  * An abstract force class, for use in cell-based simulations.
  */
@@ -60,6 +65,21 @@ class AbstractForce : public Identifiable
     {
     }
 
+protected:
+
+    /**
+     * Get a block of a Jacobian passed to AddForceJacobianContribution(), inserting
+     * a zero block if there is none yet.
+     *
+     * @param rJacobian the Jacobian of the applied forces, indexed by node
+     * @param rowNodeIndex the global index of the node whose force is differentiated
+     * @param columnNodeIndex the global index of the node whose location it is differentiated with respect to
+     * @return the block.
+     */
+    static c_matrix<double, SPACE_DIM, SPACE_DIM>& rGetJacobianBlock(std::vector<std::map<unsigned, c_matrix<double, SPACE_DIM, SPACE_DIM> > >& rJacobian,
+                                                                    unsigned rowNodeIndex,
+                                                                    unsigned columnNodeIndex);
+
 public:
 
     /**
@@ -82,6 +102,36 @@ public:
      */
     virtual void AddForceContribution(AbstractCellPopulation<ELEMENT_DIM,SPACE_DIM>& rCellPopulation)=0;
 
+    /**
+     * Add the derivatives of this force with respect to the node locations, for use
+     * by implicit numerical methods. Entry rJacobian[i][j] is the derivative of the
+     * force on node i with respect to the location of node j, where i and j are
+     * global node indices; only non-zero blocks need be added.
+     *
+     * By default no contribution is added and false is returned, in which case
+     * implicit numerical methods treat this force explicitly.
+     *
+     * @param rCellPopulation reference to the cell population
+     * @param rJacobian the Jacobian of the applied forces, indexed by node
+     * @return whether this force added its Jacobian.
+     */
+    virtual bool AddForceJacobianContribution(AbstractCellPopulation<ELEMENT_DIM,SPACE_DIM>& rCellPopulation,
+                                              std::vector<std::map<unsigned, c_matrix<double, SPACE_DIM, SPACE_DIM> > >& rJacobian);
+
+    /**
+     * Add this force to the node forces held by a NodeBasedMechanicsBackend, using
+     * the node locations resident there rather than those of the population's nodes.
+     *
+     * By default nothing is added and false is returned, in which case the numerical
+     * method calls AddForceContribution() on the host instead.
+     *
+     * @param rCellPopulation reference to the cell population
+     * @param rBackend the backend holding the node locations and forces
+     * @return whether this force was added on the backend.
+     */
+    virtual bool AddForceContributionOnBackend(AbstractCellPopulation<ELEMENT_DIM,SPACE_DIM>& rCellPopulation,
+                                               NodeBasedMechanicsBackend<SPACE_DIM>& rBackend);
+
     /**
      * Outputs force used in the simulation to file and then calls OutputForceParameters to output all relevant parameters.
      *
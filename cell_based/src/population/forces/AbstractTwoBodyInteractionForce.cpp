@@ -35,11 +35,14 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "AbstractTwoBodyInteractionForce.hpp"
 
+#include "OpenMpExceptionCollector.hpp"
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 AbstractTwoBodyInteractionForce<ELEMENT_DIM,SPACE_DIM>::AbstractTwoBodyInteractionForce()
    : AbstractForce<ELEMENT_DIM,SPACE_DIM>(),
      mUseCutOffLength(false),
-     mMechanicsCutOffLength(DBL_MAX)
+     mMechanicsCutOffLength(DBL_MAX),
+     mNumThreads(1u)
 {
 }
 
@@ -63,6 +66,30 @@ double AbstractTwoBodyInteractionForce<ELEMENT_DIM,SPACE_DIM>::GetCutOffLength()
     return mMechanicsCutOffLength;
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractTwoBodyInteractionForce<ELEMENT_DIM,SPACE_DIM>::SetNumberOfThreads(unsigned numThreads)
+{
+    if (numThreads == 0u)
+    {
+        EXCEPTION("The number of force threads must be at least one.");
+    }
+    mNumThreads = numThreads;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned AbstractTwoBodyInteractionForce<ELEMENT_DIM,SPACE_DIM>::GetNumberOfThreads() const
+{
+    return mNumThreads;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool AbstractTwoBodyInteractionForce<ELEMENT_DIM,SPACE_DIM>::CalculateForcesForNodePairs(std::vector<std::pair<Node<SPACE_DIM>*, Node<SPACE_DIM>*> >& rNodePairs,
+                                                                                        AbstractCellPopulation<ELEMENT_DIM,SPACE_DIM>& rCellPopulation,
+                                                                                        std::vector<c_vector<double, SPACE_DIM> >& rForces)
+{
+    return false;
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void AbstractTwoBodyInteractionForce<ELEMENT_DIM,SPACE_DIM>::AddForceContribution(AbstractCellPopulation<ELEMENT_DIM,SPACE_DIM>& rCellPopulation)
 {
@@ -100,6 +127,56 @@ void AbstractTwoBodyInteractionForce<ELEMENT_DIM,SPACE_DIM>::AddForceContributio
 
         std::vector< std::pair<Node<SPACE_DIM>*, Node<SPACE_DIM>* > >& r_node_pairs = p_static_cast_cell_population->rGetNodePairs();
 
+        // Use the batched kernel if this force provides one
+        bool have_pair_forces = CalculateForcesForNodePairs(r_node_pairs, rCellPopulation, mPairForces);
+
+#ifdef CHASTE_OPENMP
+        if (!have_pair_forces && mNumThreads > 1u)
+        {
+            /*
+             * Each pair's force only depends on that pair, so the pairs can be shared
+             * out between threads. To avoid write conflicts on the nodes, the forces
+             * are stored per pair and added to the nodes afterwards. The first
+             * exception thrown by any thread is re-thrown once all have finished.
+             */
+            const int num_pairs = static_cast<int>(r_node_pairs.size());
+            mPairForces.resize(r_node_pairs.size());
+            OpenMpExceptionCollector exception_collector;
+#pragma omp parallel for schedule(static) num_threads(mNumThreads)
+            for (int i = 0; i < num_pairs; i++)
+            {
+                try
+                {
+                    mPairForces[i] = CalculateForceBetweenNodes(r_node_pairs[i].first->GetIndex(),
+                                                                r_node_pairs[i].second->GetIndex(),
+                                                                rCellPopulation);
+                }
+                catch (...)
+                {
+                    exception_collector.Capture();
+                }
+            }
+            exception_collector.RethrowIfAny();
+            have_pair_forces = true;
+        }
+#endif // CHASTE_OPENMP
+
+        if (have_pair_forces)
+        {
+            assert(mPairForces.size() == r_node_pairs.size());
+            for (unsigned i=0; i<r_node_pairs.size(); i++)
+            {
+                for (unsigned j=0; j<SPACE_DIM; j++)
+                {
+                    assert(!std::isnan(mPairForces[i][j]));
+                }
+                c_vector<double, SPACE_DIM> negative_force = -1.0*mPairForces[i];
+                r_node_pairs[i].first->AddAppliedForceContribution(mPairForces[i]);
+                r_node_pairs[i].second->AddAppliedForceContribution(negative_force);
+            }
+            return;
+        }
+
         for (typename std::vector< std::pair<Node<SPACE_DIM>*, Node<SPACE_DIM>* > >::iterator iter = r_node_pairs.begin();
             iter != r_node_pairs.end();
             iter++)
@@ -71,6 +71,20 @@ protected:
     /** Mechanics cut off length. */
     double mMechanicsCutOffLength;
 
+    /**
+     * Number of shared-memory threads over which the node pairs of a
+     * NodeBasedCellPopulation are shared out in AddForceContribution().
+     * Not archived, since it is a property of the run. Defaults to 1.
+     */
+    unsigned mNumThreads;
+
+    /**
+     * The force on the first node of each node pair, used to accumulate
+     * the forces when they are calculated by several threads or by
+     * CalculateForcesForNodePairs().
+     */
+    std::vector<c_vector<double, SPACE_DIM> > mPairForces;
+
 public:
 
     /**
@@ -100,6 +114,27 @@ public:
      */
     double GetCutOffLength();
 
+    /**
+     * Set the number of shared-memory threads over which the calculation of
+     * the forces between node pairs is split, so that several cores can be
+     * used within one process. Each thread calculates the forces for its share
+     * of the pairs, and the forces are then added to the nodes in the same
+     * order as in serial, so the results do not depend on the number of threads.
+     * Only NodeBasedCellPopulations are threaded, and this is ignored unless
+     * Chaste was built with OpenMP support (Chaste_USE_OPENMP).
+     *
+     * Note that CalculateForceBetweenNodes() must then be safe to call
+     * concurrently for different pairs.
+     *
+     * @param numThreads the number of threads (at least 1)
+     */
+    void SetNumberOfThreads(unsigned numThreads);
+
+    /**
+     * @return the number of threads used for force calculation.
+     */
+    unsigned GetNumberOfThreads() const;
+
     /**
      * Calculates the force between two nodes.
      *
@@ -116,6 +151,26 @@ public:
      */
     virtual c_vector<double, SPACE_DIM> CalculateForceBetweenNodes(unsigned nodeAGlobalIndex, unsigned nodeBGlobalIndex, AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>& rCellPopulation)=0;
 
+    /**
+     * Calculate the forces for a whole list of node pairs at once.
+     *
+     * This is called by AddForceContribution() for a NodeBasedCellPopulation
+     * before falling back on calling CalculateForceBetweenNodes() for each pair.
+     * Subclasses may override it to gather whatever per-cell quantities they
+     * need once per time step and then compute all the forces in a simple loop
+     * over contiguous arrays, which the compiler can vectorise. The default
+     * implementation does nothing and returns false.
+     *
+     * @param rNodePairs the node pairs of the population
+     * @param rCellPopulation the cell population
+     * @param rForces filled in with the force exerted on the first node of each pair by the second
+     *
+     * @return whether the forces were calculated.
+     */
+    virtual bool CalculateForcesForNodePairs(std::vector<std::pair<Node<SPACE_DIM>*, Node<SPACE_DIM>*> >& rNodePairs,
+                                             AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>& rCellPopulation,
+                                             std::vector<c_vector<double, SPACE_DIM> >& rForces);
+
     /**
      * Overridden AddForceContribution() method.
      *
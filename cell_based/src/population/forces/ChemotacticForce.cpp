@@ -40,7 +40,8 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 template <unsigned DIM>
 ChemotacticForce<DIM>::ChemotacticForce()
-    : AbstractForce<DIM>()
+    : AbstractForce<DIM>(),
+      mUseCellDataGradient(false)
 {
 }
 
@@ -56,11 +57,34 @@ double ChemotacticForce<DIM>::GetChemotacticForceMagnitude(const double concentr
                           // without tests failing
 }
 
+template <unsigned DIM>
+void ChemotacticForce<DIM>::SetUseCellDataGradient(bool useCellDataGradient)
+{
+    mUseCellDataGradient = useCellDataGradient;
+}
+
+template <unsigned DIM>
+bool ChemotacticForce<DIM>::GetUseCellDataGradient() const
+{
+    return mUseCellDataGradient;
+}
+
 template <unsigned DIM>
 void ChemotacticForce<DIM>::AddForceContribution(AbstractCellPopulation<DIM>& rCellPopulation)
 {
     CellwiseDataGradient<DIM> gradients;
-    gradients.SetupGradients(rCellPopulation, "nutrient");
+    c_vector<unsigned, 3> gradient_item_indices;
+    if (mUseCellDataGradient)
+    {
+        gradient_item_indices[0] = CellData::GetItemIndex("nutrient_grad_x");
+        gradient_item_indices[1] = CellData::GetItemIndex("nutrient_grad_y");
+        gradient_item_indices[2] = CellData::GetItemIndex("nutrient_grad_z");
+    }
+    else
+    {
+        gradients.SetupGradients(rCellPopulation, "nutrient");
+    }
+    unsigned nutrient_item_index = CellData::GetItemIndex("nutrient");
 
     for (typename AbstractCellPopulation<DIM>::Iterator cell_iter = rCellPopulation.Begin();
          cell_iter != rCellPopulation.End();
@@ -71,16 +95,27 @@ void ChemotacticForce<DIM>::AddForceContribution(AbstractCellPopulation<DIM>& rC
         {
             unsigned node_global_index = rCellPopulation.GetLocationIndexUsingCell(*cell_iter);
 
-            c_vector<double,DIM>& r_gradient = gradients.rGetGradient(node_global_index);
-            double nutrient_concentration = cell_iter->GetCellData()->GetItem("nutrient");
-            double magnitude_of_gradient = norm_2(r_gradient);
+            c_vector<double,DIM> gradient;
+            if (mUseCellDataGradient)
+            {
+                for (unsigned i=0; i<DIM; i++)
+                {
+                    gradient[i] = cell_iter->GetCellData()->GetItem(gradient_item_indices[i]);
+                }
+            }
+            else
+            {
+                gradient = gradients.rGetGradient(node_global_index);
+            }
+            double nutrient_concentration = cell_iter->GetCellData()->GetItem(nutrient_item_index);
+            double magnitude_of_gradient = norm_2(gradient);
 
             double force_magnitude = GetChemotacticForceMagnitude(nutrient_concentration, magnitude_of_gradient);
 
             // force += chi * gradC/|gradC|
             if (magnitude_of_gradient > 0)
             {
-                c_vector<double,DIM> force = (force_magnitude/magnitude_of_gradient)*r_gradient;
+                c_vector<double,DIM> force = (force_magnitude/magnitude_of_gradient)*gradient;
                 rCellPopulation.GetNode(node_global_index)->AddAppliedForceContribution(force);
             }
             // else Fc=0
@@ -91,7 +126,7 @@ void ChemotacticForce<DIM>::AddForceContribution(AbstractCellPopulation<DIM>& rC
 template <unsigned DIM>
 void ChemotacticForce<DIM>::OutputForceParameters(out_stream& rParamsFile)
 {
-    // No parameters to include
+    *rParamsFile << "\t\t\t<UseCellDataGradient>" << mUseCellDataGradient << "</UseCellDataGradient>\n";
 
     // Call method on direct parent class
     AbstractForce<DIM>::OutputForceParameters(rParamsFile);
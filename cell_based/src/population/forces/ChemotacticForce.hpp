@@ -51,6 +51,13 @@ friend class TestForces;
 
 private:
 
+    /**
+     * Whether to read the nutrient gradient from the "nutrient_grad_x" (and _y, _z)
+     * CellData items written by a PDE modifier, instead of recovering it from the
+     * cell data with a CellwiseDataGradient. Defaults to false.
+     */
+    bool mUseCellDataGradient;
+
     /**
      * @return the magnitude of the chemotactic force.
      *
@@ -71,6 +78,7 @@ private:
     void serialize(Archive & archive, const unsigned int version)
     {
         archive & boost::serialization::base_object<AbstractForce<DIM> >(*this);
+        archive & mUseCellDataGradient;
     }
 
 public:
@@ -85,6 +93,23 @@ public:
      */
     ~ChemotacticForce();
 
+    /**
+     * Set whether to use the gradient of the nutrient concentration that a PDE
+     * modifier has stored in CellData (see AbstractPdeModifier::SetOutputGradient()).
+     * This gradient comes from the FE solution, so avoids recomputing a gradient
+     * over the whole mesh each time step, and works with any cell population.
+     * Otherwise the gradient is recovered from the cell data using a
+     * CellwiseDataGradient, which requires a MeshBasedCellPopulation.
+     *
+     * @param useCellDataGradient whether to use the stored gradient (defaults to true)
+     */
+    void SetUseCellDataGradient(bool useCellDataGradient=true);
+
+    /**
+     * @return whether the gradient stored in CellData by a PDE modifier is used.
+     */
+    bool GetUseCellDataGradient() const;
+
     /**
      * Overridden AddForceContribution() method.
      *
@@ -40,11 +40,16 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 template <unsigned DIM>
 const double DiffusionForce<DIM>::msBoltzmannConstant = 4.97033568e-7;
 
+template <unsigned DIM>
+const unsigned DiffusionForce<DIM>::msRandomStreamPurpose = 1u;
+
 template <unsigned DIM>
 DiffusionForce<DIM>::DiffusionForce()
     : AbstractForce<DIM>(),
       mAbsoluteTemperature(296.0), // default to room temperature
-      mViscosity(3.204e-6) // default to viscosity of water at room temperature in (using 10 microns and hours)
+      mViscosity(3.204e-6), // default to viscosity of water at room temperature in (using 10 microns and hours)
+      mUseRandomStreams(false),
+      mNumThreads(1u)
 {
 }
 
@@ -85,12 +90,48 @@ double DiffusionForce<DIM>::GetDiffusionScalingConstant()
     return msBoltzmannConstant*mAbsoluteTemperature/(6.0*mViscosity*M_PI);
 }
 
+template <unsigned DIM>
+void DiffusionForce<DIM>::SetUseRandomStreams(bool useRandomStreams)
+{
+    mUseRandomStreams = useRandomStreams;
+}
+
+template <unsigned DIM>
+bool DiffusionForce<DIM>::GetUseRandomStreams() const
+{
+    return mUseRandomStreams;
+}
+
+template <unsigned DIM>
+void DiffusionForce<DIM>::SetNumberOfThreads(unsigned numThreads)
+{
+    if (numThreads == 0u)
+    {
+        EXCEPTION("The number of force threads must be at least one.");
+    }
+    mNumThreads = numThreads;
+}
+
+template <unsigned DIM>
+unsigned DiffusionForce<DIM>::GetNumberOfThreads() const
+{
+    return mNumThreads;
+}
+
 template <unsigned DIM>
 void DiffusionForce<DIM>::AddForceContribution(AbstractCellPopulation<DIM>& rCellPopulation)
 {
     double dt = SimulationTime::Instance()->GetTimeStep();
-
-    // Iterate over the nodes
+    unsigned time_step = SimulationTime::Instance()->GetTimeStepsElapsed();
+    double diffusion_const_scaling = GetDiffusionScalingConstant();
+    AbstractOffLatticeCellPopulation<DIM>* p_population = dynamic_cast<AbstractOffLatticeCellPopulation<DIM>*>(&rCellPopulation);
+
+    /*
+     * Gather the nodes, and the prefactor of the random displacement of each, in
+     * serial. Only the random draws and the forces are computed in the loop below.
+     */
+    std::vector<Node<DIM>*> nodes;
+    std::vector<double> prefactors;
     for (typename AbstractMesh<DIM, DIM>::NodeIterator node_iter = rCellPopulation.rGetMesh().GetNodeIteratorBegin();
          node_iter != rCellPopulation.rGetMesh().GetNodeIteratorEnd();
          ++node_iter)
@@ -106,7 +147,7 @@ void DiffusionForce<DIM>::AddForceContribution(AbstractCellPopulation<DIM>& rCel
             EXCEPTION("SetRadius() must be called on each Node before calling DiffusionForce::AddForceContribution() to avoid a division by zero error");
         }
 
-        double nu = dynamic_cast<AbstractOffLatticeCellPopulation<DIM>*>(&rCellPopulation)->GetDampingConstant(node_index);
+        double nu = p_population->GetDampingConstant(node_index);
 
         /*
          * Compute the diffusion coefficient D as D = k*T/(6*pi*eta*r), where
@@ -116,26 +157,54 @@ void DiffusionForce<DIM>::AddForceContribution(AbstractCellPopulation<DIM>& rCel
          * eta = dynamic viscosity,
          * r = cell radius.
          */
-        double diffusion_const_scaling = GetDiffusionScalingConstant();
         double diffusion_constant = diffusion_const_scaling/node_radius;
 
+        /*
+         * The force on this cell is scaled with the timestep such that when it is
+         * used in the discretised equation of motion for the cell, we obtain the
+         * correct formula
+         *
+         * x_new = x_old + sqrt(2*D*dt)*W
+         *
+         * where W is a standard normal random variable.
+         */
+        nodes.push_back(&(*node_iter));
+        prefactors.push_back(nu*sqrt(2.0*diffusion_constant*dt)/dt);
+    }
+
+    const int num_nodes = static_cast<int>(nodes.size());
+    if (!mUseRandomStreams)
+    {
+        for (int i = 0; i < num_nodes; i++)
+        {
+            c_vector<double, DIM> force_contribution;
+            for (unsigned j=0; j<DIM; j++)
+            {
+                double xi = RandomNumberGenerator::Instance()->StandardNormalRandomDeviate();
+                force_contribution[j] = prefactors[i]*xi;
+            }
+            nodes[i]->AddAppliedForceContribution(force_contribution);
+        }
+        return;
+    }
+
+    /*
+     * Each node draws from its own stream, and only adds to its own applied force,
+     * so the nodes can be shared out between threads. Any exception (such as a zero
+     * radius) has already been thrown in the serial loop above.
+     */
+#ifdef CHASTE_OPENMP
+#pragma omp parallel for schedule(static) num_threads(mNumThreads)
+#endif // CHASTE_OPENMP
+    for (int i = 0; i < num_nodes; i++)
+    {
+        CounterBasedRandomNumberGenerator stream = RandomNumberGenerator::Instance()->GetStream(nodes[i]->GetIndex(), time_step, msRandomStreamPurpose);
         c_vector<double, DIM> force_contribution;
-        for (unsigned i=0; i<DIM; i++)
+        for (unsigned j=0; j<DIM; j++)
         {
-            /*
-             * The force on this cell is scaled with the timestep such that when it is
-             * used in the discretised equation of motion for the cell, we obtain the
-             * correct formula
-             *
-             * x_new = x_old + sqrt(2*D*dt)*W
-             *
-             * where W is a standard normal random variable.
-             */
-            double xi = RandomNumberGenerator::Instance()->StandardNormalRandomDeviate();
-
-            force_contribution[i] = (nu*sqrt(2.0*diffusion_constant*dt)/dt)*xi;
+            force_contribution[j] = prefactors[i]*stream.StandardNormalRandomDeviate();
         }
-        node_iter->AddAppliedForceContribution(force_contribution);
+        nodes[i]->AddAppliedForceContribution(force_contribution);
     }
 }
 
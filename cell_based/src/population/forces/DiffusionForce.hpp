@@ -71,6 +71,27 @@ private :
      */
     static const double msBoltzmannConstant;
 
+    /**
+     * Identifies the random streams of this force, so that they are
+     * independent of any other streams keyed by node index and time step.
+     */
+    static const unsigned msRandomStreamPurpose;
+
+    /**
+     * Whether to draw the random displacements from per-node counter-based
+     * streams (see RandomNumberGenerator::GetStream()) rather than from the
+     * shared generator. Not archived, since it is a property of the run.
+     * Defaults to false.
+     */
+    bool mUseRandomStreams;
+
+    /**
+     * Number of shared-memory threads over which the nodes are shared out in
+     * AddForceContribution() when random streams are used. Not archived, since
+     * it is a property of the run. Defaults to 1.
+     */
+    unsigned mNumThreads;
+
     /**
      * Archiving.
      */
@@ -139,6 +160,40 @@ public :
      */
     double GetDiffusionScalingConstant();
 
+    /**
+     * Set whether to draw the random displacement of each node from its own
+     * counter-based stream, keyed by the node index and the number of time steps
+     * elapsed, instead of from RandomNumberGenerator::Instance(). The forces then
+     * do not depend on the order in which nodes are visited, which allows them to
+     * be calculated on several threads (see SetNumberOfThreads()). Note that the
+     * same displacements are drawn if the force is calculated more than once in
+     * a time step.
+     *
+     * @param useRandomStreams whether to use per-node random streams (defaults to true)
+     */
+    void SetUseRandomStreams(bool useRandomStreams=true);
+
+    /**
+     * @return whether per-node random streams are used.
+     */
+    bool GetUseRandomStreams() const;
+
+    /**
+     * Set the number of threads used in AddForceContribution(). Threads are only
+     * used if SetUseRandomStreams() has been called, since the shared generator
+     * may not be called concurrently, and are ignored unless Chaste was built
+     * with OpenMP support (Chaste_USE_OPENMP). The results do not depend on the
+     * number of threads.
+     *
+     * @param numThreads the number of threads (at least 1)
+     */
+    void SetNumberOfThreads(unsigned numThreads);
+
+    /**
+     * @return the number of threads used for force calculation.
+     */
+    unsigned GetNumberOfThreads() const;
+
     /**
      * Overridden AddForceContribution() method.
      * Note that this method requires cell/node radii to be set.
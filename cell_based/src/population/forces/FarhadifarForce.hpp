@@ -121,6 +121,20 @@ public:
      */
     virtual void AddForceContribution(AbstractCellPopulation<DIM>& rCellPopulation);
 
+    /**
+     * Overridden AddForceJacobianContribution() method.
+     *
+     * Adds the derivatives of the forces calculated by AddForceContribution(), which are
+     * minus the Hessian of the free energy, so that implicit numerical methods can treat
+     * this force implicitly. This is only available in 2D; otherwise false is returned.
+     *
+     * @param rCellPopulation reference to the cell population
+     * @param rJacobian the Jacobian of the applied forces, indexed by node
+     * @return whether the Jacobian was added.
+     */
+    virtual bool AddForceJacobianContribution(AbstractCellPopulation<DIM>& rCellPopulation,
+                                              std::vector<std::map<unsigned, c_matrix<double, DIM, DIM> > >& rJacobian);
+
     /**
      * Get the line tension parameter for the edge between two given nodes.
      *
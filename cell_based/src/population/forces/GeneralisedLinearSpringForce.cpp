@@ -35,6 +35,12 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "GeneralisedLinearSpringForce.hpp"
 
+#include <algorithm>
+#include <typeinfo>
+
+#include "NodeBasedMechanicsBackend.hpp"
+#include "PeriodicNodesOnlyMesh.hpp"
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 GeneralisedLinearSpringForce<ELEMENT_DIM,SPACE_DIM>::GeneralisedLinearSpringForce()
    : AbstractTwoBodyInteractionForce<ELEMENT_DIM,SPACE_DIM>(),
@@ -227,6 +233,193 @@ c_vector<double, SPACE_DIM> GeneralisedLinearSpringForce<ELEMENT_DIM,SPACE_DIM>:
     }
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool GeneralisedLinearSpringForce<ELEMENT_DIM,SPACE_DIM>::CalculateForcesForNodePairs(std::vector<std::pair<Node<SPACE_DIM>*, Node<SPACE_DIM>*> >& rNodePairs,
+                                                                                     AbstractCellPopulation<ELEMENT_DIM,SPACE_DIM>& rCellPopulation,
+                                                                                     std::vector<c_vector<double, SPACE_DIM> >& rForces)
+{
+    // Subclasses may change the force law, so only use the kernel for this class itself
+    if (typeid(*this) != typeid(GeneralisedLinearSpringForce<ELEMENT_DIM,SPACE_DIM>)
+        || dynamic_cast<NodeBasedCellPopulation<SPACE_DIM>*>(&rCellPopulation) == nullptr)
+    {
+        return false;
+    }
+
+    AbstractCentreBasedCellPopulation<ELEMENT_DIM,SPACE_DIM>* p_static_cast_cell_population = static_cast<AbstractCentreBasedCellPopulation<ELEMENT_DIM,SPACE_DIM>*>(&rCellPopulation);
+    const unsigned num_pairs = rNodePairs.size();
+    rForces.resize(num_pairs);
+
+    /*
+     * Look up the quantities needed from each cell once, indexed by node global
+     * index, rather than once for every pair the cell belongs to.
+     */
+    unsigned max_index = 0;
+    for (unsigned i=0; i<num_pairs; i++)
+    {
+        max_index = std::max(max_index, std::max(rNodePairs[i].first->GetIndex(), rNodePairs[i].second->GetIndex()));
+    }
+    std::vector<bool> node_seen(num_pairs > 0 ? max_index+1 : 0, false);
+    std::vector<double> radii(node_seen.size());
+    std::vector<double> ages(node_seen.size());
+    std::vector<double> times_until_death(node_seen.size(), 1.0);
+    std::vector<double> apoptosis_times(node_seen.size(), 1.0);
+
+    for (unsigned i=0; i<num_pairs; i++)
+    {
+        Node<SPACE_DIM>* p_nodes[2] = {rNodePairs[i].first, rNodePairs[i].second};
+        for (unsigned k=0; k<2; k++)
+        {
+            unsigned index = p_nodes[k]->GetIndex();
+            if (!node_seen[index])
+            {
+                node_seen[index] = true;
+                radii[index] = p_nodes[k]->GetRadius();
+                assert(radii[index] > 0);
+
+                CellPtr p_cell = rCellPopulation.GetCellUsingLocationIndex(index);
+                ages[index] = p_cell->GetAge();
+                assert(!std::isnan(ages[index]));
+                if (p_cell->HasApoptosisBegun())
+                {
+                    times_until_death[index] = p_cell->GetTimeUntilDeath();
+                    apoptosis_times[index] = p_cell->GetApoptosisTime();
+                }
+            }
+        }
+    }
+
+    // Gather the separation and rest length of each pair into contiguous arrays
+    std::vector<double> displacements(SPACE_DIM*num_pairs);
+    std::vector<double> distances(num_pairs);
+    std::vector<double> rest_lengths(num_pairs);
+    std::vector<double> rest_lengths_final(num_pairs);
+    std::vector<char> is_cut_off(num_pairs, 0);
+
+    const double time_step = SimulationTime::Instance()->GetTimeStep();
+    for (unsigned i=0; i<num_pairs; i++)
+    {
+        unsigned index_a = rNodePairs[i].first->GetIndex();
+        unsigned index_b = rNodePairs[i].second->GetIndex();
+        assert(index_a != index_b);
+
+        // GetVectorFromAtoB() may be overloaded, e.g. for periodic meshes
+        c_vector<double, SPACE_DIM> difference = rCellPopulation.rGetMesh().GetVectorFromAtoB(rNodePairs[i].first->rGetLocation(),
+                                                                                              rNodePairs[i].second->rGetLocation());
+        double distance_between_nodes = norm_2(difference);
+        assert(distance_between_nodes > 0);
+        assert(!std::isnan(distance_between_nodes));
+        for (unsigned j=0; j<SPACE_DIM; j++)
+        {
+            displacements[SPACE_DIM*i + j] = difference[j];
+        }
+        distances[i] = distance_between_nodes;
+
+        if (this->mUseCutOffLength && distance_between_nodes >= this->GetCutOffLength())
+        {
+            is_cut_off[i] = 1;
+            continue;
+        }
+
+        double rest_length_final = radii[index_a] + radii[index_b];
+        double rest_length = rest_length_final;
+
+        double ageA = ages[index_a];
+        double ageB = ages[index_b];
+        if (ageA < mMeinekeSpringGrowthDuration && ageB < mMeinekeSpringGrowthDuration)
+        {
+            CellPtr p_cell_A = rCellPopulation.GetCellUsingLocationIndex(index_a);
+            CellPtr p_cell_B = rCellPopulation.GetCellUsingLocationIndex(index_b);
+            std::pair<CellPtr,CellPtr> cell_pair = p_static_cast_cell_population->CreateCellPair(p_cell_A, p_cell_B);
+
+            if (p_static_cast_cell_population->IsMarkedSpring(cell_pair))
+            {
+                double lambda = mMeinekeDivisionRestingSpringLength;
+                rest_length = lambda + (rest_length_final - lambda) * ageA/mMeinekeSpringGrowthDuration;
+            }
+            if (ageA + time_step >= mMeinekeSpringGrowthDuration)
+            {
+                p_static_cast_cell_population->UnmarkSpring(cell_pair);
+            }
+        }
+
+        // Share the rest length between the cells in proportion to their radii, shrinking apoptotic cells
+        double a_rest_length = (radii[index_a]/(radii[index_a]+radii[index_b]))*rest_length;
+        double b_rest_length = (radii[index_b]/(radii[index_a]+radii[index_b]))*rest_length;
+        a_rest_length = a_rest_length * times_until_death[index_a] / apoptosis_times[index_a];
+        b_rest_length = b_rest_length * times_until_death[index_b] / apoptosis_times[index_b];
+
+        rest_lengths[i] = a_rest_length + b_rest_length;
+        rest_lengths_final[i] = rest_length_final;
+    }
+
+    // Compute the forces; this loop only touches contiguous arrays of doubles
+    const double spring_stiffness = 1.0*mMeinekeSpringStiffness;
+    const double alpha = 5.0;
+    for (unsigned i=0; i<num_pairs; i++)
+    {
+        double magnitude = 0.0;
+        double scale = 0.0;
+        if (!is_cut_off[i])
+        {
+            double overlap = distances[i] - rest_lengths[i];
+            if (overlap <= 0)
+            {
+                // log(x+1) is undefined for x<=-1
+                assert(overlap > -rest_lengths_final[i]);
+                scale = rest_lengths_final[i];
+                magnitude = log(1.0 + overlap/rest_lengths_final[i]);
+            }
+            else
+            {
+                scale = overlap;
+                magnitude = exp(-alpha * overlap/rest_lengths_final[i]);
+            }
+        }
+        for (unsigned j=0; j<SPACE_DIM; j++)
+        {
+            double unit_difference = displacements[SPACE_DIM*i + j]/distances[i];
+            rForces[i][j] = is_cut_off[i] ? 0.0 : ((spring_stiffness*unit_difference)*scale)*magnitude;
+        }
+    }
+
+    return true;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool GeneralisedLinearSpringForce<ELEMENT_DIM,SPACE_DIM>::AddForceContributionOnBackend(AbstractCellPopulation<ELEMENT_DIM,SPACE_DIM>& rCellPopulation,
+                                                                                       NodeBasedMechanicsBackend<SPACE_DIM>& rBackend)
+{
+    NodeBasedCellPopulation<SPACE_DIM>* p_population = dynamic_cast<NodeBasedCellPopulation<SPACE_DIM>*>(&rCellPopulation);
+    if (typeid(*this) != typeid(GeneralisedLinearSpringForce<ELEMENT_DIM,SPACE_DIM>)
+        || p_population == nullptr
+        || dynamic_cast<PeriodicNodesOnlyMesh<SPACE_DIM>*>(&(p_population->rGetMesh())) != nullptr
+        || p_population->GetNumMarkedSprings() > 0)
+    {
+        return false;
+    }
+
+    // Each cell's share of a rest length is its radius, shrinking linearly during apoptosis
+    const std::vector<unsigned>& r_node_indices = rBackend.rGetNodeIndices();
+    std::vector<double> radii(r_node_indices.size());
+    std::vector<double> rest_length_factors(r_node_indices.size(), 1.0);
+    for (unsigned i=0; i<r_node_indices.size(); i++)
+    {
+        radii[i] = p_population->GetNode(r_node_indices[i])->GetRadius();
+        assert(radii[i] > 0);
+
+        CellPtr p_cell = p_population->GetCellUsingLocationIndex(r_node_indices[i]);
+        if (p_cell->HasApoptosisBegun())
+        {
+            rest_length_factors[i] = p_cell->GetTimeUntilDeath()/p_cell->GetApoptosisTime();
+        }
+    }
+
+    double spring_cut_off = this->mUseCutOffLength ? this->GetCutOffLength() : DBL_MAX;
+    rBackend.AddSpringForces(radii, rest_length_factors, mMeinekeSpringStiffness, spring_cut_off);
+
+    return true;
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 double GeneralisedLinearSpringForce<ELEMENT_DIM,SPACE_DIM>::GetMeinekeSpringStiffness()
 {
@@ -158,6 +158,48 @@ public:
     c_vector<double, SPACE_DIM> CalculateForceBetweenNodes(unsigned nodeAGlobalIndex,
                                                      unsigned nodeBGlobalIndex,
                                                      AbstractCellPopulation<ELEMENT_DIM,SPACE_DIM>& rCellPopulation);
+
+    /**
+     * Overridden CalculateForcesForNodePairs() method.
+     *
+     * For a NodeBasedCellPopulation, the radius, age and apoptosis state of each
+     * cell are looked up once, the separation and rest length of each pair are
+     * gathered into contiguous arrays, and the forces are then computed in a
+     * single loop. The result is the same as calling CalculateForceBetweenNodes()
+     * for each pair.
+     *
+     * The batched kernel is only used by this class itself, since subclasses may
+     * override VariableSpringConstantMultiplicationFactor() or
+     * CalculateForceBetweenNodes(); they fall back on the per-pair method unless
+     * they override this method too.
+     *
+     * @param rNodePairs the node pairs of the population
+     * @param rCellPopulation the cell population
+     * @param rForces filled in with the force exerted on the first node of each pair by the second
+     *
+     * @return whether the forces were calculated.
+     */
+    virtual bool CalculateForcesForNodePairs(std::vector<std::pair<Node<SPACE_DIM>*, Node<SPACE_DIM>*> >& rNodePairs,
+                                             AbstractCellPopulation<ELEMENT_DIM,SPACE_DIM>& rCellPopulation,
+                                             std::vector<c_vector<double, SPACE_DIM> >& rForces);
+
+    /**
+     * Overridden AddForceContributionOnBackend() method.
+     *
+     * For a NodeBasedCellPopulation on a non-periodic mesh, the radius and apoptotic
+     * shrinkage of each cell are gathered once and the spring forces between the
+     * pairs found by the backend are computed there. As for the batched kernel, this
+     * is only done for this class itself. Populations with marked springs use the
+     * host instead.
+     *
+     * @param rCellPopulation the cell population
+     * @param rBackend the backend holding the node locations and forces
+     *
+     * @return whether the forces were added on the backend.
+     */
+    virtual bool AddForceContributionOnBackend(AbstractCellPopulation<ELEMENT_DIM,SPACE_DIM>& rCellPopulation,
+                                               NodeBasedMechanicsBackend<SPACE_DIM>& rBackend);
+
     /**
      * @return mMeinekeSpringStiffness
      */
@@ -67,17 +67,18 @@ void NagaiHondaForce<DIM>::AddForceContribution(AbstractCellPopulation<DIM>& rCe
     unsigned num_nodes = p_cell_population->GetNumNodes();
     unsigned num_elements = p_cell_population->GetNumElements();
 
-    // Begin by computing the area and perimeter of each element in the mesh, to avoid having to do this multiple times
+    // Begin by looking up the area and perimeter of each element in the mesh, to avoid having to compute these multiple times
+    MutableVertexMesh<DIM, DIM>& r_mesh = p_cell_population->rGetMesh();
     std::vector<double> element_areas(num_elements);
     std::vector<double> element_perimeters(num_elements);
     std::vector<double> target_areas(num_elements);
-    for (typename VertexMesh<DIM,DIM>::VertexElementIterator elem_iter = p_cell_population->rGetMesh().GetElementIteratorBegin();
-         elem_iter != p_cell_population->rGetMesh().GetElementIteratorEnd();
+    for (typename VertexMesh<DIM,DIM>::VertexElementIterator elem_iter = r_mesh.GetElementIteratorBegin();
+         elem_iter != r_mesh.GetElementIteratorEnd();
          ++elem_iter)
     {
         unsigned elem_index = elem_iter->GetIndex();
-        element_areas[elem_index] = p_cell_population->rGetMesh().GetVolumeOfElement(elem_index);
-        element_perimeters[elem_index] = p_cell_population->rGetMesh().GetSurfaceAreaOfElement(elem_index);
+        element_areas[elem_index] = r_mesh.GetCachedVolumeOfElement(elem_index);
+        element_perimeters[elem_index] = r_mesh.GetCachedSurfaceAreaOfElement(elem_index);
         try
         {
             // If we haven't specified a growth modifier, there won't be any target areas in the CellData array and CellData
@@ -92,6 +93,11 @@ void NagaiHondaForce<DIM>::AddForceContribution(AbstractCellPopulation<DIM>& rCe
         }
     }
 
+    // Use the mesh's compact node-element connectivity, which also gives the local index of each node in each element
+    const std::vector<unsigned>& r_node_element_offsets = r_mesh.rGetNodeElementOffsets();
+    const std::vector<unsigned>& r_node_element_indices = r_mesh.rGetNodeElementIndices();
+    const std::vector<unsigned>& r_node_element_local_indices = r_mesh.rGetNodeElementLocalIndices();
+
     // Iterate over vertices in the cell population
     for (unsigned node_index=0; node_index<num_nodes; node_index++)
     {
@@ -113,24 +119,21 @@ void NagaiHondaForce<DIM>::AddForceContribution(AbstractCellPopulation<DIM>& rCe
         c_vector<double, DIM> membrane_surface_tension_contribution = zero_vector<double>(DIM);
         c_vector<double, DIM> adhesion_contribution = zero_vector<double>(DIM);
 
-        // Find the indices of the elements owned by this node
-        std::set<unsigned> containing_elem_indices = p_cell_population->GetNode(node_index)->rGetContainingElementIndices();
-
-        // Iterate over these elements
-        for (std::set<unsigned>::iterator iter = containing_elem_indices.begin();
-             iter != containing_elem_indices.end();
-             ++iter)
+        // Iterate over the elements owned by this node
+        for (unsigned entry = r_node_element_offsets[node_index];
+             entry < r_node_element_offsets[node_index + 1];
+             ++entry)
         {
             // Get this element, its index and its number of nodes
-            VertexElement<DIM, DIM>* p_element = p_cell_population->GetElement(*iter);
-            unsigned elem_index = p_element->GetIndex();
+            unsigned elem_index = r_node_element_indices[entry];
+            VertexElement<DIM, DIM>* p_element = p_cell_population->GetElement(elem_index);
             unsigned num_nodes_elem = p_element->GetNumNodes();
 
             // Find the local index of this node in this element
-            unsigned local_index = p_element->GetNodeLocalIndex(node_index);
+            unsigned local_index = r_node_element_local_indices[entry];
 
             // Add the force contribution from this cell's deformation energy (note the minus sign)
-            c_vector<double, DIM> element_area_gradient = p_cell_population->rGetMesh().GetAreaGradientOfElementAtNode(p_element, local_index);
+            c_vector<double, DIM> element_area_gradient = r_mesh.GetAreaGradientOfElementAtNode(p_element, local_index);
             deformation_contribution -= 2*GetNagaiHondaDeformationEnergyParameter()*(element_areas[elem_index] - target_areas[elem_index])*element_area_gradient;
 
             // Get the previous and next nodes in this element
@@ -145,8 +148,8 @@ void NagaiHondaForce<DIM>::AddForceContribution(AbstractCellPopulation<DIM>& rCe
             double next_edge_adhesion_parameter = GetAdhesionParameter(p_this_node, p_next_node, *p_cell_population);
 
             // Compute the gradient of each these edges, computed at the present node
-            c_vector<double, DIM> previous_edge_gradient = -p_cell_population->rGetMesh().GetNextEdgeGradientOfElementAtNode(p_element, previous_node_local_index);
-            c_vector<double, DIM> next_edge_gradient = p_cell_population->rGetMesh().GetNextEdgeGradientOfElementAtNode(p_element, local_index);
+            c_vector<double, DIM> previous_edge_gradient = -r_mesh.GetNextEdgeGradientOfElementAtNode(p_element, previous_node_local_index);
+            c_vector<double, DIM> next_edge_gradient = r_mesh.GetNextEdgeGradientOfElementAtNode(p_element, local_index);
 
             // Add the force contribution from cell-cell and cell-boundary adhesion (note the minus sign)
             adhesion_contribution -= previous_edge_adhesion_parameter*previous_edge_gradient + next_edge_adhesion_parameter*next_edge_gradient;
@@ -162,6 +165,105 @@ void NagaiHondaForce<DIM>::AddForceContribution(AbstractCellPopulation<DIM>& rCe
     }
 }
 
+template <unsigned DIM>
+bool NagaiHondaForce<DIM>::AddForceJacobianContribution(AbstractCellPopulation<DIM>& rCellPopulation,
+                                                  std::vector<std::map<unsigned, c_matrix<double, DIM, DIM> > >& rJacobian)
+{
+    // The area and perimeter gradients used by this force are only defined in 2D
+    if (DIM != 2)
+    {
+        return false;
+    }
+
+    // Throw an exception message if not using a VertexBasedCellPopulation
+    if (dynamic_cast<VertexBasedCellPopulation<DIM>*>(&rCellPopulation) == nullptr)
+    {
+        EXCEPTION("NagaiHondaForce is to be used with a VertexBasedCellPopulation only");
+    }
+
+    VertexBasedCellPopulation<DIM>* p_cell_population = static_cast<VertexBasedCellPopulation<DIM>*>(&rCellPopulation);
+    MutableVertexMesh<DIM, DIM>& r_mesh = p_cell_population->rGetMesh();
+
+    /*
+     * The area of an element is quadratic in its node locations, so its Hessian is constant:
+     * the second derivative with respect to a node and the next node is this rotation, and
+     * with respect to a node and the previous node it is the transpose.
+     */
+    c_matrix<double, DIM, DIM> area_hessian_with_next_node = zero_matrix<double>(DIM, DIM);
+    area_hessian_with_next_node(0,1) = 0.5;
+    area_hessian_with_next_node(1,0) = -0.5;
+
+    for (typename VertexMesh<DIM,DIM>::VertexElementIterator elem_iter = r_mesh.GetElementIteratorBegin();
+         elem_iter != r_mesh.GetElementIteratorEnd();
+         ++elem_iter)
+    {
+        unsigned elem_index = elem_iter->GetIndex();
+        VertexElement<DIM, DIM>* p_element = &(*elem_iter);
+        unsigned num_nodes_elem = p_element->GetNumNodes();
+
+        double element_area = r_mesh.GetCachedVolumeOfElement(elem_index);
+        double element_perimeter = r_mesh.GetCachedSurfaceAreaOfElement(elem_index);
+        double target_area = 0.0;
+        try
+        {
+            target_area = p_cell_population->GetCellUsingLocationIndex(elem_index)->GetCellData()->GetItem("target area");
+        }
+        catch (Exception&)
+        {
+            EXCEPTION("You need to add an AbstractTargetAreaModifier to the simulation in order to use NagaiHondaForce");
+        }
+
+        // The element's free energy depends on its area and perimeter through these coefficients (see AddForceContribution())
+        double area_coefficient = 2*GetNagaiHondaDeformationEnergyParameter();
+        double perimeter_coefficient = 2*GetNagaiHondaMembraneSurfaceEnergyParameter();
+        double area_term = area_coefficient*(element_area - target_area);
+        double perimeter_term = perimeter_coefficient*(element_perimeter - 2*sqrt(M_PI*target_area));
+
+        std::vector<unsigned> global_indices(num_nodes_elem);
+        std::vector<c_vector<double, DIM> > area_gradients(num_nodes_elem);
+        std::vector<c_vector<double, DIM> > perimeter_gradients(num_nodes_elem);
+        for (unsigned local_index=0; local_index<num_nodes_elem; local_index++)
+        {
+            global_indices[local_index] = p_element->GetNodeGlobalIndex(local_index);
+            area_gradients[local_index] = r_mesh.GetAreaGradientOfElementAtNode(p_element, local_index);
+            perimeter_gradients[local_index] = r_mesh.GetPerimeterGradientOfElementAtNode(p_element, local_index);
+        }
+
+        // Products of first derivatives couple every pair of nodes in the element (note the minus signs)
+        for (unsigned a=0; a<num_nodes_elem; a++)
+        {
+            for (unsigned b=0; b<num_nodes_elem; b++)
+            {
+                this->rGetJacobianBlock(rJacobian, global_indices[a], global_indices[b]) -=
+                        area_coefficient*outer_prod(area_gradients[a], area_gradients[b])
+                        + perimeter_coefficient*outer_prod(perimeter_gradients[a], perimeter_gradients[b]);
+            }
+        }
+
+        // Second derivatives of the area and of each edge length only couple neighbouring nodes
+        for (unsigned local_index=0; local_index<num_nodes_elem; local_index++)
+        {
+            unsigned next_local_index = (local_index+1)%num_nodes_elem;
+            unsigned this_global_index = global_indices[local_index];
+            unsigned next_global_index = global_indices[next_local_index];
+
+            this->rGetJacobianBlock(rJacobian, this_global_index, next_global_index) -= area_term*area_hessian_with_next_node;
+            this->rGetJacobianBlock(rJacobian, next_global_index, this_global_index) -= area_term*trans(area_hessian_with_next_node);
+
+            // The edge length enters through the perimeter and the adhesion energy
+            double edge_coefficient = perimeter_term + GetAdhesionParameter(p_element->GetNode(local_index), p_element->GetNode(next_local_index), *p_cell_population);
+            c_matrix<double, DIM, DIM> edge_hessian = edge_coefficient*r_mesh.GetNextEdgeHessianOfElementAtNode(p_element, local_index);
+
+            this->rGetJacobianBlock(rJacobian, this_global_index, this_global_index) -= edge_hessian;
+            this->rGetJacobianBlock(rJacobian, next_global_index, next_global_index) -= edge_hessian;
+            this->rGetJacobianBlock(rJacobian, this_global_index, next_global_index) += edge_hessian;
+            this->rGetJacobianBlock(rJacobian, next_global_index, this_global_index) += edge_hessian;
+        }
+    }
+
+    return true;
+}
+
 template <unsigned DIM>
 double NagaiHondaForce<DIM>::GetAdhesionParameter(Node<DIM>* pNodeA, Node<DIM>* pNodeB, VertexBasedCellPopulation<DIM>& rVertexCellPopulation)
 {
@@ -52,6 +52,19 @@ const AbstractCellPopulation<SPACE_DIM>* AbstractCellKiller<SPACE_DIM>::GetCellP
     return mpCellPopulation;
 }
 
+template <unsigned SPACE_DIM>
+bool AbstractCellKiller<SPACE_DIM>::CanCheckSingleCells() const
+{
+    return false;
+}
+
+template <unsigned SPACE_DIM>
+void AbstractCellKiller<SPACE_DIM>::CheckAndLabelSingleCellForApoptosisOrDeath(CellPtr pCell)
+{
+    // This method should only be called if CanCheckSingleCells() is overridden to return true
+    NEVER_REACHED;
+}
+
 template <unsigned DIM>
 void AbstractCellKiller<DIM>::OutputCellKillerInfo(out_stream& rParamsFile)
 {
@@ -93,6 +93,22 @@ public:
      */
     virtual void CheckAndLabelCellsForApoptosisOrDeath()=0;
 
+    /**
+     * @return whether this killer decides the fate of each cell independently of
+     * the other cells, through CheckAndLabelSingleCellForApoptosisOrDeath(). If
+     * so, the simulation may evaluate it together with other such killers in a
+     * single traversal of the cell population. Defaults to false.
+     */
+    virtual bool CanCheckSingleCells() const;
+
+    /**
+     * Call StartApoptosis() or Kill() on the given cell if it should die. Only
+     * called if CanCheckSingleCells() returns true, and only on live cells.
+     *
+     * @param pCell the cell
+     */
+    virtual void CheckAndLabelSingleCellForApoptosisOrDeath(CellPtr pCell);
+
     /**
      * Get a pointer to the cell population.
      *
@@ -62,6 +62,18 @@ void ApoptoticCellKiller<SPACE_DIM>::CheckAndLabelCellsForApoptosisOrDeath()
     }
 }
 
+template <unsigned SPACE_DIM>
+bool ApoptoticCellKiller<SPACE_DIM>::CanCheckSingleCells() const
+{
+    return true;
+}
+
+template <unsigned SPACE_DIM>
+void ApoptoticCellKiller<SPACE_DIM>::CheckAndLabelSingleCellForApoptosisOrDeath(CellPtr pCell)
+{
+    CheckAndLabelSingleCellForApoptosis(pCell);
+}
+
 template <unsigned DIM>
 void ApoptoticCellKiller<DIM>::OutputCellKillerParameters(out_stream& rParamsFile)
 {
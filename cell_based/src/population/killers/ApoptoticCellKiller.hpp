@@ -84,6 +84,21 @@ public:
      */
     virtual void CheckAndLabelCellsForApoptosisOrDeath();
 
+    /**
+     * Overridden CanCheckSingleCells() method.
+     *
+     * @return true
+     */
+    virtual bool CanCheckSingleCells() const;
+
+    /**
+     * Overridden CheckAndLabelSingleCellForApoptosisOrDeath() method, which
+     * calls CheckAndLabelSingleCellForApoptosis().
+     *
+     * @param pCell the cell
+     */
+    virtual void CheckAndLabelSingleCellForApoptosisOrDeath(CellPtr pCell);
+
     /**
      * Overridden OutputCellKillerParameters() method.
      *
@@ -65,12 +65,24 @@ void PlaneBasedCellKiller<DIM>::CheckAndLabelCellsForApoptosisOrDeath()
          cell_iter != this->mpCellPopulation->End();
          ++cell_iter)
     {
-        c_vector<double, DIM> cell_location = this->mpCellPopulation->GetLocationOfCellCentre(*cell_iter);
+        CheckAndLabelSingleCellForApoptosisOrDeath(*cell_iter);
+    }
+}
+
+template <unsigned DIM>
+bool PlaneBasedCellKiller<DIM>::CanCheckSingleCells() const
+{
+    return true;
+}
 
-        if (inner_prod(cell_location - mPointOnPlane, mNormalToPlane) > 0.0)
-        {
-            cell_iter->Kill();
-        }
+template <unsigned DIM>
+void PlaneBasedCellKiller<DIM>::CheckAndLabelSingleCellForApoptosisOrDeath(CellPtr pCell)
+{
+    c_vector<double, DIM> cell_location = this->mpCellPopulation->GetLocationOfCellCentre(pCell);
+
+    if (inner_prod(cell_location - mPointOnPlane, mNormalToPlane) > 0.0)
+    {
+        pCell->Kill();
     }
 }
 
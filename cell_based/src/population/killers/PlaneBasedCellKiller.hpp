@@ -104,6 +104,20 @@ public:
      */
     virtual void CheckAndLabelCellsForApoptosisOrDeath();
 
+    /**
+     * Overridden CanCheckSingleCells() method.
+     *
+     * @return true
+     */
+    virtual bool CanCheckSingleCells() const;
+
+    /**
+     * Kills the given cell if it is outside the boundary.
+     *
+     * @param pCell the cell
+     */
+    virtual void CheckAndLabelSingleCellForApoptosisOrDeath(CellPtr pCell);
+
     /**
      * Overridden OutputCellKillerParameters() method.
      *
@@ -88,6 +88,18 @@ void RandomCellKiller<DIM>::CheckAndLabelCellsForApoptosisOrDeath()
     }
 }
 
+template <unsigned DIM>
+bool RandomCellKiller<DIM>::CanCheckSingleCells() const
+{
+    return true;
+}
+
+template <unsigned DIM>
+void RandomCellKiller<DIM>::CheckAndLabelSingleCellForApoptosisOrDeath(CellPtr pCell)
+{
+    CheckAndLabelSingleCellForApoptosis(pCell);
+}
+
 template <unsigned DIM>
 void RandomCellKiller<DIM>::OutputCellKillerParameters(out_stream& rParamsFile)
 {
@@ -116,6 +116,21 @@ public:
      */
     void CheckAndLabelCellsForApoptosisOrDeath();
 
+    /**
+     * Overridden CanCheckSingleCells() method.
+     *
+     * @return true
+     */
+    virtual bool CanCheckSingleCells() const;
+
+    /**
+     * Overridden CheckAndLabelSingleCellForApoptosisOrDeath() method, which
+     * calls CheckAndLabelSingleCellForApoptosis().
+     *
+     * @param pCell the cell
+     */
+    virtual void CheckAndLabelSingleCellForApoptosisOrDeath(CellPtr pCell);
+
     /**
      * Overridden OutputCellKillerParameters() method.
      *
@@ -55,8 +55,8 @@ double DiffusionCaUpdateRule<DIM>::EvaluateProbability(unsigned currentNodeIndex
                                                                double deltaX,
                                                                CellPtr cell)
 {
-   c_vector<double, DIM> node_index_location = rCellPopulation.GetNode(currentNodeIndex)->rGetLocation();
-   c_vector<double, DIM> node_neighbour_location = rCellPopulation.GetNode(targetNodeIndex)->rGetLocation();
+   const c_vector<double, DIM>& node_index_location = rCellPopulation.GetNode(currentNodeIndex)->rGetLocation();
+   const c_vector<double, DIM>& node_neighbour_location = rCellPopulation.GetNode(targetNodeIndex)->rGetLocation();
 
    return (mDiffusionParameter*dt/(2* pow(norm_2(rCellPopulation.rGetMesh().GetVectorFromAtoB(node_index_location, node_neighbour_location)), 2)));
 }
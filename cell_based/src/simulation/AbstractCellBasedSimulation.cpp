@@ -40,9 +40,12 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "AbstractCellBasedSimulation.hpp"
 #include "CellBasedEventHandler.hpp"
+#include "MemoryAccounting.hpp"
 #include "LogFile.hpp"
 #include "ExecutableSupport.hpp"
 #include "AbstractPdeModifier.hpp"
+#include "ApoptoticCellProperty.hpp"
+#include "CellId.hpp"
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 AbstractCellBasedSimulation<ELEMENT_DIM,SPACE_DIM>::AbstractCellBasedSimulation(AbstractCellPopulation<ELEMENT_DIM,SPACE_DIM>& rCellPopulation,
@@ -61,7 +64,9 @@ AbstractCellBasedSimulation<ELEMENT_DIM,SPACE_DIM>::AbstractCellBasedSimulation(
       mNumDeaths(0),
       mOutputDivisionLocations(false),
       mOutputCellVelocities(false),
-      mSamplingTimestepMultiple(1)
+      mSamplingTimestepMultiple(1),
+      mBatchSrnModels(false),
+      mUseCellCycleEventQueue(false)
 {
     // Set a random seed of 0 if it wasn't specified earlier
     RandomNumberGenerator::Instance();
@@ -95,68 +100,153 @@ unsigned AbstractCellBasedSimulation<ELEMENT_DIM,SPACE_DIM>::DoCellBirth()
         return 0;
     }
 
+    // Decide which cells to check, which is all of them unless we are using the event queue
+    std::list<CellPtr> cells_to_check;
+    if (mUseCellCycleEventQueue)
+    {
+        UpdateCellCycleEventQueue();
+        std::vector<CellPtr> due_cells = mCellCycleEventQueue.GetCellsToCheck(SimulationTime::Instance()->GetTime());
+        cells_to_check.assign(due_cells.begin(), due_cells.end());
+    }
+    else
+    {
+        for (typename AbstractCellPopulation<ELEMENT_DIM,SPACE_DIM>::Iterator cell_iter = mrCellPopulation.Begin();
+             cell_iter != mrCellPopulation.End();
+             ++cell_iter)
+        {
+            cells_to_check.push_back(*cell_iter);
+        }
+    }
+
+    if (mBatchSrnModels)
+    {
+        // Advance the SRN models of exactly those cells whose ReadyToDivide() method would do so below
+        std::list<CellPtr> cells_to_simulate;
+        for (std::list<CellPtr>::iterator cell_iter = cells_to_check.begin();
+             cell_iter != cells_to_check.end();
+             ++cell_iter)
+        {
+            if ((*cell_iter)->GetAge() > 0.0 && !(*cell_iter)->HasApoptosisBegun()
+                && !(*cell_iter)->HasCellProperty<ApoptoticCellProperty>())
+            {
+                cells_to_simulate.push_back(*cell_iter);
+            }
+        }
+        mSrnModelBatchSimulator.SimulateToCurrentTime(cells_to_simulate);
+    }
+
     unsigned num_births_this_step = 0;
 
-    // Iterate over all cells, seeing if each one can be divided
-    for (typename AbstractCellPopulation<ELEMENT_DIM,SPACE_DIM>::Iterator cell_iter = mrCellPopulation.Begin();
-         cell_iter != mrCellPopulation.End();
+    // Iterate over the cells, seeing if each one can be divided
+    for (std::list<CellPtr>::iterator cell_iter = cells_to_check.begin();
+         cell_iter != cells_to_check.end();
          ++cell_iter)
     {
-        // Check if this cell is ready to divide
-        double cell_age = cell_iter->GetAge();
-        if (cell_age > 0.0)
+        CellPtr p_new_cell = DivideCellIfReady(*cell_iter);
+        if (p_new_cell)
         {
-            if (cell_iter->ReadyToDivide())
+            num_births_this_step++;
+        }
+
+        if (mUseCellCycleEventQueue)
+        {
+            mCellCycleEventQueue.AddCell(*cell_iter);
+            if (p_new_cell)
             {
-                // Check if there is room into which the cell may divide
-                if (mrCellPopulation.IsRoomToDivide(*cell_iter))
+                mCellCycleEventQueue.AddCell(p_new_cell);
+            }
+        }
+    }
+
+    if (mUseCellCycleEventQueue && !mrCellPopulation.rGetCells().empty())
+    {
+        // Any daughter cells created above have already been added to the queue
+        mCellCycleEventQueue.SetMaxCellId(mrCellPopulation.rGetCells().front()->rGetCellPropertyCollection().GetPropertyType<CellId>()->GetMaxCellId());
+    }
+    return num_births_this_step;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+CellPtr AbstractCellBasedSimulation<ELEMENT_DIM,SPACE_DIM>::DivideCellIfReady(CellPtr pCell)
+{
+    CellPtr p_new_cell;
+
+    // Check if this cell is ready to divide
+    double cell_age = pCell->GetAge();
+    if (cell_age > 0.0)
+    {
+        if (pCell->ReadyToDivide())
+        {
+            SynchroniseCellLocations();
+
+            // Check if there is room into which the cell may divide
+            if (mrCellPopulation.IsRoomToDivide(pCell))
+            {
+                // Store parent ID for output if required
+                unsigned parent_cell_id = pCell->GetCellId();
+
+                // Create a new cell
+                p_new_cell = pCell->Divide();
+
+                /**
+                 * If required, output this location to file
+                 *
+                 * \todo (#2578)
+                 *
+                 * For consistency with the rest of the output code, consider removing the
+                 * AbstractCellBasedSimulation member mOutputDivisionLocations, adding a new
+                 * member mAgesAndLocationsOfDividingCells to AbstractCellPopulation, adding
+                 * a new class CellDivisionLocationsWriter to the CellPopulationWriter hierarchy
+                 * to output the content of mAgesAndLocationsOfDividingCells to file (remembering
+                 * to clear mAgesAndLocationsOfDividingCells at each timestep), and replacing the
+                 * following conditional statement with something like
+                 *
+                 * if (mrCellPopulation.HasWriter<CellDivisionLocationsWriter>())
+                 * {
+                 *     mCellDivisionLocations.push_back(new_location);
+                 * }
+                 */
+                if (mOutputDivisionLocations)
                 {
-                    // Store parent ID for output if required
-                    unsigned parent_cell_id = cell_iter->GetCellId();
-
-                    // Create a new cell
-                    CellPtr p_new_cell = cell_iter->Divide();
-
-                    /**
-                     * If required, output this location to file
-                     *
-                     * \todo (#2578)
-                     *
-                     * For consistency with the rest of the output code, consider removing the
-                     * AbstractCellBasedSimulation member mOutputDivisionLocations, adding a new
-                     * member mAgesAndLocationsOfDividingCells to AbstractCellPopulation, adding
-                     * a new class CellDivisionLocationsWriter to the CellPopulationWriter hierarchy
-                     * to output the content of mAgesAndLocationsOfDividingCells to file (remembering
-                     * to clear mAgesAndLocationsOfDividingCells at each timestep), and replacing the
-                     * following conditional statement with something like
-                     *
-                     * if (mrCellPopulation.HasWriter<CellDivisionLocationsWriter>())
-                     * {
-                     *     mCellDivisionLocations.push_back(new_location);
-                     * }
-                     */
-                    if (mOutputDivisionLocations)
+                    c_vector<double, SPACE_DIM> cell_location = mrCellPopulation.GetLocationOfCellCentre(pCell);
+
+                    *mpDivisionLocationFile << SimulationTime::Instance()->GetTime() << "\t";
+                    for (unsigned i=0; i<SPACE_DIM; i++)
                     {
-                        c_vector<double, SPACE_DIM> cell_location = mrCellPopulation.GetLocationOfCellCentre(*cell_iter);
-
-                        *mpDivisionLocationFile << SimulationTime::Instance()->GetTime() << "\t";
-                        for (unsigned i=0; i<SPACE_DIM; i++)
-                        {
-                            *mpDivisionLocationFile << cell_location[i] << "\t";
-                        }
-                        *mpDivisionLocationFile << "\t" << cell_age << "\t" << parent_cell_id << "\t" << cell_iter->GetCellId() << "\t" << p_new_cell->GetCellId() << "\n";
+                        *mpDivisionLocationFile << cell_location[i] << "\t";
                     }
-
-                    // Add the new cell to the cell population
-                    mrCellPopulation.AddCell(p_new_cell, *cell_iter);
-
-                    // Update counter
-                    num_births_this_step++;
+                    *mpDivisionLocationFile << "\t" << cell_age << "\t" << parent_cell_id << "\t" << pCell->GetCellId() << "\t" << p_new_cell->GetCellId() << "\n";
                 }
+
+                // Add the new cell to the cell population
+                mrCellPopulation.AddCell(p_new_cell, pCell);
             }
         }
     }
-    return num_births_this_step;
+    return p_new_cell;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractCellBasedSimulation<ELEMENT_DIM,SPACE_DIM>::UpdateCellCycleEventQueue()
+{
+    if (mrCellPopulation.rGetCells().empty())
+    {
+        mCellCycleEventQueue.Clear();
+        return;
+    }
+
+    unsigned max_cell_id = mrCellPopulation.rGetCells().front()->rGetCellPropertyCollection().GetPropertyType<CellId>()->GetMaxCellId();
+    if (max_cell_id != mCellCycleEventQueue.GetMaxCellId())
+    {
+        mCellCycleEventQueue.Clear();
+        for (typename AbstractCellPopulation<ELEMENT_DIM,SPACE_DIM>::Iterator cell_iter = mrCellPopulation.Begin();
+             cell_iter != mrCellPopulation.End();
+             ++cell_iter)
+        {
+            mCellCycleEventQueue.AddCell(*cell_iter);
+        }
+        mCellCycleEventQueue.SetMaxCellId(max_cell_id);
+    }
 }
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
@@ -164,15 +254,59 @@ unsigned AbstractCellBasedSimulation<ELEMENT_DIM,SPACE_DIM>::DoCellRemoval()
 {
     unsigned num_deaths_this_step = 0;
 
+    // Cell killers may read the cell locations
+    if (!mCellKillers.empty())
+    {
+        SynchroniseCellLocations();
+    }
+
     /*
      * This labels cells as dead or apoptosing. It does not actually remove the cells,
      * mrCellPopulation.RemoveDeadCells() needs to be called for this.
+     *
+     * Each run of consecutive killers that can check cells one at a time is evaluated
+     * in a single traversal of the cell population. As each killer would otherwise
+     * skip any cell already killed by an earlier killer, we stop checking a cell as
+     * soon as it is dead.
      */
-    for (typename std::vector<boost::shared_ptr<AbstractCellKiller<SPACE_DIM> > >::iterator killer_iter = mCellKillers.begin();
-         killer_iter != mCellKillers.end();
-         ++killer_iter)
+    unsigned killer_index = 0;
+    while (killer_index < mCellKillers.size())
+    {
+        if (!mCellKillers[killer_index]->CanCheckSingleCells())
+        {
+            mCellKillers[killer_index]->CheckAndLabelCellsForApoptosisOrDeath();
+            killer_index++;
+            continue;
+        }
+
+        unsigned end_index = killer_index + 1;
+        while (end_index < mCellKillers.size() && mCellKillers[end_index]->CanCheckSingleCells())
+        {
+            end_index++;
+        }
+
+        for (typename AbstractCellPopulation<ELEMENT_DIM,SPACE_DIM>::Iterator cell_iter = mrCellPopulation.Begin();
+             cell_iter != mrCellPopulation.End();
+             ++cell_iter)
+        {
+            for (unsigned i=killer_index; i<end_index && !cell_iter->IsDead(); i++)
+            {
+                mCellKillers[i]->CheckAndLabelSingleCellForApoptosisOrDeath(*cell_iter);
+            }
+        }
+        killer_index = end_index;
+    }
+
+    // Removing cells may re-index the remaining nodes, so their locations must be current
+    for (std::list<CellPtr>::iterator cell_iter = mrCellPopulation.rGetCells().begin();
+         cell_iter != mrCellPopulation.rGetCells().end();
+         ++cell_iter)
     {
-        (*killer_iter)->CheckAndLabelCellsForApoptosisOrDeath();
+        if ((*cell_iter)->IsDead())
+        {
+            SynchroniseCellLocations();
+            break;
+        }
     }
 
     num_deaths_this_step += mrCellPopulation.RemoveDeadCells();
@@ -262,6 +396,37 @@ void AbstractCellBasedSimulation<ELEMENT_DIM,SPACE_DIM>::SetNoBirth(bool noBirth
     mNoBirth = noBirth;
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractCellBasedSimulation<ELEMENT_DIM,SPACE_DIM>::SetBatchSrnModels(bool batchSrnModels)
+{
+    mBatchSrnModels = batchSrnModels;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool AbstractCellBasedSimulation<ELEMENT_DIM,SPACE_DIM>::GetBatchSrnModels() const
+{
+    return mBatchSrnModels;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractCellBasedSimulation<ELEMENT_DIM,SPACE_DIM>::SetUseCellCycleEventQueue(bool useCellCycleEventQueue)
+{
+    mUseCellCycleEventQueue = useCellCycleEventQueue;
+    mCellCycleEventQueue.Clear();
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool AbstractCellBasedSimulation<ELEMENT_DIM,SPACE_DIM>::GetUseCellCycleEventQueue() const
+{
+    return mUseCellCycleEventQueue;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractCellBasedSimulation<ELEMENT_DIM,SPACE_DIM>::SetNumberOfSrnModelThreads(unsigned numThreads)
+{
+    mSrnModelBatchSimulator.SetNumberOfThreads(numThreads);
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void AbstractCellBasedSimulation<ELEMENT_DIM,SPACE_DIM>::AddCellKiller(boost::shared_ptr<AbstractCellKiller<SPACE_DIM> > pCellKiller)
 {
@@ -386,6 +551,9 @@ void AbstractCellBasedSimulation<ELEMENT_DIM,SPACE_DIM>::Solve()
 
     SetupSolve();
 
+    // Cells may have been added or changed since any previous call to Solve()
+    mCellCycleEventQueue.Clear();
+
     // Call SetupSolve() on each modifier
     for (typename std::vector<boost::shared_ptr<AbstractCellBasedSimulationModifier<ELEMENT_DIM, SPACE_DIM> > >::iterator iter = mSimulationModifiers.begin();
          iter != mSimulationModifiers.end();
@@ -446,6 +614,7 @@ void AbstractCellBasedSimulation<ELEMENT_DIM,SPACE_DIM>::Solve()
         std::map<CellPtr, c_vector<double, SPACE_DIM> > old_cell_locations;
         if (mOutputCellVelocities && at_sampling_timestep)
         {
+            SynchroniseCellLocations();
             for (typename AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>::Iterator cell_iter = mrCellPopulation.Begin();
                  cell_iter != mrCellPopulation.End();
                  ++cell_iter)
@@ -460,6 +629,8 @@ void AbstractCellBasedSimulation<ELEMENT_DIM,SPACE_DIM>::Solve()
         // Now write cell velocities to file if required
         if (mOutputCellVelocities && at_sampling_timestep)
         {
+            SynchroniseCellLocations();
+
             // Offset as doing this before we increase time by mDt
             *mpCellVelocitiesFile << p_time->GetTime() + mDt<< "\t";
 
@@ -495,6 +666,10 @@ void AbstractCellBasedSimulation<ELEMENT_DIM,SPACE_DIM>::Solve()
 
         // Call UpdateAtEndOfTimeStep() on each modifier
         CellBasedEventHandler::BeginEvent(CellBasedEventHandler::UPDATESIMULATION);
+        if (!mSimulationModifiers.empty())
+        {
+            SynchroniseCellLocations();
+        }
         for (typename std::vector<boost::shared_ptr<AbstractCellBasedSimulationModifier<ELEMENT_DIM, SPACE_DIM> > >::iterator iter = mSimulationModifiers.begin();
              iter != mSimulationModifiers.end();
              ++iter)
@@ -507,6 +682,7 @@ void AbstractCellBasedSimulation<ELEMENT_DIM,SPACE_DIM>::Solve()
         CellBasedEventHandler::BeginEvent(CellBasedEventHandler::OUTPUT);
         if (p_simulation_time->GetTimeStepsElapsed()%mSamplingTimestepMultiple == 0)// should be at_sampling_timestep !
         {
+            SynchroniseCellLocations();
             mrCellPopulation.WriteResultsToFiles(results_directory+"/");
 
             // Call UpdateAtEndOfOutputTimeStep() on each modifier
@@ -527,7 +703,9 @@ void AbstractCellBasedSimulation<ELEMENT_DIM,SPACE_DIM>::Solve()
      * Note that cell birth and death still need to be checked because they may be spatially
      * dependent.
      */
+    SynchroniseCellLocations();
     UpdateCellPopulation();
+    MemoryAccounting::Sample();
 
     CellBasedEventHandler::BeginEvent(CellBasedEventHandler::UPDATESIMULATION);
     // Call UpdateAtEndOfSolve(), on each modifier
@@ -568,6 +746,17 @@ bool AbstractCellBasedSimulation<ELEMENT_DIM,SPACE_DIM>::StoppingEventHasOccurre
     return false;
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractCellBasedSimulation<ELEMENT_DIM,SPACE_DIM>::SynchroniseCellLocations()
+{
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool AbstractCellBasedSimulation<ELEMENT_DIM,SPACE_DIM>::CanSkipCellPopulationUpdate()
+{
+    return false;
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void AbstractCellBasedSimulation<ELEMENT_DIM,SPACE_DIM>::UpdateCellPopulation()
 {
@@ -590,8 +779,9 @@ void AbstractCellBasedSimulation<ELEMENT_DIM,SPACE_DIM>::UpdateCellPopulation()
 
     // Update topology of cell population
     CellBasedEventHandler::BeginEvent(CellBasedEventHandler::UPDATECELLPOPULATION);
-    if (mUpdateCellPopulation)
+    if (mUpdateCellPopulation && (births_or_death_occurred || !CanSkipCellPopulationUpdate()))
     {
+        SynchroniseCellLocations();
         LOG(1, "\tUpdating cell population...");
         mrCellPopulation.Update(births_or_death_occurred);
         LOG(1, "\tdone.\n");
@@ -46,6 +46,8 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "AbstractCellBasedSimulationModifier.hpp"
 #include "AbstractForce.hpp"
 #include "RandomNumberGenerator.hpp"
+#include "SrnModelBatchSimulator.hpp"
+#include "CellCycleEventQueue.hpp"
 
 // Forward declaration prevents circular include chain
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM> class AbstractCellPopulation;
@@ -171,6 +173,43 @@ protected:
      */
     unsigned mSamplingTimestepMultiple;
 
+    /**
+     * Whether to simulate the SRN models of all cells to the current time in one
+     * pass, before checking whether each cell is ready to divide (defaults to false).
+     * This is a run-time setting, so is not archived.
+     */
+    bool mBatchSrnModels;
+
+    /** Helper class used to simulate the SRN models of all cells if mBatchSrnModels is true. */
+    SrnModelBatchSimulator mSrnModelBatchSimulator;
+
+    /**
+     * Whether DoCellBirth() should only check those cells that are due to divide,
+     * using mCellCycleEventQueue (defaults to false). This is a run-time setting,
+     * so is not archived.
+     */
+    bool mUseCellCycleEventQueue;
+
+    /** The cells in the population, ordered by when each next needs checking, if mUseCellCycleEventQueue is true. */
+    CellCycleEventQueue mCellCycleEventQueue;
+
+    /**
+     * Helper method for DoCellBirth(). If the given cell is ready to divide and
+     * there is room for it to do so, divide it, add the daughter cell to the
+     * population and, if required, output the location of the division.
+     *
+     * @param pCell the cell
+     * @return the daughter cell, or an empty pointer if the cell did not divide
+     */
+    CellPtr DivideCellIfReady(CellPtr pCell);
+
+    /**
+     * Helper method for DoCellBirth(). Refill mCellCycleEventQueue if it is empty
+     * or if cells have been created since it was last brought up to date other
+     * than by division in DoCellBirth().
+     */
+    void UpdateCellCycleEventQueue();
+
     /**
      * Writes out special information about the mesh to the visualizer.
      */
@@ -225,6 +264,22 @@ protected:
      */
     virtual void UpdateCellPopulation();
 
+    /**
+     * Make sure that the cell population holds the current cell locations, for
+     * simulations that may keep them elsewhere between time steps. Called before
+     * cell killers, cell divisions, modifiers and output read the locations;
+     * subclasses that read them at other times, for example in
+     * StoppingEventHasOccurred(), must call it first. By default this does nothing.
+     */
+    virtual void SynchroniseCellLocations();
+
+    /**
+     * @return whether CellPopulation::Update() may be skipped at this time step
+     * when there have been no births or deaths, because nothing reads the cell
+     * population's neighbour information before the next time step. By default false.
+     */
+    virtual bool CanSkipCellPopulationUpdate();
+
     /**
      * Update the cell locations and topology (connectivity) of the cell population. This method
      * is called within the main time loop of Solve() .
@@ -341,6 +396,49 @@ public:
      */
     void SetNoBirth(bool noBirth);
 
+    /**
+     * Set whether to simulate the SRN models of all cells to the current time in
+     * one pass, using a SrnModelBatchSimulator, before checking whether each cell
+     * is ready to divide. The results are the same either way, but when Chaste is
+     * built with OpenMP the ODEs may then be solved on several threads.
+     *
+     * @param batchSrnModels whether to batch the SRN models (defaults to true)
+     */
+    void SetBatchSrnModels(bool batchSrnModels=true);
+
+    /**
+     * @return whether the SRN models of all cells are simulated in one pass.
+     */
+    bool GetBatchSrnModels() const;
+
+    /**
+     * Set the number of threads used to solve the SRN models when they are batched.
+     *
+     * @param numThreads the number of threads (at least 1)
+     */
+    void SetNumberOfSrnModelThreads(unsigned numThreads);
+
+    /**
+     * Set whether DoCellBirth() should keep the cells in a CellCycleEventQueue, and
+     * only check those cells whose cell-cycle models say they may now be ready to
+     * divide (or that cannot say), rather than checking every cell at every timestep.
+     *
+     * Cells are checked in order of cell identifier rather than in the order of
+     * the cell population, so stochastic simulations may differ from those run
+     * without the queue. The queue is refilled at the start of each call to Solve()
+     * and whenever a cell is created other than by division; a change to a cell's
+     * proliferative type made outside its cell-cycle model (for example by a
+     * simulation modifier) is only seen when the cell is next checked.
+     *
+     * @param useCellCycleEventQueue whether to use the queue (defaults to true)
+     */
+    void SetUseCellCycleEventQueue(bool useCellCycleEventQueue=true);
+
+    /**
+     * @return whether DoCellBirth() only checks cells that are due to divide.
+     */
+    bool GetUseCellCycleEventQueue() const;
+
     /**
      * Set whether to update the topology of the cell population at each time step.
      *
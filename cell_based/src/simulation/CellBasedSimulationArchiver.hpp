@@ -58,6 +58,38 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 template <unsigned ELEMENT_DIM, class SIM, unsigned SPACE_DIM=ELEMENT_DIM>
 class CellBasedSimulationArchiver
 {
+private:
+
+    /**
+     * Get the name of the archive file for a given time stamp.
+     *
+     * @param rTimeStamp  the time stamp, as written by Save()
+     * @param binary  whether the archive is in the binary format
+     * @param compress  whether the archive is gzip-compressed
+     * @return the archive file name
+     */
+    static std::string GetArchiveFilename(const std::string& rTimeStamp, bool binary, bool compress=false);
+
+    /**
+     * Helper method for Load(), templated over the Boost archive and file stream types.
+     *
+     * @param rArchiveDirectory  folder containing the archive
+     * @param rArchiveFilename  the name of the archive file
+     * @return the unarchived simulation object
+     */
+    template<class ARCHIVE, class STREAM>
+    static SIM* LoadFromArchive(const FileFinder& rArchiveDirectory, const std::string& rArchiveFilename);
+
+    /**
+     * Helper method for Save(), templated over the Boost archive and file stream types.
+     *
+     * @param pSim  pointer to the simulation
+     * @param rArchiveDirectory  folder to contain the archive
+     * @param rArchiveFilename  the name of the archive file
+     */
+    template<class ARCHIVE, class STREAM>
+    static void SaveToArchive(SIM* pSim, const FileFinder& rArchiveDirectory, const std::string& rArchiveFilename);
+
 public:
 
     /**
@@ -68,8 +100,13 @@ public:
      *   (specified originally by simulation.SetOutputDirectory("wherever"); )
      * @param rTimeStamp  the time at which to load the simulation (this must
      *   be one of the times at which simulation.Save() was called)
+     * @param binary  whether to load a checkpoint written by Save() in the
+     *   binary format (defaults to false)
+     *
+     * Compressed checkpoints are detected automatically from the ".gz"
+     * extension on the archive file name.
      */
-    static SIM* Load(const std::string& rArchiveDirectory, const double& rTimeStamp);
+    static SIM* Load(const std::string& rArchiveDirectory, const double& rTimeStamp, bool binary=false);
 
     /**
      * Saves the whole cell-based simulation for restarting later.
@@ -81,41 +118,102 @@ public:
      * First archives simulation time (and other singletons, if used)
      * then the simulation itself.
      *
+     * If binary is true, a Boost binary archive is written instead, to the
+     * file "cell_population_sim_at_time_<SIMULATION TIME>.barch". This is
+     * much faster to write and read for large populations, but the resulting
+     * checkpoint is not portable between platforms or Boost versions.
+     *
+     * If compress is true, the archive is gzip-compressed as it is written,
+     * and ".gz" is appended to the file name.
+     *
      * @param pSim pointer to the simulation
+     * @param binary  whether to write the checkpoint in the binary format
+     *   (defaults to false)
+     * @param compress  whether to gzip-compress the checkpoint (defaults to false)
      */
-    static void Save(SIM* pSim);
+    static void Save(SIM* pSim, bool binary=false, bool compress=false);
 };
 
 template <unsigned ELEMENT_DIM, class SIM, unsigned SPACE_DIM>
-SIM* CellBasedSimulationArchiver<ELEMENT_DIM, SIM, SPACE_DIM>::Load(const std::string& rArchiveDirectory, const double& rTimeStamp)
+std::string CellBasedSimulationArchiver<ELEMENT_DIM, SIM, SPACE_DIM>::GetArchiveFilename(const std::string& rTimeStamp, bool binary, bool compress)
+{
+    return "cell_population_sim_at_time_" + rTimeStamp + (binary ? ".barch" : ".arch") + (compress ? ".gz" : "");
+}
+
+template <unsigned ELEMENT_DIM, class SIM, unsigned SPACE_DIM>
+template<class ARCHIVE, class STREAM>
+SIM* CellBasedSimulationArchiver<ELEMENT_DIM, SIM, SPACE_DIM>::LoadFromArchive(const FileFinder& rArchiveDirectory, const std::string& rArchiveFilename)
+{
+    // Create an input archive
+    ArchiveOpener<ARCHIVE, STREAM> arch_opener(rArchiveDirectory, rArchiveFilename);
+    ARCHIVE* p_arch = arch_opener.GetCommonArchive();
+
+    // Load the simulation
+    SIM* p_sim;
+    (*p_arch) >> p_sim;
+    return p_sim;
+}
+
+template <unsigned ELEMENT_DIM, class SIM, unsigned SPACE_DIM>
+template<class ARCHIVE, class STREAM>
+void CellBasedSimulationArchiver<ELEMENT_DIM, SIM, SPACE_DIM>::SaveToArchive(SIM* pSim, const FileFinder& rArchiveDirectory, const std::string& rArchiveFilename)
+{
+    // Create output archive
+    ArchiveOpener<ARCHIVE, STREAM> arch_opener(rArchiveDirectory, rArchiveFilename);
+    ARCHIVE* p_arch = arch_opener.GetCommonArchive();
+
+    // Archive the simulation (const-ness would be a pain here)
+    (*p_arch) & pSim;
+}
+
+template <unsigned ELEMENT_DIM, class SIM, unsigned SPACE_DIM>
+SIM* CellBasedSimulationArchiver<ELEMENT_DIM, SIM, SPACE_DIM>::Load(const std::string& rArchiveDirectory, const double& rTimeStamp, bool binary)
 {
     /**
      * Find the right archive (and mesh) to load.  The files are contained within
      * the 'archive' folder in rArchiveDirectory, with the archive itself called
-     * 'cell_population_sim_at_time_`rTimeStamp`.arch'.  The path to this file is returned.
+     * 'cell_population_sim_at_time_`rTimeStamp`.arch' (or '.barch' for binary
+     * archives, with '.gz' appended if compressed).  The path to this file is returned.
      *
      * The path to the mesh is stored in ArchiveLocationInfo for use by the
      * CellPopulation de-serialization routines.
      */
     std::ostringstream time_stamp;
     time_stamp << rTimeStamp;
-    std::string archive_filename = "cell_population_sim_at_time_" + time_stamp.str() + ".arch";
+    std::string archive_filename = GetArchiveFilename(time_stamp.str(), binary);
     std::string mesh_filename = "mesh_" + time_stamp.str();
     FileFinder archive_dir(rArchiveDirectory + "/archive/", RelativeTo::ChasteTestOutput);
     ArchiveLocationInfo::SetMeshPathname(archive_dir, mesh_filename);
 
-    // Create an input archive
-    ArchiveOpener<boost::archive::text_iarchive, std::ifstream> arch_opener(archive_dir, archive_filename);
-    boost::archive::text_iarchive* p_arch = arch_opener.GetCommonArchive();
-
-    // Load the simulation
-    SIM* p_sim;
-    (*p_arch) >> p_sim;
-    return p_sim;
+    // Fall back to a compressed archive if there isn't an uncompressed one
+    bool compressed = false;
+    if (!FileFinder(archive_filename, archive_dir).Exists())
+    {
+        std::string compressed_filename = GetArchiveFilename(time_stamp.str(), binary, true);
+        if (FileFinder(compressed_filename, archive_dir).Exists())
+        {
+            archive_filename = compressed_filename;
+            compressed = true;
+        }
+    }
+
+    if (binary)
+    {
+        if (compressed)
+        {
+            return LoadFromArchive<boost::archive::binary_iarchive, GzipInputFileStream>(archive_dir, archive_filename);
+        }
+        return LoadFromArchive<boost::archive::binary_iarchive, std::ifstream>(archive_dir, archive_filename);
+    }
+    if (compressed)
+    {
+        return LoadFromArchive<boost::archive::text_iarchive, GzipInputFileStream>(archive_dir, archive_filename);
+    }
+    return LoadFromArchive<boost::archive::text_iarchive, std::ifstream>(archive_dir, archive_filename);
 }
 
 template <unsigned ELEMENT_DIM, class SIM, unsigned SPACE_DIM>
-void CellBasedSimulationArchiver<ELEMENT_DIM, SIM, SPACE_DIM>::Save(SIM* pSim)
+void CellBasedSimulationArchiver<ELEMENT_DIM, SIM, SPACE_DIM>::Save(SIM* pSim, bool binary, bool compress)
 {
     // Get the simulation time as a string
     const SimulationTime* p_sim_time = SimulationTime::Instance();
@@ -125,15 +223,25 @@ void CellBasedSimulationArchiver<ELEMENT_DIM, SIM, SPACE_DIM>::Save(SIM* pSim)
 
     // Set up folder and filename of archive
     FileFinder archive_dir(pSim->GetOutputDirectory() + "/archive/", RelativeTo::ChasteTestOutput);
-    std::string archive_filename = "cell_population_sim_at_time_" + time_stamp.str() + ".arch";
+    std::string archive_filename = GetArchiveFilename(time_stamp.str(), binary, compress);
     ArchiveLocationInfo::SetMeshFilename(std::string("mesh_") + time_stamp.str());
 
-    // Create output archive
-    ArchiveOpener<boost::archive::text_oarchive, std::ofstream> arch_opener(archive_dir, archive_filename);
-    boost::archive::text_oarchive* p_arch = arch_opener.GetCommonArchive();
-
-    // Archive the simulation (const-ness would be a pain here)
-    (*p_arch) & pSim;
+    if (binary && compress)
+    {
+        SaveToArchive<boost::archive::binary_oarchive, GzipOutputFileStream>(pSim, archive_dir, archive_filename);
+    }
+    else if (binary)
+    {
+        SaveToArchive<boost::archive::binary_oarchive, std::ofstream>(pSim, archive_dir, archive_filename);
+    }
+    else if (compress)
+    {
+        SaveToArchive<boost::archive::text_oarchive, GzipOutputFileStream>(pSim, archive_dir, archive_filename);
+    }
+    else
+    {
+        SaveToArchive<boost::archive::text_oarchive, std::ofstream>(pSim, archive_dir, archive_filename);
+    }
 }
 
 #endif /*CELLBASEDSIMULATIONARCHIVER_HPP_*/
@@ -0,0 +1,329 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef CELLBASEDSIMULATIONENSEMBLE_HPP_
+#define CELLBASEDSIMULATIONENSEMBLE_HPP_
+
+// Must be included before any other serialization headers
+#include "CheckpointArchiveTypes.hpp"
+
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ArchiveLocationInfo.hpp"
+#include "Exception.hpp"
+#include "FileFinder.hpp"
+#include "OutputFileHandler.hpp"
+#include "PetscTools.hpp"
+#include "ProcessSpecificArchive.hpp"
+#include "RandomNumberGenerator.hpp"
+#include "SerializableSingleton.hpp"
+#include "SimulationTime.hpp"
+
+/**
+ * Runs many replicates of an initialised cell-based simulation which differ
+ * only in the seed of the random number generator, as needed by stochastic
+ * studies, without paying for the set-up of meshes, cells and forces each time.
+ *
+ * The template simulation is archived once, into memory, in the same way as
+ * CellBasedSimulationArchiver::Save() (so any mesh is written to the folder
+ * "ensemble_template" under its output directory). Each replicate is then
+ * loaded from this archive, given the seed GetBaseSeed() + its index and the
+ * output directory GetReplicateOutputDirectory(), and solved.
+ *
+ * Since SimulationTime and RandomNumberGenerator are singletons, replicates
+ * can't share a process. Instead, Run() isolates the processes (see
+ * PetscTools::IsolateProcesses()) and deals the replicates out between them,
+ * so in parallel each process must hold a complete, serial copy of the
+ * template; build it with the processes isolated if the population would
+ * otherwise be distributed. The template simulation itself is not changed,
+ * and SimulationTime and the random number generator are restored once all
+ * the replicates have been run.
+ */
+template <unsigned ELEMENT_DIM, class SIM, unsigned SPACE_DIM=ELEMENT_DIM>
+class CellBasedSimulationEnsemble
+{
+private:
+
+    /** The initialised simulation to copy. */
+    SIM* mpTemplate;
+
+    /** The number of replicates in the ensemble. */
+    unsigned mNumReplicates;
+
+    /** The seed of replicate 0; replicate i is seeded with mBaseSeed + i. */
+    unsigned mBaseSeed;
+
+    /** Called with each replicate once it has been solved, if set. */
+    std::function<void(unsigned, SIM&)> mReplicateCallback;
+
+    /**
+     * Load, reseed and solve a single replicate.
+     *
+     * @param replicate  the index of the replicate
+     * @param rCommonArchive  the main archive of the template simulation
+     * @param rPrivateArchive  this process' secondary archive of the template
+     */
+    void RunReplicate(unsigned replicate, const std::string& rCommonArchive, const std::string& rPrivateArchive);
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param pTemplate  the initialised simulation to copy, whose output
+     *   directory must be set before calling Run()
+     * @param numReplicates  the number of replicates to run
+     */
+    CellBasedSimulationEnsemble(SIM* pTemplate, unsigned numReplicates);
+
+    /** @return the number of replicates in the ensemble */
+    unsigned GetNumReplicates() const;
+
+    /**
+     * Set the seed of the first replicate. Replicate i is seeded with
+     * baseSeed + i. Defaults to 0.
+     *
+     * @param baseSeed  the seed of replicate 0
+     */
+    void SetBaseSeed(unsigned baseSeed);
+
+    /** @return the seed of replicate 0 */
+    unsigned GetBaseSeed() const;
+
+    /**
+     * Set a function to call with each replicate once it has been solved,
+     * e.g. to collect summary statistics, before the replicate is deleted.
+     *
+     * @param callback  the function, taking the index of the replicate and
+     *   the solved simulation
+     */
+    void SetReplicateCallback(std::function<void(unsigned, SIM&)> callback);
+
+    /**
+     * @return the output directory of a replicate, "replicate_<index>" under
+     *   the output directory of the template simulation
+     *
+     * @param replicate  the index of the replicate
+     */
+    std::string GetReplicateOutputDirectory(unsigned replicate) const;
+
+    /**
+     * @return the indices of the replicates that Run() solves on this process
+     */
+    std::vector<unsigned> GetReplicatesForThisProcess() const;
+
+    /**
+     * Run all the replicates, each on one process.
+     *
+     * @note Must be called collectively.
+     */
+    void Run();
+};
+
+template <unsigned ELEMENT_DIM, class SIM, unsigned SPACE_DIM>
+CellBasedSimulationEnsemble<ELEMENT_DIM, SIM, SPACE_DIM>::CellBasedSimulationEnsemble(SIM* pTemplate, unsigned numReplicates)
+    : mpTemplate(pTemplate),
+      mNumReplicates(numReplicates),
+      mBaseSeed(0u)
+{
+    assert(pTemplate != nullptr);
+    if (numReplicates == 0u)
+    {
+        EXCEPTION("An ensemble needs at least one replicate.");
+    }
+}
+
+template <unsigned ELEMENT_DIM, class SIM, unsigned SPACE_DIM>
+unsigned CellBasedSimulationEnsemble<ELEMENT_DIM, SIM, SPACE_DIM>::GetNumReplicates() const
+{
+    return mNumReplicates;
+}
+
+template <unsigned ELEMENT_DIM, class SIM, unsigned SPACE_DIM>
+void CellBasedSimulationEnsemble<ELEMENT_DIM, SIM, SPACE_DIM>::SetBaseSeed(unsigned baseSeed)
+{
+    mBaseSeed = baseSeed;
+}
+
+template <unsigned ELEMENT_DIM, class SIM, unsigned SPACE_DIM>
+unsigned CellBasedSimulationEnsemble<ELEMENT_DIM, SIM, SPACE_DIM>::GetBaseSeed() const
+{
+    return mBaseSeed;
+}
+
+template <unsigned ELEMENT_DIM, class SIM, unsigned SPACE_DIM>
+void CellBasedSimulationEnsemble<ELEMENT_DIM, SIM, SPACE_DIM>::SetReplicateCallback(std::function<void(unsigned, SIM&)> callback)
+{
+    mReplicateCallback = callback;
+}
+
+template <unsigned ELEMENT_DIM, class SIM, unsigned SPACE_DIM>
+std::string CellBasedSimulationEnsemble<ELEMENT_DIM, SIM, SPACE_DIM>::GetReplicateOutputDirectory(unsigned replicate) const
+{
+    std::ostringstream directory;
+    directory << mpTemplate->GetOutputDirectory() << "/replicate_" << replicate;
+    return directory.str();
+}
+
+template <unsigned ELEMENT_DIM, class SIM, unsigned SPACE_DIM>
+std::vector<unsigned> CellBasedSimulationEnsemble<ELEMENT_DIM, SIM, SPACE_DIM>::GetReplicatesForThisProcess() const
+{
+    std::vector<unsigned> replicates;
+    for (unsigned replicate = PetscTools::GetMyRank(); replicate < mNumReplicates; replicate += PetscTools::GetNumProcs())
+    {
+        replicates.push_back(replicate);
+    }
+    return replicates;
+}
+
+template <unsigned ELEMENT_DIM, class SIM, unsigned SPACE_DIM>
+void CellBasedSimulationEnsemble<ELEMENT_DIM, SIM, SPACE_DIM>::RunReplicate(unsigned replicate,
+                                                                            const std::string& rCommonArchive,
+                                                                            const std::string& rPrivateArchive)
+{
+    SIM* p_sim;
+    {
+        std::istringstream common_stream(rCommonArchive);
+        std::istringstream private_stream(rPrivateArchive);
+        boost::archive::binary_iarchive common_arch(common_stream);
+        boost::archive::binary_iarchive private_arch(private_stream);
+        ProcessSpecificArchive<boost::archive::binary_iarchive>::Set(&private_arch);
+        common_arch >> p_sim;
+        ProcessSpecificArchive<boost::archive::binary_iarchive>::Set(nullptr);
+    }
+
+    // Loading restored the template's random number generator, so give this replicate its own stream
+    RandomNumberGenerator::Instance()->Reseed(mBaseSeed + replicate);
+    p_sim->SetOutputDirectory(GetReplicateOutputDirectory(replicate));
+
+    try
+    {
+        p_sim->Solve();
+        if (mReplicateCallback)
+        {
+            mReplicateCallback(replicate, *p_sim);
+        }
+    }
+    catch (...)
+    {
+        delete p_sim;
+        throw;
+    }
+    delete p_sim;
+}
+
+template <unsigned ELEMENT_DIM, class SIM, unsigned SPACE_DIM>
+void CellBasedSimulationEnsemble<ELEMENT_DIM, SIM, SPACE_DIM>::Run()
+{
+    const std::string output_directory = mpTemplate->GetOutputDirectory();
+    if (output_directory.empty())
+    {
+        EXCEPTION("The output directory of the template simulation must be set before running an ensemble.");
+    }
+
+    // Any mesh files are written here when the template is archived (collective)
+    OutputFileHandler template_handler(output_directory + "/ensemble_template/");
+    FileFinder template_dir = template_handler.FindFile("");
+
+    const bool was_isolated = PetscTools::IsIsolated();
+    PetscTools::IsolateProcesses(true);
+
+    // Keep the singletons as they are now, to put them back afterwards
+    std::ostringstream singletons_stream;
+    {
+        boost::archive::binary_oarchive singletons_arch(singletons_stream);
+        SerializableSingleton<SimulationTime>* const p_time_wrapper = SimulationTime::Instance()->GetSerializationWrapper();
+        singletons_arch << p_time_wrapper;
+        SerializableSingleton<RandomNumberGenerator>* const p_rng_wrapper = RandomNumberGenerator::Instance()->GetSerializationWrapper();
+        singletons_arch << p_rng_wrapper;
+    }
+
+    bool failed = false;
+    Exception error("", "", 0u);
+    try
+    {
+        // Archive the template once, as CellBasedSimulationArchiver::Save() would but into memory
+        std::ostringstream mesh_filename;
+        mesh_filename << "mesh_template_" << PetscTools::GetMyRank();
+        ArchiveLocationInfo::SetArchiveDirectory(template_dir);
+        ArchiveLocationInfo::SetMeshFilename(mesh_filename.str());
+
+        std::ostringstream common_stream;
+        std::ostringstream private_stream;
+        {
+            boost::archive::binary_oarchive common_arch(common_stream);
+            boost::archive::binary_oarchive private_arch(private_stream);
+            ProcessSpecificArchive<boost::archive::binary_oarchive>::Set(&private_arch);
+            common_arch & mpTemplate;
+            ProcessSpecificArchive<boost::archive::binary_oarchive>::Set(nullptr);
+        }
+        const std::string common_archive = common_stream.str();
+        const std::string private_archive = private_stream.str();
+        ArchiveLocationInfo::SetMeshPathname(template_dir, mesh_filename.str());
+
+        std::vector<unsigned> replicates = GetReplicatesForThisProcess();
+        for (unsigned i=0; i<replicates.size(); i++)
+        {
+            RunReplicate(replicates[i], common_archive, private_archive);
+        }
+    }
+    catch (Exception& e)
+    {
+        failed = true;
+        error = e;
+    }
+
+    {
+        std::istringstream singletons_in(singletons_stream.str());
+        boost::archive::binary_iarchive singletons_arch(singletons_in);
+        SerializableSingleton<SimulationTime>* p_time_wrapper;
+        singletons_arch >> p_time_wrapper;
+        SerializableSingleton<RandomNumberGenerator>* p_rng_wrapper;
+        singletons_arch >> p_rng_wrapper;
+    }
+
+    // Wait for every process to finish its replicates, and fail together
+    PetscTools::IsolateProcesses(was_isolated);
+    PetscTools::ReplicateException(failed);
+    if (failed)
+    {
+        throw error;
+    }
+}
+
+#endif /*CELLBASEDSIMULATIONENSEMBLE_HPP_*/
@@ -39,6 +39,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "CellBasedEventHandler.hpp"
 #include "ForwardEulerNumericalMethod.hpp"
+#include "SimulationTime.hpp"
 #include "StepSizeException.hpp"
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
@@ -106,14 +107,22 @@ void OffLatticeSimulation<ELEMENT_DIM,SPACE_DIM>::UpdateCellLocationsAndTopology
 
     while (time_advanced_so_far < target_time_step)
     {
-        // Store the initial node positions (these may be needed when applying boundary conditions)
+        /*
+         * Store the initial node positions (these may be needed when applying boundary
+         * conditions or reverting a step). They are not needed otherwise, so node
+         * locations held by the numerical method can then stay there.
+         */
         std::map<Node<SPACE_DIM>*, c_vector<double, SPACE_DIM> > old_node_locations;
 
-        for (typename AbstractMesh<ELEMENT_DIM, SPACE_DIM>::NodeIterator node_iter = this->mrCellPopulation.rGetMesh().GetNodeIteratorBegin();
-             node_iter != this->mrCellPopulation.rGetMesh().GetNodeIteratorEnd();
-             ++node_iter)
+        if (!mBoundaryConditions.empty() || mpNumericalMethod->HasAdaptiveTimestep())
         {
-            old_node_locations[&(*node_iter)] = (node_iter)->rGetLocation();
+            mpNumericalMethod->SynchroniseNodeLocations();
+            for (typename AbstractMesh<ELEMENT_DIM, SPACE_DIM>::NodeIterator node_iter = this->mrCellPopulation.rGetMesh().GetNodeIteratorBegin();
+                 node_iter != this->mrCellPopulation.rGetMesh().GetNodeIteratorEnd();
+                 ++node_iter)
+            {
+                old_node_locations[&(*node_iter)] = (node_iter)->rGetLocation();
+            }
         }
 
         // Try to update node positions according to the numerical method
@@ -125,12 +134,10 @@ void OffLatticeSimulation<ELEMENT_DIM,SPACE_DIM>::UpdateCellLocationsAndTopology
             // Successful time step! Update time_advanced_so_far
             time_advanced_so_far += present_time_step;
 
-            // If using adaptive timestep, then increase the present_time_step (by 1% for now)
+            // If using adaptive timestep, then increase the present_time_step as suggested by the numerical method
             if (mpNumericalMethod->HasAdaptiveTimestep())
             {
-                ///\todo #2087 Make this a settable member variable
-                double timestep_increase = 0.01;
-                present_time_step = std::min((1+timestep_increase)*present_time_step, target_time_step - time_advanced_so_far);
+                present_time_step = std::min(mpNumericalMethod->CalculateNextTimeStep(present_time_step), target_time_step - time_advanced_so_far);
             }
 
         }
@@ -154,6 +161,42 @@ void OffLatticeSimulation<ELEMENT_DIM,SPACE_DIM>::UpdateCellLocationsAndTopology
     CellBasedEventHandler::EndEvent(CellBasedEventHandler::POSITION);
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void OffLatticeSimulation<ELEMENT_DIM,SPACE_DIM>::UpdateCellPopulation()
+{
+    unsigned num_births_and_deaths = this->mNumBirths + this->mNumDeaths;
+
+    AbstractCellBasedSimulation<ELEMENT_DIM,SPACE_DIM>::UpdateCellPopulation();
+
+    // New nodes may have taken the indices of deleted ones
+    if (mpNumericalMethod && this->mNumBirths + this->mNumDeaths != num_births_and_deaths)
+    {
+        mpNumericalMethod->InvalidateResidentNodeLocations();
+    }
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void OffLatticeSimulation<ELEMENT_DIM,SPACE_DIM>::SynchroniseCellLocations()
+{
+    if (mpNumericalMethod)
+    {
+        mpNumericalMethod->SynchroniseNodeLocations();
+    }
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool OffLatticeSimulation<ELEMENT_DIM,SPACE_DIM>::CanSkipCellPopulationUpdate()
+{
+    SimulationTime* p_time = SimulationTime::Instance();
+    return mpNumericalMethod
+           && mpNumericalMethod->UsesOwnNodePairs()
+           && this->mCellKillers.empty()
+           && this->mSimulationModifiers.empty()
+           && mBoundaryConditions.empty()
+           && !p_time->IsFinished()
+           && (p_time->GetTimeStepsElapsed() + 1)%this->mSamplingTimestepMultiple != 0;
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void OffLatticeSimulation<ELEMENT_DIM,SPACE_DIM>::RevertToOldLocations(std::map<Node<SPACE_DIM>*, c_vector<double, SPACE_DIM> > oldNodeLoctions)
 {
@@ -163,6 +206,7 @@ void OffLatticeSimulation<ELEMENT_DIM,SPACE_DIM>::RevertToOldLocations(std::map<
     {
         (node_iter)->rGetModifiableLocation() = oldNodeLoctions[&(*node_iter)];
     }
+    mpNumericalMethod->InvalidateResidentNodeLocations();
 }
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
@@ -186,6 +230,11 @@ void OffLatticeSimulation<ELEMENT_DIM,SPACE_DIM>::ApplyBoundaries(std::map<Node<
             EXCEPTION("The cell population boundary conditions are incompatible.");
         }
     }
+
+    if (!mBoundaryConditions.empty())
+    {
+        mpNumericalMethod->InvalidateResidentNodeLocations();
+    }
 }
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
@@ -110,16 +110,42 @@ protected:
      */
     virtual void UpdateCellLocationsAndTopology();
 
+    /**
+     * Overridden UpdateCellPopulation() method.
+     *
+     * Calls the method on the parent class, then tells the numerical method
+     * that node locations must be refreshed if there were any births or deaths.
+     */
+    virtual void UpdateCellPopulation();
+
+    /**
+     * Overridden SynchroniseCellLocations() method.
+     *
+     * Copies any node locations held by the numerical method to the nodes.
+     */
+    virtual void SynchroniseCellLocations();
+
+    /**
+     * Overridden CanSkipCellPopulationUpdate() method.
+     *
+     * @return true if the numerical method finds its own node pairs, and there are
+     * no cell killers, modifiers or boundary conditions and no output at the end of
+     * this time step.
+     */
+    virtual bool CanSkipCellPopulationUpdate();
+
     /**
      * Sends nodes back to the positions given in the input map. Used after a failed step
-     * when adaptivity is turned on.
+     * when adaptivity is turned on. Tells the numerical method that node locations must
+     * be refreshed.
      *
      * @param oldNodeLoctions A map linking nodes to their old positions.
      */
     void RevertToOldLocations(std::map<Node<SPACE_DIM>*, c_vector<double, SPACE_DIM> > oldNodeLoctions);
 
     /**
-     * Applies any boundary conditions.
+     * Applies any boundary conditions, and tells the numerical method that node
+     * locations must be refreshed if there are any.
      *
      * @param oldNodeLoctions Mapping between node indices and old node locations
      */
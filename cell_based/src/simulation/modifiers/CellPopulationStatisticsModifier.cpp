@@ -0,0 +1,426 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "CellPopulationStatisticsModifier.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#include "MeshBasedCellPopulation.hpp"
+#include "StemCellProliferativeType.hpp"
+#include "TransitCellProliferativeType.hpp"
+#include "DifferentiatedCellProliferativeType.hpp"
+#include "DefaultCellProliferativeType.hpp"
+#include "SimulationTime.hpp"
+#include "PetscTools.hpp"
+
+/**
+ * Combine the values held on each process using an MPI reduction, leaving the
+ * result on every process.
+ *
+ * @param rValues the values on this process, overwritten by the reduced values
+ * @param operation the MPI reduction operation
+ */
+static void ReduceAcrossProcesses(std::vector<double>& rValues, MPI_Op operation)
+{
+    if (PetscTools::IsParallel() && !rValues.empty())
+    {
+        std::vector<double> reduced_values(rValues.size());
+        MPI_Allreduce(&rValues[0], &reduced_values[0], rValues.size(), MPI_DOUBLE, operation, PetscTools::GetWorld());
+        rValues = reduced_values;
+    }
+}
+
+template <unsigned DIM>
+CellPopulationStatisticsModifier<DIM>::CellPopulationStatisticsModifier()
+    : AbstractCellBasedSimulationModifier<DIM>(),
+      mOutputProliferativeTypeCounts(true),
+      mOutputCellVolumeMoments(false),
+      mNumRadialBins(0),
+      mMaxNumNeighboursInHistogram(UNSIGNED_UNSET)
+{
+}
+
+template <unsigned DIM>
+CellPopulationStatisticsModifier<DIM>::~CellPopulationStatisticsModifier()
+{
+}
+
+template <unsigned DIM>
+void CellPopulationStatisticsModifier<DIM>::UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+}
+
+template <unsigned DIM>
+void CellPopulationStatisticsModifier<DIM>::UpdateAtEndOfOutputTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+    WriteStatistics(rCellPopulation);
+}
+
+template <unsigned DIM>
+void CellPopulationStatisticsModifier<DIM>::SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory)
+{
+    if (PetscTools::AmMaster())
+    {
+        OutputFileHandler output_file_handler(outputDirectory+"/", false);
+        mpStatisticsFile = output_file_handler.OpenOutputFile("populationstatistics.dat");
+        WriteHeader();
+    }
+
+    // Record the statistics of the initial population, to match the other results files
+    WriteStatistics(rCellPopulation);
+}
+
+template <unsigned DIM>
+void CellPopulationStatisticsModifier<DIM>::UpdateAtEndOfSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+    if (PetscTools::AmMaster())
+    {
+        mpStatisticsFile->close();
+    }
+}
+
+template <unsigned DIM>
+void CellPopulationStatisticsModifier<DIM>::WriteHeader()
+{
+    *mpStatisticsFile << "Time";
+    if (mOutputProliferativeTypeCounts)
+    {
+        *mpStatisticsFile << "\tStemCellCount\tTransitCellCount\tDifferentiatedCellCount\tDefaultCellCount";
+    }
+
+    std::vector<std::string> quantity_names = mCellDataItemNames;
+    if (mOutputCellVolumeMoments)
+    {
+        quantity_names.push_back("volume");
+    }
+    for (unsigned i=0; i<quantity_names.size(); i++)
+    {
+        const std::string& r_name = quantity_names[i];
+        *mpStatisticsFile << "\t" << r_name << "_mean\t" << r_name << "_std\t" << r_name << "_min\t" << r_name << "_max";
+    }
+
+    for (unsigned bin=0; bin<mNumRadialBins; bin++)
+    {
+        *mpStatisticsFile << "\tradius_" << bin << "\tdensity_" << bin;
+    }
+
+    if (mMaxNumNeighboursInHistogram != UNSIGNED_UNSET)
+    {
+        *mpStatisticsFile << "\tneighbours_mean";
+        for (unsigned num_neighbours=0; num_neighbours<=mMaxNumNeighboursInHistogram; num_neighbours++)
+        {
+            *mpStatisticsFile << "\tneighbours_" << num_neighbours;
+        }
+    }
+    *mpStatisticsFile << "\n";
+}
+
+template <unsigned DIM>
+void CellPopulationStatisticsModifier<DIM>::WriteStatistics(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+    const unsigned num_quantities = mCellDataItemNames.size() + (mOutputCellVolumeMoments ? 1 : 0);
+    const bool output_neighbours = (mMaxNumNeighboursInHistogram != UNSIGNED_UNSET);
+    const unsigned num_neighbour_bins = output_neighbours ? mMaxNumNeighboursInHistogram + 1 : 0;
+
+    /*
+     * As in VolumeTrackingModifier, the Voronoi tessellation of a MeshBasedCellPopulation
+     * may be out of date if cells have divided since it was created.
+     */
+    if (mOutputCellVolumeMoments && bool(dynamic_cast<MeshBasedCellPopulation<DIM>*>(&rCellPopulation)))
+    {
+        static_cast<MeshBasedCellPopulation<DIM>*>(&(rCellPopulation))->CreateVoronoiTessellation();
+    }
+
+    std::vector<unsigned> item_indices(mCellDataItemNames.size());
+    for (unsigned i=0; i<mCellDataItemNames.size(); i++)
+    {
+        item_indices[i] = CellData::GetItemIndex(mCellDataItemNames[i]);
+    }
+
+    /*
+     * Sums are laid out as: the number of cells; the sum of cell centres; the number of
+     * cells of each default proliferative type; the sum and sum of squares of each
+     * quantity; the total number of neighbours; and the neighbour histogram.
+     */
+    const unsigned type_offset = 1 + DIM;
+    const unsigned quantity_offset = type_offset + 4;
+    const unsigned neighbour_offset = quantity_offset + 2*num_quantities;
+    std::vector<double> sums(neighbour_offset + (output_neighbours ? 1 + num_neighbour_bins : 0), 0.0);
+    std::vector<double> minima(num_quantities, DBL_MAX);
+    std::vector<double> maxima(num_quantities, -DBL_MAX);
+
+    for (typename AbstractCellPopulation<DIM>::Iterator cell_iter = rCellPopulation.Begin();
+         cell_iter != rCellPopulation.End();
+         ++cell_iter)
+    {
+        sums[0] += 1.0;
+        c_vector<double, DIM> centre = rCellPopulation.GetLocationOfCellCentre(*cell_iter);
+        for (unsigned i=0; i<DIM; i++)
+        {
+            sums[1+i] += centre[i];
+        }
+
+        if (mOutputProliferativeTypeCounts)
+        {
+            boost::shared_ptr<AbstractCellProperty> p_type = cell_iter->GetCellProliferativeType();
+            if (p_type->IsType<StemCellProliferativeType>())
+            {
+                sums[type_offset] += 1.0;
+            }
+            else if (p_type->IsType<TransitCellProliferativeType>())
+            {
+                sums[type_offset + 1] += 1.0;
+            }
+            else if (p_type->IsType<DifferentiatedCellProliferativeType>())
+            {
+                sums[type_offset + 2] += 1.0;
+            }
+            else if (p_type->IsType<DefaultCellProliferativeType>())
+            {
+                sums[type_offset + 3] += 1.0;
+            }
+        }
+
+        for (unsigned i=0; i<num_quantities; i++)
+        {
+            double value;
+            if (i < mCellDataItemNames.size())
+            {
+                value = cell_iter->GetCellData()->GetItem(item_indices[i]);
+            }
+            else
+            {
+                value = rCellPopulation.GetVolumeOfCell(*cell_iter);
+            }
+            sums[quantity_offset + 2*i] += value;
+            sums[quantity_offset + 2*i + 1] += value*value;
+            minima[i] = std::min(minima[i], value);
+            maxima[i] = std::max(maxima[i], value);
+        }
+
+        if (output_neighbours)
+        {
+            unsigned num_neighbours = rCellPopulation.GetNeighbouringLocationIndices(*cell_iter).size();
+            sums[neighbour_offset] += num_neighbours;
+            sums[neighbour_offset + 1 + std::min(num_neighbours, mMaxNumNeighboursInHistogram)] += 1.0;
+        }
+    }
+
+    ReduceAcrossProcesses(sums, MPI_SUM);
+    ReduceAcrossProcesses(minima, MPI_MIN);
+    ReduceAcrossProcesses(maxima, MPI_MAX);
+
+    const double num_cells = sums[0];
+
+    // The radial profile needs the global centroid and extent, so requires two further reductions
+    std::vector<double> radial_counts(mNumRadialBins, 0.0);
+    double max_distance = 0.0;
+    if (mNumRadialBins > 0 && num_cells > 0.0)
+    {
+        c_vector<double, DIM> centroid;
+        for (unsigned i=0; i<DIM; i++)
+        {
+            centroid[i] = sums[1+i]/num_cells;
+        }
+
+        std::vector<double> distances;
+        for (typename AbstractCellPopulation<DIM>::Iterator cell_iter = rCellPopulation.Begin();
+             cell_iter != rCellPopulation.End();
+             ++cell_iter)
+        {
+            distances.push_back(norm_2(rCellPopulation.GetLocationOfCellCentre(*cell_iter) - centroid));
+            max_distance = std::max(max_distance, distances.back());
+        }
+
+        std::vector<double> extent(1, max_distance);
+        ReduceAcrossProcesses(extent, MPI_MAX);
+        max_distance = extent[0];
+
+        if (max_distance > 0.0)
+        {
+            for (unsigned i=0; i<distances.size(); i++)
+            {
+                unsigned bin = std::min(unsigned(distances[i]*mNumRadialBins/max_distance), mNumRadialBins - 1);
+                radial_counts[bin] += 1.0;
+            }
+        }
+        ReduceAcrossProcesses(radial_counts, MPI_SUM);
+    }
+
+    if (PetscTools::AmMaster())
+    {
+        *mpStatisticsFile << SimulationTime::Instance()->GetTime();
+
+        if (mOutputProliferativeTypeCounts)
+        {
+            for (unsigned i=0; i<4; i++)
+            {
+                *mpStatisticsFile << "\t" << sums[type_offset + i];
+            }
+        }
+
+        for (unsigned i=0; i<num_quantities; i++)
+        {
+            double mean = 0.0;
+            double std_dev = 0.0;
+            double minimum = 0.0;
+            double maximum = 0.0;
+            if (num_cells > 0.0)
+            {
+                mean = sums[quantity_offset + 2*i]/num_cells;
+                std_dev = sqrt(std::max(0.0, sums[quantity_offset + 2*i + 1]/num_cells - mean*mean));
+                minimum = minima[i];
+                maximum = maxima[i];
+            }
+            *mpStatisticsFile << "\t" << mean << "\t" << std_dev << "\t" << minimum << "\t" << maximum;
+        }
+
+        for (unsigned bin=0; bin<mNumRadialBins; bin++)
+        {
+            double inner_radius = max_distance*bin/mNumRadialBins;
+            double outer_radius = max_distance*(bin + 1)/mNumRadialBins;
+
+            // The length, area or volume of the shell between the inner and outer radii
+            double shell_measure;
+            switch (DIM)
+            {
+                case 1:
+                    shell_measure = 2.0*(outer_radius - inner_radius);
+                    break;
+                case 2:
+                    shell_measure = M_PI*(outer_radius*outer_radius - inner_radius*inner_radius);
+                    break;
+                default:
+                    shell_measure = 4.0*M_PI*(pow(outer_radius, 3) - pow(inner_radius, 3))/3.0;
+            }
+
+            double density = (shell_measure > 0.0) ? radial_counts[bin]/shell_measure : 0.0;
+            *mpStatisticsFile << "\t" << outer_radius << "\t" << density;
+        }
+
+        if (output_neighbours)
+        {
+            double mean_neighbours = (num_cells > 0.0) ? sums[neighbour_offset]/num_cells : 0.0;
+            *mpStatisticsFile << "\t" << mean_neighbours;
+            for (unsigned i=0; i<num_neighbour_bins; i++)
+            {
+                *mpStatisticsFile << "\t" << sums[neighbour_offset + 1 + i];
+            }
+        }
+        *mpStatisticsFile << "\n";
+    }
+}
+
+template <unsigned DIM>
+void CellPopulationStatisticsModifier<DIM>::SetOutputProliferativeTypeCounts(bool outputProliferativeTypeCounts)
+{
+    mOutputProliferativeTypeCounts = outputProliferativeTypeCounts;
+}
+
+template <unsigned DIM>
+bool CellPopulationStatisticsModifier<DIM>::GetOutputProliferativeTypeCounts() const
+{
+    return mOutputProliferativeTypeCounts;
+}
+
+template <unsigned DIM>
+void CellPopulationStatisticsModifier<DIM>::AddCellDataItemMoments(const std::string& rItemName)
+{
+    mCellDataItemNames.push_back(rItemName);
+}
+
+template <unsigned DIM>
+const std::vector<std::string>& CellPopulationStatisticsModifier<DIM>::rGetCellDataItemNames() const
+{
+    return mCellDataItemNames;
+}
+
+template <unsigned DIM>
+void CellPopulationStatisticsModifier<DIM>::SetOutputCellVolumeMoments(bool outputCellVolumeMoments)
+{
+    mOutputCellVolumeMoments = outputCellVolumeMoments;
+}
+
+template <unsigned DIM>
+bool CellPopulationStatisticsModifier<DIM>::GetOutputCellVolumeMoments() const
+{
+    return mOutputCellVolumeMoments;
+}
+
+template <unsigned DIM>
+void CellPopulationStatisticsModifier<DIM>::SetNumRadialBins(unsigned numRadialBins)
+{
+    mNumRadialBins = numRadialBins;
+}
+
+template <unsigned DIM>
+unsigned CellPopulationStatisticsModifier<DIM>::GetNumRadialBins() const
+{
+    return mNumRadialBins;
+}
+
+template <unsigned DIM>
+void CellPopulationStatisticsModifier<DIM>::SetMaxNumNeighboursInHistogram(unsigned maxNumNeighbours)
+{
+    mMaxNumNeighboursInHistogram = maxNumNeighbours;
+}
+
+template <unsigned DIM>
+unsigned CellPopulationStatisticsModifier<DIM>::GetMaxNumNeighboursInHistogram() const
+{
+    return mMaxNumNeighboursInHistogram;
+}
+
+template <unsigned DIM>
+void CellPopulationStatisticsModifier<DIM>::OutputSimulationModifierParameters(out_stream& rParamsFile)
+{
+    *rParamsFile << "\t\t\t<OutputProliferativeTypeCounts>" << mOutputProliferativeTypeCounts << "</OutputProliferativeTypeCounts>\n";
+    *rParamsFile << "\t\t\t<OutputCellVolumeMoments>" << mOutputCellVolumeMoments << "</OutputCellVolumeMoments>\n";
+    *rParamsFile << "\t\t\t<NumRadialBins>" << mNumRadialBins << "</NumRadialBins>\n";
+
+    // Call method on direct parent class
+    AbstractCellBasedSimulationModifier<DIM>::OutputSimulationModifierParameters(rParamsFile);
+}
+
+// Explicit instantiation
+template class CellPopulationStatisticsModifier<1>;
+template class CellPopulationStatisticsModifier<2>;
+template class CellPopulationStatisticsModifier<3>;
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapperForCpp.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(CellPopulationStatisticsModifier)
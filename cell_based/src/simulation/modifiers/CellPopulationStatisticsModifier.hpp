@@ -0,0 +1,247 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef CELLPOPULATIONSTATISTICSMODIFIER_HPP_
+#define CELLPOPULATIONSTATISTICSMODIFIER_HPP_
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include "AbstractCellBasedSimulationModifier.hpp"
+
+/**
+ * A modifier class which at each output time step computes summary statistics of the
+ * cell population and writes them, one line per output time step, to the file
+ * "populationstatistics.dat". This allows parameter sweeps to record only the
+ * statistics they need, rather than writing (for example) the location and volume of
+ * every cell and post-processing this output.
+ *
+ * The following statistics may be enabled:
+ *  - the number of cells of each of the default proliferative types;
+ *  - the mean, standard deviation, minimum and maximum of any CellData item, and of the
+ *    cell volume;
+ *  - the radial number density of cells about the centroid of the population;
+ *  - the mean number of neighbours of each cell, and a histogram of these numbers.
+ *
+ * In parallel, each process accumulates statistics over the cells it owns, and these are
+ * combined using MPI reductions, so only the reduced arrays are written (by the master
+ * process).
+ */
+template <unsigned DIM>
+class CellPopulationStatisticsModifier : public AbstractCellBasedSimulationModifier<DIM,DIM>
+{
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Boost Serialization method for archiving/checkpointing.
+     * Archives the object and its member variables.
+     *
+     * @param archive  The boost archive.
+     * @param version  The current version of this class.
+     */
+    template <class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<AbstractCellBasedSimulationModifier<DIM,DIM> >(*this);
+        archive & mOutputProliferativeTypeCounts;
+        archive & mCellDataItemNames;
+        archive & mOutputCellVolumeMoments;
+        archive & mNumRadialBins;
+        archive & mMaxNumNeighboursInHistogram;
+    }
+
+    /** Whether to output the number of cells of each default proliferative type. Defaults to true. */
+    bool mOutputProliferativeTypeCounts;
+
+    /** The names of the CellData items whose moments are output. */
+    std::vector<std::string> mCellDataItemNames;
+
+    /** Whether to output the moments of the cell volume. Defaults to false. */
+    bool mOutputCellVolumeMoments;
+
+    /** The number of bins in the radial density profile, or zero for no profile. Defaults to zero. */
+    unsigned mNumRadialBins;
+
+    /**
+     * The largest number of neighbours with its own bin in the neighbour histogram (cells with
+     * more neighbours are counted in the last bin), or UNSIGNED_UNSET for no neighbour
+     * statistics. Defaults to UNSIGNED_UNSET.
+     */
+    unsigned mMaxNumNeighboursInHistogram;
+
+    /** Results file for the statistics (only open on the master process). */
+    out_stream mpStatisticsFile;
+
+    /**
+     * Write the header line of the results file, naming each column.
+     */
+    void WriteHeader();
+
+    /**
+     * Compute the enabled statistics over the whole population by reducing the
+     * contributions of each process, and (on the master process) write them to file.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    void WriteStatistics(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+public:
+
+    /**
+     * Default constructor.
+     */
+    CellPopulationStatisticsModifier();
+
+    /**
+     * Destructor.
+     */
+    virtual ~CellPopulationStatisticsModifier();
+
+    /**
+     * Overridden UpdateAtEndOfTimeStep() method.
+     *
+     * Specify what to do in the simulation at the end of each time step.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Overridden UpdateAtEndOfOutputTimeStep() method.
+     *
+     * Compute and write the statistics.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void UpdateAtEndOfOutputTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Overridden SetupSolve() method.
+     *
+     * Open the results file and write the statistics of the initial population.
+     *
+     * @param rCellPopulation reference to the cell population
+     * @param outputDirectory the output directory, relative to where Chaste output is stored
+     */
+    virtual void SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory);
+
+    /**
+     * Overridden UpdateAtEndOfSolve() method.
+     *
+     * Close the results file.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void UpdateAtEndOfSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Set whether to output the number of cells of each default proliferative type.
+     *
+     * @param outputProliferativeTypeCounts the new value of mOutputProliferativeTypeCounts
+     */
+    void SetOutputProliferativeTypeCounts(bool outputProliferativeTypeCounts);
+
+    /**
+     * @return mOutputProliferativeTypeCounts
+     */
+    bool GetOutputProliferativeTypeCounts() const;
+
+    /**
+     * Output the mean, standard deviation, minimum and maximum of a CellData item.
+     * Every cell must store the item.
+     *
+     * @param rItemName the name of the CellData item
+     */
+    void AddCellDataItemMoments(const std::string& rItemName);
+
+    /**
+     * @return mCellDataItemNames
+     */
+    const std::vector<std::string>& rGetCellDataItemNames() const;
+
+    /**
+     * Set whether to output the mean, standard deviation, minimum and maximum of the cell volume.
+     *
+     * @param outputCellVolumeMoments the new value of mOutputCellVolumeMoments
+     */
+    void SetOutputCellVolumeMoments(bool outputCellVolumeMoments);
+
+    /**
+     * @return mOutputCellVolumeMoments
+     */
+    bool GetOutputCellVolumeMoments() const;
+
+    /**
+     * Set the number of bins in the radial density profile. The bins are of equal width and
+     * extend from the centroid of the population to the cell centre furthest from it; for
+     * each bin its outer radius and the number of cells per unit length, area or volume
+     * are output.
+     *
+     * @param numRadialBins the new value of mNumRadialBins (zero for no profile)
+     */
+    void SetNumRadialBins(unsigned numRadialBins);
+
+    /**
+     * @return mNumRadialBins
+     */
+    unsigned GetNumRadialBins() const;
+
+    /**
+     * Output the mean number of neighbours of each cell, and the number of cells with
+     * 0, 1, ..., maxNumNeighbours neighbours (the last bin also counting cells with more).
+     *
+     * @param maxNumNeighbours the largest number of neighbours with its own bin
+     */
+    void SetMaxNumNeighboursInHistogram(unsigned maxNumNeighbours);
+
+    /**
+     * @return mMaxNumNeighboursInHistogram
+     */
+    unsigned GetMaxNumNeighboursInHistogram() const;
+
+    /**
+     * Overridden OutputSimulationModifierParameters() method.
+     * Output any simulation modifier parameters to file.
+     *
+     * @param rParamsFile the file stream to which the parameters are output
+     */
+    void OutputSimulationModifierParameters(out_stream& rParamsFile);
+};
+
+#include "SerializationExportWrapper.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(CellPopulationStatisticsModifier)
+
+#endif /*CELLPOPULATIONSTATISTICSMODIFIER_HPP_*/
@@ -34,6 +34,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "AbstractNumericalMethod.hpp"
+#include "Exception.hpp"
 #include "StepSizeException.hpp"
 #include "Warnings.hpp"
 #include "AbstractCentreBasedCellPopulation.hpp"
@@ -47,7 +48,8 @@ AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM>::AbstractNumericalMethod()
       mpForceCollection(nullptr),
       mUseAdaptiveTimestep(false),
       mUseUpdateNodeLocation(false),
-      mGhostNodeForcesEnabled(true)
+      mGhostNodeForcesEnabled(true),
+      mNumThreads(1u)
 {
     // mpCellPopulation and mpForceCollection are initialized by the OffLatticeSimulation constructor
 }
@@ -97,6 +99,22 @@ bool AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM>::HasAdaptiveTimestep()
     return mUseAdaptiveTimestep;
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM>::SetNumberOfThreads(unsigned numThreads)
+{
+    if (numThreads == 0u)
+    {
+        EXCEPTION("The number of numerical method threads must be at least one.");
+    }
+    mNumThreads = numThreads;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM>::GetNumberOfThreads() const
+{
+    return mNumThreads;
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 std::vector<c_vector<double, SPACE_DIM> > AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM>::ComputeForcesIncludingDamping()
 {
@@ -125,15 +143,30 @@ std::vector<c_vector<double, SPACE_DIM> > AbstractNumericalMethod<ELEMENT_DIM,SP
         dynamic_cast<MeshBasedCellPopulationWithGhostNodes<SPACE_DIM>*>(mpCellPopulation)->ApplyGhostForces();
     }
 
-    // Store applied forces in a vector
+    /*
+     * Store applied forces in a vector. The damping constants come from the cells
+     * (they may depend on mutation state), so they are looked up serially first;
+     * the division is then a simple loop over contiguous arrays.
+     */
     std::vector<c_vector<double, SPACE_DIM> > forces_as_vector;
+    std::vector<double> damping_constants;
     forces_as_vector.reserve(mpCellPopulation->GetNumNodes());
+    damping_constants.reserve(mpCellPopulation->GetNumNodes());
 
     for (typename AbstractMesh<ELEMENT_DIM, SPACE_DIM>::NodeIterator node_iter = mpCellPopulation->rGetMesh().GetNodeIteratorBegin();
          node_iter != mpCellPopulation->rGetMesh().GetNodeIteratorEnd(); ++node_iter)
     {
-        double damping = mpCellPopulation->GetDampingConstant(node_iter->GetIndex());
-        forces_as_vector.push_back(node_iter->rGetAppliedForce()/damping);
+        damping_constants.push_back(mpCellPopulation->GetDampingConstant(node_iter->GetIndex()));
+        forces_as_vector.push_back(node_iter->rGetAppliedForce());
+    }
+
+    const int num_nodes = static_cast<int>(forces_as_vector.size());
+#ifdef CHASTE_OPENMP
+#pragma omp parallel for schedule(static) num_threads(mNumThreads) if(mNumThreads > 1u)
+#endif // CHASTE_OPENMP
+    for (int i = 0; i < num_nodes; i++)
+    {
+        forces_as_vector[i] /= damping_constants[i];
     }
 
     CellBasedEventHandler::EndEvent(CellBasedEventHandler::FORCE);
@@ -164,6 +197,42 @@ void AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM>::SafeNodePositionUpdate( uns
     mpCellPopulation->SetNode(nodeIndex, new_point);
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM>::SetAllNodeLocations(const std::vector<c_vector<double, SPACE_DIM> >& rLocations)
+{
+    unsigned index = 0;
+    for (typename AbstractMesh<ELEMENT_DIM, SPACE_DIM>::NodeIterator node_iter = mpCellPopulation->rGetMesh().GetNodeIteratorBegin();
+         node_iter != mpCellPopulation->rGetMesh().GetNodeIteratorEnd();
+         ++node_iter, ++index)
+    {
+        SafeNodePositionUpdate(node_iter->GetIndex(), rLocations[index]);
+    }
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+double AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM>::CalculateNextTimeStep(double currentTimeStep)
+{
+    ///\todo #2087 Make this a settable member variable
+    double timestep_increase = 0.01;
+    return (1+timestep_increase)*currentTimeStep;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM>::InvalidateResidentNodeLocations()
+{
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM>::SynchroniseNodeLocations()
+{
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM>::UsesOwnNodePairs()
+{
+    return false;
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM>::DetectStepSizeExceptions(unsigned nodeIndex, c_vector<double,SPACE_DIM>& displacement, double dt)
 {
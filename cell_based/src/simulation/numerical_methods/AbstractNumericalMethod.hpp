@@ -106,6 +106,13 @@ protected:
      */
     bool mGhostNodeForcesEnabled;
 
+    /**
+     * Number of shared-memory threads over which the per-node arithmetic of a
+     * time step is shared out. Not archived, since it is a property of the run.
+     * Defaults to 1.
+     */
+    unsigned mNumThreads;
+
     /**
      * Computes and returns the force on each node, including the damping factor
      * @return A vector of applied forces
@@ -126,6 +133,13 @@ protected:
      */
      void SafeNodePositionUpdate(unsigned nodeIndex, c_vector<double, SPACE_DIM> newPosition);
 
+    /**
+     * Moves every node to a given location, using SafeNodePositionUpdate().
+     *
+     * @param rLocations the new location of each node, in the order of the mesh's node iterator
+     */
+    void SetAllNodeLocations(const std::vector<c_vector<double, SPACE_DIM> >& rLocations);
+
     /**
      * Detects whether a node has exceeded the acceptable displacement for one timestep.
      * If a step size exception has occurred, it either causes the simulation to terminate or,
@@ -192,6 +206,20 @@ public:
      */
     bool HasAdaptiveTimestep();
 
+    /**
+     * Set the number of shared-memory threads used for the per-node arithmetic of
+     * each time step, such as dividing the forces by the damping constants. Has no
+     * effect unless Chaste is built with OpenMP support.
+     *
+     * @param numThreads the number of threads (must be at least one)
+     */
+    void SetNumberOfThreads(unsigned numThreads);
+
+    /**
+     * @return the number of threads used for the per-node arithmetic of each time step.
+     */
+    unsigned GetNumberOfThreads() const;
+
     /**
      * Updates node positions according to Newton's 2nd law with overdamping.
      *
@@ -202,6 +230,39 @@ public:
      */
     virtual void UpdateAllNodePositions(double dt)=0;
 
+    /**
+     * Suggest the time step to try next, after a successful step with an
+     * adaptive time step. By default this increases the step by 1%; methods
+     * with an error estimate may override this to grow the step faster.
+     *
+     * @param currentTimeStep the step that has just been taken successfully
+     * @return the suggested next time step.
+     */
+    virtual double CalculateNextTimeStep(double currentTimeStep);
+
+    /**
+     * Tell the numerical method that node locations have been changed by code
+     * other than UpdateAllNodePositions(), so that any copies of them it keeps
+     * between steps must be refreshed. By default this does nothing.
+     */
+    virtual void InvalidateResidentNodeLocations();
+
+    /**
+     * Copy any node locations that the numerical method keeps between steps, and
+     * that are newer than those of the nodes, to the nodes. Must be called before
+     * anything other than the numerical method reads the node locations. By
+     * default this does nothing.
+     */
+    virtual void SynchroniseNodeLocations();
+
+    /**
+     * @return whether the last call to UpdateAllNodePositions() found the
+     * interacting pairs of nodes itself and evaluated every force without the
+     * cell population's node pairs, so that the population need not recalculate
+     * them before the next step. By default false.
+     */
+    virtual bool UsesOwnNodePairs();
+
     /**
      * Saves the name of the numerical method to the parameters file
      *
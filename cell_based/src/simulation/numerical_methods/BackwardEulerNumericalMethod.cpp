@@ -0,0 +1,519 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include <algorithm>
+#include <cfloat>
+#include <climits>
+#include <cmath>
+#include <sstream>
+
+#include "BackwardEulerNumericalMethod.hpp"
+#include "CellBasedEventHandler.hpp"
+#include "Exception.hpp"
+#include "MeshBasedCellPopulationWithGhostNodes.hpp"
+#include "StepSizeException.hpp"
+#include "UblasCustomFunctions.hpp"
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+BackwardEulerNumericalMethod<ELEMENT_DIM,SPACE_DIM>::BackwardEulerNumericalMethod()
+    : AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM>(),
+      mNewtonTolerance(1e-8),
+      mMaxNewtonIterations(20),
+      mLinearSolverTolerance(1e-10),
+      mMaxLinearSolverIterations(200),
+      mLastNumNewtonIterations(0)
+{
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+BackwardEulerNumericalMethod<ELEMENT_DIM,SPACE_DIM>::~BackwardEulerNumericalMethod()
+{
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+std::vector<double> BackwardEulerNumericalMethod<ELEMENT_DIM,SPACE_DIM>::SolveLinearSystem(const std::vector<unsigned>& rRowOffsets,
+                                                                                          const std::vector<unsigned>& rColumns,
+                                                                                          const std::vector<c_matrix<double, SPACE_DIM, SPACE_DIM> >& rBlocks,
+                                                                                          const std::vector<unsigned>& rDiagonalPositions,
+                                                                                          const std::vector<double>& rRhs)
+{
+    unsigned num_rows = rDiagonalPositions.size();
+    unsigned size = rRhs.size();
+    std::vector<double> solution(size, 0.0);
+
+    double beta = 0.0;
+    for (unsigned k=0; k<size; k++)
+    {
+        beta += rRhs[k]*rRhs[k];
+    }
+    beta = sqrt(beta);
+    if (beta == 0.0)
+    {
+        return solution;
+    }
+
+    // The preconditioner is the inverse of the diagonal blocks
+    std::vector<c_matrix<double, SPACE_DIM, SPACE_DIM> > inverse_diagonal_blocks(num_rows);
+    for (unsigned row=0; row<num_rows; row++)
+    {
+        const c_matrix<double, SPACE_DIM, SPACE_DIM>& r_diagonal_block = rBlocks[rDiagonalPositions[row]];
+        if (fabs(Determinant(r_diagonal_block)) > DBL_EPSILON)
+        {
+            inverse_diagonal_blocks[row] = Inverse(r_diagonal_block);
+        }
+        else
+        {
+            inverse_diagonal_blocks[row] = identity_matrix<double>(SPACE_DIM);
+        }
+    }
+
+    // Krylov basis, Hessenberg matrix (stored by column), Givens rotations and the rotated residual, starting from zero
+    unsigned max_iterations = std::min(mMaxLinearSolverIterations, size);
+    std::vector<std::vector<double> > basis(1, rRhs);
+    for (unsigned k=0; k<size; k++)
+    {
+        basis[0][k] /= beta;
+    }
+    std::vector<std::vector<double> > hessenberg;
+    std::vector<double> cosines;
+    std::vector<double> sines;
+    std::vector<double> g(1, beta);
+    unsigned num_iterations = 0;
+
+    for (unsigned j=0; j<max_iterations; j++)
+    {
+        // Apply the preconditioned matrix A M^{-1} to the latest basis vector
+        std::vector<double> w(size, 0.0);
+        for (unsigned row=0; row<num_rows; row++)
+        {
+            c_vector<double, SPACE_DIM> result = zero_vector<double>(SPACE_DIM);
+            for (unsigned entry=rRowOffsets[row]; entry<rRowOffsets[row+1]; entry++)
+            {
+                unsigned column = rColumns[entry];
+                c_vector<double, SPACE_DIM> v;
+                for (unsigned d=0; d<SPACE_DIM; d++)
+                {
+                    v[d] = basis[j][SPACE_DIM*column + d];
+                }
+                result += prod(rBlocks[entry], c_vector<double, SPACE_DIM>(prod(inverse_diagonal_blocks[column], v)));
+            }
+            for (unsigned d=0; d<SPACE_DIM; d++)
+            {
+                w[SPACE_DIM*row + d] = result[d];
+            }
+        }
+
+        // Modified Gram-Schmidt
+        std::vector<double> h(j+2, 0.0);
+        for (unsigned i=0; i<=j; i++)
+        {
+            for (unsigned k=0; k<size; k++)
+            {
+                h[i] += w[k]*basis[i][k];
+            }
+            for (unsigned k=0; k<size; k++)
+            {
+                w[k] -= h[i]*basis[i][k];
+            }
+        }
+        for (unsigned k=0; k<size; k++)
+        {
+            h[j+1] += w[k]*w[k];
+        }
+        h[j+1] = sqrt(h[j+1]);
+
+        bool breakdown = (h[j+1] == 0.0);
+        if (!breakdown)
+        {
+            for (unsigned k=0; k<size; k++)
+            {
+                w[k] /= h[j+1];
+            }
+            basis.push_back(w);
+        }
+
+        // Apply the previous rotations to the new column, then eliminate its subdiagonal entry
+        for (unsigned i=0; i<j; i++)
+        {
+            double temp = cosines[i]*h[i] + sines[i]*h[i+1];
+            h[i+1] = -sines[i]*h[i] + cosines[i]*h[i+1];
+            h[i] = temp;
+        }
+        double denominator = sqrt(h[j]*h[j] + h[j+1]*h[j+1]);
+        cosines.push_back(h[j]/denominator);
+        sines.push_back(h[j+1]/denominator);
+        h[j] = denominator;
+        h[j+1] = 0.0;
+        g.push_back(-sines[j]*g[j]);
+        g[j] *= cosines[j];
+        hessenberg.push_back(h);
+
+        num_iterations = j+1;
+        if (breakdown || fabs(g[j+1]) <= mLinearSolverTolerance*beta)
+        {
+            break;
+        }
+    }
+
+    // Back substitution for the coefficients of the minimal-residual update
+    std::vector<double> y(num_iterations);
+    for (unsigned i=num_iterations; i-- > 0; )
+    {
+        y[i] = g[i];
+        for (unsigned l=i+1; l<num_iterations; l++)
+        {
+            y[i] -= hessenberg[l][i]*y[l];
+        }
+        y[i] /= hessenberg[i][i];
+    }
+    std::vector<double> preconditioned_solution(size, 0.0);
+    for (unsigned i=0; i<num_iterations; i++)
+    {
+        for (unsigned k=0; k<size; k++)
+        {
+            preconditioned_solution[k] += y[i]*basis[i][k];
+        }
+    }
+
+    // Undo the preconditioning
+    for (unsigned row=0; row<num_rows; row++)
+    {
+        c_vector<double, SPACE_DIM> v;
+        for (unsigned d=0; d<SPACE_DIM; d++)
+        {
+            v[d] = preconditioned_solution[SPACE_DIM*row + d];
+        }
+        c_vector<double, SPACE_DIM> x = prod(inverse_diagonal_blocks[row], v);
+        for (unsigned d=0; d<SPACE_DIM; d++)
+        {
+            solution[SPACE_DIM*row + d] = x[d];
+        }
+    }
+    return solution;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void BackwardEulerNumericalMethod<ELEMENT_DIM,SPACE_DIM>::UpdateAllNodePositions(double dt)
+{
+    if (!this->mUseUpdateNodeLocation)
+    {
+        AbstractMesh<ELEMENT_DIM, SPACE_DIM>& r_mesh = this->mpCellPopulation->rGetMesh();
+        std::vector<c_vector<double, SPACE_DIM> > initial_locations = this->SaveCurrentLocations();
+        unsigned num_nodes = initial_locations.size();
+        unsigned size = SPACE_DIM*num_nodes;
+
+        // The unknowns are ordered as the node iterator, so map global node indices to positions in this order
+        std::vector<unsigned> node_indices;
+        node_indices.reserve(num_nodes);
+        unsigned max_node_index = 0;
+        for (typename AbstractMesh<ELEMENT_DIM, SPACE_DIM>::NodeIterator node_iter = r_mesh.GetNodeIteratorBegin();
+             node_iter != r_mesh.GetNodeIteratorEnd();
+             ++node_iter)
+        {
+            node_indices.push_back(node_iter->GetIndex());
+            max_node_index = std::max(max_node_index, node_iter->GetIndex());
+        }
+        std::vector<unsigned> positions(max_node_index + 1, UINT_MAX);
+        std::vector<double> damping_constants(num_nodes);
+        for (unsigned p=0; p<num_nodes; p++)
+        {
+            positions[node_indices[p]] = p;
+            damping_constants[p] = this->mpCellPopulation->GetDampingConstant(node_indices[p]);
+        }
+
+        std::vector<boost::shared_ptr<AbstractForce<ELEMENT_DIM, SPACE_DIM> > >& r_forces = *(this->mpForceCollection);
+        std::vector<std::map<unsigned, c_matrix<double, SPACE_DIM, SPACE_DIM> > > jacobian(max_node_index + 1);
+
+        CellBasedEventHandler::BeginEvent(CellBasedEventHandler::FORCE);
+
+        // Forces that provide a Jacobian are treated implicitly
+        std::vector<bool> is_implicit(r_forces.size());
+        for (unsigned i=0; i<r_forces.size(); i++)
+        {
+            is_implicit[i] = r_forces[i]->AddForceJacobianContribution(*(this->mpCellPopulation), jacobian);
+        }
+
+        // The remaining forces, and any forces on ghost nodes, are evaluated once at r_n
+        for (typename AbstractMesh<ELEMENT_DIM, SPACE_DIM>::NodeIterator node_iter = r_mesh.GetNodeIteratorBegin();
+             node_iter != r_mesh.GetNodeIteratorEnd();
+             ++node_iter)
+        {
+            node_iter->ClearAppliedForce();
+        }
+        for (unsigned i=0; i<r_forces.size(); i++)
+        {
+            if (!is_implicit[i])
+            {
+                r_forces[i]->AddForceContribution(*(this->mpCellPopulation));
+            }
+        }
+        if (this->mGhostNodeForcesEnabled)
+        {
+            dynamic_cast<MeshBasedCellPopulationWithGhostNodes<SPACE_DIM>*>(this->mpCellPopulation)->ApplyGhostForces();
+        }
+        std::vector<c_vector<double, SPACE_DIM> > explicit_forces(num_nodes);
+        for (unsigned p=0; p<num_nodes; p++)
+        {
+            explicit_forces[p] = r_mesh.GetNode(node_indices[p])->rGetAppliedForce();
+        }
+
+        CellBasedEventHandler::EndEvent(CellBasedEventHandler::FORCE);
+
+        std::vector<c_vector<double, SPACE_DIM> > locations(initial_locations);
+        bool converged = false;
+        mLastNumNewtonIterations = 0;
+        for (unsigned iteration=0; ; iteration++)
+        {
+            CellBasedEventHandler::BeginEvent(CellBasedEventHandler::FORCE);
+
+            // Evaluate the implicit forces, and their Jacobian unless it was found above, at the current iterate
+            if (iteration > 0)
+            {
+                jacobian.assign(max_node_index + 1, std::map<unsigned, c_matrix<double, SPACE_DIM, SPACE_DIM> >());
+            }
+            for (typename AbstractMesh<ELEMENT_DIM, SPACE_DIM>::NodeIterator node_iter = r_mesh.GetNodeIteratorBegin();
+                 node_iter != r_mesh.GetNodeIteratorEnd();
+                 ++node_iter)
+            {
+                node_iter->ClearAppliedForce();
+            }
+            for (unsigned i=0; i<r_forces.size(); i++)
+            {
+                if (is_implicit[i])
+                {
+                    r_forces[i]->AddForceContribution(*(this->mpCellPopulation));
+                    if (iteration > 0)
+                    {
+                        r_forces[i]->AddForceJacobianContribution(*(this->mpCellPopulation), jacobian);
+                    }
+                }
+            }
+
+            CellBasedEventHandler::EndEvent(CellBasedEventHandler::FORCE);
+
+            // The residual r - r_n - dt F(r), whose largest component is measured against the tolerance
+            std::vector<double> rhs(size);
+            double residual_norm = 0.0;
+            for (unsigned p=0; p<num_nodes; p++)
+            {
+                const c_vector<double, SPACE_DIM>& r_implicit_force = r_mesh.GetNode(node_indices[p])->rGetAppliedForce();
+                for (unsigned d=0; d<SPACE_DIM; d++)
+                {
+                    double residual = locations[p][d] - initial_locations[p][d]
+                                      - dt*(r_implicit_force[d] + explicit_forces[p][d])/damping_constants[p];
+                    rhs[SPACE_DIM*p + d] = -residual;
+                    residual_norm = std::max(residual_norm, fabs(residual));
+                }
+            }
+            if (residual_norm <= mNewtonTolerance)
+            {
+                converged = true;
+                break;
+            }
+            if (iteration == mMaxNewtonIterations)
+            {
+                break;
+            }
+
+            // Assemble I - dt D^{-1} J, where D holds the damping constants, in block compressed sparse row format
+            std::vector<unsigned> row_offsets(num_nodes + 1);
+            std::vector<unsigned> columns;
+            std::vector<c_matrix<double, SPACE_DIM, SPACE_DIM> > blocks;
+            std::vector<unsigned> diagonal_positions(num_nodes);
+            for (unsigned p=0; p<num_nodes; p++)
+            {
+                std::map<unsigned, c_matrix<double, SPACE_DIM, SPACE_DIM> >& r_row = jacobian[node_indices[p]];
+                r_row.insert(std::make_pair(node_indices[p], c_matrix<double, SPACE_DIM, SPACE_DIM>(zero_matrix<double>(SPACE_DIM, SPACE_DIM))));
+
+                row_offsets[p] = columns.size();
+                for (typename std::map<unsigned, c_matrix<double, SPACE_DIM, SPACE_DIM> >::const_iterator it = r_row.begin();
+                     it != r_row.end();
+                     ++it)
+                {
+                    assert(it->first < positions.size() && positions[it->first] != UINT_MAX);
+                    c_matrix<double, SPACE_DIM, SPACE_DIM> block = -dt*it->second/damping_constants[p];
+                    if (it->first == node_indices[p])
+                    {
+                        block += identity_matrix<double>(SPACE_DIM);
+                        diagonal_positions[p] = columns.size();
+                    }
+                    columns.push_back(positions[it->first]);
+                    blocks.push_back(block);
+                }
+            }
+            row_offsets[num_nodes] = columns.size();
+
+            std::vector<double> delta = SolveLinearSystem(row_offsets, columns, blocks, diagonal_positions, rhs);
+            for (unsigned p=0; p<num_nodes; p++)
+            {
+                for (unsigned d=0; d<SPACE_DIM; d++)
+                {
+                    locations[p][d] += delta[SPACE_DIM*p + d];
+                }
+            }
+            this->SetAllNodeLocations(locations);
+            mLastNumNewtonIterations = iteration + 1;
+        }
+
+        // Leave the nodes where they started, so that the update below sees the original locations
+        this->SetAllNodeLocations(initial_locations);
+
+        if (!converged)
+        {
+            std::stringstream message;
+            message << "Newton iteration in BackwardEulerNumericalMethod did not converge in " << mMaxNewtonIterations << " iterations";
+            if (this->mUseAdaptiveTimestep)
+            {
+                throw StepSizeException(0.5*dt, message.str(), false);
+            }
+            EXCEPTION(message.str());
+        }
+
+        for (unsigned p=0; p<num_nodes; p++)
+        {
+            c_vector<double, SPACE_DIM> displacement = locations[p] - initial_locations[p];
+
+            // In the vertex-based case, the displacement may be scaled if the cell rearrangement threshold is exceeded
+            this->DetectStepSizeExceptions(node_indices[p], displacement, dt);
+
+            c_vector<double, SPACE_DIM> new_location = initial_locations[p] + displacement;
+            this->SafeNodePositionUpdate(node_indices[p], new_location);
+        }
+    }
+    else
+    {
+        /*
+         * If this type of cell population does not support the new numerical methods, delegate
+         * updating node positions to the population itself.
+         *
+         * This only applies to NodeBasedCellPopulationWithBuskeUpdates.
+         */
+        this->mpCellPopulation->UpdateNodeLocations(dt);
+    }
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+double BackwardEulerNumericalMethod<ELEMENT_DIM,SPACE_DIM>::GetNewtonTolerance()
+{
+    return mNewtonTolerance;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void BackwardEulerNumericalMethod<ELEMENT_DIM,SPACE_DIM>::SetNewtonTolerance(double newtonTolerance)
+{
+    if (newtonTolerance <= 0.0)
+    {
+        EXCEPTION("The Newton tolerance must be positive");
+    }
+    mNewtonTolerance = newtonTolerance;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned BackwardEulerNumericalMethod<ELEMENT_DIM,SPACE_DIM>::GetMaxNewtonIterations()
+{
+    return mMaxNewtonIterations;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void BackwardEulerNumericalMethod<ELEMENT_DIM,SPACE_DIM>::SetMaxNewtonIterations(unsigned maxNewtonIterations)
+{
+    if (maxNewtonIterations == 0)
+    {
+        EXCEPTION("The maximum number of Newton iterations must be positive");
+    }
+    mMaxNewtonIterations = maxNewtonIterations;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+double BackwardEulerNumericalMethod<ELEMENT_DIM,SPACE_DIM>::GetLinearSolverTolerance()
+{
+    return mLinearSolverTolerance;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void BackwardEulerNumericalMethod<ELEMENT_DIM,SPACE_DIM>::SetLinearSolverTolerance(double linearSolverTolerance)
+{
+    if (linearSolverTolerance <= 0.0)
+    {
+        EXCEPTION("The linear solver tolerance must be positive");
+    }
+    mLinearSolverTolerance = linearSolverTolerance;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned BackwardEulerNumericalMethod<ELEMENT_DIM,SPACE_DIM>::GetMaxLinearSolverIterations()
+{
+    return mMaxLinearSolverIterations;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void BackwardEulerNumericalMethod<ELEMENT_DIM,SPACE_DIM>::SetMaxLinearSolverIterations(unsigned maxLinearSolverIterations)
+{
+    if (maxLinearSolverIterations == 0)
+    {
+        EXCEPTION("The maximum number of linear solver iterations must be positive");
+    }
+    mMaxLinearSolverIterations = maxLinearSolverIterations;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned BackwardEulerNumericalMethod<ELEMENT_DIM,SPACE_DIM>::GetLastNumNewtonIterations()
+{
+    return mLastNumNewtonIterations;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void BackwardEulerNumericalMethod<ELEMENT_DIM, SPACE_DIM>::OutputNumericalMethodParameters(out_stream& rParamsFile)
+{
+    *rParamsFile << "\t\t\t<NewtonTolerance>" << mNewtonTolerance << "</NewtonTolerance> \n";
+    *rParamsFile << "\t\t\t<MaxNewtonIterations>" << mMaxNewtonIterations << "</MaxNewtonIterations> \n";
+    *rParamsFile << "\t\t\t<LinearSolverTolerance>" << mLinearSolverTolerance << "</LinearSolverTolerance> \n";
+    *rParamsFile << "\t\t\t<MaxLinearSolverIterations>" << mMaxLinearSolverIterations << "</MaxLinearSolverIterations> \n";
+
+    // Call method on direct parent class
+    AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM>::OutputNumericalMethodParameters(rParamsFile);
+}
+
+// Explicit instantiation
+template class BackwardEulerNumericalMethod<1,1>;
+template class BackwardEulerNumericalMethod<1,2>;
+template class BackwardEulerNumericalMethod<2,2>;
+template class BackwardEulerNumericalMethod<1,3>;
+template class BackwardEulerNumericalMethod<2,3>;
+template class BackwardEulerNumericalMethod<3,3>;
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapperForCpp.hpp"
+EXPORT_TEMPLATE_CLASS_ALL_DIMS(BackwardEulerNumericalMethod)
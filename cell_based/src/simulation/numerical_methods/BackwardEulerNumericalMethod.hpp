@@ -0,0 +1,215 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef BACKWARDEULERNUMERICALMETHOD_HPP_
+#define BACKWARDEULERNUMERICALMETHOD_HPP_
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+
+#include "AbstractNumericalMethod.hpp"
+
+/**
+ * A backward Euler numerical method for the update of node positions, suitable for
+ * stiff force laws such as the area constraints of NagaiHondaForce and FarhadifarForce.
+ *
+ * Writing the equations of motion as dr/dt = F(r), each step solves
+ *
+ *     r_{n+1} - r_n - dt F(r_{n+1}) = 0
+ *
+ * by Newton's method, starting from r_n. Forces that provide an analytic Jacobian
+ * through AbstractForce::AddForceJacobianContribution() are treated implicitly in
+ * this way; any other forces are evaluated once at r_n and treated explicitly, so
+ * the method is semi-implicit when such forces are present. The Jacobian is stored
+ * in blocks following the coupling between nodes (for a vertex-based population,
+ * nodes that share an element), and each Newton update is found by GMRES with
+ * block-Jacobi preconditioning.
+ *
+ * If the Newton iteration does not converge, the nodes are returned to r_n and, with
+ * an adaptive time step, a smaller step is requested through a StepSizeException.
+ */
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM=ELEMENT_DIM>
+class BackwardEulerNumericalMethod : public AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM> {
+
+private:
+
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Save or restore the simulation.
+     *
+     * @param archive the archive
+     * @param version the current version of this class
+     */
+    template <class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM> >(*this);
+        archive & mNewtonTolerance;
+        archive & mMaxNewtonIterations;
+        archive & mLinearSolverTolerance;
+        archive & mMaxLinearSolverIterations;
+    }
+
+    /**
+     * Tolerance on the largest component of the backward Euler residual, which has
+     * units of length. Defaults to 1e-8.
+     */
+    double mNewtonTolerance;
+
+    /**
+     * Maximum number of Newton iterations in each step.
+     * Defaults to 20.
+     */
+    unsigned mMaxNewtonIterations;
+
+    /**
+     * Relative residual tolerance for the GMRES solve in each Newton iteration.
+     * Defaults to 1e-10.
+     */
+    double mLinearSolverTolerance;
+
+    /**
+     * Maximum number of GMRES iterations in each Newton iteration. If the tolerance
+     * has not been met by then, the minimal-residual iterate is used.
+     * Defaults to 200.
+     */
+    unsigned mMaxLinearSolverIterations;
+
+    /** The number of Newton iterations used in the most recent step. */
+    unsigned mLastNumNewtonIterations;
+
+    /**
+     * Solve a linear system whose matrix is stored in compressed sparse row format with
+     * SPACE_DIM by SPACE_DIM blocks, by GMRES with block-Jacobi right preconditioning.
+     *
+     * @param rRowOffsets the offset of the first block of each block row, with a final entry giving the number of blocks
+     * @param rColumns the block column of each block
+     * @param rBlocks the blocks
+     * @param rDiagonalPositions the position in rBlocks of the diagonal block of each block row
+     * @param rRhs the right-hand side, flattened node by node
+     * @return the solution, flattened node by node.
+     */
+    std::vector<double> SolveLinearSystem(const std::vector<unsigned>& rRowOffsets,
+                                          const std::vector<unsigned>& rColumns,
+                                          const std::vector<c_matrix<double, SPACE_DIM, SPACE_DIM> >& rBlocks,
+                                          const std::vector<unsigned>& rDiagonalPositions,
+                                          const std::vector<double>& rRhs);
+
+public:
+
+    /**
+     * Constructor.
+     */
+    BackwardEulerNumericalMethod();
+
+    /**
+     * Destructor.
+     */
+    virtual ~BackwardEulerNumericalMethod();
+
+    /**
+     * Overridden UpdateAllNodePositions() method.
+     *
+     * @param dt Time step size
+     */
+    void UpdateAllNodePositions(double dt);
+
+    /**
+     * @return mNewtonTolerance
+     */
+    double GetNewtonTolerance();
+
+    /**
+     * Set mNewtonTolerance.
+     *
+     * @param newtonTolerance the new value of mNewtonTolerance
+     */
+    void SetNewtonTolerance(double newtonTolerance);
+
+    /**
+     * @return mMaxNewtonIterations
+     */
+    unsigned GetMaxNewtonIterations();
+
+    /**
+     * Set mMaxNewtonIterations.
+     *
+     * @param maxNewtonIterations the new value of mMaxNewtonIterations
+     */
+    void SetMaxNewtonIterations(unsigned maxNewtonIterations);
+
+    /**
+     * @return mLinearSolverTolerance
+     */
+    double GetLinearSolverTolerance();
+
+    /**
+     * Set mLinearSolverTolerance.
+     *
+     * @param linearSolverTolerance the new value of mLinearSolverTolerance
+     */
+    void SetLinearSolverTolerance(double linearSolverTolerance);
+
+    /**
+     * @return mMaxLinearSolverIterations
+     */
+    unsigned GetMaxLinearSolverIterations();
+
+    /**
+     * Set mMaxLinearSolverIterations.
+     *
+     * @param maxLinearSolverIterations the new value of mMaxLinearSolverIterations
+     */
+    void SetMaxLinearSolverIterations(unsigned maxLinearSolverIterations);
+
+    /**
+     * @return the number of Newton iterations used in the most recent step.
+     */
+    unsigned GetLastNumNewtonIterations();
+
+    /**
+     * Overridden OutputNumericalMethodParameters() method.
+     *
+     * @param rParamsFile Reference to the parameter output filestream
+     */
+    virtual void OutputNumericalMethodParameters(out_stream& rParamsFile);
+};
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapper.hpp"
+EXPORT_TEMPLATE_CLASS_ALL_DIMS(BackwardEulerNumericalMethod)
+
+#endif /*BACKWARDEULERNUMERICALMETHOD_HPP_*/
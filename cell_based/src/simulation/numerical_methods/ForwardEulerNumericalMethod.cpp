@@ -35,9 +35,19 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "ForwardEulerNumericalMethod.hpp"
 
+#include <algorithm>
+
+#include "AbstractCentreBasedCellPopulation.hpp"
+#include "CellBasedEventHandler.hpp"
+#include "NodeBasedCellPopulation.hpp"
+#include "PeriodicNodesOnlyMesh.hpp"
+#include "PetscTools.hpp"
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 ForwardEulerNumericalMethod<ELEMENT_DIM,SPACE_DIM>::ForwardEulerNumericalMethod()
-    : AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM>()
+    : AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM>(),
+      mNodesAreBehindBackend(false),
+      mAllForcesOnBackend(false)
 {
 }
 
@@ -46,28 +56,193 @@ ForwardEulerNumericalMethod<ELEMENT_DIM,SPACE_DIM>::~ForwardEulerNumericalMethod
 {
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool ForwardEulerNumericalMethod<ELEMENT_DIM,SPACE_DIM>::CanUseBackend()
+{
+    if (!mpBackend || !PetscTools::IsSequential())
+    {
+        return false;
+    }
+    NodeBasedCellPopulation<SPACE_DIM>* p_population = dynamic_cast<NodeBasedCellPopulation<SPACE_DIM>*>(this->mpCellPopulation);
+    return p_population != nullptr
+           && dynamic_cast<PeriodicNodesOnlyMesh<SPACE_DIM>*>(&(p_population->rGetMesh())) == nullptr;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void ForwardEulerNumericalMethod<ELEMENT_DIM,SPACE_DIM>::UpdateAllNodePositionsOnBackend(double dt)
+{
+    NodeBasedCellPopulation<SPACE_DIM>* p_population = dynamic_cast<NodeBasedCellPopulation<SPACE_DIM>*>(this->mpCellPopulation);
+    assert(p_population != nullptr);
+
+    std::vector<Node<SPACE_DIM>*> nodes;
+    std::vector<unsigned> node_indices;
+    nodes.reserve(p_population->GetNumNodes());
+    node_indices.reserve(p_population->GetNumNodes());
+    for (typename AbstractMesh<SPACE_DIM, SPACE_DIM>::NodeIterator node_iter = p_population->rGetMesh().GetNodeIteratorBegin();
+         node_iter != p_population->rGetMesh().GetNodeIteratorEnd();
+         ++node_iter)
+    {
+        nodes.push_back(&(*node_iter));
+        node_indices.push_back(node_iter->GetIndex());
+    }
+
+    // Only upload the node locations if the backend does not already hold them
+    if (!mpBackend->AreLocationsResident(node_indices))
+    {
+        assert(!mNodesAreBehindBackend);
+        std::vector<c_vector<double, SPACE_DIM> > locations(nodes.size());
+        for (unsigned i=0; i<nodes.size(); i++)
+        {
+            locations[i] = nodes[i]->rGetLocation();
+        }
+        mpBackend->UploadNodes(node_indices, locations);
+    }
+
+    CellBasedEventHandler::BeginEvent(CellBasedEventHandler::FORCE);
+
+    double interaction_distance = p_population->GetMechanicsCutOffLength();
+    mpBackend->BinNodes(interaction_distance);
+    mpBackend->FindPairs(interaction_distance);
+    mpBackend->ClearForces();
+
+    /*
+     * Forces without a backend implementation are added to the nodes on the host as
+     * usual, so they need the current node locations and the population's node pairs.
+     */
+    bool host_forces_added = false;
+    for (typename std::vector<boost::shared_ptr<AbstractForce<ELEMENT_DIM, SPACE_DIM> > >::iterator iter = this->mpForceCollection->begin();
+         iter != this->mpForceCollection->end();
+         ++iter)
+    {
+        if (!(*iter)->AddForceContributionOnBackend(*(this->mpCellPopulation), *mpBackend))
+        {
+            if (!host_forces_added)
+            {
+                SynchroniseNodeLocations();
+                for (unsigned i=0; i<nodes.size(); i++)
+                {
+                    nodes[i]->ClearAppliedForce();
+                }
+                host_forces_added = true;
+            }
+            (*iter)->AddForceContribution(*(this->mpCellPopulation));
+        }
+    }
+    if (host_forces_added)
+    {
+        for (unsigned i=0; i<nodes.size(); i++)
+        {
+            mpBackend->AddForce(i, nodes[i]->rGetAppliedForce());
+        }
+    }
+    mAllForcesOnBackend = !host_forces_added;
+
+    CellBasedEventHandler::EndEvent(CellBasedEventHandler::FORCE);
+
+    std::vector<double> damping_constants(nodes.size());
+    for (unsigned i=0; i<nodes.size(); i++)
+    {
+        damping_constants[i] = p_population->GetDampingConstant(node_indices[i]);
+    }
+    double max_displacement = mpBackend->CalculateDisplacements(damping_constants, dt);
+
+    // As in UpdateAllNodePositions(), a rejected step leaves every node where it was
+    if (max_displacement > p_population->GetAbsoluteMovementThreshold())
+    {
+        for (unsigned i=0; i<nodes.size(); i++)
+        {
+            c_vector<double, SPACE_DIM> displacement = mpBackend->GetDisplacement(i);
+            if (norm_2(displacement) > p_population->GetAbsoluteMovementThreshold())
+            {
+                this->DetectStepSizeExceptions(node_indices[i], displacement, dt);
+            }
+        }
+    }
+
+    /*
+     * The new locations and forces stay on the backend; they are only copied to the
+     * nodes by SynchroniseNodeLocations(), when something other than the backend
+     * needs them.
+     */
+    mpBackend->ApplyDisplacements();
+    mNodesAreBehindBackend = true;
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void ForwardEulerNumericalMethod<ELEMENT_DIM,SPACE_DIM>::UpdateAllNodePositions(double dt)
 {
-    if (!this->mUseUpdateNodeLocation)
+    if (!this->mUseUpdateNodeLocation && CanUseBackend())
+    {
+        UpdateAllNodePositionsOnBackend(dt);
+    }
+    else if (!this->mUseUpdateNodeLocation)
     {
         // Apply forces to each cell, and save a vector of net forces F
         std::vector<c_vector<double, SPACE_DIM> > forces = this->ComputeForcesIncludingDamping();
 
-        unsigned index = 0;
-        for (typename AbstractMesh<ELEMENT_DIM, SPACE_DIM>::NodeIterator node_iter = this->mpCellPopulation->rGetMesh().GetNodeIteratorBegin();
-             node_iter != this->mpCellPopulation->rGetMesh().GetNodeIteratorEnd();
-             ++node_iter, ++index)
+        if (dynamic_cast<AbstractCentreBasedCellPopulation<ELEMENT_DIM,SPACE_DIM>*>(this->mpCellPopulation))
+        {
+            /*
+             * Centre-based populations never alter a displacement, they only reject the step
+             * if a node moves too far, so all the displacements can be computed in one pass
+             * and checked together before any node is moved. If the step is rejected the
+             * nodes are left where they were, which is where the simulation reverts them to.
+             */
+            const int num_nodes = static_cast<int>(forces.size());
+            double max_displacement = 0.0;
+#ifdef CHASTE_OPENMP
+#pragma omp parallel for schedule(static) num_threads(this->mNumThreads) if(this->mNumThreads > 1u) reduction(max:max_displacement)
+#endif // CHASTE_OPENMP
+            for (int i = 0; i < num_nodes; i++)
+            {
+                forces[i] *= dt;
+                max_displacement = std::max(max_displacement, norm_2(forces[i]));
+            }
+
+            std::vector<Node<SPACE_DIM>*> nodes;
+            nodes.reserve(forces.size());
+            for (typename AbstractMesh<ELEMENT_DIM, SPACE_DIM>::NodeIterator node_iter = this->mpCellPopulation->rGetMesh().GetNodeIteratorBegin();
+                 node_iter != this->mpCellPopulation->rGetMesh().GetNodeIteratorEnd();
+                 ++node_iter)
+            {
+                nodes.push_back(&(*node_iter));
+            }
+
+            // Only look at individual nodes if some node may have moved too far (ghost nodes and particles may)
+            if (max_displacement > this->mpCellPopulation->GetAbsoluteMovementThreshold())
+            {
+                for (unsigned i=0; i<nodes.size(); i++)
+                {
+                    if (norm_2(forces[i]) > this->mpCellPopulation->GetAbsoluteMovementThreshold())
+                    {
+                        this->DetectStepSizeExceptions(nodes[i]->GetIndex(), forces[i], dt);
+                    }
+                }
+            }
+
+            for (unsigned i=0; i<nodes.size(); i++)
+            {
+                c_vector<double, SPACE_DIM> new_location = nodes[i]->rGetLocation() + forces[i];
+                this->SafeNodePositionUpdate(nodes[i]->GetIndex(), new_location);
+            }
+        }
+        else
         {
-            // Get the current node location and calculate the new location according to the forward Euler method
-            const c_vector<double, SPACE_DIM>& r_old_location = node_iter->rGetLocation();
-            c_vector<double, SPACE_DIM> displacement = dt * forces[index];
+            unsigned index = 0;
+            for (typename AbstractMesh<ELEMENT_DIM, SPACE_DIM>::NodeIterator node_iter = this->mpCellPopulation->rGetMesh().GetNodeIteratorBegin();
+                 node_iter != this->mpCellPopulation->rGetMesh().GetNodeIteratorEnd();
+                 ++node_iter, ++index)
+            {
+                // Get the current node location and calculate the new location according to the forward Euler method
+                const c_vector<double, SPACE_DIM>& r_old_location = node_iter->rGetLocation();
+                c_vector<double, SPACE_DIM> displacement = dt * forces[index];
 
-            // In the vertex-based case, the displacement may be scaled if the cell rearrangement threshold is exceeded
-            this->DetectStepSizeExceptions(node_iter->GetIndex(), displacement, dt);
+                // In the vertex-based case, the displacement may be scaled if the cell rearrangement threshold is exceeded
+                this->DetectStepSizeExceptions(node_iter->GetIndex(), displacement, dt);
 
-            c_vector<double, SPACE_DIM> new_location = r_old_location + displacement;
-            this->SafeNodePositionUpdate(node_iter->GetIndex(), new_location);
+                c_vector<double, SPACE_DIM> new_location = r_old_location + displacement;
+                this->SafeNodePositionUpdate(node_iter->GetIndex(), new_location);
+            }
         }
     }
     else
@@ -82,6 +257,64 @@ void ForwardEulerNumericalMethod<ELEMENT_DIM,SPACE_DIM>::UpdateAllNodePositions(
     }
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void ForwardEulerNumericalMethod<ELEMENT_DIM,SPACE_DIM>::SetNodeBasedMechanicsBackend(boost::shared_ptr<NodeBasedMechanicsBackend<SPACE_DIM> > pBackend)
+{
+    // Any locations still held by the old backend are copied to the nodes first
+    SynchroniseNodeLocations();
+    mpBackend = pBackend;
+    if (mpBackend)
+    {
+        mpBackend->InvalidateLocations();
+    }
+    mAllForcesOnBackend = false;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+boost::shared_ptr<NodeBasedMechanicsBackend<SPACE_DIM> > ForwardEulerNumericalMethod<ELEMENT_DIM,SPACE_DIM>::GetNodeBasedMechanicsBackend()
+{
+    return mpBackend;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void ForwardEulerNumericalMethod<ELEMENT_DIM,SPACE_DIM>::InvalidateResidentNodeLocations()
+{
+    if (mpBackend)
+    {
+        mpBackend->InvalidateLocations();
+    }
+
+    // The nodes now hold the locations to use
+    mNodesAreBehindBackend = false;
+    mAllForcesOnBackend = false;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void ForwardEulerNumericalMethod<ELEMENT_DIM,SPACE_DIM>::SynchroniseNodeLocations()
+{
+    if (mNodesAreBehindBackend)
+    {
+        const std::vector<unsigned>& r_node_indices = mpBackend->rGetNodeIndices();
+        for (unsigned i=0; i<r_node_indices.size(); i++)
+        {
+            c_vector<double, SPACE_DIM> new_location = mpBackend->GetLocation(i);
+            this->SafeNodePositionUpdate(r_node_indices[i], new_location);
+
+            Node<SPACE_DIM>* p_node = this->mpCellPopulation->GetNode(r_node_indices[i]);
+            p_node->ClearAppliedForce();
+            c_vector<double, SPACE_DIM> force = mpBackend->GetForce(i);
+            p_node->AddAppliedForceContribution(force);
+        }
+        mNodesAreBehindBackend = false;
+    }
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool ForwardEulerNumericalMethod<ELEMENT_DIM,SPACE_DIM>::UsesOwnNodePairs()
+{
+    return mAllForcesOnBackend && CanUseBackend() && !this->mUseUpdateNodeLocation;
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void ForwardEulerNumericalMethod<ELEMENT_DIM, SPACE_DIM>::OutputNumericalMethodParameters(out_stream& rParamsFile)
 {
@@ -39,7 +39,10 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ChasteSerialization.hpp"
 #include <boost/serialization/base_object.hpp>
 
+#include <boost/shared_ptr.hpp>
+
 #include "AbstractNumericalMethod.hpp"
+#include "NodeBasedMechanicsBackend.hpp"
 
 /**
  * Implements forward Euler time stepping.
@@ -48,6 +51,11 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  * Using the scheme
  *
  * r^(t+1) = r^t + dt F^t.
+ *
+ * For a NodeBasedCellPopulation the step may optionally be run on a
+ * NodeBasedMechanicsBackend, which keeps the node locations resident between
+ * steps and computes pairs, forces and the update with kernels. The nodes are
+ * then only given their new locations by SynchroniseNodeLocations().
  */
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM=ELEMENT_DIM>
 class ForwardEulerNumericalMethod : public AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM> {
@@ -69,6 +77,36 @@ private:
         archive & boost::serialization::base_object<AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM> >(*this);
     }
 
+    /**
+     * The backend used for node-based populations, if any. Not archived.
+     */
+    boost::shared_ptr<NodeBasedMechanicsBackend<SPACE_DIM> > mpBackend;
+
+    /**
+     * Whether mpBackend holds node locations and forces that have not yet been
+     * copied to the nodes. Not archived.
+     */
+    bool mNodesAreBehindBackend;
+
+    /**
+     * Whether every force was evaluated on mpBackend in the last step. Not archived.
+     */
+    bool mAllForcesOnBackend;
+
+    /**
+     * @return whether the step can be run on mpBackend: a backend has been set,
+     * the population is a NodeBasedCellPopulation on a non-periodic mesh, and
+     * the simulation runs on one process.
+     */
+    bool CanUseBackend();
+
+    /**
+     * Update the node positions using mpBackend.
+     *
+     * @param dt Time step size
+     */
+    void UpdateAllNodePositionsOnBackend(double dt);
+
 public:
 
     /**
@@ -88,6 +126,39 @@ public:
      */
     void UpdateAllNodePositions(double dt);
 
+    /**
+     * Set a backend on which to run the steps for a NodeBasedCellPopulation.
+     * Forces without a backend implementation are still evaluated on the host.
+     * Populations of other types, periodic meshes and parallel runs ignore it.
+     *
+     * @param pBackend the backend (may be empty, to switch the backend off)
+     */
+    void SetNodeBasedMechanicsBackend(boost::shared_ptr<NodeBasedMechanicsBackend<SPACE_DIM> > pBackend);
+
+    /**
+     * @return the backend used for node-based populations, if any.
+     */
+    boost::shared_ptr<NodeBasedMechanicsBackend<SPACE_DIM> > GetNodeBasedMechanicsBackend();
+
+    /**
+     * Overridden InvalidateResidentNodeLocations() method.
+     */
+    virtual void InvalidateResidentNodeLocations();
+
+    /**
+     * Overridden SynchroniseNodeLocations() method.
+     *
+     * Copies the node locations and forces held by the backend to the nodes.
+     */
+    virtual void SynchroniseNodeLocations();
+
+    /**
+     * Overridden UsesOwnNodePairs() method.
+     *
+     * @return whether the last step ran on the backend with every force evaluated there.
+     */
+    virtual bool UsesOwnNodePairs();
+
     /**
      * Overridden OutputNumericalMethodParameters() method.
      *
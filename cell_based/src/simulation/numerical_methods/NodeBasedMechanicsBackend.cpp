@@ -0,0 +1,511 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "NodeBasedMechanicsBackend.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <climits>
+
+#include "Exception.hpp"
+
+template <unsigned DIM>
+NodeBasedMechanicsBackend<DIM>::NodeBasedMechanicsBackend()
+    : mNumThreads(1u),
+      mLocationsAreResident(false),
+      mNumUploads(0u),
+      mBinWidth(0.0)
+{
+    for (unsigned d=0; d<DIM; d++)
+    {
+        mNumBins[d] = 0;
+    }
+}
+
+template <unsigned DIM>
+void NodeBasedMechanicsBackend<DIM>::SetNumberOfThreads(unsigned numThreads)
+{
+    if (numThreads == 0u)
+    {
+        EXCEPTION("The number of backend threads must be at least one.");
+    }
+    mNumThreads = numThreads;
+}
+
+template <unsigned DIM>
+unsigned NodeBasedMechanicsBackend<DIM>::GetNumberOfThreads() const
+{
+    return mNumThreads;
+}
+
+template <unsigned DIM>
+bool NodeBasedMechanicsBackend<DIM>::AreLocationsResident(const std::vector<unsigned>& rNodeIndices) const
+{
+    return mLocationsAreResident && rNodeIndices == mNodeIndices;
+}
+
+template <unsigned DIM>
+void NodeBasedMechanicsBackend<DIM>::UploadNodes(const std::vector<unsigned>& rNodeIndices, const std::vector<c_vector<double, DIM> >& rLocations)
+{
+    assert(rNodeIndices.size() == rLocations.size());
+    const unsigned num_nodes = rNodeIndices.size();
+
+    mNodeIndices = rNodeIndices;
+    unsigned max_index = 0;
+    for (unsigned i=0; i<num_nodes; i++)
+    {
+        max_index = std::max(max_index, rNodeIndices[i]);
+    }
+    mResidentIndices.assign(num_nodes > 0 ? max_index + 1 : 0, UINT_MAX);
+    for (unsigned i=0; i<num_nodes; i++)
+    {
+        mResidentIndices[rNodeIndices[i]] = i;
+    }
+
+    mLocations.resize(DIM*num_nodes);
+    for (unsigned i=0; i<num_nodes; i++)
+    {
+        for (unsigned d=0; d<DIM; d++)
+        {
+            mLocations[DIM*i + d] = rLocations[i][d];
+        }
+    }
+    mForces.assign(DIM*num_nodes, 0.0);
+    mDisplacements.assign(DIM*num_nodes, 0.0);
+
+    mLocationsAreResident = true;
+    mNumUploads++;
+}
+
+template <unsigned DIM>
+void NodeBasedMechanicsBackend<DIM>::InvalidateLocations()
+{
+    mLocationsAreResident = false;
+}
+
+template <unsigned DIM>
+unsigned NodeBasedMechanicsBackend<DIM>::GetNumberOfUploads() const
+{
+    return mNumUploads;
+}
+
+template <unsigned DIM>
+unsigned NodeBasedMechanicsBackend<DIM>::GetNumNodes() const
+{
+    return mNodeIndices.size();
+}
+
+template <unsigned DIM>
+const std::vector<unsigned>& NodeBasedMechanicsBackend<DIM>::rGetNodeIndices() const
+{
+    return mNodeIndices;
+}
+
+template <unsigned DIM>
+unsigned NodeBasedMechanicsBackend<DIM>::GetResidentIndex(unsigned globalIndex) const
+{
+    assert(globalIndex < mResidentIndices.size() && mResidentIndices[globalIndex] != UINT_MAX);
+    return mResidentIndices[globalIndex];
+}
+
+template <unsigned DIM>
+c_vector<double, DIM> NodeBasedMechanicsBackend<DIM>::GetLocation(unsigned residentIndex) const
+{
+    c_vector<double, DIM> location;
+    for (unsigned d=0; d<DIM; d++)
+    {
+        location[d] = mLocations[DIM*residentIndex + d];
+    }
+    return location;
+}
+
+template <unsigned DIM>
+void NodeBasedMechanicsBackend<DIM>::BinNodes(double binWidth)
+{
+    assert(binWidth > 0.0);
+    const unsigned num_nodes = mNodeIndices.size();
+
+    // The bounding box of the nodes
+    double lower[DIM];
+    double upper[DIM];
+    for (unsigned d=0; d<DIM; d++)
+    {
+        lower[d] = num_nodes > 0 ? mLocations[d] : 0.0;
+        upper[d] = lower[d];
+    }
+    for (unsigned i=0; i<num_nodes; i++)
+    {
+        for (unsigned d=0; d<DIM; d++)
+        {
+            lower[d] = std::min(lower[d], mLocations[DIM*i + d]);
+            upper[d] = std::max(upper[d], mLocations[DIM*i + d]);
+        }
+    }
+
+    // Widen the bins if the grid would be much larger than the number of nodes
+    mBinWidth = binWidth;
+    double num_bins_total;
+    while (true)
+    {
+        num_bins_total = 1.0;
+        for (unsigned d=0; d<DIM; d++)
+        {
+            num_bins_total *= floor((upper[d] - lower[d])/mBinWidth) + 1.0;
+        }
+        if (num_bins_total <= std::max(64.0, 8.0*num_nodes))
+        {
+            break;
+        }
+        mBinWidth *= 2.0;
+    }
+    for (unsigned d=0; d<DIM; d++)
+    {
+        mNumBins[d] = static_cast<unsigned>(floor((upper[d] - lower[d])/mBinWidth)) + 1u;
+    }
+
+    // Find the bin of each node
+    mNodeBins.resize(num_nodes);
+    const int num_nodes_int = static_cast<int>(num_nodes);
+#ifdef CHASTE_OPENMP
+#pragma omp parallel for schedule(static) num_threads(mNumThreads) if(mNumThreads > 1u)
+#endif // CHASTE_OPENMP
+    for (int i=0; i<num_nodes_int; i++)
+    {
+        unsigned bin = 0;
+        for (unsigned d=DIM; d-- > 0; )
+        {
+            unsigned bin_d = static_cast<unsigned>(floor((mLocations[DIM*i + d] - lower[d])/mBinWidth));
+            bin = bin*mNumBins[d] + std::min(bin_d, mNumBins[d] - 1u);
+        }
+        mNodeBins[i] = bin;
+    }
+
+    // Counting sort of the nodes by bin; nodes stay in resident order within each bin
+    mBinStarts.assign(static_cast<unsigned>(num_bins_total) + 1u, 0u);
+    for (unsigned i=0; i<num_nodes; i++)
+    {
+        mBinStarts[mNodeBins[i] + 1]++;
+    }
+    for (unsigned bin=1; bin<mBinStarts.size(); bin++)
+    {
+        mBinStarts[bin] += mBinStarts[bin - 1];
+    }
+    mBinnedNodes.resize(num_nodes);
+    std::vector<unsigned> next_slot(mBinStarts.begin(), mBinStarts.end() - 1);
+    for (unsigned i=0; i<num_nodes; i++)
+    {
+        mBinnedNodes[next_slot[mNodeBins[i]]++] = i;
+    }
+}
+
+template <unsigned DIM>
+void NodeBasedMechanicsBackend<DIM>::FindPairs(double cutOffLength)
+{
+    assert(cutOffLength <= mBinWidth);
+    const double cut_off_squared = cutOffLength*cutOffLength;
+    const unsigned num_bins = mBinStarts.size() - 1;
+
+    /*
+     * The neighbouring bins searched from each bin: those whose offset is
+     * lexicographically positive, so that each pair of bins is visited once.
+     * Nodes in the same bin are paired separately.
+     */
+    std::vector<std::vector<int> > offsets;
+    unsigned num_offsets = 1;
+    for (unsigned d=0; d<DIM; d++)
+    {
+        num_offsets *= 3;
+    }
+    for (unsigned k=0; k<num_offsets; k++)
+    {
+        std::vector<int> offset(DIM);
+        unsigned code = k;
+        for (unsigned d=0; d<DIM; d++)
+        {
+            offset[d] = static_cast<int>(code % 3) - 1;
+            code /= 3;
+        }
+        // Lexicographic order, with the last dimension most significant
+        int first_non_zero = 0;
+        for (unsigned d=DIM; d-- > 0; )
+        {
+            if (offset[d] != 0)
+            {
+                first_non_zero = offset[d];
+                break;
+            }
+        }
+        if (first_non_zero > 0)
+        {
+            offsets.push_back(offset);
+        }
+    }
+
+    // Two passes over the bins: count the pairs found from each bin, then fill them in
+    std::vector<unsigned> pair_starts(num_bins + 1, 0u);
+    for (unsigned pass=0; pass<2; pass++)
+    {
+        if (pass == 1)
+        {
+            for (unsigned bin=1; bin<=num_bins; bin++)
+            {
+                pair_starts[bin] += pair_starts[bin - 1];
+            }
+            mPairFirst.resize(pair_starts[num_bins]);
+            mPairSecond.resize(pair_starts[num_bins]);
+        }
+
+        const int num_bins_int = static_cast<int>(num_bins);
+#ifdef CHASTE_OPENMP
+#pragma omp parallel for schedule(dynamic, 64) num_threads(mNumThreads) if(mNumThreads > 1u)
+#endif // CHASTE_OPENMP
+        for (int bin=0; bin<num_bins_int; bin++)
+        {
+            unsigned num_pairs_found = 0;
+            unsigned next_pair = (pass == 1) ? pair_starts[bin] : 0u;
+
+            // The coordinates of this bin
+            int coords[DIM];
+            unsigned remainder = bin;
+            for (unsigned d=0; d<DIM; d++)
+            {
+                coords[d] = static_cast<int>(remainder % mNumBins[d]);
+                remainder /= mNumBins[d];
+            }
+
+            for (unsigned k=0; k<=offsets.size(); k++)
+            {
+                // k == offsets.size() stands for this bin itself
+                const bool same_bin = (k == offsets.size());
+                unsigned other_bin = bin;
+                if (!same_bin)
+                {
+                    bool in_grid = true;
+                    other_bin = 0;
+                    for (unsigned d=DIM; d-- > 0; )
+                    {
+                        int c = coords[d] + offsets[k][d];
+                        if (c < 0 || c >= static_cast<int>(mNumBins[d]))
+                        {
+                            in_grid = false;
+                            break;
+                        }
+                        other_bin = other_bin*mNumBins[d] + static_cast<unsigned>(c);
+                    }
+                    if (!in_grid)
+                    {
+                        continue;
+                    }
+                }
+
+                for (unsigned a=mBinStarts[bin]; a<mBinStarts[bin + 1]; a++)
+                {
+                    const unsigned node_a = mBinnedNodes[a];
+                    const unsigned b_begin = same_bin ? a + 1 : mBinStarts[other_bin];
+                    for (unsigned b=b_begin; b<mBinStarts[other_bin + 1]; b++)
+                    {
+                        const unsigned node_b = mBinnedNodes[b];
+                        double distance_squared = 0.0;
+                        for (unsigned d=0; d<DIM; d++)
+                        {
+                            double difference = mLocations[DIM*node_b + d] - mLocations[DIM*node_a + d];
+                            distance_squared += difference*difference;
+                        }
+                        if (distance_squared < cut_off_squared)
+                        {
+                            if (pass == 0)
+                            {
+                                num_pairs_found++;
+                            }
+                            else
+                            {
+                                mPairFirst[next_pair] = node_a;
+                                mPairSecond[next_pair] = node_b;
+                                next_pair++;
+                            }
+                        }
+                    }
+                }
+            }
+
+            if (pass == 0)
+            {
+                pair_starts[bin + 1] = num_pairs_found;
+            }
+        }
+    }
+}
+
+template <unsigned DIM>
+unsigned NodeBasedMechanicsBackend<DIM>::GetNumPairs() const
+{
+    return mPairFirst.size();
+}
+
+template <unsigned DIM>
+void NodeBasedMechanicsBackend<DIM>::ClearForces()
+{
+    std::fill(mForces.begin(), mForces.end(), 0.0);
+}
+
+template <unsigned DIM>
+void NodeBasedMechanicsBackend<DIM>::AddForce(unsigned residentIndex, const c_vector<double, DIM>& rForce)
+{
+    for (unsigned d=0; d<DIM; d++)
+    {
+        mForces[DIM*residentIndex + d] += rForce[d];
+    }
+}
+
+template <unsigned DIM>
+c_vector<double, DIM> NodeBasedMechanicsBackend<DIM>::GetForce(unsigned residentIndex) const
+{
+    c_vector<double, DIM> force;
+    for (unsigned d=0; d<DIM; d++)
+    {
+        force[d] = mForces[DIM*residentIndex + d];
+    }
+    return force;
+}
+
+template <unsigned DIM>
+void NodeBasedMechanicsBackend<DIM>::ScatterPairForces()
+{
+    // Serial, and in pair order, so that the sums do not depend on the number of threads
+    for (unsigned i=0; i<mPairFirst.size(); i++)
+    {
+        for (unsigned d=0; d<DIM; d++)
+        {
+            mForces[DIM*mPairFirst[i] + d] += mPairForces[DIM*i + d];
+            mForces[DIM*mPairSecond[i] + d] -= mPairForces[DIM*i + d];
+        }
+    }
+}
+
+template <unsigned DIM>
+void NodeBasedMechanicsBackend<DIM>::AddSpringForces(const std::vector<double>& rRadii,
+                                                     const std::vector<double>& rRestLengthFactors,
+                                                     double springStiffness,
+                                                     double springCutOffLength)
+{
+    assert(rRadii.size() == mNodeIndices.size());
+    assert(rRestLengthFactors.size() == mNodeIndices.size());
+
+    const int num_pairs = static_cast<int>(mPairFirst.size());
+    mPairForces.resize(DIM*num_pairs);
+#ifdef CHASTE_OPENMP
+#pragma omp parallel for schedule(static) num_threads(mNumThreads) if(mNumThreads > 1u)
+#endif // CHASTE_OPENMP
+    for (int i=0; i<num_pairs; i++)
+    {
+        const unsigned a = mPairFirst[i];
+        const unsigned b = mPairSecond[i];
+        double difference[DIM];
+        double distance_squared = 0.0;
+        for (unsigned d=0; d<DIM; d++)
+        {
+            difference[d] = mLocations[DIM*b + d] - mLocations[DIM*a + d];
+            distance_squared += difference[d]*difference[d];
+        }
+        const double distance = sqrt(distance_squared);
+
+        double factor = 0.0;
+        if (distance < springCutOffLength)
+        {
+            // Share the rest length between the cells in proportion to their radii
+            const double rest_length_final = rRadii[a] + rRadii[b];
+            const double rest_length = rRadii[a]*rRestLengthFactors[a] + rRadii[b]*rRestLengthFactors[b];
+            factor = CalculateSpringForceFactor(distance, rest_length, rest_length_final, springStiffness);
+        }
+        for (unsigned d=0; d<DIM; d++)
+        {
+            mPairForces[DIM*i + d] = factor*difference[d];
+        }
+    }
+
+    ScatterPairForces();
+}
+
+template <unsigned DIM>
+double NodeBasedMechanicsBackend<DIM>::CalculateDisplacements(const std::vector<double>& rDampingConstants, double dt)
+{
+    assert(rDampingConstants.size() == mNodeIndices.size());
+    const int num_nodes = static_cast<int>(mNodeIndices.size());
+    double max_displacement_squared = 0.0;
+#ifdef CHASTE_OPENMP
+#pragma omp parallel for schedule(static) num_threads(mNumThreads) if(mNumThreads > 1u) reduction(max:max_displacement_squared)
+#endif // CHASTE_OPENMP
+    for (int i=0; i<num_nodes; i++)
+    {
+        double displacement_squared = 0.0;
+        for (unsigned d=0; d<DIM; d++)
+        {
+            double displacement = dt*(mForces[DIM*i + d]/rDampingConstants[i]);
+            mDisplacements[DIM*i + d] = displacement;
+            displacement_squared += displacement*displacement;
+        }
+        max_displacement_squared = std::max(max_displacement_squared, displacement_squared);
+    }
+    return sqrt(max_displacement_squared);
+}
+
+template <unsigned DIM>
+c_vector<double, DIM> NodeBasedMechanicsBackend<DIM>::GetDisplacement(unsigned residentIndex) const
+{
+    c_vector<double, DIM> displacement;
+    for (unsigned d=0; d<DIM; d++)
+    {
+        displacement[d] = mDisplacements[DIM*residentIndex + d];
+    }
+    return displacement;
+}
+
+template <unsigned DIM>
+void NodeBasedMechanicsBackend<DIM>::ApplyDisplacements()
+{
+    const int num_entries = static_cast<int>(mLocations.size());
+#ifdef CHASTE_OPENMP
+#pragma omp parallel for schedule(static) num_threads(mNumThreads) if(mNumThreads > 1u)
+#endif // CHASTE_OPENMP
+    for (int i=0; i<num_entries; i++)
+    {
+        mLocations[i] += mDisplacements[i];
+    }
+}
+
+// Explicit instantiation
+template class NodeBasedMechanicsBackend<1>;
+template class NodeBasedMechanicsBackend<2>;
+template class NodeBasedMechanicsBackend<3>;
@@ -0,0 +1,306 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef NODEBASEDMECHANICSBACKEND_HPP_
+#define NODEBASEDMECHANICSBACKEND_HPP_
+
+#include <cmath>
+#include <vector>
+
+#include "UblasVectorInclude.hpp"
+
+/**
+ * Holds the node locations of a node-based cell population, and the work
+ * arrays for a mechanics step, in flat arrays that stay resident between time
+ * steps, and runs the steps of the node-based pipeline on them as kernels:
+ * binning the nodes into a uniform grid, finding the pairs of nodes closer
+ * than a cut-off, evaluating pair forces, and the forward Euler update.
+ *
+ * The kernels only use plain arrays of doubles and unsigneds, never nodes or
+ * cells, so that they can be offloaded to an accelerator; this implementation
+ * runs them on the host, sharing the loops between OpenMP threads if Chaste
+ * was built with OpenMP support. Their results do not depend on the number of
+ * threads.
+ *
+ * The resident node locations are only uploaded again when the nodes of the
+ * population change (for example after a cell division or death, or a spatial
+ * re-ordering of the nodes), or when InvalidateLocations() has been called
+ * because the nodes were moved by other code.
+ *
+ * Used by ForwardEulerNumericalMethod (see its SetNodeBasedMechanicsBackend()
+ * method). Forces provide kernels by overriding
+ * AbstractForce::AddForceContributionOnBackend(); other forces are evaluated
+ * on the host as usual and their contributions uploaded.
+ */
+template <unsigned DIM>
+class NodeBasedMechanicsBackend
+{
+private:
+
+    /** The number of threads used by the kernels. */
+    unsigned mNumThreads;
+
+    /** Whether mLocations holds the current locations of the nodes in mNodeIndices. */
+    bool mLocationsAreResident;
+
+    /** The number of times the node locations have been uploaded. */
+    unsigned mNumUploads;
+
+    /** The global index of each resident node, in the order of the population's node iterator. */
+    std::vector<unsigned> mNodeIndices;
+
+    /** The resident index of each node, indexed by global index (UINT_MAX for absent nodes). */
+    std::vector<unsigned> mResidentIndices;
+
+    /** The location of each resident node (DIM entries per node). */
+    std::vector<double> mLocations;
+
+    /** The force on each resident node (DIM entries per node). */
+    std::vector<double> mForces;
+
+    /** The displacement of each resident node over the current step (DIM entries per node). */
+    std::vector<double> mDisplacements;
+
+    /** The width of the bins used by the last call to BinNodes(). */
+    double mBinWidth;
+
+    /** The number of bins in each direction. */
+    unsigned mNumBins[DIM];
+
+    /** The bin containing each resident node. */
+    std::vector<unsigned> mNodeBins;
+
+    /** The position in mBinnedNodes of the first node in each bin (with one extra entry at the end). */
+    std::vector<unsigned> mBinStarts;
+
+    /** The resident indices of the nodes, sorted by bin. */
+    std::vector<unsigned> mBinnedNodes;
+
+    /** The resident index of the first node of each pair. */
+    std::vector<unsigned> mPairFirst;
+
+    /** The resident index of the second node of each pair. */
+    std::vector<unsigned> mPairSecond;
+
+    /** The force on the first node of each pair by the second (DIM entries per pair). */
+    std::vector<double> mPairForces;
+
+    /**
+     * Add the forces in mPairForces to the first node of each pair, and
+     * subtract them from the second.
+     */
+    void ScatterPairForces();
+
+public:
+
+    /**
+     * Constructor.
+     */
+    NodeBasedMechanicsBackend();
+
+    /**
+     * Set the number of threads used by the kernels.
+     *
+     * @param numThreads the number of threads (at least 1)
+     */
+    void SetNumberOfThreads(unsigned numThreads);
+
+    /**
+     * @return the number of threads used by the kernels.
+     */
+    unsigned GetNumberOfThreads() const;
+
+    /**
+     * @return whether the resident node locations are those of the given nodes,
+     * so that they need not be uploaded again.
+     *
+     * @param rNodeIndices the global index of each node, in the order of the population's node iterator
+     */
+    bool AreLocationsResident(const std::vector<unsigned>& rNodeIndices) const;
+
+    /**
+     * Upload the nodes and their locations.
+     *
+     * @param rNodeIndices the global index of each node, in the order of the population's node iterator
+     * @param rLocations the location of each node, in the same order
+     */
+    void UploadNodes(const std::vector<unsigned>& rNodeIndices, const std::vector<c_vector<double, DIM> >& rLocations);
+
+    /**
+     * Mark the resident node locations as out of date, so that they are uploaded
+     * again before the next step. Must be called if the nodes are moved other
+     * than by the numerical method.
+     */
+    void InvalidateLocations();
+
+    /**
+     * @return the number of times the node locations have been uploaded.
+     */
+    unsigned GetNumberOfUploads() const;
+
+    /**
+     * @return the number of resident nodes.
+     */
+    unsigned GetNumNodes() const;
+
+    /**
+     * @return the global index of each resident node.
+     */
+    const std::vector<unsigned>& rGetNodeIndices() const;
+
+    /**
+     * @return the resident index of a node.
+     *
+     * @param globalIndex the global index of the node, which must be resident
+     */
+    unsigned GetResidentIndex(unsigned globalIndex) const;
+
+    /**
+     * @return the location of a resident node.
+     *
+     * @param residentIndex the resident index of the node
+     */
+    c_vector<double, DIM> GetLocation(unsigned residentIndex) const;
+
+    /**
+     * Kernel: sort the resident nodes into a uniform grid of square (cubic) bins.
+     * The bins may be made wider than requested if the nodes are spread so
+     * thinly that the grid would have many more bins than nodes.
+     *
+     * @param binWidth the smallest width of the bins
+     */
+    void BinNodes(double binWidth);
+
+    /**
+     * Kernel: find every pair of resident nodes closer together than a cut-off,
+     * which must be no greater than the width of the bins. The pairs are found
+     * in an order that does not depend on the number of threads.
+     *
+     * @param cutOffLength the cut-off
+     */
+    void FindPairs(double cutOffLength);
+
+    /**
+     * @return the number of pairs found by the last call to FindPairs().
+     */
+    unsigned GetNumPairs() const;
+
+    /**
+     * Set every force to zero.
+     */
+    void ClearForces();
+
+    /**
+     * Add a force to a resident node.
+     *
+     * @param residentIndex the resident index of the node
+     * @param rForce the force
+     */
+    void AddForce(unsigned residentIndex, const c_vector<double, DIM>& rForce);
+
+    /**
+     * @return the force on a resident node.
+     *
+     * @param residentIndex the resident index of the node
+     */
+    c_vector<double, DIM> GetForce(unsigned residentIndex) const;
+
+    /**
+     * The force law of GeneralisedLinearSpringForce: the magnitude of the force
+     * between two nodes, divided by their separation.
+     *
+     * @param distance the distance between the nodes
+     * @param restLength the rest length of the spring
+     * @param restLengthFinal the rest length of the spring between two fully-grown, healthy cells
+     * @param springStiffness the spring stiffness
+     * @return the force factor
+     */
+    static double CalculateSpringForceFactor(double distance, double restLength, double restLengthFinal, double springStiffness)
+    {
+        double overlap = distance - restLength;
+        double magnitude;
+        if (overlap <= 0)
+        {
+            // log(x+1) is undefined for x<=-1
+            magnitude = springStiffness * restLengthFinal * log(1.0 + overlap/restLengthFinal);
+        }
+        else
+        {
+            const double alpha = 5.0;
+            magnitude = springStiffness * overlap * exp(-alpha * overlap/restLengthFinal);
+        }
+        return magnitude / distance;
+    }
+
+    /**
+     * Kernel: add the forces of GeneralisedLinearSpringForce between the pairs of
+     * nodes found by FindPairs(), for springs that are not marked as growing
+     * after a cell division.
+     *
+     * @param rRadii the radius of each resident node
+     * @param rRestLengthFactors the factor by which each node's share of the rest
+     *     length is scaled (less than one for apoptotic cells)
+     * @param springStiffness the spring stiffness
+     * @param springCutOffLength no force is added between nodes at least this far apart
+     */
+    void AddSpringForces(const std::vector<double>& rRadii,
+                         const std::vector<double>& rRestLengthFactors,
+                         double springStiffness,
+                         double springCutOffLength);
+
+    /**
+     * Kernel: compute the forward Euler displacement of each node over a time
+     * step, given its damping constant. The nodes are not moved.
+     *
+     * @param rDampingConstants the damping constant of each resident node
+     * @param dt the time step
+     * @return the largest displacement.
+     */
+    double CalculateDisplacements(const std::vector<double>& rDampingConstants, double dt);
+
+    /**
+     * @return the displacement of a resident node computed by CalculateDisplacements().
+     *
+     * @param residentIndex the resident index of the node
+     */
+    c_vector<double, DIM> GetDisplacement(unsigned residentIndex) const;
+
+    /**
+     * Kernel: move every node by its displacement.
+     */
+    void ApplyDisplacements();
+};
+
+#endif /*NODEBASEDMECHANICSBACKEND_HPP_*/
@@ -0,0 +1,196 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+#include "RungeKutta23NumericalMethod.hpp"
+#include "StepSizeException.hpp"
+#include "Exception.hpp"
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+RungeKutta23NumericalMethod<ELEMENT_DIM,SPACE_DIM>::RungeKutta23NumericalMethod()
+    : AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM>(),
+      mErrorTolerance(1e-3),
+      mLastErrorEstimate(0.0)
+{
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+RungeKutta23NumericalMethod<ELEMENT_DIM,SPACE_DIM>::~RungeKutta23NumericalMethod()
+{
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void RungeKutta23NumericalMethod<ELEMENT_DIM,SPACE_DIM>::UpdateAllNodePositions(double dt)
+{
+    if (!this->mUseUpdateNodeLocation)
+    {
+        std::vector<c_vector<double, SPACE_DIM> > initial_locations = this->SaveCurrentLocations();
+        unsigned num_nodes = initial_locations.size();
+        std::vector<c_vector<double, SPACE_DIM> > stage_locations(num_nodes);
+
+        // First stage, at the current positions
+        std::vector<c_vector<double, SPACE_DIM> > k1 = this->ComputeForcesIncludingDamping();
+
+        // Second stage, half way along the first stage
+        for (unsigned i=0; i<num_nodes; i++)
+        {
+            stage_locations[i] = initial_locations[i] + 0.5*dt*k1[i];
+        }
+        this->SetAllNodeLocations(stage_locations);
+        std::vector<c_vector<double, SPACE_DIM> > k2 = this->ComputeForcesIncludingDamping();
+
+        // Third stage, three quarters of the way along the second stage
+        for (unsigned i=0; i<num_nodes; i++)
+        {
+            stage_locations[i] = initial_locations[i] + 0.75*dt*k2[i];
+        }
+        this->SetAllNodeLocations(stage_locations);
+        std::vector<c_vector<double, SPACE_DIM> > k3 = this->ComputeForcesIncludingDamping();
+
+        // Third-order displacements, and the forces there for the embedded second-order solution
+        std::vector<c_vector<double, SPACE_DIM> > displacements(num_nodes);
+        for (unsigned i=0; i<num_nodes; i++)
+        {
+            displacements[i] = dt*(2.0*k1[i] + 3.0*k2[i] + 4.0*k3[i])/9.0;
+            stage_locations[i] = initial_locations[i] + displacements[i];
+        }
+        this->SetAllNodeLocations(stage_locations);
+        std::vector<c_vector<double, SPACE_DIM> > k4 = this->ComputeForcesIncludingDamping();
+
+        // The difference between the second- and third-order solutions estimates the local error
+        double error_estimate = 0.0;
+        for (unsigned i=0; i<num_nodes; i++)
+        {
+            c_vector<double, SPACE_DIM> error = dt*(-5.0*k1[i]/72.0 + k2[i]/12.0 + k3[i]/9.0 - 0.125*k4[i]);
+            error_estimate = std::max(error_estimate, norm_inf(error));
+        }
+
+        // Leave the nodes where they started, so that the update below sees the original locations
+        this->SetAllNodeLocations(initial_locations);
+
+        if (this->mUseAdaptiveTimestep && error_estimate > mErrorTolerance)
+        {
+            double suggested_step = 0.9*dt*pow(mErrorTolerance/error_estimate, 1.0/3.0);
+            std::stringstream message;
+            message << "Estimated local error " << error_estimate << " exceeds tolerance " << mErrorTolerance;
+            throw StepSizeException(suggested_step, message.str(), false);
+        }
+        mLastErrorEstimate = error_estimate;
+
+        unsigned index = 0;
+        for (typename AbstractMesh<ELEMENT_DIM, SPACE_DIM>::NodeIterator node_iter = this->mpCellPopulation->rGetMesh().GetNodeIteratorBegin();
+             node_iter != this->mpCellPopulation->rGetMesh().GetNodeIteratorEnd();
+             ++node_iter, ++index)
+        {
+            c_vector<double, SPACE_DIM> displacement = displacements[index];
+
+            // In the vertex-based case, the displacement may be scaled if the cell rearrangement threshold is exceeded
+            this->DetectStepSizeExceptions(node_iter->GetIndex(), displacement, dt);
+
+            c_vector<double, SPACE_DIM> new_location = initial_locations[index] + displacement;
+            this->SafeNodePositionUpdate(node_iter->GetIndex(), new_location);
+        }
+    }
+    else
+    {
+        /*
+         * If this type of cell population does not support the new numerical methods, delegate
+         * updating node positions to the population itself.
+         *
+         * This only applies to NodeBasedCellPopulationWithBuskeUpdates.
+         */
+        this->mpCellPopulation->UpdateNodeLocations(dt);
+    }
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+double RungeKutta23NumericalMethod<ELEMENT_DIM,SPACE_DIM>::CalculateNextTimeStep(double currentTimeStep)
+{
+    const double max_growth = 5.0;
+    double growth = max_growth;
+    if (mLastErrorEstimate > 0.0)
+    {
+        growth = std::min(max_growth, 0.9*pow(mErrorTolerance/mLastErrorEstimate, 1.0/3.0));
+    }
+
+    // Never shrink after a successful step; a step that is too large is rejected instead
+    return std::max(1.0, growth)*currentTimeStep;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+double RungeKutta23NumericalMethod<ELEMENT_DIM,SPACE_DIM>::GetErrorTolerance()
+{
+    return mErrorTolerance;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void RungeKutta23NumericalMethod<ELEMENT_DIM,SPACE_DIM>::SetErrorTolerance(double errorTolerance)
+{
+    if (errorTolerance <= 0.0)
+    {
+        EXCEPTION("The error tolerance must be positive");
+    }
+    mErrorTolerance = errorTolerance;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+double RungeKutta23NumericalMethod<ELEMENT_DIM,SPACE_DIM>::GetLastErrorEstimate()
+{
+    return mLastErrorEstimate;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void RungeKutta23NumericalMethod<ELEMENT_DIM, SPACE_DIM>::OutputNumericalMethodParameters(out_stream& rParamsFile)
+{
+    *rParamsFile << "\t\t\t<ErrorTolerance>" << mErrorTolerance << "</ErrorTolerance> \n";
+
+    // Call method on direct parent class
+    AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM>::OutputNumericalMethodParameters(rParamsFile);
+}
+
+// Explicit instantiation
+template class RungeKutta23NumericalMethod<1,1>;
+template class RungeKutta23NumericalMethod<1,2>;
+template class RungeKutta23NumericalMethod<2,2>;
+template class RungeKutta23NumericalMethod<1,3>;
+template class RungeKutta23NumericalMethod<2,3>;
+template class RungeKutta23NumericalMethod<3,3>;
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapperForCpp.hpp"
+EXPORT_TEMPLATE_CLASS_ALL_DIMS(RungeKutta23NumericalMethod)
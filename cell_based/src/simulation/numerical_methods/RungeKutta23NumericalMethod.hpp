@@ -0,0 +1,145 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef RUNGEKUTTA23NUMERICALMETHOD_HPP_
+#define RUNGEKUTTA23NUMERICALMETHOD_HPP_
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+
+#include "AbstractNumericalMethod.hpp"
+
+/**
+ * An embedded Runge-Kutta 2(3) numerical method (Bogacki-Shampine) for the
+ * update of node positions.
+ *
+ * Each step advances the node positions with the third-order solution and
+ * compares it with the embedded second-order solution to estimate the local
+ * error. If an adaptive time step is used and the estimated error exceeds the
+ * error tolerance, a StepSizeException is thrown with a suggested smaller step;
+ * otherwise CalculateNextTimeStep() uses the estimate to grow the step.
+ *
+ * The error estimate is the largest displacement error of any node owned by
+ * this process.
+ */
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM=ELEMENT_DIM>
+class RungeKutta23NumericalMethod : public AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM> {
+
+private:
+
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Save or restore the simulation.
+     *
+     * @param archive the archive
+     * @param version the current version of this class
+     */
+    template <class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM> >(*this);
+        archive & mErrorTolerance;
+    }
+
+    /**
+     * The largest acceptable local error estimate (a distance) in one step.
+     * Defaults to 1e-3.
+     */
+    double mErrorTolerance;
+
+    /** The local error estimate of the most recent step. */
+    double mLastErrorEstimate;
+
+public:
+
+    /**
+     * Constructor.
+     */
+    RungeKutta23NumericalMethod();
+
+    /**
+     * Destructor.
+     */
+    virtual ~RungeKutta23NumericalMethod();
+
+    /**
+     * Overridden UpdateAllNodePositions() method.
+     *
+     * @param dt Time step size
+     */
+    void UpdateAllNodePositions(double dt);
+
+    /**
+     * Overridden CalculateNextTimeStep() method.
+     *
+     * Uses the error estimate of the last step to choose the next step,
+     * allowing it to grow by at most a factor of 5.
+     *
+     * @param currentTimeStep the step that has just been taken successfully
+     * @return the suggested next time step.
+     */
+    virtual double CalculateNextTimeStep(double currentTimeStep);
+
+    /**
+     * @return mErrorTolerance
+     */
+    double GetErrorTolerance();
+
+    /**
+     * Set mErrorTolerance.
+     *
+     * @param errorTolerance the new value of mErrorTolerance
+     */
+    void SetErrorTolerance(double errorTolerance);
+
+    /**
+     * @return the local error estimate of the most recent step.
+     */
+    double GetLastErrorEstimate();
+
+    /**
+     * Overridden OutputNumericalMethodParameters() method.
+     *
+     * @param rParamsFile Reference to the parameter output filestream
+     */
+    virtual void OutputNumericalMethodParameters(out_stream& rParamsFile);
+};
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapper.hpp"
+EXPORT_TEMPLATE_CLASS_ALL_DIMS(RungeKutta23NumericalMethod)
+
+#endif /*RUNGEKUTTA23NUMERICALMETHOD_HPP_*/
@@ -0,0 +1,332 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "SemiImplicitEulerNumericalMethod.hpp"
+#include "Exception.hpp"
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+SemiImplicitEulerNumericalMethod<ELEMENT_DIM,SPACE_DIM>::SemiImplicitEulerNumericalMethod()
+    : AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM>(),
+      mLinearSolverTolerance(1e-6),
+      mMaxLinearSolverIterations(50),
+      mLastNumLinearSolverIterations(0)
+{
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+SemiImplicitEulerNumericalMethod<ELEMENT_DIM,SPACE_DIM>::~SemiImplicitEulerNumericalMethod()
+{
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+std::vector<double> SemiImplicitEulerNumericalMethod<ELEMENT_DIM,SPACE_DIM>::ApplyLinearisedOperator(const std::vector<double>& rV,
+                                                                                                      const std::vector<c_vector<double, SPACE_DIM> >& rInitialLocations,
+                                                                                                      const std::vector<double>& rInitialForces,
+                                                                                                      double dt)
+{
+    unsigned num_nodes = rInitialLocations.size();
+
+    double norm_v = 0.0;
+    double norm_r = 0.0;
+    for (unsigned i=0; i<num_nodes; i++)
+    {
+        for (unsigned d=0; d<SPACE_DIM; d++)
+        {
+            norm_v += rV[SPACE_DIM*i + d]*rV[SPACE_DIM*i + d];
+            norm_r += rInitialLocations[i][d]*rInitialLocations[i][d];
+        }
+    }
+    norm_v = sqrt(norm_v);
+    norm_r = sqrt(norm_r);
+
+    std::vector<double> result(rV);
+    if (norm_v == 0.0)
+    {
+        return result;
+    }
+
+    // Scale the perturbation to the size of the positions, as is usual for matrix-free Newton-Krylov methods
+    double epsilon = sqrt(std::numeric_limits<double>::epsilon())*(1.0 + norm_r)/norm_v;
+
+    std::vector<c_vector<double, SPACE_DIM> > perturbed_locations(rInitialLocations);
+    for (unsigned i=0; i<num_nodes; i++)
+    {
+        for (unsigned d=0; d<SPACE_DIM; d++)
+        {
+            perturbed_locations[i][d] += epsilon*rV[SPACE_DIM*i + d];
+        }
+    }
+    this->SetAllNodeLocations(perturbed_locations);
+    std::vector<c_vector<double, SPACE_DIM> > perturbed_forces = this->ComputeForcesIncludingDamping();
+    this->SetAllNodeLocations(rInitialLocations);
+
+    for (unsigned i=0; i<num_nodes; i++)
+    {
+        for (unsigned d=0; d<SPACE_DIM; d++)
+        {
+            unsigned k = SPACE_DIM*i + d;
+            result[k] -= dt*(perturbed_forces[i][d] - rInitialForces[k])/epsilon;
+        }
+    }
+    return result;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void SemiImplicitEulerNumericalMethod<ELEMENT_DIM,SPACE_DIM>::UpdateAllNodePositions(double dt)
+{
+    if (!this->mUseUpdateNodeLocation)
+    {
+        std::vector<c_vector<double, SPACE_DIM> > initial_locations = this->SaveCurrentLocations();
+        std::vector<c_vector<double, SPACE_DIM> > forces = this->ComputeForcesIncludingDamping();
+        unsigned num_nodes = initial_locations.size();
+        unsigned size = SPACE_DIM*num_nodes;
+
+        // Flatten the forces; the right-hand side is dt*F(r_n)
+        std::vector<double> initial_forces(size);
+        std::vector<double> rhs(size);
+        for (unsigned i=0; i<num_nodes; i++)
+        {
+            for (unsigned d=0; d<SPACE_DIM; d++)
+            {
+                initial_forces[SPACE_DIM*i + d] = forces[i][d];
+                rhs[SPACE_DIM*i + d] = dt*forces[i][d];
+            }
+        }
+
+        // Solve (I - dt J) delta = dt F(r_n) by GMRES, starting from the forward Euler displacement
+        std::vector<double> delta(rhs);
+        mLastNumLinearSolverIterations = 0;
+
+        double norm_rhs = 0.0;
+        for (unsigned k=0; k<size; k++)
+        {
+            norm_rhs += rhs[k]*rhs[k];
+        }
+        norm_rhs = sqrt(norm_rhs);
+
+        std::vector<double> residual = ApplyLinearisedOperator(delta, initial_locations, initial_forces, dt);
+        double beta = 0.0;
+        for (unsigned k=0; k<size; k++)
+        {
+            residual[k] = rhs[k] - residual[k];
+            beta += residual[k]*residual[k];
+        }
+        beta = sqrt(beta);
+
+        if (beta > mLinearSolverTolerance*norm_rhs)
+        {
+            unsigned max_iterations = std::min(mMaxLinearSolverIterations, size);
+
+            // Krylov basis, Hessenberg matrix (stored by column), Givens rotations and the rotated residual
+            std::vector<std::vector<double> > basis(1, residual);
+            for (unsigned k=0; k<size; k++)
+            {
+                basis[0][k] /= beta;
+            }
+            std::vector<std::vector<double> > hessenberg;
+            std::vector<double> cosines;
+            std::vector<double> sines;
+            std::vector<double> g(1, beta);
+
+            for (unsigned j=0; j<max_iterations; j++)
+            {
+                std::vector<double> w = ApplyLinearisedOperator(basis[j], initial_locations, initial_forces, dt);
+
+                // Modified Gram-Schmidt
+                std::vector<double> h(j+2, 0.0);
+                for (unsigned i=0; i<=j; i++)
+                {
+                    for (unsigned k=0; k<size; k++)
+                    {
+                        h[i] += w[k]*basis[i][k];
+                    }
+                    for (unsigned k=0; k<size; k++)
+                    {
+                        w[k] -= h[i]*basis[i][k];
+                    }
+                }
+                for (unsigned k=0; k<size; k++)
+                {
+                    h[j+1] += w[k]*w[k];
+                }
+                h[j+1] = sqrt(h[j+1]);
+
+                bool breakdown = (h[j+1] == 0.0);
+                if (!breakdown)
+                {
+                    for (unsigned k=0; k<size; k++)
+                    {
+                        w[k] /= h[j+1];
+                    }
+                    basis.push_back(w);
+                }
+
+                // Apply the previous rotations to the new column, then eliminate its subdiagonal entry
+                for (unsigned i=0; i<j; i++)
+                {
+                    double temp = cosines[i]*h[i] + sines[i]*h[i+1];
+                    h[i+1] = -sines[i]*h[i] + cosines[i]*h[i+1];
+                    h[i] = temp;
+                }
+                double denominator = sqrt(h[j]*h[j] + h[j+1]*h[j+1]);
+                cosines.push_back(h[j]/denominator);
+                sines.push_back(h[j+1]/denominator);
+                h[j] = denominator;
+                h[j+1] = 0.0;
+                g.push_back(-sines[j]*g[j]);
+                g[j] *= cosines[j];
+                hessenberg.push_back(h);
+
+                mLastNumLinearSolverIterations = j+1;
+                if (breakdown || fabs(g[j+1]) <= mLinearSolverTolerance*norm_rhs)
+                {
+                    break;
+                }
+            }
+
+            // Back substitution for the coefficients of the minimal-residual update
+            unsigned m = mLastNumLinearSolverIterations;
+            std::vector<double> y(m);
+            for (unsigned i=m; i-- > 0; )
+            {
+                y[i] = g[i];
+                for (unsigned l=i+1; l<m; l++)
+                {
+                    y[i] -= hessenberg[l][i]*y[l];
+                }
+                y[i] /= hessenberg[i][i];
+            }
+            for (unsigned i=0; i<m; i++)
+            {
+                for (unsigned k=0; k<size; k++)
+                {
+                    delta[k] += y[i]*basis[i][k];
+                }
+            }
+        }
+
+        unsigned index = 0;
+        for (typename AbstractMesh<ELEMENT_DIM, SPACE_DIM>::NodeIterator node_iter = this->mpCellPopulation->rGetMesh().GetNodeIteratorBegin();
+             node_iter != this->mpCellPopulation->rGetMesh().GetNodeIteratorEnd();
+             ++node_iter, ++index)
+        {
+            c_vector<double, SPACE_DIM> displacement;
+            for (unsigned d=0; d<SPACE_DIM; d++)
+            {
+                displacement[d] = delta[SPACE_DIM*index + d];
+            }
+
+            // In the vertex-based case, the displacement may be scaled if the cell rearrangement threshold is exceeded
+            this->DetectStepSizeExceptions(node_iter->GetIndex(), displacement, dt);
+
+            c_vector<double, SPACE_DIM> new_location = initial_locations[index] + displacement;
+            this->SafeNodePositionUpdate(node_iter->GetIndex(), new_location);
+        }
+    }
+    else
+    {
+        /*
+         * If this type of cell population does not support the new numerical methods, delegate
+         * updating node positions to the population itself.
+         *
+         * This only applies to NodeBasedCellPopulationWithBuskeUpdates.
+         */
+        this->mpCellPopulation->UpdateNodeLocations(dt);
+    }
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+double SemiImplicitEulerNumericalMethod<ELEMENT_DIM,SPACE_DIM>::GetLinearSolverTolerance()
+{
+    return mLinearSolverTolerance;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void SemiImplicitEulerNumericalMethod<ELEMENT_DIM,SPACE_DIM>::SetLinearSolverTolerance(double linearSolverTolerance)
+{
+    if (linearSolverTolerance <= 0.0)
+    {
+        EXCEPTION("The linear solver tolerance must be positive");
+    }
+    mLinearSolverTolerance = linearSolverTolerance;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned SemiImplicitEulerNumericalMethod<ELEMENT_DIM,SPACE_DIM>::GetMaxLinearSolverIterations()
+{
+    return mMaxLinearSolverIterations;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void SemiImplicitEulerNumericalMethod<ELEMENT_DIM,SPACE_DIM>::SetMaxLinearSolverIterations(unsigned maxLinearSolverIterations)
+{
+    if (maxLinearSolverIterations == 0)
+    {
+        EXCEPTION("The maximum number of linear solver iterations must be positive");
+    }
+    mMaxLinearSolverIterations = maxLinearSolverIterations;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned SemiImplicitEulerNumericalMethod<ELEMENT_DIM,SPACE_DIM>::GetLastNumLinearSolverIterations()
+{
+    return mLastNumLinearSolverIterations;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void SemiImplicitEulerNumericalMethod<ELEMENT_DIM, SPACE_DIM>::OutputNumericalMethodParameters(out_stream& rParamsFile)
+{
+    *rParamsFile << "\t\t\t<LinearSolverTolerance>" << mLinearSolverTolerance << "</LinearSolverTolerance> \n";
+    *rParamsFile << "\t\t\t<MaxLinearSolverIterations>" << mMaxLinearSolverIterations << "</MaxLinearSolverIterations> \n";
+
+    // Call method on direct parent class
+    AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM>::OutputNumericalMethodParameters(rParamsFile);
+}
+
+// Explicit instantiation
+template class SemiImplicitEulerNumericalMethod<1,1>;
+template class SemiImplicitEulerNumericalMethod<1,2>;
+template class SemiImplicitEulerNumericalMethod<2,2>;
+template class SemiImplicitEulerNumericalMethod<1,3>;
+template class SemiImplicitEulerNumericalMethod<2,3>;
+template class SemiImplicitEulerNumericalMethod<3,3>;
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapperForCpp.hpp"
+EXPORT_TEMPLATE_CLASS_ALL_DIMS(SemiImplicitEulerNumericalMethod)
@@ -0,0 +1,173 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef SEMIIMPLICITEULERNUMERICALMETHOD_HPP_
+#define SEMIIMPLICITEULERNUMERICALMETHOD_HPP_
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+
+#include "AbstractNumericalMethod.hpp"
+
+/**
+ * A linearly implicit (semi-implicit) Euler numerical method for the update of
+ * node positions, suitable for stiff force laws such as strong springs.
+ *
+ * Writing the equations of motion as dr/dt = F(r), each step solves
+ *
+ *     (I - dt J) delta = dt F(r_n),    r_{n+1} = r_n + delta,
+ *
+ * where J is the Jacobian of F at r_n. The linear system is solved by GMRES
+ * with Jacobian-vector products approximated by finite differences of the
+ * forces, so the Jacobian is never assembled. For forces that are linear in
+ * position this coincides with the backward Euler method.
+ *
+ * The linear solve is local to each process: halo nodes are held fixed during
+ * the step, as they are by the explicit methods.
+ */
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM=ELEMENT_DIM>
+class SemiImplicitEulerNumericalMethod : public AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM> {
+
+private:
+
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Save or restore the simulation.
+     *
+     * @param archive the archive
+     * @param version the current version of this class
+     */
+    template <class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM> >(*this);
+        archive & mLinearSolverTolerance;
+        archive & mMaxLinearSolverIterations;
+    }
+
+    /**
+     * Relative residual tolerance for the GMRES solve in each step.
+     * Defaults to 1e-6.
+     */
+    double mLinearSolverTolerance;
+
+    /**
+     * Maximum number of GMRES iterations in each step. If the tolerance has not
+     * been met by then, the minimal-residual iterate is used.
+     * Defaults to 50.
+     */
+    unsigned mMaxLinearSolverIterations;
+
+    /** The number of GMRES iterations used in the most recent step. */
+    unsigned mLastNumLinearSolverIterations;
+
+    /**
+     * Apply the matrix (I - dt J) to a vector, approximating J v by a finite
+     * difference of the forces. The nodes are moved to r_n + eps v and then
+     * returned to rInitialLocations.
+     *
+     * @param rV the vector to multiply, flattened node by node
+     * @param rInitialLocations the node locations r_n
+     * @param rInitialForces the forces F(r_n), flattened node by node
+     * @param dt the time step
+     * @return the product (I - dt J) v.
+     */
+    std::vector<double> ApplyLinearisedOperator(const std::vector<double>& rV,
+                                                const std::vector<c_vector<double, SPACE_DIM> >& rInitialLocations,
+                                                const std::vector<double>& rInitialForces,
+                                                double dt);
+
+public:
+
+    /**
+     * Constructor.
+     */
+    SemiImplicitEulerNumericalMethod();
+
+    /**
+     * Destructor.
+     */
+    virtual ~SemiImplicitEulerNumericalMethod();
+
+    /**
+     * Overridden UpdateAllNodePositions() method.
+     *
+     * @param dt Time step size
+     */
+    void UpdateAllNodePositions(double dt);
+
+    /**
+     * @return mLinearSolverTolerance
+     */
+    double GetLinearSolverTolerance();
+
+    /**
+     * Set mLinearSolverTolerance.
+     *
+     * @param linearSolverTolerance the new value of mLinearSolverTolerance
+     */
+    void SetLinearSolverTolerance(double linearSolverTolerance);
+
+    /**
+     * @return mMaxLinearSolverIterations
+     */
+    unsigned GetMaxLinearSolverIterations();
+
+    /**
+     * Set mMaxLinearSolverIterations.
+     *
+     * @param maxLinearSolverIterations the new value of mMaxLinearSolverIterations
+     */
+    void SetMaxLinearSolverIterations(unsigned maxLinearSolverIterations);
+
+    /**
+     * @return the number of GMRES iterations used in the most recent step.
+     */
+    unsigned GetLastNumLinearSolverIterations();
+
+    /**
+     * Overridden OutputNumericalMethodParameters() method.
+     *
+     * @param rParamsFile Reference to the parameter output filestream
+     */
+    virtual void OutputNumericalMethodParameters(out_stream& rParamsFile);
+};
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapper.hpp"
+EXPORT_TEMPLATE_CLASS_ALL_DIMS(SemiImplicitEulerNumericalMethod)
+
+#endif /*SEMIIMPLICITEULERNUMERICALMETHOD_HPP_*/
@@ -64,6 +64,32 @@ void AbstractCellBasedWriter<ELEMENT_DIM, SPACE_DIM>::OpenOutputFileForAppend(Ou
     mpOutStream = rOutputFileHandler.OpenOutputFile(mFileName, std::ios::app);
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractCellBasedWriter<ELEMENT_DIM, SPACE_DIM>::OpenOutputBuffer()
+{
+    if (!mpOutputBuffer)
+    {
+        mpOutputBuffer.reset(new std::stringbuf(std::ios::out));
+    }
+    mpOutputBuffer->str(std::string());
+
+    // An unopened file stream whose stream buffer is replaced by mpOutputBuffer
+    mpOutStream.reset(new std::ofstream);
+    static_cast<std::ostream&>(*mpOutStream).rdbuf(mpOutputBuffer.get());
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+std::string AbstractCellBasedWriter<ELEMENT_DIM, SPACE_DIM>::TakeBufferedOutput()
+{
+    std::string output;
+    if (mpOutputBuffer)
+    {
+        output = mpOutputBuffer->str();
+        mpOutputBuffer->str(std::string());
+    }
+    return output;
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void AbstractCellBasedWriter<ELEMENT_DIM, SPACE_DIM>::WriteTimeStamp()
 {
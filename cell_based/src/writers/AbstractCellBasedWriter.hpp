@@ -41,6 +41,9 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "Identifiable.hpp"
 #include "OutputFileHandler.hpp"
 
+#include <sstream>
+#include <boost/shared_ptr.hpp>
+
 /**
  * Abstract class for a writer that takes data from an AbstractCellPopulation and writes it to file.
  */
@@ -71,6 +74,12 @@ protected:
     /** An output stream for writing data. */
     out_stream mpOutStream;
 
+    /**
+     * A buffer that mpOutStream writes to in place of a file, when opened using
+     * OpenOutputBuffer().
+     */
+    boost::shared_ptr<std::stringbuf> mpOutputBuffer;
+
 public:
 
     /**
@@ -105,6 +114,20 @@ public:
      */
     void OpenOutputFileForAppend(OutputFileHandler& rOutputFileHandler);
 
+    /**
+     * Open mpOutStream for writing into an in-memory buffer rather than a file,
+     * so that the output can be collected into a single binary results file.
+     * Any previously buffered output is discarded.
+     */
+    void OpenOutputBuffer();
+
+    /**
+     * Return and clear the output written since OpenOutputBuffer() was called.
+     *
+     * @return the buffered output
+     */
+    std::string TakeBufferedOutput();
+
     /**
      * Write the current time stamp to mpOutStream.
      */
@@ -0,0 +1,97 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef BACKGROUNDRESULTSWRITER_HPP_
+#define BACKGROUNDRESULTSWRITER_HPP_
+
+#include "AsynchronousIoChannel.hpp"
+#include "CellBasedBinaryResultsFile.hpp"
+#include "OutputFileHandler.hpp"
+
+/**
+ * Writes chunks of a binary results file (see CellBasedBinaryResultsFile) on an
+ * I/O worker thread of the AsynchronousIoService, so that a simulation can carry
+ * on while its output goes to disk.
+ *
+ * Chunks are written in the order in which they are queued. The queue is bounded:
+ * if it is full then Enqueue() waits for the oldest chunk to be written. Any error
+ * raised while writing is rethrown by the next call to Enqueue() or Flush().
+ *
+ * Only one process may append to a binary results file at a time, so this class
+ * should only be used in sequential runs.
+ */
+class BackgroundResultsWriter
+{
+private:
+
+    /** The channel through which chunks are written; it allows at most the maximum queue length of chunks to be outstanding. */
+    AsynchronousIoChannel mChannel;
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param maxQueueLength the maximum number of chunks waiting to be written (defaults to 4)
+     */
+    BackgroundResultsWriter(unsigned maxQueueLength=4);
+
+    /**
+     * Destructor. Waits for all queued chunks to be written.
+     * Errors raised while writing are not reported here; call Flush() first to see them.
+     */
+    ~BackgroundResultsWriter();
+
+    /**
+     * Queue a chunk to be appended to its binary results file. The chunk's entries are
+     * moved into the queue, so it is left empty.
+     *
+     * @param rChunk the chunk to write
+     * @param rOutputFileHandler handler for the directory containing the binary results file
+     */
+    void Enqueue(CellBasedBinaryResultsFile& rChunk, const OutputFileHandler& rOutputFileHandler);
+
+    /**
+     * Wait until all queued chunks have been written.
+     */
+    void Flush();
+
+    /**
+     * @return mMaxQueueLength
+     */
+    unsigned GetMaxQueueLength() const;
+};
+
+#endif /*BACKGROUNDRESULTSWRITER_HPP_*/
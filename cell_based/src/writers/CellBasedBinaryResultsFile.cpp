@@ -0,0 +1,165 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "CellBasedBinaryResultsFile.hpp"
+
+#include <fstream>
+#include <map>
+#include <boost/cstdint.hpp>
+
+#include "Exception.hpp"
+
+/** Identifies a binary results file, and the version of its layout. */
+static const std::string BINARY_RESULTS_MAGIC("CHASTE_CELL_BASED_RESULTS_1\n");
+
+const std::string CellBasedBinaryResultsFile::DEFAULT_FILE_NAME("results.cellbin");
+
+CellBasedBinaryResultsFile::CellBasedBinaryResultsFile(const std::string& rFileName)
+    : mFileName(rFileName)
+{
+}
+
+const std::string& CellBasedBinaryResultsFile::rGetFileName() const
+{
+    return mFileName;
+}
+
+void CellBasedBinaryResultsFile::AddEntry(const std::string& rLegacyFileName, const std::string& rData)
+{
+    mEntries.push_back(std::make_pair(rLegacyFileName, rData));
+}
+
+unsigned CellBasedBinaryResultsFile::GetNumEntries() const
+{
+    return mEntries.size();
+}
+
+void CellBasedBinaryResultsFile::Swap(CellBasedBinaryResultsFile& rOther)
+{
+    mFileName.swap(rOther.mFileName);
+    mEntries.swap(rOther.mEntries);
+}
+
+void CellBasedBinaryResultsFile::WriteChunk(OutputFileHandler& rOutputFileHandler, bool append)
+{
+    std::ios_base::openmode mode = std::ios::out | std::ios::binary | (append ? std::ios::app : std::ios::trunc);
+    out_stream p_file = rOutputFileHandler.OpenOutputFile(mFileName, mode);
+
+    if (!append)
+    {
+        p_file->write(BINARY_RESULTS_MAGIC.data(), BINARY_RESULTS_MAGIC.size());
+    }
+
+    boost::uint32_t num_entries = mEntries.size();
+    p_file->write(reinterpret_cast<const char*>(&num_entries), sizeof(num_entries));
+
+    for (unsigned i=0; i<mEntries.size(); i++)
+    {
+        const std::string& r_name = mEntries[i].first;
+        const std::string& r_data = mEntries[i].second;
+
+        boost::uint32_t name_length = r_name.size();
+        boost::uint64_t data_length = r_data.size();
+        p_file->write(reinterpret_cast<const char*>(&name_length), sizeof(name_length));
+        p_file->write(r_name.data(), name_length);
+        p_file->write(reinterpret_cast<const char*>(&data_length), sizeof(data_length));
+        p_file->write(r_data.data(), data_length);
+    }
+
+    p_file->close();
+    mEntries.clear();
+}
+
+void CellBasedBinaryResultsFile::ConvertToLegacyFiles(const FileFinder& rBinaryFile, OutputFileHandler& rOutputFileHandler)
+{
+    std::ifstream binary_file(rBinaryFile.GetAbsolutePath().c_str(), std::ios::binary);
+    if (!binary_file.is_open())
+    {
+        EXCEPTION("Could not open binary results file " << rBinaryFile.GetAbsolutePath());
+    }
+
+    std::string magic(BINARY_RESULTS_MAGIC.size(), '\0');
+    binary_file.read(&magic[0], magic.size());
+    if (!binary_file || magic != BINARY_RESULTS_MAGIC)
+    {
+        EXCEPTION("The file " << rBinaryFile.GetAbsolutePath() << " is not a cell-based binary results file");
+    }
+
+    // Each legacy file is created on the first chunk that mentions it, and appended to thereafter
+    std::map<std::string, out_stream> legacy_files;
+
+    boost::uint32_t num_entries;
+    while (binary_file.read(reinterpret_cast<char*>(&num_entries), sizeof(num_entries)))
+    {
+        for (unsigned i=0; i<num_entries; i++)
+        {
+            boost::uint32_t name_length;
+            boost::uint64_t data_length;
+            std::string name;
+            std::string data;
+
+            binary_file.read(reinterpret_cast<char*>(&name_length), sizeof(name_length));
+            if (binary_file)
+            {
+                name.resize(name_length);
+                binary_file.read(&name[0], name_length);
+            }
+            binary_file.read(reinterpret_cast<char*>(&data_length), sizeof(data_length));
+            if (binary_file)
+            {
+                data.resize(data_length);
+                binary_file.read(&data[0], data_length);
+            }
+            if (!binary_file)
+            {
+                EXCEPTION("The binary results file " << rBinaryFile.GetAbsolutePath() << " is truncated");
+            }
+
+            std::map<std::string, out_stream>::iterator file_iter = legacy_files.find(name);
+            if (file_iter == legacy_files.end())
+            {
+                file_iter = legacy_files.insert(std::make_pair(name, rOutputFileHandler.OpenOutputFile(name))).first;
+            }
+            file_iter->second->write(data.data(), data.size());
+        }
+    }
+
+    for (std::map<std::string, out_stream>::iterator file_iter = legacy_files.begin();
+         file_iter != legacy_files.end();
+         ++file_iter)
+    {
+        file_iter->second->close();
+    }
+}
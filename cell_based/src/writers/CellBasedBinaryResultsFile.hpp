@@ -0,0 +1,122 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef CELLBASEDBINARYRESULTSFILE_HPP_
+#define CELLBASEDBINARYRESULTSFILE_HPP_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "FileFinder.hpp"
+#include "OutputFileHandler.hpp"
+
+/**
+ * A single binary file holding the output of all the writers of a cell population.
+ *
+ * The file starts with a short identifying header and is followed by a sequence of
+ * chunks, one for each time the writers' output is flushed (the headers written when
+ * the writers are opened, then once per output time step and process). Each chunk
+ * contains, for each writer, the name of the legacy output file it would have written
+ * to and the exact bytes it would have appended to that file. This means that the
+ * legacy .dat and .viz files can always be recovered exactly using
+ * ConvertToLegacyFiles().
+ */
+class CellBasedBinaryResultsFile
+{
+private:
+
+    /** The name of the binary results file. */
+    std::string mFileName;
+
+    /** The entries of the current chunk, as pairs of legacy file name and data. */
+    std::vector<std::pair<std::string, std::string> > mEntries;
+
+public:
+
+    /** The default name of the binary results file. */
+    static const std::string DEFAULT_FILE_NAME;
+
+    /**
+     * Constructor.
+     *
+     * @param rFileName the name of the binary results file (defaults to DEFAULT_FILE_NAME)
+     */
+    CellBasedBinaryResultsFile(const std::string& rFileName=DEFAULT_FILE_NAME);
+
+    /**
+     * @return the name of the binary results file.
+     */
+    const std::string& rGetFileName() const;
+
+    /**
+     * Add an entry to the current chunk.
+     *
+     * @param rLegacyFileName the name of the file the data would otherwise have been written to
+     * @param rData the data
+     */
+    void AddEntry(const std::string& rLegacyFileName, const std::string& rData);
+
+    /**
+     * @return the number of entries in the current chunk.
+     */
+    unsigned GetNumEntries() const;
+
+    /**
+     * Swap the file name and current chunk of this object with those of another.
+     *
+     * @param rOther the other object
+     */
+    void Swap(CellBasedBinaryResultsFile& rOther);
+
+    /**
+     * Write the current chunk to file and then clear it.
+     *
+     * @param rOutputFileHandler handler for the directory containing the binary results file
+     * @param append whether to append to an existing file, rather than create the file afresh
+     */
+    void WriteChunk(OutputFileHandler& rOutputFileHandler, bool append=true);
+
+    /**
+     * Recreate the legacy output files from a binary results file. Any existing files
+     * with the same names in the output directory are overwritten.
+     *
+     * @param rBinaryFile the binary results file
+     * @param rOutputFileHandler handler for the directory in which to write the legacy files
+     */
+    static void ConvertToLegacyFiles(const FileFinder& rBinaryFile, OutputFileHandler& rOutputFileHandler);
+};
+
+#endif /*CELLBASEDBINARYRESULTSFILE_HPP_*/
@@ -75,6 +75,9 @@ private:
      */
     std::string mCellDataVariableName;
 
+    /** The index of mCellDataVariableName in CellData, so that the name need not be looked up for each cell. */
+    unsigned mCellDataItemIndex;
+
 public:
 
     /**
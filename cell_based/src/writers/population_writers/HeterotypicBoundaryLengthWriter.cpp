@@ -140,10 +140,10 @@ void HeterotypicBoundaryLengthWriter<ELEMENT_DIM, SPACE_DIM>::Visit(CaBasedCellP
         bool cell_is_labelled = cell_iter->template HasCellProperty<CellLabel>();
 
         // Get this node's von Neumann neighbours (not Moore neighbours, since they must share an edge)
-        std::set<unsigned> neighbour_node_indices = pCellPopulation->rGetMesh().GetVonNeumannNeighbouringNodeIndices(index);
+        const std::set<unsigned>& neighbour_node_indices = pCellPopulation->rGetMesh().rGetVonNeumannNeighbouringNodeIndices(index);
 
         // Iterate over these neighbours
-        for (std::set<unsigned>::iterator neighbour_iter = neighbour_node_indices.begin();
+        for (std::set<unsigned>::const_iterator neighbour_iter = neighbour_node_indices.begin();
              neighbour_iter != neighbour_node_indices.end();
              ++neighbour_iter)
         {
@@ -209,13 +209,13 @@ void HeterotypicBoundaryLengthWriter<ELEMENT_DIM, SPACE_DIM>::Visit(NodeBasedCel
         unsigned node_index = pCellPopulation->GetLocationIndexUsingCell(*cell_iter);
         double node_radius = pCellPopulation->GetNode(node_index)->GetRadius();
 
-        // Get the set of neighbouring node indices
-        std::set<unsigned> neighbour_indices = pCellPopulation->GetNeighbouringNodeIndices(node_index);
+        // Get the neighbouring node indices
+        NodeIndexRange neighbour_indices = pCellPopulation->GetCachedNeighbouringNodeIndices(node_index);
 
         if (!neighbour_indices.empty())
         {
             // Iterate over these neighbours
-            for (std::set<unsigned>::iterator neighbour_iter = neighbour_indices.begin();
+            for (const unsigned* neighbour_iter = neighbour_indices.begin();
                  neighbour_iter != neighbour_indices.end();
                  ++neighbour_iter)
             {
@@ -294,10 +294,10 @@ void HeterotypicBoundaryLengthWriter<ELEMENT_DIM, SPACE_DIM>::Visit(PottsBasedCe
         {
             // Get this node's von Neumann neighbours (not Moore neighbours, since they must share an edge)
             unsigned global_index = pCellPopulation->rGetMesh().GetElement(elem_index)->GetNodeGlobalIndex(local_index);
-            std::set<unsigned> neighbour_node_indices = pCellPopulation->rGetMesh().GetVonNeumannNeighbouringNodeIndices(global_index);
+            const std::set<unsigned>& neighbour_node_indices = pCellPopulation->rGetMesh().rGetVonNeumannNeighbouringNodeIndices(global_index);
 
             // Iterate over these neighbours
-            for (std::set<unsigned>::iterator neighbour_iter = neighbour_node_indices.begin();
+            for (std::set<unsigned>::const_iterator neighbour_iter = neighbour_node_indices.begin();
                  neighbour_iter != neighbour_node_indices.end();
                  ++neighbour_iter)
             {
@@ -257,6 +257,68 @@ public:
             TS_ASSERT_DELTA(rep_another_item_1[0], 42.0, 2e-14);
         }
     }
+
+    void TestArchivingOfDaughterCell()
+    {
+        OutputFileHandler handler("archive", false);
+        handler.SetArchiveDirectory();
+        std::string archive_filename = handler.GetOutputDirectoryFullPath() + "daughter_cell.arch";
+
+        // Archive a daughter cell, which is allocated from a pool by Divide()
+        {
+            SimulationTime* p_simulation_time = SimulationTime::Instance();
+            p_simulation_time->SetEndTimeAndNumberOfTimeSteps(30.0, 60);
+
+            boost::shared_ptr<AbstractCellProperty> p_healthy_state(CellPropertyRegistry::Instance()->Get<WildTypeCellMutationState>());
+            boost::shared_ptr<AbstractCellProperty> p_type(CellPropertyRegistry::Instance()->Get<StemCellProliferativeType>());
+
+            CellPtr p_cell(new Cell(p_healthy_state, new FixedG1GenerationalCellCycleModel()));
+            p_cell->SetCellProliferativeType(p_type);
+            p_cell->InitialiseCellCycleModel();
+            p_cell->GetCellData()->SetItem("concentration", 3.5);
+
+            while (!p_cell->ReadyToDivide())
+            {
+                p_simulation_time->IncrementTimeOneStep();
+            }
+            CellPtr p_daughter_cell = p_cell->Divide();
+
+            // The daughter cell should have its own copy of the cell data
+            TS_ASSERT_DIFFERS(p_daughter_cell->GetCellData(), p_cell->GetCellData());
+            TS_ASSERT_DELTA(p_daughter_cell->GetCellData()->GetItem("concentration"), 3.5, 1e-12);
+            p_daughter_cell->GetCellData()->SetItem("concentration", 7.0);
+            TS_ASSERT_DELTA(p_cell->GetCellData()->GetItem("concentration"), 3.5, 1e-12);
+            TS_ASSERT_EQUALS(p_daughter_cell->GetCellCycleModel()->GetCell(), p_daughter_cell);
+
+            std::ofstream ofs(archive_filename.c_str());
+            boost::archive::text_oarchive output_arch(ofs);
+
+            CellPtr const p_const_daughter_cell = p_daughter_cell;
+            output_arch << static_cast<const SimulationTime&> (*p_simulation_time);
+            output_arch << p_const_daughter_cell;
+
+            SimulationTime::Destroy();
+        }
+
+        // Restore the daughter cell
+        {
+            SimulationTime* p_simulation_time = SimulationTime::Instance();
+            p_simulation_time->SetStartTime(0.0);
+
+            CellPtr p_daughter_cell;
+
+            std::ifstream ifs(archive_filename.c_str(), std::ios::binary);
+            boost::archive::text_iarchive input_arch(ifs);
+
+            input_arch >> *p_simulation_time;
+            input_arch >> p_daughter_cell;
+
+            TS_ASSERT_DELTA(p_daughter_cell->GetAge(), 0.0, 1e-12);
+            TS_ASSERT_EQUALS(static_cast<FixedG1GenerationalCellCycleModel*>(p_daughter_cell->GetCellCycleModel())->GetGeneration(), 1u);
+            TS_ASSERT_EQUALS(p_daughter_cell->GetCellCycleModel()->GetCell(), p_daughter_cell);
+            TS_ASSERT_DELTA(p_daughter_cell->GetCellData()->GetItem("concentration"), 7.0, 1e-12);
+        }
+    }
 };
 
 #endif /*TESTARCHIVECELL_HPP_*/
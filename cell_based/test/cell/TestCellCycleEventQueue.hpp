@@ -0,0 +1,225 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef TESTCELLCYCLEEVENTQUEUE_HPP_
+#define TESTCELLCYCLEEVENTQUEUE_HPP_
+
+#include <cxxtest/TestSuite.h>
+
+#include <climits>
+
+#include "AbstractCellBasedTestSuite.hpp"
+#include "BernoulliTrialCellCycleModel.hpp"
+#include "CellCycleEventQueue.hpp"
+#include "ContactInhibitionCellCycleModel.hpp"
+#include "DifferentiatedCellProliferativeType.hpp"
+#include "FixedG1GenerationalCellCycleModel.hpp"
+#include "NoCellCycleModel.hpp"
+#include "SmartPointers.hpp"
+#include "TransitCellProliferativeType.hpp"
+#include "UniformCellCycleModel.hpp"
+#include "WildTypeCellMutationState.hpp"
+
+//This test is always run sequentially (never in parallel)
+#include "FakePetscSetup.hpp"
+
+class TestCellCycleEventQueue : public AbstractCellBasedTestSuite
+{
+public:
+
+    void TestCellCycleModelNextEventTimes()
+    {
+        SimulationTime* p_simulation_time = SimulationTime::Instance();
+        p_simulation_time->SetEndTimeAndNumberOfTimeSteps(12.0, 24);
+
+        MAKE_PTR(WildTypeCellMutationState, p_state);
+        MAKE_PTR(TransitCellProliferativeType, p_transit_type);
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_diff_type);
+
+        // A cell with no cell-cycle model never divides
+        NoCellCycleModel* p_no_model = new NoCellCycleModel;
+        CellPtr p_no_cell(new Cell(p_state, p_no_model));
+        p_no_cell->SetCellProliferativeType(p_transit_type);
+        p_no_cell->InitialiseCellCycleModel();
+        TS_ASSERT_EQUALS(p_no_model->CanPredictNextEventTime(), true);
+        TS_ASSERT_EQUALS(p_no_model->GetNextEventTime(), DBL_MAX);
+
+        // Simple models divide once their age reaches the cell cycle duration
+        UniformCellCycleModel* p_uniform_model = new UniformCellCycleModel;
+        CellPtr p_uniform_cell(new Cell(p_state, p_uniform_model));
+        p_uniform_cell->SetCellProliferativeType(p_transit_type);
+        p_uniform_cell->InitialiseCellCycleModel();
+        TS_ASSERT_EQUALS(p_uniform_model->CanPredictNextEventTime(), true);
+        TS_ASSERT_DELTA(p_uniform_model->GetNextEventTime(), p_uniform_model->GetCellCycleDuration(), 1e-12);
+
+        UniformCellCycleModel* p_uniform_diff_model = new UniformCellCycleModel;
+        CellPtr p_uniform_diff_cell(new Cell(p_state, p_uniform_diff_model));
+        p_uniform_diff_cell->SetCellProliferativeType(p_diff_type);
+        p_uniform_diff_cell->InitialiseCellCycleModel();
+        TS_ASSERT_EQUALS(p_uniform_diff_model->GetNextEventTime(), DBL_MAX);
+
+        // Simple phase-based models have an event at each change of phase
+        FixedG1GenerationalCellCycleModel* p_fixed_model = new FixedG1GenerationalCellCycleModel;
+        CellPtr p_fixed_cell(new Cell(p_state, p_fixed_model));
+        p_fixed_cell->SetCellProliferativeType(p_transit_type);
+        p_fixed_cell->InitialiseCellCycleModel();
+        TS_ASSERT_EQUALS(p_fixed_model->CanPredictNextEventTime(), true);
+
+        FixedG1GenerationalCellCycleModel* p_fixed_diff_model = new FixedG1GenerationalCellCycleModel;
+        CellPtr p_fixed_diff_cell(new Cell(p_state, p_fixed_diff_model));
+        p_fixed_diff_cell->SetCellProliferativeType(p_diff_type);
+        p_fixed_diff_cell->InitialiseCellCycleModel();
+
+        // The differentiated cell must be checked once so that it enters G0 phase
+        TS_ASSERT_DELTA(p_fixed_diff_model->GetNextEventTime(), 0.0, 1e-12);
+
+        // With the default durations the phase boundaries are at 1, 3, 8 and 12 hours
+        double expected_event_times[4] = {1.0, 3.0, 8.0, 12.0};
+        for (unsigned event=0; event<4; event++)
+        {
+            TS_ASSERT_DELTA(p_fixed_model->GetNextEventTime(), expected_event_times[event], 1e-12);
+            while (p_simulation_time->GetTime() < expected_event_times[event] - 1e-12)
+            {
+                p_simulation_time->IncrementTimeOneStep();
+                TS_ASSERT_EQUALS(p_fixed_diff_cell->ReadyToDivide(), false);
+                TS_ASSERT_EQUALS(p_fixed_diff_model->GetNextEventTime(), DBL_MAX);
+            }
+            TS_ASSERT_EQUALS(p_fixed_cell->ReadyToDivide(), event == 3);
+        }
+        TS_ASSERT_EQUALS(p_fixed_model->GetCurrentCellCyclePhase(), G_TWO_PHASE);
+        TS_ASSERT_DELTA(p_fixed_model->GetNextEventTime(), 12.0, 1e-12);
+
+        // Models whose progress depends on their environment or on ODEs are polled
+        ContactInhibitionCellCycleModel contact_inhibition_model;
+        TS_ASSERT_EQUALS(contact_inhibition_model.CanPredictNextEventTime(), false);
+
+        BernoulliTrialCellCycleModel bernoulli_model;
+        TS_ASSERT_EQUALS(bernoulli_model.CanPredictNextEventTime(), false);
+        TS_ASSERT_EQUALS(bernoulli_model.GetNextEventTime(), DOUBLE_UNSET);
+    }
+
+    void TestCellCycleEventQueueMethods()
+    {
+        SimulationTime* p_simulation_time = SimulationTime::Instance();
+        p_simulation_time->SetEndTimeAndNumberOfTimeSteps(24.0, 24);
+
+        MAKE_PTR(WildTypeCellMutationState, p_state);
+        MAKE_PTR(TransitCellProliferativeType, p_transit_type);
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_diff_type);
+
+        std::vector<CellPtr> cells;
+
+        // Cell 0 is due to divide at some time between 12 and 14 hours
+        UniformCellCycleModel* p_uniform_model = new UniformCellCycleModel;
+        cells.push_back(CellPtr(new Cell(p_state, p_uniform_model)));
+        cells.back()->SetCellProliferativeType(p_transit_type);
+
+        // Cell 1 next needs to be checked at 1 hour, when it leaves M phase
+        cells.push_back(CellPtr(new Cell(p_state, new FixedG1GenerationalCellCycleModel)));
+        cells.back()->SetCellProliferativeType(p_transit_type);
+
+        // Cell 2 never divides
+        cells.push_back(CellPtr(new Cell(p_state, new UniformCellCycleModel)));
+        cells.back()->SetCellProliferativeType(p_diff_type);
+
+        // Cell 3 must be polled
+        cells.push_back(CellPtr(new Cell(p_state, new BernoulliTrialCellCycleModel)));
+        cells.back()->SetCellProliferativeType(p_transit_type);
+
+        // Cell 4 is apoptotic, so never divides
+        cells.push_back(CellPtr(new Cell(p_state, new FixedG1GenerationalCellCycleModel)));
+        cells.back()->SetCellProliferativeType(p_transit_type);
+
+        CellCycleEventQueue queue;
+        TS_ASSERT_EQUALS(queue.GetMaxCellId(), UINT_MAX);
+        queue.SetMaxCellId(5);
+        TS_ASSERT_EQUALS(queue.GetMaxCellId(), 5u);
+
+        for (unsigned i=0; i<cells.size(); i++)
+        {
+            cells[i]->InitialiseCellCycleModel();
+        }
+        cells[4]->StartApoptosis();
+
+        // Add the cells in reverse order
+        for (unsigned i=0; i<cells.size(); i++)
+        {
+            queue.AddCell(cells[cells.size() - 1 - i]);
+        }
+        TS_ASSERT_EQUALS(queue.GetNumScheduledCells(), 2u);
+        TS_ASSERT_EQUALS(queue.GetNumPolledCells(), 1u);
+
+        // Only the polled cell needs checking now
+        std::vector<CellPtr> due_cells = queue.GetCellsToCheck(0.0);
+        TS_ASSERT_EQUALS(due_cells.size(), 1u);
+        TS_ASSERT_EQUALS(due_cells[0], cells[3]);
+        TS_ASSERT_EQUALS(queue.GetNumPolledCells(), 0u);
+        TS_ASSERT_EQUALS(queue.GetNumScheduledCells(), 2u);
+
+        // Returned cells are removed from the queue until they are added again
+        queue.AddCell(cells[3]);
+        due_cells = queue.GetCellsToCheck(20.0);
+        TS_ASSERT_EQUALS(due_cells.size(), 3u);
+        TS_ASSERT_EQUALS(due_cells[0], cells[0]);
+        TS_ASSERT_EQUALS(due_cells[1], cells[1]);
+        TS_ASSERT_EQUALS(due_cells[2], cells[3]);
+        TS_ASSERT_EQUALS(queue.GetNumScheduledCells(), 0u);
+        TS_ASSERT_EQUALS(queue.GetNumPolledCells(), 0u);
+
+        // Dead cells are dropped as they come due
+        queue.AddCell(cells[0]);
+        queue.AddCell(cells[1]);
+        queue.AddCell(cells[3]);
+        cells[0]->Kill();
+        cells[3]->Kill();
+        due_cells = queue.GetCellsToCheck(p_uniform_model->GetNextEventTime());
+        TS_ASSERT_EQUALS(due_cells.size(), 1u);
+        TS_ASSERT_EQUALS(due_cells[0], cells[1]);
+        TS_ASSERT_EQUALS(queue.GetNumScheduledCells(), 0u);
+
+        // Dead cells are not added
+        queue.AddCell(cells[0]);
+        TS_ASSERT_EQUALS(queue.GetNumScheduledCells(), 0u);
+
+        queue.AddCell(cells[1]);
+        TS_ASSERT_EQUALS(queue.GetNumScheduledCells(), 1u);
+        queue.Clear();
+        TS_ASSERT_EQUALS(queue.GetNumScheduledCells(), 0u);
+        TS_ASSERT_EQUALS(queue.GetMaxCellId(), UINT_MAX);
+    }
+};
+
+#endif /*TESTCELLCYCLEEVENTQUEUE_HPP_*/
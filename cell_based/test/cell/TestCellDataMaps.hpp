@@ -100,6 +100,44 @@ public:
         TS_ASSERT_EQUALS(p_daughtercell_data->GetItem("some other thing"), 2.0);
     }
 
+    void TestCellDataItemIndices()
+    {
+        CellData cell_data;
+        cell_data.SetItem("zeta", 1.0);
+        cell_data.SetItem("alpha", 2.0);
+        cell_data.SetItem("middle", 3.0);
+        cell_data.SetItem("zeta", 4.0);
+
+        TS_ASSERT_EQUALS(cell_data.GetNumItems(), 3u);
+
+        // Keys are always returned in alphabetical order
+        std::vector<std::string> keys = cell_data.GetKeys();
+        TS_ASSERT_EQUALS(keys.size(), 3u);
+        TS_ASSERT_EQUALS(keys[0], "alpha");
+        TS_ASSERT_EQUALS(keys[1], "middle");
+        TS_ASSERT_EQUALS(keys[2], "zeta");
+
+        // Item indices are shared by all CellData objects
+        unsigned middle_index = CellData::GetItemIndex("middle");
+        TS_ASSERT_EQUALS(CellData::GetItemIndex("middle"), middle_index);
+        TS_ASSERT_EQUALS(CellData::GetItemName(middle_index), "middle");
+        TS_ASSERT_DELTA(cell_data.GetItem(middle_index), 3.0, 1e-12);
+
+        cell_data.SetItem(middle_index, 5.0);
+        TS_ASSERT_DELTA(cell_data.GetItem("middle"), 5.0, 1e-12);
+        TS_ASSERT_EQUALS(cell_data.GetNumItems(), 3u);
+
+        CellData other_cell_data;
+        other_cell_data.SetItem(middle_index, 6.0);
+        TS_ASSERT_DELTA(other_cell_data.GetItem("middle"), 6.0, 1e-12);
+        TS_ASSERT_DELTA(cell_data.GetItem(middle_index), 5.0, 1e-12);
+
+        // Looking up an item that is not stored throws, whether by name or by index
+        TS_ASSERT_THROWS_THIS(cell_data.GetItem("unknown"), "The item unknown is not stored");
+        unsigned missing_index = CellData::GetItemIndex("missing");
+        TS_ASSERT_THROWS_THIS(cell_data.GetItem(missing_index), "The item missing is not stored");
+    }
+
     void TestCellVecData()
     {
         SimulationTime* p_simulation_time = SimulationTime::Instance();
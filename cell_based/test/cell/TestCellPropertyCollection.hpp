@@ -135,6 +135,24 @@ public:
         TS_ASSERT( *it == wild_types.GetProperty() );
         TS_ASSERT_THROWS_THIS(collection.GetProperty(),
                               "Can only call GetProperty on a collection of size 1.");
+
+        // Get a single matching property without creating a new collection
+        boost::shared_ptr<AbstractCellMutationState> p_mutation = collection.GetPropertyType<AbstractCellMutationState>();
+        TS_ASSERT(p_mutation == p_wt_mutation || p_mutation == p_apc1_mutation);
+        TS_ASSERT(collection.GetPropertyType<WildTypeCellMutationState>() == p_wt_mutation);
+        TS_ASSERT(!collection.GetPropertyType<ApcTwoHitCellMutationState>());
+
+        // The type lookups should be updated when the collection is copied or changed
+        CellPropertyCollection copied_collection = collection;
+        collection.RemoveProperty(p_wt_mutation);
+        TS_ASSERT(collection.GetPropertyType<AbstractCellMutationState>() == p_apc1_mutation);
+        TS_ASSERT(!collection.GetPropertyType<WildTypeCellMutationState>());
+        TS_ASSERT_EQUALS(collection.GetPropertiesType<AbstractCellMutationState>().GetSize(), 1u);
+        TS_ASSERT_EQUALS(copied_collection.HasProperty<WildTypeCellMutationState>(), true);
+        TS_ASSERT_EQUALS(copied_collection.GetPropertiesType<AbstractCellMutationState>().GetSize(), 2u);
+        collection.RemoveProperty<ApcOneHitCellMutationState>();
+        TS_ASSERT_EQUALS(collection.HasPropertyType<AbstractCellMutationState>(), false);
+        TS_ASSERT(!collection.GetPropertyType<AbstractCellProperty>());
     }
 
     void TestArchiveCellPropertyCollection()
@@ -182,6 +200,8 @@ public:
 
             TS_ASSERT_EQUALS(collection.HasPropertyType<AbstractCellProperty>(), true);
             TS_ASSERT_EQUALS(collection.HasPropertyType<AbstractCellMutationState>(), true);
+            TS_ASSERT_EQUALS(collection.GetPropertiesType<AbstractCellMutationState>().GetSize(), 2u);
+            TS_ASSERT(collection.GetPropertyType<ApcOneHitCellMutationState>());
 
             for (CellPropertyCollection::Iterator it = collection.Begin(); it != collection.End(); ++it)
             {
@@ -47,6 +47,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "NullSrnModel.hpp"
 #include "DeltaNotchSrnModel.hpp"
 #include "Goldbeter1991SrnModel.hpp"
+#include "SrnModelBatchSimulator.hpp"
 #include "UniformG1GenerationalCellCycleModel.hpp"
 #include "AbstractCellBasedTestSuite.hpp"
 #include "OutputFileHandler.hpp"
@@ -328,6 +329,106 @@ public:
         }
     }
 
+    void TestSrnModelBatchSimulator()
+    {
+        SrnModelBatchSimulator simulator;
+        TS_ASSERT_EQUALS(simulator.GetNumberOfThreads(), 1u);
+        TS_ASSERT_EQUALS(simulator.GetBlockSize(), 32u);
+        TS_ASSERT_THROWS_THIS(simulator.SetNumberOfThreads(0), "The number of SRN model threads must be at least one.");
+        TS_ASSERT_THROWS_THIS(simulator.SetBlockSize(0), "The SRN model block size must be at least one.");
+        simulator.SetNumberOfThreads(2);
+        simulator.SetBlockSize(7);
+        TS_ASSERT_EQUALS(simulator.GetNumberOfThreads(), 2u);
+        TS_ASSERT_EQUALS(simulator.GetBlockSize(), 7u);
+
+        MAKE_PTR(WildTypeCellMutationState, p_healthy_state);
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_diff_type);
+
+        // Create two identical sets of cells, with a mixture of SRN models
+        std::list<CellPtr> serial_cells;
+        std::list<CellPtr> batched_cells;
+        for (unsigned set=0; set<2; set++)
+        {
+            std::list<CellPtr>& r_cells = (set == 0) ? serial_cells : batched_cells;
+            for (unsigned i=0; i<40; i++)
+            {
+                AbstractSrnModel* p_srn_model;
+                if (i%5 == 4)
+                {
+                    p_srn_model = new Goldbeter1991SrnModel();
+                }
+                else if (i == 10)
+                {
+                    p_srn_model = new NullSrnModel();
+                }
+                else
+                {
+                    std::vector<double> initial_conditions;
+                    initial_conditions.push_back(0.1 + 0.02*i);
+                    initial_conditions.push_back(0.9 - 0.02*i);
+                    DeltaNotchSrnModel* p_delta_notch_model = new DeltaNotchSrnModel();
+                    p_delta_notch_model->SetInitialConditions(initial_conditions);
+                    p_srn_model = p_delta_notch_model;
+                }
+
+                CellPtr p_cell(new Cell(p_healthy_state, new UniformG1GenerationalCellCycleModel(), p_srn_model, false, CellPropertyCollection()));
+                p_cell->SetCellProliferativeType(p_diff_type);
+                p_cell->GetCellData()->SetItem("mean delta", 0.05*i);
+                p_cell->InitialiseCellCycleModel();
+                p_cell->InitialiseSrnModel();
+                r_cells.push_back(p_cell);
+            }
+        }
+
+        SimulationTime* p_simulation_time = SimulationTime::Instance();
+        unsigned num_steps = 20;
+        double end_time = 2.0;
+        p_simulation_time->SetEndTimeAndNumberOfTimeSteps(end_time, num_steps);
+
+        while (p_simulation_time->GetTime() < end_time)
+        {
+            p_simulation_time->IncrementTimeOneStep();
+
+            // Change the coupling data, as a tracking modifier would
+            unsigned cell_index = 0;
+            std::list<CellPtr>::iterator batched_iter = batched_cells.begin();
+            for (std::list<CellPtr>::iterator serial_iter = serial_cells.begin();
+                 serial_iter != serial_cells.end();
+                 ++serial_iter, ++batched_iter, ++cell_index)
+            {
+                double mean_delta = 0.05*cell_index + 0.1*p_simulation_time->GetTime();
+                (*serial_iter)->GetCellData()->SetItem("mean delta", mean_delta);
+                (*batched_iter)->GetCellData()->SetItem("mean delta", mean_delta);
+                (*serial_iter)->GetSrnModel()->SimulateToCurrentTime();
+            }
+
+            simulator.SimulateToCurrentTime(batched_cells);
+        }
+
+        // The batched models should give exactly the same results
+        std::list<CellPtr>::iterator batched_iter = batched_cells.begin();
+        for (std::list<CellPtr>::iterator serial_iter = serial_cells.begin();
+             serial_iter != serial_cells.end();
+             ++serial_iter, ++batched_iter)
+        {
+            AbstractSrnModel* p_serial_model = (*serial_iter)->GetSrnModel();
+            AbstractSrnModel* p_batched_model = (*batched_iter)->GetSrnModel();
+            TS_ASSERT_DELTA(p_batched_model->GetSimulatedToTime(), end_time, 1e-12);
+
+            AbstractOdeSrnModel* p_serial_ode_model = dynamic_cast<AbstractOdeSrnModel*>(p_serial_model);
+            if (p_serial_ode_model != nullptr)
+            {
+                std::vector<double> serial_state = p_serial_ode_model->GetProteinConcentrations();
+                std::vector<double> batched_state = static_cast<AbstractOdeSrnModel*>(p_batched_model)->GetProteinConcentrations();
+                TS_ASSERT_EQUALS(serial_state.size(), batched_state.size());
+                for (unsigned i=0; i<serial_state.size(); i++)
+                {
+                    TS_ASSERT_EQUALS(serial_state[i], batched_state[i]);
+                }
+            }
+        }
+    }
+
     void TestSrnModelOutputParameters()
     {
         std::string output_directory = "TestSrnModelOutputParameters";
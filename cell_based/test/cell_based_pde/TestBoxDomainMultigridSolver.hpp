@@ -0,0 +1,244 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTBOXDOMAINMULTIGRIDSOLVER_HPP_
+#define TESTBOXDOMAINMULTIGRIDSOLVER_HPP_
+
+#include <cxxtest/TestSuite.h>
+
+#include <cmath>
+#include "BoxDomainMultigridSolver.hpp"
+
+// This test is always run sequentially (never in parallel)
+#include "FakePetscSetup.hpp"
+
+class TestBoxDomainMultigridSolver : public CxxTest::TestSuite
+{
+public:
+
+    void TestConstructorAndExceptions()
+    {
+        c_vector<unsigned,2> num_nodes;
+        num_nodes[0] = 17;
+        num_nodes[1] = 9;
+        BoxDomainMultigridSolver<2> solver(num_nodes, 0.5);
+        TS_ASSERT_EQUALS(solver.GetNumNodes(), 153u);
+        TS_ASSERT_EQUALS(solver.GetNumIterations(), 0u);
+
+        // The grid can be coarsened twice, to 5 by 3 nodes
+        TS_ASSERT_EQUALS(solver.GetNumLevels(), 3u);
+
+        TS_ASSERT_EQUALS(solver.IsBoundaryNode(0), true);
+        TS_ASSERT_EQUALS(solver.IsBoundaryNode(16), true);
+        TS_ASSERT_EQUALS(solver.IsBoundaryNode(17), true);
+        TS_ASSERT_EQUALS(solver.IsBoundaryNode(18), false);
+        TS_ASSERT_EQUALS(solver.IsBoundaryNode(152), true);
+
+        TS_ASSERT_THROWS_THIS(BoxDomainMultigridSolver<2> bad_solver(num_nodes, 0.0),
+                              "The grid spacing must be positive.");
+        num_nodes[1] = 1;
+        TS_ASSERT_THROWS_THIS(BoxDomainMultigridSolver<2> bad_solver(num_nodes, 1.0),
+                              "There must be at least two grid nodes in each direction.");
+
+        TS_ASSERT_THROWS_THIS(solver.SetDiffusionCoefficient(-1.0),
+                              "The diffusion coefficient must be positive.");
+        TS_ASSERT_THROWS_THIS(solver.SetReactionCoefficients(std::vector<double>(10, 1.0)),
+                              "The number of reaction coefficients must match the number of grid nodes.");
+        TS_ASSERT_THROWS_THIS(solver.SetReactionCoefficients(std::vector<double>(153, -1.0)),
+                              "The reaction coefficients must be non-negative.");
+        TS_ASSERT_THROWS_THIS(solver.Solve(std::vector<double>(10, 0.0), std::vector<double>(153, 0.0)),
+                              "The size of each vector passed to Solve() must match the number of grid nodes.");
+
+        // A pure Neumann problem without any reaction is singular
+        solver.SetUseNeumannBoundaryConditions();
+        TS_ASSERT_THROWS_THIS(solver.Solve(std::vector<double>(153, 0.0), std::vector<double>(153, 0.0)),
+                              "With Neumann boundary conditions the reaction coefficient must be positive somewhere.");
+
+        // Coverage of failure to converge
+        solver.SetReactionCoefficients(std::vector<double>(153, 1.0));
+        solver.SetMaxIterations(0);
+        TS_ASSERT_THROWS_THIS(solver.Solve(std::vector<double>(153, 1.0), std::vector<double>(153, 0.0)),
+                              "BoxDomainMultigridSolver did not converge within 0 iterations.");
+    }
+
+    void TestDirichletProblemIn2d()
+    {
+        // The stencil is exact for quadratics, so u = x^2 + y^2 solves -Laplacian(u) = -4 to solver tolerance
+        for (unsigned num_intervals=4; num_intervals<=64; num_intervals*=2)
+        {
+            unsigned n = num_intervals + 1;
+            double h = 1.0/num_intervals;
+            c_vector<unsigned,2> num_nodes;
+            num_nodes[0] = n;
+            num_nodes[1] = n;
+            BoxDomainMultigridSolver<2> solver(num_nodes, h);
+
+            std::vector<double> rhs(n*n, -4.0);
+            std::vector<double> exact(n*n);
+            for (unsigned j=0; j<n; j++)
+            {
+                for (unsigned i=0; i<n; i++)
+                {
+                    exact[i + n*j] = (i*h)*(i*h) + (j*h)*(j*h);
+                }
+            }
+
+            std::vector<double> solution = solver.Solve(rhs, exact);
+            for (unsigned k=0; k<n*n; k++)
+            {
+                TS_ASSERT_DELTA(solution[k], exact[k], 1e-8);
+            }
+
+            // The number of iterations should not grow with the grid size
+            TS_ASSERT_LESS_THAN(solver.GetNumIterations(), 10u);
+
+            // Starting from the exact solution, no iterations are needed
+            solution = solver.Solve(rhs, exact, exact);
+            TS_ASSERT_EQUALS(solver.GetNumIterations(), 0u);
+        }
+
+        // A grid that cannot be coarsened is still solved, by smoothing-preconditioned CG
+        c_vector<unsigned,2> num_nodes;
+        num_nodes[0] = 12;
+        num_nodes[1] = 7;
+        BoxDomainMultigridSolver<2> solver(num_nodes, 0.1);
+        TS_ASSERT_EQUALS(solver.GetNumLevels(), 1u);
+        std::vector<double> solution = solver.Solve(std::vector<double>(84, 0.0), std::vector<double>(84, 2.0));
+        for (unsigned k=0; k<84; k++)
+        {
+            TS_ASSERT_DELTA(solution[k], 2.0, 1e-8);
+        }
+    }
+
+    void TestDirichletProblemWithReactionIn3d()
+    {
+        // u = x + y + z solves -0.5*Laplacian(u) + 2u = 2(x + y + z)
+        unsigned n = 17;
+        double h = 1.0/16;
+        c_vector<unsigned,3> num_nodes;
+        num_nodes[0] = n;
+        num_nodes[1] = n;
+        num_nodes[2] = 9;
+        BoxDomainMultigridSolver<3> solver(num_nodes, h);
+        solver.SetDiffusionCoefficient(0.5);
+        TS_ASSERT_EQUALS(solver.GetNumLevels(), 3u);
+
+        unsigned num_grid_nodes = solver.GetNumNodes();
+        std::vector<double> rhs(num_grid_nodes);
+        std::vector<double> exact(num_grid_nodes);
+        for (unsigned k=0; k<9; k++)
+        {
+            for (unsigned j=0; j<n; j++)
+            {
+                for (unsigned i=0; i<n; i++)
+                {
+                    unsigned index = i + n*(j + n*k);
+                    exact[index] = (i + j + k)*h;
+                    rhs[index] = 2.0*exact[index];
+                }
+            }
+        }
+        solver.SetReactionCoefficients(std::vector<double>(num_grid_nodes, 2.0));
+
+        std::vector<double> solution = solver.Solve(rhs, exact);
+        for (unsigned index=0; index<num_grid_nodes; index++)
+        {
+            TS_ASSERT_DELTA(solution[index], exact[index], 1e-8);
+        }
+        TS_ASSERT_LESS_THAN(solver.GetNumIterations(), 12u);
+    }
+
+    void TestNeumannProblemIn2d()
+    {
+        // u = cos(pi x) cos(pi y) has zero flux on the unit square and solves -Laplacian(u) + u = (2 pi^2 + 1) u
+        double previous_error = DBL_MAX;
+        for (unsigned num_intervals=16; num_intervals<=64; num_intervals*=2)
+        {
+            unsigned n = num_intervals + 1;
+            double h = 1.0/num_intervals;
+            c_vector<unsigned,2> num_nodes;
+            num_nodes[0] = n;
+            num_nodes[1] = n;
+            BoxDomainMultigridSolver<2> solver(num_nodes, h);
+            solver.SetUseNeumannBoundaryConditions();
+            solver.SetReactionCoefficients(std::vector<double>(n*n, 1.0));
+
+            std::vector<double> rhs(n*n);
+            std::vector<double> exact(n*n);
+            for (unsigned j=0; j<n; j++)
+            {
+                for (unsigned i=0; i<n; i++)
+                {
+                    exact[i + n*j] = cos(M_PI*i*h)*cos(M_PI*j*h);
+                    rhs[i + n*j] = (2.0*M_PI*M_PI + 1.0)*exact[i + n*j];
+                }
+            }
+
+            std::vector<double> solution = solver.Solve(rhs, std::vector<double>(n*n, 0.0));
+            double error = 0.0;
+            for (unsigned k=0; k<n*n; k++)
+            {
+                error = std::max(error, fabs(solution[k] - exact[k]));
+            }
+
+            // The discretisation is second order accurate
+            TS_ASSERT_LESS_THAN(error, 0.3*previous_error);
+            TS_ASSERT_LESS_THAN(error, 4.0*h*h);
+            previous_error = error;
+        }
+
+        // With a uniform flux, u = x^2/2 + 1 solves -Laplacian(u) + u = x^2/2 on [0,1] with du/dx = 0 at x=0, 1 at x=1
+        c_vector<unsigned,1> num_nodes;
+        num_nodes[0] = 33;
+        double h = 1.0/32;
+        BoxDomainMultigridSolver<1> solver(num_nodes, h);
+        solver.SetUseNeumannBoundaryConditions();
+        solver.SetReactionCoefficients(std::vector<double>(33, 1.0));
+        std::vector<double> rhs(33);
+        std::vector<double> fluxes(33, 0.0);
+        fluxes[32] = 1.0;
+        for (unsigned i=0; i<33; i++)
+        {
+            rhs[i] = 0.5*(i*h)*(i*h);
+        }
+        std::vector<double> solution = solver.Solve(rhs, fluxes);
+        for (unsigned i=0; i<33; i++)
+        {
+            TS_ASSERT_DELTA(solution[i], 0.5*(i*h)*(i*h) + 1.0, 1e-8);
+        }
+    }
+};
+
+#endif /*TESTBOXDOMAINMULTIGRIDSOLVER_HPP_*/
@@ -303,6 +303,54 @@ public:
         TS_ASSERT_DELTA(pde.GetUptakeRateForElement(1), 0.0, 1e-6);
     }
 
+    void TestAveragedSourceEllipticPdeWithIncompleteMap()
+    {
+        // Set up cell population
+        HoneycombMeshGenerator generator(5, 5, 0);
+        MutableMesh<2,2>* p_mesh = generator.GetMesh();
+        std::vector<CellPtr> cells;
+        CellsGenerator<FixedG1GenerationalCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumNodes());
+        MeshBasedCellPopulation<2> cell_population(*p_mesh, cells);
+
+        // Make the first five cells apoptotic
+        MAKE_PTR(ApoptoticCellProperty, p_apoptotic_state);
+        for (unsigned i=0; i<5; i++)
+        {
+            cells[i]->AddCellProperty(p_apoptotic_state);
+        }
+
+        TrianglesMeshReader<2,2> mesh_reader("mesh/test/data/square_2_elements");
+        TetrahedralMesh<2,2> coarse_mesh;
+        coarse_mesh.ConstructFromMeshReader(mesh_reader);
+        coarse_mesh.Scale(10.0, 10.0);
+
+        AveragedSourceEllipticPde<2> pde(cell_population, 0.05);
+
+        // Only supply the containing element for every other cell; the rest must be located on the coarse mesh
+        std::map<CellPtr, unsigned> cell_pde_element_map;
+        for (unsigned i=0; i<cells.size(); i+=2)
+        {
+            cell_pde_element_map[cells[i]] = 0;
+        }
+        unsigned map_size = cell_pde_element_map.size();
+
+        pde.SetupSourceTerms(coarse_mesh, &cell_pde_element_map);
+
+        // There are 20 non-apoptotic cells in the first element, of area 50
+        TS_ASSERT_EQUALS(pde.mCellDensityOnCoarseElements.size(), 2u);
+        TS_ASSERT_DELTA(pde.mCellDensityOnCoarseElements[0], 0.4, 1e-6);
+        TS_ASSERT_DELTA(pde.mCellDensityOnCoarseElements[1], 0.0, 1e-6);
+
+        // The map is only read from
+        TS_ASSERT_EQUALS(cell_pde_element_map.size(), map_size);
+
+        // The same densities are obtained without a map
+        pde.SetupSourceTerms(coarse_mesh);
+        TS_ASSERT_DELTA(pde.mCellDensityOnCoarseElements[0], 0.4, 1e-6);
+        TS_ASSERT_DELTA(pde.mCellDensityOnCoarseElements[1], 0.0, 1e-6);
+    }
+
     void TestAveragedSourceEllipticPdeArchiving()
     {
         // Set up simulation time
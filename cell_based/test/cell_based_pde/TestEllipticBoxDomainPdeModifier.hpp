@@ -564,6 +564,140 @@ public:
         TS_ASSERT_DELTA(p_cell_62->GetCellData()->GetItem("variable_grad_y"), 0.0510, 1e-2);
         TS_ASSERT_DELTA(p_cell_62->GetCellData()->GetItem("variable_grad_z"), -0.0435, 1e-2);
     }
+    void TestMultigridSolver()
+    {
+        HoneycombMeshGenerator generator(10,10,0);
+        MutableMesh<2,2>* p_generating_mesh = generator.GetMesh();
+        NodesOnlyMesh<2> mesh;
+        mesh.ConstructNodesWithoutMesh(*p_generating_mesh, 1.5);
+
+        std::vector<CellPtr> cells;
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_differentiated_type);
+        CellsGenerator<UniformCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasicRandom(cells, mesh.GetNumNodes(), p_differentiated_type);
+
+        // Make cells with x<5.0 apoptotic (so no source term)
+        boost::shared_ptr<AbstractCellProperty> p_apoptotic_property =
+                cells[0]->rGetCellPropertyCollection().GetCellPropertyRegistry()->Get<ApoptoticCellProperty>();
+        for (unsigned i=0; i<cells.size(); i++)
+        {
+            if (mesh.GetNode(i)->rGetLocation()[0] < 5.0)
+            {
+                cells[i]->AddCellProperty(p_apoptotic_property);
+            }
+        }
+
+        NodeBasedCellPopulation<2> cell_population(mesh, cells);
+
+        // Set up simulation time for file output
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(1.0, 1);
+
+        MAKE_PTR_ARGS(AveragedSourceEllipticPde<2>, p_pde, (cell_population, -0.1));
+        MAKE_PTR_ARGS(ConstBoundaryCondition<2>, p_bc, (1.0));
+        ChastePoint<2> lower(-5.0, -5.0);
+        ChastePoint<2> upper(15.0, 15.0);
+        MAKE_PTR_ARGS(ChasteCuboid<2>, p_cuboid, (lower, upper));
+
+        // Solve the PDE using the finite element solver
+        MAKE_PTR_ARGS(EllipticBoxDomainPdeModifier<2>, p_fe_modifier, (p_pde, p_bc, false, p_cuboid));
+        p_fe_modifier->SetDependentVariableName("fe_variable");
+        TS_ASSERT_EQUALS(p_fe_modifier->GetUseMultigridSolver(), false);
+        p_fe_modifier->SetupSolve(cell_population, "TestEllipticBoxDomainPdeModifierMultigrid");
+
+        // Solve the PDE using the multigrid solver
+        MAKE_PTR_ARGS(EllipticBoxDomainPdeModifier<2>, p_mg_modifier, (p_pde, p_bc, false, p_cuboid));
+        p_mg_modifier->SetDependentVariableName("mg_variable");
+        p_mg_modifier->SetUseMultigridSolver();
+        TS_ASSERT_EQUALS(p_mg_modifier->GetUseMultigridSolver(), true);
+        p_mg_modifier->SetupSolve(cell_population, "TestEllipticBoxDomainPdeModifierMultigrid");
+
+        // The solutions agree to within the difference between the finite element and finite difference discretisations
+        for (AbstractCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
+             cell_iter != cell_population.End();
+             ++cell_iter)
+        {
+            double fe_value = cell_iter->GetCellData()->GetItem("fe_variable");
+            double mg_value = cell_iter->GetCellData()->GetItem("mg_variable");
+            TS_ASSERT_DELTA(mg_value, fe_value, 2e-2);
+        }
+        CellPtr p_cell_0 = cell_population.GetCellUsingLocationIndex(0);
+        TS_ASSERT_DELTA(p_cell_0->GetCellData()->GetItem("mg_variable"), 0.8605, 2e-2);
+
+        // The multigrid solver is not used when the boundary condition is imposed on the cell population boundary
+        p_fe_modifier->SetBcsOnBoxBoundary(false);
+        p_mg_modifier->SetBcsOnBoxBoundary(false);
+        p_fe_modifier->UpdateAtEndOfTimeStep(cell_population);
+        p_mg_modifier->UpdateAtEndOfTimeStep(cell_population);
+        for (AbstractCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
+             cell_iter != cell_population.End();
+             ++cell_iter)
+        {
+            double fe_value = cell_iter->GetCellData()->GetItem("fe_variable");
+            double mg_value = cell_iter->GetCellData()->GetItem("mg_variable");
+            TS_ASSERT_DELTA(mg_value, fe_value, 1e-12);
+        }
+    }
+    void TestCellPdeElementMapLookup()
+    {
+        HoneycombMeshGenerator generator(10,10,0);
+        MutableMesh<2,2>* p_generating_mesh = generator.GetMesh();
+        NodesOnlyMesh<2> mesh;
+        mesh.ConstructNodesWithoutMesh(*p_generating_mesh, 1.5);
+
+        std::vector<CellPtr> cells;
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_differentiated_type);
+        CellsGenerator<UniformCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasicRandom(cells, mesh.GetNumNodes(), p_differentiated_type);
+        NodeBasedCellPopulation<2> cell_population(mesh, cells);
+
+        MAKE_PTR_ARGS(UniformSourceEllipticPde<2>, p_pde, (-0.1));
+        MAKE_PTR_ARGS(ConstBoundaryCondition<2>, p_bc, (1.0));
+        ChastePoint<2> lower(-5.0, -5.0);
+        ChastePoint<2> upper(15.0, 15.0);
+        MAKE_PTR_ARGS(ChasteCuboid<2>, p_cuboid, (lower, upper));
+        EllipticBoxDomainPdeModifier<2> modifier(p_pde, p_bc, false, p_cuboid, 0.5);
+        TetrahedralMesh<2,2>* p_fe_mesh = modifier.GetFeMesh();
+
+        // The grid has one cell per square of the mesh, each containing two triangles
+        modifier.InitialiseCellPdeElementMap(cell_population);
+        TS_ASSERT_EQUALS(modifier.mElementsInGridCell.size(), 1600u);
+        TS_ASSERT_EQUALS(modifier.mNumGridCells[0], 40u);
+        TS_ASSERT_EQUALS(modifier.mNumGridCells[1], 40u);
+        for (unsigned i=0; i<modifier.mElementsInGridCell.size(); i++)
+        {
+            TS_ASSERT_EQUALS(modifier.mElementsInGridCell[i].size(), 2u);
+        }
+
+        for (AbstractCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
+             cell_iter != cell_population.End();
+             ++cell_iter)
+        {
+            const ChastePoint<2>& r_location = cell_population.GetLocationOfCellCentre(*cell_iter);
+            TS_ASSERT(p_fe_mesh->GetElement(modifier.mCellPdeElementMap[*cell_iter])->IncludesPoint(r_location));
+        }
+
+        // Move the cells and check that the map is updated
+        for (unsigned i=0; i<mesh.GetNumNodes(); i++)
+        {
+            c_vector<double,2>& r_location = mesh.GetNode(i)->rGetModifiableLocation();
+            r_location[0] += 0.37 + 0.1*(i%3);
+            r_location[1] -= 0.81;
+        }
+        modifier.UpdateCellPdeElementMap(cell_population);
+        for (AbstractCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
+             cell_iter != cell_population.End();
+             ++cell_iter)
+        {
+            const ChastePoint<2>& r_location = cell_population.GetLocationOfCellCentre(*cell_iter);
+            TS_ASSERT(p_fe_mesh->GetElement(modifier.mCellPdeElementMap[*cell_iter])->IncludesPoint(r_location));
+        }
+
+        // Points on the boundary of the box are located, and points outside it are not
+        TS_ASSERT(p_fe_mesh->GetElement(modifier.GetContainingElementIndex(upper))->IncludesPoint(upper));
+        TS_ASSERT(p_fe_mesh->GetElement(modifier.GetContainingElementIndex(lower, 5))->IncludesPoint(lower));
+        ChastePoint<2> outside(16.0, 0.0);
+        TS_ASSERT_THROWS_CONTAINS(modifier.GetContainingElementIndex(outside), "is not in mesh");
+    }
 };
 
 #endif /*TESTELLIPTICBOXDOMAINPDEMODIFIER_HPP_*/
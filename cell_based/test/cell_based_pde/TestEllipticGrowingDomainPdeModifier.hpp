@@ -574,6 +574,69 @@ public:
         delete p_mesh;
     }
 
+    void TestReuseFeMeshWithNodeBasedPopulation()
+    {
+        HoneycombMeshGenerator generator(6, 6, 0);
+        MutableMesh<2,2>* p_generating_mesh = generator.GetMesh();
+        NodesOnlyMesh<2> mesh;
+        mesh.ConstructNodesWithoutMesh(*p_generating_mesh, 1.5);
+
+        std::vector<CellPtr> cells;
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_differentiated_type);
+        CellsGenerator<UniformCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasicRandom(cells, mesh.GetNumNodes(), p_differentiated_type);
+
+        NodeBasedCellPopulation<2> cell_population(mesh, cells);
+
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(1.0, 1);
+
+        MAKE_PTR_ARGS(CellwiseSourceEllipticPde<2>, p_pde, (cell_population, -0.1));
+        MAKE_PTR_ARGS(ConstBoundaryCondition<2>, p_bc, (1.0));
+
+        // One modifier reuses its mesh and the other generates a new mesh every time
+        MAKE_PTR_ARGS(EllipticGrowingDomainPdeModifier<2>, p_reusing_modifier, (p_pde, p_bc, false));
+        p_reusing_modifier->SetDependentVariableName("reused");
+        TS_ASSERT_EQUALS(p_reusing_modifier->GetReuseFeMesh(), false);
+        p_reusing_modifier->SetReuseFeMesh();
+        TS_ASSERT_EQUALS(p_reusing_modifier->GetReuseFeMesh(), true);
+
+        MAKE_PTR_ARGS(EllipticGrowingDomainPdeModifier<2>, p_modifier, (p_pde, p_bc, false));
+        p_modifier->SetDependentVariableName("new");
+
+        p_reusing_modifier->SetupSolve(cell_population, "TestReuseFeMeshWithNodeBasedPopulation");
+        p_modifier->SetupSolve(cell_population, "TestReuseFeMeshWithNodeBasedPopulation");
+        TS_ASSERT_EQUALS(p_reusing_modifier->GetFeMeshWasReused(), false);
+
+        // Move the cells, so that some edges of the triangulation must be flipped
+        for (unsigned node_index=0; node_index<mesh.GetNumNodes(); node_index++)
+        {
+            c_vector<double, 2>& r_location = mesh.GetNode(node_index)->rGetModifiableLocation();
+            r_location[0] += 0.1*sin(3.0*node_index);
+            r_location[1] += 0.1*cos(5.0*node_index);
+        }
+
+        p_reusing_modifier->UpdateAtEndOfTimeStep(cell_population);
+        p_modifier->UpdateAtEndOfTimeStep(cell_population);
+        TS_ASSERT_EQUALS(p_reusing_modifier->GetFeMeshWasReused(), true);
+        TS_ASSERT_EQUALS(p_modifier->GetFeMeshWasReused(), false);
+
+        TS_ASSERT_EQUALS(p_reusing_modifier->GetFeMesh()->GetNumElements(), p_modifier->GetFeMesh()->GetNumElements());
+        for (AbstractCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
+             cell_iter != cell_population.End();
+             ++cell_iter)
+        {
+            TS_ASSERT_DELTA(cell_iter->GetCellData()->GetItem("reused"), cell_iter->GetCellData()->GetItem("new"), 1e-10);
+        }
+
+        // After a cell dies a new mesh is generated
+        cell_population.Begin()->Kill();
+        cell_population.RemoveDeadCells();
+        cell_population.Update();
+        p_reusing_modifier->UpdateAtEndOfTimeStep(cell_population);
+        TS_ASSERT_EQUALS(p_reusing_modifier->GetFeMeshWasReused(), false);
+        TS_ASSERT_EQUALS(p_reusing_modifier->GetFeMesh()->GetNumNodes(), cell_population.GetNumRealCells());
+    }
+
     void TestVertexBasedSquareMonolayer()
     {
         HoneycombVertexMeshGenerator generator(20,20);
@@ -597,6 +597,135 @@ public:
         // Checking it doesn't change for this cell population
         TS_ASSERT_DELTA(p_cell_0->GetCellData()->GetItem("variable"), 0.8343, 1e-4);
     }
+    void TestMultigridSolver()
+    {
+        HoneycombMeshGenerator generator(10,10,0);
+        MutableMesh<2,2>* p_generating_mesh = generator.GetMesh();
+        NodesOnlyMesh<2> mesh;
+        mesh.ConstructNodesWithoutMesh(*p_generating_mesh, 1.5);
+
+        std::vector<CellPtr> cells;
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_differentiated_type);
+        CellsGenerator<UniformCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasicRandom(cells, mesh.GetNumNodes(), p_differentiated_type);
+
+        // Make cells with x<5.0 apoptotic (so no source term) and set the initial conditions for each PDE
+        boost::shared_ptr<AbstractCellProperty> p_apoptotic_property =
+                cells[0]->rGetCellPropertyCollection().GetCellPropertyRegistry()->Get<ApoptoticCellProperty>();
+        for (unsigned i=0; i<cells.size(); i++)
+        {
+            if (mesh.GetNode(i)->rGetLocation()[0] < 5.0)
+            {
+                cells[i]->AddCellProperty(p_apoptotic_property);
+            }
+            cells[i]->GetCellData()->SetItem("fe_variable", 1.0);
+            cells[i]->GetCellData()->SetItem("mg_variable", 1.0);
+        }
+
+        NodeBasedCellPopulation<2> cell_population(mesh, cells);
+
+        // Set up simulation time for file output
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(1.0, 10);
+
+        MAKE_PTR_ARGS(AveragedSourceParabolicPde<2>, p_pde, (cell_population, 0.1, 1.0, -0.1));
+        MAKE_PTR_ARGS(ConstBoundaryCondition<2>, p_bc, (1.0));
+        ChastePoint<2> lower(-5.0, -5.0);
+        ChastePoint<2> upper(15.0, 15.0);
+        MAKE_PTR_ARGS(ChasteCuboid<2>, p_cuboid, (lower, upper));
+
+        MAKE_PTR_ARGS(ParabolicBoxDomainPdeModifier<2>, p_fe_modifier, (p_pde, p_bc, false, p_cuboid));
+        p_fe_modifier->SetDependentVariableName("fe_variable");
+        p_fe_modifier->SetupSolve(cell_population, "TestParabolicBoxDomainPdeModifierMultigrid");
+
+        MAKE_PTR_ARGS(ParabolicBoxDomainPdeModifier<2>, p_mg_modifier, (p_pde, p_bc, false, p_cuboid));
+        p_mg_modifier->SetDependentVariableName("mg_variable");
+        p_mg_modifier->SetUseMultigridSolver();
+        p_mg_modifier->SetupSolve(cell_population, "TestParabolicBoxDomainPdeModifierMultigrid");
+
+        // Run for 10 time steps
+        for (unsigned i=0; i<10; i++)
+        {
+            SimulationTime::Instance()->IncrementTimeOneStep();
+            p_fe_modifier->UpdateAtEndOfTimeStep(cell_population);
+            p_mg_modifier->UpdateAtEndOfTimeStep(cell_population);
+        }
+
+        // The solutions agree to within the difference between the finite element and finite difference discretisations
+        for (AbstractCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
+             cell_iter != cell_population.End();
+             ++cell_iter)
+        {
+            double fe_value = cell_iter->GetCellData()->GetItem("fe_variable");
+            double mg_value = cell_iter->GetCellData()->GetItem("mg_variable");
+            TS_ASSERT_DELTA(mg_value, fe_value, 3e-2);
+        }
+    }
+
+    void TestReuseFeSolver()
+    {
+        HoneycombMeshGenerator generator(10,10,0);
+        MutableMesh<2,2>* p_generating_mesh = generator.GetMesh();
+        NodesOnlyMesh<2> mesh;
+        mesh.ConstructNodesWithoutMesh(*p_generating_mesh, 1.5);
+
+        std::vector<CellPtr> cells;
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_differentiated_type);
+        CellsGenerator<UniformCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasicRandom(cells, mesh.GetNumNodes(), p_differentiated_type);
+
+        // Make cells with x<5.0 apoptotic (so no source term) and set the initial conditions for each PDE
+        boost::shared_ptr<AbstractCellProperty> p_apoptotic_property =
+                cells[0]->rGetCellPropertyCollection().GetCellPropertyRegistry()->Get<ApoptoticCellProperty>();
+        for (unsigned i=0; i<cells.size(); i++)
+        {
+            if (mesh.GetNode(i)->rGetLocation()[0] < 5.0)
+            {
+                cells[i]->AddCellProperty(p_apoptotic_property);
+            }
+            cells[i]->GetCellData()->SetItem("new_solver_variable", 1.0);
+            cells[i]->GetCellData()->SetItem("kept_solver_variable", 1.0);
+        }
+
+        NodeBasedCellPopulation<2> cell_population(mesh, cells);
+
+        // Set up simulation time for file output
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(1.0, 10);
+
+        MAKE_PTR_ARGS(AveragedSourceParabolicPde<2>, p_pde, (cell_population, 0.1, 1.0, -0.1));
+        MAKE_PTR_ARGS(ConstBoundaryCondition<2>, p_bc, (1.0));
+        ChastePoint<2> lower(-5.0, -5.0);
+        ChastePoint<2> upper(15.0, 15.0);
+        MAKE_PTR_ARGS(ChasteCuboid<2>, p_cuboid, (lower, upper));
+
+        MAKE_PTR_ARGS(ParabolicBoxDomainPdeModifier<2>, p_new_solver_modifier, (p_pde, p_bc, false, p_cuboid));
+        TS_ASSERT_EQUALS(p_new_solver_modifier->GetReuseFeSolver(), false);
+        p_new_solver_modifier->SetDependentVariableName("new_solver_variable");
+        p_new_solver_modifier->SetupSolve(cell_population, "TestParabolicBoxDomainPdeModifierReuseFeSolver");
+
+        MAKE_PTR_ARGS(ParabolicBoxDomainPdeModifier<2>, p_kept_solver_modifier, (p_pde, p_bc, false, p_cuboid));
+        p_kept_solver_modifier->SetReuseFeSolver();
+        TS_ASSERT_EQUALS(p_kept_solver_modifier->GetReuseFeSolver(), true);
+        p_kept_solver_modifier->SetDependentVariableName("kept_solver_variable");
+        p_kept_solver_modifier->SetupSolve(cell_population, "TestParabolicBoxDomainPdeModifierReuseFeSolver");
+
+        // Run for 10 time steps, in which the source terms change as the solution evolves
+        for (unsigned i=0; i<10; i++)
+        {
+            SimulationTime::Instance()->IncrementTimeOneStep();
+            p_new_solver_modifier->UpdateAtEndOfTimeStep(cell_population);
+            p_kept_solver_modifier->UpdateAtEndOfTimeStep(cell_population);
+        }
+
+        // Keeping the solver only avoids reassembling the matrix, so the solutions agree to within the linear solver tolerance
+        for (AbstractCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
+             cell_iter != cell_population.End();
+             ++cell_iter)
+        {
+            double new_solver_value = cell_iter->GetCellData()->GetItem("new_solver_variable");
+            double kept_solver_value = cell_iter->GetCellData()->GetItem("kept_solver_variable");
+            TS_ASSERT_DELTA(kept_solver_value, new_solver_value, 1e-6);
+        }
+    }
 };
 
 #endif /*TESTPARABOLICBOXDOMAINPDEMODIFIER_HPP_*/
@@ -1778,6 +1778,108 @@ public:
         TS_ASSERT_EQUALS(p_mesh->GetNumNodes(), 2u);
     }
 
+    void TestMooreNeighbourStencil()
+    {
+        PottsMeshGenerator<2> generator(4, 1, 2, 3, 1, 2);
+        PottsMesh<2>* p_mesh = generator.GetMesh();
+
+        // The flat stencil holds the same neighbours as the sets, in increasing order
+        std::vector<unsigned> offsets = p_mesh->rGetMooreNeighbourOffsets();
+        std::vector<unsigned> indices = p_mesh->rGetMooreNeighbourIndices();
+        TS_ASSERT_EQUALS(offsets.size(), 13u);
+        TS_ASSERT_EQUALS(offsets[0], 0u);
+        TS_ASSERT_EQUALS(offsets[12], indices.size());
+        for (unsigned node_index=0; node_index<p_mesh->GetNumNodes(); node_index++)
+        {
+            std::set<unsigned> neighbours = p_mesh->GetMooreNeighbouringNodeIndices(node_index);
+            std::vector<unsigned> expected_neighbours(neighbours.begin(), neighbours.end());
+            std::vector<unsigned> stencil_neighbours(indices.begin() + offsets[node_index], indices.begin() + offsets[node_index + 1]);
+            TS_ASSERT_EQUALS(stencil_neighbours, expected_neighbours);
+        }
+
+        // Corner nodes have three neighbours and interior nodes have eight
+        TS_ASSERT_EQUALS(offsets[1] - offsets[0], 3u);
+        TS_ASSERT_EQUALS(offsets[6] - offsets[5], 8u);
+
+        // The stencil is rebuilt when a node is deleted
+        p_mesh->DeleteNode(11);
+        TS_ASSERT_EQUALS(p_mesh->rGetMooreNeighbourOffsets().size(), 12u);
+        TS_ASSERT_EQUALS(p_mesh->rGetMooreNeighbourOffsets()[11], p_mesh->rGetMooreNeighbourIndices().size());
+        TS_ASSERT_EQUALS(p_mesh->rGetMooreNeighbourOffsets()[11] - p_mesh->rGetMooreNeighbourOffsets()[10], 4u);
+    }
+
+    void TestVonNeumannNeighbourStencil()
+    {
+        PottsMeshGenerator<2> generator(4, 1, 2, 3, 1, 2);
+        PottsMesh<2>* p_mesh = generator.GetMesh();
+
+        // The flat stencil holds the same neighbours as the sets, in increasing order
+        std::vector<unsigned> offsets = p_mesh->rGetVonNeumannNeighbourOffsets();
+        std::vector<unsigned> indices = p_mesh->rGetVonNeumannNeighbourIndices();
+        TS_ASSERT_EQUALS(offsets.size(), 13u);
+        TS_ASSERT_EQUALS(offsets[12], indices.size());
+        for (unsigned node_index=0; node_index<p_mesh->GetNumNodes(); node_index++)
+        {
+            const std::set<unsigned>& r_neighbours = p_mesh->rGetVonNeumannNeighbouringNodeIndices(node_index);
+            std::vector<unsigned> expected_neighbours(r_neighbours.begin(), r_neighbours.end());
+            std::vector<unsigned> stencil_neighbours(indices.begin() + offsets[node_index], indices.begin() + offsets[node_index + 1]);
+            TS_ASSERT_EQUALS(stencil_neighbours, expected_neighbours);
+        }
+
+        // Corner nodes have two neighbours and interior nodes have four
+        TS_ASSERT_EQUALS(offsets[1] - offsets[0], 2u);
+        TS_ASSERT_EQUALS(offsets[6] - offsets[5], 4u);
+
+        // The stencil is rebuilt when a node is deleted
+        p_mesh->DeleteNode(11);
+        TS_ASSERT_EQUALS(p_mesh->rGetVonNeumannNeighbourOffsets().size(), 12u);
+        TS_ASSERT_EQUALS(p_mesh->rGetVonNeumannNeighbourOffsets()[11], p_mesh->rGetVonNeumannNeighbourIndices().size());
+    }
+
+    void TestMoveNodeToElementUpdatesSurfaceAreas()
+    {
+        // A 2D mesh with four elements and a 3D mesh with eight, each surrounded by medium
+        PottsMeshGenerator<2> generator_2d(6, 2, 2, 6, 2, 2);
+        CheckSurfaceAreasAfterMoves(*(generator_2d.GetMesh()));
+
+        PottsMeshGenerator<3> generator_3d(6, 2, 2, 6, 2, 2, 6, 2, 2);
+        CheckSurfaceAreasAfterMoves(*(generator_3d.GetMesh()));
+    }
+
+    template<unsigned DIM>
+    void CheckSurfaceAreasAfterMoves(PottsMesh<DIM>& rMesh)
+    {
+        for (unsigned node_index=0; node_index<rMesh.GetNumNodes(); node_index += 5)
+        {
+            // Move the node into the element (or medium) of its last Von Neumann neighbour
+            unsigned neighbour_index = *(rMesh.rGetVonNeumannNeighbouringNodeIndices(node_index).rbegin());
+            const std::set<unsigned>& r_neighbour_elements = rMesh.GetNode(neighbour_index)->rGetContainingElementIndices();
+            unsigned element_index = r_neighbour_elements.empty() ? UNSIGNED_UNSET : *(r_neighbour_elements.begin());
+
+            rMesh.MoveNodeToElement(node_index, element_index);
+            if (element_index == UNSIGNED_UNSET)
+            {
+                TS_ASSERT_EQUALS(rMesh.GetNode(node_index)->GetNumContainingElements(), 0u);
+            }
+            else
+            {
+                TS_ASSERT_EQUALS(*(rMesh.GetNode(node_index)->rGetContainingElementIndices().begin()), element_index);
+            }
+
+            // The running totals agree with a full recalculation
+            for (unsigned elem_index=0; elem_index<rMesh.GetNumElements(); elem_index++)
+            {
+                TS_ASSERT_DELTA(rMesh.GetSurfaceAreaOfElement(elem_index), rMesh.CalculateSurfaceAreaOfElement(elem_index), 1e-12);
+            }
+        }
+
+        // Changes made directly to elements require the running totals to be invalidated
+        PottsElement<DIM>* p_element = rMesh.GetElement(0);
+        p_element->DeleteNode(0);
+        rMesh.InvalidateElementSurfaceAreas();
+        TS_ASSERT_DELTA(rMesh.GetSurfaceAreaOfElement(0), rMesh.CalculateSurfaceAreaOfElement(0), 1e-12);
+    }
+
     void TestArchive2dPottsMesh()
     {
         EXIT_IF_PARALLEL;
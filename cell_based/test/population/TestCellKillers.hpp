@@ -487,6 +487,87 @@ public:
         }
     }
 
+    void TestCheckingSingleCells()
+    {
+        TrianglesMeshReader<2,2> mesh_reader("mesh/test/data/square_128_elements");
+        MutableMesh<2,2> mesh;
+        mesh.ConstructFromMeshReader(mesh_reader);
+        mesh.Translate(-0.25,-0.25);
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<FixedG1GenerationalCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, mesh.GetNumNodes());
+        MeshBasedCellPopulation<2> cell_population(mesh, cells);
+
+        // Two killers that between them kill cells with x > 0.5 or y > 0
+        PlaneBasedCellKiller<2> y_killer(&cell_population, zero_vector<double>(2), unit_vector<double>(2,1));
+        c_vector<double,2> point = zero_vector<double>(2);
+        point[0] = 0.5;
+        PlaneBasedCellKiller<2> x_killer(&cell_population, point, unit_vector<double>(2,0));
+        RandomCellKiller<2> random_killer(&cell_population, 0.1);
+        ApoptoticCellKiller<2> apoptotic_killer(&cell_population);
+        TargetedCellKiller<2> targeted_killer(&cell_population, 0);
+
+        TS_ASSERT_EQUALS(y_killer.CanCheckSingleCells(), true);
+        TS_ASSERT_EQUALS(random_killer.CanCheckSingleCells(), true);
+        TS_ASSERT_EQUALS(apoptotic_killer.CanCheckSingleCells(), true);
+        TS_ASSERT_EQUALS(targeted_killer.CanCheckSingleCells(), false);
+
+        // Mark a spring between a cell that will die and one that will not
+        CellPtr p_dying_cell = cell_population.GetCellUsingLocationIndex(0);
+        CellPtr p_surviving_cell = cell_population.GetCellUsingLocationIndex(0);
+        for (AbstractCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
+             cell_iter != cell_population.End();
+             ++cell_iter)
+        {
+            c_vector<double,2> location = cell_population.GetLocationOfCellCentre(*cell_iter);
+            if (location[0] > 0.5 && location[1] < 0.0)
+            {
+                p_dying_cell = *cell_iter;
+            }
+            else if (location[0] < 0.5 && location[1] < 0.0)
+            {
+                p_surviving_cell = *cell_iter;
+            }
+        }
+        std::pair<CellPtr,CellPtr> cell_pair = cell_population.CreateCellPair(p_dying_cell, p_surviving_cell);
+        cell_population.MarkSpring(cell_pair);
+
+        // Check each cell with both killers in turn, as the simulation does
+        for (AbstractCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
+             cell_iter != cell_population.End();
+             ++cell_iter)
+        {
+            y_killer.CheckAndLabelSingleCellForApoptosisOrDeath(*cell_iter);
+            if (!cell_iter->IsDead())
+            {
+                x_killer.CheckAndLabelSingleCellForApoptosisOrDeath(*cell_iter);
+            }
+        }
+
+        unsigned num_expected_deaths = 0;
+        for (std::list<CellPtr>::iterator cell_iter = cell_population.rGetCells().begin();
+             cell_iter != cell_population.rGetCells().end();
+             ++cell_iter)
+        {
+            c_vector<double,2> location = cell_population.GetLocationOfCellCentre(*cell_iter);
+            bool should_die = (location[0] > 0.5 || location[1] > 0.0);
+            TS_ASSERT_EQUALS((*cell_iter)->IsDead(), should_die);
+            if (should_die)
+            {
+                num_expected_deaths++;
+            }
+        }
+        TS_ASSERT_EQUALS(p_dying_cell->IsDead(), true);
+        TS_ASSERT_EQUALS(p_surviving_cell->IsDead(), false);
+
+        // All the dead cells are removed at once, along with the marked spring
+        TS_ASSERT_EQUALS(cell_population.IsMarkedSpring(cell_pair), true);
+        TS_ASSERT_EQUALS(cell_population.RemoveDeadCells(), num_expected_deaths);
+        TS_ASSERT_EQUALS(cell_population.IsMarkedSpring(cell_pair), false);
+        TS_ASSERT_EQUALS(cell_population.GetNumRealCells(), mesh.GetNumAllNodes() - num_expected_deaths);
+    }
+
     void TestIsolatedLabelledCellKiller()
     {
         // Create a non-vertex based cell population
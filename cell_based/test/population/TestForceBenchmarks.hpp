@@ -0,0 +1,114 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTFORCEBENCHMARKS_HPP_
+#define TESTFORCEBENCHMARKS_HPP_
+
+#include <cxxtest/TestSuite.h>
+
+#include "AbstractCellBasedTestSuite.hpp"
+#include "BenchmarkRecorder.hpp"
+#include "CellsGenerator.hpp"
+#include "FixedG1GenerationalCellCycleModel.hpp"
+#include "GeneralisedLinearSpringForce.hpp"
+#include "HoneycombMeshGenerator.hpp"
+#include "HoneycombVertexMeshGenerator.hpp"
+#include "MeshBasedCellPopulation.hpp"
+#include "NagaiHondaForce.hpp"
+#include "VertexBasedCellPopulation.hpp"
+#include "FakePetscSetup.hpp"
+
+/**
+ * Benchmarks of cell-based force calculation at several problem sizes.
+ * Results are written to Benchmarks/ForceBenchmarks.json.
+ */
+class TestForceBenchmarks : public AbstractCellBasedTestSuite
+{
+public:
+
+    void TestForceCalculation()
+    {
+        BenchmarkRecorder recorder("ForceBenchmarks");
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(1.0, 1);
+
+        const unsigned sizes[3] = {20, 40, 80};
+        for (unsigned i=0; i<3; i++)
+        {
+            // Spring forces on a Delaunay mesh
+            {
+                HoneycombMeshGenerator generator(sizes[i], sizes[i]);
+                MutableMesh<2,2>* p_mesh = generator.GetMesh();
+
+                std::vector<CellPtr> cells;
+                CellsGenerator<FixedG1GenerationalCellCycleModel, 2> cells_generator;
+                cells_generator.GenerateBasic(cells, p_mesh->GetNumNodes());
+                MeshBasedCellPopulation<2> cell_population(*p_mesh, cells);
+
+                GeneralisedLinearSpringForce<2> force;
+                recorder.Begin("spring_force_x10", cell_population.GetNumRealCells());
+                for (unsigned repeat=0; repeat<10; repeat++)
+                {
+                    force.AddForceContribution(cell_population);
+                }
+                recorder.End();
+            }
+
+            // Nagai-Honda forces on a vertex mesh
+            {
+                HoneycombVertexMeshGenerator generator(sizes[i], sizes[i]);
+                MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+
+                std::vector<CellPtr> cells;
+                CellsGenerator<FixedG1GenerationalCellCycleModel, 2> cells_generator;
+                cells_generator.GenerateBasic(cells, p_mesh->GetNumElements());
+                VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+                cell_population.InitialiseCells();
+
+                NagaiHondaForce<2> force;
+                recorder.Begin("nagai_honda_force_x10", cell_population.GetNumRealCells());
+                for (unsigned repeat=0; repeat<10; repeat++)
+                {
+                    force.AddForceContribution(cell_population);
+                }
+                recorder.End();
+            }
+        }
+
+        TS_ASSERT_EQUALS(recorder.GetNumberOfResults(), 6u);
+        recorder.WriteResults();
+    }
+};
+
+#endif /*TESTFORCEBENCHMARKS_HPP_*/
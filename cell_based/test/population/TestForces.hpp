@@ -822,6 +822,69 @@ public:
         }
     }
 
+    void TestChemotacticForceWithCellDataGradient()
+    {
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(1.0,1);
+
+        // Create a NodeBasedCellPopulation, for which CellwiseDataGradient is not available
+        std::vector<Node<2>*> nodes;
+        nodes.push_back(new Node<2>(0, true, 0.0, 0.0));
+        nodes.push_back(new Node<2>(1, true, 1.0, 0.0));
+        nodes.push_back(new Node<2>(2, true, 0.0, 1.0));
+
+        NodesOnlyMesh<2> mesh;
+        mesh.ConstructNodesWithoutMesh(nodes, 1.5);
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<FixedG1GenerationalCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, mesh.GetNumNodes());
+
+        // Only the first two cells are labelled
+        MAKE_PTR(CellLabel, p_label);
+        cells[0]->AddCellProperty(p_label);
+        cells[1]->AddCellProperty(p_label);
+
+        NodeBasedCellPopulation<2> cell_population(mesh, cells);
+
+        // Store a concentration and gradient, as a PDE modifier with SetOutputGradient(true) would
+        for (AbstractCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
+             cell_iter != cell_population.End();
+             ++cell_iter)
+        {
+            double x = cell_population.GetLocationOfCellCentre(*cell_iter)[0];
+            cell_iter->GetCellData()->SetItem("nutrient", 1.0 + x);
+            cell_iter->GetCellData()->SetItem("nutrient_grad_x", 3.0*x);
+            cell_iter->GetCellData()->SetItem("nutrient_grad_y", 4.0*x);
+        }
+
+        ChemotacticForce<2> force;
+        TS_ASSERT_EQUALS(force.GetUseCellDataGradient(), false);
+        force.SetUseCellDataGradient();
+        TS_ASSERT_EQUALS(force.GetUseCellDataGradient(), true);
+
+        for (unsigned i=0; i<mesh.GetNumNodes(); i++)
+        {
+            mesh.GetNode(i)->ClearAppliedForce();
+        }
+        force.AddForceContribution(cell_population);
+
+        // Node 0 has a zero gradient and node 2 is not labelled, so neither is moved
+        TS_ASSERT_DELTA(mesh.GetNode(0)->rGetAppliedForce()[0], 0.0, 1e-6);
+        TS_ASSERT_DELTA(mesh.GetNode(0)->rGetAppliedForce()[1], 0.0, 1e-6);
+        TS_ASSERT_DELTA(mesh.GetNode(2)->rGetAppliedForce()[0], 0.0, 1e-6);
+        TS_ASSERT_DELTA(mesh.GetNode(2)->rGetAppliedForce()[1], 0.0, 1e-6);
+
+        // Node 1 moves with magnitude equal to its concentration, along (3,4)/5
+        TS_ASSERT_DELTA(mesh.GetNode(1)->rGetAppliedForce()[0], 2.0*0.6, 1e-6);
+        TS_ASSERT_DELTA(mesh.GetNode(1)->rGetAppliedForce()[1], 2.0*0.8, 1e-6);
+
+        // Avoid memory leak
+        for (unsigned i=0; i<nodes.size(); i++)
+        {
+            delete nodes[i];
+        }
+    }
+
     void TestChemotacticForceArchiving()
     {
         EXIT_IF_PARALLEL; // Beware of processes overwriting the identical archives of other processes
@@ -834,7 +897,8 @@ public:
             std::ofstream ofs(archive_filename.c_str());
             boost::archive::text_oarchive output_arch(ofs);
 
-            // No member variables to set
+            // Set member variables
+            force.SetUseCellDataGradient();
 
             // Serialize via pointer to most abstract class possible
             AbstractForce<2>* const p_force = &force;
@@ -851,7 +915,8 @@ public:
             // Restore from the archive
             input_arch >> p_force;
 
-            // No member variables to test, so just test a method
+            // Test member variables and a method
+            TS_ASSERT_EQUALS((static_cast<ChemotacticForce<2>*>(p_force))->GetUseCellDataGradient(), true);
             TS_ASSERT_DELTA((static_cast<ChemotacticForce<2>*>(p_force))->GetChemotacticForceMagnitude(12.0, 3.5), 12.0, 1e-6);
 
             // Tidy up
@@ -960,6 +1025,133 @@ public:
         }
     }
 
+    void TestThreadedTwoBodyInteractionForce()
+    {
+        EXIT_IF_PARALLEL; // The node pairs are only compared on a single process
+
+        // Create a small square lattice of nodes, all within interaction distance of their neighbours
+        std::vector<Node<2>*> nodes;
+        for (unsigned i=0; i<5; i++)
+        {
+            for (unsigned j=0; j<5; j++)
+            {
+                nodes.push_back(new Node<2>(5*i+j, false, 0.8*i + 0.01*j, 0.8*j + 0.02*i));
+            }
+        }
+
+        NodesOnlyMesh<2> mesh;
+        mesh.ConstructNodesWithoutMesh(nodes, 1.5);
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<FixedG1GenerationalCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, mesh.GetNumNodes());
+
+        NodeBasedCellPopulation<2> cell_population(mesh, cells);
+        cell_population.Update();
+
+        GeneralisedLinearSpringForce<2> force;
+        TS_ASSERT_EQUALS(force.GetNumberOfThreads(), 1u);
+        TS_ASSERT_THROWS_THIS(force.SetNumberOfThreads(0u), "The number of force threads must be at least one.");
+
+        // Compute the serial forces
+        for (AbstractMesh<2,2>::NodeIterator node_iter = mesh.GetNodeIteratorBegin();
+             node_iter != mesh.GetNodeIteratorEnd();
+             ++node_iter)
+        {
+            node_iter->ClearAppliedForce();
+        }
+        force.AddForceContribution(cell_population);
+
+        std::vector<c_vector<double, 2> > serial_forces;
+        for (AbstractMesh<2,2>::NodeIterator node_iter = mesh.GetNodeIteratorBegin();
+             node_iter != mesh.GetNodeIteratorEnd();
+             ++node_iter)
+        {
+            serial_forces.push_back(node_iter->rGetAppliedForce());
+        }
+
+        // The threaded forces are reduced in pair order, so must match the serial ones exactly
+        force.SetNumberOfThreads(4u);
+        TS_ASSERT_EQUALS(force.GetNumberOfThreads(), 4u);
+        for (AbstractMesh<2,2>::NodeIterator node_iter = mesh.GetNodeIteratorBegin();
+             node_iter != mesh.GetNodeIteratorEnd();
+             ++node_iter)
+        {
+            node_iter->ClearAppliedForce();
+        }
+        force.AddForceContribution(cell_population);
+
+        unsigned node_count = 0;
+        for (AbstractMesh<2,2>::NodeIterator node_iter = mesh.GetNodeIteratorBegin();
+             node_iter != mesh.GetNodeIteratorEnd();
+             ++node_iter, ++node_count)
+        {
+            TS_ASSERT_EQUALS(node_iter->rGetAppliedForce()[0], serial_forces[node_count][0]);
+            TS_ASSERT_EQUALS(node_iter->rGetAppliedForce()[1], serial_forces[node_count][1]);
+        }
+
+        for (unsigned i=0; i<nodes.size(); i++)
+        {
+            delete nodes[i];
+        }
+    }
+
+    void TestBatchedGeneralisedLinearSpringForce()
+    {
+        EXIT_IF_PARALLEL; // All the node pairs are checked on a single process
+
+        // Create a small irregular lattice of nodes, some overlapping and some stretched
+        std::vector<Node<2>*> nodes;
+        for (unsigned i=0; i<4; i++)
+        {
+            for (unsigned j=0; j<4; j++)
+            {
+                nodes.push_back(new Node<2>(4*i+j, false, 0.9*i + 0.15*(j%2), 1.1*j - 0.1*(i%3)));
+            }
+        }
+
+        NodesOnlyMesh<2> mesh;
+        mesh.ConstructNodesWithoutMesh(nodes, 1.5);
+        mesh.GetNode(5)->SetRadius(0.7);
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<FixedG1GenerationalCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, mesh.GetNumNodes());
+
+        NodeBasedCellPopulation<2> cell_population(mesh, cells);
+        cell_population.Update();
+        cell_population.GetCellUsingLocationIndex(6)->StartApoptosis();
+
+        GeneralisedLinearSpringForce<2> force;
+        force.SetCutOffLength(1.2);
+
+        std::vector<std::pair<Node<2>*, Node<2>*> >& r_node_pairs = cell_population.rGetNodePairs();
+        TS_ASSERT(!r_node_pairs.empty());
+
+        // The batched kernel must give the same forces as the per-pair method
+        std::vector<c_vector<double, 2> > batched_forces;
+        TS_ASSERT_EQUALS(force.CalculateForcesForNodePairs(r_node_pairs, cell_population, batched_forces), true);
+        TS_ASSERT_EQUALS(batched_forces.size(), r_node_pairs.size());
+
+        for (unsigned i=0; i<r_node_pairs.size(); i++)
+        {
+            c_vector<double, 2> pair_force = force.CalculateForceBetweenNodes(r_node_pairs[i].first->GetIndex(),
+                                                                              r_node_pairs[i].second->GetIndex(),
+                                                                              cell_population);
+            TS_ASSERT_DELTA(batched_forces[i][0], pair_force[0], 1e-12);
+            TS_ASSERT_DELTA(batched_forces[i][1], pair_force[1], 1e-12);
+        }
+
+        // Subclasses fall back on the per-pair method
+        DifferentialAdhesionGeneralisedLinearSpringForce<2> differential_force;
+        TS_ASSERT_EQUALS(differential_force.CalculateForcesForNodePairs(r_node_pairs, cell_population, batched_forces), false);
+
+        for (unsigned i=0; i<nodes.size(); i++)
+        {
+            delete nodes[i];
+        }
+    }
+
     void TestRepulsionForceArchiving()
     {
         EXIT_IF_PARALLEL; // Beware of processes overwriting the identical archives of other processes
@@ -1616,6 +1808,89 @@ public:
         TS_ASSERT_DELTA(applied_force_1[1], 6.76, 1e-10);
     }
 
+    void TestVertexForceJacobians()
+    {
+        // Create a small honeycomb vertex mesh and perturb it, so that the cells are not at equilibrium
+        HoneycombVertexMeshGenerator generator(3, 3);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+        for (unsigned i=0; i<p_mesh->GetNumNodes(); i++)
+        {
+            c_vector<double, 2>& r_location = p_mesh->GetNode(i)->rGetModifiableLocation();
+            r_location[0] += 0.05*sin(3.0*i);
+            r_location[1] += 0.05*cos(5.0*i);
+        }
+        p_mesh->InvalidateCachedElementData();
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<FixedG1GenerationalCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements(), std::vector<unsigned>());
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+        for (AbstractCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
+             cell_iter != cell_population.End();
+             ++cell_iter)
+        {
+            cell_iter->SetBirthTime(-5.0);
+        }
+        MAKE_PTR(SimpleTargetAreaModifier<2>, p_growth_modifier);
+        p_growth_modifier->UpdateTargetAreas(cell_population);
+
+        std::vector<boost::shared_ptr<AbstractForce<2> > > forces;
+        MAKE_PTR(NagaiHondaForce<2>, p_nagai_honda_force);
+        forces.push_back(p_nagai_honda_force);
+        MAKE_PTR(FarhadifarForce<2>, p_farhadifar_force);
+        forces.push_back(p_farhadifar_force);
+
+        unsigned num_nodes = cell_population.GetNumNodes();
+        for (unsigned f=0; f<forces.size(); f++)
+        {
+            std::vector<std::map<unsigned, c_matrix<double, 2, 2> > > jacobian(num_nodes);
+            TS_ASSERT_EQUALS(forces[f]->AddForceJacobianContribution(cell_population, jacobian), true);
+
+            // Compare each column of the Jacobian with a central difference of the forces
+            double h = 1e-6;
+            for (unsigned j=0; j<num_nodes; j++)
+            {
+                for (unsigned d=0; d<2; d++)
+                {
+                    std::vector<c_vector<double, 2> > forces_plus_minus[2];
+                    for (unsigned sign=0; sign<2; sign++)
+                    {
+                        c_vector<double, 2> location = cell_population.GetNode(j)->rGetLocation();
+                        location[d] += (sign == 0) ? h : -h;
+                        cell_population.SetNode(j, ChastePoint<2>(location));
+
+                        for (unsigned i=0; i<num_nodes; i++)
+                        {
+                            cell_population.GetNode(i)->ClearAppliedForce();
+                        }
+                        forces[f]->AddForceContribution(cell_population);
+                        for (unsigned i=0; i<num_nodes; i++)
+                        {
+                            forces_plus_minus[sign].push_back(cell_population.GetNode(i)->rGetAppliedForce());
+                        }
+
+                        location[d] -= (sign == 0) ? h : -h;
+                        cell_population.SetNode(j, ChastePoint<2>(location));
+                    }
+
+                    for (unsigned i=0; i<num_nodes; i++)
+                    {
+                        c_matrix<double, 2, 2> block = zero_matrix<double>(2, 2);
+                        if (jacobian[i].find(j) != jacobian[i].end())
+                        {
+                            block = jacobian[i][j];
+                        }
+                        for (unsigned c=0; c<2; c++)
+                        {
+                            double difference = (forces_plus_minus[0][i][c] - forces_plus_minus[1][i][c])/(2.0*h);
+                            TS_ASSERT_DELTA(block(c,d), difference, 1e-5*(1.0 + fabs(difference)));
+                        }
+                    }
+                }
+            }
+        }
+    }
+
     void TestFarhadifarForceInSimulation()
     {
         /**
@@ -2132,6 +2407,92 @@ public:
         RandomNumberGenerator::Destroy();
     }
 
+    void TestDiffusionForceWithRandomStreams()
+    {
+        RandomNumberGenerator::Instance()->Reseed(0);
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(100.0, 1000);
+
+        // Create a NodeBasedCellPopulation
+        std::vector<Node<2>*> nodes;
+        for (unsigned i=0; i<10; i++)
+        {
+            nodes.push_back(new Node<2>(i, true, 2.0*i, 0.0));
+        }
+
+        NodesOnlyMesh<2> mesh;
+        mesh.ConstructNodesWithoutMesh(nodes, 100.0);
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<FixedG1GenerationalCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, mesh.GetNumNodes());
+
+        NodeBasedCellPopulation<2> cell_population(mesh, cells);
+        cell_population.Update(); //Needs to be called separately as not in a simulation
+
+        DiffusionForce<2> force;
+        TS_ASSERT_EQUALS(force.GetUseRandomStreams(), false);
+        TS_ASSERT_EQUALS(force.GetNumberOfThreads(), 1u);
+        force.SetUseRandomStreams();
+        TS_ASSERT_EQUALS(force.GetUseRandomStreams(), true);
+        TS_ASSERT_THROWS_THIS(force.SetNumberOfThreads(0), "The number of force threads must be at least one.");
+
+        // The forces in one time step do not depend on the number of threads
+        std::vector<c_vector<double, 2> > serial_forces;
+        for (unsigned num_threads=1; num_threads<=2; num_threads++)
+        {
+            force.SetNumberOfThreads(num_threads);
+            TS_ASSERT_EQUALS(force.GetNumberOfThreads(), num_threads);
+
+            for (unsigned i=0; i<mesh.GetNumNodes(); i++)
+            {
+                mesh.GetNode(i)->ClearAppliedForce();
+            }
+            force.AddForceContribution(cell_population);
+
+            for (unsigned i=0; i<mesh.GetNumNodes(); i++)
+            {
+                if (num_threads == 1)
+                {
+                    serial_forces.push_back(mesh.GetNode(i)->rGetAppliedForce());
+                }
+                else
+                {
+                    TS_ASSERT_DELTA(mesh.GetNode(i)->rGetAppliedForce()[0], serial_forces[i][0], 1e-12);
+                    TS_ASSERT_DELTA(mesh.GetNode(i)->rGetAppliedForce()[1], serial_forces[i][1], 1e-12);
+                }
+            }
+        }
+
+        // Nor on draws from the shared generator
+        RandomNumberGenerator::Instance()->ranf();
+        mesh.GetNode(3)->ClearAppliedForce();
+        force.AddForceContribution(cell_population);
+        TS_ASSERT_DELTA(mesh.GetNode(3)->rGetAppliedForce()[0], serial_forces[3][0], 1e-12);
+
+        // Over many time steps the forces have the correct variance
+        double variance = 0.0;
+        unsigned num_iterations = 1000;
+        for (unsigned i=0; i<num_iterations; i++)
+        {
+            mesh.GetNode(0)->ClearAppliedForce();
+            force.AddForceContribution(cell_population);
+            variance += pow(norm_2(mesh.GetNode(0)->rGetAppliedForce()),2);
+            SimulationTime::Instance()->IncrementTimeOneStep();
+        }
+
+        double correct_diffusion_coefficient =
+                4.97033568e-7 * force.GetAbsoluteTemperature() / (6 * M_PI * force.GetViscosity() * mesh.GetNode(0)->GetRadius());
+        unsigned dim = 2;
+        variance /= num_iterations*2*dim*correct_diffusion_coefficient*SimulationTime::Instance()->GetTimeStep();
+        TS_ASSERT_DELTA(variance, 1.0, 1e-1);
+
+        // Avoid memory leak
+        for (unsigned i=0; i<nodes.size(); i++)
+        {
+            delete nodes[i];
+        }
+    }
+
     void TestDiffusionForceArchiving()
     {
         EXIT_IF_PARALLEL; // Beware of processes overwriting the identical archives of other processes
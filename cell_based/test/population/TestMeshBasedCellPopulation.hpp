@@ -362,6 +362,94 @@ public:
         TS_ASSERT_DELTA(area_based_damping_const, cell_population.GetDampingConstantNormal(), 1e-6);
     }
 
+    void TestVoronoiTessellationIsReused()
+    {
+        EXIT_IF_PARALLEL;    // HoneycombMeshGenerator doesn't work in parallel
+
+        HoneycombMeshGenerator generator(4, 4, 0);
+        MutableMesh<2,2>* p_mesh = generator.GetMesh();
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<FixedG1GenerationalCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumNodes());
+
+        MeshBasedCellPopulation<2> cell_population(*p_mesh, cells);
+
+        cell_population.CreateVoronoiTessellation();
+        VertexMesh<2,2>* p_tessellation = cell_population.GetVoronoiTessellation();
+        double volume = cell_population.GetVolumeOfVoronoiElement(5);
+
+        // The nodes haven't moved, so the same tessellation and cached volume are used
+        cell_population.CreateVoronoiTessellation();
+        TS_ASSERT_EQUALS(cell_population.GetVoronoiTessellation(), p_tessellation);
+        TS_ASSERT_DELTA(cell_population.GetVolumeOfVoronoiElement(5), volume, 1e-12);
+        TS_ASSERT_DELTA(cell_population.GetVolumeOfCell(cell_population.GetCellUsingLocationIndex(5)), volume, 1e-12);
+
+        // Moving a neighbouring node changes the tessellation and the volume
+        c_vector<double, 2> new_location = p_mesh->GetNode(6)->rGetLocation();
+        new_location[0] += 0.1;
+        p_mesh->GetNode(6)->rGetModifiableLocation() = new_location;
+        cell_population.CreateVoronoiTessellation();
+        TS_ASSERT_DIFFERS(fabs(cell_population.GetVolumeOfVoronoiElement(5) - volume), 0.0);
+
+        // Moving it back gives the original volume again
+        new_location[0] -= 0.1;
+        p_mesh->GetNode(6)->rGetModifiableLocation() = new_location;
+        cell_population.CreateVoronoiTessellation();
+        TS_ASSERT_DELTA(cell_population.GetVolumeOfVoronoiElement(5), volume, 1e-12);
+    }
+
+    void TestBoundaryCellRadius()
+    {
+        EXIT_IF_PARALLEL;    // HoneycombMeshGenerator doesn't work in parallel
+
+        // Create a mesh without ghost nodes
+        HoneycombMeshGenerator generator(4, 4, 0);
+        MutableMesh<2,2>* p_mesh = generator.GetMesh();
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<FixedG1GenerationalCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumNodes());
+
+        MeshBasedCellPopulation<2> cell_population(*p_mesh, cells);
+        cell_population.CreateVoronoiTessellation();
+
+        // By default boundary cells have infinite area
+        TS_ASSERT_DELTA(cell_population.GetBoundaryCellRadius(), 0.0, 1e-12);
+        CellPtr p_boundary_cell = cell_population.GetCellUsingLocationIndex(0);
+        TS_ASSERT_EQUALS(cell_population.GetVolumeOfCell(p_boundary_cell), DBL_MAX);
+
+        TS_ASSERT_THROWS_THIS(cell_population.SetBoundaryCellRadius(0.0), "The boundary cell radius must be positive");
+
+        // A large radius does not change the area of an interior cell
+        cell_population.SetBoundaryCellRadius(10.0);
+        TS_ASSERT_DELTA(cell_population.GetBoundaryCellRadius(), 10.0, 1e-12);
+        TS_ASSERT_DELTA(cell_population.GetBoundedVoronoiArea(5), 0.5*sqrt(3.0), 1e-6);
+
+        // A boundary cell is given a finite area, less than that of the bounding disc
+        cell_population.SetBoundaryCellRadius(1.0);
+        double boundary_area = cell_population.GetVolumeOfCell(p_boundary_cell);
+        TS_ASSERT_LESS_THAN(0.5*sqrt(3.0), boundary_area);
+        TS_ASSERT_LESS_THAN(boundary_area, M_PI);
+
+        // ...which is also used for the area-based damping constant
+        cell_population.SetAreaBasedDampingConstant(true);
+        double d0 = cell_population.GetAreaBasedDampingConstantParameter();
+        double d1 = 2.0*(1.0 - d0)/sqrt(3.0);
+        TS_ASSERT_DELTA(cell_population.GetDampingConstant(0), d0 + boundary_area*d1, 1e-6);
+
+        // Not implemented in 3D
+        TrianglesMeshReader<3,3> mesh_reader("mesh/test/data/cube_136_elements");
+        MutableMesh<3,3> mesh_3d;
+        mesh_3d.ConstructFromMeshReader(mesh_reader);
+        std::vector<CellPtr> cells_3d;
+        CellsGenerator<FixedG1GenerationalCellCycleModel, 3> cells_generator_3d;
+        cells_generator_3d.GenerateBasic(cells_3d, mesh_3d.GetNumNodes());
+        MeshBasedCellPopulation<3> cell_population_3d(mesh_3d, cells_3d);
+        TS_ASSERT_THROWS_THIS(cell_population_3d.SetBoundaryCellRadius(1.0),
+                              "Bounded boundary cell areas are only implemented in 2D");
+    }
+
     void TestSetNodeAndAddCell()
     {
         // Create a simple mesh
@@ -42,6 +42,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <boost/archive/text_iarchive.hpp>
 
 #include <algorithm>
+#include <map>
 
 #include "AbstractCellBasedTestSuite.hpp"
 #include "ApcOneHitCellMutationState.hpp"
@@ -51,6 +52,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "BernoulliTrialCellCycleModel.hpp"
 #include "BetaCateninOneHitCellMutationState.hpp"
 #include "CellAncestor.hpp"
+#include "CellBasedBinaryResultsFile.hpp"
 #include "CellLabel.hpp"
 #include "CellPropertyRegistry.hpp"
 #include "CellsGenerator.hpp"
@@ -859,6 +861,36 @@ public:
             TS_ASSERT_EQUALS(node_4_neighbours.size(), expected_node_4_neighbours.size());
             TS_ASSERT_EQUALS(node_4_neighbours, expected_node_4_neighbours);
         }
+
+        // The cached neighbour lists agree with the sets, in increasing order
+        for (AbstractMesh<2,2>::NodeIterator node_iter = mesh.GetNodeIteratorBegin();
+                node_iter != mesh.GetNodeIteratorEnd();
+                ++node_iter)
+        {
+            std::set<unsigned> neighbours = node_based_cell_population.GetNeighbouringNodeIndices(node_iter->GetIndex());
+            NodeIndexRange cached_neighbours = node_based_cell_population.GetCachedNeighbouringNodeIndices(node_iter->GetIndex());
+
+            TS_ASSERT_EQUALS(cached_neighbours.size(), neighbours.size());
+            TS_ASSERT_EQUALS(std::set<unsigned>(cached_neighbours.begin(), cached_neighbours.end()), neighbours);
+            for (unsigned i=1; i<cached_neighbours.size(); i++)
+            {
+                TS_ASSERT_LESS_THAN(cached_neighbours[i-1], cached_neighbours[i]);
+            }
+        }
+
+        // Moving a node through the population refreshes the cached lists
+        if (PetscTools::IsSequential())
+        {
+            TS_ASSERT_EQUALS(node_based_cell_population.GetCachedNeighbouringNodeIndices(4).size(), 3u);
+
+            ChastePoint<2> new_location(0.9, 0.1);
+            node_based_cell_population.SetNode(4, new_location);
+
+            NodeIndexRange cached_node_4_neighbours = node_based_cell_population.GetCachedNeighbouringNodeIndices(4);
+            std::set<unsigned> node_4_neighbours = node_based_cell_population.GetNeighbouringNodeIndices(4);
+            TS_ASSERT_EQUALS(std::set<unsigned>(cached_node_4_neighbours.begin(), cached_node_4_neighbours.end()), node_4_neighbours);
+            TS_ASSERT_EQUALS(node_4_neighbours.count(3), 0u);
+        }
     }
 
     void TestGetNodesWithinNeighbourhoodRadius()
@@ -1395,6 +1427,172 @@ public:
 #endif
     }
 
+    void TestNodeBasedCellPopulationBinaryOutput()
+    {
+        EXIT_IF_PARALLEL;    // Population writers don't work in parallel yet
+
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(1.0, 2);
+
+        // Create a simple mesh
+        TrianglesMeshReader<2,2> mesh_reader("mesh/test/data/square_2_elements");
+        TetrahedralMesh<2,2> generating_mesh;
+        generating_mesh.ConstructFromMeshReader(mesh_reader);
+
+        // Convert this to a NodesOnlyMesh
+        NodesOnlyMesh<2> mesh;
+        mesh.ConstructNodesWithoutMesh(generating_mesh, 1.5);
+
+        // Create a cell population writing to both text and binary files
+        std::vector<CellPtr> cells;
+        CellsGenerator<FixedG1GenerationalCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, mesh.GetNumNodes());
+
+        NodeBasedCellPopulation<2> cell_population(mesh, cells);
+        cell_population.Update();
+        cell_population.SetCellAncestorsToLocationIndices();
+
+        cell_population.AddCellWriter<CellAgesWriter>();
+        cell_population.AddCellWriter<CellAncestorWriter>();
+        cell_population.AddCellWriter<CellVolumesWriter>();
+        cell_population.AddCellPopulationCountWriter<CellProliferativeTypesCountWriter>();
+
+        TS_ASSERT_EQUALS(cell_population.GetOutputResultsInBinaryFile(), false);
+
+        std::string text_directory = "TestNodeBasedCellPopulationBinaryOutput/text";
+        OutputFileHandler text_handler(text_directory);
+        std::string binary_directory = "TestNodeBasedCellPopulationBinaryOutput/binary";
+        OutputFileHandler binary_handler(binary_directory);
+
+        cell_population.OpenWritersFiles(text_handler);
+        for (unsigned i=0; i<2; i++)
+        {
+            cell_population.WriteResultsToFiles(text_directory);
+            SimulationTime::Instance()->IncrementTimeOneStep();
+        }
+        cell_population.CloseWritersFiles();
+
+        SimulationTime::Destroy();
+        SimulationTime::Instance()->SetStartTime(0.0);
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(1.0, 2);
+
+        cell_population.SetOutputResultsInBinaryFile();
+        TS_ASSERT_EQUALS(cell_population.GetOutputResultsInBinaryFile(), true);
+
+        cell_population.OpenWritersFiles(binary_handler);
+        for (unsigned i=0; i<2; i++)
+        {
+            cell_population.WriteResultsToFiles(binary_directory);
+            SimulationTime::Instance()->IncrementTimeOneStep();
+        }
+        cell_population.CloseWritersFiles();
+
+        // Only the binary results file is written, and the legacy files may be recovered from it exactly
+        FileFinder binary_file = binary_handler.FindFile(CellBasedBinaryResultsFile::DEFAULT_FILE_NAME);
+        TS_ASSERT(binary_file.IsFile());
+        TS_ASSERT(!binary_handler.FindFile("cellages.dat").Exists());
+
+        OutputFileHandler converted_handler("TestNodeBasedCellPopulationBinaryOutput/converted");
+        CellBasedBinaryResultsFile::ConvertToLegacyFiles(binary_file, converted_handler);
+
+        std::string text_dir = text_handler.GetOutputDirectoryFullPath();
+        std::string converted_dir = converted_handler.GetOutputDirectoryFullPath();
+        FileComparison(converted_dir + "cellages.dat", text_dir + "cellages.dat").CompareFiles();
+        FileComparison(converted_dir + "results.vizancestors", text_dir + "results.vizancestors").CompareFiles();
+        FileComparison(converted_dir + "cellareas.dat", text_dir + "cellareas.dat").CompareFiles();
+        FileComparison(converted_dir + "celltypes.dat", text_dir + "celltypes.dat").CompareFiles();
+        FileComparison(converted_dir + "results.viznodes", text_dir + "results.viznodes").CompareFiles();
+        FileComparison(converted_dir + "results.vizcelltypes", text_dir + "results.vizcelltypes").CompareFiles();
+
+        // Write the binary results file again, this time from a background thread
+        SimulationTime::Destroy();
+        SimulationTime::Instance()->SetStartTime(0.0);
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(1.0, 2);
+
+        TS_ASSERT_EQUALS(cell_population.GetWriteResultsAsynchronously(), false);
+        cell_population.SetWriteResultsAsynchronously(true, 1);
+        TS_ASSERT_EQUALS(cell_population.GetWriteResultsAsynchronously(), true);
+
+        std::string async_directory = "TestNodeBasedCellPopulationBinaryOutput/async";
+        OutputFileHandler async_handler(async_directory);
+        cell_population.OpenWritersFiles(async_handler);
+        for (unsigned i=0; i<2; i++)
+        {
+            cell_population.WriteResultsToFiles(async_directory);
+            SimulationTime::Instance()->IncrementTimeOneStep();
+        }
+        cell_population.CloseWritersFiles();
+
+        OutputFileHandler async_converted_handler("TestNodeBasedCellPopulationBinaryOutput/async_converted");
+        CellBasedBinaryResultsFile::ConvertToLegacyFiles(async_handler.FindFile(CellBasedBinaryResultsFile::DEFAULT_FILE_NAME),
+                                                         async_converted_handler);
+        std::string async_converted_dir = async_converted_handler.GetOutputDirectoryFullPath();
+        FileComparison(async_converted_dir + "cellages.dat", text_dir + "cellages.dat").CompareFiles();
+        FileComparison(async_converted_dir + "celltypes.dat", text_dir + "celltypes.dat").CompareFiles();
+        FileComparison(async_converted_dir + "results.viznodes", text_dir + "results.viznodes").CompareFiles();
+
+        cell_population.SetWriteResultsAsynchronously(false);
+        TS_ASSERT_EQUALS(cell_population.GetWriteResultsAsynchronously(), false);
+
+        // Asynchronous output requires binary output
+        cell_population.SetOutputResultsInBinaryFile(false);
+        TS_ASSERT_THROWS_CONTAINS(cell_population.SetWriteResultsAsynchronously(),
+                                  "Asynchronous output requires results to be written to a binary file");
+
+        // Converting a file that is not a binary results file throws
+        FileFinder text_file = text_handler.FindFile("cellages.dat");
+        TS_ASSERT_THROWS_CONTAINS(CellBasedBinaryResultsFile::ConvertToLegacyFiles(text_file, converted_handler),
+                                  "is not a cell-based binary results file");
+    }
+
+    void TestVtkOutputSamplingMultiple()
+    {
+        EXIT_IF_PARALLEL;    // Population writers don't work in parallel yet
+
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(1.0, 4);
+
+        // Create a simple mesh
+        TrianglesMeshReader<2,2> mesh_reader("mesh/test/data/square_2_elements");
+        TetrahedralMesh<2,2> generating_mesh;
+        generating_mesh.ConstructFromMeshReader(mesh_reader);
+
+        // Convert this to a NodesOnlyMesh
+        NodesOnlyMesh<2> mesh;
+        mesh.ConstructNodesWithoutMesh(generating_mesh, 1.5);
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<FixedG1GenerationalCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, mesh.GetNumNodes());
+
+        NodeBasedCellPopulation<2> cell_population(mesh, cells);
+        cell_population.Update();
+
+        TS_ASSERT_EQUALS(cell_population.GetVtkOutputSamplingMultiple(), 1u);
+        TS_ASSERT_THROWS_THIS(cell_population.SetVtkOutputSamplingMultiple(0),
+                              "The VTK output sampling multiple must be at least one.");
+        cell_population.SetVtkOutputSamplingMultiple(2);
+        TS_ASSERT_EQUALS(cell_population.GetVtkOutputSamplingMultiple(), 2u);
+
+        std::string output_directory = "TestVtkOutputSamplingMultiple";
+        OutputFileHandler output_file_handler(output_directory);
+
+        cell_population.OpenWritersFiles(output_file_handler);
+        for (unsigned i=0; i<4; i++)
+        {
+            cell_population.WriteResultsToFiles(output_directory);
+            SimulationTime::Instance()->IncrementTimeOneStep();
+        }
+        cell_population.CloseWritersFiles();
+
+        // Text results are written every time, but VTK results only every other time
+        TS_ASSERT(output_file_handler.FindFile("results.viznodes").IsFile());
+#ifdef CHASTE_VTK
+        TS_ASSERT(output_file_handler.FindFile("results_0.vtu").IsFile());
+        TS_ASSERT(!output_file_handler.FindFile("results_1.vtu").Exists());
+        TS_ASSERT(output_file_handler.FindFile("results_2.vtu").IsFile());
+        TS_ASSERT(!output_file_handler.FindFile("results_3.vtu").Exists());
+#endif //CHASTE_VTK
+    }
+
     void TestWritingCellCyclePhases()
     {
         EXIT_IF_PARALLEL;    // Population writers dont work in parallel yet.
@@ -1629,6 +1827,126 @@ public:
         }
     }
 
+    void TestReuseNodePairsWithVerletSkin()
+    {
+        EXIT_IF_PARALLEL;  // Node pairs are always recalculated in parallel
+
+        TrianglesMeshReader<2,2> mesh_reader("mesh/test/data/square_4_elements");
+        TetrahedralMesh<2,2> generating_mesh;
+        generating_mesh.ConstructFromMeshReader(mesh_reader);
+
+        NodesOnlyMesh<2> mesh;
+        TS_ASSERT_DELTA(mesh.GetVerletSkin(), 0.0, 1e-12);
+        mesh.SetVerletSkin(0.2);
+        TS_ASSERT_DELTA(mesh.GetVerletSkin(), 0.2, 1e-12);
+        mesh.ConstructNodesWithoutMesh(generating_mesh, 1.2);
+
+        // The boxes are widened by the skin
+        TS_ASSERT_DELTA(mesh.GetBoxCollection()->GetBoxWidth(), 1.4, 1e-12);
+        TS_ASSERT_DELTA(mesh.GetBoxCollection()->GetVerletSkin(), 0.2, 1e-12);
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<FixedG1GenerationalCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, mesh.GetNumNodes());
+        NodeBasedCellPopulation<2> cell_population(mesh, cells);
+
+        cell_population.Update();
+        TS_ASSERT(mesh.AreNodePairsStillValid());
+        std::vector<std::pair<Node<2>*, Node<2>*> > original_pairs = cell_population.rGetNodePairs();
+        TS_ASSERT(!original_pairs.empty());
+
+        // Moving a node by less than half the skin keeps the pairs
+        ChastePoint<2> small_move(0.05, 0.0);
+        cell_population.SetNode(0, small_move);
+        TS_ASSERT(mesh.AreNodePairsStillValid());
+        std::vector<std::pair<Node<2>*, Node<2>*> >& r_marker_pairs = cell_population.rGetNodePairs();
+        r_marker_pairs.push_back(original_pairs[0]);
+        cell_population.Update(false);
+        TS_ASSERT_EQUALS(cell_population.rGetNodePairs().size(), original_pairs.size() + 1);
+
+        // ...but not if there have been births or deaths
+        cell_population.Update(true);
+        TS_ASSERT_EQUALS(cell_population.rGetNodePairs().size(), original_pairs.size());
+
+        // Moving it further means the pairs are recalculated
+        ChastePoint<2> large_move(0.2, 0.0);
+        cell_population.SetNode(0, large_move);
+        TS_ASSERT(!mesh.AreNodePairsStillValid());
+        cell_population.rGetNodePairs().push_back(original_pairs[0]);
+        cell_population.Update(false);
+        TS_ASSERT_EQUALS(cell_population.rGetNodePairs().size(), original_pairs.size());
+        TS_ASSERT(mesh.AreNodePairsStillValid());
+
+        // Without a skin pairs are never reused
+        NodesOnlyMesh<2> plain_mesh;
+        plain_mesh.ConstructNodesWithoutMesh(generating_mesh, 1.2);
+        plain_mesh.RecordNodeLocationsForNodePairs();
+        TS_ASSERT(!plain_mesh.AreNodePairsStillValid());
+    }
+
+    void TestReorderNodesSpatially()
+    {
+        EXIT_IF_PARALLEL;  // Only the nodes on each process are sorted, so the ordering checked here is for one process
+
+        // Create a 4x4 grid of nodes in reverse order
+        std::vector<Node<2>*> nodes;
+        for (unsigned i=0; i<16; i++)
+        {
+            unsigned j = 15 - i;
+            nodes.push_back(new Node<2>(i, false, (double)(j%4), (double)(j/4)));
+        }
+        NodesOnlyMesh<2> mesh;
+        mesh.ConstructNodesWithoutMesh(nodes, 1.5);
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<FixedG1GenerationalCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, mesh.GetNumNodes());
+        NodeBasedCellPopulation<2> cell_population(mesh, cells);
+
+        std::map<CellPtr, c_vector<double, 2> > old_cell_locations;
+        for (AbstractCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
+             cell_iter != cell_population.End();
+             ++cell_iter)
+        {
+            old_cell_locations[*cell_iter] = cell_population.GetLocationOfCellCentre(*cell_iter);
+            unsigned node_index = cell_population.GetLocationIndexUsingCell(*cell_iter);
+            cell_population.GetNode(node_index)->SetRadius(0.1*node_index + 0.1);
+        }
+
+        TS_ASSERT(mesh.ReorderNodesSpatially());
+        mesh.UpdateBoxCollection();
+
+        // The node at the origin (the last one created) now comes first, and indices are unchanged
+        TS_ASSERT_EQUALS(mesh.GetNodeIteratorBegin()->GetIndex(), 15u);
+        TS_ASSERT_DELTA(norm_2(mesh.GetNodeIteratorBegin()->rGetLocation()), 0.0, 1e-12);
+        TS_ASSERT_DELTA(mesh.GetNode(0u)->rGetLocation()[0], 3.0, 1e-12);
+        TS_ASSERT_DELTA(mesh.GetNode(0u)->rGetLocation()[1], 3.0, 1e-12);
+
+        // Each cell is still at the same place, and its node has kept its radius
+        for (AbstractCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
+             cell_iter != cell_population.End();
+             ++cell_iter)
+        {
+            c_vector<double, 2> location = cell_population.GetLocationOfCellCentre(*cell_iter);
+            TS_ASSERT_DELTA(location[0], old_cell_locations[*cell_iter][0], 1e-12);
+            TS_ASSERT_DELTA(location[1], old_cell_locations[*cell_iter][1], 1e-12);
+            unsigned node_index = cell_population.GetLocationIndexUsingCell(*cell_iter);
+            TS_ASSERT_DELTA(cell_population.GetNode(node_index)->GetRadius(), 0.1*node_index + 0.1, 1e-12);
+        }
+
+        // The population can sort the nodes as it updates
+        TS_ASSERT_EQUALS(cell_population.GetSpatialSortFrequency(), 0u);
+        cell_population.SetSpatialSortFrequency(1);
+        TS_ASSERT_EQUALS(cell_population.GetSpatialSortFrequency(), 1u);
+        cell_population.Update();
+        TS_ASSERT(!cell_population.rGetNodePairs().empty());
+
+        for (unsigned i=0; i<nodes.size(); i++)
+        {
+            delete nodes[i];
+        }
+    }
+
     void TestGetTetrahedralMeshForPdeModifier()
     {
         EXIT_IF_PARALLEL;  // The population.GetTetrahedralMeshForPdeModifier() method does not yet work in parallel.
@@ -137,6 +137,48 @@ public:
         TS_ASSERT_EQUALS(node_left_index, index_of_node_to_send);
     }
 
+    void TestPackAndUnpackCellsAndNodes()
+    {
+        unsigned index_of_node_to_send = mpNodesOnlyMesh->GetNodeIteratorBegin()->GetIndex();
+        Node<3>* p_node = mpNodesOnlyMesh->GetNode(index_of_node_to_send);
+        p_node->SetRadius(0.7);
+        p_node->AddNodeAttribute(2.5);
+        c_vector<double, 3> force = scalar_vector<double>(3, 0.25);
+        p_node->AddAppliedForceContribution(force);
+
+        CellPtr p_cell = mpNodeBasedCellPopulation->GetCellUsingLocationIndex(index_of_node_to_send);
+        p_cell->SetBirthTime(-3.0);
+
+        mpNodeBasedCellPopulation->AddNodeAndCellToSendRight(index_of_node_to_send);
+        boost::shared_ptr<std::vector<std::pair<CellPtr, Node<3>* > > > p_cells_right(&(mpNodeBasedCellPopulation->mCellsToSendRight), null_deleter());
+
+        std::string buffer;
+        ObjectPacker<std::vector<std::pair<CellPtr, Node<3>* > > >::Pack(p_cells_right, buffer);
+
+        boost::shared_ptr<std::vector<std::pair<CellPtr, Node<3>* > > > p_unpacked =
+            ObjectPacker<std::vector<std::pair<CellPtr, Node<3>* > > >::Unpack(buffer.data(), buffer.size());
+
+        TS_ASSERT_EQUALS(p_unpacked->size(), 1u);
+        Node<3>* p_unpacked_node = (*p_unpacked)[0].second;
+        TS_ASSERT_EQUALS(p_unpacked_node->GetIndex(), index_of_node_to_send);
+        for (unsigned d=0; d<3; d++)
+        {
+            TS_ASSERT_DELTA(p_unpacked_node->rGetLocation()[d], p_node->rGetLocation()[d], 1e-12);
+            TS_ASSERT_DELTA(p_unpacked_node->rGetAppliedForce()[d], p_node->rGetAppliedForce()[d], 1e-12);
+        }
+        TS_ASSERT_DELTA(p_unpacked_node->GetRadius(), 0.7, 1e-12);
+        TS_ASSERT_EQUALS(p_unpacked_node->GetNumNodeAttributes(), 1u);
+        TS_ASSERT_DELTA(p_unpacked_node->rGetNodeAttributes()[0], 2.5, 1e-12);
+
+        // The cell goes through boost, so comes back as a copy with the same state
+        CellPtr p_unpacked_cell = (*p_unpacked)[0].first;
+        TS_ASSERT(p_unpacked_cell != p_cell);
+        TS_ASSERT_DELTA(p_unpacked_cell->GetBirthTime(), -3.0, 1e-12);
+        TS_ASSERT_EQUALS(p_unpacked_cell->GetCellId(), p_cell->GetCellId());
+
+        delete p_unpacked_node;
+    }
+
     void TestSendAndReceiveCells()
     {
         unsigned index_of_node_to_send = mpNodesOnlyMesh->GetNodeIteratorBegin()->GetIndex();;
@@ -54,6 +54,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "CellId.hpp"
 #include "MutableMesh.hpp"
 #include "FileComparison.hpp"
+#include "RandomNumberGenerator.hpp"
 
 // Cell writers
 #include "CellAgesWriter.hpp"
@@ -421,6 +422,77 @@ public:
         TS_ASSERT_EQUALS(cell_population.rGetMesh().GetElement(1)->GetNumNodes(), 4u);
     }
 
+    void TestUpdateCellLocationsOnSublattices()
+    {
+        // Run the same sublattice updates with one and with four threads
+        std::vector<unsigned> num_nodes_in_elements[2];
+        for (unsigned run=0; run<2; run++)
+        {
+            RandomNumberGenerator::Instance()->Reseed(0);
+
+            // Create a 2D PottsMesh with four cells surrounded by medium
+            PottsMeshGenerator<2> generator(8, 2, 2, 8, 2, 2);
+            PottsMesh<2>* p_mesh = generator.GetMesh();
+
+            std::vector<CellPtr> cells;
+            CellsGenerator<FixedG1GenerationalCellCycleModel, 2> cells_generator;
+            cells_generator.GenerateBasic(cells, p_mesh->GetNumElements());
+
+            PottsBasedCellPopulation<2> cell_population(*p_mesh, cells);
+            cell_population.SetTemperature(10.0);
+            cell_population.SetNumSweepsPerTimestep(2);
+
+            MAKE_PTR(VolumeConstraintPottsUpdateRule<2>, p_volume_constraint_update_rule);
+            cell_population.AddUpdateRule(p_volume_constraint_update_rule);
+
+            // Test set and get methods
+            TS_ASSERT_EQUALS(cell_population.GetUseSublatticeUpdates(), false);
+            TS_ASSERT_EQUALS(cell_population.GetNumberOfThreads(), 1u);
+            cell_population.SetUseSublatticeUpdates();
+            TS_ASSERT_EQUALS(cell_population.GetUseSublatticeUpdates(), true);
+            TS_ASSERT_THROWS_THIS(cell_population.SetNumberOfThreads(0), "The number of threads must be at least one.");
+            cell_population.SetNumberOfThreads(run == 0 ? 1 : 4);
+
+            // On a regular lattice the sublattices form a checkerboard, with no two neighbours in the same sublattice
+            cell_population.ComputeSublattices();
+            TS_ASSERT_EQUALS(cell_population.mSublattices.size(), 4u);
+            for (unsigned colour=0; colour<cell_population.mSublattices.size(); colour++)
+            {
+                const std::vector<unsigned>& r_sites = cell_population.mSublattices[colour];
+                TS_ASSERT_EQUALS(r_sites.size(), 16u);
+                for (unsigned i=0; i<r_sites.size(); i++)
+                {
+                    const std::set<unsigned>& r_neighbours = p_mesh->rGetMooreNeighbouringNodeIndices(r_sites[i]);
+                    for (unsigned j=0; j<r_sites.size(); j++)
+                    {
+                        TS_ASSERT_EQUALS(r_neighbours.count(r_sites[j]), 0u);
+                    }
+                }
+            }
+
+            cell_population.UpdateCellLocations(1.0);
+
+            TS_ASSERT_EQUALS(cell_population.rGetCells().size(), 4u);
+            for (unsigned elem_index=0; elem_index<p_mesh->GetNumElements(); elem_index++)
+            {
+                num_nodes_in_elements[run].push_back(p_mesh->GetElement(elem_index)->GetNumNodes());
+            }
+
+            // Each node must remain in at most one element
+            for (unsigned node_index=0; node_index<p_mesh->GetNumNodes(); node_index++)
+            {
+                TS_ASSERT_LESS_THAN_EQUALS(p_mesh->GetNode(node_index)->GetNumContainingElements(), 1u);
+            }
+        }
+
+        // The results do not depend on the number of threads
+        TS_ASSERT_EQUALS(num_nodes_in_elements[0].size(), num_nodes_in_elements[1].size());
+        for (unsigned i=0; i<num_nodes_in_elements[0].size(); i++)
+        {
+            TS_ASSERT_EQUALS(num_nodes_in_elements[0][i], num_nodes_in_elements[1][i]);
+        }
+    }
+
     ///\todo implement this test (#1666)
 //    void TestVoronoiMethods()
 //    {
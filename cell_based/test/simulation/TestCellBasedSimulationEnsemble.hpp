@@ -0,0 +1,139 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTCELLBASEDSIMULATIONENSEMBLE_HPP_
+#define TESTCELLBASEDSIMULATIONENSEMBLE_HPP_
+
+#include <cxxtest/TestSuite.h>
+
+// Must be included before other cell_based headers
+#include "CellBasedSimulationEnsemble.hpp"
+
+#include "CellsGenerator.hpp"
+#include "OffLatticeSimulation.hpp"
+#include "NodeBasedCellPopulation.hpp"
+#include "GeneralisedLinearSpringForce.hpp"
+#include "DiffusionForce.hpp"
+#include "HoneycombMeshGenerator.hpp"
+#include "FixedG1GenerationalCellCycleModel.hpp"
+#include "AbstractCellBasedTestSuite.hpp"
+#include "SmartPointers.hpp"
+
+#include "PetscSetupAndFinalize.hpp"
+
+class TestCellBasedSimulationEnsemble : public AbstractCellBasedTestSuite
+{
+public:
+
+    void TestEnsembleOfNodeBasedSimulations()
+    {
+        EXIT_IF_PARALLEL;    // HoneycombMeshGenerator does not work in parallel.
+
+        HoneycombMeshGenerator generator(3, 3, 0);
+        NodesOnlyMesh<2> mesh;
+        mesh.ConstructNodesWithoutMesh(*generator.GetMesh(), 1.5);
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<FixedG1GenerationalCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasicRandom(cells, mesh.GetNumNodes());
+        NodeBasedCellPopulation<2> cell_population(mesh, cells);
+
+        // The random motion makes each replicate depend on its seed
+        OffLatticeSimulation<2> simulator(cell_population);
+        simulator.SetEndTime(0.5);
+        MAKE_PTR(GeneralisedLinearSpringForce<2>, p_spring_force);
+        p_spring_force->SetCutOffLength(1.5);
+        simulator.AddForce(p_spring_force);
+        MAKE_PTR(DiffusionForce<2>, p_diffusion_force);
+        simulator.AddForce(p_diffusion_force);
+
+        typedef CellBasedSimulationEnsemble<2, OffLatticeSimulation<2> > Ensemble;
+        TS_ASSERT_THROWS_THIS(Ensemble(&simulator, 0), "An ensemble needs at least one replicate.");
+
+        Ensemble ensemble(&simulator, 3);
+        TS_ASSERT_THROWS_THIS(ensemble.Run(),
+                              "The output directory of the template simulation must be set before running an ensemble.");
+
+        simulator.SetOutputDirectory("TestCellBasedSimulationEnsemble");
+        ensemble.SetBaseSeed(10);
+        TS_ASSERT_EQUALS(ensemble.GetBaseSeed(), 10u);
+        TS_ASSERT_EQUALS(ensemble.GetNumReplicates(), 3u);
+        TS_ASSERT_EQUALS(ensemble.GetReplicateOutputDirectory(2), "TestCellBasedSimulationEnsemble/replicate_2");
+        TS_ASSERT_EQUALS(ensemble.GetReplicatesForThisProcess().size(), 3u);
+
+        std::vector<c_vector<double, 2> > node_locations(3);
+        std::vector<double> end_times(3);
+        ensemble.SetReplicateCallback([&](unsigned replicate, OffLatticeSimulation<2>& rSimulation)
+        {
+            node_locations[replicate] = rSimulation.rGetCellPopulation().GetNode(4)->rGetLocation();
+            end_times[replicate] = SimulationTime::Instance()->GetTime();
+        });
+
+        c_vector<double, 2> template_location = simulator.rGetCellPopulation().GetNode(4)->rGetLocation();
+        ensemble.Run();
+
+        // Each replicate ran to the end, writing to its own folder
+        for (unsigned replicate=0; replicate<3; replicate++)
+        {
+            TS_ASSERT_DELTA(end_times[replicate], 0.5, 1e-9);
+            FileFinder node_file(ensemble.GetReplicateOutputDirectory(replicate) + "/results_from_time_0/results.viznodes",
+                                 RelativeTo::ChasteTestOutput);
+            TS_ASSERT(node_file.IsFile());
+        }
+        TS_ASSERT_LESS_THAN(1e-6, norm_2(node_locations[0] - node_locations[1]));
+        TS_ASSERT_LESS_THAN(1e-6, norm_2(node_locations[1] - node_locations[2]));
+
+        // The template and the simulation time are left alone
+        TS_ASSERT_DELTA(SimulationTime::Instance()->GetTime(), 0.0, 1e-12);
+        TS_ASSERT_DELTA(norm_2(simulator.rGetCellPopulation().GetNode(4)->rGetLocation() - template_location), 0.0, 1e-12);
+
+        // Running again with the same seeds reproduces the replicates
+        std::vector<c_vector<double, 2> > first_locations = node_locations;
+        ensemble.Run();
+        for (unsigned replicate=0; replicate<3; replicate++)
+        {
+            TS_ASSERT_DELTA(node_locations[replicate][0], first_locations[replicate][0], 1e-12);
+            TS_ASSERT_DELTA(node_locations[replicate][1], first_locations[replicate][1], 1e-12);
+        }
+
+        // ...and a replicate is the same as solving the template with its seed
+        RandomNumberGenerator::Instance()->Reseed(11);
+        simulator.Solve();
+        TS_ASSERT_DELTA(simulator.rGetCellPopulation().GetNode(4)->rGetLocation()[0], first_locations[1][0], 1e-12);
+        TS_ASSERT_DELTA(simulator.rGetCellPopulation().GetNode(4)->rGetLocation()[1], first_locations[1][1], 1e-12);
+    }
+};
+
+#endif /*TESTCELLBASEDSIMULATIONENSEMBLE_HPP_*/
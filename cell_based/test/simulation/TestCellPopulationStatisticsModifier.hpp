@@ -0,0 +1,270 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTCELLPOPULATIONSTATISTICSMODIFIER_HPP_
+#define TESTCELLPOPULATIONSTATISTICSMODIFIER_HPP_
+
+#include <cxxtest/TestSuite.h>
+
+// Must be included before other cell_based headers
+#include "CellBasedSimulationArchiver.hpp"
+
+#include <fstream>
+#include <sstream>
+
+#include "AbstractCellBasedTestSuite.hpp"
+#include "SmartPointers.hpp"
+#include "CellPopulationStatisticsModifier.hpp"
+#include "AbstractCellBasedSimulationModifier.hpp"
+#include "CellsGenerator.hpp"
+#include "FixedG1GenerationalCellCycleModel.hpp"
+#include "GeneralisedLinearSpringForce.hpp"
+#include "NodeBasedCellPopulation.hpp"
+#include "OffLatticeSimulation.hpp"
+#include "TetrahedralMesh.hpp"
+#include "TransitCellProliferativeType.hpp"
+#include "TrianglesMeshReader.hpp"
+
+#include "PetscSetupAndFinalize.hpp"
+
+class TestCellPopulationStatisticsModifier : public AbstractCellBasedTestSuite
+{
+private:
+
+    /**
+     * Read the lines of a statistics file after its header, as rows of numbers.
+     */
+    std::vector<std::vector<double> > ReadStatistics(const FileFinder& rFile)
+    {
+        std::ifstream file(rFile.GetAbsolutePath().c_str());
+        std::string line;
+        std::getline(file, line); // Header
+
+        std::vector<std::vector<double> > rows;
+        while (std::getline(file, line))
+        {
+            std::stringstream line_stream(line);
+            std::vector<double> row;
+            double value;
+            while (line_stream >> value)
+            {
+                row.push_back(value);
+            }
+            rows.push_back(row);
+        }
+        return rows;
+    }
+
+public:
+
+    void TestStatisticsOfNodeBasedCellPopulation()
+    {
+        EXIT_IF_PARALLEL;    // The expected neighbour counts assume every cell is owned by one process
+
+        // Create a population of four cells at the corners of the unit square
+        TrianglesMeshReader<2,2> mesh_reader("mesh/test/data/square_2_elements");
+        TetrahedralMesh<2,2> generating_mesh;
+        generating_mesh.ConstructFromMeshReader(mesh_reader);
+        NodesOnlyMesh<2> mesh;
+        mesh.ConstructNodesWithoutMesh(generating_mesh, 1.5);
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<FixedG1GenerationalCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, mesh.GetNumNodes());
+
+        NodeBasedCellPopulation<2> cell_population(mesh, cells);
+        cell_population.Update();
+
+        MAKE_PTR(TransitCellProliferativeType, p_transit_type);
+        for (AbstractCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
+             cell_iter != cell_population.End();
+             ++cell_iter)
+        {
+            unsigned index = cell_population.GetLocationIndexUsingCell(*cell_iter);
+            cell_iter->GetCellData()->SetItem("data", 1.0 + index);
+            if (index == 0)
+            {
+                cell_iter->SetCellProliferativeType(p_transit_type);
+            }
+        }
+
+        MAKE_PTR(CellPopulationStatisticsModifier<2>, p_modifier);
+        TS_ASSERT_EQUALS(p_modifier->GetOutputProliferativeTypeCounts(), true);
+        TS_ASSERT_EQUALS(p_modifier->GetOutputCellVolumeMoments(), false);
+        TS_ASSERT_EQUALS(p_modifier->GetNumRadialBins(), 0u);
+        TS_ASSERT_EQUALS(p_modifier->GetMaxNumNeighboursInHistogram(), UNSIGNED_UNSET);
+        TS_ASSERT(p_modifier->rGetCellDataItemNames().empty());
+
+        p_modifier->AddCellDataItemMoments("data");
+        p_modifier->SetNumRadialBins(2);
+        p_modifier->SetMaxNumNeighboursInHistogram(2);
+        TS_ASSERT_EQUALS(p_modifier->rGetCellDataItemNames().size(), 1u);
+        TS_ASSERT_EQUALS(p_modifier->GetNumRadialBins(), 2u);
+        TS_ASSERT_EQUALS(p_modifier->GetMaxNumNeighboursInHistogram(), 2u);
+
+        std::string output_directory = "TestStatisticsOfNodeBasedCellPopulation";
+        OutputFileHandler output_file_handler(output_directory);
+        p_modifier->SetupSolve(cell_population, output_directory);
+        p_modifier->UpdateAtEndOfSolve(cell_population);
+
+        if (PetscTools::AmMaster())
+        {
+            FileFinder statistics_file = output_file_handler.FindFile("populationstatistics.dat");
+            std::vector<std::vector<double> > rows = ReadStatistics(statistics_file);
+            TS_ASSERT_EQUALS(rows.size(), 1u);
+
+            // Time, 4 type counts, 4 moments, 2 radial bins, mean neighbours and 3 neighbour bins
+            std::vector<double>& r_row = rows[0];
+            TS_ASSERT_EQUALS(r_row.size(), 17u);
+            TS_ASSERT_DELTA(r_row[0], 0.0, 1e-12);
+
+            // Proliferative type counts
+            TS_ASSERT_DELTA(r_row[1], 3.0, 1e-12);
+            TS_ASSERT_DELTA(r_row[2], 1.0, 1e-12);
+            TS_ASSERT_DELTA(r_row[3], 0.0, 1e-12);
+            TS_ASSERT_DELTA(r_row[4], 0.0, 1e-12);
+
+            // Moments of the CellData item, which takes the values 1, 2, 3 and 4
+            TS_ASSERT_DELTA(r_row[5], 2.5, 1e-6);
+            TS_ASSERT_DELTA(r_row[6], sqrt(1.25), 1e-5);
+            TS_ASSERT_DELTA(r_row[7], 1.0, 1e-6);
+            TS_ASSERT_DELTA(r_row[8], 4.0, 1e-6);
+
+            // Every cell is the same distance from the centroid, so lies in the outer radial bin
+            double max_distance = sqrt(0.5);
+            TS_ASSERT_DELTA(r_row[9], 0.5*max_distance, 1e-5);
+            TS_ASSERT_DELTA(r_row[10], 0.0, 1e-12);
+            TS_ASSERT_DELTA(r_row[11], max_distance, 1e-5);
+            TS_ASSERT_DELTA(r_row[12], 4.0/(M_PI*0.75*max_distance*max_distance), 1e-4);
+
+            // Every cell neighbours the other three, so lies in the last neighbour bin
+            TS_ASSERT_DELTA(r_row[13], 3.0, 1e-12);
+            TS_ASSERT_DELTA(r_row[14], 0.0, 1e-12);
+            TS_ASSERT_DELTA(r_row[15], 0.0, 1e-12);
+            TS_ASSERT_DELTA(r_row[16], 4.0, 1e-12);
+        }
+    }
+
+    void TestStatisticsModifierInSimulation()
+    {
+        EXIT_IF_PARALLEL;
+
+        TrianglesMeshReader<2,2> mesh_reader("mesh/test/data/square_2_elements");
+        TetrahedralMesh<2,2> generating_mesh;
+        generating_mesh.ConstructFromMeshReader(mesh_reader);
+        NodesOnlyMesh<2> mesh;
+        mesh.ConstructNodesWithoutMesh(generating_mesh, 1.5);
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<FixedG1GenerationalCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, mesh.GetNumNodes());
+
+        NodeBasedCellPopulation<2> cell_population(mesh, cells);
+
+        OffLatticeSimulation<2> simulator(cell_population);
+        simulator.SetOutputDirectory("TestStatisticsModifierInSimulation");
+        simulator.SetEndTime(10.0*simulator.GetDt());
+        simulator.SetSamplingTimestepMultiple(5);
+
+        MAKE_PTR(GeneralisedLinearSpringForce<2>, p_force);
+        simulator.AddForce(p_force);
+
+        MAKE_PTR(CellPopulationStatisticsModifier<2>, p_modifier);
+        p_modifier->SetOutputCellVolumeMoments(true);
+        simulator.AddSimulationModifier(p_modifier);
+
+        simulator.Solve();
+
+        // One line for the initial population and one for each output time step
+        OutputFileHandler output_file_handler("TestStatisticsModifierInSimulation", false);
+        FileFinder statistics_file = output_file_handler.FindFile("results_from_time_0/populationstatistics.dat");
+        std::vector<std::vector<double> > rows = ReadStatistics(statistics_file);
+        TS_ASSERT_EQUALS(rows.size(), 3u);
+        for (unsigned i=0; i<rows.size(); i++)
+        {
+            TS_ASSERT_EQUALS(rows[i].size(), 9u);
+            TS_ASSERT_DELTA(rows[i][1] + rows[i][2] + rows[i][3] + rows[i][4], 4.0, 1e-12);
+            TS_ASSERT_DELTA(rows[i][5], M_PI*0.25, 1e-6);
+        }
+        TS_ASSERT_DELTA(rows[2][0], 10.0*simulator.GetDt(), 1e-6);
+    }
+
+    void TestStatisticsModifierArchiving()
+    {
+        EXIT_IF_PARALLEL;
+
+        OutputFileHandler handler("archive", false);
+        std::string archive_filename = handler.GetOutputDirectoryFullPath() + "CellPopulationStatisticsModifier.arch";
+
+        // Separate scope to write the archive
+        {
+            AbstractCellBasedSimulationModifier<2,2>* const p_modifier = new CellPopulationStatisticsModifier<2>();
+            CellPopulationStatisticsModifier<2>* p_statistics_modifier = static_cast<CellPopulationStatisticsModifier<2>*>(p_modifier);
+            p_statistics_modifier->SetOutputProliferativeTypeCounts(false);
+            p_statistics_modifier->AddCellDataItemMoments("oxygen");
+            p_statistics_modifier->SetOutputCellVolumeMoments(true);
+            p_statistics_modifier->SetNumRadialBins(7);
+            p_statistics_modifier->SetMaxNumNeighboursInHistogram(9);
+
+            std::ofstream ofs(archive_filename.c_str());
+            boost::archive::text_oarchive output_arch(ofs);
+
+            // Serialize via pointer
+            output_arch << p_modifier;
+            delete p_modifier;
+        }
+
+        // Separate scope to read the archive
+        {
+            AbstractCellBasedSimulationModifier<2,2>* p_modifier2;
+
+            std::ifstream ifs(archive_filename.c_str());
+            boost::archive::text_iarchive input_arch(ifs);
+            input_arch >> p_modifier2;
+
+            CellPopulationStatisticsModifier<2>* p_statistics_modifier = static_cast<CellPopulationStatisticsModifier<2>*>(p_modifier2);
+            TS_ASSERT_EQUALS(p_statistics_modifier->GetOutputProliferativeTypeCounts(), false);
+            TS_ASSERT_EQUALS(p_statistics_modifier->rGetCellDataItemNames().size(), 1u);
+            TS_ASSERT_EQUALS(p_statistics_modifier->rGetCellDataItemNames()[0], "oxygen");
+            TS_ASSERT_EQUALS(p_statistics_modifier->GetOutputCellVolumeMoments(), true);
+            TS_ASSERT_EQUALS(p_statistics_modifier->GetNumRadialBins(), 7u);
+            TS_ASSERT_EQUALS(p_statistics_modifier->GetMaxNumNeighboursInHistogram(), 9u);
+
+            delete p_modifier2;
+        }
+    }
+};
+
+#endif /*TESTCELLPOPULATIONSTATISTICSMODIFIER_HPP_*/
@@ -139,6 +139,82 @@ public:
         TS_ASSERT_DELTA(mean_delta, 1.0000, 1e-04);
     }
 
+    void TestBatchedSrnModels()
+    {
+        EXIT_IF_PARALLEL;
+
+        HoneycombMeshGenerator generator(3, 3, 0);
+        MutableMesh<2,2>* p_generating_mesh = generator.GetMesh();
+
+        MAKE_PTR(WildTypeCellMutationState, p_state);
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_diff_type);
+
+        // Run the same simulation with and without batching the SRN models
+        std::vector<std::vector<double> > final_levels(2);
+        for (unsigned run=0; run<2; run++)
+        {
+            SimulationTime::Destroy();
+            SimulationTime::Instance()->SetStartTime(0.0);
+            RandomNumberGenerator::Instance()->Reseed(0);
+
+            NodesOnlyMesh<2> mesh;
+            mesh.ConstructNodesWithoutMesh(*p_generating_mesh, 1.5);
+
+            std::vector<CellPtr> cells;
+            for (unsigned i=0; i<mesh.GetNumNodes(); i++)
+            {
+                std::vector<double> initial_conditions;
+                initial_conditions.push_back(0.5 + 0.05*i);
+                initial_conditions.push_back(1.0 - 0.05*i);
+
+                UniformCellCycleModel* p_cc_model = new UniformCellCycleModel();
+                p_cc_model->SetDimension(2);
+
+                DeltaNotchSrnModel* p_srn_model = new DeltaNotchSrnModel();
+                p_srn_model->SetInitialConditions(initial_conditions);
+                CellPtr p_cell(new Cell(p_state, p_cc_model, p_srn_model));
+                p_cell->SetCellProliferativeType(p_diff_type);
+                p_cell->SetBirthTime(-1.0);
+                cells.push_back(p_cell);
+            }
+
+            NodeBasedCellPopulation<2> cell_population(mesh, cells);
+
+            OffLatticeSimulation<2> simulator(cell_population);
+            simulator.SetOutputDirectory("TestDeltaNotchBatchedSrnModels");
+            simulator.SetEndTime(1.0);
+
+            TS_ASSERT_EQUALS(simulator.GetBatchSrnModels(), false);
+            if (run == 1)
+            {
+                simulator.SetBatchSrnModels();
+                simulator.SetNumberOfSrnModelThreads(2);
+                TS_ASSERT_EQUALS(simulator.GetBatchSrnModels(), true);
+                TS_ASSERT_THROWS_THIS(simulator.SetNumberOfSrnModelThreads(0), "The number of SRN model threads must be at least one.");
+            }
+
+            MAKE_PTR(DeltaNotchTrackingModifier<2>, p_modifier);
+            simulator.AddSimulationModifier(p_modifier);
+            simulator.Solve();
+
+            for (AbstractCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
+                 cell_iter != cell_population.End();
+                 ++cell_iter)
+            {
+                DeltaNotchSrnModel* p_model = static_cast<DeltaNotchSrnModel*>(cell_iter->GetSrnModel());
+                final_levels[run].push_back(p_model->GetNotch());
+                final_levels[run].push_back(p_model->GetDelta());
+            }
+        }
+
+        // The results should not depend on whether the SRN models were batched
+        TS_ASSERT_EQUALS(final_levels[0].size(), final_levels[1].size());
+        for (unsigned i=0; i<final_levels[0].size(); i++)
+        {
+            TS_ASSERT_EQUALS(final_levels[0][i], final_levels[1][i]);
+        }
+    }
+
     void TestHeterogeneousDeltaNotchOnUntetheredTwoCellSystem()
     {
         EXIT_IF_PARALLEL;
@@ -0,0 +1,128 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTNODEBASEDSCALINGSTUDY_HPP_
+#define TESTNODEBASEDSCALINGSTUDY_HPP_
+
+#include <cxxtest/TestSuite.h>
+
+// Must be included before other cell_based headers
+#include "CellBasedSimulationArchiver.hpp"
+
+#include <algorithm>
+
+#include "AbstractCellBasedTestSuite.hpp"
+#include "CellBasedEventHandler.hpp"
+#include "CellsGenerator.hpp"
+#include "DifferentiatedCellProliferativeType.hpp"
+#include "GeneralisedLinearSpringForce.hpp"
+#include "NodeBasedCellPopulation.hpp"
+#include "NodesOnlyMesh.hpp"
+#include "OffLatticeSimulation.hpp"
+#include "ScalingStudy.hpp"
+#include "SmartPointers.hpp"
+#include "UniformCellCycleModel.hpp"
+
+#include "PetscSetupAndFinalize.hpp"
+
+/**
+ * Strong and weak scaling harness for a 3D node-based cell population. Run it with different
+ * numbers of processes, e.g.
+ *
+ *  mpirun -np 8 TestNodeBasedScalingStudy -scaling_mode weak -scaling_size 20000 -scaling_steps 100
+ *
+ * and each run writes ScalingStudies/NodeBased3d_<mode>_<size>_np<N>.json with the
+ * CellBasedEventHandler timings (mean, min, max and load imbalance over processes).
+ *
+ * Cells start on a unit lattice with a fixed 10 x 10 cross-section, whose length is chosen
+ * to give about the requested number of cells. They are differentiated, so the problem size
+ * doesn't change during the run.
+ */
+class TestNodeBasedScalingStudy : public AbstractCellBasedTestSuite
+{
+public:
+
+    void TestNodeBasedLattice()
+    {
+        ScalingStudy study("NodeBased3d", 10000, 120);
+
+        const unsigned cells_across = 10;
+        unsigned cells_along = std::max(2u, (study.GetProblemSize() + cells_across*cells_across/2)/(cells_across*cells_across));
+
+        std::vector<Node<3>*> nodes;
+        unsigned index = 0;
+        for (unsigned i=0; i<cells_along; i++)
+        {
+            for (unsigned j=0; j<cells_across; j++)
+            {
+                for (unsigned k=0; k<cells_across; k++)
+                {
+                    nodes.push_back(new Node<3>(index, false, (double)i, (double)j, (double)k));
+                    index++;
+                }
+            }
+        }
+
+        NodesOnlyMesh<3> mesh;
+        mesh.ConstructNodesWithoutMesh(nodes, 1.5);
+        for (unsigned i=0; i<nodes.size(); i++)
+        {
+            delete nodes[i];
+        }
+
+        std::vector<CellPtr> cells;
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_differentiated_type);
+        CellsGenerator<UniformCellCycleModel, 3> cells_generator;
+        cells_generator.GenerateBasicRandom(cells, mesh.GetNumNodes(), p_differentiated_type);
+
+        NodeBasedCellPopulation<3> cell_population(mesh, cells);
+
+        OffLatticeSimulation<3> simulator(cell_population);
+        simulator.SetOutputDirectory("NodeBasedScalingStudy");
+        simulator.SetSamplingTimestepMultiple(study.GetNumSteps());
+        simulator.SetEndTime(study.GetNumSteps()*simulator.GetDt());
+
+        MAKE_PTR(GeneralisedLinearSpringForce<3>, p_force);
+        p_force->SetCutOffLength(1.5);
+        simulator.AddForce(p_force);
+
+        CellBasedEventHandler::Reset();
+        simulator.Solve();
+
+        study.WriteReport<CellBasedEventHandler>(cells_along*cells_across*cells_across);
+    }
+};
+
+#endif /*TESTNODEBASEDSCALINGSTUDY_HPP_*/
@@ -49,6 +49,8 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "NodeBasedCellPopulationWithParticles.hpp"
 #include "NodeBasedCellPopulationWithBuskeUpdate.hpp"
 #include "GeneralisedLinearSpringForce.hpp"
+#include "NagaiHondaForce.hpp"
+#include "SimpleTargetAreaModifier.hpp"
 #include "HoneycombMeshGenerator.hpp"
 #include "HoneycombVertexMeshGenerator.hpp"
 #include "AbstractCellBasedTestSuite.hpp"
@@ -64,7 +66,12 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "SmartPointers.hpp"
 #include "FileComparison.hpp"
 #include "PopulationTestingForce.hpp"
+#include "BackwardEulerNumericalMethod.hpp"
 #include "ForwardEulerNumericalMethod.hpp"
+#include "NodeBasedMechanicsBackend.hpp"
+#include "RungeKutta23NumericalMethod.hpp"
+#include "SemiImplicitEulerNumericalMethod.hpp"
+#include "StepSizeException.hpp"
 #include "Warnings.hpp"
 
 
@@ -305,6 +312,250 @@ public:
 
             TS_ASSERT_DELTA(norm_2(actualLocation - expectedLocation), 0, 1e-12);
         }
+
+        // The same step shared over threads gives the same answer
+        p_fe_method->SetNumberOfThreads(2);
+        for (unsigned j=0; j<cell_population.GetNumNodes(); j++)
+        {
+            old_posns[j] = cell_population.GetNode(j)->rGetLocation();
+        }
+        p_fe_method->UpdateAllNodePositions(dt);
+        for (unsigned j=0; j<cell_population.GetNumNodes(); j++)
+        {
+            double damping = cell_population.GetDampingConstant(j);
+            c_vector<double, 2> expectedLocation = p_test_force->GetExpectedOneStepLocationFE(j, damping, old_posns[j], dt);
+            TS_ASSERT_DELTA(norm_2(cell_population.GetNode(j)->rGetLocation() - expectedLocation), 0, 1e-12);
+        }
+
+        // A step that moves a node too far is rejected before any node is moved
+        cell_population.SetAbsoluteMovementThreshold(1e-6);
+        p_fe_method->SetUseAdaptiveTimestep(true);
+        for (unsigned j=0; j<cell_population.GetNumNodes(); j++)
+        {
+            old_posns[j] = cell_population.GetNode(j)->rGetLocation();
+        }
+        TS_ASSERT_THROWS_ANYTHING(p_fe_method->UpdateAllNodePositions(dt));
+        for (unsigned j=0; j<cell_population.GetNumNodes(); j++)
+        {
+            TS_ASSERT_DELTA(norm_2(cell_population.GetNode(j)->rGetLocation() - old_posns[j]), 0, 1e-12);
+        }
+    }
+
+    void TestRungeKutta23AndSemiImplicitEulerWithNodeBased()
+    {
+        EXIT_IF_PARALLEL;    // This test doesn't work in parallel.
+
+        HoneycombMeshGenerator generator(3, 3, 0);
+        TetrahedralMesh<2,2>* p_generating_mesh = generator.GetMesh();
+
+        // Convert this to a NodesOnlyMesh
+        MAKE_PTR(NodesOnlyMesh<2>, p_mesh);
+        p_mesh->ConstructNodesWithoutMesh(*p_generating_mesh, 2.0);
+
+        // Create cells
+        std::vector<CellPtr> cells;
+        CellsGenerator<FixedG1GenerationalCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumNodes());
+
+        NodeBasedCellPopulation<2> cell_population(*p_mesh, cells);
+        cell_population.SetDampingConstantNormal(1.1);
+
+        // Create a force collection
+        std::vector<boost::shared_ptr<AbstractForce<2,2> > > force_collection;
+        MAKE_PTR(PopulationTestingForce<2>, p_test_force);
+        force_collection.push_back(p_test_force);
+
+        double dt = 0.01;
+
+        // Save starting positions
+        std::vector<c_vector<double, 2> > old_posns(cell_population.GetNumNodes());
+        for (unsigned j=0; j<cell_population.GetNumNodes(); j++)
+        {
+            old_posns[j] = cell_population.GetNode(j)->rGetLocation();
+        }
+
+        // The force is linear, so the third-order method reproduces the cubic Taylor polynomial of the exact solution
+        MAKE_PTR(RungeKutta23NumericalMethod<2>, p_rk_method);
+        p_rk_method->SetCellPopulation(&cell_population);
+        p_rk_method->SetForceCollection(&force_collection);
+        p_rk_method->UpdateAllNodePositions(dt);
+
+        for (unsigned j=0; j<cell_population.GetNumNodes(); j++)
+        {
+            double damping = cell_population.GetDampingConstant(j);
+            for (unsigned d=0; d<2; d++)
+            {
+                double z = dt*(d+1)*0.01*j/damping;
+                double expected = old_posns[j][d]*(1.0 + z + z*z/2.0 + z*z*z/6.0);
+                TS_ASSERT_DELTA(cell_population.GetNode(j)->rGetLocation()[d], expected, 1e-12);
+            }
+        }
+        TS_ASSERT_LESS_THAN(0.0, p_rk_method->GetLastErrorEstimate());
+        TS_ASSERT_LESS_THAN(p_rk_method->GetLastErrorEstimate(), 1e-8);
+
+        // With such a small error, the next step may grow by the maximum factor
+        TS_ASSERT_DELTA(p_rk_method->CalculateNextTimeStep(dt), 5.0*dt, 1e-12);
+
+        // An unattainable tolerance rejects the step with adaptivity on, leaving the nodes in place
+        for (unsigned j=0; j<cell_population.GetNumNodes(); j++)
+        {
+            old_posns[j] = cell_population.GetNode(j)->rGetLocation();
+        }
+        p_rk_method->SetUseAdaptiveTimestep(true);
+        p_rk_method->SetErrorTolerance(1e-15);
+        try
+        {
+            p_rk_method->UpdateAllNodePositions(dt);
+            TS_FAIL("Expected a StepSizeException");
+        }
+        catch (StepSizeException& e)
+        {
+            TS_ASSERT_LESS_THAN(e.GetSuggestedNewStep(), dt);
+            TS_ASSERT(!e.IsTerminal());
+        }
+        for (unsigned j=0; j<cell_population.GetNumNodes(); j++)
+        {
+            TS_ASSERT_DELTA(norm_2(cell_population.GetNode(j)->rGetLocation() - old_posns[j]), 0, 1e-12);
+        }
+
+        // The semi-implicit method coincides with backward Euler for a linear force
+        MAKE_PTR(SemiImplicitEulerNumericalMethod<2>, p_si_method);
+        p_si_method->SetCellPopulation(&cell_population);
+        p_si_method->SetForceCollection(&force_collection);
+        p_si_method->SetLinearSolverTolerance(1e-12);
+        p_si_method->UpdateAllNodePositions(dt);
+
+        for (unsigned j=0; j<cell_population.GetNumNodes(); j++)
+        {
+            double damping = cell_population.GetDampingConstant(j);
+            c_vector<double, 2> expected_location = p_test_force->GetExpectedOneStepLocationBE(j, damping, old_posns[j], dt);
+            TS_ASSERT_DELTA(norm_2(cell_population.GetNode(j)->rGetLocation() - expected_location), 0, 1e-8);
+        }
+        TS_ASSERT_LESS_THAN(0u, p_si_method->GetLastNumLinearSolverIterations());
+        TS_ASSERT(p_si_method->GetLastNumLinearSolverIterations() <= p_si_method->GetMaxLinearSolverIterations());
+    }
+
+    void TestForwardEulerWithNodeBasedMechanicsBackend()
+    {
+        EXIT_IF_PARALLEL;    // The backend is only used in serial.
+
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(1.0, 100);
+        double dt = 0.01;
+
+        // Two identical populations, one stepped on the host and one on the backend
+        HoneycombMeshGenerator generator(5, 5, 0);
+        TetrahedralMesh<2,2>* p_generating_mesh = generator.GetMesh();
+        NodesOnlyMesh<2> host_mesh;
+        host_mesh.ConstructNodesWithoutMesh(*p_generating_mesh, 1.5);
+        NodesOnlyMesh<2> backend_mesh;
+        backend_mesh.ConstructNodesWithoutMesh(*p_generating_mesh, 1.5);
+
+        std::vector<CellPtr> host_cells;
+        std::vector<CellPtr> backend_cells;
+        CellsGenerator<FixedG1GenerationalCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(host_cells, host_mesh.GetNumNodes());
+        cells_generator.GenerateBasic(backend_cells, backend_mesh.GetNumNodes());
+
+        NodeBasedCellPopulation<2> host_population(host_mesh, host_cells);
+        NodeBasedCellPopulation<2> backend_population(backend_mesh, backend_cells);
+
+        // The spring force has a backend implementation; the testing force runs on the host
+        std::vector<boost::shared_ptr<AbstractForce<2,2> > > force_collection;
+        MAKE_PTR(GeneralisedLinearSpringForce<2>, p_spring_force);
+        p_spring_force->SetCutOffLength(1.5);
+        force_collection.push_back(p_spring_force);
+        MAKE_PTR(PopulationTestingForce<2>, p_test_force);
+        force_collection.push_back(p_test_force);
+
+        MAKE_PTR(ForwardEulerNumericalMethod<2>, p_host_method);
+        p_host_method->SetCellPopulation(&host_population);
+        p_host_method->SetForceCollection(&force_collection);
+
+        MAKE_PTR(NodeBasedMechanicsBackend<2>, p_backend);
+        TS_ASSERT_THROWS_THIS(p_backend->SetNumberOfThreads(0), "The number of backend threads must be at least one.");
+        MAKE_PTR(ForwardEulerNumericalMethod<2>, p_backend_method);
+        p_backend_method->SetCellPopulation(&backend_population);
+        p_backend_method->SetForceCollection(&force_collection);
+        p_backend_method->SetNodeBasedMechanicsBackend(p_backend);
+        TS_ASSERT_EQUALS(p_backend_method->GetNodeBasedMechanicsBackend(), p_backend);
+
+        for (unsigned step=0; step<10; step++)
+        {
+            // The results do not depend on the number of threads
+            p_backend->SetNumberOfThreads(1 + step%2);
+
+            host_population.Update();
+            backend_population.Update();
+            p_host_method->UpdateAllNodePositions(dt);
+            p_backend_method->UpdateAllNodePositions(dt);
+
+            // The testing force runs on the host, so the population's node pairs are still used
+            TS_ASSERT(!p_backend_method->UsesOwnNodePairs());
+            p_backend_method->SynchroniseNodeLocations();
+
+            for (unsigned j=0; j<host_population.GetNumNodes(); j++)
+            {
+                c_vector<double, 2> host_location = host_population.GetNode(j)->rGetLocation();
+                c_vector<double, 2> backend_location = backend_population.GetNode(j)->rGetLocation();
+                TS_ASSERT_DELTA(norm_2(host_location - backend_location), 0.0, 1e-10);
+
+                c_vector<double, 2> host_force = host_population.GetNode(j)->rGetAppliedForce();
+                c_vector<double, 2> backend_force = backend_population.GetNode(j)->rGetAppliedForce();
+                TS_ASSERT_DELTA(norm_2(host_force - backend_force), 0.0, 1e-10);
+            }
+        }
+
+        // The node locations stayed resident on the backend
+        TS_ASSERT_EQUALS(p_backend->GetNumberOfUploads(), 1u);
+        TS_ASSERT_EQUALS(p_backend->GetNumNodes(), backend_population.GetNumNodes());
+        TS_ASSERT_LESS_THAN(0u, p_backend->GetNumPairs());
+
+        // With only backend forces the nodes are not moved until they are synchronised
+        std::vector<boost::shared_ptr<AbstractForce<2,2> > > backend_force_collection;
+        backend_force_collection.push_back(p_spring_force);
+        p_host_method->SetForceCollection(&backend_force_collection);
+        p_backend_method->SetForceCollection(&backend_force_collection);
+
+        std::vector<c_vector<double, 2> > old_locations;
+        for (unsigned j=0; j<backend_population.GetNumNodes(); j++)
+        {
+            old_locations.push_back(backend_population.GetNode(j)->rGetLocation());
+        }
+        for (unsigned step=0; step<5; step++)
+        {
+            host_population.Update();
+            p_host_method->UpdateAllNodePositions(dt);
+            p_backend_method->UpdateAllNodePositions(dt);
+            TS_ASSERT(p_backend_method->UsesOwnNodePairs());
+        }
+        for (unsigned j=0; j<backend_population.GetNumNodes(); j++)
+        {
+            TS_ASSERT_DELTA(norm_2(backend_population.GetNode(j)->rGetLocation() - old_locations[j]), 0.0, 1e-12);
+        }
+
+        p_backend_method->SynchroniseNodeLocations();
+        for (unsigned j=0; j<host_population.GetNumNodes(); j++)
+        {
+            c_vector<double, 2> host_location = host_population.GetNode(j)->rGetLocation();
+            c_vector<double, 2> backend_location = backend_population.GetNode(j)->rGetLocation();
+            TS_ASSERT_DELTA(norm_2(host_location - backend_location), 0.0, 1e-10);
+        }
+        TS_ASSERT_EQUALS(p_backend->GetNumberOfUploads(), 1u);
+
+        // Moving a node elsewhere requires the locations to be uploaded again
+        c_vector<double, 2> shifted_location = backend_population.GetNode(0)->rGetLocation();
+        shifted_location[0] += 0.1;
+        backend_population.GetNode(0)->rGetModifiableLocation() = shifted_location;
+        p_backend_method->InvalidateResidentNodeLocations();
+        backend_population.Update();
+        p_backend_method->UpdateAllNodePositions(dt);
+        TS_ASSERT_EQUALS(p_backend->GetNumberOfUploads(), 2u);
+
+        // Without a backend the method steps on the host as before
+        p_backend_method->SetNodeBasedMechanicsBackend(boost::shared_ptr<NodeBasedMechanicsBackend<2> >());
+        TS_ASSERT(!p_backend_method->GetNodeBasedMechanicsBackend());
+        backend_population.Update();
+        TS_ASSERT_THROWS_NOTHING(p_backend_method->UpdateAllNodePositions(dt));
     }
 
     void TestUpdateAllNodePositionsWithNodeBasedWithBuskeUpdate()
@@ -475,6 +726,72 @@ public:
         }
     }
 
+    void TestBackwardEulerWithVertexBased()
+    {
+        // Create a simple 2D VertexMesh and perturb it, so that the cells are not at equilibrium
+        HoneycombVertexMeshGenerator generator(4, 4);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+        p_mesh->SetCellRearrangementThreshold(0.1);
+        for (unsigned i=0; i<p_mesh->GetNumNodes(); i++)
+        {
+            c_vector<double, 2>& r_location = p_mesh->GetNode(i)->rGetModifiableLocation();
+            r_location[0] += 0.01*sin(3.0*i);
+            r_location[1] += 0.01*cos(5.0*i);
+        }
+        p_mesh->InvalidateCachedElementData();
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<FixedG1GenerationalCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements());
+        VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+        for (AbstractCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
+             cell_iter != cell_population.End();
+             ++cell_iter)
+        {
+            cell_iter->SetBirthTime(-5.0);
+        }
+        MAKE_PTR(SimpleTargetAreaModifier<2>, p_growth_modifier);
+        p_growth_modifier->UpdateTargetAreas(cell_population);
+
+        std::vector<boost::shared_ptr<AbstractForce<2,2> > > force_collection;
+        MAKE_PTR(NagaiHondaForce<2>, p_force);
+        force_collection.push_back(p_force);
+
+        MAKE_PTR(BackwardEulerNumericalMethod<2>, p_be_method);
+        p_be_method->SetCellPopulation(&cell_population);
+        p_be_method->SetForceCollection(&force_collection);
+
+        // Take a step that is far larger than forward Euler could take stably with these stiff area constraints
+        double dt = 0.01;
+        std::vector<c_vector<double, 2> > old_locations = p_be_method->SaveCurrentLocations();
+        p_be_method->UpdateAllNodePositions(dt);
+        TS_ASSERT_LESS_THAN(0u, p_be_method->GetLastNumNewtonIterations());
+
+        // The new locations satisfy the backward Euler equations
+        std::vector<c_vector<double, 2> > new_locations = p_be_method->SaveCurrentLocations();
+        std::vector<c_vector<double, 2> > new_forces = p_be_method->ComputeForcesIncludingDamping();
+        for (unsigned j=0; j<new_locations.size(); j++)
+        {
+            TS_ASSERT_DELTA(norm_inf(new_locations[j] - old_locations[j] - dt*new_forces[j]), 0.0, 1e-7);
+        }
+
+        // For a small step, backward and forward Euler agree to second order in the step
+        MAKE_PTR(ForwardEulerNumericalMethod<2>, p_fe_method);
+        p_fe_method->SetCellPopulation(&cell_population);
+        p_fe_method->SetForceCollection(&force_collection);
+
+        double small_dt = 1e-5;
+        p_be_method->UpdateAllNodePositions(small_dt);
+        std::vector<c_vector<double, 2> > be_locations = p_be_method->SaveCurrentLocations();
+        p_be_method->SetAllNodeLocations(new_locations);
+        p_fe_method->UpdateAllNodePositions(small_dt);
+        std::vector<c_vector<double, 2> > fe_locations = p_fe_method->SaveCurrentLocations();
+        for (unsigned j=0; j<be_locations.size(); j++)
+        {
+            TS_ASSERT_DELTA(norm_inf(be_locations[j] - fe_locations[j]), 0.0, 1e-6);
+        }
+    }
+
     void TestSettingAndGettingFlags()
     {
         // Create numerical methods for testing
@@ -486,6 +803,49 @@ public:
         // Set mUseUpdateNodeLocation to true and check
         p_fe_method->SetUseUpdateNodeLocation(true);
         TS_ASSERT(p_fe_method->GetUseUpdateNodeLocation());
+
+        // The default time step growth is 1%
+        TS_ASSERT_DELTA(p_fe_method->CalculateNextTimeStep(0.01), 0.0101, 1e-12);
+
+        // The per-node arithmetic is serial by default
+        TS_ASSERT_EQUALS(p_fe_method->GetNumberOfThreads(), 1u);
+        p_fe_method->SetNumberOfThreads(4);
+        TS_ASSERT_EQUALS(p_fe_method->GetNumberOfThreads(), 4u);
+        TS_ASSERT_THROWS_THIS(p_fe_method->SetNumberOfThreads(0), "The number of numerical method threads must be at least one.");
+
+        MAKE_PTR(RungeKutta23NumericalMethod<2>, p_rk_method);
+        TS_ASSERT_DELTA(p_rk_method->GetErrorTolerance(), 1e-3, 1e-12);
+        p_rk_method->SetErrorTolerance(1e-5);
+        TS_ASSERT_DELTA(p_rk_method->GetErrorTolerance(), 1e-5, 1e-12);
+        TS_ASSERT_THROWS_THIS(p_rk_method->SetErrorTolerance(0.0), "The error tolerance must be positive");
+
+        MAKE_PTR(SemiImplicitEulerNumericalMethod<2>, p_si_method);
+        TS_ASSERT_DELTA(p_si_method->GetLinearSolverTolerance(), 1e-6, 1e-12);
+        TS_ASSERT_EQUALS(p_si_method->GetMaxLinearSolverIterations(), 50u);
+        p_si_method->SetLinearSolverTolerance(1e-9);
+        p_si_method->SetMaxLinearSolverIterations(20);
+        TS_ASSERT_DELTA(p_si_method->GetLinearSolverTolerance(), 1e-9, 1e-15);
+        TS_ASSERT_EQUALS(p_si_method->GetMaxLinearSolverIterations(), 20u);
+        TS_ASSERT_THROWS_THIS(p_si_method->SetLinearSolverTolerance(-1.0), "The linear solver tolerance must be positive");
+        TS_ASSERT_THROWS_THIS(p_si_method->SetMaxLinearSolverIterations(0), "The maximum number of linear solver iterations must be positive");
+
+        MAKE_PTR(BackwardEulerNumericalMethod<2>, p_be_method);
+        TS_ASSERT_DELTA(p_be_method->GetNewtonTolerance(), 1e-8, 1e-15);
+        TS_ASSERT_EQUALS(p_be_method->GetMaxNewtonIterations(), 20u);
+        TS_ASSERT_DELTA(p_be_method->GetLinearSolverTolerance(), 1e-10, 1e-15);
+        TS_ASSERT_EQUALS(p_be_method->GetMaxLinearSolverIterations(), 200u);
+        p_be_method->SetNewtonTolerance(1e-6);
+        p_be_method->SetMaxNewtonIterations(5);
+        p_be_method->SetLinearSolverTolerance(1e-8);
+        p_be_method->SetMaxLinearSolverIterations(50);
+        TS_ASSERT_DELTA(p_be_method->GetNewtonTolerance(), 1e-6, 1e-15);
+        TS_ASSERT_EQUALS(p_be_method->GetMaxNewtonIterations(), 5u);
+        TS_ASSERT_DELTA(p_be_method->GetLinearSolverTolerance(), 1e-8, 1e-15);
+        TS_ASSERT_EQUALS(p_be_method->GetMaxLinearSolverIterations(), 50u);
+        TS_ASSERT_THROWS_THIS(p_be_method->SetNewtonTolerance(0.0), "The Newton tolerance must be positive");
+        TS_ASSERT_THROWS_THIS(p_be_method->SetMaxNewtonIterations(0), "The maximum number of Newton iterations must be positive");
+        TS_ASSERT_THROWS_THIS(p_be_method->SetLinearSolverTolerance(-1.0), "The linear solver tolerance must be positive");
+        TS_ASSERT_THROWS_THIS(p_be_method->SetMaxLinearSolverIterations(0), "The maximum number of linear solver iterations must be positive");
     }
 };
 
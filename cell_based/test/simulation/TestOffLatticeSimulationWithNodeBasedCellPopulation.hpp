@@ -38,6 +38,8 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <cxxtest/TestSuite.h>
 
+#include <algorithm>
+
 // Must be included before other cell_based headers
 #include "CellBasedSimulationArchiver.hpp"
 
@@ -541,6 +543,181 @@ public:
         FileComparison node_files(generated_node_file,reference_node_file);
     }
 
+    void TestCellDivisionWithCellCycleEventQueue()
+    {
+        EXIT_IF_PARALLEL;    // HoneycombMeshGenereator does not work in parallel.
+
+        HoneycombMeshGenerator generator(5, 5, 0);
+        TetrahedralMesh<2,2>* p_generating_mesh = generator.GetMesh();
+
+        // Run the same simulation with and without the cell-cycle event queue
+        std::vector<unsigned> num_births(2);
+        std::vector<std::vector<double> > birth_times(2);
+        for (unsigned run=0; run<2; run++)
+        {
+            SimulationTime::Destroy();
+            SimulationTime::Instance()->SetStartTime(0.0);
+            RandomNumberGenerator::Instance()->Reseed(0);
+
+            NodesOnlyMesh<2> mesh;
+            mesh.ConstructNodesWithoutMesh(*p_generating_mesh, 1.5);
+
+            std::vector<CellPtr> cells;
+            CellsGenerator<FixedG1GenerationalCellCycleModel, 2> cells_generator;
+            cells_generator.GenerateBasicRandom(cells, mesh.GetNumNodes());
+
+            NodeBasedCellPopulation<2> cell_population(mesh, cells);
+
+            OffLatticeSimulation<2> simulator(cell_population);
+            simulator.SetOutputDirectory("TestOffLatticeSimulationWithCellCycleEventQueue");
+            simulator.SetEndTime(10.0);
+
+            TS_ASSERT_EQUALS(simulator.GetUseCellCycleEventQueue(), false);
+            if (run == 1)
+            {
+                simulator.SetUseCellCycleEventQueue();
+                TS_ASSERT_EQUALS(simulator.GetUseCellCycleEventQueue(), true);
+            }
+
+            MAKE_PTR(GeneralisedLinearSpringForce<2>, p_linear_force);
+            p_linear_force->SetCutOffLength(1.5);
+            simulator.AddForce(p_linear_force);
+
+            simulator.Solve();
+
+            num_births[run] = simulator.GetNumBirths();
+            for (AbstractCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
+                 cell_iter != cell_population.End();
+                 ++cell_iter)
+            {
+                birth_times[run].push_back(cell_iter->GetBirthTime());
+            }
+            std::sort(birth_times[run].begin(), birth_times[run].end());
+        }
+
+        // The same cells should divide at the same times, although daughters are placed differently
+        TS_ASSERT_LESS_THAN(0u, num_births[0]);
+        TS_ASSERT_EQUALS(num_births[0], num_births[1]);
+        TS_ASSERT_EQUALS(birth_times[0].size(), birth_times[1].size());
+        for (unsigned i=0; i<birth_times[0].size(); i++)
+        {
+            TS_ASSERT_DELTA(birth_times[0][i], birth_times[1][i], 1e-9);
+        }
+    }
+
+    void TestSimulationWithNodeBasedMechanicsBackend()
+    {
+        EXIT_IF_PARALLEL;    // The backend is only used in serial.
+
+        HoneycombMeshGenerator generator(5, 5, 0);
+        TetrahedralMesh<2,2>* p_generating_mesh = generator.GetMesh();
+
+        // Run the same simulation, with births and deaths, on the host and on the backend
+        std::vector<unsigned> num_births(2);
+        std::vector<unsigned> num_deaths(2);
+        std::vector<std::vector<c_vector<double, 2> > > final_locations(2);
+        for (unsigned run=0; run<2; run++)
+        {
+            SimulationTime::Destroy();
+            SimulationTime::Instance()->SetStartTime(0.0);
+            RandomNumberGenerator::Instance()->Reseed(0);
+
+            NodesOnlyMesh<2> mesh;
+            mesh.ConstructNodesWithoutMesh(*p_generating_mesh, 1.5);
+
+            std::vector<CellPtr> cells;
+            CellsGenerator<FixedG1GenerationalCellCycleModel, 2> cells_generator;
+            cells_generator.GenerateBasicRandom(cells, mesh.GetNumNodes());
+
+            NodeBasedCellPopulation<2> cell_population(mesh, cells);
+
+            OffLatticeSimulation<2> simulator(cell_population);
+            simulator.SetOutputDirectory("TestOffLatticeSimulationWithNodeBasedMechanicsBackend");
+            simulator.SetEndTime(5.0);
+            simulator.SetSamplingTimestepMultiple(10);
+
+            MAKE_PTR(GeneralisedLinearSpringForce<2>, p_linear_force);
+            p_linear_force->SetCutOffLength(1.5);
+            simulator.AddForce(p_linear_force);
+
+            MAKE_PTR_ARGS(RandomCellKiller<2>, p_killer, (&cell_population, 0.01));
+            simulator.AddCellKiller(p_killer);
+
+            if (run == 1)
+            {
+                MAKE_PTR(ForwardEulerNumericalMethod<2>, p_method);
+                MAKE_PTR(NodeBasedMechanicsBackend<2>, p_backend);
+                p_method->SetNodeBasedMechanicsBackend(p_backend);
+                simulator.SetNumericalMethod(p_method);
+            }
+
+            simulator.Solve();
+
+            num_births[run] = simulator.GetNumBirths();
+            num_deaths[run] = simulator.GetNumDeaths();
+            for (AbstractMesh<2,2>::NodeIterator node_iter = mesh.GetNodeIteratorBegin();
+                 node_iter != mesh.GetNodeIteratorEnd();
+                 ++node_iter)
+            {
+                final_locations[run].push_back(node_iter->rGetLocation());
+            }
+        }
+
+        // The nodes were given their locations for each birth, death and output
+        TS_ASSERT_LESS_THAN(0u, num_births[0]);
+        TS_ASSERT_LESS_THAN(0u, num_deaths[0]);
+        TS_ASSERT_EQUALS(num_births[0], num_births[1]);
+        TS_ASSERT_EQUALS(num_deaths[0], num_deaths[1]);
+        TS_ASSERT_EQUALS(final_locations[0].size(), final_locations[1].size());
+        for (unsigned i=0; i<final_locations[0].size(); i++)
+        {
+            TS_ASSERT_DELTA(norm_2(final_locations[0][i] - final_locations[1][i]), 0.0, 1e-8);
+        }
+
+        // Without births or deaths the node locations stay on the backend for the whole simulation
+        SimulationTime::Destroy();
+        SimulationTime::Instance()->SetStartTime(0.0);
+        RandomNumberGenerator::Instance()->Reseed(0);
+
+        NodesOnlyMesh<2> mesh;
+        mesh.ConstructNodesWithoutMesh(*p_generating_mesh, 1.5);
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<FixedG1GenerationalCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasicRandom(cells, mesh.GetNumNodes());
+
+        NodeBasedCellPopulation<2> cell_population(mesh, cells);
+
+        OffLatticeSimulation<2> simulator(cell_population);
+        simulator.SetOutputDirectory("TestOffLatticeSimulationWithNodeBasedMechanicsBackend");
+        simulator.SetEndTime(0.5);
+        simulator.SetSamplingTimestepMultiple(10);
+
+        MAKE_PTR(GeneralisedLinearSpringForce<2>, p_linear_force);
+        p_linear_force->SetCutOffLength(1.5);
+        simulator.AddForce(p_linear_force);
+
+        MAKE_PTR(ForwardEulerNumericalMethod<2>, p_method);
+        MAKE_PTR(NodeBasedMechanicsBackend<2>, p_backend);
+        p_method->SetNodeBasedMechanicsBackend(p_backend);
+        simulator.SetNumericalMethod(p_method);
+
+        simulator.Solve();
+
+        TS_ASSERT_EQUALS(simulator.GetNumBirths(), 0u);
+        TS_ASSERT_EQUALS(p_backend->GetNumberOfUploads(), 1u);
+        TS_ASSERT(p_method->UsesOwnNodePairs());
+
+        // The nodes hold the final locations
+        for (AbstractMesh<2,2>::NodeIterator node_iter = mesh.GetNodeIteratorBegin();
+             node_iter != mesh.GetNodeIteratorEnd();
+             ++node_iter)
+        {
+            unsigned resident_index = p_backend->GetResidentIndex(node_iter->GetIndex());
+            TS_ASSERT_DELTA(norm_2(node_iter->rGetLocation() - p_backend->GetLocation(resident_index)), 0.0, 1e-12);
+        }
+    }
+
     double mNode3x, mNode4x, mNode3y, mNode4y; // To preserve locations between the below test and test load.
 
     void TestStandardResultForArchivingTestsBelow()
@@ -694,6 +871,87 @@ public:
         delete p_simulator2;
     }
 
+    // Testing Save() and Load() with binary archives (based on previous tests)
+    void TestSaveAndLoadBinary()
+    {
+        EXIT_IF_PARALLEL;    // Cell based archiving doesn't work in parallel.
+
+        // Load the text archive from TestSave() above and run it from 0.1 to 1.0
+        OffLatticeSimulation<2>* p_simulator1;
+        p_simulator1 = CellBasedSimulationArchiver<2, OffLatticeSimulation<2> >::Load("TestOffLatticeSimulationWithNodeBasedCellPopulationSaveAndLoad", 0.1);
+        p_simulator1->SetEndTime(1.0);
+        p_simulator1->Solve();
+
+        // Save in the binary format, then reload and run from 1.0 to 2.5
+        CellBasedSimulationArchiver<2, OffLatticeSimulation<2> >::Save(p_simulator1, true);
+        FileFinder binary_archive("TestOffLatticeSimulationWithNodeBasedCellPopulationSaveAndLoad/archive/cell_population_sim_at_time_1.barch",
+                                  RelativeTo::ChasteTestOutput);
+        TS_ASSERT(binary_archive.IsFile());
+
+        OffLatticeSimulation<2>* p_simulator2
+            = CellBasedSimulationArchiver<2, OffLatticeSimulation<2> >::Load("TestOffLatticeSimulationWithNodeBasedCellPopulationSaveAndLoad", 1.0, true);
+
+        // Test that the numerical method was archived correctly
+        TS_ASSERT_EQUALS(p_simulator2->GetNumericalMethod()->HasAdaptiveTimestep(), true);
+
+        p_simulator2->SetEndTime(2.5);
+        p_simulator2->Solve();
+
+        // These results are from time 2.5 in TestStandardResultForArchivingTestBelow() (above!)
+        std::vector<double> node_3_location = p_simulator2->GetNodeLocation(3);
+        TS_ASSERT_DELTA(node_3_location[0], mNode3x, 1e-4);
+        TS_ASSERT_DELTA(node_3_location[1], mNode3y, 1e-4);
+
+        std::vector<double> node_4_location = p_simulator2->GetNodeLocation(4);
+        TS_ASSERT_DELTA(node_4_location[0], mNode4x, 1e-4);
+        TS_ASSERT_DELTA(node_4_location[1], mNode4y, 1e-4);
+
+        // Tidy up
+        delete p_simulator1;
+        delete p_simulator2;
+    }
+
+    // Testing Save() and Load() with compressed archives (based on previous tests)
+    void TestSaveAndLoadCompressed()
+    {
+        EXIT_IF_PARALLEL;    // Cell based archiving doesn't work in parallel.
+
+        // Load the text archive from TestSave() above and run it from 0.1 to 1.5
+        OffLatticeSimulation<2>* p_simulator1;
+        p_simulator1 = CellBasedSimulationArchiver<2, OffLatticeSimulation<2> >::Load("TestOffLatticeSimulationWithNodeBasedCellPopulationSaveAndLoad", 0.1);
+        p_simulator1->SetEndTime(1.5);
+        p_simulator1->Solve();
+
+        // Save a compressed text archive; only the ".gz" file is written
+        CellBasedSimulationArchiver<2, OffLatticeSimulation<2> >::Save(p_simulator1, false, true);
+        FileFinder compressed_archive("TestOffLatticeSimulationWithNodeBasedCellPopulationSaveAndLoad/archive/cell_population_sim_at_time_1.5.arch.gz",
+                                      RelativeTo::ChasteTestOutput);
+        TS_ASSERT(compressed_archive.IsFile());
+        FileFinder plain_archive("TestOffLatticeSimulationWithNodeBasedCellPopulationSaveAndLoad/archive/cell_population_sim_at_time_1.5.arch",
+                                 RelativeTo::ChasteTestOutput);
+        TS_ASSERT(!plain_archive.Exists());
+
+        // Reload (the compression is detected automatically) and run from 1.5 to 2.5
+        OffLatticeSimulation<2>* p_simulator2
+            = CellBasedSimulationArchiver<2, OffLatticeSimulation<2> >::Load("TestOffLatticeSimulationWithNodeBasedCellPopulationSaveAndLoad", 1.5);
+
+        p_simulator2->SetEndTime(2.5);
+        p_simulator2->Solve();
+
+        // These results are from time 2.5 in TestStandardResultForArchivingTestBelow() (above!)
+        std::vector<double> node_3_location = p_simulator2->GetNodeLocation(3);
+        TS_ASSERT_DELTA(node_3_location[0], mNode3x, 1e-4);
+        TS_ASSERT_DELTA(node_3_location[1], mNode3y, 1e-4);
+
+        std::vector<double> node_4_location = p_simulator2->GetNodeLocation(4);
+        TS_ASSERT_DELTA(node_4_location[0], mNode4x, 1e-4);
+        TS_ASSERT_DELTA(node_4_location[1], mNode4y, 1e-4);
+
+        // Tidy up
+        delete p_simulator1;
+        delete p_simulator2;
+    }
+
     /**
      * Create a simulation of a NodeBasedCellPopulation to test movement threshold.
      */
@@ -72,7 +72,7 @@ macro(Chaste_DO_CELLML output_sources cellml_file dynamic)
     if(${dynamic})
         set(pycml_args ${pycml_args} "-y")
     else()
-        set(pycml_args ${pycml_args} "--normal" "--opt" "--cvode")
+        set(pycml_args ${pycml_args} "--normal" "--opt" "--cvode" "--batch")
         if(EXISTS ${cellml_dir}/${cellml_file_name}.out)
             set(depends ${depends} ${cellml_dir}/${cellml_file_name}.out)
             set(pycml_args ${pycml_args} "--backward-euler")
@@ -61,7 +61,7 @@ void AbstractIsotropicCompressibleMaterialLaw<DIM>::ComputeStressAndStressDeriva
     double I2 = SecondInvariant(rC);
     double I3 = Determinant(rC);
 
-    static c_matrix<double,DIM,DIM> dI2dC;
+    c_matrix<double,DIM,DIM> dI2dC;
     dI2dC = I1*identity - rC;              // MUST be on separate line to above!
 
     double w1 = Get_dW_dI1(I1,I2,I3);
@@ -34,6 +34,8 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "AbstractMaterialLaw.hpp"
+#include <algorithm>
+#include "OpenMpExceptionCollector.hpp"
 
 template <unsigned DIM>
 AbstractMaterialLaw<DIM>::AbstractMaterialLaw()
@@ -48,7 +50,7 @@ void AbstractMaterialLaw<DIM>::ComputeCauchyStress(c_matrix<double,DIM,DIM>& rF,
 {
     double detF = Determinant(rF);
 
-    c_matrix<double,DIM,DIM> C = prod(trans(rF), rF);
+    c_matrix<double,DIM,DIM> C = TransposeProduct(rF);
     c_matrix<double,DIM,DIM> invC = Inverse(C);
 
     c_matrix<double,DIM,DIM> T;
@@ -84,7 +86,7 @@ void AbstractMaterialLaw<DIM>::Compute1stPiolaKirchoffStress(c_matrix<double,DIM
                                                              double pressure,
                                                              c_matrix<double,DIM,DIM>& rS)
 {
-    c_matrix<double,DIM,DIM> C = prod(trans(rF), rF);
+    c_matrix<double,DIM,DIM> C = TransposeProduct(rF);
     c_matrix<double,DIM,DIM> invC = Inverse(C);
 
     c_matrix<double,DIM,DIM> T;
@@ -174,6 +176,104 @@ void AbstractMaterialLaw<DIM>::TransformStressAndStressDerivative(c_matrix<doubl
     }
 }
 
+template <unsigned DIM>
+void AbstractMaterialLaw<DIM>::TransformStressAndStressDerivative(const c_matrix<double,DIM,DIM>& rP,
+                                                                  c_matrix<double,DIM,DIM>& rT,
+                                                                  FourthOrderTensor<DIM,DIM,DIM,DIM>& rDTdE,
+                                                                  bool transformDTdE,
+                                                                  FourthOrderTensor<DIM,DIM,DIM,DIM>& rScratch)
+{
+    //  T = P T* P^T   and   dTdE_{MNPQ}  =  P_{Mm}P_{Nn}P_{Pp}P_{Qq} dT*dE*_{mnpq}
+    c_matrix<double,DIM,DIM> T_transformed_times_Ptrans = prod(rT, trans(rP));
+    rT = prod(rP, T_transformed_times_Ptrans);
+
+    if (transformDTdE)
+    {
+        rScratch.template SetAsContractionOnFirstDimension<DIM>(rP, rDTdE);
+        rDTdE.template SetAsContractionOnSecondDimension<DIM>(rP, rScratch);
+        rScratch.template SetAsContractionOnThirdDimension<DIM>(rP, rDTdE);
+        rDTdE.template SetAsContractionOnFourthDimension<DIM>(rP, rScratch);
+    }
+}
+
+template <unsigned DIM>
+void AbstractMaterialLaw<DIM>::ComputeStressesAndStressDerivatives(unsigned firstPoint,
+                                                                   unsigned numPoints,
+                                                                   std::vector<c_matrix<double,DIM,DIM> >& rC,
+                                                                   std::vector<c_matrix<double,DIM,DIM> >& rInvC,
+                                                                   const std::vector<double>& rPressures,
+                                                                   const std::vector<c_matrix<double,DIM,DIM> >* pChangeOfBasisMatrices,
+                                                                   std::vector<c_matrix<double,DIM,DIM> >& rT,
+                                                                   std::vector<FourthOrderTensor<DIM,DIM,DIM,DIM> >& rDTdE,
+                                                                   bool computeDTdE,
+                                                                   unsigned numThreads)
+{
+    unsigned end_point = firstPoint + numPoints;
+    assert(rC.size() >= end_point);
+    assert(rInvC.size() >= end_point);
+    assert(rPressures.empty() || rPressures.size() >= end_point);
+    assert(pChangeOfBasisMatrices == nullptr || pChangeOfBasisMatrices->size() >= end_point);
+    assert(rT.size() >= end_point);
+    assert(!computeDTdE || rDTdE.size() >= end_point);
+
+    // The change of basis is applied here, point by point, rather than by the law, so
+    // that it doesn't have to be set in (shared) member data for each point
+    c_matrix<double,DIM,DIM>* p_law_change_of_basis = mpChangeOfBasisMatrix;
+    mpChangeOfBasisMatrix = nullptr;
+
+    int first_point = static_cast<int>(firstPoint);
+    int last_point = static_cast<int>(end_point);
+    unsigned num_threads = IsThreadSafe() ? std::max(numThreads, 1u) : 1u;
+
+    // The first exception thrown for any point (e.g. because the strain is too large
+    // for the law) is re-thrown once all points have been done
+    OpenMpExceptionCollector exception_collector;
+#ifdef CHASTE_OPENMP
+#pragma omp parallel num_threads(num_threads) if (num_threads > 1u)
+#endif // CHASTE_OPENMP
+    {
+        c_matrix<double,DIM,DIM> C_transformed;
+        c_matrix<double,DIM,DIM> invC_transformed;
+
+        // Stands in for the stress derivative if it is not required, and is working
+        // space for transforming it otherwise
+        FourthOrderTensor<DIM,DIM,DIM,DIM> scratch;
+
+#ifdef CHASTE_OPENMP
+#pragma omp for schedule(static)
+#endif // CHASTE_OPENMP
+        for (int i=first_point; i<last_point; i++)
+        {
+            try
+            {
+                const c_matrix<double,DIM,DIM>* p_change_of_basis = pChangeOfBasisMatrices ? &(*pChangeOfBasisMatrices)[i] : p_law_change_of_basis;
+                double pressure = rPressures.empty() ? 0.0 : rPressures[i];
+                FourthOrderTensor<DIM,DIM,DIM,DIM>& r_dTdE = computeDTdE ? rDTdE[i] : scratch;
+
+                if (p_change_of_basis)
+                {
+                    // C* = P^T C P, and ditto inv(C)
+                    C_transformed = prod(trans(*p_change_of_basis), (c_matrix<double,DIM,DIM>)prod(rC[i], *p_change_of_basis));
+                    invC_transformed = prod(trans(*p_change_of_basis), (c_matrix<double,DIM,DIM>)prod(rInvC[i], *p_change_of_basis));
+                    ComputeStressAndStressDerivative(C_transformed, invC_transformed, pressure, rT[i], r_dTdE, computeDTdE);
+                    TransformStressAndStressDerivative(*p_change_of_basis, rT[i], r_dTdE, computeDTdE, scratch);
+                }
+                else
+                {
+                    ComputeStressAndStressDerivative(rC[i], rInvC[i], pressure, rT[i], r_dTdE, computeDTdE);
+                }
+            }
+            catch (...)
+            {
+                exception_collector.Capture();
+            }
+        }
+    }
+
+    mpChangeOfBasisMatrix = p_law_change_of_basis;
+    exception_collector.RethrowIfAny();
+}
+
 // Explicit instantiation
 template class AbstractMaterialLaw<2>;
 template class AbstractMaterialLaw<3>;
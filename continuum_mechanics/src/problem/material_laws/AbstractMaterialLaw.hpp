@@ -86,6 +86,24 @@ protected:
                                             FourthOrderTensor<DIM,DIM,DIM,DIM>& rDTdE,
                                             bool transformDTdE);
 
+    /**
+     *  Transform T and dTdE back from the coordinate system given by a change of basis
+     *  matrix P. Unlike the method above this uses no member or static storage, so it
+     *  may be called for different points at the same time.
+     *
+     *  @param rP the change of basis matrix
+     *  @param rT stress being computed
+     *  @param rDTdE the stress derivative to be transformed (assuming
+     *    transformDTdE is true)
+     *  @param transformDTdE whether the stress derivative is to be transformed or not
+     *  @param rScratch working space for transforming the stress derivative
+     */
+    static void TransformStressAndStressDerivative(const c_matrix<double,DIM,DIM>& rP,
+                                                   c_matrix<double,DIM,DIM>& rT,
+                                                   FourthOrderTensor<DIM,DIM,DIM,DIM>& rDTdE,
+                                                   bool transformDTdE,
+                                                   FourthOrderTensor<DIM,DIM,DIM,DIM>& rScratch);
+
 public:
 
     /** Constuctor */
@@ -121,6 +139,56 @@ public:
                                                   FourthOrderTensor<DIM,DIM,DIM,DIM>&   rDTdE,
                                                   bool                      computeDTdE)=0;
 
+    /**
+     *  Compute the stress T, and optionally the stress derivative dT/dE, at a batch of
+     *  points, for example all the quadrature points of a set of elements. See
+     *  ComputeStressAndStressDerivative() for the meaning of the quantities.
+     *
+     *  Each point may have its own change of basis matrix (see SetChangeOfBasisMatrix()).
+     *  If the law IsThreadSafe() the points are shared between numThreads OpenMP threads;
+     *  otherwise they are done in turn. This default implementation calls
+     *  ComputeStressAndStressDerivative() for each point: laws may override it with a
+     *  version that handles the whole batch at once, e.g. so that it vectorises.
+     *
+     *  If the stress derivative is not required rDTdE is not used, and may be empty, so
+     *  that no fourth-order tensors need to be stored when only the residual is assembled.
+     *
+     *  @param firstPoint the index in the vectors below of the first point
+     *  @param numPoints the number of points, so entries firstPoint to
+     *    firstPoint+numPoints-1 of the vectors below are used
+     *  @param rC the Lagrangian deformation tensor at each point
+     *  @param rInvC the inverse of C at each point
+     *  @param rPressures the pressure at each point, or empty for zero pressure
+     *  @param pChangeOfBasisMatrices the change of basis matrix at each point, or NULL
+     *    to use the one set with SetChangeOfBasisMatrix() (if any) at every point
+     *  @param rT the stress at each point is returned in this parameter
+     *  @param rDTdE the stress derivative at each point is returned in this parameter,
+     *    if computeDTdE is true
+     *  @param computeDTdE whether the stress derivatives are required or not
+     *  @param numThreads the number of threads to use (defaults to 1)
+     */
+    virtual void ComputeStressesAndStressDerivatives(unsigned firstPoint,
+                                                     unsigned numPoints,
+                                                     std::vector<c_matrix<double,DIM,DIM> >& rC,
+                                                     std::vector<c_matrix<double,DIM,DIM> >& rInvC,
+                                                     const std::vector<double>& rPressures,
+                                                     const std::vector<c_matrix<double,DIM,DIM> >* pChangeOfBasisMatrices,
+                                                     std::vector<c_matrix<double,DIM,DIM> >& rT,
+                                                     std::vector<FourthOrderTensor<DIM,DIM,DIM,DIM> >& rDTdE,
+                                                     bool computeDTdE,
+                                                     unsigned numThreads=1u);
+
+    /**
+     *  @return whether ComputeStressAndStressDerivative() may be called for different
+     *  points at the same time, as required by ComputeStressesAndStressDerivatives() to
+     *  use threads. This holds if it keeps no working data in static variables or
+     *  members. Returns false here, laws which are thread safe should override it.
+     */
+    virtual bool IsThreadSafe() const
+    {
+        return false;
+    }
+
     /**
      *  Compute the Cauchy stress (the true stress), given the deformation gradient
      *  F and the pressure. The Cauchy stress is given by
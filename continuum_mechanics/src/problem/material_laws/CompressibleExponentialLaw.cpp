@@ -83,8 +83,8 @@ void CompressibleExponentialLaw<DIM>::ComputeStressAndStressDerivative(c_matrix<
                                                                        FourthOrderTensor<DIM,DIM,DIM,DIM>& rDTdE,
                                                                        bool                  computeDTdE)
 {
-    static c_matrix<double,DIM,DIM> C_transformed;
-    static c_matrix<double,DIM,DIM> invC_transformed;
+    c_matrix<double,DIM,DIM> C_transformed;
+    c_matrix<double,DIM,DIM> invC_transformed;
 
     // The material law parameters are set up assuming the fibre direction is (1,0,0)
     // and sheet direction is (0,1,0), so we have to transform C,inv(C),and T.
@@ -108,7 +108,6 @@ void CompressibleExponentialLaw<DIM>::ComputeStressAndStressDerivative(c_matrix<
     }
     assert(QQ < 10.0);///\todo #2193 This line is to trap for large deformations which lead to blow up in the exponential Uysk model
     double multiplier = mA*exp(QQ);
-    rDTdE.Zero();
 
     double J = sqrt(Determinant(rC));
 
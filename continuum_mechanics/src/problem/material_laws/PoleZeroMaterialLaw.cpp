@@ -97,8 +97,8 @@ void PoleZeroMaterialLaw<DIM>::ComputeStressAndStressDerivative(c_matrix<double,
                                                                 FourthOrderTensor<DIM,DIM,DIM,DIM>&   rDTdE,
                                                                 bool                      computeDTdE)
 {
-    static c_matrix<double,DIM,DIM> C_transformed;
-    static c_matrix<double,DIM,DIM> invC_transformed;
+    c_matrix<double,DIM,DIM> C_transformed;
+    c_matrix<double,DIM,DIM> invC_transformed;
 
     // The material law parameters are set up assuming the fibre direction is (1,0,0)
     // and sheet direction is (0,1,0), so we have to transform C,inv(C),and T.
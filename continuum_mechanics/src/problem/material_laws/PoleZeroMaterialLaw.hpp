@@ -139,6 +139,14 @@ public:
                                           FourthOrderTensor<DIM,DIM,DIM,DIM>&   rDTdE,
                                           bool                      computeDTdE);
 
+    /**
+     * @return true, as the stress is computed without any static or member working data.
+     */
+    bool IsThreadSafe() const
+    {
+        return true;
+    }
+
     /**
      * @return the pressure corresponding to E=0, ie C=identity.
      */
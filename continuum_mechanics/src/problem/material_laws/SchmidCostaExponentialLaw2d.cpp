@@ -70,8 +70,8 @@ void SchmidCostaExponentialLaw2d::ComputeStressAndStressDerivative(c_matrix<doub
                                                                    FourthOrderTensor<2,2,2,2>& rDTdE,
                                                                    bool                  computeDTdE)
 {
-    static c_matrix<double,2,2> C_transformed;
-    static c_matrix<double,2,2> invC_transformed;
+    c_matrix<double,2,2> C_transformed;
+    c_matrix<double,2,2> invC_transformed;
 
     // The material law parameters are set up assuming the fibre direction is (1,0,0)
     // and sheet direction is (0,1,0), so we have to transform C,inv(C),and T.
@@ -95,7 +95,6 @@ void SchmidCostaExponentialLaw2d::ComputeStressAndStressDerivative(c_matrix<doub
     }
 
     double multiplier = mA*exp(QQ)/2;
-    rDTdE.Zero();
 
     for (unsigned M=0; M<2; M++)
     {
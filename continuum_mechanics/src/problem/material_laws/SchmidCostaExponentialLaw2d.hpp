@@ -98,6 +98,14 @@ public:
                                           FourthOrderTensor<2,2,2,2>&  rDTdE,
                                           bool                   computeDTdE);
 
+    /**
+     * @return true, as the stress is computed without any static or member working data.
+     */
+    bool IsThreadSafe() const
+    {
+        return true;
+    }
+
     /**
      * @return  mA.
      */
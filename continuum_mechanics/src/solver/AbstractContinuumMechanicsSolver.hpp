@@ -201,6 +201,12 @@ protected:
      */
     Mat mPreconditionMatrix;
 
+    /**
+     * Whether to precondition the (incompressible, saddle point) linear systems with a
+     * Schur complement field split. See SetUseFieldSplitPreconditioner().
+     */
+    bool mUseFieldSplitPreconditioner;
+
     /**
      * Allocates memory for the matrices and vectors
      */
@@ -287,6 +293,22 @@ protected:
      */
     void RemovePressureDummyValuesThroughLinearInterpolation();
 
+    /**
+     * Set up a PCFIELDSPLIT block preconditioner for the saddle point system of an
+     * incompressible problem (see SetUseFieldSplitPreconditioner()). The displacement
+     * (or flow) and pressure fields are taken from the [U0 V0 W0 P0 .. Un Vn Wn Pn]
+     * ordering of the unknowns. The Schur complement is approximated by the
+     * pressure-pressure block of the preconditioner matrix, which holds the pressure
+     * mass matrix.
+     *
+     * The sub-solvers use the options prefixes "fieldsplit_u_" and "fieldsplit_p_",
+     * so can be changed on the command line; by default they are a single application
+     * of AMG (PCGAMG) for the displacement block and of Jacobi for the mass matrix.
+     *
+     * @param pc the preconditioner of the linear solver
+     */
+    void SetUpFieldSplitPreconditioner(PC pc);
+
 public:
     /**
      *  Constructor
@@ -337,6 +359,18 @@ public:
      */
     void SetWriteOutput(bool writeOutput=true);
 
+    /**
+     * Use a block (PCFIELDSPLIT) preconditioner for the linear solves, with a Schur
+     * complement approximated by the pressure mass matrix and AMG for the displacement
+     * (or flow) block, rather than the default preconditioner. This scales to larger
+     * problems than ILU, without the memory needed by SetUsePetscDirectSolve() (which
+     * takes precedence if set). Only for incompressible problems; requires PETSc 3.5
+     * or later.
+     *
+     * @param useFieldSplit whether to use the field split preconditioner (defaults to true)
+     */
+    void SetUseFieldSplitPreconditioner(bool useFieldSplit=true);
+
     /**
      * Convert the output to vtk format (placed in a folder called vtk in the output directory).
      * @param spatialSolutionName is used to identify the spatial solution as a velocity, displacement...
@@ -386,7 +420,8 @@ AbstractContinuumMechanicsSolver<DIM>::AbstractContinuumMechanicsSolver(Abstract
       mCompressibilityType(compressibilityType),
       mResidualVector(nullptr),
       mSystemLhsMatrix(nullptr),
-      mPreconditionMatrix(nullptr)
+      mPreconditionMatrix(nullptr),
+      mUseFieldSplitPreconditioner(false)
 {
     assert(DIM==2 || DIM==3);
 
@@ -542,6 +577,70 @@ void AbstractContinuumMechanicsSolver<DIM>::SetWriteOutput(bool writeOutput)
     mWriteOutput = writeOutput;
 }
 
+template <unsigned DIM>
+void AbstractContinuumMechanicsSolver<DIM>::SetUseFieldSplitPreconditioner(bool useFieldSplit)
+{
+    if (useFieldSplit && (mCompressibilityType != INCOMPRESSIBLE))
+    {
+        EXCEPTION("The field split preconditioner is only for incompressible problems");
+    }
+#if (PETSC_VERSION_MAJOR < 3 || (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR < 5)) // Before PETSc 3.5
+    if (useFieldSplit)
+    {
+        EXCEPTION("The field split preconditioner requires PETSc 3.5 or later");
+    }
+#endif
+    mUseFieldSplitPreconditioner = useFieldSplit;
+}
+
+template <unsigned DIM>
+void AbstractContinuumMechanicsSolver<DIM>::SetUpFieldSplitPreconditioner(PC pc)
+{
+    assert(mCompressibilityType == INCOMPRESSIBLE);
+#if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 5) // PETSc 3.5 or later
+    PCSetType(pc, PCFIELDSPLIT);
+
+    // The unknowns come in blocks of mProblemDimension = DIM+1 per node, the
+    // first DIM being the displacement (or flow) and the last the pressure
+    PCFieldSplitSetBlockSize(pc, mProblemDimension);
+    PetscInt displacement_fields[DIM];
+    for (unsigned i=0; i<DIM; i++)
+    {
+        displacement_fields[i] = i;
+    }
+    PetscInt pressure_field = DIM;
+    PCFieldSplitSetFields(pc, "u", DIM, displacement_fields, displacement_fields);
+    PCFieldSplitSetFields(pc, "p", 1, &pressure_field, &pressure_field);
+
+    // Block upper triangular preconditioner [A B^T; 0 S], with S approximated by
+    // the pressure mass matrix in the preconditioner matrix
+    PCFieldSplitSetType(pc, PC_COMPOSITE_SCHUR);
+    PCFieldSplitSetSchurFactType(pc, PC_FIELDSPLIT_SCHUR_FACT_UPPER);
+    PCFieldSplitSetSchurPre(pc, PC_FIELDSPLIT_SCHUR_PRE_A11, nullptr);
+
+    // Defaults for the sub-solvers, which are read when the preconditioner is set up
+    // and can be overridden on the command line
+    if (!CommandLineArguments::Instance()->OptionExists("-fieldsplit_u_ksp_type"))
+    {
+        PetscTools::SetOption("-fieldsplit_u_ksp_type", "preonly");
+    }
+    if (!CommandLineArguments::Instance()->OptionExists("-fieldsplit_u_pc_type"))
+    {
+        PetscTools::SetOption("-fieldsplit_u_pc_type", "gamg");
+    }
+    if (!CommandLineArguments::Instance()->OptionExists("-fieldsplit_p_ksp_type"))
+    {
+        PetscTools::SetOption("-fieldsplit_p_ksp_type", "preonly");
+    }
+    if (!CommandLineArguments::Instance()->OptionExists("-fieldsplit_p_pc_type"))
+    {
+        PetscTools::SetOption("-fieldsplit_p_pc_type", "jacobi");
+    }
+#else
+    NEVER_REACHED; // SetUseFieldSplitPreconditioner() doesn't allow it
+#endif
+}
+
 // ** TO BE DEPRECATED - see #2321 **
 template <unsigned DIM>
 void AbstractContinuumMechanicsSolver<DIM>::CreateVtkOutput(std::string spatialSolutionName)
@@ -914,11 +1013,11 @@ void AbstractContinuumMechanicsSolver<DIM>::AllocateMatrixMemory()
 
 
 #if (PETSC_VERSION_MAJOR == 2 && PETSC_VERSION_MINOR == 2) //PETSc 2.2
-        MatCreate(PETSC_COMM_WORLD,local_size,local_size,mNumDofs,mNumDofs,&mSystemLhsMatrix);
-        MatCreate(PETSC_COMM_WORLD,local_size,local_size,mNumDofs,mNumDofs,&mPreconditionMatrix);
+        MatCreate(PetscTools::GetWorld(),local_size,local_size,mNumDofs,mNumDofs,&mSystemLhsMatrix);
+        MatCreate(PetscTools::GetWorld(),local_size,local_size,mNumDofs,mNumDofs,&mPreconditionMatrix);
 #else //New API
-        MatCreate(PETSC_COMM_WORLD,&mSystemLhsMatrix);
-        MatCreate(PETSC_COMM_WORLD,&mPreconditionMatrix);
+        MatCreate(PetscTools::GetWorld(),&mSystemLhsMatrix);
+        MatCreate(PetscTools::GetWorld(),&mPreconditionMatrix);
         MatSetSizes(mSystemLhsMatrix,local_size,local_size,mNumDofs,mNumDofs);
         MatSetSizes(mPreconditionMatrix,local_size,local_size,mNumDofs,mNumDofs);
 #endif
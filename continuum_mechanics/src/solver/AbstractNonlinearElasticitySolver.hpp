@@ -36,6 +36,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef ABSTRACTNONLINEARELASTICITYSOLVER_HPP_
 #define ABSTRACTNONLINEARELASTICITYSOLVER_HPP_
 
+#include <algorithm>
 #include <vector>
 #include <cmath>
 #include "AbstractContinuumMechanicsSolver.hpp"
@@ -315,6 +316,57 @@ protected:
      */
     bool mPetscDirectSolve;
 
+    /**
+     *  The Jacobian is reassembled every this many Newton iterations, counting across
+     *  solves - see documentation for SetJacobianLag(). Defaults to 1, ie Newton's method.
+     */
+    unsigned mJacobianLag;
+
+    /**
+     *  Whether to assemble the Jacobian only in the first Newton iteration of each solve -
+     *  see documentation for SetUseModifiedNewton()
+     */
+    bool mUseModifiedNewton;
+
+    /**
+     *  Whether to choose the linear solve tolerance with the Eisenstat-Walker rule -
+     *  see documentation for SetUseEisenstatWalkerKspTolerance()
+     */
+    bool mUseEisenstatWalker;
+
+    /**
+     *  Whether the SNES solver applies the Jacobian matrix-free, by finite differences of
+     *  the residual - see documentation for SetUseMatrixFreeSnesJacobian()
+     */
+    bool mUseMatrixFreeSnesJacobian;
+
+    /** Number of Newton iterations taken since the Jacobian was last assembled. */
+    unsigned mIterationsSinceJacobianAssembly;
+
+    /**
+     *  Whether the next Newton iteration has to assemble the Jacobian, because there is
+     *  no usable one yet or because reusing the old one stopped working.
+     */
+    bool mForceJacobianAssembly;
+
+    /**
+     *  Linear solver used by TakeNewtonStep(). It is kept between Newton iterations and
+     *  solves, so that its preconditioner is only set up again when the Jacobian is.
+     */
+    KSP mLinearSolver;
+
+    /** Whether mLinearSolver has been created. */
+    bool mLinearSolverCreated;
+
+    /**
+     *  Norm of the residual at the start of the previous Newton iteration of the current
+     *  solve, or -1 in the first iteration. Used for the Eisenstat-Walker tolerance.
+     */
+    double mPreviousNewtonResidualNorm;
+
+    /** Relative linear solve tolerance used in the previous Newton iteration. */
+    double mPreviousKspRelativeTol;
+
     /**
      * Whether to call AddActiveStressAndStressDerivative() when computing stresses or not.
      *
@@ -339,6 +391,48 @@ protected:
      */
     std::vector<c_vector<double,DIM*(DIM+1)/2> > mAverageStressesPerElement;
 
+    /**
+     * Whether to keep the kinematic quantities (F, C, inverse(C), ...) at each quadrature
+     * point between calls to AssembleSystem(), reusing them whilst the current solution
+     * is unchanged. Defaults to false.
+     */
+    bool mUseKinematicsCache;
+
+    /**
+     * Whether the cached kinematic quantities correspond to the current solution. Set by
+     * PrepareKinematicsCache(); if false the assembly should compute the quantities and
+     * store them in the cache.
+     */
+    bool mKinematicsCacheIsCurrent;
+
+    /**
+     * The solution the cached kinematic quantities were computed from. Empty if the cache
+     * holds nothing usable (including while it is being filled).
+     */
+    std::vector<double> mKinematicsCacheSolution;
+
+    /** Cached deformation gradient F at each quadrature point (indexed by global quad point index). */
+    std::vector<c_matrix<double,DIM,DIM> > mCachedF;
+
+    /** Cached inverse(F) at each quadrature point. */
+    std::vector<c_matrix<double,DIM,DIM> > mCachedInvF;
+
+    /** Cached C = F^T F at each quadrature point. */
+    std::vector<c_matrix<double,DIM,DIM> > mCachedC;
+
+    /** Cached inverse(C) at each quadrature point. */
+    std::vector<c_matrix<double,DIM,DIM> > mCachedInvC;
+
+    /** Cached det(F) at each quadrature point. */
+    std::vector<double> mCachedDetF;
+
+    /**
+     * To be called at the start of AssembleSystem(). If the kinematics cache is in use,
+     * sets mKinematicsCacheIsCurrent according to whether the cache was computed from the
+     * current solution, and if not prepares the cache to be filled during assembly.
+     */
+    void PrepareKinematicsCache();
+
     /**
      *  Add the given stress tensor to the store of average stresses.
      *  mSetComputeAverageStressPerElement must be true
@@ -548,11 +642,34 @@ protected:
      */
     void PrintLineSearchResult(double s, double residNorm);
 
+    /**
+     * @return whether the Newton step about to be taken should assemble the Jacobian,
+     * or reuse the one already in mrJacobianMatrix.
+     */
+    bool ShouldAssembleJacobian();
+
+    /**
+     * Choose the relative tolerance of the linear solve in a Newton step with the
+     * Eisenstat-Walker rule (choice 2): eta_k = (|f_k|/|f_{k-1}|)^alpha with
+     * alpha = (1+sqrt(5))/2, safeguarded so that eta does not drop too quickly, and
+     * kept in [1e-6, 0.9]. Early iterations are therefore solved loosely, and later ones
+     * as accurately as the default tolerance.
+     *
+     * @param residNorm norm of the residual at the start of this Newton step
+     * @return the relative tolerance
+     */
+    double ComputeEisenstatWalkerKspRelativeTolerance(double residNorm);
+
     /**
      * Take one newton step, by solving the linear system -Ju=f, (J the jacobian, f
      * the residual, u the update), and picking s such that a_new = a_old + su (a
      * the current solution) such |f(a)| is the smallest.
      *
+     * If the Jacobian is reused (see SetJacobianLag() and SetUseModifiedNewton()) only
+     * the residual is assembled. Should the old Jacobian no longer give a direction in
+     * which the residual decreases, the step is retried with a newly assembled one, and
+     * if it only reduces the residual slowly the next step assembles a new one.
+     *
      * @return The current norm of the residual after the newton step.
      */
     double TakeNewtonStep();
@@ -724,6 +841,105 @@ public:
         mPetscDirectSolve = usePetscDirectSolve;
     }
 
+    /**
+     *  Only reassemble the Jacobian (and set up the preconditioner) every lag-th Newton
+     *  iteration, reusing it in between. The count carries over from one solve to the
+     *  next, so in time-dependent problems such as electromechanics the Jacobian and
+     *  preconditioner of one mechanics timestep can be reused in the following ones.
+     *  The residual is still assembled in every iteration. The command line argument
+     *  "-mech_jacobian_lag <lag>" does the same.
+     *
+     *  Does nothing if the SNES solver is used, unless in the matrix-free mode (see
+     *  SetUseMatrixFreeSnesJacobian()), where it sets how often the preconditioner is reassembled.
+     *
+     *  @param lag Number of Newton iterations per Jacobian assembly (1 is Newton's method)
+     */
+    void SetJacobianLag(unsigned lag)
+    {
+        assert(lag > 0);
+        mJacobianLag = lag;
+    }
+
+    /**
+     *  Use the modified Newton method: assemble the Jacobian in the first Newton iteration
+     *  of each solve only, and reuse it in the remaining ones. Takes precedence over
+     *  SetJacobianLag(). The command line argument "-mech_modified_newton" does the same.
+     *
+     *  Does nothing if the SNES solver is used, unless in the matrix-free mode (see
+     *  SetUseMatrixFreeSnesJacobian()), where the preconditioner is then assembled once per solve.
+     *
+     *  @param useModifiedNewton Whether to use modified Newton or not
+     */
+    void SetUseModifiedNewton(bool useModifiedNewton = true)
+    {
+        mUseModifiedNewton = useModifiedNewton;
+    }
+
+    /**
+     *  Choose the linear solve tolerance in each Newton iteration adaptively, with the
+     *  Eisenstat-Walker rule, rather than always solving to a relative tolerance of 1e-6.
+     *  Ignored if SetKspAbsoluteTolerance() has been called. The command line argument
+     *  "-mech_eisenstat_walker" does the same.
+     *
+     *  Does nothing if the SNES solver is used.
+     *
+     *  @param useEisenstatWalker Whether to use the Eisenstat-Walker tolerance or not
+     */
+    void SetUseEisenstatWalkerKspTolerance(bool useEisenstatWalker = true)
+    {
+        mUseEisenstatWalker = useEisenstatWalker;
+    }
+
+    /**
+     *  Solve with Jacobian-free Newton-Krylov when the SNES solver is used: the Jacobian is
+     *  applied to vectors by finite differences of the residual, and the assembled Jacobian
+     *  is only used to build the preconditioner. The preconditioner is reassembled according to
+     *  SetJacobianLag() and SetUseModifiedNewton(), so the (expensive) Jacobian assembly can be
+     *  done much less often than in every Newton iteration. The command line argument
+     *  "-mech_snes_matrix_free" does the same.
+     *
+     *  Does nothing if the SNES solver is not used.
+     *
+     *  @param useMatrixFree Whether to apply the Jacobian matrix-free or not
+     */
+    void SetUseMatrixFreeSnesJacobian(bool useMatrixFree = true)
+    {
+        mUseMatrixFreeSnesJacobian = useMatrixFree;
+    }
+
+    /**
+     *  Keep the kinematic quantities (F, C, inverse(C), inverse(F), det(F)) at every
+     *  quadrature point, and reuse them in further assemblies with the same current
+     *  solution, such as the residual and then Jacobian assembly of a Newton iteration
+     *  or the SNES residual and Jacobian callbacks. Uses memory for several DIM by DIM
+     *  matrices per quadrature point.
+     *
+     *  @param useKinematicsCache Whether to cache the kinematic quantities or not
+     */
+    void SetUseKinematicsCache(bool useKinematicsCache = true)
+    {
+        mUseKinematicsCache = useKinematicsCache;
+        InvalidateKinematicsCache();
+    }
+
+    /**
+     * @return whether the kinematic quantities are cached between assemblies.
+     */
+    bool GetUseKinematicsCache() const
+    {
+        return mUseKinematicsCache;
+    }
+
+    /**
+     * Discard the cached kinematic quantities, so they are recomputed in the next assembly.
+     * Only needed if the mesh is changed between solves.
+     */
+    void InvalidateKinematicsCache()
+    {
+        mKinematicsCacheSolution.clear();
+        mKinematicsCacheIsCurrent = false;
+    }
+
 
     /**
      * This solver is for static problems, however the body force or surface tractions
@@ -822,8 +1038,16 @@ AbstractNonlinearElasticitySolver<DIM>::AbstractNonlinearElasticitySolver(Abstra
       mCurrentTime(0.0),
       mCheckedOutwardNormals(false),
       mLastDampingValue(0.0),
+      mJacobianLag(1u),
+      mIterationsSinceJacobianAssembly(0u),
+      mForceJacobianAssembly(true),
+      mLinearSolverCreated(false),
+      mPreviousNewtonResidualNorm(-1.0),
+      mPreviousKspRelativeTol(0.0),
       mIncludeActiveTension(true),
-      mSetComputeAverageStressPerElement(false)
+      mSetComputeAverageStressPerElement(false),
+      mUseKinematicsCache(false),
+      mKinematicsCacheIsCurrent(false)
 {
     mUseSnesSolver = (mrProblemDefinition.GetSolveUsingSnes() ||
                       CommandLineArguments::Instance()->OptionExists("-mech_use_snes") );
@@ -832,16 +1056,67 @@ AbstractNonlinearElasticitySolver<DIM>::AbstractNonlinearElasticitySolver(Abstra
 
     mTakeFullFirstNewtonStep = CommandLineArguments::Instance()->OptionExists("-mech_full_first_newton_step");
     mPetscDirectSolve = CommandLineArguments::Instance()->OptionExists("-mech_petsc_direct_solve");
+    if (CommandLineArguments::Instance()->OptionExists("-mech_fieldsplit") && compressibilityType == INCOMPRESSIBLE)
+    {
+        this->SetUseFieldSplitPreconditioner();
+    }
+
+    if (CommandLineArguments::Instance()->OptionExists("-mech_jacobian_lag"))
+    {
+        SetJacobianLag(CommandLineArguments::Instance()->GetUnsignedCorrespondingToOption("-mech_jacobian_lag"));
+    }
+    mUseModifiedNewton = CommandLineArguments::Instance()->OptionExists("-mech_modified_newton");
+    mUseEisenstatWalker = CommandLineArguments::Instance()->OptionExists("-mech_eisenstat_walker");
+    mUseMatrixFreeSnesJacobian = CommandLineArguments::Instance()->OptionExists("-mech_snes_matrix_free");
 }
 
 template <unsigned DIM>
 AbstractNonlinearElasticitySolver<DIM>::~AbstractNonlinearElasticitySolver()
 {
+    if (mLinearSolverCreated)
+    {
+        KSPDestroy(PETSC_DESTROY_PARAM(mLinearSolver));
+    }
+}
+
+template <unsigned DIM>
+void AbstractNonlinearElasticitySolver<DIM>::PrepareKinematicsCache()
+{
+    mKinematicsCacheIsCurrent = false;
+    if (!mUseKinematicsCache)
+    {
+        return;
+    }
+
+    if (!mKinematicsCacheSolution.empty() && mKinematicsCacheSolution == this->mCurrentSolution)
+    {
+        mKinematicsCacheIsCurrent = true;
+        return;
+    }
+
+    // The cache is about to be (re)filled: forget which solution it came from until the
+    // assembly has finished, so an assembly that fails part way can't leave a stale cache
+    mKinematicsCacheSolution.clear();
+    unsigned num_quad_points = this->mrQuadMesh.GetNumElements()*this->mpQuadratureRule->GetNumQuadPoints();
+    if (mCachedF.size() != num_quad_points)
+    {
+        mCachedF.resize(num_quad_points);
+        mCachedInvF.resize(num_quad_points);
+        mCachedC.resize(num_quad_points);
+        mCachedInvC.resize(num_quad_points);
+        mCachedDetF.resize(num_quad_points);
+    }
 }
 
 template <unsigned DIM>
 void AbstractNonlinearElasticitySolver<DIM>::FinishAssembleSystem(bool assembleResidual, bool assembleJacobian)
 {
+    if (mUseKinematicsCache && !mKinematicsCacheIsCurrent)
+    {
+        mKinematicsCacheSolution = this->mCurrentSolution;
+        mKinematicsCacheIsCurrent = true;
+    }
+
     PetscVecTools::Finalise(this->mResidualVector);
 
     if (assembleJacobian)
@@ -1137,12 +1412,12 @@ void AbstractNonlinearElasticitySolver<DIM>::GetElementCentroidStrain(StrainType
         }
         case DEFORMATION_TENSOR_C:
         {
-            rStrain = prod(trans(deformation_gradient),deformation_gradient);
+            rStrain = TransposeProduct(deformation_gradient);
             break;
         }
         case LAGRANGE_STRAIN_E:
         {
-            c_matrix<double,DIM,DIM> C = prod(trans(deformation_gradient),deformation_gradient);
+            c_matrix<double,DIM,DIM> C = TransposeProduct(deformation_gradient);
             for (unsigned M=0; M<DIM; M++)
             {
                 for (unsigned N=0; N<DIM; N++)
@@ -1570,7 +1845,8 @@ void AbstractNonlinearElasticitySolver<DIM>::SetKspSolverAndPcType(KSP solver)
     //   Otherwise iterative solve with:
     //   (b) Incompressible: GMRES with ILU preconditioner (or bjacobi=ILU on each process) [default]. Very poor on large problems.
     //   (c) Incompressible: GMRES with AMG preconditioner. Uncomment #define MECH_USE_HYPRE above. Requires Petsc3 with HYPRE installed.
-    //   (d) Compressible: CG with ICC
+    //   (d) Incompressible: GMRES with a Schur complement field split, if SetUseFieldSplitPreconditioner() is called.
+    //   (e) Compressible: CG with ICC
 
     PC pc;
     KSPGetPC(solver, &pc);
@@ -1615,6 +1891,12 @@ void AbstractNonlinearElasticitySolver<DIM>::SetKspSolverAndPcType(KSP solver)
             KSPSetType(solver,KSPGMRES);
             KSPGMRESSetRestart(solver,num_restarts);
 
+            if (this->mUseFieldSplitPreconditioner)
+            {
+                this->SetUpFieldSplitPreconditioner(pc);
+                return;
+            }
+
             #ifndef MECH_USE_HYPRE
                 PCSetType(pc, PCBJACOBI); // BJACOBI = ILU on each block (block = part of matrix on each process)
             #else
@@ -1707,16 +1989,30 @@ double AbstractNonlinearElasticitySolver<DIM>::TakeNewtonStep()
     }
 
     /////////////////////////////////////////////////////////////
-    // Assemble Jacobian (and preconditioner)
+    // Assemble Jacobian (and preconditioner), or only the residual
+    // if the last Jacobian is being reused
     /////////////////////////////////////////////////////////////
+    bool assemble_jacobian = ShouldAssembleJacobian();
+
     MechanicsEventHandler::BeginEvent(MechanicsEventHandler::ASSEMBLE);
-    AssembleSystem(true, true);
+    AssembleSystem(true, assemble_jacobian);
+    if (!assemble_jacobian)
+    {
+        // The Dirichlet rows of the residual already hold the boundary values of the
+        // update, so it can be used as the right-hand side as it is. (In the symmetric
+        // compressible case this omits the column terms for the Dirichlet values, which
+        // are zero once the boundary conditions are satisfied; until then it just makes
+        // the reused Jacobian a slightly worse approximation.)
+        VecCopy(this->mResidualVector, this->mLinearSystemRhsVector);
+    }
     MechanicsEventHandler::EndEvent(MechanicsEventHandler::ASSEMBLE);
     if (this->mVerbose)
     {
-        Timer::PrintAndReset("AssembleSystem");
+        Timer::PrintAndReset(assemble_jacobian ? "AssembleSystem" : "AssembleSystem (residual only, reusing Jacobian)");
     }
 
+    double initial_norm_resid = CalculateResidualNorm();
+
     ///////////////////////////////////////////////////////////////////
     // Solve the linear system.
     ///////////////////////////////////////////////////////////////////
@@ -1725,22 +2021,34 @@ double AbstractNonlinearElasticitySolver<DIM>::TakeNewtonStep()
     Vec solution;
     VecDuplicate(this->mResidualVector,&solution);
 
-    KSP solver;
-    KSPCreate(PETSC_COMM_WORLD,&solver);
+    if (!mLinearSolverCreated)
+    {
+        KSPCreate(PetscTools::GetWorld(), &mLinearSolver);
+        mLinearSolverCreated = true;
+    }
+    KSP solver = mLinearSolver;
 
+    // Only hand the operators over again if the Jacobian has changed: otherwise the
+    // preconditioner already set up for it is reused
+    if (assemble_jacobian)
+    {
 #if ((PETSC_VERSION_MAJOR==3) && (PETSC_VERSION_MINOR>=5))
-    KSPSetOperators(solver, mrJacobianMatrix, this->mPreconditionMatrix);
+        KSPSetOperators(solver, mrJacobianMatrix, this->mPreconditionMatrix);
 #else
-    KSPSetOperators(solver, mrJacobianMatrix, this->mPreconditionMatrix, DIFFERENT_NONZERO_PATTERN /*in precond between successive solves*/);
+        KSPSetOperators(solver, mrJacobianMatrix, this->mPreconditionMatrix, DIFFERENT_NONZERO_PATTERN /*in precond between successive solves*/);
 #endif
 
-    // Set the type of KSP solver (CG, GMRES etc) and preconditioner (ILU, HYPRE, etc)
-    SetKspSolverAndPcType(solver);
+        // Set the type of KSP solver (CG, GMRES etc) and preconditioner (ILU, HYPRE, etc)
+        SetKspSolverAndPcType(solver);
+
+        //PetscTools::SetOption("-ksp_monitor","");
+        //PetscTools::SetOption("-ksp_norm_type","natural");
 
-    //PetscTools::SetOption("-ksp_monitor","");
-    //PetscTools::SetOption("-ksp_norm_type","natural");
+        KSPSetFromOptions(solver);
 
-    KSPSetFromOptions(solver);
+        mIterationsSinceJacobianAssembly = 0;
+        mForceJacobianAssembly = false;
+    }
     KSPSetUp(solver);
 
 
@@ -1765,6 +2073,10 @@ double AbstractNonlinearElasticitySolver<DIM>::TakeNewtonStep()
         PetscTools::Destroy(linsys_residual);
 
         double ksp_rel_tol = 1e-6;
+        if (mUseEisenstatWalker)
+        {
+            ksp_rel_tol = ComputeEisenstatWalkerKspRelativeTolerance(initial_norm_resid);
+        }
         double absolute_tol = ksp_rel_tol * initial_resid_norm;
         if (absolute_tol < 1e-12)
         {
@@ -1839,7 +2151,6 @@ double AbstractNonlinearElasticitySolver<DIM>::TakeNewtonStep()
     if (num_iters==0)
     {
         PetscTools::Destroy(solution);
-        KSPDestroy(PETSC_DESTROY_PARAM(solver));
         EXCEPTION("KSP Absolute tolerance was too high, linear system wasn't solved - there will be no decrease in Newton residual. Decrease KspAbsoluteTolerance");
     }
 
@@ -1866,15 +2177,89 @@ double AbstractNonlinearElasticitySolver<DIM>::TakeNewtonStep()
     // s=1 is the best. Otherwise, check s=0.8 to see if s=0.9 is a local min.
     ///////////////////////////////////////////////////////////////////////////
     MechanicsEventHandler::BeginEvent(MechanicsEventHandler::UPDATE);
-    double new_norm_resid = UpdateSolutionUsingLineSearch(solution);
+    std::vector<double> solution_before_step;
+    if (!assemble_jacobian)
+    {
+        solution_before_step = this->mCurrentSolution;
+    }
+    double new_norm_resid;
+    try
+    {
+        new_norm_resid = UpdateSolutionUsingLineSearch(solution);
+    }
+    catch (Exception&)
+    {
+        MechanicsEventHandler::EndEvent(MechanicsEventHandler::UPDATE);
+        PetscTools::Destroy(solution);
+        if (assemble_jacobian)
+        {
+            throw;
+        }
+
+        // The old Jacobian no longer gives a descent direction, so undo the line
+        // search and take the step again with a new one
+        if (this->mVerbose)
+        {
+            std::cout << "\tReused Jacobian failed, reassembling it...\n" << std::flush;
+        }
+        this->mCurrentSolution = solution_before_step;
+        mForceJacobianAssembly = true;
+        return TakeNewtonStep();
+    }
     MechanicsEventHandler::EndEvent(MechanicsEventHandler::UPDATE);
 
     PetscTools::Destroy(solution);
-    KSPDestroy(PETSC_DESTROY_PARAM(solver));
+
+    mIterationsSinceJacobianAssembly++;
+
+    // If the reused Jacobian didn't even halve the residual, it is too far out of
+    // date: assemble a new one next time
+    if (!assemble_jacobian && new_norm_resid > 0.5*initial_norm_resid)
+    {
+        mForceJacobianAssembly = true;
+    }
 
     return new_norm_resid;
 }
 
+template <unsigned DIM>
+bool AbstractNonlinearElasticitySolver<DIM>::ShouldAssembleJacobian()
+{
+    if (mForceJacobianAssembly)
+    {
+        return true;
+    }
+    if (mUseModifiedNewton)
+    {
+        return mFirstStep;
+    }
+    return (mIterationsSinceJacobianAssembly >= mJacobianLag);
+}
+
+template <unsigned DIM>
+double AbstractNonlinearElasticitySolver<DIM>::ComputeEisenstatWalkerKspRelativeTolerance(double residNorm)
+{
+    const double alpha = 0.5*(1.0 + sqrt(5.0));
+
+    double rel_tol = 0.3; // first iteration
+    if (mPreviousNewtonResidualNorm > 0.0)
+    {
+        rel_tol = pow(residNorm/mPreviousNewtonResidualNorm, alpha);
+
+        // Safeguard: don't let the tolerance drop much faster than the residual
+        double safeguard = pow(mPreviousKspRelativeTol, alpha);
+        if (safeguard > 0.1)
+        {
+            rel_tol = std::max(rel_tol, safeguard);
+        }
+    }
+    rel_tol = std::min(std::max(rel_tol, 1e-6), 0.9);
+
+    mPreviousNewtonResidualNorm = residNorm;
+    mPreviousKspRelativeTol = rel_tol;
+    return rel_tol;
+}
+
 template <unsigned DIM>
 void AbstractNonlinearElasticitySolver<DIM>::PrintLineSearchResult(double s, double residNorm)
 {
@@ -2032,6 +2417,7 @@ template <unsigned DIM>
 void AbstractNonlinearElasticitySolver<DIM>::SolveNonSnes(double tol)
 {
     mLastDampingValue = 0;
+    mPreviousNewtonResidualNorm = -1.0;
 
     if (mWriteOutputEachNewtonIteration)
     {
@@ -2048,6 +2434,9 @@ void AbstractNonlinearElasticitySolver<DIM>::SolveNonSnes(double tol)
     mNumNewtonIterations = 0;
     unsigned iteration_number = 1;
 
+    // Reusing the Jacobian trades cheaper iterations for more of them
+    unsigned max_iterations = (mUseModifiedNewton || mJacobianLag > 1) ? 50 : 20;
+
     if (tol < 0) // i.e. if wasn't passed in as a parameter
     {
         tol = NEWTON_REL_TOL*norm_resid;
@@ -2097,10 +2486,10 @@ void AbstractNonlinearElasticitySolver<DIM>::SolveNonSnes(double tol)
         PostNewtonStep(iteration_number,norm_resid);
 
         iteration_number++;
-        if (iteration_number==20)
+        if (iteration_number==max_iterations)
         {
             // LCOV_EXCL_START
-            EXCEPTION("Not converged after 20 newton iterations, quitting");
+            EXCEPTION("Not converged after " << max_iterations << " newton iterations, quitting");
             // LCOV_EXCL_STOP
         }
     }
@@ -2146,9 +2535,23 @@ void AbstractNonlinearElasticitySolver<DIM>::SolveSnes()
 
     SNES snes;
 
-    SNESCreate(PETSC_COMM_WORLD, &snes);
+    SNESCreate(PetscTools::GetWorld(), &snes);
     SNESSetFunction(snes, snes_residual_vec, &AbstractNonlinearElasticitySolver_ComputeResidual<DIM>, this);
-    SNESSetJacobian(snes, mrJacobianMatrix, this->mPreconditionMatrix, &AbstractNonlinearElasticitySolver_ComputeJacobian<DIM>, this);
+
+    Mat matrix_free_jacobian = nullptr;
+    if (mUseMatrixFreeSnesJacobian)
+    {
+        // Jacobian-free Newton-Krylov: the Jacobian is a finite difference operator on the residual,
+        // and the assembled Jacobian (in the preconditioner matrix) is only reassembled every so often
+        MatCreateSNESMF(snes, &matrix_free_jacobian);
+        SNESSetJacobian(snes, matrix_free_jacobian, this->mPreconditionMatrix, &AbstractNonlinearElasticitySolver_ComputeJacobian<DIM>, this);
+        // (-2 means assemble at the first opportunity and never again)
+        SNESSetLagJacobian(snes, mUseModifiedNewton ? -2 : (PetscInt)mJacobianLag);
+    }
+    else
+    {
+        SNESSetJacobian(snes, mrJacobianMatrix, this->mPreconditionMatrix, &AbstractNonlinearElasticitySolver_ComputeJacobian<DIM>, this);
+    }
 #if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 4) //PETSc 3.4 or later
     SNESSetType(snes, SNESNEWTONLS);
 #else
@@ -2177,6 +2580,11 @@ void AbstractNonlinearElasticitySolver<DIM>::SolveSnes()
 
     // Set the type of KSP solver (CG, GMRES etc) and preconditioner (ILU, HYPRE, etc)
     SetKspSolverAndPcType(ksp);
+    if (mUseMatrixFreeSnesJacobian && this->mCompressibilityType==COMPRESSIBLE && !mPetscDirectSolve)
+    {
+        // The finite difference operator is not exactly symmetric, so don't use CG with it
+        KSPSetType(ksp, KSPGMRES);
+    }
 
     if (this->mVerbose)
     {
@@ -2200,6 +2608,10 @@ void AbstractNonlinearElasticitySolver<DIM>::SolveSnes()
         err_stream << err;
         PetscTools::Destroy(initial_guess);
         PetscTools::Destroy(snes_residual_vec);
+        if (matrix_free_jacobian)
+        {
+            PetscTools::Destroy(matrix_free_jacobian);
+        }
         SNESDestroy(PETSC_DESTROY_PARAM(snes));
         EXCEPTION("Nonlinear Solver failed. PETSc error code: "+err_stream.str()+" .");
     }
@@ -2210,6 +2622,10 @@ void AbstractNonlinearElasticitySolver<DIM>::SolveSnes()
         reason_stream << reason;
         PetscTools::Destroy(initial_guess);
         PetscTools::Destroy(snes_residual_vec);
+        if (matrix_free_jacobian)
+        {
+            PetscTools::Destroy(matrix_free_jacobian);
+        }
         SNESDestroy(PETSC_DESTROY_PARAM(snes));
         EXCEPTION("Nonlinear Solver did not converge. PETSc reason code: "+reason_stream.str()+" .");
     }
@@ -2219,8 +2635,15 @@ void AbstractNonlinearElasticitySolver<DIM>::SolveSnes()
     SNESGetIterationNumber(snes,&num_iters);
     mNumNewtonIterations = num_iters;
 
+    // SNES has overwritten the Jacobian the non-SNES solver may be reusing
+    mForceJacobianAssembly = true;
+
     PetscTools::Destroy(initial_guess);
     PetscTools::Destroy(snes_residual_vec);
+    if (matrix_free_jacobian)
+    {
+        PetscTools::Destroy(matrix_free_jacobian);
+    }
     SNESDestroy(PETSC_DESTROY_PARAM(snes));
 }
 
@@ -2249,8 +2672,9 @@ void AbstractNonlinearElasticitySolver<DIM>::ComputeJacobian(Vec currentGuess, M
     // We don't have to copy mrJacobianMatrix to pJacobian, which would be expensive, as they will
     // point to the same memory.
 
-    // check Petsc data corresponds to internal Mats
-    assert(mrJacobianMatrix==*pJacobian);
+    // check Petsc data corresponds to internal Mats (in the matrix-free mode the Jacobian is
+    // the finite difference operator set up by SolveSnes())
+    assert(mUseMatrixFreeSnesJacobian || mrJacobianMatrix==*pJacobian);
     assert(this->mPreconditionMatrix==*pPreconditioner);
 
     MechanicsEventHandler::BeginEvent(MechanicsEventHandler::ASSEMBLE);
@@ -2261,6 +2685,13 @@ void AbstractNonlinearElasticitySolver<DIM>::ComputeJacobian(Vec currentGuess, M
     }
 
     AssembleSystem(false,true);
+
+    if (mUseMatrixFreeSnesJacobian)
+    {
+        // Moves the base point of the finite difference operator to the current guess
+        MatAssemblyBegin(*pJacobian, MAT_FINAL_ASSEMBLY);
+        MatAssemblyEnd(*pJacobian, MAT_FINAL_ASSEMBLY);
+    }
     MechanicsEventHandler::EndEvent(MechanicsEventHandler::ASSEMBLE);
 }
 
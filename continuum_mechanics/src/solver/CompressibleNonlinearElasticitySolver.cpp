@@ -48,6 +48,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "CompressibleNonlinearElasticitySolver.hpp"
 #include "LinearBasisFunction.hpp"
 #include "QuadraticBasisFunction.hpp"
+#include "SymmetricFourthOrderTensor.hpp"
 #include <algorithm>
 
 template <size_t DIM>
@@ -58,6 +59,9 @@ void CompressibleNonlinearElasticitySolver<DIM>::AssembleSystem(bool assembleRes
     assert(assembleResidual || assembleJacobian);
     assert(this->mCurrentSolution.size()==this->mNumDofs);
 
+    // Decide whether the cached kinematic quantities can be used in this assembly
+    this->PrepareKinematicsCache();
+
     // Zero the matrix/vector if it is to be assembled
     if (assembleResidual)
     {
@@ -76,24 +80,37 @@ void CompressibleNonlinearElasticitySolver<DIM>::AssembleSystem(bool assembleRes
     c_matrix<double, STENCIL_SIZE, STENCIL_SIZE> a_elem_precond;
     c_vector<double, STENCIL_SIZE> b_elem;
 
-    // Loop over elements
+    std::vector<Element<DIM, DIM>*> owned_elements;
     for (typename AbstractTetrahedralMesh<DIM, DIM>::ElementIterator iter = this->mrQuadMesh.GetElementIteratorBegin();
          iter != this->mrQuadMesh.GetElementIteratorEnd();
          ++iter)
     {
-        Element<DIM, DIM>& element = *iter;
+        if (iter->GetOwnership() == true)
+        {
+            owned_elements.push_back(&(*iter));
+        }
+    }
+
+    // Loop over elements, a batch at a time: the passive stresses for all the
+    // quadrature points of a batch are computed first, then the batch is assembled
+    for (unsigned batch_start=0; batch_start<owned_elements.size(); batch_start+=MATERIAL_LAW_BATCH_SIZE)
+    {
+        unsigned batch_end = std::min(batch_start + MATERIAL_LAW_BATCH_SIZE, (unsigned)owned_elements.size());
+        ComputeStressesForElements(owned_elements, batch_start, batch_end, assembleJacobian);
 
-        if (element.GetOwnership() == true)
+        for (unsigned element_number=batch_start; element_number<batch_end; element_number++)
         {
+            Element<DIM, DIM>& element = *owned_elements[element_number];
+
             // LCOV_EXCL_START
             // note: if assembleJacobian only
             if (CommandLineArguments::Instance()->OptionExists("-mech_very_verbose") && assembleJacobian)
             {
-                std::cout << "\r[" << PetscTools::GetMyRank() << "]: Element " << (*iter).GetIndex() << " of " << this->mrQuadMesh.GetNumElements() << std::flush;
+                std::cout << "\r[" << PetscTools::GetMyRank() << "]: Element " << element.GetIndex() << " of " << this->mrQuadMesh.GetNumElements() << std::flush;
             }
             // LCOV_EXCL_STOP
 
-            AssembleOnElement(element, a_elem, a_elem_precond, b_elem, assembleResidual, assembleJacobian);
+            AssembleOnElement(element, a_elem, a_elem_precond, b_elem, assembleResidual, assembleJacobian, element_number-batch_start);
 
             //// todo: assemble quickly by commenting the AssembleOnElement() and doing
             //// the following, to determine exact non-zeroes per row, and reallocate
@@ -171,6 +188,133 @@ void CompressibleNonlinearElasticitySolver<DIM>::AssembleSystem(bool assembleRes
     this->FinishAssembleSystem(assembleResidual, assembleJacobian);
 }
 
+template <size_t DIM>
+void CompressibleNonlinearElasticitySolver<DIM>::ComputeStressesForElements(
+            const std::vector<Element<DIM, DIM>*>& rElements,
+            unsigned batchStart,
+            unsigned batchEnd,
+            bool computeDTdE)
+{
+    const unsigned num_quad_points = this->mpQuadratureRule->GetNumQuadPoints();
+    const unsigned num_points = (batchEnd - batchStart)*num_quad_points;
+    if (mBatchF.size() < num_points)
+    {
+        mBatchF.resize(num_points);
+        mBatchC.resize(num_points);
+        mBatchInvC.resize(num_points);
+        mBatchChangeOfBasis.resize(num_points);
+        mBatchT.resize(num_points);
+    }
+    if (computeDTdE && mBatchDTdE.size() < num_points)
+    {
+        mBatchDTdE.resize(num_points);
+    }
+
+    static c_matrix<double,DIM,DIM> jacobian;
+    static c_matrix<double,DIM,DIM> inverse_jacobian;
+    double jacobian_determinant;
+
+    static c_matrix<double,DIM,NUM_NODES_PER_ELEMENT> element_current_displacements;
+    static c_matrix<double, DIM, NUM_NODES_PER_ELEMENT> grad_quad_phi;
+    static c_matrix<double,DIM,DIM> grad_u; // grad_u = (du_i/dX_M)
+
+    for (unsigned element_number=batchStart; element_number<batchEnd; element_number++)
+    {
+        Element<DIM, DIM>& r_element = *rElements[element_number];
+        if (!this->mKinematicsCacheIsCurrent)
+        {
+            this->mrQuadMesh.GetInverseJacobianForElement(r_element.GetIndex(), jacobian, jacobian_determinant, inverse_jacobian);
+
+            // Get the current displacement at the nodes
+            for (unsigned II=0; II<NUM_NODES_PER_ELEMENT; II++)
+            {
+                for (unsigned JJ=0; JJ<DIM; JJ++)
+                {
+                    element_current_displacements(JJ,II) = this->mCurrentSolution[DIM*r_element.GetNodeGlobalIndex(II) + JJ];
+                }
+            }
+        }
+
+        for (unsigned quadrature_index=0; quadrature_index < num_quad_points; quadrature_index++)
+        {
+            unsigned batch_point = (element_number - batchStart)*num_quad_points + quadrature_index;
+
+            // This is needed by the cardiac mechanics solver
+            unsigned current_quad_point_global_index = r_element.GetIndex()*num_quad_points + quadrature_index;
+
+            if (this->mKinematicsCacheIsCurrent)
+            {
+                mBatchF[batch_point] = this->mCachedF[current_quad_point_global_index];
+                mBatchC[batch_point] = this->mCachedC[current_quad_point_global_index];
+                mBatchInvC[batch_point] = this->mCachedInvC[current_quad_point_global_index];
+            }
+            else
+            {
+                const ChastePoint<DIM>& quadrature_point = this->mpQuadratureRule->rGetQuadPoint(quadrature_index);
+                QuadraticBasisFunction<DIM>::ComputeTransformedBasisFunctionDerivatives(quadrature_point, inverse_jacobian, grad_quad_phi);
+
+                // Interpolate grad_u
+                grad_u = zero_matrix<double>(DIM,DIM);
+                for (unsigned node_index=0; node_index<NUM_NODES_PER_ELEMENT; node_index++)
+                {
+                    for (unsigned i=0; i<DIM; i++)
+                    {
+                        for (unsigned M=0; M<DIM; M++)
+                        {
+                            grad_u(i,M) += grad_quad_phi(M,node_index)*element_current_displacements(i,node_index);
+                        }
+                    }
+                }
+
+                // Calculate F, C and inv(C)
+                c_matrix<double,DIM,DIM>& r_F = mBatchF[batch_point];
+                for (unsigned i=0; i<DIM; i++)
+                {
+                    for (unsigned M=0; M<DIM; M++)
+                    {
+                        r_F(i,M) = (i==M?1:0) + grad_u(i,M);
+                    }
+                }
+                mBatchC[batch_point] = TransposeProduct(r_F);
+                mBatchInvC[batch_point] = Inverse(mBatchC[batch_point]);
+
+                if (this->mUseKinematicsCache)
+                {
+                    this->mCachedF[current_quad_point_global_index] = r_F;
+                    this->mCachedC[current_quad_point_global_index] = mBatchC[batch_point];
+                    this->mCachedInvC[current_quad_point_global_index] = mBatchInvC[batch_point];
+                    this->mCachedInvF[current_quad_point_global_index] = Inverse(r_F);
+                    this->mCachedDetF[current_quad_point_global_index] = Determinant(r_F);
+                }
+            }
+
+            this->SetupChangeOfBasisMatrix(r_element.GetIndex(), current_quad_point_global_index);
+            mBatchChangeOfBasis[batch_point] = this->mChangeOfBasisMatrix;
+        }
+    }
+
+    // Compute the passive stresses, and dTdE corresponding to passive stresses
+    static const std::vector<double> zero_pressures;
+    unsigned run_start = batchStart;
+    while (run_start < batchEnd)
+    {
+        AbstractCompressibleMaterialLaw<DIM>* p_material_law
+           = this->mrProblemDefinition.GetCompressibleMaterialLaw(rElements[run_start]->GetIndex());
+        unsigned run_end = run_start + 1;
+        while (run_end < batchEnd
+               && this->mrProblemDefinition.GetCompressibleMaterialLaw(rElements[run_end]->GetIndex()) == p_material_law)
+        {
+            run_end++;
+        }
+
+        p_material_law->ComputeStressesAndStressDerivatives((run_start - batchStart)*num_quad_points,
+                                                            (run_end - run_start)*num_quad_points,
+                                                            mBatchC, mBatchInvC, zero_pressures, &mBatchChangeOfBasis,
+                                                            mBatchT, mBatchDTdE, computeDTdE, mNumMaterialLawThreads);
+        run_start = run_end;
+    }
+}
+
 template <size_t DIM>
 void CompressibleNonlinearElasticitySolver<DIM>::AssembleOnElement(
             Element<DIM, DIM>& rElement,
@@ -178,7 +322,8 @@ void CompressibleNonlinearElasticitySolver<DIM>::AssembleOnElement(
             c_matrix<double, STENCIL_SIZE, STENCIL_SIZE >& rAElemPrecond,
             c_vector<double, STENCIL_SIZE>& rBElem,
             bool assembleResidual,
-            bool assembleJacobian)
+            bool assembleJacobian,
+            unsigned batchIndex)
 {
     static c_matrix<double,DIM,DIM> jacobian;
     static c_matrix<double,DIM,DIM> inverse_jacobian;
@@ -197,45 +342,22 @@ void CompressibleNonlinearElasticitySolver<DIM>::AssembleOnElement(
         rBElem.clear();
     }
 
-    // Get the current displacement at the nodes
-    static c_matrix<double,DIM,NUM_NODES_PER_ELEMENT> element_current_displacements;
-    for (unsigned II=0; II<NUM_NODES_PER_ELEMENT; II++)
-    {
-        for (unsigned JJ=0; JJ<DIM; JJ++)
-        {
-            element_current_displacements(JJ,II) = this->mCurrentSolution[DIM*rElement.GetNodeGlobalIndex(II) + JJ];
-        }
-    }
-
     // Allocate memory for the basis functions values and derivative values
     static c_vector<double, NUM_VERTICES_PER_ELEMENT> linear_phi;
     static c_vector<double, NUM_NODES_PER_ELEMENT> quad_phi;
     static c_matrix<double, DIM, NUM_NODES_PER_ELEMENT> grad_quad_phi;
     static c_matrix<double, NUM_NODES_PER_ELEMENT, DIM> trans_grad_quad_phi;
 
-    // Get the material law
-    AbstractCompressibleMaterialLaw<DIM>* p_material_law
-       = this->mrProblemDefinition.GetCompressibleMaterialLaw(rElement.GetIndex());
-
-
-    static c_matrix<double,DIM,DIM> grad_u; // grad_u = (du_i/dX_M)
-
-    static c_matrix<double,DIM,DIM> F;      // the deformation gradient, F = dx/dX, F_{iM} = dx_i/dX_M
-    static c_matrix<double,DIM,DIM> C;      // Green deformation tensor, C = F^T F
-    static c_matrix<double,DIM,DIM> inv_C;  // inverse(C)
     static c_matrix<double,DIM,DIM> inv_F;  // inverse(F)
-    static c_matrix<double,DIM,DIM> T;      // Second Piola-Kirchoff stress tensor (= dW/dE = 2dW/dC)
 
     static c_matrix<double,DIM,DIM> F_T;    // F*T
     static c_matrix<double,DIM,NUM_NODES_PER_ELEMENT> F_T_grad_quad_phi; // F*T*grad_quad_phi
 
     c_vector<double,DIM> body_force;
 
-    static FourthOrderTensor<DIM,DIM,DIM,DIM> dTdE;    // dTdE(M,N,P,Q) = dT_{MN}/dE_{PQ}
-    static FourthOrderTensor<DIM,DIM,DIM,DIM> dSdF;    // dSdF(M,i,N,j) = dS_{Mi}/dF_{jN}
-
-    static FourthOrderTensor<NUM_NODES_PER_ELEMENT,DIM,DIM,DIM> temp_tensor;
-    static FourthOrderTensor<NUM_NODES_PER_ELEMENT,DIM,NUM_NODES_PER_ELEMENT,DIM> dSdF_quad_quad;
+    static FourthOrderTensor<DIM,DIM,DIM,DIM> unused_dTdE; // passed on if dTdE is not required
+    static SymmetricFourthOrderTensor<DIM> dTdE_sym;   // dTdE symmetrised in (M,N) and (P,Q)
+    static c_matrix<double,DIM*NUM_NODES_PER_ELEMENT,DIM*NUM_NODES_PER_ELEMENT> dSdF_grad_grad; // dSdF contracted with grad_quad_phi twice
 
     static c_matrix<double, DIM, NUM_NODES_PER_ELEMENT> temp_matrix;
     static c_matrix<double,NUM_NODES_PER_ELEMENT,DIM> grad_quad_phi_times_invF;
@@ -288,36 +410,14 @@ void CompressibleNonlinearElasticitySolver<DIM>::AssembleOnElement(
             }
         }
 
-        // Interpolate grad_u
-        grad_u = zero_matrix<double>(DIM,DIM);
-        for (unsigned node_index=0; node_index<NUM_NODES_PER_ELEMENT; node_index++)
-        {
-            for (unsigned i=0; i<DIM; i++)
-            {
-                for (unsigned M=0; M<DIM; M++)
-                {
-                    grad_u(i,M) += grad_quad_phi(M,node_index)*element_current_displacements(i,node_index);
-                }
-            }
-        }
-
-        // Calculate C, inv(C) and T
-        for (unsigned i=0; i<DIM; i++)
-        {
-            for (unsigned M=0; M<DIM; M++)
-            {
-                F(i,M) = (i==M?1:0) + grad_u(i,M);
-            }
-        }
-
-        C = prod(trans(F),F);
-        inv_C = Inverse(C);
-        inv_F = Inverse(F);
-
-        // Compute the passive stress, and dTdE corresponding to passive stress
-        this->SetupChangeOfBasisMatrix(rElement.GetIndex(), current_quad_point_global_index);
-        p_material_law->SetChangeOfBasisMatrix(this->mChangeOfBasisMatrix);
-        p_material_law->ComputeStressAndStressDerivative(C, inv_C, 0.0, T, dTdE, assembleJacobian);
+        // F, C and the passive stress T (and dTdE corresponding to the passive stress)
+        // have already been computed by ComputeStressesForElements()
+        unsigned batch_point = batchIndex*this->mpQuadratureRule->GetNumQuadPoints() + quadrature_index;
+        const c_matrix<double,DIM,DIM>& F = mBatchF[batch_point];  // the deformation gradient, F = dx/dX, F_{iM} = dx_i/dX_M
+        c_matrix<double,DIM,DIM>& C = mBatchC[batch_point];        // Green deformation tensor, C = F^T F
+        c_matrix<double,DIM,DIM>& T = mBatchT[batch_point];        // Second Piola-Kirchoff stress tensor (= dW/dE = 2dW/dC)
+        FourthOrderTensor<DIM,DIM,DIM,DIM>& dTdE = assembleJacobian ? mBatchDTdE[batch_point] : unused_dTdE; // dTdE(M,N,P,Q) = dT_{MN}/dE_{PQ}
+        this->mChangeOfBasisMatrix = mBatchChangeOfBasis[batch_point];
 
         if (this->mIncludeActiveTension)
         {
@@ -358,81 +458,33 @@ void CompressibleNonlinearElasticitySolver<DIM>::AssembleOnElement(
         if (assembleJacobian)
         {
             // Save trans(grad_quad_phi) * invF
+            // (inverse(F) is already in the kinematics cache, if there is one)
+            inv_F = this->mUseKinematicsCache ? this->mCachedInvF[current_quad_point_global_index] : Inverse(F);
             grad_quad_phi_times_invF = prod(trans_grad_quad_phi, inv_F);
 
             /////////////////////////////////////////////////////////////////////////////////////////////
-            // Set up the tensor dSdF
+            // Set up the matrix
+            //   dSdF_grad_grad(DIM*node_index1 + spatial_dim1, DIM*node_index2 + spatial_dim2)
+            //            =    dS_{M,spatial_dim1}/d_F{spatial_dim2,N}
+            //               * grad_quad_phi(M,node_index1)
+            //               * grad_quad_phi(N,node_index2)
             //
-            // dSdF as a function of T and dTdE (which is what the material law returns) is given by:
+            // where dSdF as a function of T and dTdE (which is what the material law returns) is given by:
             //
             // dS_{Mi}/dF_{jN} = (dT_{MN}/dC_{PQ}+dT_{MN}/dC_{PQ}) F{iP} F_{jQ}  + T_{MN} delta_{ij}
             //
-            // todo1: this should probably move into the material law (but need to make sure
-            // memory is handled efficiently
-            // todo2: get material law to return this immediately, not dTdE
+            // dTdE is first reduced to its symmetric part in (M,N) and (P,Q), which is all that
+            // contributes, so the contraction can be done on Voigt form.
             /////////////////////////////////////////////////////////////////////////////////////////////
-
-            // Set up the tensor 0.5(dTdE(M,N,P,Q) + dTdE(M,N,Q,P))
-            for (unsigned M=0; M<DIM; M++)
-            {
-                for (unsigned N=0; N<DIM; N++)
-                {
-                    for (unsigned P=0; P<DIM; P++)
-                    {
-                        for (unsigned Q=0; Q<DIM; Q++)
-                        {
-                            // this is NOT dSdF, just using this as storage space
-                            dSdF(M,N,P,Q) = 0.5*(dTdE(M,N,P,Q) + dTdE(M,N,Q,P));
-                        }
-                    }
-                }
-            }
-
-            // This is NOT dTdE, just reusing memory. A^{MdPQ}  = F^d_N * dTdE_sym^{MNPQ}
-            dTdE.template SetAsContractionOnSecondDimension<DIM>(F, dSdF);
-
-            // dSdF{MdPe} := F^d_N * F^e_Q * dTdE_sym^{MNPQ}
-            dSdF.template SetAsContractionOnFourthDimension<DIM>(F, dTdE);
-
-            // Now add the T_{MN} delta_{ij} term
-            for (unsigned M=0; M<DIM; M++)
-            {
-                for (unsigned N=0; N<DIM; N++)
-                {
-                    for (unsigned i=0; i<DIM; i++)
-                    {
-                        dSdF(M,i,N,i) += T(M,N);
-                    }
-                }
-            }
-
-            ///////////////////////////////////////////////////////
-            // Set up the tensor
-            //   dSdF_quad_quad(node_index1, spatial_dim1, node_index2, spatial_dim2)
-            //            =    dS_{M,spatial_dim1}/d_F{spatial_dim2,N}
-            //               * grad_quad_phi(M,node_index1)
-            //               * grad_quad_phi(P,node_index2)
-            //
-            //            =    dSdF(M,spatial_index1,N,spatial_index2)
-            //               * grad_quad_phi(M,node_index1)
-            //               * grad_quad_phi(P,node_index2)
-            //
-            ///////////////////////////////////////////////////////
-            temp_tensor.template SetAsContractionOnFirstDimension<DIM>(trans_grad_quad_phi, dSdF);
-            dSdF_quad_quad.template SetAsContractionOnThirdDimension<DIM>(trans_grad_quad_phi, temp_tensor);
+            dTdE_sym.SetAsSymmetrisation(dTdE);
+            dTdE_sym.template ComputeContractionWithBasisGradients<NUM_NODES_PER_ELEMENT>(F, T, grad_quad_phi, dSdF_grad_grad);
 
             for (unsigned index1=0; index1<NUM_NODES_PER_ELEMENT*DIM; index1++)
             {
-                unsigned spatial_dim1 = index1%DIM;
-                unsigned node_index1 = (index1-spatial_dim1)/DIM;
-
                 for (unsigned index2=0; index2<NUM_NODES_PER_ELEMENT*DIM; index2++)
                 {
-                    unsigned spatial_dim2 = index2%DIM;
-                    unsigned node_index2 = (index2-spatial_dim2)/DIM;
-
                     // The dSdF*grad_quad_phi*grad_quad_phi term
-                    rAElem(index1,index2) +=   dSdF_quad_quad(node_index1,spatial_dim1,node_index2,spatial_dim2)
+                    rAElem(index1,index2) +=   dSdF_grad_grad(index1,index2)
                                              * wJ;
                 }
             }
@@ -461,7 +513,8 @@ CompressibleNonlinearElasticitySolver<DIM>::CompressibleNonlinearElasticitySolve
     : AbstractNonlinearElasticitySolver<DIM>(rQuadMesh,
                                              rProblemDefinition,
                                              outputDirectory,
-                                             COMPRESSIBLE)
+                                             COMPRESSIBLE),
+      mNumMaterialLawThreads(1u)
 {
     if (rProblemDefinition.GetCompressibilityType() != COMPRESSIBLE)
     {
@@ -474,6 +527,16 @@ CompressibleNonlinearElasticitySolver<DIM>::~CompressibleNonlinearElasticitySolv
 {
 }
 
+template <size_t DIM>
+void CompressibleNonlinearElasticitySolver<DIM>::SetNumberOfMaterialLawThreads(unsigned numThreads)
+{
+    if (numThreads == 0u)
+    {
+        EXCEPTION("The number of material law threads must be at least one.");
+    }
+    mNumMaterialLawThreads = numThreads;
+}
+
 // Explicit instantiation
 template class CompressibleNonlinearElasticitySolver<2>;
 template class CompressibleNonlinearElasticitySolver<3>;
@@ -86,6 +86,47 @@ protected:
     /** Boundary stencil size. */
     static const size_t BOUNDARY_STENCIL_SIZE = DIM*NUM_NODES_PER_BOUNDARY_ELEMENT;
 
+    /** Number of elements whose quadrature point stresses are computed together. */
+    static const unsigned MATERIAL_LAW_BATCH_SIZE = 64u;
+
+    /** Number of threads the material law may use; see SetNumberOfMaterialLawThreads(). */
+    unsigned mNumMaterialLawThreads;
+
+    /** Deformation gradient F at each quadrature point of the current batch of elements. */
+    std::vector<c_matrix<double,DIM,DIM> > mBatchF;
+
+    /** Deformation tensor C = F^T F at each quadrature point of the current batch of elements. */
+    std::vector<c_matrix<double,DIM,DIM> > mBatchC;
+
+    /** Inverse of C at each quadrature point of the current batch of elements. */
+    std::vector<c_matrix<double,DIM,DIM> > mBatchInvC;
+
+    /** Change of basis matrix at each quadrature point of the current batch of elements. */
+    std::vector<c_matrix<double,DIM,DIM> > mBatchChangeOfBasis;
+
+    /** Passive stress T at each quadrature point of the current batch of elements. */
+    std::vector<c_matrix<double,DIM,DIM> > mBatchT;
+
+    /**
+     * Passive stress derivative dT/dE at each quadrature point of the current batch of
+     * elements. Only allocated once the Jacobian is assembled.
+     */
+    std::vector<FourthOrderTensor<DIM,DIM,DIM,DIM> > mBatchDTdE;
+
+    /**
+     * Compute F, C and the passive stress (and, if required, stress derivative) at all
+     * the quadrature points of a batch of elements, storing them in mBatchF etc. The
+     * material law is called once for each run of consecutive elements with the same law.
+     *
+     * @param rElements The elements
+     * @param batchStart Index in rElements of the first element of the batch
+     * @param batchEnd One past the index in rElements of the last element of the batch
+     * @param computeDTdE Whether to compute the stress derivatives
+     */
+    void ComputeStressesForElements(const std::vector<Element<DIM, DIM>*>& rElements,
+                                    unsigned batchStart,
+                                    unsigned batchEnd,
+                                    bool computeDTdE);
 
     /**
      * Assemble residual or Jacobian on an element, using the current solution
@@ -103,13 +144,16 @@ protected:
      *     need to zero this vector before calling.
      * @param assembleResidual A bool stating whether to assemble the residual vector.
      * @param assembleJacobian A bool stating whether to assemble the Jacobian matrix.
+     * @param batchIndex The position of the element in the batch last passed to
+     *     ComputeStressesForElements(), which has computed its passive stresses.
      */
     virtual void AssembleOnElement(Element<DIM, DIM>& rElement,
                                    c_matrix<double, STENCIL_SIZE, STENCIL_SIZE >& rAElem,
                                    c_matrix<double, STENCIL_SIZE, STENCIL_SIZE >& rAElemPrecond,
                                    c_vector<double, STENCIL_SIZE>& rBElem,
                                    bool assembleResidual,
-                                   bool assembleJacobian);
+                                   bool assembleJacobian,
+                                   unsigned batchIndex);
 
     /**
      * Assemble the residual vector (using the current solution stored
@@ -137,6 +181,16 @@ public:
 
     /** Destructor. */
     virtual ~CompressibleNonlinearElasticitySolver();
+
+    /**
+     * Set the number of threads used to evaluate the material law at the quadrature
+     * points (see AbstractMaterialLaw::ComputeStressesAndStressDerivatives()). Only has
+     * an effect if Chaste was built with OpenMP and the material law is thread safe.
+     * Defaults to 1.
+     *
+     * @param numThreads The number of threads
+     */
+    void SetNumberOfMaterialLawThreads(unsigned numThreads);
 };
 
 #endif /*COMPRESSIBLENONLINEARELASTICITYSOLVER_HPP_*/
@@ -46,6 +46,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "IncompressibleNonlinearElasticitySolver.hpp"
 #include "LinearBasisFunction.hpp"
 #include "QuadraticBasisFunction.hpp"
+#include "SymmetricFourthOrderTensor.hpp"
 #include <algorithm>
 
 template <size_t DIM>
@@ -56,6 +57,9 @@ void IncompressibleNonlinearElasticitySolver<DIM>::AssembleSystem(bool assembleR
     assert(assembleResidual || assembleJacobian);
     assert(this->mCurrentSolution.size()==this->mNumDofs);
 
+    // Decide whether the cached kinematic quantities can be used in this assembly
+    this->PrepareKinematicsCache();
+
     // Zero the matrix/vector if it is to be assembled
     if (assembleResidual)
     {
@@ -279,10 +283,8 @@ void IncompressibleNonlinearElasticitySolver<DIM>::AssembleOnElement(
     c_vector<double,DIM> body_force;
 
     static FourthOrderTensor<DIM,DIM,DIM,DIM> dTdE;    // dTdE(M,N,P,Q) = dT_{MN}/dE_{PQ}
-    static FourthOrderTensor<DIM,DIM,DIM,DIM> dSdF;    // dSdF(M,i,N,j) = dS_{Mi}/dF_{jN}
-
-    static FourthOrderTensor<NUM_NODES_PER_ELEMENT,DIM,DIM,DIM> temp_tensor;
-    static FourthOrderTensor<NUM_NODES_PER_ELEMENT,DIM,NUM_NODES_PER_ELEMENT,DIM> dSdF_quad_quad;
+    static SymmetricFourthOrderTensor<DIM> dTdE_sym;   // dTdE symmetrised in (M,N) and (P,Q)
+    static c_matrix<double,DIM*NUM_NODES_PER_ELEMENT,DIM*NUM_NODES_PER_ELEMENT> dSdF_grad_grad; // dSdF contracted with grad_quad_phi twice
 
     static c_matrix<double, DIM, NUM_NODES_PER_ELEMENT> temp_matrix;
     static c_matrix<double,NUM_NODES_PER_ELEMENT,DIM> grad_quad_phi_times_invF;
@@ -336,41 +338,62 @@ void IncompressibleNonlinearElasticitySolver<DIM>::AssembleOnElement(
             }
         }
 
-        // Interpolate grad_u and p
-        grad_u = zero_matrix<double>(DIM,DIM);
+        // Interpolate p
+        double pressure = 0;
+        for (unsigned vertex_index=0; vertex_index<NUM_VERTICES_PER_ELEMENT; vertex_index++)
+        {
+            pressure += linear_phi(vertex_index)*element_current_pressures(vertex_index);
+        }
 
-        for (unsigned node_index=0; node_index<NUM_NODES_PER_ELEMENT; node_index++)
+        double detF;
+        if (this->mKinematicsCacheIsCurrent)
         {
+            F = this->mCachedF[current_quad_point_global_index];
+            C = this->mCachedC[current_quad_point_global_index];
+            inv_C = this->mCachedInvC[current_quad_point_global_index];
+            inv_F = this->mCachedInvF[current_quad_point_global_index];
+            detF = this->mCachedDetF[current_quad_point_global_index];
+        }
+        else
+        {
+            // Interpolate grad_u
+            grad_u = zero_matrix<double>(DIM,DIM);
+
+            for (unsigned node_index=0; node_index<NUM_NODES_PER_ELEMENT; node_index++)
+            {
+                for (unsigned i=0; i<DIM; i++)
+                {
+                    for (unsigned M=0; M<DIM; M++)
+                    {
+                        grad_u(i,M) += grad_quad_phi(M,node_index)*element_current_displacements(i,node_index);
+                    }
+                }
+            }
+
+            // Calculate F, C, inv(C), inv(F) and det(F)
             for (unsigned i=0; i<DIM; i++)
             {
                 for (unsigned M=0; M<DIM; M++)
                 {
-                    grad_u(i,M) += grad_quad_phi(M,node_index)*element_current_displacements(i,node_index);
+                    F(i,M) = (i==M?1:0) + grad_u(i,M);
                 }
             }
-        }
 
-        double pressure = 0;
-        for (unsigned vertex_index=0; vertex_index<NUM_VERTICES_PER_ELEMENT; vertex_index++)
-        {
-            pressure += linear_phi(vertex_index)*element_current_pressures(vertex_index);
-        }
+            C = TransposeProduct(F);
+            inv_C = Inverse(C);
+            inv_F = Inverse(F);
+            detF = Determinant(F);
 
-        // Calculate C, inv(C) and T
-        for (unsigned i=0; i<DIM; i++)
-        {
-            for (unsigned M=0; M<DIM; M++)
+            if (this->mUseKinematicsCache)
             {
-                F(i,M) = (i==M?1:0) + grad_u(i,M);
+                this->mCachedF[current_quad_point_global_index] = F;
+                this->mCachedC[current_quad_point_global_index] = C;
+                this->mCachedInvC[current_quad_point_global_index] = inv_C;
+                this->mCachedInvF[current_quad_point_global_index] = inv_F;
+                this->mCachedDetF[current_quad_point_global_index] = detF;
             }
         }
 
-        C = prod(trans(F),F);
-        inv_C = Inverse(C);
-        inv_F = Inverse(F);
-
-        double detF = Determinant(F);
-
         // Compute the passive stress, and dTdE corresponding to passive stress
         this->SetupChangeOfBasisMatrix(rElement.GetIndex(), current_quad_point_global_index);
         p_material_law->SetChangeOfBasisMatrix(this->mChangeOfBasisMatrix);
@@ -425,65 +448,21 @@ void IncompressibleNonlinearElasticitySolver<DIM>::AssembleOnElement(
             grad_quad_phi_times_invF = prod(trans_grad_quad_phi, inv_F);
 
             /////////////////////////////////////////////////////////////////////////////////////////////
-            // Set up the tensor dSdF
+            // Set up the matrix
+            //   dSdF_grad_grad(DIM*node_index1 + spatial_dim1, DIM*node_index2 + spatial_dim2)
+            //            =    dS_{M,spatial_dim1}/d_F{spatial_dim2,N}
+            //               * grad_quad_phi(M,node_index1)
+            //               * grad_quad_phi(N,node_index2)
             //
-            // dSdF as a function of T and dTdE (which is what the material law returns) is given by:
+            // where dSdF as a function of T and dTdE (which is what the material law returns) is given by:
             //
             // dS_{Mi}/dF_{jN} = (dT_{MN}/dC_{PQ}+dT_{MN}/dC_{PQ}) F{iP} F_{jQ}  + T_{MN} delta_{ij}
             //
-            // todo1: this should probably move into the material law (but need to make sure
-            // memory is handled efficiently
-            // todo2: get material law to return this immediately, not dTdE
+            // dTdE is first reduced to its symmetric part in (M,N) and (P,Q), which is all that
+            // contributes, so the contraction can be done on Voigt form.
             /////////////////////////////////////////////////////////////////////////////////////////////
-
-            // Set up the tensor 0.5(dTdE(M,N,P,Q) + dTdE(M,N,Q,P))
-            for (unsigned M=0; M<DIM; M++)
-            {
-                for (unsigned N=0; N<DIM; N++)
-                {
-                    for (unsigned P=0; P<DIM; P++)
-                    {
-                        for (unsigned Q=0; Q<DIM; Q++)
-                        {
-                            // This is NOT dSdF, just using this as storage space
-                            dSdF(M,N,P,Q) = 0.5*(dTdE(M,N,P,Q) + dTdE(M,N,Q,P));
-                        }
-                    }
-                }
-            }
-
-            // This is NOT dTdE, just reusing memory. A^{MdPQ}  = F^d_N * dTdE_sym^{MNPQ}
-            dTdE.template SetAsContractionOnSecondDimension<DIM>(F, dSdF);
-
-            // dSdF{MdPe} := F^d_N * F^e_Q * dTdE_sym^{MNPQ}
-            dSdF.template SetAsContractionOnFourthDimension<DIM>(F, dTdE);
-
-            // Now add the T_{MN} delta_{ij} term
-            for (unsigned M=0; M<DIM; M++)
-            {
-                for (unsigned N=0; N<DIM; N++)
-                {
-                    for (unsigned i=0; i<DIM; i++)
-                    {
-                        dSdF(M,i,N,i) += T(M,N);
-                    }
-                }
-            }
-
-            ///////////////////////////////////////////////////////
-            // Set up the tensor
-            //   dSdF_quad_quad(node_index1, spatial_dim1, node_index2, spatial_dim2)
-            //            =    dS_{M,spatial_dim1}/d_F{spatial_dim2,N}
-            //               * grad_quad_phi(M,node_index1)
-            //               * grad_quad_phi(P,node_index2)
-            //
-            //            =    dSdF(M,spatial_index1,N,spatial_index2)
-            //               * grad_quad_phi(M,node_index1)
-            //               * grad_quad_phi(P,node_index2)
-            //
-            ///////////////////////////////////////////////////////
-            temp_tensor.template SetAsContractionOnFirstDimension<DIM>( trans_grad_quad_phi, dSdF );
-            dSdF_quad_quad.template SetAsContractionOnThirdDimension<DIM>( trans_grad_quad_phi, temp_tensor );
+            dTdE_sym.SetAsSymmetrisation(dTdE);
+            dTdE_sym.template ComputeContractionWithBasisGradients<NUM_NODES_PER_ELEMENT>(F, T, grad_quad_phi, dSdF_grad_grad);
 
             for (unsigned index1=0; index1<NUM_NODES_PER_ELEMENT*DIM; index1++)
             {
@@ -493,11 +472,8 @@ void IncompressibleNonlinearElasticitySolver<DIM>::AssembleOnElement(
 
                 for (unsigned index2=0; index2<NUM_NODES_PER_ELEMENT*DIM; index2++)
                 {
-                    unsigned spatial_dim2 = index2%DIM;
-                    unsigned node_index2 = (index2-spatial_dim2)/DIM;
-
                     // The dSdF*grad_quad_phi*grad_quad_phi term
-                    rAElem(index1,index2)  +=   dSdF_quad_quad(node_index1,spatial_dim1,node_index2,spatial_dim2)
+                    rAElem(index1,index2)  +=   dSdF_grad_grad(index1,index2)
                                               * wJ;
                 }
 
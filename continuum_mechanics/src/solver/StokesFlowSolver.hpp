@@ -193,7 +193,7 @@ void StokesFlowSolver<DIM>::Solve()
     PetscVecTools::Zero(solution);
 
     KSP solver;
-    KSPCreate(PETSC_COMM_WORLD,&solver);
+    KSPCreate(PetscTools::GetWorld(),&solver);
 #if ((PETSC_VERSION_MAJOR==3) && (PETSC_VERSION_MINOR>=5))
     KSPSetOperators(solver, this->mSystemLhsMatrix, this->mPreconditionMatrix);
 #else
@@ -215,7 +215,17 @@ void StokesFlowSolver<DIM>::Solve()
 
     PC pc;
     KSPGetPC(solver, &pc);
-    PCSetType(pc, PCJACOBI);
+    if (this->mUseFieldSplitPreconditioner)
+    {
+        this->SetUpFieldSplitPreconditioner(pc);
+
+        // So that the field split sub-solver options are picked up when setting up
+        KSPSetFromOptions(solver);
+    }
+    else
+    {
+        PCSetType(pc, PCJACOBI);
+    }
 
     KSPSetUp(solver);
 
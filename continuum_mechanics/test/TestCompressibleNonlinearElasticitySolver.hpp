@@ -780,6 +780,112 @@ public:
         TS_ASSERT_DELTA(r_solution[5](1), 0.0021, 1e-4);
     }
 
+    /**
+     * Same problem as TestSolveForSimpleDeformationWithExponentialLaw, solved reusing
+     * the Jacobian between Newton iterations and with adaptive linear solve tolerances.
+     */
+    void TestSolveWithJacobianReuse()
+    {
+        unsigned num_elem = 5;
+
+        QuadraticMesh<2> mesh(1.0/num_elem, 1.0, 1.0);
+        CompressibleExponentialLaw<2> law;
+
+        std::vector<unsigned> fixed_nodes = NonlinearElasticityTools<2>::GetNodesByComponentValue(mesh,0,0);
+
+        SolidMechanicsProblemDefinition<2> problem_defn(mesh);
+        problem_defn.SetMaterialLaw(COMPRESSIBLE,&law);
+        problem_defn.SetZeroDisplacementNodes(fixed_nodes);
+
+        c_vector<double,2> gravity;
+        gravity(0) = 2.0;
+        gravity(1) = 0.0;
+        problem_defn.SetBodyForce(gravity);
+
+        PetscTools::SetOption("-pc_type","jacobi");
+
+        // Modified Newton, with Eisenstat-Walker tolerances
+        {
+            CompressibleNonlinearElasticitySolver<2> solver(mesh,
+                                                            problem_defn,
+                                                            "CompressibleExponentialLawModifiedNewton");
+            solver.SetUseModifiedNewton();
+            solver.SetUseEisenstatWalkerKspTolerance();
+            solver.Solve();
+
+            // Newton's method takes 4 iterations
+            TS_ASSERT_LESS_THAN_EQUALS(4u, solver.GetNumNewtonIterations());
+
+            std::vector<c_vector<double,2> >& r_solution = solver.rGetDeformedPosition();
+            TS_ASSERT_DELTA(r_solution[5](0), 1.0360, 1e-4);
+            TS_ASSERT_DELTA(r_solution[5](1), 0.0021, 1e-4);
+        }
+
+        // Jacobian reassembled every other iteration, and reused in a second solve
+        {
+            CompressibleNonlinearElasticitySolver<2> solver(mesh,
+                                                            problem_defn,
+                                                            "CompressibleExponentialLawJacobianLag");
+            solver.SetJacobianLag(2);
+            solver.Solve();
+
+            std::vector<c_vector<double,2> >& r_solution = solver.rGetDeformedPosition();
+            TS_ASSERT_DELTA(r_solution[5](0), 1.0360, 1e-4);
+            TS_ASSERT_DELTA(r_solution[5](1), 0.0021, 1e-4);
+
+            // A larger load, solved starting with the old Jacobian
+            gravity(0) = 2.5;
+            problem_defn.SetBodyForce(gravity);
+            solver.Solve();
+            TS_ASSERT_LESS_THAN(1.0360, solver.rGetDeformedPosition()[5](0));
+        }
+
+        // Caching the kinematics at the quadrature points between assemblies doesn't change the solve
+        {
+            CompressibleNonlinearElasticitySolver<2> solver(mesh,
+                                                            problem_defn,
+                                                            "CompressibleExponentialLawNoKinematicsCache");
+            solver.Solve();
+
+            CompressibleNonlinearElasticitySolver<2> cached_solver(mesh,
+                                                                   problem_defn,
+                                                                   "CompressibleExponentialLawKinematicsCache");
+            TS_ASSERT_EQUALS(cached_solver.GetUseKinematicsCache(), false);
+            cached_solver.SetUseKinematicsCache();
+            TS_ASSERT_EQUALS(cached_solver.GetUseKinematicsCache(), true);
+            cached_solver.Solve();
+
+            TS_ASSERT_EQUALS(cached_solver.GetNumNewtonIterations(), solver.GetNumNewtonIterations());
+            for (unsigned i=0; i<mesh.GetNumNodes(); i++)
+            {
+                TS_ASSERT_DELTA(cached_solver.rGetDeformedPosition()[i](0), solver.rGetDeformedPosition()[i](0), 1e-12);
+                TS_ASSERT_DELTA(cached_solver.rGetDeformedPosition()[i](1), solver.rGetDeformedPosition()[i](1), 1e-12);
+            }
+
+            // A second solve from the converged solution starts with a cache for it
+            cached_solver.Solve();
+            TS_ASSERT_DELTA(cached_solver.rGetDeformedPosition()[5](0), solver.rGetDeformedPosition()[5](0), 1e-8);
+        }
+
+        // Jacobian-free Newton-Krylov with SNES, the assembled preconditioner being reused for two iterations
+        {
+            gravity(0) = 2.0;
+            problem_defn.SetBodyForce(gravity);
+            problem_defn.SetSolveUsingSnes();
+
+            CompressibleNonlinearElasticitySolver<2> solver(mesh,
+                                                            problem_defn,
+                                                            "CompressibleExponentialLawMatrixFree");
+            solver.SetUseMatrixFreeSnesJacobian();
+            solver.SetJacobianLag(2);
+            solver.Solve();
+
+            std::vector<c_vector<double,2> >& r_solution = solver.rGetDeformedPosition();
+            TS_ASSERT_DELTA(r_solution[5](0), 1.0360, 1e-3);
+            TS_ASSERT_DELTA(r_solution[5](1), 0.0021, 1e-3);
+        }
+    }
+
     /**
      * Same as TestSolveForSimpleDeformationWithCompMooneyRivlin (see comments for this),
      * except the y position of the fixed nodes is left free, i.e. sliding boundary conditions
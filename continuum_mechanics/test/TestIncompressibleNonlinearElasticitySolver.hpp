@@ -1066,6 +1066,9 @@ public:
                 // the second run. Note: the second run may still take an iteration or two, as the
                 // final newton solve tolerance may be different (eg if relative tolerance)
                 solver.rGetCurrentSolution() = soln_first_run;
+
+                // Share the kinematics between the SNES residual and Jacobian evaluations
+                solver.SetUseKinematicsCache();
             }
 
             solver.Solve();
@@ -1204,6 +1204,72 @@ public:
         TS_ASSERT_DELTA(T_base(1,2), a*exp(Q)*bsf*e12 + 2*w3*I3*invC(1,2), 1e-9);
         TS_ASSERT_DELTA(T_base(2,2), a*exp(Q)*bss*e22 + 2*w3*I3*invC(2,2), 1e-9);
     }
+
+    void TestBatchStressComputation()
+    {
+        CompressibleExponentialLaw<2> law;
+        TS_ASSERT(law.IsThreadSafe());
+
+        const unsigned num_points = 5;
+        std::vector<c_matrix<double,2,2> > C(num_points);
+        std::vector<c_matrix<double,2,2> > invC(num_points);
+        std::vector<c_matrix<double,2,2> > bases(num_points);
+        for (unsigned i=0; i<num_points; i++)
+        {
+            C[i](0,0) = 1.0 + 0.05*i;
+            C[i](0,1) = C[i](1,0) = 0.02*i;
+            C[i](1,1) = 0.95;
+            invC[i] = Inverse(C[i]);
+
+            double theta = 0.3*i;
+            bases[i](0,0) = cos(theta);
+            bases[i](0,1) = -sin(theta);
+            bases[i](1,0) = sin(theta);
+            bases[i](1,1) = cos(theta);
+        }
+
+        std::vector<double> no_pressures;
+        std::vector<c_matrix<double,2,2> > T(num_points);
+        std::vector<FourthOrderTensor<2,2,2,2> > dTdE(num_points);
+
+        // Batch over points 1 to 4 with a change of basis per point, using two threads
+        // (which is just one thread unless built with OpenMP)
+        law.ComputeStressesAndStressDerivatives(1, num_points-1, C, invC, no_pressures, &bases, T, dTdE, true, 2u);
+
+        c_matrix<double,2,2> T_single;
+        FourthOrderTensor<2,2,2,2> dTdE_single;
+        for (unsigned i=1; i<num_points; i++)
+        {
+            law.SetChangeOfBasisMatrix(bases[i]);
+            law.ComputeStressAndStressDerivative(C[i], invC[i], 0.0, T_single, dTdE_single, true);
+            for (unsigned M=0; M<2; M++)
+            {
+                for (unsigned N=0; N<2; N++)
+                {
+                    TS_ASSERT_DELTA(T[i](M,N), T_single(M,N), 1e-12);
+                    for (unsigned P=0; P<2; P++)
+                    {
+                        for (unsigned Q=0; Q<2; Q++)
+                        {
+                            TS_ASSERT_DELTA(dTdE[i](M,N,P,Q), dTdE_single(M,N,P,Q), 1e-12);
+                        }
+                    }
+                }
+            }
+        }
+        law.ResetToNoChangeOfBasisMatrix();
+
+        // Without a change of basis and without dTdE (which needn't be allocated then)
+        std::vector<FourthOrderTensor<2,2,2,2> > no_dTdE;
+        law.ComputeStressesAndStressDerivatives(0, num_points, C, invC, no_pressures, nullptr, T, no_dTdE, false);
+        for (unsigned i=0; i<num_points; i++)
+        {
+            law.ComputeStressAndStressDerivative(C[i], invC[i], 0.0, T_single, dTdE_single, false);
+            TS_ASSERT_DELTA(T[i](0,0), T_single(0,0), 1e-12);
+            TS_ASSERT_DELTA(T[i](0,1), T_single(0,1), 1e-12);
+            TS_ASSERT_DELTA(T[i](1,1), T_single(1,1), 1e-12);
+        }
+    }
 };
 
 #endif /*TESTMATERIALLAWS_HPP_*/
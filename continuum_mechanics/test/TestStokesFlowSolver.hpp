@@ -749,6 +749,52 @@ public:
             }
         }
     }
+
+    // As TestStokesExactSolutionLessSimple, but with the Schur complement field split preconditioner
+    void TestStokesWithFieldSplitPreconditioner()
+    {
+        unsigned num_elem = 3;
+        QuadraticMesh<2> mesh(1.0/num_elem, 1.0, 1.0);
+
+        std::vector<unsigned> dirichlet_nodes;
+        std::vector<c_vector<double,2> > dirichlet_flow;
+        for (unsigned i=0; i<mesh.GetNumNodes(); i++)
+        {
+            double x = mesh.GetNode(i)->rGetLocation()[0];
+            double y = mesh.GetNode(i)->rGetLocation()[1];
+            if (x == 0.0 || y == 0.0)
+            {
+                dirichlet_nodes.push_back(i);
+                c_vector<double,2> flow = zero_vector<double>(2);
+                flow(0) = y;
+                flow(1) = -x;
+                dirichlet_flow.push_back(flow);
+            }
+        }
+
+        StokesFlowProblemDefinition<2> problem_defn(mesh);
+        problem_defn.SetViscosity(10.0);
+        problem_defn.SetPrescribedFlowNodes(dirichlet_nodes, dirichlet_flow);
+
+        StokesFlowSolver<2> solver(mesh, problem_defn, "StokesFlowFieldSplit");
+        solver.SetKspAbsoluteTolerance(1e-12);
+        solver.SetUseFieldSplitPreconditioner();
+        solver.Solve();
+
+        for (unsigned i=0; i<mesh.GetNumNodes(); i++)
+        {
+            double x = mesh.GetNode(i)->rGetLocation()[0];
+            double y = mesh.GetNode(i)->rGetLocation()[1];
+            TS_ASSERT_DELTA(solver.rGetVelocities()[i](0),  y, 1e-8);
+            TS_ASSERT_DELTA(solver.rGetVelocities()[i](1), -x, 1e-8);
+        }
+
+        std::vector<double>& r_pressures = solver.rGetPressures();
+        for (unsigned i=0; i<r_pressures.size(); i++)
+        {
+            TS_ASSERT_DELTA(r_pressures[i], 0.0, 1e-6);
+        }
+    }
 };
 
 #endif // TESTSTOKESFLOWSOLVER_HPP_
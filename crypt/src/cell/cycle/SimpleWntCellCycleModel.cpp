@@ -268,6 +268,11 @@ void SimpleWntCellCycleModel::UpdateCellCyclePhase()
     AbstractSimplePhaseBasedCellCycleModel::UpdateCellCyclePhase();
 }
 
+bool SimpleWntCellCycleModel::CanPredictNextEventTime()
+{
+    return false;
+}
+
 void SimpleWntCellCycleModel::InitialiseDaughterCell()
 {
     WntConcentrationType wnt_type = GetWntType();
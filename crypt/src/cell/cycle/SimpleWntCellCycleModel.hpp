@@ -142,6 +142,13 @@ public:
      */
     virtual void UpdateCellCyclePhase();
 
+    /**
+     * Overridden CanPredictNextEventTime() method.
+     *
+     * @return false, since the cell's proliferative type depends on the local Wnt concentration.
+     */
+    virtual bool CanPredictNextEventTime();
+
     /**
      * Overridden InitialiseDaughterCell() method.
      */
@@ -33,6 +33,8 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 */
 #include "WntConcentration.hpp"
+#include "CellData.hpp"
+#include "SimulationTime.hpp"
 
 /** Pointer to the single instance */
 template <unsigned DIM>
@@ -59,7 +61,11 @@ WntConcentration<DIM>::WntConcentration()
       mUseConstantWntValueForTesting(false),
       mWntConcentrationParameter(1.0),
       mCryptProjectionParameterA(0.5),
-      mCryptProjectionParameterB(2.0)
+      mCryptProjectionParameterB(2.0),
+      mUseCachedWntLevels(false),
+      mCachedWntLevelsAreCurrent(false),
+      mCachedWntLevelsTimeStep(0),
+      mCachedWntLevelsNumCells(0)
 {
     // Make sure there's only one instance - enforces correct serialization
     assert(mpInstance == nullptr);
@@ -92,20 +98,62 @@ double WntConcentration<DIM>::GetWntLevel(CellPtr pCell)
     assert(mTypeSet);
     assert(mLengthSet);
 
-    double height;
+    if (mUseCachedWntLevels && SimulationTime::Instance()->IsStartTimeSetUp())
+    {
+        if (!mCachedWntLevelsAreCurrent
+            || mCachedWntLevelsTimeStep != SimulationTime::Instance()->GetTimeStepsElapsed()
+            || mCachedWntLevelsNumCells != mpCellPopulation->rGetCells().size())
+        {
+            UpdateCachedWntLevels();
+        }
+        return pCell->GetCellData()->GetItem(CellData::GetItemIndex("wnt level"));
+    }
 
+    return GetWntLevel(CalculateHeight(mpCellPopulation->GetLocationOfCellCentre(pCell)));
+}
+
+template <unsigned DIM>
+double WntConcentration<DIM>::CalculateHeight(const c_vector<double, DIM>& rLocation)
+{
     if (mWntType == RADIAL)
     {
         double a = GetCryptProjectionParameterA();
         double b = GetCryptProjectionParameterB();
-        height = a*pow(norm_2(mpCellPopulation->GetLocationOfCellCentre(pCell)), b);
+        return a*pow(norm_2(rLocation), b);
     }
     else
     {
-        height = mpCellPopulation->GetLocationOfCellCentre(pCell)[DIM-1];
+        return rLocation[DIM-1];
+    }
+}
+
+template <unsigned DIM>
+void WntConcentration<DIM>::UpdateCachedWntLevels()
+{
+    std::list<CellPtr>& r_cells = mpCellPopulation->rGetCells();
+
+    // Look up all the heights first, then work out the levels in one loop
+    std::vector<double> wnt_levels;
+    wnt_levels.reserve(r_cells.size());
+    for (std::list<CellPtr>::iterator cell_iter = r_cells.begin(); cell_iter != r_cells.end(); ++cell_iter)
+    {
+        wnt_levels.push_back(CalculateHeight(mpCellPopulation->GetLocationOfCellCentre(*cell_iter)));
+    }
+    for (unsigned i=0; i<wnt_levels.size(); i++)
+    {
+        wnt_levels[i] = GetWntLevel(wnt_levels[i]);
+    }
+
+    const unsigned item_index = CellData::GetItemIndex("wnt level");
+    unsigned index = 0;
+    for (std::list<CellPtr>::iterator cell_iter = r_cells.begin(); cell_iter != r_cells.end(); ++cell_iter, ++index)
+    {
+        (*cell_iter)->GetCellData()->SetItem(item_index, wnt_levels[index]);
     }
 
-    return GetWntLevel(height);
+    mCachedWntLevelsAreCurrent = true;
+    mCachedWntLevelsTimeStep = SimulationTime::Instance()->GetTimeStepsElapsed();
+    mCachedWntLevelsNumCells = r_cells.size();
 }
 
 template <unsigned DIM>
@@ -128,6 +176,7 @@ template <unsigned DIM>
 void WntConcentration<DIM>::SetCellPopulation(AbstractCellPopulation<DIM>& rCellPopulation)
 {
     mpCellPopulation = &rCellPopulation;
+    InvalidateCachedWntLevels();
 }
 
 template <unsigned DIM>
@@ -153,6 +202,7 @@ void WntConcentration<DIM>::SetCryptLength(double cryptLength)
 
     mCryptLength = cryptLength;
     mLengthSet = true;
+    InvalidateCachedWntLevels();
 }
 
 template <unsigned DIM>
@@ -170,6 +220,7 @@ void WntConcentration<DIM>::SetType(WntConcentrationType type)
     }
     mWntType = type;
     mTypeSet = true;
+    InvalidateCachedWntLevels();
 }
 
 template <unsigned DIM>
@@ -293,6 +344,7 @@ void WntConcentration<DIM>::SetWntConcentrationParameter(double wntConcentration
 {
     assert(wntConcentrationParameter > 0.0);
     mWntConcentrationParameter = wntConcentrationParameter;
+    InvalidateCachedWntLevels();
 }
 
 template <unsigned DIM>
@@ -312,6 +364,7 @@ void WntConcentration<DIM>::SetCryptProjectionParameterA(double cryptProjectionP
 {
     assert(cryptProjectionParameterA >= 0.0);
     mCryptProjectionParameterA = cryptProjectionParameterA;
+    InvalidateCachedWntLevels();
 }
 
 template <unsigned DIM>
@@ -319,6 +372,26 @@ void WntConcentration<DIM>::SetCryptProjectionParameterB(double cryptProjectionP
 {
     assert(cryptProjectionParameterB >= 0.0);
     mCryptProjectionParameterB = cryptProjectionParameterB;
+    InvalidateCachedWntLevels();
+}
+
+template <unsigned DIM>
+void WntConcentration<DIM>::SetUseCachedWntLevels(bool useCachedWntLevels)
+{
+    mUseCachedWntLevels = useCachedWntLevels;
+    InvalidateCachedWntLevels();
+}
+
+template <unsigned DIM>
+bool WntConcentration<DIM>::GetUseCachedWntLevels()
+{
+    return mUseCachedWntLevels;
+}
+
+template <unsigned DIM>
+void WntConcentration<DIM>::InvalidateCachedWntLevels()
+{
+    mCachedWntLevelsAreCurrent = false;
 }
 
 // Explicit instantiation
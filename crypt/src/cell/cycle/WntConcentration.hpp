@@ -134,6 +134,23 @@ private:
      */
     double mCryptProjectionParameterB;
 
+    /**
+     * Whether GetWntLevel(CellPtr) computes the Wnt level of every cell in one pass, stores
+     * it in each cell's CellData (as "wnt level") and reuses it until the time step or the
+     * number of cells changes. Not archived, since it is a property of the run. Defaults
+     * to false.
+     */
+    bool mUseCachedWntLevels;
+
+    /** Whether the Wnt levels in the cells' CellData are up to date. */
+    bool mCachedWntLevelsAreCurrent;
+
+    /** The number of time steps elapsed when the cached Wnt levels were computed. */
+    unsigned mCachedWntLevelsTimeStep;
+
+    /** The number of cells in the population when the cached Wnt levels were computed. */
+    unsigned mCachedWntLevelsNumCells;
+
     /** Needed for serialization. */
     friend class boost::serialization::access;
     /**
@@ -162,6 +179,19 @@ private:
         }
     }
 
+    /**
+     * @return the height up the crypt of a location, on which the Wnt level depends.
+     *
+     * @param rLocation the location
+     */
+    double CalculateHeight(const c_vector<double, DIM>& rLocation);
+
+    /**
+     * Calculate the Wnt level of every cell in the population and store it in the
+     * cells' CellData, for GetWntLevel(CellPtr) to use while #mUseCachedWntLevels is set.
+     */
+    void UpdateCachedWntLevels();
+
 protected:
 
     /**
@@ -312,6 +342,28 @@ public:
      * @param cryptProjectionParameterB  the new value of mCryptProjectionParameterB
      */
     void SetCryptProjectionParameterB(double cryptProjectionParameterB);
+
+    /**
+     * Set whether GetWntLevel(CellPtr) caches the Wnt levels of all cells in their CellData.
+     * The levels are then computed for the whole population the first time any cell asks in
+     * a time step, rather than once for each cell, and again if cells are added or removed.
+     * Moving cells within a time step after the levels have been computed requires a call
+     * to InvalidateCachedWntLevels(). Caching is only used when SimulationTime is set up.
+     *
+     * @param useCachedWntLevels whether to cache the Wnt levels
+     */
+    void SetUseCachedWntLevels(bool useCachedWntLevels);
+
+    /**
+     * @return mUseCachedWntLevels
+     */
+    bool GetUseCachedWntLevels();
+
+    /**
+     * Make GetWntLevel(CellPtr) recompute the cached Wnt levels the next time it is called.
+     * Called by all the methods that change the Wnt profile or the population.
+     */
+    void InvalidateCachedWntLevels();
 };
 
 #endif /*WNTCONCENTRATION_HPP_*/
@@ -58,13 +58,23 @@ void RadialSloughingCellKiller::CheckAndLabelCellsForApoptosisOrDeath()
          cell_iter != this->mpCellPopulation->End();
          ++cell_iter)
     {
-        // Get distance from centre of cell population
-        double r = norm_2(this->mpCellPopulation->GetLocationOfCellCentre(*cell_iter) - mCentre);
+        CheckAndLabelSingleCellForApoptosisOrDeath(*cell_iter);
+    }
+}
+
+bool RadialSloughingCellKiller::CanCheckSingleCells() const
+{
+    return true;
+}
+
+void RadialSloughingCellKiller::CheckAndLabelSingleCellForApoptosisOrDeath(CellPtr pCell)
+{
+    // Get distance from centre of cell population
+    double r = norm_2(this->mpCellPopulation->GetLocationOfCellCentre(pCell) - mCentre);
 
-        if (r > mRadius)
-        {
-            cell_iter->Kill();
-        }
+    if (r > mRadius)
+    {
+        pCell->Kill();
     }
 }
 
@@ -99,6 +99,20 @@ public:
      */
     virtual void CheckAndLabelCellsForApoptosisOrDeath();
 
+    /**
+     * Overridden CanCheckSingleCells() method.
+     *
+     * @return true
+     */
+    virtual bool CanCheckSingleCells() const;
+
+    /**
+     * Kills the given cell if it is outside the boundary.
+     *
+     * @param pCell the cell
+     */
+    virtual void CheckAndLabelSingleCellForApoptosisOrDeath(CellPtr pCell);
+
     /**
      * Outputs cell killer parameters to file
      *
@@ -68,49 +68,56 @@ double SloughingCellKiller<DIM>::GetSloughWidth() const
 
 template <unsigned DIM>
 void SloughingCellKiller<DIM>::CheckAndLabelCellsForApoptosisOrDeath()
+{
+    if (DIM == 3)
+    {
+        EXCEPTION("SloughingCellKiller is not yet implemented in 3D");
+    }
+
+    for (typename AbstractCellPopulation<DIM>::Iterator cell_iter = this->mpCellPopulation->Begin();
+         cell_iter != this->mpCellPopulation->End();
+         ++cell_iter)
+    {
+        CheckAndLabelSingleCellForApoptosisOrDeath(*cell_iter);
+    }
+}
+
+template <unsigned DIM>
+bool SloughingCellKiller<DIM>::CanCheckSingleCells() const
+{
+    return (DIM < 3);
+}
+
+template <unsigned DIM>
+void SloughingCellKiller<DIM>::CheckAndLabelSingleCellForApoptosisOrDeath(CellPtr pCell)
 {
     switch (DIM)
     {
         case 1:
         {
-            for (typename AbstractCellPopulation<DIM>::Iterator cell_iter = this->mpCellPopulation->Begin();
-                 cell_iter != this->mpCellPopulation->End();
-                 ++cell_iter)
-            {
-                double x = this->mpCellPopulation->GetLocationOfCellCentre(*cell_iter)[0];
+            double x = this->mpCellPopulation->GetLocationOfCellCentre(pCell)[0];
 
-                if (x > mSloughHeight)
-                {
-                    cell_iter->Kill();
-                }
+            if (x > mSloughHeight)
+            {
+                pCell->Kill();
             }
             break;
         }
         case 2:
         {
-            for (typename AbstractCellPopulation<DIM>::Iterator cell_iter = this->mpCellPopulation->Begin();
-                 cell_iter != this->mpCellPopulation->End();
-                 ++cell_iter)
+            c_vector<double, 2> location;
+            location = this->mpCellPopulation->GetLocationOfCellCentre(pCell);
+            double x = location[0];
+            double y = location[1];
+
+            if ((y>mSloughHeight) || (mSloughSides && ((x<0.0) || (x>mSloughWidth))))
             {
-                c_vector<double, 2> location;
-                location = this->mpCellPopulation->GetLocationOfCellCentre(*cell_iter);
-                double x = location[0];
-                double y = location[1];
-
-                if ((y>mSloughHeight) || (mSloughSides && ((x<0.0) || (x>mSloughWidth))))
-                {
-                    cell_iter->Kill();
-                }
+                pCell->Kill();
             }
             break;
         }
-        case 3:
-        {
-            EXCEPTION("SloughingCellKiller is not yet implemented in 3D");
-            break;
-        }
         default:
-            // This can't happen
+            // CanCheckSingleCells() returns false in 3D
             NEVER_REACHED;
     }
 }
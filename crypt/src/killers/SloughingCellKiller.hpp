@@ -121,6 +121,20 @@ public:
      */
     virtual void CheckAndLabelCellsForApoptosisOrDeath();
 
+    /**
+     * Overridden CanCheckSingleCells() method.
+     *
+     * @return true, except in 3D where this killer is not implemented
+     */
+    virtual bool CanCheckSingleCells() const;
+
+    /**
+     * Kills the given cell if it is outside the boundary.
+     *
+     * @param pCell the cell
+     */
+    virtual void CheckAndLabelSingleCellForApoptosisOrDeath(CellPtr pCell);
+
     /**
      * Outputs cell killer parameters to file
      *
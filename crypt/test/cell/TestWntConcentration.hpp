@@ -45,6 +45,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "ArchiveOpener.hpp"
 #include "CellsGenerator.hpp"
+#include "FixedG1GenerationalCellCycleModel.hpp"
 #include "MeshBasedCellPopulation.hpp"
 #include "WntCellCycleModel.hpp"
 #include "AbstractCellBasedTestSuite.hpp"
@@ -487,6 +488,58 @@ public:
         WntConcentration<2>::Destroy();
     }
 
+    void TestCachedWntLevels()
+    {
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(1.0, 2);
+
+        // Create a simple mesh, with nodes at heights 0 and 1
+        TrianglesMeshReader<2,2> mesh_reader("mesh/test/data/square_2_elements");
+        MutableMesh<2,2> mesh;
+        mesh.ConstructFromMeshReader(mesh_reader);
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<FixedG1GenerationalCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, mesh.GetNumNodes());
+        MeshBasedCellPopulation<2> crypt(mesh, cells);
+
+        WntConcentration<2>* p_wnt = WntConcentration<2>::Instance();
+        p_wnt->SetType(LINEAR);
+        p_wnt->SetCryptLength(2.0);
+        p_wnt->SetCellPopulation(crypt);
+        TS_ASSERT_EQUALS(p_wnt->GetUseCachedWntLevels(), false);
+        p_wnt->SetUseCachedWntLevels(true);
+        TS_ASSERT_EQUALS(p_wnt->GetUseCachedWntLevels(), true);
+
+        // The first query computes and stores the levels of all the cells
+        CellPtr p_cell = crypt.GetCellUsingLocationIndex(2);
+        TS_ASSERT_DELTA(crypt.GetLocationOfCellCentre(p_cell)[1], 1.0, 1e-12);
+        TS_ASSERT_DELTA(p_wnt->GetWntLevel(p_cell), 0.5, 1e-12);
+        for (AbstractCellPopulation<2>::Iterator cell_iter = crypt.Begin();
+             cell_iter != crypt.End();
+             ++cell_iter)
+        {
+            double height = crypt.GetLocationOfCellCentre(*cell_iter)[1];
+            TS_ASSERT_DELTA(cell_iter->GetCellData()->GetItem("wnt level"), 1.0 - 0.5*height, 1e-12);
+        }
+
+        // Moving a cell within the time step doesn't change its level until the cache is invalidated
+        mesh.GetNode(2)->rGetModifiableLocation()[1] = 0.5;
+        TS_ASSERT_DELTA(p_wnt->GetWntLevel(p_cell), 0.5, 1e-12);
+        p_wnt->InvalidateCachedWntLevels();
+        TS_ASSERT_DELTA(p_wnt->GetWntLevel(p_cell), 0.75, 1e-12);
+
+        // ...or the next time step
+        mesh.GetNode(2)->rGetModifiableLocation()[1] = 0.0;
+        SimulationTime::Instance()->IncrementTimeOneStep();
+        TS_ASSERT_DELTA(p_wnt->GetWntLevel(p_cell), 1.0, 1e-12);
+
+        // Changing the profile also recomputes the levels
+        p_wnt->SetWntConcentrationParameter(0.5);
+        TS_ASSERT_DELTA(p_wnt->GetWntLevel(crypt.GetCellUsingLocationIndex(3)), 0.0, 1e-12);
+
+        WntConcentration<2>::Destroy();
+    }
+
     void TestCryptProjectionParameterAAndBGettersAndSetters()
     {
         WntConcentration<2>* p_wnt1 = WntConcentration<2>::Instance();
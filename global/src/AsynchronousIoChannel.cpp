@@ -0,0 +1,124 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "AsynchronousIoChannel.hpp"
+
+#include <atomic>
+
+#include "AsynchronousIoService.hpp"
+#include "Exception.hpp"
+
+AsynchronousIoChannel::AsynchronousIoChannel(unsigned maxOutstandingTasks, const std::string& rOrderingKey)
+    : mMaxOutstandingTasks(maxOutstandingTasks),
+      mpState(new State)
+{
+    if (maxOutstandingTasks == 0)
+    {
+        EXCEPTION("The maximum number of outstanding I/O tasks must be at least one.");
+    }
+    mpState->mNumOutstandingTasks = 0;
+
+    if (rOrderingKey.empty())
+    {
+        // Spread anonymous channels over the workers
+        static std::atomic<std::size_t> s_next_key(0);
+        mOrderingKey = s_next_key.fetch_add(1);
+    }
+    else
+    {
+        mOrderingKey = std::hash<std::string>()(rOrderingKey);
+    }
+}
+
+AsynchronousIoChannel::~AsynchronousIoChannel()
+{
+    std::unique_lock<std::mutex> lock(mpState->mMutex);
+    mpState->mTaskFinished.wait(lock, [this]{ return mpState->mNumOutstandingTasks == 0; });
+}
+
+void AsynchronousIoChannel::RethrowError(std::unique_lock<std::mutex>& rLock)
+{
+    if (mpState->mpError)
+    {
+        std::exception_ptr p_error = mpState->mpError;
+        mpState->mpError = nullptr;
+        rLock.unlock();
+        std::rethrow_exception(p_error);
+    }
+}
+
+void AsynchronousIoChannel::Submit(std::function<void()> task)
+{
+    {
+        std::unique_lock<std::mutex> lock(mpState->mMutex);
+        mpState->mTaskFinished.wait(lock, [this]{ return mpState->mNumOutstandingTasks < mMaxOutstandingTasks; });
+        RethrowError(lock);
+        mpState->mNumOutstandingTasks++;
+    }
+
+    std::shared_ptr<State> p_state = mpState;
+    AsynchronousIoService::Instance()->Submit([p_state, task]()
+    {
+        std::exception_ptr p_error;
+        try
+        {
+            task();
+        }
+        catch (...)
+        {
+            p_error = std::current_exception();
+        }
+
+        std::lock_guard<std::mutex> lock(p_state->mMutex);
+        if (p_error && !p_state->mpError)
+        {
+            p_state->mpError = p_error;
+        }
+        p_state->mNumOutstandingTasks--;
+        p_state->mTaskFinished.notify_all();
+    }, mOrderingKey);
+}
+
+void AsynchronousIoChannel::Flush()
+{
+    std::unique_lock<std::mutex> lock(mpState->mMutex);
+    mpState->mTaskFinished.wait(lock, [this]{ return mpState->mNumOutstandingTasks == 0; });
+    RethrowError(lock);
+}
+
+unsigned AsynchronousIoChannel::GetMaxOutstandingTasks() const
+{
+    return mMaxOutstandingTasks;
+}
@@ -0,0 +1,132 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef ASYNCHRONOUSIOCHANNEL_HPP_
+#define ASYNCHRONOUSIOCHANNEL_HPP_
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+/**
+ * A writer's connection to the shared AsynchronousIoService.
+ *
+ * Tasks submitted through one channel run one at a time, in the order in which
+ * they were submitted. At most a given number of them may be outstanding: once
+ * that many are queued or running, Submit() waits for the oldest to finish.
+ * The first error thrown by a task is rethrown by the next call to Submit() or
+ * Flush(), so errors reach the writer that caused them.
+ *
+ * Channels created with the same (non-empty) ordering key share a worker
+ * thread, so their tasks are also run in order with respect to each other;
+ * this is how, for example, all HDF5 writes are kept on one thread.
+ */
+class AsynchronousIoChannel
+{
+private:
+
+    /** The state shared between the channel and its queued tasks. */
+    struct State
+    {
+        /** Protects the other members. */
+        std::mutex mMutex;
+
+        /** Signalled whenever a task finishes. */
+        std::condition_variable mTaskFinished;
+
+        /** The number of tasks submitted that have not yet finished. */
+        unsigned mNumOutstandingTasks;
+
+        /** The first error thrown by a task, if any. */
+        std::exception_ptr mpError;
+    };
+
+    /** The maximum number of tasks that may be outstanding. */
+    unsigned mMaxOutstandingTasks;
+
+    /** The ordering key passed to AsynchronousIoService::Submit(). */
+    std::size_t mOrderingKey;
+
+    /** The state shared with queued tasks. */
+    std::shared_ptr<State> mpState;
+
+    /**
+     * Rethrow (and clear) any error thrown by a task.
+     * Must be called with the state's mutex held.
+     *
+     * @param rLock the lock on the state's mutex
+     */
+    void RethrowError(std::unique_lock<std::mutex>& rLock);
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param maxOutstandingTasks the maximum number of tasks that may be outstanding (at least 1; defaults to 4)
+     * @param rOrderingKey channels with the same non-empty key run their tasks in order on the
+     *     same worker thread; by default each channel gets a key of its own
+     */
+    AsynchronousIoChannel(unsigned maxOutstandingTasks=4, const std::string& rOrderingKey="");
+
+    /**
+     * Destructor. Waits for all outstanding tasks to finish.
+     * Errors thrown by the tasks are not reported here; call Flush() first to see them.
+     */
+    ~AsynchronousIoChannel();
+
+    /**
+     * Queue a task to be run by an I/O worker thread.
+     *
+     * @param task the task
+     */
+    void Submit(std::function<void()> task);
+
+    /**
+     * Wait until all the tasks submitted through this channel have finished.
+     */
+    void Flush();
+
+    /**
+     * @return the maximum number of tasks that may be outstanding.
+     */
+    unsigned GetMaxOutstandingTasks() const;
+};
+
+#endif /*ASYNCHRONOUSIOCHANNEL_HPP_*/
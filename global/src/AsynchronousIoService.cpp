@@ -0,0 +1,300 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "AsynchronousIoService.hpp"
+
+#include <chrono>
+#include <cstdint>
+
+#include "Exception.hpp"
+
+AsynchronousIoService* AsynchronousIoService::mpInstance = nullptr;
+
+AsynchronousIoService::AsynchronousIoService(unsigned numWorkers, unsigned queueCapacity)
+    : mQueueCapacity(1),
+      mStopping(false),
+      mNumOutstandingTasks(0)
+{
+    if (numWorkers == 0)
+    {
+        EXCEPTION("The number of I/O worker threads must be at least one.");
+    }
+    if (queueCapacity == 0)
+    {
+        EXCEPTION("The capacity of the I/O queues must be at least one.");
+    }
+    while (mQueueCapacity < queueCapacity)
+    {
+        mQueueCapacity *= 2;
+    }
+    StartWorkers(numWorkers);
+}
+
+AsynchronousIoService::~AsynchronousIoService()
+{
+    StopWorkers();
+}
+
+AsynchronousIoService* AsynchronousIoService::Instance()
+{
+    if (mpInstance == nullptr)
+    {
+        mpInstance = new AsynchronousIoService();
+    }
+    return mpInstance;
+}
+
+void AsynchronousIoService::Destroy()
+{
+    if (mpInstance)
+    {
+        delete mpInstance;
+        mpInstance = nullptr;
+    }
+}
+
+/*
+ * The queues are the bounded multi-producer queue of D. Vyukov: each slot
+ * carries a sequence number which says whether it is ready to be written (it
+ * equals the enqueue position) or read (it equals the dequeue position plus
+ * one), so producers only need to claim a position with a compare-and-swap.
+ */
+bool AsynchronousIoService::TryPush(Worker& rWorker, std::function<void()>& rTask)
+{
+    const std::size_t mask = mQueueCapacity - 1;
+    std::size_t position = rWorker.mEnqueuePosition.load(std::memory_order_relaxed);
+    Slot* p_slot;
+    while (true)
+    {
+        p_slot = &rWorker.mpSlots[position & mask];
+        std::size_t sequence = p_slot->mSequence.load(std::memory_order_acquire);
+        std::intptr_t difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+        if (difference == 0)
+        {
+            if (rWorker.mEnqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (difference < 0)
+        {
+            // The queue is full
+            return false;
+        }
+        else
+        {
+            position = rWorker.mEnqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+    p_slot->mTask = std::move(rTask);
+    p_slot->mSequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+bool AsynchronousIoService::TryPop(Worker& rWorker, std::function<void()>& rTask)
+{
+    const std::size_t mask = mQueueCapacity - 1;
+    std::size_t position = rWorker.mDequeuePosition.load(std::memory_order_relaxed);
+    Slot* p_slot = &rWorker.mpSlots[position & mask];
+    std::size_t sequence = p_slot->mSequence.load(std::memory_order_acquire);
+    if (sequence != position + 1)
+    {
+        // The queue is empty, or the next task is still being added
+        return false;
+    }
+
+    // Only the worker itself takes tasks from its queue, so no compare-and-swap is needed here
+    rWorker.mDequeuePosition.store(position + 1, std::memory_order_relaxed);
+    rTask = std::move(p_slot->mTask);
+    p_slot->mTask = nullptr;
+    p_slot->mSequence.store(position + mQueueCapacity, std::memory_order_release);
+    return true;
+}
+
+void AsynchronousIoService::WakeUp(Worker& rWorker)
+{
+    // Pairs with the fence in RunWorker(), so either the worker sees the new task or we see it sleeping
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (rWorker.mSleeping.load(std::memory_order_relaxed))
+    {
+        std::lock_guard<std::mutex> lock(rWorker.mMutex);
+        rWorker.mWakeUp.notify_one();
+    }
+}
+
+void AsynchronousIoService::RunWorker(Worker* pWorker)
+{
+    std::function<void()> task;
+    while (true)
+    {
+        if (TryPop(*pWorker, task))
+        {
+            try
+            {
+                task();
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(mErrorMutex);
+                if (!mpError)
+                {
+                    mpError = std::current_exception();
+                }
+            }
+            task = nullptr;
+
+            if (mNumOutstandingTasks.fetch_sub(1) == 1)
+            {
+                std::lock_guard<std::mutex> lock(mFlushMutex);
+                mAllTasksFinished.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(pWorker->mMutex);
+        pWorker->mSleeping.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        bool queue_empty = (pWorker->mEnqueuePosition.load(std::memory_order_relaxed)
+                            == pWorker->mDequeuePosition.load(std::memory_order_relaxed));
+        if (queue_empty)
+        {
+            if (mStopping.load())
+            {
+                pWorker->mSleeping.store(false, std::memory_order_relaxed);
+                break;
+            }
+            // The timeout is only a safety net; producers wake the worker when they add a task
+            pWorker->mWakeUp.wait_for(lock, std::chrono::milliseconds(10));
+        }
+        pWorker->mSleeping.store(false, std::memory_order_relaxed);
+    }
+}
+
+void AsynchronousIoService::StartWorkers(unsigned numWorkers)
+{
+    mStopping = false;
+    for (unsigned i=0; i<numWorkers; i++)
+    {
+        std::unique_ptr<Worker> p_worker(new Worker);
+        p_worker->mpSlots.reset(new Slot[mQueueCapacity]);
+        for (std::size_t slot=0; slot<mQueueCapacity; slot++)
+        {
+            p_worker->mpSlots[slot].mSequence.store(slot);
+        }
+        p_worker->mEnqueuePosition = 0;
+        p_worker->mDequeuePosition = 0;
+        p_worker->mSleeping = false;
+        mWorkers.push_back(std::move(p_worker));
+    }
+    for (unsigned i=0; i<numWorkers; i++)
+    {
+        mWorkers[i]->mThread = std::thread(&AsynchronousIoService::RunWorker, this, mWorkers[i].get());
+    }
+}
+
+void AsynchronousIoService::StopWorkers()
+{
+    mStopping = true;
+    for (unsigned i=0; i<mWorkers.size(); i++)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mWorkers[i]->mMutex);
+            mWorkers[i]->mWakeUp.notify_one();
+        }
+        mWorkers[i]->mThread.join();
+    }
+    mWorkers.clear();
+}
+
+void AsynchronousIoService::Submit(std::function<void()> task, std::size_t orderingKey)
+{
+    Worker& r_worker = *mWorkers[orderingKey % mWorkers.size()];
+    mNumOutstandingTasks.fetch_add(1);
+
+    // Back-pressure: if the worker is behind, wait for it to make room
+    while (!TryPush(r_worker, task))
+    {
+        WakeUp(r_worker);
+        std::this_thread::yield();
+    }
+    WakeUp(r_worker);
+}
+
+void AsynchronousIoService::Flush()
+{
+    {
+        std::unique_lock<std::mutex> lock(mFlushMutex);
+        mAllTasksFinished.wait(lock, [this]{ return mNumOutstandingTasks.load() == 0; });
+    }
+
+    std::exception_ptr p_error;
+    {
+        std::lock_guard<std::mutex> lock(mErrorMutex);
+        p_error = mpError;
+        mpError = nullptr;
+    }
+    if (p_error)
+    {
+        std::rethrow_exception(p_error);
+    }
+}
+
+void AsynchronousIoService::SetNumberOfWorkers(unsigned numWorkers)
+{
+    if (numWorkers == 0)
+    {
+        EXCEPTION("The number of I/O worker threads must be at least one.");
+    }
+    if (numWorkers != mWorkers.size())
+    {
+        StopWorkers();
+        StartWorkers(numWorkers);
+    }
+}
+
+unsigned AsynchronousIoService::GetNumberOfWorkers() const
+{
+    return mWorkers.size();
+}
+
+unsigned AsynchronousIoService::GetQueueCapacity() const
+{
+    return mQueueCapacity;
+}
+
+unsigned AsynchronousIoService::GetNumberOfOutstandingTasks() const
+{
+    return mNumOutstandingTasks.load();
+}
@@ -0,0 +1,247 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef ASYNCHRONOUSIOSERVICE_HPP_
+#define ASYNCHRONOUSIOSERVICE_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * A pool of I/O worker threads to which output tasks (writing a chunk of
+ * results, an HDF5 hyperslab, removing an old checkpoint directory...) can be
+ * handed, so that a simulation does not wait for the file system.
+ *
+ * Each worker takes its tasks from its own bounded, lock-free queue. A task is
+ * given to the worker chosen by its ordering key, so tasks submitted with the
+ * same key (for example, all writes to one file) run one at a time, in the
+ * order in which they were submitted. If that worker's queue is full, Submit()
+ * waits for a place, which stops fast producers from running arbitrarily far
+ * ahead of the disk. Flush() waits until every submitted task has finished.
+ *
+ * Most code should not submit tasks directly, but through an
+ * AsynchronousIoChannel, which limits the number of tasks a single writer may
+ * have outstanding, and reports errors to that writer.
+ *
+ * A single shared instance is available through Instance(); it is destroyed
+ * (after running any outstanding tasks) when PETSc is finalised, since tasks
+ * may call MPI.
+ */
+class AsynchronousIoService
+{
+private:
+
+    /** A place in a worker's queue. */
+    struct Slot
+    {
+        /** Sequence number, used to tell whether the slot is free or full. */
+        std::atomic<std::size_t> mSequence;
+
+        /** The task held in the slot, if it is full. */
+        std::function<void()> mTask;
+    };
+
+    /** The queue and thread of one I/O worker. */
+    struct Worker
+    {
+        /** The ring buffer of slots, of length mQueueCapacity. */
+        std::unique_ptr<Slot[]> mpSlots;
+
+        /** The position at which the next task will be added. */
+        std::atomic<std::size_t> mEnqueuePosition;
+
+        /** The position from which the next task will be taken. */
+        std::atomic<std::size_t> mDequeuePosition;
+
+        /** Whether the worker has found its queue empty, and is (about to be) waiting on mWakeUp. */
+        std::atomic<bool> mSleeping;
+
+        /** Used with mWakeUp to put the worker to sleep when it has nothing to do. */
+        std::mutex mMutex;
+
+        /** Signalled when a task is added to an empty queue, or the worker should stop. */
+        std::condition_variable mWakeUp;
+
+        /** The worker thread. */
+        std::thread mThread;
+    };
+
+    /** The shared instance of this class. */
+    static AsynchronousIoService* mpInstance;
+
+    /** The number of tasks each worker's queue can hold (a power of two). */
+    std::size_t mQueueCapacity;
+
+    /** The workers. */
+    std::vector<std::unique_ptr<Worker> > mWorkers;
+
+    /** Whether the workers should stop once their queues are empty. */
+    std::atomic<bool> mStopping;
+
+    /** The number of tasks submitted that have not yet finished. */
+    std::atomic<std::size_t> mNumOutstandingTasks;
+
+    /** Used with mAllTasksFinished to wait in Flush(). */
+    std::mutex mFlushMutex;
+
+    /** Signalled whenever mNumOutstandingTasks falls to zero. */
+    std::condition_variable mAllTasksFinished;
+
+    /** Protects mpError. */
+    std::mutex mErrorMutex;
+
+    /** The first error thrown by a task, if any. */
+    std::exception_ptr mpError;
+
+    /**
+     * Try to add a task to a worker's queue.
+     *
+     * @param rWorker the worker
+     * @param rTask the task; moved from only if it was added
+     * @return whether the task was added (false if the queue is full)
+     */
+    bool TryPush(Worker& rWorker, std::function<void()>& rTask);
+
+    /**
+     * Try to take a task from a worker's queue. Only called by the worker itself.
+     *
+     * @param rWorker the worker
+     * @param rTask filled in with the task, if there was one
+     * @return whether a task was taken (false if the queue is empty)
+     */
+    bool TryPop(Worker& rWorker, std::function<void()>& rTask);
+
+    /**
+     * Wake a worker if it is sleeping.
+     *
+     * @param rWorker the worker
+     */
+    void WakeUp(Worker& rWorker);
+
+    /**
+     * The body of each worker thread: run queued tasks until told to stop.
+     *
+     * @param pWorker the worker
+     */
+    void RunWorker(Worker* pWorker);
+
+    /**
+     * Create and start the worker threads.
+     *
+     * @param numWorkers the number of workers
+     */
+    void StartWorkers(unsigned numWorkers);
+
+    /**
+     * Stop the worker threads, once they have run all their queued tasks.
+     */
+    void StopWorkers();
+
+public:
+
+    /**
+     * Constructor. Starts the worker threads.
+     *
+     * @param numWorkers the number of I/O worker threads (at least 1; defaults to 1)
+     * @param queueCapacity the number of tasks each worker's queue can hold (at least 1;
+     *     rounded up to a power of two; defaults to 64)
+     */
+    AsynchronousIoService(unsigned numWorkers=1, unsigned queueCapacity=64);
+
+    /**
+     * Destructor. Runs all outstanding tasks, then stops the worker threads.
+     * Errors thrown by the tasks are not reported here; call Flush() first to see them.
+     */
+    ~AsynchronousIoService();
+
+    /**
+     * @return the shared instance of this class, creating it (with one worker) if need be.
+     */
+    static AsynchronousIoService* Instance();
+
+    /**
+     * Destroy the shared instance, if there is one, once all its tasks have finished.
+     * The next call to Instance() will create a new one.
+     */
+    static void Destroy();
+
+    /**
+     * Queue a task to be run by a worker thread. Tasks with the same ordering key
+     * are run one at a time, in the order in which they were submitted. If the
+     * worker's queue is full, this waits until there is room.
+     *
+     * @param task the task
+     * @param orderingKey the ordering key (defaults to 0)
+     */
+    void Submit(std::function<void()> task, std::size_t orderingKey=0);
+
+    /**
+     * Wait until every task submitted so far has finished, and rethrow (then
+     * clear) the first error thrown by any of them. Must not be called by a task.
+     */
+    void Flush();
+
+    /**
+     * Change the number of worker threads. Waits for all outstanding tasks to
+     * finish first; must not be called while other threads are submitting tasks.
+     *
+     * @param numWorkers the number of I/O worker threads (at least 1)
+     */
+    void SetNumberOfWorkers(unsigned numWorkers);
+
+    /**
+     * @return the number of I/O worker threads.
+     */
+    unsigned GetNumberOfWorkers() const;
+
+    /**
+     * @return the number of tasks each worker's queue can hold.
+     */
+    unsigned GetQueueCapacity() const;
+
+    /**
+     * @return the number of tasks submitted that have not yet finished.
+     */
+    unsigned GetNumberOfOutstandingTasks() const;
+};
+
+#endif /*ASYNCHRONOUSIOSERVICE_HPP_*/
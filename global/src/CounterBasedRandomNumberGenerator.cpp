@@ -0,0 +1,169 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#include "CounterBasedRandomNumberGenerator.hpp"
+
+#include <cassert>
+#include <cmath>
+
+CounterBasedRandomNumberGenerator::CounterBasedRandomNumberGenerator(unsigned seed, unsigned streamId, unsigned timeStep, unsigned purpose)
+        : mNumWordsUsed(4u)
+{
+    mKey[0] = seed;
+    mKey[1] = 0u;
+    mCounter[0] = 0u;
+    mCounter[1] = streamId;
+    mCounter[2] = timeStep;
+    mCounter[3] = purpose;
+}
+
+void CounterBasedRandomNumberGenerator::Philox4x32(const uint32_t counter[4], const uint32_t key[2], uint32_t output[4])
+{
+    const uint64_t multiplier_0 = 0xD2511F53u;
+    const uint64_t multiplier_1 = 0xCD9E8D57u;
+
+    uint32_t ctr[4] = { counter[0], counter[1], counter[2], counter[3] };
+    uint32_t k0 = key[0];
+    uint32_t k1 = key[1];
+
+    for (unsigned round = 0; round < 10; round++)
+    {
+        if (round > 0)
+        {
+            // Bump the key with the Weyl sequence constants
+            k0 += 0x9E3779B9u;
+            k1 += 0xBB67AE85u;
+        }
+        uint64_t product_0 = multiplier_0 * ctr[0];
+        uint64_t product_1 = multiplier_1 * ctr[2];
+        uint32_t new_ctr[4];
+        new_ctr[0] = static_cast<uint32_t>(product_1 >> 32) ^ ctr[1] ^ k0;
+        new_ctr[1] = static_cast<uint32_t>(product_1);
+        new_ctr[2] = static_cast<uint32_t>(product_0 >> 32) ^ ctr[3] ^ k1;
+        new_ctr[3] = static_cast<uint32_t>(product_0);
+        for (unsigned i = 0; i < 4; i++)
+        {
+            ctr[i] = new_ctr[i];
+        }
+    }
+
+    for (unsigned i = 0; i < 4; i++)
+    {
+        output[i] = ctr[i];
+    }
+}
+
+uint32_t CounterBasedRandomNumberGenerator::NextWord()
+{
+    if (mNumWordsUsed == 4u)
+    {
+        Philox4x32(mCounter, mKey, mBlock);
+        mCounter[0]++;
+        mNumWordsUsed = 0u;
+    }
+    return mBlock[mNumWordsUsed++];
+}
+
+double CounterBasedRandomNumberGenerator::ranf()
+{
+    // Take 27 + 26 = 53 bits, and offset by half a unit so the result is never 0 or 1
+    uint32_t high = NextWord() >> 5;
+    uint32_t low = NextWord() >> 6;
+    return (high * 67108864.0 + low + 0.5) / 9007199254740992.0;
+}
+
+double CounterBasedRandomNumberGenerator::StandardNormalRandomDeviate()
+{
+    // Box-Muller; the second deviate is discarded so that each call uses a fixed number of words
+    double u1 = ranf();
+    double u2 = ranf();
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+double CounterBasedRandomNumberGenerator::NormalRandomDeviate(double mean, double stdDev)
+{
+    return stdDev * StandardNormalRandomDeviate() + mean;
+}
+
+double CounterBasedRandomNumberGenerator::ExponentialRandomDeviate(double scale)
+{
+    assert(scale > 0.0);
+    return -log(ranf()) / scale;
+}
+
+unsigned CounterBasedRandomNumberGenerator::randMod(unsigned base)
+{
+    assert(base > 0u);
+
+    // Reject the top (2^32 mod base) values, which would otherwise bias the result
+    const uint64_t range = 0x100000000ull;
+    const uint64_t limit = range - (range % base);
+    uint32_t val;
+    do
+    {
+        val = NextWord();
+    } while (val >= limit);
+
+    return val % base;
+}
+
+void CounterBasedRandomNumberGenerator::Shuffle(unsigned num, std::vector<unsigned>& rValues)
+{
+    rValues.resize(num);
+    for (unsigned i = 0; i < num; i++)
+    {
+        rValues[i] = i;
+    }
+    if (num == 0)
+    {
+        return;
+    }
+
+    for (unsigned end = num - 1; end > 0; end--)
+    {
+        // Pick a random integer from {0,..,end}
+        unsigned k = randMod(end + 1);
+        unsigned temp = rValues[end];
+        rValues[end] = rValues[k];
+        rValues[k] = temp;
+    }
+}
+
+void CounterBasedRandomNumberGenerator::SetBlockIndex(unsigned blockIndex)
+{
+    mCounter[0] = blockIndex;
+    mNumWordsUsed = 4u;
+}
@@ -0,0 +1,153 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef COUNTERBASEDRANDOMNUMBERGENERATOR_HPP_
+#define COUNTERBASEDRANDOMNUMBERGENERATOR_HPP_
+
+#include <stdint.h>
+#include <vector>
+
+/**
+ * A counter-based random number generator, using the Philox4x32-10 bijection
+ * of Salmon et al. (2011) "Parallel random numbers: as easy as 1, 2, 3".
+ *
+ * Unlike RandomNumberGenerator, which wraps a single Mersenne Twister shared by the
+ * whole process, each random number here is a pure function of a key and a counter.
+ * An object of this class represents one independent stream, identified by a seed
+ * and three further integers (typically a cell ID, a time step index and a number
+ * identifying what the random numbers are used for).  Streams are cheap to create,
+ * hold no shared state, and so may be used concurrently from any number of threads.
+ * Since the numbers drawn from a stream do not depend on which other streams have
+ * been used, or in which order, results are reproducible regardless of the number
+ * of threads or processes.
+ *
+ * Streams should normally be obtained from RandomNumberGenerator::GetStream(), so
+ * that they pick up the seed given to RandomNumberGenerator::Reseed().
+ */
+class CounterBasedRandomNumberGenerator
+{
+private:
+    /** The key for the Philox bijection; the first word is the seed. */
+    uint32_t mKey[2];
+
+    /** The counter for the next block; the first word is the block index within the stream. */
+    uint32_t mCounter[4];
+
+    /** The most recently generated block of random bits. */
+    uint32_t mBlock[4];
+
+    /** How many words of mBlock have been used so far (4 means a new block is needed). */
+    unsigned mNumWordsUsed;
+
+    /**
+     * @return the next 32 random bits in this stream.
+     */
+    uint32_t NextWord();
+
+public:
+    /**
+     * Constructor.
+     *
+     * @param seed  the global seed
+     * @param streamId  identifies the stream, e.g. a cell or node index
+     * @param timeStep  identifies the stream, e.g. the time step index
+     * @param purpose  identifies the stream, e.g. which random process the numbers are used for
+     */
+    CounterBasedRandomNumberGenerator(unsigned seed, unsigned streamId, unsigned timeStep = 0u, unsigned purpose = 0u);
+
+    /**
+     * Apply the Philox4x32-10 bijection.
+     *
+     * @param counter  the counter to encrypt
+     * @param key  the key
+     * @param output  the resulting 128 random bits
+     */
+    static void Philox4x32(const uint32_t counter[4], const uint32_t key[2], uint32_t output[4]);
+
+    /**
+     * @return a uniform random number in the open interval (0,1), with 53 random bits.
+     */
+    double ranf();
+
+    /**
+     * @return a random number from the normal distribution with mean 0
+     * and standard deviation 1 (using the Box-Muller transform).
+     */
+    double StandardNormalRandomDeviate();
+
+    /**
+     * @return a random number from a normal distribution with given
+     * mean and standard deviation.
+     *
+     * @param mean the mean of the normal distribution
+     * @param stdDev the standard deviation of the normal distribution
+     */
+    double NormalRandomDeviate(double mean, double stdDev);
+
+    /**
+     * @return a random number from an exponential distribution with the given
+     * scale parameter (as for RandomNumberGenerator, this is the rate, often named lambda).
+     *
+     * @param scale the scale parameter of the exponential distribution
+     */
+    double ExponentialRandomDeviate(double scale);
+
+    /**
+     * @return an unbiased random integer in the range [0, base).
+     *
+     * @param base the number of possible values; must be positive
+     */
+    unsigned randMod(unsigned base);
+
+    /**
+     * Produce a random permutation of the integers 0,1,..,num-1 using the
+     * Fisher-Yates algorithm.
+     *
+     * @param num  the number of integers to shuffle
+     * @param rValues  the output permutation (any initial values ignored)
+     */
+    void Shuffle(unsigned num, std::vector<unsigned>& rValues);
+
+    /**
+     * Jump to the given position in the stream, so that the next random number
+     * is generated from the given block.  Useful to resume a stream part-way through.
+     *
+     * @param blockIndex  the index of the block of 128 random bits to use next
+     */
+    void SetBlockIndex(unsigned blockIndex);
+};
+
+#endif /*COUNTERBASEDRANDOMNUMBERGENERATOR_HPP_*/
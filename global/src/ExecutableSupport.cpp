@@ -114,6 +114,11 @@ void ExecutableSupport::InitializePetsc(int* pArgc, char*** pArgv)
     // Store the arguments in case other code needs them
     CommandLineArguments::Instance()->p_argc = pArgc;
     CommandLineArguments::Instance()->p_argv = pArgv;
+    // Background output needs MPI with full thread support, which PETSc doesn't ask for
+    if (CommandLineArguments::Instance()->OptionExists("-mpi_thread_multiple"))
+    {
+        PetscSetupUtils::InitialiseMpiWithThreadSupport(pArgc, pArgv);
+    }
     // Initialise PETSc
     PETSCEXCEPT(PetscInitialize(pArgc, pArgv, PETSC_NULL, PETSC_NULL));
     // Set default output folder
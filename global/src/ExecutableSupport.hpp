@@ -52,7 +52,8 @@ class ExecutableSupport
 {
 public:
     /**
-     * Initialise PETSc from the command line arguments.
+     * Initialise PETSc from the command line arguments. With the option -mpi_thread_multiple,
+     * MPI is first initialised with MPI_THREAD_MULTIPLE support (needed for asynchronous output).
      *
      * @param pArgc  pointer to the number of arguments
      * @param pArgv  pointer to the argument list
@@ -0,0 +1,117 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "MemoryMappedFile.hpp"
+
+#ifndef _MSC_VER
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // _MSC_VER
+
+MemoryMappedFile::MemoryMappedFile()
+    : mpData(nullptr),
+      mSize(0)
+{
+}
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+    Close();
+}
+
+bool MemoryMappedFile::Open(const std::string& rFileName)
+{
+    Close();
+#ifdef _MSC_VER
+    return false;
+#else
+    int file_descriptor = open(rFileName.c_str(), O_RDONLY);
+    if (file_descriptor < 0)
+    {
+        return false;
+    }
+
+    struct stat file_status;
+    if (fstat(file_descriptor, &file_status) != 0 || file_status.st_size <= 0)
+    {
+        // Empty files cannot be mapped
+        close(file_descriptor);
+        return false;
+    }
+
+    std::size_t size = static_cast<std::size_t>(file_status.st_size);
+    void* p_mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+
+    // The mapping remains valid after the file descriptor is closed
+    close(file_descriptor);
+    if (p_mapping == MAP_FAILED)
+    {
+        return false; // LCOV_EXCL_LINE
+    }
+
+    mpData = static_cast<const char*>(p_mapping);
+    mSize = size;
+    return true;
+#endif // _MSC_VER
+}
+
+void MemoryMappedFile::Close()
+{
+#ifndef _MSC_VER
+    if (mpData)
+    {
+        munmap(const_cast<char*>(mpData), mSize);
+    }
+#endif // _MSC_VER
+    mpData = nullptr;
+    mSize = 0;
+}
+
+bool MemoryMappedFile::IsOpen() const
+{
+    return (mpData != nullptr);
+}
+
+const char* MemoryMappedFile::GetData() const
+{
+    return mpData;
+}
+
+std::size_t MemoryMappedFile::GetSize() const
+{
+    return mSize;
+}
@@ -0,0 +1,106 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef MEMORYMAPPEDFILE_HPP_
+#define MEMORYMAPPEDFILE_HPP_
+
+#include <cstddef>
+#include <string>
+#include <boost/utility.hpp>
+
+/**
+ * A read-only view of a whole file, mapped into memory with mmap().
+ *
+ * This gives cheap random access to large binary files (for example binary mesh
+ * files), since the operating system pages in only the parts that are used and
+ * no stream seeks or copies are required.
+ *
+ * Memory mapping is only available on POSIX platforms. Where it is not available,
+ * or the mapping fails, Open() returns false and callers should fall back to
+ * reading the file with a stream.
+ */
+class MemoryMappedFile : private boost::noncopyable
+{
+private:
+
+    /** The start of the mapped file, or NULL if no file is mapped. */
+    const char* mpData;
+
+    /** The size of the mapped file in bytes. */
+    std::size_t mSize;
+
+public:
+
+    /**
+     * Constructor. No file is mapped until Open() is called.
+     */
+    MemoryMappedFile();
+
+    /**
+     * Destructor. Unmaps the file, if one is mapped.
+     */
+    ~MemoryMappedFile();
+
+    /**
+     * Map a file into memory, unmapping any file previously mapped.
+     *
+     * @param rFileName  the path of the file to map
+     * @return whether the file was mapped; false if memory mapping is not
+     *     supported on this platform, or the file could not be mapped
+     */
+    bool Open(const std::string& rFileName);
+
+    /**
+     * Unmap the file, if one is mapped.
+     */
+    void Close();
+
+    /**
+     * @return whether a file is currently mapped.
+     */
+    bool IsOpen() const;
+
+    /**
+     * @return the start of the mapped file, or NULL if no file is mapped.
+     */
+    const char* GetData() const;
+
+    /**
+     * @return the size of the mapped file in bytes (zero if no file is mapped).
+     */
+    std::size_t GetSize() const;
+};
+
+#endif // MEMORYMAPPEDFILE_HPP_
@@ -46,12 +46,62 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "PetscTools.hpp" // For MPI methods
 #include "Exception.hpp"
 
+#include <sstream>
+#include <string>
+#include <cstring>
+
 const unsigned MAX_BUFFER_SIZE = 1000000;
 
+/**
+ * Converts objects sent by ObjectCommunicator to and from a string of bytes.
+ *
+ * By default this uses a boost binary archive, so works for any serializable class.
+ * Classes which are sent often may specialise this template with a more compact
+ * packing, as long as Pack() and Unpack() are inverses of each other.
+ */
+template <typename CLASS>
+class ObjectPacker
+{
+public:
+
+    /**
+     * Pack an object into a string of bytes.
+     *
+     * @param pObject the object to pack
+     * @param rBuffer filled in with the packed object
+     */
+    static void Pack(boost::shared_ptr<CLASS> const pObject, std::string& rBuffer)
+    {
+        std::ostringstream ss(std::ios::binary);
+        boost::archive::binary_oarchive output_arch(ss);
+        output_arch << pObject;
+        rBuffer = ss.str();
+    }
+
+    /**
+     * Unpack an object from a string of bytes created by Pack().
+     *
+     * @param pBuffer the packed object
+     * @param bufferLength the number of bytes in the buffer
+     * @return the object.
+     */
+    static boost::shared_ptr<CLASS> Unpack(const char* pBuffer, unsigned bufferLength)
+    {
+        std::string recv_string(pBuffer, bufferLength);
+        std::istringstream ss(recv_string, std::ios::binary);
+
+        boost::shared_ptr<CLASS> p_recv_object(new CLASS);
+        boost::archive::binary_iarchive input_arch(ss);
+        input_arch >> p_recv_object;
+
+        return p_recv_object;
+    }
+};
+
 /**
  * This is a helper class to enable classes that can be serialized to be sent using
  * PetSc MPI communication. The object is serialized in to a string of characters, and then
- * de-serialized on the receive process.
+ * de-serialized on the receive process, using ObjectPacker.
  */
 template <typename CLASS>
 class ObjectCommunicator
@@ -149,10 +199,6 @@ public:
     boost::shared_ptr<CLASS> SendRecvObject(boost::shared_ptr<CLASS> const pSendObject, unsigned destinationProcess, unsigned sendTag, unsigned sourceProcess, unsigned sourceTag, MPI_Status& status);
 };
 
-#include <sstream>
-#include <string>
-#include <cstring>
-
 // Implementation needs to be here, as CLASS could be anything
 template <typename CLASS>
 ObjectCommunicator<CLASS>::ObjectCommunicator()
@@ -165,13 +211,8 @@ ObjectCommunicator<CLASS>::ObjectCommunicator()
 template <typename CLASS>
 void ObjectCommunicator<CLASS>::SendObject(boost::shared_ptr<CLASS> const pObject, unsigned destinationProcess, unsigned tag)
 {
-    // Create an output archive
-    std::ostringstream ss(std::ios::binary);
-    boost::archive::binary_oarchive output_arch(ss);
-
-    output_arch << pObject;
-
-    const std::string send_msg = ss.str();
+    std::string send_msg;
+    ObjectPacker<CLASS>::Pack(pObject, send_msg);
 
     // Get + send string length
     unsigned string_length = send_msg.size();
@@ -188,13 +229,7 @@ void ObjectCommunicator<CLASS>::ISendObject(boost::shared_ptr<CLASS> const pObje
 {
     MPI_Request request;
 
-     // Create an output archive
-    std::ostringstream ss(std::ios::binary);
-    boost::archive::binary_oarchive output_arch(ss);
-
-    output_arch << pObject;
-
-    mSendString[destinationProcess] = ss.str();
+    ObjectPacker<CLASS>::Pack(pObject, mSendString[destinationProcess]);
     mSendBufferLength = mSendString[destinationProcess].size();
 
     // Make sure we are not going to overrun the asynchronous buffer size.
@@ -217,14 +252,8 @@ boost::shared_ptr<CLASS> ObjectCommunicator<CLASS>::RecvObject(unsigned sourcePr
     MPI_Recv(recv_array, string_length, MPI_BYTE, sourceProcess , tag, PetscTools::GetWorld(), &status);
 
     // Extract a proper object from the buffer
-    std::string recv_string(recv_array, string_length);
+    boost::shared_ptr<CLASS> p_recv_object = ObjectPacker<CLASS>::Unpack(recv_array, string_length);
     delete[] recv_array;
-    std::istringstream ss(recv_string, std::ios::binary);
-
-    boost::shared_ptr<CLASS> p_recv_object(new CLASS);
-    boost::archive::binary_iarchive input_arch(ss);
-
-    input_arch >> p_recv_object;
 
     return p_recv_object;
 }
@@ -256,13 +285,7 @@ boost::shared_ptr<CLASS> ObjectCommunicator<CLASS>::GetRecvObject()
     MPI_Get_count(&return_status, MPI_BYTE, &recv_size);
 
     // Extract a proper object from the buffer
-    std::string recv_string(mRecvBuffer, recv_size);
-    std::istringstream ss(recv_string, std::ios::binary);
-
-    boost::shared_ptr<CLASS> p_recv_object(new CLASS);
-    boost::archive::binary_iarchive input_arch(ss);
-
-    input_arch >> p_recv_object;
+    boost::shared_ptr<CLASS> p_recv_object = ObjectPacker<CLASS>::Unpack(mRecvBuffer, recv_size);
 
     // Tidy up
     delete[] mRecvBuffer;
@@ -275,13 +298,8 @@ boost::shared_ptr<CLASS> ObjectCommunicator<CLASS>::GetRecvObject()
 template <typename CLASS>
 boost::shared_ptr<CLASS> ObjectCommunicator<CLASS>::SendRecvObject(boost::shared_ptr<CLASS> const pSendObject, unsigned destinationProcess, unsigned sendTag, unsigned sourceProcess, unsigned sourceTag, MPI_Status& status)
 {
-    // Create an output archive
-    std::ostringstream oss(std::ios::binary);
-    boost::archive::binary_oarchive output_arch(oss);
-
-    output_arch << pSendObject;
-
-    std::string send_msg = oss.str();
+    std::string send_msg;
+    ObjectPacker<CLASS>::Pack(pSendObject, send_msg);
 
     // Get + send string length
     unsigned send_string_length = send_msg.size();
@@ -296,15 +314,7 @@ boost::shared_ptr<CLASS> ObjectCommunicator<CLASS>::SendRecvObject(boost::shared
     MPI_Sendrecv(send_buf, send_string_length, MPI_BYTE, destinationProcess, sendTag, recv_array.get(), recv_string_length, MPI_BYTE, sourceProcess, sourceTag, PetscTools::GetWorld(), &status);
 
     // Extract received object
-    std::string recv_string(recv_array.get(), recv_string_length);
-    std::istringstream iss(recv_string, std::ios::binary);
-
-    boost::shared_ptr<CLASS> p_recv_object(new CLASS);
-    boost::archive::binary_iarchive input_arch(iss);
-
-    input_arch >> p_recv_object;
-
-    return p_recv_object;
+    return ObjectPacker<CLASS>::Unpack(recv_array.get(), recv_string_length);
 }
 
 #endif // _OBJECTCOMMUNICATOR_HPP_
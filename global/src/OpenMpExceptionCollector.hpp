@@ -0,0 +1,95 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef OPENMPEXCEPTIONCOLLECTOR_HPP_
+#define OPENMPEXCEPTIONCOLLECTOR_HPP_
+
+#include <exception>
+
+/**
+ * Exceptions must not escape an OpenMP parallel region, so a loop run on several
+ * threads catches them in each iteration and passes them to one of these, which
+ * keeps the first. Once the loop is done it is re-thrown on the calling thread:
+ *
+ *     OpenMpExceptionCollector exception_collector;
+ *     #pragma omp parallel for
+ *     for (int i=0; i<n; i++)
+ *     {
+ *         try
+ *         {
+ *             ...
+ *         }
+ *         catch (...)
+ *         {
+ *             exception_collector.Capture();
+ *         }
+ *     }
+ *     exception_collector.RethrowIfAny();
+ *
+ * Without OpenMP the same code simply defers the exception to the end of the loop.
+ */
+class OpenMpExceptionCollector
+{
+private:
+
+    /** The first exception captured, if any. */
+    std::exception_ptr mpException;
+
+public:
+
+    /**
+     * Constructor.
+     */
+    OpenMpExceptionCollector();
+
+    /**
+     * Keep the exception currently being handled, unless an exception has already
+     * been captured. Must be called from a catch block. May be called from several
+     * threads at once.
+     */
+    void Capture();
+
+    /**
+     * @return whether an exception has been captured.
+     */
+    bool HasException() const;
+
+    /**
+     * Re-throw the captured exception, if any, so that the collector can be used again.
+     */
+    void RethrowIfAny();
+};
+
+#endif /*OPENMPEXCEPTIONCOLLECTOR_HPP_*/
@@ -60,7 +60,17 @@ std::string OutputDirectoryFifoQueue::CreateNextDir(const std::string& rSubdirec
         FileFinder dir_to_remove(mBaseDirectory + "/" + mQueue.front(), RelativeTo::ChasteTestOutput);
         if (PetscTools::AmMaster())
         {
-            ABORT_IF_THROWS(dir_to_remove.Remove());
+            if (mpRemovalChannel)
+            {
+                mpRemovalChannel->Submit([dir_to_remove]()
+                {
+                    dir_to_remove.Remove();
+                });
+            }
+            else
+            {
+                ABORT_IF_THROWS(dir_to_remove.Remove());
+            }
         }
         PetscTools::Barrier("OutputDirectoryFifoQueue::CreateNextDir");
 
@@ -74,3 +84,25 @@ std::string OutputDirectoryFifoQueue::CreateNextDir(const std::string& rSubdirec
 
     return subdirectory_full_name;
 }
+
+void OutputDirectoryFifoQueue::SetRemoveDirectoriesAsynchronously(bool removeAsynchronously)
+{
+    Flush();
+    if (removeAsynchronously)
+    {
+        mpRemovalChannel.reset(new AsynchronousIoChannel(mQueueMaxSize == 0 ? 1 : mQueueMaxSize));
+    }
+    else
+    {
+        mpRemovalChannel.reset();
+    }
+}
+
+void OutputDirectoryFifoQueue::Flush()
+{
+    if (mpRemovalChannel)
+    {
+        mpRemovalChannel->Flush();
+    }
+    PetscTools::Barrier("OutputDirectoryFifoQueue::Flush");
+}
@@ -38,6 +38,9 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <string>
 #include <queue>
+#include <boost/shared_ptr.hpp>
+
+#include "AsynchronousIoChannel.hpp"
 
 /**
  * This is a helper class to handle a FIFO collection of subdirectories.
@@ -46,6 +49,8 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  * in the constructor. The maximum number of concurrent subdirectories is
  * specified in the the constructor. Once this number is reached, the next
  * call to CreateNextDir() will delete the oldest directory as a side effect.
+ * The deletion may optionally be done on an I/O worker thread (see
+ * SetRemoveDirectoriesAsynchronously()), so that the caller does not wait for it.
  */
 class OutputDirectoryFifoQueue
 {
@@ -55,6 +60,9 @@ private:
     unsigned mQueueMaxSize; /**< Maximum number of subdirectories*/
     std::queue<std::string> mQueue;  /**<The queue of names of subdirectories currently on the disk*/
 
+    /** The channel used to delete old subdirectories in the background, if this is enabled. */
+    boost::shared_ptr<AsynchronousIoChannel> mpRemovalChannel;
+
 public:
 
     /**
@@ -75,6 +83,22 @@ public:
      * @return new directory name relative to the base directory
      */
     std::string CreateNextDir(const std::string& rSubdirectoryName);
+
+    /**
+     * Set whether the oldest subdirectory should be deleted on an I/O worker
+     * thread, rather than before CreateNextDir() returns. Any error in deleting
+     * it is then reported by a later call to CreateNextDir() or Flush().
+     *
+     * @param removeAsynchronously whether to delete old subdirectories in the background
+     */
+    void SetRemoveDirectoriesAsynchronously(bool removeAsynchronously=true);
+
+    /**
+     * Wait until any background deletion of old subdirectories has finished.
+     *
+     * @note Must be called collectively.
+     */
+    void Flush();
 };
 
 #endif /*OUTPUTDIRECTORYFIFOQUEUE_HPP_*/
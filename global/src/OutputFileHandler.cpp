@@ -38,6 +38,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <cstdlib>
 #include <fstream>
 #include <sstream>
+#include <vector>
 
 #include "ArchiveLocationInfo.hpp"
 #include "BoostFilesystem.hpp"
@@ -49,6 +50,50 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 const std::string OutputFileHandler::SIG_FILE_NAME(".chaste_deletable_folder");
 
+unsigned OutputFileHandler::msOutputBufferSize = 65536u;
+
+/**
+ * An output file stream which owns a (typically larger than default)
+ * buffer.  It is handed out as an out_stream, so callers still see a
+ * plain std::ofstream.
+ */
+class BufferedOutputFileStream : public std::ofstream
+{
+ public:
+  /**
+   * Give the stream its buffer, then open the file.  The buffer must be
+   * set before opening for it to take effect.
+   *
+   * @param rPath  full path of the file to open
+   * @param mode  flags to use when opening the file
+   * @param bufferSize  the buffer size in bytes (0 for the library default)
+   */
+  BufferedOutputFileStream(const std::string& rPath, std::ios_base::openmode mode, unsigned bufferSize)
+    : std::ofstream(),
+      mBuffer(bufferSize)
+  {
+    if (bufferSize > 0u) {
+      rdbuf()->pubsetbuf(&mBuffer[0], bufferSize);
+    }
+    open(rPath.c_str(), mode);
+  }
+
+  /**
+   * Close the file (writing out anything pending) before the buffer
+   * itself is destroyed.
+   */
+  ~BufferedOutputFileStream()
+  {
+    if (is_open()) {
+      close();
+    }
+  }
+
+ private:
+  /** Storage for the stream buffer. */
+  std::vector<char> mBuffer;
+};
+
 /**
  * Recursively remove the contents of the given folder, but leave any hidden
  * files present at the top level.
@@ -251,8 +296,8 @@ out_stream OutputFileHandler::OpenOutputFile(
     const std::string& rFileName
   , std::ios_base::openmode mode) const
 {
-  out_stream p_output_file(new std::ofstream(
-      (mDirectory + rFileName).c_str(), mode));
+  out_stream p_output_file(new BufferedOutputFileStream(
+      mDirectory + rFileName, mode, msOutputBufferSize));
   if (!p_output_file->is_open()) {
     EXCEPTION("Could not open file \"" + rFileName + "\" in " + mDirectory);
   }
@@ -270,6 +315,16 @@ out_stream OutputFileHandler::OpenOutputFile(
   return OpenOutputFile(string_stream.str(), mode);
 }
 
+void OutputFileHandler::SetOutputBufferSize(unsigned bufferSize)
+{
+  msOutputBufferSize = bufferSize;
+}
+
+unsigned OutputFileHandler::GetOutputBufferSize()
+{
+  return msOutputBufferSize;
+}
+
 void OutputFileHandler::SetArchiveDirectory() const
 {
   FileFinder dir(GetOutputDirectoryFullPath(), RelativeTo::Absolute);
@@ -162,6 +162,22 @@ class OutputFileHandler
     , const std::string& rFileFormat
     , std::ios_base::openmode mode = std::ios::out | std::ios::trunc) const;
 
+  /**
+   * Set the size of the buffer given to each stream opened by
+   * OpenOutputFile from now on.  Larger buffers mean fewer, larger
+   * writes; a size of zero means use the standard library default.
+   * Note that an explicit flush (including std::endl) still writes the
+   * buffer out, so hot loops should prefer '\n'.
+   *
+   * @param bufferSize  the buffer size in bytes (defaults to 64 KiB)
+   */
+  static void SetOutputBufferSize(unsigned bufferSize);
+
+  /**
+   * @return the buffer size given to each stream opened by OpenOutputFile.
+   */
+  static unsigned GetOutputBufferSize();
+
   /**
    * Copy the given file to this output directory.
    *
@@ -189,6 +205,9 @@ class OutputFileHandler
   /** The directory to store output files in (always ends in "/") */
   std::string mDirectory;
 
+  /** The buffer size given to each stream opened by OpenOutputFile. */
+  static unsigned msOutputBufferSize;
+
   /**
    * Functionality common to both constructors.
    *
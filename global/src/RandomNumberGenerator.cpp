@@ -48,10 +48,11 @@ RandomNumberGenerator::RandomNumberGenerator()
         : mMersenneTwisterGenerator(0u),
           mGenerateUnitReal(mMersenneTwisterGenerator, boost::uniform_real<>()),
 #if BOOST_VERSION < 106400 // #2585 and #2893
-          mGenerateStandardNormal(mMersenneTwisterGenerator, boost::random::normal_distribution_v165<>(0.0, 1.0))
+          mGenerateStandardNormal(mMersenneTwisterGenerator, boost::random::normal_distribution_v165<>(0.0, 1.0)),
 #else
-          mGenerateStandardNormal(mMersenneTwisterGenerator, boost::normal_distribution<>(0.0, 1.0))
+          mGenerateStandardNormal(mMersenneTwisterGenerator, boost::normal_distribution<>(0.0, 1.0)),
 #endif
+          mSeed(0u)
 {
     assert(mpInstance == nullptr); // Ensure correct serialization
 }
@@ -153,6 +154,7 @@ double RandomNumberGenerator::ExponentialRandomDeviate(double scale)
 void RandomNumberGenerator::Reseed(unsigned seed)
 {
     mMersenneTwisterGenerator.seed(seed);
+    mSeed = seed;
 
     // Because this does some Box-Muller type thing it remembers if you don't reset it - see #2633
     mGenerateStandardNormal.distribution().reset();
@@ -178,3 +180,8 @@ void RandomNumberGenerator::Shuffle(unsigned num, std::vector<unsigned>& rValues
         rValues[k] = temp;
     }
 }
+
+CounterBasedRandomNumberGenerator RandomNumberGenerator::GetStream(unsigned streamId, unsigned timeStep, unsigned purpose) const
+{
+    return CounterBasedRandomNumberGenerator(mSeed, streamId, timeStep, purpose);
+}
@@ -49,7 +49,9 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <boost/serialization/split_member.hpp>
 #include "ChasteSerialization.hpp"
+#include "ChasteSerializationVersion.hpp"
 #include "SerializableSingleton.hpp"
+#include "CounterBasedRandomNumberGenerator.hpp"
 
 /**
  * A special singleton class allowing one to generate different types of
@@ -95,6 +97,9 @@ private:
 #else
     boost::variate_generator<boost::mt19937&, boost::normal_distribution<> > mGenerateStandardNormal;
 #endif
+    /** The seed last given to Reseed(), used to key counter-based streams. */
+    unsigned mSeed;
+
     /** Pointer to the single instance. */
     static RandomNumberGenerator* mpInstance;
 
@@ -125,6 +130,11 @@ private:
         normal_internals << r_normal_dist;
         std::string normal_internals_string = normal_internals.str();
         archive& normal_internals_string;
+
+        if (version > 0)
+        {
+            archive& mSeed;
+        }
     }
 
     /**
@@ -148,6 +158,11 @@ private:
         archive& normal_internals_string;
         std::stringstream normal_internals(normal_internals_string);
         normal_internals >> mGenerateStandardNormal.distribution();
+
+        if (version > 0)
+        {
+            archive& mSeed;
+        }
     }
     BOOST_SERIALIZATION_SPLIT_MEMBER()
 
@@ -259,6 +274,20 @@ public:
      * @param seed the new seed
      */
     void Reseed(unsigned seed);
+
+    /**
+     * @return an independent counter-based random number stream, keyed by the seed last
+     * given to Reseed() and the given identifiers.  The stream holds no shared state, so
+     * (unlike the other methods of this class) this may be called from any thread, and the
+     * numbers drawn from it do not depend on what else has been drawn from this generator.
+     *
+     * @param streamId  identifies the stream, e.g. a cell ID
+     * @param timeStep  identifies the stream, e.g. the current time step index
+     * @param purpose  identifies the stream, e.g. which random process the numbers are used for
+     */
+    CounterBasedRandomNumberGenerator GetStream(unsigned streamId, unsigned timeStep = 0u, unsigned purpose = 0u) const;
 };
 
+BOOST_CLASS_VERSION(RandomNumberGenerator, 1)
+
 #endif /*RANDOMNUMBERGENERATORS_HPP_*/
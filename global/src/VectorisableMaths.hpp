@@ -0,0 +1,183 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef VECTORISABLEMATHS_HPP_
+#define VECTORISABLEMATHS_HPP_
+
+/**
+ * @file
+ * Wrappers for the transcendental functions used by cell model right-hand sides.
+ *
+ * Generated cell models (PyCml's --vectorisable-maths option) and the batched cell
+ * backends call these rather than the <cmath> functions directly, so that the maths
+ * library can be chosen at build time.  By default the wrappers forward to <cmath>.
+ * If Chaste is built with Chaste_USE_SLEEF (which defines CHASTE_SLEEF) they call
+ * the SLEEF library instead, which provides SIMD implementations with a documented
+ * maximum error.  The 1.0-ULP variants are used unless CHASTE_SLEEF_ULP35 is also
+ * defined, in which case the faster 3.5-ULP variants are used.
+ *
+ * The array versions apply a function element-wise and are the ones to use in batched
+ * kernels: with SLEEF they evaluate two lanes at a time using SSE2.
+ */
+
+#include <cmath>
+
+#ifdef CHASTE_SLEEF
+#include <sleef.h>
+#ifdef CHASTE_SLEEF_ULP35
+#define CHASTE_SLEEF_FN(name) Sleef_ ## name ## _u35
+#define CHASTE_SLEEF_FN2(name) Sleef_ ## name ## d2_u35
+#else
+#define CHASTE_SLEEF_FN(name) Sleef_ ## name ## _u10
+#define CHASTE_SLEEF_FN2(name) Sleef_ ## name ## d2_u10
+#endif // CHASTE_SLEEF_ULP35
+#endif // CHASTE_SLEEF
+
+/**
+ * @return the maximum error, in units in the last place, of the exp, log and pow wrappers
+ * in this build.  Zero means that the <cmath> functions are used, whose accuracy is
+ * that of the system maths library.
+ */
+inline double GetVectorisableMathsMaxUlpError()
+{
+#ifdef CHASTE_SLEEF
+#ifdef CHASTE_SLEEF_ULP35
+    return 3.5;
+#else
+    return 1.0;
+#endif // CHASTE_SLEEF_ULP35
+#else
+    return 0.0;
+#endif // CHASTE_SLEEF
+}
+
+/**
+ * @return e^x
+ * @param x  the exponent
+ */
+inline double VecExp(double x)
+{
+#ifdef CHASTE_SLEEF
+    return Sleef_exp_u10(x);
+#else
+    return std::exp(x);
+#endif // CHASTE_SLEEF
+}
+
+/**
+ * @return the natural logarithm of x
+ * @param x  the argument
+ */
+inline double VecLog(double x)
+{
+#ifdef CHASTE_SLEEF
+    return CHASTE_SLEEF_FN(log)(x);
+#else
+    return std::log(x);
+#endif // CHASTE_SLEEF
+}
+
+/**
+ * @return x^y
+ * @param x  the base
+ * @param y  the exponent
+ */
+inline double VecPow(double x, double y)
+{
+#ifdef CHASTE_SLEEF
+    return Sleef_pow_u10(x, y);
+#else
+    return std::pow(x, y);
+#endif // CHASTE_SLEEF
+}
+
+/**
+ * @return tanh(x)
+ * @param x  the argument
+ */
+inline double VecTanh(double x)
+{
+#ifdef CHASTE_SLEEF
+    return CHASTE_SLEEF_FN(tanh)(x);
+#else
+    return std::tanh(x);
+#endif // CHASTE_SLEEF
+}
+
+/**
+ * Compute pOut[i] = e^pIn[i] for i = 0, ..., size-1.  The arrays may be the same.
+ *
+ * @param pIn  the exponents
+ * @param pOut  the results
+ * @param size  the number of entries
+ */
+inline void VecExp(const double* pIn, double* pOut, unsigned size)
+{
+    unsigned i = 0;
+#if defined(CHASTE_SLEEF) && defined(__SSE2__)
+    for (; i+1 < size; i += 2)
+    {
+        _mm_storeu_pd(pOut+i, Sleef_expd2_u10(_mm_loadu_pd(pIn+i)));
+    }
+#endif
+    for (; i < size; i++)
+    {
+        pOut[i] = VecExp(pIn[i]);
+    }
+}
+
+/**
+ * Compute pOut[i] = log(pIn[i]) for i = 0, ..., size-1.  The arrays may be the same.
+ *
+ * @param pIn  the arguments
+ * @param pOut  the results
+ * @param size  the number of entries
+ */
+inline void VecLog(const double* pIn, double* pOut, unsigned size)
+{
+    unsigned i = 0;
+#if defined(CHASTE_SLEEF) && defined(__SSE2__)
+    for (; i+1 < size; i += 2)
+    {
+        _mm_storeu_pd(pOut+i, CHASTE_SLEEF_FN2(log)(_mm_loadu_pd(pIn+i)));
+    }
+#endif
+    for (; i < size; i++)
+    {
+        pOut[i] = VecLog(pIn[i]);
+    }
+}
+
+#endif /*VECTORISABLEMATHS_HPP_*/
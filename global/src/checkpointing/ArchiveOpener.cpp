@@ -36,6 +36,8 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // Must be included before any other serialization headers
 #include <boost/archive/text_oarchive.hpp>
 #include <boost/archive/text_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/binary_iarchive.hpp>
 
 #include <sstream>
 #include <fstream>
@@ -47,20 +49,26 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "OutputFileHandler.hpp"
 
 /**
- * Specialization for input archives.
- * @param rDirectory
- * @param rFileNameBase
- * @param procId
+ * Open the main and secondary archives for reading. This is shared by the
+ * specializations for input archives.
+ *
+ * @param rDirectory  folder containing archive files
+ * @param rFileNameBase  base name of archive files
+ * @param procId  which secondary archive to read
+ * @param rpCommonStream  set to the file stream for the main archive
+ * @param rpPrivateStream  set to the file stream for the secondary archive
+ * @param rpCommonArchive  set to the main archive
+ * @param rpPrivateArchive  set to the secondary archive
  */
-template <>
-ArchiveOpener<boost::archive::text_iarchive, std::ifstream>::ArchiveOpener(
+template <class ARCHIVE, class STREAM>
+static void OpenInputArchives(
     const FileFinder& rDirectory
   , const std::string& rFileNameBase
-  , unsigned procId)
-  : mpCommonStream(nullptr),
-    mpPrivateStream(nullptr),
-    mpCommonArchive(nullptr),
-    mpPrivateArchive(nullptr)
+  , unsigned procId
+  , STREAM*& rpCommonStream
+  , STREAM*& rpPrivateStream
+  , ARCHIVE*& rpCommonArchive
+  , ARCHIVE*& rpPrivateArchive)
 {
   // Figure out where things live
   ArchiveLocationInfo::SetArchiveDirectory(rDirectory);
@@ -70,23 +78,23 @@ ArchiveOpener<boost::archive::text_iarchive, std::ifstream>::ArchiveOpener(
   common_path << ArchiveLocationInfo::GetArchiveDirectory() << rFileNameBase;
 
   // Try to open the main archive for replicated data
-  mpCommonStream = new std::ifstream(common_path.str().c_str(),
+  rpCommonStream = new STREAM(common_path.str().c_str(),
       std::ios::binary);
-  if (!mpCommonStream->is_open()) {
-    delete mpCommonStream;
+  if (!rpCommonStream->is_open()) {
+    delete rpCommonStream;
     EXCEPTION("Cannot load main archive file: " + common_path.str());
   }
 
   try {
-    mpCommonArchive = new boost::archive::text_iarchive(*mpCommonStream);
+    rpCommonArchive = new ARCHIVE(*rpCommonStream);
   }
   catch (boost::archive::archive_exception& boost_exception) {
     if (boost_exception.code ==
         boost::archive::archive_exception::unsupported_version) {
       // This is forward compatibility issue.  We can't open the
       // archive because it's been written by a more recent Boost.
-      delete mpCommonArchive;
-      delete mpCommonStream;
+      delete rpCommonArchive;
+      delete rpCommonStream;
       EXCEPTION("Could not open Boost archive '" + common_path.str() +
           "' because it was written by a more recent Boost.  Check "
           "process-specific archives too");
@@ -98,44 +106,62 @@ ArchiveOpener<boost::archive::text_iarchive, std::ifstream>::ArchiveOpener(
   }
 
   // Try to open the secondary archive for distributed data
-  mpPrivateStream = new std::ifstream(private_path.c_str(),
+  rpPrivateStream = new STREAM(private_path.c_str(),
       std::ios::binary);
-  if (!mpPrivateStream->is_open()) {
-    delete mpPrivateStream;
-    delete mpCommonArchive;
-    delete mpCommonStream;
+  if (!rpPrivateStream->is_open()) {
+    delete rpPrivateStream;
+    delete rpCommonArchive;
+    delete rpCommonStream;
     EXCEPTION("Cannot load secondary archive file: " + private_path);
   }
-  mpPrivateArchive = new boost::archive::text_iarchive(*mpPrivateStream);
-  ProcessSpecificArchive<boost::archive::text_iarchive>::Set(
-      mpPrivateArchive);
+  rpPrivateArchive = new ARCHIVE(*rpPrivateStream);
+  ProcessSpecificArchive<ARCHIVE>::Set(
+      rpPrivateArchive);
 }
 
-template <>
-ArchiveOpener<boost::archive::text_iarchive, std::ifstream>::~ArchiveOpener()
+/**
+ * Close the archives opened by OpenInputArchives().
+ *
+ * @param rpCommonStream  the file stream for the main archive
+ * @param rpPrivateStream  the file stream for the secondary archive
+ * @param rpCommonArchive  the main archive
+ * @param rpPrivateArchive  the secondary archive
+ */
+template <class ARCHIVE, class STREAM>
+static void CloseInputArchives(
+    STREAM*& rpCommonStream
+  , STREAM*& rpPrivateStream
+  , ARCHIVE*& rpCommonArchive
+  , ARCHIVE*& rpPrivateArchive)
 {
-  ProcessSpecificArchive<boost::archive::text_iarchive>::Set(nullptr);
-  delete mpPrivateArchive;
-  delete mpPrivateStream;
-  delete mpCommonArchive;
-  delete mpCommonStream;
+  ProcessSpecificArchive<ARCHIVE>::Set(nullptr);
+  delete rpPrivateArchive;
+  delete rpPrivateStream;
+  delete rpCommonArchive;
+  delete rpCommonStream;
 }
 
 /**
- * Specialization for output archives.
- * @param rDirectory
- * @param rFileNameBase
- * @param procId
+ * Open the main and secondary archives for writing. This is shared by the
+ * specializations for output archives.
+ *
+ * @param rDirectory  folder to contain archive files
+ * @param rFileNameBase  base name of archive files
+ * @param procId  must be this process' rank
+ * @param rpCommonStream  set to the file stream for the main archive
+ * @param rpPrivateStream  set to the file stream for the secondary archive
+ * @param rpCommonArchive  set to the main archive
+ * @param rpPrivateArchive  set to the secondary archive
  */
-template <>
-ArchiveOpener<boost::archive::text_oarchive, std::ofstream>::ArchiveOpener(
+template <class ARCHIVE, class STREAM>
+static void OpenOutputArchives(
     const FileFinder& rDirectory
   , const std::string& rFileNameBase
-  , unsigned procId)
-  : mpCommonStream(nullptr),
-    mpPrivateStream(nullptr),
-    mpCommonArchive(nullptr),
-    mpPrivateArchive(nullptr)
+  , unsigned procId
+  , STREAM*& rpCommonStream
+  , STREAM*& rpPrivateStream
+  , ARCHIVE*& rpCommonArchive
+  , ARCHIVE*& rpPrivateArchive)
 {
   // Check for user error
   if (procId != PetscTools::GetMyRank()) {
@@ -157,10 +183,10 @@ ArchiveOpener<boost::archive::text_oarchive, std::ofstream>::ArchiveOpener(
 
   // Create master archive for replicated data
   if (PetscTools::AmMaster()) {
-    mpCommonStream = new std::ofstream(common_path.str().c_str(),
+    rpCommonStream = new STREAM(common_path.str().c_str(),
         std::ios::binary | std::ios::trunc);
-    if (!mpCommonStream->is_open()) {
-      delete mpCommonStream;
+    if (!rpCommonStream->is_open()) {
+      delete rpCommonStream;
       EXCEPTION("Failed to open main archive file for writing: " +
           common_path.str());
     }
@@ -169,44 +195,56 @@ ArchiveOpener<boost::archive::text_oarchive, std::ofstream>::ArchiveOpener(
     // Non-master processes need to go through the serialization
     // methods, but not write any data
 #ifdef _MSC_VER
-    mpCommonStream = new std::ofstream("NUL", std::ios::binary |
+    rpCommonStream = new STREAM("NUL", std::ios::binary |
         std::ios::trunc);
 #else
-    mpCommonStream = new std::ofstream("/dev/null", std::ios::binary |
+    rpCommonStream = new STREAM("/dev/null", std::ios::binary |
         std::ios::trunc);
 #endif
     // LCOV_EXCL_START
-    if (!mpCommonStream->is_open()) {
-      delete mpCommonStream;
+    if (!rpCommonStream->is_open()) {
+      delete rpCommonStream;
       EXCEPTION("Failed to open dummy archive file '/dev/null' for writing");
     }
     // LCOV_EXCL_STOP
   }
-  mpCommonArchive = new boost::archive::text_oarchive(*mpCommonStream);
+  rpCommonArchive = new ARCHIVE(*rpCommonStream);
 
   // Create secondary archive for distributed data
-  mpPrivateStream = new std::ofstream(private_path.c_str(),
+  rpPrivateStream = new STREAM(private_path.c_str(),
       std::ios::binary | std::ios::trunc);
-  if (!mpPrivateStream->is_open()) {
-    delete mpPrivateStream;
-    delete mpCommonArchive;
-    delete mpCommonStream;
+  if (!rpPrivateStream->is_open()) {
+    delete rpPrivateStream;
+    delete rpCommonArchive;
+    delete rpCommonStream;
     EXCEPTION("Failed to open secondary archive file for writing: " +
         private_path);
   }
-  mpPrivateArchive = new boost::archive::text_oarchive(*mpPrivateStream);
-  ProcessSpecificArchive<boost::archive::text_oarchive>::Set(
-      mpPrivateArchive);
+  rpPrivateArchive = new ARCHIVE(*rpPrivateStream);
+  ProcessSpecificArchive<ARCHIVE>::Set(
+      rpPrivateArchive);
 }
 
-template <>
-ArchiveOpener<boost::archive::text_oarchive, std::ofstream>::~ArchiveOpener()
+/**
+ * Close the archives opened by OpenOutputArchives().
+ *
+ * @param rpCommonStream  the file stream for the main archive
+ * @param rpPrivateStream  the file stream for the secondary archive
+ * @param rpCommonArchive  the main archive
+ * @param rpPrivateArchive  the secondary archive
+ */
+template <class ARCHIVE, class STREAM>
+static void CloseOutputArchives(
+    STREAM*& rpCommonStream
+  , STREAM*& rpPrivateStream
+  , ARCHIVE*& rpCommonArchive
+  , ARCHIVE*& rpPrivateArchive)
 {
-  ProcessSpecificArchive<boost::archive::text_oarchive>::Set(nullptr);
-  delete mpPrivateArchive;
-  delete mpPrivateStream;
-  delete mpCommonArchive;
-  delete mpCommonStream;
+  ProcessSpecificArchive<ARCHIVE>::Set(nullptr);
+  delete rpPrivateArchive;
+  delete rpPrivateStream;
+  delete rpCommonArchive;
+  delete rpCommonStream;
 
   /*
    * In a parallel setting, make sure all processes have finished
@@ -216,3 +254,219 @@ ArchiveOpener<boost::archive::text_oarchive, std::ofstream>::~ArchiveOpener()
    */
   PetscTools::Barrier("~ArchiveOpener");
 }
+
+/**
+ * Specialization for text input archives.
+ * @param rDirectory
+ * @param rFileNameBase
+ * @param procId
+ */
+template <>
+ArchiveOpener<boost::archive::text_iarchive, std::ifstream>::ArchiveOpener(
+    const FileFinder& rDirectory
+  , const std::string& rFileNameBase
+  , unsigned procId)
+  : mpCommonStream(nullptr),
+    mpPrivateStream(nullptr),
+    mpCommonArchive(nullptr),
+    mpPrivateArchive(nullptr)
+{
+  OpenInputArchives(rDirectory, rFileNameBase, procId,
+      mpCommonStream, mpPrivateStream, mpCommonArchive, mpPrivateArchive);
+}
+
+template <>
+ArchiveOpener<boost::archive::text_iarchive, std::ifstream>::~ArchiveOpener()
+{
+  CloseInputArchives(mpCommonStream, mpPrivateStream, mpCommonArchive,
+      mpPrivateArchive);
+}
+
+/**
+ * Specialization for binary input archives.
+ * @param rDirectory
+ * @param rFileNameBase
+ * @param procId
+ */
+template <>
+ArchiveOpener<boost::archive::binary_iarchive, std::ifstream>::ArchiveOpener(
+    const FileFinder& rDirectory
+  , const std::string& rFileNameBase
+  , unsigned procId)
+  : mpCommonStream(nullptr),
+    mpPrivateStream(nullptr),
+    mpCommonArchive(nullptr),
+    mpPrivateArchive(nullptr)
+{
+  OpenInputArchives(rDirectory, rFileNameBase, procId,
+      mpCommonStream, mpPrivateStream, mpCommonArchive, mpPrivateArchive);
+}
+
+template <>
+ArchiveOpener<boost::archive::binary_iarchive, std::ifstream>::~ArchiveOpener()
+{
+  CloseInputArchives(mpCommonStream, mpPrivateStream, mpCommonArchive,
+      mpPrivateArchive);
+}
+
+/**
+ * Specialization for text output archives.
+ * @param rDirectory
+ * @param rFileNameBase
+ * @param procId
+ */
+template <>
+ArchiveOpener<boost::archive::text_oarchive, std::ofstream>::ArchiveOpener(
+    const FileFinder& rDirectory
+  , const std::string& rFileNameBase
+  , unsigned procId)
+  : mpCommonStream(nullptr),
+    mpPrivateStream(nullptr),
+    mpCommonArchive(nullptr),
+    mpPrivateArchive(nullptr)
+{
+  OpenOutputArchives(rDirectory, rFileNameBase, procId,
+      mpCommonStream, mpPrivateStream, mpCommonArchive, mpPrivateArchive);
+}
+
+template <>
+ArchiveOpener<boost::archive::text_oarchive, std::ofstream>::~ArchiveOpener()
+{
+  CloseOutputArchives(mpCommonStream, mpPrivateStream, mpCommonArchive,
+      mpPrivateArchive);
+}
+
+/**
+ * Specialization for binary output archives.
+ * @param rDirectory
+ * @param rFileNameBase
+ * @param procId
+ */
+template <>
+ArchiveOpener<boost::archive::binary_oarchive, std::ofstream>::ArchiveOpener(
+    const FileFinder& rDirectory
+  , const std::string& rFileNameBase
+  , unsigned procId)
+  : mpCommonStream(nullptr),
+    mpPrivateStream(nullptr),
+    mpCommonArchive(nullptr),
+    mpPrivateArchive(nullptr)
+{
+  OpenOutputArchives(rDirectory, rFileNameBase, procId,
+      mpCommonStream, mpPrivateStream, mpCommonArchive, mpPrivateArchive);
+}
+
+template <>
+ArchiveOpener<boost::archive::binary_oarchive, std::ofstream>::~ArchiveOpener()
+{
+  CloseOutputArchives(mpCommonStream, mpPrivateStream, mpCommonArchive,
+      mpPrivateArchive);
+}
+
+/**
+ * Specialization for gzip-compressed text input archives.
+ * @param rDirectory
+ * @param rFileNameBase
+ * @param procId
+ */
+template <>
+ArchiveOpener<boost::archive::text_iarchive, GzipInputFileStream>::ArchiveOpener(
+    const FileFinder& rDirectory
+  , const std::string& rFileNameBase
+  , unsigned procId)
+  : mpCommonStream(nullptr),
+    mpPrivateStream(nullptr),
+    mpCommonArchive(nullptr),
+    mpPrivateArchive(nullptr)
+{
+  OpenInputArchives(rDirectory, rFileNameBase, procId,
+      mpCommonStream, mpPrivateStream, mpCommonArchive, mpPrivateArchive);
+}
+
+template <>
+ArchiveOpener<boost::archive::text_iarchive, GzipInputFileStream>::~ArchiveOpener()
+{
+  CloseInputArchives(mpCommonStream, mpPrivateStream, mpCommonArchive,
+      mpPrivateArchive);
+}
+
+/**
+ * Specialization for gzip-compressed binary input archives.
+ * @param rDirectory
+ * @param rFileNameBase
+ * @param procId
+ */
+template <>
+ArchiveOpener<boost::archive::binary_iarchive, GzipInputFileStream>::ArchiveOpener(
+    const FileFinder& rDirectory
+  , const std::string& rFileNameBase
+  , unsigned procId)
+  : mpCommonStream(nullptr),
+    mpPrivateStream(nullptr),
+    mpCommonArchive(nullptr),
+    mpPrivateArchive(nullptr)
+{
+  OpenInputArchives(rDirectory, rFileNameBase, procId,
+      mpCommonStream, mpPrivateStream, mpCommonArchive, mpPrivateArchive);
+}
+
+template <>
+ArchiveOpener<boost::archive::binary_iarchive, GzipInputFileStream>::~ArchiveOpener()
+{
+  CloseInputArchives(mpCommonStream, mpPrivateStream, mpCommonArchive,
+      mpPrivateArchive);
+}
+
+/**
+ * Specialization for gzip-compressed text output archives.
+ * @param rDirectory
+ * @param rFileNameBase
+ * @param procId
+ */
+template <>
+ArchiveOpener<boost::archive::text_oarchive, GzipOutputFileStream>::ArchiveOpener(
+    const FileFinder& rDirectory
+  , const std::string& rFileNameBase
+  , unsigned procId)
+  : mpCommonStream(nullptr),
+    mpPrivateStream(nullptr),
+    mpCommonArchive(nullptr),
+    mpPrivateArchive(nullptr)
+{
+  OpenOutputArchives(rDirectory, rFileNameBase, procId,
+      mpCommonStream, mpPrivateStream, mpCommonArchive, mpPrivateArchive);
+}
+
+template <>
+ArchiveOpener<boost::archive::text_oarchive, GzipOutputFileStream>::~ArchiveOpener()
+{
+  CloseOutputArchives(mpCommonStream, mpPrivateStream, mpCommonArchive,
+      mpPrivateArchive);
+}
+
+/**
+ * Specialization for gzip-compressed binary output archives.
+ * @param rDirectory
+ * @param rFileNameBase
+ * @param procId
+ */
+template <>
+ArchiveOpener<boost::archive::binary_oarchive, GzipOutputFileStream>::ArchiveOpener(
+    const FileFinder& rDirectory
+  , const std::string& rFileNameBase
+  , unsigned procId)
+  : mpCommonStream(nullptr),
+    mpPrivateStream(nullptr),
+    mpCommonArchive(nullptr),
+    mpPrivateArchive(nullptr)
+{
+  OpenOutputArchives(rDirectory, rFileNameBase, procId,
+      mpCommonStream, mpPrivateStream, mpCommonArchive, mpPrivateArchive);
+}
+
+template <>
+ArchiveOpener<boost::archive::binary_oarchive, GzipOutputFileStream>::~ArchiveOpener()
+{
+  CloseOutputArchives(mpCommonStream, mpPrivateStream, mpCommonArchive,
+      mpPrivateArchive);
+}
@@ -40,6 +40,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "PetscTools.hpp"
 #include "FileFinder.hpp"
+#include "GzipFileStreams.hpp"
 
 /**
  * A convenience class to assist with managing archives for parallel
@@ -58,11 +59,15 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  * the secondary archive.
  *
  * Note also that implementations of this templated class only exist
- * for text archives, i.e.
- * Archive = boost::archive::text_iarchive
- *     (with Stream = std::ifstream), or
- * Archive = boost::archive::text_oarchive
- *     (with Stream = std::ofstream).
+ * for text and binary archives, i.e.
+ * Archive = boost::archive::text_iarchive or boost::archive::binary_iarchive
+ *     (with Stream = std::ifstream or GzipInputFileStream), or
+ * Archive = boost::archive::text_oarchive or boost::archive::binary_oarchive
+ *     (with Stream = std::ofstream or GzipOutputFileStream).
+ * Binary archives are considerably faster to read and write, but are not
+ * portable between platforms. The Gzip streams compress the archive files
+ * as they are written, which can greatly reduce the size of large
+ * checkpoints at some cost in speed.
  */
 template <class Archive, class Stream>
 class ArchiveOpener
@@ -0,0 +1,136 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef GZIPFILESTREAMS_HPP_
+#define GZIPFILESTREAMS_HPP_
+
+#include <fstream>
+
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+
+/**
+ * @file
+ *
+ * File streams which compress or decompress what passes through them with gzip,
+ * using Boost iostreams filters. They can be used in place of std::ifstream and
+ * std::ofstream when opening Boost archives (see ArchiveOpener), so that large
+ * checkpoints take up less disk space and I/O bandwidth.
+ */
+
+/**
+ * An input file stream which decompresses a gzip file as it is read.
+ */
+class GzipInputFileStream : public boost::iostreams::filtering_istream
+{
+private:
+
+    /** The underlying (compressed) file. */
+    std::ifstream mFile;
+
+public:
+
+    /**
+     * Open a gzip file for reading.
+     *
+     * @param pFileName  the file name
+     * @param mode  the open mode (binary mode is always used for the underlying file)
+     */
+    GzipInputFileStream(const char* pFileName, std::ios_base::openmode mode=std::ios::in)
+        : mFile(pFileName, mode | std::ios::binary)
+    {
+        if (mFile.is_open())
+        {
+            push(boost::iostreams::gzip_decompressor());
+            push(mFile);
+        }
+    }
+
+    /** Close the filter chain before the underlying file. */
+    ~GzipInputFileStream()
+    {
+        reset();
+    }
+
+    /** @return whether the underlying file was opened */
+    bool is_open() const
+    {
+        return mFile.is_open();
+    }
+};
+
+/**
+ * An output file stream which compresses what is written to it with gzip.
+ * The compressed data is completed when the stream is destroyed.
+ */
+class GzipOutputFileStream : public boost::iostreams::filtering_ostream
+{
+private:
+
+    /** The underlying (compressed) file. */
+    std::ofstream mFile;
+
+public:
+
+    /**
+     * Open a file for writing compressed data.
+     *
+     * @param pFileName  the file name
+     * @param mode  the open mode (binary mode is always used for the underlying file)
+     */
+    GzipOutputFileStream(const char* pFileName, std::ios_base::openmode mode=std::ios::out)
+        : mFile(pFileName, mode | std::ios::binary)
+    {
+        if (mFile.is_open())
+        {
+            push(boost::iostreams::gzip_compressor());
+            push(mFile);
+        }
+    }
+
+    /** Flush the compressor, writing the end of the gzip data, before the underlying file is closed. */
+    ~GzipOutputFileStream()
+    {
+        reset();
+    }
+
+    /** @return whether the underlying file was opened */
+    bool is_open() const
+    {
+        return mFile.is_open();
+    }
+};
+
+#endif /*GZIPFILESTREAMS_HPP_*/
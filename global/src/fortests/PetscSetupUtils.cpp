@@ -41,6 +41,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <iostream>
 #include <petsc.h>
 
+#include "AsynchronousIoService.hpp"
 #include "ChasteBuildRoot.hpp"
 #include "ChasteSyscalls.hpp"
 #include "Citations.hpp"
@@ -73,19 +74,39 @@ void FpeSignalToAbort(int sig_num, siginfo_t* info, void* context)
 }
 #endif
 
-void PetscSetupUtils::InitialisePetsc()
+bool PetscSetupUtils::mMpiInitialisedHere = false;
+
+void PetscSetupUtils::InitialiseMpiWithThreadSupport(int* pArgc, char*** pArgv)
+{
+    int is_initialised;
+    MPI_Initialized(&is_initialised);
+    if (!is_initialised)
+    {
+        // If the MPI library can't provide full thread support it just reports a lower level,
+        // which users of threads check with MPI_Query_thread().
+        int provided;
+        MPI_Init_thread(pArgc, pArgv, MPI_THREAD_MULTIPLE, &provided);
+        mMpiInitialisedHere = true;
+    }
+}
+
+void PetscSetupUtils::InitialisePetsc(bool requestMpiThreadMultiple)
 {
     // The CommandLineArguments instance is filled in by the cxxtest test suite runner.
     CommandLineArguments* p_args = CommandLineArguments::Instance();
+    if (requestMpiThreadMultiple || p_args->OptionExists("-mpi_thread_multiple"))
+    {
+        InitialiseMpiWithThreadSupport(p_args->p_argc, p_args->p_argv);
+    }
     PETSCEXCEPT(PetscInitialize(p_args->p_argc, p_args->p_argv, PETSC_NULL, PETSC_NULL));
     // Work around what seems to be an Intel compiler bug/quirk that makes the cache stale,
     // by using an explicit reset to ensure all code is aware we're running in parallel.
     PetscTools::ResetCache();
 }
 
-void PetscSetupUtils::CommonSetup()
+void PetscSetupUtils::CommonSetup(bool requestMpiThreadMultiple)
 {
-    InitialisePetsc();
+    InitialisePetsc(requestMpiThreadMultiple);
 
     if ((PETSC_VERSION_MAJOR < 3) || (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR < 5)) // PETSc 3.4 or earlier
     {
@@ -124,7 +145,17 @@ void PetscSetupUtils::CommonFinalize()
     // This does nothing if we are on a new PETSc, just allows Chaste to print citations instead in this case
     Citations::Print();
 
+    // Finish any background output (which may use MPI) before finalising
+    AsynchronousIoService::Destroy();
+
     PETSCEXCEPT(PetscFinalize());
+
+    // PETSc leaves MPI running if it didn't initialise it
+    if (mMpiInitialisedHere)
+    {
+        MPI_Finalize();
+        mMpiInitialisedHere = false;
+    }
 }
 
 void PetscSetupUtils::ResetStatusCache()
@@ -45,13 +45,33 @@ class PetscSetupUtils
 public:
     /**
      * The global setup for Chaste tests.
+     *
+     * @param requestMpiThreadMultiple  whether to initialise MPI with MPI_THREAD_MULTIPLE support
+     *     (see InitialiseMpiWithThreadSupport())
      */
-    static void CommonSetup();
+    static void CommonSetup(bool requestMpiThreadMultiple=false);
 
     /**
      * Just initialise PETSc without performing the rest of the common setup.
+     * MPI is initialised with MPI_THREAD_MULTIPLE support if requested here or
+     * with the command line option -mpi_thread_multiple.
+     *
+     * @param requestMpiThreadMultiple  whether to initialise MPI with MPI_THREAD_MULTIPLE support
      */
-    static void InitialisePetsc();
+    static void InitialisePetsc(bool requestMpiThreadMultiple=false);
+
+    /**
+     * Initialise MPI requesting MPI_THREAD_MULTIPLE support, which background output such as
+     * Hdf5DataWriter::SetUseAsynchronousWrites() needs. This must be called before PETSc is
+     * initialised, as PetscInitialize() only initialises MPI (without thread support) if it
+     * is not already running. MPI is then finalised by CommonFinalize().
+     *
+     * Does nothing if MPI is already initialised.
+     *
+     * @param pArgc  pointer to the number of command line arguments
+     * @param pArgv  pointer to the command line arguments
+     */
+    static void InitialiseMpiWithThreadSupport(int* pArgc, char*** pArgv);
 
     /**
      * Call PetscTools::ResetCache().
@@ -65,6 +85,8 @@ public:
     static void CommonFinalize();
 
 private:
+    /** Whether MPI was initialised by InitialiseMpiWithThreadSupport(), and so must be finalised by us. */
+    static bool mMpiInitialisedHere;
 };
 
 #endif // PETSCSETUPUTILS_HPP_
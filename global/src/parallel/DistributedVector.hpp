@@ -141,6 +141,25 @@ public:
         return mpFactory;
     }
 
+    /**
+     * @return the local part of the underlying PETSc vector, as given by VecGetArray.
+     * For a striped vector the entry of stripe s at local index i is at
+     * [i*GetNumberOfStripes() + s]. This allows tight loops over the local entries
+     * without going through the index bookkeeping of operator[] or the stripe classes.
+     */
+    double* GetLocalArray()
+    {
+        return mpVec;
+    }
+
+    /**
+     * @return the number of stripes (types of information) interleaved in the vector.
+     */
+    unsigned GetNumberOfStripes() const
+    {
+        return mSizeMultiplier;
+    }
+
     /**
      * @param globalIndex
      * @return value of distributed vector at globalIndex
@@ -163,13 +163,15 @@ Vec DistributedVectorFactory::CreateVec(unsigned stride)
 #if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 3) //PETSc 3.3 or later
     //In PETSc 3.3 we cannot alter the stride (block size) after it has been created
     //There is no VecCreateMPI with block size
-    VecCreate(PETSC_COMM_WORLD, &vec);
+    VecCreate(PetscTools::GetWorld(), &vec);
     VecSetBlockSize(vec, stride);
     VecSetSizes(vec, stride*(mHi-mLo), stride*mProblemSize);
     VecSetType(vec,VECMPI);
-    //VecCreateMPIWithArray(PETSC_COMM_WORLD, stride, stride*(mHi-mLo), stride*mProblemSize, PETSC_NULL/*No array*/, &vec);
+    // Allow e.g. -vec_type cuda, so that striped vectors match the others
+    VecSetFromOptions(vec);
+    //VecCreateMPIWithArray(PetscTools::GetWorld(), stride, stride*(mHi-mLo), stride*mProblemSize, PETSC_NULL/*No array*/, &vec);
 #else
-    VecCreateMPI(PETSC_COMM_WORLD, stride*(mHi-mLo), stride*mProblemSize, &vec);
+    VecCreateMPI(PetscTools::GetWorld(), stride*(mHi-mLo), stride*mProblemSize, &vec);
     VecSetBlockSize(vec, stride);
 #endif
 #if (PETSC_VERSION_MAJOR == 3) //PETSc 3.x.x
@@ -194,7 +196,7 @@ std::vector<unsigned> &DistributedVectorFactory::rGetGlobalLows()
         mGlobalLows.resize(PetscTools::GetNumProcs());
 
         // Exchange data
-        MPI_Allgather( &mLo, 1, MPI_UNSIGNED, &mGlobalLows[0], 1, MPI_UNSIGNED, PETSC_COMM_WORLD);
+        MPI_Allgather( &mLo, 1, MPI_UNSIGNED, &mGlobalLows[0], 1, MPI_UNSIGNED, PetscTools::GetWorld());
       }
 
     return  mGlobalLows;
@@ -167,6 +167,8 @@ public:
 
     /**
      * Create a striped PETSc vector of size: stride * problem size.
+     * With PETSc 3.3 or later SetFromOptions is called, so the type can be
+     * changed at run time (e.g. -vec_type cuda).
      *
      * @param stride
      * @return new PETSc vector
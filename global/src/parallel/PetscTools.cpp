@@ -45,6 +45,7 @@ bool PetscTools::mPetscIsInitialised = false;
 unsigned PetscTools::mNumProcessors = 0;
 unsigned PetscTools::mRank = 0;
 bool PetscTools::mIsolateProcesses = false;
+MPI_Comm PetscTools::mWorld = MPI_COMM_NULL;
 
 #ifndef NDEBUG
 // Uncomment this to trace calls to PetscTools::Barrier
@@ -63,12 +64,15 @@ void PetscTools::ResetCache()
     {
         mPetscIsInitialised = true;
 
+        // Isolated processes keep their true rank, so this is not GetWorld()
+        MPI_Comm world = (mWorld == MPI_COMM_NULL) ? PETSC_COMM_WORLD : mWorld;
+
         PetscInt num_procs;
-        MPI_Comm_size(PETSC_COMM_WORLD, &num_procs);
+        MPI_Comm_size(world, &num_procs);
         mNumProcessors = (unsigned) num_procs;
 
         PetscInt my_rank;
-        MPI_Comm_rank(PETSC_COMM_WORLD, &my_rank);
+        MPI_Comm_rank(world, &my_rank);
         mRank = (unsigned) my_rank;
     }
     else
@@ -140,7 +144,7 @@ void PetscTools::Barrier(const std::string callerId)
         // "Before" is alphabetically before "Post" so that one can sort the output on process/event/barrier
         std::cout << "DEBUG: proc " << PetscTools::GetMyRank() << ": Before " << "Barrier " << mNumBarriers << " \""<< callerId <<  "\"." << std::endl << std::flush;
 #endif
-        PetscBarrier(PETSC_NULL);
+        MPI_Barrier(GetWorld());
 #ifdef DEBUG_BARRIERS
         std::cout << "DEBUG: proc " << PetscTools::GetMyRank() << ": Post " << "Barrier " << mNumBarriers++ << " \""<< callerId <<  "\"." << std::endl << std::flush;
 #endif
@@ -177,10 +181,20 @@ MPI_Comm PetscTools::GetWorld()
     {
         return PETSC_COMM_SELF;
     }
-    else
+    else if (mWorld == MPI_COMM_NULL)
     {
         return PETSC_COMM_WORLD;
     }
+    else
+    {
+        return mWorld;
+    }
+}
+
+void PetscTools::SetWorld(MPI_Comm world)
+{
+    mWorld = world;
+    ResetCache();
 }
 
 bool PetscTools::ReplicateBool(bool flag)
@@ -190,7 +204,7 @@ bool PetscTools::ReplicateBool(bool flag)
     unsigned anyones_flag_is_true = my_flag;
     if (mPetscIsInitialised && !mIsolateProcesses)
     {
-        MPI_Allreduce(&my_flag, &anyones_flag_is_true, 1, MPI_UNSIGNED, MPI_MAX, PETSC_COMM_WORLD);
+        MPI_Allreduce(&my_flag, &anyones_flag_is_true, 1, MPI_UNSIGNED, MPI_MAX, GetWorld());
     }
     return (anyones_flag_is_true == 1);
 }
@@ -215,7 +229,7 @@ Vec PetscTools::CreateVec(int size, int localSize, bool ignoreOffProcEntries)
 {
     assert(size >= 0); // There is one test where we create a zero-sized vector
     Vec ret;
-    VecCreate(PETSC_COMM_WORLD, &ret);
+    VecCreate(GetWorld(), &ret);
     VecSetSizes(ret, localSize, size); // localSize usually defaults to PETSC_DECIDE
     VecSetFromOptions(ret);
 
@@ -270,7 +284,8 @@ void PetscTools::SetupMat(Mat& rMat, int numRows, int numColumns,
                           int numLocalRows,
                           int numLocalColumns,
                           bool ignoreOffProcEntries,
-                          bool newAllocationError)
+                          bool newAllocationError,
+                          unsigned blockSize)
 {
     assert(numRows > 0);
     assert(numColumns > 0);
@@ -281,31 +296,45 @@ void PetscTools::SetupMat(Mat& rMat, int numRows, int numColumns,
     }
 
 #if (PETSC_VERSION_MAJOR == 2 && PETSC_VERSION_MINOR == 2) //PETSc 2.2
-    MatCreate(PETSC_COMM_WORLD,numLocalRows,numLocalColumns,numRows,numColumns,&rMat);
+    MatCreate(GetWorld(),numLocalRows,numLocalColumns,numRows,numColumns,&rMat);
 #else //New API
-    MatCreate(PETSC_COMM_WORLD,&rMat);
+    MatCreate(GetWorld(),&rMat);
     MatSetSizes(rMat,numLocalRows,numLocalColumns,numRows,numColumns);
 #endif
 
     if (PetscTools::IsSequential())
     {
         MatSetType(rMat, MATSEQAIJ);
-        if (rowPreallocation > 0)
-        {
-            MatSeqAIJSetPreallocation(rMat, rowPreallocation, PETSC_NULL);
-        }
     }
     else
     {
         MatSetType(rMat, MATMPIAIJ);
-        if (rowPreallocation > 0)
-        {
-            MatMPIAIJSetPreallocation(rMat, rowPreallocation, PETSC_NULL, rowPreallocation, PETSC_NULL);
-        }
     }
 
+    if (blockSize > 1)
+    {
+        assert(numRows%blockSize == 0);
+        MatSetBlockSize(rMat, blockSize);
+    }
+
+    // The type may be overridden here (e.g. -mat_type aijcusparse), which must be done
+    // before preallocating since changing the type discards the preallocation
     MatSetFromOptions(rMat);
 
+    if (rowPreallocation > 0)
+    {
+        // Each of these does nothing unless the matrix is (derived from) the matching type
+        MatSeqAIJSetPreallocation(rMat, rowPreallocation, PETSC_NULL);
+        MatMPIAIJSetPreallocation(rMat, rowPreallocation, PETSC_NULL, rowPreallocation, PETSC_NULL);
+        if (blockSize > 1)
+        {
+            // Block formats preallocate in blocks of blockSize rows and columns
+            unsigned block_preallocation = (rowPreallocation + blockSize - 1)/blockSize;
+            MatSeqBAIJSetPreallocation(rMat, blockSize, block_preallocation, PETSC_NULL);
+            MatMPIBAIJSetPreallocation(rMat, blockSize, block_preallocation, PETSC_NULL, block_preallocation, PETSC_NULL);
+        }
+    }
+
     if (ignoreOffProcEntries)//&& IsParallel())
     {
         if (rowPreallocation == 0)
@@ -339,7 +368,7 @@ void PetscTools::DumpPetscObject(const Mat& rMat, const std::string& rOutputFile
     PetscFileMode type = FILE_MODE_WRITE;
 #endif
 
-    PetscViewerBinaryOpen(PETSC_COMM_WORLD, rOutputFileFullPath.c_str(), type, &view);
+    PetscViewerBinaryOpen(GetWorld(), rOutputFileFullPath.c_str(), type, &view);
     MatView(rMat, view);
     PetscViewerDestroy(PETSC_DESTROY_PARAM(view));
 }
@@ -353,7 +382,7 @@ void PetscTools::DumpPetscObject(const Vec& rVec, const std::string& rOutputFile
     PetscFileMode type = FILE_MODE_WRITE;
 #endif
 
-    PetscViewerBinaryOpen(PETSC_COMM_WORLD, rOutputFileFullPath.c_str(), type, &view);
+    PetscViewerBinaryOpen(GetWorld(), rOutputFileFullPath.c_str(), type, &view);
     VecView(rVec, view);
     PetscViewerDestroy(PETSC_DESTROY_PARAM(view));
 }
@@ -374,11 +403,11 @@ void PetscTools::ReadPetscObject(Mat& rMat, const std::string& rOutputFileFullPa
     PetscFileMode type = FILE_MODE_READ;
 #endif
 
-    PetscViewerBinaryOpen(PETSC_COMM_WORLD, rOutputFileFullPath.c_str(),
+    PetscViewerBinaryOpen(GetWorld(), rOutputFileFullPath.c_str(),
                           type, &view);
 
 #if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 2) //PETSc 3.2 or later
-    MatCreate(PETSC_COMM_WORLD,&rMat);
+    MatCreate(GetWorld(),&rMat);
     MatSetType(rMat,MATMPIAIJ);
     MatLoad(rMat,view);
 #else
@@ -418,12 +447,12 @@ void PetscTools::ReadPetscObject(Vec& rVec, const std::string& rOutputFileFullPa
     PetscFileMode type = FILE_MODE_READ;
 #endif
 
-    PetscViewerBinaryOpen(PETSC_COMM_WORLD, rOutputFileFullPath.c_str(),
+    PetscViewerBinaryOpen(GetWorld(), rOutputFileFullPath.c_str(),
                           type, &view);
     if (rParallelLayout == nullptr)
     {
 #if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 2) //PETSc 3.2 or later
-        VecCreate(PETSC_COMM_WORLD,&rVec);
+        VecCreate(GetWorld(),&rVec);
         VecSetType(rVec,VECMPI);
         VecLoad(rVec,view);
 #else
@@ -453,7 +482,7 @@ bool PetscTools::HasParMetis()
 #endif
 
     MatPartitioning part;
-    MatPartitioningCreate(PETSC_COMM_WORLD, &part);
+    MatPartitioningCreate(GetWorld(), &part);
 
 
     // We are expecting an error from PETSC on systems that don't have the interface, so suppress it
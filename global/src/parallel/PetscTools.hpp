@@ -124,6 +124,9 @@ private:
     /** Whether to pretend that we're just running many master processes independently. */
     static bool mIsolateProcesses;
 
+    /** The communicator set by SetWorld(), or MPI_COMM_NULL for PETSC_COMM_WORLD. */
+    static MPI_Comm mWorld;
+
     /** Private method makes sure that (if this is the first use within a test) then PETSc has been probed. */
     static inline void CheckCache()
     {
@@ -227,11 +230,23 @@ public:
 
     /**
      * Get the MPI Communicator representing the whole set of running processes.  This will normally be
-     * PETSC_COMM_WORLD, unless IsolateProcesses has been called, in which case it will be PETSC_COMM_SELF.
+     * PETSC_COMM_WORLD, or the communicator given to SetWorld, unless IsolateProcesses has been called,
+     * in which case it will be PETSC_COMM_SELF.
      * @return  the MPI Communicator representing the whole set of running processes
      */
     static MPI_Comm GetWorld();
 
+    /**
+     * Make a sub-communicator of PETSC_COMM_WORLD stand for the whole set of running processes, so that
+     * one MPI job can run several independent simulations side by side, one per sub-communicator.
+     * Ranks, barriers, replication, PETSc objects, meshes and output all then refer to the given
+     * communicator, so each sub-communicator should write to its own output directory.  Objects created
+     * with one world must not be used with another.  Pass PETSC_COMM_WORLD to go back to normal.
+     *
+     * @param world  the communicator, which must include this process
+     */
+    static void SetWorld(MPI_Comm world);
+
     /**
      * Create a vector of the specified size. SetFromOptions is called.
      *
@@ -262,7 +277,9 @@ public:
 
     /**
      * Set up a matrix - set the size using the given parameters. The number of local rows
-     * and columns is by default PETSC_DECIDE. SetFromOptions is called.
+     * and columns is by default PETSC_DECIDE. SetFromOptions is called before preallocating,
+     * so the type may be changed at run time to any AIJ type (e.g. -mat_type aijcusparse to
+     * assemble and solve on a GPU) without losing the preallocation.
      *
      * @param rMat the matrix
      * @param numRows the number of rows in the matrix
@@ -277,13 +294,17 @@ public:
      *        ** currently only used in PETSc 3.3 and later **
      *        in PETSc 3.2 and earlier MAT_NEW_NONZERO_ALLOCATION_ERR defaults to false
      *        in PETSc 3.3 MAT_NEW_NONZERO_ALLOCATION_ERR defaults to true
+     * @param blockSize the number of interleaved unknowns per node (defaults to 1). When greater
+     *        than one the matrix is told its block size, so that it may be switched to a block
+     *        format with -mat_type baij, and block-aware preconditioners can find the fields.
      */
     static void SetupMat(Mat& rMat, int numRows, int numColumns,
                          unsigned rowPreallocation,
                          int numLocalRows=PETSC_DECIDE,
                          int numLocalColumns=PETSC_DECIDE,
                          bool ignoreOffProcEntries=true,
-                         bool newAllocationError=true);
+                         bool newAllocationError=true,
+                         unsigned blockSize=1);
 
     /**
      * Boolean OR of flags between processes.
@@ -399,6 +420,21 @@ public:
          PetscOptionsSetValue(NULL, pOptionName, pOptionValue);
 #else
          PetscOptionsSetValue(pOptionName, pOptionValue);
+#endif
+     }
+
+     /**
+      * Remove a PETSc option, e.g. one set by SetOption().
+      * This is a wrapper for PetscOptionsClearValue, which changed signature in PETSc 3.7.
+      *
+      * @param pOptionName  the option name
+      */
+     static inline void ClearOption(const char* pOptionName)
+     {
+#if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 7) // PETSc 3.7 or later
+         PetscOptionsClearValue(NULL, pOptionName);
+#else
+         PetscOptionsClearValue(pOptionName);
 #endif
      }
 };
@@ -98,7 +98,7 @@ ReplicatableVector::~ReplicatableVector()
 
 // Vector interface methods
 
-unsigned ReplicatableVector::GetSize()
+unsigned ReplicatableVector::GetSize() const
 {
     return mSize;
 }
@@ -141,9 +141,9 @@ void ReplicatableVector::Replicate(unsigned lo, unsigned hi)
 
 #if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 3) //PETSc 3.3 or later
     //Extra argument is block size
-    VecCreateMPIWithArray(PETSC_COMM_WORLD, 1, hi-lo, this->GetSize(), &mpData[lo], &distributed_vec);
+    VecCreateMPIWithArray(PetscTools::GetWorld(), 1, hi-lo, this->GetSize(), &mpData[lo], &distributed_vec);
 #else
-    VecCreateMPIWithArray(PETSC_COMM_WORLD, hi-lo, this->GetSize(), &mpData[lo], &distributed_vec);
+    VecCreateMPIWithArray(PetscTools::GetWorld(), hi-lo, this->GetSize(), &mpData[lo], &distributed_vec);
 #endif
 #if (PETSC_VERSION_MAJOR == 3) //PETSc 3.x.x
     VecSetOption(distributed_vec, VEC_IGNORE_OFF_PROC_ENTRIES, PETSC_TRUE);
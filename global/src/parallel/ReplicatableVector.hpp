@@ -88,7 +88,7 @@ public:
     /**
      * @return the size of the vector.
      */
-    unsigned GetSize();
+    unsigned GetSize() const;
 
     /**
      * Resize the vector.
@@ -0,0 +1,103 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef ABSTRACTMEMORYACCOUNTABLE_HPP_
+#define ABSTRACTMEMORYACCOUNTABLE_HPP_
+
+#include <vector>
+
+#include "MemoryAccounting.hpp"
+
+/**
+ * Base class for containers whose memory is accounted by MemoryAccounting.  An object
+ * is registered with its subsystem from construction until destruction, and concrete
+ * classes estimate the memory they hold in GetMemoryUsage().
+ */
+class AbstractMemoryAccountable
+{
+private:
+
+    /** The subsystem this object's memory is accounted to. */
+    MemoryAccounting::Subsystem mMemoryAccountingSubsystem;
+
+protected:
+
+    /**
+     * Constructor.
+     *
+     * @param subsystem  the subsystem this object's memory is accounted to
+     */
+    AbstractMemoryAccountable(MemoryAccounting::Subsystem subsystem);
+
+    /**
+     * Copy constructor; the copy is accounted separately.
+     *
+     * @param rOther  the object being copied
+     */
+    AbstractMemoryAccountable(const AbstractMemoryAccountable& rOther);
+
+    /**
+     * Assignment leaves the accounting of this object unchanged.
+     *
+     * @param rOther  the object being assigned
+     * @return this object
+     */
+    AbstractMemoryAccountable& operator=(const AbstractMemoryAccountable& rOther);
+
+    /**
+     * @return the bytes allocated to a vector's elements
+     * @param rVector  the vector
+     */
+    template<typename T>
+    static double GetVectorBytes(const std::vector<T>& rVector)
+    {
+        return double(rVector.capacity())*sizeof(T);
+    }
+
+public:
+
+    /**
+     * Destructor.
+     */
+    virtual ~AbstractMemoryAccountable();
+
+    /** @return the subsystem this object's memory is accounted to */
+    MemoryAccounting::Subsystem GetMemoryAccountingSubsystem() const;
+
+    /** @return an estimate of the bytes held by this object on this process */
+    virtual double GetMemoryUsage() const=0;
+};
+
+#endif /*ABSTRACTMEMORYACCOUNTABLE_HPP_*/
@@ -0,0 +1,165 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "BenchmarkRecorder.hpp"
+
+#include <sstream>
+
+#include "Exception.hpp"
+#include "OutputFileHandler.hpp"
+#include "PetscTools.hpp"
+#include "Timer.hpp"
+#include "Version.hpp"
+
+namespace
+{
+/**
+ * @return the given text as a quoted JSON string.
+ *
+ * @param rText  the text
+ */
+std::string JsonString(const std::string& rText)
+{
+    std::ostringstream quoted;
+    quoted << '"';
+    for (std::string::const_iterator it = rText.begin(); it != rText.end(); ++it)
+    {
+        switch (*it)
+        {
+            case '"':
+                quoted << "\\\"";
+                break;
+            case '\\':
+                quoted << "\\\\";
+                break;
+            case '\n':
+                quoted << "\\n";
+                break;
+            case '\t':
+                quoted << "\\t";
+                break;
+            default:
+                quoted << *it;
+        }
+    }
+    quoted << '"';
+    return quoted.str();
+}
+}
+
+BenchmarkRecorder::BenchmarkRecorder(const std::string& rSuiteName)
+    : mSuiteName(rSuiteName),
+      mStartTime(-1.0)
+{
+}
+
+void BenchmarkRecorder::Begin(const std::string& rName, unsigned problemSize)
+{
+    if (mStartTime >= 0.0)
+    {
+        EXCEPTION("Benchmark '" << mNames.back() << "' has not ended.");
+    }
+    mNames.push_back(rName);
+    mProblemSizes.push_back(problemSize);
+    PetscTools::Barrier("BenchmarkRecorder::Begin");
+    mStartTime = Timer::GetWallTime();
+}
+
+double BenchmarkRecorder::End()
+{
+    if (mStartTime < 0.0)
+    {
+        EXCEPTION("No benchmark is in progress.");
+    }
+    double time = Timer::GetWallTime() - mStartTime;
+    mStartTime = -1.0;
+    if (PetscTools::IsParallel() && !PetscTools::IsIsolated())
+    {
+        double max_time;
+        MPI_Allreduce(&time, &max_time, 1, MPI_DOUBLE, MPI_MAX, PetscTools::GetWorld());
+        time = max_time;
+    }
+    mTimes.push_back(time);
+    return time;
+}
+
+void BenchmarkRecorder::Record(const std::string& rName, unsigned problemSize, double seconds)
+{
+    if (mStartTime >= 0.0)
+    {
+        EXCEPTION("Benchmark '" << mNames.back() << "' has not ended.");
+    }
+    mNames.push_back(rName);
+    mProblemSizes.push_back(problemSize);
+    mTimes.push_back(seconds);
+}
+
+unsigned BenchmarkRecorder::GetNumberOfResults() const
+{
+    return mTimes.size();
+}
+
+void BenchmarkRecorder::WriteResults(const std::string& rDirectory) const
+{
+    OutputFileHandler handler(rDirectory, false);
+    if (PetscTools::AmMaster())
+    {
+        out_stream p_file = handler.OpenOutputFile(mSuiteName + ".json");
+        (*p_file) << "{\n"
+                  << "  \"suite\": " << JsonString(mSuiteName) << ",\n"
+                  << "  \"date\": " << JsonString(ChasteBuildInfo::GetCurrentTime()) << ",\n"
+                  << "  \"processes\": " << PetscTools::GetNumProcs() << ",\n"
+                  << "  \"build\": {\n"
+                  << "    \"version\": " << JsonString(ChasteBuildInfo::GetVersionString()) << ",\n"
+                  << "    \"working_copy_modified\": " << (ChasteBuildInfo::IsWorkingCopyModified() ? "true" : "false") << ",\n"
+                  << "    \"build_information\": " << JsonString(ChasteBuildInfo::GetBuildInformation()) << ",\n"
+                  << "    \"build_time\": " << JsonString(ChasteBuildInfo::GetBuildTime()) << ",\n"
+                  << "    \"compiler\": " << JsonString(ChasteBuildInfo::GetCompilerType()) << ",\n"
+                  << "    \"compiler_version\": " << JsonString(ChasteBuildInfo::GetCompilerVersion()) << ",\n"
+                  << "    \"compiler_flags\": " << JsonString(ChasteBuildInfo::GetCompilerFlags()) << "\n"
+                  << "  },\n"
+                  << "  \"results\": [";
+        for (unsigned i=0; i<mTimes.size(); i++)
+        {
+            (*p_file) << (i == 0 ? "\n" : ",\n")
+                      << "    {\"name\": " << JsonString(mNames[i])
+                      << ", \"problem_size\": " << mProblemSizes[i]
+                      << ", \"seconds\": " << mTimes[i] << "}";
+        }
+        (*p_file) << "\n  ]\n}\n";
+        p_file->close();
+    }
+    PetscTools::Barrier("BenchmarkRecorder::WriteResults");
+}
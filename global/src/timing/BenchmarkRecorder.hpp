@@ -0,0 +1,124 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef BENCHMARKRECORDER_HPP_
+#define BENCHMARKRECORDER_HPP_
+
+#include <string>
+#include <vector>
+
+/**
+ * Records the timings of a suite of benchmarks, and writes them out in a
+ * machine-readable (JSON) form together with information about the build
+ * (see ChasteBuildInfo), so that results can be compared between builds and
+ * releases.
+ *
+ * Usage:
+ *
+ *  BenchmarkRecorder recorder("MeshBenchmarks");
+ *  recorder.Begin("read_mesh", num_nodes);
+ *  //do something
+ *  recorder.End();
+ *  recorder.WriteResults();
+ *
+ * Timing and writing are collective: the time recorded is the maximum over
+ * all processes, and the results are written by the master process.
+ */
+class BenchmarkRecorder
+{
+private:
+
+    /** The name of the suite of benchmarks, used for the results file name. */
+    std::string mSuiteName;
+
+    /** The name of each benchmark recorded. */
+    std::vector<std::string> mNames;
+
+    /** The problem size (e.g. number of nodes or cells) of each benchmark recorded. */
+    std::vector<unsigned> mProblemSizes;
+
+    /** The wall time, in seconds, of each benchmark recorded. */
+    std::vector<double> mTimes;
+
+    /** Wall time at which the benchmark in progress began, or negative if none is in progress. */
+    double mStartTime;
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param rSuiteName  the name of the suite of benchmarks
+     */
+    BenchmarkRecorder(const std::string& rSuiteName);
+
+    /**
+     * Start timing a benchmark. Collective.
+     *
+     * @param rName  the name of the benchmark
+     * @param problemSize  the problem size
+     */
+    void Begin(const std::string& rName, unsigned problemSize);
+
+    /**
+     * Stop timing the benchmark in progress and record it. Collective.
+     *
+     * @return the wall time of the benchmark, in seconds (the maximum over all processes)
+     */
+    double End();
+
+    /**
+     * Record a benchmark timed by other means.
+     *
+     * @param rName  the name of the benchmark
+     * @param problemSize  the problem size
+     * @param seconds  its wall time, in seconds
+     */
+    void Record(const std::string& rName, unsigned problemSize, double seconds);
+
+    /** @return the number of benchmarks recorded. */
+    unsigned GetNumberOfResults() const;
+
+    /**
+     * Write the results, with information about the build, to the file
+     * <suite name>.json in the given output directory (which isn't cleaned).
+     * Collective.
+     *
+     * @param rDirectory  the output directory, relative to CHASTE_TEST_OUTPUT
+     */
+    void WriteResults(const std::string& rDirectory="Benchmarks") const;
+};
+
+#endif /*BENCHMARKRECORDER_HPP_*/
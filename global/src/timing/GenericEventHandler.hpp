@@ -36,8 +36,10 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef GENERICEVENTHANDLER_HPP_
 #define GENERICEVENTHANDLER_HPP_
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
+#include <vector>
 
 #include "Exception.hpp"
 #include "PetscTools.hpp"
@@ -50,6 +52,12 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  * Note: this class assume that, for any given concrete class, the last event
  * represents the total time, and thus wraps all other events.
  *
+ * As well as the wall time, the number of times each event began, the bytes communicated
+ * while it was the innermost event in progress (see RecordBytes()), and the event within
+ * which it first began are recorded. WriteJsonReport() uses these to give a structured
+ * report, nested by event and with the mean, minimum and maximum over all processes (and,
+ * for the time, the load imbalance: the maximum over the mean).
+ *
  * The methods in this class are not implemented separately as then they would not be
  * inline, which could impact performance; we generally want timing routines to be very
  * lightweight.
@@ -67,6 +75,11 @@ private:
     std::vector<bool> mHasBegun; /**< Whether each event is in progress */
     bool mEnabled; /**< Whether the event handler is recording event times */
     bool mInUse; /**< Determines if any of the event have begun */
+    std::vector<double> mCallCount; /**< Number of times each event has begun */
+    std::vector<double> mBytesSent; /**< Bytes sent while each event was the innermost in progress */
+    std::vector<double> mBytesReceived; /**< Bytes received while each event was the innermost in progress */
+    std::vector<unsigned> mParentEvent; /**< The innermost event in progress when each event first began, or NUM_EVENTS */
+    std::vector<unsigned> mOpenEvents; /**< The events in progress, in the order they began */
 
     /**
      * Sleep for a specified number of milliseconds.
@@ -178,6 +191,46 @@ public:
         Instance()->HeadingsImpl();
     }
 
+    /**
+     * Attribute communication to the innermost event in progress. Does nothing
+     * if no event is in progress.
+     *
+     * @param bytesSent  the number of bytes sent by this process
+     * @param bytesReceived  the number of bytes received by this process
+     */
+    static void RecordBytes(double bytesSent, double bytesReceived)
+    {
+        Instance()->RecordBytesImpl(bytesSent, bytesReceived);
+    }
+
+    /**
+     * @return the number of times the given event has begun since the last reset.
+     *
+     * @param event  the index of an event (this must be less than NUM_EVENTS)
+     */
+    static unsigned GetNumberOfCalls(unsigned event)
+    {
+        return Instance()->GetNumberOfCallsImpl(event);
+    }
+
+    /**
+     * Write a structured report on the timed events as JSON. Unlike Report(),
+     * events in progress are not ended and the handler is not reset.
+     *
+     * Each event is written with its name, and with the mean, minimum and maximum
+     * over processes of its wall time (in seconds), number of calls and bytes sent
+     * and received, followed by the events which first began inside it. The last
+     * event (the total) is the root.
+     *
+     * This is collective; the report is written on the master process only.
+     *
+     * @param rStream  the stream to write to
+     */
+    static void WriteJsonReport(std::ostream& rStream)
+    {
+        Instance()->WriteJsonReportImpl(rStream);
+    }
+
     /**
      * Enable the event handler so that it will record event durations.
      */
@@ -211,6 +264,10 @@ protected:
         mInUse = false;
         mWallTime.resize(NUM_EVENTS, 0.0);
         mHasBegun.resize(NUM_EVENTS, false);
+        mCallCount.resize(NUM_EVENTS, 0.0);
+        mBytesSent.resize(NUM_EVENTS, 0.0);
+        mBytesReceived.resize(NUM_EVENTS, 0.0);
+        mParentEvent.resize(NUM_EVENTS, NUM_EVENTS);
     }
 
 private:
@@ -224,7 +281,12 @@ private:
         {
             mWallTime[event] = 0.0;
             mHasBegun[event] = false;
+            mCallCount[event] = 0.0;
+            mBytesSent[event] = 0.0;
+            mBytesReceived[event] = 0.0;
+            mParentEvent[event] = NUM_EVENTS;
         }
+        mOpenEvents.clear();
         Enable();
         mInUse = false;
     }
@@ -266,6 +328,12 @@ private:
         }
         mWallTime[event] -= Timer::GetWallTime();
         mHasBegun[event] = true;
+        mCallCount[event] += 1.0;
+        if (mParentEvent[event] == NUM_EVENTS && !mOpenEvents.empty())
+        {
+            mParentEvent[event] = mOpenEvents.back();
+        }
+        mOpenEvents.push_back(event);
         //std::cout << PetscTools::GetMyRank()<<": Beginning " << EVENT_NAME[event] << " @ " << (clock()/1000) << std::endl;
     }
 
@@ -294,6 +362,10 @@ private:
         }
         mWallTime[event] += Timer::GetWallTime();
         mHasBegun[event] = false;
+        // Events need not end in the reverse order to that they began
+        std::vector<unsigned>::iterator it = std::find(mOpenEvents.begin(), mOpenEvents.end(), event);
+        assert(it != mOpenEvents.end());
+        mOpenEvents.erase(it);
         //std::cout << PetscTools::GetMyRank()<<": Ending " << EVENT_NAME[event] << " @ " << (clock()/1000) << std::endl;
     }
 
@@ -451,6 +523,145 @@ private:
         }
     }
 
+    /**
+     * Attribute communication to the innermost event in progress.
+     *
+     * @param bytesSent  the number of bytes sent by this process
+     * @param bytesReceived  the number of bytes received by this process
+     */
+    void RecordBytesImpl(double bytesSent, double bytesReceived)
+    {
+        if (mEnabled && !mOpenEvents.empty())
+        {
+            mBytesSent[mOpenEvents.back()] += bytesSent;
+            mBytesReceived[mOpenEvents.back()] += bytesReceived;
+        }
+    }
+
+    /**
+     * @return the number of times the given event has begun since the last reset.
+     *
+     * @param event  the index of an event (this must be less than NUM_EVENTS)
+     */
+    unsigned GetNumberOfCallsImpl(unsigned event)
+    {
+        assert(event<NUM_EVENTS);
+        return static_cast<unsigned>(mCallCount[event]);
+    }
+
+    /**
+     * Reduce a statistic over all processes.
+     *
+     * @param rLocal  the value of the statistic for each event on this process
+     * @param rMean  filled in with the mean over processes, on the master
+     * @param rMin  filled in with the minimum over processes, on the master
+     * @param rMax  filled in with the maximum over processes, on the master
+     */
+    void ReduceStatistic(std::vector<double>& rLocal, std::vector<double>& rMean,
+                         std::vector<double>& rMin, std::vector<double>& rMax)
+    {
+        rMean = rLocal;
+        rMin = rLocal;
+        rMax = rLocal;
+        if (PetscTools::IsParallel() && !PetscTools::IsIsolated())
+        {
+            MPI_Reduce(&rLocal[0], &rMean[0], NUM_EVENTS, MPI_DOUBLE, MPI_SUM, 0, PetscTools::GetWorld());
+            MPI_Reduce(&rLocal[0], &rMin[0], NUM_EVENTS, MPI_DOUBLE, MPI_MIN, 0, PetscTools::GetWorld());
+            MPI_Reduce(&rLocal[0], &rMax[0], NUM_EVENTS, MPI_DOUBLE, MPI_MAX, 0, PetscTools::GetWorld());
+            for (unsigned event=0; event<NUM_EVENTS; event++)
+            {
+                rMean[event] /= PetscTools::GetNumProcs();
+            }
+        }
+    }
+
+    /**
+     * Write one event of the JSON report, followed by the events which first began inside it.
+     *
+     * @param rStream  the stream to write to
+     * @param event  the event to write
+     * @param rStats  for each statistic written, its name followed by its mean, minimum and maximum;
+     *     the first is the time, for which the load imbalance is also written
+     * @param indent  the indentation of the event
+     */
+    void WriteJsonEvent(std::ostream& rStream, unsigned event,
+                        const std::vector<std::pair<std::string, std::vector<std::vector<double> > > >& rStats,
+                        const std::string& indent)
+    {
+        const unsigned top_event = NUM_EVENTS-1;
+        rStream << indent << "{\"name\": \"" << CONCRETE::EventName[event] << "\"";
+        for (unsigned i=0; i<rStats.size(); i++)
+        {
+            rStream << ", \"" << rStats[i].first << "\": {"
+                    << "\"mean\": " << rStats[i].second[0][event]
+                    << ", \"min\": " << rStats[i].second[1][event]
+                    << ", \"max\": " << rStats[i].second[2][event];
+            if (i == 0)
+            {
+                // Load imbalance in the time: the slowest process relative to the average
+                double mean = rStats[i].second[0][event];
+                rStream << ", \"imbalance\": " << (mean > 0.0 ? rStats[i].second[2][event]/mean : 1.0);
+            }
+            rStream << "}";
+        }
+
+        // Events which haven't begun inside another event are placed inside the total
+        std::vector<unsigned> children;
+        for (unsigned child=0; child<NUM_EVENTS; child++)
+        {
+            unsigned parent = mParentEvent[child];
+            if (child != top_event && (parent == event || (parent == NUM_EVENTS && event == top_event)))
+            {
+                children.push_back(child);
+            }
+        }
+        rStream << ", \"children\": [";
+        for (unsigned i=0; i<children.size(); i++)
+        {
+            rStream << (i == 0 ? "\n" : ",\n");
+            WriteJsonEvent(rStream, children[i], rStats, indent + "  ");
+        }
+        rStream << (children.empty() ? "" : "\n" + indent) << "]}";
+    }
+
+    /**
+     * Write a structured report on the timed events as JSON.
+     *
+     * @param rStream  the stream to write to
+     */
+    void WriteJsonReportImpl(std::ostream& rStream)
+    {
+        if (!mEnabled)
+        {
+            EXCEPTION("Asked to report on a disabled event handler.  Check for contributory errors above.");
+        }
+
+        std::vector<double> wall_time(NUM_EVENTS);
+        for (unsigned event=0; event<NUM_EVENTS; event++)
+        {
+            wall_time[event] = ConvertWallTimeToSeconds(mHasBegun[event] ? mWallTime[event] + Timer::GetWallTime()
+                                                                          : mWallTime[event]);
+        }
+
+        std::vector<std::pair<std::string, std::vector<std::vector<double> > > > stats;
+        const char* names[4] = {"time", "calls", "bytes_sent", "bytes_received"};
+        std::vector<double>* p_locals[4] = {&wall_time, &mCallCount, &mBytesSent, &mBytesReceived};
+        for (unsigned i=0; i<4; i++)
+        {
+            std::vector<std::vector<double> > reduced(3);
+            ReduceStatistic(*(p_locals[i]), reduced[0], reduced[1], reduced[2]);
+            stats.push_back(std::make_pair(std::string(names[i]), reduced));
+        }
+
+        if (PetscTools::AmMaster())
+        {
+            rStream << "{\"processes\": " << PetscTools::GetNumProcs() << ", \"events\":\n";
+            WriteJsonEvent(rStream, NUM_EVENTS-1, stats, "  ");
+            rStream << "\n}\n";
+            rStream.flush();
+        }
+    }
+
     /** Enable the event handler so that it will record event durations. */
     void EnableImpl()
     {
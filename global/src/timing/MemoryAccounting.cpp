@@ -0,0 +1,252 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "MemoryAccounting.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+
+#ifndef _MSC_VER
+#include <sys/resource.h>
+#endif //_MSC_VER
+
+#include "AbstractMemoryAccountable.hpp"
+#include "PetscTools.hpp"
+
+const char* MemoryAccounting::SubsystemName[] = { "Mesh", "Tissue", "LinSys", "CellPop",
+                                                  "Boxes", "OutCache" };
+
+std::vector<std::vector<const AbstractMemoryAccountable*> >& MemoryAccounting::rGetObjects()
+{
+    static std::vector<std::vector<const AbstractMemoryAccountable*> > objects(NUM_SUBSYSTEMS);
+    return objects;
+}
+
+std::vector<double>& MemoryAccounting::rGetPeakBytes()
+{
+    static std::vector<double> peak_bytes(NUM_SUBSYSTEMS, 0.0);
+    return peak_bytes;
+}
+
+void MemoryAccounting::Register(const AbstractMemoryAccountable* pObject)
+{
+    rGetObjects()[pObject->GetMemoryAccountingSubsystem()].push_back(pObject);
+}
+
+void MemoryAccounting::Deregister(const AbstractMemoryAccountable* pObject)
+{
+    std::vector<const AbstractMemoryAccountable*>& r_objects = rGetObjects()[pObject->GetMemoryAccountingSubsystem()];
+    std::vector<const AbstractMemoryAccountable*>::iterator it = std::find(r_objects.begin(), r_objects.end(), pObject);
+    assert(it != r_objects.end());
+    r_objects.erase(it);
+}
+
+unsigned MemoryAccounting::GetNumObjects(Subsystem subsystem)
+{
+    assert(subsystem < NUM_SUBSYSTEMS);
+    return rGetObjects()[subsystem].size();
+}
+
+double MemoryAccounting::GetBytes(Subsystem subsystem)
+{
+    assert(subsystem < NUM_SUBSYSTEMS);
+    const std::vector<const AbstractMemoryAccountable*>& r_objects = rGetObjects()[subsystem];
+    double bytes = 0.0;
+    for (unsigned i=0; i<r_objects.size(); i++)
+    {
+        bytes += r_objects[i]->GetMemoryUsage();
+    }
+    return bytes;
+}
+
+double MemoryAccounting::GetPeakBytes(Subsystem subsystem)
+{
+    assert(subsystem < NUM_SUBSYSTEMS);
+    return rGetPeakBytes()[subsystem];
+}
+
+void MemoryAccounting::Sample()
+{
+    std::vector<double>& r_peak_bytes = rGetPeakBytes();
+    for (unsigned subsystem=0; subsystem<NUM_SUBSYSTEMS; subsystem++)
+    {
+        r_peak_bytes[subsystem] = std::max(r_peak_bytes[subsystem], GetBytes(Subsystem(subsystem)));
+    }
+}
+
+void MemoryAccounting::Reset()
+{
+    std::fill(rGetPeakBytes().begin(), rGetPeakBytes().end(), 0.0);
+}
+
+double MemoryAccounting::GetPeakResidentSetSize()
+{
+#ifndef _MSC_VER
+    struct rusage rusage;
+    getrusage(RUSAGE_SELF, &rusage);
+#ifdef __APPLE__
+    return double(rusage.ru_maxrss); // Bytes on macOS
+#else
+    return double(rusage.ru_maxrss)*1024.0; // Kilobytes on Linux
+#endif
+#else
+    return 0.0;
+#endif //_MSC_VER
+}
+
+void MemoryAccounting::ReduceStatistics(std::vector<double>& rLocal, std::vector<double>& rMean,
+                                        std::vector<double>& rMin, std::vector<double>& rMax)
+{
+    rMean = rLocal;
+    rMin = rLocal;
+    rMax = rLocal;
+    if (PetscTools::IsParallel() && !PetscTools::IsIsolated())
+    {
+        MPI_Allreduce(&rLocal[0], &rMean[0], rLocal.size(), MPI_DOUBLE, MPI_SUM, PetscTools::GetWorld());
+        MPI_Allreduce(&rLocal[0], &rMin[0], rLocal.size(), MPI_DOUBLE, MPI_MIN, PetscTools::GetWorld());
+        MPI_Allreduce(&rLocal[0], &rMax[0], rLocal.size(), MPI_DOUBLE, MPI_MAX, PetscTools::GetWorld());
+        for (unsigned i=0; i<rMean.size(); i++)
+        {
+            rMean[i] /= PetscTools::GetNumProcs();
+        }
+    }
+}
+
+void MemoryAccounting::Report()
+{
+    Sample();
+
+    // The peak of each subsystem, followed by the peak resident set size, in Mb
+    std::vector<double> local(NUM_SUBSYSTEMS+1);
+    for (unsigned subsystem=0; subsystem<NUM_SUBSYSTEMS; subsystem++)
+    {
+        local[subsystem] = GetPeakBytes(Subsystem(subsystem))/(1024.0*1024.0);
+    }
+    local[NUM_SUBSYSTEMS] = GetPeakResidentSetSize()/(1024.0*1024.0);
+
+    std::cout.flush();
+    PetscTools::Barrier();
+    if (PetscTools::AmMaster())
+    {
+        if (PetscTools::IsParallel())
+        {
+            printf("Proc "); //5 chars
+        }
+        for (unsigned subsystem=0; subsystem<NUM_SUBSYSTEMS; subsystem++)
+        {
+            printf("%10s ", SubsystemName[subsystem]);
+        }
+        printf("%10s\n", "PeakRSS");
+    }
+
+    PetscTools::BeginRoundRobin();
+    {
+        std::cout.flush();
+        if (PetscTools::IsParallel())
+        {
+            printf("%3u: ", PetscTools::GetMyRank()); //5 chars
+        }
+        for (unsigned i=0; i<local.size(); i++)
+        {
+            printf("%10.1f ", local[i]);
+        }
+        std::cout << "(Mb) \n";
+    }
+    PetscTools::EndRoundRobin();
+
+    if (PetscTools::IsParallel() && !PetscTools::IsIsolated())
+    {
+        std::vector<double> mean, min, max;
+        ReduceStatistics(local, mean, min, max);
+        if (PetscTools::AmMaster())
+        {
+            printf("avg: "); //5 chars
+            for (unsigned i=0; i<mean.size(); i++)
+            {
+                printf("%10.1f ", mean[i]);
+            }
+            std::cout << "(Mb) \n";
+            printf("max: "); //5 chars
+            for (unsigned i=0; i<max.size(); i++)
+            {
+                printf("%10.1f ", max[i]);
+            }
+            std::cout << "(Mb) \n";
+        }
+    }
+    std::cout.flush();
+    PetscTools::Barrier();
+    std::cout.flush();
+}
+
+void MemoryAccounting::WriteJsonReport(std::ostream& rStream)
+{
+    Sample();
+
+    // Current bytes, peak bytes and number of objects of each subsystem, then the peak resident set size
+    std::vector<double> local(3*NUM_SUBSYSTEMS+1);
+    for (unsigned subsystem=0; subsystem<NUM_SUBSYSTEMS; subsystem++)
+    {
+        local[3*subsystem] = GetBytes(Subsystem(subsystem));
+        local[3*subsystem+1] = GetPeakBytes(Subsystem(subsystem));
+        local[3*subsystem+2] = GetNumObjects(Subsystem(subsystem));
+    }
+    local[3*NUM_SUBSYSTEMS] = GetPeakResidentSetSize();
+
+    std::vector<double> mean, min, max;
+    ReduceStatistics(local, mean, min, max);
+
+    if (PetscTools::AmMaster())
+    {
+        const char* stat_names[3] = {"bytes", "peak_bytes", "objects"};
+        rStream << "{\"processes\": " << PetscTools::GetNumProcs() << ", \"subsystems\": [";
+        for (unsigned subsystem=0; subsystem<NUM_SUBSYSTEMS; subsystem++)
+        {
+            rStream << (subsystem == 0 ? "\n" : ",\n") << "  {\"name\": \"" << SubsystemName[subsystem] << "\"";
+            for (unsigned stat=0; stat<3; stat++)
+            {
+                unsigned i = 3*subsystem + stat;
+                rStream << ", \"" << stat_names[stat] << "\": {\"mean\": " << mean[i]
+                        << ", \"min\": " << min[i] << ", \"max\": " << max[i] << "}";
+            }
+            rStream << "}";
+        }
+        unsigned i = 3*NUM_SUBSYSTEMS;
+        rStream << "\n],\n\"peak_rss_bytes\": {\"mean\": " << mean[i]
+                << ", \"min\": " << min[i] << ", \"max\": " << max[i] << "}\n}\n";
+        rStream.flush();
+    }
+}
@@ -0,0 +1,168 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef MEMORYACCOUNTING_HPP_
+#define MEMORYACCOUNTING_HPP_
+
+#include <iostream>
+#include <vector>
+
+class AbstractMemoryAccountable;
+
+/**
+ * Lightweight accounting of where memory goes, by subsystem.
+ *
+ * The major containers (meshes, cardiac tissues, linear systems, cell populations,
+ * box collections and output caches) derive from AbstractMemoryAccountable, which
+ * registers them here for as long as they exist. Each can estimate the bytes it holds
+ * on this process, and GetBytes() adds up the current estimates for a subsystem.
+ * Nothing is counted as memory is allocated, so the accounting costs nothing until it
+ * is queried.
+ *
+ * Sample() records the largest total seen for each subsystem; it is called at the end
+ * of cardiac and cell-based simulations and by Report(). Report() and WriteJsonReport()
+ * give these figures for each process together with its peak resident set size, so
+ * they can be read alongside the HeartEventHandler timings.
+ *
+ * The estimates cover the main data held by each container, and are lower bounds;
+ * memory held inside PETSc preconditioners, for example, is not included.
+ */
+class MemoryAccounting
+{
+public:
+
+    /** The subsystems for which memory is accounted. */
+    typedef enum
+    {
+        MESH=0,
+        CARDIAC_TISSUE,
+        LINEAR_SYSTEM,
+        CELL_POPULATION,
+        BOX_COLLECTION,
+        OUTPUT_CACHE,
+        NUM_SUBSYSTEMS
+    } Subsystem;
+
+    /** Names of the subsystems, as used in reports. */
+    static const char* SubsystemName[NUM_SUBSYSTEMS];
+
+    /**
+     * Start accounting for an object. Called by the AbstractMemoryAccountable constructors.
+     *
+     * @param pObject  the object
+     */
+    static void Register(const AbstractMemoryAccountable* pObject);
+
+    /**
+     * Stop accounting for an object. Called by the AbstractMemoryAccountable destructor.
+     *
+     * @param pObject  the object
+     */
+    static void Deregister(const AbstractMemoryAccountable* pObject);
+
+    /**
+     * @return the number of objects currently accounted for in a subsystem on this process
+     * @param subsystem  the subsystem
+     */
+    static unsigned GetNumObjects(Subsystem subsystem);
+
+    /**
+     * @return the estimated bytes currently held by a subsystem on this process
+     * @param subsystem  the subsystem
+     */
+    static double GetBytes(Subsystem subsystem);
+
+    /**
+     * @return the largest value of GetBytes() recorded by Sample() since the last Reset()
+     * @param subsystem  the subsystem
+     */
+    static double GetPeakBytes(Subsystem subsystem);
+
+    /**
+     * Record the current estimates, updating the peak for each subsystem.
+     */
+    static void Sample();
+
+    /**
+     * Forget the peaks recorded by Sample().
+     */
+    static void Reset();
+
+    /**
+     * @return the peak resident set size of this process in bytes, as reported by the
+     * operating system, or zero if it is not available.
+     */
+    static double GetPeakResidentSetSize();
+
+    /**
+     * Print the peak bytes of each subsystem and the peak resident set size (in Mb) for
+     * each process, and their average and maximum over processes. Samples first.
+     *
+     * This is collective.
+     */
+    static void Report();
+
+    /**
+     * Write the current and peak bytes of each subsystem, its number of objects, and the
+     * peak resident set size as JSON, each with the mean, minimum and maximum over
+     * processes. Samples first.
+     *
+     * This is collective; the report is written on the master process only.
+     *
+     * @param rStream  the stream to write to
+     */
+    static void WriteJsonReport(std::ostream& rStream);
+
+private:
+
+    /** @return the accounted objects in each subsystem */
+    static std::vector<std::vector<const AbstractMemoryAccountable*> >& rGetObjects();
+
+    /** @return the peak bytes recorded for each subsystem */
+    static std::vector<double>& rGetPeakBytes();
+
+    /**
+     * Reduce a set of statistics over all processes.
+     *
+     * @param rLocal  the values on this process
+     * @param rMean  filled in with the mean over processes
+     * @param rMin  filled in with the minimum over processes
+     * @param rMax  filled in with the maximum over processes
+     */
+    static void ReduceStatistics(std::vector<double>& rLocal, std::vector<double>& rMean,
+                                 std::vector<double>& rMin, std::vector<double>& rMax);
+};
+
+#endif /*MEMORYACCOUNTING_HPP_*/
@@ -0,0 +1,113 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "ScalingStudy.hpp"
+
+#include "CommandLineArguments.hpp"
+#include "Exception.hpp"
+#include "OutputFileHandler.hpp"
+#include "PetscTools.hpp"
+#include "Version.hpp"
+
+ScalingStudy::ScalingStudy(const std::string& rName, unsigned defaultSize, unsigned defaultNumSteps)
+    : mName(rName),
+      mMode(STRONG),
+      mSize(defaultSize),
+      mNumSteps(defaultNumSteps)
+{
+    CommandLineArguments* p_args = CommandLineArguments::Instance();
+    if (p_args->OptionExists("-scaling_mode"))
+    {
+        std::string mode = p_args->GetStringCorrespondingToOption("-scaling_mode");
+        if (mode == "weak")
+        {
+            mMode = WEAK;
+        }
+        else if (mode != "strong")
+        {
+            EXCEPTION("Unknown scaling mode '" << mode << "'; use 'strong' or 'weak'.");
+        }
+    }
+    if (p_args->OptionExists("-scaling_size"))
+    {
+        mSize = p_args->GetUnsignedCorrespondingToOption("-scaling_size");
+    }
+    if (p_args->OptionExists("-scaling_steps"))
+    {
+        mNumSteps = p_args->GetUnsignedCorrespondingToOption("-scaling_steps");
+    }
+}
+
+ScalingStudy::Mode ScalingStudy::GetMode() const
+{
+    return mMode;
+}
+
+unsigned ScalingStudy::GetNumSteps() const
+{
+    return mNumSteps;
+}
+
+unsigned ScalingStudy::GetProblemSize() const
+{
+    return (mMode == WEAK) ? mSize*PetscTools::GetNumProcs() : mSize;
+}
+
+std::string ScalingStudy::GetConfigurationName() const
+{
+    std::stringstream name;
+    name << mName << (mMode == WEAK ? "_weak_" : "_strong_") << mSize << "_np" << PetscTools::GetNumProcs();
+    return name.str();
+}
+
+void ScalingStudy::WriteReport(unsigned actualProblemSize, const std::string& rEventsJson, const std::string& rDirectory) const
+{
+    OutputFileHandler handler(rDirectory, false);
+    if (PetscTools::AmMaster())
+    {
+        out_stream p_file = handler.OpenOutputFile(GetConfigurationName() + ".json");
+        (*p_file) << "{\n"
+                  << "  \"study\": \"" << mName << "\",\n"
+                  << "  \"mode\": \"" << (mMode == WEAK ? "weak" : "strong") << "\",\n"
+                  << "  \"processes\": " << PetscTools::GetNumProcs() << ",\n"
+                  << "  \"size\": " << mSize << ",\n"
+                  << "  \"problem_size\": " << actualProblemSize << ",\n"
+                  << "  \"steps\": " << mNumSteps << ",\n"
+                  << "  \"version\": \"" << ChasteBuildInfo::GetVersionString() << "\",\n"
+                  << "  \"events\": " << rEventsJson << "}\n";
+        p_file->close();
+    }
+    PetscTools::Barrier("ScalingStudy::WriteReport");
+}
@@ -0,0 +1,144 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef SCALINGSTUDY_HPP_
+#define SCALINGSTUDY_HPP_
+
+#include <sstream>
+#include <string>
+
+/**
+ * Helper for strong and weak scaling studies, so that scaling curves can be produced by
+ * running the same test with different numbers of processes.
+ *
+ * The study is configured from the command line:
+ *
+ *  \li -scaling_mode strong|weak  (default strong)
+ *  \li -scaling_size N  the problem size (strong) or problem size per process (weak)
+ *  \li -scaling_steps N  the number of time steps to run
+ *
+ * A test builds a problem of GetProblemSize(), runs GetNumSteps() time steps with its
+ * event handler reset beforehand, and then calls WriteReport(), which writes one JSON
+ * file per configuration (study, mode, size and number of processes) to the
+ * ScalingStudies output directory. The report contains the configuration and the event
+ * handler's structured report, which gives the mean, minimum and maximum over processes
+ * of each event, and its load imbalance.
+ *
+ * Usage:
+ *
+ *  ScalingStudy study("Monodomain3d", 10000, 100);
+ *  // build a problem of about study.GetProblemSize() nodes
+ *  HeartEventHandler::Reset();
+ *  // run study.GetNumSteps() steps
+ *  study.WriteReport<HeartEventHandler>(num_nodes);
+ */
+class ScalingStudy
+{
+public:
+
+    /** Whether the problem size is fixed (strong) or proportional to the number of processes (weak). */
+    typedef enum
+    {
+        STRONG=0,
+        WEAK
+    } Mode;
+
+    /**
+     * Constructor. Reads the command line options.
+     *
+     * @param rName  the name of the study, used for the report file names
+     * @param defaultSize  the problem size (strong) or size per process (weak) if -scaling_size isn't given
+     * @param defaultNumSteps  the number of time steps if -scaling_steps isn't given
+     */
+    ScalingStudy(const std::string& rName, unsigned defaultSize, unsigned defaultNumSteps);
+
+    /** @return whether this is a strong or weak scaling study */
+    Mode GetMode() const;
+
+    /** @return the number of time steps to run */
+    unsigned GetNumSteps() const;
+
+    /**
+     * @return the total problem size to build: the given size for a strong scaling study,
+     * or the given size times the number of processes for a weak scaling study.
+     */
+    unsigned GetProblemSize() const;
+
+    /**
+     * @return the name of this configuration, e.g. "Monodomain3d_weak_10000_np4", used
+     * for the report file name.
+     */
+    std::string GetConfigurationName() const;
+
+    /**
+     * Write the report for this configuration, with the event handler's report. Collective;
+     * the file is written by the master process.
+     *
+     * @param actualProblemSize  the size of the problem actually built
+     * @param rDirectory  the output directory, relative to CHASTE_TEST_OUTPUT (not cleaned)
+     */
+    template<class EVENT_HANDLER>
+    void WriteReport(unsigned actualProblemSize, const std::string& rDirectory="ScalingStudies") const
+    {
+        std::stringstream events;
+        EVENT_HANDLER::WriteJsonReport(events);
+        WriteReport(actualProblemSize, events.str(), rDirectory);
+    }
+
+private:
+
+    /** The name of the study. */
+    std::string mName;
+
+    /** Whether this is a strong or weak scaling study. */
+    Mode mMode;
+
+    /** The problem size (strong) or size per process (weak). */
+    unsigned mSize;
+
+    /** The number of time steps to run. */
+    unsigned mNumSteps;
+
+    /**
+     * Write the report for this configuration.
+     *
+     * @param actualProblemSize  the size of the problem actually built
+     * @param rEventsJson  the event handler's report (only needed on the master process)
+     * @param rDirectory  the output directory, relative to CHASTE_TEST_OUTPUT
+     */
+    void WriteReport(unsigned actualProblemSize, const std::string& rEventsJson, const std::string& rDirectory) const;
+};
+
+#endif /*SCALINGSTUDY_HPP_*/
@@ -0,0 +1,160 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTASYNCHRONOUSIOSERVICE_HPP_
+#define TESTASYNCHRONOUSIOSERVICE_HPP_
+
+#include <cxxtest/TestSuite.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "AsynchronousIoChannel.hpp"
+#include "AsynchronousIoService.hpp"
+#include "Exception.hpp"
+//This test is always run sequentially (never in parallel)
+#include "FakePetscSetup.hpp"
+
+class TestAsynchronousIoService : public CxxTest::TestSuite
+{
+public:
+
+    void TestServiceRunsAllTasks()
+    {
+        TS_ASSERT_THROWS_THIS(AsynchronousIoService(0), "The number of I/O worker threads must be at least one.");
+        TS_ASSERT_THROWS_THIS(AsynchronousIoService(1, 0), "The capacity of the I/O queues must be at least one.");
+
+        // The queue capacity is rounded up to a power of two; a small queue exercises back-pressure
+        AsynchronousIoService service(3, 5);
+        TS_ASSERT_EQUALS(service.GetNumberOfWorkers(), 3u);
+        TS_ASSERT_EQUALS(service.GetQueueCapacity(), 8u);
+
+        std::atomic<unsigned> num_tasks_run(0);
+        for (unsigned i=0; i<1000; i++)
+        {
+            service.Submit([&num_tasks_run]() { num_tasks_run++; }, i);
+        }
+        service.Flush();
+        TS_ASSERT_EQUALS(num_tasks_run.load(), 1000u);
+        TS_ASSERT_EQUALS(service.GetNumberOfOutstandingTasks(), 0u);
+
+        // Tasks with the same ordering key run in order
+        std::vector<unsigned> order;
+        for (unsigned i=0; i<1000; i++)
+        {
+            service.Submit([&order, i]() { order.push_back(i); }, 7);
+        }
+        service.Flush();
+        TS_ASSERT_EQUALS(order.size(), 1000u);
+        for (unsigned i=0; i<order.size(); i++)
+        {
+            TS_ASSERT_EQUALS(order[i], i);
+        }
+
+        // Errors are rethrown (once) by Flush()
+        service.Submit([]() { EXCEPTION("Disk full"); });
+        TS_ASSERT_THROWS_CONTAINS(service.Flush(), "Disk full");
+        TS_ASSERT_THROWS_NOTHING(service.Flush());
+
+        service.SetNumberOfWorkers(1);
+        TS_ASSERT_EQUALS(service.GetNumberOfWorkers(), 1u);
+        TS_ASSERT_THROWS_THIS(service.SetNumberOfWorkers(0), "The number of I/O worker threads must be at least one.");
+    }
+
+    void TestChannels()
+    {
+        TS_ASSERT_THROWS_THIS(AsynchronousIoChannel(0), "The maximum number of outstanding I/O tasks must be at least one.");
+
+        AsynchronousIoService::Instance()->SetNumberOfWorkers(2);
+
+        // Each channel runs its own tasks in order, whichever worker it is given
+        std::vector<unsigned> order_1;
+        std::vector<unsigned> order_2;
+        {
+            AsynchronousIoChannel channel_1(2);
+            AsynchronousIoChannel channel_2(3, "shared key");
+            TS_ASSERT_EQUALS(channel_1.GetMaxOutstandingTasks(), 2u);
+            for (unsigned i=0; i<500; i++)
+            {
+                channel_1.Submit([&order_1, i]() { order_1.push_back(i); });
+                channel_2.Submit([&order_2, i]() { order_2.push_back(i); });
+            }
+            channel_1.Flush();
+            TS_ASSERT_EQUALS(order_1.size(), 500u);
+            // channel_2 is flushed by its destructor
+        }
+        TS_ASSERT_EQUALS(order_2.size(), 500u);
+        for (unsigned i=0; i<500; i++)
+        {
+            TS_ASSERT_EQUALS(order_1[i], i);
+            TS_ASSERT_EQUALS(order_2[i], i);
+        }
+
+        // At most the given number of tasks are outstanding
+        std::atomic<unsigned> num_running(0);
+        std::atomic<unsigned> max_running(0);
+        AsynchronousIoChannel bounded_channel(1);
+        for (unsigned i=0; i<20; i++)
+        {
+            bounded_channel.Submit([&num_running, &max_running]()
+            {
+                unsigned now_running = ++num_running;
+                if (now_running > max_running)
+                {
+                    max_running = now_running;
+                }
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+                num_running--;
+            });
+        }
+        bounded_channel.Flush();
+        TS_ASSERT_EQUALS(max_running.load(), 1u);
+
+        // An error is reported by the next call to Submit() or Flush() on the channel that caused it
+        AsynchronousIoChannel failing_channel(1);
+        AsynchronousIoChannel other_channel(1);
+        failing_channel.Submit([]() { EXCEPTION("Cannot write file"); });
+        other_channel.Submit([]() {});
+        TS_ASSERT_THROWS_NOTHING(other_channel.Flush());
+        TS_ASSERT_THROWS_CONTAINS(failing_channel.Submit([]() {}), "Cannot write file");
+        TS_ASSERT_THROWS_NOTHING(failing_channel.Flush());
+
+        AsynchronousIoService::Destroy();
+    }
+};
+
+#endif /*TESTASYNCHRONOUSIOSERVICE_HPP_*/
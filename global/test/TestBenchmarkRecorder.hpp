@@ -0,0 +1,85 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTBENCHMARKRECORDER_HPP_
+#define TESTBENCHMARKRECORDER_HPP_
+
+#include <cxxtest/TestSuite.h>
+
+#include <fstream>
+#include <sstream>
+
+#include "BenchmarkRecorder.hpp"
+#include "FileFinder.hpp"
+#include "OutputFileHandler.hpp"
+#include "PetscTools.hpp"
+#include "PetscSetupAndFinalize.hpp"
+
+class TestBenchmarkRecorder : public CxxTest::TestSuite
+{
+public:
+
+    void TestRecordAndWrite()
+    {
+        BenchmarkRecorder recorder("TestBenchmarkRecorder");
+        TS_ASSERT_EQUALS(recorder.GetNumberOfResults(), 0u);
+        TS_ASSERT_THROWS_THIS(recorder.End(), "No benchmark is in progress.");
+
+        recorder.Begin("first", 10u);
+        TS_ASSERT_THROWS_THIS(recorder.Begin("second", 20u), "Benchmark 'first' has not ended.");
+        TS_ASSERT_THROWS_THIS(recorder.Record("second", 20u, 1.0), "Benchmark 'first' has not ended.");
+        TS_ASSERT_LESS_THAN_EQUALS(0.0, recorder.End());
+        recorder.Record("second \"quoted\"", 20u, 1.5);
+        TS_ASSERT_EQUALS(recorder.GetNumberOfResults(), 2u);
+
+        recorder.WriteResults("TestBenchmarkRecorder");
+
+        FileFinder results("TestBenchmarkRecorder/TestBenchmarkRecorder.json", RelativeTo::ChasteTestOutput);
+        TS_ASSERT(results.IsFile());
+        std::ifstream file(results.GetAbsolutePath().c_str());
+        std::stringstream contents;
+        contents << file.rdbuf();
+        std::string json = contents.str();
+
+        TS_ASSERT_DIFFERS(json.find("\"suite\": \"TestBenchmarkRecorder\""), std::string::npos);
+        TS_ASSERT_DIFFERS(json.find("\"version\": "), std::string::npos);
+        TS_ASSERT_DIFFERS(json.find("\"compiler\": "), std::string::npos);
+        TS_ASSERT_DIFFERS(json.find("{\"name\": \"first\", \"problem_size\": 10, \"seconds\": "), std::string::npos);
+        TS_ASSERT_DIFFERS(json.find("{\"name\": \"second \\\"quoted\\\"\", \"problem_size\": 20, \"seconds\": 1.5}"),
+                          std::string::npos);
+    }
+};
+
+#endif /*TESTBENCHMARKRECORDER_HPP_*/
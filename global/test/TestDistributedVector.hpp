@@ -212,6 +212,18 @@ public:
             TS_ASSERT_EQUALS(quadratic[index], index.Global * index.Global);
         }
 
+        // the same values through the raw local arrays
+        TS_ASSERT_EQUALS(distributed_vector.GetNumberOfStripes(), 1u);
+        TS_ASSERT_EQUALS(distributed_vector2.GetNumberOfStripes(), 2u);
+        double* p_local = distributed_vector.GetLocalArray();
+        double* p_local_striped = distributed_vector2.GetLocalArray();
+        for (unsigned local_index=0; local_index<hi-lo; local_index++)
+        {
+            TS_ASSERT_EQUALS(p_local[local_index], local_index*(lo+local_index));
+            TS_ASSERT_EQUALS(p_local_striped[2*local_index], local_index);
+            TS_ASSERT_EQUALS(p_local_striped[2*local_index+1], (lo+local_index)*(lo+local_index));
+        }
+
         // read the 2nd element of the first vector
         if (lo<=2 && 2<hi)
         {
@@ -36,6 +36,8 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef TESTGENERICEVENTHANDLER_HPP_
 #define TESTGENERICEVENTHANDLER_HPP_
 
+#include <sstream>
+
 #include "GenericEventHandler.hpp"
 #include "PetscSetupAndFinalize.hpp"
 
@@ -87,6 +89,56 @@ public:
         TS_ASSERT_THROWS_THIS(AnEventHandler::Report(),"Asked to report on an event handler which is set to zero.");
     }
 
+    void TestStructuredReport()
+    {
+        AnEventHandler::Reset();
+
+        AnEventHandler::BeginEvent(AnEventHandler::TEST1);
+        for (unsigned i=0; i<3; i++)
+        {
+            AnEventHandler::BeginEvent(AnEventHandler::TEST2);
+            AnEventHandler::RecordBytes(8.0, 16.0);
+            AnEventHandler::EndEvent(AnEventHandler::TEST2);
+        }
+        AnEventHandler::RecordBytes(1.0, 2.0);
+        AnEventHandler::EndEvent(AnEventHandler::TEST1);
+
+        TS_ASSERT_EQUALS(AnEventHandler::GetNumberOfCalls(AnEventHandler::TEST1), 1u);
+        TS_ASSERT_EQUALS(AnEventHandler::GetNumberOfCalls(AnEventHandler::TEST2), 3u);
+        TS_ASSERT_EQUALS(AnEventHandler::GetNumberOfCalls(AnEventHandler::TEST3), 1u);
+
+        // The total (TEST3) is still in progress, and stays so
+        std::stringstream report;
+        AnEventHandler::WriteJsonReport(report);
+        TS_ASSERT(AnEventHandler::Instance()->mHasBegun[AnEventHandler::TEST3]);
+
+        if (PetscTools::AmMaster())
+        {
+            std::string json = report.str();
+            std::string::size_type total_pos = json.find("\"name\": \"Test3\"");
+            std::string::size_type test1_pos = json.find("\"name\": \"Test1\"");
+            std::string::size_type test2_pos = json.find("\"name\": \"Test2\"");
+            TS_ASSERT(total_pos != std::string::npos);
+            TS_ASSERT(test1_pos != std::string::npos);
+            TS_ASSERT(test2_pos != std::string::npos);
+
+            // Test2 is nested in Test1, which is nested in the total
+            TS_ASSERT_LESS_THAN(total_pos, test1_pos);
+            TS_ASSERT_LESS_THAN(test1_pos, test2_pos);
+
+            // Every process does the same, so the min and max agree with the mean
+            std::string test1 = json.substr(test1_pos, test2_pos-test1_pos);
+            TS_ASSERT_DIFFERS(test1.find("\"calls\": {\"mean\": 1, \"min\": 1, \"max\": 1}"), std::string::npos);
+            TS_ASSERT_DIFFERS(test1.find("\"bytes_sent\": {\"mean\": 1, \"min\": 1, \"max\": 1}"), std::string::npos);
+            std::string test2 = json.substr(test2_pos);
+            TS_ASSERT_DIFFERS(test2.find("\"calls\": {\"mean\": 3, \"min\": 3, \"max\": 3}"), std::string::npos);
+            TS_ASSERT_DIFFERS(test2.find("\"bytes_received\": {\"mean\": 48, \"min\": 48, \"max\": 48}"), std::string::npos);
+        }
+
+        AnEventHandler::Reset();
+        TS_ASSERT_EQUALS(AnEventHandler::GetNumberOfCalls(AnEventHandler::TEST2), 0u);
+    }
+
     void TestEventExceptions()
     {
         // Should not be able to end an event that has not yet begun
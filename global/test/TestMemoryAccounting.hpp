@@ -0,0 +1,139 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTMEMORYACCOUNTING_HPP_
+#define TESTMEMORYACCOUNTING_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include <sstream>
+#include <vector>
+
+#include "AbstractMemoryAccountable.hpp"
+#include "MemoryAccounting.hpp"
+#include "PetscTools.hpp"
+#include "PetscSetupAndFinalize.hpp"
+
+class AnAccountableContainer : public AbstractMemoryAccountable
+{
+public:
+    std::vector<double> mData;
+
+    AnAccountableContainer(unsigned size)
+        : AbstractMemoryAccountable(MemoryAccounting::OUTPUT_CACHE),
+          mData(size)
+    {
+    }
+
+    double GetMemoryUsage() const
+    {
+        return GetVectorBytes(mData);
+    }
+};
+
+class TestMemoryAccounting : public CxxTest::TestSuite
+{
+public:
+
+    void TestRegistrationAndBytes()
+    {
+        MemoryAccounting::Reset();
+        unsigned num_before = MemoryAccounting::GetNumObjects(MemoryAccounting::OUTPUT_CACHE);
+        double bytes_before = MemoryAccounting::GetBytes(MemoryAccounting::OUTPUT_CACHE);
+
+        {
+            AnAccountableContainer container(1000);
+            TS_ASSERT_EQUALS(container.GetMemoryAccountingSubsystem(), MemoryAccounting::OUTPUT_CACHE);
+            TS_ASSERT_EQUALS(MemoryAccounting::GetNumObjects(MemoryAccounting::OUTPUT_CACHE), num_before + 1);
+            TS_ASSERT_DELTA(MemoryAccounting::GetBytes(MemoryAccounting::OUTPUT_CACHE) - bytes_before,
+                            1000*sizeof(double), 1e-9);
+
+            // A copy is accounted separately
+            AnAccountableContainer copy(container);
+            TS_ASSERT_EQUALS(MemoryAccounting::GetNumObjects(MemoryAccounting::OUTPUT_CACHE), num_before + 2);
+            TS_ASSERT_DELTA(MemoryAccounting::GetBytes(MemoryAccounting::OUTPUT_CACHE) - bytes_before,
+                            2000*sizeof(double), 1e-9);
+
+            // Assignment doesn't change the number of objects
+            copy = container;
+            TS_ASSERT_EQUALS(MemoryAccounting::GetNumObjects(MemoryAccounting::OUTPUT_CACHE), num_before + 2);
+
+            MemoryAccounting::Sample();
+        }
+
+        // The objects are forgotten when destroyed, but the peak remains until reset
+        TS_ASSERT_EQUALS(MemoryAccounting::GetNumObjects(MemoryAccounting::OUTPUT_CACHE), num_before);
+        TS_ASSERT_DELTA(MemoryAccounting::GetBytes(MemoryAccounting::OUTPUT_CACHE), bytes_before, 1e-9);
+        TS_ASSERT_LESS_THAN_EQUALS(bytes_before + 2000*sizeof(double),
+                                   MemoryAccounting::GetPeakBytes(MemoryAccounting::OUTPUT_CACHE));
+
+        MemoryAccounting::Reset();
+        TS_ASSERT_EQUALS(MemoryAccounting::GetPeakBytes(MemoryAccounting::OUTPUT_CACHE), 0.0);
+    }
+
+    void TestPeakResidentSetSize()
+    {
+        // Any running process has some resident memory
+        TS_ASSERT_LESS_THAN(0.0, MemoryAccounting::GetPeakResidentSetSize());
+    }
+
+    void TestReports()
+    {
+        AnAccountableContainer container(100);
+
+        MemoryAccounting::Reset();
+        MemoryAccounting::Report();
+        TS_ASSERT_LESS_THAN_EQUALS(100*sizeof(double), MemoryAccounting::GetPeakBytes(MemoryAccounting::OUTPUT_CACHE));
+
+        std::stringstream json;
+        MemoryAccounting::WriteJsonReport(json);
+        if (PetscTools::AmMaster())
+        {
+            std::string report = json.str();
+            for (unsigned subsystem=0; subsystem<MemoryAccounting::NUM_SUBSYSTEMS; subsystem++)
+            {
+                std::string name = "\"name\": \"" + std::string(MemoryAccounting::SubsystemName[subsystem]) + "\"";
+                TS_ASSERT_DIFFERS(report.find(name), std::string::npos);
+            }
+            TS_ASSERT_DIFFERS(report.find("\"peak_bytes\""), std::string::npos);
+            TS_ASSERT_DIFFERS(report.find("\"peak_rss_bytes\""), std::string::npos);
+        }
+        else
+        {
+            TS_ASSERT(json.str().empty());
+        }
+    }
+};
+
+#endif /*TESTMEMORYACCOUNTING_HPP_*/
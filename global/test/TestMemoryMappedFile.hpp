@@ -0,0 +1,105 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTMEMORYMAPPEDFILE_HPP_
+#define TESTMEMORYMAPPEDFILE_HPP_
+
+#include <cxxtest/TestSuite.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "MemoryMappedFile.hpp"
+#include "FileFinder.hpp"
+#include "OutputFileHandler.hpp"
+#include "PetscTools.hpp"
+#include "PetscSetupAndFinalize.hpp"
+
+class TestMemoryMappedFile : public CxxTest::TestSuite
+{
+public:
+
+    void TestMappingAFile()
+    {
+        FileFinder data_file("global/test/data/citations.txt", RelativeTo::ChasteSourceRoot);
+        TS_ASSERT(data_file.IsFile());
+
+        MemoryMappedFile mapped_file;
+        TS_ASSERT_EQUALS(mapped_file.IsOpen(), false);
+        TS_ASSERT(mapped_file.GetData() == NULL);
+        TS_ASSERT_EQUALS(mapped_file.GetSize(), 0u);
+
+#ifndef _MSC_VER
+        TS_ASSERT(mapped_file.Open(data_file.GetAbsolutePath()));
+        TS_ASSERT_EQUALS(mapped_file.IsOpen(), true);
+
+        // The mapped contents should match the file read through a stream
+        std::ifstream data_stream(data_file.GetAbsolutePath().c_str(), std::ios::binary);
+        std::stringstream contents;
+        contents << data_stream.rdbuf();
+        TS_ASSERT_EQUALS(mapped_file.GetSize(), contents.str().size());
+        TS_ASSERT_EQUALS(std::string(mapped_file.GetData(), mapped_file.GetSize()), contents.str());
+#endif // _MSC_VER
+
+        mapped_file.Close();
+        TS_ASSERT_EQUALS(mapped_file.IsOpen(), false);
+        TS_ASSERT(mapped_file.GetData() == NULL);
+        TS_ASSERT_EQUALS(mapped_file.GetSize(), 0u);
+    }
+
+    void TestFilesWhichCannotBeMapped()
+    {
+        MemoryMappedFile mapped_file;
+
+        // Missing files
+        TS_ASSERT_EQUALS(mapped_file.Open("no_such_file.txt"), false);
+        TS_ASSERT_EQUALS(mapped_file.IsOpen(), false);
+
+        // Empty files
+        OutputFileHandler handler("TestMemoryMappedFile");
+        if (PetscTools::AmMaster())
+        {
+            out_stream p_file = handler.OpenOutputFile("empty.txt");
+            p_file->close();
+        }
+        PetscTools::Barrier("TestMemoryMappedFile");
+        FileFinder empty_file = handler.FindFile("empty.txt");
+        TS_ASSERT_EQUALS(mapped_file.Open(empty_file.GetAbsolutePath()), false);
+        TS_ASSERT_EQUALS(mapped_file.IsOpen(), false);
+    }
+};
+
+#endif // TESTMEMORYMAPPEDFILE_HPP_
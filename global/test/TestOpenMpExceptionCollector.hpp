@@ -0,0 +1,108 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTOPENMPEXCEPTIONCOLLECTOR_HPP_
+#define TESTOPENMPEXCEPTIONCOLLECTOR_HPP_
+
+#include <cxxtest/TestSuite.h>
+
+#include "Exception.hpp"
+#include "OpenMpExceptionCollector.hpp"
+#include "FakePetscSetup.hpp"
+
+class TestOpenMpExceptionCollector : public CxxTest::TestSuite
+{
+public:
+
+    void TestNoException()
+    {
+        OpenMpExceptionCollector exception_collector;
+        TS_ASSERT(!exception_collector.HasException());
+        TS_ASSERT_THROWS_NOTHING(exception_collector.RethrowIfAny());
+    }
+
+    void TestFirstExceptionIsRethrown()
+    {
+        OpenMpExceptionCollector exception_collector;
+        for (unsigned i=0; i<3; i++)
+        {
+            try
+            {
+                EXCEPTION("Iteration " << i << " failed");
+            }
+            catch (...)
+            {
+                exception_collector.Capture();
+            }
+        }
+        TS_ASSERT(exception_collector.HasException());
+        TS_ASSERT_THROWS_CONTAINS(exception_collector.RethrowIfAny(), "Iteration 0 failed");
+
+        // The collector is empty again after re-throwing
+        TS_ASSERT(!exception_collector.HasException());
+        TS_ASSERT_THROWS_NOTHING(exception_collector.RethrowIfAny());
+    }
+
+    void TestExceptionFromThreads()
+    {
+        OpenMpExceptionCollector exception_collector;
+        int num_iterations = 100;
+        int num_done = 0;
+#ifdef CHASTE_OPENMP
+#pragma omp parallel for schedule(static) num_threads(4) reduction(+:num_done)
+#endif // CHASTE_OPENMP
+        for (int i=0; i<num_iterations; i++)
+        {
+            try
+            {
+                if (i%10 == 3)
+                {
+                    EXCEPTION("Iteration failed");
+                }
+                num_done++;
+            }
+            catch (...)
+            {
+                exception_collector.Capture();
+            }
+        }
+
+        // Every other iteration still ran
+        TS_ASSERT_EQUALS(num_done, 90);
+        TS_ASSERT_THROWS_THIS(exception_collector.RethrowIfAny(), "Iteration failed");
+    }
+};
+
+#endif /*TESTOPENMPEXCEPTIONCOLLECTOR_HPP_*/
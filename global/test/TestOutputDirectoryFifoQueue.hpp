@@ -111,6 +111,38 @@ public:
         TS_ASSERT(!dir2.Exists());
         TS_ASSERT(!dir1.Exists());
     }
+
+    void TestQueueRemovesDirectoriesAsynchronously()
+    {
+        FileFinder checkpoints("checkpoints3", RelativeTo::ChasteTestOutput);
+        PetscTools::Barrier("TestQueueRemovesDirectoriesAsynchronously-0");
+        if (PetscTools::AmMaster())
+        {
+            ABORT_IF_THROWS(checkpoints.Remove());
+        }
+        PetscTools::Barrier("TestQueueRemovesDirectoriesAsynchronously-1");
+
+        OutputDirectoryFifoQueue fifo_queue("checkpoints3", 2);
+        fifo_queue.SetRemoveDirectoriesAsynchronously();
+
+        fifo_queue.CreateNextDir("0.1");
+        fifo_queue.CreateNextDir("0.2");
+        fifo_queue.CreateNextDir("0.3");
+        fifo_queue.CreateNextDir("0.4");
+
+        // Once flushed, only the newest directories are left
+        fifo_queue.Flush();
+        TS_ASSERT(!FileFinder("0.1", checkpoints).Exists());
+        TS_ASSERT(!FileFinder("0.2", checkpoints).Exists());
+        TS_ASSERT(FileFinder("0.3", checkpoints).IsDir());
+        TS_ASSERT(FileFinder("0.4", checkpoints).IsDir());
+
+        // Switching back to synchronous removal
+        fifo_queue.SetRemoveDirectoriesAsynchronously(false);
+        fifo_queue.CreateNextDir("0.5");
+        TS_ASSERT(!FileFinder("0.3", checkpoints).Exists());
+        TS_ASSERT(FileFinder("0.5", checkpoints).IsDir());
+    }
 };
 
 #endif /*TESTOUTPUTDIRECTORYFIFOQUEUE_HPP_*/
@@ -215,6 +215,38 @@ public:
         TS_ASSERT_EQUALS(handler_self.GetAbsolutePath(), handler.GetOutputDirectoryFullPath());
     }
 
+    void TestOutputBufferSize()
+    {
+        TS_ASSERT_EQUALS(OutputFileHandler::GetOutputBufferSize(), 65536u);
+        OutputFileHandler handler("TestOutputFileHandler/buffered", false);
+
+        std::string line(100, 'x');
+        unsigned sizes[3] = {0u, 16u, 1u<<20};
+        for (unsigned i=0; i<3; i++)
+        {
+            OutputFileHandler::SetOutputBufferSize(sizes[i]);
+            TS_ASSERT_EQUALS(OutputFileHandler::GetOutputBufferSize(), sizes[i]);
+            {
+                // Contents are written out when the last reference to the stream goes
+                out_stream p_file = handler.OpenOutputFile("buffered.txt", i, "");
+                for (unsigned j=0; j<1000; j++)
+                {
+                    *p_file << line << '\n';
+                }
+            }
+            std::ifstream in_file(handler.FindFile("buffered.txt" + std::to_string(i)).GetAbsolutePath().c_str());
+            unsigned num_lines = 0;
+            std::string read_line;
+            while (std::getline(in_file, read_line))
+            {
+                TS_ASSERT_EQUALS(read_line, line);
+                num_lines++;
+            }
+            TS_ASSERT_EQUALS(num_lines, 1000u);
+        }
+        OutputFileHandler::SetOutputBufferSize(65536u);
+    }
+
     void TestWeCanOnlyDeleteFoldersWeHaveMadeOurselves()
     {
         std::string test_folder = "cannot_delete_me";
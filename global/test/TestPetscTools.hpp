@@ -39,6 +39,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <cxxtest/TestSuite.h>
 #include <petscvec.h>
 #include <petscmat.h>
+#include <algorithm>
 #include <cstring>
 #include "DistributedVectorFactory.hpp"
 #include "ReplicatableVector.hpp"
@@ -248,6 +249,42 @@ public:
         TS_ASSERT(!PetscTools::IsIsolated());
     }
 
+    void TestSubCommunicatorWorld()
+    {
+        unsigned my_rank = PetscTools::GetMyRank();
+        unsigned num_procs = PetscTools::GetNumProcs();
+
+        // Pairs of processes become worlds of their own
+        MPI_Comm pair_world;
+        MPI_Comm_split(PETSC_COMM_WORLD, my_rank/2, my_rank, &pair_world);
+        PetscTools::SetWorld(pair_world);
+        TS_ASSERT_EQUALS(PetscTools::GetWorld(), pair_world);
+        unsigned pair_size = (my_rank/2 == (num_procs-1)/2 && num_procs%2 == 1) ? 1u : 2u;
+        TS_ASSERT_EQUALS(PetscTools::GetNumProcs(), pair_size);
+        TS_ASSERT_EQUALS(PetscTools::GetMyRank(), my_rank%2);
+        TS_ASSERT_EQUALS(PetscTools::AmMaster(), my_rank%2 == 0);
+
+        // Collective operations only involve the pair
+        PetscTools::Barrier("TestSubCommunicatorWorld");
+        TS_ASSERT(PetscTools::ReplicateBool(my_rank%2 == 0));
+        Vec vec = PetscTools::CreateVec(10);
+        PetscInt size;
+        VecGetSize(vec, &size);
+        TS_ASSERT_EQUALS(size, 10);
+        PetscTools::Destroy(vec);
+
+        // Isolation still wins
+        PetscTools::IsolateProcesses();
+        TS_ASSERT_EQUALS(PetscTools::GetWorld(), PETSC_COMM_SELF);
+        PetscTools::IsolateProcesses(false);
+
+        PetscTools::SetWorld(PETSC_COMM_WORLD);
+        MPI_Comm_free(&pair_world);
+        TS_ASSERT_EQUALS(PetscTools::GetWorld(), PETSC_COMM_WORLD);
+        TS_ASSERT_EQUALS(PetscTools::GetNumProcs(), num_procs);
+        TS_ASSERT_EQUALS(PetscTools::GetMyRank(), my_rank);
+    }
+
     void TestDumpPetscObjects()
     {
         Mat matrix;
@@ -416,6 +453,45 @@ public:
                 "; bailing out"); // both the replicated and original should contain this phrase
     }
 
+    void TestSetupMatWithTypeFromOptions()
+    {
+        // A type derived from AIJ which is always available, standing in for e.g. aijcusparse
+        PetscTools::SetOption("-mat_type", "aijperm");
+        Mat mat;
+        PetscTools::SetupMat(mat, 10, 10, 3);
+        PetscTools::ClearOption("-mat_type");
+
+        MatType type;
+        MatGetType(mat, &type);
+        std::string expected_type = PetscTools::IsSequential() ? "seqaijperm" : "mpiaijperm";
+        TS_ASSERT_EQUALS(std::string(type), expected_type);
+
+        // The preallocation survives the change of type, so filling in a tridiagonal matrix needs no mallocs
+        PetscInt lo, hi;
+        MatGetOwnershipRange(mat, &lo, &hi);
+        for (PetscInt row=lo; row<hi; row++)
+        {
+            for (PetscInt col=std::max(row-1, 0); col<=std::min(row+1, 9); col++)
+            {
+                MatSetValue(mat, row, col, 1.0, INSERT_VALUES);
+            }
+        }
+        MatAssemblyBegin(mat, MAT_FINAL_ASSEMBLY);
+        MatAssemblyEnd(mat, MAT_FINAL_ASSEMBLY);
+        MatInfo info;
+        MatGetInfo(mat, MAT_LOCAL, &info);
+        TS_ASSERT_EQUALS(info.mallocs, 0.0);
+
+        PetscTools::Destroy(mat);
+
+        // Without the option the default type is used
+        PetscTools::SetupMat(mat, 10, 10, 3);
+        MatGetType(mat, &type);
+        expected_type = PetscTools::IsSequential() ? MATSEQAIJ : MATMPIAIJ;
+        TS_ASSERT_EQUALS(std::string(type), expected_type);
+        PetscTools::Destroy(mat);
+    }
+
     void TestSetOptionWithLogging()
     {
         // See #2933: we need to cover either PetscLogBegin() or PetscLogDefaultBegin()
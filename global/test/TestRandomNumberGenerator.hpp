@@ -485,6 +485,148 @@ public:
         TS_ASSERT_DELTA(p_gen->ExponentialRandomDeviate(3.0), 0.2967, 1e-4);
         TS_ASSERT_DELTA(p_gen->ExponentialRandomDeviate(4.0), 0.2715, 1e-4);
     }
+
+    void TestCounterBasedKnownAnswers()
+    {
+        // Known-answer tests from the Random123 distribution (kat_vectors)
+        uint32_t output[4];
+        {
+            uint32_t counter[4] = { 0u, 0u, 0u, 0u };
+            uint32_t key[2] = { 0u, 0u };
+            CounterBasedRandomNumberGenerator::Philox4x32(counter, key, output);
+            TS_ASSERT_EQUALS(output[0], 0x6627e8d5u);
+            TS_ASSERT_EQUALS(output[1], 0xe169c58du);
+            TS_ASSERT_EQUALS(output[2], 0xbc57ac4cu);
+            TS_ASSERT_EQUALS(output[3], 0x9b00dbd8u);
+        }
+        {
+            uint32_t counter[4] = { 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu };
+            uint32_t key[2] = { 0xffffffffu, 0xffffffffu };
+            CounterBasedRandomNumberGenerator::Philox4x32(counter, key, output);
+            TS_ASSERT_EQUALS(output[0], 0x408f276du);
+            TS_ASSERT_EQUALS(output[1], 0x41c83b0eu);
+            TS_ASSERT_EQUALS(output[2], 0xa20bc7c6u);
+            TS_ASSERT_EQUALS(output[3], 0x6d5451fdu);
+        }
+        {
+            uint32_t counter[4] = { 0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u };
+            uint32_t key[2] = { 0xa4093822u, 0x299f31d0u };
+            CounterBasedRandomNumberGenerator::Philox4x32(counter, key, output);
+            TS_ASSERT_EQUALS(output[0], 0xd16cfe09u);
+            TS_ASSERT_EQUALS(output[1], 0x94fdccebu);
+            TS_ASSERT_EQUALS(output[2], 0x5001e420u);
+            TS_ASSERT_EQUALS(output[3], 0x24126ea1u);
+        }
+    }
+
+    void TestCounterBasedStreams()
+    {
+        RandomNumberGenerator::Destroy();
+        RandomNumberGenerator* p_gen = RandomNumberGenerator::Instance();
+        p_gen->Reseed(42);
+
+        // Reproducible values for a given seed and stream
+        CounterBasedRandomNumberGenerator stream = p_gen->GetStream(1u, 2u, 3u);
+        TS_ASSERT_DELTA(stream.ranf(), 0.8223, 1e-4);
+        TS_ASSERT_DELTA(stream.ranf(), 0.0545, 1e-4);
+        TS_ASSERT_DELTA(stream.ranf(), 0.2488, 1e-4);
+
+        // Drawing from the Mersenne Twister or other streams does not affect a stream
+        p_gen->ranf();
+        CounterBasedRandomNumberGenerator other_stream = p_gen->GetStream(1u, 2u, 4u);
+        double first_other = other_stream.ranf();
+        CounterBasedRandomNumberGenerator same_stream = p_gen->GetStream(1u, 2u, 3u);
+        TS_ASSERT_DELTA(same_stream.ranf(), 0.8223, 1e-4);
+        TS_ASSERT_DIFFERS(same_stream.ranf(), first_other);
+
+        // Jumping within a stream (each ranf() uses half a block)
+        same_stream.SetBlockIndex(1u);
+        TS_ASSERT_DELTA(same_stream.ranf(), 0.2488, 1e-4);
+
+        // Different seeds give different streams
+        p_gen->Reseed(43);
+        CounterBasedRandomNumberGenerator reseeded_stream = p_gen->GetStream(1u, 2u, 3u);
+        TS_ASSERT_DIFFERS(reseeded_stream.ranf(), 0.8223303889645386);
+
+        // Sanity check the distributions
+        CounterBasedRandomNumberGenerator stats_stream = p_gen->GetStream(7u);
+        unsigned num_samples = 100000;
+        double sum_uniform = 0.0;
+        double sum_normal = 0.0;
+        double sum_normal_squared = 0.0;
+        double sum_exponential = 0.0;
+        std::vector<unsigned> counts(6, 0u);
+        for (unsigned i = 0; i < num_samples; i++)
+        {
+            double uniform = stats_stream.ranf();
+            TS_ASSERT_LESS_THAN(0.0, uniform);
+            TS_ASSERT_LESS_THAN(uniform, 1.0);
+            sum_uniform += uniform;
+
+            double normal = stats_stream.NormalRandomDeviate(1.0, 2.0);
+            sum_normal += normal;
+            sum_normal_squared += normal * normal;
+
+            sum_exponential += stats_stream.ExponentialRandomDeviate(4.0);
+
+            unsigned value = stats_stream.randMod(6u);
+            TS_ASSERT_LESS_THAN(value, 6u);
+            counts[value]++;
+        }
+        TS_ASSERT_DELTA(sum_uniform / num_samples, 0.5, 5e-3);
+        double mean_normal = sum_normal / num_samples;
+        TS_ASSERT_DELTA(mean_normal, 1.0, 2e-2);
+        TS_ASSERT_DELTA(sum_normal_squared / num_samples - mean_normal * mean_normal, 4.0, 5e-2);
+        TS_ASSERT_DELTA(sum_exponential / num_samples, 0.25, 5e-3);
+        for (unsigned i = 0; i < 6; i++)
+        {
+            TS_ASSERT_DELTA(counts[i] / (double)num_samples, 1.0 / 6.0, 5e-3);
+        }
+
+        std::vector<unsigned> permutation;
+        stats_stream.Shuffle(10, permutation);
+        std::vector<unsigned> sorted_permutation(permutation);
+        std::sort(sorted_permutation.begin(), sorted_permutation.end());
+        for (unsigned i = 0; i < 10; i++)
+        {
+            TS_ASSERT_EQUALS(sorted_permutation[i], i);
+        }
+        stats_stream.Shuffle(0, permutation);
+        TS_ASSERT(permutation.empty());
+
+        RandomNumberGenerator::Destroy();
+    }
+
+    void TestArchiveCounterBasedSeed()
+    {
+        OutputFileHandler handler("archive", false);
+        std::string archive_filename = handler.GetOutputDirectoryFullPath() + "random_number_seed.arch";
+
+        {
+            RandomNumberGenerator* p_gen = RandomNumberGenerator::Instance();
+            p_gen->Reseed(42);
+
+            std::ofstream ofs(archive_filename.c_str());
+            boost::archive::text_oarchive output_arch(ofs);
+            SerializableSingleton<RandomNumberGenerator>* const p_wrapper = p_gen->GetSerializationWrapper();
+            output_arch << p_wrapper;
+            RandomNumberGenerator::Destroy();
+        }
+
+        {
+            RandomNumberGenerator* p_gen = RandomNumberGenerator::Instance();
+            p_gen->Reseed(5);
+
+            std::ifstream ifs(archive_filename.c_str(), std::ios::binary);
+            boost::archive::text_iarchive input_arch(ifs);
+            SerializableSingleton<RandomNumberGenerator>* p_wrapper;
+            input_arch >> p_wrapper;
+
+            CounterBasedRandomNumberGenerator stream = p_gen->GetStream(1u, 2u, 3u);
+            TS_ASSERT_DELTA(stream.ranf(), 0.8223, 1e-4);
+            RandomNumberGenerator::Destroy();
+        }
+    }
 };
 
 #endif /*TESTRANDOMNUMBERGENERATOR_HPP_*/
@@ -0,0 +1,123 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTSCALINGSTUDY_HPP_
+#define TESTSCALINGSTUDY_HPP_
+
+#include <cxxtest/TestSuite.h>
+
+#include <fstream>
+#include <sstream>
+
+#include "CommandLineArguments.hpp"
+#include "FileFinder.hpp"
+#include "HeartEventHandler.hpp"
+#include "PetscTools.hpp"
+#include "ScalingStudy.hpp"
+#include "PetscSetupAndFinalize.hpp"
+
+class TestScalingStudy : public CxxTest::TestSuite
+{
+public:
+
+    void TestDefaultsAndReport()
+    {
+        ScalingStudy study("TestStudy", 1000u, 20u);
+        TS_ASSERT_EQUALS(study.GetMode(), ScalingStudy::STRONG);
+        TS_ASSERT_EQUALS(study.GetProblemSize(), 1000u);
+        TS_ASSERT_EQUALS(study.GetNumSteps(), 20u);
+
+        std::stringstream name;
+        name << "TestStudy_strong_1000_np" << PetscTools::GetNumProcs();
+        TS_ASSERT_EQUALS(study.GetConfigurationName(), name.str());
+
+        HeartEventHandler::Reset();
+        HeartEventHandler::BeginEvent(HeartEventHandler::SOLVE_ODES);
+        HeartEventHandler::EndEvent(HeartEventHandler::SOLVE_ODES);
+        study.WriteReport<HeartEventHandler>(1010u, "TestScalingStudy");
+
+        FileFinder report("TestScalingStudy/" + name.str() + ".json", RelativeTo::ChasteTestOutput);
+        TS_ASSERT(report.IsFile());
+        std::ifstream file(report.GetAbsolutePath().c_str());
+        std::stringstream contents;
+        contents << file.rdbuf();
+        std::string json = contents.str();
+
+        TS_ASSERT_DIFFERS(json.find("\"study\": \"TestStudy\""), std::string::npos);
+        TS_ASSERT_DIFFERS(json.find("\"mode\": \"strong\""), std::string::npos);
+        TS_ASSERT_DIFFERS(json.find("\"problem_size\": 1010"), std::string::npos);
+        TS_ASSERT_DIFFERS(json.find("\"steps\": 20"), std::string::npos);
+        TS_ASSERT_DIFFERS(json.find("\"name\": \"Ode\""), std::string::npos);
+        TS_ASSERT_DIFFERS(json.find("\"imbalance\": "), std::string::npos);
+    }
+
+    void TestCommandLineOptions()
+    {
+        // Save the real args to be restored at the end
+        int* p_real_argc = CommandLineArguments::Instance()->p_argc;
+        char*** p_real_argv = CommandLineArguments::Instance()->p_argv;
+
+        char arg0[] = "TestScalingStudy";
+        char arg1[] = "-scaling_mode";
+        char arg2[] = "weak";
+        char arg3[] = "-scaling_size";
+        char arg4[] = "500";
+        char arg5[] = "-scaling_steps";
+        char arg6[] = "7";
+        char* args[] = {arg0, arg1, arg2, arg3, arg4, arg5, arg6};
+        int new_argc = 7;
+        char** new_argv = args;
+        CommandLineArguments::Instance()->p_argc = &new_argc;
+        CommandLineArguments::Instance()->p_argv = &new_argv;
+
+        ScalingStudy study("TestStudy", 1000u, 20u);
+        TS_ASSERT_EQUALS(study.GetMode(), ScalingStudy::WEAK);
+        TS_ASSERT_EQUALS(study.GetProblemSize(), 500u*PetscTools::GetNumProcs());
+        TS_ASSERT_EQUALS(study.GetNumSteps(), 7u);
+        std::stringstream name;
+        name << "TestStudy_weak_500_np" << PetscTools::GetNumProcs();
+        TS_ASSERT_EQUALS(study.GetConfigurationName(), name.str());
+
+        char bad_mode[] = "sideways";
+        args[2] = bad_mode;
+        TS_ASSERT_THROWS_THIS(ScalingStudy("TestStudy", 1000u, 20u),
+                              "Unknown scaling mode 'sideways'; use 'strong' or 'weak'.");
+
+        CommandLineArguments::Instance()->p_argc = p_real_argc;
+        CommandLineArguments::Instance()->p_argv = p_real_argv;
+    }
+};
+
+#endif /*TESTSCALINGSTUDY_HPP_*/
@@ -0,0 +1,102 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTVECTORISABLEMATHS_HPP_
+#define TESTVECTORISABLEMATHS_HPP_
+
+#include <cxxtest/TestSuite.h>
+
+#include <cmath>
+#include <vector>
+#include "VectorisableMaths.hpp"
+#include "FakePetscSetup.hpp"
+
+class TestVectorisableMaths : public CxxTest::TestSuite
+{
+public:
+
+    void TestScalarFunctions()
+    {
+        // SLEEF guarantees at worst 3.5 ULP, so a relative tolerance of 1e-15 covers every build
+        double max_error = GetVectorisableMathsMaxUlpError();
+        TS_ASSERT_LESS_THAN_EQUALS(max_error, 3.5);
+
+        for (double x=-20.0; x<=20.0; x+=0.37)
+        {
+            TS_ASSERT_DELTA(VecExp(x), exp(x), 1e-15*exp(x));
+            TS_ASSERT_DELTA(VecTanh(x), tanh(x), 1e-15);
+            TS_ASSERT_DELTA(VecPow(2.5, x), pow(2.5, x), 1e-15*pow(2.5, x));
+            if (x > 0.0)
+            {
+                TS_ASSERT_DELTA(VecLog(x), log(x), 1e-15*(1.0+fabs(log(x))));
+            }
+        }
+
+        TS_ASSERT_EQUALS(VecExp(0.0), 1.0);
+        TS_ASSERT_EQUALS(VecLog(1.0), 0.0);
+        TS_ASSERT_EQUALS(VecPow(3.0, 2.0), 9.0);
+    }
+
+    void TestArrayFunctions()
+    {
+        // Use an odd size so the scalar remainder loop is exercised too
+        unsigned size = 101;
+        std::vector<double> in(size);
+        std::vector<double> out(size);
+        for (unsigned i=0; i<size; i++)
+        {
+            in[i] = -10.0 + 0.2*i;
+        }
+
+        VecExp(&in[0], &out[0], size);
+        for (unsigned i=0; i<size; i++)
+        {
+            TS_ASSERT_DELTA(out[i], exp(in[i]), 1e-15*exp(in[i]));
+        }
+
+        // In-place evaluation is allowed
+        VecLog(&out[0], &out[0], size);
+        for (unsigned i=0; i<size; i++)
+        {
+            TS_ASSERT_DELTA(out[i], in[i], 1e-13);
+        }
+
+        // Nothing happens for an empty array
+        VecExp(&in[0], &out[0], 0u);
+        TS_ASSERT_DELTA(out[0], in[0], 1e-13);
+    }
+};
+
+#endif /*TESTVECTORISABLEMATHS_HPP_*/
@@ -0,0 +1,468 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "AbstractCardiacCellBatch.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <typeinfo>
+
+#include "EulerIvpOdeSolver.hpp"
+#include "HeartConfig.hpp"
+#include "TimeStepper.hpp"
+
+AbstractCardiacCellBatch::AbstractCardiacCellBatch(unsigned numberOfStateVariables,
+                                                   unsigned voltageIndex,
+                                                   unsigned maxBatchSize,
+                                                   unsigned numberOfParameters)
+    : mMaxBatchSize(maxBatchSize),
+      mKeepStateResident(false),
+      mResidentStateInSinglePrecision(false),
+      mNumberOfStateVariables(numberOfStateVariables),
+      mVoltageIndex(voltageIndex),
+      mDt(HeartConfig::Instance()->GetOdeTimeStep()),
+      mNumCells(0u),
+      mSetVoltageDerivativeToZero(false),
+      mNumberOfParameters(numberOfParameters)
+{
+    assert(voltageIndex < numberOfStateVariables);
+    assert(maxBatchSize > 0u);
+    mStateVariables.reserve(mNumberOfStateVariables*mMaxBatchSize);
+    mDerivatives.reserve(mNumberOfStateVariables*mMaxBatchSize);
+    mStimulus.reserve(mMaxBatchSize);
+    mParameters.reserve(mNumberOfParameters*mMaxBatchSize);
+}
+
+AbstractCardiacCellBatch::~AbstractCardiacCellBatch()
+{
+}
+
+bool AbstractCardiacCellBatch::IsCompatible(AbstractCardiacCellInterface* pCell) const
+{
+    return IsModelCompatible(pCell) && IsSolverCompatible(pCell);
+}
+
+bool AbstractCardiacCellBatch::IsSolverCompatible(AbstractCardiacCellInterface* pCell) const
+{
+    // Cells with a built-in solver (e.g. CVODE, Rush-Larsen) don't have one of these
+    const boost::shared_ptr<AbstractIvpOdeSolver> p_solver = pCell->GetSolver();
+    return p_solver && typeid(*p_solver) == typeid(EulerIvpOdeSolver) && HasSameTimestep(pCell);
+}
+
+bool AbstractCardiacCellBatch::HasSameTimestep(AbstractCardiacCellInterface* pCell) const
+{
+    return fabs(pCell->GetTimestep() - mDt) <= 1e-12*mDt;
+}
+
+void AbstractCardiacCellBatch::SetTimestep(double dt)
+{
+    mDt = dt;
+}
+
+unsigned AbstractCardiacCellBatch::GetMaxBatchSize() const
+{
+    return mMaxBatchSize;
+}
+
+void AbstractCardiacCellBatch::AdvanceBatch(double time, double dt)
+{
+    EvaluateYDerivativesBatch(time, mStateVariables, mStimulus, mDerivatives);
+
+    const unsigned num_entries = mStateVariables.size();
+    double* p_y = &mStateVariables[0];
+    const double* p_dy = &mDerivatives[0];
+    for (unsigned i=0; i<num_entries; i++)
+    {
+        p_y[i] += dt*p_dy[i];
+    }
+}
+
+void AbstractCardiacCellBatch::ComputeIIonicBatch(const std::vector<AbstractCardiacCellInterface*>& rCells,
+                                                  const std::vector<double>& rY,
+                                                  std::vector<double>& rIIonic)
+{
+    std::vector<double> state(mNumberOfStateVariables);
+    for (unsigned i=0; i<mNumCells; i++)
+    {
+        for (unsigned k=0; k<mNumberOfStateVariables; k++)
+        {
+            state[k] = rY[k*mNumCells + i];
+        }
+        rIIonic[i] = rCells[i]->GetIIonic(&state);
+    }
+}
+
+void AbstractCardiacCellBatch::GatherState(const std::vector<AbstractCardiacCellInterface*>& rCells)
+{
+    mStateVariables.resize(mNumberOfStateVariables*mNumCells);
+    for (unsigned i=0; i<mNumCells; i++)
+    {
+        assert(IsCompatible(rCells[i]));
+        std::vector<double> state = rCells[i]->GetStdVecStateVariables();
+        assert(state.size() == mNumberOfStateVariables);
+        for (unsigned k=0; k<mNumberOfStateVariables; k++)
+        {
+            mStateVariables[k*mNumCells + i] = state[k];
+        }
+    }
+}
+
+void AbstractCardiacCellBatch::ScatterState(const std::vector<AbstractCardiacCellInterface*>& rCells,
+                                            const std::vector<double>& rY)
+{
+    const unsigned num_cells = rCells.size();
+    assert(rY.size() == mNumberOfStateVariables*num_cells);
+    std::vector<double> state(mNumberOfStateVariables);
+    for (unsigned i=0; i<num_cells; i++)
+    {
+        for (unsigned k=0; k<mNumberOfStateVariables; k++)
+        {
+            state[k] = rY[k*num_cells + i];
+        }
+        rCells[i]->SetStateVariables(state);
+    }
+}
+
+void AbstractCardiacCellBatch::Integrate(const std::vector<AbstractCardiacCellInterface*>& rCells,
+                                         double tStart,
+                                         double tEnd,
+                                         bool updateVoltage)
+{
+    assert(mStateVariables.size() == mNumberOfStateVariables*mNumCells);
+    mDerivatives.resize(mNumberOfStateVariables*mNumCells);
+    mStimulus.resize(mNumCells);
+
+    // Parameters may have been changed since the last solve
+    mParameters.resize(mNumberOfParameters*mNumCells);
+    for (unsigned i=0; i<mNumCells; i++)
+    {
+        for (unsigned k=0; k<mNumberOfParameters; k++)
+        {
+            mParameters[k*mNumCells + i] = rCells[i]->GetParameter(k);
+        }
+    }
+
+    mSetVoltageDerivativeToZero = !updateVoltage;
+    TimeStepper stepper(tStart, tEnd, mDt);
+    while (!stepper.IsTimeAtEnd())
+    {
+        const double time = stepper.GetTime();
+        for (unsigned i=0; i<mNumCells; i++)
+        {
+            mStimulus[i] = rCells[i]->GetIntracellularAreaStimulus(time);
+        }
+        AdvanceBatch(time, stepper.GetNextTimeStep());
+        stepper.AdvanceOneTimeStep();
+    }
+    mSetVoltageDerivativeToZero = false;
+}
+
+void AbstractCardiacCellBatch::SolveBatch(const std::vector<AbstractCardiacCellInterface*>& rCells,
+                                          double tStart,
+                                          double tEnd,
+                                          bool updateVoltage)
+{
+    mNumCells = rCells.size();
+    assert(mNumCells <= mMaxBatchSize);
+    if (mNumCells == 0u)
+    {
+        return;
+    }
+
+    GatherState(rCells);
+    Integrate(rCells, tStart, tEnd, updateVoltage);
+    ScatterState(rCells, mStateVariables);
+}
+
+void AbstractCardiacCellBatch::SetKeepStateResident(bool keepResident)
+{
+    if (!keepResident)
+    {
+        ClearResidentState();
+    }
+    mKeepStateResident = keepResident;
+}
+
+bool AbstractCardiacCellBatch::GetKeepStateResident() const
+{
+    return mKeepStateResident;
+}
+
+void AbstractCardiacCellBatch::SetResidentStateInSinglePrecision(bool singlePrecision)
+{
+    ClearResidentState();
+    mResidentStateInSinglePrecision = singlePrecision;
+}
+
+bool AbstractCardiacCellBatch::GetResidentStateInSinglePrecision() const
+{
+    return mResidentStateInSinglePrecision;
+}
+
+void AbstractCardiacCellBatch::ScatterResidentState(unsigned blockIndex)
+{
+    if (mResidentStateInSinglePrecision)
+    {
+        const std::vector<float>& r_single = mResidentStateVariablesSingle[blockIndex];
+        ScatterState(mResidentCells[blockIndex], std::vector<double>(r_single.begin(), r_single.end()));
+    }
+    else
+    {
+        ScatterState(mResidentCells[blockIndex], mResidentStateVariables[blockIndex]);
+    }
+}
+
+void AbstractCardiacCellBatch::ScatterResidentCell(unsigned blockIndex, unsigned position)
+{
+    const unsigned num_cells = mResidentCells[blockIndex].size();
+    std::vector<double> state(mNumberOfStateVariables);
+    for (unsigned k=0; k<mNumberOfStateVariables; k++)
+    {
+        if (mResidentStateInSinglePrecision)
+        {
+            state[k] = mResidentStateVariablesSingle[blockIndex][k*num_cells + position];
+        }
+        else
+        {
+            state[k] = mResidentStateVariables[blockIndex][k*num_cells + position];
+        }
+    }
+    mResidentCells[blockIndex][position]->SetStateVariables(state);
+}
+
+void AbstractCardiacCellBatch::GatherResidentCell(unsigned blockIndex, unsigned position)
+{
+    const unsigned num_cells = mResidentCells[blockIndex].size();
+    std::vector<double> state = mResidentCells[blockIndex][position]->GetStdVecStateVariables();
+    assert(state.size() == mNumberOfStateVariables);
+    for (unsigned k=0; k<mNumberOfStateVariables; k++)
+    {
+        if (mResidentStateInSinglePrecision)
+        {
+            mResidentStateVariablesSingle[blockIndex][k*num_cells + position] = state[k];
+        }
+        else
+        {
+            mResidentStateVariables[blockIndex][k*num_cells + position] = state[k];
+        }
+    }
+}
+
+void AbstractCardiacCellBatch::RereadResidentCells(unsigned blockIndex)
+{
+    if (mResidentBlockNeedsRereading[blockIndex])
+    {
+        for (unsigned i=0; i<mResidentCells[blockIndex].size(); i++)
+        {
+            GatherResidentCell(blockIndex, i);
+        }
+    }
+    else
+    {
+        for (std::set<unsigned>::const_iterator it = mResidentCellsToReread[blockIndex].begin();
+             it != mResidentCellsToReread[blockIndex].end();
+             ++it)
+        {
+            GatherResidentCell(blockIndex, *it);
+        }
+    }
+    mResidentBlockNeedsRereading[blockIndex] = false;
+    mResidentCellsToReread[blockIndex].clear();
+}
+
+void AbstractCardiacCellBatch::SolveResidentBatch(unsigned blockIndex,
+                                                  const std::vector<AbstractCardiacCellInterface*>& rCells,
+                                                  std::vector<double>& rVoltages,
+                                                  std::vector<double>& rIIonic,
+                                                  double tStart,
+                                                  double tEnd,
+                                                  bool updateVoltage)
+{
+    mNumCells = rCells.size();
+    assert(mNumCells <= mMaxBatchSize);
+    assert(rVoltages.size() == mNumCells);
+    rIIonic.resize(mNumCells);
+    if (mNumCells == 0u)
+    {
+        return;
+    }
+
+    if (!mKeepStateResident)
+    {
+        for (unsigned i=0; i<mNumCells; i++)
+        {
+            rCells[i]->SetVoltage(rVoltages[i]);
+        }
+        SolveBatch(rCells, tStart, tEnd, updateVoltage);
+        for (unsigned i=0; i<mNumCells; i++)
+        {
+            rVoltages[i] = rCells[i]->GetVoltage();
+            rIIonic[i] = rCells[i]->GetIIonic();
+        }
+        return;
+    }
+
+    if (blockIndex >= mResidentCells.size())
+    {
+        mResidentCells.resize(blockIndex+1);
+        mResidentStateVariables.resize(blockIndex+1);
+        mResidentStateVariablesSingle.resize(blockIndex+1);
+        mResidentCellsAreStale.resize(blockIndex+1, false);
+        mResidentCellsToReread.resize(blockIndex+1);
+        mResidentBlockNeedsRereading.resize(blockIndex+1, false);
+    }
+
+    // Pick up any changes made to the cells since they were written back
+    RereadResidentCells(blockIndex);
+    if (mResidentCells[blockIndex] == rCells)
+    {
+        if (mResidentStateInSinglePrecision)
+        {
+            const std::vector<float>& r_single = mResidentStateVariablesSingle[blockIndex];
+            mStateVariables.assign(r_single.begin(), r_single.end());
+        }
+        else
+        {
+            mStateVariables.swap(mResidentStateVariables[blockIndex]);
+        }
+    }
+    else
+    {
+        // Don't lose the newer state of whatever the block held before
+        if (mResidentCellsAreStale[blockIndex])
+        {
+            ScatterResidentState(blockIndex);
+        }
+        const std::vector<AbstractCardiacCellInterface*>& r_old_cells = mResidentCells[blockIndex];
+        for (unsigned i=0; i<r_old_cells.size(); i++)
+        {
+            std::map<const AbstractCardiacCellInterface*, std::pair<unsigned, unsigned> >::iterator it
+                = mResidentCellPositions.find(r_old_cells[i]);
+            if (it != mResidentCellPositions.end() && it->second.first == blockIndex)
+            {
+                mResidentCellPositions.erase(it);
+            }
+        }
+        GatherState(rCells);
+        mResidentCells[blockIndex] = rCells;
+        for (unsigned i=0; i<mNumCells; i++)
+        {
+            mResidentCellPositions[rCells[i]] = std::make_pair(blockIndex, i);
+        }
+    }
+
+    double* p_v = &mStateVariables[mVoltageIndex*mNumCells];
+    for (unsigned i=0; i<mNumCells; i++)
+    {
+        p_v[i] = rVoltages[i];
+    }
+    Integrate(rCells, tStart, tEnd, updateVoltage);
+    if (updateVoltage)
+    {
+        for (unsigned i=0; i<mNumCells; i++)
+        {
+            rVoltages[i] = p_v[i];
+        }
+    }
+    ComputeIIonicBatch(rCells, mStateVariables, rIIonic);
+
+    if (mResidentStateInSinglePrecision)
+    {
+        mResidentStateVariablesSingle[blockIndex].assign(mStateVariables.begin(), mStateVariables.end());
+    }
+    else
+    {
+        mStateVariables.swap(mResidentStateVariables[blockIndex]);
+    }
+    mResidentCellsAreStale[blockIndex] = true;
+}
+
+void AbstractCardiacCellBatch::WriteBackResidentState()
+{
+    for (unsigned block=0; block<mResidentCells.size(); block++)
+    {
+        if (mResidentCellsAreStale[block])
+        {
+            // Don't overwrite changes made to cells written back on their own
+            RereadResidentCells(block);
+            ScatterResidentState(block);
+            mResidentCellsAreStale[block] = false;
+        }
+    }
+}
+
+void AbstractCardiacCellBatch::WriteBackResidentCell(AbstractCardiacCellInterface* pCell)
+{
+    std::map<const AbstractCardiacCellInterface*, std::pair<unsigned, unsigned> >::const_iterator it
+        = mResidentCellPositions.find(pCell);
+    if (it == mResidentCellPositions.end())
+    {
+        return;
+    }
+    const unsigned block = it->second.first;
+    const unsigned position = it->second.second;
+    if (mResidentBlockNeedsRereading[block] || mResidentCellsToReread[block].count(position) > 0u)
+    {
+        // The cell already holds its newest state, and may have been changed since
+        return;
+    }
+    if (mResidentCellsAreStale[block])
+    {
+        ScatterResidentCell(block, position);
+    }
+    mResidentCellsToReread[block].insert(position);
+}
+
+void AbstractCardiacCellBatch::WriteBackAndRereadResidentState()
+{
+    WriteBackResidentState();
+    for (unsigned block=0; block<mResidentCells.size(); block++)
+    {
+        mResidentBlockNeedsRereading[block] = true;
+        mResidentCellsToReread[block].clear();
+    }
+}
+
+void AbstractCardiacCellBatch::ClearResidentState()
+{
+    WriteBackResidentState();
+    mResidentCells.clear();
+    mResidentStateVariables.clear();
+    mResidentStateVariablesSingle.clear();
+    mResidentCellsAreStale.clear();
+    mResidentCellPositions.clear();
+    mResidentCellsToReread.clear();
+    mResidentBlockNeedsRereading.clear();
+}
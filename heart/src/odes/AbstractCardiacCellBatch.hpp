@@ -0,0 +1,418 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef ABSTRACTCARDIACCELLBATCH_HPP_
+#define ABSTRACTCARDIACCELLBATCH_HPP_
+
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+#include "AbstractCardiacCellInterface.hpp"
+
+/**
+ * Base class for batched ("structure of arrays") solvers of cardiac cell
+ * models.
+ *
+ * A batch takes a number of cells which all use the same model, gathers
+ * their state variables into contiguous arrays (one array per state
+ * variable, each of length the number of cells in the batch), integrates
+ * them all together, and scatters the results back into the cells. The
+ * right-hand side is therefore evaluated by a single call for the whole
+ * batch, with inner loops over cells that the compiler can vectorise,
+ * rather than by one virtual EvaluateYDerivatives() call per cell.
+ *
+ * The cells remain the owners of their state, so everything else (caches,
+ * output, checkpointing) works as usual. Subclasses implement the model
+ * right-hand side in EvaluateYDerivativesBatch(), and may override
+ * AdvanceBatch() to use a different update rule (e.g. Rush-Larsen for
+ * gating variables); by default forward Euler is used. A batch only
+ * accepts cells which use its model and would be solved the same way on
+ * their own (see IsCompatible()); other cells should be solved one by one.
+ * Batches for CellML models are generated by PyCml (see the --batch
+ * option of ConvertCellModel.py).
+ *
+ * Alternatively the batch can keep the state of each block of cells
+ * resident between solves (see SetKeepStateResident() and
+ * SolveResidentBatch()), so that only the voltage goes in and the ionic
+ * current comes out on each PDE time step. The cells are then out of date
+ * until WriteBackResidentState() or ClearResidentState() is called, or
+ * for a single cell WriteBackResidentCell().
+ * Resident state may be held in single precision (see
+ * SetResidentStateInSinglePrecision()) to halve its size and the memory
+ * traffic of each solve; the integration itself is always done in double
+ * precision.
+ */
+class AbstractCardiacCellBatch
+{
+private:
+    /** Maximum number of cells solved in one batch. */
+    unsigned mMaxBatchSize;
+
+    /** Whether state is kept between solves (see SetKeepStateResident()). */
+    bool mKeepStateResident;
+
+    /** For each resident block, the cells it holds, in order. */
+    std::vector<std::vector<AbstractCardiacCellInterface*> > mResidentCells;
+
+    /** For each resident block, its state variables, laid out as #mStateVariables. */
+    std::vector<std::vector<double> > mResidentStateVariables;
+
+    /** For each resident block, whether its cells hold out-of-date state. */
+    std::vector<bool> mResidentCellsAreStale;
+
+    /** For each resident cell, its block and position within the block. */
+    std::map<const AbstractCardiacCellInterface*, std::pair<unsigned, unsigned> > mResidentCellPositions;
+
+    /**
+     * For each resident block, the positions of cells which may have been
+     * changed since their state was written back, and so must be re-read
+     * before the block is next used.
+     */
+    std::vector<std::set<unsigned> > mResidentCellsToReread;
+
+    /** For each resident block, whether all of its cells must be re-read before it is next used. */
+    std::vector<bool> mResidentBlockNeedsRereading;
+
+    /** Whether resident state is stored as float (see SetResidentStateInSinglePrecision()). */
+    bool mResidentStateInSinglePrecision;
+
+    /** For each resident block, its state variables in single precision, if used. */
+    std::vector<std::vector<float> > mResidentStateVariablesSingle;
+
+    /**
+     * Copy the state of a resident block back into its cells.
+     *
+     * @param blockIndex  the block
+     */
+    void ScatterResidentState(unsigned blockIndex);
+
+    /**
+     * Copy the resident state of one cell back into it.
+     *
+     * @param blockIndex  the block holding the cell
+     * @param position  the cell's position within the block
+     */
+    void ScatterResidentCell(unsigned blockIndex, unsigned position);
+
+    /**
+     * Copy the state of one cell into its block's resident state.
+     *
+     * @param blockIndex  the block holding the cell
+     * @param position  the cell's position within the block
+     */
+    void GatherResidentCell(unsigned blockIndex, unsigned position);
+
+    /**
+     * Re-read the state of those cells in a resident block which may have
+     * been changed since it was written back to them.
+     *
+     * @param blockIndex  the block
+     */
+    void RereadResidentCells(unsigned blockIndex);
+
+    /**
+     * Copy the state of the given cells into #mStateVariables.
+     *
+     * @param rCells  the cells
+     */
+    void GatherState(const std::vector<AbstractCardiacCellInterface*>& rCells);
+
+    /**
+     * Copy state variables back into the given cells.
+     *
+     * @param rCells  the cells
+     * @param rY  their state variables, laid out as #mStateVariables
+     */
+    void ScatterState(const std::vector<AbstractCardiacCellInterface*>& rCells,
+                      const std::vector<double>& rY);
+
+    /**
+     * Integrate #mStateVariables, which hold the state of the given cells,
+     * from tStart to tEnd.
+     *
+     * @param rCells  the cells, used for their stimuli
+     * @param tStart  the start time
+     * @param tEnd  the end time
+     * @param updateVoltage  whether to solve for the voltage as well
+     */
+    void Integrate(const std::vector<AbstractCardiacCellInterface*>& rCells,
+                   double tStart,
+                   double tEnd,
+                   bool updateVoltage);
+
+protected:
+    /** Number of state variables in the model. */
+    unsigned mNumberOfStateVariables;
+
+    /** Index of the transmembrane potential within the state variables. */
+    unsigned mVoltageIndex;
+
+    /** The ODE time step to use. */
+    double mDt;
+
+    /** Number of cells in the batch currently being solved. */
+    unsigned mNumCells;
+
+    /**
+     * State variables of the current batch; variable k of cell i is stored in
+     * entry k*mNumCells + i.
+     */
+    std::vector<double> mStateVariables;
+
+    /** Derivatives of the state variables, laid out as #mStateVariables. */
+    std::vector<double> mDerivatives;
+
+    /** Intracellular area stimulus for each cell at the current time. */
+    std::vector<double> mStimulus;
+
+    /** Whether the voltage derivative should be set to zero (voltage clamped). */
+    bool mSetVoltageDerivativeToZero;
+
+    /** Number of parameters of the model (see AbstractParameterisedSystem). */
+    unsigned mNumberOfParameters;
+
+    /**
+     * Parameters of the cells in the current batch, as returned by their
+     * GetParameter() methods; parameter k of cell i is stored in entry
+     * k*mNumCells + i.
+     */
+    std::vector<double> mParameters;
+
+    /**
+     * @return whether the given cell uses exactly the model this batch
+     * implements.
+     *
+     * @param pCell  the cell
+     */
+    virtual bool IsModelCompatible(AbstractCardiacCellInterface* pCell) const=0;
+
+    /**
+     * @return whether solving the given cell on its own would use the same
+     * method and time step as AdvanceBatch(). The default implementation
+     * requires an EulerIvpOdeSolver and the batch's time step.
+     *
+     * @param pCell  the cell
+     */
+    virtual bool IsSolverCompatible(AbstractCardiacCellInterface* pCell) const;
+
+    /**
+     * @return whether the given cell uses the same ODE time step as this batch.
+     *
+     * @param pCell  the cell
+     */
+    bool HasSameTimestep(AbstractCardiacCellInterface* pCell) const;
+
+    /**
+     * Compute the right-hand side of the model for every cell in the batch.
+     *
+     * @param time  the current time
+     * @param rY  the state variables, laid out as #mStateVariables
+     * @param rStimulus  the intracellular area stimulus for each cell
+     * @param rDY  to be filled in with the derivatives, laid out as #mStateVariables
+     */
+    virtual void EvaluateYDerivativesBatch(double time,
+                                           const std::vector<double>& rY,
+                                           const std::vector<double>& rStimulus,
+                                           std::vector<double>& rDY)=0;
+
+    /**
+     * Advance every cell in the batch by a single time step.
+     * The default implementation uses forward Euler.
+     *
+     * @param time  the current time
+     * @param dt  the time step to take
+     */
+    virtual void AdvanceBatch(double time, double dt);
+
+    /**
+     * Compute the ionic current of every cell in the batch. The default
+     * implementation calls each cell's GetIIonic() on its column of rY;
+     * subclasses may override this with a batched version.
+     *
+     * @param rCells  the cells in the batch
+     * @param rY  the state variables, laid out as #mStateVariables
+     * @param rIIonic  to be filled in with the ionic current of each cell
+     */
+    virtual void ComputeIIonicBatch(const std::vector<AbstractCardiacCellInterface*>& rCells,
+                                    const std::vector<double>& rY,
+                                    std::vector<double>& rIIonic);
+
+public:
+    /**
+     * Constructor.
+     *
+     * @param numberOfStateVariables  the number of state variables in the model
+     * @param voltageIndex  the index of the voltage within the state variables
+     * @param maxBatchSize  the maximum number of cells to solve together (defaults to 256)
+     * @param numberOfParameters  the number of parameters the model has, to
+     *     be gathered into #mParameters (defaults to 0)
+     */
+    AbstractCardiacCellBatch(unsigned numberOfStateVariables,
+                             unsigned voltageIndex,
+                             unsigned maxBatchSize=256u,
+                             unsigned numberOfParameters=0u);
+
+    /**
+     * Virtual destructor.
+     */
+    virtual ~AbstractCardiacCellBatch();
+
+    /**
+     * @return whether the given cell can be solved by this batch, i.e. uses
+     * exactly the model this batch implements (see IsModelCompatible()), and
+     * the same solver and time step (see IsSolverCompatible()), so that the
+     * batch gives the same answer as solving the cell on its own.
+     *
+     * @param pCell  the cell
+     */
+    bool IsCompatible(AbstractCardiacCellInterface* pCell) const;
+
+    /**
+     * Set the ODE time step. This is initialised from HeartConfig. Only
+     * cells with the same time step are compatible with the batch.
+     *
+     * @param dt  the time step
+     */
+    void SetTimestep(double dt);
+
+    /** @return the maximum number of cells to solve in one batch. */
+    unsigned GetMaxBatchSize() const;
+
+    /**
+     * Integrate the given cells from tStart to tEnd, updating their state.
+     * All cells must be compatible with this batch, and there must be no
+     * more than GetMaxBatchSize() of them.
+     *
+     * @param rCells  the cells to solve
+     * @param tStart  the start time
+     * @param tEnd  the end time
+     * @param updateVoltage  whether to solve for the voltage as well, as in
+     *     SolveAndUpdateState(); if false the voltage is held fixed as in
+     *     ComputeExceptVoltage()
+     */
+    void SolveBatch(const std::vector<AbstractCardiacCellInterface*>& rCells,
+                    double tStart,
+                    double tEnd,
+                    bool updateVoltage);
+
+    /**
+     * Set whether SolveResidentBatch() may keep the state of the cells it
+     * solves between calls. Turning this off writes any resident state
+     * back into the cells.
+     *
+     * @param keepResident  whether to keep state resident
+     */
+    void SetKeepStateResident(bool keepResident=true);
+
+    /** @return whether state is kept resident between solves. */
+    bool GetKeepStateResident() const;
+
+    /**
+     * Set whether resident state should be stored in single precision
+     * between solves. Any state which is currently resident is written back
+     * to the cells and forgotten first.
+     *
+     * @param singlePrecision  whether to store resident state as float
+     */
+    void SetResidentStateInSinglePrecision(bool singlePrecision=true);
+
+    /** @return whether resident state is stored in single precision. */
+    bool GetResidentStateInSinglePrecision() const;
+
+    /**
+     * Integrate the given cells from tStart to tEnd, as SolveBatch(), but
+     * if state is kept resident (see SetKeepStateResident()) use and keep
+     * the state held for block blockIndex rather than the state in the
+     * cells. The state is read from the cells only when the block is new
+     * or holds different cells from last time, or for cells which have
+     * been written back since (see WriteBackResidentCell()). Otherwise
+     * this is the same as SolveBatch() followed by reading the voltages
+     * and ionic currents.
+     *
+     * @param blockIndex  which block of cells this is; callers should use
+     *     the same index for the same cells on every call
+     * @param rCells  the cells to solve
+     * @param rVoltages  the voltage of each cell; updated if updateVoltage is set
+     * @param rIIonic  filled in with the ionic current of each cell at tEnd
+     * @param tStart  the start time
+     * @param tEnd  the end time
+     * @param updateVoltage  whether to solve for the voltage as well
+     */
+    void SolveResidentBatch(unsigned blockIndex,
+                            const std::vector<AbstractCardiacCellInterface*>& rCells,
+                            std::vector<double>& rVoltages,
+                            std::vector<double>& rIIonic,
+                            double tStart,
+                            double tEnd,
+                            bool updateVoltage);
+
+    /**
+     * Copy any resident state which is newer than that in the cells back
+     * into the cells. The state stays resident, so changes made to the
+     * cells afterwards are not seen by the batch.
+     */
+    void WriteBackResidentState();
+
+    /**
+     * Bring a single cell up to date with its resident state, if it has
+     * any, and re-read its state from the cell before its block is next
+     * solved, so that the caller may change it. The rest of the block
+     * stays resident.
+     *
+     * @param pCell  the cell
+     */
+    void WriteBackResidentCell(AbstractCardiacCellInterface* pCell);
+
+    /**
+     * Copy any resident state back into the cells, as
+     * WriteBackResidentState(), and re-read the state of every block from
+     * its cells before the block is next solved, so that the cells may be
+     * changed in the meantime. Unlike ClearResidentState() the blocks and
+     * their storage are kept.
+     */
+    void WriteBackAndRereadResidentState();
+
+    /**
+     * Copy any resident state back into the cells, and then forget it, so
+     * that the next solve reads the state from the cells. Call this before
+     * changing the state of the cells by other means.
+     */
+    void ClearResidentState();
+};
+
+#endif // ABSTRACTCARDIACCELLBATCH_HPP_
@@ -34,6 +34,9 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "HeartConfig.hpp"  // First for Boost 1.33/PETSc 2.2
+
+#include <cfloat>
+
 #include "AbstractCardiacCellInterface.hpp"
 #include "Exception.hpp"
 
@@ -60,7 +63,10 @@ AbstractCardiacCellInterface::AbstractCardiacCellInterface(
     mSetVoltageDerivativeToZero(false),
     mIsUsedInTissue(false),
     mHasDefaultStimulusFromCellML(false),
-    mFixedVoltage(DOUBLE_UNSET)
+    mFixedVoltage(DOUBLE_UNSET),
+    mKnownStimulusStartTime(DBL_MAX),
+    mKnownStimulusEndTime(-DBL_MAX),
+    mKnownIntracellularStimulus(0.0)
 {
   // Record a reference for the calculations performed using this
   // class, can be extracted with the '-citations' flag as an argument
@@ -96,15 +102,34 @@ void AbstractCardiacCellInterface::SetIntracellularStimulusFunction(
     boost::shared_ptr<AbstractStimulusFunction> pStimulus)
 {
   mpIntracellularStimulus = pStimulus;
+  mKnownStimulusStartTime = DBL_MAX;
+  mKnownStimulusEndTime = -DBL_MAX;
 }
 
 
 double AbstractCardiacCellInterface::GetIntracellularStimulus(double time)
 {
+  if (mKnownStimulusStartTime <= time && time <= mKnownStimulusEndTime) {
+    return mKnownIntracellularStimulus;
+  }
   return mpIntracellularStimulus->GetStimulus(time);
 }
 
 
+bool AbstractCardiacCellInterface::SetIntracellularStimulusOver(
+    const AbstractStimulusFunction* pStimulus, double startTime,
+    double endTime, double value)
+{
+  if (pStimulus != mpIntracellularStimulus.get()) {
+    return false;
+  }
+  mKnownStimulusStartTime = startTime;
+  mKnownStimulusEndTime = endTime;
+  mKnownIntracellularStimulus = value;
+  return true;
+}
+
+
 double AbstractCardiacCellInterface::GetIntracellularAreaStimulus(
     double time)
 {
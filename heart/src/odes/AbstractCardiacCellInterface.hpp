@@ -84,6 +84,11 @@ public:
      */
     virtual void SetTimestep(double dt)=0;
 
+    /**
+     * @return the timestep (or maximum timestep when using CVODE) used for simulating this cell.
+     */
+    virtual double GetTimestep()=0;
+
     /**
      * All subclasses must implement this method to get the number of state variables.
      *
@@ -305,6 +310,25 @@ public:
      */
     double GetIntracellularStimulus(double time);
 
+    /**
+     * Tell the cell the value its intracellular stimulus function takes
+     * throughout [startTime, endTime], so that GetIntracellularStimulus()
+     * can return it for times in that interval without calling the
+     * stimulus function. Tissue simulations use this to evaluate each
+     * distinct stimulus once per time step rather than on every ODE
+     * right-hand side evaluation. The value is ignored for times outside
+     * the interval, and forgotten if the stimulus function is replaced.
+     *
+     * @param pStimulus  the stimulus function the value was computed from
+     * @param startTime  start of the interval
+     * @param endTime  end of the interval
+     * @param value  the stimulus throughout the interval
+     * @return false, leaving the cell unchanged, if pStimulus is no longer
+     *     this cell's stimulus function
+     */
+    bool SetIntracellularStimulusOver(const AbstractStimulusFunction* pStimulus,
+                                      double startTime, double endTime, double value);
+
     /**
      * @return the value of the intracellular stimulus.
      * This will always be in units of uA/cm^2.
@@ -445,6 +469,19 @@ protected:
     /** The value of the fixed voltage if #mSetVoltageDerivativeToZero is set. */
     double mFixedVoltage;
 
+    /**
+     * Start of the interval over which the intracellular stimulus is known
+     * to be #mKnownIntracellularStimulus (see SetIntracellularStimulusOver()).
+     * Not archived.
+     */
+    double mKnownStimulusStartTime;
+
+    /** End of the interval over which the intracellular stimulus is known. */
+    double mKnownStimulusEndTime;
+
+    /** The intracellular stimulus over the known interval. */
+    double mKnownIntracellularStimulus;
+
 private:
     /** Needed for serialization. */
     friend class boost::serialization::access;
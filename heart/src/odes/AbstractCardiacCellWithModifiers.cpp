@@ -49,7 +49,8 @@ AbstractCardiacCellWithModifiers<CARDIAC_CELL>::AbstractCardiacCellWithModifiers
                                  unsigned numberOfStateVariables,
                                  unsigned voltageIndex,
                                  boost::shared_ptr<AbstractStimulusFunction> pIntracellularStimulus)
-    : CARDIAC_CELL(pOdeSolver, numberOfStateVariables, voltageIndex, pIntracellularStimulus)
+    : CARDIAC_CELL(pOdeSolver, numberOfStateVariables, voltageIndex, pIntracellularStimulus),
+      mModifiersActive(false)
 {
     mModifiersMap.clear();
 }
@@ -78,6 +79,29 @@ void AbstractCardiacCellWithModifiers<CARDIAC_CELL>::SetModifier(const std::stri
         EXCEPTION("There is no modifier called " + rModifierName + " in this model.");
     }
     *(mModifiersMap[rModifierName]) = pNewModifier;
+    UpdateModifiersActive();
+}
+
+template <class CARDIAC_CELL>
+bool AbstractCardiacCellWithModifiers<CARDIAC_CELL>::AreModifiersActive() const
+{
+    return mModifiersActive;
+}
+
+template <class CARDIAC_CELL>
+void AbstractCardiacCellWithModifiers<CARDIAC_CELL>::UpdateModifiersActive()
+{
+    mModifiersActive = false;
+    std::map<std::string, boost::shared_ptr<AbstractModifier>* >::const_iterator iter;
+    for (iter = mModifiersMap.begin(); iter != mModifiersMap.end(); ++iter)
+    {
+        const boost::shared_ptr<AbstractModifier>& r_modifier = *((*iter).second);
+        if (!r_modifier || r_modifier->GetInlineKind() != AbstractModifier::IDENTITY)
+        {
+            mModifiersActive = true;
+            break;
+        }
+    }
 }
 
 // Explicit Instantiation
@@ -125,13 +125,23 @@ private:
             // Set the constructed smart pointer to be the same as the loaded one.
             *(p_to_constructed_smart_pointer) = p_loaded;
         }
+        UpdateModifiersActive();
     }
     BOOST_SERIALIZATION_SPLIT_MEMBER()
 
     /** A map between a string description and the location of the relevant modifier in concrete classes. */
     std::map<std::string, boost::shared_ptr<AbstractModifier>* > mModifiersMap;
 
+    /** Set #mModifiersActive from the modifiers now in place. */
+    void UpdateModifiersActive();
+
 protected:
+    /**
+     * Whether any modifier does something, i.e. is not a DummyModifier.  Generated cells
+     * check this and use the unmodified quantities when it is false.
+     */
+    bool mModifiersActive;
+
     /**
      * Add a new modifier - should only be called by the subclass constructors.
      * Each modifier pointer is set to a #DummyModifier by this method.
@@ -181,6 +191,11 @@ public:
      * @param pNewModifier  The new modifier object to use.
      */
     void SetModifier(const std::string& rModifierName, boost::shared_ptr<AbstractModifier>& pNewModifier);
+
+    /**
+     * @return whether any modifier does something, i.e. is not a DummyModifier
+     */
+    bool AreModifiersActive() const;
 };
 
 // Special case of archiving an abstract class that's templated over Chaste classes.
@@ -52,6 +52,7 @@ AbstractCvodeCellWithDataClamp::AbstractCvodeCellWithDataClamp(boost::shared_ptr
                                                                boost::shared_ptr<AbstractStimulusFunction> pIntracellularStimulus)
     : AbstractCvodeCell(pSolver, numberOfStateVariables, voltageIndex, pIntracellularStimulus),
       mDataAvailable(false),
+      mAnalyticJacobianSuspended(false),
       mDataClampIsOn(false)
 {
 }
@@ -114,6 +115,11 @@ void AbstractCvodeCellWithDataClamp::TurnOffDataClamp()
 {
     this->SetParameter("membrane_data_clamp_current_conductance",0);
     mDataClampIsOn = false;
+    if (mAnalyticJacobianSuspended)
+    {
+        ForceUseOfNumericalJacobian(false);
+        mAnalyticJacobianSuspended = false;
+    }
 }
 
 void AbstractCvodeCellWithDataClamp::TurnOnDataClamp(double conductance)
@@ -125,6 +131,12 @@ void AbstractCvodeCellWithDataClamp::TurnOnDataClamp(double conductance)
     assert(mExperimentalTimes.size() > 1u);
     this->SetParameter("membrane_data_clamp_current_conductance", conductance);
     mDataClampIsOn = true;
+    if (GetUseAnalyticJacobian())
+    {
+        // The analytic Jacobian doesn't include the data clamp current
+        ForceUseOfNumericalJacobian(true);
+        mAnalyticJacobianSuspended = true;
+    }
 }
 
 #endif // CHASTE_CVODEWITHDATACLAMP
@@ -74,6 +74,10 @@ private:
         archive & mExperimentalVoltages;
         archive & mDataClampIsOn;
         archive & mDataAvailable;
+        if (version > 0)
+        {
+            archive & mAnalyticJacobianSuspended;
+        }
     }
 
     /** The experimental times of voltage measurements in the data */
@@ -85,6 +89,13 @@ private:
     /** Whether experimental data have been set */
     bool mDataAvailable;
 
+    /**
+     * Whether the analytic Jacobian has been switched off because the data clamp is on.
+     * The analytic Jacobian does not include the data clamp current, so a numerical
+     * Jacobian is used while the clamp is on, and the analytic one restored when it is turned off.
+     */
+    bool mAnalyticJacobianSuspended;
+
 protected:
 
     /** Whether the data clamp is active at the moment */
@@ -130,12 +141,14 @@ public:
 
 
     /**
-     * Switch off the data clamping current
+     * Switch off the data clamping current.
+     * If the analytic Jacobian was in use before the clamp was turned on, it is used again.
      */
     void TurnOffDataClamp();
 
     /**
-     * Switch on the data clamping current
+     * Switch on the data clamping current.
+     * A numerical Jacobian is used while the clamp is on, since any analytic Jacobian doesn't include the clamp current.
      *
      * @param conductance  The conductance of the data clamping current - don't yet know best number to set this to.
      */
@@ -143,6 +156,7 @@ public:
 };
 
 CLASS_IS_ABSTRACT(AbstractCvodeCellWithDataClamp)
+BOOST_CLASS_VERSION(AbstractCvodeCellWithDataClamp, 1)
 
 #endif // _ABSTRACTCVODECELLWITHDATACLAMP_HPP_
 #endif // CHASTE_CVODE
@@ -35,8 +35,11 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "AbstractLookupTableCollection.hpp"
 
+#include <cassert>
 #include <cmath>
 
+bool AbstractLookupTableCollection::msUseNodeSharedMemory = false;
+
 AbstractLookupTableCollection::AbstractLookupTableCollection()
     : mDt(0.0)
 {
@@ -109,6 +112,128 @@ unsigned AbstractLookupTableCollection::GetTableIndex(const std::string& rKeying
 
 AbstractLookupTableCollection::~AbstractLookupTableCollection()
 {
+    for (unsigned i=0; i<mTableMemory.size(); i++)
+    {
+        FreeTableMemory(i);
+    }
+}
+
+void AbstractLookupTableCollection::SetUseNodeSharedMemory(bool useSharedMemory)
+{
+    msUseNodeSharedMemory = useSharedMemory;
+}
+
+bool AbstractLookupTableCollection::GetUseNodeSharedMemory()
+{
+    return msUseNodeSharedMemory;
+}
+
+bool AbstractLookupTableCollection::IsTableMemoryShared(const std::string& rKeyingVariableName) const
+{
+    unsigned i = GetTableIndex(rKeyingVariableName);
+    return (i < mTableMemoryIsShared.size() && mTableMemoryIsShared[i]);
+}
+
+MPI_Comm AbstractLookupTableCollection::GetNodeCommunicator()
+{
+    static MPI_Comm node_comm = MPI_COMM_NULL;
+#if MPI_VERSION >= 3
+    if (node_comm == MPI_COMM_NULL)
+    {
+        MPI_Comm_split_type(PetscTools::GetWorld(), MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &node_comm);
+    }
+#endif
+    return node_comm;
+}
+
+double* AbstractLookupTableCollection::AllocateTableMemory(unsigned keyIndex, unsigned numEntries)
+{
+    if (mTableMemory.size() <= keyIndex)
+    {
+        mTableMemory.resize(keyIndex+1, NULL);
+        mTableMemoryIsShared.resize(keyIndex+1, false);
+#if MPI_VERSION >= 3
+        mTableWindows.resize(keyIndex+1, MPI_WIN_NULL);
+#endif
+    }
+    FreeTableMemory(keyIndex);
+
+#if MPI_VERSION >= 3
+    if (msUseNodeSharedMemory && PetscTools::IsParallel())
+    {
+        MPI_Comm node_comm = GetNodeCommunicator();
+        int node_rank;
+        MPI_Comm_rank(node_comm, &node_rank);
+
+        // Only the lowest rank on the node contributes memory to the window
+        MPI_Aint local_size = (node_rank == 0) ? numEntries*sizeof(double) : 0;
+        double* p_memory;
+        MPI_Win_allocate_shared(local_size, sizeof(double), MPI_INFO_NULL, node_comm,
+                                &p_memory, &mTableWindows[keyIndex]);
+        if (node_rank != 0)
+        {
+            MPI_Aint size;
+            int disp_unit;
+            MPI_Win_shared_query(mTableWindows[keyIndex], 0, &size, &disp_unit, &p_memory);
+        }
+        mTableMemory[keyIndex] = p_memory;
+        mTableMemoryIsShared[keyIndex] = true;
+        return p_memory;
+    }
+#endif // MPI_VERSION >= 3
+
+    mTableMemory[keyIndex] = new double[numEntries];
+    return mTableMemory[keyIndex];
+}
+
+void AbstractLookupTableCollection::FreeTableMemory(unsigned keyIndex)
+{
+    if (keyIndex >= mTableMemory.size() || mTableMemory[keyIndex] == NULL)
+    {
+        return;
+    }
+    if (mTableMemoryIsShared[keyIndex])
+    {
+#if MPI_VERSION >= 3
+        // The tables are singletons, so may be destroyed after MPI has been finalised; the
+        // memory is then released when the process exits.
+        int finalized;
+        MPI_Finalized(&finalized);
+        if (!finalized)
+        {
+            MPI_Win_free(&mTableWindows[keyIndex]);
+        }
+#endif // MPI_VERSION >= 3
+        mTableMemoryIsShared[keyIndex] = false;
+    }
+    else
+    {
+        delete[] mTableMemory[keyIndex];
+    }
+    mTableMemory[keyIndex] = NULL;
+}
+
+bool AbstractLookupTableCollection::IsTableGenerator(unsigned keyIndex) const
+{
+    if (keyIndex < mTableMemoryIsShared.size() && mTableMemoryIsShared[keyIndex])
+    {
+        int node_rank;
+        MPI_Comm_rank(GetNodeCommunicator(), &node_rank);
+        return (node_rank == 0);
+    }
+    return true;
+}
+
+void AbstractLookupTableCollection::TableGenerationFinished(unsigned keyIndex)
+{
+#if MPI_VERSION >= 3
+    if (keyIndex < mTableMemoryIsShared.size() && mTableMemoryIsShared[keyIndex])
+    {
+        // Make the generating process's writes visible to the rest of the node
+        MPI_Win_fence(0, mTableWindows[keyIndex]);
+        MPI_Barrier(GetNodeCommunicator());
+    }
+#endif // MPI_VERSION >= 3
 }
 
 const char* AbstractLookupTableCollection::EventHandler::EventName[] =  {"GenTables"};
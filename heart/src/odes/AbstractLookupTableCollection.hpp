@@ -40,11 +40,24 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <vector>
 
 #include "GenericEventHandler.hpp"
+#include "PetscTools.hpp"
 
 /**
  * Base class for lookup tables used in optimised cells generated by PyCml.
  * Contains methods to query and adjust table parameters (i.e. size and spacing),
  * and an event handler to time table generation.
+ *
+ * Each generated subclass is a singleton, so there is exactly one set of tables for a
+ * given cell model on each process, built when the first cell of that model is created
+ * and shared by all cells of the model. Changing the table properties (or the timestep,
+ * if it is included in the tables) and calling RegenerateTables() rebuilds the tables
+ * for every cell of the model at once; cells cannot use different table spacings.
+ *
+ * Table memory is obtained through AllocateTableMemory(). If SetUseNodeSharedMemory()
+ * has been called, this places the tables in an MPI-3 shared-memory window covering all
+ * the processes on the same host, which is filled in once by the lowest-ranked process
+ * there; table memory and generation time are then paid once per node rather than
+ * once per process.
  */
 class AbstractLookupTableCollection
 {
@@ -114,6 +127,33 @@ public:
     /** Virtual destructor since we have a virtual method. */
     virtual ~AbstractLookupTableCollection();
 
+    /**
+     * Set whether lookup tables generated from now on should be placed in memory shared
+     * between all the processes on a node (host). This has no effect in sequential runs,
+     * or if the MPI library does not support MPI-3 shared windows.
+     *
+     * @note Allocating and freeing shared tables is collective over the processes on a
+     * node. It should therefore only be used when every process creates cells of each
+     * model using lookup tables (e.g. homogeneous tissue), and all processes must make the
+     * same calls to RegenerateTables(), SetTableProperties() and FreeMemory().
+     *
+     * @param useSharedMemory  whether to share table memory within a node
+     */
+    static void SetUseNodeSharedMemory(bool useSharedMemory=true);
+
+    /**
+     * @return whether lookup table memory is shared between processes on a node.
+     */
+    static bool GetUseNodeSharedMemory();
+
+    /**
+     * @return whether the tables for the given keying variable are currently held in
+     * node-shared memory.
+     *
+     * @param rKeyingVariableName  the table key name
+     */
+    bool IsTableMemoryShared(const std::string& rKeyingVariableName) const;
+
     /**
      * A little event handler with one event, to time table generation.
      */
@@ -138,6 +178,39 @@ protected:
      */
     unsigned GetTableIndex(const std::string& rKeyingVariableName) const;
 
+    /**
+     * Allocate memory for the tables keyed by a given variable, freeing any memory
+     * previously allocated for them. Used by generated code.
+     *
+     * @param keyIndex  the index of the keying variable
+     * @param numEntries  the number of doubles needed (table size times number of tables)
+     * @return the start of the memory
+     */
+    double* AllocateTableMemory(unsigned keyIndex, unsigned numEntries);
+
+    /**
+     * Free the memory allocated for the tables keyed by a given variable, if any.
+     *
+     * @param keyIndex  the index of the keying variable
+     */
+    void FreeTableMemory(unsigned keyIndex);
+
+    /**
+     * @return whether this process should fill in the tables keyed by a given variable,
+     * i.e. false only if they are shared and filled in by another process on the node.
+     *
+     * @param keyIndex  the index of the keying variable
+     */
+    bool IsTableGenerator(unsigned keyIndex) const;
+
+    /**
+     * Called by generated code once the tables keyed by a given variable have been filled
+     * in. If they are shared, waits until they are visible to all processes on the node.
+     *
+     * @param keyIndex  the index of the keying variable
+     */
+    void TableGenerationFinished(unsigned keyIndex);
+
     /** Names of variables used to index lookup tables */
     std::vector<std::string> mKeyingVariableNames;
 
@@ -161,6 +234,26 @@ protected:
 
     /** Timestep to use in lookup tables */
     double mDt;
+
+private:
+    /** Whether new tables are allocated in node-shared memory. */
+    static bool msUseNodeSharedMemory;
+
+    /**
+     * @return a communicator containing the processes on this node, created on first use.
+     */
+    static MPI_Comm GetNodeCommunicator();
+
+    /** The memory allocated for the tables keyed by each variable (NULL if none). */
+    std::vector<double*> mTableMemory;
+
+    /** Whether the memory for the tables keyed by each variable is node-shared. */
+    std::vector<bool> mTableMemoryIsShared;
+
+#if MPI_VERSION >= 3
+    /** The shared-memory windows for the tables keyed by each variable, if shared. */
+    std::vector<MPI_Win> mTableWindows;
+#endif
 };
 
 #endif // ABSTRACTLOOKUPTABLECOLLECTION_HPP_
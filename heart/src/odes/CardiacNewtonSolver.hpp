@@ -35,7 +35,9 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef CARDIACNEWTONSOLVER_HPP_
 #define CARDIACNEWTONSOLVER_HPP_
 
+#include <algorithm>
 #include <cmath>
+#include <vector>
 #include "IsNan.hpp"
 #include "UblasCustomFunctions.hpp"
 #include "AbstractBackwardEulerCardiacCell.hpp"
@@ -45,13 +47,19 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  * Specialised Newton solver for solving the nonlinear systems arising when
  * simulating a cardiac cell using Backward Euler.
  *
- * The class is templated by the size of the nonlinear system, and uses the
- * singleton pattern to ensure only 1 solver for any given system size is created.
- * This allows us to be both computationally and memory efficient.
+ * The class is templated by the size of the nonlinear system, so the residual,
+ * Jacobian and update are fixed-size arrays on the stack and the loops of the
+ * linear solve have compile-time trip counts, which the compiler can unroll.
+ * As the solver keeps no working memory of its own, one instance (obtained
+ * through the singleton pattern, for the generated cell code) may be used by
+ * several threads at once.
  *
- * It would be nice to have a test of this class directly, but you need a cardiac
- * cell in order to test it.  So all tests occur when testing particular cardiac
- * cells, e.g. the LuoRudy1991BackwardEuler.
+ * SolveBatch() solves the systems of several cells in lock-step, with the
+ * state of the batch stored as a structure of arrays so that the linear
+ * solves vectorise across cells.
+ *
+ * Tests occur when testing particular cardiac cells, e.g. the LuoRudy1991BackwardEuler,
+ * and in TestCardiacNewtonSolver with a simple system in place of a cell.
  */
 template <unsigned SIZE, typename CELLTYPE>
 class CardiacNewtonSolver
@@ -79,59 +87,47 @@ public:
                double time,
                double rCurrentGuess[SIZE])
     {
+        double residual[SIZE];
+        double jacobian[SIZE][SIZE];
+        double update[SIZE];
+
         unsigned counter = 0;
         const double eps = 1e-6; // JonW tolerance
 
         // check that the initial guess that was given gives a valid residual
-        rCell.ComputeResidual(time, rCurrentGuess, mResidual.data());
-        double norm_of_residual = norm_inf(mResidual);
+        rCell.ComputeResidual(time, rCurrentGuess, residual);
+        double norm_of_residual = NormInf(residual);
         assert(!std::isnan(norm_of_residual));
         double norm_of_update = 0.0; //Properly initialised in the loop
         do
         {
             // Calculate Jacobian for current guess
-            rCell.ComputeJacobian(time, rCurrentGuess, mJacobian);
+            rCell.ComputeJacobian(time, rCurrentGuess, jacobian);
 
-            // Solve Newton linear system for mUpdate, given mJacobian and mResidual
-            SolveLinearSystem();
+            // Solve Newton linear system for update, given jacobian and residual
+            SolveLinearSystem(jacobian, residual, update);
 
             // Update norm (JonW style)
-            norm_of_update = norm_inf(mUpdate);
+            norm_of_update = NormInf(update);
 
             // Update current guess and recalculate residual
             for (unsigned i=0; i<SIZE; i++)
             {
-                rCurrentGuess[i] -= mUpdate[i];
+                rCurrentGuess[i] -= update[i];
             }
             double norm_of_previous_residual = norm_of_residual;
-            rCell.ComputeResidual(time, rCurrentGuess, mResidual.data());
-            norm_of_residual = norm_inf(mResidual);
+            rCell.ComputeResidual(time, rCurrentGuess, residual);
+            norm_of_residual = NormInf(residual);
             if (norm_of_residual > norm_of_previous_residual && norm_of_update > eps)
             {
                 //Second part of guard:
                 //Note that if norm_of_update < eps (converged) then it's
                 //likely that both the residual and the previous residual were
                 //close to the root.
-
-                //Work out where the biggest change in the guess has happened.
-                double relative_change_max = 0.0;
-                unsigned relative_change_direction = 0;
-                for (unsigned i=0; i<SIZE; i++)
+                if (BackTrack(rCurrentGuess, update))
                 {
-                    double relative_change = fabs(mUpdate[i]/rCurrentGuess[i]);
-                    if (relative_change > relative_change_max)
-                    {
-                        relative_change_max = relative_change;
-                        relative_change_direction = i;
-                    }
-                }
-
-                if (relative_change_max > 1.0)
-                {
-                    //Only walk 0.2 of the way in that direction (put back 0.8)
-                    rCurrentGuess[relative_change_direction] += 0.8*mUpdate[relative_change_direction];
-                    rCell.ComputeResidual(time, rCurrentGuess, mResidual.data());
-                    norm_of_residual = norm_inf(mResidual);
+                    rCell.ComputeResidual(time, rCurrentGuess, residual);
+                    norm_of_residual = NormInf(residual);
                     WARNING("Residual increasing and one direction changing radically - back tracking in that direction");
                 }
             }
@@ -157,6 +153,119 @@ public:
 // LCOV_EXCL_STOP
     }
 
+    /**
+     * Use Newton's method to solve several cells for the next timestep, in lock-step:
+     * every iteration computes the residuals and Jacobians of the cells which have not
+     * converged yet, then does the linear solves of the whole batch together. Each cell
+     * takes the same iterations as it would in Solve().
+     *
+     * @param rCells  the cells to solve
+     * @param time  the current time
+     * @param rCurrentGuesses  the current guesses at the solutions, as a structure of arrays:
+     *     entry i of cell c is rCurrentGuesses[i*rCells.size() + c].  Will be updated on exit.
+     */
+    void SolveBatch(const std::vector<CELLTYPE*>& rCells,
+                    double time,
+                    std::vector<double>& rCurrentGuesses)
+    {
+        const unsigned num_cells = rCells.size();
+        assert(rCurrentGuesses.size() == SIZE*num_cells);
+        const double eps = 1e-6; // JonW tolerance
+
+        // Batch working memory, laid out like the guesses (entry (i,j) of the Jacobian of cell c
+        // is at (i*SIZE + j)*num_cells + c)
+        std::vector<double> residuals(SIZE*num_cells);
+        std::vector<double> jacobians(SIZE*SIZE*num_cells);
+        std::vector<double> updates(SIZE*num_cells);
+        std::vector<double> norms_of_residual(num_cells);
+        std::vector<bool> converged(num_cells, false);
+
+        double guess[SIZE];
+        double residual[SIZE];
+        double jacobian[SIZE][SIZE];
+        double update[SIZE];
+
+        // check that the initial guesses give valid residuals
+        for (unsigned c=0; c<num_cells; c++)
+        {
+            GetCellEntries(rCurrentGuesses, num_cells, c, guess);
+            rCells[c]->ComputeResidual(time, guess, residual);
+            norms_of_residual[c] = NormInf(residual);
+            assert(!std::isnan(norms_of_residual[c]));
+            SetCellEntries(residual, num_cells, c, residuals);
+        }
+
+        unsigned num_unconverged = num_cells;
+        unsigned counter = 0;
+        while (num_unconverged > 0)
+        {
+            // Calculate the Jacobians for the current guesses
+            for (unsigned c=0; c<num_cells; c++)
+            {
+                if (!converged[c])
+                {
+                    GetCellEntries(rCurrentGuesses, num_cells, c, guess);
+                    rCells[c]->ComputeJacobian(time, guess, jacobian);
+                    for (unsigned i=0; i<SIZE; i++)
+                    {
+                        for (unsigned j=0; j<SIZE; j++)
+                        {
+                            jacobians[(i*SIZE + j)*num_cells + c] = jacobian[i][j];
+                        }
+                    }
+                }
+            }
+
+            // Solve all the Newton linear systems together (the results for converged cells are unused)
+            SolveLinearSystemBatch(num_cells, jacobians, residuals, updates);
+
+            // Update the guesses and recalculate the residuals
+            for (unsigned c=0; c<num_cells; c++)
+            {
+                if (converged[c])
+                {
+                    continue;
+                }
+                GetCellEntries(rCurrentGuesses, num_cells, c, guess);
+                GetCellEntries(updates, num_cells, c, update);
+                double norm_of_update = NormInf(update);
+                for (unsigned i=0; i<SIZE; i++)
+                {
+                    guess[i] -= update[i];
+                }
+                rCells[c]->ComputeResidual(time, guess, residual);
+                double norm_of_residual = NormInf(residual);
+                if (norm_of_residual > norms_of_residual[c] && norm_of_update > eps)
+                {
+                    if (BackTrack(guess, update))
+                    {
+                        rCells[c]->ComputeResidual(time, guess, residual);
+                        norm_of_residual = NormInf(residual);
+                        WARNING("Residual increasing and one direction changing radically - back tracking in that direction");
+                    }
+                }
+                norms_of_residual[c] = norm_of_residual;
+                SetCellEntries(guess, num_cells, c, rCurrentGuesses);
+                SetCellEntries(residual, num_cells, c, residuals);
+
+                if (norm_of_update <= eps)
+                {
+                    converged[c] = true;
+                    num_unconverged--;
+                }
+            }
+            counter++;
+
+            // avoid infinite loops
+            if (counter > 15 && num_unconverged > 0)
+            {
+// LCOV_EXCL_START
+                EXCEPTION("Newton method diverged in CardiacNewtonSolver::SolveBatch()");
+// LCOV_EXCL_STOP
+            }
+        }
+    }
+
 protected:
     /** Singleton pattern - protected default constructor. */
     CardiacNewtonSolver()
@@ -174,39 +283,160 @@ protected:
      * for update given values of the Jacobian matrix and residual
      *
      * The implementation does Gaussian elimination with no pivotting and no underflow checking
+     *
+     * @param rJacobian  the Jacobian (overwritten by its factorisation)
+     * @param rResidual  the residual (overwritten)
+     * @param rUpdate  to be filled in with the update
      */
-    void SolveLinearSystem()
+    static void SolveLinearSystem(double rJacobian[SIZE][SIZE], double rResidual[SIZE], double rUpdate[SIZE])
     {
         for (unsigned i=0; i<SIZE; i++)
         {
             for (unsigned ii=i+1; ii<SIZE; ii++)
             {
-                double fact = mJacobian[ii][i]/mJacobian[i][i];
+                double fact = rJacobian[ii][i]/rJacobian[i][i];
                 for (unsigned j=i; j<SIZE; j++)
                 {
-                    mJacobian[ii][j] -= fact*mJacobian[i][j];
+                    rJacobian[ii][j] -= fact*rJacobian[i][j];
                 }
-                mResidual[ii] -= fact*mResidual[i];
+                rResidual[ii] -= fact*rResidual[i];
             }
         }
         for (unsigned i=SIZE; i-- > 0; )
         {
-            mUpdate[i] = mResidual[i];
+            rUpdate[i] = rResidual[i];
             for (unsigned j=i+1; j<SIZE; j++)
             {
-                mUpdate[i] -= mJacobian[i][j]*mUpdate[j];
+                rUpdate[i] -= rJacobian[i][j]*rUpdate[j];
+            }
+            rUpdate[i] /= rJacobian[i][i];
+        }
+    }
+
+    /**
+     * As SolveLinearSystem(), for a batch of systems stored as a structure of
+     * arrays (see SolveBatch()), with the loop over cells innermost.
+     *
+     * @param numCells  the number of systems
+     * @param rJacobians  the Jacobians (overwritten by their factorisations)
+     * @param rResiduals  the residuals (overwritten)
+     * @param rUpdates  to be filled in with the updates
+     */
+    static void SolveLinearSystemBatch(unsigned numCells,
+                                       std::vector<double>& rJacobians,
+                                       std::vector<double>& rResiduals,
+                                       std::vector<double>& rUpdates)
+    {
+        double* p_jac = &rJacobians[0];
+        double* p_res = &rResiduals[0];
+        double* p_upd = &rUpdates[0];
+        for (unsigned i=0; i<SIZE; i++)
+        {
+            for (unsigned ii=i+1; ii<SIZE; ii++)
+            {
+                for (unsigned c=0; c<numCells; c++)
+                {
+                    double fact = p_jac[(ii*SIZE + i)*numCells + c]/p_jac[(i*SIZE + i)*numCells + c];
+                    for (unsigned j=i; j<SIZE; j++)
+                    {
+                        p_jac[(ii*SIZE + j)*numCells + c] -= fact*p_jac[(i*SIZE + j)*numCells + c];
+                    }
+                    p_res[ii*numCells + c] -= fact*p_res[i*numCells + c];
+                }
+            }
+        }
+        for (unsigned i=SIZE; i-- > 0; )
+        {
+            for (unsigned c=0; c<numCells; c++)
+            {
+                double value = p_res[i*numCells + c];
+                for (unsigned j=i+1; j<SIZE; j++)
+                {
+                    value -= p_jac[(i*SIZE + j)*numCells + c]*p_upd[j*numCells + c];
+                }
+                p_upd[i*numCells + c] = value/p_jac[(i*SIZE + i)*numCells + c];
             }
-            mUpdate[i] /= mJacobian[i][i];
         }
     }
 
 private:
-    /** Working memory : residual vector */
-    c_vector<double, SIZE> mResidual;
-    /** Working memory : Jacobian matrix */
-    double mJacobian[SIZE][SIZE];
-    /** Working memory : update vector */
-    c_vector<double, SIZE> mUpdate;
+    /**
+     * @return the infinity norm of a vector
+     * @param rVector  the vector
+     */
+    static double NormInf(const double rVector[SIZE])
+    {
+        double norm = 0.0;
+        for (unsigned i=0; i<SIZE; i++)
+        {
+            norm = std::max(norm, fabs(rVector[i]));
+        }
+        return norm;
+    }
+
+    /**
+     * If the guess has changed radically in some direction, only walk 0.2 of the
+     * way in the direction of the biggest change.
+     *
+     * @param rCurrentGuess  the guess after the update (changed if backtracking)
+     * @param rUpdate  the update that was subtracted from the guess
+     * @return whether the guess was changed
+     */
+    static bool BackTrack(double rCurrentGuess[SIZE], const double rUpdate[SIZE])
+    {
+        //Work out where the biggest change in the guess has happened.
+        double relative_change_max = 0.0;
+        unsigned relative_change_direction = 0;
+        for (unsigned i=0; i<SIZE; i++)
+        {
+            double relative_change = fabs(rUpdate[i]/rCurrentGuess[i]);
+            if (relative_change > relative_change_max)
+            {
+                relative_change_max = relative_change;
+                relative_change_direction = i;
+            }
+        }
+
+        if (relative_change_max > 1.0)
+        {
+            //Only walk 0.2 of the way in that direction (put back 0.8)
+            rCurrentGuess[relative_change_direction] += 0.8*rUpdate[relative_change_direction];
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * Copy one cell's entries out of a structure of arrays.
+     *
+     * @param rBatch  the structure of arrays
+     * @param numCells  the number of cells in it
+     * @param cell  the cell
+     * @param rValues  to be filled in with the cell's entries
+     */
+    static void GetCellEntries(const std::vector<double>& rBatch, unsigned numCells, unsigned cell, double rValues[SIZE])
+    {
+        for (unsigned i=0; i<SIZE; i++)
+        {
+            rValues[i] = rBatch[i*numCells + cell];
+        }
+    }
+
+    /**
+     * Copy one cell's entries into a structure of arrays.
+     *
+     * @param rValues  the cell's entries
+     * @param numCells  the number of cells in the structure of arrays
+     * @param cell  the cell
+     * @param rBatch  the structure of arrays
+     */
+    static void SetCellEntries(const double rValues[SIZE], unsigned numCells, unsigned cell, std::vector<double>& rBatch)
+    {
+        for (unsigned i=0; i<SIZE; i++)
+        {
+            rBatch[i*numCells + cell] = rValues[i];
+        }
+    }
 };
 
 #endif /*CARDIACNEWTONSOLVER_HPP_*/
@@ -35,15 +35,21 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "CellMLToSharedLibraryConverter.hpp"
 
+#include <algorithm>
 #include <sstream>
 #include <fstream>      // for std::ofstream
 #include <sys/stat.h> // For mkdir()
 #include <ctime>
 #include <cstring> // For strerror()
 #include <cerrno> // For errno
+#include <cstdlib> // For getenv()
+#include <iomanip>
+#include <iterator>
+#include <stdint.h>
 
 #include <boost/foreach.hpp>
 
+#include "BoostFilesystem.hpp"
 #include "ChasteSyscalls.hpp"
 #include "Exception.hpp"
 #include "Warnings.hpp"
@@ -51,6 +57,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "PetscTools.hpp"
 #include "DynamicModelLoaderRegistry.hpp"
 #include "GetCurrentWorkingDirectory.hpp"
+#include "Version.hpp"
 
 #define IGNORE_EXCEPTIONS(code) \
     try {                       \
@@ -66,6 +73,24 @@ const std::string CellMLToSharedLibraryConverter::msSoSuffix = "dylib";
 const std::string CellMLToSharedLibraryConverter::msSoSuffix = "so";
 #endif
 
+/**
+ * Add some bytes to a 64-bit FNV-1a hash.
+ *
+ * @param rHash  the hash so far
+ * @param rBytes  the bytes to add
+ */
+static void AddToHash(uint64_t& rHash, const std::string& rBytes)
+{
+    for (std::string::const_iterator it = rBytes.begin(); it != rBytes.end(); ++it)
+    {
+        rHash ^= (unsigned char)(*it);
+        rHash *= 1099511628211ull;
+    }
+    // Separate successive inputs, so that e.g. ("ab", "c") and ("a", "bc") differ
+    rHash ^= 0xffu;
+    rHash *= 1099511628211ull;
+}
+
 CellMLToSharedLibraryConverter::CellMLToSharedLibraryConverter(bool preserveGeneratedSources,
                                                                std::string component)
     : mPreserveGeneratedSources(preserveGeneratedSources),
@@ -115,11 +140,41 @@ DynamicCellModelLoaderPtr CellMLToSharedLibraryConverter::Convert(const FileFind
         FileFinder so_file(so_path, RelativeTo::Absolute);
         if (!so_file.Exists() || rFilePath.IsNewerThan(so_file))
         {
-            if (!isCollective)
+            // Has an identical model already been compiled into the cache?
+            FileFinder cached_so_file;
+            FileFinder cache_folder = GetModelCacheFolder();
+            if (cache_folder.IsPathSet())
+            {
+                fs::path cached_so_path = fs::path(cache_folder.GetAbsolutePath()) / GetCacheKey(file_path_copy) / ("lib" + leaf + msSoSuffix);
+                cached_so_file.SetPath(cached_so_path.string(), RelativeTo::Absolute);
+            }
+            bool use_cache = cached_so_file.IsPathSet() && cached_so_file.Exists();
+            if (isCollective)
             {
-                EXCEPTION("Unable to convert .cellml to .so unless called collectively, due to possible race conditions.");
+                // Only use the cache if every process can see the entry
+                use_cache = !PetscTools::ReplicateBool(!use_cache);
+            }
+
+            if (use_cache)
+            {
+                so_file = cached_so_file;
+            }
+            else
+            {
+                if (!isCollective)
+                {
+                    EXCEPTION("Unable to convert .cellml to .so unless called collectively, due to possible race conditions.");
+                }
+                ConvertCellmlToSo(absolute_path, folder);
+                if (cached_so_file.IsPathSet())
+                {
+                    if (PetscTools::AmMaster())
+                    {
+                        StoreInCache(so_file, cached_so_file);
+                    }
+                    PetscTools::Barrier("CellMLToSharedLibraryConverter::StoreInCache");
+                }
             }
-            ConvertCellmlToSo(absolute_path, folder);
         }
         // Load the .so
         p_loader = DynamicModelLoaderRegistry::Instance()->GetLoader(so_file);
@@ -138,6 +193,81 @@ DynamicCellModelLoaderPtr CellMLToSharedLibraryConverter::Convert(const FileFind
     return p_loader;
 }
 
+FileFinder CellMLToSharedLibraryConverter::GetModelCacheFolder()
+{
+    FileFinder cache_folder;
+    char* p_cache_path = getenv("CHASTE_MODEL_CACHE");
+    if (p_cache_path != nullptr && *p_cache_path != 0)
+    {
+        cache_folder.SetPath(p_cache_path, RelativeTo::AbsoluteOrCwd);
+    }
+    return cache_folder;
+}
+
+std::string CellMLToSharedLibraryConverter::GetCacheKey(const FileFinder& rCellmlFile) const
+{
+    uint64_t hash = 14695981039346656037ull;
+
+    // The same files that are copied for conversion, in a fixed order
+    std::string leaf_name = rCellmlFile.GetLeafNameNoExtension();
+    std::vector<FileFinder> input_files = rCellmlFile.GetParent().FindMatches(leaf_name + "*");
+    BOOST_FOREACH(const FileFinder& r_input_file, input_files)
+    {
+        if (r_input_file.IsFile())
+        {
+            std::ifstream input(r_input_file.GetAbsolutePath().c_str(), std::ios::binary);
+            std::string contents((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+            AddToHash(hash, r_input_file.GetLeafName());
+            AddToHash(hash, contents);
+        }
+    }
+
+    // How the module is generated and built
+    AddToHash(hash, mComponentName);
+    AddToHash(hash, ChasteBuildInfo::GetVersionString());
+    AddToHash(hash, ChasteBuildType());
+    AddToHash(hash, ChasteBuildInfo::GetCompilerType());
+    AddToHash(hash, ChasteBuildInfo::GetCompilerVersion());
+    AddToHash(hash, ChasteBuildInfo::GetCompilerFlags());
+
+    std::stringstream key;
+    key << leaf_name << "_" << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return key.str();
+}
+
+void CellMLToSharedLibraryConverter::StoreInCache(const FileFinder& rSoFile, const FileFinder& rCachedSoFile)
+{
+    fs::path entry_folder = fs::path(rCachedSoFile.GetAbsolutePath()).parent_path();
+    std::stringstream tmp_name;
+    tmp_name << entry_folder.filename().string() << ".tmp_" << getpid() << "_" << time(NULL);
+    fs::path tmp_folder = entry_folder.parent_path() / tmp_name.str();
+
+    // Failing to write to the cache shouldn't stop the simulation
+    boost::system::error_code error;
+    fs::create_directories(tmp_folder, error);
+    if (error)
+    {
+        WARNING("Unable to store compiled cell model in the cache at '" << entry_folder.string() << "': " << error.message());
+        return;
+    }
+    try
+    {
+        rSoFile.CopyTo(FileFinder(tmp_folder.string(), RelativeTo::Absolute));
+    }
+    catch (const Exception& e)
+    {
+        WARNING("Unable to store compiled cell model in the cache at '" << entry_folder.string() << "': " << e.GetShortMessage());
+        fs::remove_all(tmp_folder, error);
+        return;
+    }
+    fs::rename(tmp_folder, entry_folder, error);
+    if (error)
+    {
+        // Another run has cached this model in the meantime
+        fs::remove_all(tmp_folder, error);
+    }
+}
+
 void CellMLToSharedLibraryConverter::ConvertCellmlToSo(const std::string& rCellmlFullPath,
                                                        const std::string& rCellmlFolder)
 {
@@ -298,3 +428,24 @@ void CellMLToSharedLibraryConverter::CreateOptionsFile(const OutputFileHandler&
     }
     PetscTools::Barrier("CellMLToSharedLibraryConverter::CreateOptionsFile");
 }
+
+void CellMLToSharedLibraryConverter::CreateSpecialisedOptionsFile(const OutputFileHandler& rHandler,
+                                                                  const std::string& rModelName,
+                                                                  const std::map<std::string, double>& rFixedParameters,
+                                                                  const std::vector<std::string>& rArgs)
+{
+    std::vector<std::string> args(rArgs);
+    if (std::find(args.begin(), args.end(), "--opt") == args.end())
+    {
+        args.push_back("--opt");
+    }
+    for (std::map<std::string, double>::const_iterator it = rFixedParameters.begin();
+         it != rFixedParameters.end();
+         ++it)
+    {
+        std::stringstream arg;
+        arg << "--fix-parameter=" << it->first << "=" << std::setprecision(17) << it->second;
+        args.push_back(arg.str());
+    }
+    CreateOptionsFile(rHandler, rModelName, args);
+}
@@ -36,6 +36,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef CELLMLTOSHAREDLIBRARYCONVERTER_HPP_
 #define CELLMLTOSHAREDLIBRARYCONVERTER_HPP_
 
+#include <map>
 #include <string>
 #include <vector>
 
@@ -46,6 +47,13 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 /**
  * This class encapsulates all the complexity needed to generate a loadable module from
  * a CellML file.
+ *
+ * If the environment variable CHASTE_MODEL_CACHE names a folder, compiled models are also
+ * stored there, keyed on a hash of the CellML file, its companion files (e.g. a PyCml options
+ * file or Maple output), the component, and the Chaste version and build configuration.
+ * Later conversions of an identical model (in any folder, by any run) then load the cached
+ * module instead of running PyCml and the compiler again.  Pointing the cache at node-local
+ * storage avoids every process loading the module from a shared filesystem.
  */
 class CellMLToSharedLibraryConverter
 {
@@ -93,7 +101,51 @@ public:
                                   const std::vector<std::string>& rArgs,
                                   const std::string& rExtraXml="");
 
+    /**
+     * Create a PyCml options file that specialises the given model for fixed values of some of its
+     * parameters.  These become constants of the generated code (they can no longer be changed with
+     * SetParameter()) and are folded into the model by partial evaluation, which is always requested.
+     * Since the options file is one of the inputs hashed into the model cache key, each set of values
+     * gets its own cache entry, so a parameter sweep only compiles each distinct model once.
+     *
+     * @param rHandler  where to create the file
+     * @param rModelName  base name of the model file (which will be "rModelName.cellml")
+     * @param rFixedParameters  the values of the parameters to fix, keyed by metadata name
+     *     (or by "component,variable" for parameters without metadata)
+     * @param rArgs  extra command-line arguments for the model conversion
+     */
+    static void CreateSpecialisedOptionsFile(const OutputFileHandler& rHandler,
+                                             const std::string& rModelName,
+                                             const std::map<std::string, double>& rFixedParameters,
+                                             const std::vector<std::string>& rArgs=std::vector<std::string>());
+
+    /**
+     * @return the folder in which compiled models are cached, as given by the CHASTE_MODEL_CACHE
+     * environment variable.  The returned finder has no path set if the variable is unset or empty,
+     * in which case no caching is done.
+     */
+    static FileFinder GetModelCacheFolder();
+
 private:
+    /**
+     * @return the name of the folder within the model cache for the given CellML file.  This
+     * contains a hash of all the inputs to the conversion, so changing any of them gives a new entry.
+     *
+     * @param rCellmlFile  the .cellml file
+     */
+    std::string GetCacheKey(const FileFinder& rCellmlFile) const;
+
+    /**
+     * Copy a newly compiled module into the model cache.  The entry is created under a temporary
+     * name and renamed into place, so concurrent runs never load a partly written module.
+     *
+     * @note Should only be called by the master process.
+     *
+     * @param rSoFile  the compiled module
+     * @param rCachedSoFile  where it should appear in the cache
+     */
+    static void StoreInCache(const FileFinder& rSoFile, const FileFinder& rCachedSoFile);
+
     /**
      * Helper method performing the actual conversion of a .cellml file to a .so.
      *
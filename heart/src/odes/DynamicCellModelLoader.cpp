@@ -70,6 +70,18 @@ DynamicCellModelLoader::DynamicCellModelLoader(const std::string& rLoadableModul
     }
     // Cast to the right type
     mpCreationFunction = reinterpret_cast<CellCreationFunctionType*>(p_creation_function);
+
+    // A cell batch creation function is optional
+    dlerror(); // Reset errors
+    void* p_batch_creation_function = dlsym(mpDynamicModule, "MakeCardiacCellBatch");
+    if (dlerror())
+    {
+        mpBatchCreationFunction = NULL;
+    }
+    else
+    {
+        mpBatchCreationFunction = reinterpret_cast<CellBatchCreationFunctionType*>(p_batch_creation_function);
+    }
 }
 
 DynamicCellModelLoader::~DynamicCellModelLoader()
@@ -92,6 +104,21 @@ AbstractCardiacCellInterface* DynamicCellModelLoader::CreateCell(boost::shared_p
     return p_cell;
 }
 
+bool DynamicCellModelLoader::HasCellBatch() const
+{
+    return (mpBatchCreationFunction != NULL);
+}
+
+AbstractCardiacCellBatch* DynamicCellModelLoader::CreateCellBatch(unsigned maxBatchSize)
+{
+    if (!mpBatchCreationFunction)
+    {
+        EXCEPTION("The loadable module '" + mLoadableModulePath + "' does not contain a cell batch;"
+                  " generate it with the --batch option.");
+    }
+    return (*mpBatchCreationFunction)(maxBatchSize);
+}
+
 const std::string DynamicCellModelLoader::GetLoadableModulePath() const
 {
     return mLoadableModulePath;
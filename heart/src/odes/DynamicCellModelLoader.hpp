@@ -41,6 +41,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <boost/enable_shared_from_this.hpp>
 
 #include "AbstractCardiacCellInterface.hpp"
+#include "AbstractCardiacCellBatch.hpp"
 #include "AbstractIvpOdeSolver.hpp"
 #include "AbstractStimulusFunction.hpp"
 
@@ -88,6 +89,22 @@ public:
     AbstractCardiacCellInterface* CreateCell(boost::shared_ptr<AbstractIvpOdeSolver> pSolver,
                                              boost::shared_ptr<AbstractStimulusFunction> pStimulus);
 
+    /**
+     * @return whether this dynamic module also contains a batched solver for
+     * its cells, i.e. was generated with the --batch option.
+     */
+    bool HasCellBatch() const;
+
+    /**
+     * @return a newly created batched solver for cells from this dynamic module.
+     *
+     * The caller takes responsibility for deleting the batch when it's finished
+     * with, and must keep this loader alive until then.
+     *
+     * @param maxBatchSize  the maximum number of cells to solve together
+     */
+    AbstractCardiacCellBatch* CreateCellBatch(unsigned maxBatchSize=256u);
+
     /**
      * @return the absolute path to the .so file we have loaded
      */
@@ -115,6 +132,15 @@ private:
     /** Our cell creation function */
     CellCreationFunctionType* mpCreationFunction;
 
+    /** Type of the cell batch creation function in the .so files
+     *
+     * @param maxBatchSize  the maximum number of cells to solve together
+     */
+    typedef AbstractCardiacCellBatch* CellBatchCreationFunctionType(unsigned maxBatchSize);
+
+    /** Our cell batch creation function, or NULL if the module doesn't have one */
+    CellBatchCreationFunctionType* mpBatchCreationFunction;
+
     /** Absolute path to the .so file we have loaded. */
     std::string mLoadableModulePath;
 };
@@ -0,0 +1,104 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "FitzHughNagumo1961CellBatch.hpp"
+
+#include <typeinfo>
+
+#include "FitzHughNagumo1961OdeSystem.hpp"
+
+FitzHughNagumo1961CellBatch::FitzHughNagumo1961CellBatch(unsigned maxBatchSize)
+    : AbstractCardiacCellBatch(2u, 0u, maxBatchSize)
+{
+}
+
+bool FitzHughNagumo1961CellBatch::IsModelCompatible(AbstractCardiacCellInterface* pCell) const
+{
+    // Subclasses may change the model, so only accept the class itself
+    return (typeid(*pCell) == typeid(FitzHughNagumo1961OdeSystem));
+}
+
+void FitzHughNagumo1961CellBatch::EvaluateYDerivativesBatch(double time,
+                                                            const std::vector<double>& rY,
+                                                            const std::vector<double>& rStimulus,
+                                                            std::vector<double>& rDY)
+{
+    const double alpha = FitzHughNagumo1961OdeSystem::mAlpha;
+    const double gamma = FitzHughNagumo1961OdeSystem::mGamma;
+    const double epsilon = FitzHughNagumo1961OdeSystem::mEpsilon;
+
+    const double* p_v = &rY[0];
+    const double* p_w = &rY[mNumCells];
+    const double* p_stim = &rStimulus[0];
+    double* p_dv = &rDY[0];
+    double* p_dw = &rDY[mNumCells];
+
+    // dV/dt (not updated if the voltage is clamped)
+    if (mSetVoltageDerivativeToZero)
+    {
+        for (unsigned i=0; i<mNumCells; i++)
+        {
+            p_dv[i] = 0.0;
+        }
+    }
+    else
+    {
+        for (unsigned i=0; i<mNumCells; i++)
+        {
+            p_dv[i] = p_v[i]*(p_v[i]-alpha)*(1-p_v[i])-p_w[i]+p_stim[i];
+        }
+    }
+
+    // dw/dt
+    for (unsigned i=0; i<mNumCells; i++)
+    {
+        p_dw[i] = epsilon*(p_v[i]-gamma*p_w[i]);
+    }
+}
+
+void FitzHughNagumo1961CellBatch::ComputeIIonicBatch(const std::vector<AbstractCardiacCellInterface*>& rCells,
+                                                     const std::vector<double>& rY,
+                                                     std::vector<double>& rIIonic)
+{
+    const double alpha = FitzHughNagumo1961OdeSystem::mAlpha;
+
+    const double* p_v = &rY[0];
+    const double* p_w = &rY[mNumCells];
+    double* p_i_ionic = &rIIonic[0];
+    for (unsigned i=0; i<mNumCells; i++)
+    {
+        p_i_ionic[i] = p_v[i]*(p_v[i]-alpha)*(1-p_v[i])-p_w[i];
+    }
+}
@@ -0,0 +1,89 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef FITZHUGHNAGUMO1961CELLBATCH_HPP_
+#define FITZHUGHNAGUMO1961CELLBATCH_HPP_
+
+#include "AbstractCardiacCellBatch.hpp"
+
+/**
+ * Batched forward Euler solver for FitzHughNagumo1961OdeSystem cells.
+ */
+class FitzHughNagumo1961CellBatch : public AbstractCardiacCellBatch
+{
+protected:
+    /**
+     * @return whether the cell is a FitzHughNagumo1961OdeSystem.
+     *
+     * @param pCell  the cell
+     */
+    bool IsModelCompatible(AbstractCardiacCellInterface* pCell) const;
+
+    /**
+     * Compute the right-hand side of the FitzHugh-Nagumo system for every
+     * cell in the batch.
+     *
+     * @param time  the current time
+     * @param rY  the state variables
+     * @param rStimulus  the intracellular area stimulus for each cell
+     * @param rDY  to be filled in with the derivatives
+     */
+    void EvaluateYDerivativesBatch(double time,
+                                   const std::vector<double>& rY,
+                                   const std::vector<double>& rStimulus,
+                                   std::vector<double>& rDY);
+
+    /**
+     * Compute the (fake) ionic current of every cell in the batch, as
+     * FitzHughNagumo1961OdeSystem::GetIIonic().
+     *
+     * @param rCells  the cells in the batch
+     * @param rY  the state variables
+     * @param rIIonic  to be filled in with the ionic current of each cell
+     */
+    void ComputeIIonicBatch(const std::vector<AbstractCardiacCellInterface*>& rCells,
+                            const std::vector<double>& rY,
+                            std::vector<double>& rIIonic);
+
+public:
+    /**
+     * Constructor.
+     *
+     * @param maxBatchSize  the maximum number of cells to solve together (defaults to 256)
+     */
+    FitzHughNagumo1961CellBatch(unsigned maxBatchSize=256u);
+};
+
+#endif // FITZHUGHNAGUMO1961CELLBATCH_HPP_
@@ -45,6 +45,9 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 class FitzHughNagumo1961OdeSystem : public AbstractCardiacCell
 {
 private:
+    /** The batched solver shares the model constants. */
+    friend class FitzHughNagumo1961CellBatch;
+
     static const double mAlpha; /**< Constant parameter alpha */
     static const double mGamma; /**< Constant parameter gamma */
     static const double mEpsilon; /**< Constant parameter epsilon */
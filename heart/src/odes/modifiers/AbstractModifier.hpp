@@ -49,9 +49,22 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  * Clearly for this to work the cell model must be modified to include calls to instances
  * of these classes.  PyCml has some experimental support for this, generating subclasses
  * of AbstractCardiacCellWithModifiers.
+ *
+ * Cell models should call Apply() rather than Calc(): for the common modifiers (identity,
+ * scale factor and fixed value) it computes the result inline, without a virtual call.
  */
 class AbstractModifier
 {
+public:
+    /** How Apply() computes the modified quantity. */
+    enum InlineKind
+    {
+        GENERAL,  /**< Call Calc() */
+        IDENTITY, /**< Return the quantity unchanged */
+        FACTOR,   /**< Multiply the quantity by the inline value */
+        FIXED     /**< Return the inline value */
+    };
+
 private:
     /** Needed for serialization. */
     friend class boost::serialization::access;
@@ -64,7 +77,37 @@ private:
     template <class Archive>
     void serialize(Archive & archive, const unsigned int version)
     {
-        // This class has no member variables to serialise at the moment.
+        // The inline kind and value are set by the subclass constructors and serialize methods.
+    }
+
+    /** How Apply() computes the modified quantity. */
+    InlineKind mInlineKind;
+
+    /** The scale factor or fixed value used by Apply(), if any. */
+    double mInlineValue;
+
+protected:
+    /**
+     * Constructor for subclasses whose effect Apply() can compute inline.  Subclasses of
+     * these that override Calc() must pass GENERAL.
+     *
+     * @param kind  how Apply() computes the modified quantity
+     * @param value  the scale factor or fixed value, if any
+     */
+    AbstractModifier(InlineKind kind, double value=0.0)
+        : mInlineKind(kind),
+          mInlineValue(value)
+    {
+    }
+
+    /**
+     * Change the scale factor or fixed value used by Apply().
+     *
+     * @param value  the new value
+     */
+    void SetInlineValue(double value)
+    {
+        mInlineValue = value;
     }
 
   public:
@@ -72,6 +115,8 @@ private:
      * Default constructor.
      */
     AbstractModifier(void)
+        : mInlineKind(GENERAL),
+          mInlineValue(0.0)
     {
     }
 
@@ -91,6 +136,36 @@ private:
      * @return the new value for the quantity which is being modified
      */
     virtual double Calc(double param, double time) = 0;
+
+    /**
+     * @return how Apply() computes the modified quantity
+     */
+    InlineKind GetInlineKind() const
+    {
+        return mInlineKind;
+    }
+
+    /**
+     * Perform the modification, as Calc() does, but inline for the common modifiers.
+     *
+     * @param param  the current value of the quantity which is being modified
+     * @param time  the current simulation time
+     * @return the new value for the quantity which is being modified
+     */
+    inline double Apply(double param, double time)
+    {
+        switch (mInlineKind)
+        {
+            case IDENTITY:
+                return param;
+            case FACTOR:
+                return mInlineValue*param;
+            case FIXED:
+                return mInlineValue;
+            default:
+                return Calc(param, time);
+        }
+    }
 };
 
 CLASS_IS_ABSTRACT(AbstractModifier)
@@ -69,6 +69,7 @@ public:
      * Default constructor
      */
     DummyModifier()
+        : AbstractModifier(IDENTITY)
     {
     }
 
@@ -62,6 +62,7 @@ private:
     {
         archive & boost::serialization::base_object<AbstractModifier>(*this);
         archive & mFactor;
+        SetInlineValue(mFactor);
     }
 
     /** Factor to multiply parameter of interest by. */
@@ -73,7 +74,8 @@ public:
      * @param factor  scale factor to use, defaults to 1 (i.e. no effect)
      */
     FactorModifier(double factor=1)
-        : mFactor(factor)
+        : AbstractModifier(FACTOR, factor),
+          mFactor(factor)
     {
     }
 
@@ -62,13 +62,16 @@ private:
     {
         archive & boost::serialization::base_object<AbstractModifier>(*this);
         archive & mValue;
+        SetInlineValue(mValue);
     }
 
     /** Fixed value to clamp parameter at */
     double mValue;
 
     /** Private constructor for use by archiving only */
-    FixedModifier(){};
+    FixedModifier()
+        : AbstractModifier(FIXED)
+    {};
 
 public:
     /**
@@ -76,7 +79,8 @@ public:
      * @param value  The fixed value to use.
      */
     FixedModifier(double value)
-        : mValue(value)
+        : AbstractModifier(FIXED, value),
+          mValue(value)
     {
     }
 
@@ -0,0 +1,266 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "SingleCellEnsembleRunner.hpp"
+
+#include "CheckpointArchiveTypes.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+#include "CellProperties.hpp"
+#include "Exception.hpp"
+#include "OdeSolution.hpp"
+#include "OpenMpExceptionCollector.hpp"
+#include "OutputFileHandler.hpp"
+#include "PetscTools.hpp"
+
+SingleCellEnsembleRunner::SingleCellEnsembleRunner(boost::shared_ptr<AbstractCardiacCellInterface> pModel,
+                                                   const std::vector<std::string>& rParameterNames)
+        : mpModel(pModel),
+          mParameterNames(rParameterNames),
+          mInitialState(pModel->GetStdVecStateVariables()),
+          mPrePacingDuration(0.0),
+          mDuration(-1.0),
+          mSamplingInterval(-1.0),
+          mApdPercentage(90.0),
+          mNumThreads(1u)
+{
+    // This throws if the model doesn't have one of the parameters
+    for (unsigned i=0; i<mParameterNames.size(); i++)
+    {
+        mpModel->GetParameter(mParameterNames[i]);
+    }
+}
+
+void SingleCellEnsembleRunner::AddParameterSet(const std::vector<double>& rParameterValues)
+{
+    if (rParameterValues.size() != mParameterNames.size())
+    {
+        EXCEPTION("Parameter set has " << rParameterValues.size() << " values but "
+                  << mParameterNames.size() << " parameters are being varied.");
+    }
+    mParameterSets.push_back(rParameterValues);
+}
+
+unsigned SingleCellEnsembleRunner::GetNumParameterSets() const
+{
+    return mParameterSets.size();
+}
+
+void SingleCellEnsembleRunner::SetPrePacingDuration(double duration)
+{
+    if (duration < 0.0)
+    {
+        EXCEPTION("The pre-pacing duration cannot be negative.");
+    }
+    mPrePacingDuration = duration;
+}
+
+void SingleCellEnsembleRunner::SetSimulationDuration(double duration, double samplingInterval)
+{
+    if (duration <= 0.0 || samplingInterval <= 0.0)
+    {
+        EXCEPTION("The simulation duration and sampling interval must be positive.");
+    }
+    mDuration = duration;
+    mSamplingInterval = samplingInterval;
+}
+
+void SingleCellEnsembleRunner::SetApdPercentage(double percentage)
+{
+    mApdPercentage = percentage;
+}
+
+void SingleCellEnsembleRunner::SetNumberOfThreads(unsigned numThreads)
+{
+    if (numThreads == 0u)
+    {
+        EXCEPTION("The number of ensemble threads must be at least one.");
+    }
+    mNumThreads = numThreads;
+}
+
+unsigned SingleCellEnsembleRunner::GetNumberOfThreads() const
+{
+    return mNumThreads;
+}
+
+boost::shared_ptr<AbstractCardiacCellInterface> SingleCellEnsembleRunner::CopyModel() const
+{
+    AbstractCardiacCellInterface* p_copy = nullptr;
+    try
+    {
+        std::stringstream archive_stream;
+        {
+            boost::archive::binary_oarchive output_arch(archive_stream);
+            AbstractCardiacCellInterface* const p_model = mpModel.get();
+            output_arch << p_model;
+        }
+        boost::archive::binary_iarchive input_arch(archive_stream);
+        input_arch >> p_copy;
+    }
+    catch (boost::archive::archive_exception& e)
+    {
+        EXCEPTION("Cannot copy the cell model for another thread, as it could not be archived: " << e.what());
+    }
+    return boost::shared_ptr<AbstractCardiacCellInterface>(p_copy);
+}
+
+void SingleCellEnsembleRunner::RunParameterSet(unsigned index, AbstractCardiacCellInterface& rModel, std::ostream& rOutput)
+{
+    const std::vector<double>& r_values = mParameterSets[index];
+    rOutput << index;
+    for (unsigned i=0; i<r_values.size(); i++)
+    {
+        rOutput << "\t" << r_values[i];
+    }
+
+    std::stringstream results;
+    try
+    {
+        // Every run starts from the same initial conditions and time, so the stimulus is the same
+        rModel.SetStateVariables(mInitialState);
+        for (unsigned i=0; i<mParameterNames.size(); i++)
+        {
+            rModel.SetParameter(mParameterNames[i], r_values[i]);
+        }
+        if (mPrePacingDuration > 0.0)
+        {
+            rModel.SolveAndUpdateState(0.0, mPrePacingDuration);
+        }
+
+        OdeSolution solution = rModel.Compute(mPrePacingDuration, mPrePacingDuration + mDuration, mSamplingInterval);
+        std::vector<double> voltages = solution.GetVariableAtIndex(rModel.GetVoltageIndex());
+        CellProperties properties(voltages, solution.rGetTimes());
+
+        results << "\t" << properties.GetLastActionPotentialDuration(mApdPercentage)
+                << "\t" << properties.GetLastPeakPotential()
+                << "\t" << properties.GetLastRestingPotential()
+                << "\t" << properties.GetLastMaxUpstrokeVelocity();
+    }
+    catch (Exception&)
+    {
+        // Some parameter sets may not give an action potential; this shouldn't stop the whole sweep
+        results.str("");
+        results << "\tnan\tnan\tnan\tnan";
+    }
+    rOutput << results.str() << std::endl;
+}
+
+void SingleCellEnsembleRunner::Run(const std::string& rDirectory, const std::string& rFileName)
+{
+    if (mDuration <= 0.0)
+    {
+        EXCEPTION("SetSimulationDuration() must be called before Run().");
+    }
+
+    // Split the parameter sets into contiguous blocks, so that the file is in order
+    const unsigned num_sets = mParameterSets.size();
+    const unsigned num_procs = PetscTools::GetNumProcs();
+    const unsigned rank = PetscTools::GetMyRank();
+    const unsigned lo = (num_sets*rank)/num_procs;
+    const unsigned hi = (num_sets*(rank+1))/num_procs;
+
+    /*
+     * Run the simulations before writing, so the processes only wait for each other to write.
+     * The local block is split into contiguous sub-blocks, one per thread, each run with its own
+     * copy of the model (made here, as archiving isn't thread safe). The results of each
+     * sub-block are gathered in order, and the first exception thrown is re-thrown once all have
+     * finished.
+     */
+    unsigned num_blocks = 1u;
+#ifdef CHASTE_OPENMP
+    num_blocks = std::max(1u, std::min(mNumThreads, hi - lo));
+#endif // CHASTE_OPENMP
+    std::vector<boost::shared_ptr<AbstractCardiacCellInterface> > models(1u, mpModel);
+    for (unsigned block=1; block<num_blocks; block++)
+    {
+        models.push_back(CopyModel());
+    }
+
+    std::vector<std::string> block_results(num_blocks);
+    OpenMpExceptionCollector exception_collector;
+#ifdef CHASTE_OPENMP
+#pragma omp parallel for schedule(static) num_threads(num_blocks) if(num_blocks > 1u)
+#endif // CHASTE_OPENMP
+    for (int block=0; block<static_cast<int>(num_blocks); block++)
+    {
+        try
+        {
+            std::stringstream results;
+            results << std::setprecision(10);
+            const unsigned block_lo = lo + ((hi - lo)*block)/num_blocks;
+            const unsigned block_hi = lo + ((hi - lo)*(block + 1))/num_blocks;
+            for (unsigned index=block_lo; index<block_hi; index++)
+            {
+                RunParameterSet(index, *models[block], results);
+            }
+            block_results[block] = results.str();
+        }
+        catch (...)
+        {
+            exception_collector.Capture();
+        }
+    }
+    exception_collector.RethrowIfAny();
+    std::stringstream local_results;
+    for (unsigned block=0; block<num_blocks; block++)
+    {
+        local_results << block_results[block];
+    }
+
+    OutputFileHandler handler(rDirectory, false);
+    if (PetscTools::AmMaster())
+    {
+        out_stream p_file = handler.OpenOutputFile(rFileName);
+        *p_file << "# index";
+        for (unsigned i=0; i<mParameterNames.size(); i++)
+        {
+            *p_file << "\t" << mParameterNames[i];
+        }
+        *p_file << "\tAPD" << mApdPercentage << "\tpeak_potential\tresting_potential\tmax_upstroke_velocity" << std::endl;
+        p_file->close();
+    }
+
+    PetscTools::BeginRoundRobin();
+    {
+        out_stream p_file = handler.OpenOutputFile(rFileName, std::ios::app);
+        *p_file << local_results.str();
+        p_file->close();
+    }
+    PetscTools::EndRoundRobin();
+}
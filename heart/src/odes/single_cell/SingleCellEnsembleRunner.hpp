@@ -0,0 +1,174 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef _SINGLECELLENSEMBLERUNNER_HPP_
+#define _SINGLECELLENSEMBLERUNNER_HPP_
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+#include "AbstractCardiacCellInterface.hpp"
+
+/**
+ * Helper class for running the same single cell model for many different sets of parameter
+ * values (e.g. for drug block studies), without the overhead of launching a process for each one.
+ *
+ * Each parameter set is applied to the model through SetParameter(), the model is reset to its
+ * initial state and (optionally) paced without recording, and then the action potential is
+ * recorded and analysed with CellProperties. One line of summary results per parameter set is
+ * written to a single output file.
+ *
+ * When run in parallel the parameter sets are split into contiguous blocks, one per process, and
+ * each process writes its results in turn, so the output file is in the same order as the
+ * parameter sets were added. Each process uses its own copy of the model, so the model given to
+ * the constructor should be created on every process.
+ *
+ * Within a process, the block of parameter sets can further be split between OpenMP threads (see
+ * SetNumberOfThreads()). Each thread then runs its own copy of the model, with its own ODE solver,
+ * made by archiving the model into memory, so the model class must be archivable.
+ */
+class SingleCellEnsembleRunner
+{
+private:
+    /** The cell model to run for each parameter set */
+    boost::shared_ptr<AbstractCardiacCellInterface> mpModel;
+
+    /** The names of the parameters to vary, in the order their values are given to AddParameterSet() */
+    std::vector<std::string> mParameterNames;
+
+    /** The parameter sets, each one having a value for each of #mParameterNames */
+    std::vector<std::vector<double> > mParameterSets;
+
+    /** The state of the model when this class was constructed, which each run starts from */
+    std::vector<double> mInitialState;
+
+    /** How long to pace the model for before recording, in ms (defaults to 0) */
+    double mPrePacingDuration;
+
+    /** How long to record the action potential for, in ms */
+    double mDuration;
+
+    /** The sampling interval for the recorded action potential, in ms */
+    double mSamplingInterval;
+
+    /** The percentage repolarisation at which to calculate the APD (defaults to 90) */
+    double mApdPercentage;
+
+    /** The number of threads used to run this process's parameter sets (defaults to 1) */
+    unsigned mNumThreads;
+
+    /**
+     * Run a model for a single parameter set and write a line of results.
+     *
+     * @param index  the index of the parameter set
+     * @param rModel  the model to run (#mpModel or a copy of it)
+     * @param rOutput  the stream to write the results to
+     */
+    void RunParameterSet(unsigned index, AbstractCardiacCellInterface& rModel, std::ostream& rOutput);
+
+    /**
+     * @return an independent copy of #mpModel, including its ODE solver and stimulus, made by
+     * archiving it into memory.
+     */
+    boost::shared_ptr<AbstractCardiacCellInterface> CopyModel() const;
+
+public:
+    /**
+     * Constructor.
+     *
+     * @param pModel  the cell model to run, with its stimulus already set up
+     * @param rParameterNames  the names of the model parameters to vary
+     */
+    SingleCellEnsembleRunner(boost::shared_ptr<AbstractCardiacCellInterface> pModel,
+                             const std::vector<std::string>& rParameterNames);
+
+    /**
+     * Add a set of parameter values to the ensemble.
+     *
+     * @param rParameterValues  a value for each of the parameters given to the constructor
+     */
+    void AddParameterSet(const std::vector<double>& rParameterValues);
+
+    /**
+     * @return the number of parameter sets in the ensemble
+     */
+    unsigned GetNumParameterSets() const;
+
+    /**
+     * @param duration  how long to pace the model for before each recording, in ms
+     */
+    void SetPrePacingDuration(double duration);
+
+    /**
+     * @param duration  how long to record the action potential for, in ms
+     * @param samplingInterval  the sampling interval for the recording, in ms
+     */
+    void SetSimulationDuration(double duration, double samplingInterval);
+
+    /**
+     * @param percentage  the percentage repolarisation at which to calculate the APD (defaults to 90)
+     */
+    void SetApdPercentage(double percentage);
+
+    /**
+     * Set the number of threads used to run the parameter sets on each process. This is ignored
+     * unless Chaste was built with OpenMP support.
+     *
+     * @param numThreads  the number of threads (at least 1)
+     */
+    void SetNumberOfThreads(unsigned numThreads);
+
+    /**
+     * @return the number of threads used to run the parameter sets on each process
+     */
+    unsigned GetNumberOfThreads() const;
+
+    /**
+     * Run the model for every parameter set in the ensemble. This is collective.
+     *
+     * The output file is tab separated, with a header line followed by one line per parameter set
+     * giving its index, the parameter values, and the APD, peak potential, resting potential and
+     * maximum upstroke velocity of the last action potential. If a run fails (or doesn't produce a
+     * complete action potential) these results are written as "nan".
+     *
+     * @param rDirectory  the output directory, relative to CHASTE_TEST_OUTPUT
+     * @param rFileName  the name of the results file
+     */
+    void Run(const std::string& rDirectory, const std::string& rFileName);
+};
+
+#endif // _SINGLECELLENSEMBLERUNNER_HPP_
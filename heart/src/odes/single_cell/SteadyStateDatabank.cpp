@@ -0,0 +1,217 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "SteadyStateDatabank.hpp"
+
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+#include "AbstractUntemplatedParameterisedSystem.hpp"
+#include "CheckpointArchiveTypes.hpp"
+#include "Exception.hpp"
+#include "PetscTools.hpp"
+
+#ifdef CHASTE_CVODE
+#include <boost/shared_ptr.hpp>
+#include "RegularStimulus.hpp"
+#include "SteadyStateRunner.hpp"
+
+/**
+ * Deleter for wrapping a cell model owned elsewhere in a shared pointer, for SteadyStateRunner.
+ */
+struct SteadyStateDatabankNullDeleter
+{
+    /** Does not delete the cell. */
+    void operator()(void const *) const
+    {
+    }
+};
+#endif // CHASTE_CVODE
+
+std::string SteadyStateDatabank::GetKey(AbstractCardiacCellInterface& rCell,
+                                        double pacingCycleLength,
+                                        const std::string& rTag)
+{
+    AbstractUntemplatedParameterisedSystem* p_system = dynamic_cast<AbstractUntemplatedParameterisedSystem*>(&rCell);
+    if (p_system == NULL)
+    {
+        EXCEPTION("Steady states can only be stored for cell models which are ODE systems.");
+    }
+
+    std::ostringstream key;
+    key.precision(std::numeric_limits<double>::max_digits10);
+    key << p_system->GetSystemName() << "|";
+    for (unsigned i=0; i<rCell.GetNumberOfParameters(); i++)
+    {
+        key << rCell.GetParameter(i) << " ";
+    }
+    key << "|" << pacingCycleLength << "|" << rTag;
+    return key.str();
+}
+
+bool SteadyStateDatabank::HasState(const std::string& rKey) const
+{
+    return mStates.find(rKey) != mStates.end();
+}
+
+void SteadyStateDatabank::Store(const std::string& rKey, const std::vector<double>& rState)
+{
+    mStates[rKey] = rState;
+    mNewKeys.push_back(rKey);
+}
+
+bool SteadyStateDatabank::Apply(const std::string& rKey, AbstractCardiacCellInterface& rCell) const
+{
+    std::map<std::string, std::vector<double> >::const_iterator it = mStates.find(rKey);
+    if (it == mStates.end())
+    {
+        return false;
+    }
+    rCell.SetStateVariables(it->second);
+    return true;
+}
+
+unsigned SteadyStateDatabank::GetNumStates() const
+{
+    return mStates.size();
+}
+
+#ifdef CHASTE_CVODE
+bool SteadyStateDatabank::RunToSteadyState(const std::string& rKey,
+                                           AbstractCvodeCell& rCell,
+                                           double pacingCycleLength,
+                                           unsigned maxNumPaces)
+{
+    if (!rCell.HasCellMLDefaultStimulus())
+    {
+        EXCEPTION("Cannot compute a steady state for the databank: cell model "
+                  << rCell.GetSystemName() << " has no default stimulus from CellML.");
+    }
+    boost::shared_ptr<AbstractStimulusFunction> p_own_stimulus = rCell.GetStimulusFunction();
+    rCell.UseCellMLDefaultStimulus()->SetPeriod(pacingCycleLength);
+
+    SteadyStateRunner runner(boost::shared_ptr<AbstractCvodeCell>(&rCell, SteadyStateDatabankNullDeleter()));
+    runner.SuppressOutput();
+    runner.SetMaxNumPaces(maxNumPaces);
+    bool result = runner.RunToSteadyState();
+
+    rCell.SetStimulusFunction(p_own_stimulus);
+    rCell.ResetSolver();
+
+    // Store even a state that is not quite steady, since it is still a better start than the initial conditions
+    Store(rKey, rCell.GetStdVecStateVariables());
+    return result;
+}
+#endif // CHASTE_CVODE
+
+void SteadyStateDatabank::Synchronise()
+{
+    if (PetscTools::IsSequential())
+    {
+        mNewKeys.clear();
+        return;
+    }
+
+    std::map<std::string, std::vector<double> > new_states;
+    for (unsigned i=0; i<mNewKeys.size(); i++)
+    {
+        new_states[mNewKeys[i]] = mStates[mNewKeys[i]];
+    }
+    mNewKeys.clear();
+
+    std::ostringstream local_stream;
+    {
+        boost::archive::text_oarchive output_arch(local_stream);
+        output_arch << new_states;
+    }
+    std::string local_string = local_stream.str();
+
+    unsigned num_procs = PetscTools::GetNumProcs();
+    int local_size = local_string.size();
+    std::vector<int> sizes(num_procs);
+    MPI_Allgather(&local_size, 1, MPI_INT, &sizes[0], 1, MPI_INT, PetscTools::GetWorld());
+
+    std::vector<int> offsets(num_procs, 0);
+    for (unsigned proc=1; proc<num_procs; proc++)
+    {
+        offsets[proc] = offsets[proc-1] + sizes[proc-1];
+    }
+    std::vector<char> all_strings(offsets[num_procs-1] + sizes[num_procs-1] + 1);
+    MPI_Allgatherv(const_cast<char*>(local_string.data()), local_size, MPI_CHAR,
+                   &all_strings[0], &sizes[0], &offsets[0], MPI_CHAR, PetscTools::GetWorld());
+
+    for (unsigned proc=0; proc<num_procs; proc++)
+    {
+        if (proc == PetscTools::GetMyRank())
+        {
+            continue;
+        }
+        std::istringstream remote_stream(std::string(&all_strings[offsets[proc]], sizes[proc]));
+        boost::archive::text_iarchive input_arch(remote_stream);
+        std::map<std::string, std::vector<double> > remote_states;
+        input_arch >> remote_states;
+        mStates.insert(remote_states.begin(), remote_states.end());
+    }
+}
+
+void SteadyStateDatabank::Save(const FileFinder& rFile) const
+{
+    if (PetscTools::AmMaster())
+    {
+        std::ofstream output_file(rFile.GetAbsolutePath().c_str());
+        if (!output_file.is_open())
+        {
+            EXCEPTION("Could not open steady state databank file " << rFile.GetAbsolutePath() << " for writing.");
+        }
+        boost::archive::text_oarchive output_arch(output_file);
+        output_arch << *this;
+    }
+    PetscTools::Barrier("SteadyStateDatabank::Save");
+}
+
+bool SteadyStateDatabank::Load(const FileFinder& rFile)
+{
+    if (!rFile.Exists())
+    {
+        return false;
+    }
+    std::ifstream input_file(rFile.GetAbsolutePath().c_str());
+    boost::archive::text_iarchive input_arch(input_file);
+    SteadyStateDatabank loaded;
+    input_arch >> loaded;
+    mStates.insert(loaded.mStates.begin(), loaded.mStates.end());
+    return true;
+}
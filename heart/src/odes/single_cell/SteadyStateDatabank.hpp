@@ -0,0 +1,174 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef _STEADYSTATEDATABANK_HPP_
+#define _STEADYSTATEDATABANK_HPP_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/map.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include "AbstractCardiacCellInterface.hpp"
+#include "FileFinder.hpp"
+
+#ifdef CHASTE_CVODE
+#include "AbstractCvodeCell.hpp"
+#endif // CHASTE_CVODE
+
+/**
+ * A store of precomputed limit-cycle (paced steady) states of single cell models, so that tissue
+ * simulations can start their cells at steady state instead of pre-pacing the tissue.
+ *
+ * Each state is stored under a key made from the cell model's name, the values of all its
+ * parameters, the pacing cycle length, and a free-form tag which the user should use to describe
+ * anything else that affects the steady state (e.g. modifiers or drug block applied to the cell).
+ * See GetKey().
+ *
+ * The databank can be saved to and loaded from a file, so that it is built up over many simulations.
+ * A cell factory given a databank (see AbstractCardiacCellFactory::SetSteadyStateDatabank()) looks up
+ * the state of every cell it creates, and computes any that are missing; since each process only
+ * computes the states of its own cells the missing entries are computed in parallel, and are then
+ * shared between processes by Synchronise().
+ */
+class SteadyStateDatabank
+{
+private:
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Archive the databank.
+     *
+     * @param archive the archive
+     * @param version the current version of this class
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & mStates;
+    }
+
+    /** The stored steady states, by key */
+    std::map<std::string, std::vector<double> > mStates;
+
+    /** The keys of states stored by this process since the last call to Synchronise() */
+    std::vector<std::string> mNewKeys;
+
+public:
+    /**
+     * @return the key under which the steady state of a cell is stored.
+     *
+     * @param rCell  the cell model, with its parameters set as they will be used
+     * @param pacingCycleLength  the pacing cycle length (ms)
+     * @param rTag  describes any other changes to the cell that affect its steady state
+     */
+    static std::string GetKey(AbstractCardiacCellInterface& rCell,
+                              double pacingCycleLength,
+                              const std::string& rTag="");
+
+    /**
+     * @return whether a steady state is stored under the given key
+     * @param rKey  the key
+     */
+    bool HasState(const std::string& rKey) const;
+
+    /**
+     * Store a steady state, replacing any already stored under the same key.
+     *
+     * @param rKey  the key
+     * @param rState  the model's state variables at steady state
+     */
+    void Store(const std::string& rKey, const std::vector<double>& rState);
+
+    /**
+     * Set the state variables of a cell model to the steady state stored under the given key.
+     * The model is left unchanged if there is no such state.
+     *
+     * @param rKey  the key
+     * @param rCell  the cell model
+     * @return whether a stored state was applied
+     */
+    bool Apply(const std::string& rKey, AbstractCardiacCellInterface& rCell) const;
+
+    /**
+     * @return the number of stored steady states
+     */
+    unsigned GetNumStates() const;
+
+#ifdef CHASTE_CVODE
+    /**
+     * Pace a cell model to steady state with SteadyStateRunner, using its default stimulus from
+     * CellML with the given cycle length, and store the result. The cell's own stimulus is restored
+     * afterwards.
+     *
+     * @param rKey  the key to store the state under
+     * @param rCell  the cell model
+     * @param pacingCycleLength  the pacing cycle length (ms)
+     * @param maxNumPaces  the maximum number of paces to run for
+     * @return whether the model reached steady state
+     */
+    bool RunToSteadyState(const std::string& rKey,
+                          AbstractCvodeCell& rCell,
+                          double pacingCycleLength,
+                          unsigned maxNumPaces=10000u);
+#endif // CHASTE_CVODE
+
+    /**
+     * Share the states stored on each process since the last call with all the other processes.
+     * States already present on a process are kept. Collective.
+     */
+    void Synchronise();
+
+    /**
+     * Write the databank to a file. Only the master process writes. Collective.
+     *
+     * @param rFile  the file to write
+     */
+    void Save(const FileFinder& rFile) const;
+
+    /**
+     * Add the states in a file written by Save() to the databank; states already present are kept.
+     *
+     * @param rFile  the file to read
+     * @return false if the file does not exist (e.g. on the first run), otherwise true
+     */
+    bool Load(const FileFinder& rFile);
+};
+
+#endif // _STEADYSTATEDATABANK_HPP_
@@ -0,0 +1,129 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#include "SteadyStateSnapshotCache.hpp"
+
+#include <limits>
+
+#include "Exception.hpp"
+
+#ifdef CHASTE_CVODE
+#include "SteadyStateRunner.hpp"
+#endif // CHASTE_CVODE
+
+void SteadyStateSnapshotCache::Store(const std::vector<double>& rParameters, const std::vector<double>& rState)
+{
+    for (unsigned i=0; i<mParameterSets.size(); i++)
+    {
+        if (mParameterSets[i] == rParameters)
+        {
+            mStates[i] = rState;
+            return;
+        }
+    }
+    mParameterSets.push_back(rParameters);
+    mStates.push_back(rState);
+}
+
+unsigned SteadyStateSnapshotCache::GetNearestIndex(const std::vector<double>& rParameters) const
+{
+    if (mParameterSets.empty())
+    {
+        EXCEPTION("There are no steady states stored in the cache.");
+    }
+
+    unsigned nearest = 0u;
+    double nearest_distance_squared = std::numeric_limits<double>::max();
+    for (unsigned i=0; i<mParameterSets.size(); i++)
+    {
+        if (mParameterSets[i].size() != rParameters.size())
+        {
+            EXCEPTION("Parameter set has " << rParameters.size() << " values but the cache stores sets of "
+                      << mParameterSets[i].size() << ".");
+        }
+        double distance_squared = 0.0;
+        for (unsigned j=0; j<rParameters.size(); j++)
+        {
+            double difference = mParameterSets[i][j] - rParameters[j];
+            distance_squared += difference*difference;
+        }
+        if (distance_squared < nearest_distance_squared)
+        {
+            nearest = i;
+            nearest_distance_squared = distance_squared;
+        }
+    }
+    return nearest;
+}
+
+bool SteadyStateSnapshotCache::ApplyNearest(const std::vector<double>& rParameters, AbstractCardiacCellInterface& rCell) const
+{
+    if (mParameterSets.empty())
+    {
+        return false;
+    }
+    rCell.SetStateVariables(mStates[GetNearestIndex(rParameters)]);
+    return true;
+}
+
+unsigned SteadyStateSnapshotCache::GetNumSnapshots() const
+{
+    return mParameterSets.size();
+}
+
+void SteadyStateSnapshotCache::Clear()
+{
+    mParameterSets.clear();
+    mStates.clear();
+}
+
+#ifdef CHASTE_CVODE
+bool SteadyStateSnapshotCache::RunToSteadyState(const std::vector<double>& rParameters,
+                                                boost::shared_ptr<AbstractCvodeCell> pModel,
+                                                unsigned maxNumPaces)
+{
+    ApplyNearest(rParameters, *pModel);
+
+    SteadyStateRunner runner(pModel);
+    runner.SuppressOutput();
+    runner.SetMaxNumPaces(maxNumPaces);
+    bool result = runner.RunToSteadyState();
+
+    // Store even a state that is not quite steady, since it is still a better start than the initial conditions
+    Store(rParameters, pModel->GetStdVecStateVariables());
+    return result;
+}
+#endif // CHASTE_CVODE
@@ -0,0 +1,137 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef _STEADYSTATESNAPSHOTCACHE_HPP_
+#define _STEADYSTATESNAPSHOTCACHE_HPP_
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/vector.hpp>
+
+#include "AbstractCardiacCellInterface.hpp"
+
+#ifdef CHASTE_CVODE
+#include "AbstractCvodeCell.hpp"
+#endif // CHASTE_CVODE
+
+/**
+ * Stores steady states of a single cell model for the parameter sets it has been run with,
+ * so that a run with a new parameter set can start from the steady state of the nearest
+ * parameter set seen so far (e.g. during a parameter fit, where successive parameter sets
+ * are often close together) instead of from the model's initial conditions.
+ *
+ * The cache can be archived with the usual Chaste checkpointing, so that it persists
+ * across restarts of a fitting job.
+ */
+class SteadyStateSnapshotCache
+{
+private:
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Archive the cache.
+     *
+     * @param archive the archive
+     * @param version the current version of this class
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & mParameterSets;
+        archive & mStates;
+    }
+
+    /** The parameter sets for which a steady state is stored */
+    std::vector<std::vector<double> > mParameterSets;
+
+    /** The stored steady states, one for each of #mParameterSets */
+    std::vector<std::vector<double> > mStates;
+
+public:
+    /**
+     * Store the steady state for a parameter set. If a state is already stored for exactly
+     * this parameter set it is replaced.
+     *
+     * @param rParameters  the parameter set
+     * @param rState  the model's state variables at steady state
+     */
+    void Store(const std::vector<double>& rParameters, const std::vector<double>& rState);
+
+    /**
+     * @return the index of the stored parameter set nearest (in Euclidean distance) to the given one
+     * @param rParameters  the parameter set
+     */
+    unsigned GetNearestIndex(const std::vector<double>& rParameters) const;
+
+    /**
+     * Set the state variables of a cell model to the stored steady state whose parameter
+     * set is nearest to the given one. The model is left unchanged if the cache is empty.
+     *
+     * @param rParameters  the parameter set the model is about to be run with
+     * @param rCell  the cell model
+     * @return whether a stored state was applied
+     */
+    bool ApplyNearest(const std::vector<double>& rParameters, AbstractCardiacCellInterface& rCell) const;
+
+    /**
+     * @return the number of stored steady states
+     */
+    unsigned GetNumSnapshots() const;
+
+    /**
+     * Remove all the stored steady states.
+     */
+    void Clear();
+
+#ifdef CHASTE_CVODE
+    /**
+     * Run a model to steady state with SteadyStateRunner, starting from the nearest stored
+     * steady state if there is one, and store the result.
+     *
+     * @param rParameters  the parameter set the model has been set up with
+     * @param pModel  the cell model, with its parameters and regular stimulus already set
+     * @param maxNumPaces  the maximum number of paces to run for
+     * @return whether the model reached steady state
+     */
+    bool RunToSteadyState(const std::vector<double>& rParameters,
+                          boost::shared_ptr<AbstractCvodeCell> pModel,
+                          unsigned maxNumPaces=10000u);
+#endif // CHASTE_CVODE
+};
+
+#endif // _STEADYSTATESNAPSHOTCACHE_HPP_
@@ -38,6 +38,8 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <vector>
 
+#include "SingleVariableOdeSolutionSink.hpp"
+
 /**
  * Class to calculate various physiological properties from the results of a
  * cardiac simulation.
@@ -147,6 +149,23 @@ public:
         CalculateProperties();
     }
 
+    /**
+     * Constructor which uses a voltage trace recorded while solving a cell model, so that
+     * the full solution never needs to be stored. The trace must outlive this object.
+     *
+     * @param rVoltageTrace  a sink which recorded the voltage when solving the cell model
+     * @param threshold is the threshold for determining if an AP started, defaults to -30
+     */
+    CellProperties(const SingleVariableOdeSolutionSink& rVoltageTrace,
+                   double threshold = -30.0)
+            : mrVoltage(rVoltageTrace.rGetValues()),
+              mrTime(rVoltageTrace.rGetTimes()),
+              mUnfinishedActionPotentials(false),
+              mThreshold(threshold)
+    {
+        CalculateProperties();
+    }
+
     /**
      * Returns the maximum upstroke velocity for all APs.
      *
@@ -39,95 +39,68 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "HeartConfig.hpp"
 #include "PetscTools.hpp"
 #include "Exception.hpp"
-#include "ReplicatableVector.hpp"
-#include "DistributedVector.hpp"
-#include "DistributedVectorFactory.hpp"
 #include "Version.hpp"
 #include "GenericMeshReader.hpp"
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void Hdf5ToCmguiConverter<ELEMENT_DIM,SPACE_DIM>::Write(std::string type)
 {
-    out_stream p_file = out_stream(NULL);
-
     unsigned num_nodes = this->mpReader->GetNumberOfRows();
-    unsigned num_timesteps = this->mpReader->GetUnlimitedDimensionValues().size();
-
-    DistributedVectorFactory factory(num_nodes);
+    std::vector<std::string> variable_names = this->mpReader->GetVariableNames();
+    unsigned num_vars = variable_names.size();
 
-    Vec data = factory.CreateVec();//for V
-    Vec data_phie = factory.CreateVec();//for phi_e
-    Vec data_second_cell = factory.CreateVec();//for the V of the second cell, used in extended bidomain problems.
+    // There is one file per time step, so each process converts its own share of the time steps
+    // for the whole mesh, reading a chunk's worth of them at a time
+    unsigned lo, hi;
+    this->GetLocalTimestepRange(lo, hi);
 
-    for (unsigned time_step=0; time_step<num_timesteps; time_step++)
+    Hdf5DataBlock block;
+    unsigned end_of_block = lo;
+    for (unsigned time_step=lo; time_step<hi; time_step++)
     {
+        if (time_step == end_of_block)
+        {
+            end_of_block += this->ReadWholeTimestepBlock(time_step, hi, block);
+        }
+
         // Create the file for this time step
         std::stringstream time_step_string;
 
         // unsigned to string
         time_step_string << time_step;
-        if (PetscTools::AmMaster())
-        {
-            p_file = this->mpOutputFileHandler->OpenOutputFile(this->mFileBaseName + "_" + time_step_string.str() + ".exnode");
+        out_stream p_file = this->mpOutputFileHandler->OpenOutputFile(this->mFileBaseName + "_" + time_step_string.str() + ".exnode");
 
-            // Check how many digits are to be output in the solution (0 goes to default value of digits)
-            if (this->mPrecision != 0)
-            {
-               p_file->precision(this->mPrecision);
-            }
+        // Check how many digits are to be output in the solution (0 goes to default value of digits)
+        if (this->mPrecision != 0)
+        {
+           p_file->precision(this->mPrecision);
         }
 
-        std::vector<ReplicatableVector*> all_data;
-        unsigned num_vars = this->mpReader->GetVariableNames().size();
+        // Write provenance info
+        std::string comment = "! " + ChasteBuildInfo::GetProvenanceString();
+        *p_file << comment;
+        // The header first
+        *p_file << "Group name: " << this->mFileBaseName << "\n";
+        *p_file << "#Fields=" << num_vars << "\n";
         for (unsigned var=0; var<num_vars; var++)
         {
-            // Read the data for this time step
-            this->mpReader->GetVariableOverNodes(data, this->mpReader->GetVariableNames()[var], time_step);
-            ReplicatableVector* p_repl_data = new ReplicatableVector(data);
-            assert(p_repl_data->GetSize()==num_nodes);
-            all_data.push_back(p_repl_data);
+            *p_file << " " << var+1 << ") " << variable_names[var] << " , field, rectangular cartesian, #Components=1" << "\n" << "x.  Value index=1, #Derivatives=0, #Versions=1"<<"\n";
+            if (var != num_vars-1)
+            {
+                *p_file << "\n";
+            }
         }
 
-        if (PetscTools::AmMaster())
+        // Write the data
+        for (unsigned i=0; i<num_nodes; i++)
         {
-            // Write provenance info
-            std::string comment = "! " + ChasteBuildInfo::GetProvenanceString();
-            *p_file << comment;
-            // The header first
-            *p_file << "Group name: " << this->mFileBaseName << "\n";
-            *p_file << "#Fields=" << num_vars << "\n";
+            // cmgui counts nodes from 1
+            *p_file << "Node: "<< i+1 << "\n";
             for (unsigned var=0; var<num_vars; var++)
             {
-                *p_file << " " << var+1 << ") " <<this->mpReader->GetVariableNames()[var]<< " , field, rectangular cartesian, #Components=1" << "\n" << "x.  Value index=1, #Derivatives=0, #Versions=1"<<"\n";
-                if (var != num_vars-1)
-                {
-                    *p_file << "\n";
-                }
-            }
-
-            // Write the data
-            for (unsigned i=0; i<num_nodes; i++)
-            {
-                // cmgui counts nodes from 1
-                *p_file << "Node: "<< i+1 << "\n";
-                for (unsigned var=0; var<num_vars; var++)
-                {
-                    *p_file  << (*(all_data[var]))[i] << "\n";
-                }
+                *p_file << block.GetValue(time_step, i, var) << "\n";
             }
         }
-
-        for (unsigned var=0; var<num_vars; var++)
-        {
-           delete all_data[var];
-        }
-    }
-    PetscTools::Destroy(data);
-    PetscTools::Destroy(data_phie);
-    PetscTools::Destroy(data_second_cell);
-
-    if (PetscTools::AmMaster())
-    {
         p_file->close();
     }
 }
@@ -190,7 +163,7 @@ Hdf5ToCmguiConverter<ELEMENT_DIM,SPACE_DIM>::Hdf5ToCmguiConverter(const FileFind
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void Hdf5ToCmguiConverter<ELEMENT_DIM,SPACE_DIM>::WriteCmguiScript()
 {
-    unsigned num_timesteps = this->mpReader->GetUnlimitedDimensionValues().size();
+    unsigned num_timesteps = this->mTimeValues.size();
     assert(this->mpReader->GetVariableNames().size() > 0); // seg fault guard
     std::string variable_name = this->mpReader->GetVariableNames()[0];
 
@@ -215,7 +215,7 @@ void PostProcessingWriter<ELEMENT_DIM, SPACE_DIM>::WriteOutputDataToHdf5(const s
     }
 
     unsigned max_paces = 0u;
-    MPI_Allreduce(&local_max_paces, &max_paces, 1, MPI_UNSIGNED, MPI_MAX, PETSC_COMM_WORLD);
+    MPI_Allreduce(&local_max_paces, &max_paces, 1, MPI_UNSIGNED, MPI_MAX, PetscTools::GetWorld());
 
     for (unsigned pace_idx = 0; pace_idx < max_paces; pace_idx++)
     {
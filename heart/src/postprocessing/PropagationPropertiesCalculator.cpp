@@ -37,6 +37,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "PropagationPropertiesCalculator.hpp"
 #include "CellProperties.hpp"
 #include "Exception.hpp"
+#include <algorithm>
 #include <sstream>
 #include "HeartEventHandler.hpp"
 
@@ -74,6 +75,42 @@ std::vector<double> PropagationPropertiesCalculator::CalculateUpstrokeTimes(unsi
     return cell_props.GetTimesAtMaxUpstrokeVelocity();
 }
 
+std::vector<std::vector<double> > PropagationPropertiesCalculator::CalculateActivationTimesForNodeRange(double threshold,
+                                                                                                      unsigned lowerNodeIndex,
+                                                                                                      unsigned upperNodeIndex)
+{
+    std::vector<std::string> variable_names = mpDataReader->GetVariableNames();
+    unsigned voltage_index = std::find(variable_names.begin(), variable_names.end(), mVoltageName) - variable_names.begin();
+    if (voltage_index == variable_names.size())
+    {
+        EXCEPTION("The data file does not contain data for variable " << mVoltageName);
+    }
+
+    std::vector<std::vector<double> > activation_times(upperNodeIndex-lowerNodeIndex);
+    std::vector<double> previous_voltages(upperNodeIndex-lowerNodeIndex);
+
+    Hdf5DataBlock block;
+    mpDataReader->BeginBlockIteration(lowerNodeIndex, upperNodeIndex);
+    while (mpDataReader->GetNextBlock(block))
+    {
+        for (unsigned time_step=block.mFirstTimestep; time_step<block.mFirstTimestep+block.mNumTimesteps; time_step++)
+        {
+            for (unsigned node_index=block.mLowerNode; node_index<block.mUpperNode; node_index++)
+            {
+                double voltage = block.GetValue(time_step, node_index, voltage_index);
+                double& r_previous_voltage = previous_voltages[node_index-lowerNodeIndex];
+                if (time_step > 0 && r_previous_voltage < threshold && voltage >= threshold)
+                {
+                    double fraction = (threshold - r_previous_voltage)/(voltage - r_previous_voltage);
+                    activation_times[node_index-lowerNodeIndex].push_back(mTimes[time_step-1] + fraction*(mTimes[time_step]-mTimes[time_step-1]));
+                }
+                r_previous_voltage = voltage;
+            }
+        }
+    }
+    return activation_times;
+}
+
 double PropagationPropertiesCalculator::CalculateActionPotentialDuration(const double percentage,
                                                                          unsigned globalNodeIndex)
 {
@@ -116,6 +116,23 @@ public:
      */
     std::vector<double> CalculateUpstrokeTimes(unsigned globalNodeIndex, double threshold);
 
+    /**
+     * @return the activation times (upward crossings of the threshold, linearly
+     * interpolated between samples) for each node in a range.
+     *
+     * Unlike CalculateUpstrokeTimes(), which reads the whole trace at each node,
+     * this streams through the data file once in chunk-sized blocks keeping only
+     * the previous sample at each node, so it is suitable for whole-mesh activation maps.
+     * A node that never crosses the threshold gets an empty vector.
+     *
+     * @param threshold  The voltage threshold counted as activation
+     * @param lowerNodeIndex  The first node at which to calculate
+     * @param upperNodeIndex  One past the last node at which to calculate
+     */
+    std::vector<std::vector<double> > CalculateActivationTimesForNodeRange(double threshold,
+                                                                           unsigned lowerNodeIndex,
+                                                                           unsigned upperNodeIndex);
+
     /**
      * @return the conduction velocity between two cells, i.e. the time
      * taken for an AP to propagate from one to the other. It returns
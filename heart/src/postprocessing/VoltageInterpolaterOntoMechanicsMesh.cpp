@@ -36,7 +36,6 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "VoltageInterpolaterOntoMechanicsMesh.hpp"
 #include "Hdf5ToCmguiConverter.hpp"
 #include "FineCoarseMeshPair.hpp"
-#include "ReplicatableVector.hpp"
 #include "HeartConfig.hpp"
 #include "Hdf5DataReader.hpp"
 #include "PetscTools.hpp"
@@ -82,11 +81,31 @@ VoltageInterpolaterOntoMechanicsMesh<DIM>::VoltageInterpolaterOntoMechanicsMesh(
 
     assert(columns_id.size() == rVariableNames.size());
 
-    // set up a vector to read into
+    // The interpolation is linear, so it is applied as a sparse matrix, with a row for each
+    // mechanics node holding the weights of the nodes of the electrics element containing it.
+    // Both vectors then stay distributed: there is no need to replicate the electrics data.
     DistributedVectorFactory factory(rElectricsMesh.GetNumNodes());
+    DistributedVectorFactory* p_mechanics_factory = rMechanicsMesh.GetDistributedVectorFactory();
+    Mat interpolation_matrix;
+    PetscTools::SetupMat(interpolation_matrix,
+                         rMechanicsMesh.GetNumNodes(), rElectricsMesh.GetNumNodes(),
+                         DIM+1,
+                         p_mechanics_factory->GetLocalOwnership(), factory.GetLocalOwnership());
+    for (unsigned i=p_mechanics_factory->GetLow(); i<p_mechanics_factory->GetHigh(); i++)
+    {
+        Element<DIM,DIM>& element = *(rElectricsMesh.GetElement(mesh_pair.rGetElementsAndWeights()[i].ElementNum));
+        for (unsigned node_index = 0; node_index<element.GetNumNodes(); node_index++)
+        {
+            MatSetValue(interpolation_matrix, i, element.GetNodeGlobalIndex(node_index),
+                        mesh_pair.rGetElementsAndWeights()[i].Weights(node_index), ADD_VALUES);
+        }
+    }
+    MatAssemblyBegin(interpolation_matrix, MAT_FINAL_ASSEMBLY);
+    MatAssemblyEnd(interpolation_matrix, MAT_FINAL_ASSEMBLY);
+
+    // set up vectors to read into and interpolate into
     Vec voltage = factory.CreateVec();
-    std::vector<double> interpolated_voltages(rMechanicsMesh.GetNumNodes());
-    Vec voltage_coarse = NULL;
+    Vec voltage_coarse = p_mechanics_factory->CreateVec();
 
     for (unsigned time_step=0; time_step<num_timesteps; time_step++)
     {
@@ -95,28 +114,10 @@ VoltageInterpolaterOntoMechanicsMesh<DIM>::VoltageInterpolaterOntoMechanicsMesh(
             std::string var_name = rVariableNames[var_index];
             // read
             reader.GetVariableOverNodes(voltage, var_name, time_step);
-            ReplicatableVector voltage_repl(voltage);
 
             // interpolate
-            for (unsigned i=0; i<mesh_pair.rGetElementsAndWeights().size(); i++)
-            {
-                double interpolated_voltage = 0;
-
-                Element<DIM,DIM>& element = *(rElectricsMesh.GetElement(mesh_pair.rGetElementsAndWeights()[i].ElementNum));
-                for (unsigned node_index = 0; node_index<element.GetNumNodes(); node_index++)
-                {
-                    unsigned global_node_index = element.GetNodeGlobalIndex(node_index);
-                    interpolated_voltage += voltage_repl[global_node_index]*mesh_pair.rGetElementsAndWeights()[i].Weights(node_index);
-                }
-
-                interpolated_voltages[i] = interpolated_voltage;
-            }
-
-            if (voltage_coarse != NULL)
-            {
-                PetscTools::Destroy(voltage_coarse);
-            }
-            voltage_coarse = PetscTools::CreateVec(interpolated_voltages);
+            MatMult(interpolation_matrix, voltage, voltage_coarse);
+
             // write
             p_writer->PutVector(columns_id[var_index], voltage_coarse);
         }
@@ -124,11 +125,9 @@ VoltageInterpolaterOntoMechanicsMesh<DIM>::VoltageInterpolaterOntoMechanicsMesh(
         p_writer->AdvanceAlongUnlimitedDimension();
     }
 
-    if (voltage_coarse != NULL)
-    {
-        PetscTools::Destroy(voltage);
-        PetscTools::Destroy(voltage_coarse);
-    }
+    PetscTools::Destroy(voltage);
+    PetscTools::Destroy(voltage_coarse);
+    PetscTools::Destroy(interpolation_matrix);
 
     // delete to flush
     delete p_writer;
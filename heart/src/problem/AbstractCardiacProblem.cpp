@@ -46,7 +46,9 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "DistributedVector.hpp"
 #include "ProgressReporter.hpp"
 #include "LinearSystem.hpp"
+#include "MemoryAccounting.hpp"
 #include "PostProcessingWriter.hpp"
+#include "DecimatedOutputModifier.hpp"
 #include "Hdf5ToMeshalyzerConverter.hpp"
 #include "Hdf5ToCmguiConverter.hpp"
 #include "Hdf5ToVtkConverter.hpp"
@@ -69,6 +71,7 @@ AbstractCardiacProblem<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
         mpTimeAdaptivityController(nullptr),
         mpWriter(nullptr),
         mUseHdf5DataWriterCache(false),
+        mUseHdf5DataWriterAsynchronousWrites(false),
         mHdf5DataWriterChunkSizeAndAlignment(0)
 {
   assert(mNodesToOutput.empty());
@@ -100,6 +103,7 @@ AbstractCardiacProblem<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
         mpTimeAdaptivityController(nullptr),
         mpWriter(nullptr),
         mUseHdf5DataWriterCache(false),
+        mUseHdf5DataWriterAsynchronousWrites(false),
         mHdf5DataWriterChunkSizeAndAlignment(0)
 {}
 
@@ -246,6 +250,17 @@ void AbstractCardiacProblem<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
     }
   }
 
+  // Only the implicit, matrix-based monodomain solver condenses the
+  // switched off tissue out of its linear system
+  if (mpCardiacTissue->HasInactiveRegions() &&
+      (PROBLEM_DIM != 1 ||
+       HeartConfig::Instance()->GetUseExplicitMonodomainSolver() ||
+       HeartConfig::Instance()->GetUseReactionDiffusionOperatorSplitting() ||
+       HeartConfig::Instance()->GetUseMatrixFreeOperators())) {
+    EXCEPTION("Inactive tissue regions are only supported by the implicit "
+        "monodomain solver with assembled matrices");
+  }
+
   auto end_time = HeartConfig::Instance()->GetSimulationDuration();
   auto pde_time = HeartConfig::Instance()->GetPdeTimeStep();
 
@@ -339,6 +354,15 @@ double AbstractCardiacProblem<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
   return mCurrentTime;
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
+void AbstractCardiacProblem<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
+    SetSolution(Vec solution, double currentTime)
+{
+  if (mSolution && mSolution != solution) PetscTools::Destroy(mSolution);
+  mSolution = solution;
+  mCurrentTime = currentTime;
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
 AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>&
     AbstractCardiacProblem<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::rGetMesh()
@@ -457,7 +481,17 @@ void AbstractCardiacProblem<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::Solve()
   else {
     progress_reporter_dir = "";  // progress printed to CHASTE_TEST_OUTPUT
   }
-  for (auto p_output_modifier : mOutputModifiers) {
+  // Modifiers requested through HeartConfig are not archived with the user-defined ones
+  std::vector<boost::shared_ptr<AbstractOutputModifier>> output_modifiers =
+      mOutputModifiers;
+  if (HeartConfig::Instance()->IsLatticeOutputRequested() ||
+      HeartConfig::Instance()->IsProbeOutputRequested()) {
+    if (!mpDecimatedOutputModifier) {
+      mpDecimatedOutputModifier = CreateDecimatedOutputModifier();
+    }
+    output_modifiers.push_back(mpDecimatedOutputModifier);
+  }
+  for (auto p_output_modifier : output_modifiers) {
     p_output_modifier->InitialiseAtStart(
         this->mpMesh->GetDistributedVectorFactory());
     p_output_modifier->ProcessSolutionAtTimeStep(stepper.GetTime(),
@@ -532,6 +566,9 @@ void AbstractCardiacProblem<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::Solve()
     // Initial condition for next loop is current solution
     initial_condition = mSolution;
 
+    // Record the peak memory use while the solver and its linear system are alive
+    MemoryAccounting::Sample();
+
     // Update the current time
     stepper.AdvanceOneTimeStep();
     mCurrentTime = stepper.GetTime();
@@ -543,7 +580,7 @@ void AbstractCardiacProblem<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::Solve()
       HeartEventHandler::EndEvent(HeartEventHandler::WRITE_OUTPUT);
     }
 
-    for (auto p_output_modifier : mOutputModifiers) {
+    for (auto p_output_modifier : output_modifiers) {
       p_output_modifier->ProcessSolutionAtTimeStep(stepper.GetTime(),
           mSolution, PROBLEM_DIM);
     }
@@ -569,13 +606,45 @@ void AbstractCardiacProblem<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::Solve()
 
   // Close the file that stores voltage values
   progress_reporter.PrintFinalising();
-  for (auto p_output_modifier : mOutputModifiers) {
+  for (auto p_output_modifier : output_modifiers) {
     p_output_modifier->FinaliseAtEnd();
   }
   CloseFilesAndPostProcess();
   HeartEventHandler::EndEvent(HeartEventHandler::EVERYTHING);
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
+boost::shared_ptr<AbstractOutputModifier>
+AbstractCardiacProblem<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
+    CreateDecimatedOutputModifier()
+{
+  boost::shared_ptr<DecimatedOutputModifier<ELEMENT_DIM, SPACE_DIM>>
+      p_modifier(new DecimatedOutputModifier<ELEMENT_DIM, SPACE_DIM>(
+          HeartConfig::Instance()->GetOutputFilenamePrefix(), *mpMesh));
+
+  if (HeartConfig::Instance()->IsLatticeOutputRequested()) {
+    c_vector<double, 3> lower_corner;
+    c_vector<double, 3> upper_corner;
+    double spacing;
+    double output_period;
+    HeartConfig::Instance()->GetLatticeOutput(lower_corner, upper_corner,
+        spacing, output_period);
+    c_vector<double, SPACE_DIM> lower;
+    c_vector<double, SPACE_DIM> upper;
+    for (unsigned dim = 0; dim < SPACE_DIM; ++dim) {
+      lower(dim) = lower_corner(dim);
+      upper(dim) = upper_corner(dim);
+    }
+    p_modifier->SetLattice(lower, upper, spacing, output_period);
+  }
+
+  std::vector<unsigned> probe_nodes;
+  HeartConfig::Instance()->GetProbeOutputNodes(probe_nodes);
+  p_modifier->SetProbeNodes(probe_nodes);
+
+  return p_modifier;
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
 void AbstractCardiacProblem<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
     CloseFilesAndPostProcess()
@@ -868,6 +937,10 @@ bool AbstractCardiacProblem<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
     mpWriter->SetAlignment(mHdf5DataWriterChunkSizeAndAlignment);
   }
 
+  if (mUseHdf5DataWriterCache && mUseHdf5DataWriterAsynchronousWrites) {
+    mpWriter->SetUseAsynchronousWrites();
+  }
+
   // Define columns, or get the variable IDs from the writer
   DefineWriterColumns(extend_file);
 
@@ -892,6 +965,13 @@ void AbstractCardiacProblem<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
   mUseHdf5DataWriterCache = useCache;
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
+void AbstractCardiacProblem<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
+    SetUseHdf5DataWriterAsynchronousWrites(bool useAsynchronousWrites)
+{
+  mUseHdf5DataWriterAsynchronousWrites = useAsynchronousWrites;
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
 void AbstractCardiacProblem<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
     SetHdf5DataWriterTargetChunkSizeAndAlignment(hsize_t size)
@@ -220,6 +220,10 @@ class AbstractCardiacProblem : public AbstractUntemplatedCardiacProblem
       archive & mUseHdf5DataWriterCache;
       archive & mHdf5DataWriterChunkSizeAndAlignment;
     }
+
+    if (version >= 5) {
+      archive & mUseHdf5DataWriterAsynchronousWrites;
+    }
   }
 
   /**
@@ -367,6 +371,10 @@ class AbstractCardiacProblem : public AbstractUntemplatedCardiacProblem
       archive & mUseHdf5DataWriterCache;
       archive & mHdf5DataWriterChunkSizeAndAlignment;
     }
+
+    if (version >= 5) {
+      archive & mUseHdf5DataWriterAsynchronousWrites;
+    }
   }
 
   BOOST_SERIALIZATION_SPLIT_MEMBER()
@@ -537,6 +545,12 @@ class AbstractCardiacProblem : public AbstractUntemplatedCardiacProblem
    */
   bool mUseHdf5DataWriterCache;
 
+  /**
+   * Whether to instruct the writer to write its cache to disk in a
+   * background thread.
+   */
+  bool mUseHdf5DataWriterAsynchronousWrites;
+
   /**
    * Size to pass to Hdf5DataWriter for chunk size and alignment.
    */
@@ -548,6 +562,18 @@ class AbstractCardiacProblem : public AbstractUntemplatedCardiacProblem
    */
   std::vector<boost::shared_ptr<AbstractOutputModifier>> mOutputModifiers;
 
+  /**
+   * The output modifier for lattice and probe output requested through
+   * HeartConfig (see HeartConfig::SetLatticeOutput()). Created on the first
+   * Solve() which needs it, and not archived.
+   */
+  boost::shared_ptr<AbstractOutputModifier> mpDecimatedOutputModifier;
+
+  /**
+   * @return a DecimatedOutputModifier set up from HeartConfig.
+   */
+  boost::shared_ptr<AbstractOutputModifier> CreateDecimatedOutputModifier();
+
  public:
   /**
    * Constructor
@@ -663,6 +689,16 @@ class AbstractCardiacProblem : public AbstractUntemplatedCardiacProblem
    */
   double GetCurrentTime();
 
+  /**
+   * Restart the simulation from the given solution at the given time, so
+   * that the next call to Solve() continues from there. The cells are not
+   * changed. The problem takes ownership of the vector.
+   *
+   * @param solution  the new solution, laid out as GetSolution()
+   * @param currentTime  the time of the new solution
+   */
+  void SetSolution(Vec solution, double currentTime);
+
   /**
    * @return the mesh used
    */
@@ -756,6 +792,18 @@ class AbstractCardiacProblem : public AbstractUntemplatedCardiacProblem
    */
   void SetUseHdf5DataWriterCache(bool useCache = true);
 
+  /**
+   * Set whether the Hdf5DataWriter cache is written to disk by a
+   * background thread, so that the solve continues while output is
+   * flushed to the file system. Only has an effect when caching is also
+   * enabled (see SetUseHdf5DataWriterCache()) and MPI supports
+   * MPI_THREAD_MULTIPLE; see Hdf5DataWriter::SetUseAsynchronousWrites().
+   *
+   * @param useAsynchronousWrites  Whether to write asynchronously
+   */
+  void SetUseHdf5DataWriterAsynchronousWrites(
+      bool useAsynchronousWrites = true);
+
   /**
    * Set Hdf5DataWriter target chunk size and alignment parameters.
    *
@@ -988,7 +1036,7 @@ struct version<AbstractCardiacProblem<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>>
 {
   // Macro to set the version number of templated archive in known
   // versions of Boost
-  CHASTE_VERSION_CONTENT(4);
+  CHASTE_VERSION_CONTENT(5);
 };
 }  // namespace serialization
 }  // namespace boost
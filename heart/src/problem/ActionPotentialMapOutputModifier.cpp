@@ -0,0 +1,318 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#include "ActionPotentialMapOutputModifier.hpp"
+
+#include "DistributedVector.hpp"
+#include "HeartConfig.hpp"
+#include "LinearBasisFunction.hpp"
+#include "PetscTools.hpp"
+#include "ReplicatableVector.hpp"
+#include "UblasCustomFunctions.hpp"
+
+/** Value used to mark missing data, as in PostProcessingWriter */
+static const double MISSING_DATA = -999.0;
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+ActionPotentialMapOutputModifier<ELEMENT_DIM, SPACE_DIM>::ActionPotentialMapOutputModifier(const std::string& rFilename,
+                                                                                           AbstractTetrahedralMesh<ELEMENT_DIM,SPACE_DIM>& rMesh,
+                                                                                           double threshold,
+                                                                                           double repolarisationPercentage)
+    : AbstractOutputModifier(rFilename),
+      mrMesh(rMesh),
+      mThreshold(threshold),
+      mRepolarisationPercentage(repolarisationPercentage),
+      mpVectorFactory(nullptr),
+      mLocalSize(0u),
+      mHavePreviousStep(false),
+      mPreviousTime(0.0)
+{
+    assert(ELEMENT_DIM == SPACE_DIM); // LCOV_EXCL_LINE
+    assert(mRepolarisationPercentage > 0.0 && mRepolarisationPercentage < 100.0);
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void ActionPotentialMapOutputModifier<ELEMENT_DIM, SPACE_DIM>::InitialiseAtStart(DistributedVectorFactory* pVectorFactory)
+{
+    mpVectorFactory = pVectorFactory;
+    if (mLocalSize == pVectorFactory->GetLocalOwnership() && mHavePreviousStep)
+    {
+        // Carry on from a previous Solve() call
+        return;
+    }
+
+    mLocalSize = pVectorFactory->GetLocalOwnership();
+    mHavePreviousStep = false;
+    mPreviousVoltages.assign(mLocalSize, 0.0);
+    mIsDepolarised.assign(mLocalSize, false);
+    mMinimumVoltages.assign(mLocalSize, 0.0);
+    mPeakVoltages.assign(mLocalSize, 0.0);
+    mMaxVelocitiesSinceRepolarisation.assign(mLocalSize, 0.0);
+    mUpstrokeTimes.assign(mLocalSize, std::vector<double>());
+    mApds.assign(mLocalSize, std::vector<double>());
+    mMaxUpstrokeVelocities.assign(mLocalSize, std::vector<double>());
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void ActionPotentialMapOutputModifier<ELEMENT_DIM, SPACE_DIM>::ProcessSolutionAtTimeStep(double time, Vec solution, unsigned problemDim)
+{
+    if (mHavePreviousStep && time <= mPreviousTime)
+    {
+        // The initial condition of a later Solve() call has already been seen
+        return;
+    }
+
+    double* p_solution;
+    VecGetArray(solution, &p_solution);
+
+    if (!mHavePreviousStep)
+    {
+        for (unsigned local_index=0; local_index<mLocalSize; local_index++)
+        {
+            mPreviousVoltages[local_index] = p_solution[local_index*problemDim];
+            mMinimumVoltages[local_index] = mPreviousVoltages[local_index];
+        }
+    }
+    else
+    {
+        const double dt = time - mPreviousTime;
+        for (unsigned local_index=0; local_index<mLocalSize; local_index++)
+        {
+            const double v = p_solution[local_index*problemDim];
+            const double v_previous = mPreviousVoltages[local_index];
+            const double dv_dt = (v - v_previous)/dt;
+
+            if (!mIsDepolarised[local_index])
+            {
+                mMinimumVoltages[local_index] = std::min(mMinimumVoltages[local_index], v);
+                mMaxVelocitiesSinceRepolarisation[local_index] = std::max(mMaxVelocitiesSinceRepolarisation[local_index], dv_dt);
+
+                if (v_previous < mThreshold && v >= mThreshold)
+                {
+                    // Upstroke
+                    double upstroke_time = mPreviousTime + dt*(mThreshold - v_previous)/(v - v_previous);
+                    mUpstrokeTimes[local_index].push_back(upstroke_time);
+                    mMaxUpstrokeVelocities[local_index].push_back(mMaxVelocitiesSinceRepolarisation[local_index]);
+                    mPeakVoltages[local_index] = v;
+                    mIsDepolarised[local_index] = true;
+                }
+            }
+            else if (v > mPeakVoltages[local_index])
+            {
+                // Still on the upstroke
+                mPeakVoltages[local_index] = v;
+                mMaxUpstrokeVelocities[local_index].back() = std::max(mMaxUpstrokeVelocities[local_index].back(), dv_dt);
+            }
+            else
+            {
+                double repolarisation_voltage = mPeakVoltages[local_index]
+                    - 0.01*mRepolarisationPercentage*(mPeakVoltages[local_index] - mMinimumVoltages[local_index]);
+                if (v_previous > repolarisation_voltage && v <= repolarisation_voltage)
+                {
+                    // Repolarisation
+                    double repolarisation_time = mPreviousTime + dt*(repolarisation_voltage - v_previous)/(v - v_previous);
+                    mApds[local_index].push_back(repolarisation_time - mUpstrokeTimes[local_index].back());
+                    mIsDepolarised[local_index] = false;
+                    mMinimumVoltages[local_index] = v;
+                    mMaxVelocitiesSinceRepolarisation[local_index] = 0.0;
+                }
+            }
+            mPreviousVoltages[local_index] = v;
+        }
+    }
+
+    VecRestoreArray(solution, &p_solution);
+    mPreviousTime = time;
+    mHavePreviousStep = true;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+std::vector<double> ActionPotentialMapOutputModifier<ELEMENT_DIM, SPACE_DIM>::CalculateConductionVelocities(unsigned paceIndex)
+{
+    // Neighbouring upstroke times may live on other processes
+    Vec upstroke_times = mpVectorFactory->CreateVec();
+    DistributedVector distributed_times = mpVectorFactory->CreateDistributedVector(upstroke_times);
+    for (DistributedVector::Iterator index = distributed_times.Begin();
+         index != distributed_times.End();
+         ++index)
+    {
+        const std::vector<double>& r_times = mUpstrokeTimes[index.Local];
+        distributed_times[index] = paceIndex < r_times.size() ? r_times[paceIndex] : MISSING_DATA;
+    }
+    distributed_times.Restore();
+    ReplicatableVector times_replicated(upstroke_times);
+    PetscTools::Destroy(upstroke_times);
+
+    std::vector<double> conduction_velocities(mLocalSize, MISSING_DATA);
+    const unsigned lo = mpVectorFactory->GetLow();
+    for (unsigned local_index=0; local_index<mLocalSize; local_index++)
+    {
+        Node<SPACE_DIM>* p_node = mrMesh.GetNode(lo + local_index);
+        double sum_of_velocities = 0.0;
+        unsigned num_elements_used = 0u;
+        for (typename Node<SPACE_DIM>::ContainingElementIterator iter = p_node->ContainingElementsBegin();
+             iter != p_node->ContainingElementsEnd();
+             ++iter)
+        {
+            Element<ELEMENT_DIM, SPACE_DIM>* p_element = mrMesh.GetElement(*iter);
+
+            c_vector<double, ELEMENT_DIM+1> element_times;
+            bool all_activated = true;
+            for (unsigned i=0; i<ELEMENT_DIM+1; i++)
+            {
+                element_times(i) = times_replicated[p_element->GetNodeGlobalIndex(i)];
+                all_activated = all_activated && (element_times(i) != MISSING_DATA);
+            }
+            if (!all_activated)
+            {
+                continue;
+            }
+
+            // Times are linear on the element, so the gradient is constant
+            double jacobian_determinant;
+            c_matrix<double, SPACE_DIM, ELEMENT_DIM> jacobian;
+            c_matrix<double, ELEMENT_DIM, SPACE_DIM> inverse_jacobian;
+            p_element->CalculateInverseJacobian(jacobian, jacobian_determinant, inverse_jacobian);
+            c_matrix<double, ELEMENT_DIM, ELEMENT_DIM+1> grad_phi;
+            LinearBasisFunction<ELEMENT_DIM>::ComputeTransformedBasisFunctionDerivatives(ChastePoint<ELEMENT_DIM>(), inverse_jacobian, grad_phi);
+            double norm_grad_time = norm_2(prod(grad_phi, element_times));
+
+            if (norm_grad_time > DBL_EPSILON)
+            {
+                sum_of_velocities += 1.0/norm_grad_time;
+                num_elements_used++;
+            }
+        }
+        if (num_elements_used > 0u)
+        {
+            conduction_velocities[local_index] = sum_of_velocities/num_elements_used;
+        }
+    }
+    return conduction_velocities;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void ActionPotentialMapOutputModifier<ELEMENT_DIM, SPACE_DIM>::FinaliseAtEnd()
+{
+    unsigned local_max_paces = 0u;
+    for (unsigned local_index=0; local_index<mLocalSize; local_index++)
+    {
+        local_max_paces = std::max(local_max_paces, (unsigned) mUpstrokeTimes[local_index].size());
+    }
+    unsigned max_paces = 0u;
+    MPI_Allreduce(&local_max_paces, &max_paces, 1, MPI_UNSIGNED, MPI_MAX, PetscTools::GetWorld());
+
+    Hdf5DataWriter writer(*mpVectorFactory,
+                          HeartConfig::Instance()->GetOutputDirectory(),
+                          mFilename,
+                          false); // don't wipe the simulation output
+    int upstroke_time_id = writer.DefineVariable("UpstrokeTime", "msec");
+    int apd_id = writer.DefineVariable("Apd", "msec");
+    int upstroke_velocity_id = writer.DefineVariable("MaxUpstrokeVelocity", "mV_per_msec");
+    int conduction_velocity_id = writer.DefineVariable("ConductionVelocity", "cm_per_msec");
+    writer.DefineFixedDimension(mpVectorFactory->GetProblemSize());
+    writer.DefineUnlimitedDimension("PaceNumber", "dimensionless");
+    writer.ApplyPermutation(mrMesh.rGetNodePermutation());
+    writer.EndDefineMode();
+
+    for (unsigned pace_index=0; pace_index<max_paces; pace_index++)
+    {
+        std::vector<double> conduction_velocities = CalculateConductionVelocities(pace_index);
+
+        Vec upstroke_time_vec = mpVectorFactory->CreateVec();
+        Vec apd_vec = mpVectorFactory->CreateVec();
+        Vec upstroke_velocity_vec = mpVectorFactory->CreateVec();
+        Vec conduction_velocity_vec = mpVectorFactory->CreateVec();
+        DistributedVector upstroke_times = mpVectorFactory->CreateDistributedVector(upstroke_time_vec);
+        DistributedVector apds = mpVectorFactory->CreateDistributedVector(apd_vec);
+        DistributedVector upstroke_velocities = mpVectorFactory->CreateDistributedVector(upstroke_velocity_vec);
+        DistributedVector velocities = mpVectorFactory->CreateDistributedVector(conduction_velocity_vec);
+        for (DistributedVector::Iterator index = upstroke_times.Begin();
+             index != upstroke_times.End();
+             ++index)
+        {
+            const unsigned local_index = index.Local;
+            bool have_pace = pace_index < mUpstrokeTimes[local_index].size();
+            upstroke_times[index] = have_pace ? mUpstrokeTimes[local_index][pace_index] : MISSING_DATA;
+            upstroke_velocities[index] = have_pace ? mMaxUpstrokeVelocities[local_index][pace_index] : MISSING_DATA;
+            apds[index] = pace_index < mApds[local_index].size() ? mApds[local_index][pace_index] : MISSING_DATA;
+            velocities[index] = conduction_velocities[local_index];
+        }
+        upstroke_times.Restore();
+        apds.Restore();
+        upstroke_velocities.Restore();
+        velocities.Restore();
+
+        writer.PutVector(upstroke_time_id, upstroke_time_vec);
+        writer.PutVector(apd_id, apd_vec);
+        writer.PutVector(upstroke_velocity_id, upstroke_velocity_vec);
+        writer.PutVector(conduction_velocity_id, conduction_velocity_vec);
+        writer.PutUnlimitedVariable(pace_index);
+        writer.AdvanceAlongUnlimitedDimension();
+
+        PetscTools::Destroy(upstroke_time_vec);
+        PetscTools::Destroy(apd_vec);
+        PetscTools::Destroy(upstroke_velocity_vec);
+        PetscTools::Destroy(conduction_velocity_vec);
+    }
+    writer.Close();
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+const std::vector<double>& ActionPotentialMapOutputModifier<ELEMENT_DIM, SPACE_DIM>::rGetUpstrokeTimes(unsigned localIndex) const
+{
+    assert(localIndex < mLocalSize);
+    return mUpstrokeTimes[localIndex];
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+const std::vector<double>& ActionPotentialMapOutputModifier<ELEMENT_DIM, SPACE_DIM>::rGetApds(unsigned localIndex) const
+{
+    assert(localIndex < mLocalSize);
+    return mApds[localIndex];
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+const std::vector<double>& ActionPotentialMapOutputModifier<ELEMENT_DIM, SPACE_DIM>::rGetMaxUpstrokeVelocities(unsigned localIndex) const
+{
+    assert(localIndex < mLocalSize);
+    return mMaxUpstrokeVelocities[localIndex];
+}
+
+// Explicit instantiation
+template class ActionPotentialMapOutputModifier<1,1>;
+template class ActionPotentialMapOutputModifier<2,2>;
+template class ActionPotentialMapOutputModifier<3,3>;
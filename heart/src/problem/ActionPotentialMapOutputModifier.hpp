@@ -0,0 +1,154 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef ACTIONPOTENTIALMAPOUTPUTMODIFIER_HPP_
+#define ACTIONPOTENTIALMAPOUTPUTMODIFIER_HPP_
+
+#include <vector>
+
+#include "AbstractOutputModifier.hpp"
+#include "AbstractTetrahedralMesh.hpp"
+
+/**
+ * On-the-fly calculation of the maps usually produced by PostProcessingWriter, without needing
+ * to write (and re-read) the full transmembrane potential.
+ *
+ * Each local node runs a small state machine as the solution is produced.  For every action
+ * potential (any number of them) it records
+ *  - the upstroke time, at which V first crosses the threshold (linearly interpolated),
+ *  - the maximum upstroke velocity dV/dt, between the previous repolarisation and the peak,
+ *  - the action potential duration APDxx, from the upstroke time until V falls back to
+ *    peak - xx% * (peak - resting potential) (linearly interpolated), where the resting potential
+ *    is the minimum since the previous repolarisation.
+ * When the simulation ends, a conduction velocity is also computed for each upstroke from the
+ * neighbouring upstroke times, as the average of 1/|grad T| over the elements containing the node.
+ *
+ * The results are written once, in parallel, to the HDF5 file <filename>.h5 in the simulation output
+ * directory.  There are four variables ("UpstrokeTime", "Apd", "MaxUpstrokeVelocity" and
+ * "ConductionVelocity") and the unlimited dimension is the pace number.  As for PostProcessingWriter,
+ * missing data are marked with -999.
+ *
+ * WARNING:  This class holds a reference to the mesh and so cannot be checkpointed.
+ */
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+class ActionPotentialMapOutputModifier : public AbstractOutputModifier
+{
+private:
+    /** The mesh on which the simulation is solved (with the node ordering used at solve time). */
+    AbstractTetrahedralMesh<ELEMENT_DIM,SPACE_DIM>& mrMesh;
+
+    double mThreshold; /**< The transmembrane voltage threshold (in mV) defining an upstroke */
+    double mRepolarisationPercentage; /**< The xx in APDxx */
+
+    DistributedVectorFactory* mpVectorFactory; /**< The vector factory of the calling problem */
+    unsigned mLocalSize; /**< The number of nodes on this process (calculated in #InitialiseAtStart)*/
+
+    bool mHavePreviousStep; /**< Whether mPreviousTime and mPreviousVoltages hold a solution yet */
+    double mPreviousTime; /**< The time of the previous solution */
+    std::vector<double> mPreviousVoltages; /**< V at each local node at the previous solution */
+
+    std::vector<bool> mIsDepolarised; /**< Whether each local node is between an upstroke and repolarisation */
+    std::vector<double> mMinimumVoltages; /**< Minimum V at each local node since its last repolarisation */
+    std::vector<double> mPeakVoltages; /**< Peak V at each local node during the current action potential */
+    std::vector<double> mMaxVelocitiesSinceRepolarisation; /**< Maximum dV/dt at each local node since its last repolarisation */
+
+    std::vector<std::vector<double> > mUpstrokeTimes; /**< All upstroke times for each local node */
+    std::vector<std::vector<double> > mApds; /**< All completed APDs for each local node */
+    std::vector<std::vector<double> > mMaxUpstrokeVelocities; /**< All maximum upstroke velocities for each local node */
+
+    /**
+     * Compute conduction velocities at local nodes from the upstroke times of the given pace.
+     *
+     * @param paceIndex  which upstroke to use
+     * @return the conduction velocity at each local node, or -999 where it is not defined
+     */
+    std::vector<double> CalculateConductionVelocities(unsigned paceIndex);
+
+public:
+    /**
+     * Constructor
+     *
+     * @param rFilename  The base name of the HDF5 file produced by this modifier
+     * @param rMesh  The mesh on which the simulation is solved
+     * @param threshold  The transmembrane voltage threshold (in mV) at which an upstroke is deemed to have occurred
+     * @param repolarisationPercentage  The percentage repolarisation at which APDs are measured (defaults to 90)
+     */
+    ActionPotentialMapOutputModifier(const std::string& rFilename,
+                                     AbstractTetrahedralMesh<ELEMENT_DIM,SPACE_DIM>& rMesh,
+                                     double threshold,
+                                     double repolarisationPercentage=90.0);
+
+    /**
+     * Initialise the modifier (make space for local data) when the solve loop is starting.
+     * Data already gathered in an earlier Solve() call are kept.
+     *
+     * @param pVectorFactory  The vector factory which is associated with the calling problem's mesh
+     */
+    virtual void InitialiseAtStart(DistributedVectorFactory* pVectorFactory);
+
+    /**
+     * Finalise the modifier (compute conduction velocities and write all results to file)
+     */
+    virtual void FinaliseAtEnd();
+
+    /**
+     * Process a solution time-step (advance each node's state machine)
+     * @param time  The current simulation time
+     * @param solution  A working copy of the solution at the current time-step.  This is the PETSc vector which is distributed across the processes.
+     * @param problemDim  The calling problem dimension. Transmembrane potential is the first unknown at each node.
+     */
+    virtual void ProcessSolutionAtTimeStep(double time, Vec solution, unsigned problemDim);
+
+    /**
+     * @return the upstroke times recorded so far at a local node
+     * @param localIndex  the local index of the node
+     */
+    const std::vector<double>& rGetUpstrokeTimes(unsigned localIndex) const;
+
+    /**
+     * @return the APDs recorded so far at a local node
+     * @param localIndex  the local index of the node
+     */
+    const std::vector<double>& rGetApds(unsigned localIndex) const;
+
+    /**
+     * @return the maximum upstroke velocities recorded so far at a local node
+     * @param localIndex  the local index of the node
+     */
+    const std::vector<double>& rGetMaxUpstrokeVelocities(unsigned localIndex) const;
+};
+
+#endif /* ACTIONPOTENTIALMAPOUTPUTMODIFIER_HPP_ */
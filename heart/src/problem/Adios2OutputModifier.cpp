@@ -0,0 +1,106 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "Adios2OutputModifier.hpp"
+
+#ifdef CHASTE_ADIOS2
+
+#include "HeartConfig.hpp"
+
+Adios2OutputModifier::Adios2OutputModifier(const std::string& rFilename, const std::string& rEngineType)
+    : AbstractOutputModifier(rFilename),
+      mEngineType(rEngineType),
+      mpVectorFactory(nullptr),
+      mpWriter(nullptr)
+{
+}
+
+Adios2OutputModifier::~Adios2OutputModifier()
+{
+    delete mpWriter;
+}
+
+void Adios2OutputModifier::InitialiseAtStart(DistributedVectorFactory* pVectorFactory)
+{
+    mpVectorFactory = pVectorFactory;
+}
+
+void Adios2OutputModifier::FinaliseAtEnd()
+{
+    if (mpWriter)
+    {
+        mpWriter->Close();
+        delete mpWriter;
+        mpWriter = nullptr;
+    }
+}
+
+void Adios2OutputModifier::ProcessSolutionAtTimeStep(double time, Vec solution, unsigned problemDim)
+{
+    if (mpWriter == nullptr)
+    {
+        assert(mpVectorFactory);
+        mpWriter = new Adios2DataWriter(*mpVectorFactory, HeartConfig::Instance()->GetOutputDirectory(),
+                                        mFilename, mEngineType, false);
+        mpWriter->DefineFixedDimension(mpVectorFactory->GetProblemSize());
+        mpWriter->DefineUnlimitedDimension("Time", "msecs");
+
+        // Same variable names as the HDF5 output of the cardiac problems
+        mVariableIds.clear();
+        mVariableIds.push_back(mpWriter->DefineVariable("V", "mV"));
+        if (problemDim == 3)
+        {
+            mVariableIds.push_back(mpWriter->DefineVariable("V_2", "mV"));
+        }
+        if (problemDim > 1)
+        {
+            mVariableIds.push_back(mpWriter->DefineVariable("Phi_e", "mV"));
+        }
+        mpWriter->EndDefineMode();
+    }
+
+    if (problemDim == 1)
+    {
+        mpWriter->PutVector(mVariableIds[0], solution);
+    }
+    else
+    {
+        mpWriter->PutStripedVector(mVariableIds, solution);
+    }
+    mpWriter->PutUnlimitedVariable(time);
+    mpWriter->AdvanceAlongUnlimitedDimension();
+}
+
+#endif // CHASTE_ADIOS2
@@ -0,0 +1,118 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef ADIOS2OUTPUTMODIFIER_HPP_
+#define ADIOS2OUTPUTMODIFIER_HPP_
+
+#ifdef CHASTE_ADIOS2
+
+#include <string>
+#include <vector>
+
+#include "AbstractOutputModifier.hpp"
+#include "Adios2DataWriter.hpp"
+
+/**
+ * On-the-fly output of the whole solution through ADIOS2 (see Adios2DataWriter),
+ * for in-situ analysis and live visualisation.  By default the solution is
+ * streamed with the SST engine, so readers on other nodes receive every
+ * printing time step in memory without the data touching the filesystem.
+ *
+ * The stream is named <filename> in the simulation output directory.  It has
+ * the variables "V", then "V_2" for extended bidomain problems, then "Phi_e"
+ * for bidomain problems, each over all nodes in the node ordering used at
+ * solve time, and the unlimited dimension "Time" (ms).  Each call to Solve()
+ * opens a new stream.
+ *
+ * WARNING:  This class holds an open stream and so cannot be checkpointed.
+ *
+ * Only available when Chaste is built with ADIOS2 support (Chaste_USE_ADIOS2).
+ */
+class Adios2OutputModifier : public AbstractOutputModifier
+{
+private:
+
+    /** The ADIOS2 engine type. */
+    std::string mEngineType;
+
+    /** The vector factory of the calling problem. */
+    DistributedVectorFactory* mpVectorFactory;
+
+    /** The writer, created at the first output of each solve. */
+    Adios2DataWriter* mpWriter;
+
+    /** The identifiers of the variables, one per unknown. */
+    std::vector<int> mVariableIds;
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param rFilename  The name of the stream (or file, for file engines) produced by this modifier
+     * @param rEngineType  The ADIOS2 engine to use (defaults to "SST")
+     */
+    Adios2OutputModifier(const std::string& rFilename, const std::string& rEngineType="SST");
+
+    /**
+     * Destructor.  Closes the stream if it is still open.
+     */
+    virtual ~Adios2OutputModifier();
+
+    /**
+     * Initialise the modifier when the solve loop is starting.
+     *
+     * @param pVectorFactory  The vector factory which is associated with the calling problem's mesh
+     */
+    virtual void InitialiseAtStart(DistributedVectorFactory* pVectorFactory);
+
+    /**
+     * Finalise the modifier (close the stream).
+     */
+    virtual void FinaliseAtEnd();
+
+    /**
+     * Publish a solution time-step as one ADIOS2 step.
+     *
+     * @param time  The current simulation time
+     * @param solution  A working copy of the solution at the current time-step.  This is the PETSc vector which is distributed across the processes.
+     * @param problemDim  The calling problem dimension.
+     */
+    virtual void ProcessSolutionAtTimeStep(double time, Vec solution, unsigned problemDim);
+};
+
+#endif // CHASTE_ADIOS2
+
+#endif /* ADIOS2OUTPUTMODIFIER_HPP_ */
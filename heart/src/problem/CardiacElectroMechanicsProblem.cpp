@@ -35,6 +35,8 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "CardiacElectroMechanicsProblem.hpp"
 
+#include <algorithm>
+#include <set>
 #include "OutputFileHandler.hpp"
 #include "ReplicatableVector.hpp"
 #include "HeartConfig.hpp"
@@ -102,18 +104,34 @@ void CardiacElectroMechanicsProblem<DIM,ELEC_PROB_DIM>::DetermineWatchedNodes()
   node_index = UNSIGNED_UNSET;
   c_vector<double, DIM> pos_at_min;
 
-  for (unsigned i = 0; i < mpMechanicsMesh->GetNumNodes(); i++) {
-    c_vector<double, DIM> position =
-        mpMechanicsMesh->GetNode(i)->rGetLocation();
+  // (with a distributed mechanics mesh, each process searches the nodes it
+  // has and the nearest of those is chosen)
+  for (typename AbstractMesh<DIM, DIM>::NodeIterator iter =
+      mpMechanicsMesh->GetNodeIteratorBegin();
+      iter != mpMechanicsMesh->GetNodeIteratorEnd(); ++iter) {
+    c_vector<double, DIM> position = iter->rGetLocation();
 
     double dist = norm_2(position-mWatchedLocation);
 
     if (dist < min_dist) {
       min_dist = dist;
-      node_index = i;
+      node_index = iter->GetIndex();
       pos_at_min = position;
     }
   }
+  if (!PetscTools::IsSequential()) {
+    struct {
+      double dist;
+      int rank;
+    } local_min = {min_dist, (int) PetscTools::GetMyRank()}, global_min;
+    MPI_Allreduce(&local_min, &global_min, 1, MPI_DOUBLE_INT, MPI_MINLOC,
+        PetscTools::GetWorld());
+    MPI_Bcast(&node_index, 1, MPI_UNSIGNED, global_min.rank,
+        PetscTools::GetWorld());
+    MPI_Bcast(&pos_at_min[0], DIM, MPI_DOUBLE, global_min.rank,
+        PetscTools::GetWorld());
+    min_dist = global_min.dist;
+  }
 
   // set up watched node, if close enough
   assert(node_index != UNSIGNED_UNSET);  // should def have found something
@@ -171,6 +189,154 @@ void CardiacElectroMechanicsProblem<DIM, ELEC_PROB_DIM>::
   mpWatchedLocationFile->flush();
 }
 
+template <unsigned DIM, unsigned ELEC_PROB_DIM>
+void CardiacElectroMechanicsProblem<DIM, ELEC_PROB_DIM>::SetUpElectricsHalo()
+{
+  // The mechanics solver only has contraction models at the quad points of
+  // the elements this process owns
+  unsigned num_quad_points_per_element =
+      mpCardiacMechSolver->GetQuadratureRule()->GetNumQuadPoints();
+  mLocalQuadPointIndices.clear();
+  for (typename AbstractTetrahedralMesh<DIM, DIM>::ElementIterator iter =
+      mpMechanicsMesh->GetElementIteratorBegin();
+      iter != mpMechanicsMesh->GetElementIteratorEnd(); ++iter) {
+    if (iter->GetOwnership()) {
+      for (unsigned j = 0; j < num_quad_points_per_element; j++) {
+        mLocalQuadPointIndices.push_back(
+            iter->GetIndex() * num_quad_points_per_element + j);
+      }
+    }
+  }
+
+  // Collect the electrics nodes the interpolation onto those points needs
+  std::set<unsigned> halo_nodes;
+  for (unsigned i = 0; i < mLocalQuadPointIndices.size(); i++) {
+    Element<DIM, DIM>* p_element = mpElectricsMesh->GetElement(
+        mpMeshPair->rGetElementsAndWeights()[mLocalQuadPointIndices[i]]
+        .ElementNum);
+    for (unsigned node_index = 0; node_index < DIM + 1; node_index++) {
+      halo_nodes.insert(p_element->GetNodeGlobalIndex(node_index));
+    }
+  }
+  mElectricsHaloNodes.assign(halo_nodes.begin(), halo_nodes.end());
+
+  mQuadPointHaloNodePositions.resize(mLocalQuadPointIndices.size() * (DIM + 1));
+  mQuadPointHaloNodeWeights.resize(mLocalQuadPointIndices.size() * (DIM + 1));
+  for (unsigned i = 0; i < mLocalQuadPointIndices.size(); i++) {
+    const ElementAndWeights<DIM>& r_element_and_weights =
+        mpMeshPair->rGetElementsAndWeights()[mLocalQuadPointIndices[i]];
+    Element<DIM, DIM>* p_element =
+        mpElectricsMesh->GetElement(r_element_and_weights.ElementNum);
+    for (unsigned node_index = 0; node_index < DIM + 1; node_index++) {
+      mQuadPointHaloNodePositions[i * (DIM + 1) + node_index] =
+          std::lower_bound(mElectricsHaloNodes.begin(),
+          mElectricsHaloNodes.end(),
+          p_element->GetNodeGlobalIndex(node_index)) -
+          mElectricsHaloNodes.begin();
+      mQuadPointHaloNodeWeights[i * (DIM + 1) + node_index] =
+          r_element_and_weights.Weights(node_index);
+    }
+  }
+  LOG(2, "Electrics halo on process " << PetscTools::GetMyRank() << " has "
+      << mElectricsHaloNodes.size() << " nodes, for "
+      << mLocalQuadPointIndices.size() << " mechanics quad points");
+}
+
+template <unsigned DIM, unsigned ELEC_PROB_DIM>
+void CardiacElectroMechanicsProblem<DIM, ELEC_PROB_DIM>::
+    CreateElectricsHaloScatter(Vec source, unsigned stride,
+    VecScatter& rScatter, Vec& rHalo)
+{
+  unsigned num_halo_nodes = mElectricsHaloNodes.size();
+  std::vector<PetscInt> source_indices(num_halo_nodes);
+  for (unsigned i = 0; i < num_halo_nodes; i++) {
+    source_indices[i] = stride * mElectricsHaloNodes[i];
+  }
+  PetscInt* p_indices = num_halo_nodes > 0 ? &source_indices[0] : NULL;
+
+  IS source_is;
+  IS halo_is;
+#if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 2) //PETSc 3.2 or later
+  ISCreateGeneral(PETSC_COMM_SELF, num_halo_nodes, p_indices,
+      PETSC_COPY_VALUES, &source_is);
+#else
+  ISCreateGeneral(PETSC_COMM_SELF, num_halo_nodes, p_indices, &source_is);
+#endif
+  ISCreateStride(PETSC_COMM_SELF, num_halo_nodes, 0, 1, &halo_is);
+
+  VecCreateSeq(PETSC_COMM_SELF, num_halo_nodes, &rHalo);
+  VecScatterCreate(source, source_is, rHalo, halo_is, &rScatter);
+
+  ISDestroy(PETSC_DESTROY_PARAM(source_is));
+  ISDestroy(PETSC_DESTROY_PARAM(halo_is));
+}
+
+template <unsigned DIM, unsigned ELEC_PROB_DIM>
+void CardiacElectroMechanicsProblem<DIM, ELEC_PROB_DIM>::
+    InterpolateOntoMechanicsQuadPoints(Vec electricsSolution,
+    Vec calciumData)
+{
+  // The scatters are created on first use, as they need the parallel layout
+  // of the vectors
+  if (mVoltageHaloScatter == NULL) {
+    CreateElectricsHaloScatter(electricsSolution, ELEC_PROB_DIM,
+        mVoltageHaloScatter, mVoltageHalo);
+    CreateElectricsHaloScatter(calciumData, 1, mCalciumHaloScatter,
+        mCalciumHalo);
+  }
+
+  // Start both scatters before finishing either, to overlap the two messages.
+  // The voltage scatter assumes an interleaved solution for ELEC_PROB_DIM>1
+  // (e.g, [Vm_0, phi_e_0, Vm1, phi_e_1...])
+//PETSc-3.x.x or PETSc-2.3.3
+#if ((PETSC_VERSION_MAJOR == 3) || (PETSC_VERSION_MAJOR == 2 && PETSC_VERSION_MINOR == 3 && PETSC_VERSION_SUBMINOR == 3)) //2.3.3 or 3.x.x
+  VecScatterBegin(mVoltageHaloScatter, electricsSolution, mVoltageHalo,
+      INSERT_VALUES, SCATTER_FORWARD);
+  VecScatterBegin(mCalciumHaloScatter, calciumData, mCalciumHalo,
+      INSERT_VALUES, SCATTER_FORWARD);
+  VecScatterEnd(mVoltageHaloScatter, electricsSolution, mVoltageHalo,
+      INSERT_VALUES, SCATTER_FORWARD);
+  VecScatterEnd(mCalciumHaloScatter, calciumData, mCalciumHalo,
+      INSERT_VALUES, SCATTER_FORWARD);
+#else
+//PETSc-2.3.2 or previous
+  VecScatterBegin(electricsSolution, mVoltageHalo, INSERT_VALUES,
+      SCATTER_FORWARD, mVoltageHaloScatter);
+  VecScatterBegin(calciumData, mCalciumHalo, INSERT_VALUES,
+      SCATTER_FORWARD, mCalciumHaloScatter);
+  VecScatterEnd(electricsSolution, mVoltageHalo, INSERT_VALUES,
+      SCATTER_FORWARD, mVoltageHaloScatter);
+  VecScatterEnd(calciumData, mCalciumHalo, INSERT_VALUES,
+      SCATTER_FORWARD, mCalciumHaloScatter);
+#endif
+
+  double* p_voltage;
+  double* p_calcium;
+  VecGetArray(mVoltageHalo, &p_voltage);
+  VecGetArray(mCalciumHalo, &p_calcium);
+
+  // Apply the interpolation matrix to both variables in the same pass
+  for (unsigned i = 0; i < mLocalQuadPointIndices.size(); i++) {
+    unsigned quad_index = mLocalQuadPointIndices[i];
+    double interpolated_CaI = 0;
+    double interpolated_voltage = 0;
+    for (unsigned entry = i * (DIM + 1); entry < (i + 1) * (DIM + 1); entry++) {
+      unsigned halo_index = mQuadPointHaloNodePositions[entry];
+      double weight = mQuadPointHaloNodeWeights[entry];
+      interpolated_CaI += p_calcium[halo_index] * weight;
+      interpolated_voltage += p_voltage[halo_index] * weight;
+    }
+
+    assert(quad_index < mInterpolatedCalciumConcs.size());
+    assert(quad_index < mInterpolatedVoltages.size());
+    mInterpolatedCalciumConcs[quad_index] = interpolated_CaI;
+    mInterpolatedVoltages[quad_index] = interpolated_voltage;
+  }
+
+  VecRestoreArray(mVoltageHalo, &p_voltage);
+  VecRestoreArray(mCalciumHalo, &p_calcium);
+}
+
 template <unsigned DIM, unsigned ELEC_PROB_DIM>
 c_matrix<double, DIM, DIM>& CardiacElectroMechanicsProblem<DIM, ELEC_PROB_DIM>::
     rCalculateModifiedConductivityTensor(
@@ -271,7 +437,7 @@ CardiacElectroMechanicsProblem<DIM, ELEC_PROB_DIM>::
     CompressibilityType compressibilityType
   , ElectricsProblemType electricsProblemType
   , TetrahedralMesh<DIM, DIM>* pElectricsMesh
-  , QuadraticMesh<DIM>* pMechanicsMesh
+  , AbstractTetrahedralMesh<DIM, DIM>* pMechanicsMesh
   , AbstractCardiacCellFactory<DIM>* pCellFactory
   , ElectroMechanicsProblemDefinition<DIM>* pProblemDefinition
   , std::string outputDirectory)
@@ -280,6 +446,10 @@ CardiacElectroMechanicsProblem<DIM, ELEC_PROB_DIM>::
     mpMechanicsSolver(NULL),
     mpElectricsMesh(pElectricsMesh),
     mpMechanicsMesh(pMechanicsMesh),
+    mVoltageHaloScatter(NULL),
+    mCalciumHaloScatter(NULL),
+    mVoltageHalo(NULL),
+    mCalciumHalo(NULL),
     mpProblemDefinition(pProblemDefinition),
     mHasBath(false),
     mpMeshPair(NULL),
@@ -352,6 +522,13 @@ CardiacElectroMechanicsProblem<DIM, ELEC_PROB_DIM>::
   delete mpCardiacMechSolver;
   delete mpMeshPair;
 
+  if (mVoltageHaloScatter) {
+    VecScatterDestroy(PETSC_DESTROY_PARAM(mVoltageHaloScatter));
+    VecScatterDestroy(PETSC_DESTROY_PARAM(mCalciumHaloScatter));
+    PetscTools::Destroy(mVoltageHalo);
+    PetscTools::Destroy(mCalciumHalo);
+  }
+
   LogFile::Close();
 }
 
@@ -462,6 +639,7 @@ void CardiacElectroMechanicsProblem<DIM, ELEC_PROB_DIM>::Initialise()
   unsigned num_quad_points = mpCardiacMechSolver->GetTotalNumQuadPoints();
   mInterpolatedCalciumConcs.assign(num_quad_points, 0.0);
   mInterpolatedVoltages.assign(num_quad_points, 0.0);
+  SetUpElectricsHalo();
 
   if (mpProblemDefinition->ReadFibreSheetDirectionsFromFile()) {
     mpCardiacMechSolver->SetVariableFibreSheetDirections(
@@ -709,6 +887,10 @@ void CardiacElectroMechanicsProblem<DIM, ELEC_PROB_DIM>::Solve()
       mpCardiacMechSolver->ComputeDeformationGradientAndStretchInEachElement(
           mDeformationGradientsForEachMechanicsElement,
           mStretchesForEachMechanicsElement);
+
+      // The modified conductivities are recomputed (once per element)
+      // for this mechanics step
+      this->InvalidateCache();
     }
 
     if (mpProblemDefinition->GetDeformationAffectsCellModels()) {
@@ -789,42 +971,11 @@ void CardiacElectroMechanicsProblem<DIM, ELEC_PROB_DIM>::Solve()
         VecSetValue(calcium_data, node_index, calcium_value, INSERT_VALUES);
       }
     }
-    PetscTools::Barrier();  // not sure this is needed
-
-    // Replicate electrics solution and calcium (replication is inside this
-    // constructor of ReplicatableVector)
-    // size=(number of electrics nodes)*ELEC_PROB_DIM
-    ReplicatableVector electrics_solution_repl(electrics_solution);
-    // size = number of electrics nodes
-    ReplicatableVector calcium_repl(calcium_data);
-
-    // interpolate values onto mechanics mesh
-    for (unsigned i = 0; i < mpMeshPair->rGetElementsAndWeights().size();
-        i++) {
-      double interpolated_CaI = 0;
-      double interpolated_voltage = 0;
-
-      Element<DIM, DIM>& element = *(mpElectricsMesh->GetElement(mpMeshPair
-          ->rGetElementsAndWeights()[i].ElementNum));
-
-      for (unsigned node_index = 0; node_index < element.GetNumNodes();
-          node_index++) {
-        unsigned global_index = element.GetNodeGlobalIndex(node_index);
-        double CaI_at_node =  calcium_repl[global_index];
-        interpolated_CaI += CaI_at_node *
-            mpMeshPair->rGetElementsAndWeights()[i].Weights(node_index);
-        // the following line assumes interleaved solution for ELEC_PROB_DIM>1
-        // (e.g, [Vm_0, phi_e_0, Vm1, phi_e_1...])
-        interpolated_voltage +=
-            electrics_solution_repl[global_index * ELEC_PROB_DIM] *
-            mpMeshPair->rGetElementsAndWeights()[i].Weights(node_index);
-      }
+    VecAssemblyBegin(calcium_data);
+    VecAssemblyEnd(calcium_data);
 
-      assert(i < mInterpolatedCalciumConcs.size());
-      assert(i < mInterpolatedVoltages.size());
-      mInterpolatedCalciumConcs[i] = interpolated_CaI;
-      mInterpolatedVoltages[i] = interpolated_voltage;
-    }
+    // interpolate values onto the mechanics quad points owned by this process
+    InterpolateOntoMechanicsQuadPoints(electrics_solution, calcium_data);
 
     LOG(2, "  Setting Ca_I. max value = " << Max(mInterpolatedCalciumConcs));
 
@@ -979,8 +1130,14 @@ void CardiacElectroMechanicsProblem<DIM, ELEC_PROB_DIM>::Solve()
     // Note: this calculates the data on ALL nodes of the mechanics mesh (incl
     // internal, non-vertex ones), which won't be used if linear CMGUI
     // visualisation of the mechanics solution is used.
-    VoltageInterpolaterOntoMechanicsMesh<DIM> converter(*mpElectricsMesh,
-        *mpMechanicsMesh, variable_names, input_dir, "voltage");
+    // (this needs every node of the mechanics mesh, so is only done for a
+    // replicated mechanics mesh)
+    QuadraticMesh<DIM>* p_quadratic_mesh =
+        dynamic_cast<QuadraticMesh<DIM>*>(mpMechanicsMesh);
+    if (p_quadratic_mesh) {
+      VoltageInterpolaterOntoMechanicsMesh<DIM> converter(*mpElectricsMesh,
+          *p_quadratic_mesh, variable_names, input_dir, "voltage");
+    }
 
     // reset to the default value
     HeartConfig::Instance()->SetOutputDirectory(config_directory);
@@ -131,8 +131,42 @@ protected :
 
     /** The mesh for the electrics */
     TetrahedralMesh<DIM,DIM>* mpElectricsMesh;
-    /** The mesh for the mechanics */
-    QuadraticMesh<DIM>* mpMechanicsMesh;
+    /** The mesh for the mechanics (a QuadraticMesh or a DistributedQuadraticMesh) */
+    AbstractTetrahedralMesh<DIM,DIM>* mpMechanicsMesh;
+
+    /**
+     * The (global) indices of the mechanics quadrature points in the elements owned by
+     * this process, which are the only ones the mechanics solver needs calcium and voltage at.
+     */
+    std::vector<unsigned> mLocalQuadPointIndices;
+
+    /** The electrics nodes used to interpolate onto mLocalQuadPointIndices, in increasing order. */
+    std::vector<unsigned> mElectricsHaloNodes;
+
+    /**
+     * For each of mLocalQuadPointIndices, the positions in mElectricsHaloNodes of the nodes of
+     * the electrics element containing that quad point (DIM+1 entries per quad point).
+     */
+    std::vector<unsigned> mQuadPointHaloNodePositions;
+
+    /**
+     * The interpolation weights of the nodes in mQuadPointHaloNodePositions, in the same order.
+     * Together these form the rows of a sparse interpolation matrix from the halo vectors onto
+     * the local quad points, stored contiguously so that it can be applied in one pass.
+     */
+    std::vector<double> mQuadPointHaloNodeWeights;
+
+    /** Scatter of the voltages at mElectricsHaloNodes from the electrics solution into mVoltageHalo. */
+    VecScatter mVoltageHaloScatter;
+
+    /** Scatter of the calcium concentrations at mElectricsHaloNodes into mCalciumHalo. */
+    VecScatter mCalciumHaloScatter;
+
+    /** Sequential vector of the voltages at mElectricsHaloNodes. */
+    Vec mVoltageHalo;
+
+    /** Sequential vector of the calcium concentrations at mElectricsHaloNodes. */
+    Vec mCalciumHalo;
 
     /** Object containing information about the problem to be solved */
     ElectroMechanicsProblemDefinition<DIM>* mpProblemDefinition;
@@ -182,6 +216,34 @@ protected :
      */
     void DetermineWatchedNodes();
 
+    /**
+     * Work out which mechanics quadrature points this process needs calcium and voltage at, and
+     * which electrics nodes (the halo) those are interpolated from. Called in Initialise(), after
+     * the mesh pair has been set up.
+     */
+    void SetUpElectricsHalo();
+
+    /**
+     * Create a scatter from a distributed electrics vector to a sequential vector of the values
+     * at mElectricsHaloNodes.
+     *
+     * @param source  a vector with the parallel layout of the values to be scattered
+     * @param stride  the number of values per electrics node in source (they are assumed to be interleaved)
+     * @param rScatter  the scatter to create
+     * @param rHalo  the sequential vector to create
+     */
+    void CreateElectricsHaloScatter(Vec source, unsigned stride, VecScatter& rScatter, Vec& rHalo);
+
+    /**
+     * Interpolate the calcium concentrations and voltages at the electrics nodes onto the mechanics
+     * quadrature points owned by this process, filling in mInterpolatedCalciumConcs and
+     * mInterpolatedVoltages. Only the halo values are communicated.
+     *
+     * @param electricsSolution  the electrics solution (interleaved if ELEC_PROB_DIM > 1)
+     * @param calciumData  the intracellular calcium concentration at each electrics node
+     */
+    void InterpolateOntoMechanicsQuadPoints(Vec electricsSolution, Vec calciumData);
+
 
     /**
      *  Write info (x, y, [z], V) for the watched node.
@@ -199,7 +261,7 @@ public :
      * @param compressibilityType Should be either INCOMPRESSIBLE or COMPRESSIBLE
      * @param electricsProblemType the type of electrics problem (MONODOMAIN or BIDOMAIN)
      * @param pElectricsMesh  Mesh on which to solve electrics (Monodomain)
-     * @param pMechanicsMesh  Mesh (2nd order) on which to solve mechanics
+     * @param pMechanicsMesh  Mesh (2nd order: a QuadraticMesh or DistributedQuadraticMesh) on which to solve mechanics
      * @param pCellFactory factory to use to create cells
      * @param pProblemDefinition electro-mechanics problem definition
      * @param outputDirectory the output directory
@@ -207,7 +269,7 @@ public :
     CardiacElectroMechanicsProblem(CompressibilityType compressibilityType,
                                    ElectricsProblemType electricsProblemType,
                                    TetrahedralMesh<DIM,DIM>* pElectricsMesh,
-                                   QuadraticMesh<DIM>* pMechanicsMesh,
+                                   AbstractTetrahedralMesh<DIM,DIM>* pMechanicsMesh,
                                    AbstractCardiacCellFactory<DIM>* pCellFactory,
                                    ElectroMechanicsProblemDefinition<DIM>* pProblemDefinition,
                                    std::string outputDirectory);
@@ -278,6 +340,16 @@ public :
      */
     c_matrix<double,DIM,DIM>& rCalculateModifiedConductivityTensor(unsigned elementIndex, const c_matrix<double,DIM,DIM>& rOriginalConductivity, unsigned domainIndex);
 
+    /**
+     *  The deformation, and so the modified conductivities, only change once per mechanics time step,
+     *  when the cache is invalidated.
+     *  @return ON_INVALIDATION
+     */
+    typename AbstractConductivityModifier<DIM,DIM>::TimeDependence GetTimeDependence() const
+    {
+        return AbstractConductivityModifier<DIM,DIM>::ON_INVALIDATION;
+    }
+
 
     /**
      * Called in Solve() before the time loop
@@ -35,6 +35,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "CardiacSimulationArchiver.hpp"  // Must go first
 #include "CardiacSimulation.hpp"
+#include "MemoryAccounting.hpp"
 
 
 boost::shared_ptr<AbstractUntemplatedCardiacProblem> CardiacSimulation::GetSavedProblem()
@@ -94,8 +95,10 @@ void CardiacSimulation::CreateResumeXmlFile(const std::string& rOutputDirectory,
 
 CardiacSimulation::CardiacSimulation(std::string parameterFileName,
                                      bool writeProvenanceInfo,
-                                     bool saveProblemInstance)
-    : mSaveProblemInstance(saveProblemInstance)
+                                     bool saveProblemInstance,
+                                     CardiacSimulationMeshCache* pMeshCache)
+    : mSaveProblemInstance(saveProblemInstance),
+      mpMeshCache(pMeshCache)
 {
     // If we have been passed an XML file then parse the XML file, otherwise throw
     if (parameterFileName == "")
@@ -106,6 +109,7 @@ CardiacSimulation::CardiacSimulation(std::string parameterFileName,
     Run();
     HeartEventHandler::Headings();
     HeartEventHandler::Report();
+    MemoryAccounting::Report();
     if (writeProvenanceInfo)
     {
         ExecutableSupport::SetOutputDirectory(HeartConfig::Instance()->GetOutputDirectory());
@@ -122,6 +126,7 @@ void CardiacSimulation::ReadParametersFromFile(std::string parameterFileName)
     {
         // Try the hardcoded schema location first
         HeartConfig::Instance()->SetUseFixedSchemaLocation(true);
+        HeartConfig::Instance()->SetReadParametersOnMasterOnly(true);
         HeartConfig::Instance()->SetParametersFile(parameterFileName);
     }
     catch (Exception& e)
@@ -131,6 +136,7 @@ void CardiacSimulation::ReadParametersFromFile(std::string parameterFileName)
             // Try using the schema location given in the XML
             HeartConfig::Reset();
             HeartConfig::Instance()->SetUseFixedSchemaLocation(false);
+            HeartConfig::Instance()->SetReadParametersOnMasterOnly(true);
             HeartConfig::Instance()->SetParametersFile(parameterFileName);
         }
         else
@@ -148,12 +154,21 @@ void CardiacSimulation::ReadParametersFromFile(std::string parameterFileName)
         break;                            \
     }
 
+#define EIKONAL_CASE(VALUE, REACTION, DIM)  \
+    case VALUE:                             \
+    {                                       \
+        CreateAndRunEikonal<DIM>(REACTION); \
+        break;                              \
+    }
+
 #define DOMAIN_SWITCH(DIM)                                                     \
     switch (HeartConfig::Instance()->GetDomain())                              \
     {                                                                          \
         DOMAIN_CASE(cp::domain_type::Mono, MonodomainProblem, DIM)             \
         DOMAIN_CASE(cp::domain_type::Bi, BidomainProblem, DIM)                 \
         DOMAIN_CASE(cp::domain_type::BiWithBath, BidomainWithBathProblem, DIM) \
+        EIKONAL_CASE(cp::domain_type::Eikonal, false, DIM)                     \
+        EIKONAL_CASE(cp::domain_type::ReactionEikonal, true, DIM)              \
         default:                                                               \
             NEVER_REACHED;                                                     \
     }                                                                          \
@@ -185,5 +200,6 @@ void CardiacSimulation::Run()
 
 // These aren't needed externally
 #undef DOMAIN_SWITCH
+#undef EIKONAL_CASE
 #undef DOMAIN_CASE
 
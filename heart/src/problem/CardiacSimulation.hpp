@@ -45,6 +45,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "MonodomainProblem.hpp"
 #include "BidomainProblem.hpp"
 #include "BidomainWithBathProblem.hpp"
+#include "EikonalProblem.hpp"
 #include "CardiacSimulationArchiver.hpp"
 #include "PetscTools.hpp"
 #include "TimeStepper.hpp"
@@ -65,6 +66,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "PostProcessingWriter.hpp"
 
 #include "OutputDirectoryFifoQueue.hpp"
+#include "CardiacSimulationMeshCache.hpp"
 #include "ExecutableSupport.hpp"
 
 /**
@@ -101,6 +103,10 @@ private:
             HeartConfigRelatedCellFactory<SPACE_DIM> cell_factory;
             p_problem.reset(new Problem(&cell_factory));
 
+            if (mpMeshCache != nullptr && HeartConfig::Instance()->GetLoadMesh())
+            {
+                p_problem->SetMesh(mpMeshCache->GetMeshFromHeartConfig<SPACE_DIM>());
+            }
             p_problem->Initialise();
         }
         else // (HeartConfig::Instance()->IsSimulationResumed())
@@ -127,6 +133,8 @@ private:
             // Create the checkpoints directory and set up a fifo queue of subdirectory names
             OutputDirectoryFifoQueue directory_queue(HeartConfig::Instance()->GetOutputDirectory() + "_checkpoints/",
                                                      HeartConfig::Instance()->GetMaxCheckpointsOnDisk());
+            // Old checkpoints are deleted in the background while the simulation carries on
+            directory_queue.SetRemoveDirectoriesAsynchronously();
 
             TimeStepper checkpoint_stepper(p_problem->GetCurrentTime(), HeartConfig::Instance()->GetSimulationDuration(), HeartConfig::Instance()->GetCheckpointTimestep());
             while ( !checkpoint_stepper.IsTimeAtEnd() )
@@ -165,6 +173,7 @@ private:
                 // Advance time stepper
                 checkpoint_stepper.AdvanceOneTimeStep();
             }
+            directory_queue.Flush();
         }
         else
         {
@@ -176,6 +185,31 @@ private:
         }
     }
 
+    /**
+     * Templated method which creates and runs an eikonal or reaction-eikonal
+     * simulation, based on the XML file passed to our constructor.  These
+     * simulations cannot be checkpointed or resumed.
+     *
+     * @param reactionEikonal  whether to drive the cell models with the activation times
+     */
+    template <unsigned SPACE_DIM>
+    void CreateAndRunEikonal(bool reactionEikonal)
+    {
+        if (!HeartConfig::Instance()->IsSimulationDefined() || HeartConfig::Instance()->GetCheckpointSimulation())
+        {
+            EXCEPTION("Eikonal simulations cannot be checkpointed or resumed");
+        }
+
+        HeartConfigRelatedCellFactory<SPACE_DIM> cell_factory;
+        boost::shared_ptr<EikonalProblem<SPACE_DIM> > p_problem(new EikonalProblem<SPACE_DIM>(&cell_factory, reactionEikonal));
+        p_problem->Initialise();
+        p_problem->Solve();
+        if (mSaveProblemInstance)
+        {
+            mSavedProblem = p_problem;
+        }
+    }
+
     /**
      * Run the simulation.
      * This method basically contains switches on the problem type and space dimension,
@@ -209,10 +243,13 @@ public:
      * @param parameterFileName  The name of the chaste parameters xml file to use to run a simulation.
      * @param writeProvenanceInfo  Whether to write provanence and machine information files.
      * @param saveProblemInstance  Whether to save a copy of the problem instance for examination by tests.
+     * @param pMeshCache  Optional cache from which to take meshes loaded from file, so that they can be
+     *     shared with other simulations; it must outlive any saved problem instance.
      */
     CardiacSimulation(std::string parameterFileName,
                       bool writeProvenanceInfo=false,
-                      bool saveProblemInstance=false);
+                      bool saveProblemInstance=false,
+                      CardiacSimulationMeshCache* pMeshCache=nullptr);
 
     /**
      * @return the saved problem instance, if any.  Will return an empty pointer if the
@@ -225,6 +262,9 @@ private:
 
     /** The saved problem instance, if any. */
     boost::shared_ptr<AbstractUntemplatedCardiacProblem> mSavedProblem;
+
+    /** Cache of meshes loaded from file, if any. */
+    CardiacSimulationMeshCache* mpMeshCache;
 };
 
 #endif /*CARDIACSIMULATION_HPP_*/
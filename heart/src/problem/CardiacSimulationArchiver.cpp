@@ -51,25 +51,48 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "BidomainProblem.hpp"
 #include "BidomainWithBathProblem.hpp"
 
+template <class PROBLEM_CLASS>
+template <class ARCHIVE, class STREAM>
+void CardiacSimulationArchiver<PROBLEM_CLASS>::SaveToArchive(PROBLEM_CLASS& rSimulationToArchive,
+                                                             const FileFinder& rDirectory)
+{
+    // Open the archive files
+    ArchiveOpener<ARCHIVE, STREAM> archive_opener(rDirectory, "archive.arch");
+    ARCHIVE* p_main_archive = archive_opener.GetCommonArchive();
+
+    // And save
+    PROBLEM_CLASS* const p_simulation_to_archive = &rSimulationToArchive;
+    (*p_main_archive) & p_simulation_to_archive;
+}
+
 template <class PROBLEM_CLASS>
 void CardiacSimulationArchiver<PROBLEM_CLASS>::Save(PROBLEM_CLASS& rSimulationToArchive,
                                                     const std::string& rDirectory,
-                                                    bool clearDirectory)
+                                                    bool clearDirectory,
+                                                    bool binary,
+                                                    bool compress)
 {
     // Clear directory if requested (and make sure it exists)
     OutputFileHandler handler(rDirectory, clearDirectory);
 
-    // Nest the archive writing, so the ArchiveOpener goes out of scope before
-    // the method ends.
+    // The archive writing is done in a separate method, so the ArchiveOpener
+    // goes out of scope before this method ends.
+    FileFinder dir(rDirectory, RelativeTo::ChasteTestOutput);
+    if (binary && compress)
+    {
+        SaveToArchive<boost::archive::binary_oarchive, GzipOutputFileStream>(rSimulationToArchive, dir);
+    }
+    else if (binary)
     {
-        // Open the archive files
-        FileFinder dir(rDirectory, RelativeTo::ChasteTestOutput);
-        ArchiveOpener<boost::archive::text_oarchive, std::ofstream> archive_opener(dir, "archive.arch");
-        boost::archive::text_oarchive* p_main_archive = archive_opener.GetCommonArchive();
-
-        // And save
-        PROBLEM_CLASS* const p_simulation_to_archive = &rSimulationToArchive;
-        (*p_main_archive) & p_simulation_to_archive;
+        SaveToArchive<boost::archive::binary_oarchive, std::ofstream>(rSimulationToArchive, dir);
+    }
+    else if (compress)
+    {
+        SaveToArchive<boost::archive::text_oarchive, GzipOutputFileStream>(rSimulationToArchive, dir);
+    }
+    else
+    {
+        SaveToArchive<boost::archive::text_oarchive, std::ofstream>(rSimulationToArchive, dir);
     }
 
     // Write the info file
@@ -86,6 +109,15 @@ void CardiacSimulationArchiver<PROBLEM_CLASS>::Save(PROBLEM_CLASS& rSimulationTo
         PetscTools::ReplicateBool(false);
         unsigned archive_version = 0; // Note that Boost version numbers are per-class; this only needs to change if we change the Load/Save methods here
         info_file << PetscTools::GetNumProcs() << " " << archive_version;
+        if (binary || compress)
+        {
+            // Older checkpoints have no format entry, and are uncompressed text archives
+            info_file << (binary ? " binary" : " text");
+        }
+        if (compress)
+        {
+            info_file << " gzip";
+        }
     }
     else
     {
@@ -133,12 +165,36 @@ PROBLEM_CLASS* CardiacSimulationArchiver<PROBLEM_CLASS>::Migrate(const FileFinde
     }
     unsigned num_procs, archive_version;
     info_file >> num_procs >> archive_version;
+    std::string archive_format, archive_compression;
+    info_file >> archive_format >> archive_compression;
+    bool compressed = (archive_compression == "gzip");
 
+    if (archive_format == "binary")
+    {
+        if (compressed)
+        {
+            return MigrateFromArchive<boost::archive::binary_iarchive, GzipInputFileStream>(rDirectory, num_procs, archive_version);
+        }
+        return MigrateFromArchive<boost::archive::binary_iarchive, std::ifstream>(rDirectory, num_procs, archive_version);
+    }
+    if (compressed)
+    {
+        return MigrateFromArchive<boost::archive::text_iarchive, GzipInputFileStream>(rDirectory, num_procs, archive_version);
+    }
+    return MigrateFromArchive<boost::archive::text_iarchive, std::ifstream>(rDirectory, num_procs, archive_version);
+}
+
+template <class PROBLEM_CLASS>
+template <class ARCHIVE, class STREAM>
+PROBLEM_CLASS* CardiacSimulationArchiver<PROBLEM_CLASS>::MigrateFromArchive(const FileFinder& rDirectory,
+                                                                            unsigned numProcs,
+                                                                            unsigned archiveVersion)
+{
     PROBLEM_CLASS *p_unarchived_simulation = NULL; // Shouldn't be necessary but is on some setups!
 
     // Avoid the DistributedVectorFactory throwing a 'wrong number of processes' exception when loading,
     // and make it get the original DistributedVectorFactory from the archive so we can compare against
-    // num_procs.
+    // numProcs.
     DistributedVectorFactory::SetCheckNumberOfProcessesOnLoad(false);
     // Put what follows in a try-catch to make sure we reset this
     try
@@ -146,19 +202,19 @@ PROBLEM_CLASS* CardiacSimulationArchiver<PROBLEM_CLASS>::Migrate(const FileFinde
         // Figure out which process-specific archive to load first.  If we're loading on the same number of
         // processes, we must load our own one, or the mesh gets confused.  Otherwise, start with 0 to make
         // sure it exists.
-        unsigned initial_archive = num_procs == PetscTools::GetNumProcs() ? PetscTools::GetMyRank() : 0u;
+        unsigned initial_archive = numProcs == PetscTools::GetNumProcs() ? PetscTools::GetMyRank() : 0u;
 
         // Load the master and initial process-specific archive files.
         // This will also set up ArchiveLocationInfo for us.
-        ArchiveOpener<boost::archive::text_iarchive, std::ifstream> archive_opener(rDirectory, "archive.arch", initial_archive);
-        boost::archive::text_iarchive* p_main_archive = archive_opener.GetCommonArchive();
+        ArchiveOpener<ARCHIVE, STREAM> archive_opener(rDirectory, "archive.arch", initial_archive);
+        ARCHIVE* p_main_archive = archive_opener.GetCommonArchive();
         (*p_main_archive) >> p_unarchived_simulation;
 
         // Work out how many more process-specific files to load
         DistributedVectorFactory* p_factory = p_unarchived_simulation->rGetMesh().GetDistributedVectorFactory();
         assert(p_factory != NULL);
         unsigned original_num_procs = p_factory->GetOriginalFactory()->GetNumProcs();
-        assert(original_num_procs == num_procs); // Paranoia
+        assert(original_num_procs == numProcs); // Paranoia
 
         // Merge in the extra data
         for (unsigned archive_num=0; archive_num<original_num_procs; archive_num++)
@@ -166,9 +222,9 @@ PROBLEM_CLASS* CardiacSimulationArchiver<PROBLEM_CLASS>::Migrate(const FileFinde
             if (archive_num != initial_archive)
             {
                 std::string archive_path = ArchiveLocationInfo::GetProcessUniqueFilePath("archive.arch", archive_num);
-                std::ifstream ifs(archive_path.c_str());
-                boost::archive::text_iarchive archive(ifs);
-                p_unarchived_simulation->LoadExtraArchive(archive, archive_version);
+                STREAM ifs(archive_path.c_str(), std::ios::binary);
+                ARCHIVE archive(ifs);
+                p_unarchived_simulation->LoadExtraArchive(archive, archiveVersion);
             }
         }
     }
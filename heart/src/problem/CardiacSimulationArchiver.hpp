@@ -51,6 +51,27 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 template <class PROBLEM_CLASS>
 class CardiacSimulationArchiver
 {
+private:
+    /**
+     * Helper method for Save(), templated over the Boost archive and file stream types.
+     *
+     * @param rSimulationToArchive object defining the simulation to archive
+     * @param rDirectory directory where the checkpoint will be stored
+     */
+    template <class ARCHIVE, class STREAM>
+    static void SaveToArchive(PROBLEM_CLASS& rSimulationToArchive, const FileFinder& rDirectory);
+
+    /**
+     * Helper method for Migrate(), templated over the Boost archive and file stream types.
+     *
+     * @param rDirectory directory where the multiple files defining the checkpoint are located
+     * @param numProcs the number of processes that wrote the checkpoint
+     * @param archiveVersion the version number recorded in the archive information file
+     * @return a pointer to the migrated cardiac problem class
+     */
+    template <class ARCHIVE, class STREAM>
+    static PROBLEM_CLASS* MigrateFromArchive(const FileFinder& rDirectory, unsigned numProcs, unsigned archiveVersion);
+
 public:
     /**
      * Archives a simulation in the directory specified.
@@ -61,8 +82,16 @@ public:
      * @param rDirectory directory where the multiple files defining the checkpoint will be stored
      *     (relative to CHASTE_TEST_OUTPUT)
      * @param clearDirectory whether the directory needs to be cleared or not.
+     * @param binary whether to write Boost binary archives rather than text ones.  Binary
+     *     checkpoints are much faster to write and read when there are many cells, but can only
+     *     be loaded on the same platform.  The format is recorded in the archive information
+     *     file, so Load() detects it automatically.
+     * @param compress whether to gzip-compress the archive files as they are written.  This can
+     *     greatly reduce the size of large checkpoints, at some cost in speed.  It is also recorded
+     *     in the archive information file.
      */
-    static void Save(PROBLEM_CLASS& rSimulationToArchive, const std::string& rDirectory, bool clearDirectory=true);
+    static void Save(PROBLEM_CLASS& rSimulationToArchive, const std::string& rDirectory, bool clearDirectory=true,
+                     bool binary=false, bool compress=false);
 
 
     /**
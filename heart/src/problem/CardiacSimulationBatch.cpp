@@ -0,0 +1,171 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "CardiacSimulationArchiver.hpp"  // Must go first
+#include "CardiacSimulation.hpp"
+#include "CardiacSimulationBatch.hpp"
+
+#include <fstream>
+#include <sstream>
+
+#include "Exception.hpp"
+#include "ExecutableSupport.hpp"
+#include "FileFinder.hpp"
+#include "HeartEventHandler.hpp"
+#include "PetscTools.hpp"
+
+CardiacSimulationBatch::CardiacSimulationBatch(const std::string& manifestFile,
+                                               unsigned numGroups,
+                                               bool writeProvenanceInfo)
+    : mNumFailed(0u),
+      mNumResidentMeshes(0u)
+{
+    ReadManifest(manifestFile);
+
+    unsigned num_procs = PetscTools::GetNumProcs();
+    if (numGroups == 0u || numGroups > num_procs)
+    {
+        EXCEPTION("The number of groups (" << numGroups << ") must be between 1 and the number of processes ("
+                  << num_procs << ")");
+    }
+
+    unsigned num_failed_on_group_master = 0u;
+    if (numGroups == 1u)
+    {
+        num_failed_on_group_master = RunGroup(0u, 1u, writeProvenanceInfo);
+    }
+    else
+    {
+        // Split the processes into contiguous groups, each of which becomes the world while it runs its scenarios
+        MPI_Comm world = PetscTools::GetWorld();
+        unsigned group = (PetscTools::GetMyRank() * numGroups) / num_procs;
+        MPI_Comm group_communicator;
+        MPI_Comm_split(world, group, PetscTools::GetMyRank(), &group_communicator);
+        PetscTools::SetWorld(group_communicator);
+
+        unsigned num_failed = RunGroup(group, numGroups, writeProvenanceInfo);
+        num_failed_on_group_master = PetscTools::AmMaster() ? num_failed : 0u;
+
+        PetscTools::SetWorld(world);
+        MPI_Comm_free(&group_communicator);
+
+        // Only the master of each group counts its failures, so the sum is over groups
+        unsigned num_failed_locally = num_failed_on_group_master;
+        MPI_Allreduce(&num_failed_locally, &num_failed_on_group_master, 1, MPI_UNSIGNED, MPI_SUM, world);
+    }
+    mNumFailed = num_failed_on_group_master;
+}
+
+void CardiacSimulationBatch::ReadManifest(const std::string& rManifestFile)
+{
+    FileFinder manifest(rManifestFile, RelativeTo::AbsoluteOrCwd);
+    if (!manifest.IsFile())
+    {
+        EXCEPTION("Batch manifest file " << rManifestFile << " does not exist");
+    }
+
+    std::ifstream manifest_stream(manifest.GetAbsolutePath().c_str());
+    std::string line;
+    while (std::getline(manifest_stream, line))
+    {
+        // Strip surrounding whitespace, and skip blank lines and comments
+        std::size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#')
+        {
+            continue;
+        }
+        std::size_t last = line.find_last_not_of(" \t\r");
+        std::string file_name = line.substr(first, last - first + 1);
+
+        if (FileFinder::IsAbsolutePath(file_name))
+        {
+            mParameterFiles.push_back(file_name);
+        }
+        else
+        {
+            mParameterFiles.push_back(FileFinder(file_name, manifest).GetAbsolutePath());
+        }
+    }
+
+    if (mParameterFiles.empty())
+    {
+        EXCEPTION("Batch manifest file " << rManifestFile << " does not list any parameters files");
+    }
+}
+
+unsigned CardiacSimulationBatch::RunGroup(unsigned group, unsigned numGroups, bool writeProvenanceInfo)
+{
+    CardiacSimulationMeshCache mesh_cache;
+    unsigned num_failed = 0u;
+
+    for (unsigned i=group; i<mParameterFiles.size(); i+=numGroups)
+    {
+        std::stringstream message;
+        message << "Running scenario " << i+1 << " of " << mParameterFiles.size() << ": " << mParameterFiles[i];
+        ExecutableSupport::Print(message.str());
+
+        HeartEventHandler::Reset();
+        try
+        {
+            CardiacSimulation simulation(mParameterFiles[i], writeProvenanceInfo, false, &mesh_cache);
+        }
+        catch (const Exception& e)
+        {
+            ExecutableSupport::PrintError("Scenario " + mParameterFiles[i] + " failed: " + e.GetMessage(), true);
+            num_failed++;
+        }
+    }
+
+    mNumResidentMeshes = mesh_cache.GetNumMeshes();
+
+    // Free the meshes while their communicator is still the world
+    mesh_cache.Clear();
+    return num_failed;
+}
+
+unsigned CardiacSimulationBatch::GetNumScenarios() const
+{
+    return mParameterFiles.size();
+}
+
+unsigned CardiacSimulationBatch::GetNumFailed() const
+{
+    return mNumFailed;
+}
+
+unsigned CardiacSimulationBatch::GetNumResidentMeshes() const
+{
+    return mNumResidentMeshes;
+}
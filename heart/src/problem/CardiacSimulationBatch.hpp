@@ -0,0 +1,124 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef CARDIACSIMULATIONBATCH_HPP_
+#define CARDIACSIMULATIONBATCH_HPP_
+
+#include <string>
+#include <vector>
+
+#include "CardiacSimulationMeshCache.hpp"
+
+/**
+ * Runs a batch of cardiac simulations, each described by a chaste parameters
+ * XML file as for CardiacSimulation, within a single process launch.
+ *
+ * The parameters files are listed in a manifest file, one per line.  Blank
+ * lines and lines starting with '#' are ignored, and relative paths are
+ * interpreted relative to the directory containing the manifest.
+ *
+ * PETSc is initialised once for the whole batch, meshes loaded from file are
+ * kept resident in a CardiacSimulationMeshCache and shared by every scenario
+ * that uses them, and cell models loaded from shared libraries stay loaded
+ * (see DynamicModelLoaderRegistry).  The processes may also be divided into
+ * groups, each with its own sub-communicator (see PetscTools::SetWorld), which
+ * run alternate scenarios concurrently.  Scenarios that run at the same time
+ * must write to different output directories.
+ *
+ * A scenario that fails is reported and the batch carries on with the next one.
+ */
+class CardiacSimulationBatch
+{
+private:
+
+    /** The absolute paths of the parameters files, in manifest order. */
+    std::vector<std::string> mParameterFiles;
+
+    /** The number of scenarios that failed. */
+    unsigned mNumFailed;
+
+    /** The number of meshes that were resident at the end of the batch on this process's group. */
+    unsigned mNumResidentMeshes;
+
+    /**
+     * Read the manifest file.
+     *
+     * @param rManifestFile  the manifest file name
+     */
+    void ReadManifest(const std::string& rManifestFile);
+
+    /**
+     * Run the scenarios assigned to this process's group.
+     *
+     * @param group  the index of the group
+     * @param numGroups  the number of groups
+     * @param writeProvenanceInfo  whether each scenario writes provenance and machine information files
+     * @return the number of this group's scenarios that failed
+     */
+    unsigned RunGroup(unsigned group, unsigned numGroups, bool writeProvenanceInfo);
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * This also runs the batch immediately.
+     *
+     * @param manifestFile  the name of the manifest file listing the parameters files
+     * @param numGroups  the number of groups of processes to run scenarios concurrently on;
+     *     at least 1 and at most the number of processes (defaults to 1)
+     * @param writeProvenanceInfo  whether each scenario writes provenance and machine information files
+     */
+    CardiacSimulationBatch(const std::string& manifestFile,
+                           unsigned numGroups=1u,
+                           bool writeProvenanceInfo=false);
+
+    /**
+     * @return the number of scenarios in the batch
+     */
+    unsigned GetNumScenarios() const;
+
+    /**
+     * @return the number of scenarios that failed, summed over all groups
+     */
+    unsigned GetNumFailed() const;
+
+    /**
+     * @return the number of distinct meshes read by this process's group
+     */
+    unsigned GetNumResidentMeshes() const;
+};
+
+#endif /*CARDIACSIMULATIONBATCH_HPP_*/
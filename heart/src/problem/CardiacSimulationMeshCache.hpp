@@ -0,0 +1,110 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef CARDIACSIMULATIONMESHCACHE_HPP_
+#define CARDIACSIMULATIONMESHCACHE_HPP_
+
+#include <map>
+#include <sstream>
+#include <string>
+#include <boost/shared_ptr.hpp>
+
+#include "DistributedTetrahedralMesh.hpp"
+#include "GenericMeshReader.hpp"
+#include "HeartConfig.hpp"
+#include "HeartEventHandler.hpp"
+
+/**
+ * Keeps meshes read from file resident between cardiac simulations run in the
+ * same process, so that a batch of simulations sharing a mesh (see
+ * CardiacSimulationBatch) reads and partitions it only once.
+ *
+ * Meshes are identified by their file name, space dimension and partitioning
+ * method, as given in HeartConfig.  They are owned by the cache, which must
+ * therefore outlive any problem they are given to, and are built on the
+ * communicator returned by PetscTools::GetWorld() at the time they are read.
+ */
+class CardiacSimulationMeshCache
+{
+private:
+
+    /**
+     * The resident meshes, by key.  Each points to a
+     * DistributedTetrahedralMesh<DIM,DIM> whose DIM is part of the key.
+     */
+    std::map<std::string, boost::shared_ptr<void> > mMeshes;
+
+public:
+
+    /**
+     * Get the mesh that HeartConfig asks to be loaded from file, reading it
+     * the first time it is asked for.
+     *
+     * @return the resident mesh
+     */
+    template<unsigned DIM>
+    AbstractTetrahedralMesh<DIM,DIM>* GetMeshFromHeartConfig()
+    {
+        assert(HeartConfig::Instance()->GetLoadMesh());
+        std::stringstream key;
+        key << DIM << ":" << HeartConfig::Instance()->GetMeshPartitioning()
+            << ":" << HeartConfig::Instance()->GetMeshName();
+
+        std::map<std::string, boost::shared_ptr<void> >::iterator it = mMeshes.find(key.str());
+        if (it == mMeshes.end())
+        {
+            HeartEventHandler::BeginEvent(HeartEventHandler::READ_MESH);
+            boost::shared_ptr<DistributedTetrahedralMesh<DIM,DIM> > p_mesh(
+                new DistributedTetrahedralMesh<DIM,DIM>(HeartConfig::Instance()->GetMeshPartitioning()));
+            auto p_mesh_reader = GenericMeshReader<DIM,DIM>(HeartConfig::Instance()->GetMeshName());
+            p_mesh->ConstructFromMeshReader(*p_mesh_reader);
+            HeartEventHandler::EndEvent(HeartEventHandler::READ_MESH);
+            it = mMeshes.insert(std::make_pair(key.str(), boost::shared_ptr<void>(p_mesh))).first;
+        }
+        return static_cast<DistributedTetrahedralMesh<DIM,DIM>*>(it->second.get());
+    }
+
+    /**
+     * @return the number of meshes currently resident
+     */
+    unsigned GetNumMeshes() const;
+
+    /**
+     * Free all the resident meshes.
+     */
+    void Clear();
+};
+
+#endif /*CARDIACSIMULATIONMESHCACHE_HPP_*/
@@ -0,0 +1,420 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#include "DecimatedOutputModifier.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <sstream>
+
+#include "Exception.hpp"
+#include "HeartConfig.hpp"
+#include "MathsCustomFunctions.hpp"
+#include "PetscTools.hpp"
+#include "TimeStepper.hpp"
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+DecimatedOutputModifier<ELEMENT_DIM, SPACE_DIM>::DecimatedOutputModifier(const std::string& rFilename,
+                                                                         AbstractTetrahedralMesh<ELEMENT_DIM,SPACE_DIM>& rMesh)
+    : AbstractOutputModifier(rFilename),
+      mrMesh(rMesh),
+      mUseLattice(false),
+      mLatticeLowerCorner(zero_vector<double>(SPACE_DIM)),
+      mLatticeNumPoints(zero_vector<unsigned>(SPACE_DIM)),
+      mLatticeSpacing(0.0),
+      mLatticeOutputPeriod(0.0),
+      mpLatticeFactory(nullptr),
+      mInterpolationMatrix(nullptr),
+      mpLatticeWriter(nullptr),
+      mpProbeWriter(nullptr),
+      mpVectorFactory(nullptr),
+      mFilesStarted(false),
+      mLastTime(-DBL_MAX)
+{
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+DecimatedOutputModifier<ELEMENT_DIM, SPACE_DIM>::~DecimatedOutputModifier()
+{
+    delete mpLatticeWriter;
+    delete mpProbeWriter;
+    if (mInterpolationMatrix)
+    {
+        PetscTools::Destroy(mInterpolationMatrix);
+    }
+    delete mpLatticeFactory;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void DecimatedOutputModifier<ELEMENT_DIM, SPACE_DIM>::SetLattice(const c_vector<double, SPACE_DIM>& rLowerCorner,
+                                                                 const c_vector<double, SPACE_DIM>& rUpperCorner,
+                                                                 double spacing,
+                                                                 double outputPeriod)
+{
+    if (ELEMENT_DIM != SPACE_DIM)
+    {
+        EXCEPTION("Lattice output is only available for meshes of full dimension");
+    }
+    if (spacing <= 0.0 || outputPeriod <= 0.0)
+    {
+        EXCEPTION("The lattice spacing and output period must be positive");
+    }
+    for (unsigned dim=0; dim<SPACE_DIM; dim++)
+    {
+        if (rUpperCorner(dim) < rLowerCorner(dim))
+        {
+            EXCEPTION("The upper corner of the lattice must not be below the lower corner");
+        }
+        mLatticeNumPoints(dim) = (unsigned) floor((rUpperCorner(dim) - rLowerCorner(dim))/spacing + 1e-10) + 1u;
+    }
+    mUseLattice = true;
+    mLatticeLowerCorner = rLowerCorner;
+    mLatticeSpacing = spacing;
+    mLatticeOutputPeriod = outputPeriod;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void DecimatedOutputModifier<ELEMENT_DIM, SPACE_DIM>::SetProbeNodes(const std::vector<unsigned>& rProbeNodes)
+{
+    // The HDF5 writer needs these in increasing order
+    mProbeNodes = rProbeNodes;
+    std::sort(mProbeNodes.begin(), mProbeNodes.end());
+    mProbeNodes.erase(std::unique(mProbeNodes.begin(), mProbeNodes.end()), mProbeNodes.end());
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+const std::vector<unsigned>& DecimatedOutputModifier<ELEMENT_DIM, SPACE_DIM>::rGetLatticePointsInMesh() const
+{
+    return mLatticePointsInMesh;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+ChastePoint<SPACE_DIM> DecimatedOutputModifier<ELEMENT_DIM, SPACE_DIM>::GetLatticePoint(unsigned latticeIndex) const
+{
+    ChastePoint<SPACE_DIM> point;
+    for (unsigned dim=0; dim<SPACE_DIM; dim++)
+    {
+        point.rGetLocation()(dim) = mLatticeLowerCorner(dim) + mLatticeSpacing*(latticeIndex % mLatticeNumPoints(dim));
+        latticeIndex /= mLatticeNumPoints(dim);
+    }
+    return point;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void DecimatedOutputModifier<ELEMENT_DIM, SPACE_DIM>::SetUpLattice()
+{
+    unsigned num_lattice_points = 1u;
+    for (unsigned dim=0; dim<SPACE_DIM; dim++)
+    {
+        num_lattice_points *= mLatticeNumPoints(dim);
+    }
+    mpLatticeFactory = new DistributedVectorFactory(num_lattice_points);
+
+    // Each element owned by this process claims the lattice points inside its bounding box which it contains
+    std::map<unsigned, unsigned> local_containing_elements;
+    for (typename AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::ElementIterator iter = mrMesh.GetElementIteratorBegin();
+         iter != mrMesh.GetElementIteratorEnd();
+         ++iter)
+    {
+        if (!mrMesh.CalculateDesignatedOwnershipOfElement(iter->GetIndex()))
+        {
+            continue;
+        }
+
+        c_vector<int, SPACE_DIM> lowest;
+        c_vector<int, SPACE_DIM> num_in_box;
+        unsigned num_candidates = 1u;
+        for (unsigned dim=0; dim<SPACE_DIM; dim++)
+        {
+            double min_location = DBL_MAX;
+            double max_location = -DBL_MAX;
+            for (unsigned i=0; i<ELEMENT_DIM+1; i++)
+            {
+                double location = iter->GetNode(i)->rGetLocation()(dim);
+                min_location = std::min(min_location, location);
+                max_location = std::max(max_location, location);
+            }
+            int low = std::max(0, (int) ceil((min_location - mLatticeLowerCorner(dim))/mLatticeSpacing - 1e-10));
+            int high = std::min((int) mLatticeNumPoints(dim) - 1, (int) floor((max_location - mLatticeLowerCorner(dim))/mLatticeSpacing + 1e-10));
+            lowest(dim) = low;
+            num_in_box(dim) = std::max(0, high - low + 1);
+            num_candidates *= num_in_box(dim);
+        }
+
+        for (unsigned candidate=0; candidate<num_candidates; candidate++)
+        {
+            unsigned lattice_index = 0u;
+            unsigned remainder = candidate;
+            unsigned stride = 1u;
+            for (unsigned dim=0; dim<SPACE_DIM; dim++)
+            {
+                lattice_index += stride*(lowest(dim) + remainder % num_in_box(dim));
+                remainder /= num_in_box(dim);
+                stride *= mLatticeNumPoints(dim);
+            }
+            if (local_containing_elements.find(lattice_index) == local_containing_elements.end()
+                && iter->IncludesPoint(GetLatticePoint(lattice_index)))
+            {
+                local_containing_elements[lattice_index] = iter->GetIndex();
+            }
+        }
+    }
+
+    // Points on the boundary between processes are interpolated by the lowest rank which found them
+    std::vector<unsigned> local_owners(num_lattice_points, UINT_MAX);
+    for (std::map<unsigned, unsigned>::const_iterator it = local_containing_elements.begin();
+         it != local_containing_elements.end();
+         ++it)
+    {
+        local_owners[it->first] = PetscTools::GetMyRank();
+    }
+    std::vector<unsigned> owners(num_lattice_points);
+    MPI_Allreduce(&local_owners[0], &owners[0], num_lattice_points, MPI_UNSIGNED, MPI_MIN, PetscTools::GetWorld());
+
+    mLatticePointsInMesh.clear();
+    for (unsigned lattice_index=0; lattice_index<num_lattice_points; lattice_index++)
+    {
+        if (owners[lattice_index] != UINT_MAX)
+        {
+            mLatticePointsInMesh.push_back(lattice_index);
+        }
+    }
+    if (mLatticePointsInMesh.empty())
+    {
+        EXCEPTION("No lattice points lie inside the mesh");
+    }
+
+    PetscTools::SetupMat(mInterpolationMatrix, num_lattice_points, mpVectorFactory->GetProblemSize(), ELEMENT_DIM+1,
+                         mpLatticeFactory->GetLocalOwnership(), mpVectorFactory->GetLocalOwnership(),
+                         false); // rows may belong to other processes
+    for (std::map<unsigned, unsigned>::const_iterator it = local_containing_elements.begin();
+         it != local_containing_elements.end();
+         ++it)
+    {
+        if (owners[it->first] == PetscTools::GetMyRank())
+        {
+            Element<ELEMENT_DIM, SPACE_DIM>* p_element = mrMesh.GetElement(it->second);
+            c_vector<double, SPACE_DIM+1> weights = p_element->CalculateInterpolationWeights(GetLatticePoint(it->first));
+            for (unsigned i=0; i<ELEMENT_DIM+1; i++)
+            {
+                MatSetValue(mInterpolationMatrix, it->first, p_element->GetNodeGlobalIndex(i), weights(i), INSERT_VALUES);
+            }
+        }
+    }
+    MatAssemblyBegin(mInterpolationMatrix, MAT_FINAL_ASSEMBLY);
+    MatAssemblyEnd(mInterpolationMatrix, MAT_FINAL_ASSEMBLY);
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+std::vector<std::string> DecimatedOutputModifier<ELEMENT_DIM, SPACE_DIM>::GetVariableNames(unsigned problemDim)
+{
+    // As in AbstractCardiacProblem: V, then any further transmembrane potentials, then Phi_e
+    std::vector<std::string> names;
+    names.push_back("V");
+    for (unsigned i=2; i<problemDim; i++)
+    {
+        std::stringstream name;
+        name << "V_" << i;
+        names.push_back(name.str());
+    }
+    if (problemDim > 1)
+    {
+        names.push_back("Phi_e");
+    }
+    return names;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void DecimatedOutputModifier<ELEMENT_DIM, SPACE_DIM>::CreateWriters(unsigned problemDim, double startTime)
+{
+    std::vector<std::string> variable_names = GetVariableNames(problemDim);
+    std::string directory = HeartConfig::Instance()->GetOutputDirectory();
+
+    if (mUseLattice)
+    {
+        mpLatticeWriter = new Hdf5DataWriter(*mpLatticeFactory, directory, mFilename + "_lattice",
+                                             false, // don't wipe the simulation output
+                                             mFilesStarted);
+        if (mpLatticeWriter->IsInDefineMode())
+        {
+            mpLatticeWriter->DefineFixedDimension(mLatticePointsInMesh, mpLatticeFactory->GetProblemSize());
+            for (unsigned i=0; i<variable_names.size(); i++)
+            {
+                mpLatticeWriter->DefineVariable(variable_names[i], "mV");
+            }
+            mpLatticeWriter->DefineUnlimitedDimension("Time", "msec");
+            mpLatticeWriter->EndDefineMode();
+        }
+    }
+
+    if (!mProbeNodes.empty())
+    {
+        // The probe data are cached and written a whole chunk of time steps at a time, so that
+        // frequent probe output involves no collective file access at most time steps
+        mpProbeWriter = new Hdf5DataWriter(*mpVectorFactory, directory, mFilename + "_probes",
+                                           false, // don't wipe the simulation output
+                                           mFilesStarted,
+                                           "Data",
+                                           true); // cache
+        if (mpProbeWriter->IsInDefineMode())
+        {
+            mpProbeWriter->DefineFixedDimension(mProbeNodes, mpVectorFactory->GetProblemSize());
+            for (unsigned i=0; i<variable_names.size(); i++)
+            {
+                mpProbeWriter->DefineVariable(variable_names[i], "mV");
+            }
+            // Sizing the file for the whole simulation (as AbstractCardiacProblem does for the main
+            // output) avoids extending it, collectively, at each output
+            TimeStepper stepper(startTime,
+                                HeartConfig::Instance()->GetSimulationDuration(),
+                                HeartConfig::Instance()->GetPrintingTimeStep());
+            mpProbeWriter->DefineUnlimitedDimension("Time", "msec", stepper.EstimateTimeSteps() + 1);
+            mpProbeWriter->EndDefineMode();
+        }
+    }
+    mFilesStarted = true;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void DecimatedOutputModifier<ELEMENT_DIM, SPACE_DIM>::InitialiseAtStart(DistributedVectorFactory* pVectorFactory)
+{
+    mpVectorFactory = pVectorFactory;
+
+    for (unsigned i=0; i<mProbeNodes.size(); i++)
+    {
+        if (mProbeNodes[i] >= pVectorFactory->GetProblemSize())
+        {
+            EXCEPTION("Probe node " << mProbeNodes[i] << " is not in the mesh");
+        }
+    }
+
+    if (mUseLattice)
+    {
+        if (!Divides(HeartConfig::Instance()->GetPrintingTimeStep(), mLatticeOutputPeriod))
+        {
+            EXCEPTION("The lattice output period must be a multiple of the printing time step");
+        }
+        if (mpLatticeFactory == nullptr)
+        {
+            SetUpLattice();
+        }
+    }
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void DecimatedOutputModifier<ELEMENT_DIM, SPACE_DIM>::ProcessSolutionAtTimeStep(double time, Vec solution, unsigned problemDim)
+{
+    if (time <= mLastTime)
+    {
+        // The initial condition of a later Solve() call has already been written
+        return;
+    }
+    mLastTime = time;
+
+    if (mpLatticeWriter == nullptr && mpProbeWriter == nullptr)
+    {
+        CreateWriters(problemDim, time);
+    }
+    std::vector<std::string> variable_names = GetVariableNames(problemDim);
+
+    if (mpProbeWriter)
+    {
+        if (problemDim == 1)
+        {
+            mpProbeWriter->PutVector(mpProbeWriter->GetVariableByName("V"), solution);
+        }
+        else
+        {
+            std::vector<int> variable_ids;
+            for (unsigned i=0; i<variable_names.size(); i++)
+            {
+                variable_ids.push_back(mpProbeWriter->GetVariableByName(variable_names[i]));
+            }
+            mpProbeWriter->PutStripedVector(variable_ids, solution);
+        }
+        mpProbeWriter->PutUnlimitedVariable(time);
+        mpProbeWriter->AdvanceAlongUnlimitedDimension();
+    }
+
+    // (Divides() is not used here, as it rejects time zero)
+    double num_periods = time/mLatticeOutputPeriod;
+    if (mpLatticeWriter && fabs(num_periods - floor(num_periods + 0.5)) < 1e-8)
+    {
+        Vec lattice_values = mpLatticeFactory->CreateVec();
+        Vec node_values = (problemDim == 1) ? solution : mpVectorFactory->CreateVec();
+        for (unsigned i=0; i<problemDim; i++)
+        {
+            if (problemDim > 1)
+            {
+                VecStrideGather(solution, i, node_values, INSERT_VALUES);
+            }
+            MatMult(mInterpolationMatrix, node_values, lattice_values);
+            mpLatticeWriter->PutVector(mpLatticeWriter->GetVariableByName(variable_names[i]), lattice_values);
+        }
+        if (problemDim > 1)
+        {
+            PetscTools::Destroy(node_values);
+        }
+        PetscTools::Destroy(lattice_values);
+        mpLatticeWriter->PutUnlimitedVariable(time);
+        mpLatticeWriter->AdvanceAlongUnlimitedDimension();
+    }
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void DecimatedOutputModifier<ELEMENT_DIM, SPACE_DIM>::FinaliseAtEnd()
+{
+    if (mpLatticeWriter)
+    {
+        mpLatticeWriter->Close();
+        delete mpLatticeWriter;
+        mpLatticeWriter = nullptr;
+    }
+    if (mpProbeWriter)
+    {
+        mpProbeWriter->Close();
+        delete mpProbeWriter;
+        mpProbeWriter = nullptr;
+    }
+}
+
+// Explicit instantiation
+template class DecimatedOutputModifier<1,1>;
+template class DecimatedOutputModifier<1,2>;
+template class DecimatedOutputModifier<1,3>;
+template class DecimatedOutputModifier<2,2>;
+template class DecimatedOutputModifier<3,3>;
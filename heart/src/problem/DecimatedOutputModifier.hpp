@@ -0,0 +1,198 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef DECIMATEDOUTPUTMODIFIER_HPP_
+#define DECIMATEDOUTPUTMODIFIER_HPP_
+
+#include <vector>
+
+#include "AbstractOutputModifier.hpp"
+#include "AbstractTetrahedralMesh.hpp"
+#include "UblasVectorInclude.hpp"
+
+/**
+ * Reduced-volume output for large simulations, written alongside (or instead of) the full solution.
+ *
+ * Two channels are available, each written to its own HDF5 file in the simulation output directory:
+ *  - a lattice channel, <filename>_lattice.h5, which interpolates the solution onto a regular grid
+ *    (usually much coarser than the mesh) every given output period.  The grid points are indexed
+ *    x-fastest, and only those that lie inside the mesh are stored (as incomplete HDF5 data);
+ *  - a probe channel, <filename>_probes.h5, which stores the solution at a few nodes every time
+ *    the problem produces output (i.e. every printing time step).  Probe values are copied from
+ *    the locally owned part of the solution and cached, so that the file is only written once per
+ *    HDF5 chunk of time steps.  This keeps probe output cheap even at very small printing time steps.
+ *
+ * The interpolation onto the lattice is a precomputed sparse matrix, so each lattice output is a
+ * single parallel matrix-vector product per variable.
+ *
+ * This modifier is normally created by AbstractCardiacProblem from the HeartConfig settings
+ * (see HeartConfig::SetLatticeOutput() and HeartConfig::SetProbeOutputNodes()).
+ *
+ * WARNING:  This class holds a reference to the mesh and so cannot be checkpointed.
+ */
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+class DecimatedOutputModifier : public AbstractOutputModifier
+{
+private:
+    /** The mesh on which the simulation is solved (with the node ordering used at solve time). */
+    AbstractTetrahedralMesh<ELEMENT_DIM,SPACE_DIM>& mrMesh;
+
+    /** Whether the lattice channel is in use. */
+    bool mUseLattice;
+
+    /** The lowest corner of the lattice. */
+    c_vector<double, SPACE_DIM> mLatticeLowerCorner;
+
+    /** The number of lattice points in each direction. */
+    c_vector<unsigned, SPACE_DIM> mLatticeNumPoints;
+
+    /** The lattice spacing. */
+    double mLatticeSpacing;
+
+    /** The simulation time between lattice outputs. */
+    double mLatticeOutputPeriod;
+
+    /** The nodes (indices at solve time) written by the probe channel. */
+    std::vector<unsigned> mProbeNodes;
+
+    /** Layout of vectors over the whole lattice. */
+    DistributedVectorFactory* mpLatticeFactory;
+
+    /** Interpolation from mesh nodes to lattice points. */
+    Mat mInterpolationMatrix;
+
+    /** The lattice points (in increasing order) which lie inside the mesh. */
+    std::vector<unsigned> mLatticePointsInMesh;
+
+    /** Writer for the lattice channel (created at the first output). */
+    Hdf5DataWriter* mpLatticeWriter;
+
+    /** Writer for the probe channel (created at the first output). */
+    Hdf5DataWriter* mpProbeWriter;
+
+    /** The vector factory of the calling problem. */
+    DistributedVectorFactory* mpVectorFactory;
+
+    /** Whether output files were started by an earlier Solve() call, and so should be extended. */
+    bool mFilesStarted;
+
+    /** The time of the last output processed, to avoid repeating it when a simulation is extended. */
+    double mLastTime;
+
+    /** Find the lattice points inside the mesh and assemble mInterpolationMatrix. */
+    void SetUpLattice();
+
+    /**
+     * @return the location of a lattice point
+     * @param latticeIndex  the (x-fastest) index of the point
+     */
+    ChastePoint<SPACE_DIM> GetLatticePoint(unsigned latticeIndex) const;
+
+    /**
+     * Create the writers, or re-open the existing files if extending.
+     *
+     * @param problemDim  The number of unknowns per node in the solution
+     * @param startTime  The time of the first output
+     */
+    void CreateWriters(unsigned problemDim, double startTime);
+
+    /**
+     * @return the names of the variables written for the given problem dimension
+     * @param problemDim  The number of unknowns per node in the solution
+     */
+    static std::vector<std::string> GetVariableNames(unsigned problemDim);
+
+public:
+    /**
+     * Constructor
+     *
+     * @param rFilename  The base name of the HDF5 files produced by this modifier
+     * @param rMesh  The mesh on which the simulation is solved
+     */
+    DecimatedOutputModifier(const std::string& rFilename, AbstractTetrahedralMesh<ELEMENT_DIM,SPACE_DIM>& rMesh);
+
+    /**
+     * Destructor
+     */
+    virtual ~DecimatedOutputModifier();
+
+    /**
+     * Write the solution interpolated onto a regular lattice.
+     *
+     * @param rLowerCorner  the lowest corner of the lattice
+     * @param rUpperCorner  the highest corner of the lattice (included if it is a whole number of spacings away)
+     * @param spacing  the lattice spacing
+     * @param outputPeriod  the simulation time between lattice outputs (a multiple of the printing time step)
+     */
+    void SetLattice(const c_vector<double, SPACE_DIM>& rLowerCorner,
+                    const c_vector<double, SPACE_DIM>& rUpperCorner,
+                    double spacing,
+                    double outputPeriod);
+
+    /**
+     * Write the solution at a few nodes at every printing time step.
+     *
+     * @param rProbeNodes  the node indices (as in memory at solve time)
+     */
+    void SetProbeNodes(const std::vector<unsigned>& rProbeNodes);
+
+    /**
+     * @return the lattice points (in increasing order) which lie inside the mesh; valid after InitialiseAtStart()
+     */
+    const std::vector<unsigned>& rGetLatticePointsInMesh() const;
+
+    /**
+     * Initialise the modifier (set up the interpolation onto the lattice) when the solve loop is starting.
+     *
+     * @param pVectorFactory  The vector factory which is associated with the calling problem's mesh
+     */
+    virtual void InitialiseAtStart(DistributedVectorFactory* pVectorFactory);
+
+    /**
+     * Finalise the modifier (close the files)
+     */
+    virtual void FinaliseAtEnd();
+
+    /**
+     * Process a solution time-step (write to the probe channel, and the lattice channel if due)
+     * @param time  The current simulation time
+     * @param solution  A working copy of the solution at the current time-step.  This is the PETSc vector which is distributed across the processes.
+     * @param problemDim  The calling problem dimension.
+     */
+    virtual void ProcessSolutionAtTimeStep(double time, Vec solution, unsigned problemDim);
+};
+
+#endif /* DECIMATEDOUTPUTMODIFIER_HPP_ */
@@ -0,0 +1,85 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#include "EikonalActivationCalculator.hpp"
+
+#include "Exception.hpp"
+#include "HeartConfig.hpp"
+
+template <unsigned DIM>
+EikonalActivationCalculator<DIM>::EikonalActivationCalculator(AbstractTetrahedralMesh<DIM, DIM>& rMesh,
+                                                              AbstractCardiacTissue<DIM>* pTissue,
+                                                              double conductionVelocity)
+    : DistanceMapCalculator<DIM, DIM>(rMesh),
+      mpTissue(pTissue),
+      mCachedElementIndex(UINT_MAX)
+{
+    assert(mpTissue);
+    if (conductionVelocity <= 0.0)
+    {
+        EXCEPTION("Eikonal conduction velocity must be positive");
+    }
+    c_vector<double, DIM> intra_conductivities;
+    HeartConfig::Instance()->GetIntracellularConductivities(intra_conductivities);
+    mMetricScaling = intra_conductivities[0] / (conductionVelocity * conductionVelocity);
+}
+
+template <unsigned DIM>
+double EikonalActivationCalculator<DIM>::GetEdgeLength(unsigned elementIndex,
+                                                       const Node<DIM>* pFrom,
+                                                       const Node<DIM>* pTo)
+{
+    if (elementIndex != mCachedElementIndex)
+    {
+        mCachedMetric = mMetricScaling * Inverse(mpTissue->rGetIntracellularConductivityTensor(elementIndex));
+        mCachedElementIndex = elementIndex;
+    }
+    c_vector<double, DIM> edge = pTo->rGetLocation() - pFrom->rGetLocation();
+    return sqrt(inner_prod(edge, prod(mCachedMetric, edge)));
+}
+
+template <unsigned DIM>
+void EikonalActivationCalculator<DIM>::ComputeActivationTimes(const std::vector<unsigned>& rSourceNodeIndices,
+                                                              const std::vector<double>& rSourceTimes,
+                                                              std::vector<double>& rActivationTimes)
+{
+    this->ComputeDistanceMap(rSourceNodeIndices, rSourceTimes, rActivationTimes);
+}
+
+// Explicit instantiation
+template class EikonalActivationCalculator<1>;
+template class EikonalActivationCalculator<2>;
+template class EikonalActivationCalculator<3>;
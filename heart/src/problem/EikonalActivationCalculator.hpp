@@ -0,0 +1,112 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef EIKONALACTIVATIONCALCULATOR_HPP_
+#define EIKONALACTIVATIONCALCULATOR_HPP_
+
+#include "UblasIncludes.hpp"
+#include "DistanceMapCalculator.hpp"
+#include "AbstractCardiacTissue.hpp"
+
+/**
+ * Computes activation times over a cardiac mesh by solving the anisotropic eikonal
+ * equation on the graph of mesh edges.
+ *
+ * The wave front travels along the fibres at a given conduction velocity c, and in
+ * other directions at a speed scaled by the square root of the intracellular
+ * conductivity anisotropy, so the time to cross an element edge e is
+ *   t = sqrt( e^T M e ),  where M = (sigma_l / c^2) sigma^-1
+ * with sigma the intracellular conductivity tensor of the element and sigma_l the
+ * default longitudinal intracellular conductivity from HeartConfig.  Activation times
+ * then follow from DistanceMapCalculator's shortest-path search, with the stimulated
+ * nodes as sources starting at their stimulus times.
+ */
+template <unsigned DIM>
+class EikonalActivationCalculator : public DistanceMapCalculator<DIM, DIM>
+{
+private:
+    /** The tissue providing conductivity tensors */
+    AbstractCardiacTissue<DIM>* mpTissue;
+
+    /** sigma_l / c^2, the scaling of the inverse conductivity tensor to give the metric */
+    double mMetricScaling;
+
+    /** Global index of the element whose metric is in #mCachedMetric */
+    unsigned mCachedElementIndex;
+
+    /**
+     * The metric M of element #mCachedElementIndex.  Neighbouring nodes are visited
+     * element by element, so caching one element avoids most tensor inversions.
+     */
+    c_matrix<double, DIM, DIM> mCachedMetric;
+
+protected:
+    /**
+     * @return the time for the wave front to travel along the edge between two nodes.
+     *
+     * @param elementIndex  global index of an element containing both nodes
+     * @param pFrom  the node whose activation time is known
+     * @param pTo  the neighbouring node
+     */
+    double GetEdgeLength(unsigned elementIndex, const Node<DIM>* pFrom, const Node<DIM>* pTo);
+
+public:
+    /**
+     * Constructor
+     *
+     * @param rMesh  the mesh of the tissue
+     * @param pTissue  the tissue, which must be able to supply intracellular conductivity
+     *     tensors for all locally-owned elements
+     * @param conductionVelocity  the conduction velocity along the fibres (cm/ms)
+     */
+    EikonalActivationCalculator(AbstractTetrahedralMesh<DIM, DIM>& rMesh,
+                                AbstractCardiacTissue<DIM>* pTissue,
+                                double conductionVelocity);
+
+    /**
+     * Compute the activation time of every node.
+     *
+     * @param rSourceNodeIndices  the stimulated nodes (only locally-owned nodes need be given)
+     * @param rSourceTimes  the time at which each source is stimulated
+     * @param rActivationTimes  filled in with the activation time of every node, or DBL_MAX
+     *     for nodes the front never reaches
+     */
+    void ComputeActivationTimes(const std::vector<unsigned>& rSourceNodeIndices,
+                                const std::vector<double>& rSourceTimes,
+                                std::vector<double>& rActivationTimes);
+};
+
+#endif /*EIKONALACTIVATIONCALCULATOR_HPP_*/
@@ -0,0 +1,251 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#include "EikonalProblem.hpp"
+
+#include <algorithm>
+#include <cfloat>
+
+#include "EikonalActivationCalculator.hpp"
+#include "Exception.hpp"
+#include "MultiStimulus.hpp"
+#include "OutputFileHandler.hpp"
+#include "PetscTools.hpp"
+#include "RegularStimulus.hpp"
+#include "SimpleStimulus.hpp"
+#include "ZeroStimulus.hpp"
+
+template <unsigned DIM>
+EikonalProblem<DIM>::EikonalProblem(AbstractCardiacCellFactory<DIM>* pCellFactory, bool reactionEikonal)
+    : MonodomainProblem<DIM>(pCellFactory),
+      mReactionEikonal(reactionEikonal),
+      mActivationTimesComputed(false),
+      mCellsDriven(false),
+      mDriveMagnitude(0.0),
+      mDriveDuration(0.0)
+{
+}
+
+template <unsigned DIM>
+EikonalProblem<DIM>::~EikonalProblem()
+{
+}
+
+template <unsigned DIM>
+bool EikonalProblem<DIM>::FindFirstStimulus(boost::shared_ptr<AbstractStimulusFunction> pStimulus,
+                                            double& rStartTime,
+                                            double& rMagnitude,
+                                            double& rDuration)
+{
+    double start_time = DBL_MAX;
+    double magnitude = 0.0;
+    double duration = 0.0;
+    if (!pStimulus || boost::dynamic_pointer_cast<ZeroStimulus>(pStimulus))
+    {
+        return false;
+    }
+    else if (boost::shared_ptr<MultiStimulus> p_multi = boost::dynamic_pointer_cast<MultiStimulus>(pStimulus))
+    {
+        bool found = false;
+        for (unsigned i = 0; i < p_multi->rGetStimuli().size(); i++)
+        {
+            found = FindFirstStimulus(p_multi->rGetStimuli()[i], rStartTime, rMagnitude, rDuration) || found;
+        }
+        return found;
+    }
+    else if (boost::shared_ptr<RegularStimulus> p_regular = boost::dynamic_pointer_cast<RegularStimulus>(pStimulus))
+    {
+        start_time = p_regular->GetStartTime();
+        magnitude = p_regular->GetMagnitude();
+        duration = p_regular->GetDuration();
+    }
+    else if (boost::shared_ptr<SimpleStimulus> p_simple = boost::dynamic_pointer_cast<SimpleStimulus>(pStimulus))
+    {
+        start_time = p_simple->GetStartTime();
+        magnitude = p_simple->GetMagnitude();
+        duration = p_simple->GetDuration();
+    }
+    else
+    {
+        EXCEPTION("Eikonal problems only support simple, regular and multiple stimuli");
+    }
+
+    if (magnitude == 0.0 || duration <= 0.0)
+    {
+        return false;
+    }
+    if (start_time < rStartTime)
+    {
+        rStartTime = start_time;
+        rMagnitude = magnitude;
+        rDuration = duration;
+    }
+    return true;
+}
+
+template <unsigned DIM>
+void EikonalProblem<DIM>::ComputeActivationTimes()
+{
+    if (this->mpCardiacTissue == nullptr)
+    {
+        EXCEPTION("Cardiac tissue is null, Initialise() probably hasn't been called");
+    }
+
+    // The stimulated cells are the sources of the activation wave
+    std::vector<unsigned> source_node_indices;
+    std::vector<double> source_times;
+    double local_magnitude = 0.0;
+    double local_duration = 0.0;
+    DistributedVectorFactory* p_factory = this->mpMesh->GetDistributedVectorFactory();
+    for (unsigned node_index = p_factory->GetLow(); node_index < p_factory->GetHigh(); node_index++)
+    {
+        double start_time = DBL_MAX;
+        double magnitude = 0.0;
+        double duration = 0.0;
+        AbstractCardiacCellInterface* p_cell = this->mpCardiacTissue->GetCardiacCell(node_index);
+        if (FindFirstStimulus(p_cell->GetStimulusFunction(), start_time, magnitude, duration))
+        {
+            source_node_indices.push_back(node_index);
+            source_times.push_back(start_time);
+            local_magnitude = std::min(local_magnitude, magnitude);
+            local_duration = std::max(local_duration, duration);
+        }
+    }
+
+    unsigned local_num_sources = source_node_indices.size();
+    unsigned num_sources;
+    MPI_Allreduce(&local_num_sources, &num_sources, 1, MPI_UNSIGNED, MPI_SUM, PetscTools::GetWorld());
+    if (num_sources == 0)
+    {
+        EXCEPTION("Eikonal problems need at least one stimulated cell to start the activation wave");
+    }
+
+    // Stimuli are negative currents, so the strongest has the smallest magnitude
+    MPI_Allreduce(&local_magnitude, &mDriveMagnitude, 1, MPI_DOUBLE, MPI_MIN, PetscTools::GetWorld());
+    MPI_Allreduce(&local_duration, &mDriveDuration, 1, MPI_DOUBLE, MPI_MAX, PetscTools::GetWorld());
+
+    EikonalActivationCalculator<DIM> calculator(*(this->mpMesh), this->mpCardiacTissue,
+                                                HeartConfig::Instance()->GetEikonalConductionVelocity());
+    calculator.ComputeActivationTimes(source_node_indices, source_times, mActivationTimes);
+    mActivationTimesComputed = true;
+}
+
+template <unsigned DIM>
+const std::vector<double>& EikonalProblem<DIM>::rGetActivationTimes()
+{
+    if (!mActivationTimesComputed)
+    {
+        ComputeActivationTimes();
+    }
+    return mActivationTimes;
+}
+
+template <unsigned DIM>
+bool EikonalProblem<DIM>::IsReactionEikonal() const
+{
+    return mReactionEikonal;
+}
+
+template <unsigned DIM>
+void EikonalProblem<DIM>::WriteActivationTimes()
+{
+    if (HeartConfig::Instance()->GetOutputDirectory() == "")
+    {
+        EXCEPTION("Output directory not set");
+    }
+    OutputFileHandler handler(HeartConfig::Instance()->GetOutputDirectory(), false);
+    if (PetscTools::AmMaster())
+    {
+        // The activation times are known everywhere, so the master writes them all, in the original node order
+        const std::vector<unsigned>& r_permutation = this->mpMesh->rGetNodePermutation();
+        out_stream p_file = handler.OpenOutputFile("ActivationTimeMap.dat");
+        for (unsigned node_index = 0; node_index < mActivationTimes.size(); node_index++)
+        {
+            unsigned mesh_index = r_permutation.empty() ? node_index : r_permutation[node_index];
+            double time = mActivationTimes[mesh_index];
+            (*p_file) << ((time == DBL_MAX) ? -1.0 : time) << "\n";
+        }
+        p_file->close();
+    }
+}
+
+template <unsigned DIM>
+void EikonalProblem<DIM>::DriveCellsWithActivationTimes()
+{
+    DistributedVectorFactory* p_factory = this->mpMesh->GetDistributedVectorFactory();
+    for (unsigned node_index = p_factory->GetLow(); node_index < p_factory->GetHigh(); node_index++)
+    {
+        double start_time = DBL_MAX;
+        double magnitude = 0.0;
+        double duration = 0.0;
+        AbstractCardiacCellInterface* p_cell = this->mpCardiacTissue->GetCardiacCell(node_index);
+        if (mActivationTimes[node_index] != DBL_MAX
+            && !FindFirstStimulus(p_cell->GetStimulusFunction(), start_time, magnitude, duration))
+        {
+            boost::shared_ptr<AbstractStimulusFunction> p_stimulus(
+                new SimpleStimulus(mDriveMagnitude, mDriveDuration, mActivationTimes[node_index]));
+            p_cell->SetIntracellularStimulusFunction(p_stimulus);
+        }
+    }
+    this->mpCardiacTissue->SetConductivityModifier(&mZeroConductivityModifier);
+    mCellsDriven = true;
+}
+
+template <unsigned DIM>
+void EikonalProblem<DIM>::Solve()
+{
+    if (!mActivationTimesComputed)
+    {
+        ComputeActivationTimes();
+    }
+    if (mReactionEikonal)
+    {
+        if (!mCellsDriven)
+        {
+            DriveCellsWithActivationTimes();
+        }
+        MonodomainProblem<DIM>::Solve();
+    }
+    if (this->mPrintOutput)
+    {
+        WriteActivationTimes();
+    }
+}
+
+// Explicit instantiation
+template class EikonalProblem<1>;
+template class EikonalProblem<2>;
+template class EikonalProblem<3>;
@@ -0,0 +1,188 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef EIKONALPROBLEM_HPP_
+#define EIKONALPROBLEM_HPP_
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+#include "MonodomainProblem.hpp"
+#include "AbstractConductivityModifier.hpp"
+#include "AbstractStimulusFunction.hpp"
+
+/**
+ * A cheap alternative to a monodomain simulation when only activation times are
+ * needed.  Activation times are computed from the stimuli of the cells by the
+ * anisotropic eikonal equation (see EikonalActivationCalculator), using the conduction
+ * velocity given by HeartConfig::GetEikonalConductionVelocity() and the intracellular
+ * conductivity tensors of the tissue.
+ *
+ * In plain eikonal mode Solve() only writes the activation map, to ActivationTimeMap.dat
+ * in the output directory (one line per node, in the original node order, with -1 for
+ * nodes which are never activated).
+ *
+ * In reaction-eikonal mode every cell which isn't stimulated already is given a
+ * stimulus at its activation time, and the monodomain problem is then solved with the
+ * diffusion switched off, so that the cell models only respond to the wave front
+ * imposed by the eikonal solution.  Only the first activation of each cell is driven.
+ *
+ * Eikonal problems cannot be checkpointed.
+ */
+template <unsigned DIM>
+class EikonalProblem : public MonodomainProblem<DIM>
+{
+private:
+    /**
+     * Switches the diffusion off in reaction-eikonal mode, by making every
+     * conductivity tensor zero.
+     */
+    class ZeroConductivityModifier : public AbstractConductivityModifier<DIM, DIM>
+    {
+    private:
+        /** The zero tensor returned for every element */
+        c_matrix<double, DIM, DIM> mZeroTensor;
+
+    public:
+        /** Constructor */
+        ZeroConductivityModifier()
+            : mZeroTensor(zero_matrix<double>(DIM, DIM))
+        {
+        }
+
+        /**
+         * @return a zero conductivity tensor.
+         * @param elementIndex  the index of the element
+         * @param rOriginalConductivity  the unmodified conductivity tensor
+         * @param domainIndex  the domain of the conductivity
+         */
+        c_matrix<double, DIM, DIM>& rCalculateModifiedConductivityTensor(unsigned elementIndex,
+                                                                         const c_matrix<double, DIM, DIM>& rOriginalConductivity,
+                                                                         unsigned domainIndex)
+        {
+            return mZeroTensor;
+        }
+    };
+
+    /** Whether to drive the cell models with the activation times */
+    bool mReactionEikonal;
+
+    /** Whether #mActivationTimes have been computed */
+    bool mActivationTimesComputed;
+
+    /** Whether the cells have been given their activation stimuli and the diffusion switched off */
+    bool mCellsDriven;
+
+    /** The activation time of every node (DBL_MAX if never activated) */
+    std::vector<double> mActivationTimes;
+
+    /** The strongest stimulus magnitude of any stimulated cell, used to drive the others */
+    double mDriveMagnitude;
+
+    /** The longest stimulus duration of any stimulated cell, used to drive the others */
+    double mDriveDuration;
+
+    /** The conductivity modifier used in reaction-eikonal mode */
+    ZeroConductivityModifier mZeroConductivityModifier;
+
+    /**
+     * Find the first pulse of a (possibly combined) stimulus.
+     *
+     * @param pStimulus  the stimulus of a cell
+     * @param rStartTime  the start time of the first pulse, if earlier than its value on entry
+     * @param rMagnitude  the magnitude of that pulse
+     * @param rDuration  the duration of that pulse
+     * @return whether the stimulus has any pulse
+     */
+    bool FindFirstStimulus(boost::shared_ptr<AbstractStimulusFunction> pStimulus,
+                           double& rStartTime,
+                           double& rMagnitude,
+                           double& rDuration);
+
+    /**
+     * Write the activation map to the output directory.
+     */
+    void WriteActivationTimes();
+
+    /**
+     * Give each local cell which isn't stimulated a stimulus at its activation time,
+     * and switch off the diffusion.
+     */
+    void DriveCellsWithActivationTimes();
+
+public:
+    /**
+     * Constructor
+     *
+     * @param pCellFactory  User defined cell factory which shows how the pde should
+     *   create cells.
+     * @param reactionEikonal  whether to drive the cell models with the activation times
+     *   (defaults to false, so only activation times are computed)
+     */
+    EikonalProblem(AbstractCardiacCellFactory<DIM>* pCellFactory, bool reactionEikonal=false);
+
+    /**
+     * Destructor
+     */
+    virtual ~EikonalProblem();
+
+    /**
+     * Compute the activation time of every node from the stimuli of the cells.
+     * Initialise() must have been called first.
+     */
+    void ComputeActivationTimes();
+
+    /**
+     * @return the activation time of every node (DBL_MAX for nodes which are never
+     * activated), computing them if necessary.
+     */
+    const std::vector<double>& rGetActivationTimes();
+
+    /**
+     * @return whether the cell models are driven with the activation times.
+     */
+    bool IsReactionEikonal() const;
+
+    /**
+     * Compute and write the activation times and, in reaction-eikonal mode, solve the
+     * cell models driven by them.
+     *
+     * Note that this hides AbstractCardiacProblem::Solve().
+     */
+    void Solve();
+};
+
+#endif /*EIKONALPROBLEM_HPP_*/
@@ -37,7 +37,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "LabelBasedContractionCellFactory.hpp"
 
 template <unsigned DIM>
-ElectroMechanicsProblemDefinition<DIM>::ElectroMechanicsProblemDefinition(QuadraticMesh<DIM>& rMesh)
+ElectroMechanicsProblemDefinition<DIM>::ElectroMechanicsProblemDefinition(AbstractTetrahedralMesh<DIM,DIM>& rMesh)
     : SolidMechanicsProblemDefinition<DIM>(rMesh),
       mContractionModelOdeTimeStep(-1.0),
       mMechanicsSolveTimestep(-1.0),
@@ -158,7 +158,7 @@ void ElectroMechanicsProblemDefinition<DIM>::SetContractionCellFactory(AbstractC
     assert(mpContractionCellFactory == NULL);
 
     mpContractionCellFactory = pCellFactory;
-    mpContractionCellFactory->SetMechanicsMesh(static_cast<QuadraticMesh<DIM>*>(&(this->mrMesh)));
+    mpContractionCellFactory->SetMechanicsMesh(&(this->mrMesh));
 }
 
 template <unsigned DIM>
@@ -131,7 +131,7 @@ public:
      * Constructor
      * @param rMesh the mesh
      */
-    ElectroMechanicsProblemDefinition(QuadraticMesh<DIM>& rMesh);
+    ElectroMechanicsProblemDefinition(AbstractTetrahedralMesh<DIM,DIM>& rMesh);
 
     /** Destructor */
     virtual ~ElectroMechanicsProblemDefinition();
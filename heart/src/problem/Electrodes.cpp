@@ -212,11 +212,11 @@ void Electrodes<DIM>::ComputeElectrodesAreasAndCheckEquality(unsigned dimensionI
         local_right_area /= 2.0;
     }
 
-    int mpi_ret = MPI_Allreduce(&local_left_area, &mLeftElectrodeArea, 1, MPI_DOUBLE, MPI_SUM, PETSC_COMM_WORLD);
+    int mpi_ret = MPI_Allreduce(&local_left_area, &mLeftElectrodeArea, 1, MPI_DOUBLE, MPI_SUM, PetscTools::GetWorld());
     UNUSED_OPT(mpi_ret);
     assert(mpi_ret == MPI_SUCCESS);
 
-    mpi_ret = MPI_Allreduce(&local_right_area, &mRightElectrodeArea, 1, MPI_DOUBLE, MPI_SUM, PETSC_COMM_WORLD);
+    mpi_ret = MPI_Allreduce(&local_right_area, &mRightElectrodeArea, 1, MPI_DOUBLE, MPI_SUM, PetscTools::GetWorld());
     assert(mpi_ret == MPI_SUCCESS);
 
     if (mLeftElectrodeArea != mRightElectrodeArea)
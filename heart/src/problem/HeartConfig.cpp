@@ -56,7 +56,9 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <fstream>
 #include <istream>
 #include <map>
+#include <sstream>
 #include <string>
+#include <vector>
 
 #include <xsd/cxx/tree/exceptions.hxx>
 #include "XmlTools.hpp"
@@ -217,11 +219,16 @@ HeartConfig* HeartConfig::Instance()
 HeartConfig::HeartConfig()
         : mUseMassLumping(false),
           mUseMassLumpingForPrecond(false),
+          mUseMatrixFreeOperators(false),
           mUseFixedNumberIterations(false),
-          mEvaluateNumItsEveryNSolves(UINT_MAX)
+          mEvaluateNumItsEveryNSolves(UINT_MAX),
+          mFixedNumberIterationsLinearSolver(0u),
+          mLinearSolverInitialGuessType(PREVIOUS_SOLUTION),
+          mLinearSolverInitialGuessNumPreviousSolutions(4u)
 {
     assert(mpInstance.get() == NULL);
     mUseFixedSchemaLocation = true;
+    mReadParametersOnMasterOnly = false;
     SetDefaultSchemaLocations();
 
     mpParameters = CreateDefaultParameters();
@@ -240,6 +247,10 @@ HeartConfig::HeartConfig()
     mIndexEndo = UINT_MAX - 3u;
 
     mUseReactionDiffusionOperatorSplitting = false;
+    mUseExplicitMonodomainSolver = false;
+    mUseCompactConductivityTensors = false;
+    mLatticeOutputSpacing = 0.0;
+    mLatticeOutputPeriod = 0.0;
 
     /// \todo #1703 This defaults should be set in HeartConfigDefaults.hpp
     mTissueIdentifiers.insert(0);
@@ -302,10 +313,12 @@ void HeartConfig::Write(bool useArchiveLocationInfo, std::string subfolderName)
     map["cp33"].schema = "ChasteParameters_3_3.xsd";
     map["cp34"].name = "https://chaste.comlab.ox.ac.uk/nss/parameters/3_4";
     map["cp34"].schema = "ChasteParameters_3_4.xsd";
+    map["cp2017"].name = "https://chaste.comlab.ox.ac.uk/nss/parameters/2017_1";
+    map["cp2017"].schema = "ChasteParameters_2017_1.xsd";
     // We use 'cp' as prefix for the latest version to avoid having to change saved
     // versions for comparison at every release.
-    map["cp"].name = "https://chaste.comlab.ox.ac.uk/nss/parameters/2017_1";
-    map["cp"].schema = "ChasteParameters_2017_1.xsd";
+    map["cp"].name = "https://chaste.comlab.ox.ac.uk/nss/parameters/2026_1";
+    map["cp"].schema = "ChasteParameters_2026_1.xsd";
 
     cp::ChasteParameters(*p_parameters_file, *mpParameters, map);
 
@@ -367,7 +380,7 @@ void HeartConfig::CopySchema(const std::string& rToDirectory)
     // in a situation where it can handle EXCEPTION()s nicely, e.g.
     // TRY_IF_MASTER(CopySchema(...));
 
-    std::string schema_name("ChasteParameters_2017_1.xsd");
+    std::string schema_name("ChasteParameters_2026_1.xsd");
     FileFinder schema_location("heart/src/io/" + schema_name, RelativeTo::ChasteSourceRoot);
     if (!schema_location.Exists())
     {
@@ -404,6 +417,7 @@ void HeartConfig::SetDefaultSchemaLocations()
     mSchemaLocations["https://chaste.comlab.ox.ac.uk/nss/parameters/3_3"] = root_dir + "ChasteParameters_3_3.xsd";
     mSchemaLocations["https://chaste.comlab.ox.ac.uk/nss/parameters/3_4"] = root_dir + "ChasteParameters_3_4.xsd";
     mSchemaLocations["https://chaste.comlab.ox.ac.uk/nss/parameters/2017_1"] = root_dir + "ChasteParameters_2017_1.xsd";
+    mSchemaLocations["https://chaste.comlab.ox.ac.uk/nss/parameters/2026_1"] = root_dir + "ChasteParameters_2026_1.xsd";
 }
 
 unsigned HeartConfig::GetVersionFromNamespace(const std::string& rNamespaceUri)
@@ -451,7 +465,89 @@ void HeartConfig::SetUseFixedSchemaLocation(bool useFixedSchemaLocation)
     mUseFixedSchemaLocation = useFixedSchemaLocation;
 }
 
+void HeartConfig::SetReadParametersOnMasterOnly(bool masterOnly)
+{
+    mReadParametersOnMasterOnly = masterOnly;
+}
+
+bool HeartConfig::GetReadParametersOnMasterOnly() const
+{
+    return mReadParametersOnMasterOnly;
+}
+
 boost::shared_ptr<cp::chaste_parameters_type> HeartConfig::ReadFile(const std::string& rFileName)
+{
+    if (mReadParametersOnMasterOnly && PetscTools::IsParallel())
+    {
+        return ReadFileOnMaster(rFileName);
+    }
+    return ParseFile(rFileName);
+}
+
+/**
+ * Broadcast a string from the master process to all the others.
+ *
+ * @param rString  the string to send (on the master) or receive (elsewhere)
+ */
+static void BroadcastStringFromMaster(std::string& rString)
+{
+    unsigned length = rString.size();
+    MPI_Bcast(&length, 1, MPI_UNSIGNED, 0, PetscTools::GetWorld());
+    std::vector<char> buffer(rString.begin(), rString.end());
+    buffer.resize(length);
+    if (length > 0)
+    {
+        MPI_Bcast(&buffer[0], length, MPI_CHAR, 0, PetscTools::GetWorld());
+    }
+    rString.assign(buffer.begin(), buffer.end());
+}
+
+boost::shared_ptr<cp::chaste_parameters_type> HeartConfig::ReadFileOnMaster(const std::string& rFileName)
+{
+    boost::shared_ptr<cp::chaste_parameters_type> p_params;
+    std::string xml;
+    std::string error_message;
+    if (PetscTools::AmMaster())
+    {
+        try
+        {
+            p_params = ParseFile(rFileName);
+
+            // ParseFile() has upgraded the parameters to the latest namespace
+            ::xml_schema::namespace_infomap map;
+            map["cp"].name = "https://chaste.comlab.ox.ac.uk/nss/parameters/2026_1";
+            XmlTools::Finalizer finalizer(true);
+            std::ostringstream xml_stream;
+            cp::ChasteParameters(xml_stream, *p_params, map, "UTF-8", ::xml_schema::flags::dont_initialize);
+            xml = xml_stream.str();
+        }
+        catch (const Exception& e)
+        {
+            error_message = e.GetShortMessage();
+        }
+    }
+
+    BroadcastStringFromMaster(error_message);
+    if (!error_message.empty())
+    {
+        // Make sure we don't store invalid parameters
+        mpParameters.reset();
+        EXCEPTION(error_message);
+    }
+
+    BroadcastStringFromMaster(xml);
+    if (!PetscTools::AmMaster())
+    {
+        // The master has already validated this
+        XmlTools::Finalizer finalizer(true);
+        std::istringstream xml_stream(xml);
+        p_params = boost::shared_ptr<cp::chaste_parameters_type>(
+            cp::ChasteParameters(xml_stream, ::xml_schema::flags::dont_initialize | ::xml_schema::flags::dont_validate));
+    }
+    return p_params;
+}
+
+boost::shared_ptr<cp::chaste_parameters_type> HeartConfig::ParseFile(const std::string& rFileName)
 {
     // Determine whether to use the schema path given in the input XML, or our own schema
     ::xml_schema::properties props;
@@ -505,10 +601,14 @@ boost::shared_ptr<cp::chaste_parameters_type> HeartConfig::ReadFile(const std::s
         {
             XmlTools::SetNamespace(p_doc.get(), p_root_elt, "https://chaste.comlab.ox.ac.uk/nss/parameters/3_4");
         }
-        if (version < 2017001) // Not the latest release
+        if (version < 2017001) // Not the latest in release 2017.1
         {
             XmlTools::SetNamespace(p_doc.get(), p_root_elt, "https://chaste.comlab.ox.ac.uk/nss/parameters/2017_1");
         }
+        if (version < 2026001) // Not the latest release
+        {
+            XmlTools::SetNamespace(p_doc.get(), p_root_elt, "https://chaste.comlab.ox.ac.uk/nss/parameters/2026_1");
+        }
         // Parse DOM to object model
         boost::shared_ptr<cp::chaste_parameters_type> p_params(cp::ChasteParameters(*p_doc, ::xml_schema::flags::dont_initialize, props));
         // Get rid of the DOM stuff
@@ -1641,6 +1741,12 @@ const char* HeartConfig::GetKSPSolver() const
             return "symmlq";
         case cp::ksp_solver_type::chebychev:
             return "chebychev";
+        case cp::ksp_solver_type::pipecg:
+            return "pipecg";
+        case cp::ksp_solver_type::groppcg:
+            return "groppcg";
+        case cp::ksp_solver_type::pgmres:
+            return "pgmres";
     }
     // LCOV_EXCL_START
     EXCEPTION("Unknown ksp solver");
@@ -1668,6 +1774,8 @@ const char* HeartConfig::GetKSPPreconditioner() const
             return "ldufactorisation";
         case cp::ksp_preconditioner_type::twolevelsblockdiagonal:
             return "twolevelsblockdiagonal";
+        case cp::ksp_preconditioner_type::tissuebathmultilevel:
+            return "tissuebathmultilevel";
         case cp::ksp_preconditioner_type::none:
             return "none";
     }
@@ -2446,6 +2554,21 @@ void HeartConfig::SetKSPSolver(const char* kspSolver, bool warnOfChange)
         mpParameters->Numerical().KSPSolver().set(cp::ksp_solver_type::chebychev);
         return;
     }
+    if (strcmp(kspSolver, "pipecg") == 0)
+    {
+        mpParameters->Numerical().KSPSolver().set(cp::ksp_solver_type::pipecg);
+        return;
+    }
+    if (strcmp(kspSolver, "groppcg") == 0)
+    {
+        mpParameters->Numerical().KSPSolver().set(cp::ksp_solver_type::groppcg);
+        return;
+    }
+    if (strcmp(kspSolver, "pgmres") == 0)
+    {
+        mpParameters->Numerical().KSPSolver().set(cp::ksp_solver_type::pgmres);
+        return;
+    }
 
     EXCEPTION("Unknown solver type provided");
 }
@@ -2483,6 +2606,11 @@ void HeartConfig::SetKSPPreconditioner(const char* kspPreconditioner)
         mpParameters->Numerical().KSPPreconditioner().set(cp::ksp_preconditioner_type::twolevelsblockdiagonal);
         return;
     }
+    if (strcmp(kspPreconditioner, "tissuebathmultilevel") == 0)
+    {
+        mpParameters->Numerical().KSPPreconditioner().set(cp::ksp_preconditioner_type::tissuebathmultilevel);
+        return;
+    }
     if (strcmp(kspPreconditioner, "blockdiagonal") == 0)
     {
         mpParameters->Numerical().KSPPreconditioner().set(cp::ksp_preconditioner_type::blockdiagonal);
@@ -2871,6 +2999,16 @@ bool HeartConfig::GetUseMassLumpingForPrecond()
     return mUseMassLumpingForPrecond;
 }
 
+void HeartConfig::SetUseMatrixFreeOperators(bool useMatrixFree)
+{
+    mUseMatrixFreeOperators = useMatrixFree;
+}
+
+bool HeartConfig::GetUseMatrixFreeOperators()
+{
+    return mUseMatrixFreeOperators;
+}
+
 void HeartConfig::SetUseReactionDiffusionOperatorSplitting(bool useOperatorSplitting)
 {
     mUseReactionDiffusionOperatorSplitting = useOperatorSplitting;
@@ -2881,10 +3019,84 @@ bool HeartConfig::GetUseReactionDiffusionOperatorSplitting()
     return mUseReactionDiffusionOperatorSplitting;
 }
 
-void HeartConfig::SetUseFixedNumberIterationsLinearSolver(bool useFixedNumberIterations, unsigned evaluateNumItsEveryNSolves)
+void HeartConfig::SetUseExplicitMonodomainSolver(bool useExplicit)
+{
+    mUseExplicitMonodomainSolver = useExplicit;
+}
+
+bool HeartConfig::GetUseExplicitMonodomainSolver()
+{
+    return mUseExplicitMonodomainSolver;
+}
+
+void HeartConfig::SetUseCompactConductivityTensors(bool useCompact)
+{
+    mUseCompactConductivityTensors = useCompact;
+}
+
+bool HeartConfig::GetUseCompactConductivityTensors()
+{
+    return mUseCompactConductivityTensors;
+}
+
+void HeartConfig::SetLatticeOutput(const c_vector<double, 3>& rLowerCorner,
+                                   const c_vector<double, 3>& rUpperCorner,
+                                   double spacing,
+                                   double outputPeriod)
+{
+    if (spacing <= 0.0 || outputPeriod <= 0.0)
+    {
+        EXCEPTION("The lattice spacing and output period must be positive");
+    }
+    mLatticeOutputLowerCorner.assign(rLowerCorner.begin(), rLowerCorner.end());
+    mLatticeOutputUpperCorner.assign(rUpperCorner.begin(), rUpperCorner.end());
+    mLatticeOutputSpacing = spacing;
+    mLatticeOutputPeriod = outputPeriod;
+}
+
+void HeartConfig::CancelLatticeOutput()
+{
+    mLatticeOutputLowerCorner.clear();
+    mLatticeOutputUpperCorner.clear();
+}
+
+bool HeartConfig::IsLatticeOutputRequested()
+{
+    return !mLatticeOutputLowerCorner.empty();
+}
+
+void HeartConfig::GetLatticeOutput(c_vector<double, 3>& rLowerCorner,
+                                   c_vector<double, 3>& rUpperCorner,
+                                   double& rSpacing,
+                                   double& rOutputPeriod)
+{
+    assert(IsLatticeOutputRequested());
+    std::copy(mLatticeOutputLowerCorner.begin(), mLatticeOutputLowerCorner.end(), rLowerCorner.begin());
+    std::copy(mLatticeOutputUpperCorner.begin(), mLatticeOutputUpperCorner.end(), rUpperCorner.begin());
+    rSpacing = mLatticeOutputSpacing;
+    rOutputPeriod = mLatticeOutputPeriod;
+}
+
+void HeartConfig::SetProbeOutputNodes(const std::vector<unsigned>& rNodes)
+{
+    mProbeOutputNodes = rNodes;
+}
+
+bool HeartConfig::IsProbeOutputRequested()
+{
+    return !mProbeOutputNodes.empty();
+}
+
+void HeartConfig::GetProbeOutputNodes(std::vector<unsigned>& rNodes)
+{
+    rNodes = mProbeOutputNodes;
+}
+
+void HeartConfig::SetUseFixedNumberIterationsLinearSolver(bool useFixedNumberIterations, unsigned evaluateNumItsEveryNSolves, unsigned fixedNumberIterations)
 {
     mUseFixedNumberIterations = useFixedNumberIterations;
     mEvaluateNumItsEveryNSolves = evaluateNumItsEveryNSolves;
+    mFixedNumberIterationsLinearSolver = fixedNumberIterations;
 }
 
 bool HeartConfig::GetUseFixedNumberIterationsLinearSolver()
@@ -2897,6 +3109,31 @@ unsigned HeartConfig::GetEvaluateNumItsEveryNSolves()
     return mEvaluateNumItsEveryNSolves;
 }
 
+unsigned HeartConfig::GetFixedNumberIterationsLinearSolver()
+{
+    return mFixedNumberIterationsLinearSolver;
+}
+
+void HeartConfig::SetLinearSolverInitialGuess(InitialGuessType type, unsigned numPreviousSolutions)
+{
+    if (type == PROJECTION && numPreviousSolutions == 0u)
+    {
+        EXCEPTION("The projection initial guess needs at least one previous solution");
+    }
+    mLinearSolverInitialGuessType = type;
+    mLinearSolverInitialGuessNumPreviousSolutions = numPreviousSolutions;
+}
+
+InitialGuessType HeartConfig::GetLinearSolverInitialGuessType()
+{
+    return mLinearSolverInitialGuessType;
+}
+
+unsigned HeartConfig::GetLinearSolverInitialGuessNumPreviousSolutions()
+{
+    return mLinearSolverInitialGuessNumPreviousSolutions;
+}
+
 //
 // Purkinje methods
 //
@@ -2952,6 +3189,19 @@ void HeartConfig::SetPurkinjeConductivity(double conductivity)
     mpParameters->Physiological().Purkinje()->Conductivity().set(purkinje_conductivity);
 }
 
+double HeartConfig::GetEikonalConductionVelocity() const
+{
+    CHECK_EXISTS(mpParameters->Physiological().EikonalConductionVelocity().present(),
+                 "Physiological/EikonalConductionVelocity");
+    return mpParameters->Physiological().EikonalConductionVelocity().get();
+}
+
+void HeartConfig::SetEikonalConductionVelocity(double velocity)
+{
+    XSD_CREATE_WITH_FIXED_ATTR1(cp::velocity_type, velocity_object, velocity, "cm/ms");
+    mpParameters->Physiological().EikonalConductionVelocity().set(velocity_object);
+}
+
 /**********************************************************************
  *                                                                    *
  *                                                                    *
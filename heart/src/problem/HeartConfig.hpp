@@ -45,7 +45,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "UblasVectorInclude.hpp"
 
-#include "ChasteParameters_2017_1.hpp"
+#include "ChasteParameters_2026_1.hpp"
 
 #include "AbstractStimulusFunction.hpp"
 #include "AbstractChasteRegion.hpp"
@@ -53,6 +53,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ChasteCuboid.hpp"
 #include "ChasteEllipsoid.hpp"
 #include "DistributedTetrahedralMeshPartitionType.hpp"
+#include "InitialGuessGenerator.hpp"
 #include "PetscTools.hpp"
 #include "FileFinder.hpp"
 
@@ -61,8 +62,9 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <boost/serialization/split_member.hpp>
 #include <boost/serialization/map.hpp>
 #include <boost/serialization/set.hpp>
+#include <boost/serialization/vector.hpp>
 
-namespace cp = chaste::parameters::v2017_1;
+namespace cp = chaste::parameters::v2026_1;
 
 // Forward declaration to avoid circular includes
 class HeartFileFinder;
@@ -125,6 +127,35 @@ private:
             archive & mUseFixedNumberIterations;
             archive & mEvaluateNumItsEveryNSolves;
         }
+        if (version > 2)
+        {
+            archive & mUseMatrixFreeOperators;
+        }
+        if (version > 3)
+        {
+            archive & mFixedNumberIterationsLinearSolver;
+        }
+        if (version > 4)
+        {
+            archive & mLinearSolverInitialGuessType;
+            archive & mLinearSolverInitialGuessNumPreviousSolutions;
+        }
+        if (version > 5)
+        {
+            archive & mUseExplicitMonodomainSolver;
+        }
+        if (version > 6)
+        {
+            archive & mLatticeOutputLowerCorner;
+            archive & mLatticeOutputUpperCorner;
+            archive & mLatticeOutputSpacing;
+            archive & mLatticeOutputPeriod;
+            archive & mProbeOutputNodes;
+        }
+        if (version > 7)
+        {
+            archive & mUseCompactConductivityTensors;
+        }
 
         PetscTools::Barrier("HeartConfig::save");
     }
@@ -159,6 +190,35 @@ private:
             archive & mUseFixedNumberIterations;
             archive & mEvaluateNumItsEveryNSolves;
         }
+        if (version > 2)
+        {
+            archive & mUseMatrixFreeOperators;
+        }
+        if (version > 3)
+        {
+            archive & mFixedNumberIterationsLinearSolver;
+        }
+        if (version > 4)
+        {
+            archive & mLinearSolverInitialGuessType;
+            archive & mLinearSolverInitialGuessNumPreviousSolutions;
+        }
+        if (version > 5)
+        {
+            archive & mUseExplicitMonodomainSolver;
+        }
+        if (version > 6)
+        {
+            archive & mLatticeOutputLowerCorner;
+            archive & mLatticeOutputUpperCorner;
+            archive & mLatticeOutputSpacing;
+            archive & mLatticeOutputPeriod;
+            archive & mProbeOutputNodes;
+        }
+        if (version > 7)
+        {
+            archive & mUseCompactConductivityTensors;
+        }
     }
     BOOST_SERIALIZATION_SPLIT_MEMBER()
 
@@ -217,6 +277,24 @@ public:
      */
     void SetFixedSchemaLocations(const SchemaLocationsMap& rSchemaLocations);
 
+    /**
+     * Set whether parameters files are read and validated by the master
+     * process only, which then broadcasts the parsed configuration to the
+     * other processes. This stops every process opening the parameters file
+     * and its schemas, which dominates start-up on large process counts.
+     * When set, SetParametersFile() (and resuming from a checkpoint) must
+     * be called collectively. Defaults to false; not archived.
+     *
+     * @param masterOnly  whether to read on the master only
+     */
+    void SetReadParametersOnMasterOnly(bool masterOnly=true);
+
+    /**
+     * @return whether parameters files are read on the master only (see
+     * SetReadParametersOnMasterOnly()).
+     */
+    bool GetReadParametersOnMasterOnly() const;
+
     /**
      * #mpParameters  is set to a new context associated with a parameters file
      * @param rFileName The name of the parameters file
@@ -254,6 +332,29 @@ public:
      */
     boost::shared_ptr<cp::chaste_parameters_type> ReadFile(const std::string& rFileName);
 
+private:
+    /**
+     * Parse and validate an XML parameters file on this process, upgrading
+     * it to the latest namespace. Helper method for ReadFile().
+     *
+     * @param rFileName  Name of XML file
+     * @return the parameters
+     */
+    boost::shared_ptr<cp::chaste_parameters_type> ParseFile(const std::string& rFileName);
+
+    /**
+     * Parse an XML parameters file on the master with ParseFile(), and
+     * broadcast the result to the other processes as serialised XML, which
+     * they read without validation. Exceptions on the master are
+     * replicated on every process. Helper method for ReadFile().
+     *
+     * @param rFileName  Name of XML file
+     * @return the parameters
+     */
+    boost::shared_ptr<cp::chaste_parameters_type> ReadFileOnMaster(const std::string& rFileName);
+
+public:
+
     /**
      * Throw away the current instance by resetting auto_ptr #mpInstance to NULL.
      * "New" another #mpInstance
@@ -594,8 +695,8 @@ public:
     bool GetUseRelativeTolerance() const; /**< @return true if we are using KSP relative tolerance*/
     double GetRelativeTolerance() const;  /**< @return KSP relative tolerance (or throw if we are using absolute)*/
 
-    const char* GetKSPSolver() const; /**< @return name of -ksp_type from {"gmres", "cg", "symmlq"}*/
-    const char* GetKSPPreconditioner() const; /**< @return name of -pc_type from {"jacobi", "bjacobi", "hypre", "ml", "spai", "blockdiagonal", "ldufactorisation", "none"}*/
+    const char* GetKSPSolver() const; /**< @return name of -ksp_type from {"gmres", "cg", "symmlq", "chebychev", "pipecg", "groppcg", "pgmres"}*/
+    const char* GetKSPPreconditioner() const; /**< @return name of -pc_type from {"jacobi", "bjacobi", "hypre", "ml", "spai", "blockdiagonal", "ldufactorisation", "tissuebathmultilevel", "none"}*/
 
     DistributedTetrahedralMeshPartitionType::type GetMeshPartitioning() const; /**< @return the mesh partitioning method to use */
 
@@ -743,12 +844,55 @@ public:
      */
     bool GetUseMassLumpingForPrecond();
 
+    /**
+     * @return whether to apply the FE operators matrix-free (see SetUseMatrixFreeOperators()).
+     */
+    bool GetUseMatrixFreeOperators();
+
     /**
      *  @return whether to use Strang operator splitting of the reaction and diffusion terms (see
      *  Set method documentation).
      */
     bool GetUseReactionDiffusionOperatorSplitting();
 
+    /**
+     *  @return whether to use the fully explicit monodomain solver (see Set method documentation).
+     */
+    bool GetUseExplicitMonodomainSolver();
+
+    /**
+     *  @return whether conductivity tensors are stored compactly and built when needed (see Set method documentation).
+     */
+    bool GetUseCompactConductivityTensors();
+
+    /**
+     *  @return whether the solution should also be written on a regular lattice (see SetLatticeOutput()).
+     */
+    bool IsLatticeOutputRequested();
+
+    /**
+     * Get the lattice output settings (see SetLatticeOutput()).
+     *
+     * @param rLowerCorner  filled in with the lowest corner of the lattice
+     * @param rUpperCorner  filled in with the highest corner of the lattice
+     * @param rSpacing  filled in with the lattice spacing
+     * @param rOutputPeriod  filled in with the simulation time between lattice outputs
+     */
+    void GetLatticeOutput(c_vector<double, 3>& rLowerCorner,
+                          c_vector<double, 3>& rUpperCorner,
+                          double& rSpacing,
+                          double& rOutputPeriod);
+
+    /**
+     *  @return whether the solution should also be written at every printing time step at a few nodes (see SetProbeOutputNodes()).
+     */
+    bool IsProbeOutputRequested();
+
+    /**
+     * @param rNodes  filled in with the probe nodes (see SetProbeOutputNodes())
+     */
+    void GetProbeOutputNodes(std::vector<unsigned>& rNodes);
+
     /**
      *  @return whether to use a fixed number of iterations in the linear solver
      */
@@ -759,6 +903,23 @@ public:
      */
     unsigned GetEvaluateNumItsEveryNSolves();
 
+    /**
+     *  @return the number of iterations to perform in every linear solve when using a fixed number
+     *  of iterations, or zero if this is decided by periodic residual-based solves (see Set method documentation).
+     */
+    unsigned GetFixedNumberIterationsLinearSolver();
+
+    /**
+     *  @return how the initial guess for each linear solve is formed from previous solutions
+     *  (see Set method documentation).
+     */
+    InitialGuessType GetLinearSolverInitialGuessType();
+
+    /**
+     *  @return the number of previous solutions used by the PROJECTION initial guess.
+     */
+    unsigned GetLinearSolverInitialGuessNumPreviousSolutions();
+
 
     ///////////////////////////////////////////////////////////////
     //
@@ -1038,14 +1199,14 @@ public:
     void SetUseAbsoluteTolerance(double absoluteTolerance);
 
     /** Set the type of KSP solver as with the flag "-ksp_type"
-     * @param kspSolver  a string from {"gmres", "cg", "symmlq"}
+     * @param kspSolver  a string from {"gmres", "cg", "symmlq", "chebychev", "pipecg", "groppcg", "pgmres"}
      * @param warnOfChange  Warn if this set is changing the current value because the calling
      * code may be (silently) overwriting a user setting
      */
     void SetKSPSolver(const char* kspSolver, bool warnOfChange=false);
 
     /** Set the type of preconditioner as with the flag "-pc_type"
-     * @param kspPreconditioner  a string from {"jacobi", "bjacobi", "hypre", "ml", "spai", "blockdiagonal", "ldufactorisation", "none"}
+     * @param kspPreconditioner  a string from {"jacobi", "bjacobi", "hypre", "ml", "spai", "blockdiagonal", "ldufactorisation", "tissuebathmultilevel", "none"}
      */
     void SetKSPPreconditioner(const char* kspPreconditioner);
 
@@ -1171,6 +1332,17 @@ public:
      */
     void SetUseMassLumpingForPrecond(bool useMassLumping = true);
 
+    /**
+     * Apply the FE operators (the LHS and mass matrices) matrix-free: element matrices are
+     * recomputed on the fly inside each matrix-vector product and never stored. This saves
+     * the memory of the assembled matrices at the cost of extra work per linear solver
+     * iteration. Only the diagonal of the operator is available for preconditioning, so the
+     * "jacobi" preconditioner is used. Currently supported by the monodomain solver only.
+     *
+     * @param useMatrixFree Whether to use matrix-free operators
+     */
+    void SetUseMatrixFreeOperators(bool useMatrixFree = true);
+
     /**
      * Use Strang operator splitting of the diffusion (conductivity) term and the reaction (ionic current) term,
      * instead of solving the full reaction-diffusion PDE. This does NOT refer to operator splitting of the
@@ -1181,13 +1353,75 @@ public:
      */
     void SetUseReactionDiffusionOperatorSplitting(bool useOperatorSplitting = true);
 
+    /**
+     * Use a fully explicit monodomain solver (ExplicitMonodomainSolver), which integrates the diffusion
+     * term with a lumped mass matrix and a Runge-Kutta-Chebyshev scheme, instead of solving a linear
+     * system at each PDE time step. Each step then needs only matrix-vector products and no global
+     * reductions.
+     *
+     * @param useExplicit Whether to use the explicit solver (defaults to true).
+     */
+    void SetUseExplicitMonodomainSolver(bool useExplicit = true);
+
+    /**
+     * Store each element's conductivity tensor as its fibre orientation (a unit quaternion for
+     * orthotropic media, the fibre direction for axisymmetric media) plus an index into a table of
+     * the distinct conductivities, and build the tensor when the assembler asks for it.  This needs
+     * about half the memory of storing full tensors on meshes with fibre orientation or conductivity
+     * heterogeneities.  Orthotropic fibre-sheet-normal frames are assumed to be orthonormal.
+     *
+     * @param useCompact Whether to use compact storage (defaults to true).
+     */
+    void SetUseCompactConductivityTensors(bool useCompact = true);
+
+    /**
+     * Also write the solution interpolated onto a regular lattice, to <prefix>_lattice.h5 in the output
+     * directory (see DecimatedOutputModifier). This is intended for visualisation of very large meshes,
+     * where the full output can then be switched off or written rarely. Only the first SPACE_DIM
+     * components of the corners are used.
+     *
+     * @param rLowerCorner  the lowest corner of the lattice (cm)
+     * @param rUpperCorner  the highest corner of the lattice (cm)
+     * @param spacing  the lattice spacing (cm)
+     * @param outputPeriod  the simulation time between lattice outputs (ms); a multiple of the printing time step
+     */
+    void SetLatticeOutput(const c_vector<double, 3>& rLowerCorner,
+                          const c_vector<double, 3>& rUpperCorner,
+                          double spacing,
+                          double outputPeriod);
+
+    /**
+     * Stop writing the solution on a lattice (see SetLatticeOutput()).
+     */
+    void CancelLatticeOutput();
+
+    /**
+     * Also write the solution at the given nodes at every printing time step, to <prefix>_probes.h5 in
+     * the output directory (see DecimatedOutputModifier). An empty vector switches this off.
+     *
+     * @param rNodes  the probe node indices (as in memory at solve time)
+     */
+    void SetProbeOutputNodes(const std::vector<unsigned>& rNodes);
+
     /**
      * Set the use of fixed number of iterations in the linear solver
      *
      * @param useFixedNumberIterations Whether to use a fixed number of iterations for the linear solver
      * @param evaluateNumItsEveryNSolves Perform a solve with convergence-based stop criteria every n solves to decide how many iterations perform for the next n-1 solves. Default is perfoming a single evaluation at the beginning of the simulation.
+     * @param fixedNumberIterations If non-zero, perform exactly this many iterations in every solve, so that no residual norm
+     *     (and hence no global reduction for it) is ever computed; evaluateNumItsEveryNSolves is then ignored. Default is zero.
+     */
+    void SetUseFixedNumberIterationsLinearSolver(bool useFixedNumberIterations = true, unsigned evaluateNumItsEveryNSolves=UINT_MAX, unsigned fixedNumberIterations=0u);
+
+    /**
+     * Set how the initial guess for each linear solve is formed from the solutions at previous
+     * time steps: the previous solution (the default), linear or quadratic extrapolation in time,
+     * or the combination of the last few solutions minimising the residual of the new system.
+     *
+     * @param type  how to form the initial guess
+     * @param numPreviousSolutions  the number of previous solutions used by the PROJECTION method
      */
-    void SetUseFixedNumberIterationsLinearSolver(bool useFixedNumberIterations = true, unsigned evaluateNumItsEveryNSolves=UINT_MAX);
+    void SetLinearSolverInitialGuess(InitialGuessType type, unsigned numPreviousSolutions=4u);
 
     /**
      * @return whether HeartConfig has a drug concentration and any IC50s set up
@@ -1262,6 +1496,20 @@ public:
      */
     void SetPurkinjeConductivity(double conductivity);
 
+    /**
+     * @return the conduction velocity along the fibres used by the eikonal
+     * simulation domains (units cm/ms).
+     */
+    double GetEikonalConductionVelocity() const;
+
+    /**
+     * Set the conduction velocity along the fibres used by the eikonal simulation
+     * domains.  Velocities in other directions are scaled by the square root of the
+     * intracellular conductivity anisotropy.
+     * @param velocity  conduction velocity (units cm/ms)
+     */
+    void SetEikonalConductionVelocity(double velocity);
+
 private:
     // Only to be accessed by the tests
     friend class TestHeartConfig;
@@ -1286,6 +1534,9 @@ private:
      */
     bool mUseFixedSchemaLocation;
 
+    /** Whether parameters files are read on the master only (see SetReadParametersOnMasterOnly()). */
+    bool mReadParametersOnMasterOnly;
+
     /**
      * Fraction of epicardial layer
      */
@@ -1331,12 +1582,42 @@ private:
      */
     bool mUseMassLumpingForPrecond;
 
+    /**
+     * Flag telling whether to apply the FE operators matrix-free.
+     */
+    bool mUseMatrixFreeOperators;
+
     /**
      *  @return whether to use Strang operator splitting of the diffusion and reaction terms (see
      *  Set method documentation).
      */
     bool mUseReactionDiffusionOperatorSplitting;
 
+    /**
+     *  Whether to use the fully explicit monodomain solver (see Set method documentation).
+     */
+    bool mUseExplicitMonodomainSolver;
+
+    /**
+     *  Whether to store conductivity tensors compactly (see Set method documentation).
+     */
+    bool mUseCompactConductivityTensors;
+
+    /** Lowest corner of the output lattice, empty if no lattice output is requested (see SetLatticeOutput()). */
+    std::vector<double> mLatticeOutputLowerCorner;
+
+    /** Highest corner of the output lattice (see SetLatticeOutput()). */
+    std::vector<double> mLatticeOutputUpperCorner;
+
+    /** Spacing of the output lattice (see SetLatticeOutput()). */
+    double mLatticeOutputSpacing;
+
+    /** Simulation time between lattice outputs (see SetLatticeOutput()). */
+    double mLatticeOutputPeriod;
+
+    /** Nodes written at every printing time step (see SetProbeOutputNodes()). */
+    std::vector<unsigned> mProbeOutputNodes;
+
     /**
      *  Map defining bath conductivity for multiple bath regions
      */
@@ -1364,6 +1645,18 @@ private:
      */
     unsigned mEvaluateNumItsEveryNSolves;
 
+    /**
+     * If non-zero, the number of iterations to perform in every linear solve when
+     * using a fixed number of iterations (overriding mEvaluateNumItsEveryNSolves).
+     */
+    unsigned mFixedNumberIterationsLinearSolver;
+
+    /** How the initial guess for each linear solve is formed from previous solutions. */
+    InitialGuessType mLinearSolverInitialGuessType;
+
+    /** The number of previous solutions used by the PROJECTION initial guess. */
+    unsigned mLinearSolverInitialGuessNumPreviousSolutions;
+
     /**
      * CheckSimulationIsDefined is a convenience method for checking if the "<"Simulation">" element
      * has been defined and therefore is safe to use the Simulation().get() pointer to access
@@ -1388,7 +1681,7 @@ private:
 };
 
 
-BOOST_CLASS_VERSION(HeartConfig, 2)
+BOOST_CLASS_VERSION(HeartConfig, 8)
 #include "SerializationExportWrapper.hpp"
 // Declare identifier for the serializer
 CHASTE_CLASS_EXPORT(HeartConfig)
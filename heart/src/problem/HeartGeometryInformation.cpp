@@ -62,9 +62,14 @@ HeartGeometryInformation<SPACE_DIM>::HeartGeometryInformation(AbstractTetrahedra
     GetNodesAtSurface(rEpiFile, mEpiSurface, indexFromZero);
     GetNodesAtSurface(rEndoFile, mEndoSurface, indexFromZero);
 
-    // Compute the distance map of each surface
-    distance_calculator.ComputeDistanceMap(mEpiSurface, mDistMapEpicardium);
-    distance_calculator.ComputeDistanceMap(mEndoSurface, mDistMapEndocardium);
+    // Compute the distance map of each surface, together to share the parallel communication
+    std::vector<std::vector<unsigned> > surfaces;
+    surfaces.push_back(mEpiSurface);
+    surfaces.push_back(mEndoSurface);
+    std::vector<std::vector<double> > distance_maps;
+    distance_calculator.ComputeDistanceMaps(surfaces, distance_maps);
+    mDistMapEpicardium.swap(distance_maps[0]);
+    mDistMapEndocardium.swap(distance_maps[1]);
     mNumberOfSurfacesProvided = 2;
 }
 
@@ -97,9 +102,15 @@ HeartGeometryInformation<SPACE_DIM>::HeartGeometryInformation (AbstractTetrahedr
     {
         GetNodesAtSurface(rRVFile, mRVSurface, indexFromZero);
     }
-    distance_calculator.ComputeDistanceMap(mEpiSurface, mDistMapEpicardium);
-    distance_calculator.ComputeDistanceMap(mLVSurface, mDistMapLeftVentricle);
-    distance_calculator.ComputeDistanceMap(mRVSurface, mDistMapRightVentricle);
+    std::vector<std::vector<unsigned> > surfaces;
+    surfaces.push_back(mEpiSurface);
+    surfaces.push_back(mLVSurface);
+    surfaces.push_back(mRVSurface);
+    std::vector<std::vector<double> > distance_maps;
+    distance_calculator.ComputeDistanceMaps(surfaces, distance_maps);
+    mDistMapEpicardium.swap(distance_maps[0]);
+    mDistMapLeftVentricle.swap(distance_maps[1]);
+    mDistMapRightVentricle.swap(distance_maps[2]);
 
     mNumberOfSurfacesProvided = 3;
 }
@@ -440,8 +451,8 @@ ChasteCuboid<SPACE_DIM> HeartGeometryInformation<SPACE_DIM>::CalculateBoundingBo
     //Share the local data and reduce over all processes
     c_vector<double, SPACE_DIM> global_minimum_point;
     c_vector<double, SPACE_DIM> global_maximum_point;
-    MPI_Allreduce(&my_minimum_point[0], &global_minimum_point[0], SPACE_DIM, MPI_DOUBLE, MPI_MIN, PETSC_COMM_WORLD);
-    MPI_Allreduce(&my_maximum_point[0], &global_maximum_point[0], SPACE_DIM, MPI_DOUBLE, MPI_MAX, PETSC_COMM_WORLD);
+    MPI_Allreduce(&my_minimum_point[0], &global_minimum_point[0], SPACE_DIM, MPI_DOUBLE, MPI_MIN, PetscTools::GetWorld());
+    MPI_Allreduce(&my_maximum_point[0], &global_maximum_point[0], SPACE_DIM, MPI_DOUBLE, MPI_MAX, PetscTools::GetWorld());
 
     ChastePoint<SPACE_DIM> min(global_minimum_point);
     ChastePoint<SPACE_DIM> max(global_maximum_point);
@@ -39,6 +39,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ReplicatableVector.hpp"
 #include "MonodomainSolver.hpp"
 #include "OperatorSplittingMonodomainSolver.hpp"
+#include "ExplicitMonodomainSolver.hpp"
 
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
@@ -62,11 +63,20 @@ AbstractDynamicLinearPdeSolver<ELEMENT_DIM, SPACE_DIM, 1>* MonodomainProblem<ELE
      * required in the solvers it should all work OK.
      */
 
-    if (HeartConfig::Instance()->GetUseReactionDiffusionOperatorSplitting())
+    if (HeartConfig::Instance()->GetUseExplicitMonodomainSolver())
     {
-        return new OperatorSplittingMonodomainSolver<ELEMENT_DIM,SPACE_DIM>(this->mpMesh,
-                                                                            mpMonodomainTissue,
-                                                                            this->mpBoundaryConditionsContainer.get());
+        return new ExplicitMonodomainSolver<ELEMENT_DIM,SPACE_DIM>(this->mpMesh,
+                                                                   mpMonodomainTissue,
+                                                                   this->mpBoundaryConditionsContainer.get());
+    }
+    else if (HeartConfig::Instance()->GetUseReactionDiffusionOperatorSplitting())
+    {
+        OperatorSplittingMonodomainSolver<ELEMENT_DIM,SPACE_DIM>* p_solver
+            = new OperatorSplittingMonodomainSolver<ELEMENT_DIM,SPACE_DIM>(this->mpMesh,
+                                                                           mpMonodomainTissue,
+                                                                           this->mpBoundaryConditionsContainer.get());
+        p_solver->SetFuseHalfSteps(mFuseOperatorSplittingHalfSteps);
+        return p_solver;
     }
     else
     {
@@ -79,14 +89,16 @@ AbstractDynamicLinearPdeSolver<ELEMENT_DIM, SPACE_DIM, 1>* MonodomainProblem<ELE
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 MonodomainProblem<ELEMENT_DIM, SPACE_DIM>::MonodomainProblem(AbstractCardiacCellFactory<ELEMENT_DIM,SPACE_DIM>* pCellFactory)
         : AbstractCardiacProblem<ELEMENT_DIM, SPACE_DIM, 1>(pCellFactory),
-          mpMonodomainTissue(NULL)
+          mpMonodomainTissue(NULL),
+          mFuseOperatorSplittingHalfSteps(false)
 {
 }
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 MonodomainProblem<ELEMENT_DIM, SPACE_DIM>::MonodomainProblem()
     : AbstractCardiacProblem<ELEMENT_DIM, SPACE_DIM, 1>(),
-      mpMonodomainTissue(NULL)
+      mpMonodomainTissue(NULL),
+      mFuseOperatorSplittingHalfSteps(false)
 {
 }
 
@@ -102,6 +114,18 @@ MonodomainTissue<ELEMENT_DIM,SPACE_DIM> * MonodomainProblem<ELEMENT_DIM, SPACE_D
     return mpMonodomainTissue;
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void MonodomainProblem<ELEMENT_DIM, SPACE_DIM>::SetFuseOperatorSplittingHalfSteps(bool fuseHalfSteps)
+{
+    mFuseOperatorSplittingHalfSteps = fuseHalfSteps;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool MonodomainProblem<ELEMENT_DIM, SPACE_DIM>::GetFuseOperatorSplittingHalfSteps() const
+{
+    return mFuseOperatorSplittingHalfSteps;
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void MonodomainProblem<ELEMENT_DIM, SPACE_DIM>::WriteInfo(double time)
 {
@@ -73,6 +73,12 @@ protected:
     /** The monodomain tissue object. */
     MonodomainTissue<ELEMENT_DIM,SPACE_DIM>* mpMonodomainTissue;
 
+    /**
+     * Whether the operator splitting solver fuses the half steps of the cell models,
+     * see SetFuseOperatorSplittingHalfSteps(). Not archived.
+     */
+    bool mFuseOperatorSplittingHalfSteps;
+
 public:
     /** @return Created monodomain tissue. */
     AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>* CreateCardiacTissue();
@@ -100,6 +106,19 @@ public:
     /** @return the monodomain PDE */
     MonodomainTissue<ELEMENT_DIM,SPACE_DIM> * GetMonodomainTissue();
 
+    /**
+     * Set whether, when reaction-diffusion operator splitting is used, the second half step of
+     * the cell models for one timestep is solved together with the first half step for the next
+     * (see OperatorSplittingMonodomainSolver::SetFuseHalfSteps()). Defaults to false. Must be
+     * called before Solve().
+     *
+     * @param fuseHalfSteps  whether to fuse the half steps
+     */
+    void SetFuseOperatorSplittingHalfSteps(bool fuseHalfSteps=true);
+
+    /** @return whether the operator splitting solver fuses half steps, see SetFuseOperatorSplittingHalfSteps() */
+    bool GetFuseOperatorSplittingHalfSteps() const;
+
     /**
      *  Print out time and max/min voltage values at current time.
      *
@@ -56,7 +56,8 @@ AbstractDynamicLinearPdeSolver<ELEMENT_DIM, SPACE_DIM, 2>* MonodomainPurkinjePro
     assert(p_tissue);
     return new MonodomainPurkinjeSolver<ELEMENT_DIM,SPACE_DIM>(p_mesh,
                                                                p_tissue,
-                                                               this->mpBoundaryConditionsContainer.get());
+                                                               this->mpBoundaryConditionsContainer.get(),
+                                                               mUsePurkinjeTreeSolver);
 }
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
@@ -92,7 +93,8 @@ Vec MonodomainPurkinjeProblem<ELEMENT_DIM, SPACE_DIM>::CreateInitialCondition()
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 MonodomainPurkinjeProblem<ELEMENT_DIM, SPACE_DIM>::MonodomainPurkinjeProblem(AbstractPurkinjeCellFactory<ELEMENT_DIM,SPACE_DIM>* pCellFactory)
         : AbstractCardiacProblem<ELEMENT_DIM, SPACE_DIM, 2>(pCellFactory),
-          mPurkinjeVoltageColumnId(UNSIGNED_UNSET)
+          mPurkinjeVoltageColumnId(UNSIGNED_UNSET),
+      mUsePurkinjeTreeSolver(false)
 {
 }
 
@@ -101,7 +103,8 @@ MonodomainPurkinjeProblem<ELEMENT_DIM, SPACE_DIM>::MonodomainPurkinjeProblem(Abs
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 MonodomainPurkinjeProblem<ELEMENT_DIM, SPACE_DIM>::MonodomainPurkinjeProblem()
     : AbstractCardiacProblem<ELEMENT_DIM, SPACE_DIM, 2>(),
-      mPurkinjeVoltageColumnId(UNSIGNED_UNSET)
+      mPurkinjeVoltageColumnId(UNSIGNED_UNSET),
+      mUsePurkinjeTreeSolver(false)
 {
 }
 // LCOV_EXCL_STOP
@@ -112,6 +115,13 @@ MonodomainPurkinjeProblem<ELEMENT_DIM, SPACE_DIM>::~MonodomainPurkinjeProblem()
 }
 
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void MonodomainPurkinjeProblem<ELEMENT_DIM, SPACE_DIM>::SetUsePurkinjeTreeSolver(bool useTreeSolver)
+{
+    mUsePurkinjeTreeSolver = useTreeSolver;
+}
+
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void MonodomainPurkinjeProblem<ELEMENT_DIM, SPACE_DIM>::WriteInfo(double time)
 {
@@ -74,6 +74,9 @@ protected:
     /** Used by the writer. */
     unsigned mPurkinjeVoltageColumnId;
 
+    /** Whether the solver should solve the Purkinje block with a PurkinjeTreeSolver. */
+    bool mUsePurkinjeTreeSolver;
+
     /** @return newly created our tissue object. */
     AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>* CreateCardiacTissue();
 
@@ -107,6 +110,14 @@ public:
      */
     virtual ~MonodomainPurkinjeProblem();
 
+    /**
+     * Solve the Purkinje voltage directly with a PurkinjeTreeSolver, which requires the cable
+     * elements to form a tree (or a forest).  Must be called before Initialise().
+     *
+     * @param useTreeSolver  whether to use the tree solver
+     */
+    void SetUsePurkinjeTreeSolver(bool useTreeSolver);
+
     /**
      *  Print out time and max/min voltage values at current time.
      *
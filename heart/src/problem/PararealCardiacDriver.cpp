@@ -0,0 +1,363 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "PararealCardiacDriver.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include "AbstractCvodeCell.hpp"
+#include "Exception.hpp"
+#include "HeartConfig.hpp"
+#include "MathsCustomFunctions.hpp"
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
+MPI_Comm PararealCardiacDriver<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::SplitCommunicators(unsigned numTimeProcesses)
+{
+    MPI_Comm world = PetscTools::GetWorld();
+    unsigned num_procs = PetscTools::GetNumProcs();
+    unsigned rank = PetscTools::GetMyRank();
+    if (numTimeProcesses == 0 || num_procs % numTimeProcesses != 0)
+    {
+        EXCEPTION("The number of time processes (" << numTimeProcesses
+                  << ") must divide the number of processes (" << num_procs << ")");
+    }
+    unsigned num_space_procs = num_procs/numTimeProcesses;
+
+    MPI_Comm space_communicator;
+    MPI_Comm time_communicator;
+    MPI_Comm_split(world, rank/num_space_procs, rank, &space_communicator);
+    MPI_Comm_split(world, rank%num_space_procs, rank, &time_communicator);
+    PetscTools::SetWorld(space_communicator);
+    return time_communicator;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
+PararealCardiacDriver<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::PararealCardiacDriver(
+        AbstractCardiacProblem<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>* pProblem,
+        MPI_Comm timeCommunicator)
+    : mpProblem(pProblem),
+      mTimeCommunicator(timeCommunicator),
+      mNumSlicesPerProcess(1u),
+      mCoarseOdeTimeStep(10.0*HeartConfig::Instance()->GetOdeTimeStep()),
+      mCoarsePdeTimeStep(10.0*HeartConfig::Instance()->GetPdeTimeStep()),
+      mTolerance(1e-5),
+      mMaxIterations(0u),
+      mNumIterations(0u)
+{
+    assert(mpProblem);
+    int rank, size;
+    MPI_Comm_rank(mTimeCommunicator, &rank);
+    MPI_Comm_size(mTimeCommunicator, &size);
+    mTimeRank = rank;
+    mNumTimeProcesses = size;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
+void PararealCardiacDriver<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::SetCoarseTimeSteps(double odeTimeStep, double pdeTimeStep)
+{
+    mCoarseOdeTimeStep = odeTimeStep;
+    mCoarsePdeTimeStep = pdeTimeStep;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
+void PararealCardiacDriver<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::SetNumSlicesPerProcess(unsigned numSlices)
+{
+    if (numSlices == 0)
+    {
+        EXCEPTION("Each time process needs at least one time slice");
+    }
+    mNumSlicesPerProcess = numSlices;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
+void PararealCardiacDriver<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::SetTolerance(double tolerance)
+{
+    mTolerance = tolerance;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
+void PararealCardiacDriver<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::SetMaxIterations(unsigned maxIterations)
+{
+    mMaxIterations = maxIterations;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
+unsigned PararealCardiacDriver<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::GetNumIterations() const
+{
+    return mNumIterations;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
+unsigned PararealCardiacDriver<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::GetTimeRank() const
+{
+    return mTimeRank;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
+void PararealCardiacDriver<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::GetState(std::vector<double>& rState)
+{
+    Vec solution = mpProblem->GetSolution();
+    PetscInt local_size;
+    VecGetLocalSize(solution, &local_size);
+    double* p_solution;
+    VecGetArray(solution, &p_solution);
+    rState.assign(p_solution, p_solution + local_size);
+    VecRestoreArray(solution, &p_solution);
+
+    const std::vector<AbstractCardiacCellInterface*>& r_cells = mpProblem->GetTissue()->rGetCellsDistributed();
+    for (unsigned i=0; i<r_cells.size(); i++)
+    {
+        std::vector<double> cell_state = r_cells[i]->GetStdVecStateVariables();
+        rState.insert(rState.end(), cell_state.begin(), cell_state.end());
+    }
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
+void PararealCardiacDriver<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::SetState(const std::vector<double>& rState, double time)
+{
+    Vec solution = mpProblem->GetSolution();
+    PetscInt local_size;
+    VecGetLocalSize(solution, &local_size);
+    double* p_solution;
+    VecGetArray(solution, &p_solution);
+    std::copy(rState.begin(), rState.begin() + local_size, p_solution);
+    VecRestoreArray(solution, &p_solution);
+    mpProblem->SetSolution(solution, time);
+
+    unsigned offset = local_size;
+    const std::vector<AbstractCardiacCellInterface*>& r_cells = mpProblem->GetTissue()->rGetCellsDistributed();
+    for (unsigned i=0; i<r_cells.size(); i++)
+    {
+        unsigned num_variables = r_cells[i]->GetNumberOfStateVariables();
+        r_cells[i]->SetStateVariables(std::vector<double>(rState.begin() + offset,
+                                                          rState.begin() + offset + num_variables));
+        offset += num_variables;
+#ifdef CHASTE_CVODE
+        if (dynamic_cast<AbstractCvodeCell*>(r_cells[i]))
+        {
+            // The state may have jumped without the time changing
+            static_cast<AbstractCvodeCell*>(r_cells[i])->ResetSolver();
+        }
+#endif // CHASTE_CVODE
+    }
+    assert(offset == rState.size());
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
+void PararealCardiacDriver<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::SetCellTimeSteps(double odeTimeStep, double pdeTimeStep)
+{
+    const std::vector<AbstractCardiacCellInterface*>& r_cells = mpProblem->GetTissue()->rGetCellsDistributed();
+    for (unsigned i=0; i<r_cells.size(); i++)
+    {
+        r_cells[i]->SetTimestep(odeTimeStep);
+#ifdef CHASTE_CVODE
+        if (dynamic_cast<AbstractCvodeCell*>(r_cells[i]))
+        {
+            r_cells[i]->SetTimestep(pdeTimeStep);
+        }
+#endif // CHASTE_CVODE
+    }
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
+void PararealCardiacDriver<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::Propagate(std::vector<double>& rState,
+                                                                           double startTime,
+                                                                           double endTime,
+                                                                           bool coarse)
+{
+    HeartConfig* p_config = HeartConfig::Instance();
+    const double fine_ode_time_step = p_config->GetOdeTimeStep();
+    const double fine_pde_time_step = p_config->GetPdeTimeStep();
+    const double fine_printing_time_step = p_config->GetPrintingTimeStep();
+
+    SetState(rState, startTime);
+    if (coarse)
+    {
+        p_config->SetOdePdeAndPrintingTimeSteps(mCoarseOdeTimeStep, mCoarsePdeTimeStep, mCoarsePdeTimeStep);
+        SetCellTimeSteps(mCoarseOdeTimeStep, mCoarsePdeTimeStep);
+    }
+    p_config->SetSimulationDuration(endTime);
+    mpProblem->Solve();
+    if (coarse)
+    {
+        p_config->SetOdePdeAndPrintingTimeSteps(fine_ode_time_step, fine_pde_time_step, fine_printing_time_step);
+        SetCellTimeSteps(fine_ode_time_step, fine_pde_time_step);
+    }
+    GetState(rState);
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
+void PararealCardiacDriver<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::Solve(double endTime)
+{
+    // Everyone starts from the time of the first time process
+    double start_time = mpProblem->GetCurrentTime();
+    MPI_Bcast(&start_time, 1, MPI_DOUBLE, 0, mTimeCommunicator);
+
+    const unsigned num_slices = mNumTimeProcesses*mNumSlicesPerProcess;
+    const double slice_length = (endTime - start_time)/num_slices;
+    if (slice_length <= 0.0)
+    {
+        EXCEPTION("End time should be in the future");
+    }
+    if (!Divides(HeartConfig::Instance()->GetPrintingTimeStep(), slice_length)
+        || !Divides(mCoarsePdeTimeStep, slice_length))
+    {
+        EXCEPTION("Each time slice (" << slice_length << " ms) must be a whole number of printing time steps and of coarse PDE time steps");
+    }
+
+    mpProblem->PrintOutput(false);
+    if (mpProblem->GetSolution() == NULL)
+    {
+        mpProblem->SetSolution(mpProblem->CreateInitialCondition(), start_time);
+    }
+    std::vector<double> state;
+    GetState(state);
+
+    unsigned local_size = state.size();
+    unsigned min_size;
+    unsigned max_size;
+    MPI_Allreduce(&local_size, &min_size, 1, MPI_UNSIGNED, MPI_MIN, mTimeCommunicator);
+    MPI_Allreduce(&local_size, &max_size, 1, MPI_UNSIGNED, MPI_MAX, mTimeCommunicator);
+    if (min_size != max_size)
+    {
+        EXCEPTION("Each time process must hold an identically partitioned copy of the problem");
+    }
+
+    const unsigned first_slice = mTimeRank*mNumSlicesPerProcess;
+    const bool has_previous = (mTimeRank > 0);
+    const bool has_next = (mTimeRank + 1 < mNumTimeProcesses);
+    // For each of our slices: the state at its start, and the fine and coarse propagations of it
+    std::vector<std::vector<double> > start_states(mNumSlicesPerProcess);
+    std::vector<std::vector<double> > fine_states(mNumSlicesPerProcess);
+    std::vector<std::vector<double> > coarse_states(mNumSlicesPerProcess);
+
+    // Initial guess from a coarse sweep
+    if (has_previous)
+    {
+        MPI_Recv(&state[0], local_size, MPI_DOUBLE, mTimeRank-1, 0, mTimeCommunicator, MPI_STATUS_IGNORE);
+    }
+    for (unsigned i=0; i<mNumSlicesPerProcess; i++)
+    {
+        double slice_start = start_time + (first_slice + i)*slice_length;
+        start_states[i] = state;
+        Propagate(state, slice_start, slice_start + slice_length, true);
+        coarse_states[i] = state;
+    }
+    if (has_next)
+    {
+        MPI_Send(&state[0], local_size, MPI_DOUBLE, mTimeRank+1, 0, mTimeCommunicator);
+    }
+    std::vector<double> end_state = state;
+
+    const unsigned max_iterations = (mMaxIterations == 0) ? num_slices : std::min(mMaxIterations, num_slices);
+    mNumIterations = 0;
+    while (mNumIterations < max_iterations)
+    {
+        // Slices before this one started from the exact state in the last iteration, and are done
+        const unsigned num_exact_slices = mNumIterations;
+        mNumIterations++;
+
+        // Fine propagation of all our slices at once
+        for (unsigned i=0; i<mNumSlicesPerProcess; i++)
+        {
+            if (first_slice + i >= num_exact_slices)
+            {
+                double slice_start = start_time + (first_slice + i)*slice_length;
+                fine_states[i] = start_states[i];
+                Propagate(fine_states[i], slice_start, slice_start + slice_length, false);
+            }
+        }
+
+        // Sequential coarse correction
+        if (has_previous)
+        {
+            MPI_Recv(&state[0], local_size, MPI_DOUBLE, mTimeRank-1, 0, mTimeCommunicator, MPI_STATUS_IGNORE);
+        }
+        else
+        {
+            state = start_states[0];
+        }
+        double max_change = 0.0;
+        for (unsigned i=0; i<mNumSlicesPerProcess; i++)
+        {
+            std::vector<double> next_state = fine_states[i];
+            if (first_slice + i >= num_exact_slices)
+            {
+                double slice_start = start_time + (first_slice + i)*slice_length;
+                start_states[i] = state;
+                Propagate(state, slice_start, slice_start + slice_length, true);
+                for (unsigned j=0; j<local_size; j++)
+                {
+                    next_state[j] += state[j] - coarse_states[i][j];
+                }
+                coarse_states[i] = state;
+            }
+
+            const std::vector<double>& r_old_state = (i + 1 < mNumSlicesPerProcess) ? start_states[i+1] : end_state;
+            for (unsigned j=0; j<local_size; j++)
+            {
+                max_change = std::max(max_change, fabs(next_state[j] - r_old_state[j]));
+            }
+            state = next_state;
+        }
+        if (has_next)
+        {
+            MPI_Send(&state[0], local_size, MPI_DOUBLE, mTimeRank+1, 0, mTimeCommunicator);
+        }
+        end_state = state;
+
+        double space_max_change;
+        double global_max_change;
+        MPI_Allreduce(&max_change, &space_max_change, 1, MPI_DOUBLE, MPI_MAX, PetscTools::GetWorld());
+        MPI_Allreduce(&space_max_change, &global_max_change, 1, MPI_DOUBLE, MPI_MAX, mTimeCommunicator);
+        if (global_max_change <= mTolerance)
+        {
+            break;
+        }
+    }
+
+    double end_time = start_time + (first_slice + mNumSlicesPerProcess)*slice_length;
+    SetState(end_state, end_time);
+    HeartConfig::Instance()->SetSimulationDuration(end_time);
+}
+
+// Explicit instantiation
+template class PararealCardiacDriver<1,1,1>;
+template class PararealCardiacDriver<2,2,1>;
+template class PararealCardiacDriver<3,3,1>;
+template class PararealCardiacDriver<1,1,2>;
+template class PararealCardiacDriver<2,2,2>;
+template class PararealCardiacDriver<3,3,2>;
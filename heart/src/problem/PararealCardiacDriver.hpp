@@ -0,0 +1,202 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef PARAREALCARDIACDRIVER_HPP_
+#define PARAREALCARDIACDRIVER_HPP_
+
+#include <vector>
+#include "AbstractCardiacProblem.hpp"
+#include "PetscTools.hpp"
+
+/**
+ * Parareal (parallel-in-time) driver for cardiac problems.
+ *
+ * The simulation interval is cut into time slices, which are shared out in
+ * consecutive blocks between the processes of a "time" communicator.  The
+ * existing problem, with the time steps in HeartConfig, is the fine
+ * propagator; the same problem with larger ODE and PDE time steps is the
+ * coarse propagator.  Each Parareal iteration runs the fine propagator on
+ * every slice concurrently, then sweeps the coarse propagator through the
+ * slices in order, correcting the state at each slice boundary:
+ *
+ *     U_{n+1} <- G(U_n new) + F(U_n old) - G(U_n old).
+ *
+ * The iteration stops once no boundary state changes by more than a
+ * tolerance (max norm), and after at most as many iterations as there are
+ * slices, at which point it reproduces the fine solution.
+ *
+ * The state passed between slices is the local part of the solution vector
+ * and the state variables of the local cells, so each space group must hold
+ * an identically partitioned copy of the problem.  To run space groups side
+ * by side, call SplitCommunicators() before creating the problem; the
+ * PetscTools world (and so the mesh, HeartConfig and the output code) then
+ * refers to the space group.  Each group should then use its own output
+ * directory, for example named after GetTimeRank().
+ */
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
+class PararealCardiacDriver
+{
+private:
+    /** The problem, which must have been initialised */
+    AbstractCardiacProblem<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>* mpProblem;
+
+    /** Communicator between processes that hold the same part of the mesh for different time slices */
+    MPI_Comm mTimeCommunicator;
+
+    /** Rank of this process in #mTimeCommunicator */
+    unsigned mTimeRank;
+
+    /** Size of #mTimeCommunicator */
+    unsigned mNumTimeProcesses;
+
+    /** Number of consecutive time slices given to each process of #mTimeCommunicator */
+    unsigned mNumSlicesPerProcess;
+
+    /** ODE time step of the coarse propagator */
+    double mCoarseOdeTimeStep;
+
+    /** PDE time step of the coarse propagator */
+    double mCoarsePdeTimeStep;
+
+    /** Largest change in a slice boundary state for the iteration to have converged */
+    double mTolerance;
+
+    /** Maximum number of Parareal iterations, or 0 for the number of slices */
+    unsigned mMaxIterations;
+
+    /** Number of iterations done by the last call to Solve() */
+    unsigned mNumIterations;
+
+    /**
+     * Copy the solution and cell state of the problem into a vector.
+     *
+     * @param rState  filled in with the local state
+     */
+    void GetState(std::vector<double>& rState);
+
+    /**
+     * Restart the problem from a state made by GetState().
+     *
+     * @param rState  the local state
+     * @param time  the time of the state
+     */
+    void SetState(const std::vector<double>& rState, double time);
+
+    /**
+     * Set the time step of every local cell, as the cell factory does.
+     *
+     * @param odeTimeStep  the ODE time step
+     * @param pdeTimeStep  the PDE time step, used as the maximum step by CVODE cells
+     */
+    void SetCellTimeSteps(double odeTimeStep, double pdeTimeStep);
+
+    /**
+     * Advance a state from one time to another, with the fine or coarse propagator.
+     *
+     * @param rState  the state, overwritten by the result
+     * @param startTime  the time of the given state
+     * @param endTime  the time to advance to
+     * @param coarse  whether to use the coarse propagator
+     */
+    void Propagate(std::vector<double>& rState, double startTime, double endTime, bool coarse);
+
+public:
+    /**
+     * Split the PetscTools world into space groups of consecutive ranks, one
+     * per time process, and make this process's space group the PetscTools
+     * world (see PetscTools::SetWorld).
+     *
+     * @param numTimeProcesses  the number of space groups, which must divide the number of processes
+     * @return the time communicator, joining the processes with the same rank in each space group
+     */
+    static MPI_Comm SplitCommunicators(unsigned numTimeProcesses);
+
+    /**
+     * Constructor.
+     *
+     * @param pProblem  the problem, which must have been initialised
+     * @param timeCommunicator  the communicator from SplitCommunicators(), or PETSC_COMM_SELF
+     *     to run all the time slices on this space group
+     */
+    PararealCardiacDriver(AbstractCardiacProblem<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>* pProblem,
+                          MPI_Comm timeCommunicator);
+
+    /**
+     * Set the time steps of the coarse propagator.  By default they are ten
+     * times the fine ones.
+     *
+     * @param odeTimeStep  the coarse ODE time step
+     * @param pdeTimeStep  the coarse PDE time step
+     */
+    void SetCoarseTimeSteps(double odeTimeStep, double pdeTimeStep);
+
+    /**
+     * @param numSlices  the number of time slices per time process (defaults to 1)
+     */
+    void SetNumSlicesPerProcess(unsigned numSlices);
+
+    /**
+     * @param tolerance  the largest change in a slice boundary state for the iteration to have converged
+     */
+    void SetTolerance(double tolerance);
+
+    /**
+     * @param maxIterations  the maximum number of iterations (by default, the number of slices)
+     */
+    void SetMaxIterations(unsigned maxIterations);
+
+    /**
+     * Solve from the current time of the problem to the given end time.
+     * Output is switched off.  Afterwards the problem on each time process
+     * holds the state at the end of its last slice, so the last time process
+     * holds the solution at the end time.
+     *
+     * @param endTime  the end time, such that each slice is a whole number
+     *     of printing time steps and of coarse PDE time steps
+     */
+    void Solve(double endTime);
+
+    /**
+     * @return the number of iterations done by the last call to Solve()
+     */
+    unsigned GetNumIterations() const;
+
+    /**
+     * @return the rank of this process in the time communicator
+     */
+    unsigned GetTimeRank() const;
+};
+
+#endif // PARAREALCARDIACDRIVER_HPP_
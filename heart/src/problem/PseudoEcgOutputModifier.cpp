@@ -0,0 +1,292 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#include "PseudoEcgOutputModifier.hpp"
+
+#include <boost/scoped_array.hpp>
+
+#include "GaussianQuadratureRule.hpp"
+#include "HeartConfig.hpp"
+#include "HeartRegionCodes.hpp"
+#include "LinearBasisFunction.hpp"
+#include "MathsCustomFunctions.hpp"
+#include "PetscTools.hpp"
+#include "UblasCustomFunctions.hpp"
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+PseudoEcgOutputModifier<ELEMENT_DIM, SPACE_DIM>::PseudoEcgOutputModifier(const std::string& rFilename,
+                                                                         AbstractTetrahedralMesh<ELEMENT_DIM,SPACE_DIM>& rMesh,
+                                                                         const std::vector<ChastePoint<SPACE_DIM> >& rElectrodes,
+                                                                         double flushTime)
+    : AbstractOutputModifier(rFilename, flushTime),
+      mrMesh(rMesh),
+      mElectrodes(rElectrodes),
+      mDiffusionCoefficient(1.0),
+      mpVectorFactory(nullptr),
+      mWeightVectorsProblemDim(0u),
+      mFileStream(nullptr),
+      mFileStarted(false),
+      mLatestPseudoEcgs(rElectrodes.size(), 0.0)
+{
+    assert(ELEMENT_DIM == SPACE_DIM); // LCOV_EXCL_LINE
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+PseudoEcgOutputModifier<ELEMENT_DIM, SPACE_DIM>::~PseudoEcgOutputModifier()
+{
+    DestroyWeightVectors();
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void PseudoEcgOutputModifier<ELEMENT_DIM, SPACE_DIM>::SetDiffusionCoefficient(double diffusionCoefficient)
+{
+    assert(diffusionCoefficient >= 0);
+    mDiffusionCoefficient = diffusionCoefficient;
+    mLocalNodeWeights.clear();
+    DestroyWeightVectors();
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void PseudoEcgOutputModifier<ELEMENT_DIM, SPACE_DIM>::ComputeLocalNodeWeights()
+{
+    const unsigned num_electrodes = mElectrodes.size();
+    mLocalNodeWeights.assign(num_electrodes, std::map<unsigned, double>());
+
+    // Same quadrature as AbstractFunctionalCalculator, so that we agree with PseudoEcgCalculator
+    GaussianQuadratureRule<ELEMENT_DIM> quad_rule(3);
+
+    try
+    {
+        for (typename AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::ElementIterator iter = mrMesh.GetElementIteratorBegin();
+             iter != mrMesh.GetElementIteratorEnd();
+             ++iter)
+        {
+            if (!mrMesh.CalculateDesignatedOwnershipOfElement(iter->GetIndex())
+                || HeartRegionCode::IsRegionBath(iter->GetUnsignedAttribute()))
+            {
+                continue;
+            }
+
+            double jacobian_determinant;
+            c_matrix<double, SPACE_DIM, ELEMENT_DIM> jacobian;
+            c_matrix<double, ELEMENT_DIM, SPACE_DIM> inverse_jacobian;
+            iter->CalculateInverseJacobian(jacobian, jacobian_determinant, inverse_jacobian);
+
+            for (unsigned quad_index=0; quad_index<quad_rule.GetNumQuadPoints(); quad_index++)
+            {
+                const ChastePoint<ELEMENT_DIM>& quad_point = quad_rule.rGetQuadPoint(quad_index);
+
+                c_vector<double, ELEMENT_DIM+1> phi;
+                LinearBasisFunction<ELEMENT_DIM>::ComputeBasisFunctions(quad_point, phi);
+                c_matrix<double, ELEMENT_DIM, ELEMENT_DIM+1> grad_phi;
+                LinearBasisFunction<ELEMENT_DIM>::ComputeTransformedBasisFunctionDerivatives(quad_point, inverse_jacobian, grad_phi);
+
+                c_vector<double, SPACE_DIM> x = zero_vector<double>(SPACE_DIM);
+                for (unsigned i=0; i<ELEMENT_DIM+1; i++)
+                {
+                    x += phi(i)*iter->GetNode(i)->rGetLocation();
+                }
+
+                double wJ = jacobian_determinant * quad_rule.GetWeight(quad_index);
+
+                for (unsigned electrode=0; electrode<num_electrodes; electrode++)
+                {
+                    c_vector<double, SPACE_DIM> r_vector = x - mElectrodes[electrode].rGetLocation();
+                    double norm_r = norm_2(r_vector);
+                    if (norm_r <= DBL_EPSILON)
+                    {
+                        EXCEPTION("Probe is on a mesh Gauss point.");
+                    }
+                    c_vector<double, SPACE_DIM> grad_one_over_r = -r_vector*SmallPow(1.0/norm_r, 3);
+
+                    for (unsigned i=0; i<ELEMENT_DIM+1; i++)
+                    {
+                        double grad_phi_dot_grad_one_over_r = 0.0;
+                        for (unsigned j=0; j<ELEMENT_DIM; j++)
+                        {
+                            grad_phi_dot_grad_one_over_r += grad_phi(j,i)*grad_one_over_r(j);
+                        }
+                        mLocalNodeWeights[electrode][iter->GetNodeGlobalIndex(i)] -= mDiffusionCoefficient*grad_phi_dot_grad_one_over_r*wJ;
+                    }
+                }
+            }
+        }
+    }
+    catch (Exception& e)
+    {
+        PetscTools::ReplicateException(true);
+        throw e;
+    }
+    PetscTools::ReplicateException(false);
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void PseudoEcgOutputModifier<ELEMENT_DIM, SPACE_DIM>::CreateWeightVectors(unsigned problemDim)
+{
+    assert(mpVectorFactory);
+    DestroyWeightVectors();
+
+    for (unsigned electrode=0; electrode<mElectrodes.size(); electrode++)
+    {
+        Vec weights = mpVectorFactory->CreateVec(problemDim);
+        VecZeroEntries(weights);
+        for (std::map<unsigned, double>::const_iterator it = mLocalNodeWeights[electrode].begin();
+             it != mLocalNodeWeights[electrode].end();
+             ++it)
+        {
+            // Transmembrane potential is the first unknown at each node
+            PetscInt index = problemDim*it->first;
+            VecSetValues(weights, 1, &index, &(it->second), ADD_VALUES);
+        }
+        VecAssemblyBegin(weights);
+        VecAssemblyEnd(weights);
+        mWeightVectors.push_back(weights);
+    }
+    mWeightVectorsProblemDim = problemDim;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void PseudoEcgOutputModifier<ELEMENT_DIM, SPACE_DIM>::DestroyWeightVectors()
+{
+    for (unsigned i=0; i<mWeightVectors.size(); i++)
+    {
+        PetscTools::Destroy(mWeightVectors[i]);
+    }
+    mWeightVectors.clear();
+    mWeightVectorsProblemDim = 0u;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void PseudoEcgOutputModifier<ELEMENT_DIM, SPACE_DIM>::InitialiseAtStart(DistributedVectorFactory* pVectorFactory)
+{
+    if (mpVectorFactory != pVectorFactory)
+    {
+        mpVectorFactory = pVectorFactory;
+        DestroyWeightVectors();
+    }
+    if (mLocalNodeWeights.empty())
+    {
+        ComputeLocalNodeWeights();
+    }
+
+    // Collectively open the output directory - this might already be in place from creating the HDF5 file
+    OutputFileHandler output_handler(HeartConfig::Instance()->GetOutputDirectory(), false);
+    if (PetscTools::AmMaster())
+    {
+        if (mFileStarted)
+        {
+            // Carry on from a previous Solve() call
+            mFileStream = output_handler.OpenOutputFile(mFilename, std::ios::out | std::ios::app);
+        }
+        else
+        {
+            mFileStream = output_handler.OpenOutputFile(mFilename);
+            *mFileStream << "#Time(ms)";
+            for (unsigned electrode=0; electrode<mElectrodes.size(); electrode++)
+            {
+                *mFileStream << "\tPseudoEcgFromElectrodeAt";
+                for (unsigned dim=0; dim<SPACE_DIM; dim++)
+                {
+                    *mFileStream << "_" << mElectrodes[electrode][dim];
+                }
+            }
+            *mFileStream << "\n";
+        }
+    }
+    mFileStarted = true;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void PseudoEcgOutputModifier<ELEMENT_DIM, SPACE_DIM>::FinaliseAtEnd()
+{
+    if (PetscTools::AmMaster())
+    {
+        mFileStream->close();
+    }
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void PseudoEcgOutputModifier<ELEMENT_DIM, SPACE_DIM>::ProcessSolutionAtTimeStep(double time, Vec solution, unsigned problemDim)
+{
+    if (mElectrodes.empty())
+    {
+        return;
+    }
+    if (mWeightVectorsProblemDim != problemDim)
+    {
+        CreateWeightVectors(problemDim);
+    }
+
+    // All electrodes are computed with a single global reduction
+    const unsigned num_electrodes = mElectrodes.size();
+    boost::scoped_array<PetscScalar> pseudo_ecgs(new PetscScalar[num_electrodes]);
+#if (PETSC_VERSION_MAJOR == 2 && PETSC_VERSION_MINOR == 2) //PETSc 2.2
+    VecMDot(num_electrodes, solution, &mWeightVectors[0], pseudo_ecgs.get());
+#else
+    VecMDot(solution, num_electrodes, &mWeightVectors[0], pseudo_ecgs.get());
+#endif
+
+    for (unsigned electrode=0; electrode<num_electrodes; electrode++)
+    {
+        mLatestPseudoEcgs[electrode] = pseudo_ecgs[electrode];
+    }
+
+    if (PetscTools::AmMaster())
+    {
+        (*mFileStream) << time;
+        for (unsigned electrode=0; electrode<num_electrodes; electrode++)
+        {
+            (*mFileStream) << "\t" << mLatestPseudoEcgs[electrode];
+        }
+        (*mFileStream) << "\n";
+
+        if (mFlushTime > 0.0 && Divides(mFlushTime, time))
+        {
+            mFileStream->flush();
+        }
+    }
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+const std::vector<double>& PseudoEcgOutputModifier<ELEMENT_DIM, SPACE_DIM>::rGetLatestPseudoEcgs() const
+{
+    return mLatestPseudoEcgs;
+}
+
+// Explicit instantiation
+template class PseudoEcgOutputModifier<1,1>;
+template class PseudoEcgOutputModifier<2,2>;
+template class PseudoEcgOutputModifier<3,3>;
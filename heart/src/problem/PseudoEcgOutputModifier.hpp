@@ -0,0 +1,174 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef PSEUDOECGOUTPUTMODIFIER_HPP_
+#define PSEUDOECGOUTPUTMODIFIER_HPP_
+
+#include <map>
+#include <vector>
+
+#include "AbstractOutputModifier.hpp"
+#include "AbstractTetrahedralMesh.hpp"
+#include "ChastePoint.hpp"
+#include "OutputFileHandler.hpp"
+
+/**
+ * Compute pseudo-ECGs for a set of electrodes while the simulation is running, so that
+ * they are available without writing (and re-reading) the full transmembrane potential.
+ *
+ * The pseudo-ECG computed by PseudoEcgCalculator,
+ *
+ * - D * integral of grad(V) dot grad(1/r),
+ *
+ * is linear in the nodal values of V.  We therefore precompute, once, a weight for every
+ * node and electrode (using the same quadrature as PseudoEcgCalculator), and each time step
+ * reduces to a local dot product plus a single global reduction for all electrodes together.
+ *
+ * The output file has one line per time step, containing the time followed by the pseudo-ECG
+ * at each electrode, and is written by the master process in the simulation output directory.
+ *
+ * Elements in the bath are skipped, as in PseudoEcgCalculator.
+ *
+ * WARNING:  This class holds a reference to the mesh and so cannot be checkpointed.
+ */
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+class PseudoEcgOutputModifier : public AbstractOutputModifier
+{
+private:
+    /** For testing */
+    friend class TestPseudoEcgCalculator;
+
+    /** The mesh on which the simulation is solved (with the node ordering used at solve time). */
+    AbstractTetrahedralMesh<ELEMENT_DIM,SPACE_DIM>& mrMesh;
+
+    /** The electrode locations. */
+    std::vector<ChastePoint<SPACE_DIM> > mElectrodes;
+
+    /** The diffusion coefficient D. */
+    double mDiffusionCoefficient;
+
+    /** The vector factory of the calling problem, for laying out the weight vectors. */
+    DistributedVectorFactory* mpVectorFactory;
+
+    /**
+     * The weight of each node for each electrode, from the elements owned by this process.
+     * Indexed by electrode, then by global node index.
+     */
+    std::vector<std::map<unsigned, double> > mLocalNodeWeights;
+
+    /** The weights as distributed vectors laid out like the solution (created on first use). */
+    std::vector<Vec> mWeightVectors;
+
+    /** The problem dimension the weight vectors were laid out for. */
+    unsigned mWeightVectorsProblemDim;
+
+    /** Output file stream, only open on the master process. */
+    out_stream mFileStream;
+
+    /** Whether the output file has been opened in a previous call to InitialiseAtStart(). */
+    bool mFileStarted;
+
+    /** The pseudo-ECGs at the most recent time step. */
+    std::vector<double> mLatestPseudoEcgs;
+
+    /** Compute mLocalNodeWeights by looping over the elements owned by this process. */
+    void ComputeLocalNodeWeights();
+
+    /**
+     * Create the distributed weight vectors for solutions with the given number of unknowns per node.
+     *
+     * @param problemDim  the number of unknowns per node in the solution vector
+     */
+    void CreateWeightVectors(unsigned problemDim);
+
+    /** Destroy any existing weight vectors. */
+    void DestroyWeightVectors();
+
+public:
+    /**
+     * Constructor.
+     *
+     * @param rFilename  The file which is produced by this modifier
+     * @param rMesh  The mesh on which the simulation is solved
+     * @param rElectrodes  The electrode locations
+     * @param flushTime  The simulation time between manual file flushes (if required)
+     */
+    PseudoEcgOutputModifier(const std::string& rFilename,
+                            AbstractTetrahedralMesh<ELEMENT_DIM,SPACE_DIM>& rMesh,
+                            const std::vector<ChastePoint<SPACE_DIM> >& rElectrodes,
+                            double flushTime=0.0);
+
+    /**
+     * Destructor.
+     */
+    virtual ~PseudoEcgOutputModifier();
+
+    /**
+     * Set the value of the diffusion coefficient D (defaults to 1).
+     *
+     * @param diffusionCoefficient  the diffusion coefficient
+     */
+    void SetDiffusionCoefficient(double diffusionCoefficient);
+
+    /**
+     * Initialise the modifier (compute the nodal weights if needed, and open the file) when
+     * the solve loop is starting.
+     *
+     * @param pVectorFactory  The vector factory which is associated with the calling problem's mesh
+     */
+    virtual void InitialiseAtStart(DistributedVectorFactory* pVectorFactory);
+
+    /**
+     * Finalise the modifier (close the file)
+     */
+    virtual void FinaliseAtEnd();
+
+    /**
+     * Compute the pseudo-ECGs at this time step and write them to file.
+     *
+     * @param time  The current simulation time
+     * @param solution  A working copy of the solution at the current time-step.  This is the PETSc vector which is distributed across the processes.
+     * @param problemDim  The calling problem dimension. Transmembrane potential is the first unknown at each node.
+     */
+    virtual void ProcessSolutionAtTimeStep(double time, Vec solution, unsigned problemDim);
+
+    /**
+     * @return the pseudo-ECGs computed at the most recent time step, one per electrode.
+     */
+    const std::vector<double>& rGetLatestPseudoEcgs() const;
+};
+
+#endif // PSEUDOECGOUTPUTMODIFIER_HPP_
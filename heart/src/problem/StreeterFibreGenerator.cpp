@@ -59,8 +59,72 @@ const char StreeterCitation[] = "@article{streeter1969fiber,\n"
 "}\n";
 
 template <unsigned SPACE_DIM>
-double StreeterFibreGenerator<SPACE_DIM>::GetAveragedThicknessLocalNode(
-        const unsigned nodeIndex, const std::vector<double>& wallThickness) const
+double StreeterFibreGenerator<SPACE_DIM>::CalculateWallThickness(unsigned nodeIndex) const
+{
+    double dist_epi, dist_endo;
+
+    HeartRegionType node_region = mpGeometryInfo->GetHeartRegion(nodeIndex);
+
+    switch(node_region)
+    {
+        case HeartGeometryInformation<SPACE_DIM>::LEFT_VENTRICLE_SURFACE:
+        case HeartGeometryInformation<SPACE_DIM>::LEFT_VENTRICLE_WALL:
+            dist_epi = mpGeometryInfo->rGetDistanceMapEpicardium()[nodeIndex];
+            dist_endo = mpGeometryInfo->rGetDistanceMapLeftVentricle()[nodeIndex];
+            break;
+
+        case HeartGeometryInformation<SPACE_DIM>::RIGHT_VENTRICLE_SURFACE:
+        case HeartGeometryInformation<SPACE_DIM>::RIGHT_VENTRICLE_WALL:
+            dist_epi = mpGeometryInfo->rGetDistanceMapEpicardium()[nodeIndex];
+            dist_endo = mpGeometryInfo->rGetDistanceMapRightVentricle()[nodeIndex];
+            break;
+
+        case HeartGeometryInformation<SPACE_DIM>::LEFT_SEPTUM:
+            dist_epi = mpGeometryInfo->rGetDistanceMapRightVentricle()[nodeIndex];
+            dist_endo = mpGeometryInfo->rGetDistanceMapLeftVentricle()[nodeIndex];
+            break;
+
+        case HeartGeometryInformation<SPACE_DIM>::RIGHT_SEPTUM:
+            dist_epi = mpGeometryInfo->rGetDistanceMapLeftVentricle()[nodeIndex];
+            dist_endo = mpGeometryInfo->rGetDistanceMapRightVentricle()[nodeIndex];
+            break;
+
+        case HeartGeometryInformation<SPACE_DIM>::UNKNOWN:
+            // LCOV_EXCL_START
+            std::cerr << "Wrong distances node: " << nodeIndex << "\t"
+                      << "Epi " << mpGeometryInfo->rGetDistanceMapEpicardium()[nodeIndex] << "\t"
+                      << "RV " << mpGeometryInfo->rGetDistanceMapRightVentricle()[nodeIndex] << "\t"
+                      << "LV " << mpGeometryInfo->rGetDistanceMapLeftVentricle()[nodeIndex]
+                      << std::endl;
+
+            // Make wall_thickness=0 as in Martin's code
+            dist_epi = 1;
+            dist_endo = 0;
+            break;
+            // LCOV_EXCL_STOP
+
+        default:
+            NEVER_REACHED;
+    }
+
+    double wall_thickness = dist_endo / (dist_endo + dist_epi);
+
+    if (std::isnan(wall_thickness))
+    {
+        // LCOV_EXCL_START
+        /*
+         *  A node contained on both epicardium and lv (or rv) surfaces has wall thickness 0/0.
+         *  By setting its value to 0 we consider it contained only on the lv (or rv) surface.
+         */
+        wall_thickness = 0;
+        // LCOV_EXCL_STOP
+    }
+
+    return wall_thickness;
+}
+
+template <unsigned SPACE_DIM>
+double StreeterFibreGenerator<SPACE_DIM>::GetAveragedThicknessLocalNode(const unsigned nodeIndex) const
 {
     if (nodeIndex < this->mpMesh->GetDistributedVectorFactory()->GetLow() ||
         nodeIndex >= this->mpMesh->GetDistributedVectorFactory()->GetHigh() )
@@ -69,7 +133,7 @@ double StreeterFibreGenerator<SPACE_DIM>::GetAveragedThicknessLocalNode(
     }
 
     // Initialise the average with the value corresponding to the current node
-    double average = wallThickness[nodeIndex];
+    double average = CalculateWallThickness(nodeIndex);
     unsigned nodes_visited = 1;
 
     // Use a set to store visited nodes
@@ -97,7 +161,7 @@ double StreeterFibreGenerator<SPACE_DIM>::GetAveragedThicknessLocalNode(
             // Check if the neighbour node has already been visited
             if (visited_nodes.find(neighbour_node_index) == visited_nodes.end())
             {
-                average += wallThickness[neighbour_node_index];
+                average += CalculateWallThickness(neighbour_node_index);
                 visited_nodes.insert(neighbour_node_index);
                 nodes_visited++;
             }
@@ -154,9 +218,6 @@ StreeterFibreGenerator<SPACE_DIM>::StreeterFibreGenerator(AbstractTetrahedralMes
 {
     // Record a reference for the calculations performed here, can be extracted with the '-citations' flag.
     Citations::Register(StreeterCitation, &StreeterCite);
-
-    mWallThickness.resize(rMesh.GetNumNodes());
-    mAveragedWallThickness.resize(rMesh.GetNumNodes());
 }
 
 template <unsigned SPACE_DIM>
@@ -211,94 +272,110 @@ void StreeterFibreGenerator<SPACE_DIM>::PreWriteCalculations(OutputFileHandler&
         EXCEPTION("Apex to base vector has not been set");
     }
 
-    // Compute wall thickness parameter
+    // Log the node regions and wall thicknesses (the geometry information is known for every node)
     unsigned num_nodes = this->mpMesh->GetNumNodes();
-    for (unsigned node_index=0; node_index<num_nodes; node_index++)
+    if (logInfo)
     {
-        double dist_epi, dist_endo;
-
-        HeartRegionType node_region = mpGeometryInfo->GetHeartRegion(node_index);
-
-        switch(node_region)
+        for (unsigned node_index=0; node_index<num_nodes; node_index++)
         {
-            case HeartGeometryInformation<SPACE_DIM>::LEFT_VENTRICLE_SURFACE:
-            case HeartGeometryInformation<SPACE_DIM>::LEFT_VENTRICLE_WALL:
-                dist_epi = mpGeometryInfo->rGetDistanceMapEpicardium()[node_index];
-                dist_endo = mpGeometryInfo->rGetDistanceMapLeftVentricle()[node_index];
-                break;
-
-            case HeartGeometryInformation<SPACE_DIM>::RIGHT_VENTRICLE_SURFACE:
-            case HeartGeometryInformation<SPACE_DIM>::RIGHT_VENTRICLE_WALL:
-                dist_epi = mpGeometryInfo->rGetDistanceMapEpicardium()[node_index];
-                dist_endo = mpGeometryInfo->rGetDistanceMapRightVentricle()[node_index];
-                break;
-
-            case HeartGeometryInformation<SPACE_DIM>::LEFT_SEPTUM:
-                dist_epi = mpGeometryInfo->rGetDistanceMapRightVentricle()[node_index];
-                dist_endo = mpGeometryInfo->rGetDistanceMapLeftVentricle()[node_index];
-                break;
-
-            case HeartGeometryInformation<SPACE_DIM>::RIGHT_SEPTUM:
-                dist_epi = mpGeometryInfo->rGetDistanceMapLeftVentricle()[node_index];
-                dist_endo = mpGeometryInfo->rGetDistanceMapRightVentricle()[node_index];
-                break;
-
-            case HeartGeometryInformation<SPACE_DIM>::UNKNOWN:
-                // LCOV_EXCL_START
-                std::cerr << "Wrong distances node: " << node_index << "\t"
-                          << "Epi " << mpGeometryInfo->rGetDistanceMapEpicardium()[node_index] << "\t"
-                          << "RV " << mpGeometryInfo->rGetDistanceMapRightVentricle()[node_index] << "\t"
-                          << "LV " << mpGeometryInfo->rGetDistanceMapLeftVentricle()[node_index]
-                          << std::endl;
-
-                // Make wall_thickness=0 as in Martin's code
-                dist_epi = 1;
-                dist_endo = 0;
-                break;
-                // LCOV_EXCL_STOP
-
-            default:
-                NEVER_REACHED;
+            *p_regions_file << mpGeometryInfo->GetHeartRegion(node_index)*100 << "\n";
+            *p_thickness_file << CalculateWallThickness(node_index) << "\n";
         }
+    }
 
-        mWallThickness[node_index] = dist_endo / (dist_endo + dist_epi);
+    /*
+     *  For each node we own, average its value of e with the values of all the neighbours
+     */
+    DistributedVectorFactory* p_factory = this->mpMesh->GetDistributedVectorFactory();
+    unsigned lo = p_factory->GetLow();
+    unsigned hi = p_factory->GetHigh();
+    mAveragedWallThickness.clear();
+    std::vector<double> owned_averaged_wall_thickness(hi - lo);
+    for (unsigned node_index=lo; node_index<hi; node_index++)
+    {
+        owned_averaged_wall_thickness[node_index - lo] = GetAveragedThicknessLocalNode(node_index);
+        mAveragedWallThickness[node_index] = owned_averaged_wall_thickness[node_index - lo];
+    }
 
-        if (std::isnan(mWallThickness[node_index]))
+    /*
+     *  Our elements may also have nodes owned by other processes: exchange the averages of
+     *  those halo nodes with their owners, rather than replicating every node's average
+     */
+    std::vector<std::vector<unsigned> > nodes_to_send_per_process;
+    std::vector<std::vector<unsigned> > nodes_to_receive_per_process;
+    this->mpMesh->CalculateNodeExchange(nodes_to_send_per_process, nodes_to_receive_per_process);
+
+    unsigned num_procs = PetscTools::GetNumProcs();
+    std::vector<std::vector<double> > send_buffers(num_procs);
+    std::vector<std::vector<double> > receive_buffers(num_procs);
+    std::vector<MPI_Request> requests;
+    for (unsigned proc=0; proc<num_procs; proc++)
+    {
+        if (!nodes_to_receive_per_process[proc].empty())
         {
-            // LCOV_EXCL_START
-            /*
-             *  A node contained on both epicardium and lv (or rv) surfaces has wall thickness 0/0.
-             *  By setting its value to 0 we consider it contained only on the lv (or rv) surface.
-             */
-            mWallThickness[node_index] = 0;
-            // LCOV_EXCL_STOP
+            receive_buffers[proc].resize(nodes_to_receive_per_process[proc].size());
+            MPI_Request request;
+            MPI_Irecv(&receive_buffers[proc][0], receive_buffers[proc].size(), MPI_DOUBLE, proc, 0,
+                      PetscTools::GetWorld(), &request);
+            requests.push_back(request);
         }
-
-        if (logInfo)
+    }
+    for (unsigned proc=0; proc<num_procs; proc++)
+    {
+        if (!nodes_to_send_per_process[proc].empty())
         {
-            *p_regions_file << node_region*100 << "\n";
-            *p_thickness_file << mWallThickness[node_index] << "\n";
+            for (unsigned i=0; i<nodes_to_send_per_process[proc].size(); i++)
+            {
+                send_buffers[proc].push_back(owned_averaged_wall_thickness[nodes_to_send_per_process[proc][i] - lo]);
+            }
+            MPI_Request request;
+            MPI_Isend(&send_buffers[proc][0], send_buffers[proc].size(), MPI_DOUBLE, proc, 0,
+                      PetscTools::GetWorld(), &request);
+            requests.push_back(request);
         }
     }
-
-    /*
-     *  For each node, average its value of e with the values of all the neighbours
-     */
-    std::vector<double> my_averaged_wall_thickness(num_nodes);
-    for (unsigned node_index=0; node_index<num_nodes; node_index++)
+    if (!requests.empty())
     {
-        my_averaged_wall_thickness[node_index] = GetAveragedThicknessLocalNode(node_index, mWallThickness);
+        MPI_Waitall(requests.size(), &requests[0], MPI_STATUSES_IGNORE);
+    }
+    for (unsigned proc=0; proc<num_procs; proc++)
+    {
+        for (unsigned i=0; i<nodes_to_receive_per_process[proc].size(); i++)
+        {
+            mAveragedWallThickness[nodes_to_receive_per_process[proc][i]] = receive_buffers[proc][i];
+        }
     }
 
-    // Non-local information appear as zeros in the vector
-    MPI_Allreduce(&my_averaged_wall_thickness[0], &mAveragedWallThickness[0], num_nodes,
-                  MPI_DOUBLE, MPI_SUM, PETSC_COMM_WORLD);
-
-    if (logInfo)
+    if (mLogInfo)
     {
-        for (unsigned node_index=0; node_index<num_nodes; node_index++)
+        // The log file needs every node's average, so (only in this case) gather them on the master
+        std::vector<int> counts;
+        std::vector<int> displacements;
+        std::vector<double> all_averaged_wall_thickness;
+        if (PetscTools::AmMaster())
         {
-             *p_ave_thickness_file << mAveragedWallThickness[node_index] << "\n";
+            const std::vector<unsigned>& r_global_lows = p_factory->rGetGlobalLows();
+            for (unsigned proc=0; proc<num_procs; proc++)
+            {
+                unsigned proc_hi = (proc+1 < num_procs) ? r_global_lows[proc+1] : num_nodes;
+                displacements.push_back(r_global_lows[proc]);
+                counts.push_back(proc_hi - r_global_lows[proc]);
+            }
+            all_averaged_wall_thickness.resize(num_nodes);
+        }
+        MPI_Gatherv(owned_averaged_wall_thickness.empty() ? nullptr : &owned_averaged_wall_thickness[0],
+                    owned_averaged_wall_thickness.size(), MPI_DOUBLE,
+                    all_averaged_wall_thickness.empty() ? nullptr : &all_averaged_wall_thickness[0],
+                    counts.empty() ? nullptr : &counts[0],
+                    displacements.empty() ? nullptr : &displacements[0],
+                    MPI_DOUBLE, 0, PetscTools::GetWorld());
+
+        if (logInfo)
+        {
+            for (unsigned node_index=0; node_index<num_nodes; node_index++)
+            {
+                 *p_ave_thickness_file << all_averaged_wall_thickness[node_index] << "\n";
+            }
         }
     }
 
@@ -339,11 +416,13 @@ void StreeterFibreGenerator<SPACE_DIM>::Visit(Element<SPACE_DIM, SPACE_DIM>* pEl
         // Get node's global index
         unsigned global_node_index = pElement->GetNode(local_node_index)->GetIndex();
 
-        elem_nodes_ave_thickness[local_node_index] = mAveragedWallThickness[global_node_index];
+        std::map<unsigned, double>::const_iterator averaged_it = mAveragedWallThickness.find(global_node_index);
+        assert(averaged_it != mAveragedWallThickness.end());
+        elem_nodes_ave_thickness[local_node_index] = averaged_it->second;
         elem_nodes_region[local_node_index] = mpGeometryInfo->GetHeartRegion(global_node_index);
 
         // Calculate wall thickness averaged value for the element
-        element_averaged_thickness +=  mWallThickness[global_node_index];
+        element_averaged_thickness +=  CalculateWallThickness(global_node_index);
     }
 
     element_averaged_thickness /= SPACE_DIM+1;
@@ -38,6 +38,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <vector>
 #include <string>
 #include <set>
+#include <map>
 #include "DistanceMapCalculator.hpp"
 #include "AbstractTetrahedralMesh.hpp"
 #include "HeartGeometryInformation.hpp"
@@ -68,16 +69,22 @@ private:
 
     c_vector <double, SPACE_DIM> mApexToBase; /**< Normalised direction from apex to base */
 
+    /**
+     * Compute the wall thickness parameter e of a given node from its distances to the surfaces.
+     *
+     * @param nodeIndex  The index of the node in question
+     * @return the relative position of the node across the wall (0 at the endocardium, 1 at the epicardium)
+     */
+    double CalculateWallThickness(unsigned nodeIndex) const;
+
     /**
      * Compute the wall thickness of a given node based on a
      * neighbourhood average of its thickness and of those in the forward star.
      *
      * @param nodeIndex  The index of the node in question
-     * @param wallThickness  vector of thickness of all nodes in node index order
      * @return Neighbourhood average thickness (will return 0 if the node is not local to this process)
      */
-    double GetAveragedThicknessLocalNode(const unsigned nodeIndex,
-                                         const std::vector<double>& wallThickness) const;
+    double GetAveragedThicknessLocalNode(const unsigned nodeIndex) const;
 
     /**
      * R is the maximum angle between the fibre and the v axis (heart region dependant)
@@ -86,11 +93,11 @@ private:
      */
    double GetFibreMaxAngle(const c_vector<HeartRegionType, SPACE_DIM+1>& nodesRegionsForElement) const;
 
-   /** Wall thickness at each node in the mesh. */
-   std::vector<double> mWallThickness;
-
-   /** Wall thickness at each node, smoothed by averaging over local nodes by #GetAveragedThicknessLocalNode().*/
-   std::vector<double> mAveragedWallThickness;
+   /**
+    * Wall thickness smoothed by averaging over neighbouring nodes by #GetAveragedThicknessLocalNode(),
+    * for the nodes of this process's elements only (owned and halo nodes), by global node index.
+    */
+   std::map<unsigned, double> mAveragedWallThickness;
 
    /** Whether to write Streeter generation log files for regions and wall thicknesses */
    bool mLogInfo;
@@ -117,7 +124,8 @@ protected:
 
    /**
     * Does calculations to generate an orthotropic fibre orientation model of the ventricular mesh provided.
-    * In particular - populates the member variables #mWallThickness and #mAveragedWallThickness.
+    * In particular - populates the member variable #mAveragedWallThickness, computing the averages
+    * of owned nodes and exchanging those of halo nodes with their owners.
     *
     * Also writes these to file if SetLogInfo() has been called.
     *
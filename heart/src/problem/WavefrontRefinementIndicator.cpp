@@ -0,0 +1,149 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#include "WavefrontRefinementIndicator.hpp"
+
+#include <algorithm>
+#include "Exception.hpp"
+#include "ReplicatableVector.hpp"
+
+template <unsigned DIM>
+WavefrontRefinementIndicator<DIM>::WavefrontRefinementIndicator(AbstractTetrahedralMesh<DIM, DIM>& rMesh,
+                                                                double refinementThreshold,
+                                                                double coarseningThreshold)
+    : mrMesh(rMesh),
+      mRefinementThreshold(refinementThreshold),
+      mCoarseningThreshold(coarseningThreshold),
+      mMaximumGradient(0.0)
+{
+    if (coarseningThreshold < 0.0 || refinementThreshold <= coarseningThreshold)
+    {
+        EXCEPTION("Wave front refinement threshold must exceed the coarsening threshold, which must not be negative");
+    }
+}
+
+template <unsigned DIM>
+void WavefrontRefinementIndicator<DIM>::ComputeIndicator(Vec solution, unsigned problemDim)
+{
+    // Element vertices may be halo nodes, so every process needs all the values
+    ReplicatableVector replicated_solution(solution);
+
+    mElementsToRefine.clear();
+    mElementsToCoarsen.clear();
+    double local_maximum = 0.0;
+
+    c_matrix<double, DIM, DIM> jacobian;
+    c_matrix<double, DIM, DIM> inverse_jacobian;
+    c_matrix<double, DIM, DIM+1> grad_phi;
+    double jacobian_determinant;
+
+    for (typename AbstractTetrahedralMesh<DIM, DIM>::ElementIterator iter = mrMesh.GetElementIteratorBegin();
+         iter != mrMesh.GetElementIteratorEnd();
+         ++iter)
+    {
+        unsigned element_index = iter->GetIndex();
+        mrMesh.GetElementGeometry(element_index, jacobian, jacobian_determinant, inverse_jacobian, grad_phi);
+
+        c_vector<double, DIM> grad_v = zero_vector<double>(DIM);
+        for (unsigned j=0; j<DIM+1; j++)
+        {
+            grad_v += replicated_solution[problemDim*iter->GetNodeGlobalIndex(j)] * column(grad_phi, j);
+        }
+        double gradient = norm_2(grad_v);
+
+        local_maximum = std::max(local_maximum, gradient);
+        if (gradient > mRefinementThreshold)
+        {
+            mElementsToRefine.push_back(element_index);
+        }
+        else if (gradient < mCoarseningThreshold)
+        {
+            mElementsToCoarsen.push_back(element_index);
+        }
+    }
+
+    MPI_Allreduce(&local_maximum, &mMaximumGradient, 1, MPI_DOUBLE, MPI_MAX, PetscTools::GetWorld());
+}
+
+template <unsigned DIM>
+const std::vector<unsigned>& WavefrontRefinementIndicator<DIM>::rGetElementsToRefine() const
+{
+    return mElementsToRefine;
+}
+
+template <unsigned DIM>
+const std::vector<unsigned>& WavefrontRefinementIndicator<DIM>::rGetElementsToCoarsen() const
+{
+    return mElementsToCoarsen;
+}
+
+template <unsigned DIM>
+double WavefrontRefinementIndicator<DIM>::GetMaximumGradient() const
+{
+    return mMaximumGradient;
+}
+
+template <unsigned DIM>
+void WavefrontRefinementIndicator<DIM>::InterpolateCellState(const std::vector<AbstractCardiacCellInterface*>& rCells,
+                                                             const std::vector<double>& rWeights,
+                                                             AbstractCardiacCellInterface* pNewCell)
+{
+    if (rCells.empty() || rCells.size() != rWeights.size())
+    {
+        EXCEPTION("There must be one weight for each cell whose state is interpolated");
+    }
+
+    const unsigned num_state_variables = pNewCell->GetNumberOfStateVariables();
+    std::vector<double> new_state(num_state_variables, 0.0);
+    for (unsigned i=0; i<rCells.size(); i++)
+    {
+        if (rCells[i]->GetNumberOfStateVariables() != num_state_variables)
+        {
+            EXCEPTION("Cannot interpolate the state of cells with different numbers of state variables");
+        }
+        std::vector<double> state = rCells[i]->GetStdVecStateVariables();
+        for (unsigned k=0; k<num_state_variables; k++)
+        {
+            new_state[k] += rWeights[i]*state[k];
+        }
+    }
+    pNewCell->SetStateVariables(new_state);
+}
+
+// Explicit instantiation
+template class WavefrontRefinementIndicator<1>;
+template class WavefrontRefinementIndicator<2>;
+template class WavefrontRefinementIndicator<3>;
@@ -0,0 +1,135 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef WAVEFRONTREFINEMENTINDICATOR_HPP_
+#define WAVEFRONTREFINEMENTINDICATOR_HPP_
+
+#include <vector>
+#include "UblasIncludes.hpp"
+#include "AbstractTetrahedralMesh.hpp"
+#include "AbstractCardiacCellInterface.hpp"
+#include "PetscTools.hpp"
+
+/**
+ * Finds the elements of a cardiac mesh that lie in a wave front, as the first
+ * stage of adapting the mesh to the solution.
+ *
+ * The indicator is the magnitude of the transmembrane potential gradient on
+ * each (linear) element.  Elements where it exceeds a refinement threshold are
+ * in the front or the back of an action potential and should be refined;
+ * elements where it is below a coarsening threshold are at rest or plateau and
+ * may be coarsened.  The static InterpolateCellState() method provides the
+ * cell-state transfer for nodes created by refinement, from the cells at the
+ * vertices of the parent element.
+ *
+ * Changing the mesh itself, and repartitioning it, is left to the caller.
+ */
+template <unsigned DIM>
+class WavefrontRefinementIndicator
+{
+private:
+    /** The mesh on which the solution is defined */
+    AbstractTetrahedralMesh<DIM, DIM>& mrMesh;
+
+    /** Gradient magnitude (mV/cm) above which elements are marked for refinement */
+    double mRefinementThreshold;
+
+    /** Gradient magnitude (mV/cm) below which elements are marked for coarsening */
+    double mCoarseningThreshold;
+
+    /** Global indices of the local elements marked for refinement by the last ComputeIndicator() call */
+    std::vector<unsigned> mElementsToRefine;
+
+    /** Global indices of the local elements marked for coarsening by the last ComputeIndicator() call */
+    std::vector<unsigned> mElementsToCoarsen;
+
+    /** Largest gradient magnitude over the whole mesh found by the last ComputeIndicator() call */
+    double mMaximumGradient;
+
+public:
+    /**
+     * Constructor
+     *
+     * @param rMesh  the mesh on which the solution is defined
+     * @param refinementThreshold  gradient magnitude (mV/cm) above which elements are refined
+     * @param coarseningThreshold  gradient magnitude (mV/cm) below which elements may be
+     *     coarsened (defaults to 0, which never marks any)
+     */
+    WavefrontRefinementIndicator(AbstractTetrahedralMesh<DIM, DIM>& rMesh,
+                                 double refinementThreshold,
+                                 double coarseningThreshold=0.0);
+
+    /**
+     * Evaluate the indicator on every local element.  This is collective.
+     *
+     * @param solution  the solution vector, as given to AbstractOutputModifier::ProcessSolutionAtTimeStep()
+     * @param problemDim  the number of unknowns per node, of which the transmembrane potential is the first
+     */
+    void ComputeIndicator(Vec solution, unsigned problemDim=1);
+
+    /**
+     * @return the global indices of the local elements marked for refinement by the last
+     * ComputeIndicator() call, in the mesh's element order.
+     */
+    const std::vector<unsigned>& rGetElementsToRefine() const;
+
+    /**
+     * @return the global indices of the local elements marked for coarsening by the last
+     * ComputeIndicator() call, in the mesh's element order.
+     */
+    const std::vector<unsigned>& rGetElementsToCoarsen() const;
+
+    /**
+     * @return the largest gradient magnitude (mV/cm) over the whole mesh found by the last
+     * ComputeIndicator() call.
+     */
+    double GetMaximumGradient() const;
+
+    /**
+     * Set the state of a new cell to a weighted combination of the states of existing cells,
+     * typically those at the vertices of the element containing the new cell's node, with
+     * weights from Element::CalculateInterpolationWeights().
+     *
+     * @param rCells  the existing cells, which must all have the same state variables as the new cell
+     * @param rWeights  the weight given to each cell's state
+     * @param pNewCell  the cell whose state is set
+     */
+    static void InterpolateCellState(const std::vector<AbstractCardiacCellInterface*>& rCells,
+                                     const std::vector<double>& rWeights,
+                                     AbstractCardiacCellInterface* pNewCell);
+};
+
+#endif /*WAVEFRONTREFINEMENTINDICATOR_HPP_*/
@@ -49,6 +49,10 @@ AbstractCardiacCellInterface*  AbstractCardiacCellFactory<ELEMENT_DIM,SPACE_DIM>
     else
     {
         AbstractCardiacCellInterface* p_cell = CreateCardiacCellForTissueNode(pNode);
+        if (mpSteadyStateDatabank)
+        {
+            InitialiseFromSteadyStateDatabank(p_cell);
+        }
 #ifdef CHASTE_CVODE
         if (dynamic_cast<AbstractCvodeCell*>(p_cell))
         {
@@ -66,6 +70,31 @@ AbstractCardiacCellInterface*  AbstractCardiacCellFactory<ELEMENT_DIM,SPACE_DIM>
     }
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractCardiacCellFactory<ELEMENT_DIM,SPACE_DIM>::InitialiseFromSteadyStateDatabank(AbstractCardiacCellInterface* pCell)
+{
+    std::string key = SteadyStateDatabank::GetKey(*pCell, mDatabankPacingCycleLength, mDatabankTag);
+    if (mpSteadyStateDatabank->Apply(key, *pCell))
+    {
+        return;
+    }
+#ifdef CHASTE_CVODE
+    AbstractCvodeCell* p_cvode_cell = dynamic_cast<AbstractCvodeCell*>(pCell);
+    if (p_cvode_cell)
+    {
+        // Steady state detection needs tighter tolerances than tissue simulation (see SteadyStateRunner)
+        double rel_tol = p_cvode_cell->GetRelativeTolerance();
+        double abs_tol = p_cvode_cell->GetAbsoluteTolerance();
+        p_cvode_cell->SetTolerances(1e-6, 1e-8);
+        mpSteadyStateDatabank->RunToSteadyState(key, *p_cvode_cell, mDatabankPacingCycleLength);
+        p_cvode_cell->SetTolerances(rel_tol, abs_tol);
+        return;
+    }
+#endif // CHASTE_CVODE
+    EXCEPTION("The steady state databank has no state for this cell and can only compute "
+              "missing states for CVODE cell models.");
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void AbstractCardiacCellFactory<ELEMENT_DIM,SPACE_DIM>::FinaliseCellCreation(
     std::vector< AbstractCardiacCellInterface* >* pCellsDistributed,
@@ -94,6 +123,7 @@ AbstractCardiacCellFactory<ELEMENT_DIM,SPACE_DIM>::AbstractCardiacCellFactory(
         boost::shared_ptr<AbstractIvpOdeSolver> pSolver)
     : mpMesh(NULL),
       mpHeartGeometryInformation(NULL),
+      mDatabankPacingCycleLength(1000.0),
       mpZeroStimulus(new ZeroStimulus),
       mpSolver(pSolver)
 {
@@ -136,6 +166,22 @@ HeartGeometryInformation<SPACE_DIM>* AbstractCardiacCellFactory<ELEMENT_DIM,SPAC
     return mpHeartGeometryInformation;
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractCardiacCellFactory<ELEMENT_DIM,SPACE_DIM>::SetSteadyStateDatabank(boost::shared_ptr<SteadyStateDatabank> pDatabank,
+                                                                              double pacingCycleLength,
+                                                                              const std::string& rTag)
+{
+    mpSteadyStateDatabank = pDatabank;
+    mDatabankPacingCycleLength = pacingCycleLength;
+    mDatabankTag = rTag;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+boost::shared_ptr<SteadyStateDatabank> AbstractCardiacCellFactory<ELEMENT_DIM,SPACE_DIM>::GetSteadyStateDatabank()
+{
+    return mpSteadyStateDatabank;
+}
+
 // Explicit instantiation
 template class AbstractCardiacCellFactory<1,1>;
 template class AbstractCardiacCellFactory<1,2>;
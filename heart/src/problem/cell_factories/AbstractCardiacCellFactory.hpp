@@ -37,6 +37,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef ABSTRACTCARDIACCELLFACTORY_HPP_
 #define ABSTRACTCARDIACCELLFACTORY_HPP_
 
+#include <string>
 #include <boost/shared_ptr.hpp>
 
 #include "AbstractCardiacCellInterface.hpp"
@@ -45,6 +46,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "EulerIvpOdeSolver.hpp"
 #include "HeartGeometryInformation.hpp"
 #include "HeartRegionCodes.hpp"
+#include "SteadyStateDatabank.hpp"
 #include "ZeroStimulus.hpp"
 
 /**
@@ -58,6 +60,9 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  *
  * This class saves the user having to create cells in parallel, that work is done
  * by the pde instead.
+ *
+ * If a SteadyStateDatabank is set (see SetSteadyStateDatabank()) every tissue cell is started
+ * from its paced steady state, which is looked up in the databank or computed and added to it.
  */
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM = ELEMENT_DIM>
 class AbstractCardiacCellFactory
@@ -74,6 +79,23 @@ private:
      */
     HeartGeometryInformation<SPACE_DIM>* mpHeartGeometryInformation;
 
+    /** The databank to initialise tissue cells from, if any. */
+    boost::shared_ptr<SteadyStateDatabank> mpSteadyStateDatabank;
+
+    /** The pacing cycle length (ms) of the steady states taken from #mpSteadyStateDatabank. */
+    double mDatabankPacingCycleLength;
+
+    /** The tag describing any other changes to the cells, used in #mpSteadyStateDatabank keys. */
+    std::string mDatabankTag;
+
+    /**
+     * Set a newly created tissue cell to its steady state from #mpSteadyStateDatabank,
+     * computing the steady state first if it is not yet in the databank.
+     *
+     * @param pCell  the cell
+     */
+    void InitialiseFromSteadyStateDatabank(AbstractCardiacCellInterface* pCell);
+
 protected:
     /** For use at un-stimulated cells. */
     boost::shared_ptr<ZeroStimulus> mpZeroStimulus;
@@ -154,6 +176,26 @@ public:
      * @return the HeartGeometryInformation object
      */
     HeartGeometryInformation<SPACE_DIM>* GetHeartGeometryInformation();
+
+    /**
+     * Start every tissue cell created by CreateCardiacCellForNode() from its steady state under
+     * regular pacing, instead of from the model's initial conditions. States missing from the
+     * databank are computed (CVODE cells with a default stimulus from CellML only) and added;
+     * the tissue calls SteadyStateDatabank::Synchronise() once all its cells have been created,
+     * after which the databank can be saved for later simulations.
+     *
+     * @param pDatabank  the databank
+     * @param pacingCycleLength  the pacing cycle length (ms) of the steady states
+     * @param rTag  describes any other changes the factory makes to the cells (see SteadyStateDatabank::GetKey())
+     */
+    void SetSteadyStateDatabank(boost::shared_ptr<SteadyStateDatabank> pDatabank,
+                                double pacingCycleLength,
+                                const std::string& rTag="");
+
+    /**
+     * @return the databank set by SetSteadyStateDatabank(), if any
+     */
+    boost::shared_ptr<SteadyStateDatabank> GetSteadyStateDatabank();
 };
 
 #endif /*ABSTRACTCARDIACCELLFACTORY_HPP_*/
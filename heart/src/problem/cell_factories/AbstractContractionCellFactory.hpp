@@ -37,7 +37,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define ABSTRACTCONTRACTIONCELLFACTORY_HPP_
 
 #include "AbstractContractionModel.hpp"
-#include "QuadraticMesh.hpp"
+#include "AbstractTetrahedralMesh.hpp"
 
 /**
  * A factory to ease creating contraction cell models for use in a electro-mechanics simulations.
@@ -58,8 +58,8 @@ private:
     friend class TestElectroMechanicsProblemDefinition;
 
 protected:
-    /** The mechanics mesh */
-    QuadraticMesh<DIM>* mpMesh;
+    /** The mechanics mesh (a QuadraticMesh or DistributedQuadraticMesh) */
+    AbstractTetrahedralMesh<DIM,DIM>* mpMesh;
 
 public:
     /**
@@ -81,7 +81,7 @@ public:
      *
      * @param pMesh  A quadratic (mechanics) mesh.
      */
-    void SetMechanicsMesh(QuadraticMesh<DIM>* pMesh)
+    void SetMechanicsMesh(AbstractTetrahedralMesh<DIM,DIM>* pMesh)
     {
         mpMesh = pMesh;
     }
@@ -113,12 +113,13 @@ AbstractCardiacCellInterface* HeartConfigRelatedCellFactory<SPACE_DIM>::CreateCe
         unsigned nodeIndex)
 {
     cp::ionic_model_selection_type ionic_model = mDefaultIonicModel;
+    Node<SPACE_DIM>* p_node = this->GetMesh()->GetNode(nodeIndex);
 
     for (unsigned ionic_model_region_index = 0;
          ionic_model_region_index < mIonicModelRegions.size();
          ++ionic_model_region_index)
     {
-        if (mIonicModelRegions[ionic_model_region_index]->DoesContain(this->GetMesh()->GetNode(nodeIndex)->GetPoint()))
+        if (mIonicModelRegions[ionic_model_region_index]->DoesContainNode(p_node))
         {
             ionic_model = mIonicModelsDefined[ionic_model_region_index];
             break;
@@ -250,23 +251,32 @@ template <unsigned SPACE_DIM>
 void HeartConfigRelatedCellFactory<SPACE_DIM>::SetCellParameters(AbstractCardiacCellInterface* pCell,
                                                                  unsigned nodeIndex)
 {
-    // Special case for backwards-compatibility: scale factors
+    // Which heterogeneity areas is this node in?
+    Node<SPACE_DIM>* p_node = this->GetMesh()->GetNode(nodeIndex);
+    std::vector<unsigned> areas_containing_node;
     for (unsigned ht_index = 0;
          ht_index < mCellHeterogeneityAreas.size();
          ++ht_index)
     {
-        if (mCellHeterogeneityAreas[ht_index]->DoesContain(this->GetMesh()->GetNode(nodeIndex)->GetPoint()))
+        if (mCellHeterogeneityAreas[ht_index]->DoesContainNode(p_node))
         {
-            try
-            {
-                pCell->SetParameter("ScaleFactorGks", mScaleFactorGks[ht_index]);
-                pCell->SetParameter("ScaleFactorGkr", mScaleFactorGkr[ht_index]);
-                pCell->SetParameter("ScaleFactorIto", mScaleFactorIto[ht_index]);
-            }
-            catch (const Exception&)
-            {
-                // Just ignore missing parameter errors in this case
-            }
+            areas_containing_node.push_back(ht_index);
+        }
+    }
+
+    // Special case for backwards-compatibility: scale factors
+    for (unsigned i = 0; i < areas_containing_node.size(); ++i)
+    {
+        const unsigned ht_index = areas_containing_node[i];
+        try
+        {
+            pCell->SetParameter("ScaleFactorGks", mScaleFactorGks[ht_index]);
+            pCell->SetParameter("ScaleFactorGkr", mScaleFactorGkr[ht_index]);
+            pCell->SetParameter("ScaleFactorIto", mScaleFactorIto[ht_index]);
+        }
+        catch (const Exception&)
+        {
+            // Just ignore missing parameter errors in this case
         }
     }
 
@@ -296,18 +306,14 @@ void HeartConfigRelatedCellFactory<SPACE_DIM>::SetCellParameters(AbstractCardiac
     }
 
     // SetParameter elements go next so they override the old ScaleFactor* elements.
-    for (unsigned ht_index = 0;
-         ht_index < mCellHeterogeneityAreas.size();
-         ++ht_index)
+    for (unsigned i = 0; i < areas_containing_node.size(); ++i)
     {
-        if (mCellHeterogeneityAreas[ht_index]->DoesContain(this->GetMesh()->GetNode(nodeIndex)->GetPoint()))
+        const unsigned ht_index = areas_containing_node[i];
+        for (std::map<std::string, double>::iterator param_it = mParameterSettings[ht_index].begin();
+             param_it != mParameterSettings[ht_index].end();
+             ++param_it)
         {
-            for (std::map<std::string, double>::iterator param_it = mParameterSettings[ht_index].begin();
-                 param_it != mParameterSettings[ht_index].end();
-                 ++param_it)
-            {
-                pCell->SetParameter(param_it->first, param_it->second);
-            }
+            pCell->SetParameter(param_it->first, param_it->second);
         }
     }
 }
@@ -317,12 +323,13 @@ void HeartConfigRelatedCellFactory<SPACE_DIM>::SetCellIntracellularStimulus(Abst
                                                                             unsigned nodeIndex)
 {
     boost::shared_ptr<MultiStimulus> node_specific_stimulus(new MultiStimulus());
+    Node<SPACE_DIM>* p_node = this->GetMesh()->GetNode(nodeIndex);
     // Check which of the defined stimuli contain the current node
     for (unsigned stimulus_index = 0;
          stimulus_index < mStimuliApplied.size();
          ++stimulus_index)
     {
-        if (mStimulatedAreas[stimulus_index]->DoesContain(this->GetMesh()->GetNode(nodeIndex)->GetPoint()))
+        if (mStimulatedAreas[stimulus_index]->DoesContainNode(p_node))
         {
             node_specific_stimulus->AddStimulus(mStimuliApplied[stimulus_index]);
         }
@@ -340,7 +347,7 @@ AbstractCardiacCellInterface* HeartConfigRelatedCellFactory<SPACE_DIM>::CreateCa
          stimulus_index < mStimuliApplied.size();
          ++stimulus_index)
     {
-        if (mStimulatedAreas[stimulus_index]->DoesContain(pNode->GetPoint()))
+        if (mStimulatedAreas[stimulus_index]->DoesContainNode(pNode))
         {
             node_specific_stimulus->AddStimulus(mStimuliApplied[stimulus_index]);
         }
@@ -350,6 +357,29 @@ AbstractCardiacCellInterface* HeartConfigRelatedCellFactory<SPACE_DIM>::CreateCa
     return CreateCellWithIntracellularStimulus(node_specific_stimulus, node_index);
 }
 
+template <unsigned SPACE_DIM>
+void HeartConfigRelatedCellFactory<SPACE_DIM>::AddIonicModelRegion(boost::shared_ptr<AbstractChasteRegion<SPACE_DIM> > pRegion,
+                                                                   const cp::ionic_model_selection_type& rIonicModel)
+{
+    if (rIonicModel.Dynamic().present())
+    {
+        EXCEPTION("Dynamically loaded ionic models can only be used in regions defined in HeartConfig.");
+    }
+    mIonicModelRegions.push_back(pRegion);
+    mIonicModelsDefined.push_back(rIonicModel);
+}
+
+template <unsigned SPACE_DIM>
+void HeartConfigRelatedCellFactory<SPACE_DIM>::AddCellHeterogeneityRegion(boost::shared_ptr<AbstractChasteRegion<SPACE_DIM> > pRegion,
+                                                                          const std::map<std::string, double>& rParameterSettings)
+{
+    mCellHeterogeneityAreas.push_back(pRegion);
+    mScaleFactorGks.push_back(1.0);
+    mScaleFactorIto.push_back(1.0);
+    mScaleFactorGkr.push_back(1.0);
+    mParameterSettings.push_back(rParameterSettings);
+}
+
 // LCOV_EXCL_START
 template <unsigned SPACE_DIM>
 void HeartConfigRelatedCellFactory<SPACE_DIM>::FillInCellularTransmuralAreas()
@@ -48,6 +48,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "SimpleStimulus.hpp"
 
 #include "ChasteCuboid.hpp"
+#include "ChasteNodeAttributeRegion.hpp"
 #include "AbstractChasteRegion.hpp"
 
 #include "DynamicCellModelLoader.hpp"
@@ -195,6 +196,28 @@ public:
      * @param nodeIndex  the index of the node corresponding to this cell in the mesh
      */
     void SetCellIntracellularStimulus(AbstractCardiacCellInterface* pCell, unsigned nodeIndex);
+
+    /**
+     * Use a different ionic model in a region, in addition to those defined in HeartConfig.
+     * Regions defined in HeartConfig take precedence. Regions defined by mesh labels (e.g. a
+     * ChasteNodeAttributeRegion) are much cheaper to look up than geometric ones.
+     *
+     * @param pRegion  the region
+     * @param rIonicModel  the ionic model to use in it
+     */
+    void AddIonicModelRegion(boost::shared_ptr<AbstractChasteRegion<SPACE_DIM> > pRegion,
+                             const cp::ionic_model_selection_type& rIonicModel);
+
+    /**
+     * Set cell model parameters in a region, in addition to the cell heterogeneities defined
+     * in HeartConfig. Settings are applied in the order the regions were defined, so these
+     * override the HeartConfig ones.
+     *
+     * @param pRegion  the region
+     * @param rParameterSettings  the values of named parameters to set in it
+     */
+    void AddCellHeterogeneityRegion(boost::shared_ptr<AbstractChasteRegion<SPACE_DIM> > pRegion,
+                                    const std::map<std::string, double>& rParameterSettings);
 };
 
 
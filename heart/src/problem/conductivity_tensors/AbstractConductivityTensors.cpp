@@ -35,6 +35,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "AbstractConductivityTensors.hpp"
 #include "Exception.hpp"
+#include <map>
 #include <sstream>
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
@@ -42,7 +43,10 @@ AbstractConductivityTensors<ELEMENT_DIM,SPACE_DIM>::AbstractConductivityTensors(
     : mpMesh(NULL),
       mUseNonConstantConductivities(false),
       mUseFibreOrientation(false),
-      mInitialised(false)
+      mInitialised(false),
+      mElementsPerFibre(1u),
+      mUseCompactStorage(false),
+      mOrientationDataSize(0u)
 {
     double init_data[]={DBL_MAX, DBL_MAX, DBL_MAX};
 
@@ -57,6 +61,41 @@ AbstractConductivityTensors<ELEMENT_DIM,SPACE_DIM>::~AbstractConductivityTensors
 {
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractConductivityTensors<ELEMENT_DIM,SPACE_DIM>::CheckFibreFileSize()
+{
+    assert(mFileReader && mpMesh);
+    const unsigned num_lines = mFileReader->GetNumLinesOfData();
+    const unsigned num_children = mpMesh->GetNumElementsPerParentElement();
+    if (num_lines == mpMesh->GetNumElements())
+    {
+        mElementsPerFibre = 1u;
+    }
+    else if (num_children > 1u && num_lines*num_children == mpMesh->GetNumElements())
+    {
+        mElementsPerFibre = num_children;
+    }
+    else
+    {
+        EXCEPTION("The size of the fibre file does not match the number of elements in the mesh");
+    }
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned AbstractConductivityTensors<ELEMENT_DIM,SPACE_DIM>::GetFibreIndex(unsigned globalElementIndex) const
+{
+    return globalElementIndex/mElementsPerFibre;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+double AbstractConductivityTensors<ELEMENT_DIM,SPACE_DIM>::GetMemoryUsage() const
+{
+    return double(mTensors.capacity())*sizeof(c_matrix<double,SPACE_DIM,SPACE_DIM>)
+           + double(mOrientationData.capacity())*sizeof(double)
+           + double(mDistinctConductivities.capacity())*sizeof(c_vector<double,SPACE_DIM>)
+           + double(mConductivityIndices.capacity())*sizeof(unsigned);
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void AbstractConductivityTensors<ELEMENT_DIM,SPACE_DIM>::SetFibreOrientationFile(const FileFinder &rFibreOrientationFile)
 {
@@ -107,6 +146,58 @@ void AbstractConductivityTensors<ELEMENT_DIM,SPACE_DIM>::SetNonConstantConductiv
     mpNonConstantConductivities = pNonConstantConductivities;
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractConductivityTensors<ELEMENT_DIM,SPACE_DIM>::SetUseCompactStorage(bool useCompactStorage)
+{
+    assert(!mInitialised);
+    mUseCompactStorage = useCompactStorage;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractConductivityTensors<ELEMENT_DIM,SPACE_DIM>::StoreCompactConductivities()
+{
+    assert(mUseCompactStorage);
+    mDistinctConductivities.clear();
+    mConductivityIndices.clear();
+
+    if (!mUseNonConstantConductivities)
+    {
+        for (unsigned dim=0; dim<SPACE_DIM; dim++)
+        {
+            assert(mConstantConductivities(dim) != DBL_MAX);
+        }
+        mDistinctConductivities.push_back(mConstantConductivities);
+        return;
+    }
+
+    // Heterogeneities are usually defined region by region, so there are few distinct values
+    std::map<std::vector<double>, unsigned> table_indices;
+    mConductivityIndices.reserve(mpNonConstantConductivities->size());
+    for (unsigned local_index=0; local_index<mpNonConstantConductivities->size(); local_index++)
+    {
+        const c_vector<double, SPACE_DIM>& r_conductivities = (*mpNonConstantConductivities)[local_index];
+        std::vector<double> key(r_conductivities.begin(), r_conductivities.end());
+        std::map<std::vector<double>, unsigned>::iterator it = table_indices.find(key);
+        if (it == table_indices.end())
+        {
+            it = table_indices.insert(std::make_pair(key, mDistinctConductivities.size())).first;
+            mDistinctConductivities.push_back(r_conductivities);
+        }
+        mConductivityIndices.push_back(it->second);
+    }
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+const c_vector<double, SPACE_DIM>& AbstractConductivityTensors<ELEMENT_DIM,SPACE_DIM>::rGetCompactConductivities(unsigned localIndex) const
+{
+    if (mConductivityIndices.empty())
+    {
+        return mDistinctConductivities[0];
+    }
+    assert(localIndex < mConductivityIndices.size());
+    return mDistinctConductivities[mConductivityIndices[localIndex]];
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 c_matrix<double,SPACE_DIM,SPACE_DIM>& AbstractConductivityTensors<ELEMENT_DIM,SPACE_DIM>::operator[](const unsigned global_index)
 {
@@ -123,6 +214,11 @@ c_matrix<double,SPACE_DIM,SPACE_DIM>& AbstractConductivityTensors<ELEMENT_DIM,SP
     else
     {
         unsigned local_index = mpMesh->SolveElementMapping(global_index); //This will throw if we don't own the element
+        if (mUseCompactStorage)
+        {
+            BuildCompactTensor(local_index, mCompactTensor);
+            return mCompactTensor;
+        }
         return mTensors[local_index];
     }
 }
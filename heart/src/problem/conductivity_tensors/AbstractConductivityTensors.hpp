@@ -77,6 +77,60 @@ protected:
     /** Fibre file reader */
     std::shared_ptr<FibreReader<SPACE_DIM> > mFileReader;
 
+    /** Number of consecutive elements that share each line of the fibre file (set by CheckFibreFileSize()) */
+    unsigned mElementsPerFibre;
+
+    /**
+     * Check that #mFileReader has a line for each element of the mesh, or for each element of the
+     * mesh it was refined from (see AbstractTetrahedralMesh::GetNumElementsPerParentElement()), in
+     * which case refined elements share the fibre of their parent. Called by Init().
+     */
+    void CheckFibreFileSize();
+
+    /**
+     * @return the line of the fibre file to use for an element
+     * @param globalElementIndex  the global index of the element
+     */
+    unsigned GetFibreIndex(unsigned globalElementIndex) const;
+
+    /** Whether to store orientations and conductivity indices rather than tensors (see SetUseCompactStorage()) */
+    bool mUseCompactStorage;
+
+    /** With compact storage, the number of entries of #mOrientationData per local element (set by Init()) */
+    unsigned mOrientationDataSize;
+
+    /** With compact storage, the fibre orientation of each local element, in a form chosen by the concrete class */
+    std::vector<double> mOrientationData;
+
+    /** With compact storage, the distinct conductivities used by the local elements */
+    std::vector<c_vector<double, SPACE_DIM> > mDistinctConductivities;
+
+    /** With compact storage, the index into #mDistinctConductivities of each local element (empty if all share one) */
+    std::vector<unsigned> mConductivityIndices;
+
+    /** With compact storage, the tensor most recently built by operator[] */
+    c_matrix<double,SPACE_DIM,SPACE_DIM> mCompactTensor;
+
+    /**
+     * With compact storage, fill in #mDistinctConductivities and #mConductivityIndices from the
+     * constant or non-constant conductivities that have been set. Called by Init().
+     */
+    void StoreCompactConductivities();
+
+    /**
+     * @return with compact storage, the conductivities of a local element
+     * @param localIndex  the local index of the element
+     */
+    const c_vector<double, SPACE_DIM>& rGetCompactConductivities(unsigned localIndex) const;
+
+    /**
+     * With compact storage, build the tensor of a local element from its orientation data and conductivities.
+     *
+     * @param localIndex  the local index of the element
+     * @param rTensor  filled in with the tensor
+     */
+    virtual void BuildCompactTensor(unsigned localIndex, c_matrix<double,SPACE_DIM,SPACE_DIM>& rTensor)=0;
+
 public:
 
     AbstractConductivityTensors();
@@ -124,6 +178,19 @@ public:
      */
     void SetNonConstantConductivities(std::vector<c_vector<double, SPACE_DIM> >* pNonConstantConductivities);
 
+    /**
+     * Store each element's fibre orientation and an index into a table of distinct conductivities,
+     * rather than its full tensor, and build tensors as they are requested.  This roughly halves the
+     * memory needed when there is fibre orientation or conductivity heterogeneity. Must be called
+     * before Init().
+     *
+     * Note that with compact storage the reference returned by operator[] is only valid until the
+     * next call.
+     *
+     * @param useCompactStorage  whether to use compact storage (defaults to true)
+     */
+    void SetUseCompactStorage(bool useCompactStorage=true);
+
     /**
      *  Computes the tensors based in all the info set
      * @param pMesh a pointer to the mesh on which these tensors are to be used
@@ -136,6 +203,12 @@ public:
      *  @param global_index Global index of the element of the mesh
      */
     c_matrix<double,SPACE_DIM,SPACE_DIM>& operator[](const unsigned global_index);
+
+    /**
+     * @return the bytes used to store the tensors (or, with compact storage, the orientations
+     * and conductivities) on this process
+     */
+    double GetMemoryUsage() const;
 };
 
 #endif /*ABSTRACTCONDUCTIVITYTENSORS_HPP_*/
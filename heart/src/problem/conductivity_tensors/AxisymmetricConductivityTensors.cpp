@@ -33,6 +33,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 */
 
+#include <climits>
 #include <vector>
 #include "UblasIncludes.hpp"
 #include "AxisymmetricConductivityTensors.hpp"
@@ -87,10 +88,7 @@ void AxisymmetricConductivityTensors<ELEMENT_DIM, SPACE_DIM>::Init(AbstractTetra
         {
             // open file
             this->mFileReader.reset(new FibreReader<SPACE_DIM>(this->mFibreOrientationFile, AXISYM));
-            if (this->mFileReader->GetNumLinesOfData() != this->mpMesh->GetNumElements())
-            {
-                EXCEPTION("The size of the fibre file does not match the number of elements in the mesh");
-            }
+            this->CheckFibreFileSize();
         }
 
         if (this->mUseNonConstantConductivities)
@@ -101,14 +99,28 @@ void AxisymmetricConductivityTensors<ELEMENT_DIM, SPACE_DIM>::Init(AbstractTetra
             }
         }
 
-        // reserve() allocates all the memory at once, more efficient than relying
-        // on the automatic reallocation scheme.
-        this->mTensors.reserve(this->mpMesh->GetNumLocalElements());
+        if (this->mUseCompactStorage)
+        {
+            // The fibre direction is all that is needed
+            this->mOrientationDataSize = (this->mUseFibreOrientation ? SPACE_DIM : 0u);
+            this->mOrientationData.clear();
+            this->mOrientationData.reserve(this->mOrientationDataSize*this->mpMesh->GetNumLocalElements());
+            this->StoreCompactConductivities();
+        }
+        else
+        {
+            // reserve() allocates all the memory at once, more efficient than relying
+            // on the automatic reallocation scheme.
+            this->mTensors.reserve(this->mpMesh->GetNumLocalElements());
+        }
 
         c_matrix<double, SPACE_DIM, SPACE_DIM> conductivity_matrix(zero_matrix<double>(SPACE_DIM,SPACE_DIM));
 
         unsigned local_element_index = 0;
 
+        // Elements of a refined mesh share their parent's fibre, which is only read once
+        unsigned last_fibre_index = UINT_MAX;
+
         for (typename AbstractTetrahedralMesh<ELEMENT_DIM,SPACE_DIM>::ElementIterator it = this->mpMesh->GetElementIteratorBegin();
              it != this->mpMesh->GetElementIteratorEnd();
              ++it)
@@ -138,6 +150,22 @@ void AxisymmetricConductivityTensors<ELEMENT_DIM, SPACE_DIM>::Init(AbstractTetra
              *
              */
 
+            if (this->mUseCompactStorage)
+            {
+                if (this->mUseFibreOrientation)
+                {
+                    unsigned current_fibre_global_index = this->GetFibreIndex(it->GetIndex());
+                    if (current_fibre_global_index != last_fibre_index)
+                    {
+                        this->mFileReader->GetFibreVector(current_fibre_global_index, fibre_vector);
+                        last_fibre_index = current_fibre_global_index;
+                    }
+                    this->mOrientationData.insert(this->mOrientationData.end(), fibre_vector.begin(), fibre_vector.end());
+                }
+                local_element_index++;
+                continue;
+            }
+
             if (this->mUseNonConstantConductivities)
             {
                 for (unsigned dim=0; dim<SPACE_DIM; dim++)
@@ -156,8 +184,12 @@ void AxisymmetricConductivityTensors<ELEMENT_DIM, SPACE_DIM>::Init(AbstractTetra
 
             if (this->mUseFibreOrientation)
             {
-                unsigned current_fibre_global_index = it->GetIndex();
-                this->mFileReader->GetFibreVector(current_fibre_global_index, fibre_vector);
+                unsigned current_fibre_global_index = this->GetFibreIndex(it->GetIndex());
+                if (current_fibre_global_index != last_fibre_index)
+                {
+                    this->mFileReader->GetFibreVector(current_fibre_global_index, fibre_vector);
+                    last_fibre_index = current_fibre_global_index;
+                }
             }
 
             this->mTensors.push_back( conductivity_matrix(1,1) * identity_matrix<double>(SPACE_DIM) +
@@ -166,8 +198,9 @@ void AxisymmetricConductivityTensors<ELEMENT_DIM, SPACE_DIM>::Init(AbstractTetra
             local_element_index++;
         }
 
-        assert(this->mTensors.size() == this->mpMesh->GetNumLocalElements());
-        assert(this->mTensors.size() == local_element_index);
+        assert(this->mUseCompactStorage || this->mTensors.size() == this->mpMesh->GetNumLocalElements());
+        assert(this->mUseCompactStorage || this->mTensors.size() == local_element_index);
+        assert(this->mOrientationData.size() == this->mOrientationDataSize*local_element_index);
 
         if (this->mUseFibreOrientation)
         {
@@ -179,6 +212,29 @@ void AxisymmetricConductivityTensors<ELEMENT_DIM, SPACE_DIM>::Init(AbstractTetra
     this->mInitialised = true;
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AxisymmetricConductivityTensors<ELEMENT_DIM, SPACE_DIM>::BuildCompactTensor(unsigned localIndex,
+                                                                                  c_matrix<double,SPACE_DIM,SPACE_DIM>& rTensor)
+{
+    const c_vector<double, SPACE_DIM>& r_conductivities = this->rGetCompactConductivities(localIndex);
+
+    // With no fibre file the fibre lies along the x axis
+    c_vector<double,SPACE_DIM> fibre_vector((zero_vector<double>(SPACE_DIM)));
+    fibre_vector[0] = 1.0;
+    if (this->mOrientationDataSize > 0u)
+    {
+        const double* p_data = &(this->mOrientationData[localIndex*this->mOrientationDataSize]);
+        for (unsigned dim=0; dim<SPACE_DIM; dim++)
+        {
+            fibre_vector[dim] = p_data[dim];
+        }
+    }
+
+    // As in Init(), the transverse conductivity is used for both the sheet and normal directions
+    noalias(rTensor) = r_conductivities(1) * identity_matrix<double>(SPACE_DIM) +
+                       (r_conductivities(0) - r_conductivities(1)) * outer_prod(fibre_vector, fibre_vector);
+}
+
 // Explicit instantiation
 
 // only makes sense for 3d elements in 3d, but we need the other to compile
@@ -45,6 +45,16 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 class AxisymmetricConductivityTensors : public AbstractConductivityTensors<ELEMENT_DIM, SPACE_DIM>
 {
+private:
+
+    /**
+     * Build the tensor of a local element from its stored fibre direction and conductivities.
+     *
+     * @param localIndex  the local index of the element
+     * @param rTensor  filled in with the tensor
+     */
+    void BuildCompactTensor(unsigned localIndex, c_matrix<double,SPACE_DIM,SPACE_DIM>& rTensor);
+
 public:
     /** Constructor */
     AxisymmetricConductivityTensors();
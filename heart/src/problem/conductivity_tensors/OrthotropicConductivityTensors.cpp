@@ -33,7 +33,10 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 */
 
+#include <climits>
+#include <cmath>
 #include "OrthotropicConductivityTensors.hpp"
+#include "UblasCustomFunctions.hpp"
 #include "Exception.hpp"
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
@@ -62,10 +65,7 @@ void OrthotropicConductivityTensors<ELEMENT_DIM, SPACE_DIM>::Init(AbstractTetrah
         {
             // open file
             this->mFileReader.reset(new FibreReader<SPACE_DIM>(this->mFibreOrientationFile, ORTHO));
-            if (this->mFileReader->GetNumLinesOfData() != this->mpMesh->GetNumElements())
-            {
-                EXCEPTION("The size of the fibre file does not match the number of elements in the mesh");
-            }
+            this->CheckFibreFileSize();
         }
 
         if (this->mUseNonConstantConductivities)
@@ -76,14 +76,28 @@ void OrthotropicConductivityTensors<ELEMENT_DIM, SPACE_DIM>::Init(AbstractTetrah
             }
         }
 
-        // reserve() allocates all the memory at once, more efficient than relying
-        // on the automatic reallocation scheme.
-        this->mTensors.reserve(this->mpMesh->GetNumLocalElements());
+        if (this->mUseCompactStorage)
+        {
+            // One angle in 2D or a unit quaternion in 3D; in 1D the orientation cannot change the tensor
+            this->mOrientationDataSize = (this->mUseFibreOrientation ? (SPACE_DIM==3 ? 4u : SPACE_DIM-1u) : 0u);
+            this->mOrientationData.clear();
+            this->mOrientationData.reserve(this->mOrientationDataSize*this->mpMesh->GetNumLocalElements());
+            this->StoreCompactConductivities();
+        }
+        else
+        {
+            // reserve() allocates all the memory at once, more efficient than relying
+            // on the automatic reallocation scheme.
+            this->mTensors.reserve(this->mpMesh->GetNumLocalElements());
+        }
 
         c_matrix<double, SPACE_DIM, SPACE_DIM> conductivity_matrix(zero_matrix<double>(SPACE_DIM,SPACE_DIM));
 
         unsigned local_element_index = 0;
 
+        // Elements of a refined mesh share their parent's fibre, which is only read once
+        unsigned last_fibre_index = UINT_MAX;
+
         for (typename AbstractTetrahedralMesh<ELEMENT_DIM,SPACE_DIM>::ElementIterator it = this->mpMesh->GetElementIteratorBegin();
              it != this->mpMesh->GetElementIteratorEnd();
              ++it)
@@ -107,6 +121,22 @@ void OrthotropicConductivityTensors<ELEMENT_DIM, SPACE_DIM>::Init(AbstractTetrah
              *  g_n = normal conductivity (constant or element specific)
              *
              */
+            if (this->mUseCompactStorage)
+            {
+                if (this->mUseFibreOrientation)
+                {
+                    unsigned current_fibre_global_index = this->GetFibreIndex(it->GetIndex());
+                    if (current_fibre_global_index != last_fibre_index)
+                    {
+                        this->mFileReader->GetFibreSheetAndNormalMatrix(current_fibre_global_index, orientation_matrix);
+                        last_fibre_index = current_fibre_global_index;
+                    }
+                    StoreCompactOrientation(orientation_matrix);
+                }
+                local_element_index++;
+                continue;
+            }
+
             if (this->mUseNonConstantConductivities)
             {
                 for (unsigned dim=0; dim<SPACE_DIM; dim++)
@@ -125,8 +155,12 @@ void OrthotropicConductivityTensors<ELEMENT_DIM, SPACE_DIM>::Init(AbstractTetrah
 
             if (this->mUseFibreOrientation)
             {
-                unsigned current_fibre_global_index = it->GetIndex();
-                this->mFileReader->GetFibreSheetAndNormalMatrix(current_fibre_global_index, orientation_matrix);
+                unsigned current_fibre_global_index = this->GetFibreIndex(it->GetIndex());
+                if (current_fibre_global_index != last_fibre_index)
+                {
+                    this->mFileReader->GetFibreSheetAndNormalMatrix(current_fibre_global_index, orientation_matrix);
+                    last_fibre_index = current_fibre_global_index;
+                }
             }
 
             c_matrix<double,SPACE_DIM,SPACE_DIM> temp;
@@ -135,8 +169,9 @@ void OrthotropicConductivityTensors<ELEMENT_DIM, SPACE_DIM>::Init(AbstractTetrah
 
             local_element_index++;
         }
-        assert(this->mTensors.size() == this->mpMesh->GetNumLocalElements());
-        assert(this->mTensors.size() == local_element_index);
+        assert(this->mUseCompactStorage || this->mTensors.size() == this->mpMesh->GetNumLocalElements());
+        assert(this->mUseCompactStorage || this->mTensors.size() == local_element_index);
+        assert(this->mOrientationData.size() == this->mOrientationDataSize*local_element_index);
 
         if (this->mUseFibreOrientation)
         {
@@ -148,6 +183,136 @@ void OrthotropicConductivityTensors<ELEMENT_DIM, SPACE_DIM>::Init(AbstractTetrah
     this->mInitialised = true;
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void OrthotropicConductivityTensors<ELEMENT_DIM, SPACE_DIM>::StoreCompactOrientation(c_matrix<double,SPACE_DIM,SPACE_DIM> orientationMatrix)
+{
+    /*
+     * The tensor F*G*F' does not change if a column of F changes sign, so a left-handed
+     * fibre-sheet-normal frame is made right-handed, and can then be stored as a rotation.
+     */
+    if (SPACE_DIM == 2)
+    {
+        if (Determinant(orientationMatrix) < 0.0)
+        {
+            orientationMatrix(0,1) = -orientationMatrix(0,1);
+            orientationMatrix(1,1) = -orientationMatrix(1,1);
+        }
+        this->mOrientationData.push_back(atan2(orientationMatrix(1,0), orientationMatrix(0,0)));
+    }
+    else if (SPACE_DIM == 3)
+    {
+        if (Determinant(orientationMatrix) < 0.0)
+        {
+            for (unsigned i=0; i<SPACE_DIM; i++)
+            {
+                orientationMatrix(i,SPACE_DIM-1) = -orientationMatrix(i,SPACE_DIM-1);
+            }
+        }
+
+        // Convert the rotation matrix to a unit quaternion (w,x,y,z), branching on the largest
+        // diagonal entry for accuracy
+        const c_matrix<double,SPACE_DIM,SPACE_DIM>& r = orientationMatrix;
+        unsigned z_index = SPACE_DIM-1; // avoids compiler warnings about indexing a 2x2 matrix
+        double trace = r(0,0) + r(1,1) + r(z_index,z_index);
+        double q[4];
+        if (trace > 0.0)
+        {
+            double s = 2.0*sqrt(1.0 + trace);
+            q[0] = 0.25*s;
+            q[1] = (r(z_index,1) - r(1,z_index))/s;
+            q[2] = (r(0,z_index) - r(z_index,0))/s;
+            q[3] = (r(1,0) - r(0,1))/s;
+        }
+        else if (r(0,0) > r(1,1) && r(0,0) > r(z_index,z_index))
+        {
+            double s = 2.0*sqrt(1.0 + r(0,0) - r(1,1) - r(z_index,z_index));
+            q[0] = (r(z_index,1) - r(1,z_index))/s;
+            q[1] = 0.25*s;
+            q[2] = (r(0,1) + r(1,0))/s;
+            q[3] = (r(0,z_index) + r(z_index,0))/s;
+        }
+        else if (r(1,1) > r(z_index,z_index))
+        {
+            double s = 2.0*sqrt(1.0 + r(1,1) - r(0,0) - r(z_index,z_index));
+            q[0] = (r(0,z_index) - r(z_index,0))/s;
+            q[1] = (r(0,1) + r(1,0))/s;
+            q[2] = 0.25*s;
+            q[3] = (r(1,z_index) + r(z_index,1))/s;
+        }
+        else
+        {
+            double s = 2.0*sqrt(1.0 + r(z_index,z_index) - r(0,0) - r(1,1));
+            q[0] = (r(1,0) - r(0,1))/s;
+            q[1] = (r(0,z_index) + r(z_index,0))/s;
+            q[2] = (r(1,z_index) + r(z_index,1))/s;
+            q[3] = 0.25*s;
+        }
+        double norm = sqrt(q[0]*q[0] + q[1]*q[1] + q[2]*q[2] + q[3]*q[3]);
+        for (unsigned i=0; i<4; i++)
+        {
+            this->mOrientationData.push_back(q[i]/norm);
+        }
+    }
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void OrthotropicConductivityTensors<ELEMENT_DIM, SPACE_DIM>::BuildCompactTensor(unsigned localIndex,
+                                                                                 c_matrix<double,SPACE_DIM,SPACE_DIM>& rTensor)
+{
+    const c_vector<double, SPACE_DIM>& r_conductivities = this->rGetCompactConductivities(localIndex);
+
+    if (this->mOrientationDataSize == 0u)
+    {
+        noalias(rTensor) = zero_matrix<double>(SPACE_DIM,SPACE_DIM);
+        for (unsigned dim=0; dim<SPACE_DIM; dim++)
+        {
+            rTensor(dim,dim) = r_conductivities(dim);
+        }
+        return;
+    }
+
+    const double* p_data = &(this->mOrientationData[localIndex*this->mOrientationDataSize]);
+    c_matrix<double,SPACE_DIM,SPACE_DIM> orientation_matrix;
+    if (SPACE_DIM == 2)
+    {
+        double c = cos(p_data[0]);
+        double s = sin(p_data[0]);
+        orientation_matrix(0,0) = c;
+        orientation_matrix(1,0) = s;
+        orientation_matrix(0,1) = -s;
+        orientation_matrix(1,1) = c;
+    }
+    else
+    {
+        assert(SPACE_DIM == 3);
+        unsigned z_index = SPACE_DIM-1; // avoids compiler warnings about indexing a 2x2 matrix
+        double w = p_data[0], x = p_data[1], y = p_data[2], z = p_data[3];
+        orientation_matrix(0,0) = 1.0 - 2.0*(y*y + z*z);
+        orientation_matrix(0,1) = 2.0*(x*y - z*w);
+        orientation_matrix(0,z_index) = 2.0*(x*z + y*w);
+        orientation_matrix(1,0) = 2.0*(x*y + z*w);
+        orientation_matrix(1,1) = 1.0 - 2.0*(x*x + z*z);
+        orientation_matrix(1,z_index) = 2.0*(y*z - x*w);
+        orientation_matrix(z_index,0) = 2.0*(x*z - y*w);
+        orientation_matrix(z_index,1) = 2.0*(y*z + x*w);
+        orientation_matrix(z_index,z_index) = 1.0 - 2.0*(x*x + y*y);
+    }
+
+    // tensor = F*G*F', with G diagonal
+    for (unsigned i=0; i<SPACE_DIM; i++)
+    {
+        for (unsigned j=0; j<SPACE_DIM; j++)
+        {
+            double value = 0.0;
+            for (unsigned k=0; k<SPACE_DIM; k++)
+            {
+                value += orientation_matrix(i,k)*r_conductivities(k)*orientation_matrix(j,k);
+            }
+            rTensor(i,j) = value;
+        }
+    }
+}
+
 // Explicit instantiation
 template class OrthotropicConductivityTensors<1,1>;
 template class OrthotropicConductivityTensors<1,2>;
@@ -59,6 +59,24 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 class OrthotropicConductivityTensors : public AbstractConductivityTensors<ELEMENT_DIM, SPACE_DIM>
 {
+private:
+
+    /**
+     * With compact storage, append an element's orientation to the orientation data: an angle
+     * in 2D and a unit quaternion in 3D.
+     *
+     * @param orientationMatrix  the fibre-sheet-normal matrix, by column (passed by value as it may be modified)
+     */
+    void StoreCompactOrientation(c_matrix<double,SPACE_DIM,SPACE_DIM> orientationMatrix);
+
+    /**
+     * Build the tensor of a local element from its stored orientation and conductivities.
+     *
+     * @param localIndex  the local index of the element
+     * @param rTensor  filled in with the tensor
+     */
+    void BuildCompactTensor(unsigned localIndex, c_matrix<double,SPACE_DIM,SPACE_DIM>& rTensor);
+
 public:
 
     /**
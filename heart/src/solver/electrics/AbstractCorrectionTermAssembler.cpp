@@ -34,13 +34,16 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "AbstractCorrectionTermAssembler.hpp"
+#include <algorithm>
 #include <typeinfo>
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
 AbstractCorrectionTermAssembler<ELEMENT_DIM,SPACE_DIM,PROBLEM_DIM>::AbstractCorrectionTermAssembler(
         AbstractTetrahedralMesh<ELEMENT_DIM,SPACE_DIM>* pMesh,
         AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>* pTissue)
-    : AbstractCardiacFeVolumeIntegralAssembler<ELEMENT_DIM,SPACE_DIM,PROBLEM_DIM,true,false,CARDIAC>(pMesh,pTissue)
+    : AbstractCardiacFeVolumeIntegralAssembler<ELEMENT_DIM,SPACE_DIM,PROBLEM_DIM,true,false,CARDIAC>(pMesh,pTissue),
+      mpElementCell(NULL),
+      mNextLocalNode(0u)
 {
     // Work out which elements can do SVI
     mElementsCanDoSvi.resize(pMesh->GetNumElements(), true);
@@ -76,7 +79,7 @@ AbstractCorrectionTermAssembler<ELEMENT_DIM,SPACE_DIM,PROBLEM_DIM>::AbstractCorr
             }
         }
     }
-    // Note: the mStateVariables std::vector is resized if correction will be applied to a given element
+    // Note: the state variable buffers are resized in AssembleOnElement()
 }
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
@@ -84,6 +87,7 @@ void AbstractCorrectionTermAssembler<ELEMENT_DIM,SPACE_DIM,PROBLEM_DIM>::ResetIn
 {
     // reset ionic current, and state variables
     mIionicInterp = 0;
+    mNextLocalNode = 0u;
     for (unsigned i=0; i<mStateVariablesAtQuadPoint.size(); i++)
     {
         mStateVariablesAtQuadPoint[i] = 0;
@@ -94,22 +98,56 @@ template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
 void AbstractCorrectionTermAssembler<ELEMENT_DIM,SPACE_DIM,PROBLEM_DIM>::IncrementInterpolatedQuantities(
             double phiI, const Node<SPACE_DIM>* pNode)
 {
+    // The nodes are visited in local order, so read them from the gathered buffers
+    const unsigned local_index = mNextLocalNode++;
+    assert(local_index < ELEMENT_DIM+1);
+    assert(mElementNodeIndices[local_index] == pNode->GetIndex());
+
     // interpolate ionic current
-    unsigned node_global_index = pNode->GetIndex();
-    mIionicInterp  += phiI * this->mpCardiacTissue->rGetIionicCacheReplicated()[ node_global_index ];
+    mIionicInterp += phiI * mElementIionic[local_index];
     // and state variables
-    std::vector<double> state_vars = this->mpCardiacTissue->GetCardiacCellOrHaloCell(node_global_index)->GetStdVecStateVariables();
-    for (unsigned i=0; i<mStateVariablesAtQuadPoint.size(); i++)
+    const unsigned num_state_vars = mStateVariablesAtQuadPoint.size();
+    const double* p_state_vars = &mElementStateVariables[local_index*num_state_vars];
+    for (unsigned i=0; i<num_state_vars; i++)
+    {
+        mStateVariablesAtQuadPoint[i] += phiI * p_state_vars[i];
+    }
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
+void AbstractCorrectionTermAssembler<ELEMENT_DIM,SPACE_DIM,PROBLEM_DIM>::AssembleOnElement(
+            Element<ELEMENT_DIM,SPACE_DIM>& rElement,
+            c_matrix<double,PROBLEM_DIM*(ELEMENT_DIM+1),PROBLEM_DIM*(ELEMENT_DIM+1)>& rAElem,
+            c_vector<double,PROBLEM_DIM*(ELEMENT_DIM+1)>& rBElem)
+{
+    // Gather the nodal data once, rather than once per quadrature point.
+    // All nodes of an SVI element share a cell model, so any cell will do
+    // for sizing the buffers and evaluating the ionic current.
+    mpElementCell = this->mpCardiacTissue->GetCardiacCellOrHaloCell(rElement.GetNodeGlobalIndex(0));
+    const unsigned num_state_vars = mpElementCell->GetNumberOfStateVariables();
+    mStateVariablesAtQuadPoint.resize(num_state_vars);
+    mElementStateVariables.resize((ELEMENT_DIM+1)*num_state_vars);
+
+    ReplicatableVector& r_cache = this->mpCardiacTissue->rGetIionicCacheReplicated();
+    for (unsigned local_index=0; local_index<ELEMENT_DIM+1; local_index++)
     {
-        mStateVariablesAtQuadPoint[i] += phiI * state_vars[i];
+        unsigned node_global_index = rElement.GetNodeGlobalIndex(local_index);
+        mElementNodeIndices[local_index] = node_global_index;
+        mElementIionic[local_index] = r_cache[node_global_index];
+
+        std::vector<double> state_vars = this->mpCardiacTissue->GetCardiacCellOrHaloCell(node_global_index)->GetStdVecStateVariables();
+        assert(state_vars.size() == num_state_vars);
+        std::copy(state_vars.begin(), state_vars.end(), mElementStateVariables.begin() + local_index*num_state_vars);
     }
+
+    AbstractCardiacFeVolumeIntegralAssembler<ELEMENT_DIM,SPACE_DIM,PROBLEM_DIM,true,false,CARDIAC>::AssembleOnElement(rElement, rAElem, rBElem);
 }
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
 bool AbstractCorrectionTermAssembler<ELEMENT_DIM,SPACE_DIM,PROBLEM_DIM>::ElementAssemblyCriterion(Element<ELEMENT_DIM,SPACE_DIM>& rElement)
 {
-    // Check that SVI is allowed on this element
-    if (!mElementsCanDoSvi[rElement.GetIndex()])
+    // Check that SVI is allowed on this element, and that it hasn't been switched off
+    if (!mElementsCanDoSvi[rElement.GetIndex()] || !this->mpCardiacTissue->IsElementActive(rElement))
     {
         return false;
     }
@@ -134,15 +172,7 @@ bool AbstractCorrectionTermAssembler<ELEMENT_DIM,SPACE_DIM,PROBLEM_DIM>::Element
         diionic = std::max(diionic, fabs(r_cache[rElement.GetNodeGlobalIndex(2)] - r_cache[rElement.GetNodeGlobalIndex(3)]) );
     }
 
-    bool will_assemble = (diionic > DELTA_IIONIC);
-
-    if (will_assemble)
-    {
-        unsigned any_node = rElement.GetNodeGlobalIndex(0);
-        mStateVariablesAtQuadPoint.resize(this->mpCardiacTissue->GetCardiacCellOrHaloCell(any_node)->GetNumberOfStateVariables() );
-    }
-
-    return will_assemble;
+    return (diionic > DELTA_IIONIC);
 }
 
 // Explicit instantiation
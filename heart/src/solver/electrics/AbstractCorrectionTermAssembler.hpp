@@ -56,6 +56,29 @@ protected:
     /** State variables interpolated onto quadrature point */
     std::vector<double> mStateVariablesAtQuadPoint;
 
+    /**
+     * State variables at the nodes of the element being assembled, gathered
+     * once per element by AssembleOnElement() and stored node by node, so
+     * that the quadrature loop reads them contiguously instead of asking each
+     * nodal cell for a copy of its state at every quadrature point.
+     */
+    std::vector<double> mElementStateVariables;
+
+    /** Ionic currents at the nodes of the element being assembled. */
+    c_vector<double, ELEM_DIM+1> mElementIionic;
+
+    /** Global indices of the nodes of the element being assembled. */
+    c_vector<unsigned, ELEM_DIM+1> mElementNodeIndices;
+
+    /**
+     * Cell at the first node of the element being assembled, used to
+     * evaluate the ionic current at the interpolated state.
+     */
+    AbstractCardiacCellInterface* mpElementCell;
+
+    /** Local index of the node IncrementInterpolatedQuantities() expects next. */
+    unsigned mNextLocalNode;
+
     /**
      * Resets interpolated state variables and ionic current.
      */
@@ -77,10 +100,33 @@ protected:
      */
     void IncrementInterpolatedQuantities(double phiI, const Node<SPACE_DIM>* pNode);
 
+    /**
+     * Gathers the nodal state variables and ionic currents of the element
+     * into mElementStateVariables and mElementIionic, then assembles on it
+     * as normal.
+     *
+     * @param rElement  the element
+     * @param rAElem  the element stiffness matrix (not used)
+     * @param rBElem  the element's contribution to the RHS vector
+     */
+    void AssembleOnElement(Element<ELEM_DIM,SPACE_DIM>& rElement,
+                           c_matrix<double,PROBLEM_DIM*(ELEM_DIM+1),PROBLEM_DIM*(ELEM_DIM+1)>& rAElem,
+                           c_vector<double,PROBLEM_DIM*(ELEM_DIM+1)>& rBElem);
+
+    /**
+     * @return false, as the interpolated quantities are stored in members,
+     * so elements cannot be assembled concurrently.
+     */
+    bool IsThreadSafe() const
+    {
+        return false;
+    }
+
     /**
      * @return true if we should assemble the correction term for this element.
      * Checks if there is a sufficiently steep ionic current gradient to make the expense worthwhile, by checking
      * if the maximum difference between nodal ionic currents is greater than 1 uA/cm^2^.
+     * Elements in inactive tissue regions are never assembled.
      *
      * @param rElement  the element to test
      */
@@ -45,6 +45,13 @@ void AbstractBidomainSolver<ELEMENT_DIM,SPACE_DIM>::InitialiseForSolve(Vec initi
     // The base class method that calls this function will only call it with a null linear system
     assert(this->mpLinearSystem == NULL);
 
+    // The bidomain linear system is modified row by row (Dirichlet conditions, the row for the
+    // average of phi_e and bath rows), which a shell operator cannot support
+    if (HeartConfig::Instance()->GetUseMatrixFreeOperators())
+    {
+        EXCEPTION("Matrix-free operators are only supported by the monodomain solver");
+    }
+
     // linear system created here
     AbstractDynamicLinearPdeSolver<ELEMENT_DIM, SPACE_DIM, 2>::InitialiseForSolve(initialSolution);
 
@@ -74,7 +81,28 @@ void AbstractBidomainSolver<ELEMENT_DIM,SPACE_DIM>::InitialiseForSolve(Vec initi
     // Note that twolevelblockdiagonal was never finished.  It was a preconditioner specific to the Parabolic-Parabolic formulation of Bidomain
     // Two levels block diagonal only worked in serial with TetrahedralMesh.
     assert(std::string(HeartConfig::Instance()->GetKSPPreconditioner()) != std::string("twolevelsblockdiagonal"));
-    this->mpLinearSystem->SetPcType(HeartConfig::Instance()->GetKSPPreconditioner());
+    if (std::string(HeartConfig::Instance()->GetKSPPreconditioner()) == std::string("tissuebathmultilevel"))
+    {
+        // The preconditioner splits the unknowns into tissue and bath, so needs the (locally owned) bath nodes
+        boost::shared_ptr<std::vector<PetscInt> > p_bath_nodes(new std::vector<PetscInt>);
+        if (mBathSimulation)
+        {
+            for (typename AbstractTetrahedralMesh<ELEMENT_DIM,SPACE_DIM>::NodeIterator iter=this->mpMesh->GetNodeIteratorBegin();
+                 iter != this->mpMesh->GetNodeIteratorEnd();
+                 ++iter)
+            {
+                if (HeartRegionCode::IsRegionBath((*iter).GetRegion()))
+                {
+                    p_bath_nodes->push_back(iter->GetIndex());
+                }
+            }
+        }
+        this->mpLinearSystem->SetPcType(HeartConfig::Instance()->GetKSPPreconditioner(), p_bath_nodes);
+    }
+    else
+    {
+        this->mpLinearSystem->SetPcType(HeartConfig::Instance()->GetKSPPreconditioner());
+    }
 
     if (mRowForAverageOfPhiZeroed == INT_MAX)
     {
@@ -92,7 +120,11 @@ void AbstractBidomainSolver<ELEMENT_DIM,SPACE_DIM>::InitialiseForSolve(Vec initi
 
     this->mpLinearSystem->SetUseFixedNumberIterations(
         HeartConfig::Instance()->GetUseFixedNumberIterationsLinearSolver(),
-        HeartConfig::Instance()->GetEvaluateNumItsEveryNSolves());
+        HeartConfig::Instance()->GetEvaluateNumItsEveryNSolves(),
+        HeartConfig::Instance()->GetFixedNumberIterationsLinearSolver());
+    this->SetInitialGuessType(
+        HeartConfig::Instance()->GetLinearSolverInitialGuessType(),
+        HeartConfig::Instance()->GetLinearSolverInitialGuessNumPreviousSolutions());
 }
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
@@ -216,7 +248,7 @@ void AbstractBidomainSolver<ELEMENT_DIM,SPACE_DIM>::CheckCompatibilityCondition(
     }
 
     double global_sum;
-    int mpi_ret = MPI_Allreduce(&local_sum, &global_sum, 1, MPI_DOUBLE, MPI_SUM, PETSC_COMM_WORLD);
+    int mpi_ret = MPI_Allreduce(&local_sum, &global_sum, 1, MPI_DOUBLE, MPI_SUM, PetscTools::GetWorld());
     assert(mpi_ret == MPI_SUCCESS);
 
     if (fabs(global_sum)>1e-6) // magic number! sum should really be a sum of zeros and exactly zero though anyway (or a-a+b-b+c-c.. etc in the case of electrodes)
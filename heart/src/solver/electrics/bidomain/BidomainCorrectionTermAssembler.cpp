@@ -62,9 +62,7 @@ c_vector<double,2*(ELEM_DIM+1)> BidomainCorrectionTermAssembler<ELEM_DIM,SPACE_D
     // compute the ionic current at this quadrature point using the
     // interpolated state variables, and a random choice of cell (all
     // should be the same)
-    unsigned node_global_index = pElement->GetNodeGlobalIndex(0);
-    AbstractCardiacCellInterface* p_any_cell = this->mpCardiacTissue->GetCardiacCellOrHaloCell(node_global_index);
-    double ionic_sv_interp = p_any_cell->GetIIonic(&(this->mStateVariablesAtQuadPoint));
+    double ionic_sv_interp = this->mpElementCell->GetIIonic(&(this->mStateVariablesAtQuadPoint));
 
     c_vector<double,2*(ELEM_DIM+1)> ret;
 
@@ -49,7 +49,7 @@ c_matrix<double,2*(DIM+1),2*(DIM+1)> BidomainMassMatrixAssembler<DIM>::ComputeMa
 
     if (!HeartRegionCode::IsRegionBath( pElement->GetUnsignedAttribute() ))
     {
-        c_matrix<double, DIM+1, DIM+1> basis_outer_prod = outer_prod(rPhi, rPhi);
+        c_matrix<double, DIM+1, DIM+1> basis_outer_prod = OuterProduct(rPhi, rPhi);
 
         // even rows, even columns
         matrix_slice<c_matrix<double, 2*DIM+2, 2*DIM+2> >
@@ -225,8 +225,9 @@ BidomainSolver<ELEMENT_DIM,SPACE_DIM>::BidomainSolver(
     {
         mpBidomainCorrectionTermAssembler
             = new BidomainCorrectionTermAssembler<ELEMENT_DIM,SPACE_DIM>(this->mpMesh,this->mpBidomainTissue);
-        //We are going to need those caches after all
+        //We are going to need those caches after all, but only at the halo nodes
         pTissue->SetCacheReplication(true);
+        pTissue->SetHaloOnlyCacheReplication(true);
     }
     else
     {
@@ -35,14 +35,30 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "AbstractExtendedBidomainSolver.hpp"
 
+#include <cstring>
+#include "HeartEventHandler.hpp"
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void AbstractExtendedBidomainSolver<ELEMENT_DIM, SPACE_DIM>::InitialiseForSolve(Vec initialSolution)
 {
     // The base class method that calls this function will only call it with a null linear system
     assert(this->mpLinearSystem == NULL);
 
-    // linear system created here
-    AbstractDynamicLinearPdeSolver<ELEMENT_DIM, SPACE_DIM, 3>::InitialiseForSolve(initialSolution);
+    // Create the linear system here rather than in the base class, so that the LHS matrix
+    // knows it has three interleaved unknowns per node (see PetscTools::SetupMat)
+    unsigned preallocation = 3*this->mpMesh->CalculateMaximumNodeConnectivityPerProcess();
+    HeartEventHandler::BeginEvent(HeartEventHandler::COMMUNICATION);
+    if (initialSolution == nullptr)
+    {
+        Vec template_vec = this->mpMesh->GetDistributedVectorFactory()->CreateVec(3);
+        this->mpLinearSystem = new LinearSystem(template_vec, preallocation, true, 3);
+        PetscTools::Destroy(template_vec);
+    }
+    else
+    {
+        this->mpLinearSystem = new LinearSystem(initialSolution, preallocation, true, 3);
+    }
+    HeartEventHandler::EndEvent(HeartEventHandler::COMMUNICATION);
 
     if (HeartConfig::Instance()->GetUseAbsoluteTolerance())
     {
@@ -60,7 +76,16 @@ void AbstractExtendedBidomainSolver<ELEMENT_DIM, SPACE_DIM>::InitialiseForSolve(
     }
 
     this->mpLinearSystem->SetKspType(HeartConfig::Instance()->GetKSPSolver());
-    this->mpLinearSystem->SetPcType(HeartConfig::Instance()->GetKSPPreconditioner());
+    if (strcmp(HeartConfig::Instance()->GetKSPPreconditioner(), "blockdiagonal") == 0)
+    {
+        // The two-field block diagonal preconditioner of the bidomain equations becomes
+        // its three-field counterpart here
+        this->mpLinearSystem->SetPcType("threefieldblockdiagonal");
+    }
+    else
+    {
+        this->mpLinearSystem->SetPcType(HeartConfig::Instance()->GetKSPPreconditioner());
+    }
 
     if (mRowForAverageOfPhiZeroed == INT_MAX)
     {
@@ -184,7 +209,7 @@ void AbstractExtendedBidomainSolver<ELEMENT_DIM,SPACE_DIM>::CheckCompatibilityCo
     }
 
     double global_sum;
-    int mpi_ret = MPI_Allreduce(&local_sum, &global_sum, 1, MPI_DOUBLE, MPI_SUM, PETSC_COMM_WORLD);
+    int mpi_ret = MPI_Allreduce(&local_sum, &global_sum, 1, MPI_DOUBLE, MPI_SUM, PetscTools::GetWorld());
     assert(mpi_ret == MPI_SUCCESS);
 
     if (fabs(global_sum)>1e-6) // magic number! sum should really be a sum of zeros and exactly zero though anyway (or a-a+b-b+c-c.. etc in the case of electrodes)
@@ -62,20 +62,17 @@ c_matrix<double,3*(ELEMENT_DIM+1),3*(ELEMENT_DIM+1)>
 
     double delta_t = PdeSimulationTime::GetPdeTimeStep();
 
-    c_matrix<double, SPACE_DIM, ELEMENT_DIM+1> temp_1 = prod(sigma_i_first_cell, rGradPhi);
     c_matrix<double, ELEMENT_DIM+1, ELEMENT_DIM+1> grad_phi_sigma_i_first_cell_grad_phi =
-        prod(trans(rGradPhi), temp_1);
+        WeightedTransposeProduct(rGradPhi, sigma_i_first_cell);
 
-    c_matrix<double, SPACE_DIM, ELEMENT_DIM+1> temp_2 = prod(sigma_i_second_cell, rGradPhi);
     c_matrix<double, ELEMENT_DIM+1, ELEMENT_DIM+1> grad_phi_sigma_i_second_cell_grad_phi =
-        prod(trans(rGradPhi), temp_2);
+        WeightedTransposeProduct(rGradPhi, sigma_i_second_cell);
 
     c_matrix<double, ELEMENT_DIM+1, ELEMENT_DIM+1> basis_outer_prod =
-        outer_prod(rPhi, rPhi);
+        OuterProduct(rPhi, rPhi);
 
-    c_matrix<double, SPACE_DIM, ELEMENT_DIM+1> temp_ext = prod(sigma_e, rGradPhi);
     c_matrix<double, ELEMENT_DIM+1, ELEMENT_DIM+1> grad_phi_sigma_e_grad_phi =
-        prod(trans(rGradPhi), temp_ext);
+        WeightedTransposeProduct(rGradPhi, sigma_e);
 
 
     c_matrix<double,3*(ELEMENT_DIM+1),3*(ELEMENT_DIM+1)> ret;
@@ -51,7 +51,7 @@ c_matrix<double,3*(DIM+1),3*(DIM+1)> ExtendedBidomainMassMatrixAssembler<DIM>::C
 
     if (!HeartRegionCode::IsRegionBath( pElement->GetUnsignedAttribute() )) // ie if a tissue element
     {
-        c_matrix<double, DIM+1, DIM+1> basis_outer_prod = outer_prod(rPhi, rPhi);
+        c_matrix<double, DIM+1, DIM+1> basis_outer_prod = OuterProduct(rPhi, rPhi);
 
         // first row,  first column
         matrix_slice<c_matrix<double, 3*DIM+3, 3*DIM+3> >
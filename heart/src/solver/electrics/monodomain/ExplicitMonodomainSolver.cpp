@@ -0,0 +1,381 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#include "ExplicitMonodomainSolver.hpp"
+
+#include <cmath>
+
+#include "MassMatrixAssembler.hpp"
+#include "MonodomainStiffnessMatrixAssembler.hpp"
+#include "PetscMatTools.hpp"
+#include "PetscVecTools.hpp"
+#include "TimeStepper.hpp"
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void ExplicitMonodomainSolver<ELEMENT_DIM,SPACE_DIM>::SetupLinearSystem(Vec currentSolution, bool computeMatrix)
+{
+    NEVER_REACHED;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void ExplicitMonodomainSolver<ELEMENT_DIM,SPACE_DIM>::InitialiseForSolve(Vec initialSolution)
+{
+    if (mStiffnessMatrix != NULL)
+    {
+        return;
+    }
+
+    PetscInt ownership_range_lo;
+    PetscInt ownership_range_hi;
+    VecGetOwnershipRange(initialSolution, &ownership_range_lo, &ownership_range_hi);
+    PetscInt local_size = ownership_range_hi - ownership_range_lo;
+    unsigned num_nodes = this->mpMesh->GetNumNodes();
+    unsigned row_preallocation = this->mpMesh->CalculateMaximumNodeConnectivityPerProcess();
+
+    // Stiffness matrix
+    PetscTools::SetupMat(mStiffnessMatrix, num_nodes, num_nodes, row_preallocation, local_size, local_size);
+    MonodomainStiffnessMatrixAssembler<ELEMENT_DIM,SPACE_DIM> stiffness_matrix_assembler(this->mpMesh, mpMonodomainTissue);
+    stiffness_matrix_assembler.SetMatrixToAssemble(mStiffnessMatrix);
+    stiffness_matrix_assembler.AssembleMatrix();
+    PetscMatTools::Finalise(mStiffnessMatrix);
+
+    // Lumped mass matrix: only its diagonal is kept
+    Mat lumped_mass_matrix;
+    PetscTools::SetupMat(lumped_mass_matrix, num_nodes, num_nodes, row_preallocation, local_size, local_size);
+    MassMatrixAssembler<ELEMENT_DIM,SPACE_DIM> mass_matrix_assembler(this->mpMesh, true /* lumped */);
+    mass_matrix_assembler.SetMatrixToAssemble(lumped_mass_matrix);
+    mass_matrix_assembler.Assemble();
+    PetscMatTools::Finalise(lumped_mass_matrix);
+
+    VecDuplicate(initialSolution, &mInverseLumpedMass);
+    MatGetDiagonal(lumped_mass_matrix, mInverseLumpedMass);
+    PetscTools::Destroy(lumped_mass_matrix);
+    VecScale(mInverseLumpedMass, HeartConfig::Instance()->GetSurfaceAreaToVolumeRatio()*HeartConfig::Instance()->GetCapacitance());
+    VecReciprocal(mInverseLumpedMass);
+
+    VecDuplicate(initialSolution, &mSourceTerm);
+    VecDuplicate(initialSolution, &mSurfaceTerm);
+    VecDuplicate(initialSolution, &mStageDerivative);
+    for (unsigned i=0; i<3; i++)
+    {
+        VecDuplicate(initialSolution, &mStages[i]);
+    }
+
+    /*
+     * Gershgorin bound on the spectral radius of (chi*C M_L)^{-1} K: the largest absolute
+     * row sum of K scaled by the inverse lumped mass.
+     */
+    DistributedVectorFactory* p_factory = this->mpMesh->GetDistributedVectorFactory();
+    DistributedVector inverse_lumped_mass = p_factory->CreateDistributedVector(mInverseLumpedMass);
+    double local_bound = 0.0;
+    for (DistributedVector::Iterator index = inverse_lumped_mass.Begin();
+         index != inverse_lumped_mass.End();
+         ++index)
+    {
+        PetscInt num_cols;
+        const PetscInt* p_cols;
+        const PetscScalar* p_values;
+        PetscInt row = index.Global;
+        MatGetRow(mStiffnessMatrix, row, &num_cols, &p_cols, &p_values);
+        double abs_row_sum = 0.0;
+        for (PetscInt j=0; j<num_cols; j++)
+        {
+            abs_row_sum += fabs(p_values[j]);
+        }
+        MatRestoreRow(mStiffnessMatrix, row, &num_cols, &p_cols, &p_values);
+        local_bound = std::max(local_bound, abs_row_sum*inverse_lumped_mass[index]);
+    }
+    MPI_Allreduce(&local_bound, &mSpectralRadiusBound, 1, MPI_DOUBLE, MPI_MAX, PetscTools::GetWorld());
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void ExplicitMonodomainSolver<ELEMENT_DIM,SPACE_DIM>::ComputeStageCoefficients(double dt)
+{
+    // Damping parameter of the RKC scheme, which keeps the stability region away from the imaginary axis
+    const double epsilon = 0.05;
+
+    unsigned num_stages = 1;
+    std::vector<double> chebyshev; // T_j(w0)
+    std::vector<double> chebyshev_derivative; // T_j'(w0)
+    double w0, w1;
+    while (true)
+    {
+        w0 = 1.0 + epsilon/(num_stages*num_stages);
+        chebyshev.assign(num_stages+1, 1.0);
+        chebyshev_derivative.assign(num_stages+1, 0.0);
+        chebyshev[1] = w0;
+        chebyshev_derivative[1] = 1.0;
+        for (unsigned j=2; j<=num_stages; j++)
+        {
+            chebyshev[j] = 2.0*w0*chebyshev[j-1] - chebyshev[j-2];
+            chebyshev_derivative[j] = 2.0*chebyshev[j-1] + 2.0*w0*chebyshev_derivative[j-1] - chebyshev_derivative[j-2];
+        }
+        w1 = chebyshev[num_stages]/chebyshev_derivative[num_stages];
+
+        // The scheme is stable for dt*lambda in [-(1+w0)/w1, 0]
+        if ((1.0 + w0)/w1 >= dt*mSpectralRadiusBound)
+        {
+            break;
+        }
+        num_stages++;
+        // LCOV_EXCL_START
+        if (num_stages > 10000u)
+        {
+            EXCEPTION("The explicit monodomain solver would need more than 10000 stages per time step; reduce the PDE time step");
+        }
+        // LCOV_EXCL_STOP
+    }
+
+    mMu.assign(num_stages+1, 0.0);
+    mNu.assign(num_stages+1, 0.0);
+    mMuTilde.assign(num_stages+1, 0.0);
+    mMu[1] = 1.0;
+    mMuTilde[1] = w1/w0;
+    for (unsigned j=2; j<=num_stages; j++)
+    {
+        mMu[j] = 2.0*w0*chebyshev[j-1]/chebyshev[j];
+        mNu[j] = -chebyshev[j-2]/chebyshev[j];
+        mMuTilde[j] = 2.0*w1*chebyshev[j-1]/chebyshev[j];
+    }
+    mStagesTimeStep = dt;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void ExplicitMonodomainSolver<ELEMENT_DIM,SPACE_DIM>::ComputeDerivative(Vec voltage)
+{
+    MatMult(mStiffnessMatrix, voltage, mStageDerivative);
+    // f = source - M_lumped^{-1} K V, in one pass
+    PetscVecTools::PointwiseMultAndAdd(mStageDerivative, -1.0, mInverseLumpedMass, mStageDerivative, mSourceTerm);
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void ExplicitMonodomainSolver<ELEMENT_DIM,SPACE_DIM>::TakeTimeStep(Vec voltage, double dt)
+{
+    HeartEventHandler::BeginEvent(HeartEventHandler::ASSEMBLE_RHS);
+
+    // Ionic and stimulus currents, frozen over the time step
+    DistributedVectorFactory* p_factory = this->mpMesh->GetDistributedVectorFactory();
+    DistributedVector source_term = p_factory->CreateDistributedVector(mSourceTerm);
+    double Am = HeartConfig::Instance()->GetSurfaceAreaToVolumeRatio();
+    double Cm = HeartConfig::Instance()->GetCapacitance();
+    ReplicatableVector& r_iionic_cache = this->mpMonodomainTissue->rGetIionicCacheReplicated();
+    ReplicatableVector& r_stimulus_cache = this->mpMonodomainTissue->rGetIntracellularStimulusCacheReplicated();
+    double* p_source_term = source_term.GetLocalArray();
+    const unsigned lo = source_term.GetLow();
+    const unsigned num_local = source_term.GetHigh() - lo;
+    for (unsigned local_index=0; local_index<num_local; local_index++)
+    {
+        double F = - Am*r_iionic_cache[lo + local_index]
+                   - r_stimulus_cache[lo + local_index];
+        p_source_term[local_index] = F/(Am*Cm);
+    }
+    source_term.Restore();
+
+    // Surface stimuli
+    if (mpBoundaryConditions->AnyNonZeroNeumannConditions())
+    {
+        mpNeumannSurfaceTermsAssembler->SetVectorToAssemble(mSurfaceTerm, true);
+        mpNeumannSurfaceTermsAssembler->AssembleVector();
+        PetscVecTools::PointwiseMultAndAdd(mSourceTerm, 1.0, mInverseLumpedMass, mSurfaceTerm, mSourceTerm);
+    }
+    HeartEventHandler::EndEvent(HeartEventHandler::ASSEMBLE_RHS);
+
+    HeartEventHandler::BeginEvent(HeartEventHandler::SOLVE_LINEAR_SYSTEM);
+    if (dt != mStagesTimeStep)
+    {
+        ComputeStageCoefficients(dt);
+    }
+    unsigned num_stages = mMu.size() - 1;
+
+    // Y_1 = Y_0 + mu_tilde_1*dt*f(Y_0)
+    Vec p_two_back = mStages[0];
+    Vec p_one_back = mStages[1];
+    Vec p_current = mStages[2];
+    VecCopy(voltage, p_two_back);
+    ComputeDerivative(p_two_back);
+    VecWAXPY(p_one_back, mMuTilde[1]*dt, mStageDerivative, p_two_back);
+
+    // Y_j = mu_j*Y_{j-1} + nu_j*Y_{j-2} + mu_tilde_j*dt*f(Y_{j-1})
+    for (unsigned j=2; j<=num_stages; j++)
+    {
+        ComputeDerivative(p_one_back);
+        PetscVecTools::WAXPBYPCZ(p_current, mMu[j], p_one_back, mMuTilde[j]*dt, mStageDerivative, mNu[j], p_two_back);
+
+        Vec p_temp = p_two_back;
+        p_two_back = p_one_back;
+        p_one_back = p_current;
+        p_current = p_temp;
+    }
+    VecCopy(p_one_back, voltage);
+    HeartEventHandler::EndEvent(HeartEventHandler::SOLVE_LINEAR_SYSTEM);
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void ExplicitMonodomainSolver<ELEMENT_DIM,SPACE_DIM>::PrepareForSetupLinearSystem(Vec currentSolution)
+{
+    // solve cell models
+    mpMonodomainTissue->SolveCellSystems(currentSolution, PdeSimulationTime::GetTime(), PdeSimulationTime::GetNextTime());
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+Vec ExplicitMonodomainSolver<ELEMENT_DIM,SPACE_DIM>::Solve()
+{
+    if (!this->mTimesSet)
+    {
+        EXCEPTION("SetTimes() has not been called");
+    }
+    if (this->mIdealTimeStep <= 0.0)
+    {
+        EXCEPTION("SetTimeStep() has not been called");
+    }
+    if (this->mInitialCondition == nullptr)
+    {
+        EXCEPTION("SetInitialCondition() has not been called");
+    }
+    if (this->mpTimeAdaptivityController)
+    {
+        EXCEPTION("The explicit monodomain solver does not support time adaptivity");
+    }
+
+    InitialiseForSolve(this->mInitialCondition);
+
+    Vec solution;
+    VecDuplicate(this->mInitialCondition, &solution);
+    VecCopy(this->mInitialCondition, solution);
+
+    TimeStepper stepper(this->mTstart, this->mTend, this->mIdealTimeStep);
+    while (!stepper.IsTimeAtEnd())
+    {
+        double dt = stepper.GetNextTimeStep();
+        PdeSimulationTime::SetTime(stepper.GetTime());
+        PdeSimulationTime::SetPdeTimeStepAndNextTime(dt, stepper.GetNextTime());
+        this->mLastWorkingTimeStep = dt;
+
+        try
+        {
+            // (This runs the cell ODE models)
+            PrepareForSetupLinearSystem(solution);
+        }
+        catch (Exception& e)
+        {
+            PetscTools::Destroy(solution);
+            throw e;
+        }
+
+        TakeTimeStep(solution, dt);
+        stepper.AdvanceOneTimeStep();
+    }
+
+    return solution;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned ExplicitMonodomainSolver<ELEMENT_DIM,SPACE_DIM>::GetNumStages() const
+{
+    return mMu.empty() ? 1u : mMu.size() - 1;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+double ExplicitMonodomainSolver<ELEMENT_DIM,SPACE_DIM>::GetForwardEulerStableTimeStep() const
+{
+    assert(mStiffnessMatrix != NULL);
+    return 2.0/mSpectralRadiusBound;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+ExplicitMonodomainSolver<ELEMENT_DIM,SPACE_DIM>::ExplicitMonodomainSolver(
+            AbstractTetrahedralMesh<ELEMENT_DIM,SPACE_DIM>* pMesh,
+            MonodomainTissue<ELEMENT_DIM,SPACE_DIM>* pTissue,
+            BoundaryConditionsContainer<ELEMENT_DIM,SPACE_DIM,1>* pBoundaryConditions)
+    : AbstractDynamicLinearPdeSolver<ELEMENT_DIM,SPACE_DIM,1>(pMesh),
+      mpMonodomainTissue(pTissue),
+      mpBoundaryConditions(pBoundaryConditions),
+      mStiffnessMatrix(NULL),
+      mInverseLumpedMass(NULL),
+      mSourceTerm(NULL),
+      mSurfaceTerm(NULL),
+      mStageDerivative(NULL),
+      mSpectralRadiusBound(0.0),
+      mStagesTimeStep(-1.0)
+{
+    assert(pTissue);
+    assert(pBoundaryConditions);
+
+    if (pBoundaryConditions->HasDirichletBoundaryConditions())
+    {
+        EXCEPTION("The explicit monodomain solver does not support Dirichlet boundary conditions");
+    }
+    if (HeartConfig::Instance()->GetUseStateVariableInterpolation())
+    {
+        EXCEPTION("The explicit monodomain solver does not support state variable interpolation");
+    }
+
+    for (unsigned i=0; i<3; i++)
+    {
+        mStages[i] = NULL;
+    }
+
+    mpNeumannSurfaceTermsAssembler = new NaturalNeumannSurfaceTermAssembler<ELEMENT_DIM,SPACE_DIM,1>(pMesh,pBoundaryConditions);
+
+    // Tell tissue there's no need to replicate ionic caches
+    pTissue->SetCacheReplication(false);
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+ExplicitMonodomainSolver<ELEMENT_DIM,SPACE_DIM>::~ExplicitMonodomainSolver()
+{
+    delete mpNeumannSurfaceTermsAssembler;
+
+    if (mStiffnessMatrix)
+    {
+        PetscTools::Destroy(mStiffnessMatrix);
+        PetscTools::Destroy(mInverseLumpedMass);
+        PetscTools::Destroy(mSourceTerm);
+        PetscTools::Destroy(mSurfaceTerm);
+        PetscTools::Destroy(mStageDerivative);
+        for (unsigned i=0; i<3; i++)
+        {
+            PetscTools::Destroy(mStages[i]);
+        }
+    }
+}
+
+// Explicit instantiation
+template class ExplicitMonodomainSolver<1,1>;
+template class ExplicitMonodomainSolver<1,2>;
+template class ExplicitMonodomainSolver<1,3>;
+template class ExplicitMonodomainSolver<2,2>;
+template class ExplicitMonodomainSolver<3,3>;
@@ -0,0 +1,202 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef EXPLICITMONODOMAINSOLVER_HPP_
+#define EXPLICITMONODOMAINSOLVER_HPP_
+
+#include <vector>
+
+#include "AbstractDynamicLinearPdeSolver.hpp"
+#include "NaturalNeumannSurfaceTermAssembler.hpp"
+#include "MonodomainTissue.hpp"
+
+/**
+ *  A fully explicit monodomain solver, which needs no linear solves.
+ *
+ *  With a lumped mass matrix M_L the semi-discrete monodomain equation is
+ *
+ *  chi*C M_L dV/dt = -K V + M_L F + c_surf
+ *
+ *  (see MonodomainSolver for notation), so that dV/dt only needs a matrix-vector
+ *  product with the stiffness matrix K and a diagonal scaling. The ionic and stimulus
+ *  terms F are frozen over each PDE time step, as in MonodomainSolver, and the diffusion
+ *  term is integrated with the first-order damped Runge-Kutta-Chebyshev (RKC) scheme
+ *  of Verwer et al. (J. Comput. Phys. 1990). An s-stage RKC step is stable for time steps up
+ *  to about 2*s^2 times the forward Euler limit, so s is chosen as the smallest number
+ *  of stages for which the given PDE time step is stable; s=1 is forward Euler.
+ *
+ *  The stable step is estimated once, on set up, from a Gershgorin bound on the spectral
+ *  radius of (chi*C M_L)^{-1} K (the only global reduction). Each stage then costs one
+ *  matrix-vector product and a few local vector updates, with no global reductions at all.
+ *
+ *  The lumped mass matrix is always used, whatever HeartConfig::GetUseMassLumping() says.
+ *  Dirichlet boundary conditions, state variable interpolation and time adaptivity
+ *  are not supported.
+ */
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+class ExplicitMonodomainSolver
+  : public AbstractDynamicLinearPdeSolver<ELEMENT_DIM,SPACE_DIM,1>
+{
+private:
+
+    /** Monodomain tissue class (collection of cells, and conductivities) */
+    MonodomainTissue<ELEMENT_DIM,SPACE_DIM>* mpMonodomainTissue;
+
+    /** Boundary conditions */
+    BoundaryConditionsContainer<ELEMENT_DIM,SPACE_DIM,1>* mpBoundaryConditions;
+
+    /** Assembler for surface integrals coming from any non-zero Neumann boundary conditions */
+    NaturalNeumannSurfaceTermAssembler<ELEMENT_DIM,SPACE_DIM,1>* mpNeumannSurfaceTermsAssembler;
+
+    /** The stiffness matrix K */
+    Mat mStiffnessMatrix;
+
+    /** The diagonal of (chi*C M_L)^{-1} */
+    Vec mInverseLumpedMass;
+
+    /** The part of dV/dt which is constant over a time step, (chi*C)^{-1} (F + M_L^{-1} c_surf) */
+    Vec mSourceTerm;
+
+    /** Work vector for the surface terms c_surf */
+    Vec mSurfaceTerm;
+
+    /** Work vector for dV/dt at a stage */
+    Vec mStageDerivative;
+
+    /** Work vectors for the stages of the RKC scheme */
+    Vec mStages[3];
+
+    /** Upper bound on the spectral radius of (chi*C M_L)^{-1} K */
+    double mSpectralRadiusBound;
+
+    /** The time step for which the stage coefficients were last computed */
+    double mStagesTimeStep;
+
+    /** The RKC coefficients mu_j, j=1..s (entry 0 unused) */
+    std::vector<double> mMu;
+
+    /** The RKC coefficients nu_j, j=1..s (entry 0 unused) */
+    std::vector<double> mNu;
+
+    /** The RKC coefficients mu_tilde_j, j=1..s (entry 0 unused) */
+    std::vector<double> mMuTilde;
+
+    /**
+     *  Not used: this solver has no linear system.
+     *
+     *  @param currentSolution  Solution at current time
+     *  @param computeMatrix  Whether to compute the matrix of the linear system
+     */
+    void SetupLinearSystem(Vec currentSolution, bool computeMatrix);
+
+    /**
+     *  Choose the number of RKC stages needed for the given time step to be stable, and
+     *  compute the corresponding coefficients.
+     *
+     *  @param dt  the time step
+     */
+    void ComputeStageCoefficients(double dt);
+
+    /**
+     *  Compute dV/dt = mSourceTerm - mInverseLumpedMass .* (K V) into mStageDerivative.
+     *
+     *  @param voltage  the voltage V
+     */
+    void ComputeDerivative(Vec voltage);
+
+    /**
+     *  Advance the voltage by one RKC step, once the cells have been solved.
+     *
+     *  @param voltage  the voltage, overwritten with that at the end of the step
+     *  @param dt  the time step
+     */
+    void TakeTimeStep(Vec voltage, double dt);
+
+public:
+    /**
+     *  Overloaded PrepareForSetupLinearSystem() method which
+     *  gets the cell models to solve themselves
+     *
+     *  @param currentSolution solution at current time
+     */
+    void PrepareForSetupLinearSystem(Vec currentSolution);
+
+    /**
+     *  Overloaded InitialiseForSolve(): assembles the stiffness and lumped mass
+     *  matrices and estimates the stable time step.
+     *
+     *  @param initialSolution initial solution
+     */
+    virtual void InitialiseForSolve(Vec initialSolution);
+
+    /**
+     *  Time-stepping loop, replacing that of AbstractDynamicLinearPdeSolver (which
+     *  solves a linear system at every step).
+     *
+     *  @return the solution at the end time
+     */
+    virtual Vec Solve();
+
+    /**
+     *  @return the number of RKC stages used for the last time step
+     *  (1 if the step is within the forward Euler stability limit)
+     */
+    unsigned GetNumStages() const;
+
+    /**
+     *  @return the largest time step for which forward Euler would be stable
+     *  (only available once the solver has been initialised)
+     */
+    double GetForwardEulerStableTimeStep() const;
+
+    /**
+     * Constructor
+     *
+     * @param pMesh pointer to the mesh
+     * @param pTissue pointer to the tissue
+     * @param pBoundaryConditions pointer to the boundary conditions
+     */
+    ExplicitMonodomainSolver(AbstractTetrahedralMesh<ELEMENT_DIM,SPACE_DIM>* pMesh,
+                             MonodomainTissue<ELEMENT_DIM,SPACE_DIM>* pTissue,
+                             BoundaryConditionsContainer<ELEMENT_DIM,SPACE_DIM,1>* pBoundaryConditions);
+
+    /**
+     *  Destructor
+     */
+    virtual ~ExplicitMonodomainSolver();
+};
+
+#endif /*EXPLICITMONODOMAINSOLVER_HPP_*/
@@ -0,0 +1,87 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef MONODOMAINACTIVEMASSMATRIXASSEMBLER_HPP_
+#define MONODOMAINACTIVEMASSMATRIXASSEMBLER_HPP_
+
+#include "MassMatrixAssembler.hpp"
+#include "AbstractCardiacTissue.hpp"
+
+/**
+ * A MassMatrixAssembler which only integrates over the active tissue (see
+ * AbstractCardiacTissue::SetInactiveRegions()), so that the right-hand side
+ * of the monodomain system matches the LHS matrix assembled by
+ * MonodomainAssembler when some regions are switched off.
+ */
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+class MonodomainActiveMassMatrixAssembler : public MassMatrixAssembler<ELEMENT_DIM, SPACE_DIM>
+{
+private:
+
+    /** The tissue which decides which elements are active. */
+    AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>* mpTissue;
+
+protected:
+
+    /**
+     * @return true if the element is part of the active tissue
+     *
+     * @param rElement the element
+     */
+    bool ElementAssemblyCriterion(Element<ELEMENT_DIM,SPACE_DIM>& rElement)
+    {
+        return mpTissue->IsElementActive(rElement);
+    }
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param pMesh the mesh
+     * @param pTissue the tissue
+     * @param useMassLumping whether to use mass matrix lumping or not
+     */
+    MonodomainActiveMassMatrixAssembler(AbstractTetrahedralMesh<ELEMENT_DIM,SPACE_DIM>* pMesh,
+                                        AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>* pTissue,
+                                        bool useMassLumping=false)
+        : MassMatrixAssembler<ELEMENT_DIM,SPACE_DIM>(pMesh, useMassLumping),
+          mpTissue(pTissue)
+    {
+        assert(pTissue);
+    }
+};
+
+#endif /*MONODOMAINACTIVEMASSMATRIXASSEMBLER_HPP_*/
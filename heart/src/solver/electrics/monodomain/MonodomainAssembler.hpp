@@ -73,6 +73,15 @@ protected:
      *  ComputeMatrixTerm() method. */
     MonodomainStiffnessMatrixAssembler<ELEMENT_DIM, SPACE_DIM> mStiffnessMatrixAssembler;
 
+    /**
+     * @return true if the element is part of the active tissue (see
+     * AbstractCardiacTissue::SetInactiveRegions()), so that switched off
+     * regions are left out of the matrix.
+     *
+     * @param rElement the element
+     */
+    bool ElementAssemblyCriterion(Element<ELEMENT_DIM,SPACE_DIM>& rElement);
+
 public:
 
     /**
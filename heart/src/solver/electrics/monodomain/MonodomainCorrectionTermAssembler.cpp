@@ -52,16 +52,14 @@ c_vector<double,1*(ELEM_DIM+1)> MonodomainCorrectionTermAssembler<ELEM_DIM,SPACE
     ChastePoint<SPACE_DIM> &rX /* not used */,
     c_vector<double,1> &rU,
     c_matrix<double, 1, SPACE_DIM> &rGradU /* not used */,
-    Element<ELEM_DIM,SPACE_DIM>* pElement)
+    Element<ELEM_DIM,SPACE_DIM>* pElement /* not used */)
 {
     double Am = this->mpConfig->GetSurfaceAreaToVolumeRatio();
 
     // compute the ionic current at this quadrature point using the
     // interpolated state variables, and a random choice of cell (all
     // should be the same)
-    unsigned node_global_index = pElement->GetNodeGlobalIndex(0);
-    AbstractCardiacCellInterface* p_any_cell = this->mpCardiacTissue->GetCardiacCellOrHaloCell(node_global_index);
-    double ionic_sv_interp = p_any_cell->GetIIonic(&(this->mStateVariablesAtQuadPoint));
+    double ionic_sv_interp = this->mpElementCell->GetIIonic(&(this->mStateVariablesAtQuadPoint));
 
     // add on the SVI ionic current, and take away the original ICI (linearly
     // interpolated ionic current) that would have been added as part of
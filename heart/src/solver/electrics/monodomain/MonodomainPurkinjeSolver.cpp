@@ -54,10 +54,13 @@ void MonodomainPurkinjeSolver<ELEMENT_DIM,SPACE_DIM>::SetupLinearSystem(Vec curr
         mpVolumeAssembler->SetMatrixToAssemble(this->mpLinearSystem->rGetLhsMatrix(),false);
         mpVolumeAssembler->AssembleMatrix();
 
-        mpCableAssembler->SetMatrixToAssemble(this->mpLinearSystem->rGetLhsMatrix(),false);
-        // False here is to say to the cable assembler don't zero the matrix before assembling,
-        // just add the terms to the previous value of the matrix.
-        mpCableAssembler->AssembleMatrix();
+        if (!mpTreeSolver)
+        {
+            mpCableAssembler->SetMatrixToAssemble(this->mpLinearSystem->rGetLhsMatrix(),false);
+            // False here is to say to the cable assembler don't zero the matrix before assembling,
+            // just add the terms to the previous value of the matrix.
+            mpCableAssembler->AssembleMatrix();
+        }
 
         SetIdentityBlockToLhsMatrix();
         this->mpLinearSystem->FinaliseLhsMatrix();
@@ -67,9 +70,19 @@ void MonodomainPurkinjeSolver<ELEMENT_DIM,SPACE_DIM>::SetupLinearSystem(Vec curr
         volume_mass_matrix_assembler.SetMatrixToAssemble(mMassMatrix);
         volume_mass_matrix_assembler.Assemble();
 
-        MonodomainPurkinjeCableMassMatrixAssembler<ELEMENT_DIM,SPACE_DIM> cable_mass_matrix_assembler(mpMixedMesh, HeartConfig::Instance()->GetUseMassLumping());
-        cable_mass_matrix_assembler.SetMatrixToAssemble(mMassMatrix,false /* don't zero the matrix*/);
-        cable_mass_matrix_assembler.Assemble();
+        if (mpTreeSolver)
+        {
+            mpTreeSolver->Factorise(HeartConfig::Instance()->GetPurkinjeCapacitance()
+                                        * HeartConfig::Instance()->GetPurkinjeSurfaceAreaToVolumeRatio()
+                                        * PdeSimulationTime::GetPdeTimeStepInverse(),
+                                    HeartConfig::Instance()->GetPurkinjeConductivity());
+        }
+        else
+        {
+            MonodomainPurkinjeCableMassMatrixAssembler<ELEMENT_DIM,SPACE_DIM> cable_mass_matrix_assembler(mpMixedMesh, HeartConfig::Instance()->GetUseMassLumping());
+            cable_mass_matrix_assembler.SetMatrixToAssemble(mMassMatrix,false /* don't zero the matrix*/);
+            cable_mass_matrix_assembler.Assemble();
+        }
 
         PetscMatTools::Finalise(mMassMatrix);
     }
@@ -133,6 +146,54 @@ void MonodomainPurkinjeSolver<ELEMENT_DIM,SPACE_DIM>::SetupLinearSystem(Vec curr
 
    // finalise
    this->mpLinearSystem->FinaliseRhsVector();
+
+   if (mpTreeSolver)
+   {
+       SolvePurkinjeTree(mVecForConstructingRhs);
+   }
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void MonodomainPurkinjeSolver<ELEMENT_DIM,SPACE_DIM>::SolvePurkinjeTree(Vec vecForConstructingRhs)
+{
+    DistributedVectorFactory* p_factory = this->mpMesh->GetDistributedVectorFactory();
+    const std::vector<unsigned>& r_cable_nodes = mpTreeSolver->rGetCableNodeIndices();
+
+    // Share z at the Purkinje nodes, which are few
+    DistributedVector dist_vec_matrix_based = p_factory->CreateDistributedVector(vecForConstructingRhs);
+    DistributedVector::Stripe dist_vec_matrix_based_cable(dist_vec_matrix_based, 1);
+    std::vector<double> local_z(r_cable_nodes.size(), 0.0);
+    for (unsigned k=0; k<r_cable_nodes.size(); k++)
+    {
+        if (dist_vec_matrix_based.IsGlobalIndexLocal(r_cable_nodes[k]))
+        {
+            local_z[k] = dist_vec_matrix_based_cable[r_cable_nodes[k]];
+        }
+    }
+    std::vector<double> z(r_cable_nodes.size());
+    MPI_Allreduce(local_z.empty() ? nullptr : &local_z[0], z.empty() ? nullptr : &z[0], z.size(),
+                  MPI_DOUBLE, MPI_SUM, PetscTools::GetWorld());
+
+    std::vector<double> purkinje_voltage;
+    mpTreeSolver->Solve(z, purkinje_voltage);
+
+    // The Purkinje rows of the LHS matrix are the identity
+    DistributedVector distributed_rhs = p_factory->CreateDistributedVector(this->mpLinearSystem->rGetRhsVector());
+    DistributedVector::Stripe distributed_rhs_cable(distributed_rhs, 1);
+    for (DistributedVector::Iterator index = distributed_rhs.Begin();
+         index != distributed_rhs.End();
+         ++index)
+    {
+        distributed_rhs_cable[index] = 0.0;
+    }
+    for (unsigned k=0; k<r_cable_nodes.size(); k++)
+    {
+        if (distributed_rhs.IsGlobalIndexLocal(r_cable_nodes[k]))
+        {
+            distributed_rhs_cable[r_cable_nodes[k]] = purkinje_voltage[k];
+        }
+    }
+    distributed_rhs.Restore();
 }
 
 
@@ -185,7 +246,10 @@ void MonodomainPurkinjeSolver<ELEMENT_DIM,SPACE_DIM>::InitialiseForSolve(Vec ini
     this->mpLinearSystem->SetKspType(HeartConfig::Instance()->GetKSPSolver());
     this->mpLinearSystem->SetPcType(HeartConfig::Instance()->GetKSPPreconditioner());
     this->mpLinearSystem->SetMatrixIsSymmetric(true);
-    this->mpLinearSystem->SetUseFixedNumberIterations(HeartConfig::Instance()->GetUseFixedNumberIterationsLinearSolver(), HeartConfig::Instance()->GetEvaluateNumItsEveryNSolves());
+    this->mpLinearSystem->SetUseFixedNumberIterations(HeartConfig::Instance()->GetUseFixedNumberIterationsLinearSolver(), HeartConfig::Instance()->GetEvaluateNumItsEveryNSolves(),
+                                                      HeartConfig::Instance()->GetFixedNumberIterationsLinearSolver());
+    this->SetInitialGuessType(HeartConfig::Instance()->GetLinearSolverInitialGuessType(),
+                              HeartConfig::Instance()->GetLinearSolverInitialGuessNumPreviousSolutions());
 
     // Initialise sizes/partitioning of mass matrix & vector, using the initial condition as a template
     VecDuplicate(initialSolution, &mVecForConstructingRhs);
@@ -210,11 +274,13 @@ template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 MonodomainPurkinjeSolver<ELEMENT_DIM,SPACE_DIM>::MonodomainPurkinjeSolver(
             MixedDimensionMesh<ELEMENT_DIM,SPACE_DIM>* pMesh,
             MonodomainTissue<ELEMENT_DIM,SPACE_DIM>* pTissue,
-            BoundaryConditionsContainer<ELEMENT_DIM,SPACE_DIM,2>* pBoundaryConditions)
+            BoundaryConditionsContainer<ELEMENT_DIM,SPACE_DIM,2>* pBoundaryConditions,
+            bool useTreeSolver)
     : AbstractDynamicLinearPdeSolver<ELEMENT_DIM,SPACE_DIM,2>(pMesh),
       mpMixedMesh(pMesh),
       mpMonodomainTissue(pTissue),
-      mpBoundaryConditions(pBoundaryConditions)
+      mpBoundaryConditions(pBoundaryConditions),
+      mpTreeSolver(NULL)
 {
     assert(pTissue);
     assert(pBoundaryConditions);
@@ -222,8 +288,17 @@ MonodomainPurkinjeSolver<ELEMENT_DIM,SPACE_DIM>::MonodomainPurkinjeSolver(
     {
         EXCEPTION("State-variable interpolation is not yet supported with Purkinje");
     }
+    if (useTreeSolver && HeartConfig::Instance()->GetUseMassLumping())
+    {
+        EXCEPTION("Mass lumping is not yet supported with the Purkinje tree solver");
+    }
     this->mMatrixIsConstant = true;
 
+    // Created first, as it throws if the cable elements do not form a tree
+    if (useTreeSolver)
+    {
+        mpTreeSolver = new PurkinjeTreeSolver<ELEMENT_DIM,SPACE_DIM>(pMesh);
+    }
     mpVolumeAssembler = new MonodomainPurkinjeVolumeAssembler<ELEMENT_DIM,SPACE_DIM>(mpMixedMesh,this->mpMonodomainTissue);
     mpCableAssembler = new MonodomainPurkinjeCableAssembler<ELEMENT_DIM,SPACE_DIM>(mpMixedMesh);
     mpNeumannSurfaceTermsAssembler = new NaturalNeumannSurfaceTermAssembler<ELEMENT_DIM,SPACE_DIM,2>(pMesh,pBoundaryConditions);
@@ -240,6 +315,7 @@ MonodomainPurkinjeSolver<ELEMENT_DIM,SPACE_DIM>::~MonodomainPurkinjeSolver()
     delete mpVolumeAssembler;
     delete mpCableAssembler;
     delete mpNeumannSurfaceTermsAssembler;
+    delete mpTreeSolver;
 
     if (mVecForConstructingRhs)
     {
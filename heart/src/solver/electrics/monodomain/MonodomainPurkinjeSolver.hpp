@@ -43,6 +43,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "MonodomainTissue.hpp"
 #include "MonodomainPurkinjeVolumeAssembler.hpp"
 #include "MonodomainPurkinjeCableAssembler.hpp"
+#include "PurkinjeTreeSolver.hpp"
 
 
 /**
@@ -83,6 +84,12 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  *  This class implements the above, and is based on (but doesn't inherit from, as the PROBLEM_DIMENSION
  *  is different) MonodomainSolver.
  *
+ *  Optionally, when the cable elements form a tree, the Purkinje block can instead be solved
+ *  directly by a PurkinjeTreeSolver in O(num_purkinje_nodes) operations.  The whole A2 block is then
+ *  the identity, with the Purkinje voltages from the tree solve placed in b2, so the iterative
+ *  solver only has to work on the myocardium.  Boundary conditions on the Purkinje voltage are
+ *  not applied in this mode.
+ *
  *
  */
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
@@ -116,6 +123,9 @@ private:
     /** Assembler for surface integrals coming from any non-zero Neumann boundary conditions */
     NaturalNeumannSurfaceTermAssembler<ELEMENT_DIM,SPACE_DIM,2>* mpNeumannSurfaceTermsAssembler;
 
+    /** Direct solver for the Purkinje block, or NULL if it is solved with the myocardium */
+    PurkinjeTreeSolver<ELEMENT_DIM,SPACE_DIM>* mpTreeSolver;
+
     // SVI and Purkinje not yet implemented:
     // MonodomainCorrectionTermAssembler<ELEMENT_DIM,SPACE_DIM>* mpMonodomainCorrectionTermAssembler;
 
@@ -145,6 +155,14 @@ private:
      */
     void SetIdentityBlockToLhsMatrix();
 
+    /**
+     *  Solve the Purkinje block with the tree solver and put the result in the Purkinje
+     *  stripe of the (finalised) RHS vector, zeroing it at non-Purkinje nodes.
+     *
+     *  @param vecForConstructingRhs  the vector z, whose Purkinje stripe gives b2 = Mp z
+     */
+    void SolvePurkinjeTree(Vec vecForConstructingRhs);
+
 public:
     /**
      *  Overloaded PrepareForSetupLinearSystem() methods which
@@ -167,10 +185,12 @@ public:
      * @param pMesh pointer to the mesh
      * @param pTissue pointer to the tissue
      * @param pBoundaryConditions pointer to the boundary conditions
+     * @param useTreeSolver whether to solve the Purkinje block with a PurkinjeTreeSolver (defaults to false)
      */
     MonodomainPurkinjeSolver(MixedDimensionMesh<ELEMENT_DIM,SPACE_DIM>* pMesh,
                              MonodomainTissue<ELEMENT_DIM,SPACE_DIM>* pTissue,
-                             BoundaryConditionsContainer<ELEMENT_DIM,SPACE_DIM,2>* pBoundaryConditions);
+                             BoundaryConditionsContainer<ELEMENT_DIM,SPACE_DIM,2>* pBoundaryConditions,
+                             bool useTreeSolver=false);
 
     /**
      *  Destructor
@@ -86,7 +86,7 @@ public:
                 c_matrix<double,2,SPACE_DIM> &rGradU /* not used */,
                 Element<ELEMENT_DIM,SPACE_DIM>* pElement)
     {
-        c_matrix<double, ELEMENT_DIM+1, ELEMENT_DIM+1> mass_matrix = outer_prod(rPhi, rPhi);
+        c_matrix<double, ELEMENT_DIM+1, ELEMENT_DIM+1> mass_matrix = OuterProduct(rPhi, rPhi);
 
         if (mUseMassLumping)
         {
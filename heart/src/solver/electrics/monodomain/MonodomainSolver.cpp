@@ -35,7 +35,9 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "MonodomainSolver.hpp"
 #include "MassMatrixAssembler.hpp"
+#include "MonodomainActiveMassMatrixAssembler.hpp"
 #include "PetscMatTools.hpp"
+#include "Warnings.hpp"
 
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
@@ -44,18 +46,36 @@ void MonodomainSolver<ELEMENT_DIM,SPACE_DIM>::SetupLinearSystem(Vec currentSolut
     assert(this->mpLinearSystem->rGetLhsMatrix() != NULL);
     assert(this->mpLinearSystem->rGetRhsVector() != NULL);
 
+    // Nodes in switched off tissue regions are condensed out of the system: the
+    // assemblers skip the inactive elements, leaving their rows empty, and an
+    // identity row holds each of them at its current voltage
+    const std::vector<unsigned>& r_inactive_nodes = mpMonodomainTissue->rGetInactiveOwnedNodes();
 
     /////////////////////////////////////////
     // set up LHS matrix (and mass matrix)
     /////////////////////////////////////////
-    if (computeMatrix)
+    // Matrix-free operators apply the element matrices on the fly, so have nothing to assemble
+    if (computeMatrix && !mpMassMatrixAssembler)
     {
         mpMonodomainAssembler->SetMatrixToAssemble(this->mpLinearSystem->rGetLhsMatrix());
         mpMonodomainAssembler->AssembleMatrix();
+        for (unsigned i=0; i<r_inactive_nodes.size(); i++)
+        {
+            this->mpLinearSystem->AddToMatrixElement(r_inactive_nodes[i], r_inactive_nodes[i], 1.0);
+        }
 
-        MassMatrixAssembler<ELEMENT_DIM,SPACE_DIM> mass_matrix_assembler(this->mpMesh, HeartConfig::Instance()->GetUseMassLumping());
-        mass_matrix_assembler.SetMatrixToAssemble(mMassMatrix);
-        mass_matrix_assembler.Assemble();
+        if (mpMonodomainTissue->HasInactiveRegions())
+        {
+            MonodomainActiveMassMatrixAssembler<ELEMENT_DIM,SPACE_DIM> mass_matrix_assembler(this->mpMesh, mpMonodomainTissue, HeartConfig::Instance()->GetUseMassLumping());
+            mass_matrix_assembler.SetMatrixToAssemble(mMassMatrix);
+            mass_matrix_assembler.Assemble();
+        }
+        else
+        {
+            MassMatrixAssembler<ELEMENT_DIM,SPACE_DIM> mass_matrix_assembler(this->mpMesh, HeartConfig::Instance()->GetUseMassLumping());
+            mass_matrix_assembler.SetMatrixToAssemble(mMassMatrix);
+            mass_matrix_assembler.Assemble();
+        }
 
         this->mpLinearSystem->FinaliseLhsMatrix();
         PetscMatTools::Finalise(mMassMatrix);
@@ -70,6 +90,10 @@ void MonodomainSolver<ELEMENT_DIM,SPACE_DIM>::SetupLinearSystem(Vec currentSolut
             HeartConfig::Instance()->SetUseMassLumping(true);
             lumped_mass_assembler.AssembleMatrix();
             HeartConfig::Instance()->SetUseMassLumping(false);
+            for (unsigned i=0; i<r_inactive_nodes.size(); i++)
+            {
+                PetscMatTools::AddToElement(this->mpLinearSystem->rGetPrecondMatrix(), r_inactive_nodes[i], r_inactive_nodes[i], 1.0);
+            }
 
             this->mpLinearSystem->FinalisePrecondMatrix();
         }
@@ -89,18 +113,32 @@ void MonodomainSolver<ELEMENT_DIM,SPACE_DIM>::SetupLinearSystem(Vec currentSolut
     double Am = HeartConfig::Instance()->GetSurfaceAreaToVolumeRatio();
     double Cm = HeartConfig::Instance()->GetCapacitance();
 
-    for (DistributedVector::Iterator index = dist_vec_matrix_based.Begin();
-         index!= dist_vec_matrix_based.End();
-         ++index)
+    // Loop over the local arrays directly rather than through the DistributedVector indices
+    ReplicatableVector& r_iionic_cache = this->mpMonodomainTissue->rGetIionicCacheReplicated();
+    ReplicatableVector& r_stimulus_cache = this->mpMonodomainTissue->rGetIntracellularStimulusCacheReplicated();
+    const double* p_current_solution = distributed_current_solution.GetLocalArray();
+    const unsigned solution_stride = distributed_current_solution.GetNumberOfStripes();
+    double* p_vec_matrix_based = dist_vec_matrix_based.GetLocalArray();
+    const double mass_factor = Am*Cm*PdeSimulationTime::GetPdeTimeStepInverse();
+    const unsigned lo = dist_vec_matrix_based.GetLow();
+    const unsigned num_local = dist_vec_matrix_based.GetHigh() - lo;
+
+    for (unsigned local_index=0; local_index<num_local; local_index++)
     {
-        double V = distributed_current_solution[index];
-        double F = - Am*this->mpMonodomainTissue->rGetIionicCacheReplicated()[index.Global]
-                   - this->mpMonodomainTissue->rGetIntracellularStimulusCacheReplicated()[index.Global];
+        double V = p_current_solution[local_index*solution_stride];
+        double F = - Am*r_iionic_cache[lo + local_index]
+                   - r_stimulus_cache[lo + local_index];
 
-        dist_vec_matrix_based[index] = Am*Cm*V*PdeSimulationTime::GetPdeTimeStepInverse() + F;
+        p_vec_matrix_based[local_index] = mass_factor*V + F;
     }
     dist_vec_matrix_based.Restore();
 
+    std::vector<double> inactive_voltages(r_inactive_nodes.size());
+    for (unsigned i=0; i<r_inactive_nodes.size(); i++)
+    {
+        inactive_voltages[i] = p_current_solution[(r_inactive_nodes[i] - lo)*solution_stride];
+    }
+
     //////////////////////////////////////////
     // b = Mz
     //////////////////////////////////////////
@@ -128,6 +166,12 @@ void MonodomainSolver<ELEMENT_DIM,SPACE_DIM>::SetupLinearSystem(Vec currentSolut
 
     // finalise
     this->mpLinearSystem->FinaliseRhsVector();
+
+    if (!r_inactive_nodes.empty())
+    {
+        this->mpLinearSystem->SetRhsVectorElements(r_inactive_nodes, inactive_voltages);
+        this->mpLinearSystem->FinaliseRhsVector();
+    }
 }
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
@@ -138,8 +182,23 @@ void MonodomainSolver<ELEMENT_DIM,SPACE_DIM>::InitialiseForSolve(Vec initialSolu
         return;
     }
 
-    // call base class version...
-    AbstractLinearPdeSolver<ELEMENT_DIM,SPACE_DIM,1>::InitialiseForSolve(initialSolution);
+    if (mpMassMatrixAssembler)
+    {
+        // Using matrix-free operators: wrap a shell LHS operator in the linear system, rather than letting the base
+        // class allocate a full matrix
+        Mat lhs_operator;
+        mpMonodomainAssembler->CreateMatrixFreeOperator(lhs_operator, initialSolution);
+        Vec rhs_vector;
+        VecDuplicate(initialSolution, &rhs_vector);
+        PetscInt size;
+        VecGetSize(initialSolution, &size);
+        this->mpLinearSystem = new LinearSystem(size, lhs_operator, rhs_vector);
+    }
+    else
+    {
+        // call base class version...
+        AbstractLinearPdeSolver<ELEMENT_DIM,SPACE_DIM,1>::InitialiseForSolve(initialSolution);
+    }
 
     //..then do a bit extra
     if (HeartConfig::Instance()->GetUseAbsoluteTolerance())
@@ -152,9 +211,26 @@ void MonodomainSolver<ELEMENT_DIM,SPACE_DIM>::InitialiseForSolve(Vec initialSolu
     }
 
     this->mpLinearSystem->SetKspType(HeartConfig::Instance()->GetKSPSolver());
-    this->mpLinearSystem->SetPcType(HeartConfig::Instance()->GetKSPPreconditioner());
+    if (mpMassMatrixAssembler)
+    {
+        // Only the diagonal of the operator is available without assembling it
+        std::string pc_type = HeartConfig::Instance()->GetKSPPreconditioner();
+        if (pc_type != "jacobi" && pc_type != "none")
+        {
+            WARNING("Preconditioner '" << pc_type << "' needs an assembled matrix; using 'jacobi' with matrix-free operators.");
+            pc_type = "jacobi";
+        }
+        this->mpLinearSystem->SetPcType(pc_type.c_str());
+    }
+    else
+    {
+        this->mpLinearSystem->SetPcType(HeartConfig::Instance()->GetKSPPreconditioner());
+    }
     this->mpLinearSystem->SetMatrixIsSymmetric(true);
-    this->mpLinearSystem->SetUseFixedNumberIterations(HeartConfig::Instance()->GetUseFixedNumberIterationsLinearSolver(), HeartConfig::Instance()->GetEvaluateNumItsEveryNSolves());
+    this->mpLinearSystem->SetUseFixedNumberIterations(HeartConfig::Instance()->GetUseFixedNumberIterationsLinearSolver(), HeartConfig::Instance()->GetEvaluateNumItsEveryNSolves(),
+                                                      HeartConfig::Instance()->GetFixedNumberIterationsLinearSolver());
+    this->SetInitialGuessType(HeartConfig::Instance()->GetLinearSolverInitialGuessType(),
+                              HeartConfig::Instance()->GetLinearSolverInitialGuessNumPreviousSolutions());
 
     // initialise matrix-based RHS vector and matrix, and use the linear
     // system rhs as a template
@@ -164,9 +240,16 @@ void MonodomainSolver<ELEMENT_DIM,SPACE_DIM>::InitialiseForSolve(Vec initialSolu
     PetscInt ownership_range_hi;
     VecGetOwnershipRange(r_template, &ownership_range_lo, &ownership_range_hi);
     PetscInt local_size = ownership_range_hi - ownership_range_lo;
-    PetscTools::SetupMat(mMassMatrix, this->mpMesh->GetNumNodes(), this->mpMesh->GetNumNodes(),
-                         this->mpMesh->CalculateMaximumNodeConnectivityPerProcess(),
-                         local_size, local_size);
+    if (mpMassMatrixAssembler)
+    {
+        mpMassMatrixAssembler->CreateMatrixFreeOperator(mMassMatrix, r_template);
+    }
+    else
+    {
+        PetscTools::SetupMat(mMassMatrix, this->mpMesh->GetNumNodes(), this->mpMesh->GetNumNodes(),
+                             this->mpMesh->CalculateMaximumNodeConnectivityPerProcess(),
+                             local_size, local_size);
+    }
 }
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
@@ -192,6 +275,15 @@ MonodomainSolver<ELEMENT_DIM,SPACE_DIM>::MonodomainSolver(
     mpMonodomainAssembler = new MonodomainAssembler<ELEMENT_DIM,SPACE_DIM>(this->mpMesh,this->mpMonodomainTissue);
     mpNeumannSurfaceTermsAssembler = new NaturalNeumannSurfaceTermAssembler<ELEMENT_DIM,SPACE_DIM,1>(pMesh,pBoundaryConditions);
 
+    if (HeartConfig::Instance()->GetUseMatrixFreeOperators())
+    {
+        mpMassMatrixAssembler = new MassMatrixAssembler<ELEMENT_DIM,SPACE_DIM>(this->mpMesh, HeartConfig::Instance()->GetUseMassLumping());
+    }
+    else
+    {
+        mpMassMatrixAssembler = NULL;
+    }
+
 
     // Tell tissue there's no need to replicate ionic caches
     pTissue->SetCacheReplication(false);
@@ -201,8 +293,9 @@ MonodomainSolver<ELEMENT_DIM,SPACE_DIM>::MonodomainSolver(
     {
         mpMonodomainCorrectionTermAssembler
             = new MonodomainCorrectionTermAssembler<ELEMENT_DIM,SPACE_DIM>(this->mpMesh,this->mpMonodomainTissue);
-        //We are going to need those caches after all
+        //We are going to need those caches after all, but only at the halo nodes
         pTissue->SetCacheReplication(true);
+        pTissue->SetHaloOnlyCacheReplication(true);
     }
     else
     {
@@ -222,6 +315,8 @@ MonodomainSolver<ELEMENT_DIM,SPACE_DIM>::~MonodomainSolver()
         PetscTools::Destroy(mMassMatrix);
     }
 
+    delete mpMassMatrixAssembler;
+
     if (mpMonodomainCorrectionTermAssembler)
     {
         delete mpMonodomainCorrectionTermAssembler;
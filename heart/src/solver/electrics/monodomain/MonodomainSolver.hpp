@@ -69,6 +69,10 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  *  In this case the equation is
  *  ( (chi*C/dt) M  + K ) V^{n+1} = (chi*C/dt) M V^{n} + M F^{n} + c_surf + c_correction
  *  and another assembler is used to create the c_correction.
+ *
+ *  If HeartConfig::GetUseMatrixFreeOperators() is set, neither the LHS matrix nor the mass
+ *  matrix is assembled: both are PETSc shell matrices which apply the assemblers' element
+ *  matrices on the fly, and Jacobi preconditioning is used.
  */
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 class MonodomainSolver
@@ -94,7 +98,13 @@ private:
      */
     MonodomainCorrectionTermAssembler<ELEMENT_DIM,SPACE_DIM>* mpMonodomainCorrectionTermAssembler;
 
-    /** The mass matrix, used to computing the RHS vector */
+    /**
+     * If using matrix-free operators (see HeartConfig::SetUseMatrixFreeOperators()),
+     * the assembler whose element matrices are applied on the fly as the mass matrix.
+     */
+    MassMatrixAssembler<ELEMENT_DIM,SPACE_DIM>* mpMassMatrixAssembler;
+
+    /** The mass matrix, used to computing the RHS vector (a shell matrix if using matrix-free operators) */
     Mat mMassMatrix;
 
     /** The vector multiplied by the mass matrix. Ie, if the linear system to
@@ -76,11 +76,7 @@ public:
     {
         const c_matrix<double, SPACE_DIM, SPACE_DIM>& sigma_i = this->mpCardiacTissue->rGetIntracellularConductivityTensor(pElement->GetIndex());
 
-        c_matrix<double, SPACE_DIM, ELEMENT_DIM+1> temp = prod(sigma_i, rGradPhi);
-        c_matrix<double, ELEMENT_DIM+1, ELEMENT_DIM+1> grad_phi_sigma_i_grad_phi =
-            prod(trans(rGradPhi), temp);
-
-        return grad_phi_sigma_i_grad_phi;
+        return WeightedTransposeProduct(rGradPhi, sigma_i);
     }
 
     /**
@@ -110,21 +110,60 @@ void OperatorSplittingMonodomainSolver<ELEMENT_DIM,SPACE_DIM>::PrepareForSetupLi
 {
     double time = PdeSimulationTime::GetTime();
     double dt = PdeSimulationTime::GetPdeTimeStep();
-    mpMonodomainTissue->SolveCellSystems(currentSolution, time, time+dt/2.0, true);
+
+    // If the second half step of the previous timestep was deferred, solve it together with
+    // the first half step of this one (stage (iii) followed by stage (i))
+    double ode_start_time = time;
+    if (mHalfStepPending)
+    {
+        ode_start_time = mPendingHalfStepStartTime;
+        mHalfStepPending = false;
+    }
+    mpMonodomainTissue->SolveCellSystems(currentSolution, ode_start_time, time+dt/2.0, true);
 }
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void OperatorSplittingMonodomainSolver<ELEMENT_DIM,SPACE_DIM>::FollowingSolveLinearSystem(Vec currentSolution)
 {
-    // solve cell models for second half timestep
     double time = PdeSimulationTime::GetTime();
     double dt = PdeSimulationTime::GetPdeTimeStep();
-    mpMonodomainTissue->SolveCellSystems(currentSolution, time + dt/2, PdeSimulationTime::GetNextTime(), true);
+    double next_time = PdeSimulationTime::GetNextTime();
+
+    // The TimeStepper sets the final next time to exactly the end time, so if this is not the last
+    // timestep of this call to Solve() the voltage doesn't need to be synchronised yet, and the
+    // second half step is deferred to the start of the next timestep. Intermediate output written
+    // by the base class requires a synchronised voltage, so we don't fuse the half steps then.
+    bool intermediate_output = (this->mOutputToVtk || this->mOutputToParallelVtk || this->mOutputToTxt);
+    if (mFuseHalfSteps && !intermediate_output && next_time < this->mTend)
+    {
+        mHalfStepPending = true;
+        mPendingHalfStepStartTime = time + dt/2;
+        return;
+    }
+
+    // solve cell models for second half timestep
+    mpMonodomainTissue->SolveCellSystems(currentSolution, time + dt/2, next_time, true);
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void OperatorSplittingMonodomainSolver<ELEMENT_DIM,SPACE_DIM>::SetFuseHalfSteps(bool fuseHalfSteps)
+{
+    mFuseHalfSteps = fuseHalfSteps;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool OperatorSplittingMonodomainSolver<ELEMENT_DIM,SPACE_DIM>::GetFuseHalfSteps() const
+{
+    return mFuseHalfSteps;
 }
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void OperatorSplittingMonodomainSolver<ELEMENT_DIM,SPACE_DIM>::InitialiseForSolve(Vec initialSolution)
 {
+    // Each call to Solve() starts and ends with a synchronised voltage, so there is no deferred
+    // half step to carry over (even if the previous solve was interrupted by an exception)
+    mHalfStepPending = false;
+
     if (this->mpLinearSystem != NULL)
     {
         return;
@@ -148,7 +187,10 @@ void OperatorSplittingMonodomainSolver<ELEMENT_DIM,SPACE_DIM>::InitialiseForSolv
     this->mpLinearSystem->SetKspType(HeartConfig::Instance()->GetKSPSolver());
     this->mpLinearSystem->SetPcType(HeartConfig::Instance()->GetKSPPreconditioner());
     this->mpLinearSystem->SetMatrixIsSymmetric(true);
-    this->mpLinearSystem->SetUseFixedNumberIterations(HeartConfig::Instance()->GetUseFixedNumberIterationsLinearSolver(), HeartConfig::Instance()->GetEvaluateNumItsEveryNSolves());
+    this->mpLinearSystem->SetUseFixedNumberIterations(HeartConfig::Instance()->GetUseFixedNumberIterationsLinearSolver(), HeartConfig::Instance()->GetEvaluateNumItsEveryNSolves(),
+                                                      HeartConfig::Instance()->GetFixedNumberIterationsLinearSolver());
+    this->SetInitialGuessType(HeartConfig::Instance()->GetLinearSolverInitialGuessType(),
+                              HeartConfig::Instance()->GetLinearSolverInitialGuessNumPreviousSolutions());
 
     // initialise matrix-based RHS vector and matrix, and use the linear
     // system rhs as a template
@@ -170,7 +212,10 @@ OperatorSplittingMonodomainSolver<ELEMENT_DIM,SPACE_DIM>::OperatorSplittingMonod
             BoundaryConditionsContainer<ELEMENT_DIM,SPACE_DIM,1>* pBoundaryConditions)
     : AbstractDynamicLinearPdeSolver<ELEMENT_DIM,SPACE_DIM,1>(pMesh),
       mpBoundaryConditions(pBoundaryConditions),
-      mpMonodomainTissue(pTissue)
+      mpMonodomainTissue(pTissue),
+      mFuseHalfSteps(false),
+      mHalfStepPending(false),
+      mPendingHalfStepStartTime(0.0)
 {
     assert(pTissue);
     assert(pBoundaryConditions);
@@ -57,10 +57,14 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  *  (iii) Solve ODEs   dV/dt = Iionic             for t=T+dt/2 to T+dt  [using V from step ii, --> final V]
  *
  *  Notes
- *   (a)  Stages (iii) and (i) can normally be solved together in one go, except just before/after printing the voltage to file.
- *        However for simplicity of code this has not been implemented
- *   (b)  Therefore, the effective ODE timestep will be:  min(ode_dt, pde_dt/2), where ode_dt and pde_dt are those
- *        given via HeartConfig.
+ *   (a)  If SetFuseHalfSteps() has been called, stage (iii) of one timestep and stage (i) of the next are solved
+ *        together in one go, as a single ODE solve over a full PDE timestep. They are then only solved separately
+ *        at the end of each call to Solve() (ie just before printing the voltage to file), so that the voltage is
+ *        synchronised whenever it is output. By default every half step is solved separately.
+ *   (b)  Therefore, the effective ODE timestep will be:  min(ode_dt, pde_dt/2), or with fused half steps
+ *        min(ode_dt, pde_dt) except for the half steps either side of a printing time. Here ode_dt and pde_dt are
+ *        those given via HeartConfig. A time adaptivity controller may be given with SetTimeAdaptivityController()
+ *        to vary pde_dt.
  *   (c)  This solver is FOR COMPARING ACCURACY, NOT PERFORMANCE. It has not been optimised and may or may not
  *        perform well in parallel.
  *   (d)  We don't implement the simpler form of operator splitting, Godunov splitting, where the ODEs are
@@ -97,6 +101,15 @@ private:
      */
     Vec mVecForConstructingRhs;
 
+    /** Whether to solve stage (iii) of one timestep together with stage (i) of the next, see note (a) above. */
+    bool mFuseHalfSteps;
+
+    /** Whether stage (iii) of the previous timestep has been deferred to the next call to PrepareForSetupLinearSystem(). */
+    bool mHalfStepPending;
+
+    /** The time from which the deferred stage (iii) ODE solve starts, if #mHalfStepPending is true. */
+    double mPendingHalfStepStartTime;
+
     /**
      *  Implementation of SetupLinearSystem() which uses the assembler to compute the
      *  LHS matrix, but sets up the RHS vector using the mass-matrix (constructed
@@ -108,13 +121,15 @@ private:
     void SetupLinearSystem(Vec currentSolution, bool computeMatrix);
 
     /**
-     *  Called before setting up the linear system, used to solve the cell models for first half timestep (step (i) above)
+     *  Called before setting up the linear system, used to solve the cell models for first half timestep (step (i) above),
+     *  together with any deferred second half timestep (step (iii)) of the previous timestep.
      *  @param currentSolution the latest solution vector
      */
     void PrepareForSetupLinearSystem(Vec currentSolution);
 
     /**
-     *  Called after solving the linear system, used to solve the cell models for second half timestep (step (iii) above)
+     *  Called after solving the linear system, used to solve the cell models for second half timestep (step (iii) above).
+     *  Unless this is the last timestep of the solve, this is deferred and done with step (i) of the next timestep.
      *  @param currentSolution the latest solution vector (ie the solution of the linear system).
      */
     void FollowingSolveLinearSystem(Vec currentSolution);
@@ -128,6 +143,16 @@ public:
      */
     void InitialiseForSolve(Vec initialSolution);
 
+    /**
+     *  Set whether to solve the second half step of the cell models for one timestep together with the first half
+     *  step for the next timestep (see note (a) in the class documentation). Defaults to false.
+     *
+     *  @param fuseHalfSteps  whether to fuse the half steps
+     */
+    void SetFuseHalfSteps(bool fuseHalfSteps=true);
+
+    /** @return whether the half steps of the cell models are fused, see SetFuseHalfSteps() */
+    bool GetFuseHalfSteps() const;
 
     /**
      * Constructor
@@ -0,0 +1,227 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "PurkinjeTreeSolver.hpp"
+
+#include <cassert>
+#include <climits>
+#include <map>
+#include "Exception.hpp"
+#include "PetscTools.hpp"
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+PurkinjeTreeSolver<ELEMENT_DIM,SPACE_DIM>::PurkinjeTreeSolver(MixedDimensionMesh<ELEMENT_DIM,SPACE_DIM>* pMesh)
+{
+    // Each cable element is packed as (index, node, node, area*length, area/length)
+    const unsigned record_size = 5;
+    std::vector<double> local_records;
+    for (typename MixedDimensionMesh<ELEMENT_DIM,SPACE_DIM>::CableElementIterator iter = pMesh->GetCableElementIteratorBegin();
+         iter != pMesh->GetCableElementIteratorEnd();
+         ++iter)
+    {
+        Element<1u,SPACE_DIM>* p_cable = *iter;
+        double length = norm_2(p_cable->GetNode(1)->rGetLocation() - p_cable->GetNode(0)->rGetLocation());
+        double area = M_PI*p_cable->GetAttribute()*p_cable->GetAttribute();
+        local_records.push_back(p_cable->GetIndex());
+        local_records.push_back(p_cable->GetNodeGlobalIndex(0));
+        local_records.push_back(p_cable->GetNodeGlobalIndex(1));
+        local_records.push_back(area*length);
+        local_records.push_back(area/length);
+    }
+
+    // Cable elements spanning two processes are held by both
+    const unsigned num_procs = PetscTools::GetNumProcs();
+    int local_size = local_records.size();
+    std::vector<int> counts(num_procs);
+    MPI_Allgather(&local_size, 1, MPI_INT, &counts[0], 1, MPI_INT, PetscTools::GetWorld());
+    std::vector<int> offsets(num_procs, 0);
+    for (unsigned proc=1; proc<num_procs; proc++)
+    {
+        offsets[proc] = offsets[proc-1] + counts[proc-1];
+    }
+    std::vector<double> all_records(offsets[num_procs-1] + counts[num_procs-1]);
+    MPI_Allgatherv(local_records.empty() ? nullptr : &local_records[0], local_size, MPI_DOUBLE,
+                   all_records.empty() ? nullptr : &all_records[0], &counts[0], &offsets[0], MPI_DOUBLE, PetscTools::GetWorld());
+
+    std::map<unsigned, unsigned> cables; // cable index -> position of its record
+    for (unsigned record=0; record<all_records.size(); record+=record_size)
+    {
+        cables[(unsigned)all_records[record]] = record;
+    }
+
+    // Adjacency of the cable nodes: (neighbour, record) pairs
+    std::map<unsigned, std::vector<std::pair<unsigned, unsigned> > > adjacency;
+    for (std::map<unsigned, unsigned>::const_iterator it = cables.begin(); it != cables.end(); ++it)
+    {
+        unsigned node_a = (unsigned)all_records[it->second+1];
+        unsigned node_b = (unsigned)all_records[it->second+2];
+        adjacency[node_a].push_back(std::make_pair(node_b, it->second));
+        adjacency[node_b].push_back(std::make_pair(node_a, it->second));
+    }
+
+    // Breadth-first search from a root in each tree, so that parents come before their children
+    std::map<unsigned, unsigned> position;
+    std::vector<unsigned> parent_records;
+    for (std::map<unsigned, std::vector<std::pair<unsigned, unsigned> > >::const_iterator root = adjacency.begin();
+         root != adjacency.end();
+         ++root)
+    {
+        if (position.count(root->first))
+        {
+            continue;
+        }
+        position[root->first] = mCableNodeIndices.size();
+        mCableNodeIndices.push_back(root->first);
+        mParents.push_back(UINT_MAX);
+        parent_records.push_back(UINT_MAX);
+
+        for (unsigned next=position[root->first]; next<mCableNodeIndices.size(); next++)
+        {
+            const std::vector<std::pair<unsigned, unsigned> >& r_neighbours = adjacency[mCableNodeIndices[next]];
+            for (unsigned k=0; k<r_neighbours.size(); k++)
+            {
+                if (r_neighbours[k].second == parent_records[next])
+                {
+                    continue;
+                }
+                if (position.count(r_neighbours[k].first))
+                {
+                    EXCEPTION("The Purkinje cable elements must form a tree to use the Purkinje tree solver");
+                }
+                position[r_neighbours[k].first] = mCableNodeIndices.size();
+                mCableNodeIndices.push_back(r_neighbours[k].first);
+                mParents.push_back(next);
+                parent_records.push_back(r_neighbours[k].second);
+            }
+        }
+    }
+
+    const unsigned num_cable_nodes = mCableNodeIndices.size();
+    mEdgeAreaTimesLength.assign(num_cable_nodes, 0.0);
+    mEdgeAreaOverLength.assign(num_cable_nodes, 0.0);
+    mMassDiagonal.assign(num_cable_nodes, 0.0);
+    mStiffnessDiagonal.assign(num_cable_nodes, 0.0);
+    for (unsigned i=0; i<num_cable_nodes; i++)
+    {
+        if (mParents[i] != UINT_MAX)
+        {
+            mEdgeAreaTimesLength[i] = all_records[parent_records[i]+3];
+            mEdgeAreaOverLength[i] = all_records[parent_records[i]+4];
+
+            // Linear elements: mass A h/6 [2 1; 1 2], stiffness A/h [1 -1; -1 1]
+            mMassDiagonal[i] += mEdgeAreaTimesLength[i]/3.0;
+            mMassDiagonal[mParents[i]] += mEdgeAreaTimesLength[i]/3.0;
+            mStiffnessDiagonal[i] += mEdgeAreaOverLength[i];
+            mStiffnessDiagonal[mParents[i]] += mEdgeAreaOverLength[i];
+        }
+    }
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+const std::vector<unsigned>& PurkinjeTreeSolver<ELEMENT_DIM,SPACE_DIM>::rGetCableNodeIndices() const
+{
+    return mCableNodeIndices;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void PurkinjeTreeSolver<ELEMENT_DIM,SPACE_DIM>::Factorise(double massScaling, double conductivity)
+{
+    const unsigned num_cable_nodes = mCableNodeIndices.size();
+    mPivots.resize(num_cable_nodes);
+    mOffDiagonal.resize(num_cable_nodes);
+    for (unsigned i=0; i<num_cable_nodes; i++)
+    {
+        mPivots[i] = massScaling*mMassDiagonal[i] + conductivity*mStiffnessDiagonal[i];
+        mOffDiagonal[i] = massScaling*mEdgeAreaTimesLength[i]/6.0 - conductivity*mEdgeAreaOverLength[i];
+    }
+
+    // Eliminate each node from its parent's equation, leaves first
+    for (unsigned i=num_cable_nodes; i-- > 0; )
+    {
+        if (mParents[i] != UINT_MAX)
+        {
+            mPivots[mParents[i]] -= mOffDiagonal[i]*mOffDiagonal[i]/mPivots[i];
+        }
+    }
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void PurkinjeTreeSolver<ELEMENT_DIM,SPACE_DIM>::Solve(const std::vector<double>& rZ, std::vector<double>& rX) const
+{
+    const unsigned num_cable_nodes = mCableNodeIndices.size();
+    assert(rZ.size() == num_cable_nodes);
+    assert(mPivots.size() == num_cable_nodes);
+
+    // b = Mp z
+    std::vector<double> rhs(num_cable_nodes);
+    for (unsigned i=0; i<num_cable_nodes; i++)
+    {
+        rhs[i] = mMassDiagonal[i]*rZ[i];
+    }
+    for (unsigned i=0; i<num_cable_nodes; i++)
+    {
+        if (mParents[i] != UINT_MAX)
+        {
+            rhs[i] += mEdgeAreaTimesLength[i]/6.0*rZ[mParents[i]];
+            rhs[mParents[i]] += mEdgeAreaTimesLength[i]/6.0*rZ[i];
+        }
+    }
+
+    // Forward elimination, leaves first, then back substitution from the roots
+    for (unsigned i=num_cable_nodes; i-- > 0; )
+    {
+        if (mParents[i] != UINT_MAX)
+        {
+            rhs[mParents[i]] -= mOffDiagonal[i]*rhs[i]/mPivots[i];
+        }
+    }
+    rX.resize(num_cable_nodes);
+    for (unsigned i=0; i<num_cable_nodes; i++)
+    {
+        double b = rhs[i];
+        if (mParents[i] != UINT_MAX)
+        {
+            b -= mOffDiagonal[i]*rX[mParents[i]];
+        }
+        rX[i] = b/mPivots[i];
+    }
+}
+
+///////////////////////////////////////////////////////
+// explicit instantiation
+///////////////////////////////////////////////////////
+
+template class PurkinjeTreeSolver<2,2>;
+template class PurkinjeTreeSolver<3,3>;
@@ -0,0 +1,116 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef PURKINJETREESOLVER_HPP_
+#define PURKINJETREESOLVER_HPP_
+
+#include <vector>
+#include "MixedDimensionMesh.hpp"
+
+/**
+ *  Direct solver for the Purkinje block of the linear system assembled by
+ *  MonodomainPurkinjeSolver.
+ *
+ *  The Purkinje voltage equations are not coupled to the myocardium through the
+ *  matrix (junctions act through the cell models' stimulus currents), and their
+ *  matrix
+ *      Ap = (Cm chi / dt) Mp + Kp
+ *  only couples the two ends of each cable element.  When the cable elements form
+ *  a tree (or several trees) Ap can be factorised and solved exactly in O(N)
+ *  operations by eliminating from the leaves towards a root, a generalisation of
+ *  the Thomas algorithm for tridiagonal systems.
+ *
+ *  The cable network is usually small, so on construction every process gathers the
+ *  whole network and each solve is done redundantly on all processes.
+ */
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+class PurkinjeTreeSolver
+{
+private:
+    /** Global mesh index of each cable node, in elimination order (each node after its parent). */
+    std::vector<unsigned> mCableNodeIndices;
+
+    /** Position (in elimination order) of the parent of each cable node, or UINT_MAX for a root. */
+    std::vector<unsigned> mParents;
+
+    /** Cross-section area times length of the cable element joining each node to its parent. */
+    std::vector<double> mEdgeAreaTimesLength;
+
+    /** Cross-section area over length of the cable element joining each node to its parent. */
+    std::vector<double> mEdgeAreaOverLength;
+
+    /** Diagonal of the mass matrix Mp, for each cable node. */
+    std::vector<double> mMassDiagonal;
+
+    /** Diagonal of the stiffness matrix Kp, for each cable node. */
+    std::vector<double> mStiffnessDiagonal;
+
+    /** Off-diagonal entry of Ap between each node and its parent. */
+    std::vector<double> mOffDiagonal;
+
+    /** Pivots of Ap once the leaves have been eliminated, for each cable node. */
+    std::vector<double> mPivots;
+
+public:
+    /**
+     * Constructor.  Collective: gathers the cable network from every process.
+     *
+     * @param pMesh  the mesh, whose cable elements must form one or more trees and have their radii set
+     */
+    PurkinjeTreeSolver(MixedDimensionMesh<ELEMENT_DIM,SPACE_DIM>* pMesh);
+
+    /**
+     * @return the global mesh indices of the cable nodes, in the order used by Solve().
+     */
+    const std::vector<unsigned>& rGetCableNodeIndices() const;
+
+    /**
+     * Factorise Ap = (massScaling) Mp + conductivity Kp.
+     *
+     * @param massScaling  the coefficient of the mass matrix, Cm chi / dt
+     * @param conductivity  the Purkinje conductivity
+     */
+    void Factorise(double massScaling, double conductivity);
+
+    /**
+     * Solve Ap x = Mp z, with Ap as last factorised.
+     *
+     * @param rZ  the vector z, one entry per cable node in the order of rGetCableNodeIndices()
+     * @param rX  filled in with the solution, in the same order
+     */
+    void Solve(const std::vector<double>& rZ, std::vector<double>& rX) const;
+};
+
+#endif // PURKINJETREESOLVER_HPP_
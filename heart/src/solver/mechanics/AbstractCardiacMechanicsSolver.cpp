@@ -34,11 +34,15 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "AbstractCardiacMechanicsSolver.hpp"
+
+#include <algorithm>
+
 #include "AbstractContractionCellFactory.hpp"
+#include "DistributedTetrahedralMesh.hpp"
 #include "FakeBathContractionModel.hpp"
 
 template <class ELASTICITY_SOLVER,unsigned DIM>
-AbstractCardiacMechanicsSolver<ELASTICITY_SOLVER,DIM>::AbstractCardiacMechanicsSolver(QuadraticMesh<DIM>& rQuadMesh,
+AbstractCardiacMechanicsSolver<ELASTICITY_SOLVER,DIM>::AbstractCardiacMechanicsSolver(AbstractTetrahedralMesh<DIM,DIM>& rQuadMesh,
                                                                                       ElectroMechanicsProblemDefinition<DIM>& rProblemDefinition,
                                                                                       std::string outputDirectory)
    : ELASTICITY_SOLVER(rQuadMesh,
@@ -83,6 +87,14 @@ void AbstractCardiacMechanicsSolver<ELASTICITY_SOLVER,DIM>::Initialise()
                 DataAtQuadraturePoint data_at_quad_point;
                 data_at_quad_point.Stretch = 1.0;
                 data_at_quad_point.StretchLastTimeStep = 1.0;
+                data_at_quad_point.CachedStretch = DBL_MAX;
+                data_at_quad_point.CachedStretchRate = DBL_MAX;
+                data_at_quad_point.CachedActiveTension = 0.0;
+                data_at_quad_point.CachedDerivsAreSet = false;
+                data_at_quad_point.CachedDerivActiveTensionWrtLambda = 0.0;
+                data_at_quad_point.CachedDerivActiveTensionWrtDLambdaDt = 0.0;
+                data_at_quad_point.LastRunStretch = DBL_MAX;
+                data_at_quad_point.LastRunStretchRate = DBL_MAX;
 
                 if (mpMeshPair->GetFineMesh().GetElement(fine_elements[quad_pt_global_index].ElementNum)
                         ->GetUnsignedAttribute() == HeartRegionCode::GetValidBathId() )
@@ -433,10 +445,27 @@ void AbstractCardiacMechanicsSolver<ELASTICITY_SOLVER,DIM>::ComputeDeformationGr
     double jacobian_determinant;
     ChastePoint<DIM> quadrature_point; // not needed, but has to be passed in
 
-    // loop over all the elements
-    for (unsigned elem_index=0; elem_index<this->mrQuadMesh.GetNumElements(); elem_index++)
+    // With a distributed mesh each process computes F and the stretch on the elements it is
+    // the designated owner of, and the results are then shared
+    bool is_distributed = (dynamic_cast<DistributedTetrahedralMesh<DIM,DIM>*>(&(this->mrQuadMesh)) != NULL)
+                          && !PetscTools::IsSequential();
+    if (is_distributed)
     {
-        Element<DIM,DIM>* p_elem = this->mrQuadMesh.GetElement(elem_index);
+        std::fill(rStretches.begin(), rStretches.end(), 0.0);
+        std::fill(rDeformationGradients.begin(), rDeformationGradients.end(), zero_matrix<double>(DIM,DIM));
+    }
+
+    // loop over all the (owned) elements
+    for (typename AbstractTetrahedralMesh<DIM, DIM>::ElementIterator iter = this->mrQuadMesh.GetElementIteratorBegin();
+         iter != this->mrQuadMesh.GetElementIteratorEnd();
+         ++iter)
+    {
+        Element<DIM,DIM>* p_elem = &(*iter);
+        unsigned elem_index = p_elem->GetIndex();
+        if (is_distributed && !this->mrQuadMesh.CalculateDesignatedOwnershipOfElement(elem_index))
+        {
+            continue;
+        }
 
         // get the fibre direction for this element
         SetupChangeOfBasisMatrix(elem_index, 0); // 0 is quad index, and doesn't matter as checked that fibres not defined by quad pt above.
@@ -480,6 +509,36 @@ void AbstractCardiacMechanicsSolver<ELASTICITY_SOLVER,DIM>::ComputeDeformationGr
         c_vector<double,DIM> deformed_fibre = prod(F, mCurrentElementFibreDirection);
         rStretches[elem_index] = norm_2(deformed_fibre);
     }
+
+    if (is_distributed)
+    {
+        std::vector<double> local_stretches = rStretches;
+        MPI_Allreduce(&local_stretches[0], &rStretches[0], rStretches.size(), MPI_DOUBLE, MPI_SUM, PetscTools::GetWorld());
+
+        std::vector<double> local_F(rDeformationGradients.size()*DIM*DIM);
+        for (unsigned elem_index=0; elem_index<rDeformationGradients.size(); elem_index++)
+        {
+            for (unsigned i=0; i<DIM; i++)
+            {
+                for (unsigned M=0; M<DIM; M++)
+                {
+                    local_F[(elem_index*DIM + i)*DIM + M] = rDeformationGradients[elem_index](i,M);
+                }
+            }
+        }
+        std::vector<double> global_F(local_F.size());
+        MPI_Allreduce(&local_F[0], &global_F[0], local_F.size(), MPI_DOUBLE, MPI_SUM, PetscTools::GetWorld());
+        for (unsigned elem_index=0; elem_index<rDeformationGradients.size(); elem_index++)
+        {
+            for (unsigned i=0; i<DIM; i++)
+            {
+                for (unsigned M=0; M<DIM; M++)
+                {
+                    rDeformationGradients[elem_index](i,M) = global_F[(elem_index*DIM + i)*DIM + M];
+                }
+            }
+        }
+    }
 }
 
 
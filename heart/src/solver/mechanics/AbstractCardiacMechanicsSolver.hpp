@@ -36,6 +36,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef ABSTRACTCARDIACMECHANICSSOLVER_HPP_
 #define ABSTRACTCARDIACMECHANICSSOLVER_HPP_
 
+#include <cfloat>
 #include <map>
 #include "IncompressibleNonlinearElasticitySolver.hpp"
 #include "CompressibleNonlinearElasticitySolver.hpp"
@@ -50,10 +51,12 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 
 /**
- *  This struct is used to collect the three things that are stored for
+ *  This struct is used to collect the things that are stored for
  *  each physical quadrature point: a contraction model, the stretch at that
  *  point, and the stretch at the last time-step (used to compute
- *  stretch rate).
+ *  stretch rate). The implicit solver also keeps the results of the contraction
+ *  model for the last stretch and stretch rate it was asked about, so that they
+ *  need not be recomputed while these don't change during a solve.
  */
 typedef struct DataAtQuadraturePoint_
 {
@@ -62,6 +65,15 @@ typedef struct DataAtQuadraturePoint_
     double Stretch; /**< Stretch (in fibre direction) at this quadrature point */
     double StretchLastTimeStep; /**< Stretch (in fibre direction) at the previous timestep, at this quadrature point */
 
+    double CachedStretch; /**< Stretch for which the cached active tension was computed (DBL_MAX if none) */
+    double CachedStretchRate; /**< Stretch rate for which the cached active tension was computed */
+    double CachedActiveTension; /**< Active tension at the cached stretch and stretch rate */
+    bool CachedDerivsAreSet; /**< Whether the cached derivatives of the active tension have been computed */
+    double CachedDerivActiveTensionWrtLambda; /**< Cached derivative of the active tension wrt stretch */
+    double CachedDerivActiveTensionWrtDLambdaDt; /**< Cached derivative of the active tension wrt stretch rate */
+    double LastRunStretch; /**< Stretch the contraction model was last run with (DBL_MAX if not run in this solve) */
+    double LastRunStretchRate; /**< Stretch rate the contraction model was last run with */
+
 } DataAtQuadraturePoint;
 
 
@@ -215,11 +227,11 @@ public:
     /**
      * Constructor
      *
-     * @param rQuadMesh A reference to the mesh.
+     * @param rQuadMesh A reference to the (quadratic, possibly distributed) mesh.
      * @param rProblemDefinition Object defining body force and boundary conditions
      * @param outputDirectory The output directory, relative to TEST_OUTPUT
      */
-    AbstractCardiacMechanicsSolver(QuadraticMesh<DIM>& rQuadMesh,
+    AbstractCardiacMechanicsSolver(AbstractTetrahedralMesh<DIM,DIM>& rQuadMesh,
                                    ElectroMechanicsProblemDefinition<DIM>& rProblemDefinition,
                                    std::string outputDirectory);
 
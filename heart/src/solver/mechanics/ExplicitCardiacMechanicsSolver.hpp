@@ -92,11 +92,11 @@ public:
     /**
      * Constructor
      *
-     * @param rQuadMesh A reference to the mesh.
+     * @param rQuadMesh A reference to the (quadratic, possibly distributed) mesh.
      * @param rProblemDefinition Object defining body force and boundary conditions
      * @param outputDirectory The output directory, relative to TEST_OUTPUT
      */
-    ExplicitCardiacMechanicsSolver(QuadraticMesh<DIM>& rQuadMesh,
+    ExplicitCardiacMechanicsSolver(AbstractTetrahedralMesh<DIM,DIM>& rQuadMesh,
                                    ElectroMechanicsProblemDefinition<DIM>& rProblemDefinition,
                                    std::string outputDirectory);
 
@@ -37,7 +37,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 template <class ELASTICITY_SOLVER,unsigned DIM>
 ImplicitCardiacMechanicsSolver<ELASTICITY_SOLVER,DIM>::ImplicitCardiacMechanicsSolver(
-                                  QuadraticMesh<DIM>& rQuadMesh,
+                                  AbstractTetrahedralMesh<DIM,DIM>& rQuadMesh,
                                   ElectroMechanicsProblemDefinition<DIM>& rProblemDefinition,
                                   std::string outputDirectory)
     : AbstractCardiacMechanicsSolver<ELASTICITY_SOLVER,DIM>(rQuadMesh,
@@ -62,6 +62,9 @@ void ImplicitCardiacMechanicsSolver<ELASTICITY_SOLVER,DIM>::Solve(double time, d
     this->mNextTime = nextTime;
     this->mOdeTimestep = odeTimestep;
 
+    // The contraction models' inputs and times have changed, so nothing cached from the last solve is valid
+    InvalidateContractionModelResults();
+
     // solve
     ELASTICITY_SOLVER::Solve();
 
@@ -79,10 +82,39 @@ void ImplicitCardiacMechanicsSolver<ELASTICITY_SOLVER,DIM>::Solve(double time, d
          iter != this->mQuadPointToDataAtQuadPointMap.end();
          iter++)
     {
-        AbstractContractionModel* p_contraction_model = iter->second.ContractionModel;
-        iter->second.StretchLastTimeStep = iter->second.Stretch;
+        DataAtQuadraturePoint& r_data_at_quad_point = iter->second;
+        AbstractContractionModel* p_contraction_model = r_data_at_quad_point.ContractionModel;
+
+        // The results may have come from the cache, after the model was last run with other inputs
+        // (for the Jacobian), in which case it must be run again with the final ones
+        double dlam_dt = (r_data_at_quad_point.Stretch-r_data_at_quad_point.StretchLastTimeStep)/(this->mNextTime-this->mCurrentTime);
+        if (r_data_at_quad_point.LastRunStretch != r_data_at_quad_point.Stretch
+            || r_data_at_quad_point.LastRunStretchRate != dlam_dt)
+        {
+            p_contraction_model->SetStretchAndStretchRate(r_data_at_quad_point.Stretch, dlam_dt);
+            p_contraction_model->RunDoNotUpdate(this->mCurrentTime,this->mNextTime,this->mOdeTimestep);
+        }
+
+        r_data_at_quad_point.StretchLastTimeStep = r_data_at_quad_point.Stretch;
         p_contraction_model->UpdateStateVariables();
     }
+
+    InvalidateContractionModelResults();
+}
+
+template <class ELASTICITY_SOLVER,unsigned DIM>
+void ImplicitCardiacMechanicsSolver<ELASTICITY_SOLVER,DIM>::InvalidateContractionModelResults()
+{
+    for (std::map<unsigned,DataAtQuadraturePoint>::iterator iter = this->mQuadPointToDataAtQuadPointMap.begin();
+         iter != this->mQuadPointToDataAtQuadPointMap.end();
+         iter++)
+    {
+        iter->second.CachedStretch = DBL_MAX;
+        iter->second.CachedStretchRate = DBL_MAX;
+        iter->second.CachedDerivsAreSet = false;
+        iter->second.LastRunStretch = DBL_MAX;
+        iter->second.LastRunStretchRate = DBL_MAX;
+    }
 }
 
 template <class ELASTICITY_SOLVER,unsigned DIM>
@@ -105,52 +137,75 @@ void ImplicitCardiacMechanicsSolver<ELASTICITY_SOLVER,DIM>::GetActiveTensionAndT
     // compute dlam/dt
     double dlam_dt = (currentFibreStretch-r_data_at_quad_point.StretchLastTimeStep)/(this->mNextTime-this->mCurrentTime);
 
-    // Set this stretch and stretch rate on contraction model
     AbstractContractionModel* p_contraction_model = r_data_at_quad_point.ContractionModel;
-    p_contraction_model->SetStretchAndStretchRate(currentFibreStretch, dlam_dt);
 
-    // Call RunDoNotUpdate() on the contraction model to solve it using this stretch, and get the active tension
-    try
+    // Only solve the contraction model if it hasn't already been solved with this stretch and
+    // stretch rate during this solve (for example, in the final residual assembly of Solve())
+    if (r_data_at_quad_point.CachedStretch != currentFibreStretch
+        || r_data_at_quad_point.CachedStretchRate != dlam_dt)
     {
-        p_contraction_model->RunDoNotUpdate(this->mCurrentTime,this->mNextTime,this->mOdeTimestep);
-        rActiveTension = p_contraction_model->GetNextActiveTension();
-    }
-    // LCOV_EXCL_START
-    catch (Exception&)
-    {
-        // if this failed during assembling the Jacobian this is a fatal error.
-        if (assembleJacobian)
+        // Set this stretch and stretch rate on contraction model
+        p_contraction_model->SetStretchAndStretchRate(currentFibreStretch, dlam_dt);
+
+        // Call RunDoNotUpdate() on the contraction model to solve it using this stretch, and get the active tension
+        try
         {
-            // probably shouldn't be able to get here
-            EXCEPTION("Failure in solving contraction models using current stretches for assembling Jacobian");
+            p_contraction_model->RunDoNotUpdate(this->mCurrentTime,this->mNextTime,this->mOdeTimestep);
+            r_data_at_quad_point.LastRunStretch = currentFibreStretch;
+            r_data_at_quad_point.LastRunStretchRate = dlam_dt;
+            r_data_at_quad_point.CachedActiveTension = p_contraction_model->GetNextActiveTension();
         }
-        // if this failed during assembling the residual, the stretches are too large, so we just
-        // set the active tension to infinity so that the residual will be infinite
-        rActiveTension = DBL_MAX;
-        std::cout << "WARNING: could not solve contraction model with this stretch and stretch rate. "
-                  << "Setting active tension to infinity (DBL_MAX) so that the residual(-norm) is also infinite\n" << std::flush;
-        NEVER_REACHED;
-        return;
+        // LCOV_EXCL_START
+        catch (Exception&)
+        {
+            // if this failed during assembling the Jacobian this is a fatal error.
+            if (assembleJacobian)
+            {
+                // probably shouldn't be able to get here
+                EXCEPTION("Failure in solving contraction models using current stretches for assembling Jacobian");
+            }
+            // if this failed during assembling the residual, the stretches are too large, so we just
+            // set the active tension to infinity so that the residual will be infinite
+            rActiveTension = DBL_MAX;
+            std::cout << "WARNING: could not solve contraction model with this stretch and stretch rate. "
+                      << "Setting active tension to infinity (DBL_MAX) so that the residual(-norm) is also infinite\n" << std::flush;
+            NEVER_REACHED;
+            return;
+        }
+        // LCOV_EXCL_STOP
+
+        r_data_at_quad_point.CachedStretch = currentFibreStretch;
+        r_data_at_quad_point.CachedStretchRate = dlam_dt;
+        r_data_at_quad_point.CachedDerivsAreSet = false;
     }
-    // LCOV_EXCL_STOP
+    rActiveTension = r_data_at_quad_point.CachedActiveTension;
 
     // if assembling the Jacobian, numerically evaluate dTa/dlam & dTa/d(lamdot)
     if (assembleJacobian)
     {
-        // get active tension for (lam+h,dlamdt)
-        double h1 = std::max(1e-6, currentFibreStretch/100);
-        p_contraction_model->SetStretchAndStretchRate(currentFibreStretch+h1, dlam_dt);
-        p_contraction_model->RunDoNotUpdate(this->mCurrentTime,this->mNextTime,this->mOdeTimestep);
-        double active_tension_at_lam_plus_h = p_contraction_model->GetNextActiveTension();
-
-        // get active tension for (lam,dlamdt+h)
-        double h2 = std::max(1e-6, dlam_dt/100);
-        p_contraction_model->SetStretchAndStretchRate(currentFibreStretch, dlam_dt+h2);
-        p_contraction_model->RunDoNotUpdate(this->mCurrentTime,this->mNextTime,this->mOdeTimestep);
-        double active_tension_at_dlamdt_plus_h = p_contraction_model->GetNextActiveTension();
-
-        rDerivActiveTensionWrtLambda = (active_tension_at_lam_plus_h - rActiveTension)/h1;
-        rDerivActiveTensionWrtDLambdaDt = (active_tension_at_dlamdt_plus_h - rActiveTension)/h2;
+        if (!r_data_at_quad_point.CachedDerivsAreSet)
+        {
+            // get active tension for (lam+h,dlamdt)
+            double h1 = std::max(1e-6, currentFibreStretch/100);
+            p_contraction_model->SetStretchAndStretchRate(currentFibreStretch+h1, dlam_dt);
+            p_contraction_model->RunDoNotUpdate(this->mCurrentTime,this->mNextTime,this->mOdeTimestep);
+            double active_tension_at_lam_plus_h = p_contraction_model->GetNextActiveTension();
+
+            // get active tension for (lam,dlamdt+h)
+            double h2 = std::max(1e-6, dlam_dt/100);
+            p_contraction_model->SetStretchAndStretchRate(currentFibreStretch, dlam_dt+h2);
+            p_contraction_model->RunDoNotUpdate(this->mCurrentTime,this->mNextTime,this->mOdeTimestep);
+            double active_tension_at_dlamdt_plus_h = p_contraction_model->GetNextActiveTension();
+
+            r_data_at_quad_point.LastRunStretch = currentFibreStretch;
+            r_data_at_quad_point.LastRunStretchRate = dlam_dt+h2;
+
+            r_data_at_quad_point.CachedDerivActiveTensionWrtLambda = (active_tension_at_lam_plus_h - rActiveTension)/h1;
+            r_data_at_quad_point.CachedDerivActiveTensionWrtDLambdaDt = (active_tension_at_dlamdt_plus_h - rActiveTension)/h2;
+            r_data_at_quad_point.CachedDerivsAreSet = true;
+        }
+        rDerivActiveTensionWrtLambda = r_data_at_quad_point.CachedDerivActiveTensionWrtLambda;
+        rDerivActiveTensionWrtDLambdaDt = r_data_at_quad_point.CachedDerivActiveTensionWrtDLambdaDt;
     }
 
     // Increment the iterator
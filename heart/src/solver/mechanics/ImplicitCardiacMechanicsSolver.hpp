@@ -88,15 +88,22 @@ private:
                                           double& rDerivActiveTensionWrtLambda,
                                           double& rDerivActiveTensionWrtDLambdaDt);
 
+    /**
+     *  Forget the contraction model results kept at each quadrature point (see
+     *  DataAtQuadraturePoint), at the start and end of each Solve(), as they are only
+     *  valid for one time step and one set of contraction model inputs.
+     */
+    void InvalidateContractionModelResults();
+
 public:
     /**
      * Constructor
      *
-     * @param rQuadMesh A reference to the mesh.
+     * @param rQuadMesh A reference to the (quadratic, possibly distributed) mesh.
      * @param rProblemDefinition Object defining body force and boundary conditions
      * @param outputDirectory The output directory, relative to TEST_OUTPUT
      */
-    ImplicitCardiacMechanicsSolver(QuadraticMesh<DIM>& rQuadMesh,
+    ImplicitCardiacMechanicsSolver(AbstractTetrahedralMesh<DIM,DIM>& rQuadMesh,
                                    ElectroMechanicsProblemDefinition<DIM>& rProblemDefinition,
                                    std::string outputDirectory);
 
@@ -42,6 +42,11 @@ AbstractStimulusFunction::~AbstractStimulusFunction()
 {
 }
 
+bool AbstractStimulusFunction::IsConstantOver(double startTime, double endTime)
+{
+    return false;
+}
+
 // LCOV_EXCL_START
 void AbstractStimulusFunction::Clear()
 {
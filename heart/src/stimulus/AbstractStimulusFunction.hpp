@@ -73,6 +73,18 @@ public:
      */
     virtual double GetStimulus(double time) = 0;
 
+    /**
+     * @return whether GetStimulus() takes the same value at every time in
+     * the closed interval [startTime, endTime]. Tissue simulations use this
+     * to evaluate a stimulus once per time step rather than every time a
+     * cell's ODE right-hand side is evaluated. The default implementation
+     * makes the safe answer, false.
+     *
+     * @param startTime  start of the interval
+     * @param endTime  end of the interval
+     */
+    virtual bool IsConstantOver(double startTime, double endTime);
+
     /**
      * Destructor.
      */
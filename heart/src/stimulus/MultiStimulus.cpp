@@ -41,6 +41,11 @@ void MultiStimulus::AddStimulus(boost::shared_ptr<AbstractStimulusFunction> pSti
     mStimuli.push_back(pStimulus);
 }
 
+const std::vector<boost::shared_ptr<AbstractStimulusFunction> >& MultiStimulus::rGetStimuli() const
+{
+    return mStimuli;
+}
+
 double MultiStimulus::GetStimulus(double time)
 {
     double total_stimulus = 0.0;
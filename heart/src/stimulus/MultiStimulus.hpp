@@ -90,6 +90,11 @@ public:
      */
      void AddStimulus(boost::shared_ptr<AbstractStimulusFunction> pStimulus);
 
+    /**
+     * @return the stimuli that have been combined.
+     */
+     const std::vector<boost::shared_ptr<AbstractStimulusFunction> >& rGetStimuli() const;
+
     /**
      * Get the magnitude of the multiple stimuli at time 'time'
      *
@@ -80,6 +80,28 @@ double RegularStimulus::GetStimulus(double time)
     }
 }
 
+bool RegularStimulus::IsConstantOver(double startTime, double endTime)
+{
+    if (mMagnitudeOfStimulus == 0.0 || endTime < mStartTime || startTime > mStopTime)
+    {
+        return true;
+    }
+    if (startTime < mStartTime || endTime > mStopTime)
+    {
+        // The interval straddles the first beat or the stop time
+        return false;
+    }
+
+    // Position of the interval within the beat it starts in, as in GetStimulus()
+    double beat_start = fmod(startTime-mStartTime, mPeriod);
+    double beat_end = beat_start + (endTime-startTime);
+    if (beat_start <= mDuration)
+    {
+        return beat_end <= mDuration;
+    }
+    return beat_end < mPeriod;
+}
+
 double RegularStimulus::GetPeriod()
 {
     return mPeriod;
@@ -101,6 +101,15 @@ public:
      */
     double GetStimulus(double time);
 
+    /**
+     * @return whether the stimulus neither switches on nor off within
+     * [startTime, endTime].
+     *
+     * @param startTime  start of the interval
+     * @param endTime  end of the interval
+     */
+    bool IsConstantOver(double startTime, double endTime);
+
     /**
      * @return the pacing cycle length or period of the stimulus.
      */
@@ -72,6 +72,11 @@ double RegularStimulusZeroNetCharge::GetStimulus(double time)
     }
 }
 
+bool RegularStimulusZeroNetCharge::IsConstantOver(double startTime, double endTime)
+{
+    return RegularStimulus::IsConstantOver(startTime, endTime) && GetStimulus(startTime) == 0.0;
+}
+
 // Serialization for Boost >= 1.36
 #include "SerializationExportWrapperForCpp.hpp"
 CHASTE_CLASS_EXPORT(RegularStimulusZeroNetCharge)
@@ -94,6 +94,16 @@ public:
      * @return  Magnitude of stimulus at time 'time'.
      */
     double GetStimulus(double time);
+
+    /**
+     * @return whether the stimulus is off throughout [startTime, endTime].
+     * The stimulus changes sign half way through each pulse, so an interval
+     * in which the parent class would be on throughout is not constant.
+     *
+     * @param startTime  start of the interval
+     * @param endTime  end of the interval
+     */
+    bool IsConstantOver(double startTime, double endTime);
 };
 
 #include "SerializationExportWrapper.hpp"
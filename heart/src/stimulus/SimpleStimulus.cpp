@@ -75,11 +75,34 @@ double SimpleStimulus::GetStimulus(double time)
     }
 }
 
+bool SimpleStimulus::IsConstantOver(double startTime, double endTime)
+{
+    const double end_of_stimulus = mDuration+mTimeOfStimulus;
+    return (mMagnitudeOfStimulus == 0.0)
+        || (endTime < mTimeOfStimulus || startTime > end_of_stimulus) // off throughout
+        || (mTimeOfStimulus <= startTime && endTime <= end_of_stimulus); // on throughout
+}
+
 void SimpleStimulus::SetStartTime(double startTime)
 {
     mTimeOfStimulus = startTime;
 }
 
+double SimpleStimulus::GetMagnitude()
+{
+    return mMagnitudeOfStimulus;
+}
+
+double SimpleStimulus::GetDuration()
+{
+    return mDuration;
+}
+
+double SimpleStimulus::GetStartTime()
+{
+    return mTimeOfStimulus;
+}
+
 // Serialization for Boost >= 1.36
 #include "SerializationExportWrapperForCpp.hpp"
 CHASTE_CLASS_EXPORT(SimpleStimulus)
@@ -102,12 +102,36 @@ public:
      */
     double GetStimulus(double time);
 
+    /**
+     * @return whether the stimulus neither switches on nor off within
+     * [startTime, endTime].
+     *
+     * @param startTime  start of the interval
+     * @param endTime  end of the interval
+     */
+    bool IsConstantOver(double startTime, double endTime);
+
     /**
      * Replace the time that was specified in the constructor with a new start time.
      *
      * @param startTime
      */
     void SetStartTime(double startTime);
+
+    /**
+     * @return the height of the stimulus square wave (magnitude of current).
+     */
+    double GetMagnitude();
+
+    /**
+     * @return the duration of the stimulus square wave.
+     */
+    double GetDuration();
+
+    /**
+     * @return the start time of the stimulus square wave.
+     */
+    double GetStartTime();
 };
 
 
@@ -48,6 +48,11 @@ double ZeroStimulus::GetStimulus(double time)
     return 0.0;
 }
 
+bool ZeroStimulus::IsConstantOver(double startTime, double endTime)
+{
+    return true;
+}
+
 
 // Serialization for Boost >= 1.36
 #include "SerializationExportWrapperForCpp.hpp"
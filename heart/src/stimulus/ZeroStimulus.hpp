@@ -67,6 +67,14 @@ public:
     virtual ~ZeroStimulus();
 
     double GetStimulus(double time);
+
+    /**
+     * @return true, since the stimulus is always zero.
+     *
+     * @param startTime  start of the interval
+     * @param endTime  end of the interval
+     */
+    bool IsConstantOver(double startTime, double endTime);
 };
 
 #include "SerializationExportWrapper.hpp"
@@ -239,10 +239,10 @@ double ElectrodesStimulusFactory<DIM>::ComputeElectrodeTotalFlux(AbstractChasteR
         }/* end of if that checks if node is in the electrode*/
     }/* end of loop over nodes in the mesh*/
 #ifndef NDEBUG
-    int mpi_ret = MPI_Allreduce(&total_electrode_flux, &ret, 1, MPI_DOUBLE, MPI_SUM, PETSC_COMM_WORLD);
+    int mpi_ret = MPI_Allreduce(&total_electrode_flux, &ret, 1, MPI_DOUBLE, MPI_SUM, PetscTools::GetWorld());
     assert(mpi_ret == MPI_SUCCESS);
 #else
-    MPI_Allreduce(&total_electrode_flux, &ret, 1, MPI_DOUBLE, MPI_SUM, PETSC_COMM_WORLD);
+    MPI_Allreduce(&total_electrode_flux, &ret, 1, MPI_DOUBLE, MPI_SUM, PetscTools::GetWorld());
 #endif
 
     //clear up memory
@@ -35,11 +35,14 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "AbstractCardiacTissue.hpp"
 
+#include <cmath>
+#include <exception>
+#include <limits>
 #include <map>
+#include <set>
 #include <string>
 
-#include <boost/scoped_array.hpp>
-
+#include "AbstractCardiacCell.hpp"
 #include "AbstractChasteRegion.hpp"
 #include "AbstractCvodeCell.hpp"
 #include "AxisymmetricConductivityTensors.hpp"
@@ -47,22 +50,35 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "DistributedVector.hpp"
 #include "Exception.hpp"
 #include "HeartEventHandler.hpp"
+#include "HeartRegionCodes.hpp"
+#include "OpenMpExceptionCollector.hpp"
 #include "OrthotropicConductivityTensors.hpp"
 #include "PetscTools.hpp"
 #include "PetscVecTools.hpp"
+#include "Timer.hpp"
 #include "Warnings.hpp"
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::AbstractCardiacTissue(
     AbstractCardiacCellFactory<ELEMENT_DIM, SPACE_DIM>* pCellFactory
   , bool exchangeHalos)
-  : mpMesh(pCellFactory->GetMesh()),
+  : AbstractMemoryAccountable(MemoryAccounting::CARDIAC_TISSUE),
+    mpMesh(pCellFactory->GetMesh()),
     mpDistributedVectorFactory(mpMesh->GetDistributedVectorFactory()),
     mpConductivityModifier(nullptr),
     mHasPurkinje(false),
     mDoCacheReplication(true),
     mMeshUnarchived(false),
-    mExchangeHalos(exchangeHalos)
+    mExchangeHalos(exchangeHalos),
+    mHaloOnlyCacheReplication(false),
+    mOverlapHaloCommunication(false),
+    mNumOdeThreads(1u),
+    mUseActivityAwareOdeScheduling(false),
+    mQuiescentVoltageThreshold(0.0),
+    mQuiescentDvdtThreshold(0.0),
+    mMaxDeferredOdeTime(0.0),
+    mCatchUpOdeTimeStep(0.0),
+    mRecordCellSolveTimes(false)
 {
   // This constructor is called from the Initialise() method of the
   // CardiacProblem class
@@ -107,14 +123,14 @@ AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::AbstractCardiacTissue(
   /////////////////////////////////////////////////////
   // Set up cells
   /////////////////////////////////////////////////////
+  FakeBathCell* p_bath_cell = NULL;
   try {
     for (unsigned local_index = 0; local_index < num_local_nodes;
         ++local_index) {
       unsigned global_index = ownership_range_low + local_index;
       Node<SPACE_DIM>* p_node = mpMesh->GetNode(global_index);
       mCellsDistributed[local_index] =
-          pCellFactory->CreateCardiacCellForNode(p_node);
-      mCellsDistributed[local_index]->SetUsedInTissueSimulation();
+          CreateCellForNode(pCellFactory, p_node, p_bath_cell);
 
       if (mHasPurkinje) {
         mPurkinjeCellsDistributed[local_index] =
@@ -149,15 +165,23 @@ AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::AbstractCardiacTissue(
     for (std::vector<AbstractCardiacCellInterface*>::iterator cell_iterator =
         mCellsDistributed.begin(); cell_iterator != mCellsDistributed.end();
         ++cell_iterator) {
-      delete (*cell_iterator);
+      if (*cell_iterator != p_bath_cell) {
+        delete (*cell_iterator);
+      }
     }
+    delete p_bath_cell;
 
     throw e;
   }
   PetscTools::ReplicateException(false);
 
   // Halo nodes (if required)
-  SetUpHaloCells(pCellFactory);
+  SetUpHaloCells(pCellFactory, p_bath_cell);
+
+  // Share any steady states computed while creating cells
+  if (pCellFactory->GetSteadyStateDatabank()) {
+    pCellFactory->GetSteadyStateDatabank()->Synchronise();
+  }
 
   HeartEventHandler::BeginEvent(HeartEventHandler::COMMUNICATION);
   mIionicCacheReplicated.Resize(pCellFactory->GetNumberOfCells());
@@ -187,12 +211,22 @@ AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::AbstractCardiacTissue(
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::AbstractCardiacTissue(
     AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>* pMesh)
-  : mpMesh(pMesh),
+  : AbstractMemoryAccountable(MemoryAccounting::CARDIAC_TISSUE),
+    mpMesh(pMesh),
     mpDistributedVectorFactory(mpMesh->GetDistributedVectorFactory()),
     mHasPurkinje(false),
     mDoCacheReplication(true),
     mMeshUnarchived(true),
-    mExchangeHalos(false)
+    mExchangeHalos(false),
+    mHaloOnlyCacheReplication(false),
+    mOverlapHaloCommunication(false),
+    mNumOdeThreads(1u),
+    mUseActivityAwareOdeScheduling(false),
+    mQuiescentVoltageThreshold(0.0),
+    mQuiescentDvdtThreshold(0.0),
+    mMaxDeferredOdeTime(0.0),
+    mCatchUpOdeTimeStep(0.0),
+    mRecordCellSolveTimes(false)
 {
   mIionicCacheReplicated.Resize(
       mpDistributedVectorFactory->GetProblemSize());
@@ -207,16 +241,41 @@ AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::AbstractCardiacTissue(
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::~AbstractCardiacTissue()
 {
-  // Delete cells
+  // The batch may outlive us, so mustn't keep pointers to our cells
+  if (mpCellBatch) {
+    mpCellBatch->ClearResidentState();
+  }
+
+  for (unsigned i = 0; i < mCacheExchangeRequests.size(); ++i) {
+    MPI_Request_free(&mCacheExchangeRequests[i]);
+  }
+
+  // Delete cells, and cells for halo nodes. Bath cells may be shared
+  // between nodes, so collect them and delete each only once.
+  std::set<FakeBathCell*> bath_cells;
   for (std::vector<AbstractCardiacCellInterface*>::iterator iter =
       mCellsDistributed.begin(); iter != mCellsDistributed.end(); ++iter) {
-    delete (*iter);
+    FakeBathCell* p_bath_cell = dynamic_cast<FakeBathCell*>(*iter);
+    if (p_bath_cell) {
+      bath_cells.insert(p_bath_cell);
+    }
+    else {
+      delete (*iter);
+    }
   }
-
-  // Delete cells for halo nodes
   for (std::vector<AbstractCardiacCellInterface*>::iterator iter =
       mHaloCellsDistributed.begin(); iter != mHaloCellsDistributed.end();
       ++iter) {
+    FakeBathCell* p_bath_cell = dynamic_cast<FakeBathCell*>(*iter);
+    if (p_bath_cell) {
+      bath_cells.insert(p_bath_cell);
+    }
+    else {
+      delete (*iter);
+    }
+  }
+  for (std::set<FakeBathCell*>::iterator iter = bath_cells.begin();
+      iter != bath_cells.end(); ++iter) {
     delete (*iter);
   }
 
@@ -236,6 +295,51 @@ AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::~AbstractCardiacTissue()
 }
 
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+double AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::GetMemoryUsage() const
+{
+  // Bath cells may be shared between nodes, so count each only once
+  std::set<const AbstractCardiacCellInterface*> bath_cells;
+  double bytes = 0.0;
+  const std::vector<AbstractCardiacCellInterface*>* cell_vectors[3] = {
+      &mCellsDistributed, &mHaloCellsDistributed, &mPurkinjeCellsDistributed};
+  for (unsigned v = 0; v < 3; ++v) {
+    const std::vector<AbstractCardiacCellInterface*>& r_cells = *cell_vectors[v];
+    bytes += GetVectorBytes(r_cells);
+    for (unsigned i = 0; i < r_cells.size(); ++i) {
+      if (dynamic_cast<const FakeBathCell*>(r_cells[i])) {
+        bath_cells.insert(r_cells[i]);
+      }
+      else {
+        bytes += sizeof(AbstractCardiacCell)
+            + (r_cells[i]->GetNumberOfStateVariables()
+               + r_cells[i]->GetNumberOfParameters()) * sizeof(double);
+      }
+    }
+  }
+  bytes += bath_cells.size() * sizeof(FakeBathCell);
+
+  if (mpIntracellularConductivityTensors) {
+    bytes += mpIntracellularConductivityTensors->GetMemoryUsage();
+  }
+
+  // The caches are replicated, so each holds a value for every node of the mesh
+  bytes += (mIionicCacheReplicated.GetSize()
+            + mIntracellularStimulusCacheReplicated.GetSize()
+            + mPurkinjeIionicCacheReplicated.GetSize()
+            + mPurkinjeIntracellularStimulusCacheReplicated.GetSize())
+           * sizeof(double);
+
+  bytes += mIsBathNode.capacity() / 8 + GetVectorBytes(mStimulusGroupOfNode)
+      + GetVectorBytes(mLastOdeVoltage) + GetVectorBytes(mOdeDeferredSince)
+      + GetVectorBytes(mCellSolveTimes) + GetVectorBytes(mHaloNodes)
+      + GetVectorBytes(mBoundaryLocalIndices)
+      + GetVectorBytes(mInteriorLocalIndices)
+      + mIsInactiveNode.capacity() / 8 + GetVectorBytes(mActiveLocalIndices)
+      + GetVectorBytes(mInactiveGlobalIndices);
+  return bytes;
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 bool AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::HasPurkinje()
 {
@@ -359,6 +463,8 @@ void AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::
         intra_conductivities);
   }
 
+  mpIntracellularConductivityTensors->SetUseCompactStorage(
+      mpConfig->GetUseCompactConductivityTensors());
   mpIntracellularConductivityTensors->Init(this->mpMesh);
   HeartEventHandler::EndEvent(HeartEventHandler::READ_MESH);
 }
@@ -377,6 +483,305 @@ bool AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::GetDoCacheReplication()
   return mDoCacheReplication;
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::
+    SetHaloOnlyCacheReplication(bool haloOnly)
+{
+  mHaloOnlyCacheReplication = haloOnly;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::
+    GetHaloOnlyCacheReplication() const
+{
+  return mHaloOnlyCacheReplication;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::
+    SetOverlapHaloCommunication(bool overlap)
+{
+  mOverlapHaloCommunication = overlap;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::
+    GetOverlapHaloCommunication() const
+{
+  return mOverlapHaloCommunication;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::SetNumberOfOdeThreads(
+    unsigned numThreads)
+{
+  if (numThreads == 0u) {
+    EXCEPTION("The number of ODE threads must be at least one.");
+  }
+  mNumOdeThreads = numThreads;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::
+    GetNumberOfOdeThreads() const
+{
+  return mNumOdeThreads;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::SetInactiveRegions(
+    const std::set<HeartRegionType>& rInactiveRegions)
+{
+  // Which cells are batched depends on the mask, so flush the batch first
+  if (mpCellBatch) {
+    mpCellBatch->ClearResidentState();
+  }
+  for (std::set<HeartRegionType>::const_iterator it =
+      rInactiveRegions.begin(); it != rInactiveRegions.end(); ++it) {
+    if (!HeartRegionCode::IsRegionTissue(*it)) {
+      EXCEPTION("Region " << *it << " is not a tissue region, so cannot "
+          "be made inactive.");
+    }
+  }
+  if (mHasPurkinje && !rInactiveRegions.empty()) {
+    EXCEPTION("Inactive tissue regions are not supported with Purkinje "
+        "cells.");
+  }
+  mInactiveRegions = rInactiveRegions;
+  SetUpInactiveNodeMask();
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+const std::set<HeartRegionType>& AbstractCardiacTissue<ELEMENT_DIM,
+    SPACE_DIM>::rGetInactiveRegions() const
+{
+  return mInactiveRegions;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::HasInactiveRegions()
+    const
+{
+  return !mInactiveRegions.empty();
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::IsElementActive(
+    Element<ELEMENT_DIM, SPACE_DIM>& rElement) const
+{
+  return mInactiveRegions.empty() ||
+      mInactiveRegions.find(rElement.GetUnsignedAttribute()) ==
+          mInactiveRegions.end();
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+const std::vector<unsigned>& AbstractCardiacTissue<ELEMENT_DIM,
+    SPACE_DIM>::rGetInactiveOwnedNodes()
+{
+  if (mIsInactiveNode.size() != mCellsDistributed.size()) {
+    SetUpInactiveNodeMask();
+  }
+  return mInactiveGlobalIndices;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::
+    SetActivityAwareOdeScheduling(
+        double voltageThreshold
+      , double dVdtThreshold
+      , double maxDeferredTime
+      , double catchUpTimeStep)
+{
+  if (dVdtThreshold <= 0.0 || maxDeferredTime <= 0.0 ||
+      catchUpTimeStep <= 0.0) {
+    EXCEPTION("The dV/dt threshold, maximum deferred time and catch-up "
+        "time step for activity-aware ODE scheduling must be positive.");
+  }
+  mUseActivityAwareOdeScheduling = true;
+  mQuiescentVoltageThreshold = voltageThreshold;
+  mQuiescentDvdtThreshold = dVdtThreshold;
+  mMaxDeferredOdeTime = maxDeferredTime;
+  mCatchUpOdeTimeStep = catchUpTimeStep;
+
+  const double unset = std::numeric_limits<double>::quiet_NaN();
+  mLastOdeVoltage.assign(mCellsDistributed.size(), unset);
+  mOdeDeferredSince.assign(mCellsDistributed.size(), unset);
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::
+    GetNumberOfDeferredCells() const
+{
+  unsigned num_deferred = 0u;
+  for (unsigned i = 0; i < mOdeDeferredSince.size(); ++i) {
+    if (!std::isnan(mOdeDeferredSince[i])) {
+      ++num_deferred;
+    }
+  }
+  return num_deferred;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::SetRecordCellSolveTimes(
+    bool record)
+{
+  mRecordCellSolveTimes = record;
+  mCellSolveTimes.assign(record ? mCellsDistributed.size() : 0u, 0.0);
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+std::vector<double> AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::
+    GetNodeWeightsFromCellSolveTimes() const
+{
+  if (!mRecordCellSolveTimes) {
+    EXCEPTION("Cell solve times have not been recorded; call "
+        "SetRecordCellSolveTimes() before solving.");
+  }
+  const unsigned num_nodes = mpMesh->GetNumNodes();
+  const unsigned lo = mpDistributedVectorFactory->GetLow();
+  std::vector<double> local_times(num_nodes, 0.0);
+  for (unsigned local_index = 0; local_index < mCellSolveTimes.size();
+      ++local_index) {
+    local_times[lo + local_index] = mCellSolveTimes[local_index];
+  }
+  std::vector<double> times(num_nodes, 0.0);
+  MPI_Allreduce(&local_times[0], &times[0], num_nodes, MPI_DOUBLE, MPI_SUM,
+      PetscTools::GetWorld());
+
+  // Undo any permutation applied when the mesh was partitioned
+  const std::vector<unsigned>& r_permutation =
+      mpMesh->rGetNodePermutation();
+  if (r_permutation.empty()) {
+    return times;
+  }
+  std::vector<double> weights(num_nodes);
+  for (unsigned original_index = 0; original_index < num_nodes;
+      ++original_index) {
+    weights[original_index] = times[r_permutation[original_index]];
+  }
+  return weights;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::DeferCellSolve(
+    unsigned globalIndex
+  , unsigned localIndex
+  , double voltage
+  , double time
+  , double nextTime)
+{
+  AbstractCardiacCellInterface* p_cell = mCellsDistributed[localIndex];
+  const double last_voltage = mLastOdeVoltage[localIndex];
+  mLastOdeVoltage[localIndex] = voltage;
+
+  // Note that the comparison with an unset (NaN) last voltage is false,
+  // so every cell is solved on the first step.
+  bool quiescent = voltage < mQuiescentVoltageThreshold &&
+      fabs(voltage - last_voltage) <
+          mQuiescentDvdtThreshold * (nextTime - time) &&
+      p_cell->GetIntracellularStimulus(time) == 0.0 &&
+      p_cell->GetIntracellularStimulus(nextTime) == 0.0;
+
+  double& r_deferred_since = mOdeDeferredSince[localIndex];
+  const bool was_deferred = !std::isnan(r_deferred_since);
+  if (quiescent) {
+    if (!was_deferred) {
+      r_deferred_since = time;
+    }
+    if (nextTime - r_deferred_since < mMaxDeferredOdeTime) {
+      return true;
+    }
+    // Error control: don't leave a cell unsolved for too long, even at
+    // rest. Catch up over the whole deferred interval in one go.
+    CatchUpDeferredCell(p_cell, globalIndex, r_deferred_since, nextTime);
+    r_deferred_since = std::numeric_limits<double>::quiet_NaN();
+    return true;
+  }
+  if (was_deferred) {
+    // The cell has become active, so bring it up to date before solving
+    // this step as normal
+    if (time > r_deferred_since) {
+      CatchUpDeferredCell(p_cell, globalIndex, r_deferred_since, time);
+    }
+    r_deferred_since = std::numeric_limits<double>::quiet_NaN();
+  }
+  return false;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::CatchUpDeferredCell(
+    AbstractCardiacCellInterface* pCell
+  , unsigned globalIndex
+  , double startTime
+  , double endTime)
+{
+  // The cell may have its own time step (or CVODE maximum step), so
+  // restore that rather than the global ODE time step
+  const double own_timestep = pCell->GetTimestep();
+  pCell->SetTimestep(mCatchUpOdeTimeStep);
+  try {
+    ComputeCellExceptVoltage(pCell, globalIndex, startTime, endTime);
+  }
+  catch (Exception&) {
+    pCell->SetTimestep(own_timestep);
+    throw;
+  }
+  pCell->SetTimestep(own_timestep);
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::ComputeCellExceptVoltage(
+    AbstractCardiacCellInterface* pCell
+  , unsigned globalIndex
+  , double time
+  , double nextTime)
+{
+#ifndef CHASTE_CVODE
+  pCell->ComputeExceptVoltage(time, nextTime);
+#else
+  // If CVODE is enabled, and this is a CVODE cell
+  // there's a chance we can recover this by doing a reset so
+  // put the above call in a try...catch.
+  try {
+    pCell->ComputeExceptVoltage(time, nextTime);
+  }
+  catch (Exception &e) {
+    // Try an 'emergency' reset if this is a CVODE cell.
+    // See #2594 for why we think this may be necessary.
+    if (dynamic_cast<AbstractCvodeCell*>(pCell)) {
+      // Reset the CVODE cell, this leads to a call to
+      // CVodeReInit.
+      static_cast<AbstractCvodeCell*>(pCell)->ResetSolver();
+      pCell->ComputeExceptVoltage(time, nextTime);
+#ifdef CHASTE_OPENMP
+#pragma omp critical(chaste_ode_sweep_output)
+#endif  // CHASTE_OPENMP
+      WARNING("Global node " << globalIndex <<
+          " had an ODE solving problem in t = [" << time << ", " <<
+          nextTime << "] ms. This was fixed by a reset of CVODE, "
+          "but may suggest PDE time step should be reduced, or "
+          "CVODE tolerances relaxed.");
+    }
+    else {
+      throw e;
+    }
+  }
+#endif  // CHASTE_CVODE
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::SetCellBatch(
+    boost::shared_ptr<AbstractCardiacCellBatch> pCellBatch)
+{
+  if (pCellBatch && mHasPurkinje) {
+    EXCEPTION("Batched cell solves are not supported with Purkinje cells.");
+  }
+  if (mpCellBatch) {
+    mpCellBatch->ClearResidentState();
+  }
+  mpCellBatch = pCellBatch;
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 const c_matrix<double, SPACE_DIM, SPACE_DIM>&
     AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::
@@ -408,8 +813,13 @@ AbstractCardiacCellInterface* AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::
 {
   assert(mpDistributedVectorFactory->GetLow() <= globalIndex &&
       globalIndex < mpDistributedVectorFactory->GetHigh());
-  return mCellsDistributed[globalIndex -
+  AbstractCardiacCellInterface* p_cell = mCellsDistributed[globalIndex -
       mpDistributedVectorFactory->GetLow()];
+  // The caller may read or change the cell's state
+  if (mpCellBatch) {
+    mpCellBatch->WriteBackResidentCell(p_cell);
+  }
+  return p_cell;
 }
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
@@ -451,8 +861,12 @@ AbstractCardiacCellInterface* AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::
   // Then search the owned node
   if (mpDistributedVectorFactory->IsGlobalIndexLocal(globalIndex)) {
     // Found an owned node
-    return mCellsDistributed[globalIndex -
+    AbstractCardiacCellInterface* p_cell = mCellsDistributed[globalIndex -
         mpDistributedVectorFactory->GetLow()];
+    if (mpCellBatch) {
+      mpCellBatch->WriteBackResidentCell(p_cell);
+    }
+    return p_cell;
   }
   // Not here
   EXCEPTION("Requested node/halo " << globalIndex <<
@@ -476,7 +890,8 @@ void AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::SetUpHaloCells(
-    AbstractCardiacCellFactory<ELEMENT_DIM, SPACE_DIM>* pCellFactory)
+    AbstractCardiacCellFactory<ELEMENT_DIM, SPACE_DIM>* pCellFactory,
+    FakeBathCell*& rpBathCell)
 {
   if (mExchangeHalos) {
     mpMesh->CalculateNodeExchange(mNodesToSendPerProcess,
@@ -494,8 +909,7 @@ void AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::SetUpHaloCells(
       // variety of GetNode
       Node<SPACE_DIM>* p_node = mpMesh->GetNodeOrHaloNode(global_index);
       mHaloCellsDistributed[local_index] =
-          pCellFactory->CreateCardiacCellForNode(p_node);
-      mHaloCellsDistributed[local_index]->SetUsedInTissueSimulation();
+          CreateCellForNode(pCellFactory, p_node, rpBathCell);
       mHaloGlobalToLocalIndexMap[global_index] = local_index;
     }
     // No need to call FinaliseCellCreation() as halo node cardiac
@@ -505,6 +919,316 @@ void AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::SetUpHaloCells(
 }
 
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+AbstractCardiacCellInterface*
+AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::CreateCellForNode(
+    AbstractCardiacCellFactory<ELEMENT_DIM, SPACE_DIM>* pCellFactory,
+    Node<SPACE_DIM>* pNode, FakeBathCell*& rpBathCell)
+{
+  const bool is_bath = HeartRegionCode::IsRegionBath(pNode->GetRegion());
+  if (is_bath && rpBathCell) {
+    return rpBathCell;
+  }
+  AbstractCardiacCellInterface* p_cell =
+      pCellFactory->CreateCardiacCellForNode(pNode);
+  p_cell->SetUsedInTissueSimulation();
+  if (is_bath) {
+    // Only share the factory's bath cell if it really is one; a factory
+    // may choose to put a real cell model on bath nodes
+    rpBathCell = dynamic_cast<FakeBathCell*>(p_cell);
+  }
+  return p_cell;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::SetUpBathCellMask()
+{
+  mIsBathNode.resize(mCellsDistributed.size());
+  for (unsigned local_index = 0; local_index < mCellsDistributed.size();
+      ++local_index) {
+    mIsBathNode[local_index] =
+        (dynamic_cast<FakeBathCell*>(mCellsDistributed[local_index]) != NULL);
+  }
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::SetUpInactiveNodeMask()
+{
+  const unsigned num_local_cells = mCellsDistributed.size();
+  const unsigned lo = mpDistributedVectorFactory->GetLow();
+  mIsInactiveNode.assign(num_local_cells, false);
+  mActiveLocalIndices.clear();
+  mInactiveGlobalIndices.clear();
+  for (unsigned local_index = 0; local_index < num_local_cells;
+      ++local_index) {
+    const unsigned global_index = lo + local_index;
+    bool is_inactive = false;
+    if (!mInactiveRegions.empty()) {
+      // All the elements containing an owned node are held locally
+      std::set<unsigned>& r_element_indices =
+          mpMesh->GetNode(global_index)->rGetContainingElementIndices();
+      is_inactive = !r_element_indices.empty();
+      for (std::set<unsigned>::iterator it = r_element_indices.begin();
+          is_inactive && it != r_element_indices.end(); ++it) {
+        is_inactive = !IsElementActive(*(mpMesh->GetElement(*it)));
+      }
+    }
+    if (is_inactive) {
+      mIsInactiveNode[local_index] = true;
+      mInactiveGlobalIndices.push_back(global_index);
+      mIionicCacheReplicated[global_index] = 0.0;
+      mIntracellularStimulusCacheReplicated[global_index] = 0.0;
+    }
+    else {
+      mActiveLocalIndices.push_back(local_index);
+    }
+  }
+  // Cells which have just become active need a stimulus group
+  mStimulusGroupOfNode.clear();
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::SetUpStimulusGroups()
+{
+  mDistinctStimuli.clear();
+  mStimulusGroupOfNode.assign(mCellsDistributed.size(), 0u);
+  std::map<AbstractStimulusFunction*, unsigned> group_of_stimulus;
+  for (unsigned local_index = 0; local_index < mCellsDistributed.size();
+      ++local_index) {
+    if (mIsBathNode[local_index] || mIsInactiveNode[local_index]) {
+      continue;
+    }
+    boost::shared_ptr<AbstractStimulusFunction> p_stimulus =
+        mCellsDistributed[local_index]->GetStimulusFunction();
+    std::map<AbstractStimulusFunction*, unsigned>::iterator it =
+        group_of_stimulus.find(p_stimulus.get());
+    if (it == group_of_stimulus.end()) {
+      it = group_of_stimulus.insert(std::make_pair(p_stimulus.get(),
+          static_cast<unsigned>(mDistinctStimuli.size()))).first;
+      mDistinctStimuli.push_back(p_stimulus);
+    }
+    mStimulusGroupOfNode[local_index] = it->second;
+  }
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::EvaluateStimuli(
+    double time
+  , double nextTime)
+{
+  if (mStimulusGroupOfNode.size() != mCellsDistributed.size()) {
+    SetUpStimulusGroups();
+  }
+
+  const unsigned num_groups = mDistinctStimuli.size();
+  std::vector<bool> is_constant(num_groups);
+  std::vector<double> values(num_groups);
+  bool any_constant = false;
+  for (unsigned group = 0; group < num_groups; ++group) {
+    is_constant[group] =
+        mDistinctStimuli[group]->IsConstantOver(time, nextTime);
+    if (is_constant[group]) {
+      values[group] = mDistinctStimuli[group]->GetStimulus(nextTime);
+      any_constant = true;
+    }
+  }
+  if (!any_constant) {
+    return;
+  }
+
+  bool groups_out_of_date = false;
+  for (unsigned local_index = 0; local_index < mCellsDistributed.size();
+      ++local_index) {
+    const unsigned group = mStimulusGroupOfNode[local_index];
+    if (!mIsBathNode[local_index] && !mIsInactiveNode[local_index] &&
+        is_constant[group] &&
+        !mCellsDistributed[local_index]->SetIntracellularStimulusOver(
+            mDistinctStimuli[group].get(), time, nextTime, values[group])) {
+      // Someone has given this cell a new stimulus since we grouped them
+      groups_out_of_date = true;
+    }
+  }
+  if (groups_out_of_date) {
+    mStimulusGroupOfNode.clear();
+  }
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::SolveCellSystemAtNode(
+    unsigned globalIndex
+  , unsigned localIndex
+  , double& rVoltage
+  , double time
+  , double nextTime
+  , bool updateVoltage)
+{
+  if (mIsBathNode[localIndex] || mIsInactiveNode[localIndex]) {
+    // Nothing to integrate, and the voltage is left as the PDE gave it
+    mIionicCacheReplicated[globalIndex] = 0.0;
+    mIntracellularStimulusCacheReplicated[globalIndex] = 0.0;
+    return;
+  }
+
+  AbstractCardiacCellInterface* p_cell = mCellsDistributed[localIndex];
+  double voltage_before_update = rVoltage;
+  p_cell->SetVoltage(voltage_before_update);
+
+  const double start_time =
+      mRecordCellSolveTimes ? Timer::GetWallTime() : 0.0;
+
+  // Added a try-catch here to provide more output to screen when
+  // an error occurs.
+  /// \todo This may want to go to std::cerr ??
+  try {
+    if (mUseActivityAwareOdeScheduling && !updateVoltage &&
+        DeferCellSolve(globalIndex, localIndex, voltage_before_update, time,
+                       nextTime)) {
+      // The ionic current is still updated for the new voltage, using the
+      // gating variables etc. from the last solve
+      UpdateCaches(globalIndex, localIndex, nextTime);
+      return;
+    }
+
+    if (!updateVoltage) {
+      // solve ODE system at this node.
+      // Note: Voltage is not being updated. The voltage is updated
+      // sin the PDE solve.
+      ComputeCellExceptVoltage(p_cell, globalIndex, time, nextTime);
+    }
+    else {
+      // solve, including updating the voltage (for the operator-
+      // splitting implementation of the monodomain solver)
+      p_cell->SolveAndUpdateState(time, nextTime);
+      rVoltage = p_cell->GetVoltage();
+    }
+  }
+  catch (Exception &e) {
+#ifdef CHASTE_OPENMP
+#pragma omp critical(chaste_ode_sweep_output)
+#endif  // CHASTE_OPENMP
+    {
+      std::cout << std::setprecision(16);
+      std::cout << "Global node " << globalIndex <<
+          " had problems with ODE solve between t = " << time << " and " <<
+          nextTime << "ms.\n";
+
+      std::cout << "Voltage at this node before solve was " <<
+          voltage_before_update << "mV\n(this SHOULD NOT necessarily be "
+          "the same as the one in the state variables,\nwhich can be "
+          "ignored and stay at the initial condition - the voltage is "
+          "dictated by PDE instead of state variable.)\n";
+
+      std::cout << "Stimulus current (NB converted to micro-Amps per cm^3) "
+          "applied here is equal to:\n\t" <<
+          p_cell->GetIntracellularStimulus(time) << " at t = " << time <<
+          "ms,\n\t" << p_cell->GetIntracellularStimulus(nextTime) <<
+          " at t = " << nextTime << "ms.\n";
+
+      std::cout << "Cell model: " <<
+          dynamic_cast<AbstractUntemplatedParameterisedSystem*>(
+              p_cell)->GetSystemName() << "\n";
+
+      std::cout << "All state variables are now:\n";
+      std::vector<double> state_vars = p_cell->GetStdVecStateVariables();
+      std::vector<std::string> state_var_names =
+          p_cell->rGetStateVariableNames();
+      for (unsigned i = 0; i < state_vars.size(); ++i) {
+        std::cout << "\t" << state_var_names[i] << "\t:\t" <<
+            state_vars[i] << "\n";
+      }
+      std::cout << std::flush;
+    }
+
+    throw e;
+  }
+  if (mRecordCellSolveTimes) {
+    mCellSolveTimes[localIndex] += Timer::GetWallTime() - start_time;
+  }
+  // update the Iionic and stimulus caches
+  UpdateCaches(globalIndex, localIndex, nextTime);
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::SolveCellSystemsInBatches(
+    DistributedVector& rSolution
+  , DistributedVector::Stripe& rVoltage
+  , double time
+  , double nextTime
+  , bool updateVoltage)
+{
+  const unsigned lo = mpDistributedVectorFactory->GetLow();
+  const unsigned max_batch_size = mpCellBatch->GetMaxBatchSize();
+  const bool keep_resident = mpCellBatch->GetKeepStateResident();
+  std::vector<AbstractCardiacCellInterface*> batch_cells;
+  std::vector<unsigned> batch_global_indices;
+  std::vector<double> batch_voltages;
+  std::vector<double> batch_i_ionic;
+  batch_cells.reserve(max_batch_size);
+  batch_global_indices.reserve(max_batch_size);
+  batch_voltages.reserve(max_batch_size);
+  unsigned block_index = 0u;
+
+  auto solve_batch = [&]() {
+    if (keep_resident) {
+      // Only the voltages and ionic currents are passed between the
+      // batch's state and the tissue; the cells are left alone
+      mpCellBatch->SolveResidentBatch(block_index++, batch_cells,
+          batch_voltages, batch_i_ionic, time, nextTime, updateVoltage);
+      for (unsigned i = 0; i < batch_cells.size(); ++i) {
+        unsigned global_index = batch_global_indices[i];
+        if (updateVoltage) {
+          rVoltage[global_index] = batch_voltages[i];
+        }
+        mIionicCacheReplicated[global_index] = batch_i_ionic[i];
+        mIntracellularStimulusCacheReplicated[global_index] =
+            batch_cells[i]->GetIntracellularStimulus(nextTime);
+      }
+    }
+    else {
+      mpCellBatch->SolveBatch(batch_cells, time, nextTime, updateVoltage);
+      for (unsigned i = 0; i < batch_cells.size(); ++i) {
+        unsigned global_index = batch_global_indices[i];
+        if (updateVoltage) {
+          rVoltage[global_index] = batch_cells[i]->GetVoltage();
+        }
+        UpdateCaches(global_index, global_index - lo, nextTime);
+      }
+    }
+    batch_cells.clear();
+    batch_global_indices.clear();
+    batch_voltages.clear();
+  };
+
+  for (DistributedVector::Iterator index = rSolution.Begin();
+      index != rSolution.End(); ++index) {
+    if (mIsInactiveNode[index.Local]) {
+      // Switched off tissue has nothing to solve, and its caches stay zero
+      continue;
+    }
+    AbstractCardiacCellInterface* p_cell = mCellsDistributed[index.Local];
+    if (!mpCellBatch->IsCompatible(p_cell)) {
+      // e.g. bath cells, or a different model in another region
+      SolveCellSystemAtNode(index.Global, index.Local, rVoltage[index],
+          time, nextTime, updateVoltage);
+      continue;
+    }
+    if (keep_resident) {
+      batch_voltages.push_back(rVoltage[index]);
+    }
+    else {
+      p_cell->SetVoltage(rVoltage[index]);
+    }
+    batch_cells.push_back(p_cell);
+    batch_global_indices.push_back(index.Global);
+    if (batch_cells.size() == max_batch_size) {
+      solve_batch();
+    }
+  }
+  if (!batch_cells.empty()) {
+    solve_batch();
+  }
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::SolveCellSystems(
     Vec existingSolution
@@ -525,6 +1249,15 @@ void AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::SolveCellSystems(
 
   HeartEventHandler::BeginEvent(HeartEventHandler::SOLVE_ODES);
 
+  if (mIsBathNode.size() != mCellsDistributed.size()) {
+    // First solve since construction or unarchiving
+    SetUpBathCellMask();
+  }
+  if (mIsInactiveNode.size() != mCellsDistributed.size()) {
+    SetUpInactiveNodeMask();
+  }
+  EvaluateStimuli(time, nextTime);
+
   DistributedVector dist_solution =
       mpDistributedVectorFactory->CreateDistributedVector(existingSolution);
 
@@ -532,101 +1265,60 @@ void AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::SolveCellSystems(
   // Solve cell models (except purkinje cell models)
   /////////////////////////////////////////////////////////////
   DistributedVector::Stripe voltage(dist_solution, 0);
+  // The voltage is stripe 0 of the local array, so the plain sweeps below
+  // can write straight into the PETSc Vec's memory
+  double* p_local_solution = dist_solution.GetLocalArray();
+  const unsigned stride = dist_solution.GetNumberOfStripes();
+  const unsigned lo = mpDistributedVectorFactory->GetLow();
+  const bool overlap_communication = UseOverlappedHaloCommunication();
+  // If some tissue is switched off, the plain sweeps below only visit the
+  // active nodes, whose caches are the only ones that change
+  const bool active_only = HasInactiveRegions();
+  const unsigned num_sweep_cells = active_only ?
+      mActiveLocalIndices.size() : mCellsDistributed.size();
   try {
-    double voltage_before_update;
-    for (DistributedVector::Iterator index = dist_solution.Begin();
-        index != dist_solution.End(); ++index) {
-      voltage_before_update = voltage[index];
-      mCellsDistributed[index.Local]->SetVoltage(voltage_before_update);
-
-      // Added a try-catch here to provide more output to screen when
-      // an error occurs.
-      /// \todo This may want to go to std::cerr ??
-      try {
-        if (!updateVoltage) {
-          // solve ODE system at this node.
-          // Note: Voltage is not being updated. The voltage is updated
-          // sin the PDE solve.
-#ifndef CHASTE_CVODE
-          mCellsDistributed[index.Local]->ComputeExceptVoltage(time,
-              nextTime);
-#else
-          // If CVODE is enabled, and this is a CVODE cell
-          // there's a chance we can recover this by doing a reset so
-          // put the above call in a try...catch.
-          try {
-            mCellsDistributed[index.Local]->ComputeExceptVoltage(time,
-                nextTime);
-          }
-          catch (Exception &e) {
-            // Try an 'emergency' reset if this is a CVODE cell.
-            // See #2594 for why we think this may be necessary.
-            if (dynamic_cast<AbstractCvodeCell*>(
-                mCellsDistributed[index.Local])) {
-              // Reset the CVODE cell, this leads to a call to
-              // CVodeReInit.
-              static_cast<AbstractCvodeCell*>(
-                  mCellsDistributed[index.Local])->ResetSolver();
-              mCellsDistributed[index.Local]->ComputeExceptVoltage(time,
-                  nextTime);
-              WARNING("Global node " << index.Global <<
-                  " had an ODE solving problem in t = [" << time << ", " <<
-                  nextTime << "] ms. This was fixed by a reset of CVODE, "
-                  "but may suggest PDE time step should be reduced, or "
-                  "CVODE tolerances relaxed.");
-            }
-            else {
-              throw e;
-            }
-          }
-#endif  // CHASTE_CVODE
+    if (overlap_communication) {
+      SolveCellSystemsOverlapped(voltage, time, nextTime, updateVoltage);
+    }
+    else if (mpCellBatch) {
+      SolveCellSystemsInBatches(dist_solution, voltage, time, nextTime,
+          updateVoltage);
+    }
+    else
+#ifdef CHASTE_OPENMP
+    if (mNumOdeThreads > 1u) {
+      // Each local cell is independent of all the others, and each
+      // writes only to its own entries of the voltage stripe and the
+      // caches, so the local range can be shared out between threads.
+      // The first exception thrown by any thread is re-thrown once all
+      // threads have finished.
+      const int num_cells = static_cast<int>(num_sweep_cells);
+      OpenMpExceptionCollector exception_collector;
+#pragma omp parallel for schedule(static) num_threads(mNumOdeThreads)
+      for (int i = 0; i < num_cells; ++i) {
+        try {
+          const unsigned local_index = active_only ?
+              mActiveLocalIndices[i] : static_cast<unsigned>(i);
+          unsigned global_index = lo + local_index;
+          SolveCellSystemAtNode(global_index, local_index,
+              p_local_solution[local_index * stride], time, nextTime,
+              updateVoltage);
         }
-        else {
-          // solve, including updating the voltage (for the operator-
-          // splitting implementation of the monodomain solver)
-          mCellsDistributed[index.Local]->SolveAndUpdateState(time,
-              nextTime);
-          voltage[index] = mCellsDistributed[index.Local]->GetVoltage();
+        catch (...) {
+          exception_collector.Capture();
         }
       }
-      catch (Exception &e) {
-        std::cout << std::setprecision(16);
-        std::cout << "Global node " << index.Global <<
-            " had problems with ODE solve between t = " << time << " and " <<
-            nextTime << "ms.\n";
-
-        std::cout << "Voltage at this node before solve was " <<
-            voltage_before_update << "mV\n(this SHOULD NOT necessarily be "
-            "the same as the one in the state variables,\nwhich can be "
-            "ignored and stay at the initial condition - the voltage is "
-            "dictated by PDE instead of state variable.)\n";
-
-        std::cout << "Stimulus current (NB converted to micro-Amps per cm^3) "
-            "applied here is equal to:\n\t" <<
-            mCellsDistributed[index.Local]->GetIntracellularStimulus(time) <<
-            " at t = " << time     << "ms,\n\t" <<
-            mCellsDistributed[index.Local]->GetIntracellularStimulus(
-                nextTime) << " at t = " << nextTime << "ms.\n";
-
-        std::cout << "Cell model: " <<
-            dynamic_cast<AbstractUntemplatedParameterisedSystem*>(
-                mCellsDistributed[index.Local])->GetSystemName() << "\n";
-
-        std::cout << "All state variables are now:\n";
-        std::vector<double> state_vars =
-            mCellsDistributed[index.Local]->GetStdVecStateVariables();
-        std::vector<std::string> state_var_names =
-            mCellsDistributed[index.Local]->rGetStateVariableNames();
-        for (unsigned i = 0; i < state_vars.size(); ++i) {
-          std::cout << "\t" << state_var_names[i] << "\t:\t" <<
-              state_vars[i] << "\n";
-        }
-        std::cout << std::flush;
-
-        throw e;
+      exception_collector.RethrowIfAny();
+    }
+    else
+#endif  // CHASTE_OPENMP
+    {
+      for (unsigned i = 0; i < num_sweep_cells; ++i) {
+        const unsigned local_index = active_only ? mActiveLocalIndices[i] : i;
+        SolveCellSystemAtNode(lo + local_index, local_index,
+            p_local_solution[local_index * stride], time, nextTime,
+            updateVoltage);
       }
-      // update the Iionic and stimulus caches
-      UpdateCaches(index.Global, index.Local, nextTime);
     }
 
     if (updateVoltage) {
@@ -677,91 +1369,21 @@ void AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::SolveCellSystems(
   PetscTools::ReplicateException(false);
   HeartEventHandler::EndEvent(HeartEventHandler::SOLVE_ODES);
 
-  // Communicate new state variable values to halo nodes
-  if (mExchangeHalos) {
-    assert(!mHasPurkinje);
-
-    for (unsigned rank_offset = 1; rank_offset < PetscTools::GetNumProcs();
-        ++rank_offset) {
-      unsigned send_to = (PetscTools::GetMyRank() + rank_offset) %
-          PetscTools::GetNumProcs();
-      unsigned receive_from = (PetscTools::GetMyRank() +
-          PetscTools::GetNumProcs() - rank_offset) %
-          PetscTools::GetNumProcs();
-
-      unsigned number_of_cells_to_send =
-          mNodesToSendPerProcess[send_to].size();
-      unsigned number_of_cells_to_receive =
-          mNodesToReceivePerProcess[receive_from].size();
-
-      // Pack send buffer
-      unsigned send_size = 0;
-      for (unsigned i = 0; i < number_of_cells_to_send; ++i) {
-        unsigned global_cell_index = mNodesToSendPerProcess[send_to][i];
-        send_size += mCellsDistributed[global_cell_index -
-            mpDistributedVectorFactory->GetLow()]->
-                GetNumberOfStateVariables();
-      }
-
-      boost::scoped_array<double> send_data(new double[send_size]);
-
-      unsigned send_index = 0;
-      for (unsigned cell = 0; cell < number_of_cells_to_send; ++cell) {
-        unsigned global_cell_index = mNodesToSendPerProcess[send_to][cell];
-        AbstractCardiacCellInterface* p_cell = mCellsDistributed[
-            global_cell_index - mpDistributedVectorFactory->GetLow()];
-        std::vector<double> cell_data = p_cell->GetStdVecStateVariables();
-        const unsigned num_state_vars = p_cell->GetNumberOfStateVariables();
-        for (unsigned state_variable = 0; state_variable < num_state_vars;
-            ++state_variable) {
-          send_data[send_index++] = cell_data[state_variable];
-        }
-      }
-      // Receive buffer
-      unsigned receive_size = 0;
-      for (unsigned i = 0; i < number_of_cells_to_receive; ++i) {
-        unsigned halo_cell_index = mHaloGlobalToLocalIndexMap[
-            mNodesToReceivePerProcess[receive_from][i]];
-        receive_size += mHaloCellsDistributed[halo_cell_index]->
-            GetNumberOfStateVariables();
-      }
+  HeartEventHandler::BeginEvent(HeartEventHandler::COMMUNICATION);
 
-      boost::scoped_array<double> receive_data(new double[receive_size]);
-
-      // Send and receive
-      int ret;
-      MPI_Status status;
-      ret = MPI_Sendrecv(send_data.get(), send_size,
-          MPI_DOUBLE,
-          send_to, 0,
-          receive_data.get(), receive_size,
-          MPI_DOUBLE,
-          receive_from, 0,
-          PETSC_COMM_WORLD, &status);
-      UNUSED_OPT(ret);
-      assert(ret == MPI_SUCCESS);
-
-      // Unpack
-      unsigned receive_index = 0;
-      for (unsigned cell = 0; cell < number_of_cells_to_receive; ++cell) {
-        AbstractCardiacCellInterface* p_cell =
-            mHaloCellsDistributed[mHaloGlobalToLocalIndexMap[
-                mNodesToReceivePerProcess[receive_from][cell]]];
-        const unsigned number_of_state_variables =
-            p_cell->GetNumberOfStateVariables();
-
-        std::vector<double> cell_data(number_of_state_variables);
-        for (unsigned state_variable = 0;
-            state_variable < number_of_state_variables; ++state_variable) {
-          cell_data[state_variable] = receive_data[receive_index++];
-        }
-        p_cell->SetStateVariables(cell_data);
-      }
+  // Communicate new state variable values to halo nodes, unless this
+  // has already been done while the interior cells were being solved
+  if (mExchangeHalos && !overlap_communication) {
+    assert(!mHasPurkinje);
+    if (mpCellBatch) {
+      mpCellBatch->WriteBackResidentState();
     }
+    StartStateHaloExchange();
+    FinishStateHaloExchange();
   }
 
-  HeartEventHandler::BeginEvent(HeartEventHandler::COMMUNICATION);
-  if (mDoCacheReplication) {
+  if (mDoCacheReplication &&
+      !(overlap_communication && mHaloOnlyCacheReplication)) {
     ReplicateCaches();
   }
   HeartEventHandler::EndEvent(HeartEventHandler::COMMUNICATION);
@@ -831,6 +1453,11 @@ void AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::ReplicateCaches()
   // Purkinje. See commented code below if introducing this.
   assert(!mHasPurkinje);
 
+  if (mHaloOnlyCacheReplication && !PetscTools::IsSequential()) {
+    ExchangeCacheHalos();
+    return;
+  }
+
   mIionicCacheReplicated.Replicate(mpDistributedVectorFactory->GetLow(),
       mpDistributedVectorFactory->GetHigh());
   mIntracellularStimulusCacheReplicated.Replicate(
@@ -847,11 +1474,276 @@ void AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::ReplicateCaches()
   // }
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::SetUpCacheHaloExchange()
+{
+  // The halo cell set-up will already have done this if exchanging halos
+  if (mNodesToSendPerProcess.empty()) {
+    mpMesh->CalculateNodeExchange(mNodesToSendPerProcess,
+        mNodesToReceivePerProcess);
+  }
+
+  const unsigned num_procs = PetscTools::GetNumProcs();
+  mCacheSendBuffers.resize(num_procs);
+  mCacheReceiveBuffers.resize(num_procs);
+  for (unsigned proc = 0; proc < num_procs; ++proc) {
+    mCacheSendBuffers[proc].resize(2 * mNodesToSendPerProcess[proc].size());
+    mCacheReceiveBuffers[proc].resize(
+        2 * mNodesToReceivePerProcess[proc].size());
+  }
+
+  // Receives first, so that matching sends can complete straight away
+  for (unsigned proc = 0; proc < num_procs; ++proc) {
+    if (!mCacheReceiveBuffers[proc].empty()) {
+      MPI_Request request;
+      MPI_Recv_init(&mCacheReceiveBuffers[proc][0],
+          mCacheReceiveBuffers[proc].size(), MPI_DOUBLE, proc, 1,
+          PetscTools::GetWorld(), &request);
+      mCacheExchangeRequests.push_back(request);
+    }
+  }
+  for (unsigned proc = 0; proc < num_procs; ++proc) {
+    if (!mCacheSendBuffers[proc].empty()) {
+      MPI_Request request;
+      MPI_Send_init(&mCacheSendBuffers[proc][0],
+          mCacheSendBuffers[proc].size(), MPI_DOUBLE, proc, 1,
+          PetscTools::GetWorld(), &request);
+      mCacheExchangeRequests.push_back(request);
+    }
+  }
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::ExchangeCacheHalos()
+{
+  StartCacheHaloExchange();
+  FinishCacheHaloExchange();
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::StartCacheHaloExchange()
+{
+  if (mCacheSendBuffers.empty()) {
+    SetUpCacheHaloExchange();
+  }
+
+  for (unsigned proc = 0; proc < mCacheSendBuffers.size(); ++proc) {
+    const std::vector<unsigned>& r_nodes = mNodesToSendPerProcess[proc];
+    for (unsigned i = 0; i < r_nodes.size(); ++i) {
+      mCacheSendBuffers[proc][2 * i] = mIionicCacheReplicated[r_nodes[i]];
+      mCacheSendBuffers[proc][2 * i + 1] =
+          mIntracellularStimulusCacheReplicated[r_nodes[i]];
+    }
+  }
+
+  if (!mCacheExchangeRequests.empty()) {
+    MPI_Startall(mCacheExchangeRequests.size(), &mCacheExchangeRequests[0]);
+  }
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::FinishCacheHaloExchange()
+{
+  if (!mCacheExchangeRequests.empty()) {
+    MPI_Waitall(mCacheExchangeRequests.size(), &mCacheExchangeRequests[0],
+        MPI_STATUSES_IGNORE);
+  }
+
+  unsigned bytes_sent = 0u;
+  unsigned bytes_received = 0u;
+  for (unsigned proc = 0; proc < mCacheReceiveBuffers.size(); ++proc) {
+    const std::vector<unsigned>& r_nodes = mNodesToReceivePerProcess[proc];
+    for (unsigned i = 0; i < r_nodes.size(); ++i) {
+      mIionicCacheReplicated[r_nodes[i]] = mCacheReceiveBuffers[proc][2 * i];
+      mIntracellularStimulusCacheReplicated[r_nodes[i]] =
+          mCacheReceiveBuffers[proc][2 * i + 1];
+    }
+    bytes_sent += sizeof(double) * mCacheSendBuffers[proc].size();
+    bytes_received += sizeof(double) * mCacheReceiveBuffers[proc].size();
+  }
+  HeartEventHandler::RecordBytes(bytes_sent, bytes_received);
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::StartStateHaloExchange()
+{
+  const unsigned num_procs = PetscTools::GetNumProcs();
+  const unsigned lo = mpDistributedVectorFactory->GetLow();
+  mStateSendBuffers.resize(num_procs);
+  mStateReceiveBuffers.resize(num_procs);
+  mStateExchangeRequests.clear();
+
+  for (unsigned proc = 0; proc < num_procs; ++proc) {
+    // Receive buffer
+    unsigned receive_size = 0;
+    for (unsigned i = 0; i < mNodesToReceivePerProcess[proc].size(); ++i) {
+      unsigned halo_cell_index = mHaloGlobalToLocalIndexMap[
+          mNodesToReceivePerProcess[proc][i]];
+      receive_size += mHaloCellsDistributed[halo_cell_index]->
+          GetNumberOfStateVariables();
+    }
+    std::vector<double>& r_receive = mStateReceiveBuffers[proc];
+    r_receive.resize(receive_size);
+    if (receive_size > 0) {
+      MPI_Request request;
+      MPI_Irecv(&r_receive[0], receive_size, MPI_DOUBLE, proc, 0,
+          PetscTools::GetWorld(), &request);
+      mStateExchangeRequests.push_back(request);
+    }
+
+    // Pack send buffer
+    std::vector<double>& r_send = mStateSendBuffers[proc];
+    r_send.clear();
+    for (unsigned i = 0; i < mNodesToSendPerProcess[proc].size(); ++i) {
+      std::vector<double> cell_data = mCellsDistributed[
+          mNodesToSendPerProcess[proc][i] - lo]->GetStdVecStateVariables();
+      r_send.insert(r_send.end(), cell_data.begin(), cell_data.end());
+    }
+    if (!r_send.empty()) {
+      MPI_Request request;
+      MPI_Isend(&r_send[0], r_send.size(), MPI_DOUBLE, proc, 0,
+          PetscTools::GetWorld(), &request);
+      mStateExchangeRequests.push_back(request);
+    }
+  }
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::FinishStateHaloExchange()
+{
+  if (!mStateExchangeRequests.empty()) {
+    MPI_Waitall(mStateExchangeRequests.size(), &mStateExchangeRequests[0],
+        MPI_STATUSES_IGNORE);
+  }
+
+  // Unpack
+  unsigned bytes_sent = 0u;
+  unsigned bytes_received = 0u;
+  for (unsigned proc = 0; proc < mStateReceiveBuffers.size(); ++proc) {
+    unsigned receive_index = 0;
+    for (unsigned cell = 0; cell < mNodesToReceivePerProcess[proc].size();
+        ++cell) {
+      AbstractCardiacCellInterface* p_cell =
+          mHaloCellsDistributed[mHaloGlobalToLocalIndexMap[
+              mNodesToReceivePerProcess[proc][cell]]];
+      const unsigned number_of_state_variables =
+          p_cell->GetNumberOfStateVariables();
+
+      std::vector<double> cell_data(number_of_state_variables);
+      for (unsigned state_variable = 0;
+          state_variable < number_of_state_variables; ++state_variable) {
+        cell_data[state_variable] =
+            mStateReceiveBuffers[proc][receive_index++];
+      }
+      p_cell->SetStateVariables(cell_data);
+    }
+    bytes_sent += sizeof(double) * mStateSendBuffers[proc].size();
+    bytes_received += sizeof(double) * mStateReceiveBuffers[proc].size();
+  }
+  mStateExchangeRequests.clear();
+  HeartEventHandler::RecordBytes(bytes_sent, bytes_received);
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::
+    UseOverlappedHaloCommunication() const
+{
+  const bool exchange_cache_halos = mDoCacheReplication &&
+      mHaloOnlyCacheReplication && !PetscTools::IsSequential();
+  return mOverlapHaloCommunication && !mpCellBatch &&
+      mNumOdeThreads <= 1u && !mHasPurkinje &&
+      (mExchangeHalos || exchange_cache_halos);
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::
+    SolveCellSystemsOverlapped(
+        DistributedVector::Stripe& rVoltage
+      , double time
+      , double nextTime
+      , bool updateVoltage)
+{
+  const bool exchange_cache_halos = mDoCacheReplication &&
+      mHaloOnlyCacheReplication && !PetscTools::IsSequential();
+  const unsigned lo = mpDistributedVectorFactory->GetLow();
+
+  if (mBoundaryLocalIndices.empty() && mInteriorLocalIndices.empty()) {
+    if (exchange_cache_halos && mCacheSendBuffers.empty()) {
+      // Also works out the node exchange if not exchanging halo cells
+      SetUpCacheHaloExchange();
+    }
+    std::set<unsigned> sent_nodes;
+    for (unsigned proc = 0; proc < mNodesToSendPerProcess.size(); ++proc) {
+      sent_nodes.insert(mNodesToSendPerProcess[proc].begin(),
+          mNodesToSendPerProcess[proc].end());
+    }
+    for (unsigned local_index = 0; local_index < mCellsDistributed.size();
+        ++local_index) {
+      if (sent_nodes.count(lo + local_index)) {
+        mBoundaryLocalIndices.push_back(local_index);
+      }
+      else {
+        mInteriorLocalIndices.push_back(local_index);
+      }
+    }
+  }
+
+  // Every process must post and complete its side of the exchanges, so
+  // an exception from a cell is only re-thrown once they are done
+  std::exception_ptr p_error = nullptr;
+  try {
+    for (unsigned i = 0; i < mBoundaryLocalIndices.size(); ++i) {
+      unsigned global_index = lo + mBoundaryLocalIndices[i];
+      SolveCellSystemAtNode(global_index, mBoundaryLocalIndices[i],
+          rVoltage[global_index], time, nextTime, updateVoltage);
+    }
+  }
+  catch (...) {
+    p_error = std::current_exception();
+  }
+
+  if (mExchangeHalos) {
+    StartStateHaloExchange();
+  }
+  if (exchange_cache_halos) {
+    StartCacheHaloExchange();
+  }
+
+  if (!p_error) {
+    try {
+      for (unsigned i = 0; i < mInteriorLocalIndices.size(); ++i) {
+        unsigned global_index = lo + mInteriorLocalIndices[i];
+        SolveCellSystemAtNode(global_index, mInteriorLocalIndices[i],
+            rVoltage[global_index], time, nextTime, updateVoltage);
+      }
+    }
+    catch (...) {
+      p_error = std::current_exception();
+    }
+  }
+
+  HeartEventHandler::BeginEvent(HeartEventHandler::COMMUNICATION);
+  if (mExchangeHalos) {
+    FinishStateHaloExchange();
+  }
+  if (exchange_cache_halos) {
+    FinishCacheHaloExchange();
+  }
+  HeartEventHandler::EndEvent(HeartEventHandler::COMMUNICATION);
+
+  if (p_error) {
+    std::rethrow_exception(p_error);
+  }
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 const std::vector<AbstractCardiacCellInterface*>&
     AbstractCardiacTissue<ELEMENT_DIM, SPACE_DIM>::
     rGetCellsDistributed() const
 {
+  if (mpCellBatch) {
+    mpCellBatch->WriteBackAndRereadResidentState();
+  }
   return mCellsDistributed;
 }
 
@@ -51,16 +51,21 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <boost/serialization/split_member.hpp>
 
 #include "AbstractCardiacCellInterface.hpp"
+#include "AbstractCardiacCellBatch.hpp"
 #include "FakeBathCell.hpp"
 #include "AbstractCardiacCellFactory.hpp"
 #include "AbstractConductivityTensors.hpp"
 #include "AbstractPurkinjeCellFactory.hpp"
+#include "DistributedVector.hpp"
+#include "PetscTools.hpp"
 #include "ReplicatableVector.hpp"
 #include "HeartConfig.hpp"
 #include "ArchiveLocationInfo.hpp"
 #include "AbstractDynamicallyLoadableEntity.hpp"
 #include "DynamicModelLoaderRegistry.hpp"
 #include "AbstractConductivityModifier.hpp"
+#include "AbstractMemoryAccountable.hpp"
+#include "HeartRegionCodes.hpp"
 
 /**
  * Class containing "tissue-like" functionality used in monodomain and
@@ -76,7 +81,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  * the PDE solvers to call.
  */
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM = ELEMENT_DIM>
-class AbstractCardiacTissue : private boost::noncopyable
+class AbstractCardiacTissue : private boost::noncopyable, public AbstractMemoryAccountable
 {
  private:
   /** Needed for serialization. */
@@ -256,6 +261,51 @@ class AbstractCardiacTissue : private boost::noncopyable
    */
   std::vector<AbstractCardiacCellInterface*> mPurkinjeCellsDistributed;
 
+  /**
+   * For each locally owned node, whether its cell is a FakeBathCell.
+   * Bath nodes carry no ionic current and no stimulus, so the cell
+   * solves skip them without calling into the cell. Not archived; it
+   * is rebuilt from #mCellsDistributed by SetUpBathCellMask().
+   */
+  std::vector<bool> mIsBathNode;
+
+  /**
+   * The element attributes (see HeartRegionCode) of the tissue regions
+   * which have been switched off by SetInactiveRegions(). Not archived.
+   */
+  std::set<HeartRegionType> mInactiveRegions;
+
+  /**
+   * For each locally owned node, whether all of its elements are in
+   * #mInactiveRegions. Such nodes have no cell solve and their caches
+   * stay at zero. Rebuilt by SetUpInactiveNodeMask().
+   */
+  std::vector<bool> mIsInactiveNode;
+
+  /**
+   * Local indices of the locally owned nodes which are not inactive, so
+   * that the plain cell sweeps only visit the active tissue.
+   */
+  std::vector<unsigned> mActiveLocalIndices;
+
+  /** Global indices of the locally owned inactive nodes. */
+  std::vector<unsigned> mInactiveGlobalIndices;
+
+  /**
+   * The distinct stimulus functions used by the local tissue cells. Each
+   * is evaluated once per time step by EvaluateStimuli(). Holding them
+   * here also stops a replaced stimulus being freed and its address
+   * reused while the grouping refers to it. Not archived.
+   */
+  std::vector<boost::shared_ptr<AbstractStimulusFunction> > mDistinctStimuli;
+
+  /**
+   * For each locally owned node, the index into #mDistinctStimuli of its
+   * cell's stimulus function. Empty until SetUpStimulusGroups() is called,
+   * and cleared when a cell turns out to have a new stimulus function.
+   */
+  std::vector<unsigned> mStimulusGroupOfNode;
+
   /**
    * Cache containing all the ionic currents for each node,
    * replicated over all processes.
@@ -337,6 +387,76 @@ class AbstractCardiacTissue : private boost::noncopyable
    */
   bool mExchangeHalos;
 
+  /**
+   * Whether ReplicateCaches() should only fill in the cache entries of
+   * the halo nodes (those belonging to elements which this process
+   * assembles over), rather than gathering the whole of each cache onto
+   * every process. Not archived, since it is set up by the solver.
+   * Defaults to false.
+   */
+  bool mHaloOnlyCacheReplication;
+
+  /**
+   * Whether SolveCellSystems() should overlap the halo communication
+   * with the solve of the interior cells (see
+   * SetOverlapHaloCommunication()). Not archived. Defaults to false.
+   */
+  bool mOverlapHaloCommunication;
+
+  /**
+   * Number of shared-memory threads used to sweep over the local cells
+   * in SolveCellSystems(). Only has an effect when Chaste is built with
+   * OpenMP support (CHASTE_OPENMP); otherwise the sweep is always
+   * serial. Not archived, since it is a property of the run rather
+   * than of the tissue. Defaults to 1.
+   */
+  unsigned mNumOdeThreads;
+
+  /**
+   * If set, the batched solver used for all local cells that are
+   * compatible with it (see SetCellBatch()). Not archived.
+   */
+  boost::shared_ptr<AbstractCardiacCellBatch> mpCellBatch;
+
+  /**
+   * Whether activity-aware ODE scheduling is in use (see
+   * SetActivityAwareOdeScheduling()). Defaults to false.
+   */
+  bool mUseActivityAwareOdeScheduling;
+
+  /** Cells are only considered quiescent below this voltage. */
+  double mQuiescentVoltageThreshold;
+
+  /** Cells are only considered quiescent if |dV/dt| is below this. */
+  double mQuiescentDvdtThreshold;
+
+  /** The longest time for which a quiescent cell's solve is deferred. */
+  double mMaxDeferredOdeTime;
+
+  /** ODE time step used to catch up a deferred cell. */
+  double mCatchUpOdeTimeStep;
+
+  /**
+   * The voltage passed to each local cell at the last call to
+   * SolveCellSystems(), used to estimate dV/dt. NaN if not yet known.
+   */
+  std::vector<double> mLastOdeVoltage;
+
+  /**
+   * The time from which each local cell's solve has been deferred, or
+   * NaN if it is up to date.
+   */
+  std::vector<double> mOdeDeferredSince;
+
+  /**
+   * Whether the wall-clock time spent solving each local cell is being
+   * recorded (see SetRecordCellSolveTimes()). Defaults to false.
+   */
+  bool mRecordCellSolveTimes;
+
+  /** The accumulated wall-clock time (s) spent solving each local cell. */
+  std::vector<double> mCellSolveTimes;
+
   /** Vector of halo node indices for current process */
   std::vector<unsigned> mHaloNodes;
 
@@ -359,6 +479,92 @@ class AbstractCardiacTissue : private boost::noncopyable
    */
   std::vector<std::vector<unsigned>> mNodesToReceivePerProcess;
 
+  /**
+   * Persistent MPI requests for the halo-only cache exchange, created
+   * on first use by SetUpCacheHaloExchange().
+   */
+  std::vector<MPI_Request> mCacheExchangeRequests;
+
+  /**
+   * Per-process buffers of (Iionic, stimulus) pairs for the nodes in
+   * #mNodesToSendPerProcess. These must not be resized once the
+   * persistent requests have been created.
+   */
+  std::vector<std::vector<double>> mCacheSendBuffers;
+
+  /**
+   * Per-process buffers of (Iionic, stimulus) pairs for the nodes in
+   * #mNodesToReceivePerProcess.
+   */
+  std::vector<std::vector<double>> mCacheReceiveBuffers;
+
+  /**
+   * Work out the node exchange (if this has not been done for the halo
+   * cells already) and create the persistent send and receive requests
+   * used by ExchangeCacheHalos().
+   */
+  void SetUpCacheHaloExchange();
+
+  /**
+   * Send the Iionic and intracellular stimulus cache entries of the
+   * owned nodes needed by neighbouring processes, and receive those of
+   * our halo nodes, leaving the rest of each replicated cache untouched.
+   */
+  void ExchangeCacheHalos();
+
+  /**
+   * Pack the cache entries needed by neighbouring processes and start
+   * the persistent requests of the halo-only cache exchange. Must be
+   * followed by FinishCacheHaloExchange().
+   */
+  void StartCacheHaloExchange();
+
+  /**
+   * Wait for the halo-only cache exchange to complete and copy the
+   * received entries into the replicated caches.
+   */
+  void FinishCacheHaloExchange();
+
+  /** Non-blocking requests for the exchange of halo cell state. */
+  std::vector<MPI_Request> mStateExchangeRequests;
+
+  /** Per-process buffers of state variables to send to halo owners. */
+  std::vector<std::vector<double>> mStateSendBuffers;
+
+  /** Per-process buffers of state variables for our halo cells. */
+  std::vector<std::vector<double>> mStateReceiveBuffers;
+
+  /**
+   * Pack the state variables of the owned cells needed by neighbouring
+   * processes and post non-blocking sends and receives for them. Must be
+   * followed by FinishStateHaloExchange().
+   */
+  void StartStateHaloExchange();
+
+  /**
+   * Wait for the halo cell state exchange to complete and set the state
+   * variables of the halo cells from the received data.
+   */
+  void FinishStateHaloExchange();
+
+  /**
+   * Local indices of the owned cells whose state or caches are sent to
+   * other processes, and so must be solved before communication starts.
+   * Set up on first use by SolveCellSystemsOverlapped().
+   */
+  std::vector<unsigned> mBoundaryLocalIndices;
+
+  /** Local indices of the remaining owned cells. */
+  std::vector<unsigned> mInteriorLocalIndices;
+
+  /**
+   * @return whether SolveCellSystems() should use
+   *         SolveCellSystemsOverlapped(), i.e. overlapping has been
+   *         requested, and there is halo communication which can be
+   *         overlapped with the plain (not batched or threaded) cell solve.
+   */
+  bool UseOverlappedHaloCommunication() const;
+
   /**
    * If the mesh is a tetrahedral mesh then all elements and nodes are
    * known. The halo nodes to the ones which are actually used as
@@ -372,9 +578,166 @@ class AbstractCardiacTissue : private boost::noncopyable
    * structures #mHaloCellsDistributed and #mHaloGlobalToLocalIndexMap.
    *
    * @param pCellFactory  cell factory to use to create halo cells
+   * @param rpBathCell  the bath cell shared with the local nodes, if any
+   *        (see CreateCellForNode())
    */
   void SetUpHaloCells(
-      AbstractCardiacCellFactory<ELEMENT_DIM, SPACE_DIM>* pCellFactory);
+      AbstractCardiacCellFactory<ELEMENT_DIM, SPACE_DIM>* pCellFactory,
+      FakeBathCell*& rpBathCell);
+
+  /**
+   * Create the cell for a node. Bath nodes all share a single
+   * FakeBathCell, since it has no state worth keeping per node, so the
+   * factory is only asked for a bath cell once.
+   *
+   * @param pCellFactory  cell factory to use
+   * @param pNode  the node to create a cell for
+   * @param rpBathCell  the shared bath cell, or NULL if none has been
+   *        created yet (updated when the first one is)
+   * @return the cell for the node
+   */
+  AbstractCardiacCellInterface* CreateCellForNode(
+      AbstractCardiacCellFactory<ELEMENT_DIM, SPACE_DIM>* pCellFactory,
+      Node<SPACE_DIM>* pNode, FakeBathCell*& rpBathCell);
+
+  /**
+   * Fill #mIsBathNode from the current local cells.
+   */
+  void SetUpBathCellMask();
+
+  /**
+   * Fill #mIsInactiveNode, #mActiveLocalIndices and
+   * #mInactiveGlobalIndices from the element attributes of the mesh, and
+   * zero the caches of the inactive nodes.
+   */
+  void SetUpInactiveNodeMask();
+
+  /**
+   * Group the local tissue cells by stimulus function, filling
+   * #mDistinctStimuli and #mStimulusGroupOfNode.
+   */
+  void SetUpStimulusGroups();
+
+  /**
+   * Evaluate each distinct stimulus function once for the step
+   * [time, nextTime], and hand the value to the cells using it wherever
+   * the stimulus does not change during the step.
+   *
+   * @param time  the current simulation time
+   * @param nextTime  the end of the step
+   */
+  void EvaluateStimuli(double time, double nextTime);
+
+  /**
+   * Integrate the cell ODEs at a single locally owned node and update
+   * the ionic current and stimulus caches for it. Helper method for
+   * SolveCellSystems(); safe to call concurrently for distinct nodes.
+   *
+   * @param globalIndex  global index of the node
+   * @param localIndex  local index of the node
+   * @param rVoltage  the voltage at this node (updated if updateVoltage
+   *        is true)
+   * @param time  the current simulation time
+   * @param nextTime  when to simulate the cell until
+   * @param updateVoltage  whether to also solve for the voltage
+   */
+  void SolveCellSystemAtNode(
+      unsigned globalIndex
+    , unsigned localIndex
+    , double& rVoltage
+    , double time
+    , double nextTime
+    , bool updateVoltage);
+
+  /**
+   * Decide whether the solve of a local cell over [time, nextTime] can
+   * be skipped because the cell is quiescent, and catch the cell up
+   * with a large time step when it becomes active again, or when it has
+   * been deferred for #mMaxDeferredOdeTime. Used if
+   * #mUseActivityAwareOdeScheduling is set.
+   *
+   * @param globalIndex  global index of the cell
+   * @param localIndex  local index of the cell
+   * @param voltage  the voltage at the cell
+   * @param time  the current simulation time
+   * @param nextTime  when to simulate the cell until
+   * @return true if the normal solve should be skipped
+   */
+  bool DeferCellSolve(
+      unsigned globalIndex
+    , unsigned localIndex
+    , double voltage
+    , double time
+    , double nextTime);
+
+  /**
+   * Solve a cell whose solve was deferred over [startTime, endTime] with
+   * the ODE time step #mCatchUpOdeTimeStep, without updating its voltage.
+   * The cell's own time step is restored afterwards.
+   *
+   * @param pCell  the cell
+   * @param globalIndex  global index of the cell
+   * @param startTime  the time from which the cell was deferred
+   * @param endTime  the time to solve the cell until
+   */
+  void CatchUpDeferredCell(
+      AbstractCardiacCellInterface* pCell
+    , unsigned globalIndex
+    , double startTime
+    , double endTime);
+
+  /**
+   * Solve a cell over [time, nextTime] without updating its voltage. If
+   * CVODE is enabled a failing CVODE cell is reset and solved again.
+   *
+   * @param pCell  the cell
+   * @param globalIndex  global index of the cell (for the warning output)
+   * @param time  the time to solve the cell from
+   * @param nextTime  the time to solve the cell until
+   */
+  void ComputeCellExceptVoltage(
+      AbstractCardiacCellInterface* pCell
+    , unsigned globalIndex
+    , double time
+    , double nextTime);
+
+  /**
+   * Helper method for SolveCellSystems() used when #mpCellBatch is
+   * set. Cells compatible with the batch are gathered into chunks of at
+   * most AbstractCardiacCellBatch::GetMaxBatchSize() cells and solved
+   * together; all other cells are solved one at a time.
+   *
+   * @param rSolution  the current solution
+   * @param rVoltage  the voltage stripe of rSolution
+   * @param time  the current simulation time
+   * @param nextTime  when to simulate the cells until
+   * @param updateVoltage  whether to also solve for the voltage
+   */
+  void SolveCellSystemsInBatches(
+      DistributedVector& rSolution
+    , DistributedVector::Stripe& rVoltage
+    , double time
+    , double nextTime
+    , bool updateVoltage);
+
+  /**
+   * Helper method for SolveCellSystems() which solves the cells whose
+   * data other processes need first, then starts the halo state and
+   * cache exchanges, and solves the interior cells while the messages
+   * are in flight before completing the exchanges. The exchanges are
+   * always completed, even if a cell solve throws, so that no process
+   * is left waiting on another.
+   *
+   * @param rVoltage  the voltage stripe of the current solution
+   * @param time  the current simulation time
+   * @param nextTime  when to simulate the cells until
+   * @param updateVoltage  whether to also solve for the voltage
+   */
+  void SolveCellSystemsOverlapped(
+      DistributedVector::Stripe& rVoltage
+    , double time
+    , double nextTime
+    , bool updateVoltage);
 
  public:
   /**
@@ -405,6 +768,13 @@ class AbstractCardiacTissue : private boost::noncopyable
   /** Virtual destructor */
   virtual ~AbstractCardiacTissue();
 
+  /**
+   * @return an estimate of the bytes held by this process's cells,
+   * conductivity tensors and caches (see MemoryAccounting). Cell
+   * models are counted by their state variables and parameters.
+   */
+  virtual double GetMemoryUsage() const;
+
   /** @return whether this tissue contains Purkinje fibres. */
   bool HasPurkinje();
 
@@ -425,6 +795,172 @@ class AbstractCardiacTissue : private boost::noncopyable
    */
   bool GetDoCacheReplication();
 
+  /**
+   * Set whether ReplicateCaches() should only exchange the cache entries
+   * of halo nodes with neighbouring processes, instead of replicating
+   * the caches in full. This is sufficient for state variable
+   * interpolation, which only reads the caches at the nodes of locally
+   * assembled elements. Has no effect when running sequentially.
+   *
+   * @param haloOnly  whether to exchange only the halo entries
+   */
+  void SetHaloOnlyCacheReplication(bool haloOnly = true);
+
+  /**
+   * @return whether ReplicateCaches() only exchanges halo entries
+   */
+  bool GetHaloOnlyCacheReplication() const;
+
+  /**
+   * Set whether SolveCellSystems() should hide the halo communication
+   * (the halo cell state exchange, and the halo-only cache exchange if
+   * SetHaloOnlyCacheReplication() is on) behind the solve of the cells
+   * whose data no other process needs. Only the plain cell solve is
+   * overlapped; with a cell batch or several ODE threads the
+   * communication still happens after all the cells have been solved.
+   *
+   * @param overlap  whether to overlap communication and computation
+   */
+  void SetOverlapHaloCommunication(bool overlap = true);
+
+  /**
+   * @return whether halo communication is overlapped with the cell solve
+   */
+  bool GetOverlapHaloCommunication() const;
+
+  /**
+   * Set the number of shared-memory threads over which the locally
+   * owned cells are split in SolveCellSystems(), so that e.g. one MPI
+   * process per socket can be used. This is ignored unless Chaste was
+   * built with OpenMP support (Chaste_USE_OPENMP). Purkinje cells are
+   * always solved serially.
+   *
+   * Note that all cell models and stimuli used must then be safe to
+   * solve concurrently on distinct nodes.
+   *
+   * @param numThreads  the number of threads (at least 1)
+   */
+  void SetNumberOfOdeThreads(unsigned numThreads);
+
+  /** @return the number of threads used in SolveCellSystems() */
+  unsigned GetNumberOfOdeThreads() const;
+
+  /**
+   * Use a batched (structure of arrays) solver for those local cells
+   * that are compatible with it, for example all the cells in a
+   * homogeneous region. Incompatible cells, including those whose own
+   * ODE solver or time step differ from the batch's (see
+   * AbstractCardiacCellBatch::IsCompatible()), are solved individually
+   * as normal.
+   *
+   * If the batch keeps state resident (see
+   * AbstractCardiacCellBatch::SetKeepStateResident()) the cells it solves
+   * are brought up to date whenever they are accessed through this
+   * class, e.g. by GetCardiacCell(), rGetCellsDistributed() or
+   * checkpointing, and the state of the cells accessed is then re-read
+   * from them on the next solve. The rest stays resident.
+   *
+   * @param pCellBatch  the batched solver, or an empty pointer to turn
+   *        batching off again
+   */
+  void SetCellBatch(boost::shared_ptr<AbstractCardiacCellBatch> pCellBatch);
+
+  /**
+   * Turn on activity-aware scheduling of the cell ODE solves. A cell is
+   * classed as quiescent if its voltage is below voltageThreshold, the
+   * voltage is changing more slowly than dVdtThreshold, and it is not
+   * being stimulated. Solving quiescent cells is deferred (their ionic
+   * current is still updated for the new voltage), and they are brought
+   * up to date with a single solve using the larger catchUpTimeStep
+   * when they become active again, or once they have been deferred for
+   * maxDeferredTime. Resting tissue therefore costs very little.
+   *
+   * This only applies to solves which do not update the voltage (i.e.
+   * not to operator splitting), and not to batched or Purkinje cells.
+   * The settings are not archived.
+   *
+   * @param voltageThreshold  cells can only be quiescent below this
+   *        voltage (mV), e.g. -70
+   * @param dVdtThreshold  cells can only be quiescent if |dV/dt| is below
+   *        this (mV/ms), e.g. 0.01
+   * @param maxDeferredTime  the longest a cell may go without a solve
+   *        (ms); controls the error
+   * @param catchUpTimeStep  the ODE time step to use when catching up a
+   *        deferred cell (ms)
+   */
+  void SetActivityAwareOdeScheduling(
+      double voltageThreshold
+    , double dVdtThreshold
+    , double maxDeferredTime
+    , double catchUpTimeStep);
+
+  /**
+   * @return the number of local cells whose ODE solve is currently
+   *         deferred by activity-aware scheduling
+   */
+  unsigned GetNumberOfDeferredCells() const;
+
+  /**
+   * Switch off the tissue in some regions of the mesh, e.g. the inert
+   * parts of a wedge preparation or a cryo-ablated region. A node is
+   * inactive if all the elements containing it have one of the given
+   * attributes; nodes on the edge of an inactive region stay active.
+   * Inactive nodes have no cell solve, and MonodomainSolver leaves the
+   * inactive elements out of the volume assembly and holds the voltage
+   * at inactive nodes fixed, so the cost of a time step scales with the
+   * size of the active tissue. Mesh and output numbering are unchanged.
+   *
+   * Only the implicit, matrix-based monodomain solver supports inactive
+   * regions. The setting is not archived.
+   *
+   * @param rInactiveRegions  the element attributes of the regions to
+   *        switch off, each of which must be a tissue identifier; an
+   *        empty set makes all the tissue active again
+   */
+  void SetInactiveRegions(const std::set<HeartRegionType>& rInactiveRegions);
+
+  /** @return the element attributes of the inactive regions */
+  const std::set<HeartRegionType>& rGetInactiveRegions() const;
+
+  /** @return whether any tissue regions have been switched off */
+  bool HasInactiveRegions() const;
+
+  /**
+   * @return whether an element is part of the active tissue, and so
+   *         should be included in the volume assembly
+   *
+   * @param rElement  the element
+   */
+  bool IsElementActive(Element<ELEMENT_DIM, SPACE_DIM>& rElement) const;
+
+  /**
+   * @return the global indices of the locally owned nodes which are
+   *         inactive (see SetInactiveRegions()), in increasing order
+   */
+  const std::vector<unsigned>& rGetInactiveOwnedNodes();
+
+  /**
+   * Start (or stop) recording the wall-clock time spent solving each
+   * local cell in SolveCellSystems(), for example over the first few
+   * beats of a simulation. Any previously recorded times are discarded.
+   * Cells solved by a cell batch (see SetCellBatch()) are not timed.
+   *
+   * @param record  whether to record cell solve times
+   */
+  void SetRecordCellSolveTimes(bool record = true);
+
+  /**
+   * Convert the recorded cell solve times into node weights suitable for
+   * DistributedTetrahedralMesh::SetNodeWeights(), so that the mesh can be
+   * re-partitioned by ODE cost for a subsequent run. Must be called
+   * collectively.
+   *
+   * @return the time spent solving each node's cell, indexed as in the
+   *         original mesh file (i.e. un-permuted) and replicated on all
+   *         processes
+   */
+  std::vector<double> GetNodeWeightsFromCellSolveTimes() const;
+
   /**
    * @return the intracellular conductivity tensor for the given
    *         element
@@ -537,7 +1073,8 @@ class AbstractCardiacTissue : private boost::noncopyable
     , double nextTime);
 
   /**
-   * Replicate the Iionic and intracellular stimulus caches.
+   * Replicate the Iionic and intracellular stimulus caches, or just
+   * their halo entries if SetHaloOnlyCacheReplication() is on.
    */
   void ReplicateCaches();
 
@@ -36,6 +36,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef ABSTRACTCONDUCTIVITYMODIFIER_HPP_
 #define ABSTRACTCONDUCTIVITYMODIFIER_HPP_
 
+#include <map>
 #include <utility>
 #include <vector>
 
@@ -46,10 +47,24 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  * The pure method rCalculateModifiedConductivityTensor() should take
  * in a conductivity and return a modified conductivity (with some
  * dependence e.g. on tissue deformation in cardiac electromechanics).
+ *
+ * By default the modified tensor is only reused while the same element
+ * is asked for repeatedly (e.g. at each quadrature point). A subclass whose
+ * modification changes only at known times (or never) should override
+ * GetTimeDependence() to return ON_INVALIDATION: the tensor of every
+ * element is then computed once and cached until InvalidateCache() is
+ * called, so most assemblies make no calls to the modifier at all.
  */
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 class AbstractConductivityModifier
 {
+ public:
+  /** How often the modified conductivities may change. */
+  enum TimeDependence {
+    EVERY_CALL,      /**< At any time: recompute whenever a new element is asked for */
+    ON_INVALIDATION  /**< Only when InvalidateCache() is called */
+  };
+
  private:
   /**
    * Cache recently-seen elementindex-tensor pairs, one per "domain"
@@ -57,11 +72,39 @@ class AbstractConductivityModifier
   std::vector<std::pair<unsigned, c_matrix<double, SPACE_DIM, SPACE_DIM>>>
       mCache;
 
+  /**
+   * The tensors of every element seen since the cache was last invalidated,
+   * one map per "domain" (only used for ON_INVALIDATION modifiers)
+   */
+  std::vector<std::map<unsigned, c_matrix<double, SPACE_DIM, SPACE_DIM>>>
+      mElementCache;
+
  public:
   /** Destructor */
   virtual ~AbstractConductivityModifier()
   {}
 
+  /**
+   * @return how often the modified conductivities may change. Defaults
+   *         to EVERY_CALL; override to declare a modifier which only
+   *         changes when InvalidateCache() is called.
+   */
+  virtual TimeDependence GetTimeDependence() const
+  {
+    return EVERY_CALL;
+  }
+
+  /**
+   * Forget all cached tensors, so that they are recalculated on next use.
+   * ON_INVALIDATION modifiers must call this whenever whatever the
+   * modification depends on (or the original conductivities) changes.
+   */
+  void InvalidateCache()
+  {
+    mCache.clear();
+    mElementCache.clear();
+  }
+
   /**
    * Method that checks element index and the domain
    * (intra/extra/other) and returns cached value if available.
@@ -79,6 +122,19 @@ class AbstractConductivityModifier
     , const c_matrix<double, SPACE_DIM, SPACE_DIM>& rOriginalConductivity
     , unsigned domainIndex)
   {
+    if (GetTimeDependence() == ON_INVALIDATION) {
+      if (mElementCache.size() <= domainIndex) {
+        mElementCache.resize(domainIndex + 1);
+      }
+      auto it = mElementCache[domainIndex].find(elementIndex);
+      if (it == mElementCache[domainIndex].end()) {
+        it = mElementCache[domainIndex].insert(std::make_pair(elementIndex,
+            rCalculateModifiedConductivityTensor(elementIndex,
+                rOriginalConductivity, domainIndex))).first;
+      }
+      return it->second;
+    }
+
     // Have we got space for this domain?
     if (mCache.size() <= domainIndex) {
       // Not a pretty line! Initialises every new entry with an
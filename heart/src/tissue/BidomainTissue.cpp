@@ -160,6 +160,7 @@ void BidomainTissue<SPACE_DIM>::CreateExtracellularConductivityTensors()
         mpExtracellularConductivityTensors->SetConstantConductivities(extra_conductivities);
     }
 
+    mpExtracellularConductivityTensors->SetUseCompactStorage(this->mpConfig->GetUseCompactConductivityTensors());
     mpExtracellularConductivityTensors->Init(this->mpMesh);
 }
 
@@ -172,6 +173,17 @@ BidomainTissue<SPACE_DIM>::~BidomainTissue()
     }
 }
 
+template <unsigned SPACE_DIM>
+double BidomainTissue<SPACE_DIM>::GetMemoryUsage() const
+{
+    double bytes = AbstractCardiacTissue<SPACE_DIM>::GetMemoryUsage();
+    if (mpExtracellularConductivityTensors)
+    {
+        bytes += mpExtracellularConductivityTensors->GetMemoryUsage();
+    }
+    return bytes;
+}
+
 
 template <unsigned SPACE_DIM>
 const c_matrix<double, SPACE_DIM, SPACE_DIM>& BidomainTissue<SPACE_DIM>::rGetExtracellularConductivityTensor(unsigned elementIndex)
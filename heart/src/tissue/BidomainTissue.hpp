@@ -102,6 +102,12 @@ public:
      */
     ~BidomainTissue();
 
+    /**
+     * @return an estimate of the bytes held by this tissue on this process, including
+     * the extracellular conductivity tensors (see MemoryAccounting).
+     */
+    double GetMemoryUsage() const;
+
     /**
      * @return the extracellular conductivity tensor for the given element
      * @param elementIndex  index of the element of interest
@@ -101,6 +101,11 @@ ExtendedBidomainTissue<SPACE_DIM>::ExtendedBidomainTissue(AbstractCardiacCellFac
     // LCOV_EXCL_STOP
     PetscTools::ReplicateException(false);
 
+    if (pCellFactorySecondCell->GetSteadyStateDatabank())
+    {
+        pCellFactorySecondCell->GetSteadyStateDatabank()->Synchronise();
+    }
+
     HeartEventHandler::BeginEvent(HeartEventHandler::COMMUNICATION);
     mIionicCacheReplicatedSecondCell.Resize( pCellFactory->GetNumberOfCells() );
     mIntracellularStimulusCacheReplicatedSecondCell.Resize( pCellFactorySecondCell->GetNumberOfCells() );
@@ -295,6 +300,7 @@ void ExtendedBidomainTissue<SPACE_DIM>::CreateIntracellularConductivityTensorSec
         mpIntracellularConductivityTensorsSecondCell->SetConstantConductivities(mIntracellularConductivitiesSecondCell);
     }
 
+    mpIntracellularConductivityTensorsSecondCell->SetUseCompactStorage(this->mpConfig->GetUseCompactConductivityTensors());
     mpIntracellularConductivityTensorsSecondCell->Init(this->mpMesh);
     HeartEventHandler::EndEvent(HeartEventHandler::READ_MESH);
 }
@@ -431,6 +437,7 @@ void ExtendedBidomainTissue<SPACE_DIM>::CreateExtracellularConductivityTensors()
     {
         mpExtracellularConductivityTensors->SetConstantConductivities(extra_conductivities);
     }
+    mpExtracellularConductivityTensors->SetUseCompactStorage(this->mpConfig->GetUseCompactConductivityTensors());
     mpExtracellularConductivityTensors->Init(this->mpMesh);
 }
 
@@ -46,6 +46,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "MonodomainProblem.hpp"
 
 #include "CardiacSimulation.hpp"
+#include "CardiacSimulationBatch.hpp"
 
 #include "OutputFileHandler.hpp"
 #include "CompareHdf5ResultsFiles.hpp"
@@ -237,6 +238,25 @@ public:
                                                  "Mono1DStimUsingEllipsoid", "SimulationResults", true, 1e-6));
     }
 
+    void TestEikonal1dSmall()
+    {
+        CardiacSimulation simulation("heart/test/data/xml/eikonal1d_small.xml", false, true);
+        boost::shared_ptr<AbstractUntemplatedCardiacProblem> p_problem = simulation.GetSavedProblem();
+        EikonalProblem<1>* p_eikonal_problem = dynamic_cast<EikonalProblem<1>*>(p_problem.get());
+        TS_ASSERT(p_eikonal_problem != NULL);
+        TS_ASSERT(!p_eikonal_problem->IsReactionEikonal());
+
+        // The wave leaves x=0 when it is stimulated, at 2ms, and travels at 0.05 cm/ms
+        const std::vector<double>& r_times = p_eikonal_problem->rGetActivationTimes();
+        TS_ASSERT_EQUALS(r_times.size(), 101u);
+        TS_ASSERT_DELTA(r_times[0], 2.0, 1e-12);
+        TS_ASSERT_DELTA(r_times[50], 12.0, 1e-9);
+        TS_ASSERT_DELTA(r_times[100], 22.0, 1e-9);
+
+        FileFinder activation_map("Eikonal1D/ActivationTimeMap.dat", RelativeTo::ChasteTestOutput);
+        TS_ASSERT(activation_map.Exists());
+    }
+
     void TestBi1dSmall()
     {
         if (PetscTools::GetNumProcs() > 3u)
@@ -628,6 +648,41 @@ public:
                    foldername, "SimulationResults", true, 1e-4));
     }
 
+    void TestBatch()
+    {
+        // Two scenarios sharing a mesh, and one that fails
+        OutputFileHandler handler("CardiacSimulationBatch");
+        FileFinder electrodes_xml("heart/test/data/xml/bidomain_with_bath2d_electrodes.xml", RelativeTo::ChasteSourceRoot);
+        FileFinder small_xml("heart/test/data/xml/bidomain_with_bath2d_small.xml", RelativeTo::ChasteSourceRoot);
+        if (PetscTools::AmMaster())
+        {
+            out_stream p_manifest = handler.OpenOutputFile("manifest.txt");
+            (*p_manifest) << "# Scenarios on the 2D bath mesh" << std::endl
+                          << electrodes_xml.GetAbsolutePath() << std::endl
+                          << std::endl
+                          << "  " << small_xml.GetAbsolutePath() << std::endl
+                          << "missing_parameters.xml" << std::endl;
+            p_manifest->close();
+        }
+        PetscTools::Barrier("TestBatch");
+
+        CardiacSimulationBatch batch(handler.FindFile("manifest.txt").GetAbsolutePath());
+        TS_ASSERT_EQUALS(batch.GetNumScenarios(), 3u);
+        TS_ASSERT_EQUALS(batch.GetNumFailed(), 1u);
+        TS_ASSERT_EQUALS(batch.GetNumResidentMeshes(), 1u);
+
+        // Reading the mesh once gives the same results as a standalone run
+        TS_ASSERT( CompareFilesViaHdf5DataReaderGlobalNorm("heart/test/data/cardiac_simulations", "electrodes_results", false,
+                   "ChasteResults_electrodes", "SimulationResults", true, 1e-4));
+
+        TS_ASSERT_THROWS_THIS(CardiacSimulationBatch bad_batch("no manifest"),
+                              "Batch manifest file no manifest does not exist");
+        std::stringstream message;
+        message << "The number of groups (0) must be between 1 and the number of processes (" << PetscTools::GetNumProcs() << ")";
+        TS_ASSERT_THROWS_THIS(CardiacSimulationBatch bad_batch(handler.FindFile("manifest.txt").GetAbsolutePath(), 0u),
+                              message.str());
+    }
+
     void TestExceptions()
     {
         TS_ASSERT_THROWS_THIS(CardiacSimulation simulation("heart/test/data/xml/monodomain8d_small.xml"),
@@ -263,6 +263,206 @@ public:
         }
     }
 
+    void TestArchivingWithBinaryArchives()
+    {
+        std::string archive_dir("bidomain_problem_archive_binary");
+
+        // Save
+        {
+            HeartConfig::Instance()->SetIntracellularConductivities(Create_c_vector(0.0005));
+            HeartConfig::Instance()->SetExtracellularConductivities(Create_c_vector(0.0005));
+            HeartConfig::Instance()->SetMeshFileName("mesh/test/data/1D_0_to_1mm_10_elements");
+            HeartConfig::Instance()->SetOutputDirectory("BiProblemArchiveBinary");
+            HeartConfig::Instance()->SetOutputFilenamePrefix("BidomainLR91_1d");
+            HeartConfig::Instance()->SetSurfaceAreaToVolumeRatio(1.0);
+            HeartConfig::Instance()->SetCapacitance(1.0);
+            HeartConfig::Instance()->SetOdePdeAndPrintingTimeSteps(0.01, 0.01, 0.1);
+
+            PlaneStimulusCellFactory<CellLuoRudy1991FromCellML, 1> cell_factory;
+            BidomainProblem<1> bidomain_problem( &cell_factory );
+
+            bidomain_problem.Initialise();
+            HeartConfig::Instance()->SetSimulationDuration(1.0); //ms
+            bidomain_problem.Solve();
+
+            CardiacSimulationArchiver<BidomainProblem<1> >::Save(bidomain_problem, archive_dir, false, true);
+        }
+
+        // The format is recorded in the information file
+        FileFinder info_file(archive_dir + "/archive.info", RelativeTo::ChasteTestOutput);
+        std::ifstream info_stream(info_file.GetAbsolutePath().c_str());
+        unsigned num_procs, archive_version;
+        std::string archive_format;
+        info_stream >> num_procs >> archive_version >> archive_format;
+        TS_ASSERT_EQUALS(num_procs, PetscTools::GetNumProcs());
+        TS_ASSERT_EQUALS(archive_format, "binary");
+
+        // Load and run, outputting to a different directory
+        {
+            OutputFileHandler handler("BidomainSimple1d_binary", true);
+
+            BidomainProblem<1> *p_bidomain_problem;
+            p_bidomain_problem = CardiacSimulationArchiver<BidomainProblem<1> >::Load(archive_dir);
+
+            HeartConfig::Instance()->SetSimulationDuration(2.0); //ms
+            HeartConfig::Instance()->SetOutputDirectory("BidomainSimple1d_binary");
+            p_bidomain_problem->Solve();
+
+            // Check some voltages
+            ReplicatableVector solution_replicated(p_bidomain_problem->GetSolution());
+            TS_ASSERT_EQUALS(solution_replicated.GetSize(), mSolutionReplicated1d2ms.size()); //This in to make sure that the first test in the suite has been run!
+            for (unsigned index=0; index<solution_replicated.GetSize(); index++)
+            {
+                // Shouldn't differ from the original run at all
+                TS_ASSERT_DELTA(solution_replicated[index], mSolutionReplicated1d2ms[index],  5e-11);
+            }
+
+            // Free memory
+            delete p_bidomain_problem;
+        }
+    }
+
+    void TestArchivingWithCompressedArchives()
+    {
+        // Check both text and binary archives can be compressed
+        for (unsigned binary=0; binary<2; binary++)
+        {
+            std::string archive_dir = binary ? "bidomain_problem_archive_binary_gz" : "bidomain_problem_archive_text_gz";
+
+            // Save
+            {
+                HeartConfig::Instance()->SetIntracellularConductivities(Create_c_vector(0.0005));
+                HeartConfig::Instance()->SetExtracellularConductivities(Create_c_vector(0.0005));
+                HeartConfig::Instance()->SetMeshFileName("mesh/test/data/1D_0_to_1mm_10_elements");
+                HeartConfig::Instance()->SetOutputDirectory("BiProblemArchiveCompressed");
+                HeartConfig::Instance()->SetOutputFilenamePrefix("BidomainLR91_1d");
+                HeartConfig::Instance()->SetSurfaceAreaToVolumeRatio(1.0);
+                HeartConfig::Instance()->SetCapacitance(1.0);
+                HeartConfig::Instance()->SetOdePdeAndPrintingTimeSteps(0.01, 0.01, 0.1);
+
+                PlaneStimulusCellFactory<CellLuoRudy1991FromCellML, 1> cell_factory;
+                BidomainProblem<1> bidomain_problem( &cell_factory );
+
+                bidomain_problem.Initialise();
+                HeartConfig::Instance()->SetSimulationDuration(1.0); //ms
+                bidomain_problem.Solve();
+
+                CardiacSimulationArchiver<BidomainProblem<1> >::Save(bidomain_problem, archive_dir, true, binary, true);
+            }
+
+            // The format and compression are recorded in the information file
+            FileFinder info_file(archive_dir + "/archive.info", RelativeTo::ChasteTestOutput);
+            std::ifstream info_stream(info_file.GetAbsolutePath().c_str());
+            unsigned num_procs, archive_version;
+            std::string archive_format, archive_compression;
+            info_stream >> num_procs >> archive_version >> archive_format >> archive_compression;
+            TS_ASSERT_EQUALS(archive_format, binary ? "binary" : "text");
+            TS_ASSERT_EQUALS(archive_compression, "gzip");
+
+            // The archive itself starts with the gzip magic number
+            FileFinder archive_file(archive_dir + "/archive.arch", RelativeTo::ChasteTestOutput);
+            std::ifstream archive_stream(archive_file.GetAbsolutePath().c_str(), std::ios::binary);
+            unsigned char magic[2] = {0u, 0u};
+            archive_stream.read(reinterpret_cast<char*>(magic), 2);
+            TS_ASSERT_EQUALS(magic[0], 0x1fu);
+            TS_ASSERT_EQUALS(magic[1], 0x8bu);
+
+            // Load and run, outputting to a different directory
+            {
+                OutputFileHandler handler("BidomainSimple1d_compressed", true);
+
+                BidomainProblem<1>* p_bidomain_problem = CardiacSimulationArchiver<BidomainProblem<1> >::Load(archive_dir);
+
+                HeartConfig::Instance()->SetSimulationDuration(2.0); //ms
+                HeartConfig::Instance()->SetOutputDirectory("BidomainSimple1d_compressed");
+                p_bidomain_problem->Solve();
+
+                ReplicatableVector solution_replicated(p_bidomain_problem->GetSolution());
+                TS_ASSERT_EQUALS(solution_replicated.GetSize(), mSolutionReplicated1d2ms.size());
+                for (unsigned index=0; index<solution_replicated.GetSize(); index++)
+                {
+                    TS_ASSERT_DELTA(solution_replicated[index], mSolutionReplicated1d2ms[index], 5e-11);
+                }
+
+                delete p_bidomain_problem;
+            }
+        }
+    }
+
+    void TestRepartitioningOnLoad()
+    {
+        std::string archive_dir("bidomain_problem_archive_repartition");
+
+        // Save
+        {
+            HeartConfig::Instance()->SetIntracellularConductivities(Create_c_vector(0.0005));
+            HeartConfig::Instance()->SetExtracellularConductivities(Create_c_vector(0.0005));
+            HeartConfig::Instance()->SetMeshFileName("mesh/test/data/1D_0_to_1mm_10_elements");
+            HeartConfig::Instance()->SetOutputDirectory("BiProblemArchiveRepartition");
+            HeartConfig::Instance()->SetOutputFilenamePrefix("BidomainLR91_1d");
+            HeartConfig::Instance()->SetSurfaceAreaToVolumeRatio(1.0);
+            HeartConfig::Instance()->SetCapacitance(1.0);
+            HeartConfig::Instance()->SetOdePdeAndPrintingTimeSteps(0.01, 0.01, 0.1);
+
+            PlaneStimulusCellFactory<CellLuoRudy1991FromCellML, 1> cell_factory;
+            BidomainProblem<1> bidomain_problem( &cell_factory );
+
+            bidomain_problem.Initialise();
+            HeartConfig::Instance()->SetSimulationDuration(1.0); //ms
+            bidomain_problem.Solve();
+
+            CardiacSimulationArchiver<BidomainProblem<1> >::Save(bidomain_problem, archive_dir);
+        }
+
+        // The first three nodes are ten times as expensive as the rest
+        const unsigned num_nodes = 11u;
+        std::vector<double> weights(num_nodes, 1.0);
+        double total_weight = 0.0;
+        for (unsigned i=0; i<num_nodes; i++)
+        {
+            if (i < 3u)
+            {
+                weights[i] = 10.0;
+            }
+            total_weight += weights[i];
+        }
+        DistributedTetrahedralMesh<1,1>::SetNodeWeightsOnLoad(weights);
+
+        // Load on the same number of processes, re-partitioning by cost, and run
+        {
+            OutputFileHandler handler("BidomainSimple1d_repartition", true);
+
+            BidomainProblem<1>* p_bidomain_problem = CardiacSimulationArchiver<BidomainProblem<1> >::Load(archive_dir);
+
+            // Each process owns no more than its share of the weight, give or take one node
+            DistributedVectorFactory* p_factory = p_bidomain_problem->rGetMesh().GetDistributedVectorFactory();
+            TS_ASSERT_EQUALS(p_factory->GetProblemSize(), num_nodes);
+            double local_weight = 0.0;
+            for (unsigned i=p_factory->GetLow(); i<p_factory->GetHigh(); i++)
+            {
+                local_weight += weights[i];
+            }
+            TS_ASSERT_LESS_THAN_EQUALS(local_weight, total_weight/PetscTools::GetNumProcs() + 10.0);
+
+            HeartConfig::Instance()->SetSimulationDuration(2.0); //ms
+            HeartConfig::Instance()->SetOutputDirectory("BidomainSimple1d_repartition");
+            p_bidomain_problem->Solve();
+
+            // Shouldn't differ from the original run at all
+            ReplicatableVector solution_replicated(p_bidomain_problem->GetSolution());
+            TS_ASSERT_EQUALS(solution_replicated.GetSize(), mSolutionReplicated1d2ms.size());
+            for (unsigned index=0; index<solution_replicated.GetSize(); index++)
+            {
+                TS_ASSERT_DELTA(solution_replicated[index], mSolutionReplicated1d2ms[index], 5e-11);
+            }
+
+            delete p_bidomain_problem;
+        }
+
+        // Later loads re-use the saved partition again
+        DistributedTetrahedralMesh<1,1>::SetNodeWeightsOnLoad(std::vector<double>());
+    }
+
     /**
      *  Test used to generate data for the acceptance test resume_bidomain. We run the same simulation as in save_bidomain
      *  and archive it. resume_bidomain will load it and resume the simulation.
@@ -42,6 +42,8 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "AxisymmetricConductivityTensors.hpp"
 #include "TetrahedralMesh.hpp"
 #include "DistributedTetrahedralMesh.hpp"
+#include "UniformlyRefinedMeshReader.hpp"
+#include "OutputFileHandler.hpp"
 #include "PetscSetupAndFinalize.hpp"
 
 typedef AxisymmetricConductivityTensors<2,2> AXI_2D;
@@ -245,6 +247,63 @@ public:
         }
     }
 
+    void TestFibreOrientationOnRefinedMesh()
+    {
+        c_vector<double, 3> constant_conductivities(Create_c_vector(7.0,3.5,0.5));
+
+        TrianglesMeshReader<3,3> coarse_reader("heart/test/data/box_shaped_heart/box_heart");
+        TetrahedralMesh<3,3> coarse_mesh;
+        coarse_mesh.ConstructFromMeshReader(coarse_reader);
+
+        // The fibre file has a line per coarse element, which the refined elements inherit
+        UniformlyRefinedMeshReader<3,3> fine_reader(coarse_reader);
+        TetrahedralMesh<3,3> fine_mesh;
+        fine_mesh.ConstructFromMeshReader(fine_reader);
+        TS_ASSERT_EQUALS(fine_mesh.GetNumElementsPerParentElement(), 8u);
+
+        FileFinder ortho_file("heart/test/data/box_shaped_heart/box_heart.ortho", RelativeTo::ChasteSourceRoot);
+        OrthotropicConductivityTensors<3,3> coarse_tensors;
+        coarse_tensors.SetConstantConductivities(constant_conductivities);
+        coarse_tensors.SetFibreOrientationFile(ortho_file);
+        coarse_tensors.Init(&coarse_mesh);
+
+        OrthotropicConductivityTensors<3,3> fine_tensors;
+        fine_tensors.SetConstantConductivities(constant_conductivities);
+        fine_tensors.SetFibreOrientationFile(ortho_file);
+        fine_tensors.Init(&fine_mesh);
+
+        FileFinder axi_file("heart/test/data/box_shaped_heart/box_heart.axi", RelativeTo::ChasteSourceRoot);
+        AxisymmetricConductivityTensors<3,3> fine_axi_tensors;
+        fine_axi_tensors.SetConstantConductivities(Create_c_vector(7.0,3.5,3.5));
+        fine_axi_tensors.SetFibreOrientationFile(axi_file);
+        fine_axi_tensors.SetUseCompactStorage();
+        fine_axi_tensors.Init(&fine_mesh);
+
+        for (unsigned element_index=0; element_index<fine_mesh.GetNumElements(); element_index++)
+        {
+            unsigned parent_index = fine_reader.GetParentElementIndex(element_index);
+            for (unsigned i=0; i<3; i++)
+            {
+                for (unsigned j=0; j<3; j++)
+                {
+                    TS_ASSERT_DELTA(fine_tensors[element_index](i,j), coarse_tensors[parent_index](i,j), 1e-12);
+                }
+            }
+            TS_ASSERT_DELTA(fine_axi_tensors[element_index](0,0), fine_axi_tensors[8*parent_index](0,0), 1e-12);
+        }
+
+        // A fibre file for neither mesh is still rejected
+        TrianglesMeshReader<3,3> cube_reader("mesh/test/data/cube_136_elements");
+        UniformlyRefinedMeshReader<3,3> fine_cube_reader(cube_reader);
+        TetrahedralMesh<3,3> fine_cube;
+        fine_cube.ConstructFromMeshReader(fine_cube_reader);
+        OrthotropicConductivityTensors<3,3> cube_tensors;
+        cube_tensors.SetConstantConductivities(constant_conductivities);
+        cube_tensors.SetFibreOrientationFile(ortho_file);
+        TS_ASSERT_THROWS_THIS(cube_tensors.Init(&fine_cube),
+                              "The size of the fibre file does not match the number of elements in the mesh");
+    }
+
     void TestFibreOrientationAxisymmetric3D()
     {
         TetrahedralMesh<3,3> mesh;
@@ -543,6 +602,126 @@ public:
             TS_ASSERT_DELTA(axi_tensors[element_index](2,2), g_l, tol);
         }
     }
+
+    void TestCompactStorageMatchesFullTensors()
+    {
+        DistributedTetrahedralMesh<3,3> mesh;
+        mesh.ConstructCuboid(1,1,5);
+
+        // Three distinct conductivities, as if from heterogeneity regions
+        std::vector<c_vector<double, 3> > non_constant_conductivities;
+        for (AbstractTetrahedralMesh<3,3>::ElementIterator it = mesh.GetElementIteratorBegin();
+             it != mesh.GetElementIteratorEnd();
+             ++it)
+        {
+            non_constant_conductivities.push_back((1.0 + it->GetIndex()%3)*Create_c_vector(2.1, 0.8, 0.135));
+        }
+
+        FileFinder ortho_file("heart/test/data/fibre_tests/NonTrivialOrthotropic3D.ortho", RelativeTo::ChasteSourceRoot);
+        FileFinder axi_file("heart/test/data/fibre_tests/NonTrivialAxisymmetric3D.axi", RelativeTo::ChasteSourceRoot);
+
+        OrthotropicConductivityTensors<3,3> ortho_tensors;
+        ortho_tensors.SetNonConstantConductivities(&non_constant_conductivities);
+        ortho_tensors.SetFibreOrientationFile(ortho_file);
+        ortho_tensors.Init(&mesh);
+
+        OrthotropicConductivityTensors<3,3> compact_ortho_tensors;
+        compact_ortho_tensors.SetNonConstantConductivities(&non_constant_conductivities);
+        compact_ortho_tensors.SetFibreOrientationFile(ortho_file);
+        compact_ortho_tensors.SetUseCompactStorage();
+        compact_ortho_tensors.Init(&mesh);
+
+        AxisymmetricConductivityTensors<3,3> axi_tensors;
+        axi_tensors.SetNonConstantConductivities(&non_constant_conductivities);
+        axi_tensors.SetFibreOrientationFile(axi_file);
+        axi_tensors.Init(&mesh);
+
+        AxisymmetricConductivityTensors<3,3> compact_axi_tensors;
+        compact_axi_tensors.SetNonConstantConductivities(&non_constant_conductivities);
+        compact_axi_tensors.SetFibreOrientationFile(axi_file);
+        compact_axi_tensors.SetUseCompactStorage();
+        compact_axi_tensors.Init(&mesh);
+
+        for (AbstractTetrahedralMesh<3,3>::ElementIterator it = mesh.GetElementIteratorBegin();
+             it != mesh.GetElementIteratorEnd();
+             ++it)
+        {
+            unsigned element_index = it->GetIndex();
+            for (unsigned i=0; i<3; i++)
+            {
+                for (unsigned j=0; j<3; j++)
+                {
+                    TS_ASSERT_DELTA(compact_ortho_tensors[element_index](i,j), ortho_tensors[element_index](i,j), 1e-8);
+                    TS_ASSERT_DELTA(compact_axi_tensors[element_index](i,j), axi_tensors[element_index](i,j), 1e-12);
+                }
+            }
+        }
+
+        // Heterogeneous conductivities with no fibre file
+        OrthotropicConductivityTensors<3,3> compact_hetero_tensors;
+        compact_hetero_tensors.SetNonConstantConductivities(&non_constant_conductivities);
+        compact_hetero_tensors.SetUseCompactStorage();
+        compact_hetero_tensors.Init(&mesh);
+        for (AbstractTetrahedralMesh<3,3>::ElementIterator it = mesh.GetElementIteratorBegin();
+             it != mesh.GetElementIteratorEnd();
+             ++it)
+        {
+            unsigned element_index = it->GetIndex();
+            double scale = 1.0 + element_index%3;
+            TS_ASSERT_DELTA(compact_hetero_tensors[element_index](0,0), scale*2.1, 1e-12);
+            TS_ASSERT_DELTA(compact_hetero_tensors[element_index](1,1), scale*0.8, 1e-12);
+            TS_ASSERT_DELTA(compact_hetero_tensors[element_index](2,2), scale*0.135, 1e-12);
+            TS_ASSERT_DELTA(compact_hetero_tensors[element_index](0,1), 0.0, 1e-12);
+        }
+    }
+
+    void TestCompactStorageWithLeftHandedFrames()
+    {
+        TetrahedralMesh<3,3> mesh;
+        mesh.ConstructCuboid(1,1,1);
+        TS_ASSERT_EQUALS(mesh.GetNumElements(), 6u);
+
+        // Fibre, sheet and normal on each line; some frames are left-handed, and one is a half turn
+        OutputFileHandler handler("TestCompactConductivityTensors");
+        if (PetscTools::AmMaster())
+        {
+            double c = cos(0.3);
+            double s = sin(0.3);
+            out_stream p_file = handler.OpenOutputFile("frames.ortho");
+            *p_file << "6\n";
+            *p_file << "1 0 0  0 1 0  0 0 -1\n";
+            *p_file << "0 0 1  1 0 0  0 1 0\n";
+            *p_file << "0 -1 0  1 0 0  0 0 1\n";
+            *p_file << "-1 0 0  0 -1 0  0 0 1\n";
+            *p_file << c << " " << s << " 0  " << -s << " " << c << " 0  0 0 -1\n";
+            *p_file << "0 0 -1  0 1 0  1 0 0\n";
+            p_file->close();
+        }
+        PetscTools::Barrier("TestCompactStorageWithLeftHandedFrames");
+        FileFinder ortho_file = handler.FindFile("frames.ortho");
+
+        OrthotropicConductivityTensors<3,3> ortho_tensors;
+        ortho_tensors.SetConstantConductivities(Create_c_vector(2.1, 0.8, 0.135));
+        ortho_tensors.SetFibreOrientationFile(ortho_file);
+        ortho_tensors.Init(&mesh);
+
+        OrthotropicConductivityTensors<3,3> compact_tensors;
+        compact_tensors.SetConstantConductivities(Create_c_vector(2.1, 0.8, 0.135));
+        compact_tensors.SetFibreOrientationFile(ortho_file);
+        compact_tensors.SetUseCompactStorage();
+        compact_tensors.Init(&mesh);
+
+        for (unsigned element_index=0; element_index<6u; element_index++)
+        {
+            for (unsigned i=0; i<3; i++)
+            {
+                for (unsigned j=0; j<3; j++)
+                {
+                    TS_ASSERT_DELTA(compact_tensors[element_index](i,j), ortho_tensors[element_index](i,j), 1e-5);
+                }
+            }
+        }
+    }
 };
 
 #endif /*TESTFIBREORIENTATIONTENSORS_HPP_*/
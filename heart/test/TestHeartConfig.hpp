@@ -1128,6 +1128,15 @@ public:
         HeartConfig::Instance()->SetKSPSolver("chebychev");
         TS_ASSERT(strcmp(HeartConfig::Instance()->GetKSPSolver(), "chebychev")==0);
 
+        HeartConfig::Instance()->SetKSPSolver("pipecg");
+        TS_ASSERT(strcmp(HeartConfig::Instance()->GetKSPSolver(), "pipecg")==0);
+
+        HeartConfig::Instance()->SetKSPSolver("groppcg");
+        TS_ASSERT(strcmp(HeartConfig::Instance()->GetKSPSolver(), "groppcg")==0);
+
+        HeartConfig::Instance()->SetKSPSolver("pgmres");
+        TS_ASSERT(strcmp(HeartConfig::Instance()->GetKSPSolver(), "pgmres")==0);
+
         TS_ASSERT_THROWS_THIS(HeartConfig::Instance()->SetKSPSolver("foobar"),"Unknown solver type provided");
 
         HeartConfig::Instance()->SetKSPPreconditioner("jacobi");
@@ -1154,6 +1163,9 @@ public:
         HeartConfig::Instance()->SetKSPPreconditioner("twolevelsblockdiagonal");
         TS_ASSERT(strcmp(HeartConfig::Instance()->GetKSPPreconditioner(), "twolevelsblockdiagonal")==0);
 
+        HeartConfig::Instance()->SetKSPPreconditioner("tissuebathmultilevel");
+        TS_ASSERT(strcmp(HeartConfig::Instance()->GetKSPPreconditioner(), "tissuebathmultilevel")==0);
+
         HeartConfig::Instance()->SetKSPPreconditioner("none");
         TS_ASSERT(strcmp(HeartConfig::Instance()->GetKSPPreconditioner(), "none")==0);
 
@@ -1241,17 +1253,81 @@ public:
         HeartConfig::Instance()->SetUseReactionDiffusionOperatorSplitting(false);
         TS_ASSERT_EQUALS(HeartConfig::Instance()->GetUseReactionDiffusionOperatorSplitting(), false);
 
+        TS_ASSERT_EQUALS(HeartConfig::Instance()->GetUseExplicitMonodomainSolver(), false);
+        HeartConfig::Instance()->SetUseExplicitMonodomainSolver();
+        TS_ASSERT_EQUALS(HeartConfig::Instance()->GetUseExplicitMonodomainSolver(), true);
+        HeartConfig::Instance()->SetUseExplicitMonodomainSolver(false);
+        TS_ASSERT_EQUALS(HeartConfig::Instance()->GetUseExplicitMonodomainSolver(), false);
+
+        TS_ASSERT_EQUALS(HeartConfig::Instance()->GetUseCompactConductivityTensors(), false);
+        HeartConfig::Instance()->SetUseCompactConductivityTensors();
+        TS_ASSERT_EQUALS(HeartConfig::Instance()->GetUseCompactConductivityTensors(), true);
+        HeartConfig::Instance()->SetUseCompactConductivityTensors(false);
+        TS_ASSERT_EQUALS(HeartConfig::Instance()->GetUseCompactConductivityTensors(), false);
+
+        TS_ASSERT_EQUALS(HeartConfig::Instance()->IsLatticeOutputRequested(), false);
+        {
+            c_vector<double,3> lower = zero_vector<double>(3);
+            c_vector<double,3> upper = scalar_vector<double>(3, 1.0);
+            TS_ASSERT_THROWS_THIS(HeartConfig::Instance()->SetLatticeOutput(lower, upper, 0.0, 1.0),
+                                  "The lattice spacing and output period must be positive");
+            HeartConfig::Instance()->SetLatticeOutput(lower, upper, 0.25, 2.0);
+            TS_ASSERT_EQUALS(HeartConfig::Instance()->IsLatticeOutputRequested(), true);
+
+            c_vector<double,3> got_lower, got_upper;
+            double spacing, period;
+            HeartConfig::Instance()->GetLatticeOutput(got_lower, got_upper, spacing, period);
+            TS_ASSERT_DELTA(got_lower(2), 0.0, 1e-12);
+            TS_ASSERT_DELTA(got_upper(2), 1.0, 1e-12);
+            TS_ASSERT_DELTA(spacing, 0.25, 1e-12);
+            TS_ASSERT_DELTA(period, 2.0, 1e-12);
+            HeartConfig::Instance()->CancelLatticeOutput();
+            TS_ASSERT_EQUALS(HeartConfig::Instance()->IsLatticeOutputRequested(), false);
+        }
+
+        TS_ASSERT_EQUALS(HeartConfig::Instance()->IsProbeOutputRequested(), false);
+        {
+            std::vector<unsigned> probes;
+            probes.push_back(7);
+            probes.push_back(3);
+            HeartConfig::Instance()->SetProbeOutputNodes(probes);
+            TS_ASSERT_EQUALS(HeartConfig::Instance()->IsProbeOutputRequested(), true);
+            std::vector<unsigned> got_probes;
+            HeartConfig::Instance()->GetProbeOutputNodes(got_probes);
+            TS_ASSERT_EQUALS(got_probes.size(), 2u);
+            TS_ASSERT_EQUALS(got_probes[1], 3u);
+            HeartConfig::Instance()->SetProbeOutputNodes(std::vector<unsigned>());
+            TS_ASSERT_EQUALS(HeartConfig::Instance()->IsProbeOutputRequested(), false);
+        }
+
         TS_ASSERT_EQUALS(HeartConfig::Instance()->GetUseMassLumpingForPrecond(), false);
         HeartConfig::Instance()->SetUseMassLumpingForPrecond();
         TS_ASSERT_EQUALS(HeartConfig::Instance()->GetUseMassLumpingForPrecond(), true);
         HeartConfig::Instance()->SetUseMassLumpingForPrecond(false);
         TS_ASSERT_EQUALS(HeartConfig::Instance()->GetUseMassLumpingForPrecond(), false);
 
+        TS_ASSERT_EQUALS(HeartConfig::Instance()->GetUseMatrixFreeOperators(), false);
+        HeartConfig::Instance()->SetUseMatrixFreeOperators();
+        TS_ASSERT_EQUALS(HeartConfig::Instance()->GetUseMatrixFreeOperators(), true);
+        HeartConfig::Instance()->SetUseMatrixFreeOperators(false);
+        TS_ASSERT_EQUALS(HeartConfig::Instance()->GetUseMatrixFreeOperators(), false);
+
         TS_ASSERT_EQUALS(HeartConfig::Instance()->GetUseFixedNumberIterationsLinearSolver(), false);
         TS_ASSERT_EQUALS(HeartConfig::Instance()->GetEvaluateNumItsEveryNSolves(), UINT_MAX);
         HeartConfig::Instance()->SetUseFixedNumberIterationsLinearSolver(true, 20);
         TS_ASSERT_EQUALS(HeartConfig::Instance()->GetUseFixedNumberIterationsLinearSolver(), true);
         TS_ASSERT_EQUALS(HeartConfig::Instance()->GetEvaluateNumItsEveryNSolves(), 20u);
+        TS_ASSERT_EQUALS(HeartConfig::Instance()->GetFixedNumberIterationsLinearSolver(), 0u);
+        HeartConfig::Instance()->SetUseFixedNumberIterationsLinearSolver(true, UINT_MAX, 15);
+        TS_ASSERT_EQUALS(HeartConfig::Instance()->GetFixedNumberIterationsLinearSolver(), 15u);
+
+        TS_ASSERT_EQUALS(HeartConfig::Instance()->GetLinearSolverInitialGuessType(), PREVIOUS_SOLUTION);
+        TS_ASSERT_EQUALS(HeartConfig::Instance()->GetLinearSolverInitialGuessNumPreviousSolutions(), 4u);
+        HeartConfig::Instance()->SetLinearSolverInitialGuess(PROJECTION, 6u);
+        TS_ASSERT_EQUALS(HeartConfig::Instance()->GetLinearSolverInitialGuessType(), PROJECTION);
+        TS_ASSERT_EQUALS(HeartConfig::Instance()->GetLinearSolverInitialGuessNumPreviousSolutions(), 6u);
+        TS_ASSERT_THROWS_THIS(HeartConfig::Instance()->SetLinearSolverInitialGuess(PROJECTION, 0u),
+                              "The projection initial guess needs at least one previous solution");
     }
 
     void TestPostProcessingFunctions()
@@ -1391,7 +1467,7 @@ public:
         }
         TS_ASSERT_EQUALS(Warnings::Instance()->GetNumWarnings(), 1u);
         TS_ASSERT_EQUALS(Warnings::Instance()->GetNextWarningMessage(),
-                         "Unable to locate schema file ChasteParameters_2017_1.xsd. You will need to ensure it is available when resuming from the checkpoint.");
+                         "Unable to locate schema file ChasteParameters_2026_1.xsd. You will need to ensure it is available when resuming from the checkpoint.");
     }
 
     void TestArchiving()
@@ -1489,6 +1565,27 @@ public:
         }
     }
 
+    void TestReadParametersOnMasterOnly()
+    {
+        TS_ASSERT(!HeartConfig::Instance()->GetReadParametersOnMasterOnly());
+        HeartConfig::Instance()->SetReadParametersOnMasterOnly(true);
+        TS_ASSERT(HeartConfig::Instance()->GetReadParametersOnMasterOnly());
+
+        // Every process ends up with the same parameters
+        HeartConfig::Instance()->SetParametersFile("heart/test/data/xml/ChasteParametersFullFormat.xml");
+        TS_ASSERT_EQUALS(HeartConfig::Instance()->GetSpaceDimension(), 3u);
+        TS_ASSERT_EQUALS(HeartConfig::Instance()->GetSimulationDuration(), 10.0);
+        TS_ASSERT_EQUALS(HeartConfig::Instance()->GetDomain(), cp::domain_type::Mono);
+        TS_ASSERT_EQUALS(HeartConfig::Instance()->GetDefaultIonicModel().Hardcoded().get(),
+                         cp::ionic_models_available_type::FaberRudy2000);
+
+        // Errors reading on the master are thrown on every process
+        HeartConfig::Reset();
+        HeartConfig::Instance()->SetReadParametersOnMasterOnly(true);
+        TS_ASSERT_THROWS_THIS(HeartConfig::Instance()->SetParametersFile("DoesNotExist.xml"),
+                "Missing file parsing configuration file: DoesNotExist.xml");
+    }
+
     void TestExceptions()
     {
         TS_ASSERT_THROWS_THIS(HeartConfig::Instance()->SetParametersFile("DoesNotExist.xml"),
@@ -1557,6 +1654,7 @@ public:
         TS_ASSERT_EQUALS(HeartConfig::Instance()->GetVersionFromNamespace("https://chaste.comlab.ox.ac.uk/nss/parameters/3_3"), 3003u);
         TS_ASSERT_EQUALS(HeartConfig::Instance()->GetVersionFromNamespace("https://chaste.comlab.ox.ac.uk/nss/parameters/3_4"), 3004u);
         TS_ASSERT_EQUALS(HeartConfig::Instance()->GetVersionFromNamespace("https://chaste.comlab.ox.ac.uk/nss/parameters/2017_1"), 2017001u);
+        TS_ASSERT_EQUALS(HeartConfig::Instance()->GetVersionFromNamespace("https://chaste.comlab.ox.ac.uk/nss/parameters/2026_1"), 2026001u);
         // and exceptions
         TS_ASSERT_THROWS_THIS(HeartConfig::Instance()->GetVersionFromNamespace("https://chaste.comlab.ox.ac.uk/nss/parameters/1__1"),
                               "https://chaste.comlab.ox.ac.uk/nss/parameters/1__1 is not a recognised Chaste parameters namespace.");
@@ -1695,6 +1793,18 @@ public:
         HeartConfig::Instance()->SetUseFixedSchemaLocation(true);
         HeartConfig::Instance()->SetParametersFile("heart/test/data/xml/ChasteParametersRelease3_3.xml");
         TS_ASSERT(HeartConfig::Instance()->GetVisualizeWithMeshalyzer());
+
+        // Check that release 2017.1 xml can be loaded with release 2017.1 schema
+        HeartConfig::Reset();
+        HeartConfig::Instance()->SetUseFixedSchemaLocation(false);
+        HeartConfig::Instance()->SetParametersFile("heart/test/data/xml/ChasteParametersRelease2017_1.xml");
+        TS_ASSERT_EQUALS(HeartConfig::Instance()->GetKSPPreconditioner(), std::string("bjacobi"));
+
+        // Check that release 2017.1 xml can be loaded with latest schema
+        HeartConfig::Reset();
+        HeartConfig::Instance()->SetUseFixedSchemaLocation(true);
+        HeartConfig::Instance()->SetParametersFile("heart/test/data/xml/ChasteParametersRelease2017_1.xml");
+        TS_ASSERT_EQUALS(HeartConfig::Instance()->GetKSPPreconditioner(), std::string("bjacobi"));
 }
 
     /**
@@ -1968,8 +2078,10 @@ private:
         map["cp33"].schema = "ChasteParameters_3_3.xsd";
         map["cp34"].name = "https://chaste.comlab.ox.ac.uk/nss/parameters/3_4";
         map["cp34"].schema = "ChasteParameters_3_4.xsd";
-        map["cp"].name = "https://chaste.comlab.ox.ac.uk/nss/parameters/2017_1";
-        map["cp"].schema = "ChasteParameters_2017_1.xsd";
+        map["cp2017"].name = "https://chaste.comlab.ox.ac.uk/nss/parameters/2017_1";
+        map["cp2017"].schema = "ChasteParameters_2017_1.xsd";
+        map["cp"].name = "https://chaste.comlab.ox.ac.uk/nss/parameters/2026_1";
+        map["cp"].schema = "ChasteParameters_2026_1.xsd";
         cp::ChasteParameters(*p_parameters_file, *pParams, map);
     }
 
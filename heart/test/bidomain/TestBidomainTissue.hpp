@@ -128,6 +128,38 @@ public:
         return mTensor;
     }
 };
+class CountingConductivityModifier : public AbstractConductivityModifier<2,2>
+{
+private:
+    c_matrix<double,2,2> mTensor;
+    bool mCacheUntilInvalidated;
+
+public:
+    unsigned mNumCalls;
+    double mFactor;
+
+    CountingConductivityModifier(bool cacheUntilInvalidated)
+        : AbstractConductivityModifier<2,2>(),
+          mTensor(zero_matrix<double>(2,2)),
+          mCacheUntilInvalidated(cacheUntilInvalidated),
+          mNumCalls(0u),
+          mFactor(2.0)
+    {
+    }
+
+    AbstractConductivityModifier<2,2>::TimeDependence GetTimeDependence() const
+    {
+        return mCacheUntilInvalidated ? ON_INVALIDATION : EVERY_CALL;
+    }
+
+    c_matrix<double,2,2>& rCalculateModifiedConductivityTensor(unsigned elementIndex, const c_matrix<double,2,2>& rOriginalConductivity, unsigned domainIndex)
+    {
+        mNumCalls++;
+        mTensor = mFactor*rOriginalConductivity;
+        return mTensor;
+    }
+};
+
 class TestBidomainTissue : public CxxTest::TestSuite
 {
 public:
@@ -309,6 +341,52 @@ public:
         TS_ASSERT_EQUALS(bidomain_tissue.rGetExtracellularConductivityTensor(3u)(0,0),7.0);
     }
 
+    void TestConductivityModifierTimeDependence()
+    {
+        HeartConfig::Instance()->Reset();
+        TrianglesMeshReader<2,2> mesh_reader("mesh/test/data/square_4_elements");
+        TetrahedralMesh<2,2> mesh;
+        mesh.ConstructFromMeshReader(mesh_reader);
+
+        PlaneStimulusCellFactory<CellLuoRudy1991FromCellML, 2> cell_factory;
+        cell_factory.SetMesh(&mesh);
+        BidomainTissue<2> bidomain_tissue(&cell_factory);
+
+        CountingConductivityModifier every_call_modifier(false);
+        CountingConductivityModifier cached_modifier(true);
+        TS_ASSERT_EQUALS(every_call_modifier.GetTimeDependence(), AbstractConductivityModifier<2,2>::EVERY_CALL);
+
+        // Two sweeps over the elements, as two assemblies would make
+        for (unsigned sweep=0; sweep<2; sweep++)
+        {
+            for (unsigned element_index=0; element_index<4; element_index++)
+            {
+                for (unsigned domain=0; domain<2; domain++)
+                {
+                    const c_matrix<double,2,2>& r_original = (domain == 0)
+                        ? bidomain_tissue.rGetIntracellularConductivityTensor(element_index)
+                        : bidomain_tissue.rGetExtracellularConductivityTensor(element_index);
+                    TS_ASSERT_DELTA(every_call_modifier.rGetModifiedConductivityTensor(element_index, r_original, domain)(0,0),
+                                    2.0*r_original(0,0), 1e-12);
+                    TS_ASSERT_DELTA(cached_modifier.rGetModifiedConductivityTensor(element_index, r_original, domain)(0,0),
+                                    2.0*r_original(0,0), 1e-12);
+                }
+            }
+        }
+        TS_ASSERT_EQUALS(every_call_modifier.mNumCalls, 16u);
+        TS_ASSERT_EQUALS(cached_modifier.mNumCalls, 8u);
+
+        // The cached tensors are kept until the modifier says they have changed
+        cached_modifier.mFactor = 3.0;
+        const c_matrix<double,2,2>& r_original = bidomain_tissue.rGetIntracellularConductivityTensor(0u);
+        TS_ASSERT_DELTA(cached_modifier.rGetModifiedConductivityTensor(0u, r_original, 0u)(0,0), 2.0*r_original(0,0), 1e-12);
+        TS_ASSERT_EQUALS(cached_modifier.mNumCalls, 8u);
+
+        cached_modifier.InvalidateCache();
+        TS_ASSERT_DELTA(cached_modifier.rGetModifiedConductivityTensor(0u, r_original, 0u)(0,0), 3.0*r_original(0,0), 1e-12);
+        TS_ASSERT_EQUALS(cached_modifier.mNumCalls, 9u);
+    }
+
     void TestBidomainTissueWithHeterogeneousConductivitiesEllipsoid()
     {
         HeartConfig::Instance()->Reset();
@@ -103,6 +103,26 @@ public:
         }
         // we need to call solve as otherwise an EventHandler exception is thrown
         bidomain_problem.Solve();
+
+        // All bath nodes share a single bath cell, and contribute no ionic
+        // current or stimulus
+        AbstractCardiacTissue<1>* p_tissue = bidomain_problem.GetTissue();
+        AbstractCardiacCellInterface* p_bath_cell = NULL;
+        for (unsigned i=0; i<11; i++)
+        {
+            if (p_mesh->GetDistributedVectorFactory()->IsGlobalIndexLocal(i) && expected_node_regions[i] == 'B')
+            {
+                AbstractCardiacCellInterface* p_cell = p_tissue->GetCardiacCell(i);
+                TS_ASSERT(dynamic_cast<FakeBathCell*>(p_cell) != NULL);
+                if (p_bath_cell == NULL)
+                {
+                    p_bath_cell = p_cell;
+                }
+                TS_ASSERT_EQUALS(p_cell, p_bath_cell);
+                TS_ASSERT_EQUALS(p_tissue->rGetIionicCacheReplicated()[i], 0.0);
+                TS_ASSERT_EQUALS(p_tissue->rGetIntracellularStimulusCacheReplicated()[i], 0.0);
+            }
+        }
     }
 
 
@@ -0,0 +1,481 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTCARDIACCELLBATCH_HPP_
+#define TESTCARDIACCELLBATCH_HPP_
+
+#include <cxxtest/TestSuite.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+#include "FitzHughNagumo1961CellBatch.hpp"
+#include "FitzHughNagumo1961OdeSystem.hpp"
+#include "LuoRudy1991.hpp"
+#include "LuoRudy1991Opt.hpp"
+#include "AbstractRushLarsenCardiacCell.hpp" // Needed for chaste_libs=0 build
+#include "EulerIvpOdeSolver.hpp"
+#include "RungeKutta4IvpOdeSolver.hpp"
+#include "SimpleStimulus.hpp"
+#include "ZeroStimulus.hpp"
+#include "HeartConfig.hpp"
+#include "CellMLToSharedLibraryConverter.hpp"
+#include "DynamicCellModelLoader.hpp"
+#include "FileFinder.hpp"
+#include "OutputFileHandler.hpp"
+
+//This test is always run sequentially (never in parallel)
+#include "FakePetscSetup.hpp"
+
+class TestCardiacCellBatch : public CxxTest::TestSuite
+{
+private:
+    void CompareBatchWithIndividualCells(bool updateVoltage)
+    {
+        boost::shared_ptr<EulerIvpOdeSolver> p_solver(new EulerIvpOdeSolver);
+        boost::shared_ptr<SimpleStimulus> p_stimulus(new SimpleStimulus(-0.8, 0.5, 0.1));
+        boost::shared_ptr<ZeroStimulus> p_zero_stimulus(new ZeroStimulus);
+
+        const unsigned num_cells = 5u;
+        std::vector<AbstractCardiacCellInterface*> individual_cells;
+        std::vector<AbstractCardiacCellInterface*> batched_cells;
+        for (unsigned i=0; i<num_cells; i++)
+        {
+            boost::shared_ptr<AbstractStimulusFunction> p_stim;
+            if (i%2 == 0)
+            {
+                p_stim = p_stimulus;
+            }
+            else
+            {
+                p_stim = p_zero_stimulus;
+            }
+            individual_cells.push_back(new FitzHughNagumo1961OdeSystem(p_solver, p_stim));
+            batched_cells.push_back(new FitzHughNagumo1961OdeSystem(p_solver, p_stim));
+            individual_cells[i]->SetVoltage(0.1*i);
+            batched_cells[i]->SetVoltage(0.1*i);
+        }
+
+        FitzHughNagumo1961CellBatch batch;
+        batch.SolveBatch(batched_cells, 0.0, 2.0, updateVoltage);
+
+        for (unsigned i=0; i<num_cells; i++)
+        {
+            if (updateVoltage)
+            {
+                individual_cells[i]->SolveAndUpdateState(0.0, 2.0);
+            }
+            else
+            {
+                individual_cells[i]->ComputeExceptVoltage(0.0, 2.0);
+            }
+            std::vector<double> expected = individual_cells[i]->GetStdVecStateVariables();
+            std::vector<double> actual = batched_cells[i]->GetStdVecStateVariables();
+            TS_ASSERT_EQUALS(actual.size(), expected.size());
+            for (unsigned k=0; k<expected.size(); k++)
+            {
+                TS_ASSERT_DELTA(actual[k], expected[k], 1e-12);
+            }
+            TS_ASSERT_DELTA(batched_cells[i]->GetIIonic(), individual_cells[i]->GetIIonic(), 1e-12);
+
+            delete individual_cells[i];
+            delete batched_cells[i];
+        }
+    }
+
+    /**
+     * Solve one set of cells individually, and the other (a copy) with the
+     * given batch, and check they end up in the same state. Cells are deleted.
+     */
+    void CheckBatchMatchesIndividualCells(AbstractCardiacCellBatch& rBatch,
+                                          std::vector<AbstractCardiacCellInterface*>& rIndividualCells,
+                                          std::vector<AbstractCardiacCellInterface*>& rBatchedCells,
+                                          double tEnd,
+                                          bool updateVoltage)
+    {
+        for (unsigned i=0; i<rBatchedCells.size(); i++)
+        {
+            TS_ASSERT(rBatch.IsCompatible(rBatchedCells[i]));
+        }
+        rBatch.SolveBatch(rBatchedCells, 0.0, tEnd, updateVoltage);
+
+        for (unsigned i=0; i<rIndividualCells.size(); i++)
+        {
+            if (updateVoltage)
+            {
+                rIndividualCells[i]->SolveAndUpdateState(0.0, tEnd);
+            }
+            else
+            {
+                rIndividualCells[i]->ComputeExceptVoltage(0.0, tEnd);
+            }
+            std::vector<double> expected = rIndividualCells[i]->GetStdVecStateVariables();
+            std::vector<double> actual = rBatchedCells[i]->GetStdVecStateVariables();
+            TS_ASSERT_EQUALS(actual.size(), expected.size());
+            for (unsigned k=0; k<expected.size(); k++)
+            {
+                TS_ASSERT_DELTA(actual[k], expected[k], 1e-9*std::max(1.0, fabs(expected[k])));
+            }
+            delete rIndividualCells[i];
+            delete rBatchedCells[i];
+        }
+    }
+
+public:
+    void TestFitzHughNagumoBatchMatchesIndividualCells()
+    {
+        HeartConfig::Instance()->Reset();
+        CompareBatchWithIndividualCells(true);
+        CompareBatchWithIndividualCells(false);
+    }
+
+    void TestResidentStateInSinglePrecision()
+    {
+        HeartConfig::Instance()->Reset();
+        boost::shared_ptr<EulerIvpOdeSolver> p_solver(new EulerIvpOdeSolver);
+        boost::shared_ptr<SimpleStimulus> p_stimulus(new SimpleStimulus(-0.8, 0.5, 0.1));
+
+        const unsigned num_cells = 4u;
+        std::vector<AbstractCardiacCellInterface*> double_cells;
+        std::vector<AbstractCardiacCellInterface*> single_cells;
+        std::vector<double> double_voltages(num_cells);
+        std::vector<double> single_voltages(num_cells);
+        for (unsigned i=0; i<num_cells; i++)
+        {
+            double_cells.push_back(new FitzHughNagumo1961OdeSystem(p_solver, p_stimulus));
+            single_cells.push_back(new FitzHughNagumo1961OdeSystem(p_solver, p_stimulus));
+            double_voltages[i] = single_voltages[i] = 0.1*i;
+        }
+
+        FitzHughNagumo1961CellBatch double_batch;
+        double_batch.SetKeepStateResident();
+        FitzHughNagumo1961CellBatch single_batch;
+        single_batch.SetKeepStateResident();
+        TS_ASSERT(!single_batch.GetResidentStateInSinglePrecision());
+        single_batch.SetResidentStateInSinglePrecision();
+        TS_ASSERT(single_batch.GetResidentStateInSinglePrecision());
+
+        std::vector<double> double_i_ionic;
+        std::vector<double> single_i_ionic;
+        for (unsigned step=0; step<8; step++)
+        {
+            const double time = 0.25*step;
+            double_batch.SolveResidentBatch(0u, double_cells, double_voltages, double_i_ionic, time, time+0.25, true);
+            single_batch.SolveResidentBatch(0u, single_cells, single_voltages, single_i_ionic, time, time+0.25, true);
+            for (unsigned i=0; i<num_cells; i++)
+            {
+                TS_ASSERT_DELTA(single_voltages[i], double_voltages[i], 1e-5);
+                TS_ASSERT_DELTA(single_i_ionic[i], double_i_ionic[i], 1e-5);
+            }
+        }
+
+        // The state written back to the cells is rounded to single precision
+        single_batch.ClearResidentState();
+        double_batch.ClearResidentState();
+        for (unsigned i=0; i<num_cells; i++)
+        {
+            std::vector<double> expected = double_cells[i]->GetStdVecStateVariables();
+            std::vector<double> actual = single_cells[i]->GetStdVecStateVariables();
+            TS_ASSERT_EQUALS(actual.size(), expected.size());
+            for (unsigned k=0; k<expected.size(); k++)
+            {
+                TS_ASSERT_DELTA(actual[k], expected[k], 1e-5);
+                TS_ASSERT_EQUALS(actual[k], (double)(float)actual[k]);
+            }
+            delete double_cells[i];
+            delete single_cells[i];
+        }
+    }
+
+    void TestWritingBackResidentCells()
+    {
+        HeartConfig::Instance()->Reset();
+        boost::shared_ptr<EulerIvpOdeSolver> p_solver(new EulerIvpOdeSolver);
+        boost::shared_ptr<SimpleStimulus> p_stimulus(new SimpleStimulus(-0.8, 0.5, 0.1));
+
+        const unsigned num_cells = 4u;
+        std::vector<AbstractCardiacCellInterface*> reference_cells;
+        std::vector<AbstractCardiacCellInterface*> resident_cells;
+        std::vector<double> reference_voltages(num_cells);
+        std::vector<double> resident_voltages(num_cells);
+        for (unsigned i=0; i<num_cells; i++)
+        {
+            reference_cells.push_back(new FitzHughNagumo1961OdeSystem(p_solver, p_stimulus));
+            resident_cells.push_back(new FitzHughNagumo1961OdeSystem(p_solver, p_stimulus));
+            reference_voltages[i] = resident_voltages[i] = 0.1*i;
+        }
+        const std::vector<double> initial_state = resident_cells[2]->GetStdVecStateVariables();
+
+        // The reference batch is flushed completely whenever the cells are looked at
+        FitzHughNagumo1961CellBatch reference_batch;
+        reference_batch.SetKeepStateResident();
+        FitzHughNagumo1961CellBatch resident_batch;
+        resident_batch.SetKeepStateResident();
+
+        std::vector<double> reference_i_ionic;
+        std::vector<double> resident_i_ionic;
+        for (unsigned step=0; step<4; step++)
+        {
+            const double time = 0.25*step;
+            reference_batch.SolveResidentBatch(0u, reference_cells, reference_voltages, reference_i_ionic, time, time+0.25, true);
+            resident_batch.SolveResidentBatch(0u, resident_cells, resident_voltages, resident_i_ionic, time, time+0.25, true);
+        }
+
+        // Only the cell written back is brought up to date
+        resident_batch.WriteBackResidentCell(resident_cells[1]);
+        reference_batch.ClearResidentState();
+        std::vector<double> expected = reference_cells[1]->GetStdVecStateVariables();
+        std::vector<double> actual = resident_cells[1]->GetStdVecStateVariables();
+        for (unsigned k=0; k<expected.size(); k++)
+        {
+            TS_ASSERT_DELTA(actual[k], expected[k], 1e-12);
+        }
+        actual = resident_cells[2]->GetStdVecStateVariables();
+        for (unsigned k=0; k<initial_state.size(); k++)
+        {
+            TS_ASSERT_EQUALS(actual[k], initial_state[k]);
+        }
+
+        // Changes to it are picked up by the next solve, and writing it back again doesn't undo them
+        reference_cells[1]->SetStateVariable(1u, 0.1);
+        resident_cells[1]->SetStateVariable(1u, 0.1);
+        resident_batch.WriteBackResidentCell(resident_cells[1]);
+        reference_batch.SolveResidentBatch(0u, reference_cells, reference_voltages, reference_i_ionic, 1.0, 1.25, true);
+        resident_batch.SolveResidentBatch(0u, resident_cells, resident_voltages, resident_i_ionic, 1.0, 1.25, true);
+        for (unsigned i=0; i<num_cells; i++)
+        {
+            TS_ASSERT_DELTA(resident_voltages[i], reference_voltages[i], 1e-12);
+            TS_ASSERT_DELTA(resident_i_ionic[i], reference_i_ionic[i], 1e-12);
+        }
+
+        // The same for every cell at once
+        resident_batch.WriteBackAndRereadResidentState();
+        reference_batch.ClearResidentState();
+        for (unsigned i=0; i<num_cells; i++)
+        {
+            expected = reference_cells[i]->GetStdVecStateVariables();
+            actual = resident_cells[i]->GetStdVecStateVariables();
+            for (unsigned k=0; k<expected.size(); k++)
+            {
+                TS_ASSERT_DELTA(actual[k], expected[k], 1e-12);
+            }
+            reference_cells[i]->SetStateVariable(1u, 0.05*i);
+            resident_cells[i]->SetStateVariable(1u, 0.05*i);
+        }
+        reference_batch.SolveResidentBatch(0u, reference_cells, reference_voltages, reference_i_ionic, 1.25, 1.5, true);
+        resident_batch.SolveResidentBatch(0u, resident_cells, resident_voltages, resident_i_ionic, 1.25, 1.5, true);
+
+        reference_batch.ClearResidentState();
+        resident_batch.ClearResidentState();
+        for (unsigned i=0; i<num_cells; i++)
+        {
+            TS_ASSERT_DELTA(resident_i_ionic[i], reference_i_ionic[i], 1e-12);
+            expected = reference_cells[i]->GetStdVecStateVariables();
+            actual = resident_cells[i]->GetStdVecStateVariables();
+            for (unsigned k=0; k<expected.size(); k++)
+            {
+                TS_ASSERT_DELTA(actual[k], expected[k], 1e-12);
+            }
+            delete reference_cells[i];
+            delete resident_cells[i];
+        }
+    }
+
+    void TestCompatibilityAndSettings()
+    {
+        HeartConfig::Instance()->Reset();
+        boost::shared_ptr<EulerIvpOdeSolver> p_solver(new EulerIvpOdeSolver);
+        boost::shared_ptr<ZeroStimulus> p_stimulus(new ZeroStimulus);
+        FitzHughNagumo1961OdeSystem fhn_cell(p_solver, p_stimulus);
+        CellLuoRudy1991FromCellML lr91_cell(p_solver, p_stimulus);
+
+        FitzHughNagumo1961CellBatch batch(16u);
+        TS_ASSERT_EQUALS(batch.GetMaxBatchSize(), 16u);
+        TS_ASSERT(batch.IsCompatible(&fhn_cell));
+        TS_ASSERT(!batch.IsCompatible(&lr91_cell));
+
+        // Cells which would be solved differently on their own are not compatible
+        boost::shared_ptr<RungeKutta4IvpOdeSolver> p_rk4_solver(new RungeKutta4IvpOdeSolver);
+        FitzHughNagumo1961OdeSystem rk4_cell(p_rk4_solver, p_stimulus);
+        TS_ASSERT(!batch.IsCompatible(&rk4_cell));
+        FitzHughNagumo1961OdeSystem large_dt_cell(p_solver, p_stimulus);
+        large_dt_cell.SetTimestep(0.1);
+        TS_ASSERT(!batch.IsCompatible(&large_dt_cell));
+
+        // An empty batch is a no-op
+        std::vector<AbstractCardiacCellInterface*> no_cells;
+        TS_ASSERT_THROWS_NOTHING(batch.SolveBatch(no_cells, 0.0, 1.0, true));
+
+        // A larger time step gives a different answer from the default one
+        std::vector<AbstractCardiacCellInterface*> cells(1u, &fhn_cell);
+        fhn_cell.SetVoltage(0.5);
+        batch.SetTimestep(0.1);
+        TS_ASSERT(!batch.IsCompatible(&fhn_cell));
+        TS_ASSERT(batch.IsCompatible(&large_dt_cell));
+        fhn_cell.SetTimestep(0.1);
+        batch.SolveBatch(cells, 0.0, 1.0, true);
+        double v_large_dt = fhn_cell.GetVoltage();
+
+        fhn_cell.SetStateVariables(fhn_cell.GetInitialConditions());
+        fhn_cell.SetVoltage(0.5);
+        batch.SetTimestep(HeartConfig::Instance()->GetOdeTimeStep());
+        fhn_cell.SetTimestep(HeartConfig::Instance()->GetOdeTimeStep());
+        batch.SolveBatch(cells, 0.0, 1.0, true);
+        TS_ASSERT_DIFFERS(fhn_cell.GetVoltage(), v_large_dt);
+        TS_ASSERT_DELTA(fhn_cell.GetVoltage(), v_large_dt, 1e-2);
+    }
+
+    void TestGeneratedBatchesMatchIndividualCells()
+    {
+        // The batch classes are generated by PyCml along with the cell models (--batch)
+        HeartConfig::Instance()->Reset();
+        boost::shared_ptr<EulerIvpOdeSolver> p_solver(new EulerIvpOdeSolver);
+        boost::shared_ptr<SimpleStimulus> p_stimulus(new SimpleStimulus(-25.5, 2.0, 1.0));
+        boost::shared_ptr<ZeroStimulus> p_zero_stimulus(new ZeroStimulus);
+
+        for (unsigned update_voltage=0; update_voltage<2; update_voltage++)
+        {
+            for (unsigned opt=0; opt<2; opt++)
+            {
+                const unsigned num_cells = 5u;
+                std::vector<AbstractCardiacCellInterface*> individual_cells;
+                std::vector<AbstractCardiacCellInterface*> batched_cells;
+                for (unsigned i=0; i<num_cells; i++)
+                {
+                    boost::shared_ptr<AbstractStimulusFunction> p_stim;
+                    if (i%2 == 0)
+                    {
+                        p_stim = p_stimulus;
+                    }
+                    else
+                    {
+                        p_stim = p_zero_stimulus;
+                    }
+                    for (unsigned copy=0; copy<2; copy++)
+                    {
+                        AbstractCardiacCellInterface* p_cell;
+                        if (opt)
+                        {
+                            p_cell = new CellLuoRudy1991FromCellMLOpt(p_solver, p_stim);
+                        }
+                        else
+                        {
+                            p_cell = new CellLuoRudy1991FromCellML(p_solver, p_stim);
+                        }
+                        // Each cell has its own parameter values
+                        p_cell->SetParameter("membrane_fast_sodium_current_conductance",
+                                             p_cell->GetParameter("membrane_fast_sodium_current_conductance")*(1.0 - 0.1*i));
+                        p_cell->SetVoltage(p_cell->GetVoltage() + i);
+                        if (copy)
+                        {
+                            batched_cells.push_back(p_cell);
+                        }
+                        else
+                        {
+                            individual_cells.push_back(p_cell);
+                        }
+                    }
+                }
+
+                if (opt)
+                {
+                    CellLuoRudy1991FromCellMLOptBatch batch;
+                    CellLuoRudy1991FromCellML normal_cell(p_solver, p_stimulus);
+                    TS_ASSERT(!batch.IsCompatible(&normal_cell));
+                    CheckBatchMatchesIndividualCells(batch, individual_cells, batched_cells, 10.0, update_voltage);
+                }
+                else
+                {
+                    CellLuoRudy1991FromCellMLBatch batch;
+                    CellLuoRudy1991FromCellMLOpt opt_cell(p_solver, p_stimulus);
+                    TS_ASSERT(!batch.IsCompatible(&opt_cell));
+                    CheckBatchMatchesIndividualCells(batch, individual_cells, batched_cells, 10.0, update_voltage);
+                }
+            }
+        }
+    }
+
+    void TestGeneratedRushLarsenBatch()
+    {
+        HeartConfig::Instance()->Reset();
+
+        // Generate a Rush-Larsen Luo-Rudy cell with a batch
+        CellMLToSharedLibraryConverter converter(true);
+        OutputFileHandler handler("TestCardiacCellBatch");
+        FileFinder cellml_file("heart/src/odes/cellml/LuoRudy1991.cellml", RelativeTo::ChasteSourceRoot);
+        FileFinder copied_file = handler.CopyFileTo(cellml_file);
+        std::vector<std::string> args;
+        args.push_back("--rush-larsen");
+        args.push_back("--batch");
+        converter.CreateOptionsFile(handler, "LuoRudy1991", args);
+        DynamicCellModelLoaderPtr p_loader = converter.Convert(copied_file);
+        TS_ASSERT(p_loader->HasCellBatch());
+
+        boost::shared_ptr<AbstractIvpOdeSolver> p_no_solver;
+        boost::shared_ptr<SimpleStimulus> p_stimulus(new SimpleStimulus(-25.5, 2.0, 1.0));
+        for (unsigned update_voltage=0; update_voltage<2; update_voltage++)
+        {
+            const unsigned num_cells = 3u;
+            std::vector<AbstractCardiacCellInterface*> individual_cells;
+            std::vector<AbstractCardiacCellInterface*> batched_cells;
+            for (unsigned i=0; i<2*num_cells; i++)
+            {
+                AbstractCardiacCellInterface* p_cell = p_loader->CreateCell(p_no_solver, p_stimulus);
+                p_cell->SetVoltage(p_cell->GetVoltage() + (i/2));
+                if (i%2)
+                {
+                    batched_cells.push_back(p_cell);
+                }
+                else
+                {
+                    individual_cells.push_back(p_cell);
+                }
+            }
+
+            boost::shared_ptr<AbstractCardiacCellBatch> p_batch(p_loader->CreateCellBatch());
+            // Rush-Larsen cells have no ODE solver, but must still use the batch's time step
+            TS_ASSERT(p_batch->IsCompatible(batched_cells[0]));
+            p_batch->SetTimestep(0.5*HeartConfig::Instance()->GetOdeTimeStep());
+            TS_ASSERT(!p_batch->IsCompatible(batched_cells[0]));
+            p_batch->SetTimestep(HeartConfig::Instance()->GetOdeTimeStep());
+
+            CheckBatchMatchesIndividualCells(*p_batch, individual_cells, batched_cells, 10.0, update_voltage);
+        }
+    }
+};
+
+#endif // TESTCARDIACCELLBATCH_HPP_
@@ -0,0 +1,124 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTCARDIACNEWTONSOLVER_HPP_
+#define TESTCARDIACNEWTONSOLVER_HPP_
+
+#include <cxxtest/TestSuite.h>
+
+#include <vector>
+
+#include "CardiacNewtonSolver.hpp"
+
+//This test is always run sequentially (never in parallel)
+#include "FakePetscSetup.hpp"
+
+/**
+ * A stand-in for a backward Euler cell, with the residual
+ *   r_0 = x_0^2 + x_1 - a,  r_1 = x_0 + x_1^3 - b
+ */
+class SimpleNewtonSystem
+{
+private:
+    double mA;
+    double mB;
+
+public:
+    SimpleNewtonSystem(double a, double b)
+        : mA(a), mB(b)
+    {}
+
+    void ComputeResidual(double time, const double rCurrentGuess[2], double rResidual[2])
+    {
+        rResidual[0] = rCurrentGuess[0]*rCurrentGuess[0] + rCurrentGuess[1] - mA;
+        rResidual[1] = rCurrentGuess[0] + rCurrentGuess[1]*rCurrentGuess[1]*rCurrentGuess[1] - mB;
+    }
+
+    void ComputeJacobian(double time, const double rCurrentGuess[2], double rJacobian[2][2])
+    {
+        rJacobian[0][0] = 2.0*rCurrentGuess[0];
+        rJacobian[0][1] = 1.0;
+        rJacobian[1][0] = 1.0;
+        rJacobian[1][1] = 3.0*rCurrentGuess[1]*rCurrentGuess[1];
+    }
+};
+
+class TestCardiacNewtonSolver : public CxxTest::TestSuite
+{
+public:
+    void TestSolveAndSolveBatchAgree()
+    {
+        // Solutions (x_0, x_1) = (1+c/10, 1+c/20) for a range of cells
+        const unsigned num_cells = 7;
+        std::vector<SimpleNewtonSystem> systems;
+        for (unsigned c=0; c<num_cells; c++)
+        {
+            double x0 = 1.0 + c/10.0;
+            double x1 = 1.0 + c/20.0;
+            systems.push_back(SimpleNewtonSystem(x0*x0 + x1, x0 + x1*x1*x1));
+        }
+        std::vector<SimpleNewtonSystem*> cells;
+        for (unsigned c=0; c<num_cells; c++)
+        {
+            cells.push_back(&systems[c]);
+        }
+
+        CardiacNewtonSolver<2, SimpleNewtonSystem>* p_solver = CardiacNewtonSolver<2, SimpleNewtonSystem>::Instance();
+
+        // Guesses are stored as a structure of arrays
+        std::vector<double> batch_guesses(2*num_cells);
+        for (unsigned c=0; c<num_cells; c++)
+        {
+            batch_guesses[c] = 1.2;
+            batch_guesses[num_cells + c] = 0.9;
+        }
+        p_solver->SolveBatch(cells, 0.0, batch_guesses);
+
+        for (unsigned c=0; c<num_cells; c++)
+        {
+            double guess[2] = {1.2, 0.9};
+            p_solver->Solve(systems[c], 0.0, guess);
+
+            TS_ASSERT_DELTA(guess[0], 1.0 + c/10.0, 1e-8);
+            TS_ASSERT_DELTA(guess[1], 1.0 + c/20.0, 1e-8);
+
+            // Each cell takes the same iterations in the batch as on its own
+            TS_ASSERT_DELTA(batch_guesses[c], guess[0], 1e-12);
+            TS_ASSERT_DELTA(batch_guesses[num_cells + c], guess[1], 1e-12);
+        }
+    }
+};
+
+#endif /*TESTCARDIACNEWTONSOLVER_HPP_*/
@@ -96,8 +96,13 @@ public:
             double time = 100.0;
             TS_ASSERT_EQUALS(mpModel->GetExperimentalVoltageAtTimeT(time), DOUBLE_UNSET);
 
+            // The analytic Jacobian is used by default, but not while the data clamp is on
+            TS_ASSERT_EQUALS(mpModel->HasAnalyticJacobian(), true);
+            TS_ASSERT_EQUALS(mpModel->GetUseAnalyticJacobian(), true);
+
             // So now turn on the data clamp
             mpModel->TurnOnDataClamp();
+            TS_ASSERT_EQUALS(mpModel->GetUseAnalyticJacobian(), false);
 
 # if CHASTE_SUNDIALS_VERSION >= 20400
             double tol = 5e-3; // mV
@@ -108,6 +113,7 @@ public:
 
             // So turn it off again
             mpModel->TurnOffDataClamp();
+            TS_ASSERT_EQUALS(mpModel->GetUseAnalyticJacobian(), true);
             TS_ASSERT_DELTA(mpModel->GetParameter("membrane_data_clamp_current_conductance"), 0.0, 1e-12);
             mpModel->TurnOnDataClamp(200.0);
             TS_ASSERT_DELTA(mpModel->GetParameter("membrane_data_clamp_current_conductance"), 200.0, 1e-12);
@@ -37,6 +37,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define TESTDYNAMICALLYLOADEDCELLMODELS_HPP_
 
 #include <cxxtest/TestSuite.h>
+#include <map>
 #include <boost/assign.hpp>
 #include <boost/shared_ptr.hpp>
 
@@ -64,6 +65,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "AbstractDynamicallyLoadableEntity.hpp"
 #include "AbstractCardiacCellInterface.hpp"
+#include "AbstractUntemplatedParameterisedSystem.hpp"
 #include "AbstractCvodeCell.hpp"
 
 #include "PetscSetupAndFinalize.hpp"
@@ -253,6 +255,7 @@ public:
         DynamicCellModelLoaderPtr p_loader2 = converter.Convert(so_file);
         TS_ASSERT(so_file.Exists());
         TS_ASSERT(p_loader2 == p_loader);
+        TS_ASSERT_EQUALS(p_loader2->GetLoadableModulePath(), so_file.GetAbsolutePath());
         RunLr91Test(*p_loader, 0u);
 
         // Cover exceptions
@@ -367,6 +370,67 @@ public:
 #endif
     }
 
+    void TestCellmlConverterWithFixedParameters()
+    {
+        std::string model = "LuoRudy1991";
+        OutputFileHandler handler("TestCellmlConverterWithFixedParameters");
+        FileFinder cellml_file("heart/src/odes/cellml/" + model + ".cellml", RelativeTo::ChasteSourceRoot);
+        FileFinder copied_file = handler.CopyFileTo(cellml_file);
+
+        // Fix the sodium conductance at its default value, so results are unchanged
+        std::map<std::string, double> fixed_parameters;
+        fixed_parameters["membrane_fast_sodium_current_conductance"] = 23.0;
+        CellMLToSharedLibraryConverter converter;
+        converter.CreateSpecialisedOptionsFile(handler, model, fixed_parameters);
+        DynamicCellModelLoaderPtr p_loader = converter.Convert(copied_file);
+
+        AbstractCardiacCellInterface* p_cell = CreateLr91CellFromLoader(*p_loader, 0u);
+        AbstractUntemplatedParameterisedSystem* p_system = dynamic_cast<AbstractUntemplatedParameterisedSystem*>(p_cell);
+        TS_ASSERT(p_system);
+        TS_ASSERT(!p_system->HasParameter("membrane_fast_sodium_current_conductance"));
+        TS_ASSERT(p_system->HasParameter("membrane_L_type_calcium_current_conductance"));
+        SimulateLr91AndCompare(p_cell, 0.01);
+        delete p_cell;
+    }
+
+    void TestCellmlConverterWithModelCache()
+    {
+        std::string dirname = "TestCellmlConverterWithModelCache";
+        OutputFileHandler handler(dirname);
+        FileFinder cache_folder = handler.FindFile("cache");
+        setenv("CHASTE_MODEL_CACHE", cache_folder.GetAbsolutePath().c_str(), 1);
+        TS_ASSERT_EQUALS(CellMLToSharedLibraryConverter::GetModelCacheFolder().GetAbsolutePath(), cache_folder.GetAbsolutePath());
+
+        FileFinder cellml_file_src("heart/dynamic/luo_rudy_1991_dyn.cellml", RelativeTo::ChasteSourceRoot);
+        CellMLToSharedLibraryConverter converter;
+
+        // The first conversion compiles the model and stores it in the cache
+        OutputFileHandler handler1(dirname + "/first");
+        FileFinder cellml_file1 = handler1.CopyFileTo(cellml_file_src);
+        DynamicCellModelLoaderPtr p_loader = converter.Convert(cellml_file1);
+        TS_ASSERT(handler1.FindFile("libluo_rudy_1991_dyn." + CellMLToSharedLibraryConverter::msSoSuffix).Exists());
+        std::vector<FileFinder> entries = cache_folder.FindMatches("luo_rudy_1991_dyn_*");
+        TS_ASSERT_EQUALS(entries.size(), 1u);
+        RunLr91Test(*p_loader, 0u);
+
+        // A copy of the same model elsewhere is loaded from the cache, so doesn't need a collective call
+        OutputFileHandler handler2(dirname + "/second");
+        FileFinder cellml_file2 = handler2.CopyFileTo(cellml_file_src);
+        DynamicCellModelLoaderPtr p_loader2;
+        TS_ASSERT_THROWS_NOTHING(p_loader2 = converter.Convert(cellml_file2, false));
+        TS_ASSERT(!handler2.FindFile("libluo_rudy_1991_dyn." + CellMLToSharedLibraryConverter::msSoSuffix).Exists());
+        TS_ASSERT_EQUALS(p_loader2->GetLoadableModulePath(),
+                         entries[0].GetAbsolutePath() + "libluo_rudy_1991_dyn." + CellMLToSharedLibraryConverter::msSoSuffix);
+
+        // A different component is a different cache entry, which doesn't exist yet
+        CellMLToSharedLibraryConverter other_converter(false, "not_a_project");
+        TS_ASSERT_THROWS_THIS(other_converter.Convert(cellml_file2, false),
+                              "Unable to convert .cellml to .so unless called collectively, due to possible race conditions.");
+
+        unsetenv("CHASTE_MODEL_CACHE");
+        TS_ASSERT(!CellMLToSharedLibraryConverter::GetModelCacheFolder().IsPathSet());
+    }
+
     void TestArchiving()
     {
 #ifdef CHASTE_CAN_CHECKPOINT_DLLS
@@ -390,6 +390,17 @@ public:
         TS_ASSERT_DELTA(another_fhn61_ode_system.GetStimulus(0.5), -100, 1e-12);
         TS_ASSERT_DELTA(another_fhn61_ode_system.GetIntracellularStimulus(0.5), -100, 1e-12);
 
+        // A stimulus value given for an interval is only used within that interval, and only
+        // if it came from the cell's current stimulus (the value here differs from the real one
+        // just to show which is used)
+        TS_ASSERT(!another_fhn61_ode_system.SetIntracellularStimulusOver(p_another_stimulus.get(), 0.0, 1.0, -50.0));
+        TS_ASSERT_DELTA(another_fhn61_ode_system.GetIntracellularStimulus(0.5), -100, 1e-12);
+        TS_ASSERT(another_fhn61_ode_system.SetIntracellularStimulusOver(p_intra_stimulus.get(), 0.0, 1.0, -50.0));
+        TS_ASSERT_DELTA(another_fhn61_ode_system.GetIntracellularStimulus(0.5), -50, 1e-12);
+        TS_ASSERT_DELTA(another_fhn61_ode_system.GetIntracellularStimulus(1.5), 0, 1e-12);
+        another_fhn61_ode_system.SetIntracellularStimulusFunction(p_intra_stimulus);
+        TS_ASSERT_DELTA(another_fhn61_ode_system.GetIntracellularStimulus(0.5), -100, 1e-12);
+
         TS_ASSERT_EQUALS(another_fhn61_ode_system.HasCellMLDefaultStimulus(),false);
         TS_ASSERT_THROWS_THIS(another_fhn61_ode_system.UseCellMLDefaultStimulus(),"This class has no default stimulus from CellML metadata.");
 
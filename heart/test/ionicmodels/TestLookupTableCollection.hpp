@@ -0,0 +1,163 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTLOOKUPTABLECOLLECTION_HPP_
+#define TESTLOOKUPTABLECOLLECTION_HPP_
+
+#include <cxxtest/TestSuite.h>
+
+#include "AbstractLookupTableCollection.hpp"
+#include "PetscTools.hpp"
+
+#include "PetscSetupAndFinalize.hpp"
+
+/**
+ * A hand-written collection laid out in the same way as those generated by PyCml,
+ * with two tables (V and V^2) keyed by "V".
+ */
+class SquaresLookupTables : public AbstractLookupTableCollection
+{
+private:
+    /** The tables. */
+    double (*_lookup_table_0)[2];
+
+public:
+    SquaresLookupTables()
+        : _lookup_table_0(NULL)
+    {
+        mKeyingVariableNames.assign(1u, "V");
+        mNumberOfTables.assign(1u, 2u);
+        mTableMins.assign(1u, -100.0);
+        mTableSteps.assign(1u, 0.5);
+        mTableStepInverses.assign(1u, 2.0);
+        mTableMaxs.assign(1u, 100.0);
+        mNeedsRegeneration.assign(1u, true);
+        RegenerateTables();
+    }
+
+    ~SquaresLookupTables()
+    {
+        FreeMemory();
+    }
+
+    void RegenerateTables()
+    {
+        if (mNeedsRegeneration[0])
+        {
+            const unsigned _table_size_0 = 1 + (unsigned)((mTableMaxs[0]-mTableMins[0])/mTableSteps[0]+0.5);
+            _lookup_table_0 = reinterpret_cast<double(*)[2]>(AllocateTableMemory(0, _table_size_0*2));
+            if (IsTableGenerator(0))
+            {
+                for (unsigned i=0; i<_table_size_0; i++)
+                {
+                    const double var_V = mTableMins[0] + i*mTableSteps[0];
+                    _lookup_table_0[i][0] = var_V;
+                    _lookup_table_0[i][1] = var_V*var_V;
+                }
+            }
+            TableGenerationFinished(0);
+            mNeedsRegeneration[0] = false;
+        }
+    }
+
+    void FreeMemory()
+    {
+        FreeTableMemory(0);
+        _lookup_table_0 = NULL;
+        mNeedsRegeneration.assign(mNeedsRegeneration.size(), true);
+    }
+
+    double Lookup(unsigned tableIndex, double V)
+    {
+        unsigned i = (unsigned)((V-mTableMins[0])*mTableStepInverses[0]);
+        return _lookup_table_0[i][tableIndex];
+    }
+};
+
+class TestLookupTableCollection : public CxxTest::TestSuite
+{
+private:
+    void CheckTables(SquaresLookupTables& rTables)
+    {
+        for (double v=-100.0; v<99.0; v+=6.5)
+        {
+            TS_ASSERT_DELTA(rTables.Lookup(0u, v), v, 1e-12);
+            TS_ASSERT_DELTA(rTables.Lookup(1u, v), v*v, 1e-10);
+        }
+    }
+
+public:
+    void TestPrivateTables()
+    {
+        TS_ASSERT(!AbstractLookupTableCollection::GetUseNodeSharedMemory());
+        SquaresLookupTables tables;
+        TS_ASSERT(!tables.IsTableMemoryShared("V"));
+        TS_ASSERT_THROWS_THIS(tables.IsTableMemoryShared("Cai"),
+                              "Lookup table keying variable 'Cai' does not exist.");
+        CheckTables(tables);
+
+        // Changing the spacing regenerates the (single) set of tables
+        tables.SetTableProperties("V", -100.0, 0.25, 100.0);
+        tables.RegenerateTables();
+        CheckTables(tables);
+
+        tables.FreeMemory();
+        tables.RegenerateTables();
+        CheckTables(tables);
+    }
+
+    void TestNodeSharedTables()
+    {
+        AbstractLookupTableCollection::SetUseNodeSharedMemory();
+        TS_ASSERT(AbstractLookupTableCollection::GetUseNodeSharedMemory());
+        {
+            SquaresLookupTables tables;
+#if MPI_VERSION >= 3
+            TS_ASSERT_EQUALS(tables.IsTableMemoryShared("V"), PetscTools::IsParallel());
+#else
+            TS_ASSERT(!tables.IsTableMemoryShared("V"));
+#endif
+            // Every process sees the tables, whoever generated them
+            CheckTables(tables);
+
+            tables.SetTableProperties("V", -100.0, 0.25, 100.0);
+            tables.RegenerateTables();
+            CheckTables(tables);
+        }
+        AbstractLookupTableCollection::SetUseNodeSharedMemory(false);
+    }
+};
+
+#endif // TESTLOOKUPTABLECOLLECTION_HPP_
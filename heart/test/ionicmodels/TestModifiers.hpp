@@ -92,12 +92,19 @@ public:
         boost::shared_ptr<AbstractModifier> p_new_modifier(new FixedModifier(-90.0));
 
         TS_ASSERT_THROWS_THIS(p_shannon->SetModifier("Alan",p_new_modifier), "There is no modifier called Alan in this model.");
+        TS_ASSERT_EQUALS(p_shannon->AreModifiersActive(), false);
 
         // Assign it to the Shannon model
         p_shannon->SetModifier("membrane_rapid_delayed_rectifier_potassium_current_conductance",p_new_modifier);
 
         // We should now get a new answer to this.
         TS_ASSERT_DELTA(p_shannon->GetModifier("membrane_rapid_delayed_rectifier_potassium_current_conductance")->Calc(0,0),-90,1e-9);
+        TS_ASSERT_EQUALS(p_shannon->AreModifiersActive(), true);
+
+        // Going back to a dummy modifier switches modifiers off again
+        boost::shared_ptr<AbstractModifier> p_dummy_modifier(new DummyModifier);
+        p_shannon->SetModifier("membrane_rapid_delayed_rectifier_potassium_current_conductance",p_dummy_modifier);
+        TS_ASSERT_EQUALS(p_shannon->AreModifiersActive(), false);
 
         delete p_shannon;
     }
@@ -148,6 +155,24 @@ public:
         }
     }
 
+    void TestInlineApply(void)
+    {
+        DummyModifier dummy;
+        FactorModifier factor(2.5);
+        FixedModifier fixed(-3.0);
+        TimeModifier time_modifier;
+        TS_ASSERT_EQUALS(dummy.GetInlineKind(), AbstractModifier::IDENTITY);
+        TS_ASSERT_EQUALS(factor.GetInlineKind(), AbstractModifier::FACTOR);
+        TS_ASSERT_EQUALS(fixed.GetInlineKind(), AbstractModifier::FIXED);
+        TS_ASSERT_EQUALS(time_modifier.GetInlineKind(), AbstractModifier::GENERAL);
+
+        AbstractModifier* modifiers[4] = {&dummy, &factor, &fixed, &time_modifier};
+        for (unsigned i=0; i<4; i++)
+        {
+            TS_ASSERT_EQUALS(modifiers[i]->Apply(7.0, 0.3), modifiers[i]->Calc(7.0, 0.3));
+        }
+    }
+
     void TestArchivingModifiers(void)
     {
         //Archive
@@ -200,6 +225,8 @@ public:
             TS_ASSERT_DELTA(p_dummy ->Calc(param, time), param,           1e-12); // Dummy doesn't do anything.
             TS_ASSERT_DELTA(p_factor->Calc(param, time), factor*param,    1e-12); // Factor gives back a multiple
             TS_ASSERT_DELTA(p_fixed ->Calc(param, time), fixed_value,     1e-12); // Fixed gives back a fixed value
+            TS_ASSERT_DELTA(p_factor->Apply(param, time), factor*param,    1e-12); // The inline values are restored too
+            TS_ASSERT_DELTA(p_fixed ->Apply(param, time), fixed_value,     1e-12);
             TS_ASSERT_DELTA(p_time  ->Calc(param, time), param*sin(time), 1e-12); // Time is an example of time dependent function
 
             delete p_dummy;
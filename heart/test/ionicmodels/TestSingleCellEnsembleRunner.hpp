@@ -0,0 +1,184 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef _TESTSINGLECELLENSEMBLERUNNER_HPP_
+#define _TESTSINGLECELLENSEMBLERUNNER_HPP_
+
+#include <cxxtest/TestSuite.h>
+
+#include <fstream>
+#include <sstream>
+
+#include "CellProperties.hpp"
+#include "EulerIvpOdeSolver.hpp"
+#include "FileFinder.hpp"
+#include "LuoRudy1991.hpp"
+#include "OdeSolution.hpp"
+#include "SimpleStimulus.hpp"
+#include "SingleCellEnsembleRunner.hpp"
+
+#include "PetscSetupAndFinalize.hpp"
+
+class TestSingleCellEnsembleRunner : public CxxTest::TestSuite
+{
+public:
+    void TestSodiumConductanceSweep()
+    {
+        boost::shared_ptr<SimpleStimulus> p_stimulus(new SimpleStimulus(-25.5, 2.0, 50.0));
+        boost::shared_ptr<EulerIvpOdeSolver> p_solver(new EulerIvpOdeSolver);
+        boost::shared_ptr<AbstractCardiacCellInterface> p_model(new CellLuoRudy1991FromCellML(p_solver, p_stimulus));
+        p_model->SetTimestep(0.01);
+
+        std::vector<std::string> parameter_names;
+        parameter_names.push_back("membrane_fast_sodium_current_conductance");
+
+        // Unknown parameters throw at construction
+        std::vector<std::string> bad_names(1, "not_a_parameter");
+        TS_ASSERT_THROWS_THIS(SingleCellEnsembleRunner bad_runner(p_model, bad_names),
+                              "No parameter named 'not_a_parameter'.");
+
+        SingleCellEnsembleRunner runner(p_model, parameter_names);
+        TS_ASSERT_THROWS_THIS(runner.AddParameterSet(std::vector<double>(2, 1.0)),
+                              "Parameter set has 2 values but 1 parameters are being varied.");
+        TS_ASSERT_THROWS_THIS(runner.Run("TestSingleCellEnsembleRunner", "results.dat"),
+                              "SetSimulationDuration() must be called before Run().");
+        TS_ASSERT_THROWS_THIS(runner.SetSimulationDuration(0.0, 0.1),
+                              "The simulation duration and sampling interval must be positive.");
+        TS_ASSERT_THROWS_THIS(runner.SetPrePacingDuration(-1.0),
+                              "The pre-pacing duration cannot be negative.");
+
+        const double g_na_values[] = {23.0, 16.0, 8.0};
+        for (unsigned i=0; i<3; i++)
+        {
+            runner.AddParameterSet(std::vector<double>(1, g_na_values[i]));
+        }
+        TS_ASSERT_EQUALS(runner.GetNumParameterSets(), 3u);
+
+        runner.SetPrePacingDuration(10.0);
+        runner.SetSimulationDuration(450.0, 0.1);
+        runner.Run("TestSingleCellEnsembleRunner", "results.dat");
+
+        // Compute the first parameter set directly for comparison
+        boost::shared_ptr<AbstractCardiacCellInterface> p_reference(new CellLuoRudy1991FromCellML(p_solver, p_stimulus));
+        p_reference->SetTimestep(0.01);
+        p_reference->SolveAndUpdateState(0.0, 10.0);
+        OdeSolution solution = p_reference->Compute(10.0, 460.0, 0.1);
+        std::vector<double> voltages = solution.GetVariableAtIndex(p_reference->GetVoltageIndex());
+        CellProperties properties(voltages, solution.rGetTimes());
+
+        FileFinder results_file("TestSingleCellEnsembleRunner/results.dat", RelativeTo::ChasteTestOutput);
+        TS_ASSERT(results_file.IsFile());
+        std::ifstream results(results_file.GetAbsolutePath().c_str());
+        std::string line;
+        std::getline(results, line);
+        TS_ASSERT_EQUALS(line, "# index\tmembrane_fast_sodium_current_conductance\tAPD90\tpeak_potential\tresting_potential\tmax_upstroke_velocity");
+
+        std::vector<double> upstroke_velocities;
+        for (unsigned i=0; i<3; i++)
+        {
+            TS_ASSERT(std::getline(results, line));
+            std::stringstream line_stream(line);
+            unsigned index;
+            double g_na, apd, peak, resting, upstroke;
+            line_stream >> index >> g_na >> apd >> peak >> resting >> upstroke;
+            TS_ASSERT_EQUALS(index, i);
+            TS_ASSERT_DELTA(g_na, g_na_values[i], 1e-12);
+            upstroke_velocities.push_back(upstroke);
+
+            if (i == 0)
+            {
+                TS_ASSERT_DELTA(apd, properties.GetLastActionPotentialDuration(90.0), 1e-6);
+                TS_ASSERT_DELTA(peak, properties.GetLastPeakPotential(), 1e-6);
+                TS_ASSERT_DELTA(resting, properties.GetLastRestingPotential(), 1e-6);
+                TS_ASSERT_DELTA(upstroke, properties.GetLastMaxUpstrokeVelocity(), 1e-6);
+            }
+        }
+        TS_ASSERT(!std::getline(results, line));
+
+        // Less sodium current gives a slower upstroke
+        TS_ASSERT_LESS_THAN(upstroke_velocities[1], upstroke_velocities[0]);
+        TS_ASSERT_LESS_THAN(upstroke_velocities[2], upstroke_velocities[1]);
+    }
+
+    void TestThreadedSweepMatchesSerialSweep()
+    {
+        boost::shared_ptr<SimpleStimulus> p_stimulus(new SimpleStimulus(-25.5, 2.0, 50.0));
+        std::vector<std::string> parameter_names;
+        parameter_names.push_back("membrane_fast_sodium_current_conductance");
+        const double g_na_values[] = {23.0, 20.0, 16.0, 12.0, 8.0};
+
+        for (unsigned run=0; run<2; run++)
+        {
+            boost::shared_ptr<EulerIvpOdeSolver> p_solver(new EulerIvpOdeSolver);
+            boost::shared_ptr<AbstractCardiacCellInterface> p_model(new CellLuoRudy1991FromCellML(p_solver, p_stimulus));
+            p_model->SetTimestep(0.01);
+
+            SingleCellEnsembleRunner runner(p_model, parameter_names);
+            TS_ASSERT_EQUALS(runner.GetNumberOfThreads(), 1u);
+            if (run == 1)
+            {
+                TS_ASSERT_THROWS_THIS(runner.SetNumberOfThreads(0u),
+                                      "The number of ensemble threads must be at least one.");
+                // Each thread runs its own copy of the model
+                runner.SetNumberOfThreads(3u);
+                TS_ASSERT_EQUALS(runner.GetNumberOfThreads(), 3u);
+            }
+            for (unsigned i=0; i<5; i++)
+            {
+                runner.AddParameterSet(std::vector<double>(1, g_na_values[i]));
+            }
+            runner.SetSimulationDuration(400.0, 0.1);
+            runner.Run("TestSingleCellEnsembleRunner", (run == 0) ? "serial.dat" : "threaded.dat");
+        }
+
+        // The results, and their order, are the same
+        FileFinder serial_file("TestSingleCellEnsembleRunner/serial.dat", RelativeTo::ChasteTestOutput);
+        FileFinder threaded_file("TestSingleCellEnsembleRunner/threaded.dat", RelativeTo::ChasteTestOutput);
+        std::ifstream serial_results(serial_file.GetAbsolutePath().c_str());
+        std::ifstream threaded_results(threaded_file.GetAbsolutePath().c_str());
+        std::string serial_line, threaded_line;
+        unsigned num_lines = 0;
+        while (std::getline(serial_results, serial_line))
+        {
+            TS_ASSERT(std::getline(threaded_results, threaded_line));
+            TS_ASSERT_EQUALS(threaded_line, serial_line);
+            num_lines++;
+        }
+        TS_ASSERT(!std::getline(threaded_results, threaded_line));
+        TS_ASSERT_EQUALS(num_lines, 6u);
+    }
+};
+
+#endif // _TESTSINGLECELLENSEMBLERUNNER_HPP_
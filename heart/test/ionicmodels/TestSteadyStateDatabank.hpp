@@ -0,0 +1,181 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef _TESTSTEADYSTATEDATABANK_HPP_
+#define _TESTSTEADYSTATEDATABANK_HPP_
+
+#include <cxxtest/TestSuite.h>
+
+#include <boost/lexical_cast.hpp>
+
+#include "AbstractCardiacCellFactory.hpp"
+#include "EulerIvpOdeSolver.hpp"
+#include "FileFinder.hpp"
+#include "HeartConfig.hpp"
+#include "LuoRudy1991.hpp"
+#include "MonodomainTissue.hpp"
+#include "OutputFileHandler.hpp"
+#include "PetscTools.hpp"
+#include "SteadyStateDatabank.hpp"
+#include "TetrahedralMesh.hpp"
+#include "ZeroStimulus.hpp"
+
+#ifdef CHASTE_CVODE
+#include "Shannon2004Cvode.hpp"
+
+class ShannonCvodeCellFactory : public AbstractCardiacCellFactory<1>
+{
+public:
+    ShannonCvodeCellFactory() : AbstractCardiacCellFactory<1>()
+    {
+    }
+
+    AbstractCardiacCellInterface* CreateCardiacCellForTissueNode(Node<1>* pNode)
+    {
+        boost::shared_ptr<AbstractIvpOdeSolver> p_empty_solver;
+        return new CellShannon2004FromCellMLCvode(p_empty_solver, mpZeroStimulus);
+    }
+};
+#endif //_CHASTE_CVODE
+
+#include "PetscSetupAndFinalize.hpp"
+
+class TestSteadyStateDatabank : public CxxTest::TestSuite
+{
+public:
+    void TestStoreApplyAndSave()
+    {
+        boost::shared_ptr<EulerIvpOdeSolver> p_solver(new EulerIvpOdeSolver);
+        boost::shared_ptr<ZeroStimulus> p_stimulus(new ZeroStimulus);
+        CellLuoRudy1991FromCellML cell(p_solver, p_stimulus);
+
+        // The key depends on the model, its parameters, the cycle length and the tag
+        std::string key = SteadyStateDatabank::GetKey(cell, 1000.0);
+        TS_ASSERT_EQUALS(key, SteadyStateDatabank::GetKey(cell, 1000.0, ""));
+        TS_ASSERT_DIFFERS(key, SteadyStateDatabank::GetKey(cell, 500.0));
+        TS_ASSERT_DIFFERS(key, SteadyStateDatabank::GetKey(cell, 1000.0, "drug"));
+        cell.SetParameter("membrane_fast_sodium_current_conductance",
+                          0.5*cell.GetParameter("membrane_fast_sodium_current_conductance"));
+        std::string block_key = SteadyStateDatabank::GetKey(cell, 1000.0);
+        TS_ASSERT_DIFFERS(key, block_key);
+
+        SteadyStateDatabank databank;
+        TS_ASSERT_EQUALS(databank.GetNumStates(), 0u);
+        TS_ASSERT_EQUALS(databank.HasState(key), false);
+        TS_ASSERT_EQUALS(databank.Apply(key, cell), false);
+
+        std::vector<double> state = cell.GetStdVecStateVariables();
+        state[0] = -90.0;
+        databank.Store(key, state);
+        TS_ASSERT_EQUALS(databank.HasState(key), true);
+        TS_ASSERT_EQUALS(databank.HasState(block_key), false);
+        TS_ASSERT_EQUALS(databank.Apply(key, cell), true);
+        TS_ASSERT_DELTA(cell.GetVoltage(), -90.0, 1e-12);
+
+        // Each process adds its own state, and then all processes have them all
+        std::string rank_key = "rank " + boost::lexical_cast<std::string>(PetscTools::GetMyRank());
+        databank.Store(rank_key, std::vector<double>(1, PetscTools::GetMyRank()));
+        databank.Synchronise();
+        TS_ASSERT_EQUALS(databank.GetNumStates(), 1u + PetscTools::GetNumProcs());
+
+        // Saved states can be loaded into another databank
+        OutputFileHandler handler("TestSteadyStateDatabank");
+        FileFinder databank_file = handler.FindFile("databank.arch");
+        SteadyStateDatabank loaded;
+        TS_ASSERT_EQUALS(loaded.Load(databank_file), false);
+        databank.Save(databank_file);
+        TS_ASSERT_EQUALS(loaded.Load(databank_file), true);
+        TS_ASSERT_EQUALS(loaded.GetNumStates(), databank.GetNumStates());
+        cell.SetVoltage(-80.0);
+        TS_ASSERT_EQUALS(loaded.Apply(key, cell), true);
+        TS_ASSERT_DELTA(cell.GetVoltage(), -90.0, 1e-12);
+    }
+
+    void TestTissueStartsAtSteadyState()
+    {
+#ifdef CHASTE_CVODE
+        if (PetscTools::GetNumProcs() > 2u)
+        {
+            // There are only 2 nodes in this simulation
+            TS_TRACE("This test is not suitable for more than 2 processes.");
+            return;
+        }
+        HeartConfig::Instance()->Reset();
+        TetrahedralMesh<1,1> mesh;
+        mesh.ConstructRegularSlabMesh(1.0, 1.0);
+
+        boost::shared_ptr<SteadyStateDatabank> p_databank(new SteadyStateDatabank);
+        ShannonCvodeCellFactory cell_factory;
+        cell_factory.SetMesh(&mesh);
+        cell_factory.SetSteadyStateDatabank(p_databank, 1000.0);
+        TS_ASSERT_EQUALS(cell_factory.GetSteadyStateDatabank(), p_databank);
+
+        MonodomainTissue<1> tissue(&cell_factory);
+
+        // Both cells are the same, so there is one steady state
+        TS_ASSERT_EQUALS(p_databank->GetNumStates(), 1u);
+
+        boost::shared_ptr<AbstractIvpOdeSolver> p_empty_solver;
+        boost::shared_ptr<ZeroStimulus> p_stimulus(new ZeroStimulus);
+        CellShannon2004FromCellMLCvode reference_cell(p_empty_solver, p_stimulus);
+        std::string key = SteadyStateDatabank::GetKey(reference_cell, 1000.0);
+        TS_ASSERT_EQUALS(p_databank->Apply(key, reference_cell), true);
+        std::vector<double> steady_state = reference_cell.GetStdVecStateVariables();
+
+        DistributedVectorFactory* p_factory = mesh.GetDistributedVectorFactory();
+        for (unsigned node_index=p_factory->GetLow(); node_index<p_factory->GetHigh(); node_index++)
+        {
+            AbstractCardiacCellInterface* p_cell = tissue.GetCardiacCell(node_index);
+            std::vector<double> state = p_cell->GetStdVecStateVariables();
+            TS_ASSERT_EQUALS(state.size(), steady_state.size());
+            for (unsigned i=0; i<state.size(); i++)
+            {
+                TS_ASSERT_DELTA(state[i], steady_state[i], 1e-12);
+            }
+
+            // The cell keeps the stimulus given to it by the factory
+            TS_ASSERT_DELTA(p_cell->GetIntracellularStimulus(10.0), 0.0, 1e-12);
+        }
+
+        // The pacing has moved the cells away from their initial conditions
+        CellShannon2004FromCellMLCvode fresh_cell(p_empty_solver, p_stimulus);
+        TS_ASSERT(fresh_cell.GetStdVecStateVariables() != steady_state);
+#else
+        std::cout << "CVODE must be enabled for the steady state databank to compute states." << std::endl;
+#endif //_CHASTE_CVODE
+    }
+};
+
+#endif //_TESTSTEADYSTATEDATABANK_HPP_
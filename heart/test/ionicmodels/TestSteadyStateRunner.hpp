@@ -45,6 +45,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "Shannon2004Cvode.hpp"
 #include "SteadyStateRunner.hpp"
+#include "SteadyStateSnapshotCache.hpp"
 #include "ZeroStimulus.hpp"
 
 //This test is always run sequentially (never in parallel)
@@ -124,6 +125,71 @@ public:
         steady_runner.SuppressOutput();
 #else
         std::cout << "CVODE must be enabled for the steady state runner to work." << std::endl;
+#endif //_CHASTE_CVODE
+    }
+
+    void TestSteadyStateSnapshotCache()
+    {
+        SteadyStateSnapshotCache cache;
+        std::vector<double> params(2);
+        TS_ASSERT_THROWS_THIS(cache.GetNearestIndex(params),
+                              "There are no steady states stored in the cache.");
+
+        std::vector<double> state(3, 1.0);
+        params[0] = 1.0;
+        params[1] = 1.0;
+        cache.Store(params, state);
+        params[0] = 0.5;
+        state[0] = 2.0;
+        cache.Store(params, state);
+        TS_ASSERT_EQUALS(cache.GetNumSnapshots(), 2u);
+
+        // Replacing an existing entry doesn't add a new one
+        state[0] = 3.0;
+        cache.Store(params, state);
+        TS_ASSERT_EQUALS(cache.GetNumSnapshots(), 2u);
+
+        std::vector<double> query(2, 0.9);
+        TS_ASSERT_EQUALS(cache.GetNearestIndex(query), 0u);
+        query[0] = 0.6;
+        TS_ASSERT_EQUALS(cache.GetNearestIndex(query), 1u);
+
+        std::vector<double> bad_query(3, 0.0);
+        TS_ASSERT_THROWS_THIS(cache.GetNearestIndex(bad_query),
+                              "Parameter set has 3 values but the cache stores sets of 2.");
+
+        cache.Clear();
+        TS_ASSERT_EQUALS(cache.GetNumSnapshots(), 0u);
+
+#ifdef CHASTE_CVODE
+        boost::shared_ptr<RegularStimulus> p_stimulus;
+        boost::shared_ptr<AbstractIvpOdeSolver> p_solver;
+        boost::shared_ptr<AbstractCvodeCell> p_model(new CellShannon2004FromCellMLCvode(p_solver, p_stimulus));
+        p_model->UseCellMLDefaultStimulus();
+        p_model->SetTolerances(1e-6, 1e-8);
+        std::vector<double> initial_state = p_model->GetStdVecStateVariables();
+
+        // Nothing stored, so nothing is applied
+        TS_ASSERT_EQUALS(cache.ApplyNearest(params, *p_model), false);
+
+        TS_ASSERT_EQUALS(cache.RunToSteadyState(params, p_model), true);
+        TS_ASSERT_EQUALS(cache.GetNumSnapshots(), 1u);
+        std::vector<double> steady_state = p_model->GetStdVecStateVariables();
+
+        // A fresh run of the model is warm-started from the stored steady state
+        p_model->SetStateVariables(initial_state);
+        TS_ASSERT_EQUALS(cache.ApplyNearest(query, *p_model), true);
+        std::vector<double> applied_state = p_model->GetStdVecStateVariables();
+        for (unsigned i=0; i<steady_state.size(); i++)
+        {
+            TS_ASSERT_DELTA(applied_state[i], steady_state[i], 1e-12);
+        }
+
+        // ...and so is already at steady state
+        SteadyStateRunner runner(p_model);
+        runner.SuppressOutput();
+        TS_ASSERT_EQUALS(runner.RunToSteadyState(), true);
+        TS_ASSERT_LESS_THAN(runner.GetNumEvaluations(), 10u);
 #endif //_CHASTE_CVODE
     }
 };
@@ -48,6 +48,8 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "Hdf5DataReader.hpp"
 #include "NashHunterPoleZeroLaw.hpp"
 #include "CompressibleMooneyRivlinMaterialLaw.hpp"
+#include "DistributedQuadraticMesh.hpp"
+#include "TrianglesMeshReader.hpp"
 #include "PetscSetupAndFinalize.hpp"
 
 // cell factory which stimulates everything at once
@@ -401,6 +403,68 @@ public:
         TS_ASSERT_DELTA(X_scale_factor * Y_scale_factor, 1.0, 1e-6);
     }
 
+    // Solve the same problem with a replicated and a distributed mechanics mesh
+    // (only the electrics data needed by each process's quad points is
+    // communicated in the latter case) and check the deformations agree
+    void TestWithDistributedMechanicsMesh()
+    {
+        EntirelyStimulatedTissueCellFactory cell_factory;
+
+        TetrahedralMesh<2,2> electrics_mesh;
+        electrics_mesh.ConstructRegularSlabMesh(0.05, 1.0, 1.0);
+
+        TrianglesMeshReader<2,2> reader1("mesh/test/data/square_128_elements_quadratic", 2, 1, false);
+        QuadraticMesh<2> replicated_mesh;
+        replicated_mesh.ConstructFromMeshReader(reader1);
+
+        TrianglesMeshReader<2,2> reader2("mesh/test/data/square_128_elements_quadratic", 2, 1, false);
+        DistributedQuadraticMesh<2> distributed_mesh(DistributedTetrahedralMeshPartitionType::DUMB);
+        distributed_mesh.ConstructFromMeshReader(reader2);
+
+        std::vector<c_vector<double,2> > deformed_positions[2];
+        AbstractTetrahedralMesh<2,2>* meshes[2] = {&replicated_mesh, &distributed_mesh};
+
+        for (unsigned run=0; run<2; run++)
+        {
+            std::vector<unsigned> fixed_nodes;
+            for (AbstractMesh<2,2>::NodeIterator iter = meshes[run]->GetNodeIteratorBegin();
+                 iter != meshes[run]->GetNodeIteratorEnd();
+                 ++iter)
+            {
+                if (fabs(iter->rGetLocation()[0])<1e-6)
+                {
+                    fixed_nodes.push_back(iter->GetIndex());
+                }
+            }
+
+            ElectroMechanicsProblemDefinition<2> problem_defn(*meshes[run]);
+            problem_defn.SetContractionModel(KERCHOFFS2003,1.0);
+            problem_defn.SetUseDefaultCardiacMaterialLaw(INCOMPRESSIBLE);
+            problem_defn.SetZeroDisplacementNodes(fixed_nodes);
+            problem_defn.SetMechanicsSolveTimestep(1.0);
+
+            HeartConfig::Instance()->SetSimulationDuration(10.0);
+
+            CardiacElectroMechanicsProblem<2,1> problem(INCOMPRESSIBLE,
+                                                        MONODOMAIN,
+                                                        &electrics_mesh,
+                                                        meshes[run],
+                                                        &cell_factory,
+                                                        &problem_defn,
+                                                        "");
+            problem.Solve();
+
+            deformed_positions[run] = problem.rGetDeformedPosition();
+        }
+
+        TS_ASSERT_EQUALS(deformed_positions[0].size(), deformed_positions[1].size());
+        for (unsigned i=0; i<deformed_positions[0].size(); i++)
+        {
+            TS_ASSERT_DELTA(deformed_positions[1][i](0), deformed_positions[0][i](0), 1e-8);
+            TS_ASSERT_DELTA(deformed_positions[1][i](1), deformed_positions[0][i](1), 1e-8);
+        }
+    }
+
     //Here we test the presence of a bath in an Em problem
     //We construct the electrics mesh in a  way that most of it is bath
     // We then fix the only nodes in the mechanics mesh which are not bath
@@ -326,6 +326,11 @@ public:
         if (iter != solver.rGetQuadPointToDataAtQuadPointMap().end()) //ie because some processes won't own this in parallel
         {
             TS_ASSERT_DELTA(iter->second.Stretch, 0.9737, 2e-3);
+
+            // The contraction model results kept during the solve are only valid within it
+            TS_ASSERT_EQUALS(iter->second.StretchLastTimeStep, iter->second.Stretch);
+            TS_ASSERT_EQUALS(iter->second.CachedStretch, DBL_MAX);
+            TS_ASSERT_EQUALS(iter->second.LastRunStretch, DBL_MAX);
         }
 
         //in need of deletion even if all these 3 have no influence at all on this test
@@ -0,0 +1,191 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef TESTACTIONPOTENTIALMAPOUTPUTMODIFIER_HPP_
+#define TESTACTIONPOTENTIALMAPOUTPUTMODIFIER_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include <vector>
+
+#include "TetrahedralMesh.hpp"
+#include "TrianglesMeshReader.hpp"
+#include "ActionPotentialMapOutputModifier.hpp"
+#include "DistributedVector.hpp"
+#include "Hdf5DataReader.hpp"
+#include "HeartConfig.hpp"
+#include "MonodomainProblem.hpp"
+#include "PlaneStimulusCellFactory.hpp"
+#include "LuoRudy1991.hpp"
+#include "PetscSetupAndFinalize.hpp"
+
+class TestActionPotentialMapOutputModifier : public CxxTest::TestSuite
+{
+private:
+    /**
+     * A piecewise linear action potential: upstroke at 100 mV/ms from -80 to 20 mV,
+     * 10 ms plateau, then repolarisation at 10 mV/ms back to -80 mV.
+     */
+    double SyntheticActionPotential(double timeSinceStart)
+    {
+        if (timeSinceStart < 0.0 || timeSinceStart >= 21.0)
+        {
+            return -80.0;
+        }
+        else if (timeSinceStart < 1.0)
+        {
+            return -80.0 + 100.0*timeSinceStart;
+        }
+        else if (timeSinceStart < 11.0)
+        {
+            return 20.0;
+        }
+        return 20.0 - 10.0*(timeSinceStart - 11.0);
+    }
+
+public:
+    void tearDown()
+    {
+        HeartConfig::Reset();
+    }
+
+    void TestSyntheticTravellingWaves()
+    {
+        HeartConfig::Instance()->SetOutputDirectory("TestActionPotentialMapOutputModifier");
+
+        TrianglesMeshReader<1,1> reader("mesh/test/data/1D_0_to_1_10_elements");
+        TetrahedralMesh<1,1> mesh;
+        mesh.ConstructFromMeshReader(reader);
+        DistributedVectorFactory* p_factory = mesh.GetDistributedVectorFactory();
+
+        // Two beats travelling at 0.1 cm/ms, 30 ms apart
+        const double speed = 0.1;
+        const double dt = 0.1;
+        ActionPotentialMapOutputModifier<1,1> modifier("ap_maps", mesh, -40.0);
+        modifier.InitialiseAtStart(p_factory);
+
+        Vec solution = p_factory->CreateVec();
+        DistributedVector distributed_solution = p_factory->CreateDistributedVector(solution);
+        for (unsigned step=0; step<=700; step++)
+        {
+            double time = step*dt;
+            for (DistributedVector::Iterator index = distributed_solution.Begin();
+                 index != distributed_solution.End();
+                 ++index)
+            {
+                double arrival_time = mesh.GetNode(index.Global)->rGetLocation()[0]/speed;
+                distributed_solution[index] = std::max(SyntheticActionPotential(time - arrival_time),
+                                                       SyntheticActionPotential(time - arrival_time - 30.0));
+            }
+            distributed_solution.Restore();
+            modifier.ProcessSolutionAtTimeStep(time, solution, 1u);
+        }
+        PetscTools::Destroy(solution);
+
+        for (DistributedVector::Iterator index = distributed_solution.Begin();
+             index != distributed_solution.End();
+             ++index)
+        {
+            double arrival_time = mesh.GetNode(index.Global)->rGetLocation()[0]/speed;
+            const std::vector<double>& r_upstroke_times = modifier.rGetUpstrokeTimes(index.Local);
+            const std::vector<double>& r_apds = modifier.rGetApds(index.Local);
+            const std::vector<double>& r_velocities = modifier.rGetMaxUpstrokeVelocities(index.Local);
+            TS_ASSERT_EQUALS(r_upstroke_times.size(), 2u);
+            TS_ASSERT_EQUALS(r_apds.size(), 2u);
+            TS_ASSERT_EQUALS(r_velocities.size(), 2u);
+            for (unsigned pace=0; pace<2; pace++)
+            {
+                // Threshold -40 mV is crossed 0.4 ms into the upstroke; APD90 ends at -70 mV, 20 ms in
+                TS_ASSERT_DELTA(r_upstroke_times[pace], arrival_time + 30.0*pace + 0.4, 1e-8);
+                TS_ASSERT_DELTA(r_apds[pace], 19.6, 1e-8);
+                TS_ASSERT_DELTA(r_velocities[pace], 100.0, 1e-6);
+            }
+        }
+
+        // Results written to HDF5, including conduction velocity
+        modifier.FinaliseAtEnd();
+        Hdf5DataReader data_reader("TestActionPotentialMapOutputModifier", "ap_maps");
+        TS_ASSERT_EQUALS(data_reader.GetUnlimitedDimensionValues().size(), 2u);
+        for (unsigned node_index=0; node_index<mesh.GetNumNodes(); node_index++)
+        {
+            std::vector<double> upstroke_times = data_reader.GetVariableOverTime("UpstrokeTime", node_index);
+            std::vector<double> apds = data_reader.GetVariableOverTime("Apd", node_index);
+            std::vector<double> conduction_velocities = data_reader.GetVariableOverTime("ConductionVelocity", node_index);
+            for (unsigned pace=0; pace<2; pace++)
+            {
+                TS_ASSERT_DELTA(upstroke_times[pace], node_index + 30.0*pace + 0.4, 1e-8);
+                TS_ASSERT_DELTA(apds[pace], 19.6, 1e-8);
+                TS_ASSERT_DELTA(conduction_velocities[pace], speed, 1e-8);
+            }
+        }
+    }
+
+    void TestInMonodomainProblem()
+    {
+        HeartConfig::Instance()->SetIntracellularConductivities(Create_c_vector(0.0005));
+        HeartConfig::Instance()->SetSimulationDuration(30); //ms
+        HeartConfig::Instance()->SetMeshFileName("mesh/test/data/1D_0_to_1_100_elements");
+        HeartConfig::Instance()->SetOutputDirectory("MonoActionPotentialMaps");
+        HeartConfig::Instance()->SetOutputFilenamePrefix("MonodomainLR91_1d");
+        HeartConfig::Instance()->SetVisualizeWithMeshalyzer(false);
+
+        PlaneStimulusCellFactory<CellLuoRudy1991FromCellML, 1> cell_factory;
+        MonodomainProblem<1> monodomain_problem(&cell_factory);
+        monodomain_problem.Initialise();
+
+        HeartConfig::Instance()->SetSurfaceAreaToVolumeRatio(1.0);
+        HeartConfig::Instance()->SetCapacitance(1.0);
+
+        boost::shared_ptr<ActionPotentialMapOutputModifier<1,1> > p_maps(
+            new ActionPotentialMapOutputModifier<1,1>("ap_maps", monodomain_problem.rGetMesh(), -30.0));
+        monodomain_problem.AddOutputModifier(p_maps);
+
+        monodomain_problem.Solve();
+
+        Hdf5DataReader data_reader("MonoActionPotentialMaps", "ap_maps");
+        TS_ASSERT_EQUALS(data_reader.GetUnlimitedDimensionValues().size(), 1u);
+
+        // The wave reaches the far end, and the APD is too long to complete in 30ms
+        std::vector<double> upstroke_times = data_reader.GetVariableOverTime("UpstrokeTime", 95);
+        TS_ASSERT_LESS_THAN(0.0, upstroke_times[0]);
+        TS_ASSERT_EQUALS(data_reader.GetVariableOverTime("Apd", 95)[0], -999.0);
+        TS_ASSERT_LESS_THAN(100.0, data_reader.GetVariableOverTime("MaxUpstrokeVelocity", 95)[0]);
+
+        // The value should be approximately 50cm/sec, as in TestMonodomainConductionVelocity
+        TS_ASSERT_DELTA(data_reader.GetVariableOverTime("ConductionVelocity", 50)[0], 0.05, 0.005);
+    }
+};
+
+#endif /* TESTACTIONPOTENTIALMAPOUTPUTMODIFIER_HPP_ */
@@ -0,0 +1,199 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef _TESTEIKONALPROBLEM_HPP_
+#define _TESTEIKONALPROBLEM_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include <vector>
+
+#include "EikonalProblem.hpp"
+#include "AbstractCardiacCellFactory.hpp"
+#include "PlaneStimulusCellFactory.hpp"
+#include "SimpleStimulus.hpp"
+#include "LuoRudy1991.hpp"
+#include "DistributedTetrahedralMesh.hpp"
+#include "ReplicatableVector.hpp"
+#include "FileFinder.hpp"
+#include "PetscSetupAndFinalize.hpp"
+
+class CornerStimulusCellFactory : public AbstractCardiacCellFactory<2>
+{
+private:
+    boost::shared_ptr<SimpleStimulus> mpStimulus;
+public:
+    CornerStimulusCellFactory()
+        : AbstractCardiacCellFactory<2>(),
+          mpStimulus(new SimpleStimulus(-600.0, 0.5, 1.0))
+    {
+    }
+
+    AbstractCardiacCell* CreateCardiacCellForTissueNode(Node<2>* pNode)
+    {
+        if (norm_2(pNode->rGetLocation()) < 1e-10)
+        {
+            return new CellLuoRudy1991FromCellML(mpSolver, mpStimulus);
+        }
+        else
+        {
+            return new CellLuoRudy1991FromCellML(mpSolver, mpZeroStimulus);
+        }
+    }
+};
+
+class TestEikonalProblem : public CxxTest::TestSuite
+{
+public:
+    void tearDown()
+    {
+        HeartConfig::Reset();
+    }
+
+    void TestConductionVelocityParameter()
+    {
+        TS_ASSERT_THROWS_CONTAINS(HeartConfig::Instance()->GetEikonalConductionVelocity(),
+                                  "No XML element Physiological/EikonalConductionVelocity found");
+        HeartConfig::Instance()->SetEikonalConductionVelocity(0.06);
+        TS_ASSERT_DELTA(HeartConfig::Instance()->GetEikonalConductionVelocity(), 0.06, 1e-12);
+    }
+
+    // A plane wave travels from x=0 to x=1 at the given velocity
+    void TestPlaneWave1d()
+    {
+        HeartConfig::Instance()->SetIntracellularConductivities(Create_c_vector(1.75));
+        HeartConfig::Instance()->SetEikonalConductionVelocity(0.05);
+        HeartConfig::Instance()->SetSimulationDuration(1.0); //ms
+        HeartConfig::Instance()->SetOutputDirectory("EikonalPlaneWave1d");
+        HeartConfig::Instance()->SetOutputFilenamePrefix("results");
+
+        DistributedTetrahedralMesh<1,1> mesh;
+        mesh.ConstructRegularSlabMesh(0.01, 1.0);
+
+        PlaneStimulusCellFactory<CellLuoRudy1991FromCellML, 1> cell_factory;
+        EikonalProblem<1> eikonal_problem(&cell_factory);
+        eikonal_problem.SetMesh(&mesh);
+        TS_ASSERT_THROWS_THIS(eikonal_problem.ComputeActivationTimes(),
+                              "Cardiac tissue is null, Initialise() probably hasn't been called");
+        eikonal_problem.Initialise();
+        eikonal_problem.Solve();
+
+        const std::vector<double>& r_times = eikonal_problem.rGetActivationTimes();
+        TS_ASSERT_EQUALS(r_times.size(), mesh.GetNumNodes());
+        for (unsigned node_index=0; node_index<r_times.size(); node_index++)
+        {
+            TS_ASSERT_DELTA(r_times[node_index], node_index*0.01/0.05, 1e-9);
+        }
+
+        FileFinder activation_map("EikonalPlaneWave1d/ActivationTimeMap.dat", RelativeTo::ChasteTestOutput);
+        TS_ASSERT(activation_map.Exists());
+    }
+
+    // From a corner stimulus, the wave is twice as fast along the fibres (x) as across them (y)
+    void TestAnisotropicPointStimulus2d()
+    {
+        HeartConfig::Instance()->SetIntracellularConductivities(Create_c_vector(1.6, 0.4));
+        HeartConfig::Instance()->SetEikonalConductionVelocity(0.06);
+        HeartConfig::Instance()->SetSimulationDuration(1.0); //ms
+        HeartConfig::Instance()->SetOutputDirectory("EikonalAnisotropic2d");
+        HeartConfig::Instance()->SetOutputFilenamePrefix("results");
+
+        DistributedTetrahedralMesh<2,2> mesh;
+        mesh.ConstructRegularSlabMesh(0.01, 0.1, 0.1);
+
+        CornerStimulusCellFactory cell_factory;
+        EikonalProblem<2> eikonal_problem(&cell_factory);
+        eikonal_problem.SetMesh(&mesh);
+        eikonal_problem.Initialise();
+
+        const std::vector<double>& r_times = eikonal_problem.rGetActivationTimes();
+        for (unsigned node_index=0; node_index<r_times.size(); node_index++)
+        {
+            // The slab mesh numbers its nodes row by row, with 11 nodes along x
+            unsigned i = node_index % 11;
+            unsigned j = node_index / 11;
+            if (j == 0)
+            {
+                TS_ASSERT_DELTA(r_times[node_index], 1.0 + i*0.01/0.06, 1e-9);
+            }
+            if (i == 0)
+            {
+                TS_ASSERT_DELTA(r_times[node_index], 1.0 + j*0.01/0.03, 1e-9);
+            }
+            // Nowhere is reached faster than along the fibres
+            TS_ASSERT_LESS_THAN_EQUALS(1.0 + i*0.01/0.06 - 1e-9, r_times[node_index]);
+        }
+    }
+
+    // The cells are driven by the activation times, without any diffusion
+    void TestReactionEikonal1d()
+    {
+        HeartConfig::Instance()->SetIntracellularConductivities(Create_c_vector(1.75));
+        HeartConfig::Instance()->SetEikonalConductionVelocity(0.05);
+        HeartConfig::Instance()->SetSimulationDuration(12.0); //ms
+        HeartConfig::Instance()->SetOutputDirectory("ReactionEikonal1d");
+        HeartConfig::Instance()->SetOutputFilenamePrefix("results");
+
+        DistributedTetrahedralMesh<1,1> mesh;
+        mesh.ConstructRegularSlabMesh(0.01, 1.0);
+
+        PlaneStimulusCellFactory<CellLuoRudy1991FromCellML, 1> cell_factory;
+        EikonalProblem<1> eikonal_problem(&cell_factory, true);
+        TS_ASSERT(eikonal_problem.IsReactionEikonal());
+        eikonal_problem.SetMesh(&mesh);
+        eikonal_problem.Initialise();
+
+        // As in TestMonodomainConductionVelocity, so that the stimulus is per unit area
+        HeartConfig::Instance()->SetSurfaceAreaToVolumeRatio(1.0);
+        HeartConfig::Instance()->SetCapacitance(1.0);
+
+        eikonal_problem.Solve();
+
+        // x=0.2 was activated at 4ms and is depolarised; x=0.95 is only reached at 19ms
+        ReplicatableVector voltage(eikonal_problem.GetSolution());
+        TS_ASSERT_LESS_THAN(-20.0, voltage[20]);
+        TS_ASSERT_LESS_THAN(voltage[95], -80.0);
+
+        // Stimulated cells keep their own stimuli, the others are stimulated at their activation times
+        if (mesh.GetDistributedVectorFactory()->IsGlobalIndexLocal(50u))
+        {
+            AbstractCardiacCellInterface* p_cell = eikonal_problem.GetTissue()->GetCardiacCell(50u);
+            TS_ASSERT_DELTA(p_cell->GetStimulus(10.1), -600.0, 1e-12);
+            TS_ASSERT_DELTA(p_cell->GetStimulus(9.9), 0.0, 1e-12);
+        }
+    }
+};
+
+#endif /*_TESTEIKONALPROBLEM_HPP_*/
@@ -0,0 +1,170 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef TESTEXPLICITMONODOMAINSOLVER_HPP_
+#define TESTEXPLICITMONODOMAINSOLVER_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include "MonodomainProblem.hpp"
+#include "ExplicitMonodomainSolver.hpp"
+#include "LuoRudy1991BackwardEuler.hpp"
+#include "PlaneStimulusCellFactory.hpp"
+#include "ZeroStimulusCellFactory.hpp"
+#include "ConstBoundaryCondition.hpp"
+#include "TetrahedralMesh.hpp"
+#include "ReplicatableVector.hpp"
+#include "PetscTools.hpp"
+#include "PetscSetupAndFinalize.hpp"
+
+class TestExplicitMonodomainSolver : public CxxTest::TestSuite
+{
+public:
+
+    // The explicit solver uses a lumped mass matrix, so compare it with the implicit solver using mass lumping
+    void TestComparisonWithImplicitSolver()
+    {
+        ReplicatableVector final_voltage_implicit;
+        ReplicatableVector final_voltage_explicit;
+
+        HeartConfig::Instance()->SetSimulationDuration(4.0); //ms
+        HeartConfig::Instance()->SetOutputFilenamePrefix("results");
+        HeartConfig::Instance()->SetOdePdeAndPrintingTimeSteps(0.005, 0.01, 0.1);
+        HeartConfig::Instance()->SetUseMassLumping();
+
+        for (unsigned i=0; i<2; i++)
+        {
+            bool use_explicit = (i==1);
+            HeartConfig::Instance()->SetUseExplicitMonodomainSolver(use_explicit);
+            HeartConfig::Instance()->SetOutputDirectory(use_explicit ? "MonodomainExplicit" : "MonodomainImplicitLumped");
+
+            TetrahedralMesh<1,1> mesh;
+            mesh.ConstructRegularSlabMesh(0.01, 1.0);
+            PlaneStimulusCellFactory<CellLuoRudy1991FromCellMLBackwardEuler,1> cell_factory(-1e6, 0.5);
+
+            MonodomainProblem<1> monodomain_problem( &cell_factory );
+            monodomain_problem.SetMesh(&mesh);
+            monodomain_problem.Initialise();
+            monodomain_problem.Solve();
+
+            if (use_explicit)
+            {
+                final_voltage_explicit.ReplicatePetscVector(monodomain_problem.GetSolution());
+            }
+            else
+            {
+                final_voltage_implicit.ReplicatePetscVector(monodomain_problem.GetSolution());
+            }
+        }
+
+        bool some_node_depolarised = false;
+        TS_ASSERT_EQUALS(final_voltage_implicit.GetSize(), final_voltage_explicit.GetSize());
+        for (unsigned j=0; j<final_voltage_implicit.GetSize(); j++)
+        {
+            // The time discretisations differ, so the wavefronts are close but not on top of each other
+            TS_ASSERT_DELTA(final_voltage_implicit[j], final_voltage_explicit[j], 25.0);
+            some_node_depolarised = some_node_depolarised || (final_voltage_explicit[j] > 0.0);
+        }
+        TS_ASSERT(some_node_depolarised);
+
+        HeartConfig::Instance()->Reset();
+    }
+
+    void TestStageSelectionAndExceptions()
+    {
+        TetrahedralMesh<1,1> mesh;
+        mesh.ConstructRegularSlabMesh(0.01, 1.0);
+
+        ZeroStimulusCellFactory<CellLuoRudy1991FromCellMLBackwardEuler,1> cell_factory;
+        cell_factory.SetMesh(&mesh);
+        MonodomainTissue<1> tissue(&cell_factory);
+
+        // Create an empty BCC - zero Neumann BCs will be applied everywhere
+        BoundaryConditionsContainer<1,1,1> bcc;
+
+        Vec initial_condition = PetscTools::CreateAndSetVec(mesh.GetNumNodes(), -83.853);
+
+        ExplicitMonodomainSolver<1,1> solver(&mesh, &tissue, &bcc);
+        TS_ASSERT_THROWS_THIS(solver.Solve(), "SetTimes() has not been called");
+        solver.SetInitialCondition(initial_condition);
+
+        // A step well within the forward Euler limit needs a single stage
+        solver.InitialiseForSolve(initial_condition);
+        double euler_dt = solver.GetForwardEulerStableTimeStep();
+        TS_ASSERT_LESS_THAN(0.0, euler_dt);
+
+        solver.SetTimes(0.0, 0.5*euler_dt);
+        solver.SetTimeStep(0.5*euler_dt);
+        Vec solution = solver.Solve();
+        TS_ASSERT_EQUALS(solver.GetNumStages(), 1u);
+
+        // Resting cells with no stimulus stay at rest
+        ReplicatableVector solution_repl(solution);
+        for (unsigned i=0; i<solution_repl.GetSize(); i++)
+        {
+            TS_ASSERT_DELTA(solution_repl[i], -83.853, 1e-2);
+        }
+        PetscTools::Destroy(solution);
+
+        // A step 50 times the forward Euler limit needs s stages with about 1.93*s^2 >= 2*50
+        solver.SetTimes(0.0, 50*euler_dt);
+        solver.SetTimeStep(50*euler_dt);
+        solution = solver.Solve();
+        TS_ASSERT_EQUALS(solver.GetNumStages(), 8u);
+
+        // ...and is still stable
+        solution_repl.ReplicatePetscVector(solution);
+        for (unsigned i=0; i<solution_repl.GetSize(); i++)
+        {
+            TS_ASSERT_DELTA(solution_repl[i], -83.853, 1.0);
+        }
+        PetscTools::Destroy(solution);
+        PetscTools::Destroy(initial_condition);
+
+        // Unsupported features
+        BoundaryConditionsContainer<1,1,1> dirichlet_bcc;
+        ConstBoundaryCondition<1>* p_boundary_condition = new ConstBoundaryCondition<1>(0.0);
+        dirichlet_bcc.AddDirichletBoundaryCondition(mesh.GetNode(0), p_boundary_condition);
+        TS_ASSERT_THROWS_THIS((ExplicitMonodomainSolver<1,1>(&mesh, &tissue, &dirichlet_bcc)),
+                              "The explicit monodomain solver does not support Dirichlet boundary conditions");
+
+        HeartConfig::Instance()->SetUseStateVariableInterpolation();
+        TS_ASSERT_THROWS_THIS((ExplicitMonodomainSolver<1,1>(&mesh, &tissue, &bcc)),
+                              "The explicit monodomain solver does not support state variable interpolation");
+        HeartConfig::Instance()->Reset();
+    }
+};
+
+#endif /* TESTEXPLICITMONODOMAINSOLVER_HPP_ */
@@ -0,0 +1,128 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTMONODOMAINMATRIXFREE_HPP_
+#define TESTMONODOMAINMATRIXFREE_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include "LuoRudy1991BackwardEuler.hpp"
+#include "PlaneStimulusCellFactory.hpp"
+#include "MonodomainProblem.hpp"
+#include "BidomainProblem.hpp"
+#include "Warnings.hpp"
+#include "PetscSetupAndFinalize.hpp"
+
+class TestMonodomainMatrixFree : public CxxTest::TestSuite
+{
+public:
+
+    void TestCompareSquarePlaneStimulus()
+    {
+        HeartConfig::Instance()->SetSimulationDuration(5); //ms
+        HeartConfig::Instance()->SetOdePdeAndPrintingTimeSteps(0.01,0.1,0.1);
+        HeartConfig::Instance()->SetSlabDimensions(0.3, 0.3, 0.02);
+        HeartConfig::Instance()->SetKSPPreconditioner("jacobi");
+        HeartConfig::Instance()->SetUseAbsoluteTolerance(1e-10);
+
+        PlaneStimulusCellFactory<CellLuoRudy1991FromCellMLBackwardEuler,2> cell_factory(-5e5, 1.0);
+
+        /*
+         *  Standard (assembled) solve
+         */
+        HeartConfig::Instance()->SetOutputDirectory("CompareSquareAssembled");
+        HeartConfig::Instance()->SetOutputFilenamePrefix("CompareSquareAssembled");
+
+        MonodomainProblem<2> monodomain_problem( &cell_factory );
+        monodomain_problem.Initialise();
+        monodomain_problem.Solve();
+
+        DistributedVector assembled_solution = monodomain_problem.GetSolutionDistributedVector();
+
+        /*
+         *  Matrix-free solve
+         */
+        HeartConfig::Instance()->SetOutputDirectory("CompareSquareMatrixFree");
+        HeartConfig::Instance()->SetOutputFilenamePrefix("CompareSquareMatrixFree");
+        HeartConfig::Instance()->SetUseMatrixFreeOperators();
+
+        MonodomainProblem<2> monodomain_problem_mf( &cell_factory );
+        monodomain_problem_mf.Initialise();
+        monodomain_problem_mf.Solve();
+
+        DistributedVector matrix_free_solution = monodomain_problem_mf.GetSolutionDistributedVector();
+
+        // The same linear systems are solved, so the solutions should agree to solver tolerance
+        bool some_node_depolarised = false;
+        for (DistributedVector::Iterator index = assembled_solution.Begin();
+             index != assembled_solution.End();
+             ++index)
+        {
+            TS_ASSERT_DELTA(assembled_solution[index], matrix_free_solution[index], 1e-6);
+            some_node_depolarised = some_node_depolarised || (assembled_solution[index] > 0.0);
+        }
+        TS_ASSERT(PetscTools::ReplicateBool(some_node_depolarised));
+
+        HeartConfig::Instance()->Reset();
+    }
+
+    void TestPreconditionerFallbackAndBidomainException()
+    {
+        HeartConfig::Instance()->SetSimulationDuration(0.1); //ms
+        HeartConfig::Instance()->SetOdePdeAndPrintingTimeSteps(0.01,0.1,0.1);
+        HeartConfig::Instance()->SetSlabDimensions(0.1, 0.1, 0.02);
+        HeartConfig::Instance()->SetOutputDirectory("MatrixFreeFallback");
+        HeartConfig::Instance()->SetOutputFilenamePrefix("MatrixFreeFallback");
+        HeartConfig::Instance()->SetUseMatrixFreeOperators();
+        HeartConfig::Instance()->SetKSPPreconditioner("bjacobi");
+
+        PlaneStimulusCellFactory<CellLuoRudy1991FromCellMLBackwardEuler,2> cell_factory(-5e5, 1.0);
+
+        MonodomainProblem<2> monodomain_problem( &cell_factory );
+        monodomain_problem.Initialise();
+        monodomain_problem.Solve();
+        TS_ASSERT_EQUALS(Warnings::Instance()->GetNumWarnings(), 1u);
+        TS_ASSERT_EQUALS(Warnings::Instance()->GetNextWarningMessage(),
+                         "Preconditioner 'bjacobi' needs an assembled matrix; using 'jacobi' with matrix-free operators.");
+
+        BidomainProblem<2> bidomain_problem( &cell_factory );
+        bidomain_problem.Initialise();
+        TS_ASSERT_THROWS_THIS(bidomain_problem.Solve(),
+                              "Matrix-free operators are only supported by the monodomain solver");
+
+        HeartConfig::Instance()->Reset();
+    }
+};
+
+#endif /* TESTMONODOMAINMATRIXFREE_HPP_ */
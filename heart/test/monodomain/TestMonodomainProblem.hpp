@@ -1752,6 +1752,142 @@ public:
         H5Dclose(dset);
         H5Fclose(h5_file);
     }
+
+    void TestLatticeAndProbeOutput()
+    {
+        HeartConfig::Instance()->SetMeshFileName("mesh/test/data/1D_0_to_1_100_elements");
+        HeartConfig::Instance()->SetOutputDirectory("MonodomainLatticeAndProbeOutput");
+        HeartConfig::Instance()->SetOutputFilenamePrefix("MonodomainLR91_1d");
+        HeartConfig::Instance()->SetSimulationDuration(2.0); //ms
+        HeartConfig::Instance()->SetOdePdeAndPrintingTimeSteps(0.01, 0.01, 0.1);
+
+        // Lattice sticks out past the end of the mesh, so only points 0..10 are written
+        c_vector<double,3> lower = zero_vector<double>(3);
+        c_vector<double,3> upper = zero_vector<double>(3);
+        upper(0) = 1.2;
+        HeartConfig::Instance()->SetLatticeOutput(lower, upper, 0.1, 0.5);
+
+        std::vector<unsigned> probes;
+        probes.push_back(50);
+        probes.push_back(0);
+        HeartConfig::Instance()->SetProbeOutputNodes(probes);
+
+        PlaneStimulusCellFactory<CellLuoRudy1991FromCellML, 1> cell_factory;
+        MonodomainProblem<1> monodomain_problem( &cell_factory );
+        monodomain_problem.Initialise();
+        monodomain_problem.Solve();
+
+        FileFinder dir("MonodomainLatticeAndProbeOutput", RelativeTo::ChasteTestOutput);
+        Hdf5DataReader full_reader(dir, "MonodomainLR91_1d");
+        std::vector<double> full_voltage = full_reader.GetVariableOverTime("V", 50);
+        TS_ASSERT_EQUALS(full_voltage.size(), 21u);
+
+        // Probe channel is written at every printing time
+        Hdf5DataReader probe_reader(dir, "MonodomainLR91_1d_probes");
+        std::vector<double> probe_times = probe_reader.GetUnlimitedDimensionValues();
+        TS_ASSERT_EQUALS(probe_times.size(), 21u);
+        std::vector<double> probe_voltage = probe_reader.GetVariableOverTime("V", 50);
+        TS_ASSERT_EQUALS(probe_voltage.size(), 21u);
+        for (unsigned i=0; i<probe_voltage.size(); i++)
+        {
+            TS_ASSERT_DELTA(probe_voltage[i], full_voltage[i], 1e-12);
+        }
+
+        // Lattice channel is decimated to every 0.5ms; point 5 coincides with node 50
+        Hdf5DataReader lattice_reader(dir, "MonodomainLR91_1d_lattice");
+        std::vector<double> lattice_times = lattice_reader.GetUnlimitedDimensionValues();
+        TS_ASSERT_EQUALS(lattice_times.size(), 5u);
+        TS_ASSERT_DELTA(lattice_times[1], 0.5, 1e-10);
+        std::vector<double> lattice_voltage = lattice_reader.GetVariableOverTime("V", 5);
+        TS_ASSERT_EQUALS(lattice_voltage.size(), 5u);
+        for (unsigned i=0; i<lattice_voltage.size(); i++)
+        {
+            TS_ASSERT_DELTA(lattice_voltage[i], full_voltage[5*i], 1e-8);
+        }
+        TS_ASSERT_THROWS_CONTAINS(lattice_reader.GetVariableOverTime("V", 12), "does not contain info of node 12");
+
+        HeartConfig::Instance()->CancelLatticeOutput();
+        HeartConfig::Instance()->SetProbeOutputNodes(std::vector<unsigned>());
+    }
+
+    void TestMonodomainWithInactiveRegion()
+    {
+        HeartConfig::Instance()->SetIntracellularConductivities(Create_c_vector(1.75));
+        HeartConfig::Instance()->SetSimulationDuration(2.0); //ms
+        HeartConfig::Instance()->SetOdePdeAndPrintingTimeSteps(0.01, 0.01, 0.1);
+        std::set<unsigned> tissue_ids;
+        tissue_ids.insert(0);
+        tissue_ids.insert(1);
+        std::set<unsigned> bath_ids;
+        bath_ids.insert(2);
+        HeartConfig::Instance()->SetTissueAndBathIdentifiers(tissue_ids, bath_ids);
+
+        // The right half of a 1cm fibre is switched off...
+        TetrahedralMesh<1,1> mesh;
+        mesh.ConstructRegularSlabMesh(0.01, 1.0);
+        for (TetrahedralMesh<1,1>::ElementIterator iter = mesh.GetElementIteratorBegin();
+             iter != mesh.GetElementIteratorEnd();
+             ++iter)
+        {
+            iter->SetAttribute(iter->CalculateCentroid()[0] > 0.5 ? 1.0 : 0.0);
+        }
+
+        PlaneStimulusCellFactory<CellLuoRudy1991FromCellML, 1> cell_factory;
+        MonodomainProblem<1> monodomain_problem(&cell_factory);
+        monodomain_problem.SetMesh(&mesh);
+        monodomain_problem.PrintOutput(false);
+        monodomain_problem.Initialise();
+
+        std::set<unsigned> inactive_regions;
+        inactive_regions.insert(2);
+        TS_ASSERT_THROWS_THIS(monodomain_problem.GetTissue()->SetInactiveRegions(inactive_regions),
+                              "Region 2 is not a tissue region, so cannot be made inactive.");
+        inactive_regions.clear();
+        inactive_regions.insert(1);
+        monodomain_problem.GetTissue()->SetInactiveRegions(inactive_regions);
+        TS_ASSERT(monodomain_problem.GetTissue()->HasInactiveRegions());
+
+        // Only the nodes strictly right of the middle have no active element
+        const std::vector<unsigned>& r_inactive_nodes = monodomain_problem.GetTissue()->rGetInactiveOwnedNodes();
+        unsigned num_inactive = r_inactive_nodes.size();
+        unsigned total_inactive;
+        MPI_Allreduce(&num_inactive, &total_inactive, 1, MPI_UNSIGNED, MPI_SUM, PETSC_COMM_WORLD);
+        TS_ASSERT_EQUALS(total_inactive, 50u);
+        for (unsigned i=0; i<r_inactive_nodes.size(); i++)
+        {
+            TS_ASSERT_LESS_THAN(50u, r_inactive_nodes[i]);
+        }
+
+        monodomain_problem.Solve();
+        ReplicatableVector voltage(monodomain_problem.GetSolution());
+        TS_ASSERT_EQUALS(voltage.GetSize(), 101u);
+
+        // ...so should behave like a 0.5cm fibre, with the rest held at rest
+        TetrahedralMesh<1,1> half_mesh;
+        half_mesh.ConstructRegularSlabMesh(0.01, 0.5);
+        MonodomainProblem<1> half_problem(&cell_factory);
+        half_problem.SetMesh(&half_mesh);
+        half_problem.PrintOutput(false);
+        half_problem.Initialise();
+        half_problem.Solve();
+        ReplicatableVector half_voltage(half_problem.GetSolution());
+
+        for (unsigned i=0; i<=50; i++)
+        {
+            TS_ASSERT_DELTA(voltage[i], half_voltage[i], 1e-3);
+        }
+        TS_ASSERT_LESS_THAN(-50.0, voltage[0]);
+        for (unsigned i=51; i<=100; i++)
+        {
+            TS_ASSERT_DELTA(voltage[i], -83.853, 1e-3);
+        }
+
+        // Only the implicit solver supports inactive regions
+        HeartConfig::Instance()->SetSimulationDuration(3.0); //ms
+        HeartConfig::Instance()->SetUseReactionDiffusionOperatorSplitting();
+        TS_ASSERT_THROWS_THIS(monodomain_problem.Solve(),
+                              "Inactive tissue regions are only supported by the implicit monodomain solver with assembled matrices");
+    }
 };
 
 #endif //_TESTMONODOMAINPROBLEM_HPP_
@@ -333,6 +333,44 @@ public:
         purkinje_problem.Solve();
     }
 
+    // The tree solver should give the same answer as solving the Purkinje block with the myocardium
+    void TestMonodomainPurkinjeProblemWithTreeSolver()
+    {
+        HeartConfig::Instance()->SetUseAbsoluteTolerance(1e-12);
+        HeartConfig::Instance()->SetOdePdeAndPrintingTimeSteps(0.01, 0.01, 0.1);
+        HeartConfig::Instance()->SetSimulationDuration(1.0);
+        HeartConfig::Instance()->SetPurkinjeSurfaceAreaToVolumeRatio(HeartConfig::Instance()->GetSurfaceAreaToVolumeRatio());
+        HeartConfig::Instance()->SetMeshFileName("mesh/test/data/mixed_dimension_meshes/2D_0_to_1mm_200_elements");
+
+        ReplicatableVector soln_repl[2];
+        for (unsigned use_tree_solver=0; use_tree_solver<2; use_tree_solver++)
+        {
+            HeartConfig::Instance()->SetOutputDirectory(use_tree_solver ? "TestMonodomainPurkinjeProblem_tree"
+                                                                        : "TestMonodomainPurkinjeProblem_block");
+            PurkinjeCellFactory cell_factory;
+            MonodomainPurkinjeProblem<2,2> purkinje_problem(&cell_factory);
+            purkinje_problem.SetUsePurkinjeTreeSolver(use_tree_solver==1);
+            purkinje_problem.Initialise();
+
+            MixedDimensionMesh<2, 2>& r_mesh = static_cast<MixedDimensionMesh<2, 2>& >(purkinje_problem.rGetMesh());
+            for (MixedDimensionMesh<2, 2>::CableElementIterator iter = r_mesh.GetCableElementIteratorBegin();
+                 iter != r_mesh.GetCableElementIteratorEnd();
+                 ++iter)
+            {
+                (*iter)->SetAttribute(1.0/std::sqrt(M_PI));
+            }
+
+            purkinje_problem.Solve();
+            soln_repl[use_tree_solver].ReplicatePetscVector(purkinje_problem.GetSolution());
+        }
+
+        TS_ASSERT_EQUALS(soln_repl[0].GetSize(), soln_repl[1].GetSize());
+        for (unsigned i=0; i<soln_repl[0].GetSize(); i++)
+        {
+            TS_ASSERT_DELTA(soln_repl[1][i], soln_repl[0][i], 1e-6);
+        }
+    }
+
     // Solve a Purkinje problem on a branched domain
     void TestBranchedMonodomainPurkinjeProblem()
     {
@@ -59,6 +59,8 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ArchiveOpener.hpp"
 #include "DiFrancescoNoble1985.hpp"
 #include "MonodomainProblem.hpp"
+#include "FitzHughNagumo1961OdeSystem.hpp"
+#include "FitzHughNagumo1961CellBatch.hpp"
 
 #include "PetscSetupAndFinalize.hpp"
 
@@ -127,6 +129,48 @@ public:
     }
 };
 
+/** A different model as far as batching is concerned, even though the equations are the same. */
+class UnbatchableFitzHughNagumoCell : public FitzHughNagumo1961OdeSystem
+{
+public:
+    UnbatchableFitzHughNagumoCell(boost::shared_ptr<AbstractIvpOdeSolver> pSolver,
+                                  boost::shared_ptr<AbstractStimulusFunction> pStimulus)
+        : FitzHughNagumo1961OdeSystem(pSolver, pStimulus)
+    {
+    }
+};
+
+class MixedFitzHughNagumoCellFactory : public AbstractCardiacCellFactory<1>
+{
+private:
+    boost::shared_ptr<SimpleStimulus> mpStimulus;
+
+public:
+    MixedFitzHughNagumoCellFactory()
+        : AbstractCardiacCellFactory<1>(),
+          mpStimulus(new SimpleStimulus(-600.0, 0.5))
+    {
+    }
+
+    AbstractCardiacCell* CreateCardiacCellForTissueNode(Node<1>* pNode)
+    {
+        unsigned node_index = pNode->GetIndex();
+        if (node_index == 5u)
+        {
+            // One cell that cannot be batched
+            return new UnbatchableFitzHughNagumoCell(mpSolver, mpZeroStimulus);
+        }
+        else if (node_index == 0u)
+        {
+            return new FitzHughNagumo1961OdeSystem(mpSolver, mpStimulus);
+        }
+        else
+        {
+            return new FitzHughNagumo1961OdeSystem(mpSolver, mpZeroStimulus);
+        }
+    }
+};
+
 class TestMonodomainTissue : public CxxTest::TestSuite
 {
 public:
@@ -322,6 +366,338 @@ public:
         PetscTools::Destroy(voltage2);
     }
 
+    void TestSolveCellSystemsWithThreads()
+    {
+        HeartConfig::Instance()->Reset();
+        TetrahedralMesh<1,1> mesh;
+        mesh.ConstructRegularSlabMesh(0.1, 1.0); // 11 nodes
+
+        MyCardiacCellFactory serial_cell_factory;
+        serial_cell_factory.SetMesh(&mesh);
+        MonodomainTissue<1> serial_tissue(&serial_cell_factory);
+        TS_ASSERT_EQUALS(serial_tissue.GetNumberOfOdeThreads(), 1u);
+
+        MyCardiacCellFactory threaded_cell_factory;
+        threaded_cell_factory.SetMesh(&mesh);
+        MonodomainTissue<1> threaded_tissue(&threaded_cell_factory);
+        TS_ASSERT_THROWS_THIS(threaded_tissue.SetNumberOfOdeThreads(0u),
+                              "The number of ODE threads must be at least one.");
+        threaded_tissue.SetNumberOfOdeThreads(4u);
+        TS_ASSERT_EQUALS(threaded_tissue.GetNumberOfOdeThreads(), 4u);
+
+        // Both with and without updating the voltage, the threaded sweep should match the serial one exactly
+        Vec serial_voltage = PetscTools::CreateAndSetVec(mesh.GetNumNodes(), -83.853);
+        Vec threaded_voltage = PetscTools::CreateAndSetVec(mesh.GetNumNodes(), -83.853);
+        serial_tissue.SolveCellSystems(serial_voltage, 0.0, 0.5, false);
+        threaded_tissue.SolveCellSystems(threaded_voltage, 0.0, 0.5, false);
+        serial_tissue.SolveCellSystems(serial_voltage, 0.5, 1.0, true);
+        threaded_tissue.SolveCellSystems(threaded_voltage, 0.5, 1.0, true);
+
+        ReplicatableVector serial_voltage_repl(serial_voltage);
+        ReplicatableVector threaded_voltage_repl(threaded_voltage);
+        DistributedVectorFactory* p_factory = mesh.GetDistributedVectorFactory();
+        for (unsigned index = p_factory->GetLow(); index < p_factory->GetHigh(); index++)
+        {
+            TS_ASSERT_EQUALS(threaded_voltage_repl[index], serial_voltage_repl[index]);
+            TS_ASSERT_EQUALS(threaded_tissue.rGetIionicCacheReplicated()[index],
+                             serial_tissue.rGetIionicCacheReplicated()[index]);
+            TS_ASSERT_EQUALS(threaded_tissue.rGetIntracellularStimulusCacheReplicated()[index],
+                             serial_tissue.rGetIntracellularStimulusCacheReplicated()[index]);
+
+            std::vector<double> serial_state = serial_tissue.GetCardiacCell(index)->GetStdVecStateVariables();
+            std::vector<double> threaded_state = threaded_tissue.GetCardiacCell(index)->GetStdVecStateVariables();
+            TS_ASSERT_EQUALS(threaded_state.size(), serial_state.size());
+            for (unsigned i=0; i<serial_state.size(); i++)
+            {
+                TS_ASSERT_EQUALS(threaded_state[i], serial_state[i]);
+            }
+        }
+
+        PetscTools::Destroy(serial_voltage);
+        PetscTools::Destroy(threaded_voltage);
+    }
+
+    void TestSolveCellSystemsWithCellBatch()
+    {
+        HeartConfig::Instance()->Reset();
+        TetrahedralMesh<1,1> mesh;
+        mesh.ConstructRegularSlabMesh(0.1, 1.0); // 11 nodes
+
+        MixedFitzHughNagumoCellFactory plain_cell_factory;
+        plain_cell_factory.SetMesh(&mesh);
+        MonodomainTissue<1> plain_tissue(&plain_cell_factory);
+
+        MixedFitzHughNagumoCellFactory batched_cell_factory;
+        batched_cell_factory.SetMesh(&mesh);
+        MonodomainTissue<1> batched_tissue(&batched_cell_factory);
+        // A small batch size so that several batches are needed
+        boost::shared_ptr<AbstractCardiacCellBatch> p_batch(new FitzHughNagumo1961CellBatch(3u));
+        batched_tissue.SetCellBatch(p_batch);
+
+        Vec plain_voltage = PetscTools::CreateAndSetVec(mesh.GetNumNodes(), 0.0);
+        Vec batched_voltage = PetscTools::CreateAndSetVec(mesh.GetNumNodes(), 0.0);
+        plain_tissue.SolveCellSystems(plain_voltage, 0.0, 0.5, false);
+        batched_tissue.SolveCellSystems(batched_voltage, 0.0, 0.5, false);
+        plain_tissue.SolveCellSystems(plain_voltage, 0.5, 1.0, true);
+        batched_tissue.SolveCellSystems(batched_voltage, 0.5, 1.0, true);
+
+        ReplicatableVector plain_voltage_repl(plain_voltage);
+        ReplicatableVector batched_voltage_repl(batched_voltage);
+        DistributedVectorFactory* p_factory = mesh.GetDistributedVectorFactory();
+        for (unsigned index = p_factory->GetLow(); index < p_factory->GetHigh(); index++)
+        {
+            TS_ASSERT_DELTA(batched_voltage_repl[index], plain_voltage_repl[index], 1e-12);
+            TS_ASSERT_DELTA(batched_tissue.rGetIionicCacheReplicated()[index],
+                            plain_tissue.rGetIionicCacheReplicated()[index], 1e-12);
+            TS_ASSERT_DELTA(batched_tissue.rGetIntracellularStimulusCacheReplicated()[index],
+                            plain_tissue.rGetIntracellularStimulusCacheReplicated()[index], 1e-12);
+        }
+
+        PetscTools::Destroy(plain_voltage);
+        PetscTools::Destroy(batched_voltage);
+    }
+
+    void TestSolveCellSystemsWithResidentCellBatch()
+    {
+        HeartConfig::Instance()->Reset();
+        TetrahedralMesh<1,1> mesh;
+        mesh.ConstructRegularSlabMesh(0.1, 1.0); // 11 nodes
+
+        MixedFitzHughNagumoCellFactory plain_cell_factory;
+        plain_cell_factory.SetMesh(&mesh);
+        MonodomainTissue<1> plain_tissue(&plain_cell_factory);
+        boost::shared_ptr<AbstractCardiacCellBatch> p_plain_batch(new FitzHughNagumo1961CellBatch(3u));
+        plain_tissue.SetCellBatch(p_plain_batch);
+
+        MixedFitzHughNagumoCellFactory resident_cell_factory;
+        resident_cell_factory.SetMesh(&mesh);
+        MonodomainTissue<1> resident_tissue(&resident_cell_factory);
+        boost::shared_ptr<AbstractCardiacCellBatch> p_resident_batch(new FitzHughNagumo1961CellBatch(3u));
+        TS_ASSERT(!p_resident_batch->GetKeepStateResident());
+        p_resident_batch->SetKeepStateResident();
+        TS_ASSERT(p_resident_batch->GetKeepStateResident());
+        resident_tissue.SetCellBatch(p_resident_batch);
+
+        Vec plain_voltage = PetscTools::CreateAndSetVec(mesh.GetNumNodes(), 0.0);
+        Vec resident_voltage = PetscTools::CreateAndSetVec(mesh.GetNumNodes(), 0.0);
+        DistributedVectorFactory* p_factory = mesh.GetDistributedVectorFactory();
+        for (unsigned step=0; step<4; step++)
+        {
+            const double time = 0.25*step;
+            plain_tissue.SolveCellSystems(plain_voltage, time, time+0.25, step >= 2);
+            resident_tissue.SolveCellSystems(resident_voltage, time, time+0.25, step >= 2);
+
+            ReplicatableVector plain_voltage_repl(plain_voltage);
+            ReplicatableVector resident_voltage_repl(resident_voltage);
+            for (unsigned index = p_factory->GetLow(); index < p_factory->GetHigh(); index++)
+            {
+                TS_ASSERT_DELTA(resident_voltage_repl[index], plain_voltage_repl[index], 1e-12);
+                TS_ASSERT_DELTA(resident_tissue.rGetIionicCacheReplicated()[index],
+                                plain_tissue.rGetIionicCacheReplicated()[index], 1e-12);
+                TS_ASSERT_DELTA(resident_tissue.rGetIntracellularStimulusCacheReplicated()[index],
+                                plain_tissue.rGetIntracellularStimulusCacheReplicated()[index], 1e-12);
+            }
+        }
+
+        // Getting hold of a cell brings it up to date
+        for (unsigned index = p_factory->GetLow(); index < p_factory->GetHigh(); index++)
+        {
+            std::vector<double> plain_state = plain_tissue.GetCardiacCell(index)->GetStdVecStateVariables();
+            std::vector<double> resident_state = resident_tissue.GetCardiacCell(index)->GetStdVecStateVariables();
+            TS_ASSERT_EQUALS(resident_state.size(), plain_state.size());
+            for (unsigned k=0; k<plain_state.size(); k++)
+            {
+                TS_ASSERT_DELTA(resident_state[k], plain_state[k], 1e-12);
+            }
+        }
+
+        // Changes made to the cells are picked up by the next solve
+        for (unsigned index = p_factory->GetLow(); index < p_factory->GetHigh(); index++)
+        {
+            plain_tissue.GetCardiacCell(index)->SetStateVariable(1u, 0.1);
+            resident_tissue.GetCardiacCell(index)->SetStateVariable(1u, 0.1);
+        }
+        plain_tissue.SolveCellSystems(plain_voltage, 1.0, 1.25, true);
+        resident_tissue.SolveCellSystems(resident_voltage, 1.0, 1.25, true);
+        ReplicatableVector plain_voltage_repl(plain_voltage);
+        ReplicatableVector resident_voltage_repl(resident_voltage);
+        for (unsigned index = p_factory->GetLow(); index < p_factory->GetHigh(); index++)
+        {
+            TS_ASSERT_DELTA(resident_voltage_repl[index], plain_voltage_repl[index], 1e-12);
+            TS_ASSERT_DELTA(resident_tissue.rGetIionicCacheReplicated()[index],
+                            plain_tissue.rGetIionicCacheReplicated()[index], 1e-12);
+        }
+
+        PetscTools::Destroy(plain_voltage);
+        PetscTools::Destroy(resident_voltage);
+    }
+
+    void TestChangingInactiveRegionsWithResidentCellBatch()
+    {
+        HeartConfig::Instance()->Reset();
+        TetrahedralMesh<1,1> mesh;
+        mesh.ConstructRegularSlabMesh(0.1, 1.0); // 11 nodes
+        for (TetrahedralMesh<1,1>::ElementIterator iter = mesh.GetElementIteratorBegin();
+             iter != mesh.GetElementIteratorEnd();
+             ++iter)
+        {
+            iter->SetAttribute(iter->CalculateCentroid()[0] > 0.5 ? 1.0 : 0.0);
+        }
+
+        MixedFitzHughNagumoCellFactory plain_cell_factory;
+        plain_cell_factory.SetMesh(&mesh);
+        MonodomainTissue<1> plain_tissue(&plain_cell_factory);
+
+        MixedFitzHughNagumoCellFactory resident_cell_factory;
+        resident_cell_factory.SetMesh(&mesh);
+        MonodomainTissue<1> resident_tissue(&resident_cell_factory);
+        boost::shared_ptr<AbstractCardiacCellBatch> p_resident_batch(new FitzHughNagumo1961CellBatch(3u));
+        p_resident_batch->SetKeepStateResident();
+        resident_tissue.SetCellBatch(p_resident_batch);
+
+        // Switch the right half off and on again part-way through; the batched cells must
+        // not lose (or go back on) their state when the batch membership changes
+        std::set<unsigned> right_half;
+        right_half.insert(1u);
+        std::set<unsigned> none;
+
+        Vec plain_voltage = PetscTools::CreateAndSetVec(mesh.GetNumNodes(), 0.0);
+        Vec resident_voltage = PetscTools::CreateAndSetVec(mesh.GetNumNodes(), 0.0);
+        DistributedVectorFactory* p_factory = mesh.GetDistributedVectorFactory();
+        for (unsigned step=0; step<6; step++)
+        {
+            if (step == 2u || step == 4u)
+            {
+                plain_tissue.SetInactiveRegions(step == 2u ? right_half : none);
+                resident_tissue.SetInactiveRegions(step == 2u ? right_half : none);
+            }
+            const double time = 0.25*step;
+            plain_tissue.SolveCellSystems(plain_voltage, time, time+0.25, false);
+            resident_tissue.SolveCellSystems(resident_voltage, time, time+0.25, false);
+
+            for (unsigned index = p_factory->GetLow(); index < p_factory->GetHigh(); index++)
+            {
+                TS_ASSERT_DELTA(resident_tissue.rGetIionicCacheReplicated()[index],
+                                plain_tissue.rGetIionicCacheReplicated()[index], 1e-12);
+            }
+        }
+
+        for (unsigned index = p_factory->GetLow(); index < p_factory->GetHigh(); index++)
+        {
+            std::vector<double> plain_state = plain_tissue.GetCardiacCell(index)->GetStdVecStateVariables();
+            std::vector<double> resident_state = resident_tissue.GetCardiacCell(index)->GetStdVecStateVariables();
+            for (unsigned k=0; k<plain_state.size(); k++)
+            {
+                TS_ASSERT_DELTA(resident_state[k], plain_state[k], 1e-12);
+            }
+        }
+
+        PetscTools::Destroy(plain_voltage);
+        PetscTools::Destroy(resident_voltage);
+    }
+
+    void TestActivityAwareOdeScheduling()
+    {
+        HeartConfig::Instance()->Reset();
+        TetrahedralMesh<1,1> mesh;
+        mesh.ConstructRegularSlabMesh(0.1, 1.0); // 11 nodes, only node 0 is stimulated
+
+        MyCardiacCellFactory plain_cell_factory;
+        plain_cell_factory.SetMesh(&mesh);
+        MonodomainTissue<1> plain_tissue(&plain_cell_factory);
+
+        MyCardiacCellFactory scheduled_cell_factory;
+        scheduled_cell_factory.SetMesh(&mesh);
+        MonodomainTissue<1> scheduled_tissue(&scheduled_cell_factory);
+        TS_ASSERT_THROWS_THIS(scheduled_tissue.SetActivityAwareOdeScheduling(-70.0, 0.0, 1.0, 0.1),
+                              "The dV/dt threshold, maximum deferred time and catch-up "
+                              "time step for activity-aware ODE scheduling must be positive.");
+        scheduled_tissue.SetActivityAwareOdeScheduling(-70.0, 0.01, 1.0, 0.1);
+        TS_ASSERT_EQUALS(scheduled_tissue.GetNumberOfDeferredCells(), 0u);
+
+        // Without a PDE the voltages passed in don't change, so only the stimulated cell is active at first
+        const double resting_voltage = -83.853;
+        Vec plain_voltage = PetscTools::CreateAndSetVec(mesh.GetNumNodes(), resting_voltage);
+        Vec scheduled_voltage = PetscTools::CreateAndSetVec(mesh.GetNumNodes(), resting_voltage);
+        DistributedVectorFactory* p_factory = mesh.GetDistributedVectorFactory();
+        bool owns_node_0 = p_factory->IsGlobalIndexLocal(0);
+        unsigned num_local_quiescent = p_factory->GetLocalOwnership() - (owns_node_0 ? 1u : 0u);
+
+        // Cells with their own ODE time step keep it after being caught up
+        const double own_ode_dt = 0.005;
+        for (unsigned index = p_factory->GetLow(); index < p_factory->GetHigh(); index++)
+        {
+            plain_tissue.GetCardiacCell(index)->SetTimestep(own_ode_dt);
+            scheduled_tissue.GetCardiacCell(index)->SetTimestep(own_ode_dt);
+        }
+
+        double pde_dt = 0.1;
+        for (unsigned step=0; step<15; step++)
+        {
+            double time = step*pde_dt;
+            plain_tissue.SolveCellSystems(plain_voltage, time, time+pde_dt);
+            scheduled_tissue.SolveCellSystems(scheduled_voltage, time, time+pde_dt);
+            if (step == 0)
+            {
+                // dV/dt is not yet known, so every cell is solved
+                TS_ASSERT_EQUALS(scheduled_tissue.GetNumberOfDeferredCells(), 0u);
+            }
+            else if (step == 2)
+            {
+                // Everything except the stimulated cell has been deferred since the second step
+                TS_ASSERT_EQUALS(scheduled_tissue.GetNumberOfDeferredCells(), num_local_quiescent);
+            }
+        }
+
+        for (unsigned index = p_factory->GetLow(); index < p_factory->GetHigh(); index++)
+        {
+            if (index == 0u)
+            {
+                // Solved every step, so identical
+                TS_ASSERT_EQUALS(scheduled_tissue.rGetIionicCacheReplicated()[index],
+                                 plain_tissue.rGetIionicCacheReplicated()[index]);
+            }
+            else
+            {
+                // Resting cells hardly change, so the deferred solves make little difference
+                TS_ASSERT_DELTA(scheduled_tissue.rGetIionicCacheReplicated()[index],
+                                plain_tissue.rGetIionicCacheReplicated()[index], 1e-3);
+            }
+            TS_ASSERT_EQUALS(scheduled_tissue.GetCardiacCell(index)->GetTimestep(), own_ode_dt);
+        }
+
+        PetscTools::Destroy(plain_voltage);
+        PetscTools::Destroy(scheduled_voltage);
+    }
+
+    void TestRecordCellSolveTimes()
+    {
+        HeartConfig::Instance()->Reset();
+        DistributedTetrahedralMesh<1,1> mesh;
+        mesh.ConstructRegularSlabMesh(0.1, 1.0);
+
+        MyCardiacCellFactory cell_factory;
+        cell_factory.SetMesh(&mesh);
+        MonodomainTissue<1> monodomain_tissue(&cell_factory);
+
+        TS_ASSERT_THROWS_THIS(monodomain_tissue.GetNodeWeightsFromCellSolveTimes(),
+                              "Cell solve times have not been recorded; call "
+                              "SetRecordCellSolveTimes() before solving.");
+        monodomain_tissue.SetRecordCellSolveTimes();
+
+        Vec voltage = PetscTools::CreateAndSetVec(mesh.GetNumNodes(), -83.853);
+        monodomain_tissue.SolveCellSystems(voltage, 0.0, 1.0);
+
+        std::vector<double> weights = monodomain_tissue.GetNodeWeightsFromCellSolveTimes();
+        TS_ASSERT_EQUALS(weights.size(), mesh.GetNumNodes());
+        for (unsigned i=0; i<weights.size(); i++)
+        {
+            TS_ASSERT_LESS_THAN_EQUALS(0.0, weights[i]);
+        }
+
+        PetscTools::Destroy(voltage);
+    }
+
     void TestNodeExchange()
     {
         HeartConfig::Instance()->Reset();
@@ -373,6 +749,57 @@ public:
         }
     }
 
+    void TestHaloOnlyCacheReplication()
+    {
+        HeartConfig::Instance()->Reset();
+        DistributedTetrahedralMesh<1,1> mesh;
+        mesh.ConstructRegularSlabMesh(0.1, 1.0); // 11 nodes
+
+        MyCardiacCellFactory full_cell_factory;
+        full_cell_factory.SetMesh(&mesh);
+        MonodomainTissue<1> full_tissue(&full_cell_factory);
+        TS_ASSERT(full_tissue.GetDoCacheReplication());
+        TS_ASSERT(!full_tissue.GetHaloOnlyCacheReplication());
+
+        MyCardiacCellFactory halo_cell_factory;
+        halo_cell_factory.SetMesh(&mesh);
+        MonodomainTissue<1> halo_tissue(&halo_cell_factory);
+        halo_tissue.SetHaloOnlyCacheReplication();
+        TS_ASSERT(halo_tissue.GetHaloOnlyCacheReplication());
+
+        DistributedVectorFactory* p_factory = mesh.GetDistributedVectorFactory();
+        Vec voltage = p_factory->CreateVec();
+        VecSet(voltage, -84.5);
+
+        // Several steps, so that the persistent requests get reused
+        for (unsigned step=0; step<3; step++)
+        {
+            const double time = 0.01*step;
+            full_tissue.SolveCellSystems(voltage, time, time+0.01);
+            halo_tissue.SolveCellSystems(voltage, time, time+0.01);
+
+            for (unsigned index = p_factory->GetLow(); index < p_factory->GetHigh(); index++)
+            {
+                TS_ASSERT_DELTA(halo_tissue.rGetIionicCacheReplicated()[index],
+                                full_tissue.rGetIionicCacheReplicated()[index], 1e-12);
+                TS_ASSERT_DELTA(halo_tissue.rGetIntracellularStimulusCacheReplicated()[index],
+                                full_tissue.rGetIntracellularStimulusCacheReplicated()[index], 1e-12);
+            }
+            for (DistributedTetrahedralMesh<1,1>::HaloNodeIterator it=mesh.GetHaloNodeIteratorBegin();
+                 it != mesh.GetHaloNodeIteratorEnd();
+                 ++it)
+            {
+                unsigned index = (*it)->GetIndex();
+                TS_ASSERT_DELTA(halo_tissue.rGetIionicCacheReplicated()[index],
+                                full_tissue.rGetIionicCacheReplicated()[index], 1e-12);
+                TS_ASSERT_DELTA(halo_tissue.rGetIntracellularStimulusCacheReplicated()[index],
+                                full_tissue.rGetIntracellularStimulusCacheReplicated()[index], 1e-12);
+            }
+        }
+
+        PetscTools::Destroy(voltage);
+    }
+
     void TestSolveCellSystemsInclUpdateVoltageWithNodeExchange()
     {
         if (PetscTools::GetNumProcs() > 2u)
@@ -447,6 +874,63 @@ public:
         PetscTools::Destroy(voltage2);
     }
 
+    void TestOverlappedHaloCommunication()
+    {
+        HeartConfig::Instance()->Reset();
+        DistributedTetrahedralMesh<1,1> mesh;
+        mesh.ConstructRegularSlabMesh(0.1, 1.0); // 11 nodes
+
+        MyCardiacCellFactory blocking_cell_factory;
+        blocking_cell_factory.SetMesh(&mesh);
+        MonodomainTissue<1> blocking_tissue(&blocking_cell_factory, true);
+        blocking_tissue.SetHaloOnlyCacheReplication();
+
+        MyCardiacCellFactory overlapped_cell_factory;
+        overlapped_cell_factory.SetMesh(&mesh);
+        MonodomainTissue<1> overlapped_tissue(&overlapped_cell_factory, true);
+        overlapped_tissue.SetHaloOnlyCacheReplication();
+        TS_ASSERT(!overlapped_tissue.GetOverlapHaloCommunication());
+        overlapped_tissue.SetOverlapHaloCommunication();
+        TS_ASSERT(overlapped_tissue.GetOverlapHaloCommunication());
+
+        DistributedVectorFactory* p_factory = mesh.GetDistributedVectorFactory();
+        Vec blocking_voltage = p_factory->CreateVec();
+        Vec overlapped_voltage = p_factory->CreateVec();
+        VecSet(blocking_voltage, -81.4354);
+        VecSet(overlapped_voltage, -81.4354);
+        for (unsigned step=0; step<3; step++)
+        {
+            const double time = 0.5*step;
+            blocking_tissue.SolveCellSystems(blocking_voltage, time, time+0.5, step > 0);
+            overlapped_tissue.SolveCellSystems(overlapped_voltage, time, time+0.5, step > 0);
+        }
+
+        ReplicatableVector blocking_voltage_repl(blocking_voltage);
+        ReplicatableVector overlapped_voltage_repl(overlapped_voltage);
+        for (unsigned index = p_factory->GetLow(); index < p_factory->GetHigh(); index++)
+        {
+            TS_ASSERT_DELTA(overlapped_voltage_repl[index], blocking_voltage_repl[index], 1e-12);
+        }
+        for (DistributedTetrahedralMesh<1,1>::HaloNodeIterator it=mesh.GetHaloNodeIteratorBegin();
+             it != mesh.GetHaloNodeIteratorEnd();
+             ++it)
+        {
+            unsigned index = (*it)->GetIndex();
+            std::vector<double> blocking_state = blocking_tissue.GetCardiacCellOrHaloCell(index)->GetStdVecStateVariables();
+            std::vector<double> overlapped_state = overlapped_tissue.GetCardiacCellOrHaloCell(index)->GetStdVecStateVariables();
+            TS_ASSERT_EQUALS(overlapped_state.size(), blocking_state.size());
+            for (unsigned k=0; k<blocking_state.size(); k++)
+            {
+                TS_ASSERT_DELTA(overlapped_state[k], blocking_state[k], 1e-12);
+            }
+            TS_ASSERT_DELTA(overlapped_tissue.rGetIionicCacheReplicated()[index],
+                            blocking_tissue.rGetIionicCacheReplicated()[index], 1e-12);
+        }
+
+        PetscTools::Destroy(blocking_voltage);
+        PetscTools::Destroy(overlapped_voltage);
+    }
+
     void TestSaveAndLoadCardiacTissue()
     {
         HeartConfig::Instance()->Reset();
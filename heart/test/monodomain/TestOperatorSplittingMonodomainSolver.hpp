@@ -42,6 +42,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <boost/archive/text_iarchive.hpp>
 #include <vector>
 #include "MonodomainProblem.hpp"
+#include "Hdf5DataReader.hpp"
 #include "ZeroStimulusCellFactory.hpp"
 #include "AbstractCardiacCellFactory.hpp"
 #include "LuoRudy1991BackwardEuler.hpp"
@@ -170,6 +171,58 @@ public:
         UNUSED_OPT(some_node_depolarised);
         assert(some_node_depolarised);
     }
+
+    // Fusing the half steps is opt-in. When fused, within each printing timestep the second half step of the
+    // cell models is solved together with the first half step of the next timestep. With ode_dt=pde_dt/2 the
+    // cell models take the same steps whether or not the half steps are fused, so the voltages written at
+    // every printing time should agree.
+    void TestFusedHalfStepsMatchUnfused()
+    {
+        HeartConfig::Instance()->SetSimulationDuration(2.0); //ms
+        HeartConfig::Instance()->SetOutputFilenamePrefix("results");
+        HeartConfig::Instance()->SetUseReactionDiffusionOperatorSplitting();
+        HeartConfig::Instance()->SetOdePdeAndPrintingTimeSteps(0.005, 0.01, 0.1);
+
+        std::vector<std::vector<std::vector<double> > > voltages(2);
+        std::vector<std::vector<double> > times(2);
+        for (unsigned i=0; i<2; i++)
+        {
+            bool fused = (i==1);
+            HeartConfig::Instance()->SetOutputDirectory(fused ? "OperatorSplittingFusedHalfSteps" : "OperatorSplittingUnfusedHalfSteps");
+
+            TetrahedralMesh<1,1> mesh;
+            mesh.ConstructRegularSlabMesh(0.01, 1.0);
+            BlockCellFactory<1> cell_factory;
+
+            MonodomainProblem<1> monodomain_problem( &cell_factory );
+            TS_ASSERT_EQUALS(monodomain_problem.GetFuseOperatorSplittingHalfSteps(), false);
+            if (fused)
+            {
+                monodomain_problem.SetFuseOperatorSplittingHalfSteps();
+                TS_ASSERT_EQUALS(monodomain_problem.GetFuseOperatorSplittingHalfSteps(), true);
+            }
+            monodomain_problem.SetMesh(&mesh);
+            monodomain_problem.Initialise();
+            monodomain_problem.Solve();
+
+            Hdf5DataReader data_reader = monodomain_problem.GetDataReader();
+            times[i] = data_reader.GetUnlimitedDimensionValues();
+            voltages[i] = data_reader.GetVariableOverTimeOverMultipleNodes("V", 0, mesh.GetNumNodes());
+        }
+
+        TS_ASSERT_EQUALS(times[0].size(), 21u);
+        TS_ASSERT_EQUALS(times[0].size(), times[1].size());
+        TS_ASSERT_EQUALS(voltages[0].size(), voltages[1].size());
+        for (unsigned node=0; node<voltages[0].size(); node++)
+        {
+            for (unsigned t=0; t<times[0].size(); t++)
+            {
+                TS_ASSERT_DELTA(voltages[0][node][t], voltages[1][node][t], 1e-6);
+            }
+        }
+        // check something happened
+        TS_ASSERT_LESS_THAN(-80.0, voltages[1][0].back());
+    }
 };
 
 #endif /* TESTOPERATORSPLITTINGMONODOMAINSOLVER_HPP_ */
@@ -0,0 +1,189 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTPARAREALCARDIACDRIVER_HPP_
+#define TESTPARAREALCARDIACDRIVER_HPP_
+
+#include <cxxtest/TestSuite.h>
+
+#include "PararealCardiacDriver.hpp"
+#include "MonodomainProblem.hpp"
+#include "PlaneStimulusCellFactory.hpp"
+#include "LuoRudy1991.hpp"
+#include "ReplicatableVector.hpp"
+#include "PetscSetupAndFinalize.hpp"
+
+class TestPararealCardiacDriver : public CxxTest::TestSuite
+{
+private:
+    void SetUpConfig()
+    {
+        HeartConfig::Instance()->SetIntracellularConductivities(Create_c_vector(0.0005));
+        HeartConfig::Instance()->SetSurfaceAreaToVolumeRatio(1.0);
+        HeartConfig::Instance()->SetCapacitance(1.0);
+        HeartConfig::Instance()->SetUseAbsoluteTolerance(1e-12);
+        HeartConfig::Instance()->SetOdePdeAndPrintingTimeSteps(0.01, 0.01, 0.1);
+        HeartConfig::Instance()->SetSimulationDuration(2.0);
+        HeartConfig::Instance()->SetMeshFileName("mesh/test/data/1D_0_to_1mm_10_elements");
+        HeartConfig::Instance()->SetOutputDirectory("TestPararealCardiacDriver");
+        HeartConfig::Instance()->SetOutputFilenamePrefix("results");
+    }
+
+public:
+    void TestPararealReproducesFineSolution()
+    {
+        SetUpConfig();
+        PlaneStimulusCellFactory<CellLuoRudy1991FromCellML, 1> cell_factory;
+
+        MonodomainProblem<1> serial_problem(&cell_factory);
+        serial_problem.PrintOutput(false);
+        serial_problem.Initialise();
+        serial_problem.Solve();
+        ReplicatableVector serial_solution(serial_problem.GetSolution());
+
+        // Four slices on this space group; as many iterations as slices gives the fine solution
+        MonodomainProblem<1> problem(&cell_factory);
+        problem.PrintOutput(false);
+        problem.Initialise();
+
+        PararealCardiacDriver<1,1,1> driver(&problem, PETSC_COMM_SELF);
+        TS_ASSERT_EQUALS(driver.GetTimeRank(), 0u);
+        driver.SetCoarseTimeSteps(0.01, 0.1);
+        driver.SetNumSlicesPerProcess(4);
+        driver.SetTolerance(0.0);
+        driver.Solve(2.0);
+
+        TS_ASSERT_EQUALS(driver.GetNumIterations(), 4u);
+        TS_ASSERT_DELTA(problem.GetCurrentTime(), 2.0, 1e-12);
+        ReplicatableVector parareal_solution(problem.GetSolution());
+        TS_ASSERT_EQUALS(parareal_solution.GetSize(), serial_solution.GetSize());
+        for (unsigned i=0; i<serial_solution.GetSize(); i++)
+        {
+            TS_ASSERT_DELTA(parareal_solution[i], serial_solution[i], 1e-6);
+        }
+        // The stimulated end has fired
+        TS_ASSERT_LESS_THAN(0.0, serial_solution[0]);
+    }
+
+    void TestPararealAcrossProcesses()
+    {
+        // Each process becomes a space group of its own, holding one time slice
+        const unsigned num_procs = PetscTools::GetNumProcs();
+        if (num_procs > 20 || 20 % num_procs != 0)
+        {
+            TS_TRACE("This test needs the slices to be whole printing time steps");
+            return;
+        }
+        SetUpConfig();
+        PlaneStimulusCellFactory<CellLuoRudy1991FromCellML, 1> cell_factory;
+
+        MonodomainProblem<1> serial_problem(&cell_factory);
+        serial_problem.PrintOutput(false);
+        serial_problem.Initialise();
+        serial_problem.Solve();
+        ReplicatableVector serial_solution(serial_problem.GetSolution());
+
+        MPI_Comm time_communicator = PararealCardiacDriver<1,1,1>::SplitCommunicators(num_procs);
+        TS_ASSERT(PetscTools::IsSequential());
+        {
+            MonodomainProblem<1> problem(&cell_factory);
+            problem.PrintOutput(false);
+            problem.Initialise();
+
+            PararealCardiacDriver<1,1,1> driver(&problem, time_communicator);
+            driver.SetCoarseTimeSteps(0.01, 0.1);
+            driver.SetTolerance(0.0);
+            driver.Solve(2.0);
+            TS_ASSERT_EQUALS(driver.GetNumIterations(), num_procs);
+
+            if (driver.GetTimeRank() + 1 == num_procs)
+            {
+                ReplicatableVector parareal_solution(problem.GetSolution());
+                for (unsigned i=0; i<serial_solution.GetSize(); i++)
+                {
+                    TS_ASSERT_DELTA(parareal_solution[i], serial_solution[i], 1e-6);
+                }
+            }
+        }
+        MPI_Comm space_communicator = PetscTools::GetWorld();
+        PetscTools::SetWorld(PETSC_COMM_WORLD);
+        MPI_Comm_free(&space_communicator);
+        MPI_Comm_free(&time_communicator);
+        TS_ASSERT_EQUALS(PetscTools::GetNumProcs(), num_procs);
+    }
+
+    void TestPararealStopsWhenConverged()
+    {
+        SetUpConfig();
+        PlaneStimulusCellFactory<CellLuoRudy1991FromCellML, 1> cell_factory;
+        MonodomainProblem<1> problem(&cell_factory);
+        problem.PrintOutput(false);
+        problem.Initialise();
+
+        PararealCardiacDriver<1,1,1> driver(&problem, PETSC_COMM_SELF);
+        driver.SetCoarseTimeSteps(0.01, 0.1);
+        driver.SetNumSlicesPerProcess(4);
+        driver.SetTolerance(1e3);
+        driver.Solve(2.0);
+        TS_ASSERT_EQUALS(driver.GetNumIterations(), 1u);
+
+        driver.SetTolerance(0.0);
+        driver.SetMaxIterations(2);
+        driver.Solve(4.0);
+        TS_ASSERT_EQUALS(driver.GetNumIterations(), 2u);
+        TS_ASSERT_DELTA(problem.GetCurrentTime(), 4.0, 1e-12);
+    }
+
+    void TestExceptions()
+    {
+        SetUpConfig();
+        PlaneStimulusCellFactory<CellLuoRudy1991FromCellML, 1> cell_factory;
+        MonodomainProblem<1> problem(&cell_factory);
+        problem.PrintOutput(false);
+        problem.Initialise();
+
+        TS_ASSERT_THROWS_CONTAINS(PararealCardiacDriver<1,1,1>::SplitCommunicators(0),
+                                  "The number of time processes (0) must divide the number of processes");
+
+        PararealCardiacDriver<1,1,1> driver(&problem, PETSC_COMM_SELF);
+        TS_ASSERT_THROWS_THIS(driver.SetNumSlicesPerProcess(0), "Each time process needs at least one time slice");
+        TS_ASSERT_THROWS_THIS(driver.Solve(0.0), "End time should be in the future");
+        driver.SetNumSlicesPerProcess(3);
+        TS_ASSERT_THROWS_THIS(driver.Solve(2.0),
+                              "Each time slice (0.666667 ms) must be a whole number of printing time steps and of coarse PDE time steps");
+    }
+};
+
+#endif // TESTPARAREALCARDIACDRIVER_HPP_
@@ -0,0 +1,162 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef TESTWAVEFRONTREFINEMENTINDICATOR_HPP_
+#define TESTWAVEFRONTREFINEMENTINDICATOR_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include <vector>
+
+#include "TetrahedralMesh.hpp"
+#include "WavefrontRefinementIndicator.hpp"
+#include "DistributedVector.hpp"
+#include "EulerIvpOdeSolver.hpp"
+#include "ZeroStimulus.hpp"
+#include "LuoRudy1991.hpp"
+#include "FitzHughNagumo1961OdeSystem.hpp"
+#include "PetscSetupAndFinalize.hpp"
+
+class TestWavefrontRefinementIndicator : public CxxTest::TestSuite
+{
+public:
+    void TestIndicatorFindsFront()
+    {
+        TetrahedralMesh<2,2> mesh;
+        mesh.ConstructRegularSlabMesh(0.1, 1.0, 1.0);
+        DistributedVectorFactory* p_factory = mesh.GetDistributedVectorFactory();
+
+        TS_ASSERT_THROWS_THIS((WavefrontRefinementIndicator<2>(mesh, 10.0, 20.0)),
+                              "Wave front refinement threshold must exceed the coarsening threshold, which must not be negative");
+
+        // At rest for x < 0.5, and a front of 100 mV/cm beyond
+        Vec solution = p_factory->CreateVec();
+        DistributedVector distributed_solution = p_factory->CreateDistributedVector(solution);
+        for (DistributedVector::Iterator index = distributed_solution.Begin();
+             index != distributed_solution.End();
+             ++index)
+        {
+            double x = mesh.GetNode(index.Global)->rGetLocation()[0];
+            distributed_solution[index] = -85.0 + std::max(0.0, 100.0*(x - 0.5));
+        }
+        distributed_solution.Restore();
+
+        WavefrontRefinementIndicator<2> indicator(mesh, 50.0, 1.0);
+        indicator.ComputeIndicator(solution);
+        TS_ASSERT_DELTA(indicator.GetMaximumGradient(), 100.0, 1e-9);
+
+        // The grid line x = 0.5 separates the two halves of the mesh
+        unsigned num_front_elements = 0;
+        for (unsigned i=0; i<mesh.GetNumElements(); i++)
+        {
+            if (mesh.GetElement(i)->CalculateCentroid()[0] > 0.5)
+            {
+                num_front_elements++;
+            }
+        }
+        const std::vector<unsigned>& r_refine = indicator.rGetElementsToRefine();
+        const std::vector<unsigned>& r_coarsen = indicator.rGetElementsToCoarsen();
+        TS_ASSERT_EQUALS(r_refine.size(), num_front_elements);
+        TS_ASSERT_EQUALS(r_coarsen.size(), mesh.GetNumElements() - num_front_elements);
+        for (unsigned i=0; i<r_refine.size(); i++)
+        {
+            TS_ASSERT_LESS_THAN(0.5, mesh.GetElement(r_refine[i])->CalculateCentroid()[0]);
+        }
+        for (unsigned i=0; i<r_coarsen.size(); i++)
+        {
+            TS_ASSERT_LESS_THAN(mesh.GetElement(r_coarsen[i])->CalculateCentroid()[0], 0.5);
+        }
+
+        // With two unknowns per node only the first is the transmembrane potential
+        Vec striped_solution = p_factory->CreateVec(2);
+        DistributedVector distributed_striped = p_factory->CreateDistributedVector(striped_solution);
+        DistributedVector::Stripe voltage(distributed_striped, 0);
+        DistributedVector::Stripe extracellular(distributed_striped, 1);
+        for (DistributedVector::Iterator index = distributed_striped.Begin();
+             index != distributed_striped.End();
+             ++index)
+        {
+            voltage[index] = 20.0*mesh.GetNode(index.Global)->rGetLocation()[1];
+            extracellular[index] = 1000.0*mesh.GetNode(index.Global)->rGetLocation()[0];
+        }
+        distributed_striped.Restore();
+        indicator.ComputeIndicator(striped_solution, 2);
+        TS_ASSERT_DELTA(indicator.GetMaximumGradient(), 20.0, 1e-9);
+        TS_ASSERT_EQUALS(indicator.rGetElementsToRefine().size(), 0u);
+        TS_ASSERT_EQUALS(indicator.rGetElementsToCoarsen().size(), 0u);
+
+        PetscTools::Destroy(solution);
+        PetscTools::Destroy(striped_solution);
+    }
+
+    void TestInterpolateCellState()
+    {
+        boost::shared_ptr<EulerIvpOdeSolver> p_solver(new EulerIvpOdeSolver);
+        boost::shared_ptr<ZeroStimulus> p_stimulus(new ZeroStimulus);
+        CellLuoRudy1991FromCellML resting_cell(p_solver, p_stimulus);
+        CellLuoRudy1991FromCellML excited_cell(p_solver, p_stimulus);
+        CellLuoRudy1991FromCellML new_cell(p_solver, p_stimulus);
+        excited_cell.SetVoltage(20.0);
+
+        std::vector<AbstractCardiacCellInterface*> cells;
+        cells.push_back(&resting_cell);
+        cells.push_back(&excited_cell);
+        std::vector<double> weights;
+        weights.push_back(0.25);
+        weights.push_back(0.75);
+        WavefrontRefinementIndicator<2>::InterpolateCellState(cells, weights, &new_cell);
+
+        std::vector<double> resting_state = resting_cell.GetStdVecStateVariables();
+        std::vector<double> excited_state = excited_cell.GetStdVecStateVariables();
+        std::vector<double> new_state = new_cell.GetStdVecStateVariables();
+        for (unsigned i=0; i<new_state.size(); i++)
+        {
+            TS_ASSERT_DELTA(new_state[i], 0.25*resting_state[i] + 0.75*excited_state[i], 1e-12);
+        }
+        TS_ASSERT_DELTA(new_cell.GetVoltage(), 0.25*resting_cell.GetVoltage() + 15.0, 1e-12);
+
+        weights.pop_back();
+        TS_ASSERT_THROWS_THIS(WavefrontRefinementIndicator<2>::InterpolateCellState(cells, weights, &new_cell),
+                              "There must be one weight for each cell whose state is interpolated");
+
+        FitzHughNagumo1961OdeSystem other_cell(p_solver, p_stimulus);
+        weights.push_back(0.75);
+        cells[1] = &other_cell;
+        TS_ASSERT_THROWS_THIS(WavefrontRefinementIndicator<2>::InterpolateCellState(cells, weights, &new_cell),
+                              "Cannot interpolate the state of cells with different numbers of state variables");
+    }
+};
+
+#endif /*TESTWAVEFRONTREFINEMENTINDICATOR_HPP_*/
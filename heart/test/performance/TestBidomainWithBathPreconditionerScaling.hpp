@@ -0,0 +1,166 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTBIDOMAINWITHBATHPRECONDITIONERSCALING_HPP_
+#define TESTBIDOMAINWITHBATHPRECONDITIONERSCALING_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "BidomainWithBathProblem.hpp"
+#include "DistributedTetrahedralMesh.hpp"
+#include "TrianglesMeshReader.hpp"
+#include "SimpleBathProblemSetup.hpp"
+#include "Timer.hpp"
+#include "PetscSetupAndFinalize.hpp"
+
+/**
+ * A bidomain-with-bath problem which records the linear solver statistics
+ * after every time step (the solver only exists during Solve()).
+ */
+class BidomainWithBathProblemWithSolverStats : public BidomainWithBathProblem<2>
+{
+public:
+    /** Total number of KSP iterations over all the solves */
+    unsigned mTotalIterations;
+    /** Number of linear solves */
+    unsigned mNumSolves;
+    /** Time spent setting up the KSP solver and preconditioner */
+    double mSetupTime;
+
+    BidomainWithBathProblemWithSolverStats(AbstractCardiacCellFactory<2>* pCellFactory)
+        : BidomainWithBathProblem<2>(pCellFactory),
+          mTotalIterations(0u),
+          mNumSolves(0u),
+          mSetupTime(0.0)
+    {
+    }
+
+    void OnEndOfTimestep(double time)
+    {
+        BidomainWithBathProblem<2>::OnEndOfTimestep(time);
+
+        // The printing time step equals the PDE time step, so there is one solve per call
+        LinearSystem* p_linear_system = this->mpSolver->GetLinearSystem();
+        mTotalIterations += p_linear_system->GetNumIterations();
+        mNumSolves++;
+        mSetupTime = p_linear_system->GetKspSetupTime();
+    }
+};
+
+/**
+ * Compares the purpose-built bidomain preconditioners on a bidomain problem with
+ * a perfusing bath.  Run it on 1, 8 and 64 processes to see how the iteration
+ * counts and set-up costs scale, e.g.
+ *
+ *    mpirun -np 8 ./TestBidomainWithBathPreconditionerScalingRunner
+ *
+ * The table is printed by the master process.
+ */
+class TestBidomainWithBathPreconditionerScaling : public CxxTest::TestSuite
+{
+private:
+
+    void RunWithPreconditioner(const std::string& rPreconditioner, unsigned& rIterations, double& rSetupTime, double& rTotalTime)
+    {
+        HeartConfig::Reset();
+        HeartConfig::Instance()->SetSimulationDuration(1.0);  //ms
+        HeartConfig::Instance()->SetOdePdeAndPrintingTimeSteps(0.01, 0.01, 0.01);
+        HeartConfig::Instance()->SetOutputDirectory("BidomainWithBathPreconditionerScaling");
+        HeartConfig::Instance()->SetOutputFilenamePrefix("results");
+        HeartConfig::Instance()->SetKSPSolver("cg");
+        HeartConfig::Instance()->SetKSPPreconditioner(rPreconditioner.c_str());
+        HeartConfig::Instance()->SetUseAbsoluteTolerance(1e-8);
+
+        // Square of tissue surrounded by bath, refined so that the larger runs have work to do
+        DistributedTetrahedralMesh<2,2> mesh;
+        mesh.ConstructRegularSlabMesh(0.005, 1.0, 1.0);
+        SetCircularTissueIn2dMesh(&mesh, 0.5, 0.5, 0.3);
+
+        c_vector<double,2> centre;
+        centre(0) = 0.5; // cm
+        centre(1) = 0.5; // cm
+        BathCellFactory<2> cell_factory(-5e6, centre);
+
+        BidomainWithBathProblemWithSolverStats problem(&cell_factory);
+        problem.SetMesh(&mesh);
+        problem.PrintOutput(false);
+
+        Timer::Reset();
+        problem.Initialise();
+        problem.Solve();
+        rTotalTime = Timer::GetElapsedTime();
+
+        TS_ASSERT_EQUALS(problem.mNumSolves, 100u);
+        rIterations = problem.mTotalIterations;
+        rSetupTime = problem.mSetupTime;
+    }
+
+public:
+
+    void TestCompareBathPreconditioners()
+    {
+        const unsigned num_pcs = 3;
+        std::string preconditioners[num_pcs] = {"blockdiagonal", "ldufactorisation", "tissuebathmultilevel"};
+        unsigned iterations[num_pcs];
+        double setup_times[num_pcs];
+        double total_times[num_pcs];
+
+        for (unsigned i=0; i<num_pcs; i++)
+        {
+            RunWithPreconditioner(preconditioners[i], iterations[i], setup_times[i], total_times[i]);
+        }
+
+        if (PetscTools::AmMaster())
+        {
+            std::cout << "Bidomain with bath preconditioners on " << PetscTools::GetNumProcs() << " process(es)\n";
+            std::cout << std::setw(24) << "preconditioner" << std::setw(12) << "iterations"
+                      << std::setw(14) << "set-up (s)" << std::setw(14) << "total (s)" << "\n";
+            for (unsigned i=0; i<num_pcs; i++)
+            {
+                std::cout << std::setw(24) << preconditioners[i] << std::setw(12) << iterations[i]
+                          << std::setw(14) << setup_times[i] << std::setw(14) << total_times[i] << "\n";
+            }
+            std::cout << std::flush;
+        }
+
+        // The multilevel preconditioner should need fewer iterations than block diagonal
+        TS_ASSERT_LESS_THAN_EQUALS(iterations[2], iterations[0]);
+    }
+};
+
+#endif /*TESTBIDOMAINWITHBATHPRECONDITIONERSCALING_HPP_*/
@@ -0,0 +1,108 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTCARDIACBENCHMARKS_HPP_
+#define TESTCARDIACBENCHMARKS_HPP_
+
+#include <cxxtest/TestSuite.h>
+
+#include "BenchmarkRecorder.hpp"
+#include "HeartConfig.hpp"
+#include "LuoRudy1991.hpp"
+#include "MonodomainAssembler.hpp"
+#include "MonodomainTissue.hpp"
+#include "PetscMatTools.hpp"
+#include "PetscTools.hpp"
+#include "PlaneStimulusCellFactory.hpp"
+#include "DistributedTetrahedralMesh.hpp"
+#include "PetscSetupAndFinalize.hpp"
+
+/**
+ * Benchmarks of the cardiac assembly and ODE sweep at several problem sizes.
+ * Results are written to Benchmarks/CardiacBenchmarks.json.
+ */
+class TestCardiacBenchmarks : public CxxTest::TestSuite
+{
+public:
+
+    void TestAssemblyAndOdeSweep()
+    {
+        BenchmarkRecorder recorder("CardiacBenchmarks");
+        HeartConfig::Instance()->Reset();
+        const double ode_dt = HeartConfig::Instance()->GetOdeTimeStep();
+
+        const double spacings[3] = {0.04, 0.02, 0.01}; // 676, 2601 and 10201 nodes
+        for (unsigned i=0; i<3; i++)
+        {
+            DistributedTetrahedralMesh<2,2> mesh;
+            mesh.ConstructRegularSlabMesh(spacings[i], 1.0, 1.0);
+            const unsigned num_nodes = mesh.GetNumNodes();
+
+            PlaneStimulusCellFactory<CellLuoRudy1991FromCellML, 2> cell_factory;
+            cell_factory.SetMesh(&mesh);
+            MonodomainTissue<2> tissue(&cell_factory);
+
+            Mat matrix;
+            PetscTools::SetupMat(matrix, num_nodes, num_nodes, 9,
+                                 mesh.GetDistributedVectorFactory()->GetLocalOwnership(),
+                                 mesh.GetDistributedVectorFactory()->GetLocalOwnership());
+            MonodomainAssembler<2,2> assembler(&mesh, &tissue);
+            assembler.SetMatrixToAssemble(matrix, true);
+            recorder.Begin("monodomain_assembly_x10", num_nodes);
+            for (unsigned repeat=0; repeat<10; repeat++)
+            {
+                assembler.Assemble();
+                PetscMatTools::Finalise(matrix);
+            }
+            recorder.End();
+            PetscTools::Destroy(matrix);
+
+            Vec voltage = mesh.GetDistributedVectorFactory()->CreateVec();
+            VecSet(voltage, -83.853);
+            recorder.Begin("lr91_ode_sweep_x10", num_nodes);
+            for (unsigned step=0; step<10; step++)
+            {
+                tissue.SolveCellSystems(voltage, step*ode_dt, (step+1)*ode_dt, true);
+            }
+            recorder.End();
+            PetscTools::Destroy(voltage);
+        }
+
+        TS_ASSERT_EQUALS(recorder.GetNumberOfResults(), 6u);
+        recorder.WriteResults();
+    }
+};
+
+#endif /*TESTCARDIACBENCHMARKS_HPP_*/
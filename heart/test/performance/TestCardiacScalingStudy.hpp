@@ -0,0 +1,99 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTCARDIACSCALINGSTUDY_HPP_
+#define TESTCARDIACSCALINGSTUDY_HPP_
+
+#include <cxxtest/TestSuite.h>
+
+#include <algorithm>
+
+#include "DistributedTetrahedralMesh.hpp"
+#include "HeartConfig.hpp"
+#include "HeartEventHandler.hpp"
+#include "LuoRudy1991.hpp"
+#include "MonodomainProblem.hpp"
+#include "PlaneStimulusCellFactory.hpp"
+#include "ScalingStudy.hpp"
+
+#include "PetscSetupAndFinalize.hpp"
+
+/**
+ * Strong and weak scaling harness for a 3D monodomain slab. Run it with different numbers
+ * of processes, e.g.
+ *
+ *  mpirun -np 8 TestCardiacScalingStudy -scaling_mode weak -scaling_size 50000 -scaling_steps 200
+ *
+ * and each run writes ScalingStudies/MonodomainSlab3d_<mode>_<size>_np<N>.json with the
+ * HeartEventHandler timings (mean, min, max and load imbalance over processes).
+ *
+ * The slab has a fixed 0.1cm x 0.1cm cross-section at 0.01cm resolution (121 nodes per layer)
+ * and its length is chosen to give about the requested number of nodes.
+ */
+class TestCardiacScalingStudy : public CxxTest::TestSuite
+{
+public:
+
+    void TestMonodomainSlab()
+    {
+        ScalingStudy study("MonodomainSlab3d", 10000, 50);
+
+        const double h = 0.01;
+        const unsigned nodes_per_layer = 121;
+        unsigned num_layers = std::max(2u, (study.GetProblemSize() + nodes_per_layer/2)/nodes_per_layer);
+        DistributedTetrahedralMesh<3,3> mesh;
+        mesh.ConstructRegularSlabMesh(h, (num_layers-1)*h, 0.1, 0.1);
+
+        const double pde_dt = 0.01;
+        HeartConfig::Instance()->SetOdePdeAndPrintingTimeSteps(pde_dt, pde_dt, pde_dt);
+        HeartConfig::Instance()->SetSimulationDuration(study.GetNumSteps()*pde_dt);
+        HeartConfig::Instance()->SetOutputDirectory("CardiacScalingStudy");
+        HeartConfig::Instance()->SetOutputFilenamePrefix("results");
+
+        PlaneStimulusCellFactory<CellLuoRudy1991FromCellML, 3> cell_factory(-600.0*1000);
+        MonodomainProblem<3> problem(&cell_factory);
+        problem.SetMesh(&mesh);
+        problem.PrintOutput(false);
+        problem.Initialise();
+
+        HeartEventHandler::Reset();
+        problem.Solve();
+
+        TS_ASSERT_EQUALS(mesh.GetNumNodes(), num_layers*nodes_per_layer);
+        study.WriteReport<HeartEventHandler>(mesh.GetNumNodes());
+    }
+};
+
+#endif /*TESTCARDIACSCALINGSTUDY_HPP_*/
@@ -0,0 +1,304 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTCELLMODELBENCHMARKMATRIX_HPP_
+#define TESTCELLMODELBENCHMARKMATRIX_HPP_
+
+#include <cxxtest/TestSuite.h>
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+#include "AbstractCardiacCell.hpp"
+#include "AbstractCvodeCell.hpp"
+#include "BenchmarkRecorder.hpp"
+#include "CellMLLoader.hpp"
+#include "CellProperties.hpp"
+#include "Exception.hpp"
+#include "FileFinder.hpp"
+#include "OdeSolution.hpp"
+#include "OutputFileHandler.hpp"
+#include "Timer.hpp"
+
+#include "PetscSetupAndFinalize.hpp"
+
+/**
+ * Throughput and accuracy of every cell model in heart/src/odes/cellml, in each of the
+ * variants that PyCML can generate: Normal (forward Euler), Opt (lookup tables),
+ * BackwardEuler, RushLarsen, GRL1, GRL2, and CVODE with and without an analytic Jacobian.
+ *
+ * Each variant is converted on the fly with CellMLLoader, so no extra code is built by the
+ * main build, and run as a single cell with the model's default stimulus at each of a few
+ * time steps (for CVODE this is the maximum time step). Voltage traces are compared with
+ * a reference solved by CVODE at tight tolerances (or forward Euler with a very small step
+ * if CVODE isn't available).
+ *
+ * Results go to Benchmarks/CellModelBenchmarks.csv, one row per model, variant and time step:
+ * wall time, cell-steps per second (simulated time over the time step, per second of wall
+ * time, so CVODE is given as the equivalent fixed-step rate), simulated ms per second, the
+ * maximum and RMS voltage errors, the error in the final APD90, and whether the run succeeded.
+ * Timings also go to Benchmarks/CellModelBenchmarks.json via BenchmarkRecorder.
+ */
+class TestCellModelBenchmarkMatrix : public CxxTest::TestSuite
+{
+private:
+
+    /** Length of each simulation (ms). */
+    static constexpr double mDuration = 500.0;
+
+    /** Interval at which voltages are sampled and compared (ms). */
+    static constexpr double mSamplingInterval = 0.1;
+
+    /**
+     * Solve a cell model from the start, timing the solve.
+     *
+     * @param rCell  the cell
+     * @param dt  the time step (or maximum time step for CVODE)
+     * @param rWallTime  filled in with the wall time of the solve
+     * @return the voltage trace, or an empty trace if the solve threw
+     */
+    std::vector<double> SolveCell(AbstractCardiacCellInterface& rCell, double dt, double& rWallTime)
+    {
+        rCell.SetTimestep(dt);
+        std::vector<double> voltages;
+        double start_time = Timer::GetWallTime();
+        try
+        {
+            OdeSolution solution = rCell.Compute(0.0, mDuration, mSamplingInterval);
+            voltages = solution.GetVariableAtIndex(rCell.GetVoltageIndex());
+        }
+        catch (const Exception&)
+        {
+            voltages.clear();
+        }
+        rWallTime = Timer::GetWallTime() - start_time;
+        return voltages;
+    }
+
+    /**
+     * @return the final APD90 of a voltage trace, or NaN if there isn't a complete action potential
+     * @param rVoltages  the trace, sampled every #mSamplingInterval
+     */
+    double GetApd90(const std::vector<double>& rVoltages)
+    {
+        std::vector<double> times(rVoltages.size());
+        for (unsigned i=0; i<times.size(); i++)
+        {
+            times[i] = i*mSamplingInterval;
+        }
+        try
+        {
+            CellProperties properties(rVoltages, times);
+            return properties.GetLastActionPotentialDuration(90);
+        }
+        catch (const Exception&)
+        {
+            return std::nan("");
+        }
+    }
+
+    /**
+     * Time one run of a cell model and write its row of results.
+     *
+     * @param rCell  a freshly created cell
+     * @param rModel  the model name
+     * @param rVariant  the variant name
+     * @param dt  the time step
+     * @param rReference  the reference voltage trace
+     * @param referenceApd  the APD90 of the reference trace
+     * @param rRecorder  records the timings of successful runs
+     * @param pFile  the CSV file
+     * @return whether the run succeeded and gave a finite trace
+     */
+    bool RunVariant(AbstractCardiacCellInterface& rCell, const std::string& rModel, const std::string& rVariant,
+                    double dt, const std::vector<double>& rReference, double referenceApd,
+                    BenchmarkRecorder& rRecorder, out_stream& pFile)
+    {
+        double wall_time;
+        std::vector<double> voltages = SolveCell(rCell, dt, wall_time);
+        unsigned num_steps = (unsigned)(mDuration/dt + 0.5);
+
+        std::string status = "ok";
+        double max_error = 0.0;
+        double sum_squared_error = 0.0;
+        if (voltages.size() != rReference.size())
+        {
+            status = "failed";
+        }
+        else
+        {
+            for (unsigned i=0; i<voltages.size(); i++)
+            {
+                double error = fabs(voltages[i] - rReference[i]);
+                if (std::isnan(error))
+                {
+                    status = "unstable";
+                    break;
+                }
+                max_error = std::max(max_error, error);
+                sum_squared_error += error*error;
+            }
+        }
+
+        *pFile << rModel << "," << rVariant << "," << dt << "," << wall_time << ","
+               << num_steps/wall_time << "," << mDuration/wall_time << ",";
+        if (status == "ok")
+        {
+            *pFile << max_error << "," << sqrt(sum_squared_error/voltages.size()) << ","
+                   << fabs(GetApd90(voltages) - referenceApd) << ",";
+            std::stringstream name;
+            name << rModel << "_" << rVariant << "_dt" << dt;
+            rRecorder.Record(name.str(), num_steps, wall_time);
+        }
+        else
+        {
+            *pFile << "nan,nan,nan,";
+        }
+        *pFile << status << "\n";
+        return status == "ok";
+    }
+
+public:
+
+    void TestCellModelVariants()
+    {
+        EXIT_IF_PARALLEL; // Single-cell benchmarks
+
+        const double time_steps[2] = {0.01, 0.1};
+        const std::vector<std::string> no_options;
+
+        // The variants solved with a fixed time step, and the PyCML options which generate them
+        std::vector<std::pair<std::string, std::string> > fixed_step_variants;
+        fixed_step_variants.push_back(std::make_pair("Normal", ""));
+        fixed_step_variants.push_back(std::make_pair("Opt", "--opt"));
+        fixed_step_variants.push_back(std::make_pair("BackwardEuler", "--backward-euler"));
+        fixed_step_variants.push_back(std::make_pair("RushLarsen", "--rush-larsen"));
+        fixed_step_variants.push_back(std::make_pair("GRL1", "--grl1"));
+        fixed_step_variants.push_back(std::make_pair("GRL2", "--grl2"));
+
+        BenchmarkRecorder recorder("CellModelBenchmarks");
+        OutputFileHandler results_handler("Benchmarks", false);
+        out_stream p_file = results_handler.OpenOutputFile("CellModelBenchmarks.csv");
+        *p_file << "model,variant,dt_ms,wall_time_s,cell_steps_per_s,simulated_ms_per_s,"
+                << "max_abs_error_mV,rms_error_mV,apd90_error_ms,status\n";
+
+        FileFinder cellml_dir("heart/src/odes/cellml", RelativeTo::ChasteSourceRoot);
+        std::vector<FileFinder> models = cellml_dir.FindMatches("*.cellml");
+        std::sort(models.begin(), models.end());
+        TS_ASSERT_LESS_THAN(0u, models.size());
+
+        for (unsigned model_index=0; model_index<models.size(); model_index++)
+        {
+            const std::string model = models[model_index].GetLeafNameNoExtension();
+            const std::string dir = "CellModelBenchmarks/" + model;
+
+            // The reference trace
+            double reference_wall_time;
+#ifdef CHASTE_CVODE
+            CellMLLoader reference_loader(models[model_index], OutputFileHandler(dir + "/Reference"), no_options);
+            boost::shared_ptr<AbstractCvodeCell> p_reference_cell = reference_loader.LoadCvodeCell();
+            p_reference_cell->SetTolerances(1e-8, 1e-10);
+            std::vector<double> reference = SolveCell(*p_reference_cell, mSamplingInterval, reference_wall_time);
+#else
+            CellMLLoader reference_loader(models[model_index], OutputFileHandler(dir + "/Reference"), no_options);
+            boost::shared_ptr<AbstractCardiacCell> p_reference_cell = reference_loader.LoadCardiacCell();
+            std::vector<double> reference = SolveCell(*p_reference_cell, 1e-4, reference_wall_time);
+#endif // CHASTE_CVODE
+            TS_ASSERT_LESS_THAN(0u, reference.size());
+            if (reference.empty())
+            {
+                continue;
+            }
+            const double reference_apd = GetApd90(reference);
+
+            for (unsigned variant_index=0; variant_index<fixed_step_variants.size(); variant_index++)
+            {
+                const std::string& r_variant = fixed_step_variants[variant_index].first;
+                std::vector<std::string> options;
+                if (!fixed_step_variants[variant_index].second.empty())
+                {
+                    options.push_back(fixed_step_variants[variant_index].second);
+                }
+                CellMLLoader loader(models[model_index], OutputFileHandler(dir + "/" + r_variant), options);
+                for (unsigned i=0; i<2; i++)
+                {
+                    boost::shared_ptr<AbstractCardiacCell> p_cell;
+                    try
+                    {
+                        p_cell = loader.LoadCardiacCell();
+                    }
+                    catch (const Exception&)
+                    {
+                        // Not every variant can be generated for every model, but the basic one can
+                        TS_ASSERT_DIFFERS(r_variant, "Normal");
+                        *p_file << model << "," << r_variant << ",nan,nan,nan,nan,nan,nan,nan,unavailable\n";
+                        break;
+                    }
+                    bool ok = RunVariant(*p_cell, model, r_variant, time_steps[i], reference, reference_apd, recorder, p_file);
+                    if (r_variant == "Normal" && i == 0)
+                    {
+                        // The basic variant at a small time step ought always to work
+                        TS_ASSERT(ok);
+                    }
+                }
+            }
+
+#ifdef CHASTE_CVODE
+            CellMLLoader cvode_loader(models[model_index], OutputFileHandler(dir + "/Cvode"), no_options);
+            for (unsigned i=0; i<2; i++)
+            {
+                boost::shared_ptr<AbstractCvodeCell> p_cell = cvode_loader.LoadCvodeCell();
+                if (p_cell->HasAnalyticJacobian())
+                {
+                    RunVariant(*p_cell, model, "CvodeAnalyticJacobian", time_steps[i], reference, reference_apd, recorder, p_file);
+                    p_cell = cvode_loader.LoadCvodeCell();
+                }
+                p_cell->ForceUseOfNumericalJacobian(true);
+                RunVariant(*p_cell, model, "CvodeNumericalJacobian", time_steps[i], reference, reference_apd, recorder, p_file);
+            }
+#endif // CHASTE_CVODE
+        }
+
+        p_file->close();
+        TS_ASSERT_LESS_THAN(0u, recorder.GetNumberOfResults());
+        recorder.WriteResults();
+    }
+};
+
+#endif /*TESTCELLMODELBENCHMARKMATRIX_HPP_*/
@@ -46,6 +46,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ColumnDataReader.hpp"
 #include "EulerIvpOdeSolver.hpp"
 #include "FileFinder.hpp"
+#include "HeartConfig.hpp"
 #include "LuoRudy1991.hpp"
 #include "OdeSolution.hpp"
 #include "PetscTools.hpp"
@@ -243,6 +244,18 @@ public:
         TS_ASSERT_DELTA(cell_props.GetLastActionPotentialDuration(50), 271.1389, timestep);
         TS_ASSERT_DELTA(cell_props.GetLastActionPotentialDuration(90), 362.0155, timestep); // Should use penultimate AP
         TS_ASSERT_DELTA(cell_props.GetTimesAtMaxUpstrokeVelocity()[size - 1], 3100.7300, 0.001);
+
+        // The same results come from a voltage trace streamed while solving, without storing the full solution
+        lr91_ode_system.ResetToInitialConditions();
+        SingleVariableOdeSolutionSink voltage_trace(lr91_ode_system.GetVoltageIndex());
+        double ode_dt = HeartConfig::Instance()->GetOdeTimeStep(); // as used by Compute() above
+        p_solver->Solve(&lr91_ode_system, lr91_ode_system.rGetStateVariables(), start_time, end_time,
+                        ode_dt, ode_dt, voltage_trace);
+        TS_ASSERT_EQUALS(voltage_trace.rGetValues().size(), voltage.size());
+        CellProperties streamed_props(voltage_trace);
+        TS_ASSERT_DELTA(streamed_props.GetLastActionPotentialDuration(90), cell_props.GetLastActionPotentialDuration(90), 1e-9);
+        TS_ASSERT_DELTA(streamed_props.GetLastPeakPotential(), cell_props.GetLastPeakPotential(), 1e-9);
+        TS_ASSERT_LESS_THAN_EQUALS(cell_props.GetLastPeakPotential(), voltage_trace.GetMaximum());
     }
 
     /**
@@ -251,6 +251,46 @@ public:
 
     }
 
+    void TestActivationTimesForNodeRange()
+    {
+        Hdf5DataReader reader("heart/test/data/Monodomain1dFullActionPotential", "Monodomain1dFullActionPotential", false);
+        PropagationPropertiesCalculator ppc(&reader);
+
+        unsigned lower_node = 1u;
+        unsigned upper_node = reader.GetNumberOfRows();
+        std::vector<std::vector<double> > activation_times = ppc.CalculateActivationTimesForNodeRange(-30.0, lower_node, upper_node);
+        TS_ASSERT_EQUALS(activation_times.size(), upper_node - lower_node);
+
+        // Compare with a direct scan of each node's trace
+        std::vector<double> times = reader.GetUnlimitedDimensionValues();
+        for (unsigned node_index=lower_node; node_index<upper_node; node_index++)
+        {
+            std::vector<double> voltages = reader.GetVariableOverTime("V", node_index);
+            std::vector<double> expected_times;
+            for (unsigned i=1; i<voltages.size(); i++)
+            {
+                if (voltages[i-1] < -30.0 && voltages[i] >= -30.0)
+                {
+                    expected_times.push_back(times[i-1] + (-30.0 - voltages[i-1])/(voltages[i] - voltages[i-1])*(times[i]-times[i-1]));
+                }
+            }
+            TS_ASSERT_EQUALS(activation_times[node_index-lower_node].size(), expected_times.size());
+            for (unsigned i=0; i<expected_times.size(); i++)
+            {
+                TS_ASSERT_DELTA(activation_times[node_index-lower_node][i], expected_times[i], 1e-12);
+            }
+        }
+
+        // The single activation propagates along the cable
+        TS_ASSERT_EQUALS(activation_times[4].size(), 1u);
+        TS_ASSERT_EQUALS(activation_times[5].size(), 1u);
+        TS_ASSERT_LESS_THAN(activation_times[4][0], activation_times[5][0]);
+
+        PropagationPropertiesCalculator ppc_bad(&reader, "Vm");
+        TS_ASSERT_THROWS_THIS(ppc_bad.CalculateActivationTimesForNodeRange(-30.0, 0u, 1u),
+                              "The data file does not contain data for variable Vm");
+    }
+
     void TestEadCalculation()
     {
        Hdf5DataReader ead_file("heart/test/data/PostProcessingWriter", "Ead", false);
@@ -55,6 +55,10 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "FileComparison.hpp"
 #include "SimpleBathProblemSetup.hpp"
 #include "BidomainWithBathProblem.hpp"
+#include "MonodomainProblem.hpp"
+#include "PlaneStimulusCellFactory.hpp"
+#include "LuoRudy1991.hpp"
+#include "PseudoEcgOutputModifier.hpp"
 
 /* HOW_TO_TAG Cardiac/Post-processing
  * Compute pseudo-ECGs
@@ -336,6 +340,65 @@ public:
         ecg_calculator2.WritePseudoEcg();
     }
 
+    void TestPseudoEcgOutputModifier()
+    {
+        HeartConfig::Instance()->SetSimulationDuration(2.0); //ms
+        HeartConfig::Instance()->SetOutputDirectory("Monodomain1d_InSituPseudoEcg");
+        HeartConfig::Instance()->SetOutputFilenamePrefix("monodomain_1d");
+
+        PlaneStimulusCellFactory<CellLuoRudy1991FromCellML, 1> cell_factory;
+        MonodomainProblem<1> monodomain_problem(&cell_factory);
+
+        TrianglesMeshReader<1,1> reader("mesh/test/data/1D_0_to_1_100_elements");
+        TetrahedralMesh<1,1> mesh;
+        mesh.ConstructFromMeshReader(reader);
+        monodomain_problem.SetMesh(&mesh);
+        monodomain_problem.Initialise();
+
+        std::vector<ChastePoint<1> > electrodes;
+        electrodes.push_back(ChastePoint<1>(1.5));
+        electrodes.push_back(ChastePoint<1>(-0.3));
+        boost::shared_ptr<PseudoEcgOutputModifier<1,1> > p_ecg_modifier(new PseudoEcgOutputModifier<1,1>("pseudo_ecg.dat", mesh, electrodes));
+        monodomain_problem.AddOutputModifier(p_ecg_modifier);
+
+        monodomain_problem.Solve();
+
+        // The in-situ values at the final time agree with post-processing the HDF5 file
+        FileFinder output_dir("Monodomain1d_InSituPseudoEcg", RelativeTo::ChasteTestOutput);
+        unsigned last_time_step;
+        {
+            Hdf5DataReader data_reader(output_dir, "monodomain_1d");
+            last_time_step = data_reader.GetUnlimitedDimensionValues().size() - 1;
+        }
+        for (unsigned electrode=0; electrode<electrodes.size(); electrode++)
+        {
+            PseudoEcgCalculator<1,1,1> calculator(mesh, electrodes[electrode], output_dir, "monodomain_1d");
+            double expected = calculator.ComputePseudoEcgAtOneTimeStep(last_time_step);
+            TS_ASSERT_DIFFERS(expected, 0.0);
+            TS_ASSERT_DELTA(p_ecg_modifier->rGetLatestPseudoEcgs()[electrode], expected, 1e-9*(1.0 + fabs(expected)));
+        }
+
+        // The file has a header line and one line per printing time step
+        if (PetscTools::AmMaster())
+        {
+            std::ifstream ecg_file((output_dir.GetAbsolutePath() + "pseudo_ecg.dat").c_str());
+            TS_ASSERT(ecg_file.is_open());
+            unsigned num_lines = 0;
+            std::string line;
+            while (std::getline(ecg_file, line))
+            {
+                num_lines++;
+            }
+            TS_ASSERT_EQUALS(num_lines, last_time_step + 2);
+        }
+
+        // An electrode on a Gauss point is rejected when the weights are computed
+        std::vector<ChastePoint<1> > bad_electrodes;
+        bad_electrodes.push_back(ChastePoint<1>(0.0021132486540519));
+        PseudoEcgOutputModifier<1,1> bad_modifier("bad_ecg.dat", mesh, bad_electrodes);
+        TS_ASSERT_THROWS_THIS(bad_modifier.InitialiseAtStart(mesh.GetDistributedVectorFactory()), "Probe is on a mesh Gauss point.");
+    }
+
  };
 
 
@@ -351,6 +351,38 @@ public:
         TS_ASSERT_EQUALS( zero_stim.GetStimulus(1), 0);
     }
 
+    void TestStimulusIsConstantOver()
+    {
+        ZeroStimulus zero_stim;
+        TS_ASSERT(zero_stim.IsConstantOver(0.0, 1000.0));
+
+        SimpleStimulus simple_stim(1.0, 0.5, 100.0);
+        TS_ASSERT(simple_stim.IsConstantOver(0.0, 99.0));       // before
+        TS_ASSERT(!simple_stim.IsConstantOver(99.9, 100.1));    // switches on
+        TS_ASSERT(simple_stim.IsConstantOver(100.0, 100.5));    // on throughout
+        TS_ASSERT(!simple_stim.IsConstantOver(100.4, 100.6));   // switches off
+        TS_ASSERT(simple_stim.IsConstantOver(101.0, 102.0));    // after
+
+        RegularStimulus regular_stim(1.0, 0.5, 1.0, 2.0, 10.0);
+        TS_ASSERT(regular_stim.IsConstantOver(0.0, 1.0));
+        TS_ASSERT(!regular_stim.IsConstantOver(1.9, 2.1));
+        TS_ASSERT(regular_stim.IsConstantOver(2.0, 2.5));
+        TS_ASSERT(regular_stim.IsConstantOver(2.6, 2.9));
+        TS_ASSERT(!regular_stim.IsConstantOver(2.9, 3.1));
+        TS_ASSERT(regular_stim.IsConstantOver(5.1, 5.4));
+        TS_ASSERT(!regular_stim.IsConstantOver(9.9, 10.1));
+        TS_ASSERT(regular_stim.IsConstantOver(10.1, 20.0));
+
+        // Changes sign part way through each pulse
+        RegularStimulusZeroNetCharge zero_net_stim(1.0, 0.5, 1.0, 2.0, 10.0);
+        TS_ASSERT(!zero_net_stim.IsConstantOver(2.0, 2.5));
+        TS_ASSERT(zero_net_stim.IsConstantOver(2.6, 2.9));
+
+        // Anything else is never assumed to be constant
+        MultiStimulus multi_stim;
+        TS_ASSERT(!multi_stim.IsConstantOver(0.0, 1.0));
+    }
+
     void TestMultiStimulus()
     {
         MultiStimulus multi_stim;
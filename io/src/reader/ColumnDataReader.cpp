@@ -114,6 +114,20 @@ void ColumnDataReader::CheckFiles(const std::string& rDirectory, const std::stri
     infofile >> mHasUnlimitedDimension >> junk;
     infofile >> mNumVariables;
 
+    // Binary data files are marked in the info file by the size of each value
+    mIsBinary = false;
+    std::string binary_tag;
+    if (infofile >> binary_tag && binary_tag == "BINARY")
+    {
+        unsigned value_size = 0u;
+        infofile >> value_size;
+        if (value_size != sizeof(double))
+        {
+            EXCEPTION("Binary data were written with values of a different size");
+        }
+        mIsBinary = true;
+    }
+
     if (mNumFixedDimensions == NOT_READ || mNumVariables == NOT_READ)
     {
         infofile.close();
@@ -196,6 +210,16 @@ void ColumnDataReader::CheckFiles(const std::string& rDirectory, const std::stri
 
         column++;
     }
+    mNumColumns = column;
+
+    if (mIsBinary)
+    {
+        // There is no text formatting to work out
+        mFieldWidth = 0u;
+        infofile.close();
+        datafile.close();
+        return;
+    }
 
     /*
      * Now read the first line of proper data to determine the field width used when this
@@ -359,8 +383,35 @@ std::vector<double> ColumnDataReader::GetUnlimitedDimensionValues()
     return mValues;
 }
 
+void ColumnDataReader::OpenBinaryFile(const std::string& rFilename, std::ifstream& rFile)
+{
+    rFile.open(rFilename.c_str(), std::ios::in | std::ios::binary);
+    if (!rFile.is_open())
+    {
+        EXCEPTION("Couldn't open data file");
+    }
+    std::string header;
+    std::getline(rFile, header);
+}
+
 void ColumnDataReader::ReadValueFromFile(const std::string& rFilename, int col, int row)
 {
+    if (mIsBinary)
+    {
+        // Each column of a fixed dimension file is stored contiguously
+        std::ifstream datafile;
+        OpenBinaryFile(rFilename, datafile);
+        datafile.seekg(((std::streamoff) col * mNumFixedDimensions + row) * sizeof(double), std::ios::cur);
+        double value;
+        datafile.read(reinterpret_cast<char*>(&value), sizeof(double));
+        if (!datafile)
+        {
+            EXCEPTION("Couldn't read value from data file");
+        }
+        mValues.push_back(value);
+        return;
+    }
+
     std::ifstream datafile(rFilename.c_str(), std::ios::in);
     // If it doesn't exist - throw exception
     if (!datafile.is_open())
@@ -384,6 +435,20 @@ void ColumnDataReader::ReadColumnFromFile(const std::string& rFilename, int col)
     // Empty the values vector
     mValues.clear();
 
+    if (mIsBinary)
+    {
+        // Files with only an unlimited dimension are stored a row at a time
+        std::ifstream datafile;
+        OpenBinaryFile(rFilename, datafile);
+        unsigned num_columns = (rFilename == mAncillaryFilename) ? 1u : mNumColumns;
+        std::vector<double> row(num_columns);
+        while (datafile.read(reinterpret_cast<char*>(&row[0]), num_columns * sizeof(double)))
+        {
+            mValues.push_back(row[col]);
+        }
+        return;
+    }
+
     // Read in from the ancillary file
     std::ifstream datafile(rFilename.c_str(), std::ios::in);
     std::string value;
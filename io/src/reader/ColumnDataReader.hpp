@@ -41,6 +41,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <string>
 #include <vector>
 #include <map>
+#include <fstream>
 
 #include "FileFinder.hpp"
 
@@ -61,6 +62,8 @@ private:
     std::string mAncillaryFilename;                       /**< The name of the ancillary file.*/
     std::vector<double> mValues;                          /**< Vector to hold values for a variable.*/
     unsigned mFieldWidth;                                 /**< Width of each column in the text file (excludes column headers). Determined from the first data entry*/
+    bool mIsBinary;                                       /**< Whether the data files hold raw binary doubles (see ColumnDataWriter::SetBinaryOutput). */
+    int mNumColumns;                                      /**< The number of columns in the data file. */
     /**
      * Push back an entry from the data file into #mValues.
      *
@@ -86,6 +89,14 @@ private:
      */
     void ReadValueFromFile(const std::string& rFilename, int col, int row);
 
+    /**
+     * Open a binary data file and move past its header line.
+     *
+     * @param rFilename the file name
+     * @param rFile  the stream to open
+     */
+    void OpenBinaryFile(const std::string& rFilename, std::ifstream& rFile);
+
     /**
      * Set up internal data structures based on file structure, checking that they
      * contain data in roughly the expected format.
@@ -156,7 +167,8 @@ public:
     bool HasValues(const std::string& rVariableName);
 
     /**
-     *  @return the field width (the number of characters (excl. preceding '+' or '-') printed for each data entry in the file).
+     *  @return the field width (the number of characters (excl. preceding '+' or '-') printed for each data entry in the file),
+     *  or 0 if the data are binary.
      */
     unsigned GetFieldWidth();
 };
@@ -0,0 +1,74 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef HDF5DATABLOCK_HPP_
+#define HDF5DATABLOCK_HPP_
+
+#include <vector>
+#include <cassert>
+
+/**
+ * A rectangular block of an HDF5 data set, as read by Hdf5DataReader::GetNextBlock()
+ * or Hdf5DataReader::GetBlock(): every variable for the nodes [mLowerNode, mUpperNode)
+ * at the time steps [mFirstTimestep, mFirstTimestep+mNumTimesteps).
+ *
+ * Values are stored in the same order as on disk: time slowest, then node, then variable.
+ */
+struct Hdf5DataBlock
+{
+    unsigned mFirstTimestep;    /**< The first time step in the block. */
+    unsigned mNumTimesteps;     /**< The number of time steps in the block. */
+    unsigned mLowerNode;        /**< The first node (dataset row) in the block. */
+    unsigned mUpperNode;        /**< One past the last node (dataset row) in the block. */
+    unsigned mNumVariables;     /**< The number of variables stored for each node and time step. */
+    std::vector<double> mData;  /**< The values read from the file. */
+
+    /**
+     * @return the value of a variable at a given node and time step.
+     *
+     * @param timestep  the (global) time step, which must lie within this block
+     * @param nodeIndex  the (dataset) node index, which must lie within this block
+     * @param variableIndex  the column index of the variable
+     */
+    double GetValue(unsigned timestep, unsigned nodeIndex, unsigned variableIndex) const
+    {
+        assert(timestep >= mFirstTimestep && timestep < mFirstTimestep + mNumTimesteps);
+        assert(nodeIndex >= mLowerNode && nodeIndex < mUpperNode);
+        assert(variableIndex < mNumVariables);
+        return mData[((timestep-mFirstTimestep)*(mUpperNode-mLowerNode) + (nodeIndex-mLowerNode))*mNumVariables + variableIndex];
+    }
+};
+
+#endif //HDF5DATABLOCK_HPP_
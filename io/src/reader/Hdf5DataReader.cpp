@@ -47,7 +47,10 @@ Hdf5DataReader::Hdf5DataReader(const std::string& rDirectory,
                                std::string datasetName)
     : AbstractHdf5Access(rDirectory, rBaseName, datasetName, makeAbsolute),
       mNumberTimesteps(1),
-      mClosed(false)
+      mClosed(false),
+      mBlockLowerNode(0u),
+      mBlockUpperNode(0u),
+      mNextBlockIndex(0u)
 {
     CommonConstructor();
 }
@@ -57,7 +60,10 @@ Hdf5DataReader::Hdf5DataReader(const FileFinder& rDirectory,
                                std::string datasetName)
     : AbstractHdf5Access(rDirectory, rBaseName, datasetName),
       mNumberTimesteps(1),
-      mClosed(false)
+      mClosed(false),
+      mBlockLowerNode(0u),
+      mBlockUpperNode(0u),
+      mNextBlockIndex(0u)
 {
     CommonConstructor();
 }
@@ -108,6 +114,24 @@ void Hdf5DataReader::CommonConstructor()
         assert(mDatasetDims[i] == dataset_max_sizes[i]);
     }
 
+    // Find out how the data set is laid out on disk, so that it can be streamed through in chunk-sized blocks
+    hid_t dcpl = H5Dget_create_plist(mVariablesDatasetId);
+    if (H5Pget_layout(dcpl) == H5D_CHUNKED)
+    {
+        H5Pget_chunk(dcpl, AbstractHdf5Access::DATASET_DIMS, mChunkDims);
+    }
+    else
+    {
+        // Contiguous storage is written one time step after another
+        mChunkDims[0] = 1u;
+        for (unsigned i=1; i<AbstractHdf5Access::DATASET_DIMS; i++)
+        {
+            mChunkDims[i] = mDatasetDims[i];
+        }
+    }
+    H5Pclose(dcpl);
+    H5Sclose(variables_dataspace);
+
     // Check if an unlimited dimension has been defined
     if (dataset_max_sizes[0] == H5S_UNLIMITED)
     {
@@ -401,6 +425,102 @@ void Hdf5DataReader::GetVariableOverNodes(Vec data,
     }
 }
 
+unsigned Hdf5DataReader::GetNumberOfTimestepsPerChunk() const
+{
+    return mChunkDims[0];
+}
+
+unsigned Hdf5DataReader::GetNumberOfNodesPerChunk() const
+{
+    return mChunkDims[1];
+}
+
+void Hdf5DataReader::GetBlock(unsigned firstTimestep,
+                              unsigned numTimesteps,
+                              unsigned lowerNode,
+                              unsigned upperNode,
+                              Hdf5DataBlock& rBlock)
+{
+    if (firstTimestep + numTimesteps > mNumberTimesteps)
+    {
+        EXCEPTION("The dataset '" << mDatasetName << "' does not contain data for timestep number " << firstTimestep + numTimesteps - 1);
+    }
+    if (upperNode > mDatasetDims[1] || lowerNode > upperNode)
+    {
+        EXCEPTION("The dataset '" << mDatasetName << "' doesn't contain info for nodes " << lowerNode << " to " << upperNode-1);
+    }
+
+    rBlock.mFirstTimestep = firstTimestep;
+    rBlock.mNumTimesteps = numTimesteps;
+    rBlock.mLowerNode = lowerNode;
+    rBlock.mUpperNode = upperNode;
+    rBlock.mNumVariables = mDatasetDims[2];
+    rBlock.mData.resize(numTimesteps*(upperNode-lowerNode)*mDatasetDims[2]);
+
+    if (rBlock.mData.empty())
+    {
+        return;
+    }
+
+    // Select the whole block in the file, and read it into a memory space of the same shape
+    hsize_t offset[3] = {firstTimestep, lowerNode, 0};
+    hsize_t count[3]  = {numTimesteps, upperNode-lowerNode, mDatasetDims[2]};
+    hid_t variables_dataspace = H5Dget_space(mVariablesDatasetId);
+    H5Sselect_hyperslab(variables_dataspace, H5S_SELECT_SET, offset, nullptr, count, nullptr);
+    hid_t memspace = H5Screate_simple(3, count, nullptr);
+
+    herr_t err = H5Dread(mVariablesDatasetId, H5T_NATIVE_DOUBLE, memspace, variables_dataspace, H5P_DEFAULT, &rBlock.mData[0]);
+    UNUSED_OPT(err);
+    assert(err==0);
+
+    H5Sclose(variables_dataspace);
+    H5Sclose(memspace);
+}
+
+void Hdf5DataReader::BeginBlockIteration(unsigned lowerNode, unsigned upperNode)
+{
+    if (upperNode == UNSIGNED_UNSET)
+    {
+        upperNode = mDatasetDims[1];
+    }
+    if (upperNode > mDatasetDims[1] || lowerNode > upperNode)
+    {
+        EXCEPTION("The dataset '" << mDatasetName << "' doesn't contain info for nodes " << lowerNode << " to " << upperNode-1);
+    }
+    mBlockLowerNode = lowerNode;
+    mBlockUpperNode = upperNode;
+    mNextBlockIndex = 0u;
+}
+
+bool Hdf5DataReader::GetNextBlock(Hdf5DataBlock& rBlock)
+{
+    if (mBlockLowerNode == mBlockUpperNode)
+    {
+        return false;
+    }
+
+    // Node blocks are aligned to the chunk boundaries, so the first and last may be partial chunks
+    unsigned nodes_per_chunk = mChunkDims[1];
+    unsigned first_node_chunk = mBlockLowerNode/nodes_per_chunk;
+    unsigned num_node_blocks = (mBlockUpperNode-1u)/nodes_per_chunk - first_node_chunk + 1u;
+
+    unsigned time_block = mNextBlockIndex/num_node_blocks;
+    unsigned first_timestep = time_block*mChunkDims[0];
+    if (first_timestep >= mNumberTimesteps)
+    {
+        return false;
+    }
+    unsigned num_timesteps = std::min<unsigned>(mChunkDims[0], mNumberTimesteps-first_timestep);
+
+    unsigned node_chunk = first_node_chunk + mNextBlockIndex%num_node_blocks;
+    unsigned lower_node = std::max(mBlockLowerNode, node_chunk*nodes_per_chunk);
+    unsigned upper_node = std::min(mBlockUpperNode, (node_chunk+1u)*nodes_per_chunk);
+
+    GetBlock(first_timestep, num_timesteps, lower_node, upper_node, rBlock);
+    mNextBlockIndex++;
+    return true;
+}
+
 std::vector<double> Hdf5DataReader::GetUnlimitedDimensionValues()
 {
     // Data buffer to return
@@ -41,6 +41,8 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <map>
 
 #include "AbstractHdf5Access.hpp"
+#include "Hdf5DataBlock.hpp"
+#include "Exception.hpp"
 
 /**
  * A concrete HDF5 data reader class.
@@ -61,6 +63,12 @@ private:
 
     bool mClosed;                                           /**< Whether we've already closed the file. */
 
+    hsize_t mChunkDims[DATASET_DIMS];                       /**< The chunk dimensions of the variables data set (time steps, nodes, variables). */
+
+    unsigned mBlockLowerNode;                               /**< The first node of the current block iteration. */
+    unsigned mBlockUpperNode;                               /**< One past the last node of the current block iteration. */
+    unsigned mNextBlockIndex;                               /**< The index of the next block returned by GetNextBlock(). */
+
     /**
      * Contains functionality common to both constructors.
      */
@@ -122,6 +130,55 @@ public:
      */
     void GetVariableOverNodes(Vec data, const std::string& rVariableName, unsigned timestep=0);
 
+    /**
+     * @return the number of time steps spanned by one chunk of the data set on disk.
+     * Data sets written without chunking are stored one time step after another, so
+     * this is 1 for them.
+     */
+    unsigned GetNumberOfTimestepsPerChunk() const;
+
+    /**
+     * @return the number of nodes spanned by one chunk of the data set on disk.
+     */
+    unsigned GetNumberOfNodesPerChunk() const;
+
+    /**
+     * Read every variable for a range of nodes over a range of time steps with a single
+     * hyperslab read. Reading blocks that match the chunk layout (see GetNumberOfTimestepsPerChunk()
+     * and GetNumberOfNodesPerChunk()) touches each chunk on disk exactly once.
+     *
+     * Node indices refer to rows of the data set, so this may also be used on incomplete data.
+     *
+     * @param firstTimestep  the first time step to read
+     * @param numTimesteps  the number of time steps to read
+     * @param lowerNode  the first node to read
+     * @param upperNode  one past the last node to read
+     * @param rBlock  the block to fill in
+     */
+    void GetBlock(unsigned firstTimestep,
+                  unsigned numTimesteps,
+                  unsigned lowerNode,
+                  unsigned upperNode,
+                  Hdf5DataBlock& rBlock);
+
+    /**
+     * Start iterating over the data set in chunk-sized blocks, restricted to the given range of nodes.
+     * Blocks are visited in on-disk order: all the node blocks for the first chunk of time steps,
+     * then all the node blocks for the next chunk of time steps, and so on.
+     *
+     * @param lowerNode  the first node to visit (defaults to 0)
+     * @param upperNode  one past the last node to visit (defaults to the number of rows in the data set)
+     */
+    void BeginBlockIteration(unsigned lowerNode=0u, unsigned upperNode=UNSIGNED_UNSET);
+
+    /**
+     * Read the next block of the iteration started by BeginBlockIteration().
+     *
+     * @param rBlock  the block to fill in
+     * @return false (leaving rBlock unchanged) if all blocks have been visited
+     */
+    bool GetNextBlock(Hdf5DataBlock& rBlock);
+
     /**
      * @return the unlimited dimension values.
      */
@@ -0,0 +1,302 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "Adios2DataWriter.hpp"
+
+#ifdef CHASTE_ADIOS2
+
+#include "Exception.hpp"
+#include "OutputFileHandler.hpp"
+#include "PetscTools.hpp"
+
+Adios2DataWriter::Adios2DataWriter(DistributedVectorFactory& rVectorFactory,
+                                   const std::string& rDirectory,
+                                   const std::string& rBaseName,
+                                   const std::string& rEngineType,
+                                   bool cleanDirectory)
+    : mrVectorFactory(rVectorFactory),
+      mEngineType(rEngineType),
+      mIsInDefineMode(true),
+      mFixedDimensionSize(0),
+      mIsUnlimitedDimensionSet(false),
+      mIsStepOpen(false),
+      mIsClosed(false)
+{
+    OutputFileHandler output_file_handler(rDirectory, cleanDirectory);
+    mOutputPath = output_file_handler.GetOutputDirectoryFullPath() + rBaseName;
+
+    mpAdios.reset(new adios2::ADIOS(PetscTools::GetWorld()));
+    mIo = mpAdios->DeclareIO(rBaseName);
+    mIo.SetEngine(mEngineType);
+}
+
+Adios2DataWriter::~Adios2DataWriter()
+{
+    if (!mIsInDefineMode && !mIsClosed)
+    {
+        Close();
+    }
+}
+
+void Adios2DataWriter::DefineFixedDimension(long dimensionSize)
+{
+    if (!mIsInDefineMode)
+    {
+        EXCEPTION("Cannot define variables when not in Define mode");
+    }
+    if (dimensionSize < 1)
+    {
+        EXCEPTION("Fixed dimension must be at least 1 long");
+    }
+    if (mFixedDimensionSize > 0)
+    {
+        EXCEPTION("Fixed dimension already set");
+    }
+    if (dimensionSize != (long)mrVectorFactory.GetProblemSize())
+    {
+        EXCEPTION("Vector size doesn't match fixed dimension");
+    }
+    mFixedDimensionSize = dimensionSize;
+}
+
+void Adios2DataWriter::DefineUnlimitedDimension(const std::string& rVariableName, const std::string& rVariableUnits)
+{
+    if (mIsUnlimitedDimensionSet)
+    {
+        EXCEPTION("Unlimited dimension already set. Cannot be defined twice");
+    }
+    if (!mIsInDefineMode)
+    {
+        EXCEPTION("Cannot define variables when not in Define mode");
+    }
+    mUnlimitedDimension.mVariableName = rVariableName;
+    mUnlimitedDimension.mVariableUnits = rVariableUnits;
+    mIsUnlimitedDimensionSet = true;
+}
+
+int Adios2DataWriter::DefineVariable(const std::string& rVariableName, const std::string& rVariableUnits)
+{
+    if (!mIsInDefineMode)
+    {
+        EXCEPTION("Cannot define variables when not in Define mode");
+    }
+    if (rVariableName.empty())
+    {
+        EXCEPTION("Variable name not allowed: may not be blank.");
+    }
+    for (unsigned i=0; i<mVariables.size(); i++)
+    {
+        if (mVariables[i].mVariableName == rVariableName)
+        {
+            EXCEPTION("Variable name already exists");
+        }
+    }
+
+    DataWriterVariable new_variable;
+    new_variable.mVariableName = rVariableName;
+    new_variable.mVariableUnits = rVariableUnits;
+    new_variable.mVariesWithFixedDimension = true;
+    new_variable.mVariesWithUnlimitedDimension = mIsUnlimitedDimensionSet;
+    mVariables.push_back(new_variable);
+    return mVariables.size() - 1;
+}
+
+bool Adios2DataWriter::IsInDefineMode() const
+{
+    return mIsInDefineMode;
+}
+
+void Adios2DataWriter::EndDefineMode()
+{
+    if (mVariables.empty())
+    {
+        EXCEPTION("Cannot end define mode. No variables have been defined.");
+    }
+    if (mFixedDimensionSize == 0)
+    {
+        EXCEPTION("Cannot end define mode. One fixed dimension should be defined.");
+    }
+
+    // Each process writes the rows it owns of a global array over the fixed dimension
+    const adios2::Dims shape = {(std::size_t)mFixedDimensionSize};
+    const adios2::Dims start = {(std::size_t)mrVectorFactory.GetLow()};
+    const adios2::Dims count = {(std::size_t)mrVectorFactory.GetLocalOwnership()};
+    for (unsigned i=0; i<mVariables.size(); i++)
+    {
+        mAdiosVariables.push_back(mIo.DefineVariable<double>(mVariables[i].mVariableName, shape, start, count));
+        mIo.DefineAttribute<std::string>("units", mVariables[i].mVariableUnits, mVariables[i].mVariableName);
+    }
+    if (mIsUnlimitedDimensionSet)
+    {
+        mAdiosUnlimitedVariable = mIo.DefineVariable<double>(mUnlimitedDimension.mVariableName);
+        mIo.DefineAttribute<std::string>("units", mUnlimitedDimension.mVariableUnits, mUnlimitedDimension.mVariableName);
+    }
+
+    mEngine = mIo.Open(mOutputPath, adios2::Mode::Write);
+    mIsInDefineMode = false;
+}
+
+void Adios2DataWriter::BeginStepIfNeeded()
+{
+    if (!mIsStepOpen)
+    {
+        mEngine.BeginStep();
+        mIsStepOpen = true;
+    }
+}
+
+void Adios2DataWriter::CheckReadyToPut() const
+{
+    if (mIsInDefineMode)
+    {
+        EXCEPTION("Cannot write data while in define mode.");
+    }
+    if (mIsClosed)
+    {
+        EXCEPTION("Cannot write data after the writer has been closed.");
+    }
+}
+
+void Adios2DataWriter::PutVector(int variableID, Vec petscVector)
+{
+    CheckReadyToPut();
+    int vector_size;
+    VecGetSize(petscVector, &vector_size);
+    if ((long)vector_size != mFixedDimensionSize)
+    {
+        EXCEPTION("Vector size doesn't match fixed dimension");
+    }
+    if (variableID < 0 || variableID >= (int)mAdiosVariables.size())
+    {
+        EXCEPTION("Variable does not exist in ADIOS2 definitions.");
+    }
+
+    BeginStepIfNeeded();
+
+    // Synchronous puts let the vector be restored straight away
+    const double* p_local_data;
+    VecGetArrayRead(petscVector, &p_local_data);
+    mEngine.Put(mAdiosVariables[variableID], p_local_data, adios2::Mode::Sync);
+    VecRestoreArrayRead(petscVector, &p_local_data);
+}
+
+void Adios2DataWriter::PutStripedVector(std::vector<int> variableIDs, Vec petscVector)
+{
+    CheckReadyToPut();
+    if (variableIDs.size() <= 1)
+    {
+        EXCEPTION("The PutStripedVector method requires at least two variables ID. If only one is needed, use PutVector method instead");
+    }
+    const unsigned num_stripes = variableIDs.size();
+    int vector_size;
+    VecGetSize(petscVector, &vector_size);
+    if ((long)vector_size != num_stripes*mFixedDimensionSize)
+    {
+        EXCEPTION("Vector size doesn't match fixed dimension");
+    }
+    for (unsigned stripe=0; stripe<num_stripes; stripe++)
+    {
+        if (variableIDs[stripe] < 0 || variableIDs[stripe] >= (int)mAdiosVariables.size())
+        {
+            EXCEPTION("Variable does not exist in ADIOS2 definitions.");
+        }
+    }
+
+    BeginStepIfNeeded();
+
+    const unsigned num_local_rows = mrVectorFactory.GetLocalOwnership();
+    mStripeBuffer.resize(num_local_rows);
+    const double* p_local_data;
+    VecGetArrayRead(petscVector, &p_local_data);
+    for (unsigned stripe=0; stripe<num_stripes; stripe++)
+    {
+        for (unsigned i=0; i<num_local_rows; i++)
+        {
+            mStripeBuffer[i] = p_local_data[i*num_stripes + stripe];
+        }
+        mEngine.Put(mAdiosVariables[variableIDs[stripe]], mStripeBuffer.data(), adios2::Mode::Sync);
+    }
+    VecRestoreArrayRead(petscVector, &p_local_data);
+}
+
+void Adios2DataWriter::PutUnlimitedVariable(double value)
+{
+    if (mIsInDefineMode)
+    {
+        EXCEPTION("Cannot write data while in define mode.");
+    }
+    if (!mIsUnlimitedDimensionSet)
+    {
+        EXCEPTION("PutUnlimitedVariable() called but no unlimited dimension has been set");
+    }
+
+    BeginStepIfNeeded();
+
+    // The value is a global scalar, so only the master writes it
+    if (PetscTools::AmMaster())
+    {
+        mEngine.Put(mAdiosUnlimitedVariable, value, adios2::Mode::Sync);
+    }
+}
+
+void Adios2DataWriter::AdvanceAlongUnlimitedDimension()
+{
+    if (!mIsUnlimitedDimensionSet)
+    {
+        EXCEPTION("Trying to advance along an unlimited dimension without having defined any");
+    }
+    if (mIsStepOpen)
+    {
+        mEngine.EndStep();
+        mIsStepOpen = false;
+    }
+}
+
+void Adios2DataWriter::Close()
+{
+    if (mIsInDefineMode || mIsClosed)
+    {
+        return;
+    }
+    if (mIsStepOpen)
+    {
+        mEngine.EndStep();
+        mIsStepOpen = false;
+    }
+    mEngine.Close();
+    mIsClosed = true;
+}
+
+#endif // CHASTE_ADIOS2
@@ -0,0 +1,226 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef ADIOS2DATAWRITER_HPP_
+#define ADIOS2DATAWRITER_HPP_
+
+#ifdef CHASTE_ADIOS2
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <adios2.h>
+
+#include "DataWriterVariable.hpp"
+#include "DistributedVectorFactory.hpp"
+
+/**
+ * A data writer which publishes output through ADIOS2 rather than writing it
+ * to an HDF5 file, so that analysis and visualisation tools can consume it
+ * while the simulation runs.
+ *
+ * The define/put interface follows that of Hdf5DataWriter: define the fixed
+ * dimension, an optional unlimited dimension and the variables, end define
+ * mode, then put whole PETSc vectors and advance along the unlimited
+ * dimension.  Each position along the unlimited dimension is one ADIOS2
+ * step.  Each variable is a global array over the fixed dimension, of which
+ * every process writes its own part, and its units are attached to it as
+ * the attribute "units".  The unlimited dimension is a global scalar.
+ *
+ * The ADIOS2 engine may be chosen when the writer is created.  The default,
+ * "SST", streams each step in memory to readers on other nodes, which
+ * connect through a contact file at the output path; file engines such as
+ * "BP4" write the steps to disk instead.  Only complete data (all nodes)
+ * can be written.
+ *
+ * Only available when Chaste is built with ADIOS2 support (Chaste_USE_ADIOS2).
+ */
+class Adios2DataWriter
+{
+private:
+
+    /** The factory giving the layout of the vectors to be written. */
+    DistributedVectorFactory& mrVectorFactory;
+
+    /** The ADIOS2 engine type. */
+    std::string mEngineType;
+
+    /** The full path of the output (a contact file for streaming engines). */
+    std::string mOutputPath;
+
+    /** Whether the writer is in define mode. */
+    bool mIsInDefineMode;
+
+    /** The size of the fixed dimension, or zero if it is not yet defined. */
+    long mFixedDimensionSize;
+
+    /** Whether an unlimited dimension has been defined. */
+    bool mIsUnlimitedDimensionSet;
+
+    /** The unlimited dimension. */
+    DataWriterVariable mUnlimitedDimension;
+
+    /** The variables defined, indexed by their identifiers. */
+    std::vector<DataWriterVariable> mVariables;
+
+    /** The ADIOS2 context, on the world communicator. */
+    std::unique_ptr<adios2::ADIOS> mpAdios;
+
+    /** The ADIOS2 IO object holding the variable definitions. */
+    adios2::IO mIo;
+
+    /** The ADIOS2 engine, opened by EndDefineMode(). */
+    adios2::Engine mEngine;
+
+    /** The ADIOS2 variables, indexed by their identifiers. */
+    std::vector<adios2::Variable<double> > mAdiosVariables;
+
+    /** The ADIOS2 variable for the unlimited dimension. */
+    adios2::Variable<double> mAdiosUnlimitedVariable;
+
+    /** Whether an ADIOS2 step has been begun and not yet ended. */
+    bool mIsStepOpen;
+
+    /** Whether Close() has been called. */
+    bool mIsClosed;
+
+    /** Buffer for the local part of one variable of a striped vector. */
+    std::vector<double> mStripeBuffer;
+
+    /**
+     * Begin an ADIOS2 step, unless one is already open.
+     */
+    void BeginStepIfNeeded();
+
+    /**
+     * Check that the writer is ready to accept data.
+     */
+    void CheckReadyToPut() const;
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param rVectorFactory  the factory giving the layout of the vectors to be written
+     * @param rDirectory  the output directory, relative to chaste test output
+     * @param rBaseName  the base name of the output, also used to name the ADIOS2 IO object
+     * @param rEngineType  the ADIOS2 engine to use (defaults to "SST")
+     * @param cleanDirectory  whether to clean the output directory (defaults to true)
+     */
+    Adios2DataWriter(DistributedVectorFactory& rVectorFactory,
+                     const std::string& rDirectory,
+                     const std::string& rBaseName,
+                     const std::string& rEngineType="SST",
+                     bool cleanDirectory=true);
+
+    /**
+     * Destructor.  Closes the engine if Close() has not been called.
+     */
+    ~Adios2DataWriter();
+
+    /**
+     * Define the fixed dimension.  It must match the problem size of the vector factory.
+     *
+     * @param dimensionSize  the size of the fixed dimension
+     */
+    void DefineFixedDimension(long dimensionSize);
+
+    /**
+     * Define the unlimited dimension.
+     *
+     * @param rVariableName  the name of the unlimited dimension
+     * @param rVariableUnits  the physical units of the unlimited dimension
+     */
+    void DefineUnlimitedDimension(const std::string& rVariableName, const std::string& rVariableUnits);
+
+    /**
+     * Define a variable.
+     *
+     * @param rVariableName  the name of the variable
+     * @param rVariableUnits  the physical units of the variable
+     * @return the identifier of the variable
+     */
+    int DefineVariable(const std::string& rVariableName, const std::string& rVariableUnits);
+
+    /**
+     * @return whether the writer is in define mode
+     */
+    bool IsInDefineMode() const;
+
+    /**
+     * End define mode, declaring the variables to ADIOS2 and opening the engine.
+     * For streaming engines this may wait for a reader to connect.
+     */
+    void EndDefineMode();
+
+    /**
+     * Write the local part of a vector to a variable in the current step.
+     *
+     * @param variableID  the variable to write
+     * @param petscVector  the data, laid out by the vector factory
+     */
+    void PutVector(int variableID, Vec petscVector);
+
+    /**
+     * Write the local part of a striped vector to consecutive variables in the current step.
+     *
+     * @param variableIDs  the variables to write, one per stripe
+     * @param petscVector  the data, with the stripes interleaved
+     */
+    void PutStripedVector(std::vector<int> variableIDs, Vec petscVector);
+
+    /**
+     * Write the value of the unlimited dimension for the current step.
+     *
+     * @param value  the value
+     */
+    void PutUnlimitedVariable(double value);
+
+    /**
+     * End the current step, publishing it to readers.
+     */
+    void AdvanceAlongUnlimitedDimension();
+
+    /**
+     * End any open step and close the engine.
+     */
+    void Close();
+};
+
+#endif // CHASTE_ADIOS2
+
+#endif /*ADIOS2DATAWRITER_HPP_*/
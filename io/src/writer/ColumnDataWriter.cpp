@@ -38,9 +38,11 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  *
  */
 #include <ctype.h>
+#include <cassert>
 #include <sstream>
 #include <iomanip>
 #include <fstream>
+#include <cfloat>
 
 #include "ColumnDataWriter.hpp"
 #include "ColumnDataConstants.hpp"
@@ -71,7 +73,9 @@ ColumnDataWriter::ColumnDataWriter(
     mPrecision(precision),
     mHasPutVariable(false),
     mNeedAdvanceAlongUnlimitedDimension(false),
-    mCommentForInfoFile("")
+    mCommentForInfoFile(""),
+    mIsBinary(false),
+    mNumColumns(0)
 {
   if (mPrecision < 2 || mPrecision > 20) {
     EXCEPTION("Precision must be between 2 and 20 (inclusive)");
@@ -97,7 +101,9 @@ ColumnDataWriter::ColumnDataWriter(
     mPrecision(precision),
     mHasPutVariable(false),
     mNeedAdvanceAlongUnlimitedDimension(false),
-    mCommentForInfoFile("")
+    mCommentForInfoFile(""),
+    mIsBinary(false),
+    mNumColumns(0)
 {
   if (mPrecision < 2 || mPrecision > 20) {
     EXCEPTION("Precision must be between 2 and 20 (inclusive)");
@@ -265,7 +271,10 @@ void ColumnDataWriter::EndDefineMode()
   // Calculate the width of each row
   int unlimited_dimension_variable = (mpUnlimitedDimensionVariable != nullptr);
   int fixed_dimension_variable = (mpFixedDimensionVariable != nullptr);
-  if (mIsUnlimitedDimensionSet) {
+  if (mIsBinary) {
+    this->SetUpBinaryFiles();
+  }
+  else if (mIsUnlimitedDimensionSet) {
     if (mIsFixedDimensionSet) {
       mRowWidth = (mVariables.size() + fixed_dimension_variable) *
           (mFieldWidth + SPACING);
@@ -401,7 +410,7 @@ void ColumnDataWriter::CreateFixedDimensionFile(const std::string& rFileName)
   mRowStartPosition = mpCurrentOutputFile->tellp();
   std::string blank_line(mRowWidth, ' ');
   for (int i = 0; i < mFixedDimensionSize; i++) {
-    (*mpCurrentOutputFile) << blank_line << std::endl;
+    (*mpCurrentOutputFile) << blank_line << '\n';
   }
 }
 
@@ -413,6 +422,9 @@ void ColumnDataWriter::CreateInfoFile(const std::string& rFileName)
   (*p_info_file) << "FIXED " << mFixedDimensionSize << std::endl;
   (*p_info_file) << "UNLIMITED " << mIsUnlimitedDimensionSet << std::endl;
   (*p_info_file) << "VARIABLES " << mVariables.size() << std::endl;
+  if (mIsBinary) {
+    (*p_info_file) << "BINARY " << sizeof(double) << std::endl;
+  }
   if (mCommentForInfoFile != "") {
     *p_info_file << mCommentForInfoFile << std::endl;
   }
@@ -425,7 +437,26 @@ void ColumnDataWriter::DoAdvanceAlongUnlimitedDimension()
   mHasPutVariable = false;
   mNeedAdvanceAlongUnlimitedDimension = false;
 
-  if (mIsUnlimitedDimensionSet) {
+  if (mIsUnlimitedDimensionSet && mIsBinary) {
+    if (mIsFixedDimensionSet) {
+      std::stringstream suffix;
+      suffix << std::setfill('0') << std::setw(FILE_SUFFIX_WIDTH) <<
+          mUnlimitedDimensionPosition + 1;
+      mCurrentFileName = mBaseName + "_" + suffix.str() + ".dat";
+      if (mpCurrentOutputFile.get() != nullptr) {
+        mpCurrentOutputFile->close();
+        this->CreateBinaryFixedDimensionFile(mCurrentFileName);
+      }
+    }
+    else {
+      // Start a new row, initially blank
+      mRowStartPosition += mRowWidth;
+      std::vector<double> blank_row(mNumColumns, DBL_MAX);
+      mpCurrentOutputFile->seekp(mRowStartPosition);
+      mpCurrentOutputFile->write(reinterpret_cast<const char*>(&blank_row[0]), mRowWidth);
+    }
+  }
+  else if (mIsUnlimitedDimensionSet) {
     if (mIsFixedDimensionSet) {
       // first close the current file before creating another one
       mpCurrentOutputFile->close();
@@ -440,7 +471,7 @@ void ColumnDataWriter::DoAdvanceAlongUnlimitedDimension()
       if (mIsStreamMode) {
         // go to the end of the current line
         mpStream->seekp(mRowStartPosition + mRowWidth);
-        *mpStream << std::endl;
+        *mpStream << '\n';
         mRowStartPosition = mpStream->tellp();
         std::string blank_line(mRowWidth, ' ');
         *mpStream << blank_line;
@@ -448,7 +479,7 @@ void ColumnDataWriter::DoAdvanceAlongUnlimitedDimension()
       else {
         // go to the end of the current line
         mpCurrentOutputFile->seekp(mRowStartPosition + mRowWidth);
-        (*mpCurrentOutputFile) << std::endl;
+        (*mpCurrentOutputFile) << '\n';
         mRowStartPosition = mpCurrentOutputFile->tellp();
         std::string blank_line(mRowWidth, ' ');
         (*mpCurrentOutputFile) << blank_line;
@@ -501,11 +532,14 @@ void ColumnDataWriter::PutVariable(
     }
   }
 
-  if (mIsUnlimitedDimensionSet) {
+  if (mIsBinary) {
+    this->PutBinaryVariable(variableID, variableValue, dimensionPosition);
+  }
+  else if (mIsUnlimitedDimensionSet) {
     if (mIsFixedDimensionSet) {
       // Go to the correct position in the file
       if (variableID == UNLIMITED_DIMENSION_VAR_ID) {
-        (*mpCurrentAncillaryFile) << std::endl << " ";
+        (*mpCurrentAncillaryFile) << '\n' << " ";
         mpCurrentAncillaryFile->width(mFieldWidth);
         (*mpCurrentAncillaryFile) << variableValue;
       }
@@ -571,3 +605,140 @@ void ColumnDataWriter::PutVariable(
 
   mHasPutVariable = true;
 }
+
+void ColumnDataWriter::SetBinaryOutput(bool binaryOutput)
+{
+  if (!mIsInDefineMode) {
+    EXCEPTION("Cannot change the output format when not in Define mode");
+  }
+  if (binaryOutput && mIsStreamMode) {
+    EXCEPTION("Binary output is not available in stream mode");
+  }
+  mIsBinary = binaryOutput;
+}
+
+std::string ColumnDataWriter::GetBinaryHeaderLine()
+{
+  std::stringstream header;
+  DataWriterVariable* p_first_column = mIsFixedDimensionSet ?
+      mpFixedDimensionVariable : mpUnlimitedDimensionVariable;
+  header << p_first_column->mVariableName << "(" <<
+      p_first_column->mVariableUnits << ")";
+  for (unsigned i = 0; i < mVariables.size(); i++) {
+    header << " " << mVariables[i].mVariableName << "(" <<
+        mVariables[i].mVariableUnits << ")";
+  }
+  header << '\n';
+  return header.str();
+}
+
+void ColumnDataWriter::SetUpBinaryFiles(bool createFiles)
+{
+  // The first column is the fixed dimension variable if there is one,
+  // otherwise the unlimited dimension variable
+  mNumColumns = mVariables.size() + 1;
+  mRowWidth = mNumColumns * sizeof(double);
+  mRowStartPosition = GetBinaryHeaderLine().size();
+
+  if (mIsFixedDimensionSet) {
+    if (mIsUnlimitedDimensionSet) {
+      std::stringstream suffix;
+      suffix << std::setfill('0') << std::setw(FILE_SUFFIX_WIDTH) <<
+          mUnlimitedDimensionPosition;
+      mCurrentFileName = mBaseName + "_" + suffix.str() + ".dat";
+
+      if (createFiles) {
+        mpCurrentAncillaryFile = mOutputFileHandler.OpenOutputFile(
+            mBaseName + "_unlimited.dat", std::ios::out | std::ios::binary);
+        (*mpCurrentAncillaryFile) << mpUnlimitedDimensionVariable->mVariableName <<
+            "(" << mpUnlimitedDimensionVariable->mVariableUnits << ")" << '\n';
+      }
+    }
+    else {
+      mCurrentFileName = mBaseName + ".dat";
+    }
+    if (createFiles) {
+      this->CreateBinaryFixedDimensionFile(mCurrentFileName);
+    }
+  }
+  else {
+    mCurrentFileName = mBaseName + ".dat";
+    if (createFiles) {
+      mpCurrentOutputFile = mOutputFileHandler.OpenOutputFile(mCurrentFileName,
+          std::ios::out | std::ios::binary);
+      (*mpCurrentOutputFile) << GetBinaryHeaderLine();
+      std::vector<double> blank_row(mNumColumns, DBL_MAX);
+      mpCurrentOutputFile->write(reinterpret_cast<const char*>(&blank_row[0]), mRowWidth);
+    }
+  }
+}
+
+void ColumnDataWriter::CreateBinaryFixedDimensionFile(const std::string& rFileName)
+{
+  mpCurrentOutputFile = mOutputFileHandler.OpenOutputFile(rFileName,
+      std::ios::out | std::ios::binary);
+  (*mpCurrentOutputFile) << GetBinaryHeaderLine();
+
+  std::vector<double> blank_column(mFixedDimensionSize, DBL_MAX);
+  for (long column = 0; column < mNumColumns; column++) {
+    mpCurrentOutputFile->write(reinterpret_cast<const char*>(&blank_column[0]),
+        mFixedDimensionSize * sizeof(double));
+  }
+  // Other processes may write into this file directly
+  mpCurrentOutputFile->flush();
+}
+
+void ColumnDataWriter::PutBinaryVariable(
+    int variableID
+  , double variableValue
+  , long dimensionPosition)
+{
+  if (variableID == UNLIMITED_DIMENSION_VAR_ID && mIsFixedDimensionSet) {
+    // Values along the unlimited dimension are appended to the ancillary file
+    mpCurrentAncillaryFile->write(reinterpret_cast<const char*>(&variableValue), sizeof(double));
+    return;
+  }
+
+  long column = (variableID < 0) ? 0 : variableID + 1;
+  std::streamoff position;
+  if (mIsFixedDimensionSet) {
+    position = mRowStartPosition +
+        (column * mFixedDimensionSize + dimensionPosition) * sizeof(double);
+  }
+  else {
+    position = mRowStartPosition + column * sizeof(double);
+  }
+  mpCurrentOutputFile->seekp(position);
+  mpCurrentOutputFile->write(reinterpret_cast<const char*>(&variableValue), sizeof(double));
+}
+
+void ColumnDataWriter::PutBinaryBlock(
+    int variableID
+  , long lo
+  , long hi
+  , const double* pValues)
+{
+  assert(mIsBinary && mIsFixedDimensionSet);
+  assert(0 <= lo && lo <= hi && hi <= mFixedDimensionSize);
+  if (mNeedAdvanceAlongUnlimitedDimension) {
+    DoAdvanceAlongUnlimitedDimension();
+  }
+
+  long column = (variableID < 0) ? 0 : variableID + 1;
+  std::streamoff position = mRowStartPosition +
+      (column * mFixedDimensionSize + lo) * sizeof(double);
+  if (mpCurrentOutputFile.get() != nullptr) {
+    mpCurrentOutputFile->seekp(position);
+    mpCurrentOutputFile->write(reinterpret_cast<const char*>(pValues), (hi - lo) * sizeof(double));
+  }
+  else {
+    std::string path = mOutputFileHandler.GetOutputDirectoryFullPath() + mCurrentFileName;
+    std::fstream file(path.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+    if (!file.is_open()) {
+      EXCEPTION("Couldn't open data file " + path);
+    }
+    file.seekp(position);
+    file.write(reinterpret_cast<const char*>(pValues), (hi - lo) * sizeof(double));
+  }
+  mHasPutVariable = true;
+}
@@ -145,6 +145,64 @@ class ColumnDataWriter : public AbstractDataWriter
    */
   std::string mCommentForInfoFile;
 
+  /** Whether data are written as raw binary doubles rather than text */
+  bool mIsBinary;
+
+  /** The number of columns (including any dimension variable) in a binary data file */
+  long mNumColumns;
+
+  /** The name of the data file currently being written, relative to the output directory */
+  std::string mCurrentFileName;
+
+  /**
+   * @return the header line (names and units of each column, followed
+   * by a newline) at the start of a binary data file.
+   */
+  std::string GetBinaryHeaderLine();
+
+  /**
+   * Work out the layout of binary data files, and (if createFiles) create
+   * the first of them.
+   *
+   * @param createFiles  whether to create the files (false on processes
+   *        which only write blocks into files made by the master)
+   */
+  void SetUpBinaryFiles(bool createFiles=true);
+
+  /**
+   * Create a binary data file for the fixed dimension: a header line
+   * followed by each column in turn, filled with DBL_MAX to show that
+   * nothing has been written yet.
+   *
+   * @param rFileName  the name of the file to write to, relative to
+   *        the output directory
+   */
+  void CreateBinaryFixedDimensionFile(const std::string& rFileName);
+
+  /**
+   * Write a variable into a binary data file.  Arguments are as for
+   * PutVariable, and have already been checked.
+   *
+   * @param variableID  the variable
+   * @param variableValue  the value
+   * @param dimensionPosition  the position along the fixed dimension (or -1)
+   */
+  void PutBinaryVariable(int variableID, double variableValue, long dimensionPosition);
+
+  /**
+   * Write a contiguous block of a fixed dimension variable into the
+   * current binary data file.  If this process does not have the file
+   * open (i.e. it is not the master of a ParallelColumnDataWriter)
+   * the file is opened just for this write, so that processes write
+   * their own parts directly.
+   *
+   * @param variableID  the variable
+   * @param lo  the first position along the fixed dimension
+   * @param hi  one past the last position along the fixed dimension
+   * @param pValues  the values for positions lo to hi-1
+   */
+  void PutBinaryBlock(int variableID, long lo, long hi, const double* pValues);
+
   /**
    * Create the output file and write out the header for it.
    *
@@ -274,6 +332,20 @@ class ColumnDataWriter : public AbstractDataWriter
     mCommentForInfoFile = comment;
   }
 
+  /**
+   * Write the data files as raw binary doubles (in the machine's byte
+   * order) rather than as fixed width text.  This is much faster to
+   * write and read, and keeps full precision.  Each data file starts
+   * with the usual text header line; the info file records that the data
+   * are binary so that ColumnDataReader reads them transparently.
+   * Files with a fixed dimension store each variable contiguously.
+   *
+   * Must be called in define mode, and is not available in stream mode.
+   *
+   * @param binaryOutput  whether to write binary data (defaults to true)
+   */
+  void SetBinaryOutput(bool binaryOutput=true);
+
   /**
    * End the define mode of the DataWriter.
    */
@@ -37,9 +37,16 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  * Implementation file for Hdf5DataWriter class.
  *
  */
+#include <algorithm>
+#include <cmath>
+#include <functional>
 #include <set>
 #include <cstring> //For strcmp etc. Needed in gcc-4.4
 #include <boost/scoped_array.hpp>
+#ifdef __linux__
+#include <sys/stat.h>
+#include <sys/vfs.h>
+#endif // __linux__
 
 #include "Hdf5DataWriter.hpp"
 
@@ -48,6 +55,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "PetscTools.hpp"
 #include "Version.hpp"
 #include "MathsCustomFunctions.hpp"
+#include "Warnings.hpp"
 
 Hdf5DataWriter::Hdf5DataWriter(DistributedVectorFactory& rVectorFactory,
                                const std::string& rDirectory,
@@ -57,6 +65,7 @@ Hdf5DataWriter::Hdf5DataWriter(DistributedVectorFactory& rVectorFactory,
                                std::string datasetName,
                                bool useCache)
     : AbstractHdf5Access(rDirectory, rBaseName, datasetName),
+      AbstractMemoryAccountable(MemoryAccounting::OUTPUT_CACHE),
       mrVectorFactory(rVectorFactory),
       mCleanDirectory(cleanDirectory),
       mUseExistingFile(extendData),
@@ -80,8 +89,18 @@ Hdf5DataWriter::Hdf5DataWriter(DistributedVectorFactory& rVectorFactory,
       mNumberOfChunks(0),
       mChunkTargetSize(0x20000), // 128 K
       mAlignment(0), // No alignment
+      mAutoTuneChunking(false),
+      mAccessPattern(Hdf5AccessPattern::PerTimeStepWrites),
+      mUseCollectiveBufferingHints(false),
+      mUseSinglePrecision(false),
+      mDeflateLevel(0u),
+      mUseShuffleFilter(false),
+      mLossyDecimalDigits(-1),
       mUseCache(useCache),
-      mCacheFirstTimeStep(0u)
+      mCacheFirstTimeStep(0u),
+      mUnlimitedCacheFirstTimeStep(0u),
+      mUseAsynchronousWrites(false),
+      mWriteChannel(1, "Hdf5DataWriter")
 {
     mChunkSize[0] = 0;
     mChunkSize[1] = 0;
@@ -290,6 +309,11 @@ Hdf5DataWriter::~Hdf5DataWriter()
     }
 }
 
+double Hdf5DataWriter::GetMemoryUsage() const
+{
+    return GetVectorBytes(mDataCache) + GetVectorBytes(mUnlimitedCache) + GetVectorBytes(mWriteBuffer);
+}
+
 void Hdf5DataWriter::OpenFile()
 {
     OutputFileHandler output_file_handler(mDirectory, mCleanDirectory);
@@ -304,9 +328,38 @@ void Hdf5DataWriter::OpenFile()
         }
     }
 
+    if (mAutoTuneChunking && !mUseExistingFile)
+    {
+        // Only the master looks at the file system, so that every process makes the same choice
+        unsigned long stripe_size = 0;
+        if (PetscTools::AmMaster())
+        {
+            stripe_size = GetFileSystemStripeSize(mDirectory);
+        }
+        MPI_Bcast(&stripe_size, 1, MPI_UNSIGNED_LONG, 0, PetscTools::GetWorld());
+        if (stripe_size > 0)
+        {
+            mChunkTargetSize = stripe_size;
+            mAlignment = stripe_size;
+        }
+    }
+
     // Set up a property list saying how we'll open the file
     hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
-    H5Pset_fapl_mpio(fapl, PETSC_COMM_WORLD, MPI_INFO_NULL);
+    MPI_Info info = MPI_INFO_NULL;
+    if (mUseCollectiveBufferingHints)
+    {
+        MPI_Info_create(&info);
+        MPI_Info_set(info, const_cast<char*>("romio_cb_write"), const_cast<char*>("enable"));
+        MPI_Info_set(info, const_cast<char*>("romio_cb_read"), const_cast<char*>("enable"));
+        MPI_Info_set(info, const_cast<char*>("romio_ds_write"), const_cast<char*>("disable"));
+    }
+    H5Pset_fapl_mpio(fapl, PetscTools::GetWorld(), info);
+    if (info != MPI_INFO_NULL)
+    {
+        // HDF5 keeps its own copy
+        MPI_Info_free(&info);
+    }
 
     // Set size of each dimension in main dataset.
     mDatasetDims[0] = mEstimatedUnlimitedLength; // While developing we got a non-documented "only the first dimension can be extendible" error.
@@ -619,8 +672,22 @@ void Hdf5DataWriter::EndDefineMode()
     // Create chunked dataset and clean up
     hid_t cparms = H5Pcreate (H5P_DATASET_CREATE);
     H5Pset_chunk( cparms, DATASET_DIMS, mChunkSize);
+    // Filters are applied in the order they are added; scale-offset must see the raw values
+    if (mLossyDecimalDigits >= 0)
+    {
+        H5Pset_scaleoffset(cparms, H5Z_SO_FLOAT_DSCALE, mLossyDecimalDigits);
+    }
+    if (mUseShuffleFilter)
+    {
+        H5Pset_shuffle(cparms);
+    }
+    if (mDeflateLevel > 0u)
+    {
+        H5Pset_deflate(cparms, mDeflateLevel);
+    }
     hid_t filespace = H5Screate_simple(DATASET_DIMS, mDatasetDims, dataset_max_dims);
-    mVariablesDatasetId = H5Dcreate(mFileId, mDatasetName.c_str(), H5T_NATIVE_DOUBLE, filespace,
+    hid_t storage_type = mUseSinglePrecision ? H5T_NATIVE_FLOAT : H5T_NATIVE_DOUBLE;
+    mVariablesDatasetId = H5Dcreate(mFileId, mDatasetName.c_str(), storage_type, filespace,
                                     H5P_DEFAULT, cparms, H5P_DEFAULT);
     SetMainDatasetRawChunkCache(); // Set large cache (even though parallel drivers don't currently use it!)
     H5Sclose(filespace);
@@ -775,6 +842,7 @@ void Hdf5DataWriter::PutVector(int variableID, Vec petscVector)
     {
         EXCEPTION("Cannot write data while in define mode.");
     }
+    WaitForPendingWrite();
 
     int vector_size;
     VecGetSize(petscVector, &vector_size);
@@ -920,6 +988,7 @@ void Hdf5DataWriter::PutStripedVector(std::vector<int> variableIDs, Vec petscVec
     {
         EXCEPTION("Cannot write data while in define mode.");
     }
+    WaitForPendingWrite();
 
     if (variableIDs.size() <= 1)
     {
@@ -1094,6 +1163,25 @@ bool Hdf5DataWriter::GetUsingCache()
 
 void Hdf5DataWriter::WriteCache()
 {
+    WaitForPendingWrite();
+
+    // The unlimited dimension is only written by the master, and not collectively
+    if (!mUnlimitedCache.empty())
+    {
+        hsize_t size[1] = {mUnlimitedCache.size()};
+        hid_t memspace = H5Screate_simple(1, size, nullptr);
+
+        hsize_t offset[1] = {mUnlimitedCacheFirstTimeStep};
+        hid_t hyperslab_space = H5Dget_space(mUnlimitedDatasetId);
+        H5Sselect_hyperslab(hyperslab_space, H5S_SELECT_SET, offset, nullptr, size, nullptr);
+
+        H5Dwrite(mUnlimitedDatasetId, H5T_NATIVE_DOUBLE, memspace, hyperslab_space, H5P_DEFAULT, mUnlimitedCache.data());
+
+        H5Sclose(hyperslab_space);
+        H5Sclose(memspace);
+        mUnlimitedCache.clear();
+    }
+
     // The HDF5 writes are collective which means that if a process has nothing to write from
     // its cache then it must still proceed in step with the other processes.
     bool any_nonempty_caches = PetscTools::ReplicateBool( !mDataCache.empty() );
@@ -1103,20 +1191,42 @@ void Hdf5DataWriter::WriteCache()
         return;
     }
 
-//    PRINT_3_VARIABLES(mCacheFirstTimeStep, mOffset, 0)
-//    PRINT_3_VARIABLES(mCurrentTimeStep-mCacheFirstTimeStep, mNumberOwned, mDatasetDims[2])
-//    PRINT_VARIABLE(mDataCache.size())
+    const hsize_t first_time_step = mCacheFirstTimeStep;
+    const hsize_t num_time_steps = mCurrentTimeStep - mCacheFirstTimeStep;
+    if (mUseAsynchronousWrites)
+    {
+        // Swap buffers, so that caching can carry on while the old contents are written
+        mWriteBuffer.swap(mDataCache);
+        mWriteChannel.Submit([this, first_time_step, num_time_steps]()
+        {
+            WriteCachedData(first_time_step, num_time_steps, mWriteBuffer);
+        });
+    }
+    else
+    {
+        WriteCachedData(first_time_step, num_time_steps, mDataCache);
+    }
+
+    mCacheFirstTimeStep = mCurrentTimeStep; // Update where we got to
+    mDataCache.clear(); // Clear out cache
+}
+
+void Hdf5DataWriter::WriteCachedData(hsize_t firstTimeStep, hsize_t numTimeSteps, const std::vector<double>& rData)
+{
+//    PRINT_3_VARIABLES(firstTimeStep, mOffset, 0)
+//    PRINT_3_VARIABLES(numTimeSteps, mNumberOwned, mDatasetDims[2])
+//    PRINT_VARIABLE(rData.size())
 
     // Define memspace and hyperslab
     hid_t memspace, hyperslab_space;
     if (mNumberOwned != 0)
     {
-        hsize_t v_size[1] = {mDataCache.size()};
+        hsize_t v_size[1] = {rData.size()};
         memspace = H5Screate_simple(1, v_size, nullptr);
 
-        hsize_t start[DATASET_DIMS] = {mCacheFirstTimeStep, mOffset, 0};
-        hsize_t count[DATASET_DIMS] = {mCurrentTimeStep-mCacheFirstTimeStep, mNumberOwned, mDatasetDims[2]};
-        assert((mCurrentTimeStep-mCacheFirstTimeStep)*mNumberOwned*mDatasetDims[2] == mDataCache.size()); // Got size right?
+        hsize_t start[DATASET_DIMS] = {firstTimeStep, mOffset, 0};
+        hsize_t count[DATASET_DIMS] = {numTimeSteps, mNumberOwned, mDatasetDims[2]};
+        assert(numTimeSteps*mNumberOwned*mDatasetDims[2] == rData.size()); // Got size right?
 
         hyperslab_space = H5Dget_space(mVariablesDatasetId);
         H5Sselect_hyperslab(hyperslab_space, H5S_SELECT_SET, start, nullptr, count, nullptr);
@@ -1132,15 +1242,58 @@ void Hdf5DataWriter::WriteCache()
     H5Pset_dxpl_mpio(property_list_id, H5FD_MPIO_COLLECTIVE);
 
     // Write!
-    H5Dwrite(mVariablesDatasetId, H5T_NATIVE_DOUBLE, memspace, hyperslab_space, property_list_id, &mDataCache[0]);
+    H5Dwrite(mVariablesDatasetId, H5T_NATIVE_DOUBLE, memspace, hyperslab_space, property_list_id, rData.data());
 
     // Tidy up
     H5Sclose(memspace);
     H5Sclose(hyperslab_space);
     H5Pclose(property_list_id);
+}
 
-    mCacheFirstTimeStep = mCurrentTimeStep; // Update where we got to
-    mDataCache.clear(); // Clear out cache
+void Hdf5DataWriter::WaitForPendingWrite()
+{
+    mWriteChannel.Flush();
+    mWriteBuffer.clear();
+}
+
+void Hdf5DataWriter::SetUseAsynchronousWrites(bool useAsynchronousWrites)
+{
+    if (useAsynchronousWrites && !mUseCache)
+    {
+        EXCEPTION("Asynchronous writes require the writer to cache writes.");
+    }
+    WaitForPendingWrite();
+    if (useAsynchronousWrites)
+    {
+        int thread_support;
+        MPI_Query_thread(&thread_support);
+        if (thread_support < MPI_THREAD_MULTIPLE)
+        {
+            WARNING("MPI has not been initialised with MPI_THREAD_MULTIPLE support, so HDF5 output will be written synchronously.");
+            useAsynchronousWrites = false;
+        }
+        else if (!IsHdf5LibraryThreadSafe())
+        {
+            // The worker thread's HDF5 calls would race with those made by the main thread (e.g. by other writers)
+            WARNING("The HDF5 library was not built thread-safe, so HDF5 output will be written synchronously.");
+            useAsynchronousWrites = false;
+        }
+    }
+    mUseAsynchronousWrites = useAsynchronousWrites;
+}
+
+bool Hdf5DataWriter::IsHdf5LibraryThreadSafe()
+{
+    hbool_t is_thread_safe = false;
+#if H5_VERS_MAJOR > 1 || (H5_VERS_MAJOR == 1 && (H5_VERS_MINOR > 10 || (H5_VERS_MINOR == 10 && H5_VERS_RELEASE >= 1) || (H5_VERS_MINOR == 8 && H5_VERS_RELEASE >= 16))) // HDF5 1.8.16+ or 1.10.1+
+    H5is_library_threadsafe(&is_thread_safe);
+#endif
+    return is_thread_safe;
+}
+
+bool Hdf5DataWriter::GetUsingAsynchronousWrites() const
+{
+    return mUseAsynchronousWrites;
 }
 
 void Hdf5DataWriter::PutUnlimitedVariable(double value)
@@ -1154,6 +1307,7 @@ void Hdf5DataWriter::PutUnlimitedVariable(double value)
     {
         EXCEPTION("PutUnlimitedVariable() called but no unlimited dimension has been set");
     }
+    WaitForPendingWrite();
 
     // Make sure that everything is actually extended to the correct dimension.
     PossiblyExtend();
@@ -1164,6 +1318,18 @@ void Hdf5DataWriter::PutUnlimitedVariable(double value)
         return;
     }
 
+    if (mUseCache)
+    {
+        // Written along with the cached data, so that outputting a time step needs no file access
+        if (mUnlimitedCache.empty())
+        {
+            mUnlimitedCacheFirstTimeStep = mCurrentTimeStep;
+        }
+        assert(mCurrentTimeStep == mUnlimitedCacheFirstTimeStep + mUnlimitedCache.size());
+        mUnlimitedCache.push_back(value);
+        return;
+    }
+
     hsize_t size[1] = {1};
     hid_t memspace = H5Screate_simple(1, size, nullptr);
 
@@ -1190,6 +1356,7 @@ void Hdf5DataWriter::Close()
     {
         WriteCache();
     }
+    WaitForPendingWrite();
 
     H5Dclose(mVariablesDatasetId);
     if (mIsUnlimitedDimensionSet)
@@ -1256,6 +1423,7 @@ void Hdf5DataWriter::PossiblyExtend()
 {
     if (mNeedExtend)
     {
+        WaitForPendingWrite();
         H5Dset_extent( mVariablesDatasetId, mDatasetDims );
         H5Dset_extent( mUnlimitedDatasetId, mDatasetDims );
     }
@@ -1406,7 +1574,7 @@ hsize_t Hdf5DataWriter::CalculateNumberOfChunks()
 void Hdf5DataWriter::CalculateChunkDims( unsigned targetSize, unsigned* pChunkSizeInBytes, bool* pAllOneChunk )
 {
     bool all_one_chunk = true;
-    unsigned chunk_size_in_bytes = 8u; // 8 bytes/double
+    unsigned chunk_size_in_bytes = mUseSinglePrecision ? 4u : 8u; // 4 bytes/float, 8 bytes/double
     unsigned divisors[DATASET_DIMS];
     // Loop over dataset dimensions, dividing each dimension into the integer number of chunks that results
     // in the number of entries closest to the targetSize. This means the chunks will span the dataset with
@@ -1429,7 +1597,11 @@ void Hdf5DataWriter::CalculateChunkDims( unsigned targetSize, unsigned* pChunkSi
 
 void Hdf5DataWriter::SetChunkSize()
 {
-    if (mUseOptimalChunkSizeAlgorithm)
+    if (mAutoTuneChunking)
+    {
+        CalculateAutoTunedChunkDims();
+    }
+    else if (mUseOptimalChunkSizeAlgorithm)
     {
         const unsigned target_size_in_bytes = mChunkTargetSize;
 
@@ -1474,6 +1646,41 @@ void Hdf5DataWriter::SetChunkSize()
     */
 }
 
+void Hdf5DataWriter::CalculateAutoTunedChunkDims()
+{
+    const hsize_t bytes_per_value = mUseSinglePrecision ? 4u : 8u;
+    const hsize_t num_time_steps = mDatasetDims[0];
+    const hsize_t num_nodes = mDatasetDims[1];
+    const hsize_t num_variables = mDatasetDims[2];
+
+    // The number of (time step, node) entries, each holding all the variables, that fit in the target
+    const hsize_t bytes_per_entry = bytes_per_value*num_variables;
+    const hsize_t entries_per_chunk = std::max<hsize_t>(mChunkTargetSize/bytes_per_entry, 1u);
+
+    mChunkSize[2] = num_variables;
+    if (mAccessPattern == Hdf5AccessPattern::NodeTimeSeriesReads)
+    {
+        // Long and thin: as many time steps as fit, then as many nodes as the remaining space allows
+        mChunkSize[0] = std::min(num_time_steps, entries_per_chunk);
+        mChunkSize[1] = std::min(num_nodes, std::max<hsize_t>(entries_per_chunk/mChunkSize[0], 1u));
+    }
+    else
+    {
+        // Short and wide: split the nodes into as few pieces as fit, rounded up to a multiple of
+        // the number of processes so that pieces follow the (roughly equal) ownership ranges
+        hsize_t num_node_pieces = CeilDivide(num_nodes, entries_per_chunk);
+        const hsize_t num_procs = PetscTools::GetNumProcs();
+        if (num_nodes >= num_procs)
+        {
+            num_node_pieces = num_procs*CeilDivide(num_node_pieces, num_procs);
+        }
+        mChunkSize[1] = CeilDivide(num_nodes, num_node_pieces);
+
+        // Then fill any remaining space with time steps
+        mChunkSize[0] = std::min(num_time_steps, std::max<hsize_t>(entries_per_chunk/mChunkSize[1], 1u));
+    }
+}
+
 void Hdf5DataWriter::SetTargetChunkSize(hsize_t targetSize)
 {
     if (!mIsInDefineMode)
@@ -1512,3 +1719,103 @@ void Hdf5DataWriter::SetAlignment(hsize_t alignment)
 
     mAlignment = alignment;
 }
+
+void Hdf5DataWriter::SetAutoTuneChunking(Hdf5AccessPattern::Value accessPattern)
+{
+    if (!mIsInDefineMode)
+    {
+        EXCEPTION("Cannot set chunk auto-tuning when not in define mode.");
+    }
+    mAutoTuneChunking = true;
+    mAccessPattern = accessPattern;
+}
+
+void Hdf5DataWriter::SetUseCollectiveBufferingHints(bool useHints)
+{
+    if (!mIsInDefineMode)
+    {
+        EXCEPTION("Cannot set MPI-IO hints when not in define mode.");
+    }
+    mUseCollectiveBufferingHints = useHints;
+}
+
+hsize_t Hdf5DataWriter::GetFileSystemStripeSize(const FileFinder& rDirectory)
+{
+    hsize_t stripe_size = 0;
+#ifdef __linux__
+    struct statfs fs_info;
+    struct stat dir_info;
+    const std::string path = rDirectory.GetAbsolutePath();
+    if (statfs(path.c_str(), &fs_info) == 0 && stat(path.c_str(), &dir_info) == 0)
+    {
+        // File system magic numbers, as in the kernel and the file systems' own headers
+        const long lustre_magic = 0x0BD00BD0;
+        const long gpfs_magic = 0x47504653;
+        const long beegfs_magic = 0x19830326;
+        const long fs_type = (long)fs_info.f_type;
+        if (fs_type == lustre_magic || fs_type == gpfs_magic || fs_type == beegfs_magic)
+        {
+            // These report the stripe (or file system block) size as the preferred I/O size
+            stripe_size = dir_info.st_blksize;
+        }
+    }
+#endif // __linux__
+    return stripe_size;
+}
+
+void Hdf5DataWriter::SetUseSinglePrecisionStorage(bool useSinglePrecision)
+{
+    if (!mIsInDefineMode)
+    {
+        EXCEPTION("Cannot set the storage precision when not in define mode.");
+    }
+    mUseSinglePrecision = useSinglePrecision;
+}
+
+/**
+ * @return whether this HDF5 library can write filtered (compressed) datasets in parallel
+ */
+static bool CanWriteFilteredDatasetsInParallel()
+{
+#if H5_VERS_MAJOR > 1 || (H5_VERS_MAJOR == 1 && (H5_VERS_MINOR > 10 || (H5_VERS_MINOR == 10 && H5_VERS_RELEASE >= 2))) // HDF5 1.10.2+
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Hdf5DataWriter::SetCompression(unsigned deflateLevel, bool useShuffle)
+{
+    if (!mIsInDefineMode)
+    {
+        EXCEPTION("Cannot set compression when not in define mode.");
+    }
+    if (deflateLevel > 9u)
+    {
+        EXCEPTION("The deflate compression level must be between 0 and 9.");
+    }
+    if (deflateLevel > 0u && PetscTools::IsParallel() && !CanWriteFilteredDatasetsInParallel())
+    {
+        EXCEPTION("Writing compressed HDF5 data in parallel requires HDF5 1.10.2 or later."); // LCOV_EXCL_LINE
+    }
+    mDeflateLevel = deflateLevel;
+    mUseShuffleFilter = useShuffle && deflateLevel > 0u;
+}
+
+void Hdf5DataWriter::SetLossyCompressionErrorBound(double absoluteError)
+{
+    if (!mIsInDefineMode)
+    {
+        EXCEPTION("Cannot set compression when not in define mode.");
+    }
+    if (absoluteError <= 0.0)
+    {
+        EXCEPTION("The error bound for lossy compression must be positive.");
+    }
+    if (PetscTools::IsParallel() && !CanWriteFilteredDatasetsInParallel())
+    {
+        EXCEPTION("Writing compressed HDF5 data in parallel requires HDF5 1.10.2 or later."); // LCOV_EXCL_LINE
+    }
+    // Rounding to d decimal places gives an error of at most 0.5*10^-d
+    mLossyDecimalDigits = std::max(0, (int) ceil(-log10(2.0*absoluteError)));
+}
@@ -39,13 +39,29 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <vector>
 
 #include "AbstractHdf5Access.hpp"
+#include "AsynchronousIoChannel.hpp"
+#include "AbstractMemoryAccountable.hpp"
 #include "DataWriterVariable.hpp"
 #include "DistributedVectorFactory.hpp"
 
+/**
+ * The way the main dataset of an HDF5 file is expected to be accessed, used by
+ * Hdf5DataWriter::SetAutoTuneChunking() to choose the shape of its chunks.
+ */
+namespace Hdf5AccessPattern
+{
+    /** The possible access patterns. */
+    typedef enum
+    {
+        PerTimeStepWrites,  /**< Whole time steps are written (and read back), the usual case for simulation output */
+        NodeTimeSeriesReads /**< The data will mostly be read back as time series at a few nodes */
+    } Value;
+}
+
 /**
  * A concrete HDF5 data writer class.
  */
-class Hdf5DataWriter : public AbstractHdf5Access //: public AbstractDataWriter
+class Hdf5DataWriter : public AbstractHdf5Access, public AbstractMemoryAccountable //: public AbstractDataWriter
 {
     friend class TestHdf5DataWriter;
 private:
@@ -86,10 +102,40 @@ private:
     hsize_t mChunkTargetSize;                       /**< User-provided target chunk size (for the algorithm) */
 
     hsize_t mAlignment;                             /**< User-provided alignment parameter */
+    bool mAutoTuneChunking;                         /**< Whether to choose chunk dimensions and alignment from the file system */
+    Hdf5AccessPattern::Value mAccessPattern;        /**< The expected access pattern when auto-tuning chunks */
+    bool mUseCollectiveBufferingHints;              /**< Whether to pass MPI-IO collective buffering hints when opening the file */
+
+    bool mUseSinglePrecision;                       /**< Whether the main dataset is stored as 32-bit floats */
+    unsigned mDeflateLevel;                         /**< gzip compression level for the main dataset (0 for none) */
+    bool mUseShuffleFilter;                         /**< Whether to apply the shuffle filter before deflating */
+    int mLossyDecimalDigits;                        /**< Decimal digits kept by the scale-offset filter (negative for lossless) */
 
     bool mUseCache;                                 /**< Whether to use a cache */
     long unsigned mCacheFirstTimeStep;              /**< Coordinate to keep track of cache writes */
     std::vector<double> mDataCache;                 /**< Cache results here before writing */
+    std::vector<double> mUnlimitedCache;            /**< Cache unlimited dimension values (master only) before writing */
+    long unsigned mUnlimitedCacheFirstTimeStep;     /**< The time step of the first entry in #mUnlimitedCache */
+
+    bool mUseAsynchronousWrites;                    /**< Whether the cache is written to disk by an I/O worker thread */
+    std::vector<double> mWriteBuffer;               /**< The cache contents being written through #mWriteChannel */
+    AsynchronousIoChannel mWriteChannel;            /**< The channel writing #mWriteBuffer; shared by all HDF5 writers, which use one worker */
+
+    /**
+     * Write cached data covering a block of whole time steps to the dataset.
+     * Collective (all processes must call it, even with no data).
+     *
+     * @param firstTimeStep  the first time step held in the data
+     * @param numTimeSteps  the number of time steps held in the data
+     * @param rData  the data, as stored in #mDataCache
+     */
+    void WriteCachedData(hsize_t firstTimeStep, hsize_t numTimeSteps, const std::vector<double>& rData);
+
+    /**
+     * Wait until any background write of the cache has finished. This must be called
+     * before any other HDF5 call, since only one thread may use the library at a time.
+     */
+    void WaitForPendingWrite();
 
     /**
      * Check name of variable is allowed, i.e. contains only alphanumeric & _, and isn't blank.
@@ -143,6 +189,15 @@ private:
      */
     void SetChunkSize();
 
+    /**
+     * Choose chunk dimensions for #mAccessPattern with at most #mChunkTargetSize bytes per chunk.
+     * All variables share a chunk.  For per-time-step writes a chunk holds as few time steps as
+     * possible and, where the target allows, the nodes are split into a multiple of the number of
+     * processes, so that each process mostly writes to chunks of its own.  For time series reads
+     * a chunk holds as many time steps as possible and as few nodes as possible.
+     */
+    void CalculateAutoTunedChunkDims();
+
 public:
 
     /**
@@ -155,6 +210,8 @@ public:
      * @param extendData  whether to try opening an existing file and appending to it.
      * @param datasetName The name of the HDF5 dataset to write, defaults to "Data".
      * @param useCache  Whether to cache writes so only whole chunks are written to disk.
+     *        The unlimited dimension values are cached too, so (given a good estimate of the
+     *        unlimited dimension length) outputting a time step does not touch the file at all.
      *
      * The extendData parameter allows us to add to an existing dataset.  It only really makes
      * sense if the existing file has an unlimited dimension which we can extend.  It also only
@@ -173,6 +230,13 @@ public:
      */
     virtual ~Hdf5DataWriter();
 
+    /**
+     * Estimate the memory held in this writer's caches, for MemoryAccounting.
+     *
+     * @return the number of bytes reserved by the data, unlimited dimension and write buffers
+     */
+    double GetMemoryUsage() const;
+
     /**
      * Define the fixed dimension, assuming complete data output (all the nodes).
      *
@@ -266,10 +330,39 @@ public:
     bool GetUsingCache();
 
     /**
-     * Write the cache to disk.
+     * Write the cache to disk.  With asynchronous writes (see SetUseAsynchronousWrites())
+     * this returns as soon as the cache has been handed to an I/O worker thread.
      */
     void WriteCache();
 
+    /**
+     * Write the cache to disk on an I/O worker thread of the AsynchronousIoService,
+     * so that the simulation can carry on while the (collective) write to the file
+     * system happens.  The cache is double-buffered: results for the next chunk are
+     * cached while the previous one is written, and the write is waited for before
+     * the writer next touches the file (and by Close()).
+     *
+     * Requires a cached writer (the useCache constructor argument), MPI to have
+     * been initialised with MPI_THREAD_MULTIPLE, since the HDF5 writes call MPI from
+     * the worker thread, and a thread-safe HDF5 library, since the main thread
+     * carries on making HDF5 calls (through this and other writers and readers).
+     * Otherwise a warning is given and writes stay synchronous.
+     *
+     * @param useAsynchronousWrites  whether to write asynchronously
+     */
+    void SetUseAsynchronousWrites(bool useAsynchronousWrites=true);
+
+    /**
+     * @return whether the HDF5 library was built thread-safe (always false for HDF5
+     * versions too old to tell us), which asynchronous writes need.
+     */
+    static bool IsHdf5LibraryThreadSafe();
+
+    /**
+     * @return whether the cache is being written to disk asynchronously
+     */
+    bool GetUsingAsynchronousWrites() const;
+
     /**
      * Write a single value for the unlimited variable (e.g. time) to the dataset.
      *
@@ -410,6 +503,91 @@ public:
      * @param alignment Alignment (bytes)
      */
     void SetAlignment(hsize_t alignment);
+
+    /**
+     * Choose the chunk dimensions and alignment automatically.  When the output directory
+     * is on a parallel file system whose stripe size can be found (see
+     * GetFileSystemStripeSize()), the target chunk size (see SetTargetChunkSize()) and
+     * the alignment (see SetAlignment()) are both set to the stripe size, so that each
+     * chunk gets its own stripe; otherwise the current target is kept and chunks are not
+     * aligned.  The chunk shape is then chosen for the given access pattern rather than by
+     * the general algorithm.
+     *
+     * For time series reads it helps to give a good estimate of the number of time steps
+     * in DefineUnlimitedDimension().
+     *
+     * This method only has an effect when creating a NEW DATASET, and the alignment only
+     * for a NEW HDF5 FILE.  Must be called in define mode.  Overrides SetFixedChunkSize().
+     *
+     * @param accessPattern  how the dataset is expected to be accessed
+     */
+    void SetAutoTuneChunking(Hdf5AccessPattern::Value accessPattern=Hdf5AccessPattern::PerTimeStepWrites);
+
+    /**
+     * Ask MPI-IO to use collective buffering when the file is opened, by passing the ROMIO
+     * hints romio_cb_write and romio_cb_read ("enable") and turning off data sieving for
+     * writes (romio_ds_write "disable").  Combined with the collective transfers already
+     * used for writing, this lets a few aggregator processes write whole stripes.  MPI
+     * implementations ignore hints they do not understand.
+     *
+     * Must be called in define mode.
+     *
+     * @param useHints  whether to pass the hints
+     */
+    void SetUseCollectiveBufferingHints(bool useHints=true);
+
+    /**
+     * Find the stripe size of a directory on a parallel file system (Lustre, GPFS or
+     * BeeGFS), which such file systems report as the preferred I/O block size.
+     *
+     * @param rDirectory  the directory
+     * @return the stripe size in bytes, or zero if the directory is not on a recognised
+     *     parallel file system or the size cannot be found
+     */
+    static hsize_t GetFileSystemStripeSize(const FileFinder& rDirectory);
+
+    /**
+     * Store the main dataset as 32-bit rather than 64-bit floating point numbers.
+     * Values are still written and read as doubles (HDF5 does the conversion), so
+     * this halves the file size at the cost of about 7 significant figures of
+     * precision.  The chunk size algorithm (see SetTargetChunkSize()) allows for the
+     * smaller values.
+     *
+     * Must be called in define mode.
+     *
+     * @param useSinglePrecision  whether to store 32-bit floats
+     */
+    void SetUseSinglePrecisionStorage(bool useSinglePrecision=true);
+
+    /**
+     * Compress the main dataset with the (lossless) deflate filter, optionally
+     * preceded by the shuffle filter which usually improves the compression of
+     * floating point data.  Compression acts on whole chunks, so the chunk size
+     * (see SetTargetChunkSize()) also sets the granularity of compression.
+     *
+     * Writing compressed data in parallel requires HDF5 1.10.2 or later.
+     *
+     * Must be called in define mode.
+     *
+     * @param deflateLevel  the gzip compression level, from 0 (none) to 9 (most)
+     * @param useShuffle  whether to shuffle bytes before deflating
+     */
+    void SetCompression(unsigned deflateLevel, bool useShuffle=true);
+
+    /**
+     * Use the HDF5 scale-offset filter to store values to within a given absolute
+     * error, e.g. 0.1 mV for voltage traces.  This is lossy: values are rounded
+     * to the number of decimal places needed to meet the bound (so the actual
+     * error is at most half the bound) and stored as packed integers.  It applies
+     * to every variable in the dataset, and combines with SetCompression().
+     *
+     * Writing compressed data in parallel requires HDF5 1.10.2 or later.
+     *
+     * Must be called in define mode.
+     *
+     * @param absoluteError  the largest error allowed in any stored value
+     */
+    void SetLossyCompressionErrorBound(double absoluteError);
 };
 
 #endif /*HDF5DATAWRITER_HPP_*/
@@ -44,7 +44,7 @@ ParallelColumnDataWriter::ParallelColumnDataWriter(const std::string& rDirectory
       mConcentrated(nullptr)
 {
     int num_procs;
-    MPI_Comm_size(PETSC_COMM_WORLD, &num_procs);
+    MPI_Comm_size(PetscTools::GetWorld(), &num_procs);
     if (num_procs==1)
     {
         mIsParallel = false;
@@ -65,6 +65,23 @@ void ParallelColumnDataWriter::PutVector(int variableID, Vec petscVector)
         EXCEPTION("Size of vector does not match FixedDimensionSize.");
     }
 
+    if (mIsBinary)
+    {
+        // Each process writes its own part of the vector straight into the file,
+        // once the master has created it
+        if (mIsParallel)
+        {
+            PetscTools::Barrier("ParallelColumnDataWriter::PutVector");
+        }
+        PetscInt lo, hi;
+        VecGetOwnershipRange(petscVector, &lo, &hi);
+        double* p_values;
+        VecGetArray(petscVector, &p_values);
+        ColumnDataWriter::PutBinaryBlock(variableID, lo, hi, p_values);
+        VecRestoreArray(petscVector, &p_values);
+        return;
+    }
+
     // Construct the appropriate "scatter" object to concentrate the vector on the master
     if (mConcentrated==nullptr)
     {
@@ -124,6 +141,11 @@ void ParallelColumnDataWriter::EndDefineMode()
     }
     else
     {
+        if (mIsBinary)
+        {
+            // Work out the file layout, so that this process can write its own blocks
+            ColumnDataWriter::SetUpBinaryFiles(false);
+        }
         mIsInDefineMode = false;
     }
 }
@@ -160,7 +182,8 @@ void ParallelColumnDataWriter::AdvanceAlongUnlimitedDimension()
     // Paranoia
     PetscTools::Barrier("ParallelColumnDataWriter::AdvanceAlongUnlimitedDimension");
 
-    if (PetscTools::AmMaster())
+    // With binary output every process writes into the fixed dimension files, so needs to keep track of them
+    if (PetscTools::AmMaster() || (mIsBinary && mIsFixedDimensionSet))
     {
         ColumnDataWriter::DoAdvanceAlongUnlimitedDimension();
     }
@@ -0,0 +1,137 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTADIOS2DATAWRITER_HPP_
+#define TESTADIOS2DATAWRITER_HPP_
+
+#include <cxxtest/TestSuite.h>
+
+#include <vector>
+
+#include "Adios2DataWriter.hpp"
+#include "DistributedVectorFactory.hpp"
+#include "OutputFileHandler.hpp"
+#include "PetscTools.hpp"
+#include "PetscSetupAndFinalize.hpp"
+
+class TestAdios2DataWriter : public CxxTest::TestSuite
+{
+public:
+
+    void TestWriteAndReadBack()
+    {
+#ifdef CHASTE_ADIOS2
+        // Write to a BP4 file rather than a stream, so that the data can be checked afterwards
+        const unsigned num_nodes = 10;
+        DistributedVectorFactory factory(num_nodes);
+        Adios2DataWriter writer(factory, "TestAdios2DataWriter", "striped", "BP4");
+
+        TS_ASSERT_THROWS_THIS(writer.DefineFixedDimension(num_nodes+1), "Vector size doesn't match fixed dimension");
+        writer.DefineFixedDimension(num_nodes);
+        writer.DefineUnlimitedDimension("Time", "msec");
+        std::vector<int> variable_ids;
+        variable_ids.push_back(writer.DefineVariable("V", "mV"));
+        variable_ids.push_back(writer.DefineVariable("Phi_e", "mV"));
+        TS_ASSERT_THROWS_THIS(writer.DefineVariable("V", "mV"), "Variable name already exists");
+        TS_ASSERT_THROWS_THIS(writer.PutUnlimitedVariable(0.0), "Cannot write data while in define mode.");
+        writer.EndDefineMode();
+        TS_ASSERT(!writer.IsInDefineMode());
+
+        // Stripe i of node n at step t holds 100*t + 10*n + i
+        Vec striped = factory.CreateVec(2);
+        const unsigned num_steps = 3;
+        for (unsigned step=0; step<num_steps; step++)
+        {
+            double* p_local_data;
+            VecGetArray(striped, &p_local_data);
+            for (unsigned node=factory.GetLow(); node<factory.GetHigh(); node++)
+            {
+                for (unsigned i=0; i<2; i++)
+                {
+                    p_local_data[2*(node - factory.GetLow()) + i] = 100.0*step + 10.0*node + i;
+                }
+            }
+            VecRestoreArray(striped, &p_local_data);
+            writer.PutStripedVector(variable_ids, striped);
+            writer.PutUnlimitedVariable(0.5*step);
+            writer.AdvanceAlongUnlimitedDimension();
+        }
+        writer.Close();
+        PetscTools::Destroy(striped);
+        PetscTools::Barrier("TestWriteAndReadBack");
+
+        // Read everything back on the master
+        if (PetscTools::AmMaster())
+        {
+            OutputFileHandler handler("TestAdios2DataWriter", false);
+            adios2::ADIOS adios(PETSC_COMM_SELF);
+            adios2::IO io = adios.DeclareIO("reader");
+            io.SetEngine("BP4");
+            adios2::Engine reader = io.Open(handler.GetOutputDirectoryFullPath() + "striped", adios2::Mode::Read);
+
+            unsigned step = 0;
+            while (reader.BeginStep() == adios2::StepStatus::OK)
+            {
+                adios2::Variable<double> time = io.InquireVariable<double>("Time");
+                adios2::Variable<double> phi_e = io.InquireVariable<double>("Phi_e");
+                TS_ASSERT(time);
+                TS_ASSERT(phi_e);
+                TS_ASSERT_EQUALS(phi_e.Shape()[0], num_nodes);
+
+                double time_value;
+                std::vector<double> phi_e_values;
+                reader.Get(time, time_value, adios2::Mode::Sync);
+                reader.Get(phi_e, phi_e_values, adios2::Mode::Sync);
+                reader.EndStep();
+
+                TS_ASSERT_DELTA(time_value, 0.5*step, 1e-12);
+                for (unsigned node=0; node<num_nodes; node++)
+                {
+                    TS_ASSERT_DELTA(phi_e_values[node], 100.0*step + 10.0*node + 1.0, 1e-12);
+                }
+                step++;
+            }
+            reader.Close();
+            TS_ASSERT_EQUALS(step, num_steps);
+            TS_ASSERT_EQUALS(io.InquireAttribute<std::string>("units", "V").Data()[0], "mV");
+        }
+#else
+        std::cout << "This test was not run, as ADIOS2 is not enabled." << std::endl;
+        std::cout << "If required please install it and configure Chaste with -DChaste_USE_ADIOS2=ON." << std::endl;
+#endif // CHASTE_ADIOS2
+    }
+};
+
+#endif /*TESTADIOS2DATAWRITER_HPP_*/
@@ -43,6 +43,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ColumnDataReader.hpp"
 #include "Exception.hpp"
 #include <cassert>
+#include <cfloat>
 //This test is always run sequentially (never in parallel)
 #include "FakePetscSetup.hpp"
 
@@ -607,6 +608,87 @@ public:
         CompareVectors(our_reader.GetUnlimitedDimensionValues(), good_reader.GetUnlimitedDimensionValues(), 1e-6);
     }
 
+    void TestBinaryOutput()
+    {
+        // Time series, as written by ODE solvers
+        {
+            ColumnDataWriter writer("TestColumnDataReaderWriter", "testbinaryunlimited", false);
+            int time_var_id = writer.DefineUnlimitedDimension("Time", "msecs");
+            int v_var_id = writer.DefineVariable("V", "mV");
+            int ca_var_id = writer.DefineVariable("Cai", "mM");
+            writer.SetBinaryOutput();
+            writer.EndDefineMode();
+            TS_ASSERT_THROWS_THIS(writer.SetBinaryOutput(false), "Cannot change the output format when not in Define mode");
+
+            for (unsigned i=0; i<10; i++)
+            {
+                writer.PutVariable(time_var_id, 0.1*i);
+                writer.PutVariable(v_var_id, -84.0 + 1e-9*i);
+                if (i != 4)
+                {
+                    writer.PutVariable(ca_var_id, 1.1e-130*i);
+                }
+                writer.AdvanceAlongUnlimitedDimension();
+            }
+        }
+        ColumnDataReader unlimited_reader("TestColumnDataReaderWriter", "testbinaryunlimited");
+        std::vector<double> times = unlimited_reader.GetUnlimitedDimensionValues();
+        std::vector<double> voltages = unlimited_reader.GetValues("V");
+        std::vector<double> calcium = unlimited_reader.GetValues("Cai");
+        TS_ASSERT_EQUALS(times.size(), 10u);
+        TS_ASSERT_EQUALS(voltages.size(), 10u);
+        for (unsigned i=0; i<10; i++)
+        {
+            TS_ASSERT_EQUALS(times[i], 0.1*i);
+            TS_ASSERT_EQUALS(voltages[i], -84.0 + 1e-9*i);
+            TS_ASSERT_EQUALS(calcium[i], (i == 4) ? DBL_MAX : 1.1e-130*i);
+        }
+        TS_ASSERT_EQUALS(unlimited_reader.GetFieldWidth(), 0u);
+
+        // Fixed and unlimited dimensions, compared with the text format
+        {
+            ColumnDataWriter writer("TestColumnDataReaderWriter", "testbinaryfixedandunlimited", false);
+            int node_var_id = writer.DefineFixedDimension("Node", "dimensionless", 4);
+            int time_var_id = writer.DefineUnlimitedDimension("Time", "msecs");
+            int ina_var_id = writer.DefineVariable("I_Na", "milliamperes");
+            int ik_var_id = writer.DefineVariable("I_K", "milliamperes");
+            int ica_var_id = writer.DefineVariable("I_Ca", "milliamperes");
+            writer.SetBinaryOutput();
+            writer.EndDefineMode();
+
+            writer.PutVariable(time_var_id, 0.1);
+            writer.PutVariable(node_var_id, 0, 0);
+            writer.PutVariable(ina_var_id, 12.0, 0);
+            writer.PutVariable(ina_var_id, 12.0, 1);
+            writer.PutVariable(ica_var_id, 1.1e130, 0);
+            writer.PutVariable(ica_var_id, -1.1e130, 1);
+            writer.PutVariable(ica_var_id, 1.1e-130, 2);
+            writer.PutVariable(ica_var_id, -33.124, 3);
+            writer.PutVariable(ik_var_id, -3.3e111, 0);
+            writer.PutVariable(ik_var_id, 3.3e-111, 1);
+            writer.PutVariable(ik_var_id, -3.3e-111, 2);
+            writer.PutVariable(ik_var_id, 7124.12355553, 3);
+            writer.AdvanceAlongUnlimitedDimension();
+            writer.PutVariable(node_var_id, 0, 0);
+            writer.PutVariable(ica_var_id, 63.124, 2);
+            writer.PutVariable(ica_var_id, -35.124, 3);
+            writer.PutVariable(time_var_id, 0.2);
+        }
+        ColumnDataReader good_reader("io/test/data", "testfixedandunlimited", false);
+        ColumnDataReader binary_reader("TestColumnDataReaderWriter", "testbinaryfixedandunlimited");
+        for (int i=0; i<4; i++)
+        {
+            CompareVectors(binary_reader.GetValues("I_K", i), good_reader.GetValues("I_K", i), 1e-5); // Text is rounded to 8 digits
+            CompareVectors(binary_reader.GetValues("I_Ca", i), good_reader.GetValues("I_Ca", i), 1e-6);
+        }
+        CompareVectors(binary_reader.GetUnlimitedDimensionValues(), good_reader.GetUnlimitedDimensionValues(), 1e-6);
+        TS_ASSERT_EQUALS(binary_reader.GetValues("I_Ca", 3)[1], -35.124);
+
+        boost::shared_ptr<std::stringstream> p_stream(new std::stringstream);
+        ColumnDataWriter stream_writer(p_stream);
+        TS_ASSERT_THROWS_THIS(stream_writer.SetBinaryOutput(), "Binary output is not available in stream mode");
+    }
+
     /*
      * This test is just to cover the line in ColumnDataWriter::PutVariable where
      * the fixed and unlimited dimensions are both set and the unlimited parameter
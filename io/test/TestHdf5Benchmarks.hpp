@@ -0,0 +1,116 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTHDF5BENCHMARKS_HPP_
+#define TESTHDF5BENCHMARKS_HPP_
+
+#include <cxxtest/TestSuite.h>
+
+#include "BenchmarkRecorder.hpp"
+#include "DistributedVector.hpp"
+#include "DistributedVectorFactory.hpp"
+#include "Hdf5DataReader.hpp"
+#include "Hdf5DataWriter.hpp"
+#include "PetscTools.hpp"
+#include "PetscSetupAndFinalize.hpp"
+
+/**
+ * Benchmarks of HDF5 output and post-processing reads at several problem sizes.
+ * Results are written to Benchmarks/Hdf5Benchmarks.json.
+ */
+class TestHdf5Benchmarks : public CxxTest::TestSuite
+{
+public:
+
+    void TestWriteAndRead()
+    {
+        BenchmarkRecorder recorder("Hdf5Benchmarks");
+        const unsigned num_steps = 100u;
+
+        const unsigned sizes[3] = {1000u, 10000u, 100000u};
+        for (unsigned i=0; i<3; i++)
+        {
+            DistributedVectorFactory factory(sizes[i]);
+            Vec data = factory.CreateVec();
+            DistributedVector distributed_data = factory.CreateDistributedVector(data);
+            for (DistributedVector::Iterator index = distributed_data.Begin(); index != distributed_data.End(); ++index)
+            {
+                distributed_data[index] = index.Global;
+            }
+            distributed_data.Restore();
+
+            recorder.Begin("write_100_steps", sizes[i]);
+            {
+                Hdf5DataWriter writer(factory, "TestHdf5Benchmarks", "benchmark", false);
+                writer.DefineFixedDimension(sizes[i]);
+                int v_id = writer.DefineVariable("V", "mV");
+                writer.DefineUnlimitedDimension("Time", "msec");
+                writer.EndDefineMode();
+                for (unsigned step=0; step<num_steps; step++)
+                {
+                    writer.PutVector(v_id, data);
+                    writer.PutUnlimitedVariable(step);
+                    writer.AdvanceAlongUnlimitedDimension();
+                }
+                writer.Close();
+            }
+            recorder.End();
+
+            Hdf5DataReader reader("TestHdf5Benchmarks", "benchmark");
+            TS_ASSERT_EQUALS(reader.GetUnlimitedDimensionValues().size(), num_steps);
+
+            recorder.Begin("read_all_nodes_100_steps", sizes[i]);
+            for (unsigned step=0; step<num_steps; step++)
+            {
+                reader.GetVariableOverNodes(data, "V", step);
+            }
+            recorder.End();
+
+            recorder.Begin("read_time_series_100_nodes", sizes[i]);
+            for (unsigned node=0; node<sizes[i]; node+=sizes[i]/100)
+            {
+                reader.GetVariableOverTime("V", node);
+            }
+            recorder.End();
+
+            PetscTools::Destroy(data);
+        }
+
+        TS_ASSERT_EQUALS(recorder.GetNumberOfResults(), 9u);
+        recorder.WriteResults();
+    }
+};
+
+#endif /*TESTHDF5BENCHMARKS_HPP_*/
@@ -38,6 +38,8 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <cxxtest/TestSuite.h>
 
+#include <algorithm>
+
 #include "Hdf5DataWriter.hpp"
 #include "Hdf5DataReader.hpp"
 #include "PetscSetupAndFinalize.hpp"
@@ -430,6 +432,109 @@ public:
         reader.Close();
     }
 
+    void TestBlockIteration()
+    {
+        DistributedVectorFactory factory(NUMBER_NODES);
+        {
+            Hdf5DataWriter writer(factory, "hdf5_reader", "hdf5_test_blocks", false);
+            writer.DefineFixedDimension(NUMBER_NODES);
+            int ik_id = writer.DefineVariable("I_K", "milliamperes");
+            int ina_id = writer.DefineVariable("I_Na", "milliamperes");
+            writer.DefineUnlimitedDimension("Time", "msec");
+            writer.SetFixedChunkSize(3, 30, 2);
+            writer.EndDefineMode();
+
+            Vec petsc_data_1 = factory.CreateVec();
+            DistributedVector distributed_vector_1 = factory.CreateDistributedVector(petsc_data_1);
+            Vec petsc_data_2 = factory.CreateVec();
+            DistributedVector distributed_vector_2 = factory.CreateDistributedVector(petsc_data_2);
+
+            for (unsigned time_step=0; time_step<10; time_step++)
+            {
+                for (DistributedVector::Iterator index = distributed_vector_1.Begin();
+                     index!= distributed_vector_1.End();
+                     ++index)
+                {
+                    distributed_vector_1[index] =  time_step*1000 + 100 + index.Global;
+                    distributed_vector_2[index] =  time_step*1000 + 200 + index.Global;
+                }
+                distributed_vector_1.Restore();
+                distributed_vector_2.Restore();
+
+                writer.PutVector(ik_id, petsc_data_1);
+                writer.PutVector(ina_id, petsc_data_2);
+                writer.PutUnlimitedVariable(time_step);
+                if (time_step < 9)
+                {
+                    writer.AdvanceAlongUnlimitedDimension();
+                }
+            }
+            PetscTools::Destroy(petsc_data_1);
+            PetscTools::Destroy(petsc_data_2);
+            writer.Close();
+        }
+
+        Hdf5DataReader reader("hdf5_reader", "hdf5_test_blocks");
+        TS_ASSERT_EQUALS(reader.GetNumberOfTimestepsPerChunk(), 3u);
+        TS_ASSERT_EQUALS(reader.GetNumberOfNodesPerChunk(), 30u);
+
+        // An arbitrary block
+        Hdf5DataBlock block;
+        reader.GetBlock(2, 5, 17, 41, block);
+        TS_ASSERT_EQUALS(block.mNumVariables, 2u);
+        TS_ASSERT_EQUALS(block.mData.size(), 5u*24u*2u);
+        TS_ASSERT_EQUALS(block.GetValue(4, 20, 0), 4*1000 + 100 + 20);
+        TS_ASSERT_EQUALS(block.GetValue(6, 40, 1), 6*1000 + 200 + 40);
+
+        TS_ASSERT_THROWS_THIS(reader.GetBlock(8, 3, 0, 10, block),
+                              "The dataset 'Data' does not contain data for timestep number 10");
+        TS_ASSERT_THROWS_THIS(reader.GetBlock(0, 1, 90, NUMBER_NODES+1, block),
+                              "The dataset 'Data' doesn't contain info for nodes 90 to 100");
+        TS_ASSERT_THROWS_THIS(reader.BeginBlockIteration(0, NUMBER_NODES+1),
+                              "The dataset 'Data' doesn't contain info for nodes 0 to 100");
+
+        // Iterate over a node range which doesn't line up with the chunks: blocks come
+        // out in on-disk order (all node chunks for each chunk of time steps)
+        unsigned expected_lower_nodes[4] = {5, 30, 60, 90};
+        unsigned expected_upper_nodes[4] = {30, 60, 90, 95};
+        unsigned num_blocks = 0;
+        std::vector<unsigned> num_visits(10*(95-5), 0u);
+        reader.BeginBlockIteration(5, 95);
+        while (reader.GetNextBlock(block))
+        {
+            TS_ASSERT_EQUALS(block.mFirstTimestep, 3*(num_blocks/4));
+            TS_ASSERT_EQUALS(block.mNumTimesteps, (num_blocks/4 == 3) ? 1u : 3u);
+            TS_ASSERT_EQUALS(block.mLowerNode, expected_lower_nodes[num_blocks%4]);
+            TS_ASSERT_EQUALS(block.mUpperNode, expected_upper_nodes[num_blocks%4]);
+
+            for (unsigned t=block.mFirstTimestep; t<block.mFirstTimestep+block.mNumTimesteps; t++)
+            {
+                for (unsigned n=block.mLowerNode; n<block.mUpperNode; n++)
+                {
+                    TS_ASSERT_EQUALS(block.GetValue(t, n, 0), t*1000 + 100 + n);
+                    TS_ASSERT_EQUALS(block.GetValue(t, n, 1), t*1000 + 200 + n);
+                    num_visits[t*(95-5) + n-5]++;
+                }
+            }
+            num_blocks++;
+        }
+        TS_ASSERT_EQUALS(num_blocks, 16u);
+        TS_ASSERT_EQUALS((unsigned)std::count(num_visits.begin(), num_visits.end(), 1u), (unsigned)num_visits.size());
+
+        // Iteration has finished, and can be restarted over the default (whole) range
+        TS_ASSERT(!reader.GetNextBlock(block));
+        num_blocks = 0;
+        reader.BeginBlockIteration();
+        while (reader.GetNextBlock(block))
+        {
+            num_blocks++;
+        }
+        TS_ASSERT_EQUALS(num_blocks, 16u);
+        TS_ASSERT_EQUALS(block.mUpperNode, NUMBER_NODES);
+
+        reader.Close();
+    }
+
     void TestNonMultiStepExceptions()
     {
         DistributedVectorFactory factory(NUMBER_NODES);
@@ -482,6 +482,136 @@ public:
                                                 "io/test/data", filename + "_extended", false));
     }
 
+    void TestHdf5DataWriterAsynchronousWrites()
+    {
+        int number_nodes = 100;
+        DistributedVectorFactory factory(number_nodes);
+        std::string folder("TestHdf5DataWriter");
+
+        {
+            Hdf5DataWriter writer(factory, folder, "hdf5_test_async_uncached", false);
+            TS_ASSERT_THROWS_THIS(writer.SetUseAsynchronousWrites(),
+                                  "Asynchronous writes require the writer to cache writes.");
+        }
+
+        for (unsigned file=0; file<2; file++)
+        {
+            std::string filename = (file == 0) ? "hdf5_test_async_reference" : "hdf5_test_async";
+            bool async = (file == 1);
+            Hdf5DataWriter writer(factory, folder, filename, false, false, "Data", async);
+            writer.DefineFixedDimension(number_nodes);
+            int node_id = writer.DefineVariable("Node", "dimensionless");
+            writer.DefineUnlimitedDimension("Time", "msec", 10);
+            writer.SetFixedChunkSize(3, number_nodes, 1); // so that the cache is written part-way through
+            if (async)
+            {
+                writer.SetUseAsynchronousWrites();
+                // Falls back to synchronous writes (with a warning) if MPI or HDF5 lacks thread support
+                int thread_support;
+                MPI_Query_thread(&thread_support);
+                TS_ASSERT_EQUALS(writer.GetUsingAsynchronousWrites(),
+                                 thread_support >= MPI_THREAD_MULTIPLE && Hdf5DataWriter::IsHdf5LibraryThreadSafe());
+                Warnings::QuietDestroy();
+            }
+            writer.EndDefineMode();
+
+            Vec petsc_data = factory.CreateVec();
+            for (unsigned time_step=0; time_step<10; time_step++)
+            {
+                DistributedVector distributed_vector = factory.CreateDistributedVector(petsc_data);
+                for (DistributedVector::Iterator index = distributed_vector.Begin();
+                     index!= distributed_vector.End();
+                     ++index)
+                {
+                    distributed_vector[index] = index.Global + 1000.0*time_step;
+                }
+                distributed_vector.Restore();
+                writer.PutVector(node_id, petsc_data);
+                writer.PutUnlimitedVariable(time_step);
+                writer.AdvanceAlongUnlimitedDimension();
+            }
+            writer.Close();
+            PetscTools::Destroy(petsc_data);
+        }
+
+        TS_ASSERT(CompareFilesViaHdf5DataReader(folder, "hdf5_test_async", true,
+                                                folder, "hdf5_test_async_reference", true));
+    }
+
+    void TestHdf5DataWriterCompressedStorage()
+    {
+        int number_nodes = 100;
+        DistributedVectorFactory factory(number_nodes);
+        std::string folder("TestHdf5DataWriter");
+
+        const double error_bound = 0.1;
+        for (unsigned file=0; file<2; file++)
+        {
+            std::string filename = (file == 0) ? "hdf5_test_single_precision" : "hdf5_test_lossy_compressed";
+            Hdf5DataWriter writer(factory, folder, filename, false);
+            writer.DefineFixedDimension(number_nodes);
+            int voltage_id = writer.DefineVariable("V", "mV");
+            writer.DefineUnlimitedDimension("Time", "msec", 3);
+            if (file == 0)
+            {
+                writer.SetUseSinglePrecisionStorage();
+            }
+            else
+            {
+                writer.SetCompression(6);
+                TS_ASSERT_THROWS_THIS(writer.SetCompression(10),
+                                      "The deflate compression level must be between 0 and 9.");
+                TS_ASSERT_THROWS_THIS(writer.SetLossyCompressionErrorBound(0.0),
+                                      "The error bound for lossy compression must be positive.");
+                writer.SetLossyCompressionErrorBound(error_bound);
+            }
+            writer.EndDefineMode();
+            TS_ASSERT_THROWS_THIS(writer.SetUseSinglePrecisionStorage(),
+                                  "Cannot set the storage precision when not in define mode.");
+            TS_ASSERT_THROWS_THIS(writer.SetCompression(1),
+                                  "Cannot set compression when not in define mode.");
+
+            Vec petsc_data = factory.CreateVec();
+            for (unsigned time_step=0; time_step<3; time_step++)
+            {
+                DistributedVector distributed_vector = factory.CreateDistributedVector(petsc_data);
+                for (DistributedVector::Iterator index = distributed_vector.Begin();
+                     index!= distributed_vector.End();
+                     ++index)
+                {
+                    distributed_vector[index] = -84.123456789 + 1.23456789*index.Global + time_step;
+                }
+                distributed_vector.Restore();
+                writer.PutVector(voltage_id, petsc_data);
+                writer.PutUnlimitedVariable(time_step);
+                writer.AdvanceAlongUnlimitedDimension();
+            }
+            writer.Close();
+
+            // Read back (as doubles) and check the precision
+            Hdf5DataReader reader(folder, filename);
+            for (unsigned time_step=0; time_step<3; time_step++)
+            {
+                reader.GetVariableOverNodes(petsc_data, "V", time_step);
+                DistributedVector distributed_vector = factory.CreateDistributedVector(petsc_data);
+                for (DistributedVector::Iterator index = distributed_vector.Begin();
+                     index!= distributed_vector.End();
+                     ++index)
+                {
+                    double expected = -84.123456789 + 1.23456789*index.Global + time_step;
+                    double tolerance = (file == 0) ? 1e-5 : error_bound;
+                    TS_ASSERT_DELTA(distributed_vector[index], expected, tolerance);
+                    if (file == 0)
+                    {
+                        TS_ASSERT_DELTA(distributed_vector[index], (float) expected, 1e-12);
+                    }
+                }
+            }
+            reader.Close();
+            PetscTools::Destroy(petsc_data);
+        }
+    }
+
     void TestHdf5DataWriterNonEvenRowDistribution()
     {
         int number_nodes = 100;
@@ -661,6 +791,74 @@ public:
         PetscTools::Destroy(petsc_data_1);
     }
 
+    void TestHdf5DataWriterIncompleteCachedManyTimeSteps()
+    {
+        // Probe-style output: a few nodes, many time steps, several cache writes and a sized file
+        int number_nodes = 100;
+        unsigned num_steps = 50;
+
+        DistributedVectorFactory factory(number_nodes);
+
+        Hdf5DataWriter writer(factory,
+                              "TestHdf5DataWriter",
+                              "hdf5_test_incomplete_cached_many_steps",
+                              false,
+                              false,
+                              "Data",
+                              true); // cache
+
+        int node_id = writer.DefineVariable("Node","dimensionless");
+        writer.DefineUnlimitedDimension("Time", "msec", num_steps);
+
+        std::vector<unsigned> node_numbers;
+        node_numbers.push_back(3);
+        node_numbers.push_back(50);
+        node_numbers.push_back(99);
+        writer.DefineFixedDimension(node_numbers, number_nodes);
+        writer.SetFixedChunkSize(8, 3, 1); // So the cache is written every 8 steps
+
+        writer.EndDefineMode();
+
+        Vec petsc_data = factory.CreateVec();
+        DistributedVector distributed_vector = factory.CreateDistributedVector(petsc_data);
+
+        for (unsigned time_step=0; time_step<num_steps; time_step++)
+        {
+            for (DistributedVector::Iterator index = distributed_vector.Begin();
+                 index!= distributed_vector.End();
+                 ++index)
+            {
+                distributed_vector[index] = 1000.0*time_step + index.Global;
+            }
+            distributed_vector.Restore();
+
+            writer.PutVector(node_id, petsc_data);
+            writer.PutUnlimitedVariable(0.01*time_step);
+            writer.AdvanceAlongUnlimitedDimension();
+        }
+
+        writer.Close();
+        PetscTools::Destroy(petsc_data);
+
+        Hdf5DataReader reader("TestHdf5DataWriter", "hdf5_test_incomplete_cached_many_steps");
+        std::vector<double> times = reader.GetUnlimitedDimensionValues();
+        TS_ASSERT_EQUALS(times.size(), num_steps);
+        for (unsigned time_step=0; time_step<times.size(); time_step++)
+        {
+            TS_ASSERT_DELTA(times[time_step], 0.01*time_step, 1e-12);
+        }
+
+        for (unsigned i=0; i<node_numbers.size(); i++)
+        {
+            std::vector<double> values = reader.GetVariableOverTime("Node", node_numbers[i]);
+            TS_ASSERT_EQUALS(values.size(), num_steps);
+            for (unsigned time_step=0; time_step<values.size(); time_step++)
+            {
+                TS_ASSERT_DELTA(values[time_step], 1000.0*time_step + node_numbers[i], 1e-12);
+            }
+        }
+    }
+
     void TestHdf5DataWriterFullFormat()
     {
         int number_nodes = 100;
@@ -2169,6 +2367,65 @@ public:
         H5Dclose(dset);
         H5Fclose(h5_file);
     }
+
+    void TestHdf5DataWriterAutoTunedChunks()
+    {
+        std::string folder("TestHdf5DataWriter");
+        const unsigned number_nodes = 100;
+        DistributedVectorFactory factory(number_nodes);
+
+        // On a striped file system the stripe size replaces the target chunk size set below
+        OutputFileHandler file_handler(folder, false);
+        bool on_striped_file_system = (Hdf5DataWriter::GetFileSystemStripeSize(file_handler.FindFile("")) > 0);
+
+        {
+            Hdf5DataWriter writer(factory, folder, "hdf5_test_auto_tuned_per_time_step", false);
+            writer.DefineUnlimitedDimension("Time", "msec", 50);
+            writer.DefineFixedDimension(number_nodes);
+            writer.DefineVariable("V", "mV");
+            writer.DefineVariable("Phi_e", "mV");
+
+            // 1600 bytes hold 100 nodes with two double variables
+            writer.SetTargetChunkSize(1600);
+            writer.SetAutoTuneChunking();
+            writer.SetUseCollectiveBufferingHints();
+            writer.EndDefineMode();
+
+            TS_ASSERT_THROWS_THIS(writer.SetAutoTuneChunking(),
+                                  "Cannot set chunk auto-tuning when not in define mode.");
+            TS_ASSERT_THROWS_THIS(writer.SetUseCollectiveBufferingHints(false),
+                                  "Cannot set MPI-IO hints when not in define mode.");
+
+            // One time step per chunk, and the nodes split between the processes
+            if (!on_striped_file_system)
+            {
+                TS_ASSERT_EQUALS(writer.mChunkSize[0], 1u);
+                TS_ASSERT_EQUALS(writer.mChunkSize[1], CeilDivide(number_nodes, PetscTools::GetNumProcs()));
+                TS_ASSERT_EQUALS(writer.mChunkSize[2], 2u);
+            }
+            writer.Close();
+        }
+
+        {
+            Hdf5DataWriter writer(factory, folder, "hdf5_test_auto_tuned_time_series", false);
+            writer.DefineUnlimitedDimension("Time", "msec", 50);
+            writer.DefineFixedDimension(number_nodes);
+            writer.DefineVariable("V", "mV");
+            writer.DefineVariable("Phi_e", "mV");
+            writer.SetTargetChunkSize(1600);
+            writer.SetAutoTuneChunking(Hdf5AccessPattern::NodeTimeSeriesReads);
+            writer.EndDefineMode();
+
+            // All 50 time steps per chunk, which leaves room for 2 nodes
+            if (!on_striped_file_system)
+            {
+                TS_ASSERT_EQUALS(writer.mChunkSize[0], 50u);
+                TS_ASSERT_EQUALS(writer.mChunkSize[1], 2u);
+                TS_ASSERT_EQUALS(writer.mChunkSize[2], 2u);
+            }
+            writer.Close();
+        }
+    }
 };
 
 #endif /*TESTHDF5DATAWRITER_HPP_*/
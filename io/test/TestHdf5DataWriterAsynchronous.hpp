@@ -0,0 +1,197 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTHDF5DATAWRITERASYNCHRONOUS_HPP_
+#define TESTHDF5DATAWRITERASYNCHRONOUS_HPP_
+
+#include <cxxtest/TestSuite.h>
+
+#include "CompareHdf5ResultsFiles.hpp"
+#include "DistributedVector.hpp"
+#include "DistributedVectorFactory.hpp"
+#include "Hdf5DataReader.hpp"
+#include "Hdf5DataWriter.hpp"
+#include "PetscTools.hpp"
+#include "Warnings.hpp"
+
+#include "PetscSetupWithMpiThreadsAndFinalize.hpp"
+
+/**
+ * Asynchronous HDF5 output needs MPI_THREAD_MULTIPLE support, so lives in its own
+ * suite with an MPI setup that requests it.  It also needs a thread-safe HDF5 library;
+ * without one the writers fall back to synchronous output, which must give the same files.
+ */
+class TestHdf5DataWriterAsynchronous : public CxxTest::TestSuite
+{
+public:
+
+    void TestAsynchronousWritesMatchSynchronousWrites()
+    {
+        int thread_support;
+        MPI_Query_thread(&thread_support);
+        TS_ASSERT_EQUALS(thread_support, MPI_THREAD_MULTIPLE);
+
+        const unsigned number_nodes = 100;
+        const unsigned num_time_steps = 10;
+        DistributedVectorFactory factory(number_nodes);
+        std::string folder("TestHdf5DataWriterAsynchronous");
+
+        for (unsigned file=0; file<2; file++)
+        {
+            std::string filename = (file == 0) ? "hdf5_test_sync" : "hdf5_test_async";
+            bool async = (file == 1);
+            Hdf5DataWriter writer(factory, folder, filename, (file == 0), false, "Data", true);
+            writer.DefineFixedDimension(number_nodes);
+            int node_id = writer.DefineVariable("Node", "dimensionless");
+            writer.DefineUnlimitedDimension("Time", "msec", num_time_steps);
+            writer.SetFixedChunkSize(3, number_nodes, 1); // so that the cache is written part-way through
+            if (async)
+            {
+                writer.SetUseAsynchronousWrites();
+                Warnings::QuietDestroy();
+            }
+            TS_ASSERT_EQUALS(writer.GetUsingAsynchronousWrites(), async && Hdf5DataWriter::IsHdf5LibraryThreadSafe());
+            writer.EndDefineMode();
+
+            Vec petsc_data = factory.CreateVec();
+            for (unsigned time_step=0; time_step<num_time_steps; time_step++)
+            {
+                DistributedVector distributed_vector = factory.CreateDistributedVector(petsc_data);
+                for (DistributedVector::Iterator index = distributed_vector.Begin();
+                     index!= distributed_vector.End();
+                     ++index)
+                {
+                    distributed_vector[index] = index.Global + 1000.0*time_step;
+                }
+                distributed_vector.Restore();
+                writer.PutVector(node_id, petsc_data);
+                writer.PutUnlimitedVariable(time_step);
+                writer.AdvanceAlongUnlimitedDimension();
+            }
+            writer.Close();
+            PetscTools::Destroy(petsc_data);
+        }
+
+        // Read the asynchronously written file back
+        Hdf5DataReader reader(folder, "hdf5_test_async");
+        std::vector<double> times = reader.GetUnlimitedDimensionValues();
+        TS_ASSERT_EQUALS(times.size(), num_time_steps);
+        for (unsigned node_index=0; node_index<number_nodes; node_index+=9)
+        {
+            std::vector<double> values = reader.GetVariableOverTime("Node", node_index);
+            TS_ASSERT_EQUALS(values.size(), num_time_steps);
+            for (unsigned time_step=0; time_step<num_time_steps; time_step++)
+            {
+                TS_ASSERT_DELTA(times[time_step], time_step, 1e-12);
+                TS_ASSERT_DELTA(values[time_step], node_index + 1000.0*time_step, 1e-12);
+            }
+        }
+        reader.Close();
+
+        TS_ASSERT(CompareFilesViaHdf5DataReader(folder, "hdf5_test_async", true,
+                                                folder, "hdf5_test_sync", true));
+    }
+
+    void TestAsynchronousAndSynchronousWritersOpenTogether()
+    {
+        const unsigned number_nodes = 100;
+        const unsigned num_time_steps = 10;
+        DistributedVectorFactory factory(number_nodes);
+        std::string folder("TestHdf5DataWriterAsynchronousTogether");
+
+        /*
+         * The synchronous writer makes HDF5 calls on the main thread while the
+         * asynchronous one may be writing on its worker thread.
+         */
+        Hdf5DataWriter sync_writer(factory, folder, "hdf5_test_sync", true, false, "Data", true);
+        Hdf5DataWriter async_writer(factory, folder, "hdf5_test_async", false, false, "Data", true);
+        Hdf5DataWriter* writers[2] = {&sync_writer, &async_writer};
+        int node_ids[2];
+        for (unsigned w=0; w<2; w++)
+        {
+            writers[w]->DefineFixedDimension(number_nodes);
+            node_ids[w] = writers[w]->DefineVariable("Node", "dimensionless");
+            writers[w]->DefineUnlimitedDimension("Time", "msec", num_time_steps);
+            writers[w]->SetFixedChunkSize(2, number_nodes, 1);
+        }
+        async_writer.SetUseAsynchronousWrites();
+        Warnings::QuietDestroy();
+        TS_ASSERT_EQUALS(async_writer.GetUsingAsynchronousWrites(), Hdf5DataWriter::IsHdf5LibraryThreadSafe());
+        TS_ASSERT(!sync_writer.GetUsingAsynchronousWrites());
+        sync_writer.EndDefineMode();
+        async_writer.EndDefineMode();
+
+        Vec petsc_data = factory.CreateVec();
+        for (unsigned time_step=0; time_step<num_time_steps; time_step++)
+        {
+            DistributedVector distributed_vector = factory.CreateDistributedVector(petsc_data);
+            for (DistributedVector::Iterator index = distributed_vector.Begin();
+                 index!= distributed_vector.End();
+                 ++index)
+            {
+                distributed_vector[index] = index.Global - 10.0*time_step;
+            }
+            distributed_vector.Restore();
+            // Alternate the order, so each writer's calls fall both before and after the other's
+            for (unsigned i=0; i<2; i++)
+            {
+                unsigned w = (time_step + i) % 2;
+                writers[w]->PutVector(node_ids[w], petsc_data);
+                writers[w]->PutUnlimitedVariable(time_step);
+                writers[w]->AdvanceAlongUnlimitedDimension();
+            }
+        }
+        async_writer.Close();
+        sync_writer.Close();
+        PetscTools::Destroy(petsc_data);
+
+        Hdf5DataReader reader(folder, "hdf5_test_async");
+        for (unsigned node_index=0; node_index<number_nodes; node_index+=11)
+        {
+            std::vector<double> values = reader.GetVariableOverTime("Node", node_index);
+            TS_ASSERT_EQUALS(values.size(), num_time_steps);
+            for (unsigned time_step=0; time_step<values.size(); time_step++)
+            {
+                TS_ASSERT_DELTA(values[time_step], node_index - 10.0*time_step, 1e-12);
+            }
+        }
+        reader.Close();
+
+        TS_ASSERT(CompareFilesViaHdf5DataReader(folder, "hdf5_test_async", true,
+                                                folder, "hdf5_test_sync", true));
+    }
+};
+
+#endif /*TESTHDF5DATAWRITERASYNCHRONOUS_HPP_*/
@@ -192,6 +192,65 @@ public:
         PetscTools::Destroy(var3);
     }
 
+    void TestParallelBinaryColumnWriter()
+    {
+        ParallelColumnDataWriter writer("TestParallelColumnDataWriter", "ParallelBinaryColumnWriter");
+        int time_var_id = writer.DefineUnlimitedDimension("Time", "msecs");
+        writer.DefineFixedDimension("Node", "dimensionless", num_nodes);
+        int var1_id = writer.DefineVariable("Var1", "LightYears");
+        int var2_id = writer.DefineVariable("Var2", "Angstroms");
+        writer.SetBinaryOutput();
+        writer.EndDefineMode();
+
+        Vec var1 = PetscTools::CreateVec(num_nodes);
+        Vec var2 = PetscTools::CreateVec(num_nodes);
+        for (unsigned step=0; step<2; step++)
+        {
+            double* var1_array,* var2_array;
+            VecGetArray(var1, &var1_array);
+            VecGetArray(var2, &var2_array);
+            int lo, hi;
+            VecGetOwnershipRange(var1, &lo, &hi);
+            for (int global_index=lo; global_index<hi; global_index++)
+            {
+                var1_array[global_index-lo] = global_index + step;
+                var2_array[global_index-lo] = -global_index * 1e100 * (step+1);
+            }
+            VecRestoreArray(var1, &var1_array);
+            VecRestoreArray(var2, &var2_array);
+
+            if (step > 0)
+            {
+                writer.AdvanceAlongUnlimitedDimension();
+            }
+            // Every process writes its own part of each vector
+            writer.PutVariable(time_var_id, 0.1*(step+1));
+            writer.PutVector(var1_id, var1);
+            writer.PutVector(var2_id, var2);
+        }
+        writer.Close();
+
+        ColumnDataReader reader("TestParallelColumnDataWriter", "ParallelBinaryColumnWriter");
+        std::vector<double> times = reader.GetUnlimitedDimensionValues();
+        TS_ASSERT_EQUALS(times.size(), 2u);
+        TS_ASSERT_EQUALS(times[1], 0.2);
+        for (int node=0; node<num_nodes; node++)
+        {
+            std::vector<double> var1_values = reader.GetValues("Var1", node);
+            std::vector<double> var2_values = reader.GetValues("Var2", node);
+            TS_ASSERT_EQUALS(var1_values.size(), 2u);
+            for (unsigned step=0; step<2; step++)
+            {
+                // Binary values are exact
+                TS_ASSERT_EQUALS(var1_values[step], node + step);
+                TS_ASSERT_EQUALS(var2_values[step], -node * 1e100 * (step+1));
+            }
+        }
+
+        PetscTools::Destroy(var1);
+        PetscTools::Destroy(var2);
+    }
+
     void TestPutSlice()
     {
         // Create a vector slice
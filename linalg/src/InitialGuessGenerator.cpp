@@ -0,0 +1,255 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#include "InitialGuessGenerator.hpp"
+
+#include <cassert>
+#include <cmath>
+
+#include "Exception.hpp"
+#include "PetscTools.hpp"
+
+InitialGuessGenerator::InitialGuessGenerator(InitialGuessType type, unsigned numPreviousSolutions)
+    : mType(PREVIOUS_SOLUTION),
+      mMaxNumSolutions(1u)
+{
+    SetType(type, numPreviousSolutions);
+}
+
+InitialGuessGenerator::~InitialGuessGenerator()
+{
+    Reset();
+    DestroyWorkVectors();
+}
+
+void InitialGuessGenerator::SetType(InitialGuessType type, unsigned numPreviousSolutions)
+{
+    unsigned max_num_solutions;
+    switch (type)
+    {
+        case PREVIOUS_SOLUTION:
+            max_num_solutions = 1u;
+            break;
+        case LINEAR_EXTRAPOLATION:
+            max_num_solutions = 2u;
+            break;
+        case QUADRATIC_EXTRAPOLATION:
+            max_num_solutions = 3u;
+            break;
+        case PROJECTION:
+            if (numPreviousSolutions == 0u)
+            {
+                EXCEPTION("The projection initial guess needs at least one previous solution");
+            }
+            max_num_solutions = numPreviousSolutions;
+            break;
+        default:
+            NEVER_REACHED;
+    }
+
+    if (type != mType || max_num_solutions != mMaxNumSolutions)
+    {
+        Reset();
+        DestroyWorkVectors();
+        mType = type;
+        mMaxNumSolutions = max_num_solutions;
+    }
+}
+
+InitialGuessType InitialGuessGenerator::GetType() const
+{
+    return mType;
+}
+
+unsigned InitialGuessGenerator::GetNumStoredSolutions() const
+{
+    return mSolutions.size();
+}
+
+double InitialGuessGenerator::GetLastTime() const
+{
+    if (mTimes.empty())
+    {
+        EXCEPTION("No solutions have been stored");
+    }
+    return mTimes.back();
+}
+
+void InitialGuessGenerator::AddSolution(Vec solution, double time)
+{
+    Vec copy;
+    if (mSolutions.size() == mMaxNumSolutions)
+    {
+        // Recycle the oldest vector
+        copy = mSolutions.front();
+        mSolutions.pop_front();
+        mTimes.pop_front();
+    }
+    else
+    {
+        VecDuplicate(solution, &copy);
+    }
+    VecCopy(solution, copy);
+    mSolutions.push_back(copy);
+    mTimes.push_back(time);
+}
+
+bool InitialGuessGenerator::ComputeGuess(Vec guess, double time, Mat lhsMatrix, Vec rhsVector)
+{
+    if (mSolutions.empty())
+    {
+        return false;
+    }
+
+    if (mType == PROJECTION)
+    {
+        assert(lhsMatrix != nullptr && rhsVector != nullptr);
+        if (Project(guess, lhsMatrix, rhsVector))
+        {
+            return true;
+        }
+        // Fall back to the previous solution
+        VecCopy(mSolutions.back(), guess);
+    }
+    else
+    {
+        Extrapolate(guess, time, mSolutions.size());
+    }
+    return true;
+}
+
+void InitialGuessGenerator::Reset()
+{
+    for (unsigned i=0; i<mSolutions.size(); i++)
+    {
+        PetscTools::Destroy(mSolutions[i]);
+    }
+    mSolutions.clear();
+    mTimes.clear();
+}
+
+void InitialGuessGenerator::DestroyWorkVectors()
+{
+    for (unsigned i=0; i<mImages.size(); i++)
+    {
+        PetscTools::Destroy(mImages[i]);
+        PetscTools::Destroy(mBasis[i]);
+    }
+    mImages.clear();
+    mBasis.clear();
+}
+
+void InitialGuessGenerator::Extrapolate(Vec guess, double time, unsigned numPoints)
+{
+    assert(numPoints > 0u && numPoints <= mSolutions.size());
+    const unsigned first = mSolutions.size() - numPoints;
+
+    VecSet(guess, 0.0);
+    for (unsigned j=first; j<mSolutions.size(); j++)
+    {
+        // Lagrange basis polynomial through the stored times, evaluated at the new time
+        double weight = 1.0;
+        for (unsigned l=first; l<mSolutions.size(); l++)
+        {
+            if (l != j)
+            {
+                weight *= (time - mTimes[l])/(mTimes[j] - mTimes[l]);
+            }
+        }
+        VecAXPY(guess, weight, mSolutions[j]);
+    }
+}
+
+bool InitialGuessGenerator::Project(Vec guess, Mat lhsMatrix, Vec rhsVector)
+{
+    while (mImages.size() < mSolutions.size())
+    {
+        Vec image, basis;
+        VecDuplicate(mSolutions.back(), &image);
+        VecDuplicate(mSolutions.back(), &basis);
+        mImages.push_back(image);
+        mBasis.push_back(basis);
+    }
+
+    // Modified Gram-Schmidt on the images A*x_i, applying the same operations to the x_i
+    unsigned num_independent = 0u;
+    for (unsigned i=0; i<mSolutions.size(); i++)
+    {
+        Vec image = mImages[num_independent];
+        Vec basis = mBasis[num_independent];
+        VecCopy(mSolutions[i], basis);
+        MatMult(lhsMatrix, basis, image);
+
+        PetscReal original_norm;
+        VecNorm(image, NORM_2, &original_norm);
+        if (original_norm == 0.0)
+        {
+            continue;
+        }
+
+        for (unsigned j=0; j<num_independent; j++)
+        {
+            PetscScalar projection;
+            VecDot(image, mImages[j], &projection);
+            VecAXPY(image, -projection, mImages[j]);
+            VecAXPY(basis, -projection, mBasis[j]);
+        }
+
+        PetscReal norm;
+        VecNorm(image, NORM_2, &norm);
+        // Discard solutions which are (numerically) in the span of the previous ones
+        if (norm > 1e-10*original_norm)
+        {
+            VecScale(image, 1.0/norm);
+            VecScale(basis, 1.0/norm);
+            num_independent++;
+        }
+    }
+
+    if (num_independent == 0u)
+    {
+        return false;
+    }
+
+    VecSet(guess, 0.0);
+    for (unsigned j=0; j<num_independent; j++)
+    {
+        PetscScalar coefficient;
+        VecDot(rhsVector, mImages[j], &coefficient);
+        VecAXPY(guess, coefficient, mBasis[j]);
+    }
+    return true;
+}
@@ -0,0 +1,175 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef INITIALGUESSGENERATOR_HPP_
+#define INITIALGUESSGENERATOR_HPP_
+
+#include <deque>
+#include <vector>
+#include <petscvec.h>
+#include <petscmat.h>
+
+/**
+ * How to form the initial guess for each linear solve of a time-stepping scheme.
+ *
+ * PREVIOUS_SOLUTION: use the solution at the previous time step.
+ * LINEAR_EXTRAPOLATION: extrapolate linearly in time from the last two solutions.
+ * QUADRATIC_EXTRAPOLATION: extrapolate quadratically in time from the last three solutions.
+ * PROJECTION: minimise the residual of the new system over the span of the last k solutions.
+ */
+typedef enum InitialGuessType_
+{
+    PREVIOUS_SOLUTION = 0,
+    LINEAR_EXTRAPOLATION,
+    QUADRATIC_EXTRAPOLATION,
+    PROJECTION
+} InitialGuessType;
+
+/**
+ * Keeps (copies of) the solutions of the most recent linear solves in a sequence, together
+ * with the times they correspond to, and uses them to generate an initial guess for the
+ * next solve.
+ *
+ * The extrapolation methods use Lagrange interpolation through the stored (time, solution)
+ * pairs, so they cope with variable time steps. The projection method takes the linear
+ * combination of the stored solutions which minimises the 2-norm of the residual of the
+ * new system: the images A x_i are orthonormalised with modified Gram-Schmidt and the same
+ * operations applied to the x_i, costing k matrix-vector products per guess.
+ *
+ * Until enough solutions are stored the generator falls back to a lower order guess.
+ */
+class InitialGuessGenerator
+{
+private:
+
+    /** How the guess is formed. */
+    InitialGuessType mType;
+
+    /** The maximum number of previous solutions kept. */
+    unsigned mMaxNumSolutions;
+
+    /** Stored solutions, most recent last. */
+    std::deque<Vec> mSolutions;
+
+    /** The times corresponding to #mSolutions. */
+    std::deque<double> mTimes;
+
+    /** Work vectors for the projection method (orthonormalised images of the stored solutions). */
+    std::vector<Vec> mImages;
+
+    /** Work vectors for the projection method (combinations of stored solutions matching #mImages). */
+    std::vector<Vec> mBasis;
+
+    /** Destroy the work vectors used by the projection method. */
+    void DestroyWorkVectors();
+
+    /**
+     * Extrapolate in time through the most recent stored solutions.
+     *
+     * @param guess  vector to fill in
+     * @param time  the time at which the guess is wanted
+     * @param numPoints  the number of stored solutions to use (at most the number stored)
+     */
+    void Extrapolate(Vec guess, double time, unsigned numPoints);
+
+    /**
+     * Minimise the residual of lhsMatrix*guess = rhsVector over the span of the stored solutions.
+     *
+     * @param guess  vector to fill in
+     * @param lhsMatrix  the matrix of the system to be solved
+     * @param rhsVector  the right-hand side of the system to be solved
+     * @return whether a guess was found (false if the stored solutions span nothing useful)
+     */
+    bool Project(Vec guess, Mat lhsMatrix, Vec rhsVector);
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param type  how the guess is formed
+     * @param numPreviousSolutions  the number of previous solutions kept by the PROJECTION
+     *     method (ignored by the others, which keep as many as they need)
+     */
+    InitialGuessGenerator(InitialGuessType type=PREVIOUS_SOLUTION, unsigned numPreviousSolutions=4u);
+
+    /**
+     * Destructor: frees the stored solutions and work vectors.
+     */
+    ~InitialGuessGenerator();
+
+    /**
+     * Change how the guess is formed. Any stored solutions are discarded if this changes the
+     * type or the number of solutions kept.
+     *
+     * @param type  how the guess is formed
+     * @param numPreviousSolutions  the number of previous solutions kept by the PROJECTION method
+     */
+    void SetType(InitialGuessType type, unsigned numPreviousSolutions=4u);
+
+    /** @return how the guess is formed */
+    InitialGuessType GetType() const;
+
+    /** @return the number of solutions currently stored */
+    unsigned GetNumStoredSolutions() const;
+
+    /** @return the time of the most recently stored solution (throws if none is stored) */
+    double GetLastTime() const;
+
+    /**
+     * Store a copy of a solution, discarding the oldest stored solution if necessary.
+     *
+     * @param solution  the solution
+     * @param time  the time it corresponds to
+     */
+    void AddSolution(Vec solution, double time);
+
+    /**
+     * Fill in an initial guess for the next solve. If no solution is stored the guess is left untouched.
+     *
+     * @param guess  vector (with the same layout as the stored solutions) to fill in
+     * @param time  the time at which the guess is wanted
+     * @param lhsMatrix  the matrix of the system to be solved (only used by PROJECTION)
+     * @param rhsVector  the right-hand side of the system to be solved (only used by PROJECTION)
+     * @return whether guess was filled in
+     */
+    bool ComputeGuess(Vec guess, double time, Mat lhsMatrix=nullptr, Vec rhsVector=nullptr);
+
+    /** Discard all stored solutions. */
+    void Reset();
+};
+
+#endif // INITIALGUESSGENERATOR_HPP_
@@ -37,6 +37,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <iostream>
 #include <cassert>
+#include <cmath>
 #include <algorithm>
 #include <boost/scoped_array.hpp>
 
@@ -52,7 +53,8 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 ///////////////////////////////////////////////////////////////////////////////////
 
 LinearSystem::LinearSystem(PetscInt lhsVectorSize, unsigned rowPreallocation)
-   :mPrecondMatrix(nullptr),
+   :AbstractMemoryAccountable(MemoryAccounting::LINEAR_SYSTEM),
+    mPrecondMatrix(nullptr),
     mSize(lhsVectorSize),
     mMatNullSpace(nullptr),
     mDestroyMatAndVec(true),
@@ -63,17 +65,26 @@ LinearSystem::LinearSystem(PetscInt lhsVectorSize, unsigned rowPreallocation)
     mUseAbsoluteTolerance(false),
     mDirichletBoundaryConditionsVector(nullptr),
     mpBlockDiagonalPC(nullptr),
+    mpThreeFieldBlockDiagonalPC(nullptr),
     mpLDUFactorisationPC(nullptr),
     mpTwoLevelsBlockDiagonalPC(nullptr),
+    mpTissueBathMultilevelPC(nullptr),
     mpBathNodes( boost::shared_ptr<std::vector<PetscInt> >() ),
     mPrecondMatrixIsNotLhs(false),
     mRowPreallocation(rowPreallocation),
     mUseFixedNumberIterations(false),
     mEvaluateNumItsEveryNSolves(UINT_MAX),
+    mFixedNumberIterations(0u),
     mpConvergenceTestContext(nullptr),
     mEigMin(DBL_MAX),
     mEigMax(DBL_MIN),
-    mForceSpectrumReevaluation(false)
+    mForceSpectrumReevaluation(false),
+    mPreconditionerReuseTolerance(-1.0),
+    mPreconditionerMatrixNorm(0.0),
+    mCheckPreconditionerReuse(false),
+    mKspSetupTime(0.0),
+    mKspSolveTime(0.0),
+    mNumPreconditionerSetups(0u)
 {
     assert(lhsVectorSize > 0);
     if (mRowPreallocation == UINT_MAX)
@@ -107,7 +118,8 @@ LinearSystem::LinearSystem(PetscInt lhsVectorSize, unsigned rowPreallocation)
 }
 
 LinearSystem::LinearSystem(PetscInt lhsVectorSize, Mat lhsMatrix, Vec rhsVector)
-   :mPrecondMatrix(nullptr),
+   :AbstractMemoryAccountable(MemoryAccounting::LINEAR_SYSTEM),
+    mPrecondMatrix(nullptr),
     mSize(lhsVectorSize),
     mMatNullSpace(nullptr),
     mDestroyMatAndVec(true),
@@ -118,16 +130,25 @@ LinearSystem::LinearSystem(PetscInt lhsVectorSize, Mat lhsMatrix, Vec rhsVector)
     mUseAbsoluteTolerance(false),
     mDirichletBoundaryConditionsVector(nullptr),
     mpBlockDiagonalPC(nullptr),
+    mpThreeFieldBlockDiagonalPC(nullptr),
     mpLDUFactorisationPC(nullptr),
     mpTwoLevelsBlockDiagonalPC(nullptr),
+    mpTissueBathMultilevelPC(nullptr),
     mpBathNodes( boost::shared_ptr<std::vector<PetscInt> >() ),
     mPrecondMatrixIsNotLhs(false),
     mUseFixedNumberIterations(false),
     mEvaluateNumItsEveryNSolves(UINT_MAX),
+    mFixedNumberIterations(0u),
     mpConvergenceTestContext(nullptr),
     mEigMin(DBL_MAX),
     mEigMax(DBL_MIN),
-    mForceSpectrumReevaluation(false)
+    mForceSpectrumReevaluation(false),
+    mPreconditionerReuseTolerance(-1.0),
+    mPreconditionerMatrixNorm(0.0),
+    mCheckPreconditionerReuse(false),
+    mKspSetupTime(0.0),
+    mKspSolveTime(0.0),
+    mNumPreconditionerSetups(0u)
 {
     assert(lhsVectorSize > 0);
     // Conveniently, PETSc Mats and Vecs are actually pointers
@@ -143,8 +164,9 @@ LinearSystem::LinearSystem(PetscInt lhsVectorSize, Mat lhsMatrix, Vec rhsVector)
 #endif
 }
 
-LinearSystem::LinearSystem(Vec templateVector, unsigned rowPreallocation, bool newAllocationError)
-   :mPrecondMatrix(nullptr),
+LinearSystem::LinearSystem(Vec templateVector, unsigned rowPreallocation, bool newAllocationError, unsigned blockSize)
+   :AbstractMemoryAccountable(MemoryAccounting::LINEAR_SYSTEM),
+    mPrecondMatrix(nullptr),
     mMatNullSpace(nullptr),
     mDestroyMatAndVec(true),
     mKspIsSetup(false),
@@ -153,24 +175,33 @@ LinearSystem::LinearSystem(Vec templateVector, unsigned rowPreallocation, bool n
     mUseAbsoluteTolerance(false),
     mDirichletBoundaryConditionsVector(nullptr),
     mpBlockDiagonalPC(nullptr),
+    mpThreeFieldBlockDiagonalPC(nullptr),
     mpLDUFactorisationPC(nullptr),
     mpTwoLevelsBlockDiagonalPC(nullptr),
+    mpTissueBathMultilevelPC(nullptr),
     mpBathNodes( boost::shared_ptr<std::vector<PetscInt> >() ),
     mPrecondMatrixIsNotLhs(false),
     mRowPreallocation(rowPreallocation),
     mUseFixedNumberIterations(false),
     mEvaluateNumItsEveryNSolves(UINT_MAX),
+    mFixedNumberIterations(0u),
     mpConvergenceTestContext(nullptr),
     mEigMin(DBL_MAX),
     mEigMax(DBL_MIN),
-    mForceSpectrumReevaluation(false)
+    mForceSpectrumReevaluation(false),
+    mPreconditionerReuseTolerance(-1.0),
+    mPreconditionerMatrixNorm(0.0),
+    mCheckPreconditionerReuse(false),
+    mKspSetupTime(0.0),
+    mKspSolveTime(0.0),
+    mNumPreconditionerSetups(0u)
 {
     VecDuplicate(templateVector, &mRhsVector);
     VecGetSize(mRhsVector, &mSize);
     VecGetOwnershipRange(mRhsVector, &mOwnershipRangeLo, &mOwnershipRangeHi);
     PetscInt local_size = mOwnershipRangeHi - mOwnershipRangeLo;
 
-    PetscTools::SetupMat(mLhsMatrix, mSize, mSize, mRowPreallocation, local_size, local_size, true, newAllocationError);
+    PetscTools::SetupMat(mLhsMatrix, mSize, mSize, mRowPreallocation, local_size, local_size, true, newAllocationError, blockSize);
 
     /// \todo: if we create a linear system object outside a cardiac solver, these are gonna
     /// be the default solver and preconditioner. Not consistent with ChasteDefaults.xml though...
@@ -185,7 +216,8 @@ LinearSystem::LinearSystem(Vec templateVector, unsigned rowPreallocation, bool n
 }
 
 LinearSystem::LinearSystem(Vec residualVector, Mat jacobianMatrix)
-   :mPrecondMatrix(nullptr),
+   :AbstractMemoryAccountable(MemoryAccounting::LINEAR_SYSTEM),
+    mPrecondMatrix(nullptr),
     mMatNullSpace(nullptr),
     mDestroyMatAndVec(false),
     mKspIsSetup(false),
@@ -194,17 +226,26 @@ LinearSystem::LinearSystem(Vec residualVector, Mat jacobianMatrix)
     mUseAbsoluteTolerance(false),
     mDirichletBoundaryConditionsVector(nullptr),
     mpBlockDiagonalPC(nullptr),
+    mpThreeFieldBlockDiagonalPC(nullptr),
     mpLDUFactorisationPC(nullptr),
     mpTwoLevelsBlockDiagonalPC(nullptr),
+    mpTissueBathMultilevelPC(nullptr),
     mpBathNodes( boost::shared_ptr<std::vector<PetscInt> >() ),
     mPrecondMatrixIsNotLhs(false),
     mRowPreallocation(UINT_MAX),
     mUseFixedNumberIterations(false),
     mEvaluateNumItsEveryNSolves(UINT_MAX),
+    mFixedNumberIterations(0u),
     mpConvergenceTestContext(nullptr),
     mEigMin(DBL_MAX),
     mEigMax(DBL_MIN),
-    mForceSpectrumReevaluation(false)
+    mForceSpectrumReevaluation(false),
+    mPreconditionerReuseTolerance(-1.0),
+    mPreconditionerMatrixNorm(0.0),
+    mCheckPreconditionerReuse(false),
+    mKspSetupTime(0.0),
+    mKspSolveTime(0.0),
+    mNumPreconditionerSetups(0u)
 {
     assert(residualVector || jacobianMatrix);
     mRhsVector = residualVector;
@@ -251,8 +292,10 @@ LinearSystem::LinearSystem(Vec residualVector, Mat jacobianMatrix)
 LinearSystem::~LinearSystem()
 {
     delete mpBlockDiagonalPC;
+    delete mpThreeFieldBlockDiagonalPC;
     delete mpLDUFactorisationPC;
     delete mpTwoLevelsBlockDiagonalPC;
+    delete mpTissueBathMultilevelPC;
 
     if (mDestroyMatAndVec)
     {
@@ -307,6 +350,34 @@ LinearSystem::~LinearSystem()
 #endif
 }
 
+double LinearSystem::GetMemoryUsage() const
+{
+    double bytes = 0.0;
+    if (mDestroyMatAndVec)
+    {
+        MatInfo info;
+        MatGetInfo(mLhsMatrix, MAT_LOCAL, &info);
+        bytes += info.nz_allocated*(sizeof(PetscScalar) + sizeof(PetscInt));
+        // The local rhs entries plus (roughly) the matrix row pointers
+        PetscInt local_size;
+        VecGetLocalSize(mRhsVector, &local_size);
+        bytes += local_size*(sizeof(PetscScalar) + sizeof(PetscInt));
+    }
+    if (mPrecondMatrixIsNotLhs)
+    {
+        MatInfo info;
+        MatGetInfo(mPrecondMatrix, MAT_LOCAL, &info);
+        bytes += info.nz_allocated*(sizeof(PetscScalar) + sizeof(PetscInt));
+    }
+    if (mDirichletBoundaryConditionsVector)
+    {
+        PetscInt local_size;
+        VecGetLocalSize(mDirichletBoundaryConditionsVector, &local_size);
+        bytes += local_size*sizeof(PetscScalar);
+    }
+    return bytes;
+}
+
 void LinearSystem::SetMatrixElement(PetscInt row, PetscInt col, double value)
 {
     PetscMatTools::SetElement(mLhsMatrix, row, col, value);
@@ -354,6 +425,11 @@ void LinearSystem::SetRhsVectorElement(PetscInt row, double value)
     PetscVecTools::SetElement(mRhsVector, row, value);
 }
 
+void LinearSystem::SetRhsVectorElements(const std::vector<unsigned>& rRows, const std::vector<double>& rValues)
+{
+    PetscVecTools::SetElements(mRhsVector, rRows, rValues);
+}
+
 void LinearSystem::AddToRhsVectorElement(PetscInt row, double value)
 {
     PetscVecTools::AddToElement(mRhsVector, row, value);
@@ -451,7 +527,7 @@ void LinearSystem::SetNullBasis(Vec nullBasis[], unsigned numberOfBases)
 
 #endif
 
-    PETSCEXCEPT( MatNullSpaceCreate(PETSC_COMM_WORLD, PETSC_FALSE, numberOfBases, nullBasis, &mMatNullSpace) );
+    PETSCEXCEPT( MatNullSpaceCreate(PetscTools::GetWorld(), PETSC_FALSE, numberOfBases, nullBasis, &mMatNullSpace) );
 }
 
 void LinearSystem::RemoveNullSpace()
@@ -460,7 +536,7 @@ void LinearSystem::RemoveNullSpace()
     if (mMatNullSpace)
     {
         PETSCEXCEPT( MatNullSpaceDestroy(PETSC_DESTROY_PARAM(mMatNullSpace)) );
-        PETSCEXCEPT( MatNullSpaceCreate(PETSC_COMM_WORLD, PETSC_FALSE, 0, nullptr, &mMatNullSpace) );
+        PETSCEXCEPT( MatNullSpaceCreate(PetscTools::GetWorld(), PETSC_FALSE, 0, nullptr, &mMatNullSpace) );
 #if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 3) //PETSc 3.3 or later
         // Setting null space in the KSP was deprecated in PETSc 3.6, but setting the null space
         // for the matrix appeared in PETSc 3.3 so 3.3, 3.4, 3.5 can do either
@@ -576,6 +652,11 @@ bool LinearSystem::IsMatrixSymmetric()
     return symmetry_flag_is_set && symmetry_flag;
 }
 
+bool LinearSystem::IsPrecondMatrixDifferentFromLhs() const
+{
+    return mPrecondMatrixIsNotLhs;
+}
+
 void LinearSystem::SetMatrixIsConstant(bool matrixIsConstant)
 {
     mMatrixIsConstant = matrixIsConstant;
@@ -606,7 +687,7 @@ void LinearSystem::SetKspType(const char *kspType)
     mKspType = kspType;
     if (mKspIsSetup)
     {
-        KSPSetType(mKspSolver, kspType);
+        KSPSetType(mKspSolver, GetPetscKspType());
         KSPSetFromOptions(mKspSolver);
     }
 }
@@ -624,23 +705,48 @@ void LinearSystem::SetPcType(const char* pcType, boost::shared_ptr<std::vector<P
             /// \todo: #1082 use a single pointer to abstract class
             delete mpBlockDiagonalPC;
             mpBlockDiagonalPC = nullptr;
+            delete mpThreeFieldBlockDiagonalPC;
+            mpThreeFieldBlockDiagonalPC = nullptr;
             delete mpLDUFactorisationPC;
             mpLDUFactorisationPC = nullptr;
             delete mpTwoLevelsBlockDiagonalPC;
             mpTwoLevelsBlockDiagonalPC = nullptr;
+            delete mpTissueBathMultilevelPC;
+            mpTissueBathMultilevelPC = nullptr;
 
             mpBlockDiagonalPC = new PCBlockDiagonal(mKspSolver);
         }
+        else if (mPcType == "threefieldblockdiagonal")
+        {
+            // If the previous preconditioner was purpose-built we need to free the appropriate pointer.
+            /// \todo: #1082 use a single pointer to abstract class
+            delete mpBlockDiagonalPC;
+            mpBlockDiagonalPC = nullptr;
+            delete mpThreeFieldBlockDiagonalPC;
+            mpThreeFieldBlockDiagonalPC = nullptr;
+            delete mpLDUFactorisationPC;
+            mpLDUFactorisationPC = nullptr;
+            delete mpTwoLevelsBlockDiagonalPC;
+            mpTwoLevelsBlockDiagonalPC = nullptr;
+            delete mpTissueBathMultilevelPC;
+            mpTissueBathMultilevelPC = nullptr;
+
+            mpThreeFieldBlockDiagonalPC = new PCThreeFieldBlockDiagonal(mKspSolver);
+        }
         else if (mPcType == "ldufactorisation")
         {
             // If the previous preconditioner was purpose-built we need to free the appropriate pointer.
             /// \todo: #1082 use a single pointer to abstract class
             delete mpBlockDiagonalPC;
             mpBlockDiagonalPC = nullptr;
+            delete mpThreeFieldBlockDiagonalPC;
+            mpThreeFieldBlockDiagonalPC = nullptr;
             delete mpLDUFactorisationPC;
             mpLDUFactorisationPC = nullptr;
             delete mpTwoLevelsBlockDiagonalPC;
             mpTwoLevelsBlockDiagonalPC = nullptr;
+            delete mpTissueBathMultilevelPC;
+            mpTissueBathMultilevelPC = nullptr;
 
             mpLDUFactorisationPC = new PCLDUFactorisation(mKspSolver);
         }
@@ -650,10 +756,14 @@ void LinearSystem::SetPcType(const char* pcType, boost::shared_ptr<std::vector<P
             /// \todo: #1082 use a single pointer to abstract class
             delete mpBlockDiagonalPC;
             mpBlockDiagonalPC = nullptr;
+            delete mpThreeFieldBlockDiagonalPC;
+            mpThreeFieldBlockDiagonalPC = nullptr;
             delete mpLDUFactorisationPC;
             mpLDUFactorisationPC = nullptr;
             delete mpTwoLevelsBlockDiagonalPC;
             mpTwoLevelsBlockDiagonalPC = nullptr;
+            delete mpTissueBathMultilevelPC;
+            mpTissueBathMultilevelPC = nullptr;
 
             if (!mpBathNodes)
             {
@@ -661,6 +771,27 @@ void LinearSystem::SetPcType(const char* pcType, boost::shared_ptr<std::vector<P
             }
             mpTwoLevelsBlockDiagonalPC = new PCTwoLevelsBlockDiagonal(mKspSolver, *mpBathNodes);
         }
+        else if (mPcType == "tissuebathmultilevel")
+        {
+            // If the previous preconditioner was purpose-built we need to free the appropriate pointer.
+            /// \todo: #1082 use a single pointer to abstract class
+            delete mpBlockDiagonalPC;
+            mpBlockDiagonalPC = nullptr;
+            delete mpThreeFieldBlockDiagonalPC;
+            mpThreeFieldBlockDiagonalPC = nullptr;
+            delete mpLDUFactorisationPC;
+            mpLDUFactorisationPC = nullptr;
+            delete mpTwoLevelsBlockDiagonalPC;
+            mpTwoLevelsBlockDiagonalPC = nullptr;
+            delete mpTissueBathMultilevelPC;
+            mpTissueBathMultilevelPC = nullptr;
+
+            if (!mpBathNodes)
+            {
+                TERMINATE("You must provide a list of bath nodes when using TissueBathMultilevelPC"); // LCOV_EXCL_LINE
+            }
+            mpTissueBathMultilevelPC = new PCTissueBathMultilevel(mKspSolver, *mpBathNodes);
+        }
         else
         {
             PC prec;
@@ -679,12 +810,21 @@ Vec LinearSystem::Solve(Vec lhsGuess)
      *    VecView(mRhsVector,    PETSC_VIEWER_STDOUT_WORLD);
      */
 
-    // Double check that the non-zero pattern hasn't changed
+    // Double check that the non-zero pattern hasn't changed (shell matrices, used for
+    // matrix-free operators, have no non-zero pattern)
     MatInfo mat_info;
-    MatGetInfo(mLhsMatrix, MAT_GLOBAL_SUM, &mat_info);
+    mat_info.nz_used = 0.0;
+    PetscBool lhs_is_shell;
+    PetscObjectTypeCompare((PetscObject)mLhsMatrix, MATSHELL, &lhs_is_shell);
+    if (!lhs_is_shell)
+    {
+        MatGetInfo(mLhsMatrix, MAT_GLOBAL_SUM, &mat_info);
+    }
 
     if (!mKspIsSetup)
     {
+        const double setup_start_time = Timer::GetWallTime();
+
         // Create PETSc Vec that may be required if we use a Chebyshev solver
         Vec chebyshev_lhs_vector = nullptr;
 
@@ -693,7 +833,7 @@ Vec LinearSystem::Solve(Vec lhsGuess)
         //MatNorm(mLhsMatrix, NORM_FROBENIUS, &mMatrixNorm);
         PC prec; //Type of pre-conditioner
 
-        KSPCreate(PETSC_COMM_WORLD, &mKspSolver);
+        KSPCreate(PetscTools::GetWorld(), &mKspSolver);
 
         if (mMatNullSpace) // Adding null-space to the matrix (new style) has to happen *before* KSPSetOperators
         {
@@ -762,18 +902,7 @@ Vec LinearSystem::Solve(Vec lhsGuess)
         }
 
         // Set ksp and pc types
-#if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 3) //PETSc 3.3 or later
-        if (mKspType == "chebychev")
-        {
-            KSPSetType(mKspSolver, "chebyshev");
-        }
-        else
-        {
-            KSPSetType(mKspSolver, mKspType.c_str());
-        }
-#else
-        KSPSetType(mKspSolver, mKspType.c_str());
-#endif
+        KSPSetType(mKspSolver, GetPetscKspType());
         KSPGetPC(mKspSolver, &prec);
 
         // Turn off pre-conditioning if the system size is very small
@@ -795,6 +924,16 @@ Vec LinearSystem::Solve(Vec lhsGuess)
                 {
                     Timer::Print("Purpose-build preconditioner creation");
                 }
+#endif
+            }
+            else if (mPcType == "threefieldblockdiagonal")
+            {
+                mpThreeFieldBlockDiagonalPC = new PCThreeFieldBlockDiagonal(mKspSolver);
+#ifdef TRACE_KSP
+                if (PetscTools::AmMaster())
+                {
+                    Timer::Print("Purpose-build preconditioner creation");
+                }
 #endif
             }
             else if (mPcType == "ldufactorisation")
@@ -821,6 +960,22 @@ Vec LinearSystem::Solve(Vec lhsGuess)
                 }
 #endif
 
+            }
+            else if (mPcType == "tissuebathmultilevel")
+            {
+                if (!mpBathNodes)
+                {
+                    TERMINATE("You must provide a list of bath nodes when using TissueBathMultilevelPC"); // LCOV_EXCL_LINE
+                }
+                // The KSP (and with it the shell preconditioner) may have been reset since the last solve
+                delete mpTissueBathMultilevelPC;
+                mpTissueBathMultilevelPC = new PCTissueBathMultilevel(mKspSolver, *mpBathNodes);
+#ifdef TRACE_KSP
+                if (PetscTools::AmMaster())
+                {
+                    Timer::Print("Purpose-build preconditioner creation");
+                }
+#endif
             }
             else
             {
@@ -838,8 +993,10 @@ Vec LinearSystem::Solve(Vec lhsGuess)
         /*
          * Non-adaptive Chebyshev: the required spectrum approximation is computed just once
          * at the beginning of the simulation. This is done with two extra CG solves.
+         * The same is needed when a prescribed number of iterations means there will
+         * never be a residual-based solve from which to estimate it.
          */
-        if (mKspType == "chebychev" && !mUseFixedNumberIterations)
+        if (mKspType == "chebychev" && (!mUseFixedNumberIterations || mFixedNumberIterations > 0u))
         {
 #ifdef TRACE_KSP
             Timer::Reset();
@@ -930,6 +1087,11 @@ Vec LinearSystem::Solve(Vec lhsGuess)
 #endif
         }
 
+        if (mUseFixedNumberIterations && mFixedNumberIterations > 0u)
+        {
+            SkipConvergenceTest(mFixedNumberIterations);
+        }
+
 #ifdef TRACE_KSP
         Timer::Reset();
 #endif
@@ -949,6 +1111,12 @@ Vec LinearSystem::Solve(Vec lhsGuess)
 #endif
 
         mKspIsSetup = true;
+        if (mPreconditionerReuseTolerance >= 0.0)
+        {
+            MatNorm(mLhsMatrix, NORM_FROBENIUS, &mPreconditionerMatrixNorm);
+        }
+        mNumPreconditionerSetups++;
+        mKspSetupTime += Timer::GetWallTime() - setup_start_time;
 
         HeartEventHandler::EndEvent(HeartEventHandler::COMMUNICATION);
     }
@@ -959,6 +1127,11 @@ Vec LinearSystem::Solve(Vec lhsGuess)
             WARNING("LinearSystem doesn't like the non-zero pattern of a matrix to change. (I think you changed it).");
             mNonZerosUsed = mat_info.nz_used;
         }
+
+        if (mPreconditionerReuseTolerance >= 0.0 && (mCheckPreconditionerReuse || !mMatrixIsConstant))
+        {
+            UpdatePreconditionerIfMatrixChanged();
+        }
 //        PetscScalar norm;
 //        MatNorm(mLhsMatrix, NORM_FROBENIUS, &norm);
 //        if (fabs(norm - mMatrixNorm) > 0)
@@ -1022,12 +1195,12 @@ Vec LinearSystem::Solve(Vec lhsGuess)
 //    PetscTools::Destroy(temp);
 //    // Dump the matrix to file
 //    PetscViewer viewer;
-//    PetscViewerASCIIOpen(PETSC_COMM_WORLD,"mat.output",&viewer);
+//    PetscViewerASCIIOpen(PetscTools::GetWorld(),"mat.output",&viewer);
 //    MatView(mLhsMatrix, viewer);
 //    PetscViewerFlush(viewer);
 //    PetscViewerDestroy(PETSC_DESTROY_PARAM(viewer);
 //    // Dump the rhs vector to file
-//    PetscViewerASCIIOpen(PETSC_COMM_WORLD,"vec.output",&viewer);
+//    PetscViewerASCIIOpen(PetscTools::GetWorld(),"vec.output",&viewer);
 //    PetscViewerSetFormat(viewer, PETSC_VIEWER_ASCII_MATLAB);
 //    VecView(mRhsVector, viewer);
 //    PetscViewerFlush(viewer);
@@ -1042,7 +1215,9 @@ Vec LinearSystem::Solve(Vec lhsGuess)
 #endif
 
         // Current solve has to be done with tolerance-based stop criteria in order to record iterations taken
-        if (mUseFixedNumberIterations && (mNumSolves%mEvaluateNumItsEveryNSolves==0 || mForceSpectrumReevaluation))
+        const bool evaluate_num_its = mUseFixedNumberIterations && mFixedNumberIterations == 0u
+                                      && (mNumSolves%mEvaluateNumItsEveryNSolves==0 || mForceSpectrumReevaluation);
+        if (evaluate_num_its)
         {
 #if ((PETSC_VERSION_MAJOR == 2 && PETSC_VERSION_MINOR == 2) || (PETSC_VERSION_MAJOR == 2 && PETSC_VERSION_MINOR == 3 && PETSC_VERSION_SUBMINOR <= 2))
             KSPSetNormType(mKspSolver, KSP_PRECONDITIONED_NORM);
@@ -1096,7 +1271,9 @@ Vec LinearSystem::Solve(Vec lhsGuess)
             KSPSetUp(mKspSolver);
         }
 
+        const double solve_start_time = Timer::GetWallTime();
         PETSCEXCEPT(KSPSolve(mKspSolver, mRhsVector, lhs_vector));
+        mKspSolveTime += Timer::GetWallTime() - solve_start_time;
         HeartEventHandler::EndEvent(HeartEventHandler::SOLVE_LINEAR_SYSTEM);
 
 #ifdef TRACE_KSP
@@ -1128,7 +1305,7 @@ Vec LinearSystem::Solve(Vec lhsGuess)
             KSPEXCEPT(reason);
         }
 
-        if (mUseFixedNumberIterations && (mNumSolves%mEvaluateNumItsEveryNSolves==0 || mForceSpectrumReevaluation))
+        if (evaluate_num_its)
         {
             // Adaptive Chebyshev: reevaluate spectrum with cg
             if (mKspType == "chebychev")
@@ -1160,42 +1337,9 @@ Vec LinearSystem::Solve(Vec lhsGuess)
                 KSPSetComputeEigenvalues(mKspSolver, PETSC_FALSE);
             }
 
-#if ((PETSC_VERSION_MAJOR == 2 && PETSC_VERSION_MINOR == 2) || (PETSC_VERSION_MAJOR == 2 && PETSC_VERSION_MINOR == 3 && PETSC_VERSION_SUBMINOR <= 2))
-            if (mKspType == "chebychev")
-            {
-                // See #1695 for more details.
-                EXCEPTION("Chebyshev with fixed number of iterations is known to be broken in PETSc <= 2.3.2");
-            }
-
-            KSPSetNormType(mKspSolver, KSP_NO_NORM);
-#elif (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 2) //PETSc 3.2 or later
-            KSPSetNormType(mKspSolver, KSP_NORM_NONE);
-    #if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 7) //PETSc 3.7 or later
-              /*
-             * Up to PETSc 3.7.2 the above call also turned off the default convergence test.
-             * However, in PETSc 3.7.3 (subminor release) this behaviour was removed and so, here,
-             * we explicitly add it back again.
-             * See
-             * https://bitbucket.org/petsc/petsc/commits/eb70c44be3430b039effa3de7e1ca2fab9f75a57
-             * This following line of code is actually valid from PETSc 3.5.
-             */
-            KSPSetConvergenceTest(mKspSolver, KSPConvergedSkip, PETSC_NULL, PETSC_NULL);
-    #endif
-#else
-            KSPSetNormType(mKspSolver, KSP_NORM_NO);
-#endif
-
-#if (PETSC_VERSION_MAJOR == 2)
-            KSPSetConvergenceTest(mKspSolver, KSPSkipConverged, PETSC_NULL);
-#endif
-
             PetscInt num_it;
             KSPGetIterationNumber(mKspSolver, &num_it);
-            std::stringstream num_it_str;
-            num_it_str << num_it;
-            PetscTools::SetOption("-ksp_max_it", num_it_str.str().c_str());
-
-            KSPSetFromOptions(mKspSolver);
+            SkipConvergenceTest(num_it);
             KSPSetUp(mKspSolver);
 
             mForceSpectrumReevaluation=false;
@@ -1239,21 +1383,16 @@ void LinearSystem::SetPrecondMatrixIsDifferentFromLhs(bool precondIsDifferent)
     }
 }
 
-void LinearSystem::SetUseFixedNumberIterations(bool useFixedNumberIterations, unsigned evaluateNumItsEveryNSolves)
+void LinearSystem::SetUseFixedNumberIterations(bool useFixedNumberIterations, unsigned evaluateNumItsEveryNSolves, unsigned fixedNumberIterations)
 {
 
     mUseFixedNumberIterations = useFixedNumberIterations;
     mEvaluateNumItsEveryNSolves = evaluateNumItsEveryNSolves;
+    mFixedNumberIterations = fixedNumberIterations;
 }
 
 void LinearSystem::ResetKspSolver()
 {
-    if (mKspIsSetup)
-    {
-        KSPDestroy(PETSC_DESTROY_PARAM(mKspSolver));
-    }
-
-    mKspIsSetup = false;
     mForceSpectrumReevaluation = true;
 
     /*
@@ -1265,6 +1404,149 @@ void LinearSystem::ResetKspSolver()
     std::stringstream num_it_str;
     num_it_str << 1000;
     PetscTools::SetOption("-ksp_max_it", num_it_str.str().c_str());
+
+    if (mKspIsSetup && mPreconditionerReuseTolerance >= 0.0)
+    {
+        // Keep the solver and preconditioner; the next Solve() decides whether the latter must be rebuilt.
+        // The kept solver will not read the options database again, so apply the iteration limit directly.
+        PetscReal rtol, abstol, dtol;
+        PetscInt max_it;
+        KSPGetTolerances(mKspSolver, &rtol, &abstol, &dtol, &max_it);
+        KSPSetTolerances(mKspSolver, rtol, abstol, dtol, 1000);
+        mCheckPreconditionerReuse = true;
+        return;
+    }
+
+    if (mKspIsSetup)
+    {
+        KSPDestroy(PETSC_DESTROY_PARAM(mKspSolver));
+    }
+
+    mKspIsSetup = false;
+}
+
+void LinearSystem::SetPreconditionerReuseTolerance(double tolerance)
+{
+    mPreconditionerReuseTolerance = tolerance;
+    if (mKspIsSetup && tolerance >= 0.0)
+    {
+        MatNorm(mLhsMatrix, NORM_FROBENIUS, &mPreconditionerMatrixNorm);
+    }
+}
+
+double LinearSystem::GetPreconditionerReuseTolerance() const
+{
+    return mPreconditionerReuseTolerance;
+}
+
+void LinearSystem::UpdatePreconditionerIfMatrixChanged()
+{
+    assert(mKspIsSetup);
+    mCheckPreconditionerReuse = false;
+
+    PetscReal norm;
+    MatNorm(mLhsMatrix, NORM_FROBENIUS, &norm);
+    const bool rebuild = fabs(norm - mPreconditionerMatrixNorm) > mPreconditionerReuseTolerance*mPreconditionerMatrixNorm;
+
+    Mat precond_matrix = mPrecondMatrixIsNotLhs ? mPrecondMatrix : mLhsMatrix;
+#if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 5) //PETSc 3.5 or later
+    KSPSetReusePreconditioner(mKspSolver, rebuild ? PETSC_FALSE : PETSC_TRUE);
+    KSPSetOperators(mKspSolver, mLhsMatrix, precond_matrix);
+#else
+    KSPSetOperators(mKspSolver, mLhsMatrix, precond_matrix, rebuild ? SAME_NONZERO_PATTERN : SAME_PRECONDITIONER);
+#endif
+
+    if (rebuild)
+    {
+        // Do the set-up now (rather than inside KSPSolve) so that it is timed separately
+        const double setup_start_time = Timer::GetWallTime();
+        KSPSetUp(mKspSolver);
+        mKspSetupTime += Timer::GetWallTime() - setup_start_time;
+        mNumPreconditionerSetups++;
+        mPreconditionerMatrixNorm = norm;
+#if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 5) //PETSc 3.5 or later
+        // Until the matrix changes again the new preconditioner is kept
+        KSPSetReusePreconditioner(mKspSolver, PETSC_TRUE);
+#endif
+    }
+}
+
+double LinearSystem::GetKspSetupTime() const
+{
+    return mKspSetupTime;
+}
+
+double LinearSystem::GetKspSolveTime() const
+{
+    return mKspSolveTime;
+}
+
+unsigned LinearSystem::GetNumPreconditionerSetups() const
+{
+    return mNumPreconditionerSetups;
+}
+
+const char* LinearSystem::GetPetscKspType() const
+{
+    if (mKspType == "chebychev")
+    {
+#if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 3) //PETSc 3.3 or later
+        return "chebyshev";
+#else
+        return "chebychev";
+#endif
+    }
+    if (mKspType == "pipecg" || mKspType == "groppcg")
+    {
+#if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR < 4) || (PETSC_VERSION_MAJOR < 3) // Before PETSc 3.4
+        EXCEPTION("KSP solver " << mKspType << " requires PETSc 3.4 or later");
+#endif
+    }
+    if (mKspType == "pgmres")
+    {
+#if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR < 3) || (PETSC_VERSION_MAJOR < 3) // Before PETSc 3.3
+        EXCEPTION("KSP solver " << mKspType << " requires PETSc 3.3 or later");
+#endif
+    }
+    return mKspType.c_str();
+}
+
+void LinearSystem::SkipConvergenceTest(PetscInt numIterations)
+{
+#if ((PETSC_VERSION_MAJOR == 2 && PETSC_VERSION_MINOR == 2) || (PETSC_VERSION_MAJOR == 2 && PETSC_VERSION_MINOR == 3 && PETSC_VERSION_SUBMINOR <= 2))
+    if (mKspType == "chebychev")
+    {
+        // See #1695 for more details.
+        EXCEPTION("Chebyshev with fixed number of iterations is known to be broken in PETSc <= 2.3.2");
+    }
+
+    KSPSetNormType(mKspSolver, KSP_NO_NORM);
+#elif (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 2) //PETSc 3.2 or later
+    KSPSetNormType(mKspSolver, KSP_NORM_NONE);
+    #if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 7) //PETSc 3.7 or later
+    /*
+     * Up to PETSc 3.7.2 the above call also turned off the default convergence test.
+     * However, in PETSc 3.7.3 (subminor release) this behaviour was removed and so, here,
+     * we explicitly add it back again.
+     * See
+     * https://bitbucket.org/petsc/petsc/commits/eb70c44be3430b039effa3de7e1ca2fab9f75a57
+     * This following line of code is actually valid from PETSc 3.5.
+     */
+    KSPSetConvergenceTest(mKspSolver, KSPConvergedSkip, PETSC_NULL, PETSC_NULL);
+    #endif
+#else
+    KSPSetNormType(mKspSolver, KSP_NORM_NO);
+#endif
+
+#if (PETSC_VERSION_MAJOR == 2)
+    KSPSetConvergenceTest(mKspSolver, KSPSkipConverged, PETSC_NULL);
+#endif
+
+    std::stringstream num_it_str;
+    num_it_str << numIterations;
+    PetscTools::SetOption("-ksp_max_it", num_it_str.str().c_str());
+
+    KSPSetFromOptions(mKspSolver);
 }
 
 // Serialization for Boost >= 1.36
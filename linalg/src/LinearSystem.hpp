@@ -44,9 +44,12 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "PetscMatTools.hpp"
 #include "OutputFileHandler.hpp"
 #include "PCBlockDiagonal.hpp"
+#include "PCThreeFieldBlockDiagonal.hpp"
 #include "PCLDUFactorisation.hpp"
 #include "PCTwoLevelsBlockDiagonal.hpp"
+#include "PCTissueBathMultilevel.hpp"
 #include "ArchiveLocationInfo.hpp"
+#include "AbstractMemoryAccountable.hpp"
 //#include <boost/serialization/shared_ptr.hpp>
 
 #include <petscvec.h>
@@ -55,6 +58,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <petscviewer.h>
 
 #include <string>
+#include <vector>
 #include <cassert>
 
 /**
@@ -62,11 +66,13 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  * where A is a square matrix and x and b are column vectors.
  * The class uses PETSc.
  */
-class LinearSystem
+class LinearSystem : public AbstractMemoryAccountable
 {
     friend class TestLinearSystem;
     friend class TestPCBlockDiagonal;
+    friend class TestPCThreeFieldBlockDiagonal;
     friend class TestPCTwoLevelsBlockDiagonal;
+    friend class TestPCTissueBathMultilevel;
     friend class TestPCLDUFactorisation;
     friend class TestChebyshevIteration;
 
@@ -108,9 +114,13 @@ private:
     /** Stores a pointer to a purpose-build preconditioner*/
     PCBlockDiagonal* mpBlockDiagonalPC;
     /** Stores a pointer to a purpose-build preconditioner*/
+    PCThreeFieldBlockDiagonal* mpThreeFieldBlockDiagonalPC;
+    /** Stores a pointer to a purpose-build preconditioner*/
     PCLDUFactorisation* mpLDUFactorisationPC;
     /** Stores a pointer to a purpose-build preconditioner*/
     PCTwoLevelsBlockDiagonal* mpTwoLevelsBlockDiagonalPC;
+    /** Stores a pointer to a purpose-build preconditioner*/
+    PCTissueBathMultilevel* mpTissueBathMultilevelPC;
 
     /** Pointer to vector containing a list of bath nodes*/
     boost::shared_ptr<std::vector<PetscInt> > mpBathNodes;
@@ -131,6 +141,13 @@ private:
      */
     unsigned mEvaluateNumItsEveryNSolves;
 
+    /**
+     * When using fixed number of iterations, the number of iterations to perform in every solve.
+     * If zero (the default) this is instead decided by the residual-based solves described
+     * in #mEvaluateNumItsEveryNSolves; otherwise no residual norm is ever computed.
+     */
+    unsigned mFixedNumberIterations;
+
     /**  Context for KSPDefaultConverged() */
     void* mpConvergenceTestContext;
 
@@ -146,6 +163,28 @@ private:
     /** Under certain circunstances you have to reevaluate the spectrum before the k*n-th, k=0,1,..., iteration*/
     bool mForceSpectrumReevaluation;
 
+    /**
+     * Relative change in the Frobenius norm of the LHS matrix beyond which the preconditioner
+     * is rebuilt; negative (the default) if the preconditioner is never kept across calls to
+     * ResetKspSolver(). See SetPreconditionerReuseTolerance().
+     */
+    double mPreconditionerReuseTolerance;
+
+    /** Frobenius norm of the LHS matrix when the preconditioner was last built. */
+    PetscReal mPreconditionerMatrixNorm;
+
+    /** Whether ResetKspSolver() has been called since the preconditioner was last checked. */
+    bool mCheckPreconditionerReuse;
+
+    /** Total wall-clock time (s) spent setting up the KSP solver and preconditioner. */
+    double mKspSetupTime;
+
+    /** Total wall-clock time (s) spent in KSPSolve. */
+    double mKspSolveTime;
+
+    /** Number of times the preconditioner has been (re)built. */
+    unsigned mNumPreconditionerSetups;
+
 #ifdef TRACE_KSP
     unsigned mTotalNumIterations;
     unsigned mMaxNumIterations;
@@ -203,8 +242,10 @@ public:
      *        ** currently only used in PETSc 3.3 and later **
      *        in PETSc 3.2 and earlier MAT_NEW_NONZERO_ALLOCATION_ERR defaults to false
      *        in PETSc 3.3 MAT_NEW_NONZERO_ALLOCATION_ERR defaults to true
+     * @param blockSize the number of interleaved unknowns per node, passed on to the LHS matrix
+     *        (see PetscTools::SetupMat). Defaults to 1.
      */
-    LinearSystem(Vec templateVector, unsigned rowPreallocation, bool newAllocationError=true);
+    LinearSystem(Vec templateVector, unsigned rowPreallocation, bool newAllocationError=true, unsigned blockSize=1);
 
     /**
      * Alternative constructor.
@@ -234,6 +275,17 @@ public:
      */
     ~LinearSystem();
 
+    /**
+     * Estimate the local memory held by this linear system, for MemoryAccounting.
+     * Counts the matrix nonzeros allocated on this process and the local parts of the
+     * right-hand side and Dirichlet vectors (and of a separate preconditioner matrix),
+     * but only when this object owns them. Memory inside PETSc preconditioners and
+     * KSP work vectors is not included.
+     *
+     * @return the estimated number of bytes
+     */
+    double GetMemoryUsage() const;
+
 //    bool IsMatrixEqualTo(Mat testMatrix);
 //    bool IsRhsVectorEqualTo(Vec testVector);
 
@@ -303,6 +355,12 @@ public:
      */
     bool IsMatrixSymmetric();
 
+    /**
+     * @return whether a matrix other than the LHS is used for preconditioning
+     * (see SetPrecondMatrixIsDifferentFromLhs()).
+     */
+    bool IsPrecondMatrixDifferentFromLhs() const;
+
     /**
      * Set mMatrixIsConstant.
      *
@@ -327,6 +385,10 @@ public:
     /**
      * Set the KSP solver type (see PETSc KSPSetType() for valid arguments).
      *
+     * As well as the PETSc names, "chebychev" is accepted for Chebyshev iteration and the
+     * communication-avoiding variants "pipecg" (pipelined CG), "groppcg" (CG with overlapped
+     * reductions) and "pgmres" (pipelined GMRES) are checked against the PETSc version in use.
+     *
      * @param kspType  the KSP solver type
      */
     void SetKspType(const char* kspType);
@@ -430,6 +492,14 @@ public:
      */
     void SetRhsVectorElement(PetscInt row, double value);
 
+    /**
+     * Set several elements of the right-hand side vector in one call.
+     *
+     * @param rRows  the row indices
+     * @param rValues  the value to set at each row
+     */
+    void SetRhsVectorElements(const std::vector<unsigned>& rRows, const std::vector<double>& rValues);
+
     /**
      * Add a value to an element of the right-hand side vector.
      *
@@ -567,14 +637,79 @@ public:
      * Set method for #mUseFixedNumberIterations
      * @param useFixedNumberIterations whether to use fixed number of iterations
      * @param evaluateNumItsEveryNSolves tells LinearSystem to perform a solve with convergence-based stop criteria every n solves to decide how many iterations perform for the next n-1 solves. Default is perfoming a single evaluation at the beginning of the simulation.
+     * @param fixedNumberIterations if non-zero, perform exactly this many iterations in every solve (including the first),
+     *     so that the residual norm is never computed and evaluateNumItsEveryNSolves is ignored. Default is zero.
      */
-    void SetUseFixedNumberIterations(bool useFixedNumberIterations = true, unsigned evaluateNumItsEveryNSolves = UINT_MAX);
+    void SetUseFixedNumberIterations(bool useFixedNumberIterations = true, unsigned evaluateNumItsEveryNSolves = UINT_MAX, unsigned fixedNumberIterations = 0u);
 
     /**
      * Method to regenerate all KSP objects, including the solver and the preconditioner (e.g. after
      * changing the PDE time step when using time adaptivity).
+     *
+     * If a preconditioner reuse tolerance has been set (see SetPreconditionerReuseTolerance()) the
+     * KSP objects are kept instead, and the preconditioner is only rebuilt by the next Solve() if
+     * the LHS matrix has changed by more than the tolerance.
      */
     void ResetKspSolver();
+
+    /**
+     * Keep the (possibly expensive, e.g. algebraic multigrid) preconditioner across calls to
+     * ResetKspSolver() and across solves with a non-constant matrix, only rebuilding it when the
+     * Frobenius norm of the LHS matrix has changed by more than the given relative amount since
+     * it was last built.  Use a tolerance of zero to rebuild whenever the norm changes at all,
+     * or a negative tolerance for the default behaviour.
+     *
+     * Note that the norm is only a cheap proxy for the matrix having changed: matrices with the
+     * same norm but different entries will share a preconditioner, which may cost iterations but
+     * will not affect the accuracy of the solution.
+     *
+     * @param tolerance  the relative change in matrix norm which triggers a rebuild
+     */
+    void SetPreconditionerReuseTolerance(double tolerance);
+
+    /**
+     * @return #mPreconditionerReuseTolerance
+     */
+    double GetPreconditionerReuseTolerance() const;
+
+    /**
+     * @return the total wall-clock time (s) spent setting up the KSP solver and building
+     * the preconditioner
+     */
+    double GetKspSetupTime() const;
+
+    /**
+     * @return the total wall-clock time (s) spent in KSPSolve (excluding explicit set-up)
+     */
+    double GetKspSolveTime() const;
+
+    /**
+     * @return the number of times the preconditioner has been built
+     */
+    unsigned GetNumPreconditionerSetups() const;
+
+private:
+
+    /**
+     * Called by Solve() when the KSP has already been set up and a preconditioner reuse tolerance
+     * is in effect: rebuilds the preconditioner if the LHS matrix has changed by more than the
+     * tolerance, and reuses it otherwise.
+     */
+    void UpdatePreconditionerIfMatrixChanged();
+
+    /**
+     * @return the name to pass to PETSc KSPSetType() for #mKspType. Throws if #mKspType
+     * names a solver which is not available in the PETSc version in use.
+     */
+    const char* GetPetscKspType() const;
+
+    /**
+     * Switch the KSP to performing exactly the given number of iterations, without computing
+     * the residual norm or testing for convergence.
+     *
+     * @param numIterations  the number of iterations to perform in each subsequent solve
+     */
+    void SkipConvergenceTest(PetscInt numIterations);
 };
 
 #include "SerializationExportWrapper.hpp"
@@ -140,8 +140,8 @@ void PCBlockDiagonal::PCBlockDiagonalCreate(KSP& rKspObject)
 
         IS A11_local_rows;
         IS A11_columns;
-        ISCreateStride(PETSC_COMM_WORLD, high-low, 2*low, 2, &A11_local_rows);
-        ISCreateStride(PETSC_COMM_WORLD, global_size, 0, 2, &A11_columns);
+        ISCreateStride(PetscTools::GetWorld(), high-low, 2*low, 2, &A11_local_rows);
+        ISCreateStride(PetscTools::GetWorld(), global_size, 0, 2, &A11_columns);
 
 #if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 8) //PETSc 3.8 or later
         MatCreateSubMatrix(system_matrix, A11_local_rows, A11_local_rows,
@@ -166,8 +166,8 @@ void PCBlockDiagonal::PCBlockDiagonalCreate(KSP& rKspObject)
 
         IS A22_local_rows;
         IS A22_columns;
-        ISCreateStride(PETSC_COMM_WORLD, high-low, 2*low+1, 2, &A22_local_rows);
-        ISCreateStride(PETSC_COMM_WORLD, global_size, 1, 2, &A22_columns);
+        ISCreateStride(PetscTools::GetWorld(), high-low, 2*low+1, 2, &A22_local_rows);
+        ISCreateStride(PetscTools::GetWorld(), global_size, 1, 2, &A22_columns);
 
 #if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 8) //PETSc 3.8 or later
         MatCreateSubMatrix(system_matrix, A22_local_rows, A22_local_rows,
@@ -203,7 +203,7 @@ void PCBlockDiagonal::PCBlockDiagonalSetUp()
 //     PetscTools::SetOption("-pc_hypre_type", "boomeramg");
 
     // Set up amg preconditioner for block A11
-    PCCreate(PETSC_COMM_WORLD, &(mPCContext.PC_amg_A11));
+    PCCreate(PetscTools::GetWorld(), &(mPCContext.PC_amg_A11));
 
     //    PCSetType(mPCContext.PC_amg_A11, PCBJACOBI);
 
@@ -240,7 +240,7 @@ void PCBlockDiagonal::PCBlockDiagonalSetUp()
     PCSetUp(mPCContext.PC_amg_A11);
 
     // Set up amg preconditioner for block A22
-    PCCreate(PETSC_COMM_WORLD, &(mPCContext.PC_amg_A22));
+    PCCreate(PetscTools::GetWorld(), &(mPCContext.PC_amg_A22));
 
     /* Full AMG in the block */
     PetscPushErrorHandler(PetscIgnoreErrorHandler, nullptr);
@@ -144,8 +144,8 @@ void PCLDUFactorisation::PCLDUFactorisationCreate(KSP& rKspObject)
 
         IS A11_local_rows;
         IS A11_columns;
-        ISCreateStride(PETSC_COMM_WORLD, high-low, 2*low, 2, &A11_local_rows);
-        ISCreateStride(PETSC_COMM_WORLD, global_size, 0, 2, &A11_columns);
+        ISCreateStride(PetscTools::GetWorld(), high-low, 2*low, 2, &A11_local_rows);
+        ISCreateStride(PetscTools::GetWorld(), global_size, 0, 2, &A11_columns);
 
 #if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 8) //PETSc 3.8 or later
         MatCreateSubMatrix(system_matrix, A11_local_rows, A11_local_rows,
@@ -168,8 +168,8 @@ void PCLDUFactorisation::PCLDUFactorisationCreate(KSP& rKspObject)
 
         IS A22_local_rows;
         IS A22_columns;
-        ISCreateStride(PETSC_COMM_WORLD, high-low, 2*low+1, 2, &A22_local_rows);
-        ISCreateStride(PETSC_COMM_WORLD, global_size, 1, 2, &A22_columns);
+        ISCreateStride(PetscTools::GetWorld(), high-low, 2*low+1, 2, &A22_local_rows);
+        ISCreateStride(PetscTools::GetWorld(), global_size, 1, 2, &A22_columns);
 
 #if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 8) //PETSc 3.8 or later
         MatCreateSubMatrix(system_matrix, A22_local_rows, A22_local_rows,
@@ -193,9 +193,9 @@ void PCLDUFactorisation::PCLDUFactorisationCreate(KSP& rKspObject)
 
         IS B_local_rows;
         IS B_columns;
-        ISCreateStride(PETSC_COMM_WORLD, high-low, 2*low, 2, &B_local_rows);
+        ISCreateStride(PetscTools::GetWorld(), high-low, 2*low, 2, &B_local_rows);
 
-        ISCreateStride(PETSC_COMM_WORLD, high-low, 2*low+1, 2, &B_columns);
+        ISCreateStride(PetscTools::GetWorld(), high-low, 2*low+1, 2, &B_columns);
 
 #if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 8) //PETSc 3.8 or later
         MatCreateSubMatrix(system_matrix, B_local_rows, B_columns,
@@ -251,7 +251,7 @@ void PCLDUFactorisation::PCLDUFactorisationSetUp()
     /*
      * Set up preconditioner for block A11
      */
-    PCCreate(PETSC_COMM_WORLD, &(mPCContext.PC_amg_A11));
+    PCCreate(PetscTools::GetWorld(), &(mPCContext.PC_amg_A11));
 #if (PETSC_VERSION_MAJOR==3 && PETSC_VERSION_MINOR>=5)
     // Attempt to emulate SAME_PRECONDITIONER below
     PCSetReusePreconditioner(mPCContext.PC_amg_A11, PETSC_TRUE);
@@ -311,7 +311,7 @@ void PCLDUFactorisation::PCLDUFactorisationSetUp()
     /*
      * Set up amg preconditioner for block A22
      */
-    PCCreate(PETSC_COMM_WORLD, &(mPCContext.PC_amg_A22));
+    PCCreate(PetscTools::GetWorld(), &(mPCContext.PC_amg_A22));
 #if (PETSC_VERSION_MAJOR==3 && PETSC_VERSION_MINOR>=5)
     // Attempt to emulate SAME_PRECONDITIONER below
     PCSetReusePreconditioner(mPCContext.PC_amg_A22, PETSC_TRUE);
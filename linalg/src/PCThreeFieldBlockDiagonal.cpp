@@ -0,0 +1,321 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include <iostream>
+#include <vector>
+
+#include "PCThreeFieldBlockDiagonal.hpp"
+#include "Exception.hpp"
+#include "Warnings.hpp"
+
+#ifdef TRACE_KSP
+#include "Timer.hpp"
+#endif
+
+PCThreeFieldBlockDiagonal::PCThreeFieldBlockDiagonal(KSP& rKspObject)
+{
+#ifdef TRACE_KSP
+    mPCContext.mScatterTime = 0.0;
+    mPCContext.mA1PreconditionerTime = 0.0;
+    mPCContext.mA2PreconditionerTime = 0.0;
+    mPCContext.mGatherTime = 0.0;
+#endif
+
+    PCThreeFieldBlockDiagonalCreate(rKspObject);
+    PCThreeFieldBlockDiagonalSetUp();
+}
+
+PCThreeFieldBlockDiagonal::~PCThreeFieldBlockDiagonal()
+{
+#ifdef TRACE_KSP
+    if (PetscTools::AmMaster())
+    {
+        std::cout << " -- Three field block diagonal preconditioner profile information: " << std::endl;
+        std::cout << "\t mScatterTime: " << mPCContext.mScatterTime << std::endl;
+        std::cout << "\t mA1PreconditionerTime: " << mPCContext.mA1PreconditionerTime << std::endl;
+        std::cout << "\t mA2PreconditionerTime: " << mPCContext.mA2PreconditionerTime << std::endl;
+        std::cout << "\t mGatherTime: " << mPCContext.mGatherTime << std::endl;
+    }
+#endif
+
+    PetscTools::Destroy(mPCContext.Aii_matrix_subblock);
+    PetscTools::Destroy(mPCContext.A33_matrix_subblock);
+
+    PCDestroy(PETSC_DESTROY_PARAM(mPCContext.PC_amg_Aii));
+    PCDestroy(PETSC_DESTROY_PARAM(mPCContext.PC_amg_A33));
+
+    PetscTools::Destroy(mPCContext.xi_subvector);
+    PetscTools::Destroy(mPCContext.yi_subvector);
+
+    PetscTools::Destroy(mPCContext.x3_subvector);
+    PetscTools::Destroy(mPCContext.y3_subvector);
+}
+
+void PCThreeFieldBlockDiagonal::PCThreeFieldBlockDiagonalCreate(KSP& rKspObject)
+{
+    KSPGetPC(rKspObject, &mPetscPCObject);
+
+    Mat system_matrix, dummy;
+#if (PETSC_VERSION_MAJOR==3 && PETSC_VERSION_MINOR>=5)
+    KSPGetOperators(rKspObject, &system_matrix, &dummy);
+#else
+    MatStructure flag;
+    KSPGetOperators(rKspObject, &system_matrix, &dummy, &flag);
+#endif
+
+    PetscInt num_rows, num_columns;
+    MatGetSize(system_matrix, &num_rows, &num_columns);
+    assert(num_rows==num_columns);
+
+    PetscInt num_local_rows, num_local_columns;
+    MatGetLocalSize(system_matrix, &num_local_rows, &num_local_columns);
+
+    // The three unknowns of each node must be stored on the same processor
+    if ((num_rows%3 != 0) || (num_local_rows%3 != 0))
+    {
+        TERMINATE("Wrong matrix parallel layout detected in PCThreeFieldBlockDiagonal."); // LCOV_EXCL_LINE
+    }
+
+    PetscInt row_lo, row_hi;
+    MatGetOwnershipRange(system_matrix, &row_lo, &row_hi);
+    PetscInt num_nodes = num_rows/3;
+    PetscInt num_local_nodes = num_local_rows/3;
+    PetscInt node_lo = row_lo/3;
+
+    // Allocate memory
+    mPCContext.xi_subvector = PetscTools::CreateVec(2*num_nodes, 2*num_local_nodes);
+    mPCContext.yi_subvector = PetscTools::CreateVec(2*num_nodes, 2*num_local_nodes);
+    mPCContext.x3_subvector = PetscTools::CreateVec(num_nodes, num_local_nodes);
+    mPCContext.y3_subvector = PetscTools::CreateVec(num_nodes, num_local_nodes);
+
+    // Get matrix sublock Aii (the first two unknowns of each node)
+    {
+        std::vector<PetscInt> cell_rows(2*num_local_nodes);
+        for (PetscInt local_node=0; local_node<num_local_nodes; local_node++)
+        {
+            cell_rows[2*local_node] = 3*(node_lo+local_node);
+            cell_rows[2*local_node+1] = 3*(node_lo+local_node)+1;
+        }
+
+        IS Aii_local_rows;
+#if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 2) //PETSc 3.2 or later
+        ISCreateGeneral(PetscTools::GetWorld(), 2*num_local_nodes, cell_rows.empty() ? nullptr : &cell_rows[0], PETSC_COPY_VALUES, &Aii_local_rows);
+#else
+        ISCreateGeneral(PetscTools::GetWorld(), 2*num_local_nodes, cell_rows.empty() ? nullptr : &cell_rows[0], &Aii_local_rows);
+#endif
+
+#if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 8) //PETSc 3.8 or later
+        MatCreateSubMatrix(system_matrix, Aii_local_rows, Aii_local_rows,
+                           MAT_INITIAL_MATRIX, &mPCContext.Aii_matrix_subblock);
+#else
+        MatGetSubMatrix(system_matrix, Aii_local_rows, Aii_local_rows,
+                        MAT_INITIAL_MATRIX, &mPCContext.Aii_matrix_subblock);
+#endif
+
+        ISDestroy(PETSC_DESTROY_PARAM(Aii_local_rows));
+    }
+
+    // Get matrix sublock A33 (the last unknown of each node)
+    {
+        IS A33_local_rows;
+        ISCreateStride(PetscTools::GetWorld(), num_local_nodes, 3*node_lo+2, 3, &A33_local_rows);
+
+#if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 8) //PETSc 3.8 or later
+        MatCreateSubMatrix(system_matrix, A33_local_rows, A33_local_rows,
+                           MAT_INITIAL_MATRIX, &mPCContext.A33_matrix_subblock);
+#else
+        MatGetSubMatrix(system_matrix, A33_local_rows, A33_local_rows,
+                        MAT_INITIAL_MATRIX, &mPCContext.A33_matrix_subblock);
+#endif
+
+        ISDestroy(PETSC_DESTROY_PARAM(A33_local_rows));
+    }
+
+    // Register call-back function and its context
+    PCSetType(mPetscPCObject, PCSHELL);
+#if (PETSC_VERSION_MAJOR == 2 && PETSC_VERSION_MINOR == 2) //PETSc 2.2
+    PCShellSetApply(mPetscPCObject, PCThreeFieldBlockDiagonalApply, (void*) &mPCContext);
+#else
+    // Register PC context so it gets passed to PCThreeFieldBlockDiagonalApply
+    PCShellSetContext(mPetscPCObject, &mPCContext);
+
+    // Register call-back function
+    PCShellSetApply(mPetscPCObject, PCThreeFieldBlockDiagonalApply);
+#endif
+}
+
+void PCThreeFieldBlockDiagonal::PCThreeFieldBlockDiagonalSetUp()
+{
+    // Set up amg preconditioner for block Aii
+    PCCreate(PetscTools::GetWorld(), &(mPCContext.PC_amg_Aii));
+
+    // We are expecting an error from PETSC on systems that don't have the hypre library, so suppress it
+    // in case it aborts
+    PetscPushErrorHandler(PetscIgnoreErrorHandler, nullptr);
+    PetscErrorCode pc_set_error = PCSetType(mPCContext.PC_amg_Aii, PCHYPRE);
+    if (pc_set_error != 0)
+    {
+        WARNING("PETSc hypre preconditioning library is not installed");
+    }
+    // Stop supressing error
+    PetscPopErrorHandler();
+
+    PetscTools::SetOption("-pc_hypre_type", "boomeramg");
+    PetscTools::SetOption("-pc_hypre_boomeramg_max_iter", "1");
+    PetscTools::SetOption("-pc_hypre_boomeramg_strong_threshold", "0.0");
+    PetscTools::SetOption("-pc_hypre_boomeramg_coarsen_type", "HMIS");
+
+#if (PETSC_VERSION_MAJOR==3 && PETSC_VERSION_MINOR>=5)
+    // Attempt to emulate SAME_PRECONDITIONER below
+    PCSetReusePreconditioner(mPCContext.PC_amg_Aii, PETSC_TRUE);
+    PCSetOperators(mPCContext.PC_amg_Aii, mPCContext.Aii_matrix_subblock, mPCContext.Aii_matrix_subblock);
+#else
+    PCSetOperators(mPCContext.PC_amg_Aii, mPCContext.Aii_matrix_subblock, mPCContext.Aii_matrix_subblock, SAME_PRECONDITIONER);
+#endif
+    PCSetFromOptions(mPCContext.PC_amg_Aii);
+    PCSetUp(mPCContext.PC_amg_Aii);
+
+    // Set up amg preconditioner for block A33
+    PCCreate(PetscTools::GetWorld(), &(mPCContext.PC_amg_A33));
+
+    PetscPushErrorHandler(PetscIgnoreErrorHandler, nullptr);
+    PCSetType(mPCContext.PC_amg_A33, PCHYPRE);
+    // Stop supressing error
+    PetscPopErrorHandler();
+
+#if (PETSC_VERSION_MAJOR==3 && PETSC_VERSION_MINOR>=5)
+    // Attempt to emulate SAME_PRECONDITIONER below
+    PCSetReusePreconditioner(mPCContext.PC_amg_A33, PETSC_TRUE);
+    PCSetOperators(mPCContext.PC_amg_A33, mPCContext.A33_matrix_subblock, mPCContext.A33_matrix_subblock);
+#else
+    PCSetOperators(mPCContext.PC_amg_A33, mPCContext.A33_matrix_subblock, mPCContext.A33_matrix_subblock, SAME_PRECONDITIONER);
+#endif
+    PCSetFromOptions(mPCContext.PC_amg_A33);
+    PCSetUp(mPCContext.PC_amg_A33);
+}
+
+#if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 1) //PETSc 3.1 or later
+PetscErrorCode PCThreeFieldBlockDiagonalApply(PC pc_object, Vec x, Vec y)
+{
+  void* pc_context;
+
+  PCShellGetContext(pc_object, &pc_context);
+#else
+PetscErrorCode PCThreeFieldBlockDiagonalApply(void* pc_context, Vec x, Vec y)
+{
+#endif
+
+    // Cast the context pointer to PCThreeFieldBlockDiagonalContext
+    PCThreeFieldBlockDiagonal::PCThreeFieldBlockDiagonalContext* block_diag_context = (PCThreeFieldBlockDiagonal::PCThreeFieldBlockDiagonalContext*) pc_context;
+    assert(block_diag_context!=nullptr);
+
+    PetscInt num_local_nodes;
+    VecGetLocalSize(block_diag_context->x3_subvector, &num_local_nodes);
+
+    /*
+     * Split x = [xi x3]'. All the unknowns of a node are local, so this is a local copy.
+     */
+#ifdef TRACE_KSP
+    Timer::Reset();
+#endif
+    {
+        const PetscScalar* p_x;
+        PetscScalar* p_xi;
+        PetscScalar* p_x3;
+        VecGetArrayRead(x, &p_x);
+        VecGetArray(block_diag_context->xi_subvector, &p_xi);
+        VecGetArray(block_diag_context->x3_subvector, &p_x3);
+        for (PetscInt local_node=0; local_node<num_local_nodes; local_node++)
+        {
+            p_xi[2*local_node] = p_x[3*local_node];
+            p_xi[2*local_node+1] = p_x[3*local_node+1];
+            p_x3[local_node] = p_x[3*local_node+2];
+        }
+        VecRestoreArrayRead(x, &p_x);
+        VecRestoreArray(block_diag_context->xi_subvector, &p_xi);
+        VecRestoreArray(block_diag_context->x3_subvector, &p_x3);
+    }
+#ifdef TRACE_KSP
+    block_diag_context->mScatterTime += Timer::GetElapsedTime();
+#endif
+
+    /*
+     * yi = AMG(Aii)*xi
+     * y3 = AMG(A33)*x3
+     */
+#ifdef TRACE_KSP
+    Timer::Reset();
+#endif
+    PCApply(block_diag_context->PC_amg_Aii, block_diag_context->xi_subvector, block_diag_context->yi_subvector);
+#ifdef TRACE_KSP
+    block_diag_context->mA1PreconditionerTime += Timer::GetElapsedTime();
+#endif
+
+#ifdef TRACE_KSP
+    Timer::Reset();
+#endif
+    PCApply(block_diag_context->PC_amg_A33, block_diag_context->x3_subvector, block_diag_context->y3_subvector);
+#ifdef TRACE_KSP
+    block_diag_context->mA2PreconditionerTime += Timer::GetElapsedTime();
+#endif
+
+    /*
+     * Gather y = [yi y3]'
+     */
+#ifdef TRACE_KSP
+    Timer::Reset();
+#endif
+    {
+        PetscScalar* p_y;
+        const PetscScalar* p_yi;
+        const PetscScalar* p_y3;
+        VecGetArray(y, &p_y);
+        VecGetArrayRead(block_diag_context->yi_subvector, &p_yi);
+        VecGetArrayRead(block_diag_context->y3_subvector, &p_y3);
+        for (PetscInt local_node=0; local_node<num_local_nodes; local_node++)
+        {
+            p_y[3*local_node] = p_yi[2*local_node];
+            p_y[3*local_node+1] = p_yi[2*local_node+1];
+            p_y[3*local_node+2] = p_y3[local_node];
+        }
+        VecRestoreArray(y, &p_y);
+        VecRestoreArrayRead(block_diag_context->yi_subvector, &p_yi);
+        VecRestoreArrayRead(block_diag_context->y3_subvector, &p_y3);
+    }
+#ifdef TRACE_KSP
+    block_diag_context->mGatherTime += Timer::GetElapsedTime();
+#endif
+    return 0;
+}
@@ -0,0 +1,139 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef PCTHREEFIELDBLOCKDIAGONAL_HPP_
+#define PCTHREEFIELDBLOCKDIAGONAL_HPP_
+
+#include <cassert>
+#include <petscvec.h>
+#include <petscmat.h>
+#include <petscksp.h>
+#include <petscpc.h>
+#include "PetscTools.hpp"
+
+/**
+ * PETSc will return the control to this function everytime it needs to precondition a vector (i.e. y = inv(M)*x)
+ *
+ * This function needs to be declared global, see PCBlockDiagonalApply().
+ *
+ * @param pc_context preconditioner context struct. Stores preconditioner state (i.e. PC, Mat, and Vec objects used)
+ * @param x unpreconditioned residual.
+ * @param y preconditioned residual. y = inv(M)*x
+ */
+#if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 1) //PETSc 3.1 or later
+PetscErrorCode PCThreeFieldBlockDiagonalApply(PC pc_context, Vec x, Vec y);
+#else
+PetscErrorCode PCThreeFieldBlockDiagonalApply(void* pc_context, Vec x, Vec y);
+#endif
+
+/**
+ * This class defines a PETSc-compliant purpose-build preconditioner for systems
+ * with three unknowns per node stored interleaved, such as the extended bidomain
+ * equations [V_1 V_2 phi_e V_1 V_2 phi_e ...].
+ *
+ * Reordering the unknowns by field, the matrix has the block structure
+ *
+ *                 A = (A11  A12  B1')
+ *                     (A21  A22  B2')
+ *                     (B1   B2   A33)
+ *
+ * The two cell potentials are coupled node by node through the cell-to-cell
+ * conductance, so they are kept together in one block, while the extracellular
+ * potential forms a second block:
+ *
+ *                 inv(M) = inv( (Aii   0)   = (inv(Aii)        0)
+ *                               (0   A33) )   (0        inv(A33))
+ *
+ * where Aii is the 2x2 block matrix of the two cell potentials. Each inverse
+ * is approximated with one cycle of AMG. As with PCBlockDiagonal, this requires
+ * PETSc to be built with HYPRE; otherwise a warning is shown and PETSc's default
+ * preconditioner is used for the blocks.
+ *
+ * All three unknowns for a node must be stored on the same process, so that
+ * splitting and reassembling the fields is a purely local operation.
+ */
+class PCThreeFieldBlockDiagonal
+{
+public:
+
+    /**
+     * This struct defines the state of the preconditioner (initialised data and objects to be reused)
+     */
+    typedef struct{
+        Mat Aii_matrix_subblock; /**< Mat object that stores the subblock of the two cell potentials*/
+        Mat A33_matrix_subblock; /**< Mat object that stores the extracellular subblock*/
+        PC  PC_amg_Aii; /**< inv(Aii) is approximated by an AMG cycle. We compute it with HYPRE via a PC object*/
+        PC  PC_amg_A33; /**< inv(A33) is approximated by an AMG cycle. We compute it with HYPRE via a PC object*/
+        Vec xi_subvector;/**< Used to store the two cell potential fields of the vector to be preconditioned*/
+        Vec x3_subvector;/**< Used to store the extracellular field of the vector to be preconditioned*/
+        Vec yi_subvector;/**< Used to store the two cell potential fields of the preconditioned vector*/
+        Vec y3_subvector;/**< Used to store the extracellular field of the preconditioned vector*/
+#ifdef TRACE_KSP
+        double mScatterTime;/**< Time counter used for profiling scatter operations*/
+        double mA1PreconditionerTime;/**< Time counter used for profiling the application of the preconditioner on the Aii block*/
+        double mA2PreconditionerTime;/**< Time counter used for profiling the application of the preconditioner on the A33 block*/
+        double mGatherTime;/**< Time counter used for profiling gather operations*/
+#endif
+
+    } PCThreeFieldBlockDiagonalContext;
+
+    PCThreeFieldBlockDiagonalContext mPCContext; /**< PC context, this will be passed to PCThreeFieldBlockDiagonalApply when PETSc returns control to our preconditioner subroutine.  See PCShellSetContext().*/
+    PC mPetscPCObject;/**< Generic PETSc preconditioner object */
+
+    /**
+     * Constructor.
+     *
+     * @param rKspObject KSP object where we want to install the block diagonal preconditioner.
+     */
+    PCThreeFieldBlockDiagonal(KSP& rKspObject);
+
+    ~PCThreeFieldBlockDiagonal();
+
+private:
+
+    /**
+     * Creates all the state data required by the preconditioner.
+     *
+     * @param rKspObject KSP object where we want to install the block diagonal preconditioner.
+     */
+    void PCThreeFieldBlockDiagonalCreate(KSP& rKspObject);
+
+    /**
+     * Setups preconditioner.
+     */
+    void PCThreeFieldBlockDiagonalSetUp();
+};
+
+#endif /*PCTHREEFIELDBLOCKDIAGONAL_HPP_*/
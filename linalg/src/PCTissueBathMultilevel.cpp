@@ -0,0 +1,555 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include <algorithm>
+
+#include "PCTissueBathMultilevel.hpp"
+#include "Exception.hpp"
+#include "Warnings.hpp"
+
+/**
+ * Create an index set from a list of global indices (the values are copied).
+ *
+ * @param rIndices the indices
+ * @param rIs the new index set
+ */
+static void CreateIndexSet(std::vector<PetscInt>& rIndices, IS& rIs)
+{
+    PetscInt* p_indices = rIndices.empty() ? nullptr : &rIndices[0];
+#if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 2) //PETSc 3.2 or later
+    ISCreateGeneral(PetscTools::GetWorld(), rIndices.size(), p_indices, PETSC_COPY_VALUES, &rIs);
+#else
+    ISCreateGeneral(PetscTools::GetWorld(), rIndices.size(), p_indices, &rIs);
+#endif
+}
+
+/**
+ * Extract (or refresh the values of) a sub-block of a matrix.
+ *
+ * @param matrix the matrix
+ * @param rows the locally owned rows of the sub-block
+ * @param columns the local part of the columns of the sub-block
+ * @param reuse MAT_INITIAL_MATRIX to create the sub-block, MAT_REUSE_MATRIX to refresh it
+ * @param pSubBlock the sub-block
+ */
+static void ExtractSubBlock(Mat matrix, IS rows, IS columns, MatReuse reuse, Mat* pSubBlock)
+{
+#if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 8) //PETSc 3.8 or later
+    MatCreateSubMatrix(matrix, rows, columns, reuse, pSubBlock);
+#else
+    MatGetSubMatrix(matrix, rows, columns, reuse, pSubBlock);
+#endif
+}
+
+/**
+ * Create a scatter context from the given entries of a vector into the whole of a
+ * (distributed) sub-vector.
+ *
+ * @param fullVector a vector with the layout of the source
+ * @param fullIndices the locally owned entries of the source to gather
+ * @param subVector the target sub-vector
+ * @param rScatter the new scatter context
+ */
+static void CreateSubVectorScatter(Vec fullVector, IS fullIndices, Vec subVector, VecScatter& rScatter)
+{
+    PetscInt low, high;
+    VecGetOwnershipRange(subVector, &low, &high);
+    IS sub_indices;
+    ISCreateStride(PetscTools::GetWorld(), high-low, low, 1, &sub_indices);
+    VecScatterCreate(fullVector, fullIndices, subVector, sub_indices, &rScatter);
+    ISDestroy(PETSC_DESTROY_PARAM(sub_indices));
+}
+
+/**
+ * Gather a sub-vector from a vector.
+ *
+ * @param scatter the scatter context
+ * @param from the full vector
+ * @param to the sub-vector
+ */
+static void ScatterForward(VecScatter scatter, Vec from, Vec to)
+{
+//PETSc-3.x.x or PETSc-2.3.3
+#if ((PETSC_VERSION_MAJOR == 3) || (PETSC_VERSION_MAJOR == 2 && PETSC_VERSION_MINOR == 3 && PETSC_VERSION_SUBMINOR == 3)) //2.3.3 or 3.x.x
+    VecScatterBegin(scatter, from, to, INSERT_VALUES, SCATTER_FORWARD);
+    VecScatterEnd(scatter, from, to, INSERT_VALUES, SCATTER_FORWARD);
+#else
+    VecScatterBegin(from, to, INSERT_VALUES, SCATTER_FORWARD, scatter);
+    VecScatterEnd(from, to, INSERT_VALUES, SCATTER_FORWARD, scatter);
+#endif
+}
+
+/**
+ * Put a sub-vector back into a vector.
+ *
+ * @param scatter the scatter context
+ * @param from the sub-vector
+ * @param to the full vector
+ */
+static void ScatterReverse(VecScatter scatter, Vec from, Vec to)
+{
+//PETSc-3.x.x or PETSc-2.3.3
+#if ((PETSC_VERSION_MAJOR == 3) || (PETSC_VERSION_MAJOR == 2 && PETSC_VERSION_MINOR == 3 && PETSC_VERSION_SUBMINOR == 3)) //2.3.3 or 3.x.x
+    VecScatterBegin(scatter, from, to, INSERT_VALUES, SCATTER_REVERSE);
+    VecScatterEnd(scatter, from, to, INSERT_VALUES, SCATTER_REVERSE);
+#else
+    VecScatterBegin(from, to, INSERT_VALUES, SCATTER_REVERSE, scatter);
+    VecScatterEnd(from, to, INSERT_VALUES, SCATTER_REVERSE, scatter);
+#endif
+}
+
+/**
+ * Attach a matrix to an inner preconditioner.
+ *
+ * @param pc the preconditioner
+ * @param matrix the matrix
+ */
+static void SetInnerOperators(PC pc, Mat matrix)
+{
+#if (PETSC_VERSION_MAJOR==3 && PETSC_VERSION_MINOR>=5)
+    PCSetOperators(pc, matrix, matrix);
+#else
+    PCSetOperators(pc, matrix, matrix, SAME_NONZERO_PATTERN);
+#endif
+}
+
+/**
+ * Create an inner preconditioner doing one AMG (BoomerAMG) cycle.
+ *
+ * @param rPc the new preconditioner
+ * @param matrix the matrix it approximates the inverse of
+ */
+static void CreateAmgPC(PC& rPc, Mat matrix)
+{
+    PCCreate(PetscTools::GetWorld(), &rPc);
+    SetInnerOperators(rPc, matrix);
+
+    // We are expecting an error from PETSC on systems that don't have the hypre library, so suppress it
+    // in case it aborts
+    PetscPushErrorHandler(PetscIgnoreErrorHandler, nullptr);
+    PetscErrorCode pc_set_error = PCSetType(rPc, PCHYPRE);
+    if (pc_set_error != 0)
+    {
+        WARNING("PETSc hypre preconditioning library is not installed");
+    }
+    // Stop supressing error
+    PetscPopErrorHandler();
+
+    PetscTools::SetOption("-pc_hypre_type", "boomeramg");
+    PetscTools::SetOption("-pc_hypre_boomeramg_max_iter", "1");
+    PetscTools::SetOption("-pc_hypre_boomeramg_strong_threshold", "0.0");
+    PetscTools::SetOption("-pc_hypre_boomeramg_coarsen_type", "HMIS");
+
+    PCSetFromOptions(rPc);
+    PCSetUp(rPc);
+}
+
+/**
+ * Create an inner block Jacobi (ILU on each process) preconditioner.
+ *
+ * @param rPc the new preconditioner
+ * @param matrix the matrix it approximates the inverse of
+ */
+static void CreateSmootherPC(PC& rPc, Mat matrix)
+{
+    PCCreate(PetscTools::GetWorld(), &rPc);
+    SetInnerOperators(rPc, matrix);
+    PCSetType(rPc, PCBJACOBI);
+    PCSetUp(rPc);
+}
+
+PCTissueBathMultilevel::PCTissueBathMultilevel(KSP& rKspObject, std::vector<PetscInt>& rBathNodes)
+{
+    PCTissueBathMultilevelCreate(rKspObject, rBathNodes);
+    PCTissueBathMultilevelSetUp();
+}
+
+PCTissueBathMultilevel::~PCTissueBathMultilevel()
+{
+    PetscTools::Destroy(mPCContext.A11_matrix_subblock);
+    PetscTools::Destroy(mPCContext.B_matrix_subblock);
+    PetscTools::Destroy(mPCContext.Bt_matrix_subblock);
+    PetscTools::Destroy(mPCContext.A22_matrix_subblock);
+    PetscTools::Destroy(mPCContext.A22_tissue_matrix_subblock);
+
+    PCDestroy(PETSC_DESTROY_PARAM(mPCContext.PC_amg_A11));
+    PCDestroy(PETSC_DESTROY_PARAM(mPCContext.PC_amg_A22));
+    PCDestroy(PETSC_DESTROY_PARAM(mPCContext.PC_smoother_tissue));
+
+    PetscTools::Destroy(mPCContext.x1_subvector);
+    PetscTools::Destroy(mPCContext.y1_subvector);
+    PetscTools::Destroy(mPCContext.x2_subvector);
+    PetscTools::Destroy(mPCContext.y2_subvector);
+    PetscTools::Destroy(mPCContext.z);
+    PetscTools::Destroy(mPCContext.temp1);
+    PetscTools::Destroy(mPCContext.r2);
+    PetscTools::Destroy(mPCContext.w2);
+    PetscTools::Destroy(mPCContext.temp2);
+    PetscTools::Destroy(mPCContext.r2_tissue);
+    PetscTools::Destroy(mPCContext.w2_tissue);
+
+    VecScatterDestroy(PETSC_DESTROY_PARAM(mPCContext.vm_tissue_scatter_ctx));
+    VecScatterDestroy(PETSC_DESTROY_PARAM(mPCContext.phi_e_scatter_ctx));
+    VecScatterDestroy(PETSC_DESTROY_PARAM(mPCContext.phi_e_tissue_scatter_ctx));
+
+    ISDestroy(PETSC_DESTROY_PARAM(mPCContext.vm_tissue_rows));
+    ISDestroy(PETSC_DESTROY_PARAM(mPCContext.phi_e_rows));
+    ISDestroy(PETSC_DESTROY_PARAM(mPCContext.phi_e_tissue_rows));
+
+    if (mPCContext.has_bath)
+    {
+        PetscTools::Destroy(mPCContext.A22_bath_matrix_subblock);
+        PCDestroy(PETSC_DESTROY_PARAM(mPCContext.PC_smoother_bath));
+        PetscTools::Destroy(mPCContext.xb_subvector);
+        PetscTools::Destroy(mPCContext.r2_bath);
+        PetscTools::Destroy(mPCContext.w2_bath);
+        VecScatterDestroy(PETSC_DESTROY_PARAM(mPCContext.vm_bath_scatter_ctx));
+        VecScatterDestroy(PETSC_DESTROY_PARAM(mPCContext.phi_e_bath_scatter_ctx));
+        ISDestroy(PETSC_DESTROY_PARAM(mPCContext.vm_bath_rows));
+        ISDestroy(PETSC_DESTROY_PARAM(mPCContext.phi_e_bath_rows));
+    }
+}
+
+unsigned PCTissueBathMultilevel::GetNumSetUps() const
+{
+    return mPCContext.num_setups;
+}
+
+void PCTissueBathMultilevel::PCTissueBathMultilevelCreate(KSP& rKspObject, std::vector<PetscInt>& rBathNodes)
+{
+    KSPGetPC(rKspObject, &mPetscPCObject);
+
+    Mat system_matrix, precond_matrix;
+#if (PETSC_VERSION_MAJOR==3 && PETSC_VERSION_MINOR>=5)
+    KSPGetOperators(rKspObject, &system_matrix, &precond_matrix);
+#else
+    MatStructure flag;
+    KSPGetOperators(rKspObject, &system_matrix, &precond_matrix, &flag);
+#endif
+    mPCContext.system_matrix = precond_matrix;
+
+    PetscInt num_rows, num_columns;
+    MatGetSize(precond_matrix, &num_rows, &num_columns);
+    assert(num_rows==num_columns);
+
+    PetscInt num_local_rows, num_local_columns;
+    MatGetLocalSize(precond_matrix, &num_local_rows, &num_local_columns);
+
+    // Odd number of rows: impossible in Bidomain.
+    // Odd number of local rows: impossible if V_m and phi_e for each node are stored in the same processor.
+    if ((num_rows%2 != 0) || (num_local_rows%2 != 0))
+    {
+        TERMINATE("Wrong matrix parallel layout detected in PCTissueBathMultilevel."); // LCOV_EXCL_LINE
+    }
+
+    // Split the locally owned nodes into tissue and bath
+    PetscInt low, high;
+    MatGetOwnershipRange(precond_matrix, &low, &high);
+    const PetscInt node_low = low/2;
+    const PetscInt node_high = high/2;
+
+    std::vector<PetscInt> local_bath_nodes;
+    for (unsigned i=0; i<rBathNodes.size(); i++)
+    {
+        if (node_low <= rBathNodes[i] && rBathNodes[i] < node_high)
+        {
+            local_bath_nodes.push_back(rBathNodes[i]);
+        }
+    }
+    std::sort(local_bath_nodes.begin(), local_bath_nodes.end());
+    local_bath_nodes.erase(std::unique(local_bath_nodes.begin(), local_bath_nodes.end()), local_bath_nodes.end());
+
+    std::vector<PetscInt> vm_tissue, vm_bath, phi_e, phi_e_tissue, phi_e_bath;
+    std::vector<PetscInt>::iterator next_bath_node = local_bath_nodes.begin();
+    for (PetscInt node=node_low; node<node_high; node++)
+    {
+        phi_e.push_back(2*node+1);
+        if (next_bath_node != local_bath_nodes.end() && *next_bath_node == node)
+        {
+            vm_bath.push_back(2*node);
+            phi_e_bath.push_back(2*node+1);
+            ++next_bath_node;
+        }
+        else
+        {
+            vm_tissue.push_back(2*node);
+            phi_e_tissue.push_back(2*node+1);
+        }
+    }
+
+    unsigned local_num_bath = local_bath_nodes.size();
+    unsigned num_bath = local_num_bath;
+    if (!PetscTools::IsSequential())
+    {
+        MPI_Allreduce(&local_num_bath, &num_bath, 1, MPI_UNSIGNED, MPI_SUM, PetscTools::GetWorld());
+    }
+    mPCContext.has_bath = (num_bath > 0);
+
+    unsigned num_nodes = num_rows/2;
+    unsigned local_num_nodes = num_local_rows/2;
+    unsigned num_tissue = num_nodes - num_bath;
+    unsigned local_num_tissue = local_num_nodes - local_num_bath;
+
+    CreateIndexSet(vm_tissue, mPCContext.vm_tissue_rows);
+    CreateIndexSet(phi_e, mPCContext.phi_e_rows);
+    CreateIndexSet(phi_e_tissue, mPCContext.phi_e_tissue_rows);
+
+    // Allocate memory
+    mPCContext.x1_subvector = PetscTools::CreateVec(num_tissue, local_num_tissue);
+    mPCContext.y1_subvector = PetscTools::CreateVec(num_tissue, local_num_tissue);
+    mPCContext.z = PetscTools::CreateVec(num_tissue, local_num_tissue);
+    mPCContext.temp1 = PetscTools::CreateVec(num_tissue, local_num_tissue);
+    mPCContext.x2_subvector = PetscTools::CreateVec(num_nodes, local_num_nodes);
+    mPCContext.y2_subvector = PetscTools::CreateVec(num_nodes, local_num_nodes);
+    mPCContext.r2 = PetscTools::CreateVec(num_nodes, local_num_nodes);
+    mPCContext.w2 = PetscTools::CreateVec(num_nodes, local_num_nodes);
+    mPCContext.temp2 = PetscTools::CreateVec(num_nodes, local_num_nodes);
+    mPCContext.r2_tissue = PetscTools::CreateVec(num_tissue, local_num_tissue);
+    mPCContext.w2_tissue = PetscTools::CreateVec(num_tissue, local_num_tissue);
+
+    // Create scatter contexts
+    {
+        // Needed by VecScatterCreate in order to find out parallel layout.
+        Vec dummy_vec = PetscTools::CreateVec(num_rows, num_local_rows);
+
+        CreateSubVectorScatter(dummy_vec, mPCContext.vm_tissue_rows, mPCContext.x1_subvector, mPCContext.vm_tissue_scatter_ctx);
+        CreateSubVectorScatter(dummy_vec, mPCContext.phi_e_rows, mPCContext.x2_subvector, mPCContext.phi_e_scatter_ctx);
+
+        // The phi_e sub-vector is indexed by node
+        std::vector<PetscInt> tissue_nodes(phi_e_tissue.size());
+        for (unsigned i=0; i<phi_e_tissue.size(); i++)
+        {
+            tissue_nodes[i] = phi_e_tissue[i]/2;
+        }
+        IS tissue_nodes_is;
+        CreateIndexSet(tissue_nodes, tissue_nodes_is);
+        CreateSubVectorScatter(mPCContext.x2_subvector, tissue_nodes_is, mPCContext.r2_tissue, mPCContext.phi_e_tissue_scatter_ctx);
+        ISDestroy(PETSC_DESTROY_PARAM(tissue_nodes_is));
+
+        if (mPCContext.has_bath)
+        {
+            CreateIndexSet(vm_bath, mPCContext.vm_bath_rows);
+            CreateIndexSet(phi_e_bath, mPCContext.phi_e_bath_rows);
+
+            mPCContext.xb_subvector = PetscTools::CreateVec(num_bath, local_num_bath);
+            mPCContext.r2_bath = PetscTools::CreateVec(num_bath, local_num_bath);
+            mPCContext.w2_bath = PetscTools::CreateVec(num_bath, local_num_bath);
+
+            CreateSubVectorScatter(dummy_vec, mPCContext.vm_bath_rows, mPCContext.xb_subvector, mPCContext.vm_bath_scatter_ctx);
+
+            IS bath_nodes_is;
+            CreateIndexSet(local_bath_nodes, bath_nodes_is);
+            CreateSubVectorScatter(mPCContext.x2_subvector, bath_nodes_is, mPCContext.r2_bath, mPCContext.phi_e_bath_scatter_ctx);
+            ISDestroy(PETSC_DESTROY_PARAM(bath_nodes_is));
+        }
+
+        PetscTools::Destroy(dummy_vec);
+    }
+
+    // Get matrix sub-blocks. The column index sets give the local part of the columns, so
+    // each sub-block's column layout matches the sub-vector it multiplies.
+    ExtractSubBlock(precond_matrix, mPCContext.vm_tissue_rows, mPCContext.vm_tissue_rows, MAT_INITIAL_MATRIX, &mPCContext.A11_matrix_subblock);
+    ExtractSubBlock(precond_matrix, mPCContext.phi_e_rows, mPCContext.vm_tissue_rows, MAT_INITIAL_MATRIX, &mPCContext.B_matrix_subblock);
+    ExtractSubBlock(precond_matrix, mPCContext.vm_tissue_rows, mPCContext.phi_e_rows, MAT_INITIAL_MATRIX, &mPCContext.Bt_matrix_subblock);
+    ExtractSubBlock(precond_matrix, mPCContext.phi_e_rows, mPCContext.phi_e_rows, MAT_INITIAL_MATRIX, &mPCContext.A22_matrix_subblock);
+    ExtractSubBlock(precond_matrix, mPCContext.phi_e_tissue_rows, mPCContext.phi_e_tissue_rows, MAT_INITIAL_MATRIX, &mPCContext.A22_tissue_matrix_subblock);
+    if (mPCContext.has_bath)
+    {
+        ExtractSubBlock(precond_matrix, mPCContext.phi_e_bath_rows, mPCContext.phi_e_bath_rows, MAT_INITIAL_MATRIX, &mPCContext.A22_bath_matrix_subblock);
+    }
+
+    // Register call-back functions and their context
+    PCSetType(mPetscPCObject, PCSHELL);
+#if (PETSC_VERSION_MAJOR == 2 && PETSC_VERSION_MINOR == 2) //PETSc 2.2
+    PCShellSetApply(mPetscPCObject, PCTissueBathMultilevelApply, (void*) &mPCContext);
+#else
+    // Register PC context so it gets passed to PCTissueBathMultilevelApply
+    PCShellSetContext(mPetscPCObject, &mPCContext);
+
+    // Register call-back function
+    PCShellSetApply(mPetscPCObject, PCTissueBathMultilevelApply);
+#endif
+#if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 1) //PETSc 3.1 or later
+    PCShellSetSetUp(mPetscPCObject, PCTissueBathMultilevelSetUpCallback);
+#endif
+}
+
+void PCTissueBathMultilevel::PCTissueBathMultilevelSetUp()
+{
+    CreateAmgPC(mPCContext.PC_amg_A11, mPCContext.A11_matrix_subblock);
+    CreateAmgPC(mPCContext.PC_amg_A22, mPCContext.A22_matrix_subblock);
+    CreateSmootherPC(mPCContext.PC_smoother_tissue, mPCContext.A22_tissue_matrix_subblock);
+    if (mPCContext.has_bath)
+    {
+        CreateSmootherPC(mPCContext.PC_smoother_bath, mPCContext.A22_bath_matrix_subblock);
+    }
+
+    // Everything is up to date, so the set-up PETSc does when the KSP is first used is a no-op
+    mPCContext.skip_next_setup = true;
+    mPCContext.num_setups = 1;
+}
+
+void PCTissueBathMultilevel::UpdateSubBlocks(PCTissueBathMultilevelContext& rContext)
+{
+    Mat matrix = rContext.system_matrix;
+    ExtractSubBlock(matrix, rContext.vm_tissue_rows, rContext.vm_tissue_rows, MAT_REUSE_MATRIX, &rContext.A11_matrix_subblock);
+    ExtractSubBlock(matrix, rContext.phi_e_rows, rContext.vm_tissue_rows, MAT_REUSE_MATRIX, &rContext.B_matrix_subblock);
+    ExtractSubBlock(matrix, rContext.vm_tissue_rows, rContext.phi_e_rows, MAT_REUSE_MATRIX, &rContext.Bt_matrix_subblock);
+    ExtractSubBlock(matrix, rContext.phi_e_rows, rContext.phi_e_rows, MAT_REUSE_MATRIX, &rContext.A22_matrix_subblock);
+    ExtractSubBlock(matrix, rContext.phi_e_tissue_rows, rContext.phi_e_tissue_rows, MAT_REUSE_MATRIX, &rContext.A22_tissue_matrix_subblock);
+
+    SetInnerOperators(rContext.PC_amg_A11, rContext.A11_matrix_subblock);
+    SetInnerOperators(rContext.PC_amg_A22, rContext.A22_matrix_subblock);
+    SetInnerOperators(rContext.PC_smoother_tissue, rContext.A22_tissue_matrix_subblock);
+    PCSetUp(rContext.PC_amg_A11);
+    PCSetUp(rContext.PC_amg_A22);
+    PCSetUp(rContext.PC_smoother_tissue);
+
+    if (rContext.has_bath)
+    {
+        ExtractSubBlock(matrix, rContext.phi_e_bath_rows, rContext.phi_e_bath_rows, MAT_REUSE_MATRIX, &rContext.A22_bath_matrix_subblock);
+        SetInnerOperators(rContext.PC_smoother_bath, rContext.A22_bath_matrix_subblock);
+        PCSetUp(rContext.PC_smoother_bath);
+    }
+    rContext.num_setups++;
+}
+
+/**
+ * Apply the fine level (block Jacobi over the tissue and bath phi_e unknowns) of the
+ * two-level cycle.
+ *
+ * @param rContext the preconditioner state
+ * @param in a phi_e sized vector
+ * @param out the smoothed vector
+ */
+static void ApplyTissueBathSmoother(PCTissueBathMultilevel::PCTissueBathMultilevelContext& rContext, Vec in, Vec out)
+{
+    ScatterForward(rContext.phi_e_tissue_scatter_ctx, in, rContext.r2_tissue);
+    PCApply(rContext.PC_smoother_tissue, rContext.r2_tissue, rContext.w2_tissue);
+    ScatterReverse(rContext.phi_e_tissue_scatter_ctx, rContext.w2_tissue, out);
+
+    if (rContext.has_bath)
+    {
+        ScatterForward(rContext.phi_e_bath_scatter_ctx, in, rContext.r2_bath);
+        PCApply(rContext.PC_smoother_bath, rContext.r2_bath, rContext.w2_bath);
+        ScatterReverse(rContext.phi_e_bath_scatter_ctx, rContext.w2_bath, out);
+    }
+}
+
+#if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 1) //PETSc 3.1 or later
+PetscErrorCode PCTissueBathMultilevelSetUpCallback(PC pc_object)
+{
+    void* pc_context;
+    PCShellGetContext(pc_object, &pc_context);
+
+    PCTissueBathMultilevel::PCTissueBathMultilevelContext* p_context = (PCTissueBathMultilevel::PCTissueBathMultilevelContext*) pc_context;
+    assert(p_context!=nullptr);
+
+    if (p_context->skip_next_setup)
+    {
+        p_context->skip_next_setup = false;
+    }
+    else
+    {
+        PCTissueBathMultilevel::UpdateSubBlocks(*p_context);
+    }
+    return 0;
+}
+#endif
+
+#if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 1) //PETSc 3.1 or later
+PetscErrorCode PCTissueBathMultilevelApply(PC pc_object, Vec x, Vec y)
+{
+  void* pc_context;
+
+  PCShellGetContext(pc_object, &pc_context);
+#else
+PetscErrorCode PCTissueBathMultilevelApply(void* pc_context, Vec x, Vec y)
+{
+#endif
+
+    // Cast the context pointer to PCTissueBathMultilevelContext
+    PCTissueBathMultilevel::PCTissueBathMultilevelContext* p_context = (PCTissueBathMultilevel::PCTissueBathMultilevelContext*) pc_context;
+    assert(p_context!=nullptr);
+
+    /*
+     * Scatter x = [x1 xb x2]'
+     */
+    ScatterForward(p_context->vm_tissue_scatter_ctx, x, p_context->x1_subvector);
+    ScatterForward(p_context->phi_e_scatter_ctx, x, p_context->x2_subvector);
+
+    // z  = inv(A11)*x1
+    PCApply(p_context->PC_amg_A11, p_context->x1_subvector, p_context->z);
+
+    // r2 = x2 - B*z
+    MatMult(p_context->B_matrix_subblock, p_context->z, p_context->temp2);
+    VecWAXPY(p_context->r2, -1.0, p_context->temp2, p_context->x2_subvector);
+
+    /*
+     * y2 = inv(A22)*r2 by one two-level cycle
+     */
+    // pre-smooth: y2 = S*r2
+    ApplyTissueBathSmoother(*p_context, p_context->r2, p_context->y2_subvector);
+
+    // coarse correction: y2 += inv_amg(A22)*(r2 - A22*y2)
+    MatMult(p_context->A22_matrix_subblock, p_context->y2_subvector, p_context->temp2);
+    VecAYPX(p_context->temp2, -1.0, p_context->r2);
+    PCApply(p_context->PC_amg_A22, p_context->temp2, p_context->w2);
+    VecAXPY(p_context->y2_subvector, 1.0, p_context->w2);
+
+    // post-smooth: y2 += S*(r2 - A22*y2)
+    MatMult(p_context->A22_matrix_subblock, p_context->y2_subvector, p_context->temp2);
+    VecAYPX(p_context->temp2, -1.0, p_context->r2);
+    ApplyTissueBathSmoother(*p_context, p_context->temp2, p_context->w2);
+    VecAXPY(p_context->y2_subvector, 1.0, p_context->w2);
+
+    // y1 = z - inv(A11)(B'*y2)
+    MatMult(p_context->Bt_matrix_subblock, p_context->y2_subvector, p_context->temp1);
+    PCApply(p_context->PC_amg_A11, p_context->temp1, p_context->y1_subvector);
+    VecAYPX(p_context->y1_subvector, -1.0, p_context->z);
+
+    /*
+     * Gather y = [y1 yb y2]', with yb = xb for the dummy identity equations
+     */
+    ScatterReverse(p_context->vm_tissue_scatter_ctx, p_context->y1_subvector, y);
+    ScatterReverse(p_context->phi_e_scatter_ctx, p_context->y2_subvector, y);
+    if (p_context->has_bath)
+    {
+        ScatterForward(p_context->vm_bath_scatter_ctx, x, p_context->xb_subvector);
+        ScatterReverse(p_context->vm_bath_scatter_ctx, p_context->xb_subvector, y);
+    }
+
+    return 0;
+}
@@ -0,0 +1,212 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef PCTISSUEBATHMULTILEVEL_HPP_
+#define PCTISSUEBATHMULTILEVEL_HPP_
+
+#include <cassert>
+#include <vector>
+#include <petscvec.h>
+#include <petscmat.h>
+#include <petscksp.h>
+#include <petscpc.h>
+#include "PetscTools.hpp"
+
+/**
+ * PETSc will return the control to this function everytime it needs to precondition a vector (i.e. y = inv(M)*x)
+ *
+ * @param pc_context preconditioner context struct. Stores preconditioner state (i.e. PC, Mat, and Vec objects used)
+ * @param x unpreconditioned residual.
+ * @param y preconditioned residual. y = inv(M)*x
+ */
+#if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 1) //PETSc 3.1 or later
+PetscErrorCode PCTissueBathMultilevelApply(PC pc_context, Vec x, Vec y);
+#else
+PetscErrorCode PCTissueBathMultilevelApply(void* pc_context, Vec x, Vec y);
+#endif
+
+#if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 1) //PETSc 3.1 or later
+/**
+ * PETSc will return the control to this function when the preconditioner needs to be rebuilt
+ * because the system matrix has changed (see KSPSetReusePreconditioner). The sub-blocks are
+ * refreshed in place and the inner preconditioners rebuilt; index sets, scatters and work
+ * vectors are reused.
+ *
+ * @param pc_object the shell preconditioner
+ */
+PetscErrorCode PCTissueBathMultilevelSetUpCallback(PC pc_object);
+#endif
+
+/**
+ *  This class defines a PETSc-compliant purpose-built preconditioner for bidomain problems
+ *  with a perfusing bath.
+ *
+ *  With Vm and phi_e interleaved, the rows of the bidomain-with-bath matrix split into
+ *  Vm at tissue nodes (t), Vm at bath nodes (b, dummy identity equations) and phi_e at
+ *  every node (e). Up to the identity rows the matrix is
+ *
+ *                 A = (A11  B')
+ *                     (B  A22)
+ *
+ *  with A11 the tissue Vm block and A22 the phi_e block, which couples the tissue and the
+ *  bath. The preconditioner follows the approximate LDU factorisation of PCLDUFactorisation
+ *
+ *                 z  = inv(A11)*x1
+ *                 y2 = inv(A22)*(x2 - B*z)
+ *                 y1 = z - inv(A11)(B'*y2)
+ *
+ *  where inv(A11) is one AMG cycle on the tissue Vm block only, and inv(A22) is a symmetric
+ *  two-level cycle built on the tissue/bath decomposition of the phi_e unknowns:
+ *
+ *                 w  = S*r                       (fine level: block Jacobi over tissue and bath)
+ *                 w += inv_amg(A22)*(r - A22*w)  (coarse level: one AMG cycle on the whole of A22)
+ *                 w += S*(r - A22*w)
+ *
+ *  with S = diag(inv(A22_tissue), inv(A22_bath)), each approximated by block Jacobi/ILU. The
+ *  smoother resolves the jump in conductivity between tissue and bath, while the AMG cycle
+ *  provides the global coupling.
+ *
+ *  All index sets, scatters, work vectors and sub-matrix structures are created once. When
+ *  the system matrix changes and PETSc asks for a new preconditioner, the sub-blocks are
+ *  refreshed in place (MAT_REUSE_MATRIX) and only the inner preconditioners are rebuilt.
+ *
+ *  Note: This class requires PETSc to be built including the HYPRE library for the AMG cycles.
+ *  If it's not available, a warning is given and PETSc's default preconditioner (bjacobi
+ *  at the time of writing this) is used instead.
+ */
+class PCTissueBathMultilevel
+{
+public:
+
+    /**
+     * This struct defines the state of the preconditioner (initialised data and objects to be reused).
+     */
+    typedef struct{
+        Mat system_matrix; /**< The matrix the sub-blocks are extracted from (not owned)*/
+        bool has_bath; /**< Whether there are any bath nodes at all*/
+        bool skip_next_setup; /**< Whether the next set-up call back can be skipped (the sub-blocks are up to date)*/
+
+        IS vm_tissue_rows; /**< Locally owned rows of Vm at tissue nodes*/
+        IS vm_bath_rows; /**< Locally owned rows of Vm at bath nodes*/
+        IS phi_e_rows; /**< Locally owned rows of phi_e*/
+        IS phi_e_tissue_rows; /**< Locally owned rows of phi_e at tissue nodes*/
+        IS phi_e_bath_rows; /**< Locally owned rows of phi_e at bath nodes*/
+
+        Mat A11_matrix_subblock; /**< Tissue Vm block*/
+        Mat B_matrix_subblock; /**< phi_e rows, tissue Vm columns*/
+        Mat Bt_matrix_subblock; /**< Tissue Vm rows, phi_e columns*/
+        Mat A22_matrix_subblock; /**< phi_e block*/
+        Mat A22_tissue_matrix_subblock; /**< phi_e block restricted to tissue nodes*/
+        Mat A22_bath_matrix_subblock; /**< phi_e block restricted to bath nodes*/
+
+        PC PC_amg_A11; /**< inv(A11) is approximated by an AMG cycle*/
+        PC PC_amg_A22; /**< Coarse level of inv(A22): an AMG cycle on the whole phi_e block*/
+        PC PC_smoother_tissue; /**< Fine level of inv(A22) on the tissue nodes*/
+        PC PC_smoother_bath; /**< Fine level of inv(A22) on the bath nodes*/
+
+        Vec x1_subvector; /**< Vm at tissue nodes (input)*/
+        Vec y1_subvector; /**< Vm at tissue nodes (output)*/
+        Vec xb_subvector; /**< Vm at bath nodes (copied straight through)*/
+        Vec x2_subvector; /**< phi_e (input)*/
+        Vec y2_subvector; /**< phi_e (output)*/
+        Vec z; /**< Used to store intermediate results of Vm size*/
+        Vec temp1; /**< Used to store intermediate results of Vm size*/
+        Vec r2; /**< Used to store intermediate results of phi_e size*/
+        Vec w2; /**< Used to store intermediate results of phi_e size*/
+        Vec temp2; /**< Used to store intermediate results of phi_e size*/
+        Vec r2_tissue; /**< Tissue part of a phi_e sized vector*/
+        Vec w2_tissue; /**< Tissue part of a phi_e sized vector*/
+        Vec r2_bath; /**< Bath part of a phi_e sized vector*/
+        Vec w2_bath; /**< Bath part of a phi_e sized vector*/
+
+        VecScatter vm_tissue_scatter_ctx; /**< Gather x1 from x and scatter y1 back into y*/
+        VecScatter vm_bath_scatter_ctx; /**< Gather xb from x and scatter it back into y*/
+        VecScatter phi_e_scatter_ctx; /**< Gather x2 from x and scatter y2 back into y*/
+        VecScatter phi_e_tissue_scatter_ctx; /**< Split a phi_e sized vector into its tissue part*/
+        VecScatter phi_e_bath_scatter_ctx; /**< Split a phi_e sized vector into its bath part*/
+
+        unsigned num_setups; /**< Number of times the inner preconditioners have been built*/
+    } PCTissueBathMultilevelContext;
+
+    PCTissueBathMultilevelContext mPCContext; /**< PC context, this will be passed to PCTissueBathMultilevelApply when PETSc returns control to our preconditioner subroutine.  See PCShellSetContext().*/
+    PC mPetscPCObject;/**< Generic PETSc preconditioner object */
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param rKspObject KSP object where we want to install the preconditioner.
+     * @param rBathNodes the global indices of the bath nodes. Either all of them or just the
+     *     locally owned ones may be given; only the locally owned ones are used.
+     */
+    PCTissueBathMultilevel(KSP& rKspObject, std::vector<PetscInt>& rBathNodes);
+
+    /**
+     * Destructor.
+     */
+    ~PCTissueBathMultilevel();
+
+    /**
+     * @return the number of times the inner preconditioners have been built (the initial
+     * set-up plus any rebuilds requested by PETSc after the matrix changed)
+     */
+    unsigned GetNumSetUps() const;
+
+    /**
+     * Refresh the sub-blocks from the (changed) system matrix, reusing their structure, and
+     * rebuild the inner preconditioners.
+     *
+     * @param rContext the preconditioner state
+     */
+    static void UpdateSubBlocks(PCTissueBathMultilevelContext& rContext);
+
+private:
+
+    /**
+     * Creates all the state data required by the preconditioner.
+     *
+     * @param rKspObject KSP object where we want to install the preconditioner.
+     * @param rBathNodes the global indices of the bath nodes
+     */
+    void PCTissueBathMultilevelCreate(KSP& rKspObject, std::vector<PetscInt>& rBathNodes);
+
+    /**
+     * Setups preconditioner.
+     */
+    void PCTissueBathMultilevelSetUp();
+};
+
+#endif /*PCTISSUEBATHMULTILEVEL_HPP_*/
@@ -115,13 +115,13 @@ void PCTwoLevelsBlockDiagonal::PCTwoLevelsBlockDiagonalCreate(KSP& rKspObject, s
 
     // Define IS objects that will be used throughout the method
     IS A11_all_rows;
-    ISCreateStride(PETSC_COMM_WORLD, num_rows/2, 0, 2, &A11_all_rows);
+    ISCreateStride(PetscTools::GetWorld(), num_rows/2, 0, 2, &A11_all_rows);
 
     IS A22_all_rows;
     PetscInt A22_size;
     VecGetSize(mPCContext.x1_subvector, &A22_size);
     /// \todo: #1082 assert size(x1) = size(x21) + size(x22)
-    ISCreateStride(PETSC_COMM_WORLD, A22_size, 1, 2, &A22_all_rows);
+    ISCreateStride(PetscTools::GetWorld(), A22_size, 1, 2, &A22_all_rows);
 
     IS A22_bath_rows;
     PetscInt* phi_e_bath_rows = new PetscInt[rBathNodes.size()];
@@ -130,9 +130,9 @@ void PCTwoLevelsBlockDiagonal::PCTwoLevelsBlockDiagonalCreate(KSP& rKspObject, s
         phi_e_bath_rows[index] = 2*rBathNodes[index] + 1;
     }
 #if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 2) //PETSc 3.2 or later
-    ISCreateGeneral(PETSC_COMM_WORLD, rBathNodes.size(), phi_e_bath_rows, PETSC_USE_POINTER, &A22_bath_rows);
+    ISCreateGeneral(PetscTools::GetWorld(), rBathNodes.size(), phi_e_bath_rows, PETSC_USE_POINTER, &A22_bath_rows);
  #else
-    ISCreateGeneralWithArray(PETSC_COMM_WORLD, rBathNodes.size(), phi_e_bath_rows, &A22_bath_rows);
+    ISCreateGeneralWithArray(PetscTools::GetWorld(), rBathNodes.size(), phi_e_bath_rows, &A22_bath_rows);
 #endif
 
     IS A22_tissue_rows;
@@ -149,13 +149,13 @@ void PCTwoLevelsBlockDiagonal::PCTwoLevelsBlockDiagonalCreate(KSP& rKspObject, s
         IS& A22_B2_rows=A22_bath_rows;
 
         IS all_vector;
-        ISCreateStride(PETSC_COMM_WORLD, num_rows/2, 0, 1, &all_vector);
+        ISCreateStride(PetscTools::GetWorld(), num_rows/2, 0, 1, &all_vector);
 
         IS tissue_vector;
-        ISCreateStride(PETSC_COMM_WORLD, (num_rows/2)-rBathNodes.size(), 0, 1, &tissue_vector);
+        ISCreateStride(PetscTools::GetWorld(), (num_rows/2)-rBathNodes.size(), 0, 1, &tissue_vector);
 
         IS bath_vector;
-        ISCreateStride(PETSC_COMM_WORLD, rBathNodes.size(), 0, 1, &bath_vector);
+        ISCreateStride(PetscTools::GetWorld(), rBathNodes.size(), 0, 1, &bath_vector);
 
         VecScatterCreate(dummy_vec, A11_rows, mPCContext.x1_subvector, all_vector, &mPCContext.A11_scatter_ctx);
         VecScatterCreate(dummy_vec, A22_B1_rows, mPCContext.x21_subvector, tissue_vector, &mPCContext.A22_B1_scatter_ctx);
@@ -178,7 +178,7 @@ void PCTwoLevelsBlockDiagonal::PCTwoLevelsBlockDiagonalCreate(KSP& rKspObject, s
 
         IS A11_local_rows;
         IS& A11_columns=A11_all_rows;
-        ISCreateStride(PETSC_COMM_WORLD, high-low, 2*low, 2, &A11_local_rows); /// \todo: #1082 OK in parallel. Use as an example for the other two blocks
+        ISCreateStride(PetscTools::GetWorld(), high-low, 2*low, 2, &A11_local_rows); /// \todo: #1082 OK in parallel. Use as an example for the other two blocks
 
 #if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 8) //PETSc 3.8 or later
         MatCreateSubMatrix(system_matrix, A11_local_rows, A11_columns,
@@ -261,7 +261,7 @@ void PCTwoLevelsBlockDiagonal::PCTwoLevelsBlockDiagonalSetUp()
     PetscTools::SetOption("-pc_hypre_type", "boomeramg");
 
     // Set up amg preconditioner for block A11
-    PCCreate(PETSC_COMM_WORLD, &(mPCContext.PC_amg_A11));
+    PCCreate(PetscTools::GetWorld(), &(mPCContext.PC_amg_A11));
     PCSetType(mPCContext.PC_amg_A11, PCBJACOBI);
 #if (PETSC_VERSION_MAJOR==3 && PETSC_VERSION_MINOR>=5)
     PCSetOperators(mPCContext.PC_amg_A11, mPCContext.A11_matrix_subblock, mPCContext.A11_matrix_subblock);
@@ -272,7 +272,7 @@ void PCTwoLevelsBlockDiagonal::PCTwoLevelsBlockDiagonalSetUp()
     PCSetUp(mPCContext.PC_amg_A11);
 
     // Set up amg preconditioner for block A22_B1
-    PCCreate(PETSC_COMM_WORLD, &(mPCContext.PC_amg_A22_B1));
+    PCCreate(PetscTools::GetWorld(), &(mPCContext.PC_amg_A22_B1));
     PCSetType(mPCContext.PC_amg_A22_B1, PCBJACOBI);
 #if (PETSC_VERSION_MAJOR==3 && PETSC_VERSION_MINOR>=5)
     PCSetOperators(mPCContext.PC_amg_A22_B1, mPCContext.A22_B1_matrix_subblock, mPCContext.A22_B1_matrix_subblock);
@@ -283,7 +283,7 @@ void PCTwoLevelsBlockDiagonal::PCTwoLevelsBlockDiagonalSetUp()
     PCSetUp(mPCContext.PC_amg_A22_B1);
 
     // Set up amg preconditioner for block A22_B2
-    PCCreate(PETSC_COMM_WORLD, &(mPCContext.PC_amg_A22_B2));
+    PCCreate(PetscTools::GetWorld(), &(mPCContext.PC_amg_A22_B2));
     PCSetType(mPCContext.PC_amg_A22_B2, PCHYPRE);
     //PCHYPRESetType(mPCContext.PC_amg_A22_B2, "boomeramg");
     PetscTools::SetOption("-pc_hypre_type", "boomeramg");
@@ -0,0 +1,223 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "PetscMatSlotMap.hpp"
+#include <algorithm>
+#include "PetscTools.hpp"
+
+namespace
+{
+/**
+ * @return the position of a column within one row of a compressed row storage
+ * structure, or -1 if the row does not contain it.
+ *
+ * @param pRowStarts  the row start positions
+ * @param pColumns  the (sorted) column indices of each row
+ * @param row  the local row
+ * @param col  the column to find
+ */
+PetscInt FindInRow(const PetscInt* pRowStarts, const PetscInt* pColumns, PetscInt row, PetscInt col)
+{
+    const PetscInt* p_begin = pColumns + pRowStarts[row];
+    const PetscInt* p_end = pColumns + pRowStarts[row+1];
+    const PetscInt* p_found = std::lower_bound(p_begin, p_end, col);
+    if (p_found == p_end || *p_found != col)
+    {
+        return -1;
+    }
+    return static_cast<PetscInt>(p_found - pColumns);
+}
+}
+
+PetscMatSlotMap::PetscMatSlotMap(Mat matrix, const std::vector<PetscInt>& rStencilIndices, unsigned stencilSize)
+    : mMatrix(matrix),
+      mDiagonalBlock(NULL),
+      mOffDiagonalBlock(NULL),
+      mStencilSize(stencilSize),
+      mIsValid(false),
+      mpDiagonalValues(NULL),
+      mpOffDiagonalValues(NULL)
+{
+    assert(stencilSize > 0);
+    assert(rStencilIndices.size() % stencilSize == 0);
+
+#if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 5) //PETSc 3.5 or later
+    PetscBool is_seq_aij, is_mpi_aij, is_assembled;
+    PetscObjectTypeCompare((PetscObject) matrix, MATSEQAIJ, &is_seq_aij);
+    PetscObjectTypeCompare((PetscObject) matrix, MATMPIAIJ, &is_mpi_aij);
+    MatAssembled(matrix, &is_assembled);
+    if (!(is_seq_aij || is_mpi_aij) || !is_assembled)
+    {
+        return;
+    }
+
+    PetscInt lo, hi;
+    MatGetOwnershipRange(matrix, &lo, &hi);
+    PetscInt col_lo, col_hi;
+    MatGetOwnershipRangeColumn(matrix, &col_lo, &col_hi);
+
+    // In the MPI case the off-diagonal block's columns are compressed, and
+    // p_off_diagonal_columns maps them back to (sorted) global columns
+    const PetscInt* p_off_diagonal_columns = NULL;
+    PetscInt num_off_diagonal_columns = 0;
+    if (is_mpi_aij)
+    {
+        MatMPIAIJGetSeqAIJ(matrix, &mDiagonalBlock, &mOffDiagonalBlock, &p_off_diagonal_columns);
+        PetscInt num_rows;
+        MatGetSize(mOffDiagonalBlock, &num_rows, &num_off_diagonal_columns);
+    }
+    else
+    {
+        mDiagonalBlock = matrix;
+    }
+
+    PetscInt num_local_rows;
+    const PetscInt* p_row_starts;
+    const PetscInt* p_columns;
+    PetscBool done;
+    MatGetRowIJ(mDiagonalBlock, 0, PETSC_FALSE, PETSC_FALSE, &num_local_rows, &p_row_starts, &p_columns, &done);
+    if (!done)
+    {
+        return;
+    }
+    const PetscInt* p_off_row_starts = NULL;
+    const PetscInt* p_off_columns = NULL;
+    if (mOffDiagonalBlock)
+    {
+        PetscInt num_off_rows;
+        MatGetRowIJ(mOffDiagonalBlock, 0, PETSC_FALSE, PETSC_FALSE, &num_off_rows, &p_off_row_starts, &p_off_columns, &done);
+        if (!done)
+        {
+            MatRestoreRowIJ(mDiagonalBlock, 0, PETSC_FALSE, PETSC_FALSE, &num_local_rows, &p_row_starts, &p_columns, &done);
+            return;
+        }
+    }
+
+    const unsigned num_stencils = rStencilIndices.size()/stencilSize;
+    mSlots.resize(rStencilIndices.size()*stencilSize);
+    bool all_found = true;
+    unsigned slot_index = 0;
+    for (unsigned stencil=0; stencil<num_stencils && all_found; stencil++)
+    {
+        const PetscInt* p_indices = &rStencilIndices[stencil*stencilSize];
+        for (unsigned row=0; row<stencilSize && all_found; row++)
+        {
+            const PetscInt global_row = p_indices[row];
+            for (unsigned col=0; col<stencilSize && all_found; col++)
+            {
+                PetscInt slot = -1;
+                if (global_row >= lo && global_row < hi)
+                {
+                    const PetscInt global_col = p_indices[col];
+                    PetscInt position = -1;
+                    if (global_col >= col_lo && global_col < col_hi)
+                    {
+                        position = FindInRow(p_row_starts, p_columns, global_row-lo, global_col-col_lo);
+                        slot = 2*position;
+                    }
+                    else if (mOffDiagonalBlock)
+                    {
+                        const PetscInt* p_end = p_off_diagonal_columns + num_off_diagonal_columns;
+                        const PetscInt* p_found = std::lower_bound(p_off_diagonal_columns, p_end, global_col);
+                        if (p_found != p_end && *p_found == global_col)
+                        {
+                            position = FindInRow(p_off_row_starts, p_off_columns, global_row-lo, static_cast<PetscInt>(p_found-p_off_diagonal_columns));
+                            slot = 2*position + 1;
+                        }
+                    }
+                    all_found = (position >= 0);
+                }
+                mSlots[slot_index++] = slot;
+            }
+        }
+    }
+
+    MatRestoreRowIJ(mDiagonalBlock, 0, PETSC_FALSE, PETSC_FALSE, &num_local_rows, &p_row_starts, &p_columns, &done);
+    if (mOffDiagonalBlock)
+    {
+        PetscInt num_off_rows;
+        MatRestoreRowIJ(mOffDiagonalBlock, 0, PETSC_FALSE, PETSC_FALSE, &num_off_rows, &p_off_row_starts, &p_off_columns, &done);
+    }
+
+    mIsValid = all_found;
+    if (!mIsValid)
+    {
+        std::vector<PetscInt>().swap(mSlots);
+    }
+#endif
+}
+
+bool PetscMatSlotMap::IsValid() const
+{
+    return mIsValid;
+}
+
+Mat PetscMatSlotMap::GetMatrix() const
+{
+    return mMatrix;
+}
+
+unsigned PetscMatSlotMap::GetNumStencils() const
+{
+    return mSlots.size()/(mStencilSize*mStencilSize);
+}
+
+void PetscMatSlotMap::BeginAdding()
+{
+    assert(mIsValid);
+#if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 5) //PETSc 3.5 or later
+    MatSeqAIJGetArray(mDiagonalBlock, &mpDiagonalValues);
+    if (mOffDiagonalBlock)
+    {
+        MatSeqAIJGetArray(mOffDiagonalBlock, &mpOffDiagonalValues);
+    }
+#endif
+}
+
+void PetscMatSlotMap::EndAdding()
+{
+    assert(mIsValid);
+#if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 5) //PETSc 3.5 or later
+    MatSeqAIJRestoreArray(mDiagonalBlock, &mpDiagonalValues);
+    if (mOffDiagonalBlock)
+    {
+        MatSeqAIJRestoreArray(mOffDiagonalBlock, &mpOffDiagonalValues);
+    }
+    // The blocks know they have changed, but the parallel matrix does not
+    PetscObjectStateIncrease((PetscObject) mMatrix);
+#endif
+    mpDiagonalValues = NULL;
+    mpOffDiagonalValues = NULL;
+}
@@ -0,0 +1,162 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef _PETSCMATSLOTMAP_HPP_
+#define _PETSCMATSLOTMAP_HPP_
+
+#include "UblasMatrixInclude.hpp" // needs to be 'first'
+#include <cassert>
+#include <vector>
+#include <petscmat.h>
+
+/**
+ * Precomputed positions ('slots') of a set of small dense stencils, such as
+ * finite element matrices, within the value arrays of an assembled AIJ matrix.
+ *
+ * Once the nonzero structure of a matrix is fixed, re-assembling it does not
+ * need MatSetValues(): each stencil entry can be added straight into the
+ * compressed row storage of the locally owned rows at a position that was
+ * looked up once. Entries in rows owned by other processes are skipped, as in
+ * PetscMatTools::AddMultipleValues(), since the owning process adds them
+ * from its own copy of the stencil.
+ *
+ * Only MATSEQAIJ and MATMPIAIJ matrices are supported. If the matrix is of
+ * another type, is not assembled, or does not already contain every stencil
+ * entry, IsValid() returns false and the caller should use MatSetValues() as
+ * usual.
+ */
+class PetscMatSlotMap
+{
+private:
+    /** The matrix the slots refer to. */
+    Mat mMatrix;
+
+    /** The locally owned diagonal block (the matrix itself for MATSEQAIJ). */
+    Mat mDiagonalBlock;
+
+    /** The locally owned off-diagonal block (NULL for MATSEQAIJ). */
+    Mat mOffDiagonalBlock;
+
+    /** Number of rows (and columns) in each stencil. */
+    unsigned mStencilSize;
+
+    /**
+     * For each stencil entry, in stencil then row-major order: 2*k for position
+     * k of the diagonal block's values, 2*k+1 for position k of the off-diagonal
+     * block's values, or -1 if the row is not owned by this process.
+     */
+    std::vector<PetscInt> mSlots;
+
+    /** Whether every stencil entry was found in the matrix. */
+    bool mIsValid;
+
+    /** Values of the diagonal block, between BeginAdding() and EndAdding(). */
+    PetscScalar* mpDiagonalValues;
+
+    /** Values of the off-diagonal block, between BeginAdding() and EndAdding(). */
+    PetscScalar* mpOffDiagonalValues;
+
+public:
+    /**
+     * Look up the slots of the given stencils in an assembled matrix.
+     *
+     * @param matrix  the matrix, whose nonzero structure must not change while this object is used
+     * @param rStencilIndices  the global row (and column) indices of each stencil, one after the other
+     * @param stencilSize  the number of indices in each stencil
+     */
+    PetscMatSlotMap(Mat matrix, const std::vector<PetscInt>& rStencilIndices, unsigned stencilSize);
+
+    /**
+     * @return whether every stencil entry has a slot, so this map may be used.
+     */
+    bool IsValid() const;
+
+    /**
+     * @return the matrix the slots refer to.
+     */
+    Mat GetMatrix() const;
+
+    /**
+     * @return the number of stencils.
+     */
+    unsigned GetNumStencils() const;
+
+    /**
+     * Get access to the matrix values. Must be called before AddStencil().
+     */
+    void BeginAdding();
+
+    /**
+     * Add a small dense matrix into the entries of one stencil.
+     *
+     * @param stencilIndex  the index of the stencil, in the order given to the constructor
+     * @param rSmallMatrix  the values to add
+     */
+    template<size_t MATRIX_SIZE>
+    void AddStencil(unsigned stencilIndex, const c_matrix<double, MATRIX_SIZE, MATRIX_SIZE>& rSmallMatrix)
+    {
+        assert(mIsValid && mpDiagonalValues);
+        assert(MATRIX_SIZE == mStencilSize);
+        assert(stencilIndex < GetNumStencils());
+
+        const PetscInt* p_slots = &mSlots[stencilIndex*MATRIX_SIZE*MATRIX_SIZE];
+        for (unsigned row=0; row<MATRIX_SIZE; row++)
+        {
+            for (unsigned col=0; col<MATRIX_SIZE; col++)
+            {
+                const PetscInt slot = *(p_slots++);
+                if (slot >= 0)
+                {
+                    if (slot % 2 == 0)
+                    {
+                        mpDiagonalValues[slot/2] += rSmallMatrix(row, col);
+                    }
+                    else
+                    {
+                        mpOffDiagonalValues[slot/2] += rSmallMatrix(row, col);
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * Give back access to the matrix values. The matrix should be finalised
+     * afterwards, as after MatSetValues().
+     */
+    void EndAdding();
+};
+
+#endif // _PETSCMATSLOTMAP_HPP_
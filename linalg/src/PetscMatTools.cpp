@@ -134,7 +134,7 @@ void PetscMatTools::ZeroRowsWithValueOnDiagonal(Mat matrix, std::vector<unsigned
     }
 #if (PETSC_VERSION_MAJOR == 2 && PETSC_VERSION_MINOR == 2) //PETSc 2.2
     IS is;
-    ISCreateGeneral(PETSC_COMM_WORLD, rRows.size(), rows, &is);
+    ISCreateGeneral(PetscTools::GetWorld(), rRows.size(), rows, &is);
     MatZeroRows(matrix, is, &diagonalValue);
     ISDestroy(PETSC_DESTROY_PARAM(is));
     /*
@@ -252,6 +252,44 @@ void PetscMatTools::ZeroRowsAndColumnsWithValueOnDiagonal(Mat matrix, std::vecto
     ZeroRowsWithValueOnDiagonal(matrix, rowColIndices, diagonalValue);
 }
 
+void PetscMatTools::GetEntriesInColumns(Mat matrix, std::vector<unsigned> rowColIndices,
+                                        std::vector<unsigned>& rRows, std::vector<unsigned>& rCols, std::vector<double>& rValues)
+{
+    Finalise(matrix);
+
+    // sort the vector as we will be repeatedly searching for entries in it
+    std::sort(rowColIndices.begin(), rowColIndices.end());
+
+    rRows.clear();
+    rCols.clear();
+    rValues.clear();
+
+    PetscInt lo, hi;
+    GetOwnershipRange(matrix, lo, hi);
+    for (PetscInt row = lo; row < hi; row++)
+    {
+        if (std::binary_search(rowColIndices.begin(), rowColIndices.end(), row))
+        {
+            continue;
+        }
+
+        PetscInt num_cols;
+        const PetscInt* cols;
+        const PetscScalar* values;
+        MatGetRow(matrix, row, &num_cols, &cols, &values);
+        for (PetscInt i=0; i<num_cols; i++)
+        {
+            if (values[i] != 0.0 && std::binary_search(rowColIndices.begin(), rowColIndices.end(), cols[i]))
+            {
+                rRows.push_back(row);
+                rCols.push_back(cols[i]);
+                rValues.push_back(values[i]);
+            }
+        }
+        MatRestoreRow(matrix, row, &num_cols, &cols, &values);
+    }
+}
+
 void PetscMatTools::ZeroColumn(Mat matrix, PetscInt col)
 {
     Finalise(matrix);
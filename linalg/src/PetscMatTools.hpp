@@ -124,6 +124,22 @@ public:
      */
     static void ZeroRowsAndColumnsWithValueOnDiagonal(Mat matrix, std::vector<unsigned> rowColIndices, double diagonalValue);
 
+    /**
+     * Get the entries of the given columns which lie in locally owned rows that
+     * are not themselves in the list, as (row, column, value) triples. This is
+     * the part of the matrix that ZeroRowsAndColumnsWithValueOnDiagonal() would
+     * remove from the rows that it keeps, found with one pass over the local rows
+     * rather than one distributed vector per column.
+     *
+     * @param matrix  the matrix
+     * @param rowColIndices  the column (and row) indices, copied so that they can be sorted
+     * @param rRows  filled in with the row of each entry
+     * @param rCols  filled in with the column of each entry
+     * @param rValues  filled in with the value of each entry
+     */
+    static void GetEntriesInColumns(Mat matrix, std::vector<unsigned> rowColIndices,
+                                    std::vector<unsigned>& rRows, std::vector<unsigned>& rCols, std::vector<double>& rValues);
+
     /**
      * Zero a column of a matrix.
      *
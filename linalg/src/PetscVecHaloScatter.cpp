@@ -0,0 +1,116 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "PetscVecHaloScatter.hpp"
+#include "PetscTools.hpp"
+
+PetscVecHaloScatter::PetscVecHaloScatter(Vec templateVector, const std::vector<PetscInt>& rIndices)
+    : mHaloVector(NULL),
+      mScatter(NULL),
+      mInput(NULL),
+      mpLocalValues(NULL)
+{
+    VecGetSize(templateVector, &mSize);
+    VecGetOwnershipRange(templateVector, &mLo, &mHi);
+
+    for (std::vector<PetscInt>::const_iterator it = rIndices.begin(); it != rIndices.end(); ++it)
+    {
+        assert(*it >= 0 && *it < mSize);
+        if (*it < mLo || *it >= mHi)
+        {
+            mHaloIndices.push_back(*it);
+        }
+    }
+    std::sort(mHaloIndices.begin(), mHaloIndices.end());
+    mHaloIndices.erase(std::unique(mHaloIndices.begin(), mHaloIndices.end()), mHaloIndices.end());
+    mHaloValues.resize(mHaloIndices.size());
+
+    const PetscInt num_halo = mHaloIndices.size();
+    PetscScalar* p_halo_values = mHaloValues.empty() ? NULL : &mHaloValues[0];
+    PetscInt* p_halo_indices = mHaloIndices.empty() ? NULL : &mHaloIndices[0];
+#if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 3) //PETSc 3.3 or later
+    //Extra argument is block size
+    VecCreateSeqWithArray(PETSC_COMM_SELF, 1, num_halo, p_halo_values, &mHaloVector);
+#else
+    VecCreateSeqWithArray(PETSC_COMM_SELF, num_halo, p_halo_values, &mHaloVector);
+#endif
+
+    IS halo_is;
+#if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 2) //PETSc 3.2 or later
+    ISCreateGeneral(PETSC_COMM_SELF, num_halo, p_halo_indices, PETSC_COPY_VALUES, &halo_is);
+#else
+    ISCreateGeneral(PETSC_COMM_SELF, num_halo, p_halo_indices, &halo_is);
+#endif
+    VecScatterCreate(templateVector, halo_is, mHaloVector, NULL, &mScatter);
+    ISDestroy(PETSC_DESTROY_PARAM(halo_is));
+}
+
+PetscVecHaloScatter::~PetscVecHaloScatter()
+{
+    assert(mpLocalValues == NULL);
+    VecScatterDestroy(PETSC_DESTROY_PARAM(mScatter));
+    PetscTools::Destroy(mHaloVector);
+}
+
+bool PetscVecHaloScatter::IsCompatible(Vec vector) const
+{
+    PetscInt size, lo, hi;
+    VecGetSize(vector, &size);
+    VecGetOwnershipRange(vector, &lo, &hi);
+    return (size == mSize && lo == mLo && hi == mHi);
+}
+
+unsigned PetscVecHaloScatter::GetNumHaloEntries() const
+{
+    return mHaloIndices.size();
+}
+
+void PetscVecHaloScatter::BeginAccess(Vec input)
+{
+    assert(mpLocalValues == NULL);
+    assert(IsCompatible(input));
+    VecScatterBegin(mScatter, input, mHaloVector, INSERT_VALUES, SCATTER_FORWARD);
+    VecScatterEnd(mScatter, input, mHaloVector, INSERT_VALUES, SCATTER_FORWARD);
+    mInput = input;
+    VecGetArrayRead(mInput, &mpLocalValues);
+}
+
+void PetscVecHaloScatter::EndAccess()
+{
+    assert(mpLocalValues != NULL);
+    VecRestoreArrayRead(mInput, &mpLocalValues);
+    mpLocalValues = NULL;
+    mInput = NULL;
+}
@@ -0,0 +1,146 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef _PETSCVECHALOSCATTER_HPP_
+#define _PETSCVECHALOSCATTER_HPP_
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+#include <petscvec.h>
+
+/**
+ * Gives read access to the locally owned entries of a distributed vector,
+ * plus a fixed set of entries owned by other processes (the 'halo').
+ *
+ * The halo is given once, to the constructor, which builds a PETSc scatter
+ * that fetches just those entries. Each BeginAccess() then only
+ * communicates the halo, rather than replicating the whole vector as
+ * ReplicatableVector does, so repeated products with an operator whose
+ * stencils are mostly local (e.g. finite element matrices on a partitioned
+ * mesh) only cost communication proportional to the partition boundary.
+ *
+ * The constructor and BeginAccess() are collective.
+ */
+class PetscVecHaloScatter
+{
+private:
+    /** Global size of the vectors this scatter is for. */
+    PetscInt mSize;
+
+    /** First locally owned entry. */
+    PetscInt mLo;
+
+    /** One past the last locally owned entry. */
+    PetscInt mHi;
+
+    /** Global indices of the halo entries, sorted. */
+    std::vector<PetscInt> mHaloIndices;
+
+    /** Values of the halo entries, in the order of #mHaloIndices. */
+    std::vector<double> mHaloValues;
+
+    /** Sequential vector wrapping #mHaloValues. */
+    Vec mHaloVector;
+
+    /** Scatter from the distributed vector into #mHaloVector. */
+    VecScatter mScatter;
+
+    /** The vector being accessed, between BeginAccess() and EndAccess(). */
+    Vec mInput;
+
+    /** Its locally owned values, between BeginAccess() and EndAccess(). */
+    const PetscScalar* mpLocalValues;
+
+public:
+    /**
+     * Build the scatter.
+     *
+     * @param templateVector  a vector with the parallel layout of the vectors to be accessed
+     * @param rIndices  the global indices this process will read, in any order and possibly
+     *     repeated; those owned by this process are ignored
+     */
+    PetscVecHaloScatter(Vec templateVector, const std::vector<PetscInt>& rIndices);
+
+    /**
+     * Destructor. Frees the PETSc objects.
+     */
+    ~PetscVecHaloScatter();
+
+    /**
+     * @return whether the given vector has the parallel layout this scatter was built for.
+     *
+     * @param vector  the vector
+     */
+    bool IsCompatible(Vec vector) const;
+
+    /**
+     * @return the number of entries owned by other processes that are fetched.
+     */
+    unsigned GetNumHaloEntries() const;
+
+    /**
+     * Fetch the halo entries of a vector and get access to its local entries.
+     * Must be called before operator[]().
+     *
+     * @param input  the vector, which must have the layout of the template vector
+     */
+    void BeginAccess(Vec input);
+
+    /**
+     * @return the entry of the vector being accessed with the given global index,
+     * which must be owned by this process or be one of the halo indices.
+     *
+     * @param globalIndex  the global index
+     */
+    double operator[](PetscInt globalIndex) const
+    {
+        assert(mpLocalValues != NULL);
+        if (globalIndex >= mLo && globalIndex < mHi)
+        {
+            return mpLocalValues[globalIndex - mLo];
+        }
+        std::vector<PetscInt>::const_iterator it = std::lower_bound(mHaloIndices.begin(), mHaloIndices.end(), globalIndex);
+        assert(it != mHaloIndices.end() && *it == globalIndex);
+        return mHaloValues[it - mHaloIndices.begin()];
+    }
+
+    /**
+     * Give back access to the vector's local entries.
+     */
+    void EndAccess();
+};
+
+#endif // _PETSCVECHALOSCATTER_HPP_
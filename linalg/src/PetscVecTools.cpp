@@ -37,6 +37,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "PetscTools.hpp"
 #include <petscviewer.h>
 #include <cassert>
+#include <vector>
 #include "DistributedVectorFactory.hpp"
 #include "DistributedVector.hpp"
 #include "PetscException.hpp"
@@ -45,6 +46,65 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // Implementation
 ///////////////////////////////////////////////////////////////////////////////////
 
+namespace
+{
+/**
+ * Gives access to the local arrays of several vectors for the fused kernels below.
+ * Each distinct vector is only fetched once, so the kernels may be called with
+ * aliased arguments; all arrays are restored on destruction.
+ */
+class LocalVectorArrays
+{
+private:
+    /** The vectors whose arrays have been fetched. */
+    std::vector<Vec> mVectors;
+
+    /** The corresponding local arrays. */
+    std::vector<double*> mArrays;
+
+public:
+    /**
+     * @return the local array of a vector
+     * @param vector  the vector
+     */
+    double* Get(Vec vector)
+    {
+        for (unsigned i=0; i<mVectors.size(); i++)
+        {
+            if (mVectors[i] == vector)
+            {
+                return mArrays[i];
+            }
+        }
+        double* p_array;
+        PETSCEXCEPT( VecGetArray(vector, &p_array) );
+        mVectors.push_back(vector);
+        mArrays.push_back(p_array);
+        return p_array;
+    }
+
+    /** Destructor restores all the arrays. */
+    ~LocalVectorArrays()
+    {
+        for (unsigned i=0; i<mVectors.size(); i++)
+        {
+            VecRestoreArray(mVectors[i], &mArrays[i]);
+        }
+    }
+};
+
+/**
+ * @return the number of locally owned entries of a vector
+ * @param vector  the vector
+ */
+PetscInt GetLocalSize(Vec vector)
+{
+    PetscInt local_size;
+    VecGetLocalSize(vector, &local_size);
+    return local_size;
+}
+} // anonymous namespace
+
 void PetscVecTools::Finalise(Vec vector)
 {
     VecAssemblyBegin(vector);
@@ -62,6 +122,31 @@ void PetscVecTools::SetElement(Vec vector, PetscInt row, double value)
     }
 }
 
+void PetscVecTools::SetElements(Vec vector, const std::vector<unsigned>& rRows, const std::vector<double>& rValues)
+{
+    assert(rRows.size() == rValues.size());
+    PetscInt lo, hi;
+    GetOwnershipRange(vector, lo, hi);
+
+    std::vector<PetscInt> local_rows;
+    std::vector<double> local_values;
+    local_rows.reserve(rRows.size());
+    local_values.reserve(rRows.size());
+    for (unsigned i=0; i<rRows.size(); i++)
+    {
+        PetscInt row = rRows[i];
+        if (row >= lo && row < hi)
+        {
+            local_rows.push_back(row);
+            local_values.push_back(rValues[i]);
+        }
+    }
+    if (!local_rows.empty())
+    {
+        VecSetValues(vector, local_rows.size(), &local_rows[0], &local_values[0], INSERT_VALUES);
+    }
+}
+
 void PetscVecTools::AddToElement(Vec vector, PetscInt row, double value)
 {
     PetscInt lo, hi;
@@ -151,6 +236,58 @@ void PetscVecTools::WAXPY(Vec w, double a, Vec x, Vec y)
 #endif
 }
 
+void PetscVecTools::WAXPBY(Vec w, double a, Vec x, double b, Vec y)
+{
+    PetscInt local_size = GetLocalSize(w);
+    assert(GetLocalSize(x) == local_size);
+    assert(GetLocalSize(y) == local_size);
+
+    LocalVectorArrays arrays;
+    double* p_w = arrays.Get(w);
+    double* p_x = arrays.Get(x);
+    double* p_y = arrays.Get(y);
+    for (PetscInt i=0; i<local_size; i++)
+    {
+        p_w[i] = a*p_x[i] + b*p_y[i];
+    }
+}
+
+void PetscVecTools::WAXPBYPCZ(Vec w, double a, Vec x, double b, Vec y, double c, Vec z)
+{
+    PetscInt local_size = GetLocalSize(w);
+    assert(GetLocalSize(x) == local_size);
+    assert(GetLocalSize(y) == local_size);
+    assert(GetLocalSize(z) == local_size);
+
+    LocalVectorArrays arrays;
+    double* p_w = arrays.Get(w);
+    double* p_x = arrays.Get(x);
+    double* p_y = arrays.Get(y);
+    double* p_z = arrays.Get(z);
+    for (PetscInt i=0; i<local_size; i++)
+    {
+        p_w[i] = a*p_x[i] + b*p_y[i] + c*p_z[i];
+    }
+}
+
+void PetscVecTools::PointwiseMultAndAdd(Vec w, double a, Vec d, Vec x, Vec y)
+{
+    PetscInt local_size = GetLocalSize(w);
+    assert(GetLocalSize(d) == local_size);
+    assert(GetLocalSize(x) == local_size);
+    assert(GetLocalSize(y) == local_size);
+
+    LocalVectorArrays arrays;
+    double* p_w = arrays.Get(w);
+    double* p_d = arrays.Get(d);
+    double* p_x = arrays.Get(x);
+    double* p_y = arrays.Get(y);
+    for (PetscInt i=0; i<local_size; i++)
+    {
+        p_w[i] = p_y[i] + a*p_d[i]*p_x[i];
+    }
+}
+
 void PetscVecTools::SetupInterleavedVectorScatterGather(Vec interleavedVec, VecScatter& rFirstVariableScatterContext, VecScatter& rSecondVariableScatterContext)
 {
     PetscInt num_rows, num_local_rows;
@@ -159,11 +296,11 @@ void PetscVecTools::SetupInterleavedVectorScatterGather(Vec interleavedVec, VecS
     VecGetLocalSize(interleavedVec, &num_local_rows);
 
     IS A11_rows, A22_rows;
-    ISCreateStride(PETSC_COMM_WORLD, num_rows/2, 0, 2, &A11_rows);
-    ISCreateStride(PETSC_COMM_WORLD, num_rows/2, 1, 2, &A22_rows);
+    ISCreateStride(PetscTools::GetWorld(), num_rows/2, 0, 2, &A11_rows);
+    ISCreateStride(PetscTools::GetWorld(), num_rows/2, 1, 2, &A22_rows);
 
     IS all_vector;
-    ISCreateStride(PETSC_COMM_WORLD, num_rows/2, 0, 1, &all_vector);
+    ISCreateStride(PetscTools::GetWorld(), num_rows/2, 0, 1, &all_vector);
 
     unsigned subvector_num_rows = num_rows/2;
     unsigned subvector_local_rows = num_local_rows/2;
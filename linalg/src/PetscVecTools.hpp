@@ -39,6 +39,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "UblasVectorInclude.hpp" // needs to be 'first'
 
 #include <petscvec.h>
+#include <vector>
 
 /**
  * A collection of static methods for working with PETSc vectors.
@@ -77,6 +78,16 @@ public:
      */
     static void SetElement(Vec vector, PetscInt row, double value);
 
+    /**
+     * Set several elements of a vector in one call. Rows not owned by this
+     * process are ignored, as in SetElement().
+     *
+     * @param vector  the vector to modify
+     * @param rRows  the row indices
+     * @param rValues  the value to set at each row
+     */
+    static void SetElements(Vec vector, const std::vector<unsigned>& rRows, const std::vector<double>& rValues);
+
     /**
      * Add a value to an element of a vector.
      *
@@ -137,6 +148,47 @@ public:
      */
     static void WAXPY(Vec w, double a, Vec x, Vec y);
 
+    /**
+     * Computes w = ax + by in a single pass over the local entries, instead of
+     * a VecWAXPY followed by a VecScale. Any of the vectors may be aliased.
+     *
+     * @param w the result vector
+     * @param a the factor x is multiplied by
+     * @param x the first vector
+     * @param b the factor y is multiplied by
+     * @param y the second vector
+     */
+    static void WAXPBY(Vec w, double a, Vec x, double b, Vec y);
+
+    /**
+     * Computes w = ax + by + cz in a single pass over the local entries, instead of
+     * a VecCopy followed by a VecAXPBYPCZ. Any of the vectors may be aliased, so
+     * passing w == z gives the in-place update z = ax + by + cz.
+     *
+     * @param w the result vector
+     * @param a the factor x is multiplied by
+     * @param x the first vector
+     * @param b the factor y is multiplied by
+     * @param y the second vector
+     * @param c the factor z is multiplied by
+     * @param z the third vector
+     */
+    static void WAXPBYPCZ(Vec w, double a, Vec x, double b, Vec y, double c, Vec z);
+
+    /**
+     * Computes w = y + a*(d.*x), where .* is the pointwise product, in a single pass over the
+     * local entries. This is typically used to scale by a precomputed (inverse lumped) mass
+     * diagonal d and add the result to another vector, which would otherwise need a
+     * VecPointwiseMult and a VecAXPY/VecAYPX. Any of the vectors may be aliased.
+     *
+     * @param w the result vector
+     * @param a the scale factor
+     * @param d the diagonal vector
+     * @param x the vector multiplied pointwise by d
+     * @param y the vector added to
+     */
+    static void PointwiseMultAndAdd(Vec w, double a, Vec d, Vec x, Vec y);
+
     /**
      * Add multiple values to a vector.
      *
@@ -68,7 +68,7 @@ Vec SimplePetscNonlinearSolver::Solve(PetscErrorCode (*pComputeResidual)(SNES,Ve
     // Note that the Jacobian matrix might involve new non-zero elements in the course of a SNES solve
     PetscTools::SetupMat(jacobian, N, N, fill, PETSC_DECIDE, PETSC_DECIDE, true, false /*malloc flag*/);
 
-    SNESCreate(PETSC_COMM_WORLD, &snes);
+    SNESCreate(PetscTools::GetWorld(), &snes);
 
     SNESSetFunction(snes, residual, pComputeResidual, pContext);
     SNESSetJacobian(snes, jacobian, jacobian, pComputeJacobian, pContext);
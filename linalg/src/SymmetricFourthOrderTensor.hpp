@@ -0,0 +1,265 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef _SYMMETRICFOURTHORDERTENSOR_HPP_
+#define _SYMMETRICFOURTHORDERTENSOR_HPP_
+
+#include <cassert>
+
+#include "UblasIncludes.hpp"
+#include "FourthOrderTensor.hpp"
+
+/**
+ * SymmetricFourthOrderTensor
+ *
+ * A fourth order tensor over DIM dimensions with the minor symmetries
+ * D_{MNPQ} = D_{NMPQ} = D_{MNQP}, as satisfied by stress derivatives dT/dE
+ * (T and E both being symmetric). It is stored in Voigt form, as a
+ * DIM(DIM+1)/2 by DIM(DIM+1)/2 matrix, ie 36 rather than 81 components in 3D.
+ *
+ * Major symmetry (D_{MNPQ} = D_{PQMN}) is not assumed, as it doesn't hold
+ * once active stresses are added to the passive material law.
+ */
+template <unsigned DIM>
+class SymmetricFourthOrderTensor
+{
+public:
+
+    /** Number of independent components of a symmetric DIM by DIM matrix. */
+    static const unsigned NUM_VOIGT_INDICES = DIM*(DIM+1)/2;
+
+private:
+
+    /** The components of the tensor, D(GetVoigtIndex(M,N), GetVoigtIndex(P,Q)) = D_{MNPQ}. */
+    c_matrix<double, NUM_VOIGT_INDICES, NUM_VOIGT_INDICES> mData;
+
+public:
+
+    /**
+     * Constructor. The tensor is initialised to zero.
+     */
+    SymmetricFourthOrderTensor();
+
+    /**
+     * @return the Voigt index of the pair (M,N): the diagonal pairs come first,
+     * followed by the off-diagonal pairs (eg 00, 11, 22, 12, 02, 01 in 3D).
+     *
+     * @param M  first index
+     * @param N  second index
+     */
+    static unsigned GetVoigtIndex(unsigned M, unsigned N);
+
+    /**
+     * Set to be the symmetrisation of a general fourth order tensor, ie
+     * D_{MNPQ} = (X_{MNPQ} + X_{NMPQ} + X_{MNQP} + X_{NMQP})/4.
+     *
+     * @param rTensor A fourth order tensor
+     */
+    void SetAsSymmetrisation(FourthOrderTensor<DIM,DIM,DIM,DIM>& rTensor);
+
+    /**
+     * Compute the contraction used to assemble the Jacobian of the nonlinear elasticity
+     * equations, given this tensor as dT/dE. With S = T F^T (the first Piola-Kirchhoff
+     * stress), dS_{Mi}/dF_{jP} = F_{iN} F_{jQ} D_{MNPQ} + T_{MP} delta_{ij}, and this sets
+     *
+     *   rResult(DIM*a+i, DIM*b+j) = dS_{Mi}/dF_{jP} rGradPhi(M,a) rGradPhi(P,b)
+     *
+     * The symmetry of D is used to do this in fewer operations than contracting the
+     * full tensor one index at a time.
+     *
+     * @param rF  The deformation gradient
+     * @param rT  The second Piola-Kirchhoff stress
+     * @param rGradPhi  The basis function gradients, rGradPhi(M,a) = dphi_a/dX_M
+     * @param rResult  The matrix to be filled in
+     */
+    template <unsigned NUM_NODES>
+    void ComputeContractionWithBasisGradients(const c_matrix<double,DIM,DIM>& rF,
+                                              const c_matrix<double,DIM,DIM>& rT,
+                                              const c_matrix<double,DIM,NUM_NODES>& rGradPhi,
+                                              c_matrix<double,DIM*NUM_NODES,DIM*NUM_NODES>& rResult) const;
+
+    /**
+     * @return the MNPQ-component of the tensor.
+     *
+     * @param M  first index
+     * @param N  second index
+     * @param P  third index
+     * @param Q  fourth index
+     */
+    double operator()(unsigned M, unsigned N, unsigned P, unsigned Q) const;
+
+    /**
+     * Set all components of the tensor to zero.
+     */
+    void Zero();
+
+    /**
+     * @return a reference to the components of the tensor in Voigt form.
+     */
+    c_matrix<double, NUM_VOIGT_INDICES, NUM_VOIGT_INDICES>& rGetVoigtMatrix()
+    {
+        return mData;
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Implementation (templated on the number of nodes so no point with explicit instantiation)
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <unsigned DIM>
+SymmetricFourthOrderTensor<DIM>::SymmetricFourthOrderTensor()
+{
+    Zero();
+}
+
+template <unsigned DIM>
+unsigned SymmetricFourthOrderTensor<DIM>::GetVoigtIndex(unsigned M, unsigned N)
+{
+    assert(M<DIM);
+    assert(N<DIM);
+
+    if (M == N)
+    {
+        return M;
+    }
+    // The off-diagonal pair (M,N) is stored at DIM + (the index not in the pair) in 3D,
+    // and at 2 in 2D
+    return (DIM == 2) ? 2u : DIM + (3u - M - N);
+}
+
+template <unsigned DIM>
+void SymmetricFourthOrderTensor<DIM>::SetAsSymmetrisation(FourthOrderTensor<DIM,DIM,DIM,DIM>& rTensor)
+{
+    for (unsigned M=0; M<DIM; M++)
+    {
+        for (unsigned N=M; N<DIM; N++)
+        {
+            unsigned alpha = GetVoigtIndex(M,N);
+            for (unsigned P=0; P<DIM; P++)
+            {
+                for (unsigned Q=P; Q<DIM; Q++)
+                {
+                    mData(alpha, GetVoigtIndex(P,Q)) = 0.25*(  rTensor(M,N,P,Q) + rTensor(N,M,P,Q)
+                                                             + rTensor(M,N,Q,P) + rTensor(N,M,Q,P));
+                }
+            }
+        }
+    }
+}
+
+template <unsigned DIM>
+template <unsigned NUM_NODES>
+void SymmetricFourthOrderTensor<DIM>::ComputeContractionWithBasisGradients(const c_matrix<double,DIM,DIM>& rF,
+                                                                          const c_matrix<double,DIM,DIM>& rT,
+                                                                          const c_matrix<double,DIM,NUM_NODES>& rGradPhi,
+                                                                          c_matrix<double,DIM*NUM_NODES,DIM*NUM_NODES>& rResult) const
+{
+    /*
+     * Since D is symmetric in P and Q, the sum over (P,Q) of D_{MNPQ} F_{jQ} rGradPhi(P,b)
+     * only needs the symmetric part of F_{jQ} rGradPhi(P,b), which is stored (with the
+     * off-diagonal pairs counted twice) in Voigt form as sym_grad(beta, DIM*b+j).
+     */
+    c_matrix<double, NUM_VOIGT_INDICES, DIM*NUM_NODES> sym_grad;
+    for (unsigned b=0; b<NUM_NODES; b++)
+    {
+        for (unsigned j=0; j<DIM; j++)
+        {
+            for (unsigned P=0; P<DIM; P++)
+            {
+                sym_grad(GetVoigtIndex(P,P), DIM*b+j) = rF(j,P)*rGradPhi(P,b);
+                for (unsigned Q=P+1; Q<DIM; Q++)
+                {
+                    sym_grad(GetVoigtIndex(P,Q), DIM*b+j) = rF(j,Q)*rGradPhi(P,b) + rF(j,P)*rGradPhi(Q,b);
+                }
+            }
+        }
+    }
+
+    // D_{MN..} contracted with the above, for each Voigt pair (M,N)
+    c_matrix<double, NUM_VOIGT_INDICES, DIM*NUM_NODES> D_sym_grad = prod(mData, sym_grad);
+
+    // dSdF_grad(DIM*M+i, DIM*b+j) = dS_{Mi}/dF_{jP} rGradPhi(P,b)
+    c_matrix<double, DIM*DIM, DIM*NUM_NODES> dSdF_grad;
+    c_matrix<double, DIM, NUM_NODES> T_grad = prod(rT, rGradPhi);
+    for (unsigned M=0; M<DIM; M++)
+    {
+        for (unsigned i=0; i<DIM; i++)
+        {
+            for (unsigned col=0; col<DIM*NUM_NODES; col++)
+            {
+                double value = 0.0;
+                for (unsigned N=0; N<DIM; N++)
+                {
+                    value += rF(i,N)*D_sym_grad(GetVoigtIndex(M,N), col);
+                }
+                dSdF_grad(DIM*M+i, col) = value;
+            }
+            for (unsigned b=0; b<NUM_NODES; b++)
+            {
+                dSdF_grad(DIM*M+i, DIM*b+i) += T_grad(M,b);
+            }
+        }
+    }
+
+    for (unsigned a=0; a<NUM_NODES; a++)
+    {
+        for (unsigned i=0; i<DIM; i++)
+        {
+            for (unsigned col=0; col<DIM*NUM_NODES; col++)
+            {
+                double value = 0.0;
+                for (unsigned M=0; M<DIM; M++)
+                {
+                    value += rGradPhi(M,a)*dSdF_grad(DIM*M+i, col);
+                }
+                rResult(DIM*a+i, col) = value;
+            }
+        }
+    }
+}
+
+template <unsigned DIM>
+double SymmetricFourthOrderTensor<DIM>::operator()(unsigned M, unsigned N, unsigned P, unsigned Q) const
+{
+    return mData(GetVoigtIndex(M,N), GetVoigtIndex(P,Q));
+}
+
+template <unsigned DIM>
+void SymmetricFourthOrderTensor<DIM>::Zero()
+{
+    mData = zero_matrix<double>(NUM_VOIGT_INDICES, NUM_VOIGT_INDICES);
+}
+
+#endif //_SYMMETRICFOURTHORDERTENSOR_HPP_
@@ -614,6 +614,104 @@ double CalculateMaxEigenpair(c_matrix<double, 3, 3>& rA, c_vector<double, 3>& rE
                              //COMMON VECTOR FUNCTIONS
 
 
+// SMALL FIXED-SIZE MATRIX PRODUCTS
+//
+// These are written as plain loops over the compile-time dimensions, which the compiler
+// can fully unroll, instead of ublas expressions such as prod(trans(rA), rA) which are
+// evaluated element by element through proxy objects and temporaries. They are meant for
+// the per-quadrature-point element kernels in the assemblers and mechanics solvers.
+
+/**
+ * Compute the symmetric product A^T A of a small matrix, e.g. the Laplacian stencil
+ * from basis function gradients, or C = F^T F from a deformation gradient.
+ *
+ * @param rA  the M x N matrix A
+ * @return the N x N matrix A^T A
+ */
+template <class T, std::size_t M, std::size_t N>
+c_matrix<T, N, N> TransposeProduct(const c_matrix<T, M, N>& rA)
+{
+    c_matrix<T, N, N> result;
+    for (std::size_t i=0; i<N; i++)
+    {
+        for (std::size_t j=i; j<N; j++)
+        {
+            T sum = 0;
+            for (std::size_t k=0; k<M; k++)
+            {
+                sum += rA(k,i)*rA(k,j);
+            }
+            result(i,j) = sum;
+            result(j,i) = sum;
+        }
+    }
+    return result;
+}
+
+/**
+ * Compute the weighted product A^T W A of small matrices, e.g. grad(phi)^T sigma grad(phi)
+ * for a conductivity or diffusion tensor sigma.
+ *
+ * @param rA  the M x N matrix A
+ * @param rW  the M x M weight matrix W
+ * @return the N x N matrix A^T W A
+ */
+template <class T, std::size_t M, std::size_t N>
+c_matrix<T, N, N> WeightedTransposeProduct(const c_matrix<T, M, N>& rA, const c_matrix<T, M, M>& rW)
+{
+    // W A first, so that each entry of the result is a single dot product
+    T w_a[M][N];
+    for (std::size_t k=0; k<M; k++)
+    {
+        for (std::size_t j=0; j<N; j++)
+        {
+            T sum = 0;
+            for (std::size_t l=0; l<M; l++)
+            {
+                sum += rW(k,l)*rA(l,j);
+            }
+            w_a[k][j] = sum;
+        }
+    }
+
+    c_matrix<T, N, N> result;
+    for (std::size_t i=0; i<N; i++)
+    {
+        for (std::size_t j=0; j<N; j++)
+        {
+            T sum = 0;
+            for (std::size_t k=0; k<M; k++)
+            {
+                sum += rA(k,i)*w_a[k][j];
+            }
+            result(i,j) = sum;
+        }
+    }
+    return result;
+}
+
+/**
+ * Compute the outer product u v^T of two small vectors, e.g. the mass matrix stencil
+ * phi phi^T at a quadrature point.
+ *
+ * @param rU  the vector u, of size M
+ * @param rV  the vector v, of size N
+ * @return the M x N matrix u v^T
+ */
+template <class T, std::size_t M, std::size_t N>
+c_matrix<T, M, N> OuterProduct(const c_vector<T, M>& rU, const c_vector<T, N>& rV)
+{
+    c_matrix<T, M, N> result;
+    for (std::size_t i=0; i<M; i++)
+    {
+        for (std::size_t j=0; j<N; j++)
+        {
+            result(i,j) = rU(i)*rV(j);
+        }
+    }
+    return result;
+}
+
 /**
  * This is a fake cross-product aka vector-product.  Fake because it's only implemented for 3-vectors.
  * This version is to satisfy template compilation.
@@ -38,6 +38,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <cxxtest/TestSuite.h>
 #include "FourthOrderTensor.hpp"
+#include "SymmetricFourthOrderTensor.hpp"
 #include "PetscSetupAndFinalize.hpp"
 
 class TestFourthOrderTensor : public CxxTest::TestSuite
@@ -395,6 +396,91 @@ public:
         TS_ASSERT_DELTA( Y(0,0,0,0), A(0,0), 1e-8);
         TS_ASSERT_DELTA( Y(0,0,1,0), A(0,1), 1e-8);
     }
+
+    void TestSymmetricFourthOrderTensor()
+    {
+        // Voigt indices
+        TS_ASSERT_EQUALS(SymmetricFourthOrderTensor<3>::GetVoigtIndex(1,1), 1u);
+        TS_ASSERT_EQUALS(SymmetricFourthOrderTensor<3>::GetVoigtIndex(1,2), 3u);
+        TS_ASSERT_EQUALS(SymmetricFourthOrderTensor<3>::GetVoigtIndex(2,0), 4u);
+        TS_ASSERT_EQUALS(SymmetricFourthOrderTensor<3>::GetVoigtIndex(0,1), 5u);
+        TS_ASSERT_EQUALS(SymmetricFourthOrderTensor<2>::GetVoigtIndex(1,0), 2u);
+
+        // A tensor with the minor symmetries but not the major symmetry
+        FourthOrderTensor<3,3,3,3> X;
+        for (unsigned M=0; M<3; M++)
+        {
+            for (unsigned N=0; N<3; N++)
+            {
+                for (unsigned P=0; P<3; P++)
+                {
+                    for (unsigned Q=0; Q<3; Q++)
+                    {
+                        X(M,N,P,Q) = (M+1)*(N+1) + 0.5*(P+Q) + 0.1*M*N*P*Q;
+                    }
+                }
+            }
+        }
+
+        SymmetricFourthOrderTensor<3> D;
+        D.SetAsSymmetrisation(X);
+        TS_ASSERT_DELTA(D(0,1,2,1), X(0,1,2,1), 1e-12);
+        TS_ASSERT_DELTA(D(1,0,1,2), X(0,1,2,1), 1e-12);
+        TS_ASSERT_DELTA(D(2,2,0,0), X(2,2,0,0), 1e-12);
+
+        c_matrix<double,3,3> F;
+        c_matrix<double,3,3> T;
+        c_matrix<double,3,4> grad_phi;
+        for (unsigned i=0; i<3; i++)
+        {
+            for (unsigned j=0; j<3; j++)
+            {
+                F(i,j) = (i==j ? 1.1 : 0.0) + 0.1*i - 0.05*j;
+                T(i,j) = 1.0 + i + j;
+            }
+            for (unsigned a=0; a<4; a++)
+            {
+                grad_phi(i,a) = 0.3*a - 0.2*i + 0.1*i*a;
+            }
+        }
+
+        c_matrix<double,12,12> result;
+        D.ComputeContractionWithBasisGradients<4>(F, T, grad_phi, result);
+
+        // Compare with doing the contractions index by index on the full tensor
+        for (unsigned a=0; a<4; a++)
+        {
+            for (unsigned i=0; i<3; i++)
+            {
+                for (unsigned b=0; b<4; b++)
+                {
+                    for (unsigned j=0; j<3; j++)
+                    {
+                        double expected = 0.0;
+                        for (unsigned M=0; M<3; M++)
+                        {
+                            for (unsigned P=0; P<3; P++)
+                            {
+                                double dSdF = (i==j ? T(M,P) : 0.0);
+                                for (unsigned N=0; N<3; N++)
+                                {
+                                    for (unsigned Q=0; Q<3; Q++)
+                                    {
+                                        dSdF += F(i,N)*F(j,Q)*X(M,N,P,Q);
+                                    }
+                                }
+                                expected += dSdF*grad_phi(M,a)*grad_phi(P,b);
+                            }
+                        }
+                        TS_ASSERT_DELTA(result(3*a+i,3*b+j), expected, 1e-10);
+                    }
+                }
+            }
+        }
+
+        D.Zero();
+        TS_ASSERT_DELTA(D(0,1,0,1), 0.0, 1e-12);
+    }
 };
 
 #endif /*TESTFOURTHORDERTENSOR_HPP_*/
@@ -0,0 +1,219 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef TESTINITIALGUESSGENERATOR_HPP_
+#define TESTINITIALGUESSGENERATOR_HPP_
+
+#include <cxxtest/TestSuite.h>
+
+#include "PetscMatTools.hpp" // Includes Ublas so must come before PETSc
+#include "InitialGuessGenerator.hpp"
+#include "ReplicatableVector.hpp"
+#include "PetscTools.hpp"
+#include "PetscSetupAndFinalize.hpp"
+
+class TestInitialGuessGenerator : public CxxTest::TestSuite
+{
+private:
+
+    /** @return a vector with entries a[i] + b[i]*t + c[i]*t*t */
+    Vec MakeQuadraticInTime(double t)
+    {
+        std::vector<double> values(5);
+        for (unsigned i=0; i<values.size(); i++)
+        {
+            values[i] = 1.0 + i + (2.0 - i)*t + 0.5*i*t*t;
+        }
+        return PetscTools::CreateVec(values);
+    }
+
+    /** @return a vector with entries a[i] + b[i]*t */
+    Vec MakeLinearInTime(double t)
+    {
+        std::vector<double> values(5);
+        for (unsigned i=0; i<values.size(); i++)
+        {
+            values[i] = 1.0 + i + (2.0 - i)*t;
+        }
+        return PetscTools::CreateVec(values);
+    }
+
+    void CheckEqual(Vec a, Vec b, double tol)
+    {
+        ReplicatableVector a_repl(a);
+        ReplicatableVector b_repl(b);
+        TS_ASSERT_EQUALS(a_repl.GetSize(), b_repl.GetSize());
+        for (unsigned i=0; i<a_repl.GetSize(); i++)
+        {
+            TS_ASSERT_DELTA(a_repl[i], b_repl[i], tol);
+        }
+    }
+
+public:
+
+    void TestExtrapolation()
+    {
+        Vec guess = PetscTools::CreateAndSetVec(5, 0.0);
+
+        // Previous solution
+        InitialGuessGenerator generator;
+        TS_ASSERT_EQUALS(generator.GetType(), PREVIOUS_SOLUTION);
+        TS_ASSERT_EQUALS(generator.ComputeGuess(guess, 1.0), false);
+        TS_ASSERT_THROWS_THIS(generator.GetLastTime(), "No solutions have been stored");
+
+        Vec x0 = MakeQuadraticInTime(0.0);
+        Vec x1 = MakeQuadraticInTime(0.3);
+        Vec x2 = MakeQuadraticInTime(0.5);
+        generator.AddSolution(x0, 0.0);
+        generator.AddSolution(x1, 0.3);
+        TS_ASSERT_EQUALS(generator.GetNumStoredSolutions(), 1u);
+        TS_ASSERT_DELTA(generator.GetLastTime(), 0.3, 1e-12);
+        TS_ASSERT_EQUALS(generator.ComputeGuess(guess, 1.0), true);
+        CheckEqual(guess, x1, 1e-12);
+
+        // Linear extrapolation is exact for data linear in time (with a variable time step)
+        generator.SetType(LINEAR_EXTRAPOLATION);
+        TS_ASSERT_EQUALS(generator.GetNumStoredSolutions(), 0u);
+        Vec y0 = MakeLinearInTime(0.0);
+        Vec y1 = MakeLinearInTime(0.3);
+        Vec y_exact = MakeLinearInTime(0.45);
+        generator.AddSolution(y0, 0.0);
+        // Falls back to the previous solution until there are two
+        generator.ComputeGuess(guess, 0.3);
+        CheckEqual(guess, y0, 1e-12);
+        generator.AddSolution(y1, 0.3);
+        generator.ComputeGuess(guess, 0.45);
+        CheckEqual(guess, y_exact, 1e-12);
+
+        // Quadratic extrapolation is exact for data quadratic in time
+        generator.SetType(QUADRATIC_EXTRAPOLATION);
+        Vec x_exact = MakeQuadraticInTime(0.6);
+        generator.AddSolution(x0, 0.0);
+        generator.AddSolution(x1, 0.3);
+        generator.AddSolution(x2, 0.5);
+        TS_ASSERT_EQUALS(generator.GetNumStoredSolutions(), 3u);
+        generator.ComputeGuess(guess, 0.6);
+        CheckEqual(guess, x_exact, 1e-10);
+
+        // Adding a fourth solution drops the oldest
+        generator.AddSolution(x_exact, 0.6);
+        TS_ASSERT_EQUALS(generator.GetNumStoredSolutions(), 3u);
+        TS_ASSERT_DELTA(generator.GetLastTime(), 0.6, 1e-12);
+
+        // Setting the same type keeps the history
+        generator.SetType(QUADRATIC_EXTRAPOLATION);
+        TS_ASSERT_EQUALS(generator.GetNumStoredSolutions(), 3u);
+        generator.Reset();
+        TS_ASSERT_EQUALS(generator.GetNumStoredSolutions(), 0u);
+
+        TS_ASSERT_THROWS_THIS(generator.SetType(PROJECTION, 0u),
+                              "The projection initial guess needs at least one previous solution");
+
+        PetscTools::Destroy(guess);
+        PetscTools::Destroy(x0);
+        PetscTools::Destroy(x1);
+        PetscTools::Destroy(x2);
+        PetscTools::Destroy(x_exact);
+        PetscTools::Destroy(y0);
+        PetscTools::Destroy(y1);
+        PetscTools::Destroy(y_exact);
+    }
+
+    void TestProjection()
+    {
+        const unsigned size = 5;
+        Mat matrix;
+        PetscTools::SetupMat(matrix, size, size, 3);
+        for (unsigned i=0; i<size; i++)
+        {
+            PetscMatTools::SetElement(matrix, i, i, 2.0 + i);
+            if (i > 0)
+            {
+                PetscMatTools::SetElement(matrix, i, i-1, -1.0);
+            }
+        }
+        PetscMatTools::Finalise(matrix);
+
+        Vec x0 = MakeQuadraticInTime(0.0);
+        Vec x1 = MakeQuadraticInTime(0.3);
+        Vec x2 = MakeQuadraticInTime(0.5);
+
+        // The solution 2*x1 - x0 lies in the span of the stored solutions, so is recovered exactly
+        Vec exact = PetscTools::CreateAndSetVec(size, 0.0);
+        VecAXPY(exact, 2.0, x1);
+        VecAXPY(exact, -1.0, x0);
+        Vec rhs = PetscTools::CreateAndSetVec(size, 0.0);
+        MatMult(matrix, exact, rhs);
+
+        Vec guess = PetscTools::CreateAndSetVec(size, 0.0);
+
+        InitialGuessGenerator generator(PROJECTION, 3u);
+        TS_ASSERT_EQUALS(generator.GetType(), PROJECTION);
+        generator.AddSolution(x0, 0.0);
+        generator.AddSolution(x1, 0.3);
+        // A repeated solution adds nothing to the span and is discarded by the orthogonalisation
+        generator.AddSolution(x1, 0.4);
+        TS_ASSERT_EQUALS(generator.ComputeGuess(guess, 0.5, matrix, rhs), true);
+        CheckEqual(guess, exact, 1e-10);
+
+        // Only the most recent three solutions are kept
+        generator.AddSolution(x2, 0.5);
+        TS_ASSERT_EQUALS(generator.GetNumStoredSolutions(), 3u);
+
+        // A zero right-hand side gives a zero guess
+        Vec zero = PetscTools::CreateAndSetVec(size, 0.0);
+        generator.ComputeGuess(guess, 0.6, matrix, zero);
+        CheckEqual(guess, zero, 1e-12);
+
+        // If the stored solutions are all zero we fall back to the previous solution
+        generator.Reset();
+        generator.AddSolution(zero, 0.0);
+        VecSet(guess, 1.0);
+        TS_ASSERT_EQUALS(generator.ComputeGuess(guess, 0.1, matrix, rhs), true);
+        CheckEqual(guess, zero, 1e-12);
+
+        PetscTools::Destroy(matrix);
+        PetscTools::Destroy(x0);
+        PetscTools::Destroy(x1);
+        PetscTools::Destroy(x2);
+        PetscTools::Destroy(exact);
+        PetscTools::Destroy(rhs);
+        PetscTools::Destroy(guess);
+        PetscTools::Destroy(zero);
+    }
+};
+
+#endif /*TESTINITIALGUESSGENERATOR_HPP_*/
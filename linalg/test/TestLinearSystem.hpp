@@ -1312,6 +1312,60 @@ public:
         PetscTools::Destroy(system_rhs);
     }
 
+    void TestPreconditionerReuse()
+    {
+        const unsigned size = 10;
+        LinearSystem ls(size);
+        for (unsigned i=0; i<size; i++)
+        {
+            ls.SetMatrixElement(i, i, i+1.0);
+            ls.SetRhsVectorElement(i, 1.0);
+        }
+        ls.AssembleFinalLinearSystem();
+        ls.SetAbsoluteTolerance(1e-12);
+
+        TS_ASSERT_DELTA(ls.GetPreconditionerReuseTolerance(), -1.0, 1e-12);
+        TS_ASSERT_EQUALS(ls.GetNumPreconditionerSetups(), 0u);
+        Vec solution = ls.Solve();
+        PetscTools::Destroy(solution);
+        TS_ASSERT_EQUALS(ls.GetNumPreconditionerSetups(), 1u);
+
+        // By default resetting the solver rebuilds the preconditioner
+        ls.ResetKspSolver();
+        solution = ls.Solve();
+        PetscTools::Destroy(solution);
+        TS_ASSERT_EQUALS(ls.GetNumPreconditionerSetups(), 2u);
+
+        // Now keep it unless the matrix changes by more than 10%
+        ls.SetPreconditionerReuseTolerance(0.1);
+        ls.ResetKspSolver();
+        solution = ls.Solve();
+        PetscTools::Destroy(solution);
+        TS_ASSERT_EQUALS(ls.GetNumPreconditionerSetups(), 2u);
+
+        MatScale(ls.GetLhsMatrix(), 1.01);
+        ls.ResetKspSolver();
+        solution = ls.Solve();
+        PetscTools::Destroy(solution);
+        TS_ASSERT_EQUALS(ls.GetNumPreconditionerSetups(), 2u);
+
+        MatScale(ls.GetLhsMatrix(), 2.0);
+        ls.ResetKspSolver();
+        solution = ls.Solve();
+        TS_ASSERT_EQUALS(ls.GetNumPreconditionerSetups(), 3u);
+
+        // The solution is right whether or not the preconditioner was rebuilt
+        ReplicatableVector solution_repl(solution);
+        for (unsigned i=0; i<size; i++)
+        {
+            TS_ASSERT_DELTA(solution_repl[i], 1.0/(2.02*(i+1.0)), 1e-9);
+        }
+        PetscTools::Destroy(solution);
+
+        TS_ASSERT_LESS_THAN_EQUALS(0.0, ls.GetKspSetupTime());
+        TS_ASSERT_LESS_THAN_EQUALS(0.0, ls.GetKspSolveTime());
+    }
+
 //    void TestSingularSolves()
 //    {
 //        LinearSystem ls(2);
@@ -1602,6 +1656,96 @@ public:
         PetscTools::Destroy(guess);
     }
 
+    void TestPipelinedKrylovWithPrescribedNumberOfIterations()
+    {
+#if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 4) //PETSc 3.4 or later
+        unsigned num_nodes = 1331;
+        DistributedVectorFactory factory(num_nodes);
+        Vec parallel_layout = factory.CreateVec(2);
+
+        Mat system_matrix;
+        // Note that this test deadlocks if the file's not on the disk
+        PetscTools::ReadPetscObject(system_matrix, "linalg/test/data/matrices/cube_6000elems_half_activated.mat", parallel_layout);
+
+        Vec system_rhs;
+        // Note that this test deadlocks if the file's not on the disk
+        PetscTools::ReadPetscObject(system_rhs, "linalg/test/data/matrices/cube_6000elems_half_activated.vec", parallel_layout);
+
+        Vec guess;
+        VecDuplicate(parallel_layout, &guess);
+        VecSet(guess, 0.0);
+
+        // Reference solution with standard CG
+        LinearSystem ls_cg = LinearSystem(system_rhs, system_matrix);
+        ls_cg.SetMatrixIsSymmetric();
+        ls_cg.SetKspType("cg");
+        ls_cg.SetPcType("jacobi");
+        ls_cg.SetAbsoluteTolerance(1e-4);
+        Vec cg_solution = ls_cg.Solve(guess);
+
+        Vec difference;
+        VecDuplicate(parallel_layout, &difference);
+        PetscReal l_inf_norm;
+
+        // The communication-avoiding variants of CG converge to the same solution
+        const char* cg_types[2] = {"pipecg", "groppcg"};
+        for (unsigned i=0; i<2; i++)
+        {
+            LinearSystem ls = LinearSystem(system_rhs, system_matrix);
+            ls.SetMatrixIsSymmetric();
+            ls.SetKspType(cg_types[i]);
+            ls.SetPcType("jacobi");
+            ls.SetAbsoluteTolerance(1e-4);
+
+            Vec solution = ls.Solve(guess);
+            TS_ASSERT_LESS_THAN(0u, ls.GetNumIterations());
+
+            PetscVecTools::WAXPY(difference, -1.0, solution, cg_solution);
+            VecNorm(difference, NORM_INFINITY, &l_inf_norm);
+            TS_ASSERT_DELTA(l_inf_norm, 0.0, 4e-4);
+            PetscTools::Destroy(solution);
+        }
+
+        /*
+         * With a prescribed number of iterations the residual norm is never computed, so every
+         * solve (including the first) takes exactly that many iterations, even when the guess is
+         * already the solution.
+         */
+        LinearSystem ls = LinearSystem(system_rhs, system_matrix);
+        ls.SetMatrixIsSymmetric();
+        ls.SetKspType("pipecg");
+        ls.SetPcType("jacobi");
+        ls.SetAbsoluteTolerance(1e-4);
+        TS_ASSERT_THROWS_NOTHING(ls.SetUseFixedNumberIterations(true, 2, 60));
+
+        Vec solution = ls.Solve(guess);
+        TS_ASSERT_EQUALS(ls.GetNumIterations(), 60u);
+
+        PetscVecTools::WAXPY(difference, -1.0, solution, cg_solution);
+        VecNorm(difference, NORM_INFINITY, &l_inf_norm);
+        TS_ASSERT_DELTA(l_inf_norm, 0.0, 4e-4);
+
+        for (unsigned solve=0; solve<2; solve++)
+        {
+            Vec new_solution = ls.Solve(cg_solution);
+            TS_ASSERT_EQUALS(ls.GetNumIterations(), 60u);
+            PetscTools::Destroy(new_solution);
+        }
+
+        PetscTools::Destroy(solution);
+        PetscTools::Destroy(cg_solution);
+        PetscTools::Destroy(difference);
+        PetscTools::Destroy(system_matrix);
+        PetscTools::Destroy(system_rhs);
+        PetscTools::Destroy(parallel_layout);
+        PetscTools::Destroy(guess);
+#else
+        LinearSystem ls(3, 3);
+        ls.SetKspType("pipecg");
+        TS_ASSERT_THROWS_CONTAINS(ls.Solve(), "requires PETSc 3.4 or later");
+#endif
+    }
+
     void TestSolveZerosInitialGuessForSmallRhs()
     {
         LinearSystem ls(2);
@@ -0,0 +1,203 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTPCTHREEFIELDBLOCKDIAGONAL_HPP_
+#define TESTPCTHREEFIELDBLOCKDIAGONAL_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include "LinearSystem.hpp"
+#include "PetscSetupAndFinalize.hpp"
+#include "ReplicatableVector.hpp"
+#include "DistributedVectorFactory.hpp"
+#include <cstring>
+
+class TestPCThreeFieldBlockDiagonal : public CxxTest::TestSuite
+{
+private:
+
+    /**
+     * Fill in a matrix with the structure of the extended bidomain equations on a 1D chain
+     * of nodes, with unknowns [V_1 V_2 phi_e] interleaved. With K the stiffness matrix,
+     * M a mass-like diagonal and g the cell-to-cell coupling:
+     *
+     *    (K+M+g   -g        K    )
+     *    (-g      K/2+M+g   K/2  )
+     *    (K       K/2       5K/2 )
+     *
+     * which is symmetric positive definite.
+     */
+    void AssembleThreeFieldSystem(LinearSystem& rLinearSystem, unsigned numNodes)
+    {
+        const double mass = 0.1;
+        const double coupling = 0.05;
+        const double intra_scale[2] = {1.0, 0.5};
+
+        PetscInt lo, hi;
+        rLinearSystem.GetOwnershipRange(lo, hi);
+        for (unsigned node=(unsigned)lo/3; node<(unsigned)hi/3; node++)
+        {
+            // Stencil of K on this row
+            std::vector<unsigned> neighbours;
+            std::vector<double> stiffness;
+            neighbours.push_back(node);
+            stiffness.push_back(2.0);
+            if (node > 0)
+            {
+                neighbours.push_back(node-1);
+                stiffness.push_back(-1.0);
+            }
+            if (node+1 < numNodes)
+            {
+                neighbours.push_back(node+1);
+                stiffness.push_back(-1.0);
+            }
+
+            for (unsigned cell=0; cell<2; cell++)
+            {
+                unsigned row = 3*node+cell;
+                for (unsigned i=0; i<neighbours.size(); i++)
+                {
+                    double k = intra_scale[cell]*stiffness[i];
+                    rLinearSystem.AddToMatrixElement(row, 3*neighbours[i]+cell, k);
+                    rLinearSystem.AddToMatrixElement(row, 3*neighbours[i]+2, k);
+                    rLinearSystem.AddToMatrixElement(3*node+2, 3*neighbours[i]+cell, k);
+                }
+                rLinearSystem.AddToMatrixElement(row, row, mass+coupling);
+                rLinearSystem.AddToMatrixElement(row, 3*node+1-cell, -coupling);
+            }
+            for (unsigned i=0; i<neighbours.size(); i++)
+            {
+                rLinearSystem.AddToMatrixElement(3*node+2, 3*neighbours[i]+2, 2.5*stiffness[i]);
+            }
+
+            for (unsigned field=0; field<3; field++)
+            {
+                rLinearSystem.SetRhsVectorElement(3*node+field, field==2 ? 0.0 : 1.0);
+            }
+        }
+        rLinearSystem.AssembleFinalLinearSystem();
+    }
+
+public:
+
+    void TestBlockSizeAndBasicFunctionality()
+    {
+        unsigned num_nodes = 1000;
+        DistributedVectorFactory factory(num_nodes);
+        Vec template_vec = factory.CreateVec(3);
+
+        LinearSystem ls(template_vec, 9, true, 3);
+        PetscTools::Destroy(template_vec);
+
+        // The matrix has been told about the three unknowns per node
+        PetscInt block_size;
+        MatGetBlockSize(ls.rGetLhsMatrix(), &block_size);
+        TS_ASSERT_EQUALS(block_size, 3);
+
+        AssembleThreeFieldSystem(ls, num_nodes);
+
+        ls.SetAbsoluteTolerance(1e-10);
+        ls.SetKspType("cg");
+        ls.SetPcType("threefieldblockdiagonal");
+
+        Vec solution = ls.Solve();
+
+        // Check the residual
+        Vec residual;
+        VecDuplicate(solution, &residual);
+        MatMult(ls.rGetLhsMatrix(), solution, residual);
+        VecAXPY(residual, -1.0, ls.rGetRhsVector());
+        double norm;
+        VecNorm(residual, NORM_2, &norm);
+        TS_ASSERT_LESS_THAN(norm, 1e-8);
+
+#if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR <= 3) //PETSc 3.0 to PETSc 3.3
+        const PCType pc;
+#else
+        PCType pc;
+#endif
+        PC prec;
+        KSPGetPC(ls.mKspSolver, &prec);
+        PCGetType(prec, &pc);
+        TS_ASSERT( strcmp(pc,"shell")==0 );
+
+        // Coverage (setting PC type after first solve)
+        ls.SetPcType("threefieldblockdiagonal");
+
+        PetscTools::Destroy(residual);
+        PetscTools::Destroy(solution);
+    }
+
+    void TestBetterThanNoPreconditioning()
+    {
+        unsigned num_nodes = 1000;
+        DistributedVectorFactory factory(num_nodes);
+
+        std::string pc_types[2] = {"none", "threefieldblockdiagonal"};
+        unsigned num_iterations[2];
+        Vec solutions[2];
+
+        for (unsigned i=0; i<2; i++)
+        {
+            Vec template_vec = factory.CreateVec(3);
+            LinearSystem ls(template_vec, 9, true, 3);
+            PetscTools::Destroy(template_vec);
+
+            AssembleThreeFieldSystem(ls, num_nodes);
+
+            ls.SetAbsoluteTolerance(1e-10);
+            ls.SetKspType("cg");
+            ls.SetPcType(pc_types[i].c_str());
+
+            solutions[i] = ls.Solve();
+            num_iterations[i] = ls.GetNumIterations();
+        }
+
+        std::cout << num_iterations[1] << " " << num_iterations[0] << std::endl;
+        TS_ASSERT_LESS_THAN(num_iterations[1], num_iterations[0]);
+
+        ReplicatableVector unpreconditioned(solutions[0]);
+        ReplicatableVector preconditioned(solutions[1]);
+        for (unsigned i=0; i<unpreconditioned.GetSize(); i++)
+        {
+            TS_ASSERT_DELTA(preconditioned[i], unpreconditioned[i], 1e-6);
+        }
+
+        PetscTools::Destroy(solutions[0]);
+        PetscTools::Destroy(solutions[1]);
+    }
+};
+
+#endif /*TESTPCTHREEFIELDBLOCKDIAGONAL_HPP_*/
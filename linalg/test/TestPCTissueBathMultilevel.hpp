@@ -0,0 +1,239 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTPCTISSUEBATHMULTILEVEL_HPP_
+#define TESTPCTISSUEBATHMULTILEVEL_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include "LinearSystem.hpp"
+#include "PetscSetupAndFinalize.hpp"
+#include "DistributedVectorFactory.hpp"
+#include <cstring>
+#include <set>
+
+/*
+ * Warning: these tests do not inform PETSc about the nullspace of the matrix. Therefore, convergence might be
+ * different compared to a real cardiac simulation. Do not take conclusions about preconditioner performance
+ * based on these tests only.
+ */
+class TestPCTissueBathMultilevel : public CxxTest::TestSuite
+{
+private:
+
+    boost::shared_ptr<std::vector<PetscInt> > GetBathNodes()
+    {
+        const unsigned num_bath_nodes = 84;
+        PetscInt bath_nodes[num_bath_nodes] = {0, 1, 19, 20, 21, 22, 40, 41, 42, 43, 61, 62, 63, 64, 82, 83, 84,
+                                               85, 103, 104, 105, 106, 124, 125, 126, 127, 145, 146, 147, 148, 166,
+                                               167, 168, 169, 187, 188, 189, 190, 208, 209, 210, 211, 229, 230, 231,
+                                               232, 250, 251, 252, 253, 271, 272, 273, 274, 292, 293, 294, 295, 313,
+                                               314, 315, 316, 334, 335, 336, 337, 355, 356, 357, 358, 376, 377, 378,
+                                               379, 397, 398, 399, 400, 418, 419, 420, 421, 439, 440};
+        return boost::shared_ptr<std::vector<PetscInt> >(new std::vector<PetscInt>(bath_nodes, &bath_nodes[num_bath_nodes]));
+    }
+
+public:
+
+    void TestBasicFunctionality()
+    {
+        unsigned num_nodes = 441;
+        DistributedVectorFactory factory(num_nodes);
+        Vec parallel_layout = factory.CreateVec(2);
+
+        boost::shared_ptr<std::vector<PetscInt> > p_bath = GetBathNodes();
+
+        Mat system_matrix;
+        PetscTools::ReadPetscObject(system_matrix, "linalg/test/data/matrices/PP_system_with_bath.mat", parallel_layout);
+
+        PetscTools::Destroy(parallel_layout);
+
+        // Set rhs = A * [1 0 1 0 ... 1 0]'
+        Vec one_zeros = factory.CreateVec(2);
+        Vec rhs = factory.CreateVec(2);
+
+        for (unsigned node_index=0; node_index<2*num_nodes; node_index+=2)
+        {
+            PetscVecTools::SetElement(one_zeros, node_index, 1);
+            PetscVecTools::SetElement(one_zeros, node_index+1, 0);
+        }
+        PetscVecTools::Finalise(one_zeros);
+
+        MatMult(system_matrix, one_zeros, rhs);
+        PetscTools::Destroy(one_zeros);
+
+        LinearSystem ls = LinearSystem(rhs, system_matrix);
+
+        ls.SetAbsoluteTolerance(1e-9);
+        ls.SetKspType("cg");
+        ls.SetPcType("tissuebathmultilevel", p_bath);
+
+        ls.AssembleFinalLinearSystem();
+
+        Vec solution = ls.Solve();
+
+        DistributedVector distributed_solution = factory.CreateDistributedVector(solution);
+        DistributedVector::Stripe phi_i(distributed_solution, 0);
+        DistributedVector::Stripe phi_e(distributed_solution, 1);
+
+        std::set<PetscInt> bath_nodes_set(p_bath->begin(), p_bath->end());
+
+        // The system is singular, so the solution is only defined up to a constant in phi_e
+        // (see TestPCTwoLevelsBlockDiagonal). Check the differences instead.
+        for (DistributedVector::Iterator index = distributed_solution.Begin();
+             index!= distributed_solution.End();
+             ++index)
+        {
+            if (bath_nodes_set.find(index.Global) != bath_nodes_set.end())
+            {
+                // Bath node: phi_i in the bath is 1 because of the dummy equations we introduce x_i = b_i
+                TS_ASSERT_DELTA(phi_i[index], 1.0, 1e-6);
+            }
+            else
+            {
+                // Tissue node
+                TS_ASSERT_DELTA(phi_i[index] - phi_e[index], 1.0, 1e-6);
+            }
+        }
+
+        // Coverage (setting PC type after first solve)
+        ls.SetPcType("tissuebathmultilevel", p_bath);
+
+        PetscTools::Destroy(system_matrix);
+        PetscTools::Destroy(rhs);
+        PetscTools::Destroy(solution);
+
+#if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR <= 3) //PETSc 3.0 to PETSc 3.3
+        //The PETSc developers changed this one, but later changed it back again!
+        const PCType pc;
+#else
+        PCType pc;
+#endif
+        PC prec;
+        KSPGetPC(ls.mKspSolver, &prec);
+        PCGetType(prec, &pc);
+        // Although we call it "tissuebathmultilevel", PETSc considers this PC a generic SHELL preconditioner
+        TS_ASSERT( strcmp(pc,"shell")==0 );
+    }
+
+    void TestBetterThanOtherPreconditioners()
+    {
+        unsigned num_nodes = 441;
+        DistributedVectorFactory factory(num_nodes);
+        Vec parallel_layout = factory.CreateVec(2);
+
+        boost::shared_ptr<std::vector<PetscInt> > p_bath = GetBathNodes();
+
+        const unsigned num_pcs = 3;
+        std::string pc_types[num_pcs] = {"none", "ldufactorisation", "tissuebathmultilevel"};
+        unsigned iterations[num_pcs];
+
+        for (unsigned i=0; i<num_pcs; i++)
+        {
+            Mat system_matrix;
+            //Note that this test deadlocks if the file's not on the disk
+            PetscTools::ReadPetscObject(system_matrix, "linalg/test/data/matrices/PP_system_with_bath.mat", parallel_layout);
+
+            Vec system_rhs;
+            //Note that this test deadlocks if the file's not on the disk
+            PetscTools::ReadPetscObject(system_rhs, "linalg/test/data/matrices/PP_system_with_bath.vec", parallel_layout);
+
+            LinearSystem ls = LinearSystem(system_rhs, system_matrix);
+
+            ls.SetAbsoluteTolerance(1e-9);
+            ls.SetKspType("cg");
+            ls.SetPcType(pc_types[i].c_str(), p_bath);
+
+            Vec solution = ls.Solve();
+            iterations[i] = ls.GetNumIterations();
+
+            if (PetscTools::AmMaster())
+            {
+                std::cout << pc_types[i] << ": " << iterations[i] << " iterations, set-up "
+                          << ls.GetKspSetupTime() << " s" << std::endl;
+            }
+
+            PetscTools::Destroy(system_matrix);
+            PetscTools::Destroy(system_rhs);
+            PetscTools::Destroy(solution);
+        }
+
+        TS_ASSERT_LESS_THAN(iterations[2], iterations[0]);
+        TS_ASSERT_LESS_THAN_EQUALS(iterations[2], iterations[1]);
+
+        PetscTools::Destroy(parallel_layout);
+    }
+
+    void TestSetUpIsReused()
+    {
+        unsigned num_nodes = 441;
+        DistributedVectorFactory factory(num_nodes);
+        Vec parallel_layout = factory.CreateVec(2);
+
+        Mat system_matrix;
+        PetscTools::ReadPetscObject(system_matrix, "linalg/test/data/matrices/PP_system_with_bath.mat", parallel_layout);
+        Vec system_rhs;
+        PetscTools::ReadPetscObject(system_rhs, "linalg/test/data/matrices/PP_system_with_bath.vec", parallel_layout);
+        PetscTools::Destroy(parallel_layout);
+
+        LinearSystem ls = LinearSystem(system_rhs, system_matrix);
+        ls.SetAbsoluteTolerance(1e-9);
+        ls.SetKspType("cg");
+        ls.SetPcType("tissuebathmultilevel", GetBathNodes());
+        ls.SetPreconditionerReuseTolerance(0.1);
+
+        Vec solution = ls.Solve();
+        TS_ASSERT_EQUALS(ls.mpTissueBathMultilevelPC->GetNumSetUps(), 1u);
+
+        // The unchanged matrix keeps the preconditioner
+        Vec second_solution = ls.Solve(solution);
+        PetscTools::Destroy(solution);
+        PetscTools::Destroy(second_solution);
+        TS_ASSERT_EQUALS(ls.mpTissueBathMultilevelPC->GetNumSetUps(), 1u);
+
+        // A changed matrix refreshes the sub-blocks of the same preconditioner object
+        PCTissueBathMultilevel* p_pc = ls.mpTissueBathMultilevelPC;
+        MatScale(ls.GetLhsMatrix(), 2.0);
+        solution = ls.Solve();
+        PetscTools::Destroy(solution);
+        TS_ASSERT_EQUALS(ls.mpTissueBathMultilevelPC, p_pc);
+        TS_ASSERT_EQUALS(ls.mpTissueBathMultilevelPC->GetNumSetUps(), 2u);
+        TS_ASSERT_EQUALS(ls.GetNumPreconditionerSetups(), 2u);
+
+        PetscTools::Destroy(system_matrix);
+        PetscTools::Destroy(system_rhs);
+    }
+};
+
+#endif /*TESTPCTISSUEBATHMULTILEVEL_HPP_*/
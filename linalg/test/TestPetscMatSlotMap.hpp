@@ -0,0 +1,140 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTPETSCMATSLOTMAP_HPP_
+#define TESTPETSCMATSLOTMAP_HPP_
+
+#include <cxxtest/TestSuite.h>
+
+#include "PetscMatSlotMap.hpp" // Includes Ublas so must come before PETSc
+#include "PetscMatTools.hpp"
+
+#include "PetscSetupAndFinalize.hpp"
+
+class TestPetscMatSlotMap : public CxxTest::TestSuite
+{
+private:
+    /**
+     * The stencils of a chain of 1D linear elements: element i couples nodes i and i+1.
+     */
+    std::vector<PetscInt> MakeChainStencils(unsigned numNodes)
+    {
+        std::vector<PetscInt> stencils;
+        for (unsigned i=0; i+1<numNodes; i++)
+        {
+            stencils.push_back(i);
+            stencils.push_back(i+1);
+        }
+        return stencils;
+    }
+
+public:
+    void TestAddingThroughSlots()
+    {
+        const unsigned size = 12u;
+        std::vector<PetscInt> stencils = MakeChainStencils(size);
+        unsigned num_stencils = size-1;
+
+        c_matrix<double, 2, 2> element_matrix;
+        element_matrix(0,0) = 1.0;
+        element_matrix(0,1) = -2.0;
+        element_matrix(1,0) = -3.0;
+        element_matrix(1,1) = 4.0;
+
+        // Assemble as usual, so that the matrix has its nonzero structure
+        Mat reference;
+        PetscTools::SetupMat(reference, size, size, 3);
+        for (unsigned i=0; i<num_stencils; i++)
+        {
+            unsigned indices[2] = {i, i+1};
+            PetscMatTools::AddMultipleValues<2>(reference, indices, element_matrix);
+        }
+        PetscMatTools::Finalise(reference);
+
+        Mat matrix;
+        PetscTools::SetupMat(matrix, size, size, 3);
+        for (unsigned i=0; i<num_stencils; i++)
+        {
+            unsigned indices[2] = {i, i+1};
+            PetscMatTools::AddMultipleValues<2>(matrix, indices, element_matrix);
+        }
+        PetscMatTools::Finalise(matrix);
+
+        // The slot map can't be built until the structure is known
+        Mat unassembled;
+        PetscTools::SetupMat(unassembled, size, size, 3);
+        PetscMatSlotMap unassembled_map(unassembled, stencils, 2);
+        TS_ASSERT(!unassembled_map.IsValid());
+        TS_ASSERT_EQUALS(unassembled_map.GetNumStencils(), 0u);
+        PetscTools::Destroy(unassembled);
+
+        PetscMatSlotMap slot_map(matrix, stencils, 2);
+        TS_ASSERT(slot_map.IsValid());
+        TS_ASSERT_EQUALS(slot_map.GetMatrix(), matrix);
+        TS_ASSERT_EQUALS(slot_map.GetNumStencils(), num_stencils);
+
+        // Re-assemble through the slots, twice over, and compare
+        PetscMatTools::Zero(matrix);
+        for (unsigned pass=0; pass<2; pass++)
+        {
+            slot_map.BeginAdding();
+            for (unsigned i=0; i<num_stencils; i++)
+            {
+                slot_map.AddStencil<2>(i, element_matrix);
+            }
+            slot_map.EndAdding();
+        }
+        PetscMatTools::Finalise(matrix);
+
+        MatScale(reference, 2.0);
+        TS_ASSERT(PetscMatTools::CheckEquality(matrix, reference));
+
+        // A stencil coupling nodes which are not coupled in the matrix has no slots,
+        // so the map is invalid on any process owning one of its rows
+        std::vector<PetscInt> wide_stencils;
+        wide_stencils.push_back(0);
+        wide_stencils.push_back(size-1);
+        PetscInt lo, hi;
+        PetscMatTools::GetOwnershipRange(matrix, lo, hi);
+        PetscMatSlotMap wide_map(matrix, wide_stencils, 2);
+        bool owns_a_row = (lo == 0) || (hi == (PetscInt) size);
+        TS_ASSERT_EQUALS(wide_map.IsValid(), !owns_a_row);
+
+        PetscTools::Destroy(matrix);
+        PetscTools::Destroy(reference);
+    }
+};
+
+#endif /*TESTPETSCMATSLOTMAP_HPP_*/
@@ -0,0 +1,116 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTPETSCVECHALOSCATTER_HPP_
+#define TESTPETSCVECHALOSCATTER_HPP_
+
+#include <cxxtest/TestSuite.h>
+
+#include <set>
+
+#include "PetscVecHaloScatter.hpp"
+#include "PetscTools.hpp"
+
+#include "PetscSetupAndFinalize.hpp"
+
+class TestPetscVecHaloScatter : public CxxTest::TestSuite
+{
+public:
+    void TestFetchingNeighbouringEntries()
+    {
+        const unsigned size = 20u;
+        Vec vec = PetscTools::CreateVec(size);
+        PetscInt lo, hi;
+        VecGetOwnershipRange(vec, &lo, &hi);
+        for (PetscInt i=lo; i<hi; i++)
+        {
+            VecSetValue(vec, i, 2.0*i, INSERT_VALUES);
+        }
+        VecAssemblyBegin(vec);
+        VecAssemblyEnd(vec);
+
+        // Each process reads its own entries, the entries either side, and entry 0 (twice)
+        std::vector<PetscInt> indices;
+        for (PetscInt i=lo; i<hi; i++)
+        {
+            indices.push_back(i);
+        }
+        indices.push_back((lo + size - 1) % size);
+        indices.push_back(hi % size);
+        indices.push_back(0);
+        indices.push_back(0);
+
+        PetscVecHaloScatter halo(vec, indices);
+        TS_ASSERT(halo.IsCompatible(vec));
+
+        // Only entries owned by other processes are fetched, once each
+        std::set<PetscInt> off_process;
+        for (unsigned i=0; i<indices.size(); i++)
+        {
+            if (indices[i] < lo || indices[i] >= hi)
+            {
+                off_process.insert(indices[i]);
+            }
+        }
+        unsigned expected_halo_size = off_process.size();
+        if (PetscTools::IsSequential())
+        {
+            TS_ASSERT_EQUALS(expected_halo_size, 0u);
+        }
+        TS_ASSERT_EQUALS(halo.GetNumHaloEntries(), expected_halo_size);
+
+        for (unsigned pass=0; pass<2; pass++)
+        {
+            halo.BeginAccess(vec);
+            for (unsigned i=0; i<indices.size(); i++)
+            {
+                TS_ASSERT_DELTA(halo[indices[i]], 2.0*indices[i]*(1+pass), 1e-12);
+            }
+            halo.EndAccess();
+
+            // The scatter is reused for new values
+            VecScale(vec, 2.0);
+        }
+
+        // A vector with a different layout isn't compatible
+        Vec other = PetscTools::CreateVec(size+1);
+        TS_ASSERT(!halo.IsCompatible(other));
+
+        PetscTools::Destroy(other);
+        PetscTools::Destroy(vec);
+    }
+};
+
+#endif // TESTPETSCVECHALOSCATTER_HPP_
@@ -167,6 +167,85 @@ public:
         VecScatterDestroy(PETSC_DESTROY_PARAM(first_variable_context));
         VecScatterDestroy(PETSC_DESTROY_PARAM(second_variable_context));
     }
+
+    void TestFusedOperations()
+    {
+        const unsigned PROBLEM_SIZE = 10;
+        DistributedVectorFactory factory(PROBLEM_SIZE);
+
+        // x = [1 2 3 ...], y = [1 4 9 ...], d = [0.5 0.5 ...]
+        Vec x = factory.CreateVec();
+        Vec y = factory.CreateVec();
+        Vec d = factory.CreateVec();
+        Vec w = factory.CreateVec();
+        DistributedVector dist_x = factory.CreateDistributedVector(x);
+        DistributedVector dist_y = factory.CreateDistributedVector(y);
+        DistributedVector dist_d = factory.CreateDistributedVector(d);
+        for (DistributedVector::Iterator index = dist_x.Begin();
+             index!= dist_x.End();
+             ++index)
+        {
+            double value = index.Global+1.0;
+            dist_x[index] = value;
+            dist_y[index] = value*value;
+            dist_d[index] = 0.5;
+        }
+        dist_x.Restore();
+        dist_y.Restore();
+        dist_d.Restore();
+
+        // w = 2x - 3y
+        PetscVecTools::WAXPBY(w, 2.0, x, -3.0, y);
+        {
+            DistributedVector dist_w = factory.CreateDistributedVector(w);
+            for (DistributedVector::Iterator index = dist_w.Begin(); index!= dist_w.End(); ++index)
+            {
+                double value = index.Global+1.0;
+                TS_ASSERT_DELTA(dist_w[index], 2.0*value - 3.0*value*value, 1e-12);
+            }
+            dist_w.Restore();
+        }
+
+        // w = x + 2y - w, with the result aliased to an input
+        PetscVecTools::WAXPBYPCZ(w, 1.0, x, 2.0, y, -1.0, w);
+        {
+            DistributedVector dist_w = factory.CreateDistributedVector(w);
+            for (DistributedVector::Iterator index = dist_w.Begin(); index!= dist_w.End(); ++index)
+            {
+                double value = index.Global+1.0;
+                TS_ASSERT_DELTA(dist_w[index], -value + 5.0*value*value, 1e-12);
+            }
+            dist_w.Restore();
+        }
+
+        // w = y - 4*(d.*x)
+        PetscVecTools::PointwiseMultAndAdd(w, -4.0, d, x, y);
+        {
+            DistributedVector dist_w = factory.CreateDistributedVector(w);
+            for (DistributedVector::Iterator index = dist_w.Begin(); index!= dist_w.End(); ++index)
+            {
+                double value = index.Global+1.0;
+                TS_ASSERT_DELTA(dist_w[index], value*value - 2.0*value, 1e-12);
+            }
+            dist_w.Restore();
+        }
+
+        // x = x + d.*x, in place
+        PetscVecTools::PointwiseMultAndAdd(x, 1.0, d, x, x);
+        {
+            DistributedVector dist_x_after = factory.CreateDistributedVector(x);
+            for (DistributedVector::Iterator index = dist_x_after.Begin(); index!= dist_x_after.End(); ++index)
+            {
+                TS_ASSERT_DELTA(dist_x_after[index], 1.5*(index.Global+1.0), 1e-12);
+            }
+            dist_x_after.Restore();
+        }
+
+        PetscTools::Destroy(x);
+        PetscTools::Destroy(y);
+        PetscTools::Destroy(d);
+        PetscTools::Destroy(w);
+    }
 };
 
 #endif /* TESTPETSCVECTOOLS_HPP_ */
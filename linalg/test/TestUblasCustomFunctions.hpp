@@ -315,6 +315,59 @@ public:
         TS_ASSERT_EQUALS(a(1,2), row1(2));
     }
 
+    void TestSmallMatrixProducts()
+    {
+        // A 3x4 matrix, like the basis function gradients of a tetrahedron
+        c_matrix<double, 3, 4> grad_phi;
+        for (unsigned i=0; i<3; i++)
+        {
+            for (unsigned j=0; j<4; j++)
+            {
+                grad_phi(i,j) = 1.0 + i - 2.0*j + 0.5*i*j;
+            }
+        }
+
+        // A non-symmetric weight, to check the order of the products
+        c_matrix<double, 3, 3> sigma;
+        for (unsigned i=0; i<3; i++)
+        {
+            for (unsigned j=0; j<3; j++)
+            {
+                sigma(i,j) = 0.1*(i+1) + 0.3*j*j;
+            }
+        }
+
+        c_vector<double, 4> phi;
+        phi(0) = 0.1;
+        phi(1) = 0.1;
+        phi(2) = -0.7;
+        phi(3) = 0.1;
+
+        c_matrix<double, 4, 4> ata = TransposeProduct(grad_phi);
+        c_matrix<double, 4, 4> ublas_ata = prod(trans(grad_phi), grad_phi);
+        c_matrix<double, 4, 4> atwa = WeightedTransposeProduct(grad_phi, sigma);
+        c_matrix<double, 3, 4> sigma_grad_phi = prod(sigma, grad_phi);
+        c_matrix<double, 4, 4> ublas_atwa = prod(trans(grad_phi), sigma_grad_phi);
+        c_matrix<double, 4, 4> phi_phi = OuterProduct(phi, phi);
+        c_matrix<double, 4, 4> ublas_phi_phi = outer_prod(phi, phi);
+
+        for (unsigned i=0; i<4; i++)
+        {
+            for (unsigned j=0; j<4; j++)
+            {
+                TS_ASSERT_DELTA(ata(i,j), ublas_ata(i,j), 1e-12);
+                TS_ASSERT_DELTA(atwa(i,j), ublas_atwa(i,j), 1e-12);
+                TS_ASSERT_DELTA(phi_phi(i,j), ublas_phi_phi(i,j), 1e-12);
+            }
+        }
+
+        // Non-square outer product
+        c_vector<double, 2> u = Create_c_vector(2.0, -3.0);
+        c_matrix<double, 2, 4> u_phi = OuterProduct(u, phi);
+        TS_ASSERT_DELTA(u_phi(1,2), 2.1, 1e-12);
+        TS_ASSERT_DELTA(u_phi(0,3), 0.2, 1e-12);
+    }
+
     void TestCreate_c_vector()
     {
         c_vector<double, 1> v1 = Create_c_vector(1);
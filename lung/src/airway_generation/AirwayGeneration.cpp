@@ -67,6 +67,20 @@ void AirwayGeneration::AddApex(unsigned startId, double currentLocation[3], doub
 }
 
 void AirwayGeneration::DistributeGrowthPoints(vtkSmartPointer<vtkPolyData> pAllGrowthPoints, std::set<unsigned>& invalidIds)
+{
+    std::vector<unsigned> growth_point_ids;
+    for (int index = 0; index < pAllGrowthPoints->GetNumberOfPoints(); ++index)
+    {
+        if (!invalidIds.count(index)) // Only copy over valid ids
+        {
+            growth_point_ids.push_back(index);
+        }
+    }
+
+    DistributeGrowthPoints(pAllGrowthPoints, growth_point_ids);
+}
+
+void AirwayGeneration::DistributeGrowthPoints(vtkSmartPointer<vtkPolyData> pAllGrowthPoints, const std::vector<unsigned>& rGrowthPointIds)
 {
     if (mApices.size() == 0) // Nothing to do if we don't have any apices
     {
@@ -91,24 +105,23 @@ void AirwayGeneration::DistributeGrowthPoints(vtkSmartPointer<vtkPolyData> pAllG
     apex_locator->SetDataSet(apex_poly_data);
     apex_locator->BuildLocator();
 
-    for (int index = 0; index < pAllGrowthPoints->GetNumberOfPoints(); ++index)
+    for (std::vector<unsigned>::const_iterator id_iter = rGrowthPointIds.begin();
+         id_iter != rGrowthPointIds.end();
+         ++id_iter)
     {
-        if (!invalidIds.count(index)) // Only copy over valid ids
-        {
-            // Find closest apex
-            double growth_point[3];
-            pAllGrowthPoints->GetPoints()->GetPoint(index, growth_point);
+        // Find closest apex
+        double growth_point[3];
+        pAllGrowthPoints->GetPoints()->GetPoint(*id_iter, growth_point);
 
-            double dist;
-            int closest_apex_id = apex_locator->FindClosestPointWithinRadius(mDistributionRadius, growth_point, dist);
+        double dist;
+        int closest_apex_id = apex_locator->FindClosestPointWithinRadius(mDistributionRadius, growth_point, dist);
 
-            if (closest_apex_id != -1) // No point within the radius
-            {
-                assert(sqrt(dist) <= mDistributionRadius);
+        if (closest_apex_id != -1) // No point within the radius
+        {
+            assert(sqrt(dist) <= mDistributionRadius);
 
-                // Copy this point into the apex
-                mApices[closest_apex_id].mPointCloud->GetPoints()->InsertNextPoint(growth_point);
-            }
+            // Copy this point into the apex
+            mApices[closest_apex_id].mPointCloud->GetPoints()->InsertNextPoint(growth_point);
         }
     }
 
@@ -39,6 +39,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <deque>
 #include <set>
+#include <vector>
 #include <iostream>
 
 #ifdef CHASTE_VTK
@@ -119,6 +120,14 @@ public:
      */
     void DistributeGrowthPoints(vtkSmartPointer<vtkPolyData> pAllGrowthPoints, std::set<unsigned>& invalidIds);
 
+    /**
+     * Distributes some of the growth points to the growth apices
+     *
+     * @param pAllGrowthPoints Polydata containing the growth points
+     * @param rGrowthPointIds The ids of the growth points to distribute, in increasing order
+     */
+    void DistributeGrowthPoints(vtkSmartPointer<vtkPolyData> pAllGrowthPoints, const std::vector<unsigned>& rGrowthPointIds);
+
     /** Returns the apices associated with this generation */
     std::deque<Apex>& GetApices();
 
@@ -54,15 +54,12 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #if ((VTK_MAJOR_VERSION >= 5 && VTK_MINOR_VERSION >= 6) || VTK_MAJOR_VERSION >= 6)
 
-#include "vtkGeometryFilter.h"
 #include "vtkDoubleArray.h"
-#include "vtkPlane.h"
 #include "vtkPoints.h"
 #include "vtkPointData.h"
 #include "vtkPolyVertex.h"
 #include "vtkMassProperties.h"
 #include "vtkMath.h"
-#include "vtkTableBasedClipDataSet.h"
 #include "vtkCellArray.h"
 #include "vtkLine.h"
 #include "vtkUnsignedIntArray.h"
@@ -85,7 +82,8 @@ AirwayGenerator::AirwayGenerator(vtkSmartPointer<vtkPolyData> LobeSurface,
                                                                   mPointLimit(pointLimit),
                                                                   mAngleLimit(angleLimit),
                                                                   mBranchingFraction(branchingFraction),
-                                                                  mPointSelector(vtkSmartPointer<vtkSelectEnclosedPoints>::New())
+                                                                  mPointSelector(vtkSmartPointer<vtkSelectEnclosedPoints>::New()),
+                                                                  mNumThreads(1u)
 
 {
     mAirwayTree->SetPoints(vtkSmartPointer<vtkPoints>::New());
@@ -186,9 +184,13 @@ vtkSmartPointer<vtkPolyData> AirwayGenerator::CreatePointCloud(const double& rPo
     mSeedPointCloud->Allocate(1,1);
     mSeedPointCloud->InsertNextCell(poly_vertex->GetCellType(), poly_vertex->GetPointIds());
 
-    mSeedPointLocator = vtkSmartPointer<vtkPointLocator>::New();
-    mSeedPointLocator->SetDataSet(mSeedPointCloud);
-    mSeedPointLocator->BuildLocator();
+    // Index the seed points in boxes of about eight points each
+    std::vector<c_vector<double, 3> > seed_locations(points->GetNumberOfPoints());
+    for (int i = 0; i < points->GetNumberOfPoints(); ++i)
+    {
+        points->GetPoint(i, seed_locations[i].data());
+    }
+    mpGrowthPointIndex.reset(new AirwayGrowthPointIndex(seed_locations, 2.0*rPointSpacing));
 
     return mSeedPointCloud;
 }
@@ -234,26 +236,37 @@ vtkSmartPointer<vtkPolyData> AirwayGenerator::SplitPointCloud(vtkSmartPointer<vt
                                                               double rOrigin[3],
                                                               bool insideOut)
 {
-    vtkSmartPointer<vtkPlane> clip_plane = vtkSmartPointer<vtkPlane>::New();
-    clip_plane->SetNormal(rNormal);
-    clip_plane->SetOrigin(rOrigin);
+    // A single pass over the points classifying each against the plane. This is much cheaper than
+    // running a clipping pipeline for every apex, and keeps the points in their original order.
+    // Points on the plane go to the normal side, so the two halves never share a point.
+    vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+    points->Allocate(pointCloud->GetNumberOfPoints());
 
-    vtkSmartPointer<vtkTableBasedClipDataSet > clipper = vtkSmartPointer<vtkTableBasedClipDataSet >::New();
-#if VTK_MAJOR_VERSION >= 6
-    clipper->SetInputData(pointCloud);
-#else
-    clipper->SetInputConnection(pointCloud->GetProducerPort());
-#endif
-    clipper->SetClipFunction(clip_plane);
-    clipper->GenerateClippedOutputOff();
-    clipper->SetInsideOut(insideOut);
-    clipper->Update();
+    for (int i = 0; i < pointCloud->GetNumberOfPoints(); ++i)
+    {
+        double point[3];
+        pointCloud->GetPoint(i, point);
 
-    vtkSmartPointer<vtkGeometryFilter> filter = vtkSmartPointer<vtkGeometryFilter>::New();
-    filter->SetInputConnection(clipper->GetOutputPort());
-    filter->Update();
+        if (IsOnNormalSide(point, rNormal, rOrigin) != insideOut)
+        {
+            points->InsertNextPoint(point);
+        }
+    }
 
-    return filter->GetOutput();
+    vtkSmartPointer<vtkPolyData> cloud = vtkSmartPointer<vtkPolyData>::New();
+    cloud->SetPoints(points);
+
+    // Some vtk filters get confused by individual points, so we add each point to a poly_vertex to keep them happy
+    vtkSmartPointer<vtkPolyVertex> poly_vertex = vtkSmartPointer<vtkPolyVertex>::New();
+    poly_vertex->GetPointIds()->SetNumberOfIds(points->GetNumberOfPoints());
+    for (int i = 0; i < points->GetNumberOfPoints(); ++i)
+    {
+        poly_vertex->GetPointIds()->SetId(i, i);
+    }
+    cloud->Allocate(1, 1);
+    cloud->InsertNextCell(poly_vertex->GetCellType(), poly_vertex->GetPointIds());
+
+    return cloud;
 }
 
 void AirwayGenerator::AddInitialApex(double rStartLocation[3],
@@ -303,9 +316,18 @@ std::set<unsigned>& AirwayGenerator::GetInvalidIds()
 
 void AirwayGenerator::GrowApex(Apex& rApex)
 {
+    ApplyApexGrowthPlan(rApex, PlanApexGrowth(rApex));
+}
+
+AirwayGenerator::ApexGrowthPlan AirwayGenerator::PlanApexGrowth(Apex& rApex)
+{
+    ApexGrowthPlan plan;
+    plan.mNumPoints[0] = 0u;
+    plan.mNumPoints[1] = 0u;
+
     if (rApex.mPointCloud->GetNumberOfPoints() == 0)
     {
-        return; //Can't grow an apex without any points associated to it
+        return plan; //Can't grow an apex without any points associated to it
     }
 
     // Determine the current point cloud centre of mass
@@ -331,58 +353,89 @@ void AirwayGenerator::GrowApex(Apex& rApex)
     assert(vtkMath::Norm(normal) > 1e-10);
     vtkMath::Normalize(normal);
 
-    // Split the point cloud twice, creating new apices if needed. Should this be bundled up into a method/loop?
+    // Split the point cloud in two, as SplitPointCloud does, keeping the points in order
+    std::vector<int> halves[2];
+    for (int i = 0; i < rApex.mPointCloud->GetNumberOfPoints(); ++i)
     {
-        vtkSmartPointer<vtkPolyData> cloud = SplitPointCloud(rApex.mPointCloud,
-                                                             normal,
-                                                             centre,
-                                                             false);
+        double point[3];
+        rApex.mPointCloud->GetPoint(i, point);
+        halves[IsOnNormalSide(point, normal, centre) ? 0 : 1].push_back(i);
+    }
 
-        if (cloud->GetNumberOfPoints() > 0)
+    for (unsigned side = 0; side < 2; ++side)
+    {
+        const std::vector<int>& r_half = halves[side];
+        plan.mNumPoints[side] = r_half.size();
+        if (r_half.empty())
         {
-            double end_location[3];
-            vtkIdType end_id = InsertBranch(cloud, rApex.mStartId, rApex.mOriginalDirection, end_location);
+            continue;
+        }
 
-            if (std::sqrt(vtkMath::Distance2BetweenPoints(mAirwayTree->GetPoints()->GetPoint(rApex.mStartId), end_location)) > mLengthLimit
-                && (unsigned)cloud->GetNumberOfPoints() > mPointLimit
-                && end_id != -1)
+        // The branch grows towards the centre of mass of this half, subject to the angle and length limits
+        double* end_location = plan.mEndLocations[side];
+        end_location[0] = 0.0;
+        end_location[1] = 0.0;
+        end_location[2] = 0.0;
+        for (std::vector<int>::const_iterator iter = r_half.begin(); iter != r_half.end(); ++iter)
+        {
+            double point[3];
+            rApex.mPointCloud->GetPoint(*iter, point);
+            for (unsigned j = 0; j < 3; ++j)
             {
-                double end_direction[3];
-                vtkMath::Subtract(end_location, rApex.mCurrentLocation, end_direction);
-                vtkMath::Normalize(end_direction);
-                AddApex(end_id, end_location, end_direction, rApex.mOriginalDirection, rApex.mGeneration + 1);
+                end_location[j] += point[j];
             }
-            else
+        }
+        for (unsigned j = 0; j < 3; ++j)
+        {
+            end_location[j] /= r_half.size();
+        }
+
+        CheckBranchAngleLengthAndAdjust(rApex.mStartId, rApex.mOriginalDirection, end_location);
+
+        // Find the point to invalidate should this branch turn out to be terminal
+        double closest_distance2 = DBL_MAX;
+        for (std::vector<int>::const_iterator iter = r_half.begin(); iter != r_half.end(); ++iter)
+        {
+            double point[3];
+            rApex.mPointCloud->GetPoint(*iter, point);
+            double distance2 = vtkMath::Distance2BetweenPoints(end_location, point);
+            if (distance2 < closest_distance2)
             {
-                InvalidateClosestPoint(end_location, cloud);
+                closest_distance2 = distance2;
+                std::copy(point, point+3, plan.mClosestPoints[side]);
             }
         }
     }
 
-    {
-        vtkSmartPointer<vtkPolyData> cloud = SplitPointCloud(rApex.mPointCloud,
-                                                             normal,
-                                                             centre,
-                                                             true);
+    return plan;
+}
 
-        if (cloud->GetNumberOfPoints() > 0)
+void AirwayGenerator::ApplyApexGrowthPlan(Apex& rApex, const ApexGrowthPlan& rPlan)
+{
+    // The normal side is always added first
+    for (unsigned side = 0; side < 2; ++side)
+    {
+        if (rPlan.mNumPoints[side] == 0u)
         {
-            double end_location[3];
-            vtkIdType end_id = InsertBranch(cloud, rApex.mStartId, rApex.mOriginalDirection, end_location);
+            continue;
+        }
 
-            if (std::sqrt(vtkMath::Distance2BetweenPoints(mAirwayTree->GetPoints()->GetPoint(rApex.mStartId), end_location)) > mLengthLimit
-                && (unsigned)cloud->GetNumberOfPoints() > mPointLimit
-                && end_id != -1)
-            {
-                double end_direction[3];
-                vtkMath::Subtract(end_location, rApex.mCurrentLocation, end_direction);
-                vtkMath::Normalize(end_direction);
-                AddApex(end_id, end_location, end_direction, rApex.mOriginalDirection, rApex.mGeneration + 1);
-            }
-            else
-            {
-                InvalidateClosestPoint(end_location, cloud);
-            }
+        double end_location[3];
+        std::copy(rPlan.mEndLocations[side], rPlan.mEndLocations[side]+3, end_location);
+        vtkIdType end_id = AddBranchToTree(rApex.mStartId, end_location);
+
+        if (std::sqrt(vtkMath::Distance2BetweenPoints(mAirwayTree->GetPoints()->GetPoint(rApex.mStartId), end_location)) > mLengthLimit
+            && rPlan.mNumPoints[side] > mPointLimit
+            && end_id != -1)
+        {
+            double end_direction[3];
+            vtkMath::Subtract(end_location, rApex.mCurrentLocation, end_direction);
+            vtkMath::Normalize(end_direction);
+            AddApex(end_id, end_location, end_direction, rApex.mOriginalDirection, rApex.mGeneration + 1);
+        }
+        else
+        {
+            InvalidateSeedPoint(rPlan.mClosestPoints[side]);
         }
     }
 }
@@ -396,6 +449,11 @@ vtkIdType AirwayGenerator::InsertBranch(vtkSmartPointer<vtkPolyData> pPointCloud
 
     CheckBranchAngleLengthAndAdjust(startId, originalDirection, endLocation);
 
+    return AddBranchToTree(startId, endLocation);
+}
+
+vtkIdType AirwayGenerator::AddBranchToTree(unsigned startId, double endLocation[3])
+{
     // If the branch point isn't inside the surface then terminate
     if (!mPointSelector->IsInsideSurface(endLocation))
     {
@@ -418,16 +476,46 @@ void AirwayGenerator::InvalidateClosestPoint(double point[3], vtkSmartPointer<vt
 {
     assert(searchCloud->GetNumberOfPoints() > 0);
 
-    vtkSmartPointer<vtkPointLocator> locator = vtkSmartPointer<vtkPointLocator>::New();
-    locator->SetDataSet(searchCloud);
-    locator->BuildLocator();
+    // A linear scan is cheaper than building a locator for a single query
+    double closest_point[3];
+    double closest_distance2 = DBL_MAX;
+    for (int i = 0; i < searchCloud->GetNumberOfPoints(); ++i)
+    {
+        double search_point[3];
+        searchCloud->GetPoint(i, search_point);
+        double distance2 = vtkMath::Distance2BetweenPoints(point, search_point);
+        if (distance2 < closest_distance2)
+        {
+            closest_distance2 = distance2;
+            std::copy(search_point, search_point+3, closest_point);
+        }
+    }
+
+    InvalidateSeedPoint(closest_point);
+}
 
-    unsigned search_cloud_id = locator->FindClosestPoint(point);
+void AirwayGenerator::InvalidateSeedPoint(const double point[3])
+{
+    assert(mpGrowthPointIndex);
 
-    unsigned invalid_id = mSeedPointLocator->FindClosestPoint(searchCloud->GetPoints()->GetPoint(search_cloud_id));
+    // Invalid points have already been removed from the index, so a point is never invalidated twice
+    c_vector<double, 3> location;
+    std::copy(point, point+3, location.begin());
+    int invalid_id = mpGrowthPointIndex->FindClosestPoint(location);
+    assert(invalid_id != -1);
 
-    assert(!mInvalidIds.count(invalid_id)); //Need to modify the point splitter to ensure this.
     mInvalidIds.insert(invalid_id);
+    mpGrowthPointIndex->RemovePoint(invalid_id);
+}
+
+bool AirwayGenerator::IsOnNormalSide(const double point[3], const double normal[3], const double origin[3])
+{
+    double signed_distance = 0.0;
+    for (unsigned j = 0; j < 3; ++j)
+    {
+        signed_distance += (point[j] - origin[j])*normal[j];
+    }
+    return signed_distance >= 0.0;
 }
 
 void AirwayGenerator::Generate()
@@ -436,13 +524,26 @@ void AirwayGenerator::Generate()
          gen_iter != mGenerations.end();
          ++gen_iter)
     {
-        gen_iter->DistributeGrowthPoints(mSeedPointCloud, mInvalidIds);
+        assert(mpGrowthPointIndex);
+        gen_iter->DistributeGrowthPoints(mSeedPointCloud, mpGrowthPointIndex->rGetPointIds());
+
+        // The apices of a generation grow into disjoint point clouds, so their branches can be planned
+        // concurrently. Only adding the branches touches shared state, and that is done in apex order.
+        std::deque<Apex>& r_apices = gen_iter->GetApices();
+        const int num_apices = static_cast<int>(r_apices.size());
+        std::vector<ApexGrowthPlan> plans(num_apices);
+
+#ifdef CHASTE_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mNumThreads) if(mNumThreads > 1u)
+#endif // CHASTE_OPENMP
+        for (int i = 0; i < num_apices; i++)
+        {
+            plans[i] = PlanApexGrowth(r_apices[i]);
+        }
 
-        for (std::deque<Apex>::iterator apex_iter = gen_iter->GetApices().begin();
-            apex_iter != gen_iter->GetApices().end();
-            ++apex_iter)
+        for (int i = 0; i < num_apices; i++)
         {
-            GrowApex(*apex_iter);
+            ApplyApexGrowthPlan(r_apices[i], plans[i]);
         }
     }
 }
@@ -640,6 +741,20 @@ void AirwayGenerator::RadiiProcessPoint(unsigned pointId, unsigned startId, std:
     radii->SetValue(pointId, radius);
 }
 
+void AirwayGenerator::SetNumberOfThreads(unsigned numThreads)
+{
+    if (numThreads == 0u)
+    {
+        EXCEPTION("The number of airway generation threads must be at least one.");
+    }
+    mNumThreads = numThreads;
+}
+
+unsigned AirwayGenerator::GetNumberOfThreads() const
+{
+    return mNumThreads;
+}
+
 bool AirwayGenerator::IsInsideLobeSurface(double point[3])
 {
     return mPointSelector->IsInsideSurface(point);
@@ -38,9 +38,13 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define AIRWAY_GENERATOR_HPP_
 
 #include "AirwayGeneration.hpp"
+#include "AirwayGrowthPointIndex.hpp"
 
 #include <deque>
 #include <set>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
 
 #ifdef CHASTE_VTK
 
@@ -62,6 +66,10 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  * Tawhai et. al. 2004. J Appl Physiol. This class only handles growing airways
  * into a single  contiguous volume, such as a single lobe. For generation of a complete airway for a pair of lungs
  * see `MultiLobeAirwayGenerator`.
+ *
+ * The seed points are held in an AirwayGrowthPointIndex, from which points are removed as they are
+ * invalidated. Within a generation the apices are planned concurrently (see SetNumberOfThreads) and the
+ * resulting branches are then added in apex order, so the tree does not depend on the number of threads.
  */
 class AirwayGenerator
 {
@@ -146,6 +154,9 @@ public:
     /**
      * Splits a point cloud using a clipping plane
      *
+     * Points lying on the plane belong to the half in the direction of the normal, so each point
+     * is in exactly one of the two halves.
+     *
      * @param pointCloud The set of points to be split
      * @param rNormal The normal of a plane to split the point cloud with
      * @param rOrigin A point on a plane to split the point cloud with
@@ -301,8 +312,37 @@ public:
      */
     void WriteDecomposedAirways(std::string rOutputDirectory, std::string rOutputFileNameRoot);
 
+    /**
+     * Set the number of OpenMP threads used to plan the growth of the apices in each generation.
+     * Has no effect unless Chaste is built with OpenMP.
+     *
+     * @param numThreads the number of threads (defaults to 1)
+     */
+    void SetNumberOfThreads(unsigned numThreads);
+
+    /**
+     * @return the number of OpenMP threads used to plan apex growth
+     */
+    unsigned GetNumberOfThreads() const;
+
 private:
 
+    /**
+     * The two branches to be grown from an apex, one on each side of its splitting plane.
+     * Computing a plan only reads the generator, so the apices of a generation can be planned concurrently.
+     */
+    struct ApexGrowthPlan
+    {
+        /** The number of points on each side of the splitting plane (normal side first) */
+        unsigned mNumPoints[2];
+
+        /** The end location of the branch on each side */
+        double mEndLocations[2][3];
+
+        /** The point on each side closest to the branch end, invalidated if the branch is terminal */
+        double mClosestPoints[2][3];
+    };
+
     /** An enclosed surface representing the lobe geometry */
     vtkSmartPointer<vtkPolyData> mLobeSurface;
 
@@ -312,8 +352,8 @@ private:
     /** The cloud of seed points */
     vtkSmartPointer<vtkPolyData> mSeedPointCloud;
 
-    /** A point locator for easy access to the seed point cloud */
-    vtkSmartPointer<vtkPointLocator> mSeedPointLocator;
+    /** An index over the seed points that are still valid for use as growth points */
+    boost::shared_ptr<AirwayGrowthPointIndex> mpGrowthPointIndex;
 
     /** All the growth generations */
     std::deque<AirwayGeneration> mGenerations;
@@ -345,6 +385,49 @@ private:
     /** The initial radii corresponding to the initial node indices */
     std::vector<double> mStartRadii;
 
+    /** The number of OpenMP threads used to plan apex growth */
+    unsigned mNumThreads;
+
+    /**
+     * Works out the branches to grow from an apex without changing the tree.
+     *
+     * @param rApex The apex to plan
+     * @return The plan
+     */
+    ApexGrowthPlan PlanApexGrowth(Apex& rApex);
+
+    /**
+     * Adds the branches of a plan to the tree, creating new apices or invalidating seed points as needed.
+     *
+     * @param rApex The apex the plan was made for
+     * @param rPlan The plan
+     */
+    void ApplyApexGrowthPlan(Apex& rApex, const ApexGrowthPlan& rPlan);
+
+    /**
+     * Adds a branch to the airway tree, unless its end lies outside the lobe surface
+     *
+     * @param startId The id of the start point
+     * @param endLocation The end location of the branch
+     * @return The ID of the inserted branch end or -1 if it is outside the host volume
+     */
+    vtkIdType AddBranchToTree(unsigned startId, double endLocation[3]);
+
+    /**
+     * Marks a seed point as invalid and removes it from the growth point index
+     *
+     * @param point The location of the seed point
+     */
+    void InvalidateSeedPoint(const double point[3]);
+
+    /**
+     * @param point A point
+     * @param normal The normal of a plane
+     * @param origin A point on the plane
+     * @return Whether the point lies on the plane or on the side the normal points towards
+     */
+    static bool IsOnNormalSide(const double point[3], const double normal[3], const double origin[3]);
+
     /**
      * Private method to help recursively calculate the Horsfield order of the tree
      *
@@ -0,0 +1,216 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "AirwayGrowthPointIndex.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+#include <cstdlib>
+
+AirwayGrowthPointIndex::AirwayGrowthPointIndex(const std::vector<c_vector<double, 3> >& rPoints, double boxWidth)
+    : mPoints(rPoints),
+      mRemoved(rPoints.size(), false),
+      mNumPoints(rPoints.size()),
+      mPointIdsNeedCompacting(false),
+      mBoxWidth(boxWidth)
+{
+    assert(boxWidth > 0.0);
+
+    c_vector<double, 3> max_corner = zero_vector<double>(3);
+    mMinCorner = zero_vector<double>(3);
+    for (unsigned i = 0; i < mPoints.size(); ++i)
+    {
+        for (unsigned d = 0; d < 3; ++d)
+        {
+            if (i == 0 || mPoints[i][d] < mMinCorner[d])
+            {
+                mMinCorner[d] = mPoints[i][d];
+            }
+            if (i == 0 || mPoints[i][d] > max_corner[d])
+            {
+                max_corner[d] = mPoints[i][d];
+            }
+        }
+    }
+
+    for (unsigned d = 0; d < 3; ++d)
+    {
+        mNumBoxes[d] = static_cast<int>(std::floor((max_corner[d] - mMinCorner[d])/mBoxWidth)) + 1;
+    }
+    mBoxes.resize(mNumBoxes[0]*mNumBoxes[1]*mNumBoxes[2]);
+
+    // Points are added in id order, so each box (and mPointIds) is sorted
+    mPointIds.reserve(mPoints.size());
+    for (unsigned i = 0; i < mPoints.size(); ++i)
+    {
+        mBoxes[GetBoxIndex(CalculateBoxCoordinates(mPoints[i]))].push_back(i);
+        mPointIds.push_back(i);
+    }
+}
+
+void AirwayGrowthPointIndex::RemovePoint(unsigned pointId)
+{
+    assert(pointId < mPoints.size());
+    assert(!mRemoved[pointId]);
+
+    std::vector<unsigned>& r_box = mBoxes[GetBoxIndex(CalculateBoxCoordinates(mPoints[pointId]))];
+    r_box.erase(std::find(r_box.begin(), r_box.end(), pointId));
+
+    mRemoved[pointId] = true;
+    mNumPoints--;
+    mPointIdsNeedCompacting = true;
+}
+
+bool AirwayGrowthPointIndex::HasPoint(unsigned pointId) const
+{
+    return pointId < mPoints.size() && !mRemoved[pointId];
+}
+
+unsigned AirwayGrowthPointIndex::GetNumPoints() const
+{
+    return mNumPoints;
+}
+
+const std::vector<unsigned>& AirwayGrowthPointIndex::rGetPointIds()
+{
+    // Removed ids are dropped lazily, so a generation that removes many points only pays for one pass
+    if (mPointIdsNeedCompacting)
+    {
+        std::vector<unsigned>::iterator kept = mPointIds.begin();
+        for (std::vector<unsigned>::iterator iter = mPointIds.begin(); iter != mPointIds.end(); ++iter)
+        {
+            if (!mRemoved[*iter])
+            {
+                *kept++ = *iter;
+            }
+        }
+        mPointIds.erase(kept, mPointIds.end());
+        mPointIdsNeedCompacting = false;
+    }
+    return mPointIds;
+}
+
+int AirwayGrowthPointIndex::FindClosestPoint(const c_vector<double, 3>& rLocation) const
+{
+    if (mNumPoints == 0u)
+    {
+        return -1;
+    }
+
+    const c_vector<int, 3> centre = CalculateBoxCoordinates(rLocation);
+
+    // The furthest shell of boxes (in the max norm) around the centre box that still meets the grid
+    int max_shell = 0;
+    for (unsigned d = 0; d < 3; ++d)
+    {
+        max_shell = std::max(max_shell, std::max(std::abs(centre[d]), std::abs(mNumBoxes[d] - 1 - centre[d])));
+    }
+
+    int closest_id = -1;
+    double closest_distance2 = DBL_MAX;
+
+    for (int shell = 0; shell <= max_shell; ++shell)
+    {
+        // Every point in this shell is at least (shell-1) box widths away, so stop once nothing here can be closer
+        if (closest_id != -1 && shell > 0)
+        {
+            double min_distance = (shell - 1)*mBoxWidth;
+            if (min_distance*min_distance > closest_distance2)
+            {
+                break;
+            }
+        }
+
+        c_vector<int, 3> lo;
+        c_vector<int, 3> hi;
+        for (unsigned d = 0; d < 3; ++d)
+        {
+            lo[d] = std::max(centre[d] - shell, 0);
+            hi[d] = std::min(centre[d] + shell, mNumBoxes[d] - 1);
+        }
+
+        c_vector<int, 3> box;
+        for (box[0] = lo[0]; box[0] <= hi[0]; ++box[0])
+        {
+            for (box[1] = lo[1]; box[1] <= hi[1]; ++box[1])
+            {
+                // Unless we're on an x or y face of the shell, only the two z faces belong to it
+                bool on_face = std::abs(box[0] - centre[0]) == shell || std::abs(box[1] - centre[1]) == shell;
+                int z_step = (on_face || shell == 0) ? 1 : 2*shell;
+
+                for (box[2] = centre[2] - shell; box[2] <= centre[2] + shell; box[2] += z_step)
+                {
+                    if (box[2] < lo[2] || box[2] > hi[2])
+                    {
+                        continue;
+                    }
+
+                    const std::vector<unsigned>& r_box = mBoxes[GetBoxIndex(box)];
+                    for (std::vector<unsigned>::const_iterator iter = r_box.begin(); iter != r_box.end(); ++iter)
+                    {
+                        double distance2 = inner_prod(mPoints[*iter] - rLocation, mPoints[*iter] - rLocation);
+                        if (distance2 < closest_distance2 || (distance2 == closest_distance2 && (int)*iter < closest_id))
+                        {
+                            closest_distance2 = distance2;
+                            closest_id = *iter;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return closest_id;
+}
+
+c_vector<int, 3> AirwayGrowthPointIndex::CalculateBoxCoordinates(const c_vector<double, 3>& rLocation) const
+{
+    c_vector<int, 3> coordinates;
+    for (unsigned d = 0; d < 3; ++d)
+    {
+        coordinates[d] = static_cast<int>(std::floor((rLocation[d] - mMinCorner[d])/mBoxWidth));
+    }
+    return coordinates;
+}
+
+unsigned AirwayGrowthPointIndex::GetBoxIndex(const c_vector<int, 3>& rCoordinates) const
+{
+    assert(rCoordinates[0] >= 0 && rCoordinates[0] < mNumBoxes[0]);
+    assert(rCoordinates[1] >= 0 && rCoordinates[1] < mNumBoxes[1]);
+    assert(rCoordinates[2] >= 0 && rCoordinates[2] < mNumBoxes[2]);
+    return rCoordinates[0] + mNumBoxes[0]*(rCoordinates[1] + mNumBoxes[1]*rCoordinates[2]);
+}
@@ -0,0 +1,136 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef AIRWAYGROWTHPOINTINDEX_HPP_
+#define AIRWAYGROWTHPOINTINDEX_HPP_
+
+#include <vector>
+
+#include "UblasVectorInclude.hpp"
+
+/**
+ * A uniform box index over the growth (seed) points used by the airway generator.
+ *
+ * Points can be removed as they are invalidated, after which they are neither returned by
+ * FindClosestPoint nor listed by rGetPointIds, so the generator never has to rescan the
+ * invalid points each generation.
+ */
+class AirwayGrowthPointIndex
+{
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param rPoints The locations of the growth points. The index of a point in this vector is its id.
+     * @param boxWidth The width of the boxes; a few times the point spacing works well
+     */
+    AirwayGrowthPointIndex(const std::vector<c_vector<double, 3> >& rPoints, double boxWidth);
+
+    /**
+     * Removes a point from the index. Removing a point twice is an error.
+     *
+     * @param pointId The id of the point to remove
+     */
+    void RemovePoint(unsigned pointId);
+
+    /**
+     * @param pointId The id of a point
+     * @return Whether the point is still in the index
+     */
+    bool HasPoint(unsigned pointId) const;
+
+    /**
+     * @return The number of points still in the index
+     */
+    unsigned GetNumPoints() const;
+
+    /**
+     * @return The ids of the points still in the index, in increasing order
+     */
+    const std::vector<unsigned>& rGetPointIds();
+
+    /**
+     * Finds the point still in the index that is closest to a location. Ties are broken in
+     * favour of the lowest id.
+     *
+     * @param rLocation The location to search from; it may lie outside the indexed points
+     * @return The id of the closest point, or -1 if the index is empty
+     */
+    int FindClosestPoint(const c_vector<double, 3>& rLocation) const;
+
+private:
+
+    /** The locations of all the points, including those that have been removed */
+    std::vector<c_vector<double, 3> > mPoints;
+
+    /** Whether each point has been removed */
+    std::vector<bool> mRemoved;
+
+    /** The ids of the points still in the index; may contain removed points until compacted */
+    std::vector<unsigned> mPointIds;
+
+    /** The number of points still in the index */
+    unsigned mNumPoints;
+
+    /** Whether mPointIds contains removed points */
+    bool mPointIdsNeedCompacting;
+
+    /** The ids of the points still in the index, by box */
+    std::vector<std::vector<unsigned> > mBoxes;
+
+    /** The lower corner of the box grid */
+    c_vector<double, 3> mMinCorner;
+
+    /** The box width */
+    double mBoxWidth;
+
+    /** The number of boxes in each direction */
+    c_vector<int, 3> mNumBoxes;
+
+    /**
+     * @param rLocation A location
+     * @return The (unclamped) box coordinates containing the location
+     */
+    c_vector<int, 3> CalculateBoxCoordinates(const c_vector<double, 3>& rLocation) const;
+
+    /**
+     * @param rCoordinates Box coordinates inside the grid
+     * @return The index of the box in mBoxes
+     */
+    unsigned GetBoxIndex(const c_vector<int, 3>& rCoordinates) const;
+};
+
+#endif // AIRWAYGROWTHPOINTINDEX_HPP_
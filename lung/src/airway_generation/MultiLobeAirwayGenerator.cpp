@@ -41,6 +41,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "VtkMeshWriter.hpp"
 #include "VtkMeshReader.hpp"
 #include "CmguiMeshWriter.hpp"
+#include "OpenMpExceptionCollector.hpp"
 
 #ifdef CHASTE_VTK
 #define _BACKWARD_BACKWARD_WARNING_H 1 //Cut out the strstream deprecated warning for now (gcc4.3)
@@ -58,7 +59,8 @@ MultiLobeAirwayGenerator::MultiLobeAirwayGenerator(TetrahedralMesh<1,3>& rAirway
                                                                                          mAirwaysMesh(rAirwaysMesh),
                                                                                          mNumberOfPointsPerLung(0),
                                                                                          mPointVolume(-1),
-                                                                                         mPointDistanceLimit(pointDistanceLimit)
+                                                                                         mPointDistanceLimit(pointDistanceLimit),
+                                                                                         mNumThreads(1u)
 
 {
 }
@@ -272,6 +274,20 @@ void  MultiLobeAirwayGenerator::SetDiameterRatio(const double& rDiameterRatio)
     mDiameterRatio = rDiameterRatio;
 }
 
+void MultiLobeAirwayGenerator::SetNumberOfThreads(unsigned numThreads)
+{
+    if (numThreads == 0u)
+    {
+        EXCEPTION("The number of airway generation threads must be at least one.");
+    }
+    mNumThreads = numThreads;
+}
+
+unsigned MultiLobeAirwayGenerator::GetNumberOfThreads() const
+{
+    return mNumThreads;
+}
+
 void MultiLobeAirwayGenerator::Generate(std::string rOutputDirectory, std::string rBaseName)
 {
     vtkSmartPointer<vtkAppendFilter> append_filter = vtkSmartPointer<vtkAppendFilter>::New();
@@ -329,17 +345,35 @@ void MultiLobeAirwayGenerator::Generate(std::string rOutputDirectory, std::strin
     append_filter->AddInput(major_airways_reader->GetOutput());
 #endif
 
-    // Loop over generators, generate and merge the results
+    // Grow each lobe. The lobes share no state, so they are independent subtrees that can grow concurrently.
+    const int num_lobes = static_cast<int>(mLobeGenerators.size());
+    OpenMpExceptionCollector exception_collector;
+#ifdef CHASTE_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mNumThreads) if(mNumThreads > 1u)
+#endif // CHASTE_OPENMP
+    for (int i = 0; i < num_lobes; i++)
+    {
+        try
+        {
+            AirwayGenerator* p_generator = mLobeGenerators[i].first;
+            p_generator->Generate();
+            p_generator->CalculateHorsfieldOrder();
+            p_generator->CalculateRadii(mDiameterRatio);
+            p_generator->MarkStartIds();
+        }
+        catch (...)
+        {
+            exception_collector.Capture();
+        }
+    }
+    exception_collector.RethrowIfAny();
+
+    // Merge the results in lobe order
     typedef std::pair<AirwayGenerator*, LungLocation> pair_type;
     for (std::vector<pair_type>::iterator generators_iter = mLobeGenerators.begin();
          generators_iter != mLobeGenerators.end();
          ++generators_iter)
     {
-        generators_iter->first->Generate();
-        generators_iter->first->CalculateHorsfieldOrder();
-        generators_iter->first->CalculateRadii(mDiameterRatio);
-        generators_iter->first->MarkStartIds();
-
 #if VTK_MAJOR_VERSION >= 6
         append_filter->AddInputData(generators_iter->first->GetAirwayTree());
 #else
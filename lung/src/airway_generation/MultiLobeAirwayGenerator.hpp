@@ -168,6 +168,20 @@ public:
      */
     void SetDiameterRatio(const double& rDiameterRatio);
 
+    /**
+     * Set the number of OpenMP threads used to grow the lobes. Each lobe generator owns all of its
+     * VTK objects, so the lobes are grown concurrently and only merged afterwards.
+     * Has no effect unless Chaste is built with OpenMP.
+     *
+     * @param numThreads the number of threads (defaults to 1)
+     */
+    void SetNumberOfThreads(unsigned numThreads);
+
+    /**
+     * @return the number of OpenMP threads used to grow the lobes
+     */
+    unsigned GetNumberOfThreads() const;
+
     /**
      * Generates a complete airway tree and writes it to the given file name.
      *
@@ -207,6 +221,9 @@ private:
 
     /** A flag to turn on the point distance limit heuristic */
     bool mPointDistanceLimit;
+
+    /** The number of OpenMP threads used to grow the lobes */
+    unsigned mNumThreads;
 };
 
 #endif // (VTK_MAJOR_VERSION >= 5 && VTK_MINOR_VERSION >= 6) || VTK_MAJOR_VERSION >= 6
@@ -36,13 +36,24 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "AirwayPropertiesCalculator.hpp"
 
+#include <climits>
+
+#include "Exception.hpp"
+#include "OpenMpExceptionCollector.hpp"
+#include "UblasCustomFunctions.hpp"
+
 AirwayPropertiesCalculator::AirwayPropertiesCalculator(TetrahedralMesh<1,3>& rAirwaysMesh,
                                                        unsigned rootIndex,
                                                        bool radiusOnEdge) :
                                                            mAirwaysMesh(rAirwaysMesh),
                                                            mOutletNodeIndex(rootIndex),
                                                            mWalker(mAirwaysMesh, mOutletNodeIndex),
-                                                           mRadiusOnEdge(radiusOnEdge)
+                                                           mRadiusOnEdge(radiusOnEdge),
+                                                           mNumThreads(1u),
+                                                           mBranchQuantitiesAreCached(false),
+                                                           mBranchPropertiesCalculated(false),
+                                                           mSubtreePropertiesCalculated(false),
+                                                           mUpstreamPropertiesCalculated(false)
 {
     // Get the head element & process
     Node<3>* p_node = mAirwaysMesh.GetNode(mOutletNodeIndex);
@@ -55,6 +66,7 @@ AirwayPropertiesCalculator::AirwayPropertiesCalculator(TetrahedralMesh<1,3>& rAi
 
     mBranches.push_back(p_head_branch);
     SetupBranches(p_element, p_head_branch);
+    SetupTreeStructure();
 }
 
 AirwayPropertiesCalculator::~AirwayPropertiesCalculator()
@@ -123,6 +135,321 @@ void AirwayPropertiesCalculator::SetupBranches(Element<1,3>* pElement, AirwayBra
     }
 }
 
+void AirwayPropertiesCalculator::SetupTreeStructure()
+{
+    const unsigned num_branches = mBranches.size();
+
+    mParentIndices.assign(num_branches, UINT_MAX);
+    mSiblingIndices.assign(num_branches, UINT_MAX);
+    mChildStarts.assign(num_branches + 1, 0u);
+    mChildIndices.clear();
+    for (unsigned branch_idx = 0; branch_idx < num_branches; branch_idx++)
+    {
+        AirwayBranch* p_branch = mBranches[branch_idx];
+        assert(p_branch->GetIndex() == branch_idx);
+
+        if (p_branch->GetParent() != nullptr)
+        {
+            mParentIndices[branch_idx] = p_branch->GetParent()->GetIndex();
+        }
+        if (p_branch->GetSibling() != nullptr)
+        {
+            mSiblingIndices[branch_idx] = p_branch->GetSibling()->GetIndex();
+        }
+
+        std::vector<AirwayBranch*> all_children = p_branch->GetAllChildren();
+        for (unsigned child_idx = 0; child_idx < all_children.size(); child_idx++)
+        {
+            mChildIndices.push_back(all_children[child_idx]->GetIndex());
+        }
+        mChildStarts[branch_idx + 1] = mChildIndices.size();
+    }
+
+    // Children always have higher indices than their parents, so one forward sweep finds the primary paths
+    mIsOnPrimaryPath.assign(num_branches, false);
+    mIsOnPrimaryPath[0] = true;
+    for (unsigned branch_idx = 0; branch_idx < num_branches; branch_idx++)
+    {
+        if (mIsOnPrimaryPath[branch_idx])
+        {
+            if (mBranches[branch_idx]->GetChildOne() != nullptr)
+            {
+                mIsOnPrimaryPath[mBranches[branch_idx]->GetChildOne()->GetIndex()] = true;
+            }
+            if (mBranches[branch_idx]->GetChildTwo() != nullptr)
+            {
+                mIsOnPrimaryPath[mBranches[branch_idx]->GetChildTwo()->GetIndex()] = true;
+            }
+        }
+    }
+
+    // Depth-first walk with an explicit stack of (branch, next child to visit), recording branches in post order
+    mPostOrder.clear();
+    mPostOrder.reserve(num_branches);
+    mPostOrderPositions.assign(num_branches, 0u);
+    mSubtreeSizes.assign(num_branches, 1u);
+
+    std::vector<std::pair<unsigned, unsigned> > stack;
+    stack.push_back(std::make_pair(0u, 0u));
+    while (!stack.empty())
+    {
+        unsigned branch_idx = stack.back().first;
+        unsigned next_child = mChildStarts[branch_idx] + stack.back().second;
+        if (next_child < mChildStarts[branch_idx + 1])
+        {
+            stack.back().second++;
+            stack.push_back(std::make_pair(mChildIndices[next_child], 0u));
+        }
+        else
+        {
+            mPostOrderPositions[branch_idx] = mPostOrder.size();
+            mPostOrder.push_back(branch_idx);
+            stack.pop_back();
+            if (!stack.empty())
+            {
+                mSubtreeSizes[stack.back().first] += mSubtreeSizes[branch_idx];
+            }
+        }
+    }
+    assert(mPostOrder.size() == num_branches);
+}
+
+void AirwayPropertiesCalculator::CacheBranchQuantities(const std::vector<unsigned>& rBranchIndices)
+{
+    const int num_branches = static_cast<int>(rBranchIndices.size());
+    OpenMpExceptionCollector exception_collector;
+#ifdef CHASTE_OPENMP
+#pragma omp parallel for schedule(dynamic, 256) num_threads(mNumThreads) if(mNumThreads > 1u)
+#endif // CHASTE_OPENMP
+    for (int i = 0; i < num_branches; i++)
+    {
+        try
+        {
+            unsigned branch_idx = rBranchIndices[i];
+            AirwayBranch* p_branch = mBranches[branch_idx];
+
+            mBranchLengths[branch_idx] = p_branch->GetLength();
+            mBranchAverageRadii[branch_idx] = p_branch->GetAverageRadius();
+            mBranchPoiseuilleResistances[branch_idx] = p_branch->GetPoiseuilleResistance();
+            mBranchDirections[branch_idx] = p_branch->GetDirection();
+
+            // Volumes, areas and centroids are only defined for nodal radii
+            if (!mRadiusOnEdge)
+            {
+                mBranchVolumes[branch_idx] = p_branch->GetBranchVolume();
+                mBranchLateralSurfaceAreas[branch_idx] = p_branch->GetBranchLateralSurfaceArea();
+                mBranchCentroids[branch_idx] = p_branch->GetBranchCentroid();
+            }
+        }
+        catch (...)
+        {
+            exception_collector.Capture();
+        }
+    }
+    exception_collector.RethrowIfAny();
+}
+
+void AirwayPropertiesCalculator::CacheBranchAngles(const std::vector<unsigned>& rBranchIndices)
+{
+    const int num_branches = static_cast<int>(rBranchIndices.size());
+#ifdef CHASTE_OPENMP
+#pragma omp parallel for schedule(static) num_threads(mNumThreads) if(mNumThreads > 1u)
+#endif // CHASTE_OPENMP
+    for (int i = 0; i < num_branches; i++)
+    {
+        // As AirwayBranch::GetBranchAngle() and AirwayBranch::GetRotationAngle(), using the cached directions
+        unsigned branch_idx = rBranchIndices[i];
+        unsigned parent_idx = mParentIndices[branch_idx];
+        unsigned sibling_idx = mSiblingIndices[branch_idx];
+
+        mBranchAngles[branch_idx] = 0.0;
+        mRotationAngles[branch_idx] = 0.0;
+        if (parent_idx == UINT_MAX)
+        {
+            continue;
+        }
+
+        const c_vector<double, 3>& r_dir = mBranchDirections[branch_idx];
+        const c_vector<double, 3>& r_parent_dir = mBranchDirections[parent_idx];
+        mBranchAngles[branch_idx] = std::acos(inner_prod(r_dir, r_parent_dir)/(norm_2(r_dir)*norm_2(r_parent_dir)));
+
+        unsigned parent_sibling_idx = mSiblingIndices[parent_idx];
+        if (sibling_idx != UINT_MAX && parent_sibling_idx != UINT_MAX)
+        {
+            c_vector<double, 3> n1 = VectorProduct(r_dir, mBranchDirections[sibling_idx]);
+            c_vector<double, 3> n2 = VectorProduct(r_parent_dir, mBranchDirections[parent_sibling_idx]);
+
+            // Co-planar bifurcations have an undefined rotation angle, which we take to be zero
+            double rotation_factor = inner_prod(n1,n2)/(norm_2(n1)*norm_2(n2));
+            if (fabs(rotation_factor) != 1.0)
+            {
+                mRotationAngles[branch_idx] = std::acos(rotation_factor);
+            }
+        }
+    }
+}
+
+void AirwayPropertiesCalculator::CacheAllBranchQuantities()
+{
+    if (mBranchQuantitiesAreCached)
+    {
+        return;
+    }
+
+    const unsigned num_branches = mBranches.size();
+    mBranchLengths.resize(num_branches);
+    mBranchAverageRadii.resize(num_branches);
+    mBranchVolumes.assign(num_branches, 0.0);
+    mBranchLateralSurfaceAreas.assign(num_branches, 0.0);
+    mBranchPoiseuilleResistances.resize(num_branches);
+    c_vector<double, 3> zero_centroid = zero_vector<double>(3);
+    mBranchCentroids.assign(num_branches, zero_centroid);
+    mBranchDirections.resize(num_branches);
+    mBranchAngles.resize(num_branches);
+    mRotationAngles.resize(num_branches);
+
+    // Visit the branches in post order, so that neighbouring branches are computed together
+    CacheBranchQuantities(mPostOrder);
+    CacheBranchAngles(mPostOrder);
+    mBranchQuantitiesAreCached = true;
+}
+
+void AirwayPropertiesCalculator::AccumulateSubtreeProperties(unsigned branchIndex)
+{
+    mTotalSubtreeBranchLength[branchIndex] = mBranchLengths[branchIndex];
+    mTotalSubtreeBranchVolume[branchIndex] = mBranchVolumes[branchIndex];
+    mTotalSubtreeBranchLateralSurfaceArea[branchIndex] = mBranchLateralSurfaceAreas[branchIndex];
+    mTotalSubtreePoiseuilleResistance[branchIndex] = mBranchPoiseuilleResistances[branchIndex];
+
+    // Rescale the centroid by the branch volume; it is divided by the total subtree volume later
+    mWeightedSubtreeCentroid[branchIndex] = mBranchCentroids[branchIndex] * mBranchVolumes[branchIndex];
+
+    // Loop over all children.  If there are no children, the loop will not be executed.
+    for (unsigned child = mChildStarts[branchIndex]; child < mChildStarts[branchIndex + 1]; child++)
+    {
+        unsigned child_idx = mChildIndices[child];
+        mTotalSubtreeBranchLength[branchIndex] += mTotalSubtreeBranchLength[child_idx];
+        mTotalSubtreeBranchVolume[branchIndex] += mTotalSubtreeBranchVolume[child_idx];
+        mTotalSubtreeBranchLateralSurfaceArea[branchIndex] += mTotalSubtreeBranchLateralSurfaceArea[child_idx];
+        mWeightedSubtreeCentroid[branchIndex] += mWeightedSubtreeCentroid[child_idx];
+    }
+
+    // If there are children, currently we assume there are exactly two, whose resistances add in parallel
+    if (mChildStarts[branchIndex + 1] > mChildStarts[branchIndex])
+    {
+        assert(mChildStarts[branchIndex + 1] - mChildStarts[branchIndex] == 2u);
+        double child0_subtree_res = mTotalSubtreePoiseuilleResistance[mChildIndices[mChildStarts[branchIndex]]];
+        double child1_subtree_res = mTotalSubtreePoiseuilleResistance[mChildIndices[mChildStarts[branchIndex] + 1]];
+        mTotalSubtreePoiseuilleResistance[branchIndex] += ( child0_subtree_res * child1_subtree_res / (child0_subtree_res + child1_subtree_res) );
+    }
+
+    mTotalSubtreeCentroid[branchIndex] = mWeightedSubtreeCentroid[branchIndex] / mTotalSubtreeBranchVolume[branchIndex];
+}
+
+void AirwayPropertiesCalculator::AccumulateUpstreamProperties(unsigned branchIndex)
+{
+    // Only branches reached through first and second children are included
+    if (!mIsOnPrimaryPath[branchIndex])
+    {
+        mUpstreamPathBranchLengths[branchIndex] = 0.0;
+        mUpstreamPathBranchVolumes[branchIndex] = 0.0;
+        mUpstreamPathBranchLateralSurfaceAreas[branchIndex] = 0.0;
+        mUpstreamPathPoiseuilleResistances[branchIndex] = 0.0;
+        return;
+    }
+
+    mUpstreamPathBranchLengths[branchIndex] = mBranchLengths[branchIndex];
+    mUpstreamPathBranchVolumes[branchIndex] = mBranchVolumes[branchIndex];
+    mUpstreamPathBranchLateralSurfaceAreas[branchIndex] = mBranchLateralSurfaceAreas[branchIndex];
+    mUpstreamPathPoiseuilleResistances[branchIndex] = mBranchPoiseuilleResistances[branchIndex];
+
+    // If current branch is not the trachea, simply add the parent branch data
+    unsigned parent_idx = mParentIndices[branchIndex];
+    if (parent_idx != UINT_MAX)
+    {
+        mUpstreamPathBranchLengths[branchIndex] += mUpstreamPathBranchLengths[parent_idx];
+        mUpstreamPathBranchVolumes[branchIndex] += mUpstreamPathBranchVolumes[parent_idx];
+        mUpstreamPathBranchLateralSurfaceAreas[branchIndex] += mUpstreamPathBranchLateralSurfaceAreas[parent_idx];
+        mUpstreamPathPoiseuilleResistances[branchIndex] += mUpstreamPathPoiseuilleResistances[parent_idx];
+    }
+}
+
+void AirwayPropertiesCalculator::UpdateSubtree(AirwayBranch* pBranch)
+{
+    const unsigned root_idx = pBranch->GetIndex();
+    assert(root_idx < mBranches.size() && mBranches[root_idx] == pBranch);
+
+    if (!mBranchQuantitiesAreCached)
+    {
+        // Nothing has been calculated yet, so there is nothing to update
+        return;
+    }
+
+    // The subtree is a contiguous range of the post order, ending with its root
+    const unsigned last = mPostOrderPositions[root_idx];
+    const unsigned first = last + 1 - mSubtreeSizes[root_idx];
+    std::vector<unsigned> subtree(mPostOrder.begin() + first, mPostOrder.begin() + last + 1);
+    CacheBranchQuantities(subtree);
+
+    // The angles of the sibling and its children depend on the direction of the subtree root
+    std::vector<unsigned> changed_angles(subtree);
+    unsigned sibling_idx = mSiblingIndices[root_idx];
+    if (sibling_idx != UINT_MAX)
+    {
+        changed_angles.push_back(sibling_idx);
+        for (unsigned child = mChildStarts[sibling_idx]; child < mChildStarts[sibling_idx + 1]; child++)
+        {
+            changed_angles.push_back(mChildIndices[child]);
+        }
+    }
+    CacheBranchAngles(changed_angles);
+
+    if (mSubtreePropertiesCalculated)
+    {
+        for (unsigned position = first; position <= last; position++)
+        {
+            AccumulateSubtreeProperties(mPostOrder[position]);
+        }
+        for (unsigned ancestor_idx = mParentIndices[root_idx]; ancestor_idx != UINT_MAX; ancestor_idx = mParentIndices[ancestor_idx])
+        {
+            AccumulateSubtreeProperties(ancestor_idx);
+        }
+    }
+
+    if (mUpstreamPropertiesCalculated)
+    {
+        for (unsigned position = last + 1; position-- > first; )
+        {
+            AccumulateUpstreamProperties(mPostOrder[position]);
+        }
+    }
+
+    // The branch statistics are sums over the cached quantities, so are cheap to recalculate
+    if (mBranchPropertiesCalculated)
+    {
+        CalculateBranchProperties();
+    }
+}
+
+const std::vector<unsigned>& AirwayPropertiesCalculator::rGetPostOrderBranchIndices() const
+{
+    return mPostOrder;
+}
+
+void AirwayPropertiesCalculator::SetNumberOfThreads(unsigned numThreads)
+{
+    if (numThreads == 0u)
+    {
+        EXCEPTION("The number of airway property threads must be at least one.");
+    }
+    mNumThreads = numThreads;
+}
+
+unsigned AirwayPropertiesCalculator::GetNumberOfThreads() const
+{
+    return mNumThreads;
+}
+
 double AirwayPropertiesCalculator::GetLengthOneOverLengthTwoMean() const
 {
     return mLengthOneOverLengthTwoMean;
@@ -384,24 +711,27 @@ void AirwayPropertiesCalculator::CalculateBranchProperties()
     mLengthOneOverLengthTwoSpread = 0.0;
     unsigned lengthOneOverLengthTwoCount = 0u;
 
-    for (std::vector<AirwayBranch*>::iterator iter = mBranches.begin();
-         iter != mBranches.end();
-         ++iter)
+    CacheAllBranchQuantities();
+
+    for (unsigned branch_idx = 0; branch_idx < mBranches.size(); branch_idx++)
     {
-        bool is_major = (*iter)->IsMajor();
-        double length = (*iter)->GetLength();
-        double diameter = 2*(*iter)->GetAverageRadius();
+        unsigned parent_idx = mParentIndices[branch_idx];
+        unsigned sibling_idx = mSiblingIndices[branch_idx];
+        bool is_major = (sibling_idx == UINT_MAX) || (mBranchAverageRadii[branch_idx] > mBranchAverageRadii[sibling_idx]);
+        double length = mBranchLengths[branch_idx];
+        double diameter = 2*mBranchAverageRadii[branch_idx];
 
         assert(diameter > 0.0); //The airway tree must have a well defined set of radii to calculate branch properties
 
         mLengthOverDiameterMean += length/diameter;
 
-        if ((*iter)->GetParent() != nullptr)
+        if (parent_idx != UINT_MAX)
         {
-            double theta = (*iter)->GetBranchAngle();
-            double parent_diameter = 2*(*iter)->GetParent()->GetAverageRadius();
+            double theta = mBranchAngles[branch_idx];
+            double parent_length = mBranchLengths[parent_idx];
+            double parent_diameter = 2*mBranchAverageRadii[parent_idx];
 
-            mLengthOverLengthParentMean += length/(*iter)->GetParent()->GetLength();
+            mLengthOverLengthParentMean += length/parent_length;
             mDiameterOverParentDiameterMean += diameter/parent_diameter;
 
             mThetaMean += theta;
@@ -427,7 +757,7 @@ void AirwayPropertiesCalculator::CalculateBranchProperties()
                 thetaParentDiameter2mmTo1mmCount++;
             }
 
-            if ((*iter)->GetSibling() != nullptr)
+            if (sibling_idx != UINT_MAX)
             {
                 if (is_major)
                 {
@@ -440,28 +770,28 @@ void AirwayPropertiesCalculator::CalculateBranchProperties()
                 {
                     mThetaMinorBranches += theta;
                     mLengthOverDiameterMinorChildMean += length/diameter;
-                    mMinorDiameterOverMajorDiameterMean += diameter/(2*(*iter)->GetSibling()->GetAverageRadius());
+                    mMinorDiameterOverMajorDiameterMean += diameter/(2*mBranchAverageRadii[sibling_idx]);
                     mMinorDiameterOverParentDiameterMean += diameter/parent_diameter;
                     minorBranchesCount++;
                 }
 
-                if (length < (*iter)->GetSibling()->GetLength())
+                if (length < mBranchLengths[sibling_idx])
                 {
-                    mLengthOneOverLengthTwoMean += length/(*iter)->GetSibling()->GetLength();
+                    mLengthOneOverLengthTwoMean += length/mBranchLengths[sibling_idx];
                     lengthOneOverLengthTwoCount++;
                 }
             }
 
-            if ((*iter)->GetParent() != nullptr && length < (*iter)->GetParent()->GetLength())
+            if (length < parent_length)
             {
                 lengthOverParentLengthLessThanOneCount++;
             }
-        }
 
-        if ((*iter)->GetParent() != nullptr && (*iter)->GetParent()->GetSibling() != nullptr && (*iter)->GetSibling() != nullptr)
-        {
-            mPhiMean += (*iter)->GetRotationAngle();
-            phiMeanCount++;
+            if (mSiblingIndices[parent_idx] != UINT_MAX && sibling_idx != UINT_MAX)
+            {
+                mPhiMean += mRotationAngles[branch_idx];
+                phiMeanCount++;
+            }
         }
     }
 
@@ -523,6 +853,8 @@ void AirwayPropertiesCalculator::CalculateBranchProperties()
     {
         mLengthOneOverLengthTwoMean /= lengthOneOverLengthTwoCount;
     }
+
+    mBranchPropertiesCalculated = true;
 }
 
 void AirwayPropertiesCalculator::CalculateSubtreeProperties()
@@ -534,39 +866,18 @@ void AirwayPropertiesCalculator::CalculateSubtreeProperties()
     mTotalSubtreeBranchLateralSurfaceArea.resize(num_branches);
     mTotalSubtreePoiseuilleResistance.resize(num_branches);
     mTotalSubtreeCentroid.resize(num_branches);
+    mWeightedSubtreeCentroid.resize(num_branches);
 
-    // Get pointer to trachea, and double check it's the correct
-    AirwayBranch* trachea = mBranches[0];
-    assert(trachea->GetIndex() == 0);
-
-    // Begin the recursions, sanity checking results
-    double total_tree_length = RecursivelyCalculateSubtreeLength(trachea);
-    assert(fabs(total_tree_length - mTotalSubtreeBranchLength[trachea->GetIndex()]) < 1e-6);
-    UNUSED_OPT(total_tree_length);
-
-    double total_tree_volume = RecursivelyCalculateSubtreeVolume(trachea);
-    assert(fabs(total_tree_volume - mTotalSubtreeBranchVolume[trachea->GetIndex()]) < 1e-6);
-    UNUSED_OPT(total_tree_volume);
+    // Volumes are only defined for nodal radii
+    assert(!mRadiusOnEdge);
+    CacheAllBranchQuantities();
 
-    double total_tree_lateral_surface_area = RecursivelyCalculateSubtreeLateralSurfaceArea(trachea);
-    assert(fabs(total_tree_lateral_surface_area - mTotalSubtreeBranchLateralSurfaceArea[trachea->GetIndex()]) < 1e-6);
-    UNUSED_OPT(total_tree_lateral_surface_area);
-
-    // The variable assigned to is unused; does the method call have desirable side effects?
-    double total_tree_poiseuille_resistance = RecursivelyCalculateSubtreePoiseuilleResistance(trachea);
-    RecursivelyCalculateSubtreePoiseuilleResistance(trachea);
-    assert(fabs(total_tree_poiseuille_resistance - mTotalSubtreePoiseuilleResistance[trachea->GetIndex()]) < 1e-6);
-    UNUSED_OPT(total_tree_poiseuille_resistance);
-
-    c_vector<double, 3> total_centroid = RecursivelyCalculateSubtreeCentroid(trachea);
-    assert(norm_2(total_centroid - mTotalSubtreeCentroid[trachea->GetIndex()]) < 1e-6);
-    UNUSED_OPT(total_centroid);
-
-    // Correct centroid by undoing volume-weighting
-    for (unsigned branch_idx = 0 ; branch_idx < num_branches ; branch_idx ++)
+    // One sweep in post order sees every child before its parent
+    for (unsigned position = 0; position < num_branches; position++)
     {
-        mTotalSubtreeCentroid[branch_idx] /= mTotalSubtreeBranchVolume[branch_idx];
+        AccumulateSubtreeProperties(mPostOrder[position]);
     }
+    mSubtreePropertiesCalculated = true;
 }
 
 void AirwayPropertiesCalculator::CalculateUpstreamProperties()
@@ -578,203 +889,14 @@ void AirwayPropertiesCalculator::CalculateUpstreamProperties()
     mUpstreamPathBranchLateralSurfaceAreas.resize(num_branches);
     mUpstreamPathPoiseuilleResistances.resize(num_branches);
 
-    // Get pointer to trachea, and double check it's the correct
-    AirwayBranch* trachea = mBranches[0];
-    assert(trachea->GetIndex() == 0);
-
-    // Begin the recursions
-    RecursivelyCalculateUpstreamLengths(trachea);
-    RecursivelyCalculateUpstreamVolumes(trachea);
-    RecursivelyCalculateUpstreamLateralSurfaceAreas(trachea);
-    RecursivelyCalculateUpstreamPoiseuilleResistances(trachea);
-}
-
-double AirwayPropertiesCalculator::RecursivelyCalculateSubtreeLength(AirwayBranch* pBranch)
-{
-    mTotalSubtreeBranchLength[pBranch->GetIndex()] = pBranch->GetLength();
-
-    std::vector<AirwayBranch*> all_children = pBranch->GetAllChildren();
-
-    // Loop over all children.  If there are no children, the loop will not be executed.
-    for (unsigned child_branch_idx = 0 ; child_branch_idx < all_children.size() ; child_branch_idx++)
-    {
-        mTotalSubtreeBranchLength[pBranch->GetIndex()] += RecursivelyCalculateSubtreeLength(all_children[child_branch_idx]);
-    }
-
-    // Return the total below, including current branch length
-    return mTotalSubtreeBranchLength[pBranch->GetIndex()];
-}
-
-double AirwayPropertiesCalculator::RecursivelyCalculateSubtreeVolume(AirwayBranch* pBranch)
-{
-    mTotalSubtreeBranchVolume[pBranch->GetIndex()] = pBranch->GetBranchVolume();
-
-    std::vector<AirwayBranch*> all_children = pBranch->GetAllChildren();
-
-    // Loop over all children.  If there are no children, the loop will not be executed.
-    for (unsigned child_branch_idx = 0 ; child_branch_idx < all_children.size() ; child_branch_idx++)
-    {
-        mTotalSubtreeBranchVolume[pBranch->GetIndex()] += RecursivelyCalculateSubtreeVolume(all_children[child_branch_idx]);
-    }
-
-    // Return the total below, including current branch length
-    return mTotalSubtreeBranchVolume[pBranch->GetIndex()];
-}
-
-double AirwayPropertiesCalculator::RecursivelyCalculateSubtreeLateralSurfaceArea(AirwayBranch* pBranch)
-{
-    mTotalSubtreeBranchLateralSurfaceArea[pBranch->GetIndex()] = pBranch->GetBranchLateralSurfaceArea();
-
-    std::vector<AirwayBranch*> all_children = pBranch->GetAllChildren();
-
-    // Loop over all children.  If there are no children, the loop will not be executed.
-    for (unsigned child_branch_idx = 0 ; child_branch_idx < all_children.size() ; child_branch_idx++)
-    {
-        mTotalSubtreeBranchLateralSurfaceArea[pBranch->GetIndex()] += RecursivelyCalculateSubtreeLateralSurfaceArea(all_children[child_branch_idx]);
-    }
-
-    // Return the total below, including current branch surface area
-    return mTotalSubtreeBranchLateralSurfaceArea[pBranch->GetIndex()];
-}
-
-double AirwayPropertiesCalculator::RecursivelyCalculateSubtreePoiseuilleResistance(AirwayBranch* pBranch)
-{
-    mTotalSubtreePoiseuilleResistance[pBranch->GetIndex()] = pBranch->GetPoiseuilleResistance();
-
-    std::vector<AirwayBranch*> all_children = pBranch->GetAllChildren();
-
-    // Only carry on with recursion if there are children
-    if (!all_children.empty())
-    {
-        // If there are children, currently we assume there are exactly two
-        assert(all_children.size() == 2);
-
-        double child0_subtree_res = RecursivelyCalculateSubtreePoiseuilleResistance(all_children[0]);
-        double child1_subtree_res = RecursivelyCalculateSubtreePoiseuilleResistance(all_children[1]);
-
-        // Update the Poiseuille resistance by reciprocal sum
-        mTotalSubtreePoiseuilleResistance[pBranch->GetIndex()] += ( child0_subtree_res * child1_subtree_res / (child0_subtree_res + child1_subtree_res) );
-    }
-
-    // Return the total below, including current branch resistance
-    return mTotalSubtreePoiseuilleResistance[pBranch->GetIndex()];
-}
-
-c_vector<double, 3> AirwayPropertiesCalculator::RecursivelyCalculateSubtreeCentroid(AirwayBranch* pBranch)
-{
-    // Need to rescale centroid by volume of the element, then divide later by total subtree volume
-    mTotalSubtreeCentroid[pBranch->GetIndex()] = pBranch->GetBranchCentroid() * pBranch->GetBranchVolume();
-
-    std::vector<AirwayBranch*> all_children = pBranch->GetAllChildren();
-
-    // Loop over all children.  If there are no children, the loop will not be executed.
-    for (unsigned child_branch_idx = 0 ; child_branch_idx < all_children.size() ; child_branch_idx++)
-    {
-        mTotalSubtreeCentroid[pBranch->GetIndex()] += RecursivelyCalculateSubtreeCentroid(all_children[child_branch_idx]);
-    }
-
-    // Return the final value
-    return mTotalSubtreeCentroid[pBranch->GetIndex()];
-}
-
-void AirwayPropertiesCalculator::RecursivelyCalculateUpstreamLengths(AirwayBranch* pBranch)
-{
-    unsigned current_index = pBranch->GetIndex();
-
-    // If current branch is trachea, there is nothing upstream, so just need current branch data
-    if (pBranch->GetParent() == nullptr)
-    {
-        mUpstreamPathBranchLengths[current_index] = pBranch->GetLength();
-    }
-    // Otherwise, simply add current branch data to parent branch data
-    else
-    {
-        mUpstreamPathBranchLengths[current_index] = pBranch->GetLength() + mUpstreamPathBranchLengths[pBranch->GetParent()->GetIndex()];
-    }
-
-    // Recursively calculate correct value for each child branch
-    if (pBranch->GetChildOne() != nullptr)
-    {
-        RecursivelyCalculateUpstreamLengths(pBranch->GetChildOne());
-    }
-    if (pBranch->GetChildTwo() != nullptr)
-    {
-        RecursivelyCalculateUpstreamLengths(pBranch->GetChildTwo());
-    }
-}
-void AirwayPropertiesCalculator::RecursivelyCalculateUpstreamVolumes(AirwayBranch* pBranch)
-{
-    unsigned current_index = pBranch->GetIndex();
-
-    // If current branch is trachea, there is nothing upstream, so just need current branch data
-    if (pBranch->GetParent() == nullptr)
-    {
-        mUpstreamPathBranchVolumes[current_index] = pBranch->GetBranchVolume();
-    }
-    // Otherwise, simply add current branch data to parent branch data
-    else
-    {
-        mUpstreamPathBranchVolumes[current_index] = pBranch->GetBranchVolume() + mUpstreamPathBranchVolumes[pBranch->GetParent()->GetIndex()];
-    }
-
-    // Recursively calculate correct value for each child branch
-    if (pBranch->GetChildOne() != nullptr)
-    {
-        RecursivelyCalculateUpstreamVolumes(pBranch->GetChildOne());
-    }
-    if (pBranch->GetChildTwo() != nullptr)
-    {
-        RecursivelyCalculateUpstreamVolumes(pBranch->GetChildTwo());
-    }
-}
-void AirwayPropertiesCalculator::RecursivelyCalculateUpstreamLateralSurfaceAreas(AirwayBranch* pBranch)
-{
-    unsigned current_index = pBranch->GetIndex();
-
-    // If current branch is trachea, there is nothing upstream, so just need current branch data
-    if (pBranch->GetParent() == nullptr)
-    {
-        mUpstreamPathBranchLateralSurfaceAreas[current_index] = pBranch->GetBranchLateralSurfaceArea();
-    }
-    // Otherwise, simply add current branch data to parent branch data
-    else
-    {
-        mUpstreamPathBranchLateralSurfaceAreas[current_index] = pBranch->GetBranchLateralSurfaceArea() + mUpstreamPathBranchLateralSurfaceAreas[pBranch->GetParent()->GetIndex()];
-    }
-
-    // Recursively calculate correct value for each child branch
-    if (pBranch->GetChildOne() != nullptr)
-    {
-        RecursivelyCalculateUpstreamLateralSurfaceAreas(pBranch->GetChildOne());
-    }
-    if (pBranch->GetChildTwo() != nullptr)
-    {
-        RecursivelyCalculateUpstreamLateralSurfaceAreas(pBranch->GetChildTwo());
-    }
-}
-
-void AirwayPropertiesCalculator::RecursivelyCalculateUpstreamPoiseuilleResistances(AirwayBranch* pBranch)
-{
-    unsigned current_index = pBranch->GetIndex();
+    // Volumes are only defined for nodal radii
+    assert(!mRadiusOnEdge);
+    CacheAllBranchQuantities();
 
-    // If current branch is trachea, there is nothing upstream, so just need current branch data
-    if (pBranch->GetParent() == nullptr)
-    {
-        mUpstreamPathPoiseuilleResistances[current_index] = pBranch->GetPoiseuilleResistance();
-    }
-    // Otherwise, simply add current branch data to parent branch data
-    else
-    {
-        mUpstreamPathPoiseuilleResistances[current_index] = pBranch->GetPoiseuilleResistance() + mUpstreamPathPoiseuilleResistances[pBranch->GetParent()->GetIndex()];
-    }
-
-    // Recursively calculate correct value for each child branch
-    if (pBranch->GetChildOne() != nullptr)
-    {
-        RecursivelyCalculateUpstreamPoiseuilleResistances(pBranch->GetChildOne());
-    }
-    if (pBranch->GetChildTwo() != nullptr)
+    // One sweep in reverse post order sees every parent before its children
+    for (unsigned position = num_branches; position-- > 0; )
     {
-        RecursivelyCalculateUpstreamPoiseuilleResistances(pBranch->GetChildTwo());
+        AccumulateUpstreamProperties(mPostOrder[position]);
     }
+    mUpstreamPropertiesCalculated = true;
 }
@@ -46,6 +46,12 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  *
  * Properties include adding the airway generation as an attribute to the tree, calculating branching and rotation angles
  * and length/diameter ratios.
+ *
+ * The branches are also held as a flat tree in post order (children before parents), with the length, radius,
+ * volume, surface area, resistance, centroid and angles of each branch cached in contiguous arrays. These are
+ * computed once, sharing the branches between OpenMP threads if Chaste was built with OpenMP support, and all
+ * the statistics are then calculated from the arrays in single sweeps. After the geometry or radii of a subtree
+ * have been changed, UpdateSubtree() refreshes only what depends on that subtree.
  */
 class AirwayPropertiesCalculator
 {
@@ -206,6 +212,34 @@ public:
      */
     void CalculateUpstreamProperties();
 
+    /**
+     * Update the cached quantities of the branches in the subtree rooted at a given branch, after the node
+     * locations or radii in that subtree (other than the proximal node of its root, which is shared with the
+     * parent branch) have been changed, and update any branch, subtree or upstream
+     * properties that have already been calculated. Only the subtree, its sibling and the path from it to
+     * the trachea are revisited. The branching structure of the tree must not have changed; if it has, a
+     * new calculator must be constructed.
+     *
+     * @param pBranch The root of the modified subtree
+     */
+    void UpdateSubtree(AirwayBranch* pBranch);
+
+    /**
+     * @return The indices of the branches in post order, so that each branch comes after all of its children
+     * and each subtree occupies a contiguous range ending with its root.
+     */
+    const std::vector<unsigned>& rGetPostOrderBranchIndices() const;
+
+    /**
+     * Set the number of OpenMP threads used to compute the cached branch quantities.
+     *
+     * @param numThreads the number of threads (must be at least one)
+     */
+    void SetNumberOfThreads(unsigned numThreads);
+
+    /** @return the number of OpenMP threads used to compute the cached branch quantities */
+    unsigned GetNumberOfThreads() const;
+
 private:
 
     /** A mesh containing the airways tree.  */
@@ -222,6 +256,75 @@ private:
     /** An easy access list of airway branches */
     std::vector<AirwayBranch*> mBranches;
 
+    /** The number of OpenMP threads used to compute the cached branch quantities */
+    unsigned mNumThreads;
+
+    /** For each branch, the index of its parent (UINT_MAX for the trachea) */
+    std::vector<unsigned> mParentIndices;
+
+    /** For each branch, the index of its sibling (UINT_MAX if it has none) */
+    std::vector<unsigned> mSiblingIndices;
+
+    /** The children of branch i are mChildIndices[mChildStarts[i]] to mChildIndices[mChildStarts[i+1]-1] */
+    std::vector<unsigned> mChildStarts;
+
+    /** The indices of the children of each branch, in the order of AirwayBranch::GetAllChildren() */
+    std::vector<unsigned> mChildIndices;
+
+    /** The branch indices in post order */
+    std::vector<unsigned> mPostOrder;
+
+    /** For each branch, its position in mPostOrder */
+    std::vector<unsigned> mPostOrderPositions;
+
+    /** For each branch, the number of branches in its subtree (including itself) */
+    std::vector<unsigned> mSubtreeSizes;
+
+    /** For each branch, whether it is reached from the trachea through first and second children only */
+    std::vector<bool> mIsOnPrimaryPath;
+
+    /** Whether the cached branch quantities below have been computed */
+    bool mBranchQuantitiesAreCached;
+
+    /** Whether CalculateBranchProperties() has been called */
+    bool mBranchPropertiesCalculated;
+
+    /** Whether CalculateSubtreeProperties() has been called */
+    bool mSubtreePropertiesCalculated;
+
+    /** Whether CalculateUpstreamProperties() has been called */
+    bool mUpstreamPropertiesCalculated;
+
+    /** For each branch, its length */
+    std::vector<double> mBranchLengths;
+
+    /** For each branch, its average radius */
+    std::vector<double> mBranchAverageRadii;
+
+    /** For each branch, its volume */
+    std::vector<double> mBranchVolumes;
+
+    /** For each branch, its lateral surface area */
+    std::vector<double> mBranchLateralSurfaceAreas;
+
+    /** For each branch, its Poiseuille resistance */
+    std::vector<double> mBranchPoiseuilleResistances;
+
+    /** For each branch, its centroid */
+    std::vector<c_vector<double, 3> > mBranchCentroids;
+
+    /** For each branch, its unit direction */
+    std::vector<c_vector<double, 3> > mBranchDirections;
+
+    /** For each branch, its branch angle (zero for the trachea) */
+    std::vector<double> mBranchAngles;
+
+    /** For each branch, its rotation angle (zero where it is undefined) */
+    std::vector<double> mRotationAngles;
+
+    /** For each branch, the volume-weighted sum of the centroids of all branches in the distal direction */
+    std::vector<c_vector<double, 3> > mWeightedSubtreeCentroid;
+
     /** The average branch angle of the tree */
     double mThetaMean;
 
@@ -349,81 +452,44 @@ private:
     void SetupBranches(Element<1,3>* pElement, AirwayBranch* pBranch);
 
     /**
-     * Recursively walk airway tree to calculate subtree length.
-     * Helper method for CalculateSubtreeProperties().
-     *
-     * @param pBranch The current branch
-     * @return The subtree length
+     * Set up the flat tree representation (parents, siblings, children and post order) from mBranches.
      */
-    double RecursivelyCalculateSubtreeLength(AirwayBranch* pBranch);
+    void SetupTreeStructure();
 
     /**
-     * Recursively walk airway tree to calculate subtree volume.
-     * Helper method for CalculateSubtreeProperties().
+     * Compute the cached quantities of the given branches, other than their angles.
      *
-     * @param pBranch The current branch
-     * @return The subtree volume
+     * @param rBranchIndices The branches to update
      */
-    double RecursivelyCalculateSubtreeVolume(AirwayBranch* pBranch);
+    void CacheBranchQuantities(const std::vector<unsigned>& rBranchIndices);
 
     /**
-     * Recursively walk airway tree to calculate subtree lateral surface area.
-     * Helper method for CalculateSubtreeProperties().
+     * Compute the cached branch and rotation angles of the given branches, from the cached directions.
      *
-     * @param pBranch The current branch
-     * @return The subtree lateral surface area
+     * @param rBranchIndices The branches to update
      */
-    double RecursivelyCalculateSubtreeLateralSurfaceArea(AirwayBranch* pBranch);
+    void CacheBranchAngles(const std::vector<unsigned>& rBranchIndices);
 
     /**
-     * Recursively walk airway tree to calculate subtree Poiseuille resistance.
-     * Helper method for CalculateSubtreeProperties().
-     *
-     * @param pBranch The current branch
-     * @return The subtree Poiseuille resistance
+     * Compute all the cached branch quantities, if this has not already been done.
      */
-    double RecursivelyCalculateSubtreePoiseuilleResistance(AirwayBranch* pBranch);
+    void CacheAllBranchQuantities();
 
     /**
-     * Recursively walk airway tree to calculate subtree centroid.
-     * Helper method for CalculateSubtreeProperties().
+     * Set the subtree properties of a branch from its own cached quantities and the subtree properties
+     * of its children.
      *
-     * @param pBranch The current branch
-     * @return The subtree centroid
+     * @param branchIndex The branch
      */
-    c_vector<double, 3> RecursivelyCalculateSubtreeCentroid(AirwayBranch* pBranch);
+    void AccumulateSubtreeProperties(unsigned branchIndex);
 
     /**
-     * Recursively walk airway tree to calculate upstream lengths.
-     * Helper method for CalculateUpstreamProperties().
+     * Set the upstream properties of a branch from its own cached quantities and the upstream properties
+     * of its parent.
      *
-     * @param pBranch The current branch
-     */
-    void RecursivelyCalculateUpstreamLengths(AirwayBranch* pBranch);
-
-    /**
-     * Recursively walk airway tree to calculate upstream volumes.
-     * Helper method for CalculateUpstreamProperties().
-     *
-     * @param pBranch The current branch
-     */
-    void RecursivelyCalculateUpstreamVolumes(AirwayBranch* pBranch);
-
-    /**
-     * Recursively walk airway tree to calculate upstream lateral surface areas.
-     * Helper method for CalculateUpstreamProperties().
-     *
-     * @param pBranch The current branch
-     */
-    void RecursivelyCalculateUpstreamLateralSurfaceAreas(AirwayBranch* pBranch);
-
-    /**
-     * Recursively walk airway tree to calculate upstream Poiseuille resistances.
-     * Helper method for CalculateUpstreamProperties().
-     *
-     * @param pBranch The current branch
+     * @param branchIndex The branch
      */
-    void RecursivelyCalculateUpstreamPoiseuilleResistances(AirwayBranch* pBranch);
+    void AccumulateUpstreamProperties(unsigned branchIndex);
 };
 
 #endif // AIRWAY_PROPERTIES_CALCULATOR
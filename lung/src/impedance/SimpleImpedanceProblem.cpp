@@ -36,7 +36,10 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "SimpleImpedanceProblem.hpp"
 #include "TrianglesMeshReader.hpp"
 #include "ReplicatableVector.hpp"
+#include "Exception.hpp"
+#include "OpenMpExceptionCollector.hpp"
 
+#include <algorithm>
 #include <cmath>
 
 SimpleImpedanceProblem::SimpleImpedanceProblem(TetrahedralMesh<1,3>& rAirwaysMesh, unsigned rootIndex)
@@ -46,7 +49,8 @@ SimpleImpedanceProblem::SimpleImpedanceProblem(TetrahedralMesh<1,3>& rAirwaysMes
       mRho(1.1500),                   //air density in Kg/m^3
       mMu(1.9e-5),                    //air viscosity in Pa s
       mH(5.8*98.0665*1e3),            //Tissue elastance in Pa/m^3 (5.8 cmH2O/L)
-      mLengthScaling(1.0)
+      mLengthScaling(1.0),
+      mNumThreads(1u)
 {
     mAcinarH = mH*(mrMesh.GetNumBoundaryNodes() - 1);
 
@@ -86,17 +90,63 @@ void SimpleImpedanceProblem::SetElastance(double elastance)
     mAcinarH = mH*(mrMesh.GetNumBoundaryNodes() - 1);
 }
 
+void SimpleImpedanceProblem::SetNumberOfThreads(unsigned numThreads)
+{
+    if (numThreads == 0u)
+    {
+        EXCEPTION("The number of impedance threads must be at least one.");
+    }
+    mNumThreads = numThreads;
+}
+
+unsigned SimpleImpedanceProblem::GetNumberOfThreads() const
+{
+    return mNumThreads;
+}
+
 void SimpleImpedanceProblem::Solve()
 {
     Node<3>* p_node = mrMesh.GetNode(mOutletNodeIndex);
     Element<1,3>* p_element = mrMesh.GetElement(*(p_node->ContainingElementsBegin()));
 
-    mImpedances.resize(mFrequencies.size());
+    const unsigned num_frequencies = mFrequencies.size();
+    unsigned num_blocks = 1u;
+#ifdef CHASTE_OPENMP
+    num_blocks = std::max(1u, std::min(mNumThreads, num_frequencies));
+#endif // CHASTE_OPENMP
+    if (num_blocks == 1u)
+    {
+        CalculateElementImpedances(p_element, mFrequencies, mImpedances);
+        return;
+    }
 
-    for (unsigned frequency_index = 0; frequency_index < mFrequencies.size(); ++frequency_index)
+    /*
+     * Each thread walks the tree for a contiguous block of the frequencies, with its own
+     * frequency and impedance vectors. The tree walker is only read here (all its maps were
+     * filled in on construction). The first exception thrown is re-thrown once all have finished.
+     */
+    mImpedances.resize(num_frequencies);
+    OpenMpExceptionCollector exception_collector;
+#ifdef CHASTE_OPENMP
+#pragma omp parallel for schedule(static) num_threads(num_blocks)
+#endif // CHASTE_OPENMP
+    for (int block=0; block<static_cast<int>(num_blocks); block++)
     {
-        mImpedances[frequency_index] = CalculateElementImpedance(p_element, mFrequencies[frequency_index]);
+        try
+        {
+            const unsigned block_lo = (num_frequencies*block)/num_blocks;
+            const unsigned block_hi = (num_frequencies*(block + 1))/num_blocks;
+            std::vector<double> block_frequencies(mFrequencies.begin() + block_lo, mFrequencies.begin() + block_hi);
+            std::vector<std::complex<double> > block_impedances;
+            CalculateElementImpedances(p_element, block_frequencies, block_impedances);
+            std::copy(block_impedances.begin(), block_impedances.end(), mImpedances.begin() + block_lo);
+        }
+        catch (...)
+        {
+            exception_collector.Capture();
+        }
     }
+    exception_collector.RethrowIfAny();
 }
 
 std::complex<double> SimpleImpedanceProblem::GetImpedance()
@@ -117,16 +167,31 @@ TetrahedralMesh<1, 3>& SimpleImpedanceProblem::rGetMesh()
 
 std::complex<double> SimpleImpedanceProblem::CalculateElementImpedance(Element<1,3>* pElement, double frequency)
 {
-    std::complex<double> Z(0, 0);
+    std::vector<std::complex<double> > impedances;
+    CalculateElementImpedances(pElement, std::vector<double>(1u, frequency), impedances);
+    return impedances[0];
+}
+
+void SimpleImpedanceProblem::CalculateElementImpedances(Element<1,3>* pElement,
+                                                        const std::vector<double>& rFrequencies,
+                                                        std::vector<std::complex<double> >& rImpedances)
+{
+    const unsigned num_frequencies = rFrequencies.size();
+    std::vector<std::complex<double> > Z(num_frequencies, std::complex<double>(0, 0));
 
     //Get children
     if (mWalker.GetNumberOfChildElements(pElement) == 0u) //Branch is terminal, hence consider to be an acinus
     {
-        Z = CalculateAcinusImpedance(mWalker.GetDistalNode(pElement), frequency);
+        Node<3>* p_acinus_node = mWalker.GetDistalNode(pElement);
+        for (unsigned f = 0; f < num_frequencies; ++f)
+        {
+            Z[f] = CalculateAcinusImpedance(p_acinus_node, rFrequencies[f]);
+        }
     }
     else
     {
-        std::complex<double> sum_one_over_Z_child(0,0); //Add up impedance of child elements
+        std::vector<std::complex<double> > sum_one_over_Z_child(num_frequencies, std::complex<double>(0, 0)); //Add up impedance of child elements
+        std::vector<std::complex<double> > ele_impedances;
 
         std::vector<Element<1,3>* > child_eles = mWalker.GetChildElements(pElement);
 
@@ -136,17 +201,23 @@ std::complex<double> SimpleImpedanceProblem::CalculateElementImpedance(Element<1
         {
             assert(child_eles[i] != pElement);
 
-            std::complex<double> ele_impedance = CalculateElementImpedance(child_eles[i], frequency);
+            CalculateElementImpedances(child_eles[i], rFrequencies, ele_impedances);
 
-            if (real(ele_impedance) != 0.0 || imag(ele_impedance) != 0.0)
+            for (unsigned f = 0; f < num_frequencies; ++f)
             {
-                sum_one_over_Z_child += 1.0/ele_impedance;
+                if (real(ele_impedances[f]) != 0.0 || imag(ele_impedances[f]) != 0.0)
+                {
+                    sum_one_over_Z_child[f] += 1.0/ele_impedances[f];
+                }
             }
         }
 
-        if (real(sum_one_over_Z_child) != 0.0 || imag(sum_one_over_Z_child) != 0.0)
+        for (unsigned f = 0; f < num_frequencies; ++f)
         {
-            Z = 1.0/sum_one_over_Z_child;
+            if (real(sum_one_over_Z_child[f]) != 0.0 || imag(sum_one_over_Z_child[f]) != 0.0)
+            {
+                Z[f] = 1.0/sum_one_over_Z_child[f];
+            }
         }
     }
 
@@ -163,10 +234,14 @@ std::complex<double> SimpleImpedanceProblem::CalculateElementImpedance(Element<1
     double R = CalculateElementResistance(radius, length);
     double I = CalculateElementInertance(radius, length);
 
-    double omega = 2*M_PI*frequency;
-    std::complex<double> I_inertance(0, omega*I);
+    rImpedances.resize(num_frequencies);
+    for (unsigned f = 0; f < num_frequencies; ++f)
+    {
+        double omega = 2*M_PI*rFrequencies[f];
+        std::complex<double> I_inertance(0, omega*I);
 
-    return R + I_inertance + Z;
+        rImpedances[f] = R + I_inertance + Z[f];
+    }
 }
 
 std::complex<double> SimpleImpedanceProblem::CalculateAcinusImpedance(Node<3>* pNode, double frequency)
@@ -120,11 +120,26 @@ public:
     void SetElastance(double elastance);
 
     /**
-     *  Performs a depth first iteration over the tree to
-     *  calculate total impedance
+     *  Performs a single depth first iteration over the tree to
+     *  calculate total impedance at every frequency.  With more than one thread
+     *  (see SetNumberOfThreads()) the frequencies are split into contiguous blocks,
+     *  and each thread does one iteration for its own block.
      */
     void Solve();
 
+    /**
+     * Set the number of threads Solve() splits the frequencies between.  This is
+     * ignored unless Chaste was built with OpenMP support.
+     *
+     * @param numThreads the number of threads (at least 1)
+     */
+    void SetNumberOfThreads(unsigned numThreads);
+
+    /**
+     * @return the number of threads Solve() splits the frequencies between.
+     */
+    unsigned GetNumberOfThreads() const;
+
     /**
      * Used to set mRadiusOnEdge flag.
      * This is false by default in the constructor (conic pipes with radius defined at nodes).  When true pipes are cylindrical.
@@ -147,6 +162,19 @@ public:
      */
     std::complex<double> CalculateElementImpedance(Element<1,3>* pElement, double frequency);
 
+    /**
+     * Recursively calculates the impedance of an element (and all its children) at several
+     * frequencies at once, so that the tree is only traversed once.  The geometry of each
+     * element is only looked at once, and the inner loops run over the frequencies.
+     *
+     * @param pElement The root element to calculate impedance for
+     * @param rFrequencies The input frequencies in Hz
+     * @param rImpedances Filled in with the impedance at each frequency
+     */
+    void CalculateElementImpedances(Element<1,3>* pElement,
+                                    const std::vector<double>& rFrequencies,
+                                    std::vector<std::complex<double> >& rImpedances);
+
     /**
      * Calculates the impedance of a single acinar unit.
      *
@@ -213,6 +241,8 @@ private:
      std::vector<double> mFrequencies; /**<The applied frequency in Hz */
      std::vector<std::complex<double> > mImpedances; /**< The calculated impedance for the network */
 
+     unsigned mNumThreads; /**< The number of threads Solve() splits the frequencies between */
+
     /**
      * Calculate the Poiseille flow resistance of an element
      *
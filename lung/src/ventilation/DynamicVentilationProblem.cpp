@@ -34,12 +34,19 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "DynamicVentilationProblem.hpp"
+#include "DistributedVectorFactory.hpp"
+#include "Exception.hpp"
+#include "OpenMpExceptionCollector.hpp"
 #include "ProgressReporter.hpp"
 
 DynamicVentilationProblem::DynamicVentilationProblem(AbstractAcinarUnitFactory* pAcinarFactory,
                                                      const std::string& rMeshDirFilePath,
                                                      unsigned rootIndex) : mpAcinarFactory(pAcinarFactory),
                                                                            mVentilationProblem(rMeshDirFilePath, rootIndex),
+                                                                           mDistributeAcinarUnits(false),
+                                                                           mTerminalLo(0u),
+                                                                           mTerminalHi(0u),
+                                                                           mNumAcinarThreads(1u),
                                                                            mrMesh(mVentilationProblem.rGetMesh()),
                                                                            mDt(0.01),
                                                                            mSamplingTimeStepMultiple(1u),
@@ -60,6 +67,16 @@ DynamicVentilationProblem::DynamicVentilationProblem(AbstractAcinarUnitFactory*
             mAcinarMap[(*iter)->GetIndex()] = mpAcinarFactory->CreateAcinarUnitForNode((*iter));
         }
     }
+
+    for (std::map<unsigned, AbstractAcinarUnit*>::iterator iter = mAcinarMap.begin();
+         iter != mAcinarMap.end();
+         ++iter )
+    {
+        mTerminalNodeIndices.push_back(iter->first);
+        mTerminalElementIndices.push_back(*(mrMesh.GetNode(iter->first)->rGetContainingElementIndices().begin()));
+        mTerminalUnits.push_back(iter->second);
+    }
+    mTerminalHi = mTerminalUnits.size();
 }
 
 DynamicVentilationProblem::~DynamicVentilationProblem()
@@ -112,6 +129,59 @@ void DynamicVentilationProblem::SetWriteVtkOutput(bool writeVtkOutput)
     mWriteVtkOutput = writeVtkOutput;
 }
 
+void DynamicVentilationProblem::SetDistributeAcinarUnits(bool distributeAcinarUnits)
+{
+    mDistributeAcinarUnits = distributeAcinarUnits;
+
+    const unsigned num_terminals = mTerminalUnits.size();
+    mTerminalLo = 0u;
+    mTerminalHi = num_terminals;
+    mTerminalCounts.clear();
+    mTerminalOffsets.clear();
+    if (mDistributeAcinarUnits && !PetscTools::IsSequential())
+    {
+        DistributedVectorFactory factory(num_terminals);
+        mTerminalLo = factory.GetLow();
+        mTerminalHi = factory.GetHigh();
+
+        const unsigned num_procs = PetscTools::GetNumProcs();
+        std::vector<unsigned>& r_lows = factory.rGetGlobalLows();
+        mTerminalCounts.resize(num_procs);
+        mTerminalOffsets.resize(num_procs);
+        for (unsigned proc=0; proc<num_procs; proc++)
+        {
+            unsigned high = (proc+1 < num_procs) ? r_lows[proc+1] : num_terminals;
+            mTerminalOffsets[proc] = r_lows[proc];
+            mTerminalCounts[proc] = high - r_lows[proc];
+        }
+    }
+}
+
+void DynamicVentilationProblem::SetNumberOfAcinarThreads(unsigned numThreads)
+{
+    if (numThreads == 0u)
+    {
+        EXCEPTION("The number of acinar unit threads must be at least one.");
+    }
+    mNumAcinarThreads = numThreads;
+}
+
+unsigned DynamicVentilationProblem::GetNumberOfAcinarThreads() const
+{
+    return mNumAcinarThreads;
+}
+
+void DynamicVentilationProblem::ShareTerminalValues(std::vector<double>& rValues)
+{
+    if (mTerminalCounts.empty())
+    {
+        return;
+    }
+    std::vector<double> local_values(rValues.begin() + mTerminalLo, rValues.begin() + mTerminalHi);
+    MPI_Allgatherv(local_values.data(), local_values.size(), MPI_DOUBLE,
+                   rValues.data(), &mTerminalCounts[0], &mTerminalOffsets[0], MPI_DOUBLE, PetscTools::GetWorld());
+}
+
 void DynamicVentilationProblem::Solve()
 {
     TimeStepper time_stepper(mCurrentTime, mEndTime, mDt);
@@ -125,46 +195,79 @@ void DynamicVentilationProblem::Solve()
     std::vector<double> pressures(mrMesh.GetNumNodes(), -1);
     std::vector<double> fluxes(mrMesh.GetNumNodes() - 1, -1);
     std::vector<double> volumes(mrMesh.GetNumNodes(), -1);
+    std::vector<double> airway_pressures(mTerminalUnits.size(), 0.0);
+    std::vector<double> terminal_volumes(mTerminalUnits.size(), -1);
+
+    const int terminal_lo = static_cast<int>(mTerminalLo);
+    const int terminal_hi = static_cast<int>(mTerminalHi);
 
     while (!time_stepper.IsTimeAtEnd())
     {
-        //Solve coupled problem
-        for (AbstractTetrahedralMesh<1,3>::BoundaryNodeIterator iter = mrMesh.GetBoundaryNodeIteratorBegin();
-                 iter != mrMesh.GetBoundaryNodeIteratorEnd();
-                 ++iter )
+        const double time = time_stepper.GetTime();
+        const double next_time = time_stepper.GetNextTime();
+
+        /*
+         * Solve coupled problem. Each acinar unit only touches its own state and its own
+         * entries of the vectors here, so the units are advanced in parallel; the first
+         * exception thrown is re-thrown once all have finished.
+         */
+        OpenMpExceptionCollector exception_collector;
+#ifdef CHASTE_OPENMP
+#pragma omp parallel for schedule(static) num_threads(mNumAcinarThreads) if(mNumAcinarThreads > 1u)
+#endif // CHASTE_OPENMP
+        for (int i=terminal_lo; i<terminal_hi; i++)
         {
-            if ((*iter)->GetIndex() != mRootIndex)
+            try
             {
-                double pleural_pressure =  mpAcinarFactory->GetPleuralPressureForNode(time_stepper.GetNextTime(), (*iter));
-                mAcinarMap[(*iter)->GetIndex()]->SetPleuralPressure(pleural_pressure);
-                mAcinarMap[(*iter)->GetIndex()]->ComputeExceptFlow(time_stepper.GetTime(), time_stepper.GetNextTime());
-
-                mVentilationProblem.SetPressureAtBoundaryNode(*(*iter), mAcinarMap[(*iter)->GetIndex()]->GetAirwayPressure());
+                AbstractAcinarUnit* p_acinus = mTerminalUnits[i];
+                double pleural_pressure =  mpAcinarFactory->GetPleuralPressureForNode(next_time, mrMesh.GetNode(mTerminalNodeIndices[i]));
+                p_acinus->SetPleuralPressure(pleural_pressure);
+                p_acinus->ComputeExceptFlow(time, next_time);
+                airway_pressures[i] = p_acinus->GetAirwayPressure();
+            }
+            catch (...)
+            {
+                exception_collector.Capture();
             }
         }
+        exception_collector.RethrowIfAny();
+        ShareTerminalValues(airway_pressures);
 
+        for (unsigned i=0; i<mTerminalNodeIndices.size(); i++)
+        {
+            mVentilationProblem.SetPressureAtBoundaryNode(*mrMesh.GetNode(mTerminalNodeIndices[i]), airway_pressures[i]);
+        }
+
+        // The tree traversal is worked out on the first step and reused, and dynamic resistances
+        // are only recalculated on edges whose flux has changed since the last step
         mVentilationProblem.Solve();
         mVentilationProblem.GetSolutionAsFluxesAndPressures(fluxes, pressures);
 
-        for (AbstractTetrahedralMesh<1,3>::BoundaryNodeIterator iter = mrMesh.GetBoundaryNodeIteratorBegin();
-                            iter != mrMesh.GetBoundaryNodeIteratorEnd();
-                            ++iter )
+#ifdef CHASTE_OPENMP
+#pragma omp parallel for schedule(static) num_threads(mNumAcinarThreads) if(mNumAcinarThreads > 1u)
+#endif // CHASTE_OPENMP
+        for (int i=terminal_lo; i<terminal_hi; i++)
         {
-            if ((*iter)->GetIndex() != 0u)
+            try
             {
-                unsigned boundary_element_index = (*(*iter)->rGetContainingElementIndices().begin());
-
-                mAcinarMap[(*iter)->GetIndex()]->SetFlow(fluxes[boundary_element_index]);
+                AbstractAcinarUnit* p_acinus = mTerminalUnits[i];
+                double flux = fluxes[mTerminalElementIndices[i]];
+                p_acinus->SetFlow(flux);
 
                 double resistance = 0.0;
-                if (fluxes[boundary_element_index] != 0.0)
+                if (flux != 0.0)
                 {
-                    resistance = std::fabs(pressures[(*iter)->GetIndex()]/fluxes[boundary_element_index]);
+                    resistance = std::fabs(pressures[mTerminalNodeIndices[i]]/flux);
                 }
-                mAcinarMap[(*iter)->GetIndex()]->SetTerminalBronchioleResistance(resistance);
-                mAcinarMap[(*iter)->GetIndex()]->UpdateFlow(time_stepper.GetTime(), time_stepper.GetNextTime());
+                p_acinus->SetTerminalBronchioleResistance(resistance);
+                p_acinus->UpdateFlow(time, next_time);
+            }
+            catch (...)
+            {
+                exception_collector.Capture();
             }
         }
+        exception_collector.RethrowIfAny();
 
         if ((time_stepper.GetTotalTimeStepsTaken() % mSamplingTimeStepMultiple) == 0u)
         {
@@ -180,14 +283,14 @@ void DynamicVentilationProblem::Solve()
                 vtk_writer.AddPointData("Pressure"+suffix_name.str(), pressures);
 
 
-                for (AbstractTetrahedralMesh<1,3>::BoundaryNodeIterator iter = mrMesh.GetBoundaryNodeIteratorBegin();
-                                                iter != mrMesh.GetBoundaryNodeIteratorEnd();
-                                                ++iter )
+                for (unsigned i=mTerminalLo; i<mTerminalHi; i++)
+                {
+                    terminal_volumes[i] = mTerminalUnits[i]->GetVolume();
+                }
+                ShareTerminalValues(terminal_volumes);
+                for (unsigned i=0; i<mTerminalNodeIndices.size(); i++)
                 {
-                    if ((*iter)->GetIndex() != mRootIndex)
-                    {
-                        volumes[(*iter)->GetIndex()] = mAcinarMap[(*iter)->GetIndex()]->GetVolume();
-                    }
+                    volumes[mTerminalNodeIndices[i]] = terminal_volumes[i];
                 }
 
                 vtk_writer.AddPointData("Volume"+suffix_name.str(), volumes);
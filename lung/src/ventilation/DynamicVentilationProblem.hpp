@@ -45,6 +45,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "AbstractAcinarUnit.hpp"
 #include "MatrixVentilationProblem.hpp"
 #include <map>
+#include <vector>
 
 /**
  * A class for solving dynamic one-dimensional lung ventilation problems in which each terminal of
@@ -127,7 +128,39 @@ public:
      */
     void SetWriteVtkOutput(bool writeVtkOutput = true);
 
+    /**
+     * Tell the solver whether to share the acinar units out between processes.  If so, each process
+     * only advances its own block of acinar units, and the airway pressures and volumes are then
+     * exchanged.  The state of units owned by other processes is not kept up to date, so this is off
+     * by default.  The airway tree itself is solved on every process.
+     *
+     * @param distributeAcinarUnits Whether to distribute the acinar units between processes
+     */
+    void SetDistributeAcinarUnits(bool distributeAcinarUnits = true);
+
+    /**
+     * Set the number of threads used to advance this process's acinar units, which are independent
+     * of each other.  This is ignored unless Chaste was built with OpenMP support.  With more than one
+     * thread, the acinar factory's GetPleuralPressureForNode() must be safe to call concurrently.
+     *
+     * @param numThreads the number of threads (at least 1)
+     */
+    void SetNumberOfAcinarThreads(unsigned numThreads);
+
+    /**
+     * @return the number of threads used to advance the acinar units.
+     */
+    unsigned GetNumberOfAcinarThreads() const;
+
 private:
+    /**
+     * Gather the locally computed block [mTerminalLo, mTerminalHi) of a vector with one entry per terminal
+     * unit onto every process.  Does nothing unless acinar units are distributed in parallel.
+     *
+     * @param rValues The values, one per terminal unit (updated in place)
+     */
+    void ShareTerminalValues(std::vector<double>& rValues);
+
     /**
      * Acinar factory
      */
@@ -143,6 +176,52 @@ private:
      */
     std::map<unsigned, AbstractAcinarUnit*> mAcinarMap;
 
+    /**
+     * The terminal (non-root boundary) node indices, in increasing order.
+     */
+    std::vector<unsigned> mTerminalNodeIndices;
+
+    /**
+     * The index of the element containing each terminal node.
+     */
+    std::vector<unsigned> mTerminalElementIndices;
+
+    /**
+     * The acinar unit for each terminal node, stored contiguously so that a time step is a
+     * sweep over arrays rather than repeated map lookups.
+     */
+    std::vector<AbstractAcinarUnit*> mTerminalUnits;
+
+    /**
+     * Whether acinar units are distributed between processes.
+     */
+    bool mDistributeAcinarUnits;
+
+    /**
+     * First terminal unit (in #mTerminalUnits) advanced by this process.
+     */
+    unsigned mTerminalLo;
+
+    /**
+     * One past the last terminal unit advanced by this process.
+     */
+    unsigned mTerminalHi;
+
+    /**
+     * Number of terminal units advanced by each process (for exchanging values).
+     */
+    std::vector<int> mTerminalCounts;
+
+    /**
+     * Offset of each process's block of terminal units (for exchanging values).
+     */
+    std::vector<int> mTerminalOffsets;
+
+    /**
+     * Number of threads used to advance the acinar units.
+     */
+    unsigned mNumAcinarThreads;
+
     /**
      * The airway tree mesh
      */
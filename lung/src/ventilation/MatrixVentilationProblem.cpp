@@ -34,14 +34,42 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "MatrixVentilationProblem.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#include "AirwayTreeWalker.hpp"
 #include "ReplicatableVector.hpp"
 #include "Warnings.hpp"
 
 MatrixVentilationProblem::MatrixVentilationProblem(const std::string& rMeshDirFilePath, unsigned rootIndex)
     : AbstractVentilationProblem(rMeshDirFilePath, rootIndex),
       mpLinearSystem(nullptr),
-      mSolution(nullptr)
+      mSolution(nullptr),
+      mUseTreeSolver(true),
+      mTreeTraversalSetUp(false),
+      mIsPureTree(false),
+      mSolvedOnTree(false)
+{
+    mFluxScaling = 1;//mViscosity;
+}
+
+MatrixVentilationProblem::~MatrixVentilationProblem()
+{
+    if (mpLinearSystem)
+    {
+        delete mpLinearSystem;
+    }
+    if (mSolution)
+    {
+        PetscTools::Destroy(mSolution);
+    }
+}
+
+void MatrixVentilationProblem::CreateLinearSystem()
 {
+    assert(mpLinearSystem == nullptr);
 
     // We solve for flux at every edge and for pressure at each node/bifurcation
     // Note pipe flow equation has 3 variables and flux balance has 3 variables (at a bifurcation)
@@ -68,20 +96,6 @@ MatrixVentilationProblem::MatrixVentilationProblem(const std::string& rMeshDirFi
     PetscTools::SetOption("-ksp_diagonal_scale_fix","");
     mpLinearSystem->SetKspType("fgmres");
 #endif
-
-    mFluxScaling = 1;//mViscosity;
-}
-
-MatrixVentilationProblem::~MatrixVentilationProblem()
-{
-    if (mpLinearSystem)
-    {
-        delete mpLinearSystem;
-    }
-    if (mSolution)
-    {
-        PetscTools::Destroy(mSolution);
-    }
 }
 
 void MatrixVentilationProblem::SetMeshInMilliMetres()
@@ -96,17 +110,20 @@ void MatrixVentilationProblem::SetMeshInMilliMetres()
     mFluxScaling = 1e10; // 1e9 would be enough to put the fluxes in mm^3/s rather than m^3/s we may scale further to account for small airways
 }
 
+void MatrixVentilationProblem::SetUseTreeSolver(bool useTreeSolver)
+{
+    mUseTreeSolver = useTreeSolver;
+}
+
 void MatrixVentilationProblem::SetPressureAtBoundaryNode(const Node<3>& rNode, double pressure)
 {
     if (rNode.IsBoundaryNode() == false)
     {
         EXCEPTION("Boundary conditions cannot be set at internal nodes");
     }
-    unsigned pressure_index =  mMesh.GetNumElements() +  rNode.GetIndex();
-
-    mpLinearSystem->SetMatrixElement(pressure_index, pressure_index,  1.0);
-    mpLinearSystem->SetRhsVectorElement(pressure_index, pressure);
-    PetscVecTools::SetElement(mSolution, pressure_index, pressure); // Make a good guess
+    // Conditions are stored here and written into the linear system (if any) at solve time
+    mFluxCondition.erase(rNode.GetIndex());
+    mPressureCondition[rNode.GetIndex()] = pressure;
 }
 
 void MatrixVentilationProblem::SetFluxAtBoundaryNode(const Node<3>& rNode, double flux)
@@ -115,22 +132,47 @@ void MatrixVentilationProblem::SetFluxAtBoundaryNode(const Node<3>& rNode, doubl
     {
         EXCEPTION("Boundary conditions cannot be set at internal nodes");
     }
+    mPressureCondition.erase(rNode.GetIndex());
+    mFluxCondition[rNode.GetIndex()] = flux;
+}
 
-    // In a <1,3> mesh a boundary node will be associated with exactly one edge.
-    // Flux boundary conditions are set in the system matrix using
-    // the node index for the row and the edge index for the column.
-    // The row associated with the leaf node is used so that the edge's row
-    // can still be used to solve for flux/pressure.
-    unsigned edge_index = *( rNode.ContainingElementsBegin() );
-    unsigned pressure_index =  mMesh.GetNumElements() +  rNode.GetIndex();
+void MatrixVentilationProblem::ApplyBoundaryConditionsToLinearSystem()
+{
+    for (std::map<unsigned, double>::const_iterator it = mPressureCondition.begin();
+         it != mPressureCondition.end();
+         ++it)
+    {
+        unsigned pressure_index =  mMesh.GetNumElements() +  it->first;
 
-    mpLinearSystem->SetMatrixElement(pressure_index, edge_index,  1.0);
-    mpLinearSystem->SetRhsVectorElement(pressure_index, flux*mFluxScaling);
-    PetscVecTools::SetElement(mSolution, edge_index, flux*mFluxScaling); // Make a good guess
+        mpLinearSystem->SetMatrixElement(pressure_index, pressure_index,  1.0);
+        mpLinearSystem->SetRhsVectorElement(pressure_index, it->second);
+        PetscVecTools::SetElement(mSolution, pressure_index, it->second); // Make a good guess
+    }
+
+    for (std::map<unsigned, double>::const_iterator it = mFluxCondition.begin();
+         it != mFluxCondition.end();
+         ++it)
+    {
+        // In a <1,3> mesh a boundary node will be associated with exactly one edge.
+        // Flux boundary conditions are set in the system matrix using
+        // the node index for the row and the edge index for the column.
+        // The row associated with the leaf node is used so that the edge's row
+        // can still be used to solve for flux/pressure.
+        unsigned edge_index = *( mMesh.GetNode(it->first)->ContainingElementsBegin() );
+        unsigned pressure_index =  mMesh.GetNumElements() +  it->first;
+
+        mpLinearSystem->SetMatrixElement(pressure_index, edge_index,  1.0);
+        mpLinearSystem->SetRhsVectorElement(pressure_index, it->second*mFluxScaling);
+        PetscVecTools::SetElement(mSolution, edge_index, it->second*mFluxScaling); // Make a good guess
+    }
 }
 
 double MatrixVentilationProblem::GetFluxAtOutflow()
 {
+    if (mSolvedOnTree)
+    {
+        return mFlux[mOutletNodeIndex];
+    }
     if (PetscTools::IsSequential())
     {
         return PetscVecTools::GetElement(mSolution, mOutletNodeIndex) / mFluxScaling;
@@ -221,7 +263,30 @@ void MatrixVentilationProblem::Assemble(bool dynamicReassemble)
 
 void MatrixVentilationProblem::Solve()
 {
+    if (mUseTreeSolver && !mTreeTraversalSetUp)
+    {
+        SetUpTreeTraversal();
+    }
+    if (mUseTreeSolver && mIsPureTree)
+    {
+        SolveTree();
+        mSolvedOnTree = true;
+    }
+    else
+    {
+        SolveLinearSystem();
+        mSolvedOnTree = false;
+    }
+}
+
+void MatrixVentilationProblem::SolveLinearSystem()
+{
+    if (mpLinearSystem == nullptr)
+    {
+        CreateLinearSystem();
+    }
     Assemble();
+    ApplyBoundaryConditionsToLinearSystem();
     mpLinearSystem->AssembleFinalLinearSystem();
     PetscVecTools::Finalise(mSolution);
     //mpLinearSystem->DisplayMatrix();
@@ -257,9 +322,223 @@ void MatrixVentilationProblem::Solve()
     //PetscVecTools::Display(mSolution);
 }
 
+void MatrixVentilationProblem::SetUpTreeTraversal()
+{
+    mTreeTraversalSetUp = true;
+    const unsigned num_elements = mMesh.GetNumElements();
+
+    // A connected tree has exactly one fewer edge than it has nodes
+    mIsPureTree = (num_elements + 1u == mMesh.GetNumNodes());
+    if (!mIsPureTree)
+    {
+        return;
+    }
+
+    AirwayTreeWalker walker(mMesh, mOutletNodeIndex);
+    mEdgeOrder.clear();
+    mEdgeOrder.reserve(num_elements);
+    mProximalNode.resize(num_elements);
+    mDistalNode.resize(num_elements);
+    mDownwardSign.resize(num_elements);
+
+    // Breadth-first, so that every parent edge is listed before its children
+    mEdgeOrder.push_back(walker.GetOutletElementIndex());
+    for (unsigned i=0; i<mEdgeOrder.size(); i++)
+    {
+        Element<1,3>* p_element = mMesh.GetElement(mEdgeOrder[i]);
+        unsigned element_index = p_element->GetIndex();
+        unsigned distal_node = walker.GetDistalNodeIndex(p_element);
+
+        mDistalNode[element_index] = distal_node;
+        if (p_element->GetNodeGlobalIndex(1) == distal_node)
+        {
+            mProximalNode[element_index] = p_element->GetNodeGlobalIndex(0);
+            mDownwardSign[element_index] = 1.0;
+        }
+        else
+        {
+            mProximalNode[element_index] = p_element->GetNodeGlobalIndex(1);
+            mDownwardSign[element_index] = -1.0;
+        }
+
+        std::vector<unsigned> child_indices = walker.GetChildElementIndices(p_element);
+        mEdgeOrder.insert(mEdgeOrder.end(), child_indices.begin(), child_indices.end());
+    }
+    mIsPureTree = (mEdgeOrder.size() == num_elements);
+
+    mResistance.assign(num_elements, 0.0);
+    mResistanceFlux.assign(num_elements, DBL_MAX);
+    mAdmittance.resize(num_elements);
+    mFluxOffset.resize(num_elements);
+    mFlux.assign(num_elements, 0.0);
+    mPressure.assign(mMesh.GetNumNodes(), 0.0);
+}
+
+void MatrixVentilationProblem::UpdateTreeResistances(bool dynamic)
+{
+    for (unsigned i=0; i<mEdgeOrder.size(); i++)
+    {
+        unsigned element_index = mEdgeOrder[i];
+        if (!dynamic)
+        {
+            mResistance[element_index] = CalculateResistance(*mMesh.GetElement(element_index));
+            mResistanceFlux[element_index] = DBL_MAX;
+        }
+        else if (mResistanceFlux[element_index] != mFlux[element_index])
+        {
+            // Only edges whose flux has moved need their resistance recalculated
+            mResistance[element_index] = CalculateResistance(*mMesh.GetElement(element_index), true, mFlux[element_index]);
+            mResistanceFlux[element_index] = mFlux[element_index];
+        }
+    }
+}
+
+void MatrixVentilationProblem::SolveTreeWithFixedResistances()
+{
+    /* Upward sweep.  The downward flux in each edge is written as a linear function of the
+     * pressure at its proximal node, Q = a*P + b, which summarises the whole subtree below it.
+     * Since the edge order is breadth-first, working backwards visits all children before their parent.
+     * The sums of a and b over the children of each node are accumulated in mPressure, which is
+     * then overwritten by the downward sweep.
+     */
+    std::vector<double>& r_sum_admittance = mPressure;
+    std::vector<double> sum_offset(mMesh.GetNumNodes(), 0.0);
+    std::fill(r_sum_admittance.begin(), r_sum_admittance.end(), 0.0);
+
+    for (std::vector<unsigned>::reverse_iterator it = mEdgeOrder.rbegin(); it != mEdgeOrder.rend(); ++it)
+    {
+        unsigned element_index = *it;
+        unsigned distal_node = mDistalNode[element_index];
+        double resistance = mResistance[element_index];
+
+        std::map<unsigned, double>::const_iterator pressure_bc = mPressureCondition.find(distal_node);
+        std::map<unsigned, double>::const_iterator flux_bc = mFluxCondition.find(distal_node);
+        if (pressure_bc != mPressureCondition.end())
+        {
+            mAdmittance[element_index] = 1.0/resistance;
+            mFluxOffset[element_index] = -pressure_bc->second/resistance;
+        }
+        else if (flux_bc != mFluxCondition.end())
+        {
+            mAdmittance[element_index] = 0.0;
+            mFluxOffset[element_index] = mDownwardSign[element_index]*flux_bc->second;
+        }
+        else
+        {
+            // Internal node (or a leaf with no condition, which is closed)
+            double denominator = 1.0 + r_sum_admittance[distal_node]*resistance;
+            mAdmittance[element_index] = r_sum_admittance[distal_node]/denominator;
+            mFluxOffset[element_index] = sum_offset[distal_node]/denominator;
+        }
+        r_sum_admittance[mProximalNode[element_index]] += mAdmittance[element_index];
+        sum_offset[mProximalNode[element_index]] += mFluxOffset[element_index];
+    }
+
+    // Pressure at the root
+    double root_pressure;
+    std::map<unsigned, double>::const_iterator root_pressure_bc = mPressureCondition.find(mOutletNodeIndex);
+    std::map<unsigned, double>::const_iterator root_flux_bc = mFluxCondition.find(mOutletNodeIndex);
+    if (root_pressure_bc != mPressureCondition.end())
+    {
+        root_pressure = root_pressure_bc->second;
+    }
+    else if (root_flux_bc != mFluxCondition.end())
+    {
+        if (r_sum_admittance[mOutletNodeIndex] == 0.0)
+        {
+            EXCEPTION("Pressure is not determined: at least one pressure boundary condition is needed");
+        }
+        unsigned outlet_element = mEdgeOrder[0];
+        double downward_flux = mDownwardSign[outlet_element]*root_flux_bc->second;
+        root_pressure = (downward_flux - sum_offset[mOutletNodeIndex])/r_sum_admittance[mOutletNodeIndex];
+    }
+    else
+    {
+        EXCEPTION("No boundary condition has been set at the outlet node");
+    }
+
+    // Downward sweep: parents before children
+    mPressure[mOutletNodeIndex] = root_pressure;
+    for (std::vector<unsigned>::const_iterator it = mEdgeOrder.begin(); it != mEdgeOrder.end(); ++it)
+    {
+        unsigned element_index = *it;
+        unsigned distal_node = mDistalNode[element_index];
+        double proximal_pressure = mPressure[mProximalNode[element_index]];
+        double downward_flux = mAdmittance[element_index]*proximal_pressure + mFluxOffset[element_index];
+
+        mFlux[element_index] = mDownwardSign[element_index]*downward_flux;
+
+        std::map<unsigned, double>::const_iterator pressure_bc = mPressureCondition.find(distal_node);
+        if (pressure_bc != mPressureCondition.end())
+        {
+            mPressure[distal_node] = pressure_bc->second;
+        }
+        else
+        {
+            mPressure[distal_node] = proximal_pressure - mResistance[element_index]*downward_flux;
+        }
+    }
+}
+
+void MatrixVentilationProblem::SolveTree()
+{
+    if (!mDynamicResistance)
+    {
+        UpdateTreeResistances(false);
+        SolveTreeWithFixedResistances();
+        return;
+    }
+
+    /* Dynamic (Pedley) resistance: fixed-point iteration on the resistances.  The first
+     * solve starts from Poiseuille resistances; later solves (e.g. the next time step of a
+     * DynamicVentilationProblem) start from the previous fluxes.
+     */
+    if (!mSolvedOnTree)
+    {
+        UpdateTreeResistances(false);
+        SolveTreeWithFixedResistances();
+    }
+
+    std::vector<double> old_flux;
+    std::vector<double> old_pressure;
+    double relative_diff = DBL_MAX;
+    do
+    {
+        old_flux = mFlux;
+        old_pressure = mPressure;
+        UpdateTreeResistances(true);
+        SolveTreeWithFixedResistances();
+
+        double flux_diff = 0.0;
+        double flux_norm = 0.0;
+        for (unsigned i=0; i<mFlux.size(); i++)
+        {
+            flux_diff = std::max(flux_diff, fabs(mFlux[i] - old_flux[i]));
+            flux_norm = std::max(flux_norm, fabs(mFlux[i]));
+        }
+        double pressure_diff = 0.0;
+        double pressure_norm = 0.0;
+        for (unsigned i=0; i<mPressure.size(); i++)
+        {
+            pressure_diff = std::max(pressure_diff, fabs(mPressure[i] - old_pressure[i]));
+            pressure_norm = std::max(pressure_norm, fabs(mPressure[i]));
+        }
+        relative_diff = std::max(flux_norm > 0.0 ? flux_diff/flux_norm : flux_diff,
+                                 pressure_norm > 0.0 ? pressure_diff/pressure_norm : pressure_diff);
+    }
+    while (relative_diff > 10.0*DBL_EPSILON);
+}
+
 void MatrixVentilationProblem::GetSolutionAsFluxesAndPressures(std::vector<double>& rFluxesOnEdges,
                                                          std::vector<double>& rPressuresOnNodes)
 {
+    if (mSolvedOnTree)
+    {
+        rFluxesOnEdges = mFlux;
+        rPressuresOnNodes = mPressure;
+        return;
+    }
+
     ReplicatableVector solution_vector_repl( mSolution );
     unsigned num_elem = mMesh.GetNumElements();
 //    double max_flux = 0.0;
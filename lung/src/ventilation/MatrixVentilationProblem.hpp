@@ -38,6 +38,9 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 //#define LUNG_USE_KLU 1 //Uncomment to use a direct solver
 
+#include <map>
+#include <vector>
+
 #include "AbstractVentilationProblem.hpp"
 #include "LinearSystem.hpp"
 #include "TimeStepper.hpp"
@@ -53,16 +56,81 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  * Current functionality: pressure boundary conditions are set on each of the boundary nodes
  * Solves for pressure at internal nodes and flux on edges
  *
- * In this subclass all node pressures and edge fluxes are solved simultaneously using a direct matrix solution.
+ * In this subclass all node pressures and edge fluxes are solved simultaneously.  On a pure tree (the
+ * default case) this is done directly in O(N) by an upward sweep which reduces each subtree to a linear
+ * flux-pressure relation at its top, followed by a downward sweep which recovers pressures and fluxes.
+ * Otherwise (or if SetUseTreeSolver(false) is called) a PETSc linear system is assembled and solved.
+ * The linear system is only created when it is first needed.
  */
 class MatrixVentilationProblem : public AbstractVentilationProblem
 {
 private:
-    LinearSystem* mpLinearSystem; /**< Linear system for pressure (at nodes) and flux (in edges).  Allocated by constructor */
+    LinearSystem* mpLinearSystem; /**< Linear system for pressure (at nodes) and flux (in edges).  Allocated when first needed */
 
     double mFluxScaling;  /**< In order to keep the pressure and flux solution at a comparable magnitude, so solve for mFluxScaling * flux.  This should be the same scale as Poiseuille resistance (comparable to viscosity).*/
     Vec mSolution; /**< Allow access to the solution of the linear system and use as a guess later */
 
+    std::map<unsigned, double> mPressureCondition; /**< Pressure boundary conditions, by node index */
+    std::map<unsigned, double> mFluxCondition; /**< Flux boundary conditions, by node index */
+
+    bool mUseTreeSolver; /**< Whether to solve directly on the tree when the mesh is a pure tree (defaults to true) */
+    bool mTreeTraversalSetUp; /**< Whether SetUpTreeTraversal() has been called */
+    bool mIsPureTree; /**< Whether the mesh is a tree, so that the tree solver can be used */
+    bool mSolvedOnTree; /**< Whether the most recent solution came from the tree solver */
+
+    std::vector<unsigned> mEdgeOrder; /**< Edge indices in breadth-first order from the root, so parents come before children */
+    std::vector<unsigned> mProximalNode; /**< The node nearer the root of each edge */
+    std::vector<unsigned> mDistalNode; /**< The node further from the root of each edge */
+    std::vector<double> mDownwardSign; /**< +1 if an edge is oriented away from the root (node 0 proximal), -1 otherwise */
+
+    std::vector<double> mResistance; /**< Resistance of each edge used by the tree solver */
+    std::vector<double> mResistanceFlux; /**< The flux each dynamic resistance was calculated from (DBL_MAX if Poiseuille) */
+    std::vector<double> mAdmittance; /**< Tree solver: the downward flux in each edge is mAdmittance*proximal pressure + mFluxOffset */
+    std::vector<double> mFluxOffset; /**< Tree solver: see #mAdmittance */
+
+    std::vector<double> mFlux; /**< Tree solver flux solution, in edge orientation (unscaled) */
+    std::vector<double> mPressure; /**< Tree solver pressure solution */
+
+    /**
+     * Create the PETSc linear system and choose its solver.
+     */
+    void CreateLinearSystem();
+
+    /**
+     * Write the stored boundary conditions into the linear system (and the initial guess).
+     */
+    void ApplyBoundaryConditionsToLinearSystem();
+
+    /**
+     * Solve by assembling and solving the PETSc linear system.
+     */
+    void SolveLinearSystem();
+
+    /**
+     * Work out the breadth-first traversal order of the tree with an AirwayTreeWalker, and
+     * the direction of each edge.  This is done once, and reused by every subsequent solve.
+     */
+    void SetUpTreeTraversal();
+
+    /**
+     * Recalculate the resistance of each edge used by the tree solver.
+     *
+     * @param dynamic  whether to use dynamic (Pedley) resistance based on the current flux.  In this
+     *     case only edges whose flux has changed since their resistance was calculated are updated.
+     */
+    void UpdateTreeResistances(bool dynamic);
+
+    /**
+     * Solve the linear (fixed resistance) problem directly on the tree, by upward and
+     * downward sweeps.
+     */
+    void SolveTreeWithFixedResistances();
+
+    /**
+     * Solve directly on the tree, iterating on the resistances if dynamic resistance is in use.
+     */
+    void SolveTree();
+
 
     /** Assemble the linear system by writing in
      *  * flux balance at the nodes
@@ -135,11 +203,20 @@ public:
      */
     void SetFluxAtBoundaryNode(const Node<3>& rNode, double flux);
 
-    /** Assemble the linear system by writing in
+    /**
+     * Choose whether to solve directly on the tree (when the mesh is a pure tree), or to always
+     * assemble and solve a PETSc linear system.
+     *
+     * @param useTreeSolver  whether to use the tree solver (defaults to true)
+     */
+    void SetUseTreeSolver(bool useTreeSolver=true);
+
+    /**
+     * Solve for the fluxes and pressures, either directly on the tree or by
+     * assembling the linear system from
      *  * flux balance at the nodes
      *  * Poiseuille flow in the edges
-     *
-     *  Solve the linear system
+     * and solving it.
      */
     void Solve();
 
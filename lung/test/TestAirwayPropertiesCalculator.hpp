@@ -38,6 +38,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <cxxtest/TestSuite.h>
 #include <queue>
+#include <set>
 
 #include "TetrahedralMesh.hpp"
 #include "TrianglesMeshReader.hpp"
@@ -222,6 +223,68 @@ public:
         TS_ASSERT_DELTA(branch_resistances[1], 6.0 + sqrt(72), 1e-6);
 
     }
+
+    void TestUpdateSubtree()
+    {
+        TetrahedralMesh<1, 3> mesh;
+        TrianglesMeshReader<1,3> mesh_reader("lung/test/data/TestSubtreeProperties");
+        mesh.ConstructFromMeshReader(mesh_reader);
+
+        AirwayPropertiesCalculator properties_calculator(mesh, 0u);
+        TS_ASSERT_THROWS_THIS(properties_calculator.SetNumberOfThreads(0u),
+                              "The number of airway property threads must be at least one.");
+        properties_calculator.SetNumberOfThreads(2u);
+        TS_ASSERT_EQUALS(properties_calculator.GetNumberOfThreads(), 2u);
+
+        // Each child comes before its parent
+        std::vector<unsigned> post_order = properties_calculator.rGetPostOrderBranchIndices();
+        TS_ASSERT_EQUALS(post_order.size(), 3u);
+        TS_ASSERT_EQUALS(post_order[0], 1u);
+        TS_ASSERT_EQUALS(post_order[1], 2u);
+        TS_ASSERT_EQUALS(post_order[2], 0u);
+
+        properties_calculator.CalculateBranchProperties();
+        properties_calculator.CalculateSubtreeProperties();
+        properties_calculator.CalculateUpstreamProperties();
+
+        // Double the radius along the first child branch, apart from where it joins the trachea
+        AirwayBranch* p_branch = properties_calculator.GetBranches()[1];
+        std::list<Element<1,3>* > elements = p_branch->GetElements();
+        std::set<Node<3>*> nodes;
+        for (std::list<Element<1,3>* >::iterator iter = elements.begin(); iter != elements.end(); ++iter)
+        {
+            nodes.insert((*iter)->GetNode(0));
+            nodes.insert((*iter)->GetNode(1));
+        }
+        nodes.erase(p_branch->GetProximalNode());
+        for (std::set<Node<3>*>::iterator iter = nodes.begin(); iter != nodes.end(); ++iter)
+        {
+            (*iter)->rGetNodeAttributes()[0] *= 2.0;
+        }
+
+        properties_calculator.UpdateSubtree(p_branch);
+
+        // The updated properties match those of a new calculator
+        AirwayPropertiesCalculator new_calculator(mesh, 0u);
+        new_calculator.CalculateBranchProperties();
+        new_calculator.CalculateSubtreeProperties();
+        new_calculator.CalculateUpstreamProperties();
+
+        TS_ASSERT_DELTA(properties_calculator.GetMinorDiameterOverMajorDiameterMean(), new_calculator.GetMinorDiameterOverMajorDiameterMean(), 1e-12);
+        TS_ASSERT_DELTA(properties_calculator.GetDiameterOverParentDiameterMean(), new_calculator.GetDiameterOverParentDiameterMean(), 1e-12);
+        TS_ASSERT_DELTA(properties_calculator.GetLengthOverDiameterMean(), new_calculator.GetLengthOverDiameterMean(), 1e-12);
+        for (unsigned branch_idx = 0; branch_idx < 3u; branch_idx++)
+        {
+            TS_ASSERT_DELTA(properties_calculator.GetSubtreeBranchVolumes()[branch_idx], new_calculator.GetSubtreeBranchVolumes()[branch_idx], 1e-12);
+            TS_ASSERT_DELTA(properties_calculator.GetSubtreePoiseuilleResistances()[branch_idx], new_calculator.GetSubtreePoiseuilleResistances()[branch_idx], 1e-12);
+            TS_ASSERT_DELTA(norm_2(properties_calculator.GetSubtreeCentroids()[branch_idx] - new_calculator.GetSubtreeCentroids()[branch_idx]), 0.0, 1e-12);
+            TS_ASSERT_DELTA(properties_calculator.GetUpstreamBranchVolumes()[branch_idx], new_calculator.GetUpstreamBranchVolumes()[branch_idx], 1e-12);
+            TS_ASSERT_DELTA(properties_calculator.GetUpstreamPoiseuilleResistances()[branch_idx], new_calculator.GetUpstreamPoiseuilleResistances()[branch_idx], 1e-12);
+        }
+
+        // The trachea and the other child are unchanged, so only the first child's volume has grown
+        TS_ASSERT_LESS_THAN(new_calculator.GetSubtreeBranchVolumes()[2] + 1e-6, new_calculator.GetSubtreeBranchVolumes()[1]);
+    }
 };
 
 #endif /*_TESTAIRWAYPROPERTIESCALCULATOR_HPP_*/
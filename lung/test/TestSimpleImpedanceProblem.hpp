@@ -201,6 +201,54 @@ public:
         TS_ASSERT_DELTA(real(impedances[6])*1e-3/98, 5.77, 1e-2);
         TS_ASSERT_DELTA(imag(impedances[6])*1e-3/98, 4.12, 1e-2);
     }
+
+    void TestSingleWalkMatchesPerFrequencyWalks()
+    {
+        TetrahedralMesh<1,3> mesh;
+        TrianglesMeshReader<1,3> mesh_reader("lung/test/data/TestSubject002");
+        mesh.ConstructFromMeshReader(mesh_reader);
+
+        std::vector<double> test_frequencies;
+        test_frequencies.push_back(0.0);
+        test_frequencies.push_back(1.0);
+        test_frequencies.push_back(2.5);
+        test_frequencies.push_back(5.0);
+        test_frequencies.push_back(10.0);
+        test_frequencies.push_back(20.0);
+        test_frequencies.push_back(30.0);
+
+        SimpleImpedanceProblem problem(mesh, 0u);
+        problem.SetMeshInMilliMetres();
+        problem.SetFrequencies(test_frequencies);
+        problem.Solve();
+        std::vector<std::complex<double> > impedances = problem.rGetImpedances();
+        TS_ASSERT_EQUALS(impedances.size(), test_frequencies.size());
+
+        // Walking the tree once for all frequencies gives the same as a walk per frequency
+        Element<1,3>* p_root_element = mesh.GetElement(*(mesh.GetNode(0u)->ContainingElementsBegin()));
+        for (unsigned f=0; f<test_frequencies.size(); f++)
+        {
+            std::complex<double> single_impedance = problem.CalculateElementImpedance(p_root_element, test_frequencies[f]);
+            double tolerance = 1e-12*std::abs(single_impedance);
+            TS_ASSERT_DELTA(real(impedances[f]), real(single_impedance), tolerance);
+            TS_ASSERT_DELTA(imag(impedances[f]), imag(single_impedance), tolerance);
+        }
+
+        // Splitting the frequencies between threads gives the same again
+        TS_ASSERT_EQUALS(problem.GetNumberOfThreads(), 1u);
+        TS_ASSERT_THROWS_THIS(problem.SetNumberOfThreads(0u),
+                              "The number of impedance threads must be at least one.");
+        problem.SetNumberOfThreads(3u);
+        TS_ASSERT_EQUALS(problem.GetNumberOfThreads(), 3u);
+        problem.Solve();
+        std::vector<std::complex<double> >& r_threaded_impedances = problem.rGetImpedances();
+        TS_ASSERT_EQUALS(r_threaded_impedances.size(), test_frequencies.size());
+        for (unsigned f=0; f<test_frequencies.size(); f++)
+        {
+            TS_ASSERT_EQUALS(real(r_threaded_impedances[f]), real(impedances[f]));
+            TS_ASSERT_EQUALS(imag(r_threaded_impedances[f]), imag(impedances[f]));
+        }
+    }
 };
 
 #endif /*_TESTIMPEDANCEPROBLEM_HPP_*/
@@ -55,6 +55,13 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "vtkSphereSource.h"
 #include "vtkXMLPolyDataWriter.h"
 #include "vtkSTLReader.h"
+#include "vtkPoints.h"
+#include "vtkIdList.h"
+#include "vtkMath.h"
+
+#include <cfloat>
+#include <utility>
+#include <vector>
 
 #endif //CHASTE_VTK
 
@@ -177,6 +184,17 @@ public:
             TS_ASSERT_LESS_THAN(coords[1], 0.0);
         }
 
+        // Points on the plane belong to the normal side only
+        vtkSmartPointer<vtkPoints> line_points = vtkSmartPointer<vtkPoints>::New();
+        line_points->InsertNextPoint(0.0, -1.0, 0.0);
+        line_points->InsertNextPoint(0.0, 0.0, 0.0);
+        line_points->InsertNextPoint(0.0, 1.0, 0.0);
+        vtkSmartPointer<vtkPolyData> line_cloud = vtkSmartPointer<vtkPolyData>::New();
+        line_cloud->SetPoints(line_points);
+
+        TS_ASSERT_EQUALS(generator.SplitPointCloud(line_cloud, normal, origin, false)->GetNumberOfPoints(), 2);
+        TS_ASSERT_EQUALS(generator.SplitPointCloud(line_cloud, normal, origin, true)->GetNumberOfPoints(), 1);
+
 #endif
     }
 
@@ -740,6 +758,97 @@ public:
     #endif
     }
 
+    void TestGenerateMatchesReferenceAlgorithm()
+    {
+#if defined(CHASTE_VTK) && ( (VTK_MAJOR_VERSION >= 5 && VTK_MINOR_VERSION >= 6) || VTK_MAJOR_VERSION >= 6)
+        EXIT_IF_PARALLEL;
+        vtkSmartPointer<vtkPolyData> sphere = CreateSphere();
+
+        // The angle limit is off, so a branch just grows a fixed fraction of the way to its centre of mass
+        double min_branch_length = 0.1;
+        unsigned point_limit = 1;
+        double angle_limit = 180.0;
+        double branching_fraction = 0.4;
+
+        // Off-centre so that no seed point is equidistant from two apices
+        double origin[3] = {0.013, 0.95, 0.021};
+        double direction[3] = {1.0, 0.0, 0.0};
+        double parent_direction[3] = {1.0, 0.0, 0.0};
+
+        AirwayGenerator generator(sphere, min_branch_length, point_limit, angle_limit, branching_fraction);
+        generator.AddInitialApex(origin, direction, parent_direction, 10.0, 0);
+        generator.CreatePointCloudUsingTargetPoints(200);
+        generator.Generate();
+
+        // Grow the same tree with the straightforward algorithm: brute force distribution, splitting and searches
+        std::vector<c_vector<double, 3> > seeds(generator.GetPointCloud()->GetNumberOfPoints());
+        for (unsigned i = 0; i < seeds.size(); ++i)
+        {
+            generator.GetPointCloud()->GetPoint(i, seeds[i].data());
+        }
+
+        AirwayGenerator surface_checker(sphere);
+        std::vector<c_vector<double, 3> > reference_points;
+        std::vector<std::pair<unsigned, unsigned> > reference_lines;
+        GrowReferenceTree(surface_checker, seeds, origin, direction, parent_direction,
+                          min_branch_length, point_limit, branching_fraction,
+                          reference_points, reference_lines);
+
+        vtkSmartPointer<vtkPolyData> tree = generator.GetAirwayTree();
+        TS_ASSERT_LESS_THAN(10u, reference_points.size());
+        TS_ASSERT_EQUALS((unsigned)tree->GetNumberOfPoints(), reference_points.size());
+        TS_ASSERT_EQUALS((unsigned)tree->GetNumberOfCells(), reference_lines.size());
+
+        if ((unsigned)tree->GetNumberOfPoints() == reference_points.size())
+        {
+            for (unsigned i = 0; i < reference_points.size(); ++i)
+            {
+                double point[3];
+                tree->GetPoint(i, point);
+                for (unsigned d = 0; d < 3; ++d)
+                {
+                    TS_ASSERT_DELTA(point[d], reference_points[i][d], 1e-6);
+                }
+            }
+        }
+        if ((unsigned)tree->GetNumberOfCells() == reference_lines.size())
+        {
+            vtkSmartPointer<vtkIdList> line_ids = vtkSmartPointer<vtkIdList>::New();
+            for (unsigned i = 0; i < reference_lines.size(); ++i)
+            {
+                tree->GetCellPoints(i, line_ids);
+                TS_ASSERT_EQUALS((unsigned)line_ids->GetId(0), reference_lines[i].first);
+                TS_ASSERT_EQUALS((unsigned)line_ids->GetId(1), reference_lines[i].second);
+            }
+        }
+
+        // Planning the apices on several threads gives exactly the same tree
+        AirwayGenerator threaded_generator(sphere, min_branch_length, point_limit, angle_limit, branching_fraction);
+        TS_ASSERT_THROWS_THIS(threaded_generator.SetNumberOfThreads(0u),
+                              "The number of airway generation threads must be at least one.");
+        threaded_generator.SetNumberOfThreads(4u);
+        TS_ASSERT_EQUALS(threaded_generator.GetNumberOfThreads(), 4u);
+        threaded_generator.AddInitialApex(origin, direction, parent_direction, 10.0, 0);
+        threaded_generator.CreatePointCloudUsingTargetPoints(200);
+        threaded_generator.Generate();
+
+        vtkSmartPointer<vtkPolyData> threaded_tree = threaded_generator.GetAirwayTree();
+        TS_ASSERT_EQUALS(threaded_tree->GetNumberOfPoints(), tree->GetNumberOfPoints());
+        TS_ASSERT(threaded_generator.GetInvalidIds() == generator.GetInvalidIds());
+        for (int i = 0; i < std::min(tree->GetNumberOfPoints(), threaded_tree->GetNumberOfPoints()); ++i)
+        {
+            double point[3];
+            double threaded_point[3];
+            tree->GetPoint(i, point);
+            threaded_tree->GetPoint(i, threaded_point);
+            for (unsigned d = 0; d < 3; ++d)
+            {
+                TS_ASSERT_EQUALS(threaded_point[d], point[d]);
+            }
+        }
+#endif
+    }
+
     void TestDummyClassCoverage()
     {
 #if !(defined(CHASTE_VTK) && ( (VTK_MAJOR_VERSION >= 5 && VTK_MINOR_VERSION >= 6) || VTK_MAJOR_VERSION >= 6))
@@ -752,6 +861,200 @@ public:
 
 private:
 #if defined(CHASTE_VTK) && ( (VTK_MAJOR_VERSION >= 5 && VTK_MINOR_VERSION >= 6) || VTK_MAJOR_VERSION >= 6)
+    /**
+     * Grows an airway tree from a single apex with no angle limit, as the generator did before it had a
+     * growth point index: every valid seed point goes to its nearest apex, each apex cloud is split in
+     * two by a brute force pass, and terminal branches invalidate the nearest point of their half.
+     * Tree points are stored in single precision, as vtkPoints stores them.
+     */
+    void GrowReferenceTree(AirwayGenerator& rSurfaceChecker,
+                           const std::vector<c_vector<double, 3> >& rSeeds,
+                           double start[3],
+                           double direction[3],
+                           double parentDirection[3],
+                           double minBranchLength,
+                           unsigned pointLimit,
+                           double branchingFraction,
+                           std::vector<c_vector<double, 3> >& rTreePoints,
+                           std::vector<std::pair<unsigned, unsigned> >& rTreeLines)
+    {
+        struct ReferenceApex
+        {
+            unsigned mStartId;
+            double mLocation[3];
+            double mDirection[3];
+            double mParentDirection[3];
+        };
+
+        std::vector<bool> invalid(rSeeds.size(), false);
+
+        ReferenceApex initial_apex;
+        initial_apex.mStartId = 0;
+        std::copy(start, start+3, initial_apex.mLocation);
+        std::copy(direction, direction+3, initial_apex.mDirection);
+        std::copy(parentDirection, parentDirection+3, initial_apex.mParentDirection);
+        std::vector<ReferenceApex> apices(1, initial_apex);
+
+        c_vector<double, 3> start_point;
+        for (unsigned d = 0; d < 3; ++d)
+        {
+            start_point[d] = (float)start[d];
+        }
+        rTreePoints.push_back(start_point);
+
+        for (unsigned generation = 0; !apices.empty() && generation < AirwayGenerator::MAX_GENERATIONS; ++generation)
+        {
+            // Distribute the valid seed points to their nearest apex (apex locations are stored in single precision)
+            std::vector<std::vector<unsigned> > clouds(apices.size());
+            for (unsigned seed = 0; seed < rSeeds.size(); ++seed)
+            {
+                if (invalid[seed])
+                {
+                    continue;
+                }
+                unsigned nearest_apex = 0;
+                double nearest_distance2 = DBL_MAX;
+                for (unsigned a = 0; a < apices.size(); ++a)
+                {
+                    double distance2 = 0.0;
+                    for (unsigned d = 0; d < 3; ++d)
+                    {
+                        double offset = rSeeds[seed][d] - (float)apices[a].mLocation[d];
+                        distance2 += offset*offset;
+                    }
+                    if (distance2 < nearest_distance2)
+                    {
+                        nearest_distance2 = distance2;
+                        nearest_apex = a;
+                    }
+                }
+                clouds[nearest_apex].push_back(seed);
+            }
+
+            std::vector<ReferenceApex> next_apices;
+            for (unsigned a = 0; a < apices.size(); ++a)
+            {
+                ReferenceApex& r_apex = apices[a];
+                if (clouds[a].empty())
+                {
+                    continue;
+                }
+
+                double centre[3] = {0.0, 0.0, 0.0};
+                for (unsigned i = 0; i < clouds[a].size(); ++i)
+                {
+                    for (unsigned d = 0; d < 3; ++d)
+                    {
+                        centre[d] += rSeeds[clouds[a][i]][d];
+                    }
+                }
+                for (unsigned d = 0; d < 3; ++d)
+                {
+                    centre[d] /= clouds[a].size();
+                }
+
+                double centre_direction[3];
+                vtkMath::Subtract(centre, r_apex.mLocation, centre_direction);
+                vtkMath::Normalize(centre_direction);
+                double normal[3];
+                vtkMath::Cross(r_apex.mDirection, centre_direction, normal);
+                if (vtkMath::Norm(normal) < 1e-10)
+                {
+                    vtkMath::Cross(r_apex.mDirection, r_apex.mParentDirection, normal);
+                }
+                vtkMath::Normalize(normal);
+
+                for (unsigned side = 0; side < 2; ++side)
+                {
+                    std::vector<unsigned> half;
+                    for (unsigned i = 0; i < clouds[a].size(); ++i)
+                    {
+                        double signed_distance = 0.0;
+                        for (unsigned d = 0; d < 3; ++d)
+                        {
+                            signed_distance += (rSeeds[clouds[a][i]][d] - centre[d])*normal[d];
+                        }
+                        if ((signed_distance >= 0.0) == (side == 0))
+                        {
+                            half.push_back(clouds[a][i]);
+                        }
+                    }
+                    if (half.empty())
+                    {
+                        continue;
+                    }
+
+                    double end[3] = {0.0, 0.0, 0.0};
+                    for (unsigned i = 0; i < half.size(); ++i)
+                    {
+                        for (unsigned d = 0; d < 3; ++d)
+                        {
+                            end[d] += rSeeds[half[i]][d];
+                        }
+                    }
+                    for (unsigned d = 0; d < 3; ++d)
+                    {
+                        end[d] /= half.size();
+                    }
+
+                    // Shorten the branch as CheckBranchAngleLengthAndAdjust does
+                    double branch_start[3];
+                    std::copy(rTreePoints[r_apex.mStartId].begin(), rTreePoints[r_apex.mStartId].end(), branch_start);
+                    double branch[3];
+                    vtkMath::Subtract(end, branch_start, branch);
+                    double branch_length = vtkMath::Norm(branch);
+                    vtkMath::Normalize(branch);
+                    vtkMath::MultiplyScalar(branch, branch_length*branchingFraction);
+                    vtkMath::Add(branch_start, branch, end);
+
+                    int end_id = -1;
+                    if (rSurfaceChecker.IsInsideLobeSurface(end))
+                    {
+                        c_vector<double, 3> end_point;
+                        for (unsigned d = 0; d < 3; ++d)
+                        {
+                            end_point[d] = (float)end[d];
+                        }
+                        end_id = rTreePoints.size();
+                        rTreePoints.push_back(end_point);
+                        rTreeLines.push_back(std::make_pair(r_apex.mStartId, (unsigned)end_id));
+                    }
+
+                    if (std::sqrt(vtkMath::Distance2BetweenPoints(branch_start, end)) > minBranchLength
+                        && half.size() > pointLimit
+                        && end_id != -1)
+                    {
+                        ReferenceApex child;
+                        child.mStartId = end_id;
+                        std::copy(end, end+3, child.mLocation);
+                        vtkMath::Subtract(end, r_apex.mLocation, child.mDirection);
+                        vtkMath::Normalize(child.mDirection);
+                        std::copy(r_apex.mDirection, r_apex.mDirection+3, child.mParentDirection);
+                        next_apices.push_back(child);
+                    }
+                    else
+                    {
+                        unsigned closest_seed = half[0];
+                        double closest_distance2 = DBL_MAX;
+                        for (unsigned i = 0; i < half.size(); ++i)
+                        {
+                            double seed_point[3];
+                            std::copy(rSeeds[half[i]].begin(), rSeeds[half[i]].end(), seed_point);
+                            double distance2 = vtkMath::Distance2BetweenPoints(end, seed_point);
+                            if (distance2 < closest_distance2)
+                            {
+                                closest_distance2 = distance2;
+                                closest_seed = half[i];
+                            }
+                        }
+                        invalid[closest_seed] = true;
+                    }
+                }
+            }
+            apices = next_apices;
+        }
+    }
+
     vtkSmartPointer<vtkPolyData> CreateSphere(unsigned resolution = 18, double radius = 1.0)
     {
         vtkSmartPointer<vtkSphereSource> sphere = vtkSmartPointer<vtkSphereSource>::New();
@@ -0,0 +1,172 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTAIRWAYGROWTHPOINTINDEX_HPP_
+#define TESTAIRWAYGROWTHPOINTINDEX_HPP_
+
+#include <cxxtest/TestSuite.h>
+
+#include <cfloat>
+#include <vector>
+
+#include "AirwayGrowthPointIndex.hpp"
+#include "RandomNumberGenerator.hpp"
+
+//This test is always run sequentially (never in parallel)
+#include "FakePetscSetup.hpp"
+
+class TestAirwayGrowthPointIndex : public CxxTest::TestSuite
+{
+private:
+
+    /** The closest point still in the index, by brute force (lowest id on ties) */
+    int FindClosestPointByScan(AirwayGrowthPointIndex& rIndex,
+                               const std::vector<c_vector<double, 3> >& rPoints,
+                               const c_vector<double, 3>& rLocation)
+    {
+        int closest_id = -1;
+        double closest_distance2 = DBL_MAX;
+        for (unsigned i = 0; i < rPoints.size(); ++i)
+        {
+            double distance2 = inner_prod(rPoints[i] - rLocation, rPoints[i] - rLocation);
+            if (rIndex.HasPoint(i) && distance2 < closest_distance2)
+            {
+                closest_distance2 = distance2;
+                closest_id = i;
+            }
+        }
+        return closest_id;
+    }
+
+public:
+
+    void TestRemovePoints()
+    {
+        // A 4x4x4 grid of points with unit spacing
+        std::vector<c_vector<double, 3> > points;
+        for (unsigned i = 0; i < 64; ++i)
+        {
+            c_vector<double, 3> point;
+            point[0] = i % 4;
+            point[1] = (i / 4) % 4;
+            point[2] = i / 16;
+            points.push_back(point);
+        }
+
+        AirwayGrowthPointIndex index(points, 2.0);
+        TS_ASSERT_EQUALS(index.GetNumPoints(), 64u);
+        TS_ASSERT_EQUALS(index.rGetPointIds().size(), 64u);
+
+        c_vector<double, 3> location;
+        location[0] = 1.1;
+        location[1] = 2.2;
+        location[2] = 2.9;
+        TS_ASSERT_EQUALS(index.FindClosestPoint(location), 57);
+
+        // Removed points are never found again
+        index.RemovePoint(57);
+        TS_ASSERT(!index.HasPoint(57));
+        TS_ASSERT(index.HasPoint(56));
+        TS_ASSERT_EQUALS(index.GetNumPoints(), 63u);
+        int next_closest = index.FindClosestPoint(location);
+        TS_ASSERT_DIFFERS(next_closest, 57);
+        TS_ASSERT_EQUALS(next_closest, FindClosestPointByScan(index, points, location));
+
+        // Equidistant points are resolved in favour of the lowest id
+        location[0] = 0.5;
+        location[1] = 0.0;
+        location[2] = 0.0;
+        TS_ASSERT_EQUALS(index.FindClosestPoint(location), 0);
+
+        // The remaining ids stay sorted
+        index.RemovePoint(0);
+        index.RemovePoint(63);
+        const std::vector<unsigned>& r_ids = index.rGetPointIds();
+        TS_ASSERT_EQUALS(r_ids.size(), 61u);
+        TS_ASSERT_EQUALS(r_ids.front(), 1u);
+        TS_ASSERT_EQUALS(r_ids.back(), 62u);
+        for (unsigned i = 1; i < r_ids.size(); ++i)
+        {
+            TS_ASSERT_LESS_THAN(r_ids[i-1], r_ids[i]);
+        }
+
+        // An empty index finds nothing
+        std::vector<c_vector<double, 3> > no_points;
+        AirwayGrowthPointIndex empty_index(no_points, 1.0);
+        TS_ASSERT_EQUALS(empty_index.FindClosestPoint(location), -1);
+    }
+
+    void TestFindClosestPointMatchesScan()
+    {
+        RandomNumberGenerator* p_gen = RandomNumberGenerator::Instance();
+        p_gen->Reseed(0);
+
+        std::vector<c_vector<double, 3> > points;
+        for (unsigned i = 0; i < 500; ++i)
+        {
+            c_vector<double, 3> point;
+            for (unsigned d = 0; d < 3; ++d)
+            {
+                point[d] = 10.0*p_gen->ranf();
+            }
+            points.push_back(point);
+        }
+
+        AirwayGrowthPointIndex index(points, 1.5);
+
+        // Search from inside and well outside the points, removing points as we go
+        for (unsigned query = 0; query < 300; ++query)
+        {
+            c_vector<double, 3> location;
+            for (unsigned d = 0; d < 3; ++d)
+            {
+                location[d] = 30.0*p_gen->ranf() - 10.0;
+            }
+
+            int closest_id = index.FindClosestPoint(location);
+            TS_ASSERT_EQUALS(closest_id, FindClosestPointByScan(index, points, location));
+
+            if (query % 2 == 0)
+            {
+                index.RemovePoint(closest_id);
+            }
+        }
+        TS_ASSERT_EQUALS(index.GetNumPoints(), 350u);
+
+        RandomNumberGenerator::Destroy();
+    }
+};
+
+#endif // TESTAIRWAYGROWTHPOINTINDEX_HPP_
@@ -205,6 +205,13 @@ public:
         generator.SetBranchingFraction(0.5);
         generator.SetDiameterRatio(1.6);
 
+        // The lobes are independent, so they can be grown on separate threads
+        TS_ASSERT_EQUALS(generator.GetNumberOfThreads(), 1u);
+        TS_ASSERT_THROWS_THIS(generator.SetNumberOfThreads(0u),
+                              "The number of airway generation threads must be at least one.");
+        generator.SetNumberOfThreads(3u);
+        TS_ASSERT_EQUALS(generator.GetNumberOfThreads(), 3u);
+
         generator.AddLobe(CreateCube(-2.9, 0.0, 0.0), LEFT);
         generator.AddLobe(CreateCube(0.0, 2.9, 0.0), LEFT);
         generator.AddLobe(CreateCube(2.9, 0.0, 0.0), RIGHT);
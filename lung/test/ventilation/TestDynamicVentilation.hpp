@@ -56,6 +56,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "DynamicVentilationProblem.hpp"
 #include "CommandLineArguments.hpp"
+#include "DistributedVectorFactory.hpp"
 #include "PetscSetupAndFinalize.hpp"
 
 
@@ -207,6 +208,76 @@ public:
     }
 
 
+    void TestDistributedAcinarUnitsThreeBifurcations()
+    {
+        FileFinder mesh_finder("lung/test/data/three_bifurcations", RelativeTo::ChasteSourceRoot);
+        double acinar_compliance = 0.1/98.0665/1e3/4.0;
+
+        SimpleAcinarUnitFactory<> serial_factory(acinar_compliance, 2400.0);
+        DynamicVentilationProblem serial_problem(&serial_factory, mesh_finder.GetAbsolutePath(), 0u);
+        serial_problem.rGetMatrixVentilationProblem().SetMeshInMilliMetres();
+        serial_problem.SetEndTime(0.5);
+        serial_problem.Solve();
+
+        SimpleAcinarUnitFactory<> factory(acinar_compliance, 2400.0);
+        DynamicVentilationProblem problem(&factory, mesh_finder.GetAbsolutePath(), 0u);
+        problem.rGetMatrixVentilationProblem().SetMeshInMilliMetres();
+        problem.SetDistributeAcinarUnits();
+        problem.SetEndTime(0.5);
+        problem.SetOutputDirectory("TestDynamicVentilation");
+        problem.SetOutputFilenamePrefix("three_bifurcations_distributed");
+        problem.SetWriteVtkOutput();
+        problem.Solve();
+
+        // Units advanced by this process agree with the undistributed problem
+        std::map<unsigned, AbstractAcinarUnit*>& r_serial_map = serial_problem.rGetAcinarUnitMap();
+        std::map<unsigned, AbstractAcinarUnit*>& r_acinar_map = problem.rGetAcinarUnitMap();
+        DistributedVectorFactory ownership(r_acinar_map.size());
+        unsigned i = 0;
+        for (std::map<unsigned, AbstractAcinarUnit*>::iterator iter = r_acinar_map.begin();
+             iter != r_acinar_map.end();
+             ++iter, ++i)
+        {
+            if (ownership.IsGlobalIndexLocal(i))
+            {
+                TS_ASSERT_DELTA(iter->second->GetVolume(), r_serial_map[iter->first]->GetVolume(), 1e-12);
+            }
+        }
+    }
+
+    void TestThreadedAcinarUnitsThreeBifurcations()
+    {
+        FileFinder mesh_finder("lung/test/data/three_bifurcations", RelativeTo::ChasteSourceRoot);
+        double acinar_compliance = 0.1/98.0665/1e3/4.0;
+
+        SimpleAcinarUnitFactory<> serial_factory(acinar_compliance, 2400.0);
+        DynamicVentilationProblem serial_problem(&serial_factory, mesh_finder.GetAbsolutePath(), 0u);
+        serial_problem.rGetMatrixVentilationProblem().SetMeshInMilliMetres();
+        serial_problem.SetEndTime(0.5);
+        serial_problem.Solve();
+
+        SimpleAcinarUnitFactory<> factory(acinar_compliance, 2400.0);
+        DynamicVentilationProblem problem(&factory, mesh_finder.GetAbsolutePath(), 0u);
+        problem.rGetMatrixVentilationProblem().SetMeshInMilliMetres();
+        TS_ASSERT_EQUALS(problem.GetNumberOfAcinarThreads(), 1u);
+        TS_ASSERT_THROWS_THIS(problem.SetNumberOfAcinarThreads(0u),
+                              "The number of acinar unit threads must be at least one.");
+        problem.SetNumberOfAcinarThreads(3u);
+        TS_ASSERT_EQUALS(problem.GetNumberOfAcinarThreads(), 3u);
+        problem.SetEndTime(0.5);
+        problem.Solve();
+
+        // The units are independent, so threading doesn't change the results
+        std::map<unsigned, AbstractAcinarUnit*>& r_serial_map = serial_problem.rGetAcinarUnitMap();
+        std::map<unsigned, AbstractAcinarUnit*>& r_acinar_map = problem.rGetAcinarUnitMap();
+        for (std::map<unsigned, AbstractAcinarUnit*>::iterator iter = r_acinar_map.begin();
+             iter != r_acinar_map.end();
+             ++iter)
+        {
+            TS_ASSERT_EQUALS(iter->second->GetVolume(), r_serial_map[iter->first]->GetVolume());
+        }
+    }
+
     void TestColemanDynamicVentilationOtisBifurcations()
     {
 #if defined(LUNG_USE_UMFPACK) || defined(LUNG_USE_KLU)
@@ -473,6 +473,49 @@ public:
 //        vtk_writer.AddCellData("Radii", radii);
 //        vtk_writer.WriteFilesUsingMesh(problem.rGetMesh());
     }
+    void TestTreeSolverAgreesWithLinearSystem()
+    {
+        std::vector<double> tree_flux, tree_pressure, matrix_flux, matrix_pressure;
+        {
+            MatrixVentilationProblem problem("lung/test/data/three_bifurcations_extra_links", 0u);
+            problem.SetMeshInMilliMetres();
+            problem.SetOutflowPressure(0.0);
+            problem.SetConstantInflowPressures(150000);
+            problem.SetDynamicResistance();
+            problem.Solve();
+            problem.GetSolutionAsFluxesAndPressures(tree_flux, tree_pressure);
+
+            // A second solve (as in a time step) starts from the previous fluxes and should give the same answer
+            problem.Solve();
+            std::vector<double> flux, pressure;
+            problem.GetSolutionAsFluxesAndPressures(flux, pressure);
+            for (unsigned i=0; i<flux.size(); i++)
+            {
+                TS_ASSERT_DELTA(flux[i], tree_flux[i], 1e-15);
+            }
+            TS_ASSERT_DELTA(problem.GetFluxAtOutflow(), tree_flux[0], 1e-15);
+        }
+        {
+            MatrixVentilationProblem problem("lung/test/data/three_bifurcations_extra_links", 0u);
+            problem.SetUseTreeSolver(false);
+            problem.SetMeshInMilliMetres();
+            problem.SetOutflowPressure(0.0);
+            problem.SetConstantInflowPressures(150000);
+            problem.SetDynamicResistance();
+            problem.Solve();
+            problem.GetSolutionAsFluxesAndPressures(matrix_flux, matrix_pressure);
+        }
+        TS_ASSERT_EQUALS(tree_flux.size(), matrix_flux.size());
+        for (unsigned i=0; i<tree_flux.size(); i++)
+        {
+            TS_ASSERT_DELTA(tree_flux[i], matrix_flux[i], 1e-11);
+        }
+        for (unsigned i=0; i<tree_pressure.size(); i++)
+        {
+            TS_ASSERT_DELTA(tree_pressure[i], matrix_pressure[i], 1e-1);
+        }
+    }
+
     void TestExceptions()
     {
         TS_ASSERT_THROWS_THIS(MatrixVentilationProblem bad_problem("mesh/test/data/y_branch_3d_mesh", 1u),
@@ -484,6 +527,10 @@ public:
         TS_ASSERT_THROWS_THIS(problem.SetPressureAtBoundaryNode(3u, 0.0), "Boundary conditions cannot be set at internal nodes");
         TS_ASSERT_THROWS_THIS(problem.SetFluxAtBoundaryNode(3u, 0.0), "Boundary conditions cannot be set at internal nodes");
 
+        problem.SetOutflowFlux(1.0);
+        problem.SetConstantInflowFluxes(-0.25);
+        TS_ASSERT_THROWS_THIS(problem.Solve(), "Pressure is not determined: at least one pressure boundary condition is needed");
+
     }
 };
 
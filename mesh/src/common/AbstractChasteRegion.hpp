@@ -44,6 +44,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <boost/shared_ptr.hpp>
 
 #include "ChastePoint.hpp"
+#include "Node.hpp"
 
 /**
  * Abstract base class for Chaste regions.
@@ -96,6 +97,19 @@ public:
      */
 
     virtual bool DoesContain(const ChastePoint<SPACE_DIM>& rPointToCheck) const = 0;
+
+    /**
+     * Checks whether a mesh node is contained in the region. By default this checks the
+     * node's location with DoesContain(); regions which can say more cheaply (or only)
+     * from the node itself, e.g. from its index or attributes, override this.
+     *
+     * @param pNode  the node to be checked to be contained in the region
+     * @return true if the node is contained, false otherwise
+     */
+    virtual bool DoesContainNode(Node<SPACE_DIM>* pNode) const
+    {
+        return DoesContain(pNode->GetPoint());
+    }
 };
 
 TEMPLATED_CLASS_IS_ABSTRACT_1_UNSIGNED(AbstractChasteRegion)
@@ -44,7 +44,10 @@ template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 AbstractMesh<ELEMENT_DIM, SPACE_DIM>::AbstractMesh()
         : mpDistributedVectorFactory(nullptr),
           mMeshFileBaseName(""),
-          mMeshChangesDuringSimulation(false)
+          mMeshChangesDuringSimulation(false),
+          mpNodeAttributesStore(nullptr),
+          mUseSpatialSearch(false),
+          mpNodeKdTree(nullptr)
 {
 }
 
@@ -60,6 +63,9 @@ AbstractMesh<ELEMENT_DIM, SPACE_DIM>::~AbstractMesh()
     {
         delete mpDistributedVectorFactory;
     }
+    // Only once the nodes have released their slots
+    delete mpNodeAttributesStore;
+    delete mpNodeKdTree;
 }
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
@@ -89,6 +95,34 @@ unsigned AbstractMesh<ELEMENT_DIM, SPACE_DIM>::GetNumNodeAttributes() const
     return mNodes[0]->GetNumNodeAttributes();
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractMesh<ELEMENT_DIM, SPACE_DIM>::UseCompactNodeAttributes()
+{
+    if (mpNodeAttributesStore == nullptr)
+    {
+        mpNodeAttributesStore = new NodeAttributesStore<SPACE_DIM>(mNodes.size());
+        for (unsigned i = 0; i < mNodes.size(); i++)
+        {
+            mNodes[i]->UseAttributesStore(mpNodeAttributesStore);
+        }
+    }
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool AbstractMesh<ELEMENT_DIM, SPACE_DIM>::HasCompactNodeAttributes() const
+{
+    return (mpNodeAttributesStore != nullptr);
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractMesh<ELEMENT_DIM, SPACE_DIM>::AttachNodeToAttributesStore(Node<SPACE_DIM>* pNode)
+{
+    if (mpNodeAttributesStore)
+    {
+        pNode->UseAttributesStore(mpNodeAttributesStore);
+    }
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 Node<SPACE_DIM>* AbstractMesh<ELEMENT_DIM, SPACE_DIM>::GetNode(unsigned index) const
 {
@@ -293,6 +327,12 @@ unsigned AbstractMesh<ELEMENT_DIM, SPACE_DIM>::GetNearestNodeIndex(const ChasteP
          */
         return UINT_MAX; // LCOV_EXCL_LINE
     }
+    if (mUseSpatialSearch)
+    {
+        unsigned nearest = rGetNodeKdTree().GetNearestPoint(rTestPoint.rGetLocation());
+        return (nearest == UINT_MAX) ? UINT_MAX : mNodes[mNodeKdTreeLocalIndices[nearest]]->GetIndex();
+    }
+
     // Hold the best distance from node to point found so far
     // and the (local) node at which this was recorded
     unsigned best_node_index = 0u;
@@ -474,9 +514,70 @@ void AbstractMesh<ELEMENT_DIM, SPACE_DIM>::Rotate(double theta)
     RotateZ(theta);
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+std::vector<unsigned> AbstractMesh<ELEMENT_DIM, SPACE_DIM>::GetNearestNodeIndices(const std::vector<ChastePoint<SPACE_DIM> >& rTestPoints)
+{
+    std::vector<unsigned> nearest_node_indices(rTestPoints.size(), UINT_MAX);
+    if (!mNodes.empty())
+    {
+        NodeKdTree<SPACE_DIM>& r_tree = rGetNodeKdTree();
+        for (unsigned i = 0; i < rTestPoints.size(); i++)
+        {
+            unsigned nearest = r_tree.GetNearestPoint(rTestPoints[i].rGetLocation());
+            if (nearest != UINT_MAX)
+            {
+                nearest_node_indices[i] = mNodes[mNodeKdTreeLocalIndices[nearest]]->GetIndex();
+            }
+        }
+    }
+    return nearest_node_indices;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+NodeKdTree<SPACE_DIM>& AbstractMesh<ELEMENT_DIM, SPACE_DIM>::rGetNodeKdTree()
+{
+    if (mpNodeKdTree == nullptr)
+    {
+        std::vector<c_vector<double, SPACE_DIM> > locations;
+        locations.reserve(mNodes.size());
+        mNodeKdTreeLocalIndices.clear();
+        for (unsigned i = 0; i < mNodes.size(); i++)
+        {
+            if (!mNodes[i]->IsDeleted())
+            {
+                locations.push_back(mNodes[i]->rGetLocation());
+                mNodeKdTreeLocalIndices.push_back(i);
+            }
+        }
+        mpNodeKdTree = new NodeKdTree<SPACE_DIM>(locations);
+    }
+    return *mpNodeKdTree;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractMesh<ELEMENT_DIM, SPACE_DIM>::SetUseSpatialSearch(bool useSpatialSearch)
+{
+    mUseSpatialSearch = useSpatialSearch;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool AbstractMesh<ELEMENT_DIM, SPACE_DIM>::GetUseSpatialSearch() const
+{
+    return mUseSpatialSearch;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractMesh<ELEMENT_DIM, SPACE_DIM>::InvalidateSpatialSearch()
+{
+    delete mpNodeKdTree;
+    mpNodeKdTree = nullptr;
+    std::vector<unsigned>().swap(mNodeKdTreeLocalIndices);
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void AbstractMesh<ELEMENT_DIM, SPACE_DIM>::RefreshMesh()
 {
+    InvalidateSpatialSearch();
 }
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
@@ -50,6 +50,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "DistributedVectorFactory.hpp"
 #include "ProcessSpecificArchive.hpp"
 #include "ChasteCuboid.hpp"
+#include "NodeKdTree.hpp"
 
 #include <boost/utility.hpp>
 
@@ -124,6 +125,39 @@ protected:  // Give access of these variables to subclasses
      */
     bool mMeshChangesDuringSimulation;
 
+    /**
+     * Mesh-level store for node attributes, if UseCompactNodeAttributes() has
+     * been called; otherwise NULL and each node owns its own attributes.
+     */
+    NodeAttributesStore<SPACE_DIM>* mpNodeAttributesStore;
+
+    /** Whether single-point searches use #mpNodeKdTree (and, in subclasses, other search structures). */
+    bool mUseSpatialSearch;
+
+    /**
+     * k-d tree over the locations of the (non-deleted) nodes held by this process,
+     * built by GetNodeKdTree() when first needed and discarded by InvalidateSpatialSearch().
+     */
+    NodeKdTree<SPACE_DIM>* mpNodeKdTree;
+
+    /**
+     * Local indices (positions in #mNodes) of the points in #mpNodeKdTree.
+     */
+    std::vector<unsigned> mNodeKdTreeLocalIndices;
+
+    /**
+     * @return the k-d tree over the nodes held by this process, building it if needed.
+     */
+    NodeKdTree<SPACE_DIM>& rGetNodeKdTree();
+
+    /**
+     * Move the attributes of a node into #mpNodeAttributesStore, if this mesh
+     * has one. Called by subclasses whenever they add a node.
+     *
+     * @param pNode the node
+     */
+    void AttachNodeToAttributesStore(Node<SPACE_DIM>* pNode);
+
     /**
      * Does nothing.  Used in derived classes which have elements
      */
@@ -200,6 +234,22 @@ public:
      */
     unsigned GetNumNodeAttributes() const;
 
+    /**
+     * Keep the attributes of all nodes (radius, applied force, neighbours,
+     * region, flags and user attributes) in mesh-level arrays instead of a
+     * separate heap object per node. Existing attributes are moved across,
+     * and nodes added to the mesh later use the arrays too. This saves memory
+     * and improves locality on meshes with very many nodes.
+     *
+     * Calling this more than once has no further effect.
+     */
+    void UseCompactNodeAttributes();
+
+    /**
+     * @return whether UseCompactNodeAttributes() has been called.
+     */
+    bool HasCompactNodeAttributes() const;
+
     /**
      * Get the node with a given index in the mesh.
      *
@@ -352,6 +402,46 @@ public:
       */
     virtual unsigned GetNearestNodeIndex(const ChastePoint<SPACE_DIM>& rTestPoint);
 
+    /**
+     * As GetNearestNodeIndex(), for many points at once. The search always uses a
+     * k-d tree over the nodes, built once for all the points, and so assumes
+     * Euclidean distances (unlike GetNearestNodeIndex() in, e.g., Cylindrical2dMesh).
+     *
+     * This method is overridden in the distributed case to return global node indices.
+     *
+     * @param rTestPoints the points
+     * @return the global index of the nearest node to each point
+     */
+    virtual std::vector<unsigned> GetNearestNodeIndices(const std::vector<ChastePoint<SPACE_DIM> >& rTestPoints);
+
+    /**
+     * Set whether single-point searches (GetNearestNodeIndex() and, for
+     * tetrahedral meshes, the GetContainingElementIndex() family) should use
+     * spatial search structures: a k-d tree over the nodes and a bounding volume
+     * hierarchy over the elements. These are built the first time they are needed
+     * and shared by all subsequent searches until the mesh changes.
+     *
+     * The structures assume Euclidean distances, and are discarded by
+     * RefreshMesh(), by SetNode() and when nodes or elements are added or
+     * deleted. Code that moves nodes directly must call RefreshMesh() or
+     * InvalidateSpatialSearch() before searching again.
+     *
+     * @param useSpatialSearch whether to use spatial search structures (defaults to true)
+     */
+    void SetUseSpatialSearch(bool useSpatialSearch=true);
+
+    /**
+     * @return whether single-point searches use spatial search structures.
+     */
+    bool GetUseSpatialSearch() const;
+
+    /**
+     * Discard the spatial search structures, so that they are rebuilt the next
+     * time they are needed. Overridden in AbstractTetrahedralMesh, which has
+     * further structures; overrides should call this version too.
+     */
+    virtual void InvalidateSpatialSearch();
+
     /**
      * Scale the mesh.
      *
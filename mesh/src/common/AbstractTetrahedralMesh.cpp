@@ -33,8 +33,55 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 */
 
+#include <algorithm>
+#include <climits>
 #include <limits>
 #include "AbstractTetrahedralMesh.hpp"
+#include "ElementBoundingVolumeHierarchy.hpp"
+
+namespace
+{
+/**
+ * Helper for AbstractTetrahedralMesh::GetElementBoundingVolumeHierarchy(): the
+ * hierarchy only handles meshes whose elements have the dimension of the space.
+ */
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+struct ElementHierarchyBuilder
+{
+    /**
+     * @return NULL, as there is no hierarchy for this mesh.
+     * @param rMesh the mesh
+     */
+    static ElementBoundingVolumeHierarchy<SPACE_DIM>* Build(AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>& rMesh)
+    {
+        return nullptr;
+    }
+};
+
+/**
+ * Specialisation of ElementHierarchyBuilder for meshes whose elements have the
+ * dimension of the space.
+ */
+template <unsigned DIM>
+struct ElementHierarchyBuilder<DIM, DIM>
+{
+    /**
+     * @return a new hierarchy over the (non-deleted) elements held by this process.
+     * @param rMesh the mesh
+     */
+    static ElementBoundingVolumeHierarchy<DIM>* Build(AbstractTetrahedralMesh<DIM, DIM>& rMesh)
+    {
+        std::set<unsigned> element_indices;
+        for (typename AbstractTetrahedralMesh<DIM, DIM>::ElementIterator iter = rMesh.GetElementIteratorBegin();
+             iter != rMesh.GetElementIteratorEnd();
+             ++iter)
+        {
+            element_indices.insert(iter->GetIndex());
+        }
+        return new ElementBoundingVolumeHierarchy<DIM>(rMesh, element_indices);
+    }
+};
+}
 
 ///////////////////////////////////////////////////////////////////////////////////
 // Implementation
@@ -64,13 +111,21 @@ void AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::SetElementOwnerships()
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::AbstractTetrahedralMesh()
-    : mMeshIsLinear(true)
+    : AbstractMemoryAccountable(MemoryAccounting::MESH),
+      mMeshIsLinear(true),
+      mNumElementsPerParentElement(1u),
+      mUseElementGeometryCache(false),
+      mElementGeometryCacheIsValid(false),
+      mTopologyCacheIsValid(false),
+      mpElementHierarchy(nullptr)
 {
 }
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::~AbstractTetrahedralMesh()
 {
+    delete mpElementHierarchy;
+
     // Iterate over elements and free the memory
     for (unsigned i=0; i<mElements.size(); i++)
     {
@@ -125,6 +180,41 @@ unsigned AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::GetNumCableElements()
     return 0u;
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::GetNumElementsPerParentElement() const
+{
+    return mNumElementsPerParentElement;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+double AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::GetMemoryUsage() const
+{
+    // A node's containing element indices are held in a std::set, at about four pointers per entry
+    const double set_entry_bytes = 4.0*sizeof(void*);
+
+    double bytes = GetVectorBytes(this->mNodes) + GetVectorBytes(this->mBoundaryNodes)
+                 + GetVectorBytes(mElements) + GetVectorBytes(mBoundaryElements);
+    for (unsigned i=0; i<this->mNodes.size(); i++)
+    {
+        bytes += sizeof(Node<SPACE_DIM>) + this->mNodes[i]->GetNumContainingElements()*set_entry_bytes;
+    }
+    for (unsigned i=0; i<mElements.size(); i++)
+    {
+        bytes += sizeof(Element<ELEMENT_DIM, SPACE_DIM>) + mElements[i]->GetNumNodes()*sizeof(Node<SPACE_DIM>*);
+    }
+    for (unsigned i=0; i<mBoundaryElements.size(); i++)
+    {
+        bytes += sizeof(BoundaryElement<ELEMENT_DIM-1, SPACE_DIM>) + mBoundaryElements[i]->GetNumNodes()*sizeof(Node<SPACE_DIM>*);
+    }
+
+    // Element geometry and topology caches
+    bytes += GetVectorBytes(mCachedJacobians) + GetVectorBytes(mCachedInverseJacobians)
+           + GetVectorBytes(mCachedJacobianDeterminants) + GetVectorBytes(mCachedBasisGradients);
+    bytes += GetVectorBytes(mTopologyNodeRows) + GetVectorBytes(mNodeElementOffsets) + GetVectorBytes(mNodeElementIndices)
+           + GetVectorBytes(mNodeNeighbourOffsets) + GetVectorBytes(mNodeNeighbourIndices) + GetVectorBytes(mElementNeighbourIndices);
+    return bytes;
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 unsigned AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::GetNumVertices() const
 {
@@ -173,6 +263,393 @@ void AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::GetInverseJacobianForEleme
     mElements[SolveElementMapping(elementIndex)]->CalculateInverseJacobian(rJacobian, rJacobianDeterminant, rInverseJacobian);
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::SetUseElementGeometryCache(bool useCache)
+{
+    mUseElementGeometryCache = useCache;
+    InvalidateElementGeometryCache();
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::GetUseElementGeometryCache() const
+{
+    return mUseElementGeometryCache;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::InvalidateElementGeometryCache()
+{
+    mElementGeometryCacheIsValid = false;
+    if (!mUseElementGeometryCache)
+    {
+        // Release the memory
+        std::vector<c_matrix<double, SPACE_DIM, ELEMENT_DIM> >().swap(mCachedJacobians);
+        std::vector<c_matrix<double, ELEMENT_DIM, SPACE_DIM> >().swap(mCachedInverseJacobians);
+        std::vector<double>().swap(mCachedJacobianDeterminants);
+        std::vector<c_matrix<double, SPACE_DIM, ELEMENT_DIM+1> >().swap(mCachedBasisGradients);
+    }
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+c_matrix<double, ELEMENT_DIM, ELEMENT_DIM+1> AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::CalculateCanonicalBasisGradients()
+{
+    // phi_0 = 1 - x_0 - ... and phi_j = x_{j-1} on the canonical element
+    c_matrix<double, ELEMENT_DIM, ELEMENT_DIM+1> grad_phi = zero_matrix<double>(ELEMENT_DIM, ELEMENT_DIM+1);
+    for (unsigned i=0; i<ELEMENT_DIM; i++)
+    {
+        grad_phi(i, 0) = -1.0;
+        grad_phi(i, i+1) = 1.0;
+    }
+    return grad_phi;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::RefreshElementGeometryCache() const
+{
+    const c_matrix<double, ELEMENT_DIM, ELEMENT_DIM+1> canonical_grad_phi = CalculateCanonicalBasisGradients();
+
+    unsigned num_local_elements = mElements.size();
+    mCachedJacobians.resize(num_local_elements);
+    mCachedInverseJacobians.resize(num_local_elements);
+    mCachedJacobianDeterminants.resize(num_local_elements);
+    mCachedBasisGradients.resize(num_local_elements);
+
+    for (unsigned i=0; i<num_local_elements; i++)
+    {
+        if (!mElements[i]->IsDeleted())
+        {
+            mElements[i]->CalculateInverseJacobian(mCachedJacobians[i], mCachedJacobianDeterminants[i], mCachedInverseJacobians[i]);
+            noalias(mCachedBasisGradients[i]) = prod(trans(mCachedInverseJacobians[i]), canonical_grad_phi);
+        }
+    }
+    mElementGeometryCacheIsValid = true;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::GetElementGeometry(
+        unsigned elementIndex,
+        c_matrix<double, SPACE_DIM, ELEMENT_DIM>& rJacobian,
+        double& rJacobianDeterminant,
+        c_matrix<double, ELEMENT_DIM, SPACE_DIM>& rInverseJacobian,
+        c_matrix<double, SPACE_DIM, ELEMENT_DIM+1>& rGradPhi) const
+{
+    if (mUseElementGeometryCache)
+    {
+        if (!mElementGeometryCacheIsValid || mCachedJacobians.size() != mElements.size())
+        {
+            RefreshElementGeometryCache();
+        }
+        unsigned local_index = SolveElementMapping(elementIndex);
+        rJacobian = mCachedJacobians[local_index];
+        rJacobianDeterminant = mCachedJacobianDeterminants[local_index];
+        rInverseJacobian = mCachedInverseJacobians[local_index];
+        rGradPhi = mCachedBasisGradients[local_index];
+    }
+    else
+    {
+        GetInverseJacobianForElement(elementIndex, rJacobian, rJacobianDeterminant, rInverseJacobian);
+
+        const c_matrix<double, ELEMENT_DIM, ELEMENT_DIM+1> canonical_grad_phi = CalculateCanonicalBasisGradients();
+        noalias(rGradPhi) = prod(trans(rInverseJacobian), canonical_grad_phi);
+    }
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::PrepareToRepartitionOnLoad()
+{
+    return false;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::RefreshMesh()
+{
+    InvalidateElementGeometryCache();
+    InvalidateTopologyCache();
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::InvalidateTopologyCache()
+{
+    mTopologyCacheIsValid = false;
+
+    // Release the memory
+    std::vector<unsigned>().swap(mTopologyNodeRows);
+    std::vector<unsigned>().swap(mNodeElementOffsets);
+    std::vector<unsigned>().swap(mNodeElementIndices);
+    std::vector<unsigned>().swap(mNodeNeighbourOffsets);
+    std::vector<unsigned>().swap(mNodeNeighbourIndices);
+    std::vector<unsigned>().swap(mElementNeighbourIndices);
+
+    // Adding or deleting nodes or elements also invalidates the search structures
+    this->InvalidateSpatialSearch();
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::InvalidateSpatialSearch()
+{
+    AbstractMesh<ELEMENT_DIM, SPACE_DIM>::InvalidateSpatialSearch();
+    delete mpElementHierarchy;
+    mpElementHierarchy = nullptr;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+ElementBoundingVolumeHierarchy<SPACE_DIM>* AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::GetElementBoundingVolumeHierarchy()
+{
+    if (mpElementHierarchy == nullptr)
+    {
+        mpElementHierarchy = ElementHierarchyBuilder<ELEMENT_DIM, SPACE_DIM>::Build(*this);
+    }
+    return mpElementHierarchy;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::GetContainingElementIndexFromHierarchy(ElementBoundingVolumeHierarchy<SPACE_DIM>& rHierarchy,
+                                                                                                 const ChastePoint<SPACE_DIM>& rTestPoint,
+                                                                                                 bool strict)
+{
+    // The candidates are ordered, so this finds the lowest-indexed containing element
+    std::set<unsigned> candidates;
+    rHierarchy.GetCandidateContainingElements(rTestPoint.rGetLocation(), candidates);
+    for (std::set<unsigned>::iterator iter = candidates.begin(); iter != candidates.end(); ++iter)
+    {
+        if (this->GetElement(*iter)->IncludesPoint(rTestPoint, strict))
+        {
+            return *iter;
+        }
+    }
+    return UINT_MAX;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+std::vector<unsigned> AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::GetContainingElementIndicesForPoints(const std::vector<ChastePoint<SPACE_DIM> >& rTestPoints,
+                                                                                                           bool strict)
+{
+    std::vector<unsigned> element_indices(rTestPoints.size(), UINT_MAX);
+    ElementBoundingVolumeHierarchy<SPACE_DIM>* p_hierarchy = GetElementBoundingVolumeHierarchy();
+    for (unsigned i=0; i<rTestPoints.size(); i++)
+    {
+        if (p_hierarchy)
+        {
+            element_indices[i] = GetContainingElementIndexFromHierarchy(*p_hierarchy, rTestPoints[i], strict);
+        }
+        else
+        {
+            for (unsigned j=0; j<mElements.size(); j++)
+            {
+                if (!mElements[j]->IsDeleted() && mElements[j]->IncludesPoint(rTestPoints[i], strict))
+                {
+                    element_indices[i] = mElements[j]->GetIndex();
+                    break;
+                }
+            }
+        }
+    }
+    return element_indices;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::RefreshTopologyCache() const
+{
+    const unsigned num_rows = this->mNodes.size();
+    const unsigned num_local_elements = mElements.size();
+
+    // Map global node indices onto rows
+    unsigned max_node_index = 0;
+    for (unsigned row=0; row<num_rows; row++)
+    {
+        max_node_index = std::max(max_node_index, this->mNodes[row]->GetIndex());
+    }
+    for (unsigned i=0; i<num_local_elements; i++)
+    {
+        for (unsigned j=0; j<mElements[i]->GetNumNodes(); j++)
+        {
+            max_node_index = std::max(max_node_index, mElements[i]->GetNodeGlobalIndex(j));
+        }
+    }
+    mTopologyNodeRows.assign(max_node_index+1, UINT_MAX);
+    for (unsigned row=0; row<num_rows; row++)
+    {
+        if (!this->mNodes[row]->IsDeleted())
+        {
+            mTopologyNodeRows[this->mNodes[row]->GetIndex()] = row;
+        }
+    }
+
+    // Node to local elements, counting the entries of each row and then filling them in
+    std::vector<unsigned> local_offsets(num_rows+1, 0u);
+    for (unsigned i=0; i<num_local_elements; i++)
+    {
+        if (!mElements[i]->IsDeleted())
+        {
+            for (unsigned j=0; j<mElements[i]->GetNumNodes(); j++)
+            {
+                unsigned row = mTopologyNodeRows[mElements[i]->GetNodeGlobalIndex(j)];
+                if (row != UINT_MAX)
+                {
+                    local_offsets[row+1]++;
+                }
+            }
+        }
+    }
+    for (unsigned row=0; row<num_rows; row++)
+    {
+        local_offsets[row+1] += local_offsets[row];
+    }
+    std::vector<unsigned> local_elements(local_offsets[num_rows]);
+    std::vector<unsigned> next_entry(local_offsets.begin(), local_offsets.end()-1);
+    for (unsigned i=0; i<num_local_elements; i++)
+    {
+        if (!mElements[i]->IsDeleted())
+        {
+            for (unsigned j=0; j<mElements[i]->GetNumNodes(); j++)
+            {
+                unsigned row = mTopologyNodeRows[mElements[i]->GetNodeGlobalIndex(j)];
+                if (row != UINT_MAX)
+                {
+                    local_elements[next_entry[row]++] = i;
+                }
+            }
+        }
+    }
+
+    // Node to global elements, and node to nodes
+    mNodeElementOffsets = local_offsets;
+    mNodeElementIndices.resize(local_elements.size());
+    mNodeNeighbourOffsets.assign(1, 0u);
+    mNodeNeighbourOffsets.reserve(num_rows+1);
+    mNodeNeighbourIndices.clear();
+    std::vector<unsigned> neighbours;
+    for (unsigned row=0; row<num_rows; row++)
+    {
+        const unsigned row_begin = local_offsets[row];
+        const unsigned row_end = local_offsets[row+1];
+        neighbours.clear();
+        for (unsigned entry=row_begin; entry<row_end; entry++)
+        {
+            Element<ELEMENT_DIM, SPACE_DIM>* p_element = mElements[local_elements[entry]];
+            mNodeElementIndices[entry] = p_element->GetIndex();
+            for (unsigned j=0; j<p_element->GetNumNodes(); j++)
+            {
+                neighbours.push_back(p_element->GetNodeGlobalIndex(j));
+            }
+        }
+        std::sort(mNodeElementIndices.begin()+row_begin, mNodeElementIndices.begin()+row_end);
+
+        std::sort(neighbours.begin(), neighbours.end());
+        const unsigned this_node_index = this->mNodes[row]->GetIndex();
+        for (unsigned k=0; k<neighbours.size(); k++)
+        {
+            if (neighbours[k] != this_node_index && (k == 0 || neighbours[k] != neighbours[k-1]))
+            {
+                mNodeNeighbourIndices.push_back(neighbours[k]);
+            }
+        }
+        mNodeNeighbourOffsets.push_back(mNodeNeighbourIndices.size());
+    }
+
+    // Element to neighbouring elements: the neighbour across face j contains all the vertices but vertex j
+    mElementNeighbourIndices.assign(num_local_elements*(ELEMENT_DIM+1), UINT_MAX);
+    for (unsigned i=0; i<num_local_elements; i++)
+    {
+        if (mElements[i]->IsDeleted())
+        {
+            continue;
+        }
+        for (unsigned face=0; face<ELEMENT_DIM+1; face++)
+        {
+            // Search the elements of any face vertex held by this process
+            unsigned row = UINT_MAX;
+            for (unsigned j=0; j<ELEMENT_DIM+1 && row == UINT_MAX; j++)
+            {
+                if (j != face)
+                {
+                    row = mTopologyNodeRows[mElements[i]->GetNodeGlobalIndex(j)];
+                }
+            }
+            if (row == UINT_MAX)
+            {
+                continue;
+            }
+            for (unsigned entry=local_offsets[row]; entry<local_offsets[row+1]; entry++)
+            {
+                unsigned candidate = local_elements[entry];
+                if (candidate == i)
+                {
+                    continue;
+                }
+                unsigned num_shared = 0;
+                for (unsigned j=0; j<ELEMENT_DIM+1; j++)
+                {
+                    if (j != face)
+                    {
+                        unsigned node_index = mElements[i]->GetNodeGlobalIndex(j);
+                        for (unsigned k=0; k<ELEMENT_DIM+1; k++)
+                        {
+                            if (mElements[candidate]->GetNodeGlobalIndex(k) == node_index)
+                            {
+                                num_shared++;
+                                break;
+                            }
+                        }
+                    }
+                }
+                if (num_shared == ELEMENT_DIM)
+                {
+                    mElementNeighbourIndices[i*(ELEMENT_DIM+1)+face] = mElements[candidate]->GetIndex();
+                    break;
+                }
+            }
+        }
+    }
+
+    mTopologyCacheIsValid = true;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::GetTopologyRow(unsigned nodeIndex) const
+{
+    if (!mTopologyCacheIsValid)
+    {
+        RefreshTopologyCache();
+    }
+    if (nodeIndex >= mTopologyNodeRows.size() || mTopologyNodeRows[nodeIndex] == UINT_MAX)
+    {
+        EXCEPTION("Requested node " << nodeIndex << " does not belong to processor " << PetscTools::GetMyRank());
+    }
+    return mTopologyNodeRows[nodeIndex];
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+std::pair<typename AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::TopologyIterator,
+          typename AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::TopologyIterator>
+AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::GetNodeContainingElements(unsigned nodeIndex) const
+{
+    unsigned row = GetTopologyRow(nodeIndex);
+    return std::make_pair(mNodeElementIndices.begin() + mNodeElementOffsets[row],
+                          mNodeElementIndices.begin() + mNodeElementOffsets[row+1]);
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+std::pair<typename AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::TopologyIterator,
+          typename AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::TopologyIterator>
+AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::GetNodeNeighbours(unsigned nodeIndex) const
+{
+    unsigned row = GetTopologyRow(nodeIndex);
+    return std::make_pair(mNodeNeighbourIndices.begin() + mNodeNeighbourOffsets[row],
+                          mNodeNeighbourIndices.begin() + mNodeNeighbourOffsets[row+1]);
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::GetElementNeighbour(unsigned elementIndex, unsigned localFaceIndex) const
+{
+    assert(localFaceIndex < ELEMENT_DIM+1);
+    if (!mTopologyCacheIsValid)
+    {
+        RefreshTopologyCache();
+    }
+    return mElementNeighbourIndices[SolveElementMapping(elementIndex)*(ELEMENT_DIM+1) + localFaceIndex];
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::GetWeightedDirectionForBoundaryElement(
         unsigned elementIndex,
@@ -1004,7 +1481,22 @@ unsigned AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::GetContainingElementIn
         }
     }
 
-    if (!onlyTryWithTestElements)
+    ElementBoundingVolumeHierarchy<SPACE_DIM>* p_hierarchy = nullptr;
+    if (!onlyTryWithTestElements && this->mUseSpatialSearch)
+    {
+        p_hierarchy = GetElementBoundingVolumeHierarchy();
+    }
+
+    if (p_hierarchy)
+    {
+        // The hierarchy's boxes contain every point that its elements include, so if none does the point is not in the mesh
+        unsigned element_index = GetContainingElementIndexFromHierarchy(*p_hierarchy, rTestPoint, strict);
+        if (element_index != UINT_MAX)
+        {
+            return element_index;
+        }
+    }
+    else if (!onlyTryWithTestElements)
     {
         for (unsigned i=0; i<this->mElements.size(); i++)
         {
@@ -57,18 +57,22 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "TrianglesMeshWriter.hpp"
 #include "ArchiveLocationInfo.hpp"
 #include "FileFinder.hpp"
+#include "AbstractMemoryAccountable.hpp"
 
 
 /// Forward declaration which is going to be used for friendship
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 class AbstractConductivityTensors;
 
+template <unsigned DIM>
+class ElementBoundingVolumeHierarchy;
+
 /**
  * Abstract base class for all tetrahedral meshes (inherits from AbstractMesh).
  */
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
-class AbstractTetrahedralMesh : public AbstractMesh<ELEMENT_DIM, SPACE_DIM>
+class AbstractTetrahedralMesh : public AbstractMesh<ELEMENT_DIM, SPACE_DIM>, public AbstractMemoryAccountable
 {
     friend class AbstractConductivityTensors<ELEMENT_DIM, SPACE_DIM>; //A class which needs a global to local element mapping
     friend class CentroidWriter; //A test class which needs access to mElements in order to check that local/global indices match
@@ -78,7 +82,103 @@ protected:
      */
     bool mMeshIsLinear;
 
+    /**
+     * Number of elements made from each element of the original mesh, if the mesh was
+     * refined as it was read (see AbstractMeshReader::GetNumElementsPerParentElement()).
+     * This is 1 unless set by ConstructFromMeshReader(), and is not archived.
+     */
+    unsigned mNumElementsPerParentElement;
+
 private:
+    /** Whether GetElementGeometry() should cache its results (off by default). */
+    bool mUseElementGeometryCache;
+
+    /** Whether the cached element geometry matches the current node locations. */
+    mutable bool mElementGeometryCacheIsValid;
+
+    /** Cached Jacobian of each local element, indexed as mElements. */
+    mutable std::vector<c_matrix<double, SPACE_DIM, ELEMENT_DIM> > mCachedJacobians;
+
+    /** Cached inverse Jacobian of each local element, indexed as mElements. */
+    mutable std::vector<c_matrix<double, ELEMENT_DIM, SPACE_DIM> > mCachedInverseJacobians;
+
+    /** Cached Jacobian determinant of each local element, indexed as mElements. */
+    mutable std::vector<double> mCachedJacobianDeterminants;
+
+    /** Cached physical gradients of the linear basis functions of each local element, indexed as mElements. */
+    mutable std::vector<c_matrix<double, SPACE_DIM, ELEMENT_DIM+1> > mCachedBasisGradients;
+
+    /**
+     * @return the derivatives of the linear basis functions on the canonical element.
+     */
+    static c_matrix<double, ELEMENT_DIM, ELEMENT_DIM+1> CalculateCanonicalBasisGradients();
+
+    /**
+     * Fill the element geometry cache for every local element.
+     */
+    void RefreshElementGeometryCache() const;
+
+    /** Whether the topology tables below match the current elements. */
+    mutable bool mTopologyCacheIsValid;
+
+    /**
+     * Row of the topology tables for each global node index, or UINT_MAX if the
+     * node is not held by this process.  Rows follow the order of mNodes.
+     */
+    mutable std::vector<unsigned> mTopologyNodeRows;
+
+    /** Offsets into mNodeElementIndices of each row (one more entry than there are rows). */
+    mutable std::vector<unsigned> mNodeElementOffsets;
+
+    /** Global indices of the elements containing each node, sorted within each row. */
+    mutable std::vector<unsigned> mNodeElementIndices;
+
+    /** Offsets into mNodeNeighbourIndices of each row (one more entry than there are rows). */
+    mutable std::vector<unsigned> mNodeNeighbourOffsets;
+
+    /** Global indices of the nodes sharing an element with each node, sorted within each row. */
+    mutable std::vector<unsigned> mNodeNeighbourIndices;
+
+    /**
+     * Global index of the element across each face of each local element, or
+     * UINT_MAX if there is none on this process.  Face j of local element i
+     * is opposite its vertex j and is stored at i*(ELEMENT_DIM+1)+j.
+     */
+    mutable std::vector<unsigned> mElementNeighbourIndices;
+
+    /**
+     * Bounding volume hierarchy over the (non-deleted) elements held by this process,
+     * built by GetElementBoundingVolumeHierarchy() when first needed and discarded by
+     * InvalidateSpatialSearch().
+     */
+    ElementBoundingVolumeHierarchy<SPACE_DIM>* mpElementHierarchy;
+
+    /**
+     * Find the lowest-indexed element containing a point using the bounding
+     * volume hierarchy.
+     *
+     * @param rHierarchy the hierarchy
+     * @param rTestPoint the point
+     * @param strict whether the point must be in the interior of the element
+     * @return the global element index, or UINT_MAX if no element contains the point
+     */
+    unsigned GetContainingElementIndexFromHierarchy(ElementBoundingVolumeHierarchy<SPACE_DIM>& rHierarchy,
+                                                    const ChastePoint<SPACE_DIM>& rTestPoint,
+                                                    bool strict);
+
+    /**
+     * Build the node-element, node-node and element-neighbour tables from the
+     * local elements.
+     */
+    void RefreshTopologyCache() const;
+
+    /**
+     * @return the row of the topology tables for a node, building the tables if needed.
+     *
+     * @param nodeIndex global index of a node held by this process
+     */
+    unsigned GetTopologyRow(unsigned nodeIndex) const;
+
     /**
      * Pure virtual solve element mapping method. For an element with a given
      * global index, get the local index used by this process.
@@ -100,6 +200,15 @@ private:
      */
     virtual unsigned SolveBoundaryElementMapping(unsigned index) const = 0;
 
+    /**
+     * Called when the mesh is being loaded from an archive, before it is constructed.
+     * Overridden in DistributedTetrahedralMesh.
+     *
+     * @return whether to partition the mesh afresh, rather than give it the partition
+     *     it was saved with (the default) when loading on the same number of processes
+     */
+    virtual bool PrepareToRepartitionOnLoad();
+
     /** Needed for serialization. */
     friend class boost::serialization::access;
 
@@ -215,14 +324,15 @@ private:
         {
             p_our_factory = p_factory->GetOriginalFactory();
         }
-        if (p_our_factory && p_our_factory->GetNumProcs() == p_factory->GetNumProcs())
+        bool repartition = this->PrepareToRepartitionOnLoad();
+        if (p_our_factory && p_our_factory->GetNumProcs() == p_factory->GetNumProcs() && !repartition)
         {
             // Specify the node distribution
             this->SetDistributedVectorFactory(p_our_factory);
         }
         else
         {
-            // Migrating; let the mesh re-partition if it likes
+            // Migrating or re-partitioning; let the mesh re-partition if it likes
             /// \todo #1199  make this work for everything else...
             p_our_factory = nullptr;
         }
@@ -288,6 +398,12 @@ protected:  // Give access of these variables to subclasses
      */
     void SetElementOwnerships();
 
+    /**
+     * @return the bounding volume hierarchy over the elements held by this process,
+     * building it if needed, or NULL if ELEMENT_DIM is not equal to SPACE_DIM.
+     */
+    ElementBoundingVolumeHierarchy<SPACE_DIM>* GetElementBoundingVolumeHierarchy();
+
 public:
 
     //////////////////////////////////////////////////////////////////////
@@ -364,6 +480,20 @@ public:
      */
     virtual unsigned GetNumCableElements() const;
 
+    /**
+     * @return the number of elements made from each element of the original mesh, which is
+     * greater than one if the mesh was constructed from a UniformlyRefinedMeshReader.  Element i
+     * came from element i/GetNumElementsPerParentElement() of the original mesh, which is how
+     * per-element data such as fibre orientations are inherited.
+     */
+    unsigned GetNumElementsPerParentElement() const;
+
+    /**
+     * @return an estimate of the bytes held by the nodes, elements, boundary elements and
+     * caches of this mesh on this process (see MemoryAccounting).
+     */
+    virtual double GetMemoryUsage() const;
+
     /**
      * @return the number of vertices (nodes which are also corners of elements).  For a linear mesh all nodes are vertices,
      * so this method is a synonym for GetNumNodes.  However, it is over-ridden in quadratic meshes.
@@ -437,6 +567,104 @@ public:
                                               double& rJacobianDeterminant,
                                               c_matrix<double, ELEMENT_DIM, SPACE_DIM>& rInverseJacobian) const;
 
+    /**
+     * Turn the element geometry cache used by GetElementGeometry() on or off.
+     * The cache trades memory for assembly speed and is worth having when the
+     * same mesh is assembled on many times.  It is discarded whenever the mesh
+     * is refreshed (see RefreshMesh()) or a node is moved through MutableMesh.
+     *
+     * @param useCache  whether to cache element geometry (defaults to true)
+     */
+    void SetUseElementGeometryCache(bool useCache=true);
+
+    /**
+     * @return whether GetElementGeometry() caches its results.
+     */
+    bool GetUseElementGeometryCache() const;
+
+    /**
+     * Discard any cached element geometry, so that it is recomputed the next
+     * time it is needed.  Must be called if node locations are changed directly
+     * rather than through the mesh.
+     */
+    void InvalidateElementGeometryCache();
+
+    /**
+     * Get the Jacobian data for a given element together with the gradients of
+     * its linear basis functions in physical space, rGradPhi(i,j) = d(phi_j)/d(X_i).
+     * For linear elements these are the same at every quadrature point.
+     *
+     * If the cache is on, all local elements are computed on the first call after
+     * the cache was invalidated, and later calls are lookups.
+     *
+     * @param elementIndex global index of an element
+     * @param rJacobian  the Jacobian matrix
+     * @param rJacobianDeterminant  the determinant of the Jacobian matrix
+     * @param rInverseJacobian  the inverse Jacobian matrix
+     * @param rGradPhi  the gradients of the basis functions
+     */
+    void GetElementGeometry(unsigned elementIndex,
+                            c_matrix<double, SPACE_DIM, ELEMENT_DIM>& rJacobian,
+                            double& rJacobianDeterminant,
+                            c_matrix<double, ELEMENT_DIM, SPACE_DIM>& rInverseJacobian,
+                            c_matrix<double, SPACE_DIM, ELEMENT_DIM+1>& rGradPhi) const;
+
+    /** Definition of the iterator type used to walk a row of the topology cache. */
+    typedef std::vector<unsigned>::const_iterator TopologyIterator;
+
+    /**
+     * The topology cache holds, in compressed row form, the elements containing
+     * each node, the nodes sharing an element with each node, and the element
+     * across each face of each element.  It is built from the local elements the
+     * first time one of the methods below is called, and is much smaller than
+     * the per-node sets it duplicates.  It is discarded whenever the mesh is
+     * refreshed or its connectivity changed through MutableMesh.
+     *
+     * @return the global indices of the elements containing a node, in ascending order.
+     *
+     * @param nodeIndex global index of a node held by this process
+     */
+    std::pair<TopologyIterator, TopologyIterator> GetNodeContainingElements(unsigned nodeIndex) const;
+
+    /**
+     * @return the global indices of the other nodes sharing an element with a node,
+     * in ascending order.  See GetNodeContainingElements().
+     *
+     * @param nodeIndex global index of a node held by this process
+     */
+    std::pair<TopologyIterator, TopologyIterator> GetNodeNeighbours(unsigned nodeIndex) const;
+
+    /**
+     * @return the global index of the element sharing a face with a given
+     * element, or UINT_MAX if the face is on the boundary (or, for a
+     * distributed mesh, the neighbour is not held by this process).
+     * See GetNodeContainingElements().
+     *
+     * @param elementIndex global index of an element
+     * @param localFaceIndex index of the face, which is the one opposite the
+     *     element's vertex of the same local index
+     */
+    unsigned GetElementNeighbour(unsigned elementIndex, unsigned localFaceIndex) const;
+
+    /**
+     * Discard the topology cache, so that it is rebuilt the next time it is
+     * needed.  Must be called if elements are changed directly rather than
+     * through the mesh.
+     */
+    void InvalidateTopologyCache();
+
+    /**
+     * Overridden InvalidateSpatialSearch() method, which also discards the
+     * bounding volume hierarchy over the elements.
+     */
+    virtual void InvalidateSpatialSearch();
+
+    /**
+     * Overridden RefreshMesh method, which discards the element geometry and topology caches.
+     * Subclasses overriding it should call this version too.
+     */
+    virtual void RefreshMesh();
+
     /**
      * Compute the weighted direction for a given boundary element.
      *
@@ -615,6 +843,20 @@ public:
                                         std::set<unsigned> testElements=std::set<unsigned>(),
                                         bool onlyTryWithTestElements = false);
 
+     /**
+      * As GetContainingElementIndex(), for many points at once. When ELEMENT_DIM
+      * equals SPACE_DIM the search uses a bounding volume hierarchy over the
+      * elements, built once for all the points; otherwise every element is tested.
+      *
+      * @param rTestPoints the points
+      * @param strict  Should the element returned contain the point in the interior and
+      *      not on an edge/face/vertex (default = not strict)
+      * @return the element index for each point, or UINT_MAX for points not in any
+      *      element held by this process
+      */
+     std::vector<unsigned> GetContainingElementIndicesForPoints(const std::vector<ChastePoint<SPACE_DIM> >& rTestPoints,
+                                                                bool strict=false);
+
      /** As with GetNearestElementIndex() except only searches in the given set of elements.
       * @param rTestPoint reference to the point
       * @param testElements a set of elements (element indices) to look in
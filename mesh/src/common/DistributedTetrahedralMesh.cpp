@@ -36,6 +36,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "DistributedTetrahedralMesh.hpp"
 
 #include <cassert>
+#include <cfloat>
 #include <sstream>
 #include <string>
 #include <iterator>
@@ -78,9 +79,11 @@ DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::DistributedTetrahedralMesh(D
       mTotalNumBoundaryElements(0u),
       mTotalNumNodes(0u),
       mpSpaceRegion(nullptr),
-      mPartitioning(partitioningMethod)
+      mPartitioning(partitioningMethod),
+      mReorderLocalNodes(false)
 {
-    if (ELEMENT_DIM == 1 && (partitioningMethod != DistributedTetrahedralMeshPartitionType::GEOMETRIC))
+    if (ELEMENT_DIM == 1 && (partitioningMethod != DistributedTetrahedralMeshPartitionType::GEOMETRIC)
+        && (partitioningMethod != DistributedTetrahedralMeshPartitionType::HILBERT_CURVE))
     {
         //No METIS partition is possible - revert to DUMB
         mPartitioning = DistributedTetrahedralMeshPartitionType::DUMB;
@@ -103,6 +106,65 @@ void DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::SetDistributedVectorFac
     mPartitioning = DistributedTetrahedralMeshPartitionType::DUMB;
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+std::vector<double> DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::msNodeWeightsOnLoad;
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::CheckNodeWeights(const std::vector<double>& rNodeWeights)
+{
+    for (unsigned i=0; i<rNodeWeights.size(); i++)
+    {
+        if (rNodeWeights[i] < 0.0)
+        {
+            EXCEPTION("Node weights for mesh partitioning must be non-negative.");
+        }
+    }
+    if (!rNodeWeights.empty() && *std::max_element(rNodeWeights.begin(), rNodeWeights.end()) == 0.0)
+    {
+        EXCEPTION("At least one node weight for mesh partitioning must be positive.");
+    }
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::SetNodeWeights(const std::vector<double>& rNodeWeights)
+{
+    CheckNodeWeights(rNodeWeights);
+    mNodeWeights = rNodeWeights;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+const std::vector<double>& DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::rGetNodeWeights() const
+{
+    return mNodeWeights;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::SetNodeWeightsOnLoad(const std::vector<double>& rNodeWeights)
+{
+    // Check now, since throwing part-way through loading an archive is messy
+    CheckNodeWeights(rNodeWeights);
+    msNodeWeightsOnLoad = rNodeWeights;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::PrepareToRepartitionOnLoad()
+{
+    mNodeWeights = msNodeWeightsOnLoad;
+    return !mNodeWeights.empty();
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::SetReorderLocalNodes(bool reorderLocalNodes)
+{
+    mReorderLocalNodes = reorderLocalNodes;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::GetReorderLocalNodes() const
+{
+    return mReorderLocalNodes;
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::ComputeMeshPartitioning(
     AbstractMeshReader<ELEMENT_DIM, SPACE_DIM>& rMeshReader,
@@ -140,7 +202,7 @@ void DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::ComputeMeshPartitioning
          */
         if (mPartitioning==DistributedTetrahedralMeshPartitionType::PETSC_MAT_PARTITION && PetscTools::IsParallel())
         {
-            NodePartitioner<ELEMENT_DIM, SPACE_DIM>::PetscMatrixPartitioning(rMeshReader, this->mNodePermutation, rNodesOwned, rProcessorsOffset);
+            NodePartitioner<ELEMENT_DIM, SPACE_DIM>::PetscMatrixPartitioning(rMeshReader, this->mNodePermutation, rNodesOwned, rProcessorsOffset, mNodeWeights);
         }
         else if (mPartitioning==DistributedTetrahedralMeshPartitionType::GEOMETRIC && PetscTools::IsParallel())
         {
@@ -150,6 +212,25 @@ void DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::ComputeMeshPartitioning
             }
             NodePartitioner<ELEMENT_DIM, SPACE_DIM>::GeometricPartitioning(rMeshReader, this->mNodePermutation, rNodesOwned, rProcessorsOffset, mpSpaceRegion);
         }
+        else if (mPartitioning==DistributedTetrahedralMeshPartitionType::HILBERT_CURVE && PetscTools::IsParallel())
+        {
+            NodePartitioner<ELEMENT_DIM, SPACE_DIM>::HilbertCurvePartitioning(rMeshReader, this->mNodePermutation, rNodesOwned, rProcessorsOffset, mNodeWeights);
+        }
+        else if (!mNodeWeights.empty() && !this->mpDistributedVectorFactory && PetscTools::IsParallel())
+        {
+            std::vector<double> node_weights(mNodeWeights);
+            if (rMeshReader.HasNodePermutation())
+            {
+                // The reader renumbers the nodes, e.g. when loading a permuted mesh from an archive
+                const std::vector<unsigned>& r_permutation = rMeshReader.rGetNodePermutation();
+                for (unsigned i=0; i<mNodeWeights.size(); i++)
+                {
+                    node_weights[r_permutation[i]] = mNodeWeights[i];
+                }
+            }
+            unsigned num_owned = NodePartitioner<ELEMENT_DIM, SPACE_DIM>::WeightedDumbPartitioning(node_weights, rNodesOwned);
+            this->mpDistributedVectorFactory = new DistributedVectorFactory(mTotalNumNodes, num_owned);
+        }
         else
         {
             NodePartitioner<ELEMENT_DIM, SPACE_DIM>::DumbPartitioning(*this, rNodesOwned);
@@ -238,10 +319,16 @@ void DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::ConstructFromMeshReader
     std::vector<unsigned> proc_offsets;//(PetscTools::GetNumProcs());
 
     this->mMeshFileBaseName = rMeshReader.GetMeshFileBaseName();
+    this->mNumElementsPerParentElement = rMeshReader.GetNumElementsPerParentElement();
     mTotalNumElements = rMeshReader.GetNumElements();
     mTotalNumBoundaryElements = rMeshReader.GetNumFaces();
     mTotalNumNodes = rMeshReader.GetNumNodes();
 
+    if (!mNodeWeights.empty() && mNodeWeights.size() != mTotalNumNodes)
+    {
+        EXCEPTION("The number of node weights does not match the number of nodes in the mesh.");
+    }
+
 
     PetscTools::Barrier();
     Timer::Reset();
@@ -363,7 +450,7 @@ void DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::ConstructFromMeshReader
             for (unsigned node_index=0; node_index<node_indices.size(); node_index++)
             {
                 // if I own this node
-                if (mNodesMapping.find(node_indices[node_index]) != mNodesMapping.end())
+                if (mNodesMapping.Contains(node_indices[node_index]))
                 {
                     own = true;
                     break;
@@ -430,6 +517,11 @@ void DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::ConstructFromMeshReader
         // If we are partitioning (and permuting) a mesh, we need to be certain that we aren't doing it twice
         assert(rMeshReader.HasNodePermutation() == false);
 
+        if (mReorderLocalNodes)
+        {
+            ReorderLocalNodesAlongHilbertCurve(proc_offsets);
+        }
+
         // We reorder so that each process owns a contiguous set of the indices and we can then build a distributed vector factory.
         ReorderNodes();
 
@@ -474,6 +566,16 @@ unsigned DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::GetNumHaloNodes() c
     return this->mHaloNodes.size();
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+double DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::GetMemoryUsage() const
+{
+    double bytes = AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::GetMemoryUsage();
+    bytes += this->GetVectorBytes(mHaloNodes) + mHaloNodes.size()*sizeof(Node<SPACE_DIM>);
+    bytes += (mNodesMapping.GetSize() + mHaloNodesMapping.GetSize() + mElementsMapping.GetSize()
+              + mBoundaryElementsMapping.GetSize())*sizeof(std::pair<unsigned, unsigned>);
+    return bytes + this->GetVectorBytes(mNodeWeights);
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 unsigned DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::GetNumLocalElements() const
 {
@@ -579,37 +681,36 @@ bool DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::CalculateDesignatedOwne
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::RegisterNode(unsigned index)
 {
-    mNodesMapping[index] = this->mNodes.size();
+    mNodesMapping.Insert(index, this->mNodes.size());
 }
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::RegisterHaloNode(unsigned index)
 {
-    mHaloNodesMapping[index] = mHaloNodes.size();
+    mHaloNodesMapping.Insert(index, mHaloNodes.size());
 }
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::RegisterElement(unsigned index)
 {
-    mElementsMapping[index] = this->mElements.size();
+    mElementsMapping.Insert(index, this->mElements.size());
 }
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::RegisterBoundaryElement(unsigned index)
 {
-    mBoundaryElementsMapping[index] = this->mBoundaryElements.size();
+    mBoundaryElementsMapping.Insert(index, this->mBoundaryElements.size());
 }
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 unsigned DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::SolveNodeMapping(unsigned index) const
 {
-    std::map<unsigned, unsigned>::const_iterator node_position = mNodesMapping.find(index);
-
-    if (node_position == mNodesMapping.end())
+    unsigned local_index;
+    if (!mNodesMapping.Find(index, local_index))
     {
         EXCEPTION("Requested node " << index << " does not belong to processor " << PetscTools::GetMyRank());
     }
-    return node_position->second;
+    return local_index;
 }
 
 //template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
@@ -622,43 +723,41 @@ unsigned DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::SolveNodeMapping(un
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 unsigned DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::SolveElementMapping(unsigned index) const
 {
-    std::map<unsigned, unsigned>::const_iterator element_position = mElementsMapping.find(index);
-
-    if (element_position == mElementsMapping.end())
+    unsigned local_index;
+    if (!mElementsMapping.Find(index, local_index))
     {
         EXCEPTION("Requested element " << index << " does not belong to processor " << PetscTools::GetMyRank());
     }
 
-    return element_position->second;
+    return local_index;
 }
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 unsigned DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::SolveBoundaryElementMapping(unsigned index) const
 {
-    std::map<unsigned, unsigned>::const_iterator boundary_element_position = mBoundaryElementsMapping.find(index);
-
-    if (boundary_element_position == mBoundaryElementsMapping.end())
+    unsigned local_index;
+    if (!mBoundaryElementsMapping.Find(index, local_index))
     {
         EXCEPTION("Requested boundary element " << index << " does not belong to processor " << PetscTools::GetMyRank());
     }
 
-    return boundary_element_position->second;
+    return local_index;
 }
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 Node<SPACE_DIM> * DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::GetNodeOrHaloNode(unsigned index) const
 {
-    std::map<unsigned, unsigned>::const_iterator node_position;
+    unsigned local_index;
     // First search the halo (expected to be a smaller map so quicker)
-    if ((node_position=mHaloNodesMapping.find(index)) != mHaloNodesMapping.end())
+    if (mHaloNodesMapping.Find(index, local_index))
     {
-        return mHaloNodes[node_position->second];
+        return mHaloNodes[local_index];
     }
     // Next search the owned node
-    if ((node_position=mNodesMapping.find(index)) != mNodesMapping.end())
+    if (mNodesMapping.Find(index, local_index))
     {
         //Found an owned node
-        return this->mNodes[node_position->second];
+        return this->mNodes[local_index];
     }
     // Not here
     EXCEPTION("Requested node/halo " << index << " does not belong to processor " << PetscTools::GetMyRank());
@@ -669,27 +768,106 @@ void DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::ReorderNodes()
 {
     assert(PetscTools::IsParallel());
 
-    // Need to rebuild global-local maps
-    mNodesMapping.clear();
-    mHaloNodesMapping.clear();
-
-    // Update indices
+    // Update indices, and rebuild the global-local maps
+    std::vector<unsigned> new_indices(this->mNodes.size());
     for (unsigned index=0; index<this->mNodes.size(); index++)
     {
         unsigned old_index = this->mNodes[index]->GetIndex();
-        unsigned new_index = this->mNodePermutation[old_index];
+        new_indices[index] = this->mNodePermutation[old_index];
 
-        this->mNodes[index]->SetIndex(new_index);
-        mNodesMapping[new_index] = index;
+        this->mNodes[index]->SetIndex(new_indices[index]);
     }
+    mNodesMapping.Rebuild(new_indices);
 
+    new_indices.resize(mHaloNodes.size());
     for (unsigned index=0; index<mHaloNodes.size(); index++)
     {
         unsigned old_index = mHaloNodes[index]->GetIndex();
-        unsigned new_index = this->mNodePermutation[old_index];
+        new_indices[index] = this->mNodePermutation[old_index];
 
-        mHaloNodes[index]->SetIndex(new_index);
-        mHaloNodesMapping[new_index] = index;
+        mHaloNodes[index]->SetIndex(new_indices[index]);
+    }
+    mHaloNodesMapping.Rebuild(new_indices);
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::ReorderLocalNodesAlongHilbertCurve(const std::vector<unsigned>& rProcessorsOffset)
+{
+    assert(PetscTools::IsParallel());
+    unsigned num_procs = PetscTools::GetNumProcs();
+    unsigned rank = PetscTools::GetMyRank();
+    assert(rProcessorsOffset.size() == num_procs);
+
+    // Bounding box of the nodes owned by this process
+    c_vector<double, SPACE_DIM> lower;
+    c_vector<double, SPACE_DIM> upper;
+    for (unsigned d=0; d<SPACE_DIM; d++)
+    {
+        lower[d] = DBL_MAX;
+        upper[d] = -DBL_MAX;
+    }
+    for (unsigned i=0; i<this->mNodes.size(); i++)
+    {
+        const c_vector<double, SPACE_DIM>& r_location = this->mNodes[i]->rGetLocation();
+        for (unsigned d=0; d<SPACE_DIM; d++)
+        {
+            lower[d] = std::min(lower[d], r_location[d]);
+            upper[d] = std::max(upper[d], r_location[d]);
+        }
+    }
+
+    // Sort the local nodes along the curve
+    const unsigned num_bits = std::min(32u, 64u/SPACE_DIM);
+    const double grid_max = (double)((uint64_t(1) << num_bits) - 1);
+    std::vector<std::pair<uint64_t, unsigned> > curve_order(this->mNodes.size());
+    std::vector<uint64_t> grid_coordinates(SPACE_DIM);
+    for (unsigned i=0; i<this->mNodes.size(); i++)
+    {
+        const c_vector<double, SPACE_DIM>& r_location = this->mNodes[i]->rGetLocation();
+        for (unsigned d=0; d<SPACE_DIM; d++)
+        {
+            double width = upper[d] - lower[d];
+            double scaled = (width > 0.0) ? (r_location[d] - lower[d])/width : 0.0;
+            grid_coordinates[d] = (uint64_t)(scaled*grid_max);
+        }
+        curve_order[i] = std::make_pair(NodePartitioner<ELEMENT_DIM, SPACE_DIM>::CalculateHilbertIndex(grid_coordinates, num_bits),
+                                        this->mNodes[i]->GetIndex());
+    }
+    std::sort(curve_order.begin(), curve_order.end());
+
+    // The original index of the node to be given each new index in this process's range
+    std::vector<unsigned> local_order(curve_order.size());
+    for (unsigned i=0; i<curve_order.size(); i++)
+    {
+        local_order[i] = curve_order[i].second;
+    }
+
+    // Put mNodes into the new order, so that local and global indices increase together
+    std::vector<Node<SPACE_DIM>*> reordered_nodes(this->mNodes.size());
+    for (unsigned i=0; i<this->mNodes.size(); i++)
+    {
+        reordered_nodes[i] = this->mNodes[SolveNodeMapping(local_order[i])];
+    }
+    this->mNodes.swap(reordered_nodes);
+
+    // Share the new numbering, since mNodePermutation is also used to renumber halo nodes
+    std::vector<int> counts(num_procs);
+    std::vector<int> displacements(num_procs);
+    for (unsigned proc=0; proc<num_procs; proc++)
+    {
+        unsigned end = (proc+1 < num_procs) ? rProcessorsOffset[proc+1] : mTotalNumNodes;
+        counts[proc] = end - rProcessorsOffset[proc];
+        displacements[proc] = rProcessorsOffset[proc];
+    }
+    assert((int)local_order.size() == counts[rank]);
+
+    std::vector<unsigned> global_order(mTotalNumNodes);
+    MPI_Allgatherv(local_order.empty() ? nullptr : &local_order[0], counts[rank], MPI_UNSIGNED,
+                   &global_order[0], &counts[0], &displacements[0], MPI_UNSIGNED, PetscTools::GetWorld());
+
+    for (unsigned new_index=0; new_index<mTotalNumNodes; new_index++)
+    {
+        this->mNodePermutation[global_order[new_index]] = new_index;
     }
 }
 
@@ -1284,8 +1462,6 @@ void DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::ConstructCuboid(unsigne
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::Scale(const double xFactor, const double yFactor, const double zFactor)
 {
-    //Base class scale (scales node positions)
-    AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::Scale(xFactor, yFactor, zFactor);
     //Scales halos
     for (unsigned i=0; i<mHaloNodes.size(); i++)
     {
@@ -1300,7 +1476,8 @@ void DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::Scale(const double xFac
         }
         r_location[0] *= xFactor;
     }
-
+    //Base class scale (scales node positions and refreshes the mesh, once halos are in place)
+    AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::Scale(xFactor, yFactor, zFactor);
 }
 
 
@@ -1360,6 +1537,20 @@ void DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::ParMetisLibraryNodeAndE
         }
     }
 
+    /*
+     * If node weights have been supplied then each element (a vertex of the dual graph
+     * which ParMETIS partitions) is weighted by the mean weight of its nodes.  ParMETIS
+     * requires positive integer weights, so these are scaled relative to the heaviest node.
+     */
+    const bool use_weights = !mNodeWeights.empty();
+    boost::scoped_array<idxtype> element_weights;
+    double max_node_weight = 0.0;
+    if (use_weights)
+    {
+        element_weights.reset(new idxtype[num_local_elements]);
+        max_node_weight = *std::max_element(mNodeWeights.begin(), mNodeWeights.end());
+    }
+
     unsigned counter = 0;
     for (idxtype element_index = 0; element_index < num_local_elements; element_index++)
     {
@@ -1368,9 +1559,19 @@ void DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::ParMetisLibraryNodeAndE
         element_data = rMeshReader.GetNextElementData();
 
         eptr[element_index] = counter;
+        double element_weight = 0.0;
         for (unsigned i=0; i<ELEMENT_DIM+1; i++)
         {
             eind[counter++] = element_data.NodeIndices[i];
+            if (use_weights)
+            {
+                element_weight += mNodeWeights[element_data.NodeIndices[i]];
+            }
+        }
+        if (use_weights)
+        {
+            element_weight /= (ELEMENT_DIM+1);
+            element_weights[element_index] = NodePartitioner<ELEMENT_DIM, SPACE_DIM>::ConvertToPartitionWeight(element_weight, max_node_weight);
         }
     }
     eptr[num_local_elements] = counter;
@@ -1391,7 +1592,7 @@ void DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::ParMetisLibraryNodeAndE
         ncommonnodes = 2;
     }
 
-    MPI_Comm communicator = PETSC_COMM_WORLD;
+    MPI_Comm communicator = PetscTools::GetWorld();
 
     idxtype* xadj;
     idxtype* adjncy;
@@ -1405,7 +1606,7 @@ void DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::ParMetisLibraryNodeAndE
     eind.reset();
     eptr.reset();
 
-    idxtype weight_flag = 0; // unweighted graph
+    idxtype weight_flag = use_weights ? 2 : 0; // weights on the vertices only, or an unweighted graph
     idxtype n_constraints = 1; // number of weights that each vertex has (number of balance constraints)
     idxtype n_subdomains = PetscTools::GetNumProcs();
     idxtype options[3]; // extra options
@@ -1433,11 +1634,12 @@ void DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::ParMetisLibraryNodeAndE
 //                             options, &edgecut, local_partition, &communicator);
 
     Timer::Reset();
-    ParMETIS_V3_PartKway(element_distribution.get(), xadj, adjncy, nullptr, nullptr, &weight_flag, &numflag,
+    ParMETIS_V3_PartKway(element_distribution.get(), xadj, adjncy, element_weights.get(), nullptr, &weight_flag, &numflag,
                          &n_constraints, &n_subdomains, tpwgts.get(), &ubvec_value,
                          options, &edgecut, local_partition.get(), &communicator);
     //Timer::Print("ParMETIS PartKway");
     tpwgts.reset();
+    element_weights.reset();
 
     boost::scoped_array<idxtype> global_element_partition(new idxtype[num_elements]);
 
@@ -1453,7 +1655,7 @@ void DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::ParMetisLibraryNodeAndE
         int_element_distribution[i] = element_distribution[i];
     }
     MPI_Allgatherv(local_partition.get(), num_local_elements, mpi_idxtype,
-                   global_element_partition.get(), element_counts.get(), int_element_distribution.get(), mpi_idxtype, PETSC_COMM_WORLD);
+                   global_element_partition.get(), element_counts.get(), int_element_distribution.get(), mpi_idxtype, PetscTools::GetWorld());
 
     local_partition.reset();
 
@@ -1635,8 +1837,8 @@ ChasteCuboid<SPACE_DIM> DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::Calc
 
     c_vector<double, SPACE_DIM> global_minimum_point;
     c_vector<double, SPACE_DIM> global_maximum_point;
-    MPI_Allreduce(&my_minimum_point.rGetLocation()[0], &global_minimum_point[0], SPACE_DIM, MPI_DOUBLE, MPI_MIN, PETSC_COMM_WORLD);
-    MPI_Allreduce(&my_maximum_point.rGetLocation()[0], &global_maximum_point[0], SPACE_DIM, MPI_DOUBLE, MPI_MAX, PETSC_COMM_WORLD);
+    MPI_Allreduce(&my_minimum_point.rGetLocation()[0], &global_minimum_point[0], SPACE_DIM, MPI_DOUBLE, MPI_MIN, PetscTools::GetWorld());
+    MPI_Allreduce(&my_maximum_point.rGetLocation()[0], &global_maximum_point[0], SPACE_DIM, MPI_DOUBLE, MPI_MAX, PetscTools::GetWorld());
 
     ChastePoint<SPACE_DIM> min(global_minimum_point);
     ChastePoint<SPACE_DIM> max(global_maximum_point);
@@ -1669,19 +1871,55 @@ unsigned DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::GetNearestNodeIndex
     value.node_index = best_node_index;
     value.distance = best_node_point_distance;
 
-    MPI_Allreduce( &value, &minval, 1, MPI_DOUBLE_INT, MPI_MINLOC, MPI_COMM_WORLD );
+    MPI_Allreduce( &value, &minval, 1, MPI_DOUBLE_INT, MPI_MINLOC, PetscTools::GetWorld() );
 
     return minval.node_index;
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+std::vector<unsigned> DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::GetNearestNodeIndices(const std::vector<ChastePoint<SPACE_DIM> >& rTestPoints)
+{
+    // Call base method to find closest on local processor
+    std::vector<unsigned> best_node_indices = AbstractMesh<ELEMENT_DIM, SPACE_DIM>::GetNearestNodeIndices(rTestPoints);
+
+    // As in GetNearestNodeIndex(), but for all the points in one reduction
+    struct DistanceAndIndex
+    {
+        double distance;
+        int node_index;
+    };
+    std::vector<DistanceAndIndex> values(rTestPoints.size());
+    std::vector<DistanceAndIndex> minvals(rTestPoints.size());
+    for (unsigned i=0; i<rTestPoints.size(); i++)
+    {
+        values[i].node_index = best_node_indices[i];
+        values[i].distance = DBL_MAX;
+        if (best_node_indices[i] != UINT_MAX)
+        {
+            values[i].distance = norm_2(this->GetNode(best_node_indices[i])->rGetLocation() - rTestPoints[i].rGetLocation());
+        }
+    }
+
+    if (!values.empty())
+    {
+        MPI_Allreduce(&values[0], &minvals[0], values.size(), MPI_DOUBLE_INT, MPI_MINLOC, PetscTools::GetWorld());
+    }
+
+    for (unsigned i=0; i<rTestPoints.size(); i++)
+    {
+        best_node_indices[i] = minvals[i].node_index;
+    }
+    return best_node_indices;
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 c_vector<double, 2> DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::CalculateMinMaxEdgeLengths()
 {
     c_vector<double, 2> local_min_max =  AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::CalculateMinMaxEdgeLengths();
     c_vector<double, 2> global_min_max;
 
-    MPI_Allreduce(&local_min_max[0], &global_min_max[0], 1, MPI_DOUBLE, MPI_MIN, PETSC_COMM_WORLD);
-    MPI_Allreduce(&local_min_max[1], &global_min_max[1], 1, MPI_DOUBLE, MPI_MAX, PETSC_COMM_WORLD);
+    MPI_Allreduce(&local_min_max[0], &global_min_max[0], 1, MPI_DOUBLE, MPI_MIN, PetscTools::GetWorld());
+    MPI_Allreduce(&local_min_max[1], &global_min_max[1], 1, MPI_DOUBLE, MPI_MAX, PetscTools::GetWorld());
 
     return global_min_max;
 }
@@ -1707,6 +1945,7 @@ void DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::Rotate(c_matrix<double,
         c_vector<double, SPACE_DIM>& r_location = this->mNodes[i]->rGetModifiableLocation();
         r_location = prod(rotationMatrix, r_location);
     }
+    this->RefreshMesh();
 }
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
@@ -1724,6 +1963,7 @@ void DistributedTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::Translate(const c_vecto
         c_vector<double, SPACE_DIM>& r_location = this->mNodes[i]->rGetModifiableLocation();
         r_location += rDisplacement;
     }
+    this->RefreshMesh();
 }
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
@@ -47,6 +47,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "Node.hpp"
 #include "AbstractMeshReader.hpp"
 #include "DistributedTetrahedralMeshPartitionType.hpp"
+#include "GlobalToLocalIndexMap.hpp"
 
 #define UNASSIGNED_NODE UINT_MAX
 
@@ -78,16 +79,16 @@ private:
     std::vector<Node<SPACE_DIM>* > mHaloNodes;
 
     /** A map from node global index to local index used by this process. */
-    std::map<unsigned, unsigned> mNodesMapping;
+    GlobalToLocalIndexMap mNodesMapping;
 
     /** A map from halo node global index to local index used by this process. */
-    std::map<unsigned, unsigned> mHaloNodesMapping;
+    GlobalToLocalIndexMap mHaloNodesMapping;
 
     /** A map from element global index to local index used by this process. */
-    std::map<unsigned, unsigned> mElementsMapping;
+    GlobalToLocalIndexMap mElementsMapping;
 
     /** A map from boundary element global index to local index used by this process. */
-    std::map<unsigned, unsigned> mBoundaryElementsMapping;
+    GlobalToLocalIndexMap mBoundaryElementsMapping;
 
     /** The region of space owned by this process, if using geometric partition. */
     ChasteCuboid<SPACE_DIM>* mpSpaceRegion;
@@ -95,6 +96,28 @@ private:
     /** Partitioning method. */
     DistributedTetrahedralMeshPartitionType::type mPartitioning;
 
+    /**
+     * Optional relative computational cost of each node, indexed by the node's index in the
+     * mesh file.  If empty then all nodes are assumed to cost the same.
+     */
+    std::vector<double> mNodeWeights;
+
+    /** Node weights to give meshes loaded from an archive (see SetNodeWeightsOnLoad()). */
+    static std::vector<double> msNodeWeightsOnLoad;
+
+    /**
+     * Check that node weights are valid, throwing if not.
+     *
+     * @param rNodeWeights  the weights
+     */
+    static void CheckNodeWeights(const std::vector<double>& rNodeWeights);
+
+    /**
+     * Whether to renumber the nodes owned by each process along a Hilbert curve after partitioning.
+     * Defaults to false.
+     */
+    bool mReorderLocalNodes;
+
     /** Needed for serialization.*/
     friend class boost::serialization::access;
     /**
@@ -125,7 +148,8 @@ public:
     /**
      * Constructor.
      *
-     * @param partitioningMethod  defaults to PARMETIS_LIBRARY, but in 1-D is always overridden in this constructor to be the DUMB partition
+     * @param partitioningMethod  defaults to PARMETIS_LIBRARY, but in 1-D is overridden in this constructor to be the DUMB partition
+     *     (unless it is GEOMETRIC or HILBERT_CURVE, which do not need a graph partitioner)
      */
     DistributedTetrahedralMesh(DistributedTetrahedralMeshPartitionType::type partitioningMethod=DistributedTetrahedralMeshPartitionType::PARMETIS_LIBRARY);
 
@@ -142,6 +166,63 @@ public:
      */
     void SetDistributedVectorFactory(DistributedVectorFactory* pFactory);
 
+    /**
+     * Specify the relative computational cost of each node, so that the PARMETIS_LIBRARY,
+     * PETSC_MAT_PARTITION and HILBERT_CURVE partitioners balance total cost rather than node count.  For example,
+     * nodes with expensive cell models can be weighted more heavily than bath nodes.  The DUMB
+     * partitioner still gives each process a contiguous range of node indices, but chooses the
+     * ranges to balance their total weight, unless a DistributedVectorFactory has been given.
+     *
+     * Must be called before ConstructFromMeshReader.  The weights are not used by the
+     * GEOMETRIC partitioner, and are not archived (but see SetNodeWeightsOnLoad()).
+     *
+     * @param rNodeWeights  non-negative weight of each node, indexed as in the mesh file
+     *     (pass an empty vector to revert to unweighted partitioning)
+     */
+    void SetNodeWeights(const std::vector<double>& rNodeWeights);
+
+    /**
+     * @return the node weights given to SetNodeWeights (empty if none have been set)
+     */
+    const std::vector<double>& rGetNodeWeights() const;
+
+    /**
+     * Specify node weights (see SetNodeWeights()) to be given to meshes of this type when they
+     * are loaded from an archive.  The mesh is then re-partitioned by cost, even when loading
+     * on the same number of processes as it was saved on, rather than given the partition it
+     * was saved with.  This allows a checkpointed simulation to be restarted with a partition
+     * balanced by, for example, the cell solve times measured in the original run (see
+     * AbstractCardiacTissue::GetNodeWeightsFromCellSolveTimes()).
+     *
+     * Since loaded meshes are always partitioned with the DUMB partitioner, each process still
+     * owns a contiguous range of the node indices used when the mesh was saved.
+     *
+     * @param rNodeWeights  non-negative weight of each node, indexed as in the original mesh file
+     *     (pass an empty vector to go back to re-using the saved partition)
+     */
+    static void SetNodeWeightsOnLoad(const std::vector<double>& rNodeWeights);
+
+    /**
+     * Specify whether, after partitioning, the nodes owned by each process should be renumbered
+     * so that consecutive indices follow a Hilbert space-filling curve through the process's
+     * nodes.  This improves the cache locality of loops over the local nodes (such as the ODE
+     * solves in cardiac simulations) and reduces the bandwidth of the local block of assembled
+     * matrices.  The renumbering is recorded in the node permutation, so output written through
+     * Hdf5DataWriter::ApplyPermutation is still in the original mesh file ordering.
+     *
+     * Must be called before ConstructFromMeshReader.  The renumbering is only applied when the
+     * mesh is partitioned (and hence permuted) in parallel, i.e. not for the DUMB partition or
+     * in serial.  This setting is not archived.
+     *
+     * @param reorderLocalNodes  whether to renumber the local nodes
+     */
+    void SetReorderLocalNodes(bool reorderLocalNodes=true);
+
+    /**
+     * @return whether the nodes owned by each process are renumbered after partitioning (see SetReorderLocalNodes)
+     */
+    bool GetReorderLocalNodes() const;
+
     /**
      * Construct the mesh using a MeshReader.
      *
@@ -160,6 +241,12 @@ public:
      */
     unsigned GetNumHaloNodes() const;
 
+    /**
+     * @return an estimate of the bytes held by this process's part of the mesh,
+     * including its halo nodes and index maps (see MemoryAccounting).
+     */
+    virtual double GetMemoryUsage() const;
+
     /**
      * @return the number of Elements which are owned by this process (have at least one entirely
      * locally-owned node).
@@ -311,6 +398,15 @@ public:
       */
     virtual unsigned GetNearestNodeIndex(const ChastePoint<SPACE_DIM>& rTestPoint);
 
+    /**
+     * Overridden GetNearestNodeIndices() method, which combines the nearest nodes
+     * found on each process in one collective operation.
+     *
+     * @param rTestPoints the points (the same on every process)
+     * @return the global index of the nearest node to each point
+     */
+    virtual std::vector<unsigned> GetNearestNodeIndices(const std::vector<ChastePoint<SPACE_DIM> >& rTestPoints);
+
     /**
      * Computes the minimum and maximum lengths of the edges in the mesh.
      * This method overrides the default implementation in the parent class
@@ -364,6 +460,13 @@ protected:
      * @return local index
      */
     unsigned SolveBoundaryElementMapping(unsigned index) const;
+
+    /**
+     * Overridden method to use any weights given to SetNodeWeightsOnLoad().
+     *
+     * @return whether node weights have been given for loaded meshes
+     */
+    bool PrepareToRepartitionOnLoad();
 private:
 
     /**
@@ -437,6 +540,16 @@ private:
      */
     void ReorderNodes();
 
+    /**
+     * Renumber the nodes owned by each process along a Hilbert curve through their locations,
+     * keeping each process's range of indices unchanged.  This updates mNodePermutation on
+     * every process and puts mNodes into the new index order, so must be called collectively
+     * after the mesh has been partitioned and before ReorderNodes().
+     *
+     * @param rProcessorsOffset the index of the lowest indexed node owned by each process
+     */
+    void ReorderLocalNodesAlongHilbertCurve(const std::vector<unsigned>& rProcessorsOffset);
+
     //////////////////////////////////////////////////////////////////////
     //                            Iterators                             //
     //////////////////////////////////////////////////////////////////////
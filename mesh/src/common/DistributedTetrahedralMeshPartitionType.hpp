@@ -42,6 +42,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  * "METIS_LIBRARY" used to be a call to the sequential METIS library.  (Now deprecated in favour of a drop through call to parMETIS.)
  * "PETSC_MAT_PARTITION" is a call to parMETIS (or whatever) via PETSc functionality.  This is not always available on a given installation.
  * "GEOMETRIC" requires user to define which region of space is owned by each process.
+ * "HILBERT_CURVE" splits a Hilbert space-filling curve through the nodes into equal pieces.  It needs no connectivity graph, so is suited to very large meshes.
  */
 struct DistributedTetrahedralMeshPartitionType
 {
@@ -52,7 +53,8 @@ struct DistributedTetrahedralMeshPartitionType
         PARMETIS_LIBRARY=1,  // Deprecated
         METIS_LIBRARY=2,
         PETSC_MAT_PARTITION=3,
-        GEOMETRIC=4
+        GEOMETRIC=4,
+        HILBERT_CURVE=5
     } type;
 };
 
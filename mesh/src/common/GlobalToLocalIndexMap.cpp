@@ -0,0 +1,105 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "GlobalToLocalIndexMap.hpp"
+#include <algorithm>
+#include <cassert>
+
+///////////////////////////////////////////////////////////////////////////////////
+// Implementation
+///////////////////////////////////////////////////////////////////////////////////
+
+void GlobalToLocalIndexMap::Insert(unsigned globalIndex, unsigned localIndex)
+{
+    if (mEntries.empty() || mEntries.back().first < globalIndex)
+    {
+        mEntries.push_back(std::make_pair(globalIndex, localIndex));
+        return;
+    }
+
+    std::vector<std::pair<unsigned, unsigned> >::iterator it =
+        std::lower_bound(mEntries.begin(), mEntries.end(), std::make_pair(globalIndex, 0u));
+    if (it->first == globalIndex)
+    {
+        it->second = localIndex;
+    }
+    else
+    {
+        mEntries.insert(it, std::make_pair(globalIndex, localIndex));
+    }
+}
+
+void GlobalToLocalIndexMap::Rebuild(const std::vector<unsigned>& rGlobalIndices)
+{
+    mEntries.resize(rGlobalIndices.size());
+    for (unsigned i=0; i<rGlobalIndices.size(); i++)
+    {
+        mEntries[i] = std::make_pair(rGlobalIndices[i], i);
+    }
+    std::sort(mEntries.begin(), mEntries.end());
+
+    // Each global index may appear only once
+    assert(std::adjacent_find(mEntries.begin(), mEntries.end(),
+                              [](const std::pair<unsigned, unsigned>& rA, const std::pair<unsigned, unsigned>& rB)
+                              { return rA.first == rB.first; }) == mEntries.end());
+}
+
+bool GlobalToLocalIndexMap::Find(unsigned globalIndex, unsigned& rLocalIndex) const
+{
+    std::vector<std::pair<unsigned, unsigned> >::const_iterator it =
+        std::lower_bound(mEntries.begin(), mEntries.end(), std::make_pair(globalIndex, 0u));
+    if (it == mEntries.end() || it->first != globalIndex)
+    {
+        return false;
+    }
+    rLocalIndex = it->second;
+    return true;
+}
+
+bool GlobalToLocalIndexMap::Contains(unsigned globalIndex) const
+{
+    unsigned local_index;
+    return Find(globalIndex, local_index);
+}
+
+void GlobalToLocalIndexMap::Clear()
+{
+    std::vector<std::pair<unsigned, unsigned> >().swap(mEntries);
+}
+
+unsigned GlobalToLocalIndexMap::GetSize() const
+{
+    return mEntries.size();
+}
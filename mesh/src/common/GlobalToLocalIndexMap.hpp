@@ -0,0 +1,105 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef GLOBALTOLOCALINDEXMAP_HPP_
+#define GLOBALTOLOCALINDEXMAP_HPP_
+
+#include <utility>
+#include <vector>
+
+/**
+ * Map from the global indices of the nodes or elements held by a process to
+ * their local indices, as used by DistributedTetrahedralMesh.
+ *
+ * The map is stored as a vector of (global, local) pairs sorted by global
+ * index and searched by bisection.  This takes 8 bytes per entry, compared
+ * with about 48 for a std::map, and lookups never modify the map so they may
+ * be made from several threads at once.
+ */
+class GlobalToLocalIndexMap
+{
+private:
+
+    /** The (global index, local index) pairs, sorted by global index. */
+    std::vector<std::pair<unsigned, unsigned> > mEntries;
+
+public:
+
+    /**
+     * Associate a global index with a local index, replacing any existing
+     * association.  This is cheapest when global indices are inserted in
+     * increasing order; for other orders use Rebuild().
+     *
+     * @param globalIndex  the global index
+     * @param localIndex  the local index
+     */
+    void Insert(unsigned globalIndex, unsigned localIndex);
+
+    /**
+     * Replace the contents of the map so that each global index is mapped to
+     * its position in the given vector.
+     *
+     * @param rGlobalIndices  the global index of each local index
+     */
+    void Rebuild(const std::vector<unsigned>& rGlobalIndices);
+
+    /**
+     * Look up a global index.
+     *
+     * @param globalIndex  the global index
+     * @param rLocalIndex  filled in with the local index, if there is one
+     * @return whether the global index is in the map
+     */
+    bool Find(unsigned globalIndex, unsigned& rLocalIndex) const;
+
+    /**
+     * @return whether a global index is in the map.
+     *
+     * @param globalIndex  the global index
+     */
+    bool Contains(unsigned globalIndex) const;
+
+    /**
+     * Remove all entries and release their memory.
+     */
+    void Clear();
+
+    /**
+     * @return the number of entries in the map.
+     */
+    unsigned GetSize() const;
+};
+
+#endif /*GLOBALTOLOCALINDEXMAP_HPP_*/
@@ -33,8 +33,12 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 */
 
+#include <algorithm>
+#include <cmath>
+#include <iterator>
 #include <map>
 #include <cstring>
+#include <set>
 
 #include "MutableMesh.hpp"
 #include "OutputFileHandler.hpp"
@@ -50,13 +54,17 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 MutableMesh<ELEMENT_DIM, SPACE_DIM>::MutableMesh()
-    : mAddedNodes(false)
+    : mAddedNodes(false),
+      mUseIncrementalReMesh(false),
+      mLastReMeshWasIncremental(false)
 {
     this->mMeshChangesDuringSimulation = true;
 }
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 MutableMesh<ELEMENT_DIM, SPACE_DIM>::MutableMesh(std::vector<Node<SPACE_DIM> *> nodes)
+    : mUseIncrementalReMesh(false),
+      mLastReMeshWasIncremental(false)
 {
     this->mMeshChangesDuringSimulation = true;
     Clear();
@@ -79,6 +87,8 @@ MutableMesh<ELEMENT_DIM, SPACE_DIM>::~MutableMesh()
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 unsigned MutableMesh<ELEMENT_DIM, SPACE_DIM>::AddNode(Node<SPACE_DIM>* pNewNode)
 {
+    this->InvalidateTopologyCache();
+
     if (mDeletedNodeIndices.empty())
     {
         pNewNode->SetIndex(this->mNodes.size());
@@ -92,6 +102,7 @@ unsigned MutableMesh<ELEMENT_DIM, SPACE_DIM>::AddNode(Node<SPACE_DIM>* pNewNode)
         delete this->mNodes[index];
         this->mNodes[index] = pNewNode;
     }
+    this->AttachNodeToAttributesStore(pNewNode);
     mAddedNodes = true;
     return pNewNode->GetIndex();
 }
@@ -100,6 +111,8 @@ template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 unsigned MutableMesh<ELEMENT_DIM, SPACE_DIM>::AddElement(Element<ELEMENT_DIM,SPACE_DIM>* pNewElement)
 {
     unsigned new_elt_index;
+    this->InvalidateElementGeometryCache();
+    this->InvalidateTopologyCache();
 
     if (mDeletedElementIndices.empty())
     {
@@ -176,6 +189,8 @@ void MutableMesh<ELEMENT_DIM, SPACE_DIM>::SetNode(unsigned index,
         bool concreteMove)
 {
     this->mNodes[index]->SetPoint(point);
+    this->InvalidateElementGeometryCache();
+    this->InvalidateSpatialSearch();
 
     if (concreteMove)
     {
@@ -266,6 +281,8 @@ void MutableMesh<ELEMENT_DIM, SPACE_DIM>::DeleteNode(unsigned index)
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void MutableMesh<ELEMENT_DIM, SPACE_DIM>::DeleteElement(unsigned index)
 {
+    this->InvalidateTopologyCache();
+
     assert(!this->mElements[index]->IsDeleted());
     this->mElements[index]->MarkAsDeleted();
     mDeletedElementIndices.push_back(index);
@@ -297,6 +314,8 @@ void MutableMesh<ELEMENT_DIM, SPACE_DIM>::DeleteElement(unsigned index)
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void MutableMesh<ELEMENT_DIM, SPACE_DIM>::DeleteNodePriorToReMesh(unsigned index)
 {
+    this->InvalidateTopologyCache();
+
     this->mNodes[index]->MarkAsDeleted();
     mDeletedNodeIndices.push_back(index);
 }
@@ -354,6 +373,8 @@ void MutableMesh<ELEMENT_DIM, SPACE_DIM>::MoveMergeNode(unsigned index,
     }
 
     this->mNodes[index]->rGetModifiableLocation() = this->mNodes[targetIndex]->rGetLocation();
+    this->InvalidateElementGeometryCache();
+    this->InvalidateTopologyCache();
 
     for (std::set<unsigned>::const_iterator element_iter=unshared_element_indices.begin();
              element_iter != unshared_element_indices.end();
@@ -466,6 +487,9 @@ unsigned MutableMesh<ELEMENT_DIM, SPACE_DIM>::RefineElement(
         EXCEPTION("RefineElement could not be started (point is not in element)");
     }
 
+    this->InvalidateElementGeometryCache();
+    this->InvalidateTopologyCache();
+
     // Add a new node from the point that is passed to RefineElement
     unsigned new_node_index = AddNode(new Node<SPACE_DIM>(0, point.rGetLocation()));
     // Note: the first argument is the index of the node, which is going to be
@@ -518,6 +542,7 @@ void MutableMesh<ELEMENT_DIM, SPACE_DIM>::DeleteBoundaryNodeAt(unsigned index)
     {
         EXCEPTION(" You may only delete a boundary node ");
     }
+    this->InvalidateTopologyCache();
 
     this->mNodes[index]->MarkAsDeleted();
     mDeletedNodeIndices.push_back(index);
@@ -563,6 +588,8 @@ void MutableMesh<ELEMENT_DIM, SPACE_DIM>::DeleteBoundaryNodeAt(unsigned index)
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void MutableMesh<ELEMENT_DIM, SPACE_DIM>::ReIndex(NodeMap& map)
 {
+    this->InvalidateTopologyCache();
+
     assert(!mAddedNodes);
     map.Resize(this->GetNumAllNodes());
 
@@ -687,6 +714,7 @@ void MutableMesh<ELEMENT_DIM, SPACE_DIM>::ReMesh(NodeMap& map)
 
     // Make sure the map is big enough
     map.Resize(this->GetNumAllNodes());
+    mLastReMeshWasIncremental = false;
     if (mAddedNodes || !mDeletedNodeIndices.empty())
     {
         // Size of mesh is about to change
@@ -725,6 +753,7 @@ void MutableMesh<ELEMENT_DIM, SPACE_DIM>::ReMesh(NodeMap& map)
             bool is_boundary_node = (node_index==0 || node_index==old_node_locations.size()-1);
 
             Node<SPACE_DIM>* p_node = new Node<SPACE_DIM>(node_index, old_node_locations[node_index], is_boundary_node);
+            this->AttachNodeToAttributesStore(p_node);
             this->mNodes.push_back(p_node);
 
             if (is_boundary_node)
@@ -774,6 +803,11 @@ void MutableMesh<ELEMENT_DIM, SPACE_DIM>::ReMesh(NodeMap& map)
 
         this->RefreshJacobianCachedData();
     }
+    else if (SPACE_DIM==2 && mUseIncrementalReMesh && ReMeshIncrementally(map))
+    {
+        // The existing triangulation has been repaired locally
+        mLastReMeshWasIncremental = true;
+    }
     else if (SPACE_DIM==2)  // In 2D, remesh using triangle via library calls
     {
         struct triangulateio mesher_input, mesher_output;
@@ -812,6 +846,338 @@ void MutableMesh<ELEMENT_DIM, SPACE_DIM>::ReMesh()
     ReMesh(map);
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void MutableMesh<ELEMENT_DIM, SPACE_DIM>::SetUseIncrementalReMesh(bool useIncrementalReMesh)
+{
+    mUseIncrementalReMesh = useIncrementalReMesh;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool MutableMesh<ELEMENT_DIM, SPACE_DIM>::GetUseIncrementalReMesh() const
+{
+    return mUseIncrementalReMesh;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool MutableMesh<ELEMENT_DIM, SPACE_DIM>::GetLastReMeshWasIncremental() const
+{
+    return mLastReMeshWasIncremental;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+double MutableMesh<ELEMENT_DIM, SPACE_DIM>::CalculateTwiceSignedArea(Node<SPACE_DIM>* pNodeA, Node<SPACE_DIM>* pNodeB, Node<SPACE_DIM>* pNodeC)
+{
+    assert(SPACE_DIM == 2);    // LCOV_EXCL_LINE
+    const c_vector<double, SPACE_DIM>& r_a = pNodeA->rGetLocation();
+    const c_vector<double, SPACE_DIM>& r_b = pNodeB->rGetLocation();
+    const c_vector<double, SPACE_DIM>& r_c = pNodeC->rGetLocation();
+
+    return (r_b[0] - r_a[0])*(r_c[1] - r_a[1]) - (r_b[1] - r_a[1])*(r_c[0] - r_a[0]);
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool MutableMesh<ELEMENT_DIM, SPACE_DIM>::IsInsideCircumcircle(Node<SPACE_DIM>* pNodeA, Node<SPACE_DIM>* pNodeB, Node<SPACE_DIM>* pNodeC, Node<SPACE_DIM>* pNodeD)
+{
+    assert(SPACE_DIM == 2);    // LCOV_EXCL_LINE
+    const c_vector<double, SPACE_DIM>& r_d = pNodeD->rGetLocation();
+    double adx = pNodeA->rGetLocation()[0] - r_d[0];
+    double ady = pNodeA->rGetLocation()[1] - r_d[1];
+    double bdx = pNodeB->rGetLocation()[0] - r_d[0];
+    double bdy = pNodeB->rGetLocation()[1] - r_d[1];
+    double cdx = pNodeC->rGetLocation()[0] - r_d[0];
+    double cdy = pNodeC->rGetLocation()[1] - r_d[1];
+
+    double a_lift = adx*adx + ady*ady;
+    double b_lift = bdx*bdx + bdy*bdy;
+    double c_lift = cdx*cdx + cdy*cdy;
+
+    double determinant = a_lift*(bdx*cdy - cdx*bdy) + b_lift*(cdx*ady - adx*cdy) + c_lift*(adx*bdy - bdx*ady);
+
+    // Treat (nearly) cocircular nodes as not inside, so that flips cannot cycle
+    double permanent = a_lift*(fabs(bdx*cdy) + fabs(cdx*bdy))
+                     + b_lift*(fabs(cdx*ady) + fabs(adx*cdy))
+                     + c_lift*(fabs(adx*bdy) + fabs(bdx*ady));
+
+    return determinant > 1e-10*permanent;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void MutableMesh<ELEMENT_DIM, SPACE_DIM>::FlipEdgesToRestoreDelaunay(std::vector<std::pair<unsigned, unsigned> >& rEdgesToCheck)
+{
+    this->InvalidateTopologyCache();
+
+    while (!rEdgesToCheck.empty())
+    {
+        Node<SPACE_DIM>* p_node_a = this->mNodes[rEdgesToCheck.back().first];
+        Node<SPACE_DIM>* p_node_b = this->mNodes[rEdgesToCheck.back().second];
+        rEdgesToCheck.pop_back();
+
+        // Find the two elements sharing this edge; boundary edges and edges that have since been flipped are skipped
+        std::set<unsigned> shared_elements;
+        std::set_intersection(p_node_a->rGetContainingElementIndices().begin(), p_node_a->rGetContainingElementIndices().end(),
+                              p_node_b->rGetContainingElementIndices().begin(), p_node_b->rGetContainingElementIndices().end(),
+                              std::inserter(shared_elements, shared_elements.begin()));
+        if (shared_elements.size() != 2)
+        {
+            continue;
+        }
+        Element<ELEMENT_DIM, SPACE_DIM>* p_element_1 = this->mElements[*shared_elements.begin()];
+        Element<ELEMENT_DIM, SPACE_DIM>* p_element_2 = this->mElements[*shared_elements.rbegin()];
+
+        // Order the edge so that element 1 is the anticlockwise triangle (a, b, c)
+        unsigned local_c = 0;
+        while (p_element_1->GetNode(local_c) == p_node_a || p_element_1->GetNode(local_c) == p_node_b)
+        {
+            local_c++;
+        }
+        Node<SPACE_DIM>* p_node_c = p_element_1->GetNode(local_c);
+        p_node_a = p_element_1->GetNode((local_c + 1)%3);
+        p_node_b = p_element_1->GetNode((local_c + 2)%3);
+
+        // Element 2 is then the anticlockwise triangle (b, a, d)
+        unsigned local_d = 0;
+        while (p_element_2->GetNode(local_d) == p_node_a || p_element_2->GetNode(local_d) == p_node_b)
+        {
+            local_d++;
+        }
+        Node<SPACE_DIM>* p_node_d = p_element_2->GetNode(local_d);
+
+        if (IsInsideCircumcircle(p_node_a, p_node_b, p_node_c, p_node_d)
+            && CalculateTwiceSignedArea(p_node_a, p_node_d, p_node_c) > 0.0
+            && CalculateTwiceSignedArea(p_node_d, p_node_b, p_node_c) > 0.0)
+        {
+            // Flip the edge ab to cd, giving the anticlockwise triangles (c, a, d) and (b, c, d)
+            p_element_1->UpdateNode((local_c + 2)%3, p_node_d);
+            p_element_2->UpdateNode((local_d + 2)%3, p_node_c);
+
+            // The edges of the surrounding quadrilateral may no longer be Delaunay
+            rEdgesToCheck.push_back(std::make_pair(p_node_a->GetIndex(), p_node_d->GetIndex()));
+            rEdgesToCheck.push_back(std::make_pair(p_node_d->GetIndex(), p_node_b->GetIndex()));
+            rEdgesToCheck.push_back(std::make_pair(p_node_b->GetIndex(), p_node_c->GetIndex()));
+            rEdgesToCheck.push_back(std::make_pair(p_node_c->GetIndex(), p_node_a->GetIndex()));
+        }
+    }
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool MutableMesh<ELEMENT_DIM, SPACE_DIM>::ReMeshIncrementally(NodeMap& rMap)
+{
+    assert(SPACE_DIM == 2 && ELEMENT_DIM == 2);    // LCOV_EXCL_LINE
+
+    // Deleted nodes, or a mesh not yet triangulated, require a full rebuild
+    if (!mDeletedNodeIndices.empty() || !mDeletedElementIndices.empty() || !mDeletedBoundaryElementIndices.empty()
+        || this->mElements.empty())
+    {
+        return false;
+    }
+
+    try
+    {
+        // Edge flips cannot repair inverted elements
+        for (unsigned elem_index=0; elem_index<this->mElements.size(); elem_index++)
+        {
+            Element<ELEMENT_DIM, SPACE_DIM>* p_element = this->mElements[elem_index];
+            if (CalculateTwiceSignedArea(p_element->GetNode(0), p_element->GetNode(1), p_element->GetNode(2)) <= 0.0)
+            {
+                return false;
+            }
+        }
+
+        std::vector<std::pair<unsigned, unsigned> > edges_to_check;
+
+        // Insert each added node, which is not yet in any element, by splitting the element containing it
+        for (unsigned node_index=0; node_index<this->mNodes.size(); node_index++)
+        {
+            Node<SPACE_DIM>* p_new_node = this->mNodes[node_index];
+            if (!p_new_node->rGetContainingElementIndices().empty())
+            {
+                continue;
+            }
+
+            Element<ELEMENT_DIM, SPACE_DIM>* p_containing_element = nullptr;
+            for (unsigned elem_index=0; elem_index<this->mElements.size(); elem_index++)
+            {
+                Element<ELEMENT_DIM, SPACE_DIM>* p_element = this->mElements[elem_index];
+                double tolerance = 1e-10*CalculateTwiceSignedArea(p_element->GetNode(0), p_element->GetNode(1), p_element->GetNode(2));
+                if (CalculateTwiceSignedArea(p_element->GetNode(0), p_element->GetNode(1), p_new_node) > tolerance
+                    && CalculateTwiceSignedArea(p_element->GetNode(1), p_element->GetNode(2), p_new_node) > tolerance
+                    && CalculateTwiceSignedArea(p_element->GetNode(2), p_element->GetNode(0), p_new_node) > tolerance)
+                {
+                    p_containing_element = p_element;
+                    break;
+                }
+            }
+            if (p_containing_element == nullptr)
+            {
+                // The node lies on an edge or outside the mesh
+                return false;
+            }
+
+            Node<SPACE_DIM>* p_node_0 = p_containing_element->GetNode(0);
+            Node<SPACE_DIM>* p_node_1 = p_containing_element->GetNode(1);
+            Node<SPACE_DIM>* p_node_2 = p_containing_element->GetNode(2);
+
+            std::vector<Node<SPACE_DIM>*> nodes_1;
+            nodes_1.push_back(p_node_1);
+            nodes_1.push_back(p_node_2);
+            nodes_1.push_back(p_new_node);
+            std::vector<Node<SPACE_DIM>*> nodes_2;
+            nodes_2.push_back(p_node_2);
+            nodes_2.push_back(p_node_0);
+            nodes_2.push_back(p_new_node);
+
+            p_containing_element->UpdateNode(2, p_new_node);
+            AddElement(new Element<ELEMENT_DIM, SPACE_DIM>(this->mElements.size(), nodes_1));
+            AddElement(new Element<ELEMENT_DIM, SPACE_DIM>(this->mElements.size(), nodes_2));
+
+            edges_to_check.push_back(std::make_pair(p_node_0->GetIndex(), p_node_1->GetIndex()));
+            edges_to_check.push_back(std::make_pair(p_node_1->GetIndex(), p_node_2->GetIndex()));
+            edges_to_check.push_back(std::make_pair(p_node_2->GetIndex(), p_node_0->GetIndex()));
+            FlipEdgesToRestoreDelaunay(edges_to_check);
+        }
+        mAddedNodes = false;
+
+        /*
+         * Walk the boundary anticlockwise: the boundary edge from node p to the next boundary
+         * node is the one whose element lies to its left.
+         */
+        std::map<unsigned, unsigned> next_boundary_node;
+        std::map<unsigned, unsigned> previous_boundary_node;
+        std::map<unsigned, unsigned> boundary_element_after_node;
+        for (unsigned b_elem_index=0; b_elem_index<this->mBoundaryElements.size(); b_elem_index++)
+        {
+            BoundaryElement<ELEMENT_DIM-1, SPACE_DIM>* p_boundary_element = this->mBoundaryElements[b_elem_index];
+            Node<SPACE_DIM>* p_node_u = p_boundary_element->GetNode(0);
+            Node<SPACE_DIM>* p_node_w = p_boundary_element->GetNode(1);
+
+            std::set<unsigned> shared_elements;
+            std::set_intersection(p_node_u->rGetContainingElementIndices().begin(), p_node_u->rGetContainingElementIndices().end(),
+                                  p_node_w->rGetContainingElementIndices().begin(), p_node_w->rGetContainingElementIndices().end(),
+                                  std::inserter(shared_elements, shared_elements.begin()));
+            if (shared_elements.size() != 1)
+            {
+                return false;
+            }
+
+            Element<ELEMENT_DIM, SPACE_DIM>* p_element = this->mElements[*shared_elements.begin()];
+            unsigned local_opposite = 0;
+            while (p_element->GetNode(local_opposite) == p_node_u || p_element->GetNode(local_opposite) == p_node_w)
+            {
+                local_opposite++;
+            }
+            unsigned from = p_element->GetNodeGlobalIndex((local_opposite + 1)%3);
+            unsigned to = p_element->GetNodeGlobalIndex((local_opposite + 2)%3);
+            if (next_boundary_node.count(from) != 0 || previous_boundary_node.count(to) != 0)
+            {
+                return false;
+            }
+            next_boundary_node[from] = to;
+            previous_boundary_node[to] = from;
+            boundary_element_after_node[from] = b_elem_index;
+        }
+
+        // Cover any boundary node that has moved inside the hull with an element, so that the boundary stays convex
+        std::vector<unsigned> nodes_to_check;
+        for (std::map<unsigned, unsigned>::iterator it = next_boundary_node.begin(); it != next_boundary_node.end(); ++it)
+        {
+            nodes_to_check.push_back(it->first);
+        }
+        while (!nodes_to_check.empty())
+        {
+            unsigned p = nodes_to_check.back();
+            nodes_to_check.pop_back();
+            if (next_boundary_node.count(p) == 0)
+            {
+                continue;
+            }
+            unsigned q = next_boundary_node[p];
+            if (next_boundary_node.count(q) == 0)
+            {
+                return false;
+            }
+            unsigned s = next_boundary_node[q];
+            if (s == p)
+            {
+                return false;
+            }
+
+            // A clockwise turn at q means that q is no longer on the convex hull
+            Node<SPACE_DIM>* p_node_p = this->mNodes[p];
+            Node<SPACE_DIM>* p_node_q = this->mNodes[q];
+            Node<SPACE_DIM>* p_node_s = this->mNodes[s];
+            double scale = norm_2(p_node_q->rGetLocation() - p_node_p->rGetLocation())*norm_2(p_node_s->rGetLocation() - p_node_q->rGetLocation());
+            if (CalculateTwiceSignedArea(p_node_p, p_node_q, p_node_s) >= -1e-10*scale)
+            {
+                continue;
+            }
+
+            std::vector<Node<SPACE_DIM>*> nodes;
+            nodes.push_back(p_node_p);
+            nodes.push_back(p_node_s);
+            nodes.push_back(p_node_q);
+            AddElement(new Element<ELEMENT_DIM, SPACE_DIM>(this->mElements.size(), nodes));
+
+            // The boundary edge pq becomes ps, the boundary edge qs is removed and q becomes an interior node
+            BoundaryElement<ELEMENT_DIM-1, SPACE_DIM>* p_boundary_element_pq = this->mBoundaryElements[boundary_element_after_node[p]];
+            p_boundary_element_pq->UpdateNode(p_boundary_element_pq->GetNode(0) == p_node_q ? 0 : 1, p_node_s);
+            unsigned b_elem_qs = boundary_element_after_node[q];
+            this->mBoundaryElements[b_elem_qs]->MarkAsDeleted();
+            mDeletedBoundaryElementIndices.push_back(b_elem_qs);
+
+            p_node_q->SetAsBoundaryNode(false);
+            this->mBoundaryNodes.erase(std::find(this->mBoundaryNodes.begin(), this->mBoundaryNodes.end(), p_node_q));
+
+            next_boundary_node[p] = s;
+            previous_boundary_node[s] = p;
+            next_boundary_node.erase(q);
+            previous_boundary_node.erase(q);
+            boundary_element_after_node.erase(q);
+
+            edges_to_check.push_back(std::make_pair(p, q));
+            edges_to_check.push_back(std::make_pair(q, s));
+            FlipEdgesToRestoreDelaunay(edges_to_check);
+
+            // The turns at p and at s may now be clockwise
+            nodes_to_check.push_back(p);
+            nodes_to_check.push_back(previous_boundary_node[p]);
+        }
+
+        // Finally, flip every edge that is no longer Delaunay because nodes have moved
+        for (unsigned elem_index=0; elem_index<this->mElements.size(); elem_index++)
+        {
+            Element<ELEMENT_DIM, SPACE_DIM>* p_element = this->mElements[elem_index];
+            for (unsigned local_index=0; local_index<3; local_index++)
+            {
+                unsigned node_a = p_element->GetNodeGlobalIndex(local_index);
+                unsigned node_b = p_element->GetNodeGlobalIndex((local_index + 1)%3);
+                if (node_a < node_b)
+                {
+                    edges_to_check.push_back(std::make_pair(node_a, node_b));
+                }
+            }
+        }
+        FlipEdgesToRestoreDelaunay(edges_to_check);
+
+        if (mDeletedBoundaryElementIndices.empty())
+        {
+            rMap.ResetToIdentity();
+        }
+        else
+        {
+            // Remove the deleted boundary elements; as no nodes have been deleted, the map is the identity
+            ReIndex(rMap);
+        }
+        this->RefreshJacobianCachedData();
+    }
+    catch (Exception&)
+    {
+        // A degenerate element has been met, so leave the mesh to be rebuilt in full
+        return false;
+    }
+
+    return true;
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 std::vector<c_vector<unsigned, 5> > MutableMesh<ELEMENT_DIM, SPACE_DIM>::SplitLongEdges(double cutoffLength)
 {
@@ -911,6 +1277,8 @@ std::vector<c_vector<unsigned, 5> > MutableMesh<ELEMENT_DIM, SPACE_DIM>::SplitLo
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 c_vector<unsigned, 3> MutableMesh<ELEMENT_DIM, SPACE_DIM>::SplitEdge(Node<SPACE_DIM>* pNodeA, Node<SPACE_DIM>* pNodeB)
 {
+    this->InvalidateTopologyCache();
+
     c_vector<unsigned, 3> new_node_index_vector;
 
     std::set<unsigned> elements_of_node_a = pNodeA->rGetContainingElementIndices();
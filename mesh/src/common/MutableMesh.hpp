@@ -150,8 +150,65 @@ protected:
     /** Whether any nodes have been added to the mesh. */
     bool mAddedNodes;
 
+    /**
+     * Whether ReMesh() should first try to repair the existing triangulation locally,
+     * rather than rebuilding it (only used in 2D). Defaults to false.
+     */
+    bool mUseIncrementalReMesh;
+
+    /** Whether the most recent call to ReMesh() repaired the triangulation locally. */
+    bool mLastReMeshWasIncremental;
+
 private:
 
+    /**
+     * Helper method for ReMeshIncrementally().
+     *
+     * @param pNodeA the first vertex
+     * @param pNodeB the second vertex
+     * @param pNodeC the third vertex
+     * @return twice the signed area of the triangle ABC, which is positive if the vertices are anticlockwise.
+     */
+    double CalculateTwiceSignedArea(Node<SPACE_DIM>* pNodeA, Node<SPACE_DIM>* pNodeB, Node<SPACE_DIM>* pNodeC);
+
+    /**
+     * Helper method for ReMeshIncrementally().
+     *
+     * @param pNodeA the first vertex of an anticlockwise triangle
+     * @param pNodeB the second vertex of the triangle
+     * @param pNodeC the third vertex of the triangle
+     * @param pNodeD the node to test
+     * @return whether D lies strictly inside the circumcircle of the triangle ABC (beyond round-off).
+     */
+    bool IsInsideCircumcircle(Node<SPACE_DIM>* pNodeA, Node<SPACE_DIM>* pNodeB, Node<SPACE_DIM>* pNodeC, Node<SPACE_DIM>* pNodeD);
+
+    /**
+     * Helper method for ReMeshIncrementally().
+     *
+     * Restore the Delaunay property by Lawson edge flips, starting from a given list of edges
+     * and checking the edges opposite each flip in turn. Boundary edges are never flipped.
+     *
+     * @param rEdgesToCheck pairs of global node indices of the edges to check; emptied by this method
+     */
+    void FlipEdgesToRestoreDelaunay(std::vector<std::pair<unsigned, unsigned> >& rEdgesToCheck);
+
+    /**
+     * Helper method for ReMesh(), used in 2D if mUseIncrementalReMesh is true.
+     *
+     * Repair the existing triangulation after nodes have moved or been added, rather than rebuilding
+     * it. Each added node is inserted by splitting the element containing it; boundary vertices that
+     * have moved inside the convex hull are covered by a new element; and edge flips then restore the
+     * Delaunay property. Node indices are unchanged.
+     *
+     * The repair is not attempted if nodes have been deleted, and is abandoned if any element has been
+     * inverted, an added node does not lie strictly inside an element, or the boundary cannot be made
+     * convex locally. In these cases the mesh is left for ReMesh() to rebuild in full.
+     *
+     * @param rMap the NodeMap passed to ReMesh(); set to the identity if the repair succeeds
+     * @return whether the repair succeeded.
+     */
+    bool ReMeshIncrementally(NodeMap& rMap);
+
     /**
      * @return true if the mesh is Voronoi local to the given element.
      * Check whether any neighbouring node is inside the circumsphere of this element.
@@ -322,6 +379,29 @@ public:
      */
     void ReMesh();
 
+    /**
+     * Set whether ReMesh() should first try to repair the existing triangulation locally, using
+     * point insertion and edge flips, and only rebuild it in full where this fails. This is only
+     * used in 2D; it keeps node indices unchanged, but for nodes that are exactly cocircular it may
+     * choose a different (equally Delaunay) triangulation from a full rebuild. Meshes that add
+     * nodes outside the existing mesh before remeshing, such as Cylindrical2dMesh, always fall
+     * back to a full rebuild.
+     *
+     * @param useIncrementalReMesh whether to try to repair the triangulation (defaults to true)
+     */
+    void SetUseIncrementalReMesh(bool useIncrementalReMesh=true);
+
+    /**
+     * @return mUseIncrementalReMesh
+     */
+    bool GetUseIncrementalReMesh() const;
+
+    /**
+     * @return whether the most recent call to ReMesh() repaired the triangulation locally,
+     * rather than rebuilding it in full.
+     */
+    bool GetLastReMeshWasIncremental() const;
+
 
     /**
      * Find edges in the mesh longer than the given cutoff length and split them creating new elements as required.
@@ -33,7 +33,9 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 */
 
+#include <algorithm>
 #include <cassert>
+#include <climits>
 
 #include "Node.hpp"
 #include "Exception.hpp"
@@ -50,6 +52,8 @@ void Node<SPACE_DIM>::CommonConstructor(unsigned index, bool isBoundaryNode)
     mIsInternal = false;
     mIsDeleted = false;
     mpNodeAttributes = nullptr;
+    mpAttributesStore = nullptr;
+    mAttributesSlot = UINT_MAX;
 }
 
 template <unsigned SPACE_DIM>
@@ -105,6 +109,55 @@ template <unsigned SPACE_DIM>
 Node<SPACE_DIM>::~Node()
 {
     delete mpNodeAttributes;
+    if (mpAttributesStore)
+    {
+        mpAttributesStore->FreeSlot(mAttributesSlot);
+    }
+}
+
+template <unsigned SPACE_DIM>
+void Node<SPACE_DIM>::UseAttributesStore(NodeAttributesStore<SPACE_DIM>* pStore)
+{
+    assert(pStore != nullptr);
+    if (mpAttributesStore == pStore)
+    {
+        return;
+    }
+
+    unsigned slot = pStore->AllocateSlot();
+    if (mpAttributesStore)
+    {
+        // Moving between stores
+        pStore->rGetAttributes(slot) = mpAttributesStore->rGetAttributes(mAttributesSlot);
+        pStore->SetRegion(slot, mpAttributesStore->GetRegion(mAttributesSlot));
+        pStore->rGetAppliedForce(slot) = mpAttributesStore->rGetAppliedForce(mAttributesSlot);
+        pStore->SetRadius(slot, mpAttributesStore->GetRadius(mAttributesSlot));
+        pStore->rGetNeighbours(slot) = mpAttributesStore->rGetNeighbours(mAttributesSlot);
+        pStore->SetNeighboursSetUp(slot, mpAttributesStore->GetNeighboursSetUp(mAttributesSlot));
+        pStore->SetIsParticle(slot, mpAttributesStore->IsParticle(mAttributesSlot));
+        mpAttributesStore->FreeSlot(mAttributesSlot);
+    }
+    else if (mpNodeAttributes)
+    {
+        pStore->rGetAttributes(slot).swap(mpNodeAttributes->rGetAttributes());
+        pStore->SetRegion(slot, mpNodeAttributes->GetRegion());
+        pStore->rGetAppliedForce(slot) = mpNodeAttributes->rGetAppliedForce();
+        pStore->SetRadius(slot, mpNodeAttributes->GetRadius());
+        pStore->rGetNeighbours(slot).swap(mpNodeAttributes->rGetNeighbours());
+        pStore->SetNeighboursSetUp(slot, mpNodeAttributes->GetNeighboursSetUp());
+        pStore->SetIsParticle(slot, mpNodeAttributes->IsParticle());
+        delete mpNodeAttributes;
+        mpNodeAttributes = nullptr;
+    }
+
+    mpAttributesStore = pStore;
+    mAttributesSlot = slot;
+}
+
+template <unsigned SPACE_DIM>
+bool Node<SPACE_DIM>::UsesAttributesStore() const
+{
+    return (mpAttributesStore != nullptr);
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -171,6 +224,11 @@ void Node<SPACE_DIM>::AddNodeAttribute(double attribute)
 {
     ConstructNodeAttributes();
 
+    if (mpAttributesStore)
+    {
+        mpAttributesStore->rGetAttributes(mAttributesSlot).push_back(attribute);
+        return;
+    }
     mpNodeAttributes->AddAttribute(attribute);
 }
 
@@ -179,6 +237,10 @@ std::vector<double>& Node<SPACE_DIM>::rGetNodeAttributes()
 {
     CheckForNodeAttributes();
 
+    if (mpAttributesStore)
+    {
+        return mpAttributesStore->rGetAttributes(mAttributesSlot);
+    }
     return mpNodeAttributes->rGetAttributes();
 }
 
@@ -186,7 +248,11 @@ template <unsigned SPACE_DIM>
 unsigned Node<SPACE_DIM>::GetNumNodeAttributes()
 {
     unsigned num_attributes;
-    if (!mpNodeAttributes)
+    if (mpAttributesStore)
+    {
+        num_attributes = mpAttributesStore->rGetAttributes(mAttributesSlot).size();
+    }
+    else if (!mpNodeAttributes)
     {
         num_attributes = 0u;
     }
@@ -201,7 +267,7 @@ unsigned Node<SPACE_DIM>::GetNumNodeAttributes()
 template <unsigned SPACE_DIM>
 bool Node<SPACE_DIM>::HasNodeAttributes()
 {
-    return (mpNodeAttributes != nullptr);
+    return (mpNodeAttributes != nullptr || mpAttributesStore != nullptr);
 }
 
 template <unsigned SPACE_DIM>
@@ -209,6 +275,10 @@ c_vector<double, SPACE_DIM>& Node<SPACE_DIM>::rGetAppliedForce()
 {
     CheckForNodeAttributes();
 
+    if (mpAttributesStore)
+    {
+        return mpAttributesStore->rGetAppliedForce(mAttributesSlot);
+    }
     return mpNodeAttributes->rGetAppliedForce();
 }
 
@@ -217,6 +287,11 @@ void Node<SPACE_DIM>::ClearAppliedForce()
 {
     ConstructNodeAttributes();
 
+    if (mpAttributesStore)
+    {
+        mpAttributesStore->rGetAppliedForce(mAttributesSlot) = zero_vector<double>(SPACE_DIM);
+        return;
+    }
     mpNodeAttributes->ClearAppliedForce();
 }
 
@@ -225,6 +300,11 @@ void Node<SPACE_DIM>::AddAppliedForceContribution(const c_vector<double, SPACE_D
 {
     ConstructNodeAttributes();
 
+    if (mpAttributesStore)
+    {
+        mpAttributesStore->rGetAppliedForce(mAttributesSlot) += rForceContribution;
+        return;
+    }
     mpNodeAttributes->AddAppliedForceContribution(rForceContribution);
 }
 
@@ -233,6 +313,10 @@ bool Node<SPACE_DIM>::IsParticle()
 {
     CheckForNodeAttributes();
 
+    if (mpAttributesStore)
+    {
+        return mpAttributesStore->IsParticle(mAttributesSlot);
+    }
     return mpNodeAttributes->IsParticle();
 }
 
@@ -241,6 +325,11 @@ void Node<SPACE_DIM>::SetIsParticle(bool isParticle)
 {
     ConstructNodeAttributes();
 
+    if (mpAttributesStore)
+    {
+        mpAttributesStore->SetIsParticle(mAttributesSlot, isParticle);
+        return;
+    }
     mpNodeAttributes->SetIsParticle(isParticle);
 }
 
@@ -249,6 +338,10 @@ double Node<SPACE_DIM>::GetRadius()
 {
     CheckForNodeAttributes();
 
+    if (mpAttributesStore)
+    {
+        return mpAttributesStore->GetRadius(mAttributesSlot);
+    }
     return mpNodeAttributes->GetRadius();
 }
 
@@ -257,6 +350,11 @@ void Node<SPACE_DIM>::SetRadius(double radius)
 {
     ConstructNodeAttributes();
 
+    if (mpAttributesStore)
+    {
+        mpAttributesStore->SetRadius(mAttributesSlot, radius);
+        return;
+    }
     mpNodeAttributes->SetRadius(radius);
 }
 
@@ -329,7 +427,12 @@ void Node<SPACE_DIM>::AddNeighbour(unsigned index)
 {
     ConstructNodeAttributes();
 
-    return mpNodeAttributes->AddNeighbour(index);
+    if (mpAttributesStore)
+    {
+        mpAttributesStore->rGetNeighbours(mAttributesSlot).push_back(index);
+        return;
+    }
+    mpNodeAttributes->AddNeighbour(index);
 }
 
 template <unsigned SPACE_DIM>
@@ -337,6 +440,11 @@ void Node<SPACE_DIM>::ClearNeighbours()
 {
     ConstructNodeAttributes();
 
+    if (mpAttributesStore)
+    {
+        mpAttributesStore->rGetNeighbours(mAttributesSlot).clear();
+        return;
+    }
     mpNodeAttributes->ClearNeighbours();
 }
 
@@ -345,6 +453,13 @@ void Node<SPACE_DIM>::RemoveDuplicateNeighbours()
 {
     CheckForNodeAttributes();
 
+    if (mpAttributesStore)
+    {
+        std::vector<unsigned>& r_neighbours = mpAttributesStore->rGetNeighbours(mAttributesSlot);
+        std::sort(r_neighbours.begin(), r_neighbours.end());
+        r_neighbours.erase(std::unique(r_neighbours.begin(), r_neighbours.end()), r_neighbours.end());
+        return;
+    }
     mpNodeAttributes->RemoveDuplicateNeighbours();
 }
 
@@ -353,6 +468,10 @@ bool Node<SPACE_DIM>::NeighboursIsEmpty()
 {
     CheckForNodeAttributes();
 
+    if (mpAttributesStore)
+    {
+        return mpAttributesStore->rGetNeighbours(mAttributesSlot).empty();
+    }
     return mpNodeAttributes->NeighboursIsEmpty();
 }
 
@@ -361,6 +480,11 @@ void Node<SPACE_DIM>::SetNeighboursSetUp(bool flag)
 {
     ConstructNodeAttributes();
 
+    if (mpAttributesStore)
+    {
+        mpAttributesStore->SetNeighboursSetUp(mAttributesSlot, flag);
+        return;
+    }
     mpNodeAttributes->SetNeighboursSetUp(flag);
 };
 
@@ -369,6 +493,10 @@ bool Node<SPACE_DIM>::GetNeighboursSetUp()
 {
     CheckForNodeAttributes();
 
+    if (mpAttributesStore)
+    {
+        return mpAttributesStore->GetNeighboursSetUp(mAttributesSlot);
+    }
     return mpNodeAttributes->GetNeighboursSetUp();
 };
 
@@ -377,6 +505,10 @@ std::vector<unsigned>& Node<SPACE_DIM>::rGetNeighbours()
 {
     CheckForNodeAttributes();
 
+    if (mpAttributesStore)
+    {
+        return mpAttributesStore->rGetNeighbours(mAttributesSlot);
+    }
     return mpNodeAttributes->rGetNeighbours();
 };
 
@@ -387,7 +519,7 @@ std::vector<unsigned>& Node<SPACE_DIM>::rGetNeighbours()
 template <unsigned SPACE_DIM>
 void Node<SPACE_DIM>::CheckForNodeAttributes() const
 {
-    if (mpNodeAttributes == nullptr)
+    if (mpNodeAttributes == nullptr && mpAttributesStore == nullptr)
     {
         EXCEPTION("Node has no attributes associated with it. Construct attributes first");
     }
@@ -396,7 +528,7 @@ void Node<SPACE_DIM>::CheckForNodeAttributes() const
 template <unsigned SPACE_DIM>
 void Node<SPACE_DIM>::ConstructNodeAttributes()
 {
-    if (mpNodeAttributes == nullptr)
+    if (mpNodeAttributes == nullptr && mpAttributesStore == nullptr)
     {
         mpNodeAttributes = new NodeAttributes<SPACE_DIM>();
     }
@@ -430,6 +562,11 @@ template <unsigned SPACE_DIM>
 void Node<SPACE_DIM>::SetRegion(unsigned region)
 {
     ConstructNodeAttributes();
+    if (mpAttributesStore)
+    {
+        mpAttributesStore->SetRegion(mAttributesSlot, region);
+        return;
+    }
     mpNodeAttributes->SetRegion(region);
 }
 
@@ -438,7 +575,11 @@ unsigned Node<SPACE_DIM>::GetRegion() const
 {
     unsigned region = 0;
 
-    if (mpNodeAttributes)
+    if (mpAttributesStore)
+    {
+        region = mpAttributesStore->GetRegion(mAttributesSlot);
+    }
+    else if (mpNodeAttributes)
     {
         region = mpNodeAttributes->GetRegion();
     }
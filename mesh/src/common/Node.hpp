@@ -44,6 +44,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ChasteSerialization.hpp"
 #include "ChastePoint.hpp"
 #include "NodeAttributes.hpp"
+#include "NodeAttributesStore.hpp"
 
 //#include <boost/serialization/vector.hpp>
 //#include <boost/serialization/set.hpp>
@@ -62,23 +63,32 @@ private:
     /** The index of this node within the mesh. */
     unsigned mIndex;
 
+    /** The slot holding this node's attributes in #mpAttributesStore, if it has one. */
+    unsigned mAttributesSlot;
+
     /** The location of this node within the mesh. */
     c_vector<double, SPACE_DIM> mLocation;
 
     /** A pointer to a NodeAttributes object associated with this node. */
     NodeAttributes<SPACE_DIM>* mpNodeAttributes;
 
+    /**
+     * A pointer to the mesh-level store holding this node's attributes, if
+     * the node uses one instead of #mpNodeAttributes. Not owned by the node.
+     */
+    NodeAttributesStore<SPACE_DIM>* mpAttributesStore;
+
     /** Whether this node is a boundary node. */
-    bool mIsBoundaryNode;
+    bool mIsBoundaryNode : 1;
 
     /** Whether this node is an internal node (for use in the QuadraticMesh class). */
-    bool mIsInternal;
+    bool mIsInternal : 1;
 
     /**
      * Whether this node has been deleted, and hence whether its location in the
      * mesh can be re-used (for use in the MutableMesh class).
      */
-    bool mIsDeleted;
+    bool mIsDeleted : 1;
 
     /** Set of indices of elements containing this node as a vertex. */
     std::set<unsigned> mElementIndices;
@@ -98,6 +108,7 @@ private:
     template <class Archive>
     void serialize(Archive & archive, const unsigned int version)
     {
+        // Attributes held in a NodeAttributesStore are not archived here; meshes archive them via the accessors
         //archive & mLocation; //earlier versions of boost are unable to do this. See #1709
 //        archive & mIndex;
         archive & mpNodeAttributes;
@@ -182,10 +193,26 @@ public:
     Node(unsigned index,  double *location, bool isBoundaryNode=false);
 
     /**
-     * Explicit destructor to free memory from mpNodeAttributes.
+     * Explicit destructor to free memory from mpNodeAttributes, or to release
+     * this node's slot in its attributes store.
      */
     ~Node();
 
+    /**
+     * Move this node's attributes into a mesh-level store, copying across any
+     * attributes it already has and freeing its own NodeAttributes object.
+     * From then on all the attribute methods below read and write the store,
+     * which must outlive the node.
+     *
+     * @param pStore the store to use
+     */
+    void UseAttributesStore(NodeAttributesStore<SPACE_DIM>* pStore);
+
+    /**
+     * @return whether this node keeps its attributes in a NodeAttributesStore.
+     */
+    bool UsesAttributesStore() const;
+
     /**
      * Set the node's location.
      *
@@ -335,7 +362,8 @@ public:
     unsigned GetNumNodeAttributes();
 
     /**
-     * @return Whether mpNodeAttributes has been set. Used in archiving of attributes in a mesh.
+     * @return Whether mpNodeAttributes has been set, or the node uses an attributes store.
+     * Used in archiving of attributes in a mesh.
      */
     bool HasNodeAttributes();
 
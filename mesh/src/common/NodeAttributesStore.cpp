@@ -0,0 +1,187 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include <cassert>
+
+#include "NodeAttributesStore.hpp"
+#include "Exception.hpp"
+
+template <unsigned SPACE_DIM>
+NodeAttributesStore<SPACE_DIM>::NodeAttributesStore(unsigned initialCapacity)
+{
+    mAttributes.reserve(initialCapacity);
+    mRegions.reserve(initialCapacity);
+    mAppliedForces.reserve(initialCapacity);
+    mRadii.reserve(initialCapacity);
+    mNeighbourIndices.reserve(initialCapacity);
+    mFlags.reserve(initialCapacity);
+}
+
+template <unsigned SPACE_DIM>
+void NodeAttributesStore<SPACE_DIM>::SetFlag(unsigned slot, unsigned char bit, bool value)
+{
+    if (value)
+    {
+        mFlags[slot] |= bit;
+    }
+    else
+    {
+        mFlags[slot] &= static_cast<unsigned char>(~bit);
+    }
+}
+
+template <unsigned SPACE_DIM>
+unsigned NodeAttributesStore<SPACE_DIM>::AllocateSlot()
+{
+    unsigned slot;
+    if (mFreeSlots.empty())
+    {
+        slot = mRegions.size();
+        mAttributes.push_back(std::vector<double>());
+        mRegions.push_back(0u);
+        mAppliedForces.push_back(zero_vector<double>(SPACE_DIM));
+        mRadii.push_back(0.0);
+        mNeighbourIndices.push_back(std::vector<unsigned>());
+        mFlags.push_back(0u);
+    }
+    else
+    {
+        slot = mFreeSlots.back();
+        mFreeSlots.pop_back();
+        mRegions[slot] = 0u;
+        mAppliedForces[slot] = zero_vector<double>(SPACE_DIM);
+        mRadii[slot] = 0.0;
+        mFlags[slot] = 0u;
+    }
+    return slot;
+}
+
+template <unsigned SPACE_DIM>
+void NodeAttributesStore<SPACE_DIM>::FreeSlot(unsigned slot)
+{
+    assert(slot < mRegions.size());
+
+    // Release the heap memory held by this slot now rather than when it is reused
+    std::vector<double>().swap(mAttributes[slot]);
+    std::vector<unsigned>().swap(mNeighbourIndices[slot]);
+    mFreeSlots.push_back(slot);
+}
+
+template <unsigned SPACE_DIM>
+unsigned NodeAttributesStore<SPACE_DIM>::GetNumSlots() const
+{
+    return mRegions.size();
+}
+
+template <unsigned SPACE_DIM>
+unsigned NodeAttributesStore<SPACE_DIM>::GetNumFreeSlots() const
+{
+    return mFreeSlots.size();
+}
+
+template <unsigned SPACE_DIM>
+std::vector<double>& NodeAttributesStore<SPACE_DIM>::rGetAttributes(unsigned slot)
+{
+    return mAttributes[slot];
+}
+
+template <unsigned SPACE_DIM>
+unsigned NodeAttributesStore<SPACE_DIM>::GetRegion(unsigned slot) const
+{
+    return mRegions[slot];
+}
+
+template <unsigned SPACE_DIM>
+void NodeAttributesStore<SPACE_DIM>::SetRegion(unsigned slot, unsigned region)
+{
+    mRegions[slot] = region;
+}
+
+template <unsigned SPACE_DIM>
+c_vector<double, SPACE_DIM>& NodeAttributesStore<SPACE_DIM>::rGetAppliedForce(unsigned slot)
+{
+    return mAppliedForces[slot];
+}
+
+template <unsigned SPACE_DIM>
+double NodeAttributesStore<SPACE_DIM>::GetRadius(unsigned slot) const
+{
+    return mRadii[slot];
+}
+
+template <unsigned SPACE_DIM>
+void NodeAttributesStore<SPACE_DIM>::SetRadius(unsigned slot, double radius)
+{
+    if (radius < 0.0)
+    {
+        EXCEPTION("Trying to set node attributes mRadius to a negative value.");
+    }
+    mRadii[slot] = radius;
+}
+
+template <unsigned SPACE_DIM>
+std::vector<unsigned>& NodeAttributesStore<SPACE_DIM>::rGetNeighbours(unsigned slot)
+{
+    return mNeighbourIndices[slot];
+}
+
+template <unsigned SPACE_DIM>
+bool NodeAttributesStore<SPACE_DIM>::GetNeighboursSetUp(unsigned slot) const
+{
+    return (mFlags[slot] & NEIGHBOURS_SET_UP) != 0;
+}
+
+template <unsigned SPACE_DIM>
+void NodeAttributesStore<SPACE_DIM>::SetNeighboursSetUp(unsigned slot, bool flag)
+{
+    SetFlag(slot, NEIGHBOURS_SET_UP, flag);
+}
+
+template <unsigned SPACE_DIM>
+bool NodeAttributesStore<SPACE_DIM>::IsParticle(unsigned slot) const
+{
+    return (mFlags[slot] & IS_PARTICLE) != 0;
+}
+
+template <unsigned SPACE_DIM>
+void NodeAttributesStore<SPACE_DIM>::SetIsParticle(unsigned slot, bool isParticle)
+{
+    SetFlag(slot, IS_PARTICLE, isParticle);
+}
+
+// Explicit instantiation
+template class NodeAttributesStore<1>;
+template class NodeAttributesStore<2>;
+template class NodeAttributesStore<3>;
@@ -0,0 +1,208 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef NODEATTRIBUTESSTORE_HPP_
+#define NODEATTRIBUTESSTORE_HPP_
+
+#include <vector>
+
+#include "UblasVectorInclude.hpp"
+
+#include <boost/utility.hpp>
+
+/**
+ * Mesh-level storage for the attributes of many nodes, laid out as one array
+ * per attribute rather than one heap-allocated NodeAttributes object per node.
+ *
+ * Each node that uses the store holds a slot number, handed out by
+ * AllocateSlot(), and all of its attributes live at that position in the
+ * arrays. Slots released by FreeSlot() are reused, so meshes that add and
+ * delete nodes do not grow the store without bound.
+ *
+ * Note that references returned by the rGet methods are only valid until the
+ * next call to AllocateSlot().
+ */
+template <unsigned SPACE_DIM>
+class NodeAttributesStore : private boost::noncopyable
+{
+private:
+
+    /** Bit in #mFlags recording whether the neighbours of a node have been set up. */
+    static const unsigned char NEIGHBOURS_SET_UP = 1u;
+
+    /** Bit in #mFlags recording whether a node is a particle. */
+    static const unsigned char IS_PARTICLE = 2u;
+
+    /** Arbitrary attributes that a user gives meaning to, for each slot. */
+    std::vector<std::vector<double> > mAttributes;
+
+    /** The region ID of each slot. */
+    std::vector<unsigned> mRegions;
+
+    /** The force accumulated on each slot. */
+    std::vector<c_vector<double, SPACE_DIM> > mAppliedForces;
+
+    /** The radius of each slot. */
+    std::vector<double> mRadii;
+
+    /** The indices of neighbouring nodes, for each slot. */
+    std::vector<std::vector<unsigned> > mNeighbourIndices;
+
+    /** Boolean flags of each slot, see #NEIGHBOURS_SET_UP and #IS_PARTICLE. */
+    std::vector<unsigned char> mFlags;
+
+    /** Slots that have been freed and may be handed out again. */
+    std::vector<unsigned> mFreeSlots;
+
+    /**
+     * Set or clear one of the bits in #mFlags.
+     *
+     * @param slot the slot
+     * @param bit the bit to change
+     * @param value whether to set the bit
+     */
+    void SetFlag(unsigned slot, unsigned char bit, bool value);
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param initialCapacity the number of slots to reserve space for (defaults to 0)
+     */
+    NodeAttributesStore(unsigned initialCapacity=0u);
+
+    /**
+     * Hand out a slot with default values for all attributes, reusing a freed
+     * slot if there is one.
+     *
+     * @return the slot
+     */
+    unsigned AllocateSlot();
+
+    /**
+     * Release a slot so that it may be handed out again. Its neighbour and
+     * attribute vectors are emptied.
+     *
+     * @param slot the slot
+     */
+    void FreeSlot(unsigned slot);
+
+    /**
+     * @return the number of slots in the store, including freed ones.
+     */
+    unsigned GetNumSlots() const;
+
+    /**
+     * @return the number of freed slots waiting to be reused.
+     */
+    unsigned GetNumFreeSlots() const;
+
+    /**
+     * @return the attributes of a slot.
+     * @param slot the slot
+     */
+    std::vector<double>& rGetAttributes(unsigned slot);
+
+    /**
+     * @return the region ID of a slot.
+     * @param slot the slot
+     */
+    unsigned GetRegion(unsigned slot) const;
+
+    /**
+     * Set the region ID of a slot.
+     *
+     * @param slot the slot
+     * @param region the region ID
+     */
+    void SetRegion(unsigned slot, unsigned region);
+
+    /**
+     * @return the force applied to a slot.
+     * @param slot the slot
+     */
+    c_vector<double, SPACE_DIM>& rGetAppliedForce(unsigned slot);
+
+    /**
+     * @return the radius of a slot.
+     * @param slot the slot
+     */
+    double GetRadius(unsigned slot) const;
+
+    /**
+     * Set the radius of a slot.
+     *
+     * @param slot the slot
+     * @param radius the radius. Must be >= 0.0
+     */
+    void SetRadius(unsigned slot, double radius);
+
+    /**
+     * @return the neighbour indices of a slot.
+     * @param slot the slot
+     */
+    std::vector<unsigned>& rGetNeighbours(unsigned slot);
+
+    /**
+     * @return whether the neighbours of a slot have been set up.
+     * @param slot the slot
+     */
+    bool GetNeighboursSetUp(unsigned slot) const;
+
+    /**
+     * Set whether the neighbours of a slot have been set up.
+     *
+     * @param slot the slot
+     * @param flag whether the neighbours are set up
+     */
+    void SetNeighboursSetUp(unsigned slot, bool flag);
+
+    /**
+     * @return whether a slot is a particle.
+     * @param slot the slot
+     */
+    bool IsParticle(unsigned slot) const;
+
+    /**
+     * Set whether a slot is a particle.
+     *
+     * @param slot the slot
+     * @param isParticle whether it is a particle
+     */
+    void SetIsParticle(unsigned slot, bool isParticle);
+};
+
+#endif /*NODEATTRIBUTESSTORE_HPP_*/
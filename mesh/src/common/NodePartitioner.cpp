@@ -34,6 +34,8 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 #include <cassert>
 #include <algorithm>
+#include <cfloat>
+#include <cmath>
 
 #include "Exception.hpp"
 #include "NodePartitioner.hpp"
@@ -67,14 +69,51 @@ void NodePartitioner<ELEMENT_DIM, SPACE_DIM>::DumbPartitioning(AbstractMesh<ELEM
     }
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned NodePartitioner<ELEMENT_DIM, SPACE_DIM>::WeightedDumbPartitioning(const std::vector<double>& rNodeWeights,
+                                                                       std::set<unsigned>& rNodesOwned)
+{
+    unsigned num_nodes = rNodeWeights.size();
+    unsigned num_procs = PetscTools::GetNumProcs();
+    unsigned rank = PetscTools::GetMyRank();
+
+    double total_weight = 0.0;
+    for (unsigned i=0; i<num_nodes; i++)
+    {
+        total_weight += rNodeWeights[i];
+    }
+
+    // Cut the node indices into stretches of (roughly) equal weight, as in HilbertCurvePartitioning
+    std::vector<unsigned> offsets(num_procs+1, num_nodes);
+    unsigned proc = 0;
+    double weight_so_far = 0.0;
+    for (unsigned node=0; node<num_nodes; node++)
+    {
+        while (proc < num_procs && weight_so_far >= total_weight*proc/num_procs)
+        {
+            offsets[proc] = node;
+            proc++;
+        }
+        weight_so_far += rNodeWeights[node];
+    }
+
+    for (unsigned node=offsets[rank]; node<offsets[rank+1]; node++)
+    {
+        rNodesOwned.insert(node);
+    }
+    return offsets[rank+1] - offsets[rank];
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void NodePartitioner<ELEMENT_DIM, SPACE_DIM>::PetscMatrixPartitioning(AbstractMeshReader<ELEMENT_DIM, SPACE_DIM>& rMeshReader,
                                               std::vector<unsigned>& rNodePermutation,
                                               std::set<unsigned>& rNodesOwned,
-                                              std::vector<unsigned>& rProcessorsOffset)
+                                              std::vector<unsigned>& rProcessorsOffset,
+                                              const std::vector<double>& rNodeWeights)
 {
     assert(PetscTools::IsParallel());
     assert(ELEMENT_DIM==2 || ELEMENT_DIM==3);      // LCOV_EXCL_LINE // Metis works with triangles and tetras
+    assert(rNodeWeights.empty() || rNodeWeights.size() == rMeshReader.GetNumNodes());
 
     if (!PetscTools::HasParMetis()) //We must have ParMetis support compiled into Petsc
     {
@@ -207,7 +246,7 @@ void NodePartitioner<ELEMENT_DIM, SPACE_DIM>::PetscMatrixPartitioning(AbstractMe
 
     // Convert to an adjacency matrix
     Mat adj_matrix;
-    MatCreateMPIAdj(PETSC_COMM_WORLD, num_local_nodes, num_nodes, xadj, adjncy, PETSC_NULL, &adj_matrix);
+    MatCreateMPIAdj(PetscTools::GetWorld(), num_local_nodes, num_nodes, xadj, adjncy, PETSC_NULL, &adj_matrix);
 
     PetscTools::Barrier();
     if (PetscTools::AmMaster())
@@ -217,8 +256,20 @@ void NodePartitioner<ELEMENT_DIM, SPACE_DIM>::PetscMatrixPartitioning(AbstractMe
 
     // Get PETSc to call ParMETIS
     MatPartitioning part;
-    MatPartitioningCreate(PETSC_COMM_WORLD, &part);
+    MatPartitioningCreate(PetscTools::GetWorld(), &part);
     MatPartitioningSetAdjacency(part, adj_matrix);
+    if (!rNodeWeights.empty())
+    {
+        // PETSc takes ownership of (and will free) the weights array
+        double max_weight = *std::max_element(rNodeWeights.begin(), rNodeWeights.end());
+        PetscMalloc(num_local_nodes*sizeof(PetscInt), &ptr);
+        PetscInt* vertex_weights = (PetscInt*) ptr;
+        for (unsigned local_index=0; local_index<num_local_nodes; local_index++)
+        {
+            vertex_weights[local_index] = ConvertToPartitionWeight(rNodeWeights[connectivity_matrix_lo + local_index], max_weight);
+        }
+        MatPartitioningSetVertexWeights(part, vertex_weights);
+    }
     MatPartitioningSetFromOptions(part);
     IS new_process_numbers;
 
@@ -343,7 +394,7 @@ void NodePartitioner<ELEMENT_DIM, SPACE_DIM>::GeometricPartitioning(AbstractMesh
     std::vector<unsigned> global_ownership(num_nodes, 0);
     std::vector<unsigned> global_index_ownership(num_nodes, UNSIGNED_UNSET);
 
-    MPI_Allreduce(&node_ownership[0], &global_ownership[0], num_nodes, MPI_UNSIGNED, MPI_LXOR, PETSC_COMM_WORLD);
+    MPI_Allreduce(&node_ownership[0], &global_ownership[0], num_nodes, MPI_UNSIGNED, MPI_LXOR, PetscTools::GetWorld());
     for (unsigned i=0; i<num_nodes; i++)
     {
         if (global_ownership[i] == 0)
@@ -353,7 +404,7 @@ void NodePartitioner<ELEMENT_DIM, SPACE_DIM>::GeometricPartitioning(AbstractMesh
     }
 
     // Create the permutation and offset vectors.
-    MPI_Allreduce(&node_index_ownership[0], &global_index_ownership[0], num_nodes, MPI_UNSIGNED, MPI_MIN, PETSC_COMM_WORLD);
+    MPI_Allreduce(&node_index_ownership[0], &global_index_ownership[0], num_nodes, MPI_UNSIGNED, MPI_MIN, PetscTools::GetWorld());
 
     for (unsigned proc=0; proc<PetscTools::GetNumProcs(); proc++)
     {
@@ -369,6 +420,162 @@ void NodePartitioner<ELEMENT_DIM, SPACE_DIM>::GeometricPartitioning(AbstractMesh
     assert(rNodePermutation.size() == num_nodes);
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void NodePartitioner<ELEMENT_DIM, SPACE_DIM>::HilbertCurvePartitioning(AbstractMeshReader<ELEMENT_DIM, SPACE_DIM>& rMeshReader,
+                                    std::vector<unsigned>& rNodePermutation,
+                                    std::set<unsigned>& rNodesOwned,
+                                    std::vector<unsigned>& rProcessorsOffset,
+                                    const std::vector<double>& rNodeWeights)
+{
+    unsigned num_nodes = rMeshReader.GetNumNodes();
+    unsigned num_procs = PetscTools::GetNumProcs();
+    assert(rNodeWeights.empty() || rNodeWeights.size() == num_nodes);
+
+    // First pass through the nodes to find the bounding box
+    std::vector<double> lower(SPACE_DIM, DBL_MAX);
+    std::vector<double> upper(SPACE_DIM, -DBL_MAX);
+    for (unsigned node=0; node<num_nodes; node++)
+    {
+        std::vector<double> location = rMeshReader.GetNextNode();
+        assert(location.size() == SPACE_DIM);
+        for (unsigned d=0; d<SPACE_DIM; d++)
+        {
+            lower[d] = std::min(lower[d], location[d]);
+            upper[d] = std::max(upper[d], location[d]);
+        }
+    }
+    rMeshReader.Reset();
+
+    // Second pass to place each node on a grid of 2^num_bits points in each direction, and find its distance along the curve
+    const unsigned num_bits = std::min(32u, 64u/SPACE_DIM);
+    const double grid_max = (double)((uint64_t(1) << num_bits) - 1);
+    std::vector<std::pair<uint64_t, unsigned> > curve_order(num_nodes);
+    std::vector<uint64_t> grid_coordinates(SPACE_DIM);
+    for (unsigned node=0; node<num_nodes; node++)
+    {
+        std::vector<double> location = rMeshReader.GetNextNode();
+        for (unsigned d=0; d<SPACE_DIM; d++)
+        {
+            double width = upper[d] - lower[d];
+            double scaled = (width > 0.0) ? (location[d] - lower[d])/width : 0.0;
+            grid_coordinates[d] = (uint64_t)(scaled*grid_max);
+        }
+        curve_order[node] = std::make_pair(CalculateHilbertIndex(grid_coordinates, num_bits), node);
+    }
+
+    // Sorting the pairs breaks ties by node index, so every process computes the same order
+    std::sort(curve_order.begin(), curve_order.end());
+
+    // Cut the curve into stretches of (roughly) equal weight
+    double total_weight = rNodeWeights.empty() ? (double)num_nodes : 0.0;
+    for (unsigned i=0; i<rNodeWeights.size(); i++)
+    {
+        total_weight += rNodeWeights[i];
+    }
+
+    rProcessorsOffset.resize(num_procs);
+    rNodePermutation.resize(num_nodes);
+    unsigned proc = 0;
+    double weight_so_far = 0.0;
+    for (unsigned position=0; position<num_nodes; position++)
+    {
+        // Start the next process(es) once this one has its share
+        while (proc < num_procs && weight_so_far >= total_weight*proc/num_procs)
+        {
+            rProcessorsOffset[proc] = position;
+            proc++;
+        }
+
+        unsigned node = curve_order[position].second;
+        rNodePermutation[node] = position;
+        weight_so_far += rNodeWeights.empty() ? 1.0 : rNodeWeights[node];
+    }
+    for (; proc<num_procs; proc++)
+    {
+        rProcessorsOffset[proc] = num_nodes;
+    }
+
+    // Fill in rNodesOwned
+    unsigned rank = PetscTools::GetMyRank();
+    unsigned end = PetscTools::AmTopMost() ? num_nodes : rProcessorsOffset[rank+1];
+    for (unsigned position=rProcessorsOffset[rank]; position<end; position++)
+    {
+        rNodesOwned.insert(curve_order[position].second);
+    }
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+uint64_t NodePartitioner<ELEMENT_DIM, SPACE_DIM>::CalculateHilbertIndex(const std::vector<uint64_t>& rCoordinates, unsigned numBits)
+{
+    assert(rCoordinates.size() == SPACE_DIM);
+    assert(numBits > 0 && SPACE_DIM*numBits <= 64);
+
+    /*
+     * Convert the coordinates to the "transposed" form of the Hilbert index, following
+     * J. Skilling, "Programming the Hilbert curve", AIP Conf. Proc. 707, 381 (2004).
+     */
+    std::vector<uint64_t> x(rCoordinates);
+    const uint64_t top_bit = uint64_t(1) << (numBits-1);
+
+    // Inverse undo
+    for (uint64_t q = top_bit; q > 1; q >>= 1)
+    {
+        uint64_t p = q - 1;
+        for (unsigned i=0; i<SPACE_DIM; i++)
+        {
+            if (x[i] & q)
+            {
+                // Invert
+                x[0] ^= p;
+            }
+            else
+            {
+                // Exchange
+                uint64_t t = (x[0] ^ x[i]) & p;
+                x[0] ^= t;
+                x[i] ^= t;
+            }
+        }
+    }
+
+    // Gray encode
+    for (unsigned i=1; i<SPACE_DIM; i++)
+    {
+        x[i] ^= x[i-1];
+    }
+    uint64_t t = 0;
+    for (uint64_t q = top_bit; q > 1; q >>= 1)
+    {
+        if (x[SPACE_DIM-1] & q)
+        {
+            t ^= q - 1;
+        }
+    }
+    for (unsigned i=0; i<SPACE_DIM; i++)
+    {
+        x[i] ^= t;
+    }
+
+    // Interleave the bits of the transposed form, most significant first
+    uint64_t index = 0;
+    for (unsigned bit=numBits; bit-- > 0;)
+    {
+        for (unsigned i=0; i<SPACE_DIM; i++)
+        {
+            index = (index << 1) | ((x[i] >> bit) & 1u);
+        }
+    }
+    return index;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned NodePartitioner<ELEMENT_DIM, SPACE_DIM>::ConvertToPartitionWeight(double weight, double maxWeight)
+{
+    assert(maxWeight > 0.0);
+    unsigned int_weight = (unsigned) floor(MAX_PARTITION_WEIGHT*weight/maxWeight + 0.5);
+    return std::max(1u, int_weight);
+}
+
 // Explicit instantiation
 template class NodePartitioner<1,1>;
 template class NodePartitioner<1,2>;
@@ -37,10 +37,15 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define NODEPARTITIONER_HPP_
 
 #include <set>
+#include <vector>
+#include <cstdint>
 
 #include "AbstractMesh.hpp"
 #include "AbstractMeshReader.hpp"
 
+/** The integer weight given to the most expensive node when partitioning with node weights. */
+#define MAX_PARTITION_WEIGHT 1000u
+
 /**
  * Static methods to allow node-wise partitioning of meshes.
  */
@@ -59,6 +64,18 @@ public:
      static void DumbPartitioning(AbstractMesh<ELEMENT_DIM, SPACE_DIM>& rMesh,
                                   std::set<unsigned>& rNodesOwned);
 
+    /**
+     * Compute a dumb partition, in which each process owns a contiguous range of the node
+     * indices, but choose the ranges so that they have (roughly) equal total weight rather
+     * than equal numbers of nodes.  The nodes are not permuted.
+     *
+     * @param rNodeWeights  the relative computational cost of each node, indexed as in the mesh
+     * @param rNodesOwned is an empty set to be filled with the indices of nodes owned by this process
+     * @return the number of nodes owned by this process
+     */
+    static unsigned WeightedDumbPartitioning(const std::vector<double>& rNodeWeights,
+                                             std::set<unsigned>& rNodesOwned);
+
     /**
      * Method to compute a parallel partitioning of a given mesh.
      *
@@ -66,12 +83,26 @@ public:
      * @param rNodePermutation is the vector to be filled with node permutation information.
      * @param rNodesOwned is an empty set to be filled with the indices of nodes owned by this process
      * @param rProcessorsOffset a vector of length NumProcs to be filled with the index of the lowest indexed node owned by each process
+     * @param rNodeWeights optional relative computational cost of each node (in the original mesh file ordering).
+     *     If empty (the default) all nodes are weighted equally.
      *
      */
     static void PetscMatrixPartitioning(AbstractMeshReader<ELEMENT_DIM, SPACE_DIM>& rMeshReader,
                                         std::vector<unsigned>& rNodePermutation,
                                         std::set<unsigned>& rNodesOwned,
-                                        std::vector<unsigned>& rProcessorsOffset);
+                                        std::vector<unsigned>& rProcessorsOffset,
+                                        const std::vector<double>& rNodeWeights=std::vector<double>());
+
+    /**
+     * Convert a relative (floating point) cost into the positive integer weight expected by
+     * the graph partitioners.  Weights are scaled so that the heaviest item has weight
+     * MAX_PARTITION_WEIGHT, and nothing is given a weight of less than one.
+     *
+     * @param weight  the relative cost to convert
+     * @param maxWeight  the largest relative cost being partitioned
+     * @return the integer weight
+     */
+    static unsigned ConvertToPartitionWeight(double weight, double maxWeight);
     /**
      * Specialised method to compute the partition of a mesh based on geometric partitioning
      *
@@ -88,6 +119,38 @@ public:
                                         std::vector<unsigned>& rProcessorsOffset,
                                         ChasteCuboid<SPACE_DIM>* pRegion);
 
+    /**
+     * Compute a partition of a mesh by ordering the nodes along a Hilbert space-filling curve
+     * through the mesh's bounding box, and giving each process a contiguous stretch of the curve.
+     * Nodes which are close in space tend to be close along the curve, so this gives compact
+     * partitions without building the mesh connectivity graph.  Each process computes the same
+     * ordering independently, so no communication is needed.  This is cheap enough to use for
+     * very large meshes, although the partitions are generally less balanced in surface area
+     * than those from a graph partitioner.
+     *
+     * @param rMeshReader is the reader pointing to the mesh to be read in and partitioned
+     * @param rNodePermutation is the vector to be filled with node permutation information.
+     * @param rNodesOwned is an empty set to be filled with the indices of nodes owned by this process
+     * @param rProcessorsOffset a vector of length NumProcs to be filled with the index of the lowest indexed node owned by each process
+     * @param rNodeWeights optional relative computational cost of each node (in the original mesh file ordering).
+     *     If empty (the default) all nodes are weighted equally.
+     */
+    static void HilbertCurvePartitioning(AbstractMeshReader<ELEMENT_DIM, SPACE_DIM>& rMeshReader,
+                                         std::vector<unsigned>& rNodePermutation,
+                                         std::set<unsigned>& rNodesOwned,
+                                         std::vector<unsigned>& rProcessorsOffset,
+                                         const std::vector<double>& rNodeWeights=std::vector<double>());
+
+    /**
+     * Compute the distance along a Hilbert curve of a point in a SPACE_DIM-dimensional grid
+     * with 2^numBits points in each direction.
+     *
+     * @param rCoordinates  the integer grid coordinates of the point (each less than 2^numBits)
+     * @param numBits  the number of bits per coordinate; SPACE_DIM*numBits must be at most 64
+     * @return the index of the point along the curve
+     */
+    static uint64_t CalculateHilbertIndex(const std::vector<uint64_t>& rCoordinates, unsigned numBits);
+
 
 private:
 };
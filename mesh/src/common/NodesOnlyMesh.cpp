@@ -33,7 +33,9 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 */
 
+#include <algorithm>
 #include <map>
+#include <stdint.h>
 #include "NodesOnlyMesh.hpp"
 #include "ChasteCuboid.hpp"
 
@@ -45,7 +47,10 @@ NodesOnlyMesh<SPACE_DIM>::NodesOnlyMesh()
           mMinimumNodeDomainBoundarySeparation(1.0),
           mMaxAddedNodeIndex(0u),
           mpBoxCollection(nullptr),
-          mCalculateNodeNeighbours(true)
+          mCalculateNodeNeighbours(true),
+          mVerletSkin(0.0),
+          mUseMultiLevelPairSearch(false),
+          mUseGlobalLoadBalancing(false)
 {
 }
 
@@ -81,6 +86,7 @@ void NodesOnlyMesh<SPACE_DIM>::ConstructNodesWithoutMesh(const std::vector<Node<
             // Create a copy of the node, sharing its location
             c_vector<double, SPACE_DIM> location = rNodes[i]->rGetLocation();
             Node<SPACE_DIM>* p_node_copy = new Node<SPACE_DIM>(GetNextAvailableIndex(), location);
+            this->AttachNodeToAttributesStore(p_node_copy);
 
             p_node_copy->SetRadius(0.5);
 
@@ -238,6 +244,59 @@ void NodesOnlyMesh<SPACE_DIM>::CalculateBoundaryNodePairs(std::vector<std::pair<
     mpBoxCollection->CalculateBoundaryNodePairs(this->mNodes, rNodePairs);
 }
 
+template <unsigned SPACE_DIM>
+void NodesOnlyMesh<SPACE_DIM>::SetVerletSkin(double skin)
+{
+    assert(skin >= 0.0);
+    mVerletSkin = skin;
+}
+
+template <unsigned SPACE_DIM>
+double NodesOnlyMesh<SPACE_DIM>::GetVerletSkin() const
+{
+    return mVerletSkin;
+}
+
+template <unsigned SPACE_DIM>
+void NodesOnlyMesh<SPACE_DIM>::SetUseMultiLevelPairSearch(bool useMultiLevelPairSearch)
+{
+    mUseMultiLevelPairSearch = useMultiLevelPairSearch;
+}
+
+template <unsigned SPACE_DIM>
+bool NodesOnlyMesh<SPACE_DIM>::GetUseMultiLevelPairSearch() const
+{
+    return mUseMultiLevelPairSearch;
+}
+
+template <unsigned SPACE_DIM>
+void NodesOnlyMesh<SPACE_DIM>::SetUseGlobalLoadBalancing(bool useGlobalLoadBalancing)
+{
+    mUseGlobalLoadBalancing = useGlobalLoadBalancing;
+}
+
+template <unsigned SPACE_DIM>
+bool NodesOnlyMesh<SPACE_DIM>::GetUseGlobalLoadBalancing() const
+{
+    return mUseGlobalLoadBalancing;
+}
+
+template <unsigned SPACE_DIM>
+void NodesOnlyMesh<SPACE_DIM>::RecordNodeLocationsForNodePairs()
+{
+    assert(mpBoxCollection);
+
+    mpBoxCollection->RecordNodeLocationsForNodePairs(this->mNodes);
+}
+
+template <unsigned SPACE_DIM>
+bool NodesOnlyMesh<SPACE_DIM>::AreNodePairsStillValid()
+{
+    assert(mpBoxCollection);
+
+    return mpBoxCollection->AreNodePairsStillValid(this->mNodes);
+}
+
 template <unsigned SPACE_DIM>
 void NodesOnlyMesh<SPACE_DIM>::ReMesh(NodeMap& map)
 {
@@ -256,24 +315,27 @@ void NodesOnlyMesh<SPACE_DIM>::ReMesh(NodeMap& map)
 template <unsigned SPACE_DIM>
 void NodesOnlyMesh<SPACE_DIM>::RemoveDeletedNodes(NodeMap& map)
 {
-    typename std::vector<Node<SPACE_DIM>* >::iterator node_iter = this->mNodes.begin();
-    while (node_iter != this->mNodes.end())
+    // Compact the vector of nodes in a single pass, keeping the live nodes in order
+    unsigned num_live_nodes = 0;
+    for (unsigned i=0; i<this->mNodes.size(); i++)
     {
-        if ((*node_iter)->IsDeleted())
+        Node<SPACE_DIM>* p_node = this->mNodes[i];
+        if (p_node->IsDeleted())
         {
-            map.SetDeleted((*node_iter)->GetIndex());
+            map.SetDeleted(p_node->GetIndex());
 
-            mNodesMapping.erase((*node_iter)->GetIndex());
+            mNodesMapping.erase(p_node->GetIndex());
 
-            // Free memory before erasing the pointer from the list of nodes.
-            delete (*node_iter);
-            node_iter = this->mNodes.erase(node_iter);
+            // Free memory before dropping the pointer from the list of nodes.
+            delete p_node;
         }
         else
         {
-            ++node_iter;
+            this->mNodes[num_live_nodes] = p_node;
+            num_live_nodes++;
         }
     }
+    this->mNodes.resize(num_live_nodes);
 }
 
 template <unsigned SPACE_DIM>
@@ -287,6 +349,71 @@ void NodesOnlyMesh<SPACE_DIM>::UpdateNodeIndices()
     }
 }
 
+template <unsigned SPACE_DIM>
+Node<SPACE_DIM>* NodesOnlyMesh<SPACE_DIM>::CopyNode(Node<SPACE_DIM>* pNode)
+{
+    Node<SPACE_DIM>* p_copy = new Node<SPACE_DIM>(pNode->GetIndex(), pNode->rGetLocation(), pNode->IsBoundaryNode());
+    if (pNode->HasNodeAttributes())
+    {
+        p_copy->rGetNodeAttributes() = pNode->rGetNodeAttributes();
+        p_copy->SetRegion(pNode->GetRegion());
+        p_copy->SetRadius(pNode->GetRadius());
+        p_copy->SetIsParticle(pNode->IsParticle());
+        p_copy->AddAppliedForceContribution(pNode->rGetAppliedForce());
+    }
+    return p_copy;
+}
+
+template <unsigned SPACE_DIM>
+bool NodesOnlyMesh<SPACE_DIM>::ReorderNodesSpatially()
+{
+    if (!this->mDeletedNodeIndices.empty() || this->mNodes.size() < 2)
+    {
+        return false;
+    }
+
+    // Quantise each coordinate over the local bounding box and interleave the bits
+    const unsigned bits_per_dim = 21; // 63 bits of code in 3D
+    const double num_cells = (double)((1u << bits_per_dim) - 1u);
+    ChasteCuboid<SPACE_DIM> bounding_box = this->CalculateBoundingBox(this->mNodes);
+    c_vector<double, SPACE_DIM> lower = bounding_box.rGetLowerCorner().rGetLocation();
+    c_vector<double, SPACE_DIM> upper = bounding_box.rGetUpperCorner().rGetLocation();
+
+    std::vector<std::pair<uint64_t, unsigned> > codes(this->mNodes.size());
+    for (unsigned i=0; i<this->mNodes.size(); i++)
+    {
+        const c_vector<double, SPACE_DIM>& r_location = this->mNodes[i]->rGetLocation();
+        uint64_t code = 0;
+        for (unsigned d=0; d<SPACE_DIM; d++)
+        {
+            double extent = upper[d] - lower[d];
+            uint64_t cell = (extent > 0.0) ? (uint64_t)(num_cells*(r_location[d] - lower[d])/extent) : 0u;
+            for (unsigned bit=0; bit<bits_per_dim; bit++)
+            {
+                code |= ((cell >> bit) & 1u) << (SPACE_DIM*bit + d);
+            }
+        }
+        codes[i] = std::make_pair(code, i);
+    }
+    std::sort(codes.begin(), codes.end());
+
+    // Re-allocate in the new order, so the nodes are laid out in memory in that order too
+    std::vector<Node<SPACE_DIM>*> sorted_nodes(this->mNodes.size());
+    for (unsigned i=0; i<codes.size(); i++)
+    {
+        sorted_nodes[i] = CopyNode(this->mNodes[codes[i].second]);
+    }
+    for (unsigned i=0; i<this->mNodes.size(); i++)
+    {
+        delete this->mNodes[i];
+    }
+    this->mNodes.swap(sorted_nodes);
+
+    UpdateNodeIndices();
+
+    return true;
+}
+
 template <unsigned SPACE_DIM>
 void NodesOnlyMesh<SPACE_DIM>::CalculateNodesOutsideLocalDomain()
 {
@@ -356,6 +483,7 @@ void NodesOnlyMesh<SPACE_DIM>::AddNodeWithFixedIndex(Node<SPACE_DIM>* pNewNode)
     }
 
     this->mAddedNodes = true;
+    this->AttachNodeToAttributesStore(pNewNode);
 
     mMaxAddedNodeIndex = (pNewNode->GetIndex() > mMaxAddedNodeIndex) ? pNewNode->GetIndex() : mMaxAddedNodeIndex;
 
@@ -400,6 +528,7 @@ void NodesOnlyMesh<SPACE_DIM>::SetNode(unsigned nodeIndex, ChastePoint<SPACE_DIM
 
     // Update the node's location
     this->GetNode(nodeIndex)->SetPoint(point);
+    this->InvalidateSpatialSearch();
 }
 
 template <unsigned SPACE_DIM>
@@ -584,9 +713,11 @@ void NodesOnlyMesh<SPACE_DIM>::SetUpBoxCollection(double cutOffLength, c_vector<
 {
      ClearBoxCollection();
 
-     mpBoxCollection = new DistributedBoxCollection<SPACE_DIM>(cutOffLength, domainSize, isPeriodic, numLocalRows);
+     mpBoxCollection = new DistributedBoxCollection<SPACE_DIM>(cutOffLength + mVerletSkin, domainSize, isPeriodic, numLocalRows);
      mpBoxCollection->SetupLocalBoxesHalfOnly();
      mpBoxCollection->SetCalculateNodeNeighbours(mCalculateNodeNeighbours);
+     mpBoxCollection->SetVerletSkin(mVerletSkin);
+     mpBoxCollection->SetUseMultiLevelPairSearch(mUseMultiLevelPairSearch);
 }
 
 template <unsigned SPACE_DIM>
@@ -647,7 +778,8 @@ void NodesOnlyMesh<SPACE_DIM>::LoadBalanceMesh()
 {
     std::vector<int> local_node_distribution = mpBoxCollection->CalculateNumberOfNodesInEachStrip();
 
-    unsigned new_rows = mpBoxCollection->LoadBalance(local_node_distribution);
+    unsigned new_rows = mUseGlobalLoadBalancing ? mpBoxCollection->LoadBalanceGlobally(local_node_distribution)
+                                                : mpBoxCollection->LoadBalance(local_node_distribution);
 
     c_vector<double, 2*SPACE_DIM> current_domain_size = mpBoxCollection->rGetDomainSize();
 
@@ -152,6 +152,26 @@ private:
     /** Whether to calculate node neighbours in the box collection. Switch off for efficiency */
     bool mCalculateNodeNeighbours;
 
+    /**
+     * The Verlet skin added to the box width when setting up the box collection,
+     * so that node pairs can be reused between updates (see SetVerletSkin()).
+     * Not archived. Defaults to zero.
+     */
+    double mVerletSkin;
+
+    /**
+     * Whether the box collection finds node pairs with a multi-level grid (see
+     * SetUseMultiLevelPairSearch()). Not archived. Defaults to false.
+     */
+    bool mUseMultiLevelPairSearch;
+
+    /**
+     * Whether LoadBalanceMesh() rebalances all the rows in one go, rather than
+     * moving each process boundary by one row (see SetUseGlobalLoadBalancing()).
+     * Not archived. Defaults to false.
+     */
+    bool mUseGlobalLoadBalancing;
+
     /**
      * Calculate the next unique global index available on this
      * process. Uses a hashing function to ensure that a unique
@@ -199,6 +219,14 @@ private:
      /** Make sure that node indices match their location, and update mNodesMapping. */
      void UpdateNodeIndices();
 
+     /**
+      * @return a new node which is a copy of the given one, including its attributes.
+      * The neighbours are not copied, as they are recalculated with the node pairs.
+      *
+      * @param pNode the node to copy
+      */
+     static Node<SPACE_DIM>* CopyNode(Node<SPACE_DIM>* pNode);
+
      /**
       * Add pNewNode to the mesh, maintaining its current global index. Called by AddNode and AddMovedNode.
       *
@@ -352,6 +380,76 @@ public:
      */
     void CalculateBoundaryNodePairs(std::vector<std::pair<Node<SPACE_DIM>*, Node<SPACE_DIM>*> >& rNodePairs);
 
+    /**
+     * Sort the nodes on this process into Morton (Z-curve) order of their locations,
+     * re-allocating each node, so that nodes which are close in space are also close
+     * in memory and in #mNodes. The global node indices, and hence the node-to-cell
+     * bookkeeping, are unaffected, but any pointers to the nodes must be recalculated:
+     * UpdateBoxCollection() must be called before the boxes are next used, and the node
+     * pairs recalculated. Does nothing while there are deleted nodes awaiting ReMesh().
+     *
+     * @return whether the nodes were sorted.
+     */
+    bool ReorderNodesSpatially();
+
+    /**
+     * Set the Verlet skin. Boxes are then made this much wider than the cut-off length,
+     * so that the node pairs remain a superset of those within the cut-off until some
+     * node has moved by half the skin, and need not be recalculated before then (see
+     * AreNodePairsStillValid()). Takes effect when the box collection is next set up.
+     *
+     * @param skin the skin width (must be non-negative).
+     */
+    void SetVerletSkin(double skin);
+
+    /**
+     * @return #mVerletSkin.
+     */
+    double GetVerletSkin() const;
+
+    /**
+     * Set whether the box collection finds node pairs with a hierarchy of grids sized by
+     * the node radii (see DistributedBoxCollection::SetUseMultiLevelPairSearch()). The pairs
+     * are then only those within the sum of the two radii plus the Verlet skin, rather than
+     * all those in neighbouring boxes. Takes effect when the box collection is next set up.
+     *
+     * @param useMultiLevelPairSearch whether to use the multi-level search
+     */
+    void SetUseMultiLevelPairSearch(bool useMultiLevelPairSearch);
+
+    /**
+     * @return #mUseMultiLevelPairSearch.
+     */
+    bool GetUseMultiLevelPairSearch() const;
+
+    /**
+     * Set whether LoadBalanceMesh() uses DistributedBoxCollection::LoadBalanceGlobally(),
+     * which moves the process boundaries straight to where they balance the number of
+     * nodes, instead of DistributedBoxCollection::LoadBalance(), which moves each boundary
+     * by at most one row per call. This suits populations whose distribution changes
+     * quickly, such as a growing spheroid. Nodes still only move between neighbouring
+     * processes.
+     *
+     * @param useGlobalLoadBalancing whether to use global load balancing (defaults to true)
+     */
+    void SetUseGlobalLoadBalancing(bool useGlobalLoadBalancing=true);
+
+    /**
+     * @return #mUseGlobalLoadBalancing.
+     */
+    bool GetUseGlobalLoadBalancing() const;
+
+    /**
+     * Record the current node locations, to be called once the node pairs have been calculated.
+     */
+    void RecordNodeLocationsForNodePairs();
+
+    /**
+     * @return whether the node pairs calculated when RecordNodeLocationsForNodePairs() was
+     * last called can still be used. See DistributedBoxCollection::AreNodePairsStillValid().
+     */
+    bool AreNodePairsStillValid();
+
     /**
      * Overridden ReMesh() method. Since only Nodes are stored, this method cleans up mNodes by
      * removing nodes marked as deleted and reallocating mNodes to 'fill the gaps'.
@@ -39,13 +39,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "Warnings.hpp"
 #include "QuadraticMeshHelper.hpp"
 
-//Jonathan Shewchuk's Triangle and Hang Si's TetGen
-#define REAL double
-#define VOID void
-#include "triangle.h"
-#include "tetgen.h"
-#undef REAL
-#undef VOID
+#include <unordered_map>
 
 template <unsigned DIM>
 void QuadraticMesh<DIM>::CountVertices()
@@ -414,45 +408,40 @@ void QuadraticMesh<DIM>::ConstructFromLinearMeshReader(AbstractMeshReader<DIM, D
     //Make a linear mesh
     TetrahedralMesh<DIM,DIM>::ConstructFromMeshReader(rMeshReader);
 
-    NodeMap unused_map(this->GetNumNodes());
-
-    if (DIM==2)  // In 2D, remesh using triangle via library calls
+    /*
+     * Add a node at the midpoint of each edge, in a single pass over the elements.  Edges are
+     * hashed on their (ordered) vertex indices so that each midpoint node is created once and
+     * shared by all the elements around that edge.
+     */
+    std::unordered_map<uint64_t, Node<DIM>*> edge_to_internal_node;
+    edge_to_internal_node.reserve(this->GetNumElements()*DIM*(DIM+1)/2);
+    for (typename AbstractTetrahedralMesh<DIM,DIM>::ElementIterator iter = this->GetElementIteratorBegin();
+         iter != this->GetElementIteratorEnd();
+         ++iter)
     {
-        struct triangulateio mesher_input, mesher_output;
-        this->InitialiseTriangulateIo(mesher_input);
-        this->InitialiseTriangulateIo(mesher_output);
-
-        mesher_input.numberoftriangles = this->GetNumElements();
-        mesher_input.trianglelist = (int *) malloc(this->GetNumElements() * (DIM+1) * sizeof(int));
-        this->ExportToMesher(unused_map, mesher_input, mesher_input.trianglelist);
-
-        // Library call
-        triangulate((char*)"Qzero2", &mesher_input, &mesher_output, nullptr);
-
-        this->ImportFromMesher(mesher_output, mesher_output.numberoftriangles, mesher_output.trianglelist, mesher_output.numberofedges, mesher_output.edgelist, mesher_output.edgemarkerlist);
-        CountVertices();
-        QuadraticMeshHelper<DIM>::AddNodesToBoundaryElements(this, nullptr);
-
-        //Tidy up triangle
-        this->FreeTriangulateIo(mesher_input);
-        this->FreeTriangulateIo(mesher_output);
+        for (unsigned internal_node=DIM+1; internal_node<(DIM+1)*(DIM+2)/2; internal_node++)
+        {
+            unsigned vertex0, vertex1;
+            QuadraticMeshHelper<DIM>::GetEdgeVerticesOfInternalNode(internal_node, vertex0, vertex1);
+            Node<DIM>* p_vertex0 = iter->GetNode(vertex0);
+            Node<DIM>* p_vertex1 = iter->GetNode(vertex1);
+            uint64_t key = QuadraticMeshHelper<DIM>::GetEdgeKey(p_vertex0->GetIndex(), p_vertex1->GetIndex());
+
+            Node<DIM>*& rp_internal_node = edge_to_internal_node[key];
+            if (rp_internal_node == nullptr)
+            {
+                c_vector<double, DIM> location = 0.5*(p_vertex0->rGetLocation() + p_vertex1->rGetLocation());
+                rp_internal_node = new Node<DIM>(this->mNodes.size(), location, false);
+                rp_internal_node->MarkAsInternal();
+                this->mNodes.push_back(rp_internal_node);
+            }
+            iter->AddNode(rp_internal_node);
+            rp_internal_node->AddElement(iter->GetIndex());
+        }
     }
-    else // in 3D, remesh using tetgen
-    {
-
-        class tetgen::tetgenio mesher_input, mesher_output;
 
-        mesher_input.numberoftetrahedra = this->GetNumElements();
-        mesher_input.tetrahedronlist = new int[this->GetNumElements() * (DIM+1)];
-        this->ExportToMesher(unused_map, mesher_input, mesher_input.tetrahedronlist);
-
-        // Library call
-        tetgen::tetrahedralize((char*)"Qzro2", &mesher_input, &mesher_output);
-
-        this->ImportFromMesher(mesher_output, mesher_output.numberoftetrahedra, mesher_output.tetrahedronlist, mesher_output.numberoftrifaces, mesher_output.trifacelist, nullptr);
-        CountVertices();
-        QuadraticMeshHelper<DIM>::AddNodesToBoundaryElements(this, nullptr);
-    }
+    CountVertices();
+    QuadraticMeshHelper<DIM>::AddNodesToBoundaryElements(this, nullptr);
 }
 
 template <unsigned DIM>
@@ -464,7 +453,7 @@ void QuadraticMesh<DIM>::ConstructFromMeshReader(AbstractMeshReader<DIM, DIM>& r
     // If it is a linear mesh reader
     if (order_of_elements == 1)
     {
-        WARNING("Reading a (linear) tetrahedral mesh and converting it to a QuadraticMesh.  This involves making an external library call to Triangle/Tetgen in order to compute internal nodes");
+        WARNING("Reading a (linear) tetrahedral mesh and converting it to a QuadraticMesh.  Internal nodes are added at the midpoint of each edge");
         ConstructFromLinearMeshReader(rAbsMeshReader);
         return;
     }
@@ -178,7 +178,10 @@ public:
     /**
      * Load a quadratic mesh from a linear mesh file.
      *
-     * Constructs as linear mesh, then exports to triangle/tetgen
+     * Constructs as linear mesh, then adds a node at the midpoint of each edge, found in one pass
+     * over the elements using a hash of the edges.  The boundary elements are those read from file.
+     * The result may be written with a TrianglesMeshWriter (in ascii or binary) and read back in,
+     * including by a DistributedQuadraticMesh.
      *
      * @param rMeshReader the mesh reader
      */
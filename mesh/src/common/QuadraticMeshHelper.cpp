@@ -35,6 +35,8 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "QuadraticMeshHelper.hpp"
 
+#include <unordered_map>
+
 #define SEEK_TO_CONTENT(methNameDirect, methNameIncrement, index) \
     if (index > 0u) {                                             \
         if (rMeshReader.IsFileFormatBinary()) {                   \
@@ -127,121 +129,99 @@ void QuadraticMeshHelper<DIM>::AddInternalNodesToBoundaryElements(AbstractTetrah
 template <unsigned DIM>
 void QuadraticMeshHelper<DIM>::AddNodesToBoundaryElements(AbstractTetrahedralMesh<DIM, DIM>* pMesh,
                                                           AbstractMeshReader<DIM,DIM>* pMeshReader)
- {
-    // Loop over all boundary elements, find the equivalent face from all
-    // the elements, and add the extra nodes to the boundary element
-    bool boundary_element_file_has_containing_element_info = false;
-
-    if (pMeshReader)
-    {
-        boundary_element_file_has_containing_element_info = pMeshReader->GetReadContainingElementOfBoundaryElement();
-    }
-
+{
     if (DIM > 1)
     {
-        if (boundary_element_file_has_containing_element_info)
+        // Hash the internal nodes of the elements we own by the edge they lie on
+        std::unordered_map<uint64_t, Node<DIM>*> edge_to_internal_node;
+        edge_to_internal_node.reserve(pMesh->GetNumLocalElements()*DIM*(DIM+1)/2);
+        for (typename AbstractTetrahedralMesh<DIM,DIM>::ElementIterator iter = pMesh->GetElementIteratorBegin();
+             iter != pMesh->GetElementIteratorEnd();
+             ++iter)
         {
-            pMeshReader->Reset();
+            assert(iter->GetNumNodes() == (DIM+1)*(DIM+2)/2);
+            for (unsigned internal_node=DIM+1; internal_node<(DIM+1)*(DIM+2)/2; internal_node++)
+            {
+                unsigned vertex0, vertex1;
+                GetEdgeVerticesOfInternalNode(internal_node, vertex0, vertex1);
+                uint64_t key = GetEdgeKey(iter->GetNodeGlobalIndex(vertex0), iter->GetNodeGlobalIndex(vertex1));
+                edge_to_internal_node[key] = iter->GetNode(internal_node);
+            }
         }
 
-        ///\todo #1930 Until there is an interator_facade over boundary elements,
-        // we may need to skip through the boundary element file searching for containing elements hints.
-        // This counter keeps track of our position in the file.
-        unsigned next_face_on_file = 0u;
-
+        // Add the internal nodes on each edge of each boundary element, in the same order as a
+        // 2D element (internal node i of a face lies opposite vertex i)
         for (typename AbstractTetrahedralMesh<DIM,DIM>::BoundaryElementIterator iter
                  = pMesh->GetBoundaryElementIteratorBegin();
              iter != pMesh->GetBoundaryElementIteratorEnd();
              ++iter)
         {
-
-            // collect the nodes of this boundary element in a set
-            std::set<unsigned> boundary_element_node_indices;
-            for (unsigned i=0; i<DIM; i++)
+            assert((*iter)->GetNumNodes() == DIM);
+            unsigned num_internal_nodes = (DIM==2) ? 1u : 3u;
+            std::vector<Node<DIM>*> internal_nodes(num_internal_nodes);
+            for (unsigned i=0; i<num_internal_nodes; i++)
             {
-                boundary_element_node_indices.insert( (*iter)->GetNodeGlobalIndex(i) );
-            }
-
-            bool found_this_boundary_element = false;
-
-            // Loop over elements surrounding this face, then loop over each face of that element, and see if it matches
-            // this boundary element.
-            // Note, if we know what elem it should be in (boundary_element_file_has_containing_element_info==true)
-            // we will reset elem_index immediately (below)
-            Node<DIM>* p_representative_node = (*iter)->GetNode(0);
-            for (typename Node<DIM>::ContainingElementIterator element_iter = p_representative_node->ContainingElementsBegin();
-                 element_iter != p_representative_node->ContainingElementsEnd();
-                 ++element_iter)
-            {
-                unsigned elem_index = *element_iter;
-
-                // We know what elem it should be in (but we'll still check the node indices match in case)
-                if (boundary_element_file_has_containing_element_info)
-                {
-                    unsigned face_index = (*iter)->GetIndex();
-                    ///\todo #1930 Once there is an interator_facade then we can do: elem_index = pMeshReader->GetFaceData(face_index).ContainingElement;
-                    do
-                    {
-                        elem_index = pMeshReader->GetNextFaceData().ContainingElement;
-                        next_face_on_file++;
-                    }
-                    while (face_index >= next_face_on_file);
-                }
-
-                Element<DIM,DIM>* p_element = pMesh->GetElement(elem_index);
-
-                // For each element, loop over faces (the opposites to a node)
-                for (unsigned face=0; face<DIM+1; face++)
-                {
-                    // Collect the node indices for this face
-                    std::set<unsigned> node_indices;
-                    for (unsigned local_node_index=0; local_node_index<DIM+1; local_node_index++)
-                    {
-                        if (local_node_index != face)
-                        {
-                            node_indices.insert( p_element->GetNodeGlobalIndex(local_node_index) );
-                        }
-                    }
-
-                    assert(node_indices.size()==DIM);
-
-                    // See if this face matches the boundary element, and add internal nodes if so
-                    if (node_indices == boundary_element_node_indices)
-                    {
-                        QuadraticMeshHelper<DIM>::AddExtraBoundaryNodes(pMesh, *iter, p_element, face);
-
-                        found_this_boundary_element = true;
-                        break;
-                    }
-                }
-
-                // If the containing element info was given, we must have found the face first time
-                if (boundary_element_file_has_containing_element_info && !found_this_boundary_element)
+                unsigned vertex0 = (DIM==2) ? 0u : (i+1)%3;
+                unsigned vertex1 = (DIM==2) ? 1u : (i+2)%3;
+                uint64_t key = GetEdgeKey((*iter)->GetNodeGlobalIndex(vertex0), (*iter)->GetNodeGlobalIndex(vertex1));
+                typename std::unordered_map<uint64_t, Node<DIM>*>::iterator it = edge_to_internal_node.find(key);
+                if (it == edge_to_internal_node.end())
                 {
                     // LCOV_EXCL_START
-                    //std::cout << (*iter)->GetIndex() << " " <<  pMeshReader->GetNextFaceData().ContainingElement << "\n";
-                    EXCEPTION("Boundary element " << (*iter)->GetIndex()
-                              << "wasn't found in the containing element given for it "
-                              << elem_index);
+                    EXCEPTION("Unable to find a face of an element which matches one of the boundary elements");
                     // LCOV_EXCL_STOP
                 }
-
-                if (found_this_boundary_element)
-                {
-                    break;
-                }
+                internal_nodes[i] = it->second;
             }
-
-            if (!found_this_boundary_element)
+            for (unsigned i=0; i<num_internal_nodes; i++)
             {
-                // LCOV_EXCL_START
-                EXCEPTION("Unable to find a face of an element which matches one of the boundary elements");
-                // LCOV_EXCL_STOP
+                AddNodeToBoundaryElement(pMesh, *iter, internal_nodes[i]);
             }
         }
     }
 }
 
+template <unsigned DIM>
+void QuadraticMeshHelper<DIM>::GetEdgeVerticesOfInternalNode(unsigned internalNode, unsigned& rVertex0, unsigned& rVertex1)
+{
+    assert(internalNode >= DIM+1);
+    assert(internalNode < (DIM+1)*(DIM+2)/2);
+    switch (DIM)
+    {
+        case 1:
+        {
+            rVertex0 = 0;
+            rVertex1 = 1;
+            break;
+        }
+        case 2:
+        {
+            // Internal node 3+i is opposite vertex i
+            rVertex0 = (internalNode-2)%3;
+            rVertex1 = (internalNode-1)%3;
+            break;
+        }
+        default:
+        {
+            assert(DIM==3);
+            const unsigned edge_vertices[6][2] = {{0,1}, {1,2}, {0,2}, {0,3}, {1,3}, {2,3}};
+            rVertex0 = edge_vertices[internalNode-4][0];
+            rVertex1 = edge_vertices[internalNode-4][1];
+        }
+    }
+}
+
+template <unsigned DIM>
+uint64_t QuadraticMeshHelper<DIM>::GetEdgeKey(unsigned globalIndex1, unsigned globalIndex2)
+{
+    assert(globalIndex1 != globalIndex2);
+    if (globalIndex1 > globalIndex2)
+    {
+        std::swap(globalIndex1, globalIndex2);
+    }
+    return (((uint64_t) globalIndex1) << 32) | ((uint64_t) globalIndex2);
+}
+
 template <unsigned DIM>
 void QuadraticMeshHelper<DIM>::CheckBoundaryElements(AbstractTetrahedralMesh<DIM, DIM>* pMesh)
 {
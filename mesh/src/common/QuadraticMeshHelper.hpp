@@ -36,6 +36,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef QUADRATICMESHHELPER_HPP_
 #define QUADRATICMESHHELPER_HPP_
 
+#include <stdint.h>
 #include "AbstractTetrahedralMesh.hpp"
 #include "TrianglesMeshReader.hpp"
 
@@ -78,15 +79,39 @@ public:
      * Used by AddInternalNodesToBoundaryElements in the case where the on-disk mesh doesn't have
      * the associations already, and by the linear -> quadratic mesh conversion routines.
      *
-     * If there is an on-mesh disk that has containing element information in its edge/face file,
-     * then this can be supplied to speed up finding the full element containing each boundary element.
+     * The internal nodes of the locally owned elements are hashed by the edge they lie on, and each
+     * boundary element then looks up the nodes on its own edges, so no search over the elements
+     * containing each face is needed.  The containing element of a boundary element must be owned
+     * by this process, which DistributedTetrahedralMesh guarantees.
      *
      * @param pMesh  the mesh to modify
-     * @param pMeshReader  pointer to the reader for accessing the on-disk mesh data, if any; NULL otherwise
+     * @param pMeshReader  pointer to the reader for accessing the on-disk mesh data, if any; NULL otherwise.
+     *     No longer needed, but kept for compatibility.
      */
     static void AddNodesToBoundaryElements(AbstractTetrahedralMesh<DIM, DIM>* pMesh,
                                             AbstractMeshReader<DIM,DIM>* pMeshReader);
 
+    /**
+     * Get the local indices of the two vertices at either end of the edge on which an internal node of
+     * a quadratic simplex lies.  The ordering matches that used by Triangle and Tetgen, i.e. in 2D
+     * internal nodes 3, 4, 5 lie on edges (1,2), (2,0), (0,1), and in 3D internal nodes 4..9 lie on
+     * edges (0,1), (1,2), (0,2), (0,3), (1,3), (2,3).
+     *
+     * @param internalNode  local index of the internal node, from DIM+1 to (DIM+1)*(DIM+2)/2 - 1
+     * @param rVertex0  filled in with the local index of the first vertex
+     * @param rVertex1  filled in with the local index of the second vertex
+     */
+    static void GetEdgeVerticesOfInternalNode(unsigned internalNode, unsigned& rVertex0, unsigned& rVertex1);
+
+    /**
+     * @return a key identifying the edge between two vertices, independent of their order,
+     * for use in hashing edges.
+     *
+     * @param globalIndex1  global index of one of the vertices
+     * @param globalIndex2  global index of the other vertex
+     */
+    static uint64_t GetEdgeKey(unsigned globalIndex1, unsigned globalIndex2);
+
     /**
      * Check whether all the boundary elements in the given mesh have the expected number of nodes.
      *
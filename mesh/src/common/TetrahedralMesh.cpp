@@ -43,6 +43,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "BoundaryElement.hpp"
 #include "Element.hpp"
+#include "ElementBoundingVolumeHierarchy.hpp"
 #include "Exception.hpp"
 #include "Node.hpp"
 #include "OutputFileHandler.hpp"
@@ -70,6 +71,7 @@ void TetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::ConstructFromMeshReader(
 {
     assert(rMeshReader.HasNodePermutation() == false);
     this->mMeshFileBaseName = rMeshReader.GetMeshFileBaseName();
+    this->mNumElementsPerParentElement = rMeshReader.GetNumElementsPerParentElement();
 
     // Record number of corner nodes
     unsigned num_nodes = rMeshReader.GetNumNodes();
@@ -373,12 +375,26 @@ unsigned TetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::GetContainingElementIndexWithI
 {
     assert(startingElementGuess < this->GetNumElements());
 
+    if (this->mUseSpatialSearch && this->mElements[startingElementGuess]->IncludesPoint(rTestPoint, strict))
+    {
+        return startingElementGuess;
+    }
+    ElementBoundingVolumeHierarchy<SPACE_DIM>* p_hierarchy = this->mUseSpatialSearch ? this->GetElementBoundingVolumeHierarchy() : nullptr;
+    if (p_hierarchy)
+    {
+        unsigned element_index = this->GetContainingElementIndexFromHierarchy(*p_hierarchy, rTestPoint, strict);
+        if (element_index != UINT_MAX)
+        {
+            return element_index;
+        }
+    }
+
     /*
      * Let m=startingElementGuess, N=num_elem-1.
      * We search from in this order: m, m+1, m+2, .. , N, 0, 1, .., m-1.
      */
     unsigned i = startingElementGuess;
-    bool reached_end = false;
+    bool reached_end = (p_hierarchy != nullptr); // the hierarchy has already ruled out every element
 
     while (!reached_end)
     {
@@ -417,6 +433,21 @@ template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 unsigned TetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::GetNearestElementIndex(const ChastePoint<SPACE_DIM>& rTestPoint)
 {
     EXCEPT_IF_NOT(ELEMENT_DIM == SPACE_DIM); // LCOV_EXCL_LINE // CalculateInterpolationWeights hits an assertion otherwise
+    ElementBoundingVolumeHierarchy<SPACE_DIM>* p_hierarchy = this->mUseSpatialSearch ? this->GetElementBoundingVolumeHierarchy() : nullptr;
+    if (p_hierarchy)
+    {
+        std::set<unsigned> test_elements;
+        p_hierarchy->GetCandidateContainingElements(rTestPoint.rGetLocation(), test_elements);
+        if (test_elements.empty())
+        {
+            p_hierarchy->GetCandidateNearestElements(rTestPoint.rGetLocation(), test_elements);
+        }
+        if (!test_elements.empty())
+        {
+            return this->GetNearestElementIndexFromTestElements(rTestPoint, test_elements);
+        }
+    }
+
     double max_min_weight = -std::numeric_limits<double>::infinity();
     unsigned closest_index = 0;
     for (unsigned i = 0; i < this->mElements.size(); i++)
@@ -444,6 +475,21 @@ template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 std::vector<unsigned> TetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::GetContainingElementIndices(const ChastePoint<SPACE_DIM>& rTestPoint)
 {
     std::vector<unsigned> element_indices;
+    ElementBoundingVolumeHierarchy<SPACE_DIM>* p_hierarchy = this->mUseSpatialSearch ? this->GetElementBoundingVolumeHierarchy() : nullptr;
+    if (p_hierarchy)
+    {
+        std::set<unsigned> candidates;
+        p_hierarchy->GetCandidateContainingElements(rTestPoint.rGetLocation(), candidates);
+        for (std::set<unsigned>::iterator iter = candidates.begin(); iter != candidates.end(); ++iter)
+        {
+            if (this->mElements[*iter]->IncludesPoint(rTestPoint))
+            {
+                element_indices.push_back(*iter);
+            }
+        }
+        return element_indices;
+    }
+
     for (unsigned i = 0; i < this->mElements.size(); i++)
     {
         if (this->mElements[i]->IncludesPoint(rTestPoint))
@@ -458,6 +504,8 @@ std::vector<unsigned> TetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::GetContainingElem
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void TetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::Clear()
 {
+    this->InvalidateTopologyCache();
+
     // Three loops, just like the destructor. note we don't delete boundary nodes.
     for (unsigned i = 0; i < this->mBoundaryElements.size(); i++)
     {
@@ -641,6 +689,7 @@ typename TetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::EdgeIterator TetrahedralMesh<E
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void TetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::RefreshMesh()
 {
+    AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::RefreshMesh();
     RefreshJacobianCachedData();
 }
 
@@ -668,6 +717,8 @@ unsigned TetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::SolveBoundaryElementMapping(un
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void TetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::RefreshJacobianCachedData()
 {
+    this->InvalidateElementGeometryCache();
+
     unsigned num_elements = this->GetNumAllElements();
     unsigned num_boundary_elements = this->GetNumAllBoundaryElements();
 
@@ -0,0 +1,166 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#include "PeriodicNodesOnlyMesh.hpp"
+
+template <unsigned SPACE_DIM>
+PeriodicNodesOnlyMesh<SPACE_DIM>::PeriodicNodesOnlyMesh(double width)
+        : NodesOnlyMesh<SPACE_DIM>(),
+          mWidth(width)
+{
+    assert(SPACE_DIM > 1);    // LCOV_EXCL_LINE
+    assert(width > 0.0);
+}
+
+template <unsigned SPACE_DIM>
+double PeriodicNodesOnlyMesh<SPACE_DIM>::WrapXCoordinate(double x) const
+{
+    if (x >= mWidth || x < 0.0)
+    {
+        x = fmod(x, mWidth);
+        if (x < 0.0)
+        {
+            x += mWidth;
+        }
+
+        // This is to ensure that the position is never equal to mWidth, which would be outside the box domain
+        double fudge_factor = 1e-14;
+        if (x > mWidth-fudge_factor)
+        {
+            x = mWidth-fudge_factor;
+        }
+    }
+    return x;
+}
+
+template <unsigned SPACE_DIM>
+void PeriodicNodesOnlyMesh<SPACE_DIM>::SetUpBoxCollection(double cutOffLength, c_vector<double, 2*SPACE_DIM> domainSize, int numLocalRows, bool isPeriodic)
+{
+    // Ensure that the width is a multiple of the box width (the cut-off length plus any Verlet skin)
+    const double box_width = cutOffLength + this->GetVerletSkin();
+    double num_boxes = mWidth/box_width;
+    if (fabs(num_boxes - round(num_boxes)) > 1e-12*num_boxes)
+    {
+        EXCEPTION("The periodic width must be a multiple of cut off length.");
+    }
+    else if (round(num_boxes) == 2.0)
+    {
+        // With two boxes across, each box would be a neighbour of the other on both sides, so some pairs would be found twice
+        EXCEPTION("The periodic domain width cannot be 2*CutOffLength.");
+    }
+
+    // We force the domain to the periodic width
+    domainSize[0] = 0.0;
+    domainSize[1] = mWidth;
+
+    NodesOnlyMesh<SPACE_DIM>::SetUpBoxCollection(cutOffLength, domainSize, numLocalRows, true);
+
+    this->AddNodesToBoxes();
+}
+
+template <unsigned SPACE_DIM>
+c_vector<double, SPACE_DIM> PeriodicNodesOnlyMesh<SPACE_DIM>::GetVectorFromAtoB(const c_vector<double, SPACE_DIM>& rLocation1, const c_vector<double, SPACE_DIM>& rLocation2)
+{
+    c_vector<double, SPACE_DIM> vector = rLocation2 - rLocation1;
+    vector[0] = fmod(vector[0], mWidth);
+
+    // If the points are more than half the width apart in x, use the nearer periodic image
+    if (vector[0] > 0.5*mWidth)
+    {
+        vector[0] -= mWidth;
+    }
+    else if (vector[0] < -0.5*mWidth)
+    {
+        vector[0] += mWidth;
+    }
+    return vector;
+}
+
+template <unsigned SPACE_DIM>
+double PeriodicNodesOnlyMesh<SPACE_DIM>::GetWidth(const unsigned& rDimension) const
+{
+    assert(rDimension < SPACE_DIM);
+    return (rDimension == 0) ? mWidth : NodesOnlyMesh<SPACE_DIM>::GetWidth(rDimension);
+}
+
+template <unsigned SPACE_DIM>
+void PeriodicNodesOnlyMesh<SPACE_DIM>::SetNode(unsigned nodeIndex, ChastePoint<SPACE_DIM> point, bool concreteMove)
+{
+    // concreteMove should always be false for NodesOnlyMesh as no elements to check
+    assert(!concreteMove);
+
+    // Perform a periodic movement if necessary
+    point.SetCoordinate(0, WrapXCoordinate(point.rGetLocation()[0]));
+
+    // Update the node's location
+    this->GetNode(nodeIndex)->SetPoint(point);
+}
+
+template <unsigned SPACE_DIM>
+unsigned PeriodicNodesOnlyMesh<SPACE_DIM>::AddNode(Node<SPACE_DIM>* pNewNode)
+{
+    // Call method on parent class
+    unsigned node_index = NodesOnlyMesh<SPACE_DIM>::AddNode(pNewNode);
+
+    // If necessary move it back into the domain
+    ChastePoint<SPACE_DIM> new_node_point = pNewNode->GetPoint();
+    SetNode(node_index, new_node_point);
+
+    return node_index;
+}
+
+template <unsigned SPACE_DIM>
+void PeriodicNodesOnlyMesh<SPACE_DIM>::RefreshMesh()
+{
+    // Move any nodes outside the domain in x back into it
+    for (unsigned i=0; i<this->mNodes.size(); i++)
+    {
+        double& x_location = (this->mNodes[i]->rGetModifiableLocation())[0];
+        x_location = WrapXCoordinate(x_location);
+    }
+
+    // Now run the base class method
+    NodesOnlyMesh<SPACE_DIM>::RefreshMesh();
+}
+
+// Explicit instantiation
+template class PeriodicNodesOnlyMesh<2>;
+template class PeriodicNodesOnlyMesh<3>;
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapperForCpp.hpp"
+EXPORT_TEMPLATE_CLASS1(PeriodicNodesOnlyMesh, 2)
+EXPORT_TEMPLATE_CLASS1(PeriodicNodesOnlyMesh, 3)
@@ -0,0 +1,187 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef PERIODICNODESONLYMESH_HPP_
+#define PERIODICNODESONLYMESH_HPP_
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+
+#include "NodesOnlyMesh.hpp"
+
+/**
+ * A subclass of NodesOnlyMesh for a 2D or 3D domain whose boundaries at x=0 and
+ * x=width are periodic.
+ *
+ * No image nodes are created: the x coordinate of every node is kept in [0, width),
+ * the DistributedBoxCollection includes boxes on the far side of the domain among
+ * the neighbours of boxes on its left and right edges, and GetVectorFromAtoB()
+ * returns the minimum image vector, so forces and neighbour searches see the
+ * periodicity without any copying. In 2D this behaves as a Cylindrical2dNodesOnlyMesh.
+ */
+template <unsigned SPACE_DIM>
+class PeriodicNodesOnlyMesh : public NodesOnlyMesh<SPACE_DIM>
+{
+private:
+
+    /** The periodic width of the domain in x. */
+    double mWidth;
+
+    friend class TestPeriodicNodesOnlyMesh;
+
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Archives the member variables of the object which have to be preserved
+     * during its lifetime.
+     *
+     * @param archive the archive
+     * @param version the current version of this class
+     */
+    template <class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<NodesOnlyMesh<SPACE_DIM> >(*this);
+        archive & mWidth;
+    }
+
+    /**
+     * @param x an x coordinate
+     * @return the equivalent x coordinate in [0, mWidth)
+     */
+    double WrapXCoordinate(double x) const;
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param width the periodic width of the domain in x
+     */
+    PeriodicNodesOnlyMesh(double width);
+
+    /**
+     * Set up the box collection, which always spans [0, width) in x.
+     *
+     * @param cutOffLength the cut off length for node neighbours
+     * @param domainSize the size of the domain containing the nodes (the x extent is ignored).
+     * @param numLocalRows the number of rows of the collection that this process should own.
+     * @param isPeriodic whether the box collection should be periodic. Defaults to true.
+     */
+    virtual void SetUpBoxCollection(double cutOffLength, c_vector<double, 2*SPACE_DIM> domainSize, int numLocalRows = PETSC_DECIDE, bool isPeriodic = true);
+
+    /**
+     * Overridden GetVectorFromAtoB() method.
+     *
+     * @param rLocation1 the co-ordinates of point 1
+     * @param rLocation2 the co-ordinates of point 2
+     * @return the minimum image vector from location1 to location2
+     */
+    c_vector<double, SPACE_DIM> GetVectorFromAtoB(const c_vector<double, SPACE_DIM>& rLocation1, const c_vector<double, SPACE_DIM>& rLocation2);
+
+    /**
+     * Overridden GetWidth() method.
+     *
+     * @param rDimension a dimension
+     * @return the periodic width in x, or the maximum distance between any nodes in other dimensions.
+     */
+    double GetWidth(const unsigned& rDimension) const;
+
+    /**
+     * Overridden SetNode() method.
+     *
+     * If the location is outside [0, width) in x, move it back into the domain.
+     *
+     * @param nodeIndex is the index of the node to be moved
+     * @param point is the new target location of the node
+     * @param concreteMove should always be false here
+     */
+    void SetNode(unsigned nodeIndex, ChastePoint<SPACE_DIM> point, bool concreteMove = false);
+
+    /**
+     * Overridden AddNode() method.
+     *
+     * @param pNewNode  pointer to the new node
+     * @return index of new node
+     */
+    unsigned AddNode(Node<SPACE_DIM>* pNewNode);
+
+    /**
+     * Overridden RefreshMesh() method.
+     *
+     * Move any nodes outside [0, width) in x back into the domain.
+     */
+    void RefreshMesh();
+};
+
+#include "SerializationExportWrapper.hpp"
+EXPORT_TEMPLATE_CLASS1(PeriodicNodesOnlyMesh, 2)
+EXPORT_TEMPLATE_CLASS1(PeriodicNodesOnlyMesh, 3)
+
+namespace boost
+{
+namespace serialization
+{
+/**
+ * Serialize information required to construct a PeriodicNodesOnlyMesh.
+ */
+template <class Archive, unsigned SPACE_DIM>
+inline void save_construct_data(
+    Archive & ar, const PeriodicNodesOnlyMesh<SPACE_DIM> * t, const unsigned int file_version)
+{
+    // Save data required to construct instance
+    const double width = t->GetWidth(0);
+    ar & width;
+}
+
+/**
+ * De-serialize constructor parameters and initialise a PeriodicNodesOnlyMesh.
+ */
+template <class Archive, unsigned SPACE_DIM>
+inline void load_construct_data(
+    Archive & ar, PeriodicNodesOnlyMesh<SPACE_DIM> * t, const unsigned int file_version)
+{
+    // Retrieve data from archive required to construct new instance
+    double width;
+    ar & width;
+
+    // Invoke inplace constructor to initialise instance
+    ::new(t)PeriodicNodesOnlyMesh<SPACE_DIM>(width);
+}
+}
+} // namespace ...
+
+#endif /*PERIODICNODESONLYMESH_HPP_*/
@@ -194,6 +194,15 @@ public:
      */
     virtual bool GetReadContainingElementOfBoundaryElement();
 
+    /**
+     * @return the number of elements made from each element of the original (unrefined) mesh.
+     * Elements made from the same original element are numbered consecutively, so element i
+     * came from original element i/GetNumElementsPerParentElement().
+     *
+     * Note, this will always return 1 unless over-ridden by a derived class that refines a mesh
+     * (see UniformlyRefinedMeshReader).
+     */
+    virtual unsigned GetNumElementsPerParentElement();
 
     /**
      * @return true if reading binary files, false if reading ascii files.
@@ -45,6 +45,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "TrianglesMeshReader.hpp"
 #include "MemfemMeshReader.hpp"
 #include "VtkMeshReader.hpp"
+#include "GmshMeshReader.hpp"
 
 /**
  * This function creates a mesh reader of a suitable type to read the mesh file given.
@@ -52,6 +53,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  *  - TrianglesMeshReader
  *  - MemfemMeshReader
  *  - VtkMeshReader
+ *  - GmshMeshReader (for file names ending in ".msh")
  *
  * The created mesh reader is returned as a std::shared_ptr to ease memory management.
  *
@@ -71,6 +73,14 @@ std::shared_ptr<AbstractMeshReader<ELEMENT_DIM, SPACE_DIM> > GenericMeshReader(c
                                                                              bool readContainingElementsForBoundaryElements=false)
 {
     std::shared_ptr<AbstractMeshReader<ELEMENT_DIM, SPACE_DIM> > p_reader;
+    if (rPathBaseName.size() > 4u && rPathBaseName.compare(rPathBaseName.size()-4u, 4u, ".msh") == 0)
+    {
+        p_reader.reset(new GmshMeshReader<ELEMENT_DIM, SPACE_DIM>(rPathBaseName,
+                                                                  orderOfElements,
+                                                                  orderOfBoundaryElements));
+        return p_reader;
+    }
+
     try
     {
         p_reader.reset(new TrianglesMeshReader<ELEMENT_DIM, SPACE_DIM>(rPathBaseName,
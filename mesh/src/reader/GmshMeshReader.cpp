@@ -35,17 +35,50 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <cassert>
 #include <sstream>
 #include <iostream>
+#include <algorithm>
 
 #include "GmshMeshReader.hpp"
 #include "Exception.hpp"
 
+/**
+ * Read a value from a binary file.
+ *
+ * @param rFile  the file to read from
+ * @return the value read
+ */
+template <typename T>
+T ReadGmshBinaryValue(std::ifstream& rFile)
+{
+    T value;
+    rFile.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return value;
+}
+
+/**
+ * Used to find the block holding a given item.
+ *
+ * @param index  an item index
+ * @param rBlock  a block
+ * @return whether the block starts after the item
+ */
+bool GmshBlockStartsAfter(unsigned index, const GmshEntityBlock& rBlock)
+{
+    return index < rBlock.FirstIndex;
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 GmshMeshReader<ELEMENT_DIM, SPACE_DIM>::GmshMeshReader(std::string pathBaseName,
                                                        unsigned orderOfElements,
                                                        unsigned orderOfBoundaryElements) :
        mFileName(pathBaseName),
+       mNumElementAttributes(0u),
+       mNumFaceAttributes(0u),
        mOrderOfElements(orderOfElements),
-       mOrderOfBoundaryElements(orderOfBoundaryElements)
+       mOrderOfBoundaryElements(orderOfBoundaryElements),
+       mFilesAreBinary(false),
+       mNodesRead(0u),
+       mElementsRead(0u),
+       mFacesRead(0u)
 {
     // Only linear and quadratic elements
     assert(mOrderOfElements==1 || mOrderOfElements==2);
@@ -82,9 +115,9 @@ template <unsigned  ELEMENT_DIM, unsigned  SPACE_DIM>
 void GmshMeshReader<ELEMENT_DIM, SPACE_DIM>::OpenFiles()
 {
     // Open mesh file
-    mNodeFile.open(mFileName.c_str());
-    mElementFile.open(mFileName.c_str());
-    mFaceFile.open(mFileName.c_str());
+    mNodeFile.open(mFileName.c_str(), std::ios::binary);
+    mElementFile.open(mFileName.c_str(), std::ios::binary);
+    mFaceFile.open(mFileName.c_str(), std::ios::binary);
     if (!mNodeFile.is_open() || !mElementFile.is_open() || !mFaceFile.is_open() )
     {
         EXCEPTION("Could not open data file: " + mFileName);
@@ -116,16 +149,43 @@ void GmshMeshReader<ELEMENT_DIM, SPACE_DIM>::ReadHeaders()
 
     line >> mVersionNumber >> mFileType >> mDataSize;
 
-    if (mVersionNumber != 2.2)
+    mFilesAreBinary = (mFileType == 1u);
+    if (mFilesAreBinary)
+    {
+        if (mVersionNumber != 4.1)
+        {
+            EXCEPTION("Only .msh version 4.1 binary files are supported.");
+        }
+        if (mDataSize != sizeof(uint64_t))
+        {
+            EXCEPTION("Binary .msh files must use 8 byte sizes.");
+        }
+        // A binary 1 follows the header line, to check the byte order
+        if (ReadGmshBinaryValue<int>(mNodeFile) != 1)
+        {
+            EXCEPTION("Binary .msh file was written with a different byte order.");
+        }
+        getline(mNodeFile, this_line);
+    }
+    else if (mVersionNumber != 2.2)
     {
         EXCEPTION("Only .msh version 2.2 files are supported.");
     }
-    assert(mFileType == 0);
+    assert(mFileType == 0 || mFilesAreBinary);
 
     //Check mesh format close string
     getline(mNodeFile, this_line);
     assert(this_line == "$EndMeshFormat");
 
+    if (mFilesAreBinary)
+    {
+        IndexBinaryBlocks();
+        mNodesRead = 0u;
+        mElementsRead = 0u;
+        mFacesRead = 0u;
+        return;
+    }
+
     ReadNodeHeader();
     ReadElementHeader(); // This reads the total number of elements in the file into mTotalNumElementsAndFaces
     ReadFaceHeader();
@@ -247,6 +307,211 @@ void GmshMeshReader<ELEMENT_DIM, SPACE_DIM>::ReadFaceHeader()
     mFaceFile.seekg(face_start); //mFacesFile should now be pointing at the start of the node lines in the file.
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void GmshMeshReader<ELEMENT_DIM, SPACE_DIM>::IndexBinaryBlocks()
+{
+    bool found_nodes = false;
+    bool found_elements = false;
+
+    std::string this_line;
+    while (getline(mNodeFile, this_line))
+    {
+        if (this_line == "$Nodes")
+        {
+            IndexBinaryNodeBlocks();
+            found_nodes = true;
+        }
+        else if (this_line == "$Elements")
+        {
+            IndexBinaryElementBlocks();
+            found_elements = true;
+        }
+        else if (this_line.size() > 1u && this_line[0] == '$' && this_line.compare(0, 4, "$End") != 0)
+        {
+            // Skip sections we don't use, such as $Entities
+            std::string end_of_section = "$End" + this_line.substr(1);
+            while (getline(mNodeFile, this_line) && this_line != end_of_section)
+            {
+            }
+        }
+    }
+    mNodeFile.clear();
+
+    if (!found_nodes || !found_elements)
+    {
+        EXCEPTION("Binary .msh file has no $Nodes or no $Elements section.");
+    }
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void GmshMeshReader<ELEMENT_DIM, SPACE_DIM>::IndexBinaryNodeBlocks()
+{
+    uint64_t num_blocks = ReadGmshBinaryValue<uint64_t>(mNodeFile);
+    uint64_t num_nodes = ReadGmshBinaryValue<uint64_t>(mNodeFile);
+    uint64_t min_tag = ReadGmshBinaryValue<uint64_t>(mNodeFile);
+    uint64_t max_tag = ReadGmshBinaryValue<uint64_t>(mNodeFile);
+    if (num_nodes > 0u && (min_tag != 1u || max_tag != num_nodes))
+    {
+        EXCEPTION("Node tags in a binary .msh file must be numbered consecutively from 1: renumber the mesh in gmsh.");
+    }
+    mNumNodes = num_nodes;
+
+    mNodeBlocks.clear();
+    unsigned first_index = 0u;
+    for (uint64_t block_index = 0; block_index < num_blocks; ++block_index)
+    {
+        ReadGmshBinaryValue<int>(mNodeFile); // Entity dimension
+        int entity_tag = ReadGmshBinaryValue<int>(mNodeFile);
+        int parametric = ReadGmshBinaryValue<int>(mNodeFile);
+        uint64_t num_in_block = ReadGmshBinaryValue<uint64_t>(mNodeFile);
+        if (parametric != 0)
+        {
+            EXCEPTION("Parametric node coordinates in binary .msh files are not supported.");
+        }
+
+        // Nodes are numbered consecutively, so only the first and last tags need checking
+        std::streamoff tags_start = mNodeFile.tellg();
+        if (num_in_block > 0u)
+        {
+            uint64_t first_tag = ReadGmshBinaryValue<uint64_t>(mNodeFile);
+            mNodeFile.seekg(tags_start + (std::streamoff)((num_in_block-1)*sizeof(uint64_t)));
+            uint64_t last_tag = ReadGmshBinaryValue<uint64_t>(mNodeFile);
+            if (first_tag != first_index+1u || last_tag != first_index+num_in_block)
+            {
+                EXCEPTION("Node tags in a binary .msh file must be numbered consecutively from 1: renumber the mesh in gmsh.");
+            }
+
+            GmshEntityBlock block;
+            block.EntityTag = entity_tag;
+            block.FirstIndex = first_index;
+            block.NumItems = num_in_block;
+            block.NodesPerItem = 0u;
+            block.DataStart = tags_start + (std::streamoff)(num_in_block*sizeof(uint64_t));
+            mNodeBlocks.push_back(block);
+            first_index += num_in_block;
+        }
+        mNodeFile.seekg(tags_start + (std::streamoff)(num_in_block*(sizeof(uint64_t) + 3u*sizeof(double))));
+    }
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void GmshMeshReader<ELEMENT_DIM, SPACE_DIM>::IndexBinaryElementBlocks()
+{
+    uint64_t num_blocks = ReadGmshBinaryValue<uint64_t>(mNodeFile);
+    ReadGmshBinaryValue<uint64_t>(mNodeFile); // Number of elements of all types
+    ReadGmshBinaryValue<uint64_t>(mNodeFile); // Minimum element tag
+    ReadGmshBinaryValue<uint64_t>(mNodeFile); // Maximum element tag
+
+    mElementBlocks.clear();
+    mFaceBlocks.clear();
+    mNumElements = 0u;
+    mNumFaces = 0u;
+    for (uint64_t block_index = 0; block_index < num_blocks; ++block_index)
+    {
+        int entity_dim = ReadGmshBinaryValue<int>(mNodeFile);
+        int entity_tag = ReadGmshBinaryValue<int>(mNodeFile);
+        int ele_type = ReadGmshBinaryValue<int>(mNodeFile);
+        uint64_t num_in_block = ReadGmshBinaryValue<uint64_t>(mNodeFile);
+
+        unsigned nodes_per_item = 0u;
+        switch (ele_type)
+        {
+            case GmshTypes::POINT:
+                nodes_per_item = 1u;
+                break;
+            case GmshTypes::LINE:
+                nodes_per_item = 2u;
+                break;
+            case GmshTypes::QUADRATIC_LINE:
+            case GmshTypes::TRIANGLE:
+                nodes_per_item = 3u;
+                break;
+            case GmshTypes::TETRAHEDRON:
+                nodes_per_item = 4u;
+                break;
+            case GmshTypes::QUADRATIC_TRIANGLE:
+                nodes_per_item = 6u;
+                break;
+            case GmshTypes::QUADRATIC_TETRAHEDRON:
+                nodes_per_item = 10u;
+                break;
+            default:
+                EXCEPTION("Unrecognised element types present in the .msh file: check mesh generation settings in gmsh.");
+        }
+
+        GmshEntityBlock block;
+        block.EntityTag = entity_tag;
+        block.NumItems = num_in_block;
+        block.NodesPerItem = nodes_per_item;
+        block.DataStart = mNodeFile.tellg();
+
+        // Blocks of points (and of edges in 3D) are skipped
+        if (entity_dim == (int)ELEMENT_DIM)
+        {
+            if (!((ELEMENT_DIM == 2 && (ele_type == GmshTypes::TRIANGLE || ele_type == GmshTypes::QUADRATIC_TRIANGLE)) ||
+                  (ELEMENT_DIM == 3 && (ele_type == GmshTypes::TETRAHEDRON || ele_type == GmshTypes::QUADRATIC_TETRAHEDRON))))
+            {
+                EXCEPTION("Unrecognised element types present in the .msh file: check mesh generation settings in gmsh.");
+            }
+            if (nodes_per_item < mNodesPerElement)
+            {
+                EXCEPTION("The elements in the .msh file are of lower order than requested.");
+            }
+            block.FirstIndex = mNumElements;
+            mNumElements += num_in_block;
+            mElementBlocks.push_back(block);
+        }
+        else if (entity_dim + 1 == (int)ELEMENT_DIM)
+        {
+            if (!((ELEMENT_DIM == 2 && (ele_type == GmshTypes::LINE || ele_type == GmshTypes::QUADRATIC_LINE)) ||
+                  (ELEMENT_DIM == 3 && (ele_type == GmshTypes::TRIANGLE || ele_type == GmshTypes::QUADRATIC_TRIANGLE))))
+            {
+                EXCEPTION("Unrecognised element types present in the .msh file: check mesh generation settings in gmsh.");
+            }
+            if (nodes_per_item < mNodesPerBoundaryElement)
+            {
+                EXCEPTION("The elements in the .msh file are of lower order than requested.");
+            }
+            block.FirstIndex = mNumFaces;
+            mNumFaces += num_in_block;
+            mFaceBlocks.push_back(block);
+        }
+
+        mNodeFile.seekg(block.DataStart + (std::streamoff)(num_in_block*(1u + nodes_per_item)*sizeof(uint64_t)));
+    }
+
+    mNumElementAttributes = 1u;
+    mNumFaceAttributes = 1u;
+    mTotalNumElementsAndFaces = mNumElements + mNumFaces;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+ElementData GmshMeshReader<ELEMENT_DIM, SPACE_DIM>::ReadBinaryElementData(std::ifstream& rFile,
+                                                                         const std::vector<GmshEntityBlock>& rBlocks,
+                                                                         unsigned index,
+                                                                         unsigned numNodes)
+{
+    // Find the last block starting at or before this index
+    std::vector<GmshEntityBlock>::const_iterator it = std::upper_bound(rBlocks.begin(), rBlocks.end(), index, GmshBlockStartsAfter);
+    assert(it != rBlocks.begin());
+    const GmshEntityBlock& r_block = *(--it);
+    assert(index - r_block.FirstIndex < r_block.NumItems);
+
+    // Each element is stored as its tag followed by its node tags
+    std::vector<uint64_t> item(1u + r_block.NodesPerItem);
+    rFile.seekg(r_block.DataStart + (std::streamoff)((index - r_block.FirstIndex)*item.size()*sizeof(uint64_t)));
+    rFile.read(reinterpret_cast<char*>(&item[0]), item.size()*sizeof(uint64_t));
+
+    ElementData element_data;
+    element_data.NodeIndices.resize(numNodes);
+    for (unsigned node_index = 0; node_index < numNodes; ++node_index)
+    {
+        element_data.NodeIndices[node_index] = item[1u + node_index] - 1u; //Gmsh *always* indexes from 1, we index from 0
+    }
+    element_data.AttributeValue = r_block.EntityTag;
+    return element_data;
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 unsigned GmshMeshReader<ELEMENT_DIM, SPACE_DIM>::GetNumElements() const
 {
@@ -319,6 +584,11 @@ void GmshMeshReader<ELEMENT_DIM, SPACE_DIM>::Reset()
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 std::vector<double> GmshMeshReader<ELEMENT_DIM, SPACE_DIM>::GetNextNode()
 {
+    if (mFilesAreBinary)
+    {
+        return GetNode(mNodesRead);
+    }
+
     std::vector<double> ret_coords(SPACE_DIM);
 
     std::string this_line;
@@ -346,6 +616,11 @@ std::vector<double> GmshMeshReader<ELEMENT_DIM, SPACE_DIM>::GetNodeAttributes()
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 ElementData GmshMeshReader<ELEMENT_DIM, SPACE_DIM>::GetNextElementData()
 {
+    if (mFilesAreBinary)
+    {
+        return GetElementData(mElementsRead);
+    }
+
     ElementData element_data;
     element_data.NodeIndices.resize(mNodesPerElement);
     element_data.AttributeValue = 0.0; // If an attribute is not read this stays as zero, otherwise overwritten.
@@ -408,6 +683,11 @@ ElementData GmshMeshReader<ELEMENT_DIM, SPACE_DIM>::GetNextCableElementData()
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 ElementData GmshMeshReader<ELEMENT_DIM, SPACE_DIM>::GetNextFaceData()
 {
+    if (mFilesAreBinary)
+    {
+        return GetFaceData(mFacesRead);
+    }
+
     ElementData face_data;
     face_data.NodeIndices.resize(mNodesPerBoundaryElement);
     face_data.AttributeValue = 0.0; // If an attribute is not read this stays as zero, otherwise overwritten.
@@ -459,29 +739,66 @@ ElementData GmshMeshReader<ELEMENT_DIM, SPACE_DIM>::GetNextFaceData()
     return face_data;
 }
 
-// LCOV_EXCL_START
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool GmshMeshReader<ELEMENT_DIM, SPACE_DIM>::IsFileFormatBinary()
+{
+    return mFilesAreBinary;
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 std::vector<double> GmshMeshReader<ELEMENT_DIM, SPACE_DIM>::GetNode(unsigned index)
 {
-    NEVER_REACHED;
+    if (!mFilesAreBinary)
+    {
+        EXCEPTION("Random access is only implemented in mesh readers for binary mesh files.");
+    }
+    if (index >= mNumNodes)
+    {
+        EXCEPTION("Node does not exist - not enough nodes.");
+    }
+
+    std::vector<GmshEntityBlock>::const_iterator it = std::upper_bound(mNodeBlocks.begin(), mNodeBlocks.end(), index, GmshBlockStartsAfter);
+    assert(it != mNodeBlocks.begin());
+    const GmshEntityBlock& r_block = *(--it);
+
+    // Gmsh always stores three coordinates
+    double coords[3];
+    mNodeFile.seekg(r_block.DataStart + (std::streamoff)((index - r_block.FirstIndex)*3u*sizeof(double)));
+    mNodeFile.read(reinterpret_cast<char*>(coords), 3u*sizeof(double));
+    mNodesRead = index + 1u;
+
+    return std::vector<double>(coords, coords + SPACE_DIM);
 }
-// LCOV_EXCL_STOP
 
-// LCOV_EXCL_START
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 ElementData GmshMeshReader<ELEMENT_DIM, SPACE_DIM>::GetElementData(unsigned index)
 {
-    NEVER_REACHED;
+    if (!mFilesAreBinary)
+    {
+        EXCEPTION("Random access is only implemented in mesh readers for binary mesh files.");
+    }
+    if (index >= mNumElements)
+    {
+        EXCEPTION("Element " << index << " does not exist - not enough elements (only " << mNumElements << ").");
+    }
+    mElementsRead = index + 1u;
+    return ReadBinaryElementData(mElementFile, mElementBlocks, index, mNodesPerElement);
 }
-// LCOV_EXCL_STOP
 
-// LCOV_EXCL_START
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 ElementData GmshMeshReader<ELEMENT_DIM, SPACE_DIM>::GetFaceData(unsigned index)
 {
-    NEVER_REACHED;
+    if (!mFilesAreBinary)
+    {
+        EXCEPTION("Random access is only implemented in mesh readers for binary mesh files.");
+    }
+    if (index >= mNumFaces)
+    {
+        EXCEPTION("Face " << index << " does not exist - not enough faces (only " << mNumFaces << ").");
+    }
+    mFacesRead = index + 1u;
+    return ReadBinaryElementData(mFaceFile, mFaceBlocks, index, mNodesPerBoundaryElement);
 }
-// LCOV_EXCL_STOP
 
 // Explicit instantiation
 template class GmshMeshReader<0,1>;
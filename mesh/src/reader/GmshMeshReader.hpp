@@ -40,6 +40,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <vector>
 #include <string>
 #include <fstream>
+#include <stdint.h>
 #include "AbstractMeshReader.hpp"
 
 /**
@@ -57,12 +58,32 @@ struct GmshTypes
         TRIANGLE = 2u,
         QUADRATIC_TRIANGLE = 9u,
         TETRAHEDRON = 4u,
-        QUADRATIC_TETRAHEDRON = 11u
+        QUADRATIC_TETRAHEDRON = 11u,
+        POINT = 15u
     };
 };
 
+/**
+ * Where to find one entity block of nodes or elements in a binary (version 4.1) .msh file.
+ */
+struct GmshEntityBlock
+{
+    unsigned EntityTag; /**< The tag of the Gmsh entity (used as the attribute of its elements). */
+    unsigned FirstIndex; /**< The (zero-based) Chaste index of the first item in the block. */
+    unsigned NumItems; /**< The number of nodes or elements in the block. */
+    unsigned NodesPerItem; /**< The number of nodes per element (0 for a node block). */
+    std::streamoff DataStart; /**< The file offset of the coordinates or element data of the block. */
+};
+
 /**
  * Class to enable reading of Gmsh format mesh files (see #2312).
+ *
+ * Version 2.2 ascii files and version 4.1 binary files are supported.  For binary files only
+ * the block headers are read on construction, giving an index of where each block of nodes
+ * and elements starts, so that individual nodes and elements can be read directly.  This lets
+ * a DistributedTetrahedralMesh read only the part of the mesh each process owns.  Binary files
+ * must have node tags numbered consecutively from 1 (as Gmsh writes them by default), and the
+ * entity tag of each element block is used as the element attribute.
  */
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 class GmshMeshReader : public AbstractMeshReader<ELEMENT_DIM,SPACE_DIM>
@@ -135,7 +156,12 @@ public:
     std::vector<double> GetNodeAttributes();
 
     /**
-     *  Normally throws an exception.  Only implemented for tetrahedral mesh reader of binary files.
+     * @return true if the file is a version 4.1 binary .msh file (which allows random access)
+     */
+    bool IsFileFormatBinary();
+
+    /**
+     *  Throws an exception unless the file is binary.
      *
      * @param index  The global node index
      * @return a vector of the coordinates of the node
@@ -143,7 +169,7 @@ public:
     std::vector<double> GetNode(unsigned index);
 
     /**
-     *  Normally throws an exception.  Only implemented for tetrahedral mesh reader of binary files.
+     *  Throws an exception unless the file is binary.
      *
      * @param index  The global element index
      * @return a vector of the node indices of the element (and any attribute information, if there is any)
@@ -151,7 +177,7 @@ public:
     ElementData GetElementData(unsigned index);
 
     /**
-     *  Normally throws an exception.  Only implemented for tetrahedral mesh reader of binary files.
+     *  Throws an exception unless the file is binary.
      *
      * @param index  The global face index
      * @return a vector of the node indices of the face (and any attribute/containment information, if there is any)
@@ -171,6 +197,32 @@ private:
     /** Read the face header from the mesh file. */
     void ReadFaceHeader();
 
+    /**
+     * Read the headers of the node and element blocks of a binary file, to find the number of
+     * nodes, elements and faces and where each block is stored.
+     */
+    void IndexBinaryBlocks();
+
+    /** Read the node block headers of a binary file (the file should be just after "$Nodes"). */
+    void IndexBinaryNodeBlocks();
+
+    /** Read the element block headers of a binary file (the file should be just after "$Elements"). */
+    void IndexBinaryElementBlocks();
+
+    /**
+     * Read one element or face from a binary file.
+     *
+     * @param rFile  the file stream to read from
+     * @param rBlocks  the blocks of the elements or faces
+     * @param index  the index of the element or face
+     * @param numNodes  the number of nodes to return
+     * @return the node indices and attribute of the element or face
+     */
+    ElementData ReadBinaryElementData(std::ifstream& rFile,
+                                      const std::vector<GmshEntityBlock>& rBlocks,
+                                      unsigned index,
+                                      unsigned numNodes);
+
     /** Opens the .msh file descriptors */
     void OpenFiles();
 
@@ -194,6 +246,13 @@ private:
     unsigned mOrderOfBoundaryElements; /**< The order of each element (1 for linear, 2 for quadratic). */
     unsigned mNodesPerElement; /**< The number of nodes contained in each element. */
     unsigned mNodesPerBoundaryElement; /**< The number of nodes contained in each boundary element. */
+    bool mFilesAreBinary; /**< Whether the file is a binary (version 4.1) file. */
+    std::vector<GmshEntityBlock> mNodeBlocks; /**< The node blocks of a binary file. */
+    std::vector<GmshEntityBlock> mElementBlocks; /**< The element blocks of a binary file. */
+    std::vector<GmshEntityBlock> mFaceBlocks; /**< The face blocks of a binary file. */
+    unsigned mNodesRead; /**< Number of nodes read so far from a binary file. */
+    unsigned mElementsRead; /**< Number of elements read so far from a binary file. */
+    unsigned mFacesRead; /**< Number of faces read so far from a binary file. */
 };
 
 #endif //_GMSHMESHREADER_HPP_
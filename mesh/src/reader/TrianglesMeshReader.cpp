@@ -33,6 +33,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 */
 #include <cassert>
+#include <cstring>
 #include <sstream>
 #include <iostream>
 
@@ -202,12 +203,27 @@ ElementData TrianglesMeshReader<ELEMENT_DIM, SPACE_DIM>::GetNextElementData()
     element_data.NodeIndices.resize(mNodesPerElement);
     element_data.AttributeValue = 0.0; // If an attribute is not read this stays as zero, otherwise overwritten.
 
-    std::vector<double> element_attributes;
-    GetNextItemFromStream(mElementsFile, mElementsRead, element_data.NodeIndices, mNumElementAttributes, element_attributes);
-
-    if (mNumElementAttributes > 0)
+    if (mElementsFileMapping.IsOpen())
     {
-        element_data.AttributeValue = element_attributes[0];///only one element attribute registered for the moment
+        // Copy the item straight out of the mapped file; no stream positioning is needed
+        const char* p_item = mElementsFileMapping.GetData() + std::streamoff(mElementFileDataStart)
+                             + mElementItemWidth*mElementsRead;
+        memcpy(&element_data.NodeIndices[0], p_item, mNodesPerElement*sizeof(unsigned));
+        if (mNumElementAttributes > 0)
+        {
+            ///only one element attribute registered for the moment
+            memcpy(&element_data.AttributeValue, p_item + mNodesPerElement*sizeof(unsigned), sizeof(double));
+        }
+    }
+    else
+    {
+        std::vector<double> element_attributes;
+        GetNextItemFromStream(mElementsFile, mElementsRead, element_data.NodeIndices, mNumElementAttributes, element_attributes);
+
+        if (mNumElementAttributes > 0)
+        {
+            element_data.AttributeValue = element_attributes[0];///only one element attribute registered for the moment
+        }
     }
 
     EnsureIndexingFromZero(element_data.NodeIndices);
@@ -376,16 +392,19 @@ ElementData TrianglesMeshReader<ELEMENT_DIM, SPACE_DIM>::GetElementData(unsigned
         EXCEPTION("Element " << index << " does not exist - not enough elements (only " << mNumElements << ").");
     }
 
-    // Put the file stream pointer to the right location
-    if (index > mElementsRead)
-    {
-        // This is a monotonic (but non-contiguous) read.  Let's assume that it's more efficient
-        // to seek from the current position rather than from the start of the file
-        mElementsFile.seekg( mElementItemWidth*(index-mElementsRead), std::ios_base::cur);
-    }
-    else if (mElementsRead != index)
+    // Put the file stream pointer to the right location (not needed if the file is mapped into memory)
+    if (!mElementsFileMapping.IsOpen())
     {
-        mElementsFile.seekg(mElementFileDataStart + mElementItemWidth*index, std::ios_base::beg);
+        if (index > mElementsRead)
+        {
+            // This is a monotonic (but non-contiguous) read.  Let's assume that it's more efficient
+            // to seek from the current position rather than from the start of the file
+            mElementsFile.seekg( mElementItemWidth*(index-mElementsRead), std::ios_base::cur);
+        }
+        else if (mElementsRead != index)
+        {
+            mElementsFile.seekg(mElementFileDataStart + mElementItemWidth*index, std::ios_base::beg);
+        }
     }
 
     mElementsRead = index; // Allow GetNextElementData() to note the position of the item after this one
@@ -534,6 +553,7 @@ void TrianglesMeshReader<ELEMENT_DIM, SPACE_DIM>::OpenElementsFile()
     {
         EXCEPTION("Could not open data file: " + file_name);
     }
+    mElementsFileName = file_name;
 }
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
@@ -716,6 +736,17 @@ void TrianglesMeshReader<ELEMENT_DIM, SPACE_DIM>::ReadHeaders()
     {
         mElementFileDataStart = mElementsFile.tellg(); // Record the position of the first byte after the header.
         mElementItemWidth = mNodesPerElement*sizeof(unsigned) +  extra_attributes*sizeof(double);
+
+        // Map the element data into memory for fast random access, if we can.  If the file is
+        // shorter than the header says, fall back to the stream so that reads fail as before.
+        if (mElementsFileMapping.Open(mElementsFileName))
+        {
+            std::size_t data_end = std::size_t(mElementFileDataStart) + std::size_t(mElementItemWidth)*mNumElements;
+            if (mElementsFileMapping.GetSize() < data_end)
+            {
+                mElementsFileMapping.Close();
+            }
+        }
     }
 
     /*
@@ -832,6 +863,7 @@ void TrianglesMeshReader<ELEMENT_DIM, SPACE_DIM>::CloseFiles()
 {
     mNodesFile.close();
     mElementsFile.close();
+    mElementsFileMapping.Close();
     mFacesFile.close();
     mNclFile.close();
     mCableElementsFile.close();
@@ -998,6 +1030,12 @@ bool TrianglesMeshReader<ELEMENT_DIM, SPACE_DIM>::HasNclFile()
     return mNclFileAvailable;
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool TrianglesMeshReader<ELEMENT_DIM, SPACE_DIM>::IsElementsFileMemoryMapped() const
+{
+    return mElementsFileMapping.IsOpen();
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void TrianglesMeshReader<ELEMENT_DIM, SPACE_DIM>::SetReadBufferSize(unsigned bufferSize)
 {
@@ -41,6 +41,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <string>
 #include <fstream>
 #include "AbstractMeshReader.hpp"
+#include "MemoryMappedFile.hpp"
 
 /**
  * Concrete version of the AbstractCachedMeshReader class.
@@ -65,6 +66,13 @@ private:
     std::ifstream mFacesFile;       /**< The faces (edges) file for the mesh. */
     std::ifstream mNclFile;         /**< The node connectivity list file for the mesh. */
     std::ifstream mCableElementsFile; /**< The elements file for the mesh. */
+    std::string mElementsFileName;  /**< The path of the elements file for the mesh. */
+
+    /**
+     * The elements file mapped into memory, if it is binary and mapping is supported.
+     * When mapped, element data are read directly from memory rather than through #mElementsFile.
+     */
+    MemoryMappedFile mElementsFileMapping;
 
     std::streampos mNodeFileDataStart; /**< The start of the binary data*/
     std::streamoff mNodeItemWidth;  /**< The number of bytes in a line of the node file*/
@@ -251,6 +259,12 @@ public:
     /*** @return true if reading binary files, false if reading ascii files */
     bool IsFileFormatBinary();
 
+    /**
+     * @return true if element data are being read from a memory-mapped binary elements file.
+     * This is the case for binary files on platforms supporting memory mapping.
+     */
+    bool IsElementsFileMemoryMapped() const;
+
     /**
      * @return true if there is a node connectivity list (NCL) file available.
      *
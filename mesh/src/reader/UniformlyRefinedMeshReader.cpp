@@ -0,0 +1,412 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "UniformlyRefinedMeshReader.hpp"
+
+#include <algorithm>
+#include <cfloat>
+
+#include "Exception.hpp"
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+UniformlyRefinedMeshReader<ELEMENT_DIM, SPACE_DIM>::UniformlyRefinedMeshReader(AbstractMeshReader<ELEMENT_DIM, SPACE_DIM>& rCoarseReader)
+    : mNumElementAttributes(rCoarseReader.GetNumElementAttributes()),
+      mNumFaceAttributes(rCoarseReader.GetNumFaceAttributes()),
+      mNumCoarseElementsPerParentElement(rCoarseReader.GetNumElementsPerParentElement()),
+      mNodesRead(0),
+      mElementsRead(0),
+      mFacesRead(0)
+{
+    if (rCoarseReader.GetOrderOfElements() != 1 || rCoarseReader.GetOrderOfBoundaryElements() != 1)
+    {
+        EXCEPTION("Only linear meshes can be uniformly refined.");
+    }
+
+    rCoarseReader.Reset();
+
+    const unsigned num_nodes = rCoarseReader.GetNumNodes();
+    mCoarseNodes.reserve(num_nodes);
+    mCoarseNodeAttributes.reserve(num_nodes);
+    for (unsigned i=0; i<num_nodes; i++)
+    {
+        mCoarseNodes.push_back(rCoarseReader.GetNextNode());
+        mCoarseNodeAttributes.push_back(rCoarseReader.GetNodeAttributes());
+    }
+
+    const unsigned num_elements = rCoarseReader.GetNumElements();
+    mCoarseElements.reserve(num_elements);
+    for (unsigned i=0; i<num_elements; i++)
+    {
+        mCoarseElements.push_back(rCoarseReader.GetNextElementData());
+    }
+
+    const unsigned num_faces = rCoarseReader.GetNumFaces();
+    mCoarseFaces.reserve(num_faces);
+    for (unsigned i=0; i<num_faces; i++)
+    {
+        mCoarseFaces.push_back(rCoarseReader.GetNextFaceData());
+    }
+
+    // Every pair of nodes in an element is an edge; the sorted list numbers the new nodes
+    mEdges.reserve(num_elements*ELEMENT_DIM*(ELEMENT_DIM+1)/2);
+    for (unsigned i=0; i<num_elements; i++)
+    {
+        const std::vector<unsigned>& r_nodes = mCoarseElements[i].NodeIndices;
+        for (unsigned a=0; a<r_nodes.size(); a++)
+        {
+            for (unsigned b=a+1; b<r_nodes.size(); b++)
+            {
+                mEdges.push_back(std::make_pair(std::min(r_nodes[a], r_nodes[b]), std::max(r_nodes[a], r_nodes[b])));
+            }
+        }
+    }
+    std::sort(mEdges.begin(), mEdges.end());
+    mEdges.erase(std::unique(mEdges.begin(), mEdges.end()), mEdges.end());
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+UniformlyRefinedMeshReader<ELEMENT_DIM, SPACE_DIM>::~UniformlyRefinedMeshReader()
+{
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned UniformlyRefinedMeshReader<ELEMENT_DIM, SPACE_DIM>::GetMidpointIndex(unsigned nodeA, unsigned nodeB) const
+{
+    std::pair<unsigned, unsigned> edge(std::min(nodeA, nodeB), std::max(nodeA, nodeB));
+    std::vector<std::pair<unsigned, unsigned> >::const_iterator it = std::lower_bound(mEdges.begin(), mEdges.end(), edge);
+    if (it == mEdges.end() || *it != edge)
+    {
+        EXCEPTION("Nodes " << edge.first << " and " << edge.second << " of a boundary element are not joined by an edge of any element.");
+    }
+    return mCoarseNodes.size() + (it - mEdges.begin());
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+std::vector<double> UniformlyRefinedMeshReader<ELEMENT_DIM, SPACE_DIM>::GetFineNodeLocation(unsigned index) const
+{
+    if (index < mCoarseNodes.size())
+    {
+        return mCoarseNodes[index];
+    }
+    const std::pair<unsigned, unsigned>& r_edge = mEdges[index - mCoarseNodes.size()];
+    std::vector<double> location(mCoarseNodes[r_edge.first]);
+    for (unsigned i=0; i<location.size(); i++)
+    {
+        location[i] = 0.5*(location[i] + mCoarseNodes[r_edge.second][i]);
+    }
+    return location;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+double UniformlyRefinedMeshReader<ELEMENT_DIM, SPACE_DIM>::CalculateSignedVolume(const std::vector<unsigned>& rNodes) const
+{
+    assert(rNodes.size() == SPACE_DIM+1);
+    std::vector<double> origin = GetFineNodeLocation(rNodes[0]);
+    std::vector<std::vector<double> > edges;
+    for (unsigned i=1; i<rNodes.size(); i++)
+    {
+        std::vector<double> edge = GetFineNodeLocation(rNodes[i]);
+        for (unsigned j=0; j<SPACE_DIM; j++)
+        {
+            edge[j] -= origin[j];
+        }
+        edges.push_back(edge);
+    }
+
+    switch (SPACE_DIM)
+    {
+        case 1:
+            return edges[0][0];
+        case 2:
+            return edges[0][0]*edges[1][1] - edges[0][1]*edges[1][0];
+        default:
+            return edges[0][0]*(edges[1][1]*edges[2][2] - edges[1][2]*edges[2][1])
+                 - edges[0][1]*(edges[1][0]*edges[2][2] - edges[1][2]*edges[2][0])
+                 + edges[0][2]*(edges[1][0]*edges[2][1] - edges[1][1]*edges[2][0]);
+    }
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+std::vector<std::vector<unsigned> > UniformlyRefinedMeshReader<ELEMENT_DIM, SPACE_DIM>::RefineSimplex(const std::vector<unsigned>& rNodes) const
+{
+    std::vector<std::vector<unsigned> > children;
+    switch (rNodes.size())
+    {
+        case 1:
+        {
+            children.push_back(rNodes);
+            break;
+        }
+        case 2:
+        {
+            const unsigned a = rNodes[0], b = rNodes[1];
+            const unsigned m = GetMidpointIndex(a, b);
+            const unsigned c0[] = {a, m}, c1[] = {m, b};
+            children.push_back(std::vector<unsigned>(c0, c0+2));
+            children.push_back(std::vector<unsigned>(c1, c1+2));
+            break;
+        }
+        case 3:
+        {
+            const unsigned a = rNodes[0], b = rNodes[1], c = rNodes[2];
+            const unsigned m_ab = GetMidpointIndex(a, b);
+            const unsigned m_bc = GetMidpointIndex(b, c);
+            const unsigned m_ca = GetMidpointIndex(c, a);
+            const unsigned c0[] = {a, m_ab, m_ca}, c1[] = {m_ab, b, m_bc}, c2[] = {m_ca, m_bc, c}, c3[] = {m_ab, m_bc, m_ca};
+            children.push_back(std::vector<unsigned>(c0, c0+3));
+            children.push_back(std::vector<unsigned>(c1, c1+3));
+            children.push_back(std::vector<unsigned>(c2, c2+3));
+            children.push_back(std::vector<unsigned>(c3, c3+3));
+            break;
+        }
+        default:
+        {
+            assert(rNodes.size() == 4);
+            const unsigned n0 = rNodes[0], n1 = rNodes[1], n2 = rNodes[2], n3 = rNodes[3];
+            const unsigned m01 = GetMidpointIndex(n0, n1);
+            const unsigned m02 = GetMidpointIndex(n0, n2);
+            const unsigned m03 = GetMidpointIndex(n0, n3);
+            const unsigned m12 = GetMidpointIndex(n1, n2);
+            const unsigned m13 = GetMidpointIndex(n1, n3);
+            const unsigned m23 = GetMidpointIndex(n2, n3);
+
+            // Corner tetrahedra
+            const unsigned c0[] = {n0, m01, m02, m03}, c1[] = {m01, n1, m12, m13}, c2[] = {m02, m12, n2, m23}, c3[] = {m03, m13, m23, n3};
+            children.push_back(std::vector<unsigned>(c0, c0+4));
+            children.push_back(std::vector<unsigned>(c1, c1+4));
+            children.push_back(std::vector<unsigned>(c2, c2+4));
+            children.push_back(std::vector<unsigned>(c3, c3+4));
+
+            /*
+             * The inner octahedron is cut into four round its shortest diagonal, which gives
+             * the best shaped children. Each diagonal joins the midpoints of opposite edges,
+             * and the other four midpoints form a cycle round it.
+             */
+            const unsigned diagonals[3][2] = {{m01, m23}, {m02, m13}, {m03, m12}};
+            const unsigned cycles[3][4] = {{m02, m03, m13, m12}, {m01, m12, m23, m03}, {m01, m02, m23, m13}};
+            unsigned shortest = 0;
+            double shortest_length = DBL_MAX;
+            for (unsigned d=0; d<3; d++)
+            {
+                std::vector<double> end_a = GetFineNodeLocation(diagonals[d][0]);
+                std::vector<double> end_b = GetFineNodeLocation(diagonals[d][1]);
+                double length = 0.0;
+                for (unsigned j=0; j<end_a.size(); j++)
+                {
+                    length += (end_a[j] - end_b[j])*(end_a[j] - end_b[j]);
+                }
+                if (length < shortest_length)
+                {
+                    shortest_length = length;
+                    shortest = d;
+                }
+            }
+            for (unsigned i=0; i<4; i++)
+            {
+                const unsigned c[] = {diagonals[shortest][0], diagonals[shortest][1], cycles[shortest][i], cycles[shortest][(i+1)%4]};
+                children.push_back(std::vector<unsigned>(c, c+4));
+            }
+            break;
+        }
+    }
+    return children;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+ElementData UniformlyRefinedMeshReader<ELEMENT_DIM, SPACE_DIM>::GetChildData(const ElementData& rParent, unsigned childIndex, bool checkOrientation) const
+{
+    ElementData child;
+    child.NodeIndices = RefineSimplex(rParent.NodeIndices)[childIndex];
+    child.AttributeValue = rParent.AttributeValue;
+
+    if (checkOrientation)
+    {
+        // Children of the inner octahedron of a tetrahedron may need turning over
+        if ((CalculateSignedVolume(child.NodeIndices) > 0.0) != (CalculateSignedVolume(rParent.NodeIndices) > 0.0))
+        {
+            std::swap(child.NodeIndices[SPACE_DIM-1], child.NodeIndices[SPACE_DIM]);
+        }
+    }
+    return child;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned UniformlyRefinedMeshReader<ELEMENT_DIM, SPACE_DIM>::GetNumElements() const
+{
+    return mCoarseElements.size()*GetNumChildrenPerElement();
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned UniformlyRefinedMeshReader<ELEMENT_DIM, SPACE_DIM>::GetNumNodes() const
+{
+    return mCoarseNodes.size() + mEdges.size();
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned UniformlyRefinedMeshReader<ELEMENT_DIM, SPACE_DIM>::GetNumFaces() const
+{
+    // A boundary element has ELEMENT_DIM nodes and so 2^(ELEMENT_DIM-1) children
+    return mCoarseFaces.size()*(1u << (ELEMENT_DIM-1));
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned UniformlyRefinedMeshReader<ELEMENT_DIM, SPACE_DIM>::GetNumElementAttributes() const
+{
+    return mNumElementAttributes;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned UniformlyRefinedMeshReader<ELEMENT_DIM, SPACE_DIM>::GetNumFaceAttributes() const
+{
+    return mNumFaceAttributes;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned UniformlyRefinedMeshReader<ELEMENT_DIM, SPACE_DIM>::GetNumChildrenPerElement() const
+{
+    return 1u << ELEMENT_DIM;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned UniformlyRefinedMeshReader<ELEMENT_DIM, SPACE_DIM>::GetParentElementIndex(unsigned fineElementIndex) const
+{
+    return fineElementIndex/GetNumChildrenPerElement();
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned UniformlyRefinedMeshReader<ELEMENT_DIM, SPACE_DIM>::GetNumElementsPerParentElement()
+{
+    return mNumCoarseElementsPerParentElement*GetNumChildrenPerElement();
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+std::vector<double> UniformlyRefinedMeshReader<ELEMENT_DIM, SPACE_DIM>::GetNodeAttributes()
+{
+    return mNodeAttributes;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+std::vector<double> UniformlyRefinedMeshReader<ELEMENT_DIM, SPACE_DIM>::GetNextNode()
+{
+    return GetNode(mNodesRead);
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void UniformlyRefinedMeshReader<ELEMENT_DIM, SPACE_DIM>::Reset()
+{
+    mNodesRead = 0;
+    mElementsRead = 0;
+    mFacesRead = 0;
+    mNodeAttributes.clear();
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+ElementData UniformlyRefinedMeshReader<ELEMENT_DIM, SPACE_DIM>::GetNextElementData()
+{
+    return GetElementData(mElementsRead);
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+ElementData UniformlyRefinedMeshReader<ELEMENT_DIM, SPACE_DIM>::GetNextFaceData()
+{
+    return GetFaceData(mFacesRead);
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+std::vector<double> UniformlyRefinedMeshReader<ELEMENT_DIM, SPACE_DIM>::GetNode(unsigned index)
+{
+    if (index >= GetNumNodes())
+    {
+        EXCEPTION("Node does not exist - not enough nodes.");
+    }
+    mNodesRead = index + 1;
+
+    if (index < mCoarseNodes.size())
+    {
+        mNodeAttributes = mCoarseNodeAttributes[index];
+    }
+    else
+    {
+        const std::pair<unsigned, unsigned>& r_edge = mEdges[index - mCoarseNodes.size()];
+        const std::vector<double>& r_attributes_a = mCoarseNodeAttributes[r_edge.first];
+        const std::vector<double>& r_attributes_b = mCoarseNodeAttributes[r_edge.second];
+        mNodeAttributes = r_attributes_a;
+        for (unsigned i=0; i<mNodeAttributes.size() && i<r_attributes_b.size(); i++)
+        {
+            mNodeAttributes[i] = 0.5*(r_attributes_a[i] + r_attributes_b[i]);
+        }
+    }
+    return GetFineNodeLocation(index);
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+ElementData UniformlyRefinedMeshReader<ELEMENT_DIM, SPACE_DIM>::GetElementData(unsigned index)
+{
+    if (index >= GetNumElements())
+    {
+        EXCEPTION("Element " << index << " does not exist - not enough elements (only " << GetNumElements() << ").");
+    }
+    mElementsRead = index + 1;
+
+    const unsigned num_children = GetNumChildrenPerElement();
+    return GetChildData(mCoarseElements[index/num_children], index%num_children, ELEMENT_DIM == SPACE_DIM);
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+ElementData UniformlyRefinedMeshReader<ELEMENT_DIM, SPACE_DIM>::GetFaceData(unsigned index)
+{
+    if (index >= GetNumFaces())
+    {
+        EXCEPTION("Face does not exist - not enough faces.");
+    }
+    mFacesRead = index + 1;
+
+    const unsigned num_children = 1u << (ELEMENT_DIM-1);
+    return GetChildData(mCoarseFaces[index/num_children], index%num_children, false);
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool UniformlyRefinedMeshReader<ELEMENT_DIM, SPACE_DIM>::IsFileFormatBinary()
+{
+    return true;
+}
+
+// Explicit instantiation
+template class UniformlyRefinedMeshReader<1,1>;
+template class UniformlyRefinedMeshReader<1,2>;
+template class UniformlyRefinedMeshReader<1,3>;
+template class UniformlyRefinedMeshReader<2,2>;
+template class UniformlyRefinedMeshReader<2,3>;
+template class UniformlyRefinedMeshReader<3,3>;
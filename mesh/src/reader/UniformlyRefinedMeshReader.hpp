@@ -0,0 +1,235 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef UNIFORMLYREFINEDMESHREADER_HPP_
+#define UNIFORMLYREFINEDMESHREADER_HPP_
+
+#include <utility>
+#include <vector>
+
+#include "AbstractMeshReader.hpp"
+
+/**
+ * A mesh reader which reads a coarse linear mesh from another reader and presents it
+ * uniformly refined once: every edge is split at its midpoint, so each element becomes
+ * 2^ELEMENT_DIM elements (tetrahedra are cut through the shortest diagonal of their
+ * inner octahedron) and each boundary element is refined to match.
+ *
+ * The refinement is done in memory when the reader is constructed, and numbering depends
+ * only on the coarse mesh, so every process that refines the same coarse mesh sees the same
+ * fine mesh.  Fine nodes are the coarse nodes followed by one node per coarse edge; fine
+ * element i is a child of coarse element GetParentElementIndex(i) and inherits its attribute,
+ * as do boundary elements.  Node attributes of new nodes are the average of those at the ends
+ * of their edge.
+ *
+ * Random access is supported, so a DistributedTetrahedralMesh constructed from this reader
+ * partitions the fine mesh and only keeps its own part of it (plus the coarse mesh held here).
+ * As with binary mesh files, a DistributedTetrahedralMesh does not take node attributes from
+ * random access readers, so node attributes are only passed on to a TetrahedralMesh.
+ * Readers can be chained to refine more than once, by passing a refined reader to the
+ * constructor as an AbstractMeshReader reference (otherwise it would be copied).
+ *
+ * Typical use:
+ *     TrianglesMeshReader<3,3> coarse_reader("mesh/test/data/cube_136_elements");
+ *     UniformlyRefinedMeshReader<3,3> fine_reader(coarse_reader);
+ *     DistributedTetrahedralMesh<3,3> mesh;
+ *     mesh.ConstructFromMeshReader(fine_reader);
+ */
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+class UniformlyRefinedMeshReader : public AbstractMeshReader<ELEMENT_DIM, SPACE_DIM>
+{
+private:
+
+    /** Coordinates of each coarse node. */
+    std::vector<std::vector<double> > mCoarseNodes;
+
+    /** Attributes of each coarse node (empty vectors if there are none). */
+    std::vector<std::vector<double> > mCoarseNodeAttributes;
+
+    /** Each coarse element. */
+    std::vector<ElementData> mCoarseElements;
+
+    /** Each coarse boundary element. */
+    std::vector<ElementData> mCoarseFaces;
+
+    /** Each coarse edge as (lower node index, higher node index), sorted. */
+    std::vector<std::pair<unsigned, unsigned> > mEdges;
+
+    /** Number of attributes on each element (copied from the coarse reader). */
+    unsigned mNumElementAttributes;
+
+    /** Number of attributes on each face (copied from the coarse reader). */
+    unsigned mNumFaceAttributes;
+
+    /** GetNumElementsPerParentElement() of the coarse reader. */
+    unsigned mNumCoarseElementsPerParentElement;
+
+    /** Index of the next node returned by GetNextNode(). */
+    unsigned mNodesRead;
+
+    /** Index of the next element returned by GetNextElementData(). */
+    unsigned mElementsRead;
+
+    /** Index of the next face returned by GetNextFaceData(). */
+    unsigned mFacesRead;
+
+    /** Attributes of the node most recently returned. */
+    std::vector<double> mNodeAttributes;
+
+    /**
+     * @return the index of the fine node at the middle of a coarse edge
+     *
+     * @param nodeA  the (coarse) index of one end of the edge
+     * @param nodeB  the (coarse) index of the other end of the edge
+     */
+    unsigned GetMidpointIndex(unsigned nodeA, unsigned nodeB) const;
+
+    /**
+     * @return the location of a fine node
+     *
+     * @param index  the index of the fine node
+     */
+    std::vector<double> GetFineNodeLocation(unsigned index) const;
+
+    /**
+     * @return the signed volume (up to a constant factor) of a simplex with SPACE_DIM+1 fine nodes
+     *
+     * @param rNodes  the fine node indices of the simplex
+     */
+    double CalculateSignedVolume(const std::vector<unsigned>& rNodes) const;
+
+    /**
+     * @return the fine node indices of the children of a coarse simplex, in order.
+     * A simplex with n nodes has 2^(n-1) children.
+     *
+     * @param rNodes  the coarse node indices of the simplex
+     */
+    std::vector<std::vector<unsigned> > RefineSimplex(const std::vector<unsigned>& rNodes) const;
+
+    /**
+     * @return the data for one child of a coarse element or face
+     *
+     * @param rParent  the coarse element or face
+     * @param childIndex  which child
+     * @param checkOrientation  whether to give the child the same orientation as its parent
+     */
+    ElementData GetChildData(const ElementData& rParent, unsigned childIndex, bool checkOrientation) const;
+
+public:
+
+    /**
+     * Constructor.  Reads the whole of the coarse mesh and refines it.
+     *
+     * @param rCoarseReader  reader for a linear mesh; it is not used after construction
+     */
+    UniformlyRefinedMeshReader(AbstractMeshReader<ELEMENT_DIM, SPACE_DIM>& rCoarseReader);
+
+    /**
+     * Destructor
+     */
+    virtual ~UniformlyRefinedMeshReader();
+
+    /** @return the number of elements in the fine mesh */
+    unsigned GetNumElements() const;
+
+    /** @return the number of nodes in the fine mesh */
+    unsigned GetNumNodes() const;
+
+    /** @return the number of boundary elements in the fine mesh */
+    unsigned GetNumFaces() const;
+
+    /** @return the number of attributes on each element */
+    unsigned GetNumElementAttributes() const;
+
+    /** @return the number of attributes on each boundary element */
+    unsigned GetNumFaceAttributes() const;
+
+    /** @return the number of fine elements made from each coarse element */
+    unsigned GetNumChildrenPerElement() const;
+
+    /**
+     * @return the index of the coarse element that a fine element came from
+     *
+     * @param fineElementIndex  the index of the fine element
+     */
+    unsigned GetParentElementIndex(unsigned fineElementIndex) const;
+
+    /** @return the number of elements made from each element of the original mesh */
+    unsigned GetNumElementsPerParentElement();
+
+    /** @return the attributes of the node most recently returned */
+    std::vector<double> GetNodeAttributes();
+
+    /** @return the coordinates of the next node */
+    std::vector<double> GetNextNode();
+
+    /** Go back to the start of the nodes, elements and faces. */
+    void Reset();
+
+    /** @return the next element */
+    ElementData GetNextElementData();
+
+    /** @return the next boundary element */
+    ElementData GetNextFaceData();
+
+    /**
+     * @return the coordinates of a node
+     *
+     * @param index  the index of the node
+     */
+    std::vector<double> GetNode(unsigned index);
+
+    /**
+     * @return an element
+     *
+     * @param index  the index of the element
+     */
+    ElementData GetElementData(unsigned index);
+
+    /**
+     * @return a boundary element
+     *
+     * @param index  the index of the boundary element
+     */
+    ElementData GetFaceData(unsigned index);
+
+    /**
+     * @return true, since the refined mesh is held in memory and can be read in any order.
+     * This is what makes DistributedTetrahedralMesh use random access.
+     */
+    bool IsFileFormatBinary();
+};
+
+#endif /*UNIFORMLYREFINEDMESHREADER_HPP_*/
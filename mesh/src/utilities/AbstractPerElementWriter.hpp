@@ -35,7 +35,9 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef ABSTRACTPERELEMENTWRITER_HPP_
 #define ABSTRACTPERELEMENTWRITER_HPP_
 
+#include <vector>
 #include "AbstractTetrahedralMesh.hpp"
+#include "PetscTools.hpp"
 #include "UblasCustomFunctions.hpp"
 #include "OutputFileHandler.hpp"
 #include "Version.hpp"
@@ -43,7 +45,8 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 /**
  * An abstract writer class for writing stuff on a "per element" basis.
  * This class will "visit" all the locally owned elements and concentrate
- * data back to the master.
+ * data back to the master, or (for binary files) write each process's data
+ * straight into its place in the file.
  */
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned DATA_SIZE>
 class AbstractPerElementWriter
@@ -51,6 +54,76 @@ class AbstractPerElementWriter
 private:
     bool mFileIsBinary;  /**< Whether all data is to be written as binary*/
 
+    /**
+     * Write a binary file collectively: the master writes the header and footer, and every
+     * process writes the data for the elements it is the designated owner of at their place
+     * in the file (in global element index order) using MPI-IO. No process holds more than
+     * its own elements' data.
+     *
+     * @param rHandler  specify the directory in which to place the output file
+     * @param rFileName  the file name
+     */
+    void WriteBinaryDataCollectively(OutputFileHandler& rHandler, const std::string& rFileName)
+    {
+        // The master writes the header as usual and tells everyone how long it is
+        unsigned header_size = 0u;
+        if (PetscTools::AmMaster())
+        {
+            mpMasterFile = rHandler.OpenOutputFile(rFileName);
+            WriteHeaderOnMaster();
+            *mpMasterFile << "\tBIN\n";
+            header_size = mpMasterFile->tellp();
+            mpMasterFile->close();
+        }
+        MPI_Bcast(&header_size, 1, MPI_UNSIGNED, 0, PetscTools::GetWorld());
+
+        // Visit our elements (the element iterator goes in increasing global index order)
+        std::vector<int> displacements;
+        std::vector<double> local_data;
+        c_vector<double, DATA_SIZE> data;
+        unsigned local_index = 0u;
+        for (typename AbstractTetrahedralMesh<ELEMENT_DIM,SPACE_DIM>::ElementIterator iter = mpMesh->GetElementIteratorBegin();
+             iter != mpMesh->GetElementIteratorEnd();
+             ++iter, local_index++)
+        {
+            unsigned element_index = iter->GetIndex();
+            if (mpMesh->CalculateDesignatedOwnershipOfElement(element_index))
+            {
+                assert(displacements.empty() || (int)element_index > displacements.back());
+                Visit(&(*iter), local_index, data);
+                displacements.push_back(element_index);
+                local_data.insert(local_data.end(), data.begin(), data.end());
+            }
+        }
+
+        std::string file_path = rHandler.GetOutputDirectoryFullPath() + rFileName;
+        MPI_File file;
+        MPI_File_open(PetscTools::GetWorld(), const_cast<char*>(file_path.c_str()), MPI_MODE_WRONLY, MPI_INFO_NULL, &file);
+
+        // Each process sees only its own elements in the file (the binary file is row-major)
+        MPI_Datatype item_type;
+        MPI_Type_contiguous(DATA_SIZE, MPI_DOUBLE, &item_type);
+        MPI_Type_commit(&item_type);
+        MPI_Datatype file_type;
+        MPI_Type_create_indexed_block(displacements.size(), 1, displacements.empty() ? nullptr : &displacements[0], item_type, &file_type);
+        MPI_Type_commit(&file_type);
+
+        MPI_File_set_view(file, header_size, item_type, file_type, const_cast<char*>("native"), MPI_INFO_NULL);
+        MPI_File_write_all(file, local_data.empty() ? nullptr : &local_data[0], displacements.size(), item_type, MPI_STATUS_IGNORE);
+        MPI_File_set_view(file, 0, MPI_BYTE, MPI_BYTE, const_cast<char*>("native"), MPI_INFO_NULL);
+
+        if (PetscTools::AmMaster())
+        {
+            std::string footer = "# " + ChasteBuildInfo::GetProvenanceString();
+            MPI_Offset footer_offset = header_size + (MPI_Offset)mpMesh->GetNumElements()*DATA_SIZE*sizeof(double);
+            MPI_File_write_at(file, footer_offset, const_cast<char*>(footer.c_str()), footer.size(), MPI_CHAR, MPI_STATUS_IGNORE);
+        }
+
+        MPI_File_close(&file);
+        MPI_Type_free(&file_type);
+        MPI_Type_free(&item_type);
+    }
+
 protected:
     /**
      * The mesh. Set by the constructor.
@@ -140,6 +213,8 @@ public:
      * Data about each element is retrieved by the Visit() method.
      * Writing is done by the master process using the WriteElement() method.
      * Any element not owned by the master is communicated by the unique designated owner.
+     * Binary files are instead written collectively by all processes (so WriteElementOnMaster()
+     * is not used for them).
      *
      * MUST BE CALLED IN PARALLEL.
      *
@@ -150,6 +225,12 @@ public:
     {
         PreWriteCalculations(rHandler);
 
+        if (mFileIsBinary)
+        {
+            WriteBinaryDataCollectively(rHandler, rFileName);
+            return;
+        }
+
         c_vector<double, DATA_SIZE> data;
         if (PetscTools::AmMaster())
         {
@@ -190,7 +271,7 @@ public:
                 else
                 {
                     //Data must come from a remote process
-                    MPI_Recv(&data[0], DATA_SIZE, MPI_DOUBLE, MPI_ANY_SOURCE, global_element_index, PETSC_COMM_WORLD, &status);
+                    MPI_Recv(&data[0], DATA_SIZE, MPI_DOUBLE, MPI_ANY_SOURCE, global_element_index, PetscTools::GetWorld(), &status);
                 }
                 WriteElementOnMaster(data);
             }
@@ -218,7 +299,7 @@ public:
                     // The master needs to know about this one.
                     Visit(&(*iter), local_index, data);
                     /// \todo See if this can be speeded up with #2351.
-                    MPI_Ssend(&data[0], DATA_SIZE, MPI_DOUBLE, 0, element_index, PETSC_COMM_WORLD);//Tag with element_index
+                    MPI_Ssend(&data[0], DATA_SIZE, MPI_DOUBLE, 0, element_index, PetscTools::GetWorld());//Tag with element_index
                 }
             }
 
@@ -72,6 +72,18 @@ std::set< Element<DIM,DIM>* >& Box<DIM>::rGetElementsContained()
     return mElementsContained;
 }
 
+template <unsigned DIM>
+const std::set< Node<DIM>* >& Box<DIM>::rGetNodesContained() const
+{
+    return mNodesContained;
+}
+
+template <unsigned DIM>
+const std::set< Element<DIM,DIM>* >& Box<DIM>::rGetElementsContained() const
+{
+    return mElementsContained;
+}
+
 ///////// Explicit instantiation///////
 
 template class Box<1>;
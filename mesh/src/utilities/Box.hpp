@@ -87,6 +87,12 @@ public:
 
     /** @return all the elements in this box. */
     std::set< Element<DIM,DIM>* >& rGetElementsContained();
+
+    /** @return all the nodes in this box (const version). */
+    const std::set< Node<DIM>* >& rGetNodesContained() const;
+
+    /** @return all the elements in this box (const version). */
+    const std::set< Element<DIM,DIM>* >& rGetElementsContained() const;
 };
 
 #endif /*BOX_HPP_*/
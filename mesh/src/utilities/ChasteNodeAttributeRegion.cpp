@@ -0,0 +1,82 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "ChasteNodeAttributeRegion.hpp"
+#include "Exception.hpp"
+
+template <unsigned SPACE_DIM>
+ChasteNodeAttributeRegion<SPACE_DIM>::ChasteNodeAttributeRegion(unsigned attributeIndex, double attributeValue)
+    : mAttributeIndex(attributeIndex),
+      mAttributeValue(attributeValue)
+{
+}
+
+template <unsigned SPACE_DIM>
+bool ChasteNodeAttributeRegion<SPACE_DIM>::DoesContain(const ChastePoint<SPACE_DIM>& rPointToCheck) const
+{
+    EXCEPTION("A region defined by node attributes can only check whether it contains nodes, not points.");
+}
+
+template <unsigned SPACE_DIM>
+bool ChasteNodeAttributeRegion<SPACE_DIM>::DoesContainNode(Node<SPACE_DIM>* pNode) const
+{
+    if (pNode->GetNumNodeAttributes() <= mAttributeIndex)
+    {
+        return false;
+    }
+    return pNode->rGetNodeAttributes()[mAttributeIndex] == mAttributeValue;
+}
+
+template <unsigned SPACE_DIM>
+unsigned ChasteNodeAttributeRegion<SPACE_DIM>::GetAttributeIndex() const
+{
+    return mAttributeIndex;
+}
+
+template <unsigned SPACE_DIM>
+double ChasteNodeAttributeRegion<SPACE_DIM>::GetAttributeValue() const
+{
+    return mAttributeValue;
+}
+
+///////// Explicit instantiation///////
+
+template class ChasteNodeAttributeRegion<1>;
+template class ChasteNodeAttributeRegion<2>;
+template class ChasteNodeAttributeRegion<3>;
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapperForCpp.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(ChasteNodeAttributeRegion)
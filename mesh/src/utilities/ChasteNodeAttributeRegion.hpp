@@ -0,0 +1,147 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef CHASTENODEATTRIBUTEREGION_HPP_
+#define CHASTENODEATTRIBUTEREGION_HPP_
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+
+#include "AbstractChasteRegion.hpp"
+#include "ChastePoint.hpp"
+#include "Node.hpp"
+
+/**
+ * This class defines a region as the mesh nodes with a given value of one of their
+ * attributes (as read from a mesh's .node file, for example), so that a labelled mesh
+ * can be split into regions without any geometric tests.
+ *
+ * Since the region is defined by node attributes, it can only check nodes (with
+ * DoesContainNode()), not arbitrary points.
+ */
+template <unsigned SPACE_DIM>
+class ChasteNodeAttributeRegion : public AbstractChasteRegion<SPACE_DIM>
+{
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Archive the member variables.
+     *
+     * @param archive
+     * @param version
+     */
+    template <class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<AbstractChasteRegion<SPACE_DIM> >(*this);
+    }
+
+private:
+    /** Which of the node attributes defines the region. */
+    unsigned mAttributeIndex;
+
+    /** The value of that attribute at nodes in the region. */
+    double mAttributeValue;
+
+public:
+    /**
+     * Constructor.
+     *
+     * @param attributeIndex  which of the node attributes defines the region
+     * @param attributeValue  the value of that attribute at nodes in the region
+     */
+    ChasteNodeAttributeRegion(unsigned attributeIndex, double attributeValue);
+
+    /**
+     * Throws, since the region is only defined at nodes.
+     *
+     * @param rPointToCheck Point to be checked to be contained in the region.
+     * @return never returns
+     */
+    bool DoesContain(const ChastePoint<SPACE_DIM>& rPointToCheck) const;
+
+    /**
+     * @return true if the node has the region's attribute value. Nodes with too few
+     * attributes are not in the region.
+     *
+     * @param pNode  the node to be checked
+     */
+    bool DoesContainNode(Node<SPACE_DIM>* pNode) const;
+
+    /** @return which of the node attributes defines the region */
+    unsigned GetAttributeIndex() const;
+
+    /** @return the value of that attribute at nodes in the region */
+    double GetAttributeValue() const;
+};
+
+// Declare identifier for the serializer
+#include "SerializationExportWrapper.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(ChasteNodeAttributeRegion)
+
+namespace boost
+{
+namespace serialization
+{
+
+template <class Archive, unsigned SPACE_DIM>
+inline void save_construct_data(
+    Archive & ar, const ChasteNodeAttributeRegion<SPACE_DIM> * t, const unsigned int file_version)
+{
+    unsigned attribute_index = t->GetAttributeIndex();
+    double attribute_value = t->GetAttributeValue();
+    ar & attribute_index;
+    ar & attribute_value;
+}
+
+/**
+ * Allow us to not need a default constructor, by specifying how Boost should
+ * instantiate an instance (using existing constructor)
+ */
+template <class Archive, unsigned SPACE_DIM>
+inline void load_construct_data(
+    Archive & ar, ChasteNodeAttributeRegion<SPACE_DIM> * t, const unsigned int file_version)
+{
+    unsigned attribute_index;
+    double attribute_value;
+    ar & attribute_index;
+    ar & attribute_value;
+
+    ::new(t)ChasteNodeAttributeRegion<SPACE_DIM>(attribute_index, attribute_value);
+}
+}
+} // namespace ...
+
+#endif /*CHASTENODEATTRIBUTEREGION_HPP_*/
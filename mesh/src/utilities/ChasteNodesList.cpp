@@ -40,6 +40,10 @@ ChasteNodesList<SPACE_DIM>::ChasteNodesList(const std::vector<Node<SPACE_DIM>*>
     : mListOfNodes(rNodesList),
       mOwnNodes(ownNodes)
 {
+    for (unsigned i=0; i<mListOfNodes.size(); i++)
+    {
+        mNodesByIndex[mListOfNodes[i]->GetIndex()] = mListOfNodes[i];
+    }
 }
 
 template <unsigned SPACE_DIM>
@@ -70,6 +74,13 @@ bool ChasteNodesList<SPACE_DIM>::DoesContain(const ChastePoint<SPACE_DIM>& rPoin
     return returned_value;
 }
 
+template <unsigned SPACE_DIM>
+bool ChasteNodesList<SPACE_DIM>::DoesContainNode(Node<SPACE_DIM>* pNode) const
+{
+    typename std::map<unsigned, Node<SPACE_DIM>*>::const_iterator it = mNodesByIndex.find(pNode->GetIndex());
+    return (it != mNodesByIndex.end() && it->second->GetPoint().IsSamePoint(pNode->GetPoint()));
+}
+
 template <unsigned SPACE_DIM>
 const std::vector< Node<SPACE_DIM>*>& ChasteNodesList<SPACE_DIM>::rGetNodesList() const
 {
@@ -44,6 +44,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "Node.hpp"
 #include "ChastePoint.hpp"
 
+#include <map>
 #include <vector>
 using namespace std;
 /**
@@ -75,6 +76,9 @@ private:
     /** Whether we own the Node objects and should free the memory on destruction */
     bool mOwnNodes;
 
+    /** The nodes in #mListOfNodes by their index, for DoesContainNode() */
+    std::map<unsigned, Node<SPACE_DIM>*> mNodesByIndex;
+
 public:
 
     /**
@@ -101,6 +105,16 @@ public:
      */
     bool DoesContain(const ChastePoint<SPACE_DIM>& rPointToCheck) const;
 
+    /**
+     * @return true if a given node is in the list. Unlike DoesContain(), which searches the
+     * whole list, this looks the node up by its index, so the nodes in the list must have the
+     * indices of the mesh they are being compared with (as those built from mesh nodes, or
+     * restored from an archive, do). The location must also match.
+     *
+     * @param pNode  the node to be checked
+     */
+    bool DoesContainNode(Node<SPACE_DIM>* pNode) const;
+
     /**
      * @return the size of the nodes list
      */
@@ -34,6 +34,9 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "DistanceMapCalculator.hpp"
+
+#include <algorithm>
+
 #include "DistributedTetrahedralMesh.hpp" // For dynamic cast
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
@@ -41,11 +44,11 @@ DistanceMapCalculator<ELEMENT_DIM, SPACE_DIM>::DistanceMapCalculator(
             AbstractTetrahedralMesh<ELEMENT_DIM,SPACE_DIM>& rMesh)
     : mrMesh(rMesh),
       mWorkOnEntireMesh(true),
-      mNumHalosPerProcess(nullptr),
       mRoundCounter(0u),
       mPopCounter(0u),
       mTargetNodeIndex(UINT_MAX),
-      mSingleTarget(false)
+      mSingleTarget(false),
+      mpSourceDistances(nullptr)
 {
     mNumNodes = mrMesh.GetNumNodes();
 
@@ -67,9 +70,22 @@ DistanceMapCalculator<ELEMENT_DIM, SPACE_DIM>::DistanceMapCalculator(
         p_distributed_mesh->GetHaloNodeIndices(mHaloNodeIndices);
 
         // Share information on the number of halo nodes
-        unsigned my_size = mHaloNodeIndices.size();
-        mNumHalosPerProcess = new unsigned[PetscTools::GetNumProcs()];
-        MPI_Allgather(&my_size, 1, MPI_UNSIGNED, mNumHalosPerProcess, 1, MPI_UNSIGNED, PETSC_COMM_WORLD);
+        const unsigned num_procs = PetscTools::GetNumProcs();
+        int my_size = mHaloNodeIndices.size();
+        mHaloCounts.resize(num_procs);
+        MPI_Allgather(&my_size, 1, MPI_INT, &mHaloCounts[0], 1, MPI_INT, PetscTools::GetWorld());
+
+        // ...and on the halo nodes themselves
+        mHaloOffsets.resize(num_procs);
+        int total_halos = 0;
+        for (unsigned proc=0; proc<num_procs; proc++)
+        {
+            mHaloOffsets[proc] = total_halos;
+            total_halos += mHaloCounts[proc];
+        }
+        mAllHaloNodeIndices.resize(total_halos);
+        MPI_Allgatherv(mHaloNodeIndices.data(), my_size, MPI_UNSIGNED,
+                       mAllHaloNodeIndices.data(), &mHaloCounts[0], &mHaloOffsets[0], MPI_UNSIGNED, PetscTools::GetWorld());
     }
 }
 
@@ -78,34 +94,71 @@ void DistanceMapCalculator<ELEMENT_DIM, SPACE_DIM>::ComputeDistanceMap(
         const std::vector<unsigned>& rSourceNodeIndices,
         std::vector<double>& rNodeDistances)
 {
-    rNodeDistances.resize(mNumNodes);
-    for (unsigned index=0; index<mNumNodes; index++)
-    {
-        rNodeDistances[index] = DBL_MAX;
-    }
+    std::vector<std::vector<unsigned> > source_node_index_sets(1, rSourceNodeIndices);
+    std::vector<std::vector<double> > node_distance_maps(1);
+    node_distance_maps[0].swap(rNodeDistances);
+    ComputeDistanceMaps(source_node_index_sets, node_distance_maps);
+    rNodeDistances.swap(node_distance_maps[0]);
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void DistanceMapCalculator<ELEMENT_DIM, SPACE_DIM>::ComputeDistanceMap(
+        const std::vector<unsigned>& rSourceNodeIndices,
+        const std::vector<double>& rSourceDistances,
+        std::vector<double>& rNodeDistances)
+{
+    assert(rSourceDistances.size() == rSourceNodeIndices.size());
+    assert(!mSingleTarget);
+    mpSourceDistances = &rSourceDistances;
+    ComputeDistanceMap(rSourceNodeIndices, rNodeDistances);
+    mpSourceDistances = nullptr;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void DistanceMapCalculator<ELEMENT_DIM, SPACE_DIM>::ComputeDistanceMaps(
+        const std::vector<std::vector<unsigned> >& rSourceNodeIndexSets,
+        std::vector<std::vector<double> >& rNodeDistanceMaps)
+{
+    const unsigned num_maps = rSourceNodeIndexSets.size();
+    rNodeDistanceMaps.resize(num_maps);
     assert(mActivePriorityNodeIndexQueue.empty());
 
-    if (mSingleTarget)
+    // Each map has its own queue, which is swapped into mActivePriorityNodeIndexQueue while it's worked on
+    std::vector<std::priority_queue<std::pair<double, unsigned> > > queues(num_maps);
+    for (unsigned map=0; map<num_maps; map++)
     {
-        assert(rSourceNodeIndices.size() == 1);
-        unsigned source_node_index = rSourceNodeIndices[0];
+        const std::vector<unsigned>& r_source_node_indices = rSourceNodeIndexSets[map];
+        std::vector<double>& r_node_distances = rNodeDistanceMaps[map];
+        r_node_distances.assign(mNumNodes, DBL_MAX);
 
-        // We need to make sure this is local, so that we can use the geometry
-        if (mLo<=source_node_index && source_node_index<mHi)
+        if (mSingleTarget)
         {
-            double heuristic_correction = norm_2(mrMesh.GetNode(source_node_index)->rGetLocation()-mTargetNodePoint);
-            PushLocal(heuristic_correction, source_node_index);
-            rNodeDistances[source_node_index] = heuristic_correction;
+            assert(num_maps == 1);
+            assert(r_source_node_indices.size() == 1);
+            unsigned source_node_index = r_source_node_indices[0];
+
+            // We need to make sure this is local, so that we can use the geometry
+            if (mLo<=source_node_index && source_node_index<mHi)
+            {
+                double heuristic_correction = norm_2(mrMesh.GetNode(source_node_index)->rGetLocation()-mTargetNodePoint);
+                PushLocal(heuristic_correction, source_node_index);
+                r_node_distances[source_node_index] = heuristic_correction;
+            }
         }
-     }
-    else
-    {
-        for (unsigned source_index=0; source_index<rSourceNodeIndices.size(); source_index++)
+        else
         {
-            unsigned source_node_index = rSourceNodeIndices[source_index];
-            PushLocal(0.0, source_node_index);
-            rNodeDistances[source_node_index] = 0.0;
+            for (unsigned source_index=0; source_index<r_source_node_indices.size(); source_index++)
+            {
+                unsigned source_node_index = r_source_node_indices[source_index];
+                double source_distance = (mpSourceDistances == nullptr) ? 0.0 : (*mpSourceDistances)[source_index];
+                if (source_distance < r_node_distances[source_node_index])
+                {
+                    PushLocal(source_distance, source_node_index);
+                    r_node_distances[source_node_index] = source_distance;
+                }
+            }
         }
+        queues[map].swap(mActivePriorityNodeIndexQueue);
     }
 
     bool non_empty_queue = true;
@@ -113,7 +166,13 @@ void DistanceMapCalculator<ELEMENT_DIM, SPACE_DIM>::ComputeDistanceMap(
     mPopCounter = 0;
     while (non_empty_queue)
     {
-        bool termination = WorkOnLocalQueue(rNodeDistances);
+        bool termination = false;
+        for (unsigned map=0; map<num_maps; map++)
+        {
+            mActivePriorityNodeIndexQueue.swap(queues[map]);
+            termination = WorkOnLocalQueue(rNodeDistanceMaps[map]) || termination;
+            mActivePriorityNodeIndexQueue.swap(queues[map]);
+        }
 
         // Sanity - check that we aren't doing this very many times
         if (mRoundCounter++ > 10 * PetscTools::GetNumProcs())
@@ -126,73 +185,107 @@ void DistanceMapCalculator<ELEMENT_DIM, SPACE_DIM>::ComputeDistanceMap(
             // A single process found the target already
             break;
         }
-        non_empty_queue = UpdateQueueFromRemote(rNodeDistances);
+        non_empty_queue = UpdateQueuesFromRemote(rNodeDistanceMaps, queues);
     }
 
-    if (mWorkOnEntireMesh == false)
+    if (mSingleTarget)
     {
-        // Update all processes with the best values from everywhere
-        // Take a local copy
-        std::vector<double> local_distances = rNodeDistances;
+        // Keep any unfinished work for SingleDistance() to throw away
+        mActivePriorityNodeIndexQueue.swap(queues[0]);
+    }
 
-        // Share it back into the vector
-        MPI_Allreduce( &local_distances[0], &rNodeDistances[0], mNumNodes, MPI_DOUBLE, MPI_MIN, PETSC_COMM_WORLD);
+    if (mWorkOnEntireMesh == false && num_maps > 0)
+    {
+        // Update all processes with the best values from everywhere, all maps at once
+        std::vector<double> local_distances(num_maps*mNumNodes);
+        for (unsigned map=0; map<num_maps; map++)
+        {
+            std::copy(rNodeDistanceMaps[map].begin(), rNodeDistanceMaps[map].end(), local_distances.begin() + map*mNumNodes);
+        }
+        std::vector<double> global_distances(num_maps*mNumNodes);
+        MPI_Allreduce(&local_distances[0], &global_distances[0], num_maps*mNumNodes, MPI_DOUBLE, MPI_MIN, PetscTools::GetWorld());
+        for (unsigned map=0; map<num_maps; map++)
+        {
+            std::copy(global_distances.begin() + map*mNumNodes, global_distances.begin() + (map+1)*mNumNodes,
+                      rNodeDistanceMaps[map].begin());
+        }
     }
 }
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
-bool DistanceMapCalculator<ELEMENT_DIM, SPACE_DIM>::UpdateQueueFromRemote(std::vector<double>& rNodeDistances)
+bool DistanceMapCalculator<ELEMENT_DIM, SPACE_DIM>::UpdateQueuesFromRemote(
+        std::vector<std::vector<double> >& rNodeDistanceMaps,
+        std::vector<std::priority_queue<std::pair<double, unsigned> > >& rQueues)
 {
+    const unsigned num_maps = rNodeDistanceMaps.size();
+    bool non_empty_queue = false;
     if (mWorkOnEntireMesh)
     {
         // This update does nowt
-        return !mActivePriorityNodeIndexQueue.empty();
+        for (unsigned map=0; map<num_maps; map++)
+        {
+            non_empty_queue = non_empty_queue || !rQueues[map].empty();
+        }
+        return non_empty_queue;
     }
-    for (unsigned bcast_process=0; bcast_process<PetscTools::GetNumProcs(); bcast_process++)
+
+    /*
+     * Every process shares the distances at its halo nodes, for all maps, in one collective.
+     * Process p's block of the received array holds num_maps runs of mHaloCounts[p] distances,
+     * in the order of its halo nodes in mAllHaloNodeIndices.
+     */
+    const unsigned num_procs = PetscTools::GetNumProcs();
+    const unsigned num_my_halos = mHaloNodeIndices.size();
+    std::vector<double> my_distances(num_maps*num_my_halos);
+    for (unsigned map=0; map<num_maps; map++)
     {
-        // Process packs cart0/cart1/...euclid/index into a 1-d array
-        double* dist_exchange = new double[ mNumHalosPerProcess[bcast_process] ];
-        unsigned* index_exchange = new unsigned[ mNumHalosPerProcess[bcast_process] ];
-        if (PetscTools::GetMyRank() == bcast_process)
+        for (unsigned index=0; index<num_my_halos; index++)
         {
-            // Broadcaster fills the array
-            for (unsigned index=0; index<mHaloNodeIndices.size();index++)
-            {
-                dist_exchange[index] = rNodeDistances[mHaloNodeIndices[index]];
-                index_exchange[index] = mHaloNodeIndices[index];
-            }
+            my_distances[map*num_my_halos + index] = rNodeDistanceMaps[map][mHaloNodeIndices[index]];
         }
+    }
+    std::vector<int> counts(num_procs);
+    std::vector<int> offsets(num_procs);
+    for (unsigned proc=0; proc<num_procs; proc++)
+    {
+        counts[proc] = num_maps*mHaloCounts[proc];
+        offsets[proc] = num_maps*mHaloOffsets[proc];
+    }
+    std::vector<double> all_distances(num_maps*mAllHaloNodeIndices.size());
+    MPI_Allgatherv(my_distances.data(), my_distances.size(), MPI_DOUBLE,
+                   all_distances.data(), &counts[0], &offsets[0], MPI_DOUBLE, PetscTools::GetWorld());
 
-        /*
-         * Broadcast - this is can be done by casting indices to double and
-         * packing everything into a single array. That would be better for
-         * latency, but this is probably more readable.
-         */
-        MPI_Bcast(dist_exchange, mNumHalosPerProcess[bcast_process], MPI_DOUBLE,
-                  bcast_process, PETSC_COMM_WORLD);
-        MPI_Bcast(index_exchange, mNumHalosPerProcess[bcast_process], MPI_UNSIGNED,
-                  bcast_process, PETSC_COMM_WORLD);
-        if (PetscTools::GetMyRank() != bcast_process)
+    for (unsigned map=0; map<num_maps; map++)
+    {
+        std::vector<double>& r_node_distances = rNodeDistanceMaps[map];
+        mActivePriorityNodeIndexQueue.swap(rQueues[map]);
+        for (unsigned proc=0; proc<num_procs; proc++)
         {
+            if (proc == PetscTools::GetMyRank())
+            {
+                continue;
+            }
             // Receiving process take updates
-            for (unsigned index=0; index<mNumHalosPerProcess[bcast_process];index++)
+            const double* p_proc_distances = all_distances.data() + offsets[proc] + map*mHaloCounts[proc];
+            const unsigned* p_proc_indices = mAllHaloNodeIndices.data() + mHaloOffsets[proc];
+            for (int index=0; index<mHaloCounts[proc]; index++)
             {
-                unsigned global_index=index_exchange[index];
+                unsigned global_index = p_proc_indices[index];
                 // Is it a better answer?
-                if (dist_exchange[index] < rNodeDistances[global_index]*(1.0-2*DBL_EPSILON) )
+                if (p_proc_distances[index] < r_node_distances[global_index]*(1.0-2*DBL_EPSILON))
                 {
                     // Copy across - this may be unnecessary when PushLocal isn't going to push because it's not local
-                    rNodeDistances[global_index] = dist_exchange[index];
-                    PushLocal(rNodeDistances[global_index], global_index);
+                    r_node_distances[global_index] = p_proc_distances[index];
+                    PushLocal(r_node_distances[global_index], global_index);
                 }
             }
         }
-        delete [] dist_exchange;
-        delete [] index_exchange;
+        non_empty_queue = non_empty_queue || !mActivePriorityNodeIndexQueue.empty();
+        mActivePriorityNodeIndexQueue.swap(rQueues[map]);
     }
+
     // Is any queue non-empty?
-    bool non_empty_queue = PetscTools::ReplicateBool(!mActivePriorityNodeIndexQueue.empty());
-    return(non_empty_queue);
+    return PetscTools::ReplicateBool(non_empty_queue);
 }
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
@@ -245,7 +338,7 @@ bool DistanceMapCalculator<ELEMENT_DIM, SPACE_DIM>::WorkOnLocalQueue(std::vector
                         }
                         // Test if we have found a shorter path from the source to the neighbour through current node
                         double updated_distance = rNodeDistances[current_node_index] +
-                                                  norm_2(p_neighbour_node->rGetLocation() - p_current_node->rGetLocation())
+                                                  GetEdgeLength(*element_iterator, p_current_node, p_neighbour_node)
                                                   - current_heuristic + neighbour_heuristic;
                         if (updated_distance < rNodeDistances[neighbour_node_index] * (1.0-2*DBL_EPSILON))
                         {
@@ -273,6 +366,14 @@ bool DistanceMapCalculator<ELEMENT_DIM, SPACE_DIM>::WorkOnLocalQueue(std::vector
      return false;
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+double DistanceMapCalculator<ELEMENT_DIM, SPACE_DIM>::GetEdgeLength(unsigned elementIndex,
+                                                                    const Node<SPACE_DIM>* pFrom,
+                                                                    const Node<SPACE_DIM>* pTo)
+{
+    return norm_2(pTo->rGetLocation() - pFrom->rGetLocation());
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 double DistanceMapCalculator<ELEMENT_DIM, SPACE_DIM>::SingleDistance(unsigned sourceNodeIndex, unsigned targetNodeIndex)
 {
@@ -292,7 +393,7 @@ double DistanceMapCalculator<ELEMENT_DIM, SPACE_DIM>::SingleDistance(unsigned so
     }
 
     // Communicate for wherever to everyone
-    MPI_Allreduce(&target_point[0], &mTargetNodePoint[0], SPACE_DIM, MPI_DOUBLE, MPI_SUM, PETSC_COMM_WORLD);
+    MPI_Allreduce(&target_point[0], &mTargetNodePoint[0], SPACE_DIM, MPI_DOUBLE, MPI_SUM, PetscTools::GetWorld());
 
     //mTargetNodePoint;
     std::vector<double> distances;
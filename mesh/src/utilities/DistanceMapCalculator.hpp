@@ -46,7 +46,8 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  * from a given surface, specifying the distance from each node to the surface.
  *
  * The mesh is specified in the constructor, and the ComputeDistanceMap computes
- * (and returns by reference) the map.
+ * (and returns by reference) the map. ComputeDistanceMaps computes several maps
+ * at once, sharing the parallel communication rounds between them.
  */
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 class DistanceMapCalculator
@@ -64,10 +65,17 @@ private:
     unsigned mHi;
     /** Whether we should work on the entire mesh.  True if sequential.  True is the mesh is a plain TetrahedralMesh.*/
     bool mWorkOnEntireMesh;
-    /** (Only used when mWorkOnEntrireMesh == false).  This forms an array of with the number of halo nodes known by each process.*/
-    unsigned *mNumHalosPerProcess;
+    /** (Only used when mWorkOnEntrireMesh == false).  The number of halo nodes known by each process.*/
+    std::vector<int> mHaloCounts;
+    /** (Only used when mWorkOnEntrireMesh == false).  Where each process's halo nodes start in #mAllHaloNodeIndices.*/
+    std::vector<int> mHaloOffsets;
     /** (Only used when mWorkOnEntrireMesh == false).  This is a local cache of halo node indices.*/
     std::vector<unsigned> mHaloNodeIndices;
+    /**
+     * (Only used when mWorkOnEntrireMesh == false).  The halo node indices of every process, concatenated
+     * in rank order.  These never change, so are shared once in the constructor rather than every round.
+     */
+    std::vector<unsigned> mAllHaloNodeIndices;
     /** Used to check parallel implementation*/
     unsigned mRoundCounter;
     /** Used to check implementation for number of queue pops per calculation*/
@@ -78,6 +86,8 @@ private:
     bool mSingleTarget;
     /** Also used in the calculation of point-to-point distances with A* heuristic -- this requires a parallel communication*/
     c_vector<double, SPACE_DIM> mTargetNodePoint;
+    /** Distances at which the sources start, if not all zero (only set during ComputeDistanceMap()).*/
+    const std::vector<double>* mpSourceDistances;
 
     /**
      * Queue of nodes to be processed (initialised with the nodes defining the surface)
@@ -98,15 +108,16 @@ private:
     bool WorkOnLocalQueue(std::vector<double>& rNodeDistances);
 
     /**
-     * Update the local Queue of node indices using data that are from the halo nodes of remote processes.
-     *
-     * @param rNodeDistances distance map computed
+     * Update the local Queue of node indices of each map using data that are from the halo nodes of
+     * remote processes.  The halo distances of all the maps are exchanged in a single collective call.
      *
-     * @return true when this update was active => there are non-empty queues left to work on
-     * @return false without working or side-effects if we don't have a true distributed mesh
+     * @param rNodeDistanceMaps distance maps computed
+     * @param rQueues the queue belonging to each map (#mActivePriorityNodeIndexQueue is only used in passing)
      *
+     * @return true when there are non-empty queues left to work on (on any process)
      */
-    bool UpdateQueueFromRemote(std::vector<double>& rNodeDistances);
+    bool UpdateQueuesFromRemote(std::vector<std::vector<double> >& rNodeDistanceMaps,
+                                std::vector<std::priority_queue<std::pair<double, unsigned> > >& rQueues);
 
     /**
      * Push a node index onto the queue.  In the parallel case this will only push a
@@ -124,6 +135,20 @@ private:
         }
     }
 
+protected:
+
+    /**
+     * @return the length of the edge between two nodes of an element, i.e. how far
+     * it is from one node to the other.  By default this is the Euclidean distance,
+     * but subclasses may weight edges differently, e.g. by travel time.  Note that
+     * the A* heuristic used by SingleDistance() assumes the default metric.
+     *
+     * @param elementIndex  global index of an element containing both nodes
+     * @param pFrom  the node whose distance is known
+     * @param pTo  the neighbouring node
+     */
+    virtual double GetEdgeLength(unsigned elementIndex, const Node<SPACE_DIM>* pFrom, const Node<SPACE_DIM>* pTo);
+
 public:
 
     /**
@@ -133,12 +158,11 @@ public:
      */
     DistanceMapCalculator(AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>& rMesh);
 
-     /**
-     * Destructor - cleans up mNumHalosPerProcess (which is normally set to NULL anyway).
+    /**
+     * Destructor
      */
-    ~DistanceMapCalculator()
+    virtual ~DistanceMapCalculator()
     {
-        delete [] mNumHalosPerProcess;
     }
 
     /**
@@ -153,6 +177,30 @@ public:
     void ComputeDistanceMap(const std::vector<unsigned>& rSourceNodeIndices,
                             std::vector<double>& rNodeDistances);
 
+    /**
+     *  Generates a distance map of all the nodes of the mesh to the given source, where each source
+     *  node starts at its own distance rather than zero (e.g. a time at which it is activated).
+     *
+     *  @param rSourceNodeIndices set of node indices defining the source set or surface
+     *  @param rSourceDistances the distance of each source node, in the same order
+     *  @param rNodeDistances distance map computed. The method will resize it if it's not big enough.
+     */
+    void ComputeDistanceMap(const std::vector<unsigned>& rSourceNodeIndices,
+                            const std::vector<double>& rSourceDistances,
+                            std::vector<double>& rNodeDistances);
+
+    /**
+     *  Generates several distance maps at once, e.g. from the epicardial, endocardial and ventricular
+     *  surfaces.  The result is the same as calling ComputeDistanceMap() for each source set, but the
+     *  maps share each round of parallel communication, so there are as few synchronisations as for
+     *  the slowest map alone.
+     *
+     *  @param rSourceNodeIndexSets the source set or surface of each map (any of which may be empty)
+     *  @param rNodeDistanceMaps distance maps computed, one per source set.  Resized as needed.
+     */
+    void ComputeDistanceMaps(const std::vector<std::vector<unsigned> >& rSourceNodeIndexSets,
+                             std::vector<std::vector<double> >& rNodeDistanceMaps);
+
     /**
      *  @return calculated single point-to-point distance
      *
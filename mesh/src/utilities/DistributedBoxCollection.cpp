@@ -35,23 +35,30 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "DistributedBoxCollection.hpp"
 #include "Exception.hpp"
 #include "MathsCustomFunctions.hpp"
+#include "MultiLevelNodeGrid.hpp"
 #include "Warnings.hpp"
 
+#include <algorithm>
+#include <cstdlib>
+
 // Static member for "fudge factor" is instantiated here
 template <unsigned DIM>
 const double DistributedBoxCollection<DIM>::msFudge = 5e-14;
 
 template <unsigned DIM>
 DistributedBoxCollection<DIM>::DistributedBoxCollection(double boxWidth, c_vector<double, 2*DIM> domainSize, bool isPeriodicInX, int localRows)
-    : mBoxWidth(boxWidth),
+    : AbstractMemoryAccountable(MemoryAccounting::BOX_COLLECTION),
+      mBoxWidth(boxWidth),
       mIsPeriodicInX(isPeriodicInX),
       mAreLocalBoxesSet(false),
-      mCalculateNodeNeighbours(true)
+      mCalculateNodeNeighbours(true),
+      mVerletSkin(0.0),
+      mUseMultiLevelPairSearch(false)
 {
-    // Periodicity only works in 2d
+    // Periodicity only works in 2d and 3d, since in 1d the x direction is split between processes
     if (isPeriodicInX)
     {
-        assert(DIM==2);    // LCOV_EXCL_LINE
+        assert(DIM > 1);    // LCOV_EXCL_LINE
     }
 
     // If the domain size is not 'divisible' (i.e. fmod(width, box_size) > 0.0) we swell the domain to enforce this.
@@ -115,6 +122,30 @@ DistributedBoxCollection<DIM>::~DistributedBoxCollection()
     delete mpDistributedBoxStackFactory;
 }
 
+template<unsigned DIM>
+double DistributedBoxCollection<DIM>::GetMemoryUsage() const
+{
+    // Each std::set node carries roughly four pointers of overhead
+    const double set_entry = 5*sizeof(void*);
+    double bytes = GetVectorBytes(mBoxes) + GetVectorBytes(mHaloBoxes);
+    for (unsigned i=0; i<mBoxes.size(); i++)
+    {
+        bytes += (mBoxes[i].rGetNodesContained().size() + mBoxes[i].rGetElementsContained().size())*set_entry;
+    }
+    for (unsigned i=0; i<mHaloBoxes.size(); i++)
+    {
+        bytes += (mHaloBoxes[i].rGetNodesContained().size() + mHaloBoxes[i].rGetElementsContained().size())*set_entry;
+    }
+    bytes += GetVectorBytes(mLocalBoxes);
+    for (unsigned i=0; i<mLocalBoxes.size(); i++)
+    {
+        bytes += mLocalBoxes[i].size()*set_entry;
+    }
+    bytes += GetVectorBytes(mHalosRight) + GetVectorBytes(mHalosLeft)
+             + GetVectorBytes(mHaloNodesRight) + GetVectorBytes(mHaloNodesLeft);
+    return bytes;
+}
+
 template <unsigned DIM>
 void DistributedBoxCollection<DIM>::EmptyBoxes()
 {
@@ -224,7 +255,6 @@ bool DistributedBoxCollection<DIM>::IsInteriorBox(unsigned globalIndex)
 template <unsigned DIM>
 unsigned DistributedBoxCollection<DIM>::CalculateGlobalIndex(c_vector<unsigned, DIM> gridIndices)
 {
-    ///\todo #2308 etc. We need to make allowance for periodicity here...
     unsigned global_index;
 
     switch (DIM)
@@ -342,6 +372,30 @@ c_vector<unsigned, DIM> DistributedBoxCollection<DIM>::CalculateGridIndices(unsi
     return grid_indices;
 }
 
+template <unsigned DIM>
+void DistributedBoxCollection<DIM>::InsertBoxAtOffset(std::set<unsigned>& rLocalBoxes, unsigned globalIndex, const int offset[DIM])
+{
+    c_vector<unsigned, DIM> grid_indices = CalculateGridIndices(globalIndex);
+
+    for (unsigned d=0; d<DIM; d++)
+    {
+        int index = (int)grid_indices[d] + offset[d];
+        int num_boxes = (int)mNumBoxesEachDirection(d);
+        if (index < 0 || index >= num_boxes)
+        {
+            // Only the x direction may wrap around
+            if (d > 0 || !mIsPeriodicInX)
+            {
+                return;
+            }
+            index = (index + num_boxes) % num_boxes;
+        }
+        grid_indices[d] = (unsigned)index;
+    }
+
+    rLocalBoxes.insert(CalculateGlobalIndex(grid_indices));
+}
+
 template <unsigned DIM>
 Box<DIM>& DistributedBoxCollection<DIM>::rGetBox(unsigned boxIndex)
 {
@@ -426,13 +480,13 @@ int DistributedBoxCollection<DIM>::LoadBalance(std::vector<int> localDistributio
 
     unsigned num_local_rows = localDistribution.size();
 
-    MPI_Send(&num_local_rows, 1, MPI_UNSIGNED, proc_right, 123, PETSC_COMM_WORLD);
-    MPI_Recv(&rows_on_left_process, 1, MPI_UNSIGNED, proc_left, 123, PETSC_COMM_WORLD, &status);
+    MPI_Send(&num_local_rows, 1, MPI_UNSIGNED, proc_right, 123, PetscTools::GetWorld());
+    MPI_Recv(&rows_on_left_process, 1, MPI_UNSIGNED, proc_left, 123, PetscTools::GetWorld(), &status);
 
     node_distr_on_left_process.resize(rows_on_left_process > 0 ? rows_on_left_process : 1);
 
-    MPI_Send(&localDistribution[0], num_local_rows, MPI_INT, proc_right, 123, PETSC_COMM_WORLD);
-    MPI_Recv(&node_distr_on_left_process[0], rows_on_left_process, MPI_INT, proc_left, 123, PETSC_COMM_WORLD, &status);
+    MPI_Send(&localDistribution[0], num_local_rows, MPI_INT, proc_right, 123, PetscTools::GetWorld());
+    MPI_Recv(&node_distr_on_left_process[0], rows_on_left_process, MPI_INT, proc_left, 123, PetscTools::GetWorld(), &status);
 
     /**
      * Calculate change in balance of loads by shifting the left/bottom boundary in either direction
@@ -482,12 +536,12 @@ int DistributedBoxCollection<DIM>::LoadBalance(std::vector<int> localDistributio
         new_rows += local_change;
 
         // Send the result of the calculation back to the left processes.
-        MPI_Send(&local_change, 1, MPI_INT, proc_left, 123, PETSC_COMM_WORLD);
+        MPI_Send(&local_change, 1, MPI_INT, proc_left, 123, PetscTools::GetWorld());
     }
 
     // Receive changes from right hand process.
     int remote_change = 0;
-    MPI_Recv(&remote_change, 1, MPI_INT, proc_right, 123, PETSC_COMM_WORLD, &status);
+    MPI_Recv(&remote_change, 1, MPI_INT, proc_right, 123, PetscTools::GetWorld(), &status);
 
     // Update based on change or right/top boundary
     new_rows -= remote_change;
@@ -495,6 +549,88 @@ int DistributedBoxCollection<DIM>::LoadBalance(std::vector<int> localDistributio
     return new_rows;
 }
 
+template <unsigned DIM>
+int DistributedBoxCollection<DIM>::LoadBalanceGlobally(std::vector<int> localDistribution)
+{
+    const unsigned num_procs = PetscTools::GetNumProcs();
+
+    // Gather the number of rows on each process, and from that the loads of all the rows
+    int num_local_rows = localDistribution.size();
+    std::vector<int> rows_on_each_process(num_procs);
+    MPI_Allgather(&num_local_rows, 1, MPI_INT, &rows_on_each_process[0], 1, MPI_INT, PetscTools::GetWorld());
+
+    std::vector<unsigned> current_starts(num_procs+1, 0);
+    std::vector<int> displacements(num_procs, 0);
+    for (unsigned proc=0; proc<num_procs; proc++)
+    {
+        displacements[proc] = current_starts[proc];
+        current_starts[proc+1] = current_starts[proc] + rows_on_each_process[proc];
+    }
+
+    std::vector<int> loads(current_starts[num_procs] > 0 ? current_starts[num_procs] : 1);
+    MPI_Allgatherv(num_local_rows > 0 ? &localDistribution[0] : nullptr, num_local_rows, MPI_INT,
+                   &loads[0], &rows_on_each_process[0], &displacements[0], MPI_INT, PetscTools::GetWorld());
+    loads.resize(current_starts[num_procs]);
+
+    std::vector<unsigned> new_starts = CalculateBalancedPartition(loads, current_starts);
+
+    unsigned rank = PetscTools::GetMyRank();
+    return new_starts[rank+1] - new_starts[rank];
+}
+
+template <unsigned DIM>
+std::vector<unsigned> DistributedBoxCollection<DIM>::CalculateBalancedPartition(const std::vector<int>& rLoads,
+                                                                                const std::vector<unsigned>& rCurrentStarts)
+{
+    assert(rCurrentStarts.size() > 1);
+    const unsigned num_procs = rCurrentStarts.size() - 1;
+    const unsigned num_rows = rCurrentStarts[num_procs];
+    assert(rLoads.size() == num_rows);
+
+    // Keep at least two rows on each process, unless one already has fewer
+    unsigned min_rows = 2;
+    for (unsigned proc=0; proc<num_procs; proc++)
+    {
+        assert(rCurrentStarts[proc+1] > rCurrentStarts[proc]);
+        min_rows = std::min(min_rows, rCurrentStarts[proc+1] - rCurrentStarts[proc]);
+    }
+
+    // Cumulative loads, in integers to avoid rounding errors as in LoadBalance()
+    std::vector<long> cumulative_loads(num_rows+1, 0);
+    for (unsigned row=0; row<num_rows; row++)
+    {
+        cumulative_loads[row+1] = cumulative_loads[row] + rLoads[row];
+    }
+    const long total_load = cumulative_loads[num_rows];
+
+    std::vector<unsigned> new_starts(num_procs+1, 0);
+    new_starts[num_procs] = num_rows;
+    for (unsigned proc=1; proc<num_procs; proc++)
+    {
+        // The row boundary closest to an equal share of the load, compared as total_load*proc/num_procs
+        const long target = total_load*proc;
+        unsigned best_row = 0;
+        long best_error = labs(cumulative_loads[0]*num_procs - target);
+        for (unsigned row=1; row<=num_rows; row++)
+        {
+            long error = labs(cumulative_loads[row]*num_procs - target);
+            if (error < best_error)
+            {
+                best_error = error;
+                best_row = row;
+            }
+        }
+
+        // Only move the boundary within the rows currently owned by its neighbours
+        unsigned lower = std::max(rCurrentStarts[proc-1], new_starts[proc-1] + min_rows);
+        unsigned upper = std::min(rCurrentStarts[proc+1], num_rows - min_rows*(num_procs - proc));
+        assert(lower <= upper);
+        new_starts[proc] = std::min(std::max(best_row, lower), upper);
+    }
+
+    return new_starts;
+}
+
 template <unsigned DIM>
 void DistributedBoxCollection<DIM>::SetupLocalBoxesHalfOnly()
 {
@@ -570,6 +706,16 @@ void DistributedBoxCollection<DIM>::SetupLocalBoxesHalfOnly()
                         {
                             local_boxes.insert(global_index - mNumBoxesEachDirection(0) + 1);
                         }
+
+                        // If periodic, include the boxes below on the opposite edge of the domain
+                        if (left && mIsPeriodicInX)
+                        {
+                            local_boxes.insert(global_index - 1);
+                        }
+                        if (right && mIsPeriodicInX)
+                        {
+                            local_boxes.insert(global_index - 2*mNumBoxesEachDirection(0) + 1);
+                        }
                     }
 
                     // If we're not at the top of the domain insert boxes above
@@ -601,7 +747,7 @@ void DistributedBoxCollection<DIM>::SetupLocalBoxesHalfOnly()
                     {
                         local_boxes.insert(global_index - mNumBoxesEachDirection(0) + 1);
                         // If we're also not on the top-most row, then insert the box above- on the far left of the domain
-                        if (global_index < mBoxes.size() - mNumBoxesEachDirection(0))
+                        if (!top)
                         {
                             local_boxes.insert(global_index + 1);
                         }
@@ -615,132 +761,42 @@ void DistributedBoxCollection<DIM>::SetupLocalBoxesHalfOnly()
             {
                 // We only need to look for neighbours in the current box and half the neighbouring boxes plus some others for halos
                 mLocalBoxes.clear();
-                unsigned num_boxes_xy = mNumBoxesEachDirection(0)*mNumBoxesEachDirection(1);
 
+                // The (x,y,z) offsets of half of the neighbouring boxes
+                const int half_offsets[13][3] = {{1,0,0}, {-1,1,0}, {0,1,0}, {1,1,0},
+                                                 {-1,1,-1}, {0,1,-1}, {1,1,-1}, {1,0,-1},
+                                                 {0,0,1}, {1,0,1}, {-1,1,1}, {0,1,1}, {1,1,1}};
+
+                // The offsets of the other boxes in the face in front of (behind) the process, which are halos
+                const int front_halo_offsets[5][3] = {{0,0,-1}, {-1,0,-1}, {0,-1,-1}, {-1,-1,-1}, {1,-1,-1}};
+                const int back_halo_offsets[4][3] = {{-1,0,1}, {0,-1,1}, {-1,-1,1}, {1,-1,1}};
 
                 for (unsigned global_index = mMinBoxIndex; global_index<mMaxBoxIndex+1; global_index++)
                 {
                     std::set<unsigned> local_boxes;
 
-                    // Set some bools to find out where we are
-                    bool top = !(global_index % num_boxes_xy < num_boxes_xy - mNumBoxesEachDirection(0));
-                    bool bottom = (global_index % num_boxes_xy < mNumBoxesEachDirection(0));
-                    bool left = (global_index % mNumBoxesEachDirection(0) == 0);
-                    bool right = (global_index % mNumBoxesEachDirection(0) == mNumBoxesEachDirection(0) - 1);
-                    bool front = (global_index < num_boxes_xy);
-                    bool back = !(global_index < num_boxes_xy*mNumBoxesEachDirection(2) - num_boxes_xy);
-                    bool proc_front = (CalculateGridIndices(global_index)[2] == mpDistributedBoxStackFactory->GetLow());
-                    bool proc_back = (CalculateGridIndices(global_index)[2] == mpDistributedBoxStackFactory->GetHigh()-1);
-
                     // Insert the current box
                     local_boxes.insert(global_index);
 
-                    // If we're not on the front face, add appropriate boxes on the closer face
-                    if (!front)
-                    {
-                        // If we're not on the top of the domain
-                        if (!top)
-                        {
-                            local_boxes.insert( global_index - num_boxes_xy + mNumBoxesEachDirection(0) );
-                            if (!left)
-                            {
-                                local_boxes.insert( global_index - num_boxes_xy + mNumBoxesEachDirection(0) - 1);
-                            }
-                            if (!right)
-                            {
-                                local_boxes.insert( global_index - num_boxes_xy + mNumBoxesEachDirection(0) + 1);
-                            }
-                        }
-                        if (!right)
-                        {
-                            local_boxes.insert( global_index - num_boxes_xy + 1);
-                        }
-
-                        // If we are on the front of the process we have to add extra boxes as they are halos.
-                        if (proc_front)
-                        {
-                            local_boxes.insert( global_index - num_boxes_xy );
-
-                            if (!left)
-                            {
-                                local_boxes.insert( global_index - num_boxes_xy - 1);
-                            }
-                            if (!bottom)
-                            {
-                                local_boxes.insert( global_index - num_boxes_xy - mNumBoxesEachDirection(0));
-
-                                if (!left)
-                                {
-                                    local_boxes.insert( global_index - num_boxes_xy - mNumBoxesEachDirection(0) - 1);
-                                }
-                                if (!right)
-                                {
-                                    local_boxes.insert( global_index - num_boxes_xy - mNumBoxesEachDirection(0) + 1);
-                                }
-                            }
-
-                        }
-                    }
-                    if (!right)
+                    for (unsigned i=0; i<13; i++)
                     {
-                        local_boxes.insert( global_index + 1);
+                        InsertBoxAtOffset(local_boxes, global_index, half_offsets[i]);
                     }
-                    // If we're not on the very top add boxes above
-                    if (!top)
-                    {
-                        local_boxes.insert( global_index + mNumBoxesEachDirection(0));
 
-                        if (!right)
-                        {
-                            local_boxes.insert( global_index + mNumBoxesEachDirection(0) + 1);
-                        }
-                        if (!left)
+                    // If we are on the front or back of the process we have to add extra boxes as they are halos
+                    unsigned z_index = CalculateGridIndices(global_index)[2];
+                    if (z_index == mpDistributedBoxStackFactory->GetLow())
+                    {
+                        for (unsigned i=0; i<5; i++)
                         {
-                            local_boxes.insert( global_index + mNumBoxesEachDirection(0) - 1);
+                            InsertBoxAtOffset(local_boxes, global_index, front_halo_offsets[i]);
                         }
                     }
-
-                    // If we're not on the back add boxes behind
-                    if (!back)
+                    if (z_index == mpDistributedBoxStackFactory->GetHigh()-1)
                     {
-                        local_boxes.insert(global_index + num_boxes_xy);
-
-                        if (!right)
+                        for (unsigned i=0; i<4; i++)
                         {
-                            local_boxes.insert(global_index + num_boxes_xy + 1);
-                        }
-                        if (!top)
-                        {
-                            local_boxes.insert(global_index + num_boxes_xy + mNumBoxesEachDirection(0));
-                            if (!right)
-                            {
-                                local_boxes.insert(global_index + num_boxes_xy + mNumBoxesEachDirection(0) + 1);
-                            }
-                            if (!left)
-                            {
-                                local_boxes.insert(global_index + num_boxes_xy + mNumBoxesEachDirection(0) - 1);
-                            }
-                        }
-                        // If we are on the back proc we should make sure we get everything in the face further back
-                        if (proc_back)
-                        {
-                            if (!left)
-                            {
-                                local_boxes.insert(global_index + num_boxes_xy - 1);
-                            }
-                            if (!bottom)
-                            {
-                                local_boxes.insert(global_index + num_boxes_xy - mNumBoxesEachDirection(0));
-
-                                if (!left)
-                                {
-                                    local_boxes.insert(global_index + num_boxes_xy - mNumBoxesEachDirection(0) - 1);
-                                }
-                                if (!right)
-                                {
-                                    local_boxes.insert(global_index + num_boxes_xy - mNumBoxesEachDirection(0) + 1);
-                                }
-                            }
+                            InsertBoxAtOffset(local_boxes, global_index, back_halo_offsets[i]);
                         }
                     }
                     mLocalBoxes.push_back(local_boxes);
@@ -1067,6 +1123,20 @@ void DistributedBoxCollection<DIM>::SetupAllLocalBoxes()
                     local_boxes.insert(i+1+M+M*N);
                 }
 
+                // Add periodic boxes on the far side of the domain if needed
+                if (mIsPeriodicInX && (is_xmin[i] || is_xmax[i]))
+                {
+                    int offset[3];
+                    offset[0] = is_xmin[i] ? -1 : 1;
+                    for (offset[1]=-1; offset[1]<=1; offset[1]++)
+                    {
+                        for (offset[2]=-1; offset[2]<=1; offset[2]++)
+                        {
+                            InsertBoxAtOffset(local_boxes, i, offset);
+                        }
+                    }
+                }
+
                 mLocalBoxes.push_back(local_boxes);
             }
             break;
@@ -1136,10 +1206,78 @@ void DistributedBoxCollection<DIM>::SetCalculateNodeNeighbours(bool calculateNod
     mCalculateNodeNeighbours = calculateNodeNeighbours;
 }
 
+template <unsigned DIM>
+void DistributedBoxCollection<DIM>::SetVerletSkin(double skin)
+{
+    assert(skin >= 0.0);
+    mVerletSkin = skin;
+    mNodesAtLastPairCalculation.clear();
+    mLocationsAtLastPairCalculation.clear();
+}
+
+template <unsigned DIM>
+double DistributedBoxCollection<DIM>::GetVerletSkin() const
+{
+    return mVerletSkin;
+}
+
+template <unsigned DIM>
+void DistributedBoxCollection<DIM>::SetUseMultiLevelPairSearch(bool useMultiLevelPairSearch)
+{
+    mUseMultiLevelPairSearch = useMultiLevelPairSearch;
+}
+
+template <unsigned DIM>
+bool DistributedBoxCollection<DIM>::GetUseMultiLevelPairSearch() const
+{
+    return mUseMultiLevelPairSearch;
+}
+
+template <unsigned DIM>
+void DistributedBoxCollection<DIM>::RecordNodeLocationsForNodePairs(std::vector<Node<DIM>*>& rNodes)
+{
+    mNodesAtLastPairCalculation = rNodes;
+    mLocationsAtLastPairCalculation.resize(rNodes.size());
+    mRadiiAtLastPairCalculation.resize(rNodes.size());
+    for (unsigned i=0; i<rNodes.size(); i++)
+    {
+        mLocationsAtLastPairCalculation[i] = rNodes[i]->rGetLocation();
+        mRadiiAtLastPairCalculation[i] = rNodes[i]->HasNodeAttributes() ? rNodes[i]->GetRadius() : 0.0;
+    }
+}
+
+template <unsigned DIM>
+bool DistributedBoxCollection<DIM>::AreNodePairsStillValid(std::vector<Node<DIM>*>& rNodes)
+{
+    if (mVerletSkin == 0.0 || !PetscTools::IsSequential() || rNodes != mNodesAtLastPairCalculation)
+    {
+        return false;
+    }
+
+    // Two nodes can only have closed the gap by twice the largest displacement
+    const double max_displacement = 0.5*mVerletSkin;
+    for (unsigned i=0; i<rNodes.size(); i++)
+    {
+        if (norm_2(rNodes[i]->rGetLocation() - mLocationsAtLastPairCalculation[i]) >= max_displacement)
+        {
+            return false;
+        }
+
+        // The multi-level search only kept pairs within the sum of the radii (plus the skin) at the time
+        if (mUseMultiLevelPairSearch && rNodes[i]->HasNodeAttributes()
+            && rNodes[i]->GetRadius() > mRadiiAtLastPairCalculation[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
 template <unsigned DIM>
 void DistributedBoxCollection<DIM>::CalculateNodePairs(std::vector<Node<DIM>*>& rNodes, std::vector<std::pair<Node<DIM>*, Node<DIM>*> >& rNodePairs)
 {
     rNodePairs.clear();
+    SortNodesIntoContiguousBoxes();
 
     // Create an empty neighbours set for each node
     for (unsigned i=0; i<rNodes.size(); i++)
@@ -1154,9 +1292,16 @@ void DistributedBoxCollection<DIM>::CalculateNodePairs(std::vector<Node<DIM>*>&
         }
     }
 
-    for (unsigned box_index=mMinBoxIndex; box_index<=mMaxBoxIndex; box_index++)
+    if (mUseMultiLevelPairSearch && !mIsPeriodicInX)
     {
-        AddPairsFromBox(box_index, rNodePairs);
+        AddPairsFromMultiLevelGrid(true, true, rNodePairs);
+    }
+    else
+    {
+        for (unsigned box_index=mMinBoxIndex; box_index<=mMaxBoxIndex; box_index++)
+        {
+            AddPairsFromBox(box_index, rNodePairs);
+        }
     }
 
     if (mCalculateNodeNeighbours)
@@ -1179,6 +1324,7 @@ template <unsigned DIM>
 void DistributedBoxCollection<DIM>::CalculateInteriorNodePairs(std::vector<Node<DIM>*>& rNodes, std::vector<std::pair<Node<DIM>*, Node<DIM>*> >& rNodePairs)
 {
     rNodePairs.clear();
+    SortNodesIntoContiguousBoxes();
 
     // Create an empty neighbours set for each node
     for (unsigned i=0; i<rNodes.size(); i++)
@@ -1194,11 +1340,18 @@ void DistributedBoxCollection<DIM>::CalculateInteriorNodePairs(std::vector<Node<
         }
     }
 
-    for (unsigned box_index=mMinBoxIndex; box_index<=mMaxBoxIndex; box_index++)
+    if (mUseMultiLevelPairSearch && !mIsPeriodicInX)
+    {
+        AddPairsFromMultiLevelGrid(true, false, rNodePairs);
+    }
+    else
     {
-        if (IsInteriorBox(box_index))
+        for (unsigned box_index=mMinBoxIndex; box_index<=mMaxBoxIndex; box_index++)
         {
-            AddPairsFromBox(box_index, rNodePairs);
+            if (IsInteriorBox(box_index))
+            {
+                AddPairsFromBox(box_index, rNodePairs);
+            }
         }
     }
 
@@ -1222,11 +1375,20 @@ void DistributedBoxCollection<DIM>::CalculateInteriorNodePairs(std::vector<Node<
 template <unsigned DIM>
 void DistributedBoxCollection<DIM>::CalculateBoundaryNodePairs(std::vector<Node<DIM>*>& rNodes, std::vector<std::pair<Node<DIM>*, Node<DIM>*> >& rNodePairs)
 {
-    for (unsigned box_index=mMinBoxIndex; box_index<=mMaxBoxIndex; box_index++)
+    SortNodesIntoContiguousBoxes();
+
+    if (mUseMultiLevelPairSearch && !mIsPeriodicInX)
     {
-        if (!IsInteriorBox(box_index))
+        AddPairsFromMultiLevelGrid(false, true, rNodePairs);
+    }
+    else
+    {
+        for (unsigned box_index=mMinBoxIndex; box_index<=mMaxBoxIndex; box_index++)
         {
-            AddPairsFromBox(box_index, rNodePairs);
+            if (!IsInteriorBox(box_index))
+            {
+                AddPairsFromBox(box_index, rNodePairs);
+            }
         }
     }
 
@@ -1248,66 +1410,186 @@ void DistributedBoxCollection<DIM>::CalculateBoundaryNodePairs(std::vector<Node<
 }
 
 template <unsigned DIM>
-void DistributedBoxCollection<DIM>::AddPairsFromBox(unsigned boxIndex,
-                                                    std::vector<std::pair<Node<DIM>*, Node<DIM>*> >& rNodePairs)
+void DistributedBoxCollection<DIM>::SortNodesIntoContiguousBoxes()
 {
-    // Get the box
-    Box<DIM>& r_box = rGetBox(boxIndex);
-
-    // Get the set of nodes in this box
-    const std::set< Node<DIM>* >& r_contained_nodes = r_box.rGetNodesContained();
-
-    // Get the local boxes to this box
-    const std::set<unsigned>& local_boxes_indices = rGetLocalBoxes(boxIndex);
+    const unsigned num_owned_boxes = mBoxes.size();
+    const unsigned num_boxes = num_owned_boxes + mHaloBoxes.size();
 
-    // Loop over all the local boxes
-    for (std::set<unsigned>::iterator box_iter = local_boxes_indices.begin();
-         box_iter != local_boxes_indices.end();
-         box_iter++)
+    // Count the nodes in each box, and hence where each box starts
+    mSortedBoxStarts.resize(num_boxes + 1);
+    mSortedBoxStarts[0] = 0;
+    for (unsigned i=0; i<num_boxes; i++)
     {
-        Box<DIM>* p_neighbour_box;
+        Box<DIM>& r_box = (i < num_owned_boxes) ? mBoxes[i] : mHaloBoxes[i - num_owned_boxes];
+        mSortedBoxStarts[i+1] = mSortedBoxStarts[i] + r_box.rGetNodesContained().size();
+    }
 
-        // Establish whether box is locally owned or halo.
-        if (IsBoxOwned(*box_iter))
+    // Copy each box's nodes into its range, in the order of the box's set
+    mSortedNodes.resize(mSortedBoxStarts[num_boxes]);
+    mSortedNodeIndices.resize(mSortedBoxStarts[num_boxes]);
+    for (unsigned i=0; i<num_boxes; i++)
+    {
+        Box<DIM>& r_box = (i < num_owned_boxes) ? mBoxes[i] : mHaloBoxes[i - num_owned_boxes];
+        const std::set<Node<DIM>*>& r_nodes = r_box.rGetNodesContained();
+        unsigned position = mSortedBoxStarts[i];
+        for (typename std::set<Node<DIM>*>::const_iterator node_iter = r_nodes.begin();
+             node_iter != r_nodes.end();
+             ++node_iter, ++position)
         {
-            p_neighbour_box = &mBoxes[*box_iter - mMinBoxIndex];
+            mSortedNodes[position] = *node_iter;
+            mSortedNodeIndices[position] = (*node_iter)->GetIndex();
         }
-        else // Assume it is a halo.
+    }
+
+    // Where each owned box's local boxes are, so the pair search needs no map lookups
+    mLocalBoxSlots.resize(mLocalBoxes.size());
+    for (unsigned i=0; i<mLocalBoxes.size(); i++)
+    {
+        const std::set<unsigned>& r_local_boxes = mLocalBoxes[i];
+        mLocalBoxSlots[i].clear();
+        for (std::set<unsigned>::const_iterator box_iter = r_local_boxes.begin();
+             box_iter != r_local_boxes.end();
+             ++box_iter)
         {
-            p_neighbour_box = &mHaloBoxes[mHaloBoxesMapping[*box_iter]];
+            // Establish whether box is locally owned or halo.
+            unsigned slot = IsBoxOwned(*box_iter) ? (*box_iter - mMinBoxIndex)
+                                                  : (num_owned_boxes + mHaloBoxesMapping[*box_iter]);
+            mLocalBoxSlots[i].push_back(std::make_pair(slot, *box_iter));
         }
-        assert(p_neighbour_box);
+    }
+}
+
+template <unsigned DIM>
+void DistributedBoxCollection<DIM>::AddPairsFromBox(unsigned boxIndex,
+                                                    std::vector<std::pair<Node<DIM>*, Node<DIM>*> >& rNodePairs)
+{
+    assert(IsBoxOwned(boxIndex));
+    assert(mLocalBoxSlots.size() == mBoxes.size());
+    const unsigned local_box_index = boxIndex - mMinBoxIndex;
+
+    // The nodes in this box
+    const unsigned box_begin = mSortedBoxStarts[local_box_index];
+    const unsigned box_end = mSortedBoxStarts[local_box_index + 1];
+    if (box_begin == box_end)
+    {
+        return;
+    }
 
-        // Get the set of nodes contained in this box
-        std::set< Node<DIM>* >& r_contained_neighbour_nodes = p_neighbour_box->rGetNodesContained();
+    // Loop over all the local boxes
+    const std::vector<std::pair<unsigned, unsigned> >& r_local_box_slots = mLocalBoxSlots[local_box_index];
+    for (unsigned local_box=0; local_box<r_local_box_slots.size(); local_box++)
+    {
+        const unsigned neighbour_slot = r_local_box_slots[local_box].first;
+        const bool same_box = (r_local_box_slots[local_box].second == boxIndex);
 
-        // Loop over these nodes
-        for (typename std::set<Node<DIM>*>::iterator neighbour_node_iter = r_contained_neighbour_nodes.begin();
-             neighbour_node_iter != r_contained_neighbour_nodes.end();
-             ++neighbour_node_iter)
+        // Loop over the nodes in the neighbouring box
+        for (unsigned neighbour=mSortedBoxStarts[neighbour_slot]; neighbour<mSortedBoxStarts[neighbour_slot+1]; neighbour++)
         {
-            // Get the index of the other node
-            unsigned other_node_index = (*neighbour_node_iter)->GetIndex();
+            Node<DIM>* p_neighbour_node = mSortedNodes[neighbour];
+            const unsigned other_node_index = mSortedNodeIndices[neighbour];
 
             // Loop over nodes in this box
-            for (typename std::set<Node<DIM>*>::iterator node_iter = r_contained_nodes.begin();
-                 node_iter != r_contained_nodes.end();
-                 ++node_iter)
+            for (unsigned node=box_begin; node<box_end; node++)
             {
-                unsigned node_index = (*node_iter)->GetIndex();
+                const unsigned node_index = mSortedNodeIndices[node];
 
                 // If we're in the same box, then take care not to store the node pair twice
-                if (*box_iter != boxIndex || other_node_index > node_index)
+                if (!same_box || other_node_index > node_index)
                 {
-                    rNodePairs.push_back(std::pair<Node<DIM>*, Node<DIM>*>((*node_iter), (*neighbour_node_iter)));
+                    rNodePairs.push_back(std::pair<Node<DIM>*, Node<DIM>*>(mSortedNodes[node], p_neighbour_node));
                     if (mCalculateNodeNeighbours)
                     {
-                        (*node_iter)->AddNeighbour(other_node_index);
-                        (*neighbour_node_iter)->AddNeighbour(node_index);
+                        mSortedNodes[node]->AddNeighbour(other_node_index);
+                        p_neighbour_node->AddNeighbour(node_index);
                     }
                 }
+            }
+        }
+    }
+}
+
+template <unsigned DIM>
+void DistributedBoxCollection<DIM>::AddPairsFromMultiLevelGrid(bool includeInterior,
+                                                               bool includeBoundary,
+                                                               std::vector<std::pair<Node<DIM>*, Node<DIM>*> >& rNodePairs)
+{
+    const unsigned num_owned_boxes = mBoxes.size();
+
+    // The halo boxes are only up to date when the boundary pairs are wanted
+    const unsigned num_nodes = includeBoundary ? mSortedNodes.size() : mSortedBoxStarts[num_owned_boxes];
+    if (num_nodes == 0)
+    {
+        return;
+    }
+
+    // The global index of each halo box, by its local index
+    std::vector<unsigned> halo_box_indices(mHaloBoxes.size());
+    for (std::map<unsigned, unsigned>::const_iterator map_iter = mHaloBoxesMapping.begin();
+         map_iter != mHaloBoxesMapping.end();
+         ++map_iter)
+    {
+        halo_box_indices[map_iter->second] = map_iter->first;
+    }
+
+    // The box, location and radius of each node, in the order of mSortedNodes
+    std::vector<unsigned> node_boxes(num_nodes);
+    std::vector<c_vector<double, DIM> > locations(num_nodes);
+    std::vector<double> radii(num_nodes);
+    double largest_diameter = 0.0;
+    for (unsigned slot=0; mSortedBoxStarts[slot]<num_nodes; slot++)
+    {
+        const unsigned box_index = (slot < num_owned_boxes) ? (mMinBoxIndex + slot)
+                                                            : halo_box_indices[slot - num_owned_boxes];
+        for (unsigned i=mSortedBoxStarts[slot]; i<mSortedBoxStarts[slot+1]; i++)
+        {
+            node_boxes[i] = box_index;
+            locations[i] = mSortedNodes[i]->rGetLocation();
+            radii[i] = mSortedNodes[i]->HasNodeAttributes() ? mSortedNodes[i]->GetRadius() : 0.0;
+            largest_diameter = std::max(largest_diameter, 2.0*radii[i] + mVerletSkin);
+        }
+    }
+
+    MultiLevelNodeGrid<DIM> grid(largest_diameter > 0.0 ? largest_diameter : mBoxWidth);
+    grid.Build(locations, radii, mVerletSkin);
+    std::vector<std::pair<unsigned, unsigned> > candidate_pairs;
+    grid.CalculatePairs(candidate_pairs);
+
+    for (unsigned pair=0; pair<candidate_pairs.size(); pair++)
+    {
+        // Try both orders, to find the one in which the box search would give the pair
+        for (unsigned order=0; order<2; order++)
+        {
+            const unsigned node = (order == 0) ? candidate_pairs[pair].first : candidate_pairs[pair].second;
+            const unsigned neighbour = (order == 0) ? candidate_pairs[pair].second : candidate_pairs[pair].first;
+            const unsigned box_index = node_boxes[node];
+            const unsigned neighbour_box_index = node_boxes[neighbour];
+
+            if (!IsBoxOwned(box_index))
+            {
+                continue;
+            }
+            if (box_index == neighbour_box_index)
+            {
+                if (mSortedNodeIndices[neighbour] <= mSortedNodeIndices[node])
+                {
+                    continue;
+                }
+            }
+            else if (mLocalBoxes[box_index - mMinBoxIndex].count(neighbour_box_index) == 0)
+            {
+                continue;
+            }
 
+            if (IsInteriorBox(box_index) ? includeInterior : includeBoundary)
+            {
+                rNodePairs.push_back(std::pair<Node<DIM>*, Node<DIM>*>(mSortedNodes[node], mSortedNodes[neighbour]));
+                if (mCalculateNodeNeighbours)
+                {
+                    mSortedNodes[node]->AddNeighbour(mSortedNodeIndices[neighbour]);
+                    mSortedNodes[neighbour]->AddNeighbour(mSortedNodeIndices[node]);
+                }
             }
+            break;
         }
     }
 }
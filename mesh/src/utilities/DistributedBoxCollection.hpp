@@ -43,6 +43,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "Box.hpp"
 #include "PetscTools.hpp"
 #include "DistributedVectorFactory.hpp"
+#include "AbstractMemoryAccountable.hpp"
 #include <map>
 #include <vector>
 
@@ -51,7 +52,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  * A collection of 'boxes' partitioning the domain with information on which nodes are located in which box.
  */
 template <unsigned DIM>
-class DistributedBoxCollection
+class DistributedBoxCollection : public AbstractMemoryAccountable
 {
 private:
     friend class TestDistributedBoxCollection;
@@ -101,7 +102,7 @@ private:
     /** The largest index of the boxes owned by this process. */
     unsigned mMaxBoxIndex;
 
-    /** Whether the domain is periodic in the X dimension Note this currently only works for DIM=2.*/
+    /** Whether the domain is periodic in the X dimension. Note this currently only works for DIM=2 or DIM=3. */
     bool mIsPeriodicInX;
 
     /** Whether the local boxes have been setup or not. */
@@ -116,6 +117,60 @@ private:
     /** A flag that can be set to not save rNodeNeighbours in CalculateNodePairs - for efficiency */
     bool mCalculateNodeNeighbours;
 
+    /**
+     * The Verlet skin: how much wider the boxes are than the interaction distance,
+     * which allows the node pairs to be reused until a node moves by half of this.
+     * Defaults to zero, meaning pairs are never reused (see AreNodePairsStillValid()).
+     */
+    double mVerletSkin;
+
+    /** The nodes passed to the last call to RecordNodeLocationsForNodePairs(). */
+    std::vector<Node<DIM>*> mNodesAtLastPairCalculation;
+
+    /** The locations of #mNodesAtLastPairCalculation at the time of that call. */
+    std::vector<c_vector<double, DIM> > mLocationsAtLastPairCalculation;
+
+    /** The radii of #mNodesAtLastPairCalculation at the time of that call. */
+    std::vector<double> mRadiiAtLastPairCalculation;
+
+    /**
+     * Whether to find node pairs with a MultiLevelNodeGrid, keeping only those within the
+     * sum of their radii plus the Verlet skin, rather than taking every pair of nodes in
+     * neighbouring boxes. Defaults to false. Ignored if the domain is periodic in x.
+     */
+    bool mUseMultiLevelPairSearch;
+
+    /**
+     * The nodes in the owned boxes followed by those in the halo boxes, stored contiguously
+     * box by box, so that the pair search does not have to walk each box's std::set of nodes
+     * every time the box is visited. Rebuilt by SortNodesIntoContiguousBoxes().
+     */
+    std::vector<Node<DIM>*> mSortedNodes;
+
+    /** The indices of #mSortedNodes, so that the pair search does not need to dereference them. */
+    std::vector<unsigned> mSortedNodeIndices;
+
+    /**
+     * Where each box's nodes start in #mSortedNodes: owned box i (local index) at
+     * mSortedBoxStarts[i], halo box j at mSortedBoxStarts[mBoxes.size()+j]. Has one extra
+     * entry at the end, so box k's nodes end at mSortedBoxStarts[k+1].
+     */
+    std::vector<unsigned> mSortedBoxStarts;
+
+    /**
+     * For each owned box (by local index), the positions in #mSortedBoxStarts of its local
+     * boxes (see rGetLocalBoxes()), in the same order, with their global indices.
+     */
+    std::vector<std::vector<std::pair<unsigned, unsigned> > > mLocalBoxSlots;
+
+    /**
+     * Copy the contents of the owned and halo boxes into #mSortedNodes, a counting sort of the
+     * nodes by box, and fill in #mLocalBoxSlots, for AddPairsFromBox(). Called at the start of
+     * each pair calculation, as the boxes (in particular the halo boxes) and local boxes may have
+     * changed since the last one.
+     */
+    void SortNodesIntoContiguousBoxes();
+
     /**
      * Setup the halo box structure on this process.
      * (Private method since this is called as a helper method by the constructor.)
@@ -124,6 +179,17 @@ private:
      */
     void SetupHaloBoxes();
 
+    /**
+     * Insert the global index of the box at a given offset (in numbers of boxes) from a given box
+     * into a set, if such a box exists. Offsets in x wrap around the domain if it is periodic in x.
+     * (Private method since this is called as a helper method when setting up the local boxes.)
+     *
+     * @param rLocalBoxes the set of boxes to add to
+     * @param globalIndex the global index of the box
+     * @param offset the offset in each dimension, each -1, 0 or 1
+     */
+    void InsertBoxAtOffset(std::set<unsigned>& rLocalBoxes, unsigned globalIndex, const int offset[DIM]);
+
     /** Needed for serialization **/
     friend class boost::serialization::access;
 
@@ -160,6 +226,14 @@ public:
      */
     ~DistributedBoxCollection();
 
+    /**
+     * Estimate the memory held by this box collection, for MemoryAccounting: the owned and
+     * halo boxes with their node and element sets, and the local box sets.
+     *
+     * @return the estimated number of bytes
+     */
+    double GetMemoryUsage() const;
+
     /**
      * Remove the list of nodes stored in each box.
      */
@@ -284,6 +358,33 @@ public:
      */
     int LoadBalance(std::vector<int> localDistribution);
 
+    /**
+     * An alternative to LoadBalance() which balances the whole domain in one go, rather
+     * than moving each boundary by at most one row at a time. The loads of all the rows
+     * are gathered on every process, and each boundary between processes is placed as
+     * close as possible to where it would equally divide the total load (see
+     * CalculateBalancedPartition()). This must be called on all processes together.
+     *
+     * @param localDistribution a vector containing the number of nodes in each row/face of boxes in 2d/3d
+     * @return the updated number of rows owned by this process.
+     */
+    int LoadBalanceGlobally(std::vector<int> localDistribution);
+
+    /**
+     * Work out a partition of rows of boxes between processes which balances the loads.
+     *
+     * So that nodes and cells only ever have to move to a neighbouring process, each
+     * new boundary is kept within the rows currently owned by the two processes either
+     * side of it. Each process keeps at least two rows, or one if some process already
+     * has only one.
+     *
+     * @param rLoads the load of each row, over all processes
+     * @param rCurrentStarts the first row owned by each process, followed by the total number of rows
+     * @return the first row to be owned by each process, followed by the total number of rows.
+     */
+    static std::vector<unsigned> CalculateBalancedPartition(const std::vector<int>& rLoads,
+                                                            const std::vector<unsigned>& rCurrentStarts);
+
     /**
      *  Set up the local boxes (ie itself and its nearest-neighbours) for each of the boxes.
      *  This method just sets up half of the local boxes (for example, in 1D, local boxes for box0 = {1}
@@ -342,6 +443,55 @@ public:
      */
     void SetCalculateNodeNeighbours(bool calculateNodeNeighbours);
 
+    /**
+     * Set the Verlet skin. The caller is responsible for making the box width
+     * the interaction distance plus this skin.
+     *
+     * @param skin the skin width (must be non-negative).
+     */
+    void SetVerletSkin(double skin);
+
+    /**
+     * @return #mVerletSkin.
+     */
+    double GetVerletSkin() const;
+
+    /**
+     * Set whether to find node pairs with a hierarchy of grids sized by the node radii
+     * (see MultiLevelNodeGrid), which only returns the pairs of nodes within the sum of
+     * their radii plus the Verlet skin. This is much cheaper than the box search when
+     * the radii vary widely and the box width is set by the largest of them. Ignored if
+     * the domain is periodic in x.
+     *
+     * @param useMultiLevelPairSearch whether to use the multi-level search
+     */
+    void SetUseMultiLevelPairSearch(bool useMultiLevelPairSearch);
+
+    /**
+     * @return #mUseMultiLevelPairSearch.
+     */
+    bool GetUseMultiLevelPairSearch() const;
+
+    /**
+     * Record the nodes and their locations, to be called straight after the node
+     * pairs have been calculated.
+     *
+     * @param rNodes the nodes the pairs were calculated for
+     */
+    void RecordNodeLocationsForNodePairs(std::vector<Node<DIM>*>& rNodes);
+
+    /**
+     * @return whether node pairs calculated when RecordNodeLocationsForNodePairs() was
+     * last called still contain every pair of nodes less than (box width - skin) apart.
+     * This is the case if the nodes are the same and none has moved by skin/2 or more
+     * (and, with the multi-level search, none has grown).
+     * Always false if the skin is zero or in parallel, where the halo nodes are
+     * recreated on every exchange.
+     *
+     * @param rNodes the current nodes
+     */
+    bool AreNodePairsStillValid(std::vector<Node<DIM>*>& rNodes);
+
     /**
      *  Compute all the pairs of (potentially) connected nodes for cell_based simulations, ie nodes which are in a
      *  local box to the box containing the first node. **Note: the user still has to check that the node
@@ -371,12 +521,29 @@ public:
 
     /**
      * A method pulled out of CalculateNodePairs methods that adds all pairs of nodes from neighbouring boxes of the box with index boxIndex.
+     * Works on the copy of the box contents made by the last call to SortNodesIntoContiguousBoxes()
+     * at the start of the calling CalculateNodePairs method.
      *
      * @param boxIndex the box to add neighbours to.
      * @param rNodePairs the return value, a set of pairs of nodes
      */
     void AddPairsFromBox(unsigned boxIndex, std::vector<std::pair<Node<DIM>*, Node<DIM>*> >& rNodePairs);
 
+    /**
+     * The alternative to calling AddPairsFromBox() on each owned box used when
+     * #mUseMultiLevelPairSearch is set. Finds the pairs of nodes within the sum of their radii
+     * plus the Verlet skin with a MultiLevelNodeGrid, and adds each one that the box search
+     * would have given, as it would have given it, if the owned box it would come from is
+     * of the required kind.
+     *
+     * @param includeInterior whether to add pairs from interior boxes (see IsInteriorBox())
+     * @param includeBoundary whether to add pairs from the other owned boxes, which may involve halo nodes
+     * @param rNodePairs the return value, a set of pairs of nodes
+     */
+    void AddPairsFromMultiLevelGrid(bool includeInterior,
+                                    bool includeBoundary,
+                                    std::vector<std::pair<Node<DIM>*, Node<DIM>*> >& rNodePairs);
+
     /**
      * Calculate how many cells lie in each strip / face of boxes, used in load balancing
      *
@@ -405,7 +572,7 @@ inline void save_construct_data(
     // good load balance
     int num_local_rows = (int)(t->GetNumRowsOfBoxes());
     std::vector<int> num_rows(PetscTools::GetNumProcs());
-    MPI_Gather(&num_local_rows, 1, MPI_INT, &num_rows[0], 1, MPI_INT, 0, PETSC_COMM_WORLD);
+    MPI_Gather(&num_local_rows, 1, MPI_INT, &num_rows[0], 1, MPI_INT, 0, PetscTools::GetWorld());
 
     if (PetscTools::AmMaster())
     {
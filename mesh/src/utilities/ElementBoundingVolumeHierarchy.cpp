@@ -0,0 +1,296 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "ElementBoundingVolumeHierarchy.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <limits>
+
+template <unsigned DIM>
+ElementBoundingVolumeHierarchy<DIM>::ElementBoundingVolumeHierarchy(AbstractTetrahedralMesh<DIM, DIM>& rMesh,
+                                                                    const std::set<unsigned>& rElementIndices)
+    : mrMesh(rMesh),
+      mElementIndices(rElementIndices.begin(), rElementIndices.end()),
+      mMaxElementWidth(0.0)
+{
+    // The bounding box of each element, from its vertices, enlarged slightly so
+    // points on the surface of the element (as accepted by Element::IncludesPoint())
+    // are inside the box
+    std::vector<std::pair<c_vector<double, DIM>, c_vector<double, DIM> > > boxes(mElementIndices.size());
+    for (unsigned i=0; i<mElementIndices.size(); i++)
+    {
+        Element<DIM, DIM>* p_element = mrMesh.GetElement(mElementIndices[i]);
+        c_vector<double, DIM> lower = p_element->GetNodeLocation(0);
+        c_vector<double, DIM> upper = lower;
+        for (unsigned j=1; j<DIM+1; j++) // num vertices per element
+        {
+            const c_vector<double, DIM>& r_location = p_element->GetNode(j)->rGetLocation();
+            for (unsigned d=0; d<DIM; d++)
+            {
+                lower[d] = std::min(lower[d], r_location[d]);
+                upper[d] = std::max(upper[d], r_location[d]);
+            }
+        }
+        double width = 0.0;
+        for (unsigned d=0; d<DIM; d++)
+        {
+            width = std::max(width, upper[d] - lower[d]);
+        }
+        double tolerance = 1e-8*width + DBL_EPSILON;
+        for (unsigned d=0; d<DIM; d++)
+        {
+            lower[d] -= tolerance;
+            upper[d] += tolerance;
+        }
+        boxes[i] = std::make_pair(lower, upper);
+        mMaxElementWidth = std::max(mMaxElementWidth, width);
+    }
+
+    // Build the tree, reordering mElementIndices (and the boxes with them)
+    mElementLower.resize(mElementIndices.size());
+    mElementUpper.resize(mElementIndices.size());
+    for (unsigned i=0; i<mElementIndices.size(); i++)
+    {
+        mElementLower[i] = boxes[i].first;
+        mElementUpper[i] = boxes[i].second;
+    }
+    if (!mElementIndices.empty())
+    {
+        mTreeNodes.reserve(2*mElementIndices.size()/MAX_ELEMENTS_PER_LEAF + 1);
+        BuildSubtree(0, mElementIndices.size());
+    }
+}
+
+template <unsigned DIM>
+void ElementBoundingVolumeHierarchy<DIM>::BuildSubtree(unsigned first, unsigned count)
+{
+    unsigned node_index = mTreeNodes.size();
+    mTreeNodes.push_back(TreeNode());
+
+    // The box containing all the elements in the range, and the spread of their centres
+    c_vector<double, DIM> lower = mElementLower[first];
+    c_vector<double, DIM> upper = mElementUpper[first];
+    c_vector<double, DIM> min_centre = 0.5*(mElementLower[first] + mElementUpper[first]);
+    c_vector<double, DIM> max_centre = min_centre;
+    for (unsigned i=first+1; i<first+count; i++)
+    {
+        for (unsigned d=0; d<DIM; d++)
+        {
+            lower[d] = std::min(lower[d], mElementLower[i][d]);
+            upper[d] = std::max(upper[d], mElementUpper[i][d]);
+            double centre = 0.5*(mElementLower[i][d] + mElementUpper[i][d]);
+            min_centre[d] = std::min(min_centre[d], centre);
+            max_centre[d] = std::max(max_centre[d], centre);
+        }
+    }
+    mTreeNodes[node_index].Lower = lower;
+    mTreeNodes[node_index].Upper = upper;
+
+    if (count <= MAX_ELEMENTS_PER_LEAF)
+    {
+        mTreeNodes[node_index].First = first;
+        mTreeNodes[node_index].Count = count;
+        mTreeNodes[node_index].SecondChild = 0u;
+        return;
+    }
+
+    unsigned split_direction = 0;
+    for (unsigned d=1; d<DIM; d++)
+    {
+        if (max_centre[d] - min_centre[d] > max_centre[split_direction] - min_centre[split_direction])
+        {
+            split_direction = d;
+        }
+    }
+
+    // Partition the range about the median centre in that direction
+    std::vector<unsigned> order(count);
+    for (unsigned i=0; i<count; i++)
+    {
+        order[i] = first + i;
+    }
+    unsigned half = count/2;
+    std::nth_element(order.begin(), order.begin() + half, order.end(),
+                     [this, split_direction](unsigned a, unsigned b)
+                     {
+                         return   mElementLower[a][split_direction] + mElementUpper[a][split_direction]
+                                < mElementLower[b][split_direction] + mElementUpper[b][split_direction];
+                     });
+
+    std::vector<unsigned> indices(count);
+    std::vector<c_vector<double, DIM> > element_lower(count);
+    std::vector<c_vector<double, DIM> > element_upper(count);
+    for (unsigned i=0; i<count; i++)
+    {
+        indices[i] = mElementIndices[order[i]];
+        element_lower[i] = mElementLower[order[i]];
+        element_upper[i] = mElementUpper[order[i]];
+    }
+    std::copy(indices.begin(), indices.end(), mElementIndices.begin() + first);
+    std::copy(element_lower.begin(), element_lower.end(), mElementLower.begin() + first);
+    std::copy(element_upper.begin(), element_upper.end(), mElementUpper.begin() + first);
+
+    mTreeNodes[node_index].First = first;
+    mTreeNodes[node_index].Count = 0u;
+    BuildSubtree(first, half);
+    mTreeNodes[node_index].SecondChild = mTreeNodes.size();
+    BuildSubtree(first + half, count - half);
+}
+
+template <unsigned DIM>
+double ElementBoundingVolumeHierarchy<DIM>::SquaredDistanceToBox(const c_vector<double, DIM>& rPoint,
+                                                                 const c_vector<double, DIM>& rLower,
+                                                                 const c_vector<double, DIM>& rUpper)
+{
+    double squared_distance = 0.0;
+    for (unsigned d=0; d<DIM; d++)
+    {
+        double outside = std::max(rLower[d] - rPoint[d], rPoint[d] - rUpper[d]);
+        if (outside > 0.0)
+        {
+            squared_distance += outside*outside;
+        }
+    }
+    return squared_distance;
+}
+
+template <unsigned DIM>
+void ElementBoundingVolumeHierarchy<DIM>::CollectElementsWithinDistance(const c_vector<double, DIM>& rPoint,
+                                                                        double squaredDistance,
+                                                                        std::set<unsigned>& rElementIndices) const
+{
+    if (mTreeNodes.empty())
+    {
+        return;
+    }
+
+    std::vector<unsigned> stack(1, 0u);
+    while (!stack.empty())
+    {
+        unsigned node_index = stack.back();
+        stack.pop_back();
+        const TreeNode& r_node = mTreeNodes[node_index];
+
+        if (SquaredDistanceToBox(rPoint, r_node.Lower, r_node.Upper) > squaredDistance)
+        {
+            continue;
+        }
+        if (r_node.Count > 0u)
+        {
+            for (unsigned i=r_node.First; i<r_node.First+r_node.Count; i++)
+            {
+                if (SquaredDistanceToBox(rPoint, mElementLower[i], mElementUpper[i]) <= squaredDistance)
+                {
+                    rElementIndices.insert(mElementIndices[i]);
+                }
+            }
+        }
+        else
+        {
+            stack.push_back(r_node.SecondChild);
+            stack.push_back(node_index + 1);
+        }
+    }
+}
+
+template <unsigned DIM>
+unsigned ElementBoundingVolumeHierarchy<DIM>::GetNumElements() const
+{
+    return mElementIndices.size();
+}
+
+template <unsigned DIM>
+void ElementBoundingVolumeHierarchy<DIM>::GetCandidateContainingElements(const c_vector<double, DIM>& rPoint,
+                                                                         std::set<unsigned>& rElementIndices) const
+{
+    CollectElementsWithinDistance(rPoint, 0.0, rElementIndices);
+}
+
+template <unsigned DIM>
+void ElementBoundingVolumeHierarchy<DIM>::GetCandidateNearestElements(const c_vector<double, DIM>& rPoint,
+                                                                      std::set<unsigned>& rElementIndices) const
+{
+    if (mTreeNodes.empty())
+    {
+        return;
+    }
+
+    // Branch and bound for the distance to the nearest element bounding box,
+    // visiting the nearer child first
+    double best_squared_distance = std::numeric_limits<double>::max();
+    std::vector<unsigned> stack(1, 0u);
+    while (!stack.empty())
+    {
+        unsigned node_index = stack.back();
+        stack.pop_back();
+        const TreeNode& r_node = mTreeNodes[node_index];
+
+        if (SquaredDistanceToBox(rPoint, r_node.Lower, r_node.Upper) >= best_squared_distance)
+        {
+            continue;
+        }
+        if (r_node.Count > 0u)
+        {
+            for (unsigned i=r_node.First; i<r_node.First+r_node.Count; i++)
+            {
+                best_squared_distance = std::min(best_squared_distance,
+                                                 SquaredDistanceToBox(rPoint, mElementLower[i], mElementUpper[i]));
+            }
+        }
+        else
+        {
+            unsigned first_child = node_index + 1;
+            unsigned second_child = r_node.SecondChild;
+            if (  SquaredDistanceToBox(rPoint, mTreeNodes[first_child].Lower, mTreeNodes[first_child].Upper)
+                < SquaredDistanceToBox(rPoint, mTreeNodes[second_child].Lower, mTreeNodes[second_child].Upper))
+            {
+                std::swap(first_child, second_child);
+            }
+            stack.push_back(first_child);
+            stack.push_back(second_child);
+        }
+    }
+
+    // The nearest element (in the sense of GetNearestElementIndexFromTestElements())
+    // needn't have the nearest bounding box, so also take those a little further away
+    double search_distance = sqrt(best_squared_distance) + mMaxElementWidth;
+    CollectElementsWithinDistance(rPoint, search_distance*search_distance, rElementIndices);
+}
+
+// Explicit instantiation
+template class ElementBoundingVolumeHierarchy<1>;
+template class ElementBoundingVolumeHierarchy<2>;
+template class ElementBoundingVolumeHierarchy<3>;
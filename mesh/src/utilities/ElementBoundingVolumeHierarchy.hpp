@@ -0,0 +1,171 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef ELEMENTBOUNDINGVOLUMEHIERARCHY_HPP_
+#define ELEMENTBOUNDINGVOLUMEHIERARCHY_HPP_
+
+#include <set>
+#include <vector>
+
+#include "UblasIncludes.hpp"
+#include "AbstractTetrahedralMesh.hpp"
+
+/**
+ * A bounding volume hierarchy (a binary tree of axis-aligned bounding boxes) over
+ * a set of elements of a mesh, for locating the element containing, or nearest to,
+ * a point in O(log(number of elements)) time rather than by testing every element.
+ *
+ * The elements' bounding boxes are computed when the hierarchy is constructed, so
+ * it must be rebuilt if the mesh moves.
+ */
+template <unsigned DIM>
+class ElementBoundingVolumeHierarchy
+{
+private:
+    friend class TestElementBoundingVolumeHierarchy;
+
+    /** A node of the tree: a bounding box and either two children or a range of elements. */
+    struct TreeNode
+    {
+        /** Lower corner of the box containing all the elements below this node. */
+        c_vector<double, DIM> Lower;
+
+        /** Upper corner of the box containing all the elements below this node. */
+        c_vector<double, DIM> Upper;
+
+        /** First position in mElementIndices of the elements of a leaf. */
+        unsigned First;
+
+        /** Number of elements of a leaf, or 0 if this is not a leaf. */
+        unsigned Count;
+
+        /** Index in mTreeNodes of the second child (the first child follows this node). */
+        unsigned SecondChild;
+    };
+
+    /** Maximum number of elements in a leaf of the tree. */
+    static const unsigned MAX_ELEMENTS_PER_LEAF = 8u;
+
+    /** The mesh. */
+    AbstractTetrahedralMesh<DIM, DIM>& mrMesh;
+
+    /** Indices of the elements in the hierarchy, ordered so each leaf holds a contiguous range. */
+    std::vector<unsigned> mElementIndices;
+
+    /** Lower corners of the elements' bounding boxes, in the order of mElementIndices. */
+    std::vector<c_vector<double, DIM> > mElementLower;
+
+    /** Upper corners of the elements' bounding boxes, in the order of mElementIndices. */
+    std::vector<c_vector<double, DIM> > mElementUpper;
+
+    /** The nodes of the tree, the root first. */
+    std::vector<TreeNode> mTreeNodes;
+
+    /** Largest width of any element's bounding box in any direction. */
+    double mMaxElementWidth;
+
+    /**
+     * Create the subtree for a range of elements, recursively splitting at the median
+     * of the element centres along the direction in which they are most spread out.
+     *
+     * @param first First position in mElementIndices of the range
+     * @param count Number of elements in the range
+     */
+    void BuildSubtree(unsigned first, unsigned count);
+
+    /**
+     * @return the square of the distance from a point to a box (zero if inside it).
+     *
+     * @param rPoint The point
+     * @param rLower Lower corner of the box
+     * @param rUpper Upper corner of the box
+     */
+    static double SquaredDistanceToBox(const c_vector<double, DIM>& rPoint,
+                                       const c_vector<double, DIM>& rLower,
+                                       const c_vector<double, DIM>& rUpper);
+
+    /**
+     * Collect the elements whose bounding box is within a given distance of a point.
+     *
+     * @param rPoint The point
+     * @param squaredDistance The square of the distance
+     * @param rElementIndices Set to which the element indices are added
+     */
+    void CollectElementsWithinDistance(const c_vector<double, DIM>& rPoint,
+                                       double squaredDistance,
+                                       std::set<unsigned>& rElementIndices) const;
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param rMesh The mesh
+     * @param rElementIndices The (global) indices of the elements of the mesh to include,
+     *     which must all be available on this process
+     */
+    ElementBoundingVolumeHierarchy(AbstractTetrahedralMesh<DIM, DIM>& rMesh,
+                                   const std::set<unsigned>& rElementIndices);
+
+    /**
+     * @return the number of elements in the hierarchy.
+     */
+    unsigned GetNumElements() const;
+
+    /**
+     * Get the elements whose bounding boxes contain a point: the candidates for the
+     * element containing the point, which can be given to
+     * AbstractTetrahedralMesh::GetContainingElementIndex(). As the set is ordered, this
+     * finds the lowest-indexed containing element.
+     *
+     * @param rPoint The point
+     * @param rElementIndices Set to which the element indices are added (not cleared)
+     */
+    void GetCandidateContainingElements(const c_vector<double, DIM>& rPoint,
+                                        std::set<unsigned>& rElementIndices) const;
+
+    /**
+     * Get the elements near a point that is not in any of them: those whose bounding
+     * boxes are within the largest element width of the nearest bounding box. These are
+     * suitable test elements for AbstractTetrahedralMesh::GetNearestElementIndexFromTestElements().
+     *
+     * @param rPoint The point
+     * @param rElementIndices Set to which the element indices are added (not cleared)
+     */
+    void GetCandidateNearestElements(const c_vector<double, DIM>& rPoint,
+                                     std::set<unsigned>& rElementIndices) const;
+};
+
+#endif /*ELEMENTBOUNDINGVOLUMEHIERARCHY_HPP_*/
@@ -0,0 +1,237 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "MultiLevelNodeGrid.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Exception.hpp"
+
+/** The number of bits of a cell key used for each grid index. */
+static const unsigned BITS_PER_DIMENSION = 21u;
+
+template <unsigned DIM>
+MultiLevelNodeGrid<DIM>::MultiLevelNodeGrid(double coarsestWidth, unsigned maxNumLevels)
+    : mCoarsestWidth(coarsestWidth),
+      mMaxNumLevels(maxNumLevels),
+      mOrigin(zero_vector<double>(DIM)),
+      mSkin(0.0)
+{
+    if (coarsestWidth <= 0.0)
+    {
+        EXCEPTION("The width of the coarsest grid must be positive.");
+    }
+    if (maxNumLevels == 0u)
+    {
+        EXCEPTION("A multi-level grid needs at least one level.");
+    }
+}
+
+template <unsigned DIM>
+unsigned long long MultiLevelNodeGrid<DIM>::CalculateKey(const c_vector<unsigned, DIM>& rIndices) const
+{
+    unsigned long long key = 0;
+    for (unsigned d=0; d<DIM; d++)
+    {
+        key = (key << BITS_PER_DIMENSION) | rIndices[d];
+    }
+    return key;
+}
+
+template <unsigned DIM>
+c_vector<unsigned, DIM> MultiLevelNodeGrid<DIM>::CalculateGridIndices(const c_vector<double, DIM>& rLocation, unsigned level) const
+{
+    c_vector<unsigned, DIM> indices;
+    for (unsigned d=0; d<DIM; d++)
+    {
+        indices[d] = 1u + (unsigned)floor((rLocation[d] - mOrigin[d])/mWidths[level]);
+    }
+    return indices;
+}
+
+template <unsigned DIM>
+void MultiLevelNodeGrid<DIM>::Build(const std::vector<c_vector<double, DIM> >& rLocations,
+                                    const std::vector<double>& rRadii,
+                                    double skin)
+{
+    assert(rLocations.size() == rRadii.size());
+    assert(skin >= 0.0);
+    mLocations = rLocations;
+    mRadii = rRadii;
+    mSkin = skin;
+    const unsigned num_points = mLocations.size();
+
+    // The grids start at the lower corner of the points' bounding box
+    double largest_extent = 0.0;
+    double smallest_diameter = mCoarsestWidth;
+    if (num_points > 0)
+    {
+        c_vector<double, DIM> upper = mLocations[0];
+        mOrigin = mLocations[0];
+        for (unsigned i=0; i<num_points; i++)
+        {
+            for (unsigned d=0; d<DIM; d++)
+            {
+                mOrigin[d] = std::min(mOrigin[d], mLocations[i][d]);
+                upper[d] = std::max(upper[d], mLocations[i][d]);
+            }
+            double diameter = 2.0*mRadii[i] + mSkin;
+            if (diameter > mCoarsestWidth*(1.0 + 1e-12))
+            {
+                EXCEPTION("A point has interaction diameter " << diameter << ", which is wider than the coarsest grid ("
+                          << mCoarsestWidth << ").");
+            }
+            smallest_diameter = std::min(smallest_diameter, diameter);
+        }
+        for (unsigned d=0; d<DIM; d++)
+        {
+            largest_extent = std::max(largest_extent, upper[d] - mOrigin[d]);
+        }
+    }
+
+    // Only make levels as fine as the smallest point needs, and as the cell keys allow
+    const double largest_index = (double)((1u << BITS_PER_DIMENSION) - 3u);
+    mWidths.assign(1u, mCoarsestWidth);
+    while (mWidths.size() < mMaxNumLevels
+           && 0.5*mWidths.back() >= smallest_diameter
+           && largest_extent/(0.5*mWidths.back()) < largest_index)
+    {
+        mWidths.push_back(0.5*mWidths.back());
+    }
+    if (largest_extent/mCoarsestWidth >= largest_index)
+    {
+        EXCEPTION("The points are spread over too many grid cells for a multi-level grid.");
+    }
+
+    // Put each point on the finest level that is wide enough for it
+    const unsigned num_levels = mWidths.size();
+    mLevels.resize(num_points);
+    mCellContents.assign(num_levels, std::vector<std::pair<unsigned long long, unsigned> >());
+    for (unsigned i=0; i<num_points; i++)
+    {
+        double diameter = 2.0*mRadii[i] + mSkin;
+        unsigned level = 0;
+        while (level+1 < num_levels && mWidths[level+1] >= diameter)
+        {
+            level++;
+        }
+        mLevels[i] = level;
+        mCellContents[level].push_back(std::make_pair(CalculateKey(CalculateGridIndices(mLocations[i], level)), i));
+    }
+    for (unsigned level=0; level<num_levels; level++)
+    {
+        std::sort(mCellContents[level].begin(), mCellContents[level].end());
+    }
+}
+
+template <unsigned DIM>
+unsigned MultiLevelNodeGrid<DIM>::GetNumLevels() const
+{
+    return mWidths.size();
+}
+
+template <unsigned DIM>
+unsigned MultiLevelNodeGrid<DIM>::GetLevel(unsigned pointIndex) const
+{
+    assert(pointIndex < mLevels.size());
+    return mLevels[pointIndex];
+}
+
+template <unsigned DIM>
+void MultiLevelNodeGrid<DIM>::CalculatePairs(std::vector<std::pair<unsigned, unsigned> >& rPairs) const
+{
+    rPairs.clear();
+
+    unsigned num_neighbouring_cells = 1;
+    for (unsigned d=0; d<DIM; d++)
+    {
+        num_neighbouring_cells *= 3;
+    }
+
+    for (unsigned i=0; i<mLocations.size(); i++)
+    {
+        const unsigned level_i = mLevels[i];
+
+        // Look on this point's level and every coarser one: a pair is found by the point on the finer level
+        for (unsigned level=0; level<=level_i; level++)
+        {
+            const std::vector<std::pair<unsigned long long, unsigned> >& r_contents = mCellContents[level];
+            if (r_contents.empty())
+            {
+                continue;
+            }
+            const c_vector<unsigned, DIM> centre = CalculateGridIndices(mLocations[i], level);
+
+            for (unsigned neighbour=0; neighbour<num_neighbouring_cells; neighbour++)
+            {
+                // Offsets of -1, 0 or +1 in each direction
+                c_vector<unsigned, DIM> indices;
+                unsigned remainder = neighbour;
+                for (unsigned d=0; d<DIM; d++)
+                {
+                    indices[d] = centre[d] + (remainder % 3) - 1u;
+                    remainder /= 3;
+                }
+
+                std::pair<unsigned long long, unsigned> first(CalculateKey(indices), 0u);
+                for (typename std::vector<std::pair<unsigned long long, unsigned> >::const_iterator it = std::lower_bound(r_contents.begin(), r_contents.end(), first);
+                     it != r_contents.end() && it->first == first.first;
+                     ++it)
+                {
+                    const unsigned j = it->second;
+
+                    // On the same level, only take each pair once
+                    if (level == level_i && j <= i)
+                    {
+                        continue;
+                    }
+
+                    const double interaction_distance = mRadii[i] + mRadii[j] + mSkin;
+                    if (norm_2(mLocations[i] - mLocations[j]) <= interaction_distance)
+                    {
+                        rPairs.push_back(std::make_pair(i, j));
+                    }
+                }
+            }
+        }
+    }
+}
+
+///////// Explicit instantiation///////
+
+template class MultiLevelNodeGrid<1>;
+template class MultiLevelNodeGrid<2>;
+template class MultiLevelNodeGrid<3>;
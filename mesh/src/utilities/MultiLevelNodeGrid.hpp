@@ -0,0 +1,148 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef MULTILEVELNODEGRID_HPP_
+#define MULTILEVELNODEGRID_HPP_
+
+#include <utility>
+#include <vector>
+
+#include "UblasIncludes.hpp"
+
+/**
+ * A hierarchy of uniform grids for finding the pairs of points (nodes) which are within
+ * the sum of their radii (plus a skin) of each other, when the radii vary widely.
+ *
+ * Level 0 has cells of the given (coarsest) width and each further level halves the
+ * width. Each point is put on the finest level whose cells are at least as wide as its
+ * interaction diameter (twice its radius plus the skin), and looks for partners on its
+ * own level and every coarser one, in the 3^DIM cells around it. A pair is therefore
+ * found by its smaller member, and the number of points examined is proportional to the
+ * number of real neighbours rather than to the number of points within the largest
+ * interaction distance, as it is for a single grid sized for the largest point.
+ */
+template <unsigned DIM>
+class MultiLevelNodeGrid
+{
+private:
+    friend class TestMultiLevelNodeGrid;
+
+    /** Width of the cells of the coarsest level. */
+    double mCoarsestWidth;
+
+    /** The largest number of levels to use. */
+    unsigned mMaxNumLevels;
+
+    /** Lower corner of the grids: the lower corner of the points' bounding box. */
+    c_vector<double, DIM> mOrigin;
+
+    /** Locations of the points. */
+    std::vector<c_vector<double, DIM> > mLocations;
+
+    /** Radii of the points. */
+    std::vector<double> mRadii;
+
+    /** The skin added to the sum of radii of each pair. */
+    double mSkin;
+
+    /** The level each point is on. */
+    std::vector<unsigned> mLevels;
+
+    /** The width of the cells on each level. */
+    std::vector<double> mWidths;
+
+    /** For each level, its points by cell: (cell key, point index) sorted by key. */
+    std::vector<std::vector<std::pair<unsigned long long, unsigned> > > mCellContents;
+
+    /**
+     * @return the key of the cell with the given grid indices, each of which is offset by one
+     *     so that the cells around cell 0 have non-negative indices.
+     *
+     * @param rIndices The grid indices of the cell, plus one
+     */
+    unsigned long long CalculateKey(const c_vector<unsigned, DIM>& rIndices) const;
+
+    /**
+     * @return the grid indices (plus one) of the cell containing a location on a level.
+     *
+     * @param rLocation The location
+     * @param level The level
+     */
+    c_vector<unsigned, DIM> CalculateGridIndices(const c_vector<double, DIM>& rLocation, unsigned level) const;
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param coarsestWidth The width of the cells of the coarsest level, which must be at
+     *     least the largest interaction diameter (twice the radius plus the skin) of any point
+     * @param maxNumLevels The largest number of levels to use (defaults to 10)
+     */
+    MultiLevelNodeGrid(double coarsestWidth, unsigned maxNumLevels=10u);
+
+    /**
+     * Sort points into the grids, replacing any from a previous call.
+     *
+     * @param rLocations The locations of the points
+     * @param rRadii The radii of the points
+     * @param skin The skin added to the sum of radii of each pair (defaults to 0)
+     */
+    void Build(const std::vector<c_vector<double, DIM> >& rLocations,
+               const std::vector<double>& rRadii,
+               double skin=0.0);
+
+    /**
+     * @return the number of levels used by the last call to Build().
+     */
+    unsigned GetNumLevels() const;
+
+    /**
+     * @return the level of a point.
+     *
+     * @param pointIndex The index of the point
+     */
+    unsigned GetLevel(unsigned pointIndex) const;
+
+    /**
+     * Find all pairs of points which are no further apart than the sum of their radii
+     * plus the skin. Each pair is given once, in no particular order.
+     *
+     * @param rPairs The pairs of point indices (cleared first)
+     */
+    void CalculatePairs(std::vector<std::pair<unsigned, unsigned> >& rPairs) const;
+};
+
+#endif /*MULTILEVELNODEGRID_HPP_*/
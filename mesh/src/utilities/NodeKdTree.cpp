@@ -0,0 +1,212 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "NodeKdTree.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <limits>
+
+template <unsigned DIM>
+NodeKdTree<DIM>::NodeKdTree(const std::vector<c_vector<double, DIM> >& rLocations)
+    : mPointIndices(rLocations.size()),
+      mLocations(rLocations)
+{
+    for (unsigned i=0; i<mPointIndices.size(); i++)
+    {
+        mPointIndices[i] = i;
+    }
+    if (!mPointIndices.empty())
+    {
+        mTreeNodes.reserve(2*mPointIndices.size()/MAX_POINTS_PER_LEAF + 1);
+        BuildSubtree(0, mPointIndices.size());
+    }
+}
+
+template <unsigned DIM>
+void NodeKdTree<DIM>::BuildSubtree(unsigned first, unsigned count)
+{
+    unsigned node_index = mTreeNodes.size();
+    mTreeNodes.push_back(TreeNode());
+
+    // The box containing all the points in the range
+    c_vector<double, DIM> lower = mLocations[first];
+    c_vector<double, DIM> upper = lower;
+    for (unsigned i=first+1; i<first+count; i++)
+    {
+        for (unsigned d=0; d<DIM; d++)
+        {
+            lower[d] = std::min(lower[d], mLocations[i][d]);
+            upper[d] = std::max(upper[d], mLocations[i][d]);
+        }
+    }
+    mTreeNodes[node_index].Lower = lower;
+    mTreeNodes[node_index].Upper = upper;
+
+    if (count <= MAX_POINTS_PER_LEAF)
+    {
+        mTreeNodes[node_index].First = first;
+        mTreeNodes[node_index].Count = count;
+        mTreeNodes[node_index].SecondChild = 0u;
+        return;
+    }
+
+    unsigned split_direction = 0;
+    for (unsigned d=1; d<DIM; d++)
+    {
+        if (upper[d] - lower[d] > upper[split_direction] - lower[split_direction])
+        {
+            split_direction = d;
+        }
+    }
+
+    // Partition the range about the median in that direction
+    std::vector<unsigned> order(count);
+    for (unsigned i=0; i<count; i++)
+    {
+        order[i] = first + i;
+    }
+    unsigned half = count/2;
+    std::nth_element(order.begin(), order.begin() + half, order.end(),
+                     [this, split_direction](unsigned a, unsigned b)
+                     {
+                         return mLocations[a][split_direction] < mLocations[b][split_direction];
+                     });
+
+    std::vector<unsigned> indices(count);
+    std::vector<c_vector<double, DIM> > locations(count);
+    for (unsigned i=0; i<count; i++)
+    {
+        indices[i] = mPointIndices[order[i]];
+        locations[i] = mLocations[order[i]];
+    }
+    std::copy(indices.begin(), indices.end(), mPointIndices.begin() + first);
+    std::copy(locations.begin(), locations.end(), mLocations.begin() + first);
+
+    mTreeNodes[node_index].First = first;
+    mTreeNodes[node_index].Count = 0u;
+    BuildSubtree(first, half);
+    mTreeNodes[node_index].SecondChild = mTreeNodes.size();
+    BuildSubtree(first + half, count - half);
+}
+
+template <unsigned DIM>
+double NodeKdTree<DIM>::SquaredDistanceToBox(const c_vector<double, DIM>& rPoint,
+                                             const c_vector<double, DIM>& rLower,
+                                             const c_vector<double, DIM>& rUpper)
+{
+    double squared_distance = 0.0;
+    for (unsigned d=0; d<DIM; d++)
+    {
+        double outside = std::max(rLower[d] - rPoint[d], rPoint[d] - rUpper[d]);
+        if (outside > 0.0)
+        {
+            squared_distance += outside*outside;
+        }
+    }
+    return squared_distance;
+}
+
+template <unsigned DIM>
+unsigned NodeKdTree<DIM>::GetNumPoints() const
+{
+    return mPointIndices.size();
+}
+
+template <unsigned DIM>
+unsigned NodeKdTree<DIM>::GetNearestPoint(const c_vector<double, DIM>& rLocation) const
+{
+    unsigned best_index = UINT_MAX;
+    double best_squared_distance = std::numeric_limits<double>::max();
+    if (mTreeNodes.empty())
+    {
+        return best_index;
+    }
+
+    // Branch and bound, visiting the nearer child first. Boxes at exactly the best
+    // distance are still visited so that ties go to the lowest index.
+    std::vector<unsigned> stack(1, 0u);
+    while (!stack.empty())
+    {
+        unsigned node_index = stack.back();
+        stack.pop_back();
+        const TreeNode& r_node = mTreeNodes[node_index];
+
+        if (SquaredDistanceToBox(rLocation, r_node.Lower, r_node.Upper) > best_squared_distance)
+        {
+            continue;
+        }
+        if (r_node.Count > 0u)
+        {
+            for (unsigned i=r_node.First; i<r_node.First+r_node.Count; i++)
+            {
+                double squared_distance = 0.0;
+                for (unsigned d=0; d<DIM; d++)
+                {
+                    double difference = mLocations[i][d] - rLocation[d];
+                    squared_distance += difference*difference;
+                }
+                if (squared_distance < best_squared_distance
+                    || (squared_distance == best_squared_distance && mPointIndices[i] < best_index))
+                {
+                    best_squared_distance = squared_distance;
+                    best_index = mPointIndices[i];
+                }
+            }
+        }
+        else
+        {
+            const TreeNode& r_first = mTreeNodes[node_index + 1];
+            const TreeNode& r_second = mTreeNodes[r_node.SecondChild];
+            if (SquaredDistanceToBox(rLocation, r_first.Lower, r_first.Upper)
+                <= SquaredDistanceToBox(rLocation, r_second.Lower, r_second.Upper))
+            {
+                stack.push_back(r_node.SecondChild);
+                stack.push_back(node_index + 1);
+            }
+            else
+            {
+                stack.push_back(node_index + 1);
+                stack.push_back(r_node.SecondChild);
+            }
+        }
+    }
+    return best_index;
+}
+
+// Explicit instantiation
+template class NodeKdTree<1>;
+template class NodeKdTree<2>;
+template class NodeKdTree<3>;
@@ -0,0 +1,135 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef NODEKDTREE_HPP_
+#define NODEKDTREE_HPP_
+
+#include <vector>
+
+#include "UblasIncludes.hpp"
+
+/**
+ * A k-d tree over a set of points (typically node locations), for finding the
+ * point nearest to a query point in O(log(number of points)) time rather than
+ * by measuring the distance to every point.
+ *
+ * Points are identified by their position in the vector given to the
+ * constructor. Distances are Euclidean. The locations are copied when the tree
+ * is constructed, so it must be rebuilt if the points move.
+ */
+template <unsigned DIM>
+class NodeKdTree
+{
+private:
+    friend class TestNodeKdTree;
+
+    /** A node of the tree: a bounding box and either two children or a range of points. */
+    struct TreeNode
+    {
+        /** Lower corner of the box containing all the points below this node. */
+        c_vector<double, DIM> Lower;
+
+        /** Upper corner of the box containing all the points below this node. */
+        c_vector<double, DIM> Upper;
+
+        /** First position in mPointIndices of the points of a leaf. */
+        unsigned First;
+
+        /** Number of points of a leaf, or 0 if this is not a leaf. */
+        unsigned Count;
+
+        /** Index in mTreeNodes of the second child (the first child follows this node). */
+        unsigned SecondChild;
+    };
+
+    /** Maximum number of points in a leaf of the tree. */
+    static const unsigned MAX_POINTS_PER_LEAF = 8u;
+
+    /** Positions of the points in the constructor's vector, ordered so each leaf holds a contiguous range. */
+    std::vector<unsigned> mPointIndices;
+
+    /** Locations of the points, in the order of mPointIndices. */
+    std::vector<c_vector<double, DIM> > mLocations;
+
+    /** The nodes of the tree, the root first. */
+    std::vector<TreeNode> mTreeNodes;
+
+    /**
+     * Create the subtree for a range of points, recursively splitting at the median
+     * along the direction in which they are most spread out.
+     *
+     * @param first First position in mPointIndices of the range
+     * @param count Number of points in the range
+     */
+    void BuildSubtree(unsigned first, unsigned count);
+
+    /**
+     * @return the square of the distance from a point to a box (zero if inside it).
+     *
+     * @param rPoint The point
+     * @param rLower Lower corner of the box
+     * @param rUpper Upper corner of the box
+     */
+    static double SquaredDistanceToBox(const c_vector<double, DIM>& rPoint,
+                                       const c_vector<double, DIM>& rLower,
+                                       const c_vector<double, DIM>& rUpper);
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param rLocations The locations of the points
+     */
+    NodeKdTree(const std::vector<c_vector<double, DIM> >& rLocations);
+
+    /**
+     * @return the number of points in the tree.
+     */
+    unsigned GetNumPoints() const;
+
+    /**
+     * Find the point nearest to a given location. If several points are equally
+     * near, the one given first to the constructor is returned, as a linear
+     * search would.
+     *
+     * @param rLocation The location
+     * @return the position of the nearest point in the constructor's vector, or
+     *     UINT_MAX if the tree is empty
+     */
+    unsigned GetNearestPoint(const c_vector<double, DIM>& rLocation) const;
+};
+
+#endif /*NODEKDTREE_HPP_*/
@@ -35,6 +35,8 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "MutableVertexMesh.hpp"
 
+#include <cfloat>
+
 #include "LogFile.hpp"
 #include "UblasCustomFunctions.hpp"
 #include "Warnings.hpp"
@@ -55,7 +57,9 @@ MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::MutableVertexMesh(std::vector<Node<SP
           mProtorosetteResolutionProbabilityPerTimestep(protorosetteResolutionProbabilityPerTimestep),
           mRosetteResolutionProbabilityPerTimestep(rosetteResolutionProbabilityPerTimestep),
           mCheckForInternalIntersections(false),
-          mDistanceForT3SwapChecking(5.0)
+          mDistanceForT3SwapChecking(5.0),
+          mUseIncrementalSwapChecks(false),
+          mSwapCheckDataIsCurrent(false)
 {
     // Threshold parameters must be strictly positive
     assert(cellRearrangementThreshold > 0.0);
@@ -129,7 +133,9 @@ MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::MutableVertexMesh()
       mProtorosetteResolutionProbabilityPerTimestep(0.0),
       mRosetteResolutionProbabilityPerTimestep(0.0),
       mCheckForInternalIntersections(false),
-      mDistanceForT3SwapChecking(5.0)
+      mDistanceForT3SwapChecking(5.0),
+      mUseIncrementalSwapChecks(false),
+      mSwapCheckDataIsCurrent(false)
 {
     // Note that the member variables initialised above will be overwritten as soon as archiving is complete
     this->mMeshChangesDuringSimulation = true;
@@ -190,6 +196,25 @@ double MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::GetDistanceForT3SwapChecking()
     return mDistanceForT3SwapChecking;
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::SetUseIncrementalSwapChecks(bool useIncrementalSwapChecks)
+{
+    mUseIncrementalSwapChecks = useIncrementalSwapChecks;
+    mSwapCheckDataIsCurrent = false;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::GetUseIncrementalSwapChecks() const
+{
+    return mUseIncrementalSwapChecks;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::IsPeriodic() const
+{
+    return false;
+}
+
 
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
@@ -202,6 +227,7 @@ template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::SetCellRearrangementThreshold(double cellRearrangementThreshold)
 {
     mCellRearrangementThreshold = cellRearrangementThreshold;
+    mSwapCheckDataIsCurrent = false;
 }
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
@@ -276,6 +302,8 @@ void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::SetCheckForInternalIntersections
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::Clear()
 {
+    InvalidateCachedElementData();
+    mSwapCheckDataIsCurrent = false;
     mDeletedNodeIndices.clear();
     mDeletedElementIndices.clear();
 
@@ -324,9 +352,142 @@ void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::ClearLocationsOfT3Swaps()
     mLocationsOfT3Swaps.clear();
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::UpdateCompactConnectivity()
+{
+    if (!mCompactConnectivityIsCurrent)
+    {
+        unsigned num_elements = this->mElements.size();
+        unsigned num_nodes = this->mNodes.size();
+
+        // Element-node connectivity, in the order in which nodes are stored in each element
+        mElementNodeOffsets.assign(num_elements + 1, 0);
+        mElementNodeIndices.clear();
+        std::vector<unsigned> num_containing_elements(num_nodes, 0);
+        for (unsigned elem_index=0; elem_index<num_elements; elem_index++)
+        {
+            VertexElement<ELEMENT_DIM, SPACE_DIM>* p_element = this->mElements[elem_index];
+            if (!p_element->IsDeleted())
+            {
+                for (unsigned local_index=0; local_index<p_element->GetNumNodes(); local_index++)
+                {
+                    unsigned node_index = p_element->GetNodeGlobalIndex(local_index);
+                    mElementNodeIndices.push_back(node_index);
+                    num_containing_elements[node_index]++;
+                }
+            }
+            mElementNodeOffsets[elem_index + 1] = mElementNodeIndices.size();
+        }
+
+        // Node-element connectivity; visiting elements in order of index keeps each node's elements sorted
+        mNodeElementOffsets.assign(num_nodes + 1, 0);
+        for (unsigned node_index=0; node_index<num_nodes; node_index++)
+        {
+            mNodeElementOffsets[node_index + 1] = mNodeElementOffsets[node_index] + num_containing_elements[node_index];
+        }
+        mNodeElementIndices.resize(mElementNodeIndices.size());
+        mNodeElementLocalIndices.resize(mElementNodeIndices.size());
+
+        std::vector<unsigned> next_entry(mNodeElementOffsets.begin(), mNodeElementOffsets.end() - 1);
+        for (unsigned elem_index=0; elem_index<num_elements; elem_index++)
+        {
+            for (unsigned entry=mElementNodeOffsets[elem_index]; entry<mElementNodeOffsets[elem_index + 1]; entry++)
+            {
+                unsigned position = next_entry[mElementNodeIndices[entry]]++;
+                mNodeElementIndices[position] = elem_index;
+                mNodeElementLocalIndices[position] = entry - mElementNodeOffsets[elem_index];
+            }
+        }
+
+        mCompactConnectivityIsCurrent = true;
+    }
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::UpdateCachedElementGeometry()
+{
+    if (!mCachedElementGeometryIsCurrent)
+    {
+        unsigned num_elements = this->mElements.size();
+        mCachedElementVolumes.assign(num_elements, 0.0);
+        mCachedElementSurfaceAreas.assign(num_elements, 0.0);
+        for (unsigned elem_index=0; elem_index<num_elements; elem_index++)
+        {
+            if (!this->mElements[elem_index]->IsDeleted())
+            {
+                mCachedElementVolumes[elem_index] = this->GetVolumeOfElement(elem_index);
+                mCachedElementSurfaceAreas[elem_index] = this->GetSurfaceAreaOfElement(elem_index);
+            }
+        }
+
+        mCachedElementGeometryIsCurrent = true;
+    }
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+const std::vector<unsigned>& MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::rGetElementNodeOffsets()
+{
+    UpdateCompactConnectivity();
+    return mElementNodeOffsets;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+const std::vector<unsigned>& MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::rGetElementNodeIndices()
+{
+    UpdateCompactConnectivity();
+    return mElementNodeIndices;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+const std::vector<unsigned>& MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::rGetNodeElementOffsets()
+{
+    UpdateCompactConnectivity();
+    return mNodeElementOffsets;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+const std::vector<unsigned>& MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::rGetNodeElementIndices()
+{
+    UpdateCompactConnectivity();
+    return mNodeElementIndices;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+const std::vector<unsigned>& MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::rGetNodeElementLocalIndices()
+{
+    UpdateCompactConnectivity();
+    return mNodeElementLocalIndices;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+double MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::GetCachedVolumeOfElement(unsigned index)
+{
+    UpdateCachedElementGeometry();
+    assert(index < mCachedElementVolumes.size());
+    return mCachedElementVolumes[index];
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+double MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::GetCachedSurfaceAreaOfElement(unsigned index)
+{
+    UpdateCachedElementGeometry();
+    assert(index < mCachedElementSurfaceAreas.size());
+    return mCachedElementSurfaceAreas[index];
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::InvalidateCachedElementData()
+{
+    mCompactConnectivityIsCurrent = false;
+    mCachedElementGeometryIsCurrent = false;
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 unsigned MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::AddNode(Node<SPACE_DIM>* pNewNode)
 {
+    InvalidateCachedElementData();
+    mSwapCheckDataIsCurrent = false;
+
     if (mDeletedNodeIndices.empty())
     {
         pNewNode->SetIndex(this->mNodes.size());
@@ -346,6 +507,9 @@ unsigned MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::AddNode(Node<SPACE_DIM>* pNe
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 unsigned MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::AddElement(VertexElement<ELEMENT_DIM,SPACE_DIM>* pNewElement)
 {
+    InvalidateCachedElementData();
+    mSwapCheckDataIsCurrent = false;
+
     unsigned new_element_index = pNewElement->GetIndex();
 
     if (new_element_index == this->mElements.size())
@@ -363,6 +527,7 @@ unsigned MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::AddElement(VertexElement<ELE
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::SetNode(unsigned nodeIndex, ChastePoint<SPACE_DIM> point)
 {
+    mCachedElementGeometryIsCurrent = false;
     this->mNodes[nodeIndex]->SetPoint(point);
 }
 
@@ -571,6 +736,9 @@ unsigned MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::DivideElement(VertexElement<
                                                                   unsigned nodeBIndex,
                                                                   bool placeOriginalElementBelow)
 {
+    InvalidateCachedElementData();
+    mSwapCheckDataIsCurrent = false;
+
     assert(SPACE_DIM == 2);                // LCOV_EXCL_LINE
     assert(ELEMENT_DIM == SPACE_DIM);    // LCOV_EXCL_LINE
 
@@ -694,6 +862,9 @@ unsigned MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::DivideElement(VertexElement<
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::DeleteElementPriorToReMesh(unsigned index)
 {
+    InvalidateCachedElementData();
+    mSwapCheckDataIsCurrent = false;
+
     assert(SPACE_DIM == 2); // LCOV_EXCL_LINE
 
     // Mark any nodes that are contained only in this element as deleted
@@ -718,6 +889,9 @@ void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::DeleteElementPriorToReMesh(unsig
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::DeleteNodePriorToReMesh(unsigned index)
 {
+    InvalidateCachedElementData();
+    mSwapCheckDataIsCurrent = false;
+
     this->mNodes[index]->MarkAsDeleted();
     mDeletedNodeIndices.push_back(index);
 }
@@ -725,6 +899,9 @@ void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::DeleteNodePriorToReMesh(unsigned
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::DivideEdge(Node<SPACE_DIM>* pNodeA, Node<SPACE_DIM>* pNodeB)
 {
+    InvalidateCachedElementData();
+    mSwapCheckDataIsCurrent = false;
+
     // Find the indices of the elements owned by each node
     std::set<unsigned> elements_containing_nodeA = pNodeA->rGetContainingElementIndices();
     std::set<unsigned> elements_containing_nodeB = pNodeB->rGetContainingElementIndices();
@@ -801,6 +978,8 @@ void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::DivideEdge(Node<SPACE_DIM>* pNod
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::RemoveDeletedNodesAndElements(VertexElementMap& rElementMap)
 {
+    InvalidateCachedElementData();
+
     // Make sure the map is big enough.  Each entry will be set in the loop below.
     rElementMap.Resize(this->GetNumAllElements());
 
@@ -840,6 +1019,8 @@ void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::RemoveDeletedNodesAndElements(Ve
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::RemoveDeletedNodes()
 {
+    InvalidateCachedElementData();
+
     // Remove any nodes that have been marked for deletion and store all other nodes in a temporary structure
     std::vector<Node<SPACE_DIM>*> live_nodes;
     for (unsigned i=0; i<this->mNodes.size(); i++)
@@ -909,6 +1090,9 @@ void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::ReMesh(VertexElementMap& rElemen
          * (see #2664).
          */
         this->CheckForRosettes();
+
+        // Node locations and element topology may have changed in ways not seen by the methods above
+        InvalidateCachedElementData();
     }
     else // 3D
     {
@@ -929,29 +1113,70 @@ void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::ReMesh()
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 bool MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::CheckForSwapsFromShortEdges()
 {
+    // Find each short edge that may be swapped, in the order in which a search over the elements meets them
+    std::vector<std::pair<Node<SPACE_DIM>*, Node<SPACE_DIM>*> > short_edges;
+    std::set<std::pair<unsigned, unsigned> > short_edge_node_indices;
+
+    /*
+     * If the last search found nothing to swap and the topology is unchanged, then an edge can only
+     * have become short if one of its nodes has moved further than that node's slack, so we only need
+     * to search the elements containing such nodes (in order of index, as a full search would).
+     */
+    bool search_incrementally = mUseIncrementalSwapChecks && mSwapCheckDataIsCurrent;
+    std::set<unsigned> moved_nodes;
+    std::vector<unsigned> elements_to_search;
+    if (search_incrementally)
+    {
+        std::set<unsigned> elements_of_moved_nodes;
+        for (typename AbstractMesh<ELEMENT_DIM,SPACE_DIM>::NodeIterator node_iter = this->GetNodeIteratorBegin();
+             node_iter != this->GetNodeIteratorEnd();
+             ++node_iter)
+        {
+            unsigned node_index = node_iter->GetIndex();
+            double displacement = norm_2(this->GetVectorFromAtoB(mSwapCheckLocations[node_index], node_iter->rGetLocation()));
+            if (displacement >= mSwapCheckSlacks[node_index])
+            {
+                moved_nodes.insert(node_index);
+                elements_of_moved_nodes.insert(node_iter->rGetContainingElementIndices().begin(),
+                                               node_iter->rGetContainingElementIndices().end());
+            }
+        }
+        elements_to_search.assign(elements_of_moved_nodes.begin(), elements_of_moved_nodes.end());
+    }
+    else
+    {
+        for (typename VertexMesh<ELEMENT_DIM, SPACE_DIM>::VertexElementIterator elem_iter = this->GetElementIteratorBegin();
+             elem_iter != this->GetElementIteratorEnd();
+             ++elem_iter)
+        {
+            elements_to_search.push_back(elem_iter->GetIndex());
+        }
+    }
+
     // Loop over elements to check for T1 swaps
-    for (typename VertexMesh<ELEMENT_DIM, SPACE_DIM>::VertexElementIterator elem_iter = this->GetElementIteratorBegin();
-         elem_iter != this->GetElementIteratorEnd();
-         ++elem_iter)
+    for (unsigned i=0; i<elements_to_search.size(); i++)
     {
         ///\todo Could we search more efficiently by just iterating over edges? (see #2401)
+        VertexElement<ELEMENT_DIM, SPACE_DIM>* p_element = this->GetElement(elements_to_search[i]);
 
-        unsigned num_nodes = elem_iter->GetNumNodes();
+        unsigned num_nodes = p_element->GetNumNodes();
         assert(num_nodes > 0);
 
         // Loop over the nodes contained in this element
         for (unsigned local_index=0; local_index<num_nodes; local_index++)
         {
             // Find locations of the current node and anticlockwise node
-            Node<SPACE_DIM>* p_current_node = elem_iter->GetNode(local_index);
+            Node<SPACE_DIM>* p_current_node = p_element->GetNode(local_index);
             unsigned local_index_plus_one = (local_index+1)%num_nodes;    ///\todo Use iterators to tidy this up (see #2401)
-            Node<SPACE_DIM>* p_anticlockwise_node = elem_iter->GetNode(local_index_plus_one);
+            Node<SPACE_DIM>* p_anticlockwise_node = p_element->GetNode(local_index_plus_one);
 
             // Find distance between nodes
             double distance_between_nodes = this->GetDistanceBetweenNodes(p_current_node->GetIndex(), p_anticlockwise_node->GetIndex());
 
-            // If the nodes are too close together...
-            if (distance_between_nodes < mCellRearrangementThreshold)
+            // If the nodes are too close together, and we have not already met this edge in a neighbouring element...
+            std::pair<unsigned, unsigned> edge(std::min(p_current_node->GetIndex(), p_anticlockwise_node->GetIndex()),
+                                               std::max(p_current_node->GetIndex(), p_anticlockwise_node->GetIndex()));
+            if (distance_between_nodes < mCellRearrangementThreshold && short_edge_node_indices.count(edge) == 0)
             {
                 // ...then check if any triangular elements are shared by these nodes...
                 std::set<unsigned> elements_of_node_a = p_current_node->rGetContainingElementIndices();
@@ -974,17 +1199,133 @@ bool MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::CheckForSwapsFromShortEdges()
                     }
                 }
 
-                // ...and if none are, then perform the required type of swap and halt the search, returning true
+                // ...and if none are, then this edge requires a swap
                 if (!both_nodes_share_triangular_element)
                 {
-                    IdentifySwapType(p_current_node, p_anticlockwise_node);
-                    return true;
+                    short_edge_node_indices.insert(edge);
+                    short_edges.push_back(std::make_pair(p_current_node, p_anticlockwise_node));
                 }
             }
         }
     }
 
-    return false;
+    if (short_edges.empty() && mUseIncrementalSwapChecks)
+    {
+        // Nothing to swap, so remember where the nodes are for the next search
+        if (!search_incrementally)
+        {
+            mSwapCheckLocations.resize(this->mNodes.size());
+            mSwapCheckSlacks.assign(this->mNodes.size(), 0.0);
+            for (typename AbstractMesh<ELEMENT_DIM,SPACE_DIM>::NodeIterator node_iter = this->GetNodeIteratorBegin();
+                 node_iter != this->GetNodeIteratorEnd();
+                 ++node_iter)
+            {
+                moved_nodes.insert(node_iter->GetIndex());
+            }
+        }
+
+        // The slacks of the moved nodes and their neighbours depend on where the moved nodes are now
+        std::set<unsigned> nodes_to_update;
+        for (std::set<unsigned>::const_iterator it = moved_nodes.begin(); it != moved_nodes.end(); ++it)
+        {
+            mSwapCheckLocations[*it] = this->GetNode(*it)->rGetLocation();
+            std::set<unsigned> neighbours = this->GetNeighbouringNodeIndices(*it);
+            nodes_to_update.insert(*it);
+            nodes_to_update.insert(neighbours.begin(), neighbours.end());
+        }
+        UpdateSwapCheckSlacks(nodes_to_update);
+        mSwapCheckDataIsCurrent = true;
+    }
+
+    /*
+     * Perform the required type of swap on each short edge in turn, for as long as each edge is
+     * far enough from those already swapped to be unaffected by them. We stop at the first edge
+     * that may have been affected, so the swaps are performed in the same order as a search that
+     * restarts after every swap; the caller then searches the mesh again.
+     */
+    std::set<unsigned> blocked_elements;
+    for (unsigned i=0; i<short_edges.size(); i++)
+    {
+        Node<SPACE_DIM>* p_node_a = short_edges[i].first;
+        Node<SPACE_DIM>* p_node_b = short_edges[i].second;
+        if (p_node_a->IsDeleted() || p_node_b->IsDeleted())
+        {
+            return true;
+        }
+
+        std::set<unsigned> affected_elements = p_node_a->rGetContainingElementIndices();
+        affected_elements.insert(p_node_b->rGetContainingElementIndices().begin(), p_node_b->rGetContainingElementIndices().end());
+
+        for (std::set<unsigned>::const_iterator it = affected_elements.begin(); it != affected_elements.end(); ++it)
+        {
+            if (blocked_elements.count(*it) != 0)
+            {
+                return true;
+            }
+        }
+
+        IdentifySwapType(p_node_a, p_node_b);
+
+        // Block the elements changed by this swap, and their neighbours, for the rest of this search
+        if (!p_node_a->IsDeleted())
+        {
+            affected_elements.insert(p_node_a->rGetContainingElementIndices().begin(), p_node_a->rGetContainingElementIndices().end());
+        }
+        if (!p_node_b->IsDeleted())
+        {
+            affected_elements.insert(p_node_b->rGetContainingElementIndices().begin(), p_node_b->rGetContainingElementIndices().end());
+        }
+        for (std::set<unsigned>::const_iterator it = affected_elements.begin(); it != affected_elements.end(); ++it)
+        {
+            blocked_elements.insert(*it);
+
+            VertexElement<ELEMENT_DIM, SPACE_DIM>* p_element = this->GetElement(*it);
+            if (!p_element->IsDeleted())
+            {
+                for (unsigned local_index=0; local_index<p_element->GetNumNodes(); local_index++)
+                {
+                    const std::set<unsigned>& r_neighbouring_elements = p_element->GetNode(local_index)->rGetContainingElementIndices();
+                    blocked_elements.insert(r_neighbouring_elements.begin(), r_neighbouring_elements.end());
+                }
+            }
+        }
+    }
+
+    return !short_edges.empty();
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::UpdateSwapCheckSlacks(const std::set<unsigned>& rNodeIndices)
+{
+    for (std::set<unsigned>::const_iterator it = rNodeIndices.begin(); it != rNodeIndices.end(); ++it)
+    {
+        Node<SPACE_DIM>* p_node = this->GetNode(*it);
+        const std::set<unsigned>& r_elements_of_node = p_node->rGetContainingElementIndices();
+
+        double slack = DBL_MAX;
+        std::set<unsigned> neighbours = this->GetNeighbouringNodeIndices(*it);
+        for (std::set<unsigned>::const_iterator neighbour_iter = neighbours.begin(); neighbour_iter != neighbours.end(); ++neighbour_iter)
+        {
+            // Edges whose nodes share a triangular element are never swapped, however short they get
+            const std::set<unsigned>& r_elements_of_neighbour = this->GetNode(*neighbour_iter)->rGetContainingElementIndices();
+            bool edge_can_be_swapped = true;
+            for (std::set<unsigned>::const_iterator elem_iter = r_elements_of_node.begin(); elem_iter != r_elements_of_node.end(); ++elem_iter)
+            {
+                if (r_elements_of_neighbour.count(*elem_iter) != 0 && this->GetElement(*elem_iter)->GetNumNodes() <= 3)
+                {
+                    edge_can_be_swapped = false;
+                    break;
+                }
+            }
+
+            if (edge_can_be_swapped)
+            {
+                double edge_length = norm_2(this->GetVectorFromAtoB(mSwapCheckLocations[*it], mSwapCheckLocations[*neighbour_iter]));
+                slack = std::min(slack, 0.5*(edge_length - mCellRearrangementThreshold));
+            }
+        }
+        mSwapCheckSlacks[*it] = std::max(slack, 0.0);
+    }
 }
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
@@ -1018,21 +1359,37 @@ bool MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::CheckForIntersections()
     // If checking for internal intersections as well as on the boundary, then check that no nodes have overlapped any elements...
     if (mCheckForInternalIntersections)
     {
-        ///\todo Change to only loop over neighbouring elements (see #2401)
         for (typename AbstractMesh<ELEMENT_DIM,SPACE_DIM>::NodeIterator node_iter = this->GetNodeIteratorBegin();
              node_iter != this->GetNodeIteratorEnd();
              ++node_iter)
         {
             assert(!(node_iter->IsDeleted()));
 
-            for (typename VertexMesh<ELEMENT_DIM, SPACE_DIM>::VertexElementIterator elem_iter = this->GetElementIteratorBegin();
-                 elem_iter != this->GetElementIteratorEnd();
+            /*
+             * Nodes only move a short distance in each time step, so a node can only have moved into
+             * an element that shares a node with one of the elements containing it. We check these
+             * neighbouring elements in order of index, as a search over all elements would.
+             */
+            const std::set<unsigned>& r_containing_elements = node_iter->rGetContainingElementIndices();
+            std::set<unsigned> neighbouring_elements;
+            for (std::set<unsigned>::const_iterator it = r_containing_elements.begin(); it != r_containing_elements.end(); ++it)
+            {
+                VertexElement<ELEMENT_DIM, SPACE_DIM>* p_element = this->GetElement(*it);
+                for (unsigned local_index=0; local_index<p_element->GetNumNodes(); local_index++)
+                {
+                    const std::set<unsigned>& r_elements = p_element->GetNode(local_index)->rGetContainingElementIndices();
+                    neighbouring_elements.insert(r_elements.begin(), r_elements.end());
+                }
+            }
+
+            for (std::set<unsigned>::const_iterator elem_iter = neighbouring_elements.begin();
+                 elem_iter != neighbouring_elements.end();
                  ++elem_iter)
             {
-                unsigned elem_index = elem_iter->GetIndex();
+                unsigned elem_index = *elem_iter;
 
                 // Check that the node is not part of this element
-                if (node_iter->rGetContainingElementIndices().count(elem_index) == 0)
+                if (r_containing_elements.count(elem_index) == 0)
                 {
                     if (this->ElementIncludesPoint(node_iter->rGetLocation(), elem_index))
                     {
@@ -1062,8 +1419,34 @@ bool MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::CheckForIntersections()
             }
         }
 
+        /*
+         * Bin the centroids into boxes of side mDistanceForT3SwapChecking, so that any centroid within
+         * this distance of a node lies in the node's box or an adjacent one. This relies on distances
+         * being Euclidean, so in a periodic mesh every boundary element is a candidate instead.
+         */
+        bool use_boxes = !IsPeriodic() && mDistanceForT3SwapChecking > 0.0;
+        std::map<std::vector<int>, std::vector<unsigned> > boxes;
+        if (use_boxes)
+        {
+            for (unsigned i=0; i<boundary_element_centroids.size(); i++)
+            {
+                std::vector<int> box(SPACE_DIM);
+                for (unsigned d=0; d<SPACE_DIM; d++)
+                {
+                    box[d] = (int)floor(boundary_element_centroids[i][d]/mDistanceForT3SwapChecking);
+                }
+                boxes[box].push_back(i);
+            }
+        }
+        unsigned num_adjacent_boxes = 1;
+        for (unsigned d=0; d<SPACE_DIM; d++)
+        {
+            num_adjacent_boxes *= 3;
+        }
+
         // Second: Check intersections only for those nodes and elements within
         // mDistanceForT3SwapChecking within each other (node<-->element centroid)
+        std::vector<unsigned> candidates;
         for (typename AbstractMesh<ELEMENT_DIM,SPACE_DIM>::NodeIterator node_iter = this->GetNodeIteratorBegin();
                 node_iter != this->GetNodeIteratorEnd();
                 ++node_iter)
@@ -1071,31 +1454,58 @@ bool MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::CheckForIntersections()
             if (node_iter->IsBoundaryNode())
             {
                 assert(!(node_iter->IsDeleted()));
+                c_vector<double, SPACE_DIM> node_location = node_iter->rGetLocation();
+
+                // Positions in boundary_element_centroids and boundary_element_indices of the elements to check
+                candidates.clear();
+                if (use_boxes)
+                {
+                    for (unsigned neighbour=0; neighbour<num_adjacent_boxes; neighbour++)
+                    {
+                        std::vector<int> box(SPACE_DIM);
+                        unsigned offsets = neighbour;
+                        for (unsigned d=0; d<SPACE_DIM; d++)
+                        {
+                            box[d] = (int)floor(node_location[d]/mDistanceForT3SwapChecking) + (int)(offsets%3) - 1;
+                            offsets /= 3;
+                        }
+                        std::map<std::vector<int>, std::vector<unsigned> >::const_iterator box_iter = boxes.find(box);
+                        if (box_iter != boxes.end())
+                        {
+                            candidates.insert(candidates.end(), box_iter->second.begin(), box_iter->second.end());
+                        }
+                    }
+
+                    // Check the elements in the same order as a search over all of them would
+                    std::sort(candidates.begin(), candidates.end());
+                }
+                else
+                {
+                    for (unsigned i=0; i<boundary_element_indices.size(); i++)
+                    {
+                        candidates.push_back(i);
+                    }
+                }
 
-                // index in boundary_element_centroids and boundary_element_indices
-                unsigned boundary_element_index = 0;
-                for (std::vector<unsigned>::iterator elem_iter = boundary_element_indices.begin();
-                        elem_iter != boundary_element_indices.end();
-                        ++elem_iter)
+                for (unsigned i=0; i<candidates.size(); i++)
                 {
+                    unsigned elem_index = boundary_element_indices[candidates[i]];
+
                     // Check that the node is not part of this element
-                    if (node_iter->rGetContainingElementIndices().count(*elem_iter) == 0)
+                    if (node_iter->rGetContainingElementIndices().count(elem_index) == 0)
                     {
-                        c_vector<double, SPACE_DIM> node_location = node_iter->rGetLocation();
-                        c_vector<double, SPACE_DIM> element_centroid = boundary_element_centroids[boundary_element_index];
+                        c_vector<double, SPACE_DIM> element_centroid = boundary_element_centroids[candidates[i]];
                         double node_element_distance = norm_2(this->GetVectorFromAtoB(node_location, element_centroid));
 
                         if ( node_element_distance < mDistanceForT3SwapChecking )
                         {
-                            if (this->ElementIncludesPoint(node_iter->rGetLocation(), *elem_iter))
+                            if (this->ElementIncludesPoint(node_iter->rGetLocation(), elem_index))
                             {
-                                this->PerformT3Swap(&(*node_iter), *elem_iter);
+                                this->PerformT3Swap(&(*node_iter), elem_index);
                                 return true;
                             }
                         }
                     }
-                    // increment the boundary element index
-                    boundary_element_index +=1u;
                 }
             }
         }
@@ -1437,6 +1847,8 @@ void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::IdentifySwapType(Node<SPACE_DIM>
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::PerformNodeMerge(Node<SPACE_DIM>* pNodeA, Node<SPACE_DIM>* pNodeB)
 {
+    mSwapCheckDataIsCurrent = false;
+
     // Find the sets of elements containing each of the nodes, sorted by index
     std::set<unsigned> nodeA_elem_indices = pNodeA->rGetContainingElementIndices();
     std::set<unsigned> nodeB_elem_indices = pNodeB->rGetContainingElementIndices();
@@ -1477,6 +1889,8 @@ void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::PerformT1Swap(Node<SPACE_DIM>* p
                                                               Node<SPACE_DIM>* pNodeB,
                                                               std::set<unsigned>& rElementsContainingNodes)
 {
+    mSwapCheckDataIsCurrent = false;
+
     // First compute and store the location of the T1 swap, which is at the midpoint of nodes A and B
     double distance_between_nodes_CD = mCellRearrangementRatio*mCellRearrangementThreshold;
 
@@ -1616,6 +2030,8 @@ void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::PerformT1Swap(Node<SPACE_DIM>* p
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::PerformIntersectionSwap(Node<SPACE_DIM>* pNode, unsigned elementIndex)
 {
+    mSwapCheckDataIsCurrent = false;
+
     assert(SPACE_DIM == 2);                    // LCOV_EXCL_LINE
     assert(ELEMENT_DIM == SPACE_DIM);        // LCOV_EXCL_LINE
 
@@ -1783,6 +2199,8 @@ void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::PerformIntersectionSwap(Node<SPA
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::PerformT2Swap(VertexElement<ELEMENT_DIM,SPACE_DIM>& rElement)
 {
+    mSwapCheckDataIsCurrent = false;
+
     // The given element must be triangular for us to be able to perform a T2 swap on it
     assert(rElement.GetNumNodes() == 3);
 
@@ -1851,6 +2269,8 @@ void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::PerformT2Swap(VertexElement<ELEM
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::PerformT3Swap(Node<SPACE_DIM>* pNode, unsigned elementIndex)
 {
+    mSwapCheckDataIsCurrent = false;
+
     assert(SPACE_DIM == 2);                 // LCOV_EXCL_LINE - code will be removed at compile time
     assert(ELEMENT_DIM == SPACE_DIM);    // LCOV_EXCL_LINE - code will be removed at compile time
 
@@ -2559,6 +2979,8 @@ void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::PerformT3Swap(Node<SPACE_DIM>* p
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::PerformVoidRemoval(Node<SPACE_DIM>* pNodeA, Node<SPACE_DIM>* pNodeB, Node<SPACE_DIM>* pNodeC)
 {
+    mSwapCheckDataIsCurrent = false;
+
     // Calculate void centroid
     c_vector<double, SPACE_DIM> nodes_midpoint = pNodeA->rGetLocation()
             + this->GetVectorFromAtoB(pNodeA->rGetLocation(), pNodeB->rGetLocation()) / 3.0
@@ -2616,6 +3038,8 @@ void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::HandleHighOrderJunctions(Node<SP
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::PerformRosetteRankIncrease(Node<SPACE_DIM>* pNodeA, Node<SPACE_DIM>* pNodeB)
 {
+    mSwapCheckDataIsCurrent = false;
+
     /*
      * One of the nodes will have 3 containing element indices, the other
      * will have at least four. We first identify which node is which.
@@ -2703,6 +3127,8 @@ void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::PerformRosetteRankIncrease(Node<
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::PerformProtorosetteResolution(Node<SPACE_DIM>* pProtorosetteNode)
 {
+    mSwapCheckDataIsCurrent = false;
+
     // Double check we are dealing with a protorosette
     assert(pProtorosetteNode->rGetContainingElementIndices().size() == 4);
 
@@ -2889,6 +3315,8 @@ void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::PerformProtorosetteResolution(No
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::PerformRosetteRankDecrease(Node<SPACE_DIM>* pRosetteNode)
 {
+    mSwapCheckDataIsCurrent = false;
+
     unsigned rosette_rank = pRosetteNode->rGetContainingElementIndices().size();
 
     // Double check we're dealing with a rosette
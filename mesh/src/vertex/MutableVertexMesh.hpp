@@ -125,6 +125,90 @@ protected:
      */
     std::vector< c_vector<double, SPACE_DIM> > mLocationsOfT3Swaps;
 
+    /**
+     * Compact (compressed sparse row) copy of the element-node connectivity. The global indices of
+     * the nodes of element i are mElementNodeIndices[mElementNodeOffsets[i]] up to, but not including,
+     * mElementNodeIndices[mElementNodeOffsets[i+1]], in the element's own (anticlockwise) order.
+     * Deleted elements have no nodes. Not archived; rebuilt when next needed.
+     */
+    std::vector<unsigned> mElementNodeOffsets;
+
+    /** Node indices of the compact element-node connectivity (see mElementNodeOffsets). */
+    std::vector<unsigned> mElementNodeIndices;
+
+    /**
+     * Compact (compressed sparse row) copy of the node-element connectivity, in increasing order of
+     * element index. The elements containing node i, and this node's local index in each of them, are
+     * stored in mNodeElementIndices and mNodeElementLocalIndices from mNodeElementOffsets[i] up to, but not
+     * including, mNodeElementOffsets[i+1].
+     */
+    std::vector<unsigned> mNodeElementOffsets;
+
+    /** Element indices of the compact node-element connectivity (see mNodeElementOffsets). */
+    std::vector<unsigned> mNodeElementIndices;
+
+    /** Local indices of each node in its containing elements (see mNodeElementOffsets). */
+    std::vector<unsigned> mNodeElementLocalIndices;
+
+    /** Cached volume (area in 2D) of each element, indexed by element index. */
+    std::vector<double> mCachedElementVolumes;
+
+    /** Cached surface area (perimeter in 2D) of each element, indexed by element index. */
+    std::vector<double> mCachedElementSurfaceAreas;
+
+    /** Whether the compact connectivity reflects the current mesh topology. */
+    bool mCompactConnectivityIsCurrent;
+
+    /** Whether mCachedElementVolumes and mCachedElementSurfaceAreas reflect the current node locations. */
+    bool mCachedElementGeometryIsCurrent;
+
+    /**
+     * Whether CheckForSwapsFromShortEdges() only searches the elements containing nodes that have
+     * moved far enough to have made one of their edges short (see SetUseIncrementalSwapChecks()).
+     */
+    bool mUseIncrementalSwapChecks;
+
+    /**
+     * Whether mSwapCheckLocations and mSwapCheckSlacks are valid, i.e. they were set by a search that
+     * found no short edges to swap, and the mesh topology has not changed since. Not archived.
+     */
+    bool mSwapCheckDataIsCurrent;
+
+    /** The location of each node when the edges around it were last checked for being short. */
+    std::vector<c_vector<double, SPACE_DIM> > mSwapCheckLocations;
+
+    /**
+     * How far each node may move from its entry in mSwapCheckLocations before its edges need checking
+     * again: half the smallest excess over mCellRearrangementThreshold of the length of any of its edges,
+     * ignoring edges that cannot be swapped because their nodes share a triangular element.
+     */
+    std::vector<double> mSwapCheckSlacks;
+
+    /**
+     * Helper method for CheckForSwapsFromShortEdges(). Recompute the entries of mSwapCheckSlacks for
+     * the given nodes from mSwapCheckLocations.
+     *
+     * @param rNodeIndices the global indices of the nodes
+     */
+    void UpdateSwapCheckSlacks(const std::set<unsigned>& rNodeIndices);
+
+    /**
+     * @return whether the mesh measures distances across periodic boundaries in GetVectorFromAtoB(),
+     * in which case CheckForIntersections() cannot bin element centroids by their coordinates.
+     * Overridden in periodic meshes.
+     */
+    virtual bool IsPeriodic() const;
+
+    /**
+     * Rebuild the compact connectivity, if it is out of date.
+     */
+    void UpdateCompactConnectivity();
+
+    /**
+     * Rebuild the cached element volumes and surface areas, if they are out of date.
+     */
+    void UpdateCachedElementGeometry();
+
     /**
      * Divide an element along the axis passing through two of its nodes.
      *
@@ -150,6 +234,11 @@ protected:
      * call IdentifySwapType(), which in turn implements the appropriate local remeshing operation
      * (a T1 swap, void removal, or node merge).
      *
+     * Short edges that are far enough apart not to affect one another are swapped in a single
+     * call, in the order in which a search over the elements finds them. If incremental checks are
+     * switched on, only elements containing a node that has moved further than its entry in
+     * mSwapCheckSlacks since the last search are searched; no other edge can have become short.
+     *
      * @return whether we need to check for, and implement, any further local remeshing operations
      *                   (true if any swaps are performed).
      */
@@ -161,6 +250,11 @@ protected:
      * Check if any elements have become intersected and correct this by implementing the appropriate
      * local remeshing operation (a T3 swap or node merge).
      *
+     * When checking for internal intersections, each node is only checked against the elements
+     * that share a node with an element containing it. Otherwise, each boundary node is only checked
+     * against the boundary elements whose centroids lie in the same or an adjacent box of a grid with
+     * spacing mDistanceForT3SwapChecking (unless the mesh is periodic).
+     *
      * @return whether to recheck the mesh again
      */
     bool CheckForIntersections();
@@ -499,6 +593,24 @@ public:
      */
     double GetDistanceForT3SwapChecking() const;
 
+    /**
+     * Set whether to search for short edges incrementally in ReMesh(). The node locations at the
+     * last search are then stored, and the next search only visits elements containing a node that
+     * has moved far enough to have made one of its edges short. The swaps performed are the same.
+     *
+     * Any change to the mesh topology through the methods of this class restarts the search from
+     * scratch. Code that changes the nodes of elements directly must call SetUseIncrementalSwapChecks()
+     * again before the next ReMesh(), which does the same. Off by default.
+     *
+     * @param useIncrementalSwapChecks whether to search incrementally
+     */
+    void SetUseIncrementalSwapChecks(bool useIncrementalSwapChecks);
+
+    /**
+     * @return whether ReMesh() searches for short edges incrementally
+     */
+    bool GetUseIncrementalSwapChecks() const;
+
     /**
      * @return the number of Nodes in the mesh.
      */
@@ -539,6 +651,65 @@ public:
      */
     void ClearLocationsOfT3Swaps();
 
+    /**
+     * Get the offsets of the compact element-node connectivity, rebuilding it if necessary.
+     * The nodes of element i are given by rGetElementNodeIndices() from entry
+     * rGetElementNodeOffsets()[i] up to, but not including, entry rGetElementNodeOffsets()[i+1].
+     *
+     * @return the offsets, with GetNumAllElements()+1 entries.
+     */
+    const std::vector<unsigned>& rGetElementNodeOffsets();
+
+    /**
+     * @return the node indices of the compact element-node connectivity (see rGetElementNodeOffsets()).
+     */
+    const std::vector<unsigned>& rGetElementNodeIndices();
+
+    /**
+     * Get the offsets of the compact node-element connectivity, rebuilding it if necessary.
+     * The elements containing node i, in increasing order of index, are given by rGetNodeElementIndices()
+     * from entry rGetNodeElementOffsets()[i] up to, but not including, entry rGetNodeElementOffsets()[i+1];
+     * the same entries of rGetNodeElementLocalIndices() give the node's local index in each element.
+     *
+     * @return the offsets, with GetNumAllNodes()+1 entries.
+     */
+    const std::vector<unsigned>& rGetNodeElementOffsets();
+
+    /**
+     * @return the element indices of the compact node-element connectivity (see rGetNodeElementOffsets()).
+     */
+    const std::vector<unsigned>& rGetNodeElementIndices();
+
+    /**
+     * @return the local index of each node in each of its containing elements (see rGetNodeElementOffsets()).
+     */
+    const std::vector<unsigned>& rGetNodeElementLocalIndices();
+
+    /**
+     * Get the volume (area in 2D) of an element, using a cache of the volumes of all elements.
+     *
+     * The cache is rebuilt after the mesh has changed through SetNode(), ReMesh() or any other
+     * method of this class. Code that moves nodes directly, through Node::rGetModifiableLocation(),
+     * must call InvalidateCachedElementData() before using the cache again.
+     *
+     * @param index the global index of the element
+     * @return the volume of the element
+     */
+    double GetCachedVolumeOfElement(unsigned index);
+
+    /**
+     * Get the surface area (perimeter in 2D) of an element, using a cache as in GetCachedVolumeOfElement().
+     *
+     * @param index the global index of the element
+     * @return the surface area of the element
+     */
+    double GetCachedSurfaceAreaOfElement(unsigned index);
+
+    /**
+     * Mark the compact connectivity and the cached element volumes and surface areas as out of date.
+     */
+    void InvalidateCachedElementData();
+
     /**
      * Add a node to the mesh.
      *
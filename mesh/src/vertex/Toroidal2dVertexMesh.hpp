@@ -131,6 +131,13 @@ public:
      */
     c_vector<double, 2> GetVectorFromAtoB(const c_vector<double, 2>& rLocation1, const c_vector<double, 2>& rLocation2);
 
+    /**
+     * Overridden IsPeriodic() method.
+     *
+     * @return true
+     */
+    bool IsPeriodic() const;
+
     /**
      * Overridden SetNode() method.
      *
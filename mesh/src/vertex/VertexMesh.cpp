@@ -1492,6 +1492,23 @@ c_vector<double, SPACE_DIM> VertexMesh<ELEMENT_DIM, SPACE_DIM>::GetPerimeterGrad
     return previous_edge_gradient + next_edge_gradient;
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+c_matrix<double, SPACE_DIM, SPACE_DIM> VertexMesh<ELEMENT_DIM, SPACE_DIM>::GetNextEdgeHessianOfElementAtNode(VertexElement<ELEMENT_DIM, SPACE_DIM>* pElement, unsigned localIndex)
+{
+    assert(SPACE_DIM == 2); // LCOV_EXCL_LINE - code will be removed at compile time
+
+    unsigned next_local_index = (localIndex + 1) % (pElement->GetNumNodes());
+
+    c_vector<double, SPACE_DIM> edge = this->GetVectorFromAtoB(pElement->GetNodeLocation(localIndex), pElement->GetNodeLocation(next_local_index));
+    double edge_length = norm_2(edge);
+    assert(edge_length > DBL_EPSILON);
+
+    c_vector<double, SPACE_DIM> unit_edge = edge / edge_length;
+    c_matrix<double, SPACE_DIM, SPACE_DIM> next_edge_hessian = (identity_matrix<double>(SPACE_DIM) - outer_prod(unit_edge, unit_edge)) / edge_length;
+
+    return next_edge_hessian;
+}
+
 //////////////////////////////////////////////////////////////////////
 //                        3D-specific methods                       //
 //////////////////////////////////////////////////////////////////////
@@ -454,6 +454,22 @@ public:
      */
     c_vector<double, SPACE_DIM> GetPerimeterGradientOfElementAtNode(VertexElement<ELEMENT_DIM, SPACE_DIM>* pElement, unsigned localIndex);
 
+    /**
+     * Compute the Hessian of the length of the edge of a 2D element starting at one of its nodes,
+     * with respect to the location of this node. This is (I - u u^T)/L, where u is the unit vector
+     * along the edge and L its length; the Hessian with respect to the location of the next node
+     * is the same, and the mixed second derivatives are its negative.
+     *
+     * N.B. This calls GetVectorFromAtoB(), which can be overridden
+     * in daughter classes for non-Euclidean metrics.
+     *
+     * @param pElement  pointer to a specified vertex element
+     * @param localIndex  local index of a node in this element
+     *
+     * @return the Hessian of the length of the edge of the element that starts at this node.
+     */
+    c_matrix<double, SPACE_DIM, SPACE_DIM> GetNextEdgeHessianOfElementAtNode(VertexElement<ELEMENT_DIM, SPACE_DIM>* pElement, unsigned localIndex);
+
     /**
      * Compute the second moments and product moment of area for a given 2D element
      * about its centroid. These are:
@@ -148,7 +148,7 @@ std::vector<double> AbstractTetrahedralMeshWriter<ELEMENT_DIM, SPACE_DIM>::GetNe
         status.MPI_ERROR = MPI_SUCCESS; //For MPICH2
         // do receive, convert to std::vector on master
         boost::scoped_array<double> raw_coords(new double[SPACE_DIM]);
-        MPI_Recv(raw_coords.get(), SPACE_DIM, MPI_DOUBLE, MPI_ANY_SOURCE, mNodeCounterForParallelMesh, PETSC_COMM_WORLD, &status);
+        MPI_Recv(raw_coords.get(), SPACE_DIM, MPI_DOUBLE, MPI_ANY_SOURCE, mNodeCounterForParallelMesh, PetscTools::GetWorld(), &status);
         assert(status.MPI_ERROR == MPI_SUCCESS);
         for (unsigned j=0; j<coords.size(); j++)
         {
@@ -341,7 +341,7 @@ void AbstractTetrahedralMeshWriter<ELEMENT_DIM, SPACE_DIM>::WriteNclFile(
     else
     {
         unsigned max_elements_per_process = rMesh.CalculateMaximumContainingElementsPerProcess();
-        MPI_Allreduce(&max_elements_per_process, &max_elements_all, 1, MPI_UNSIGNED, MPI_MAX, PETSC_COMM_WORLD);
+        MPI_Allreduce(&max_elements_per_process, &max_elements_all, 1, MPI_UNSIGNED, MPI_MAX, PetscTools::GetWorld());
     }
 
     std::string node_connect_list_file_name = this->mBaseName + ".ncl";
@@ -533,6 +533,11 @@ void AbstractTetrahedralMeshWriter<ELEMENT_DIM, SPACE_DIM>::WriteFilesUsingParal
 {
     if (keepOriginalElementIndexing)
     {
+        if (WriteFilesCollectively())
+        {
+            return;
+        }
+
         // Master goes on to write as usual
         if (PetscTools::AmMaster())
         {
@@ -551,7 +556,7 @@ void AbstractTetrahedralMeshWriter<ELEMENT_DIM, SPACE_DIM>::WriteFilesUsingParal
                 {
                     raw_coords[j] = it->GetPoint()[j];
                 }
-                MPI_Ssend(raw_coords.get(), SPACE_DIM, MPI_DOUBLE, 0, it->GetIndex(), PETSC_COMM_WORLD);//Nodes sent with positive tags
+                MPI_Ssend(raw_coords.get(), SPACE_DIM, MPI_DOUBLE, 0, it->GetIndex(), PetscTools::GetWorld());//Nodes sent with positive tags
             }
 //            PetscTools::Barrier("DodgyBarrierAfterNODE");
             MeshEventHandler::EndEvent(MeshEventHandler::NODE);
@@ -641,6 +646,12 @@ void AbstractTetrahedralMeshWriter<ELEMENT_DIM, SPACE_DIM>::WriteFilesUsingParal
     }
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool AbstractTetrahedralMeshWriter<ELEMENT_DIM, SPACE_DIM>::WriteFilesCollectively()
+{
+    return false;
+}
+
 // LCOV_EXCL_START
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void AbstractTetrahedralMeshWriter<ELEMENT_DIM, SPACE_DIM>::CreateFilesWithHeaders()
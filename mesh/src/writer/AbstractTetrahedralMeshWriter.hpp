@@ -101,13 +101,13 @@ private:
         MeshEventHandler::BeginEvent(MeshEventHandler::COMM1);
         MPI_Ssend(indices, numIndices, MPI_UNSIGNED, 0,
                   tag, //Elements sent with tags offset
-                  PETSC_COMM_WORLD);
+                  PetscTools::GetWorld());
         MeshEventHandler::EndEvent(MeshEventHandler::COMM1);
         // Attribute value has the same tag (assume that it doesn't overtake the previous message)
         MeshEventHandler::BeginEvent(MeshEventHandler::COMM2);
         MPI_Ssend(&attribute, 1, MPI_DOUBLE, 0,
                   tag, //Elements sent with tags offset
-                  PETSC_COMM_WORLD);
+                  PetscTools::GetWorld());
         MeshEventHandler::EndEvent(MeshEventHandler::COMM2);
     }
     /**
@@ -126,7 +126,7 @@ private:
         MeshEventHandler::BeginEvent(MeshEventHandler::COMM1);
         MPI_Recv(raw_indices.get(), numIndices, MPI_UNSIGNED, MPI_ANY_SOURCE,
                  tag,
-                 PETSC_COMM_WORLD, &status);
+                 PetscTools::GetWorld(), &status);
         MeshEventHandler::EndEvent(MeshEventHandler::COMM1);
         // Convert to std::vector
         for (unsigned j=0; j< rElementData.NodeIndices.size(); j++)
@@ -139,7 +139,7 @@ private:
         MeshEventHandler::BeginEvent(MeshEventHandler::COMM2);
         MPI_Recv(&attribute, 1U, MPI_DOUBLE, MPI_ANY_SOURCE,
                  tag,
-                 PETSC_COMM_WORLD, &status);
+                 PetscTools::GetWorld(), &status);
         MeshEventHandler::EndEvent(MeshEventHandler::COMM2);
 
         // Attribute value
@@ -164,6 +164,16 @@ private:
     void WriteNclFile(AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>& rMesh,
                       bool invertMeshPermutation=false);
 
+    /**
+     * Write a parallel mesh (keeping the original element indexing) with each process writing
+     * its own part of the files directly, rather than sending it to the master process.
+     * Collectively called.
+     *
+     * @return whether the files were written (the default implementation does nothing and
+     *     returns false, so the data is concentrated on the master process instead)
+     */
+    virtual bool WriteFilesCollectively();
+
     /**
      * Create output files and add headers.
      */
@@ -36,9 +36,14 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "TrianglesMeshWriter.hpp"
 
 #include "AbstractTetrahedralMesh.hpp"
+#include "DistributedTetrahedralMesh.hpp"
+#include "PetscTools.hpp"
 #include "Version.hpp"
 
 #include <cassert>
+#include <cstring>
+#include <algorithm>
+#include <mpi.h> // For MPI-IO
 
 ///////////////////////////////////////////////////////////////////////////////////
 // Implementation
@@ -415,6 +420,172 @@ void TrianglesMeshWriter<ELEMENT_DIM, SPACE_DIM>::WriteItem(out_stream &pFile, u
     }
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool TrianglesMeshWriter<ELEMENT_DIM, SPACE_DIM>::WriteFilesCollectively()
+{
+    assert(this->mpDistributedMesh);
+    if (!this->mFilesAreBinary || ELEMENT_DIM != SPACE_DIM || this->mpMixedMesh || this->GetNumElements() == 0u)
+    {
+        return false;
+    }
+    // The data sent to the master assumes linear elements, so we do too
+    bool is_quadratic = (this->mNodesPerElement != ELEMENT_DIM+1 || this->mNodesPerBoundaryElement != ELEMENT_DIM);
+    if (PetscTools::ReplicateBool(is_quadratic))
+    {
+        return false;
+    }
+
+    std::string comment = "#\n# " + ChasteBuildInfo::GetProvenanceString() + "\n";
+
+    MeshEventHandler::BeginEvent(MeshEventHandler::NODE);
+    {
+        const unsigned item_width = SPACE_DIM*sizeof(double);
+        std::vector<unsigned> indices;
+        std::vector<char> data;
+        indices.reserve(this->mpDistributedMesh->GetNumLocalNodes());
+        data.reserve(this->mpDistributedMesh->GetNumLocalNodes()*item_width);
+        typedef typename AbstractMesh<ELEMENT_DIM,SPACE_DIM>::NodeIterator NodeIterType;
+        for (NodeIterType it = this->mpMesh->GetNodeIteratorBegin(); it != this->mpMesh->GetNodeIteratorEnd(); ++it)
+        {
+            indices.push_back(it->GetIndex());
+            const c_vector<double, SPACE_DIM>& r_location = it->rGetLocation();
+            const char* p_location = reinterpret_cast<const char*>(&r_location[0]);
+            data.insert(data.end(), p_location, p_location + item_width);
+        }
+
+        std::stringstream header;
+        header << this->GetNumNodes() << "\t" << SPACE_DIM << "\t" << 0 << "\t" << 0 << "\tBIN\n";
+        WriteBinaryFileCollectively(this->mBaseName + ".node", header.str(), indices, data, item_width, this->GetNumNodes(), comment);
+    }
+    MeshEventHandler::EndEvent(MeshEventHandler::NODE);
+
+    MeshEventHandler::BeginEvent(MeshEventHandler::ELE);
+    {
+        // Node indices followed by the attribute
+        const unsigned item_width = (ELEMENT_DIM+1)*sizeof(unsigned) + sizeof(double);
+        std::vector<unsigned> indices;
+        std::vector<char> data;
+        std::vector<unsigned> node_indices(ELEMENT_DIM+1);
+        typedef typename AbstractTetrahedralMesh<ELEMENT_DIM,SPACE_DIM>::ElementIterator ElementIterType;
+        for (ElementIterType it = this->mpMesh->GetElementIteratorBegin(); it != this->mpMesh->GetElementIteratorEnd(); ++it)
+        {
+            unsigned index = it->GetIndex();
+            if (this->mpDistributedMesh->CalculateDesignatedOwnershipOfElement(index))
+            {
+                indices.push_back(index);
+                for (unsigned j=0; j<ELEMENT_DIM+1; j++)
+                {
+                    node_indices[j] = it->GetNodeGlobalIndex(j);
+                }
+                double attribute = it->GetAttribute();
+                const char* p_indices = reinterpret_cast<const char*>(&node_indices[0]);
+                const char* p_attribute = reinterpret_cast<const char*>(&attribute);
+                data.insert(data.end(), p_indices, p_indices + (ELEMENT_DIM+1)*sizeof(unsigned));
+                data.insert(data.end(), p_attribute, p_attribute + sizeof(double));
+            }
+        }
+
+        std::stringstream header;
+        header << this->GetNumElements() << "\t" << ELEMENT_DIM+1 << "\t" << 1 << "\tBIN\n";
+        WriteBinaryFileCollectively(this->mBaseName + ".ele", header.str(), indices, data, item_width, this->GetNumElements(), comment);
+    }
+    MeshEventHandler::EndEvent(MeshEventHandler::ELE);
+
+    MeshEventHandler::BeginEvent(MeshEventHandler::FACE);
+    // In 1-D there is no boundary file: it's trivial to calculate
+    if (ELEMENT_DIM != 1)
+    {
+        const unsigned item_width = ELEMENT_DIM*sizeof(unsigned);
+        std::vector<unsigned> indices;
+        std::vector<char> data;
+        std::vector<unsigned> node_indices(ELEMENT_DIM);
+        typedef typename AbstractTetrahedralMesh<ELEMENT_DIM,SPACE_DIM>::BoundaryElementIterator BoundaryElementIterType;
+        for (BoundaryElementIterType it = this->mpMesh->GetBoundaryElementIteratorBegin(); it != this->mpMesh->GetBoundaryElementIteratorEnd(); ++it)
+        {
+            unsigned index = (*it)->GetIndex();
+            if (this->mpDistributedMesh->CalculateDesignatedOwnershipOfBoundaryElement(index))
+            {
+                indices.push_back(index);
+                for (unsigned j=0; j<ELEMENT_DIM; j++)
+                {
+                    node_indices[j] = (*it)->GetNodeGlobalIndex(j);
+                }
+                const char* p_indices = reinterpret_cast<const char*>(&node_indices[0]);
+                data.insert(data.end(), p_indices, p_indices + item_width);
+            }
+        }
+
+        std::string face_file_name = this->mBaseName + (ELEMENT_DIM == 2 ? ".edge" : ".face");
+        std::stringstream header;
+        header << this->GetNumBoundaryFaces() << "\t" << 0 << "\tBIN\n";
+        WriteBinaryFileCollectively(face_file_name, header.str(), indices, data, item_width, this->GetNumBoundaryFaces(), comment);
+    }
+    MeshEventHandler::EndEvent(MeshEventHandler::FACE);
+
+    PetscTools::Barrier("TrianglesMeshWriter::WriteFilesCollectively");
+    return true;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void TrianglesMeshWriter<ELEMENT_DIM, SPACE_DIM>::WriteBinaryFileCollectively(const std::string& rFileName,
+                                                                              const std::string& rHeader,
+                                                                              const std::vector<unsigned>& rIndices,
+                                                                              const std::vector<char>& rData,
+                                                                              unsigned itemWidth,
+                                                                              unsigned numItems,
+                                                                              const std::string& rFooter)
+{
+    assert(rData.size() == rIndices.size()*itemWidth);
+
+    // A file view needs increasing offsets, so sort our items by global index
+    std::vector<std::pair<unsigned, unsigned> > index_and_position(rIndices.size());
+    for (unsigned i=0; i<rIndices.size(); i++)
+    {
+        index_and_position[i] = std::make_pair(rIndices[i], i);
+    }
+    std::sort(index_and_position.begin(), index_and_position.end());
+
+    std::vector<int> displacements(rIndices.size());
+    std::vector<char> sorted_data(rData.size());
+    for (unsigned i=0; i<index_and_position.size(); i++)
+    {
+        displacements[i] = index_and_position[i].first;
+        memcpy(&sorted_data[i*itemWidth], &rData[index_and_position[i].second*itemWidth], itemWidth);
+    }
+
+    std::string file_path = this->mpOutputFileHandler->GetOutputDirectoryFullPath() + rFileName;
+    MPI_File file;
+    MPI_File_open(PetscTools::GetWorld(), const_cast<char*>(file_path.c_str()), MPI_MODE_WRONLY | MPI_MODE_CREATE, MPI_INFO_NULL, &file);
+    MPI_File_set_size(file, 0);
+
+    if (PetscTools::AmMaster())
+    {
+        MPI_File_write_at(file, 0, const_cast<char*>(rHeader.c_str()), rHeader.size(), MPI_CHAR, MPI_STATUS_IGNORE);
+    }
+
+    // Each process sees only its own items in the file
+    MPI_Datatype item_type;
+    MPI_Type_contiguous(itemWidth, MPI_BYTE, &item_type);
+    MPI_Type_commit(&item_type);
+    MPI_Datatype file_type;
+    MPI_Type_create_indexed_block(displacements.size(), 1, displacements.data(), item_type, &file_type);
+    MPI_Type_commit(&file_type);
+
+    MPI_File_set_view(file, rHeader.size(), item_type, file_type, const_cast<char*>("native"), MPI_INFO_NULL);
+    MPI_File_write_all(file, sorted_data.data(), index_and_position.size(), item_type, MPI_STATUS_IGNORE);
+    MPI_File_set_view(file, 0, MPI_BYTE, MPI_BYTE, const_cast<char*>("native"), MPI_INFO_NULL);
+
+    if (PetscTools::AmMaster())
+    {
+        MPI_Offset footer_offset = rHeader.size() + (MPI_Offset)numItems*itemWidth;
+        MPI_File_write_at(file, footer_offset, const_cast<char*>(rFooter.c_str()), rFooter.size(), MPI_CHAR, MPI_STATUS_IGNORE);
+    }
+
+    MPI_File_close(&file);
+    MPI_Type_free(&file_type);
+    MPI_Type_free(&item_type);
+}
+
 // Explicit instantiation
 template class TrianglesMeshWriter<1,1>;
 template class TrianglesMeshWriter<1,2>;
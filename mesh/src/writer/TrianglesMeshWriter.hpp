@@ -47,6 +47,39 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 class TrianglesMeshWriter : public AbstractTetrahedralMeshWriter<ELEMENT_DIM, SPACE_DIM>
 {
+private:
+
+    /**
+     * Write a linear DistributedTetrahedralMesh in binary format using MPI-IO: each process writes
+     * the nodes it owns and the elements and boundary elements it is the designated owner of, at
+     * offsets computed from their global indices.  The files are the same as those written via the
+     * master process.  Collectively called.
+     *
+     * @return whether the files were written (false for ascii output, quadratic or mixed dimension
+     *     meshes, and meshes with elements of lower dimension than space)
+     */
+    bool WriteFilesCollectively();
+
+    /**
+     * Collectively write one binary file made of a text header, fixed width items and a text footer.
+     * The master process writes the header and footer.
+     *
+     * @param rFileName  the name of the file, relative to the output directory
+     * @param rHeader  the header line(s)
+     * @param rIndices  the global indices of the items this process writes
+     * @param rData  the raw data of those items, in the same order
+     * @param itemWidth  the size of each item in bytes
+     * @param numItems  the total number of items in the file
+     * @param rFooter  the footer
+     */
+    void WriteBinaryFileCollectively(const std::string& rFileName,
+                                     const std::string& rHeader,
+                                     const std::vector<unsigned>& rIndices,
+                                     const std::vector<char>& rData,
+                                     unsigned itemWidth,
+                                     unsigned numItems,
+                                     const std::string& rFooter);
+
 public:
 
     /**
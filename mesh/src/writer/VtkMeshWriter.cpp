@@ -408,7 +408,7 @@ void VtkMeshWriter<ELEMENT_DIM, SPACE_DIM>::AddPointData(
             receive_data.get(), number_of_nodes_to_receive,
             MPI_DOUBLE,
             receive_from, 0,
-            PETSC_COMM_WORLD, &status);
+            PetscTools::GetWorld(), &status);
         UNUSED_OPT(ret);
         assert(ret == MPI_SUCCESS);
       }
@@ -489,7 +489,7 @@ void VtkMeshWriter<ELEMENT_DIM, SPACE_DIM>::AddPointData(
           receive_data.get(), number_of_nodes_to_receive * SPACE_DIM,
           MPI_DOUBLE,
           receive_from, 0,
-          PETSC_COMM_WORLD, &status);
+          PetscTools::GetWorld(), &status);
       UNUSED_OPT(ret);
       assert(ret == MPI_SUCCESS);
 
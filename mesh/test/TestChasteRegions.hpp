@@ -42,6 +42,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "AbstractChasteRegion.hpp"
 #include "ChasteCuboid.hpp"
 #include "ChasteEllipsoid.hpp"
+#include "ChasteNodeAttributeRegion.hpp"
 #include "ChasteNodesList.hpp"
 #include "ChastePoint.hpp"
 #include "Node.hpp"
@@ -159,6 +160,46 @@ public:
         TS_ASSERT_EQUALS(nodes_list.DoesContain(test_point_non_contained), false);
 
         TS_ASSERT_EQUALS(nodes_list.GetSize(), 3u);
+
+        // Nodes are looked up by index, and must also be in the same place
+        Node<3> same_node(2u, point_c);
+        Node<3> other_node(3u, point_c);
+        Node<3> moved_node(1u, point_c);
+        TS_ASSERT_EQUALS(nodes_list.DoesContainNode(&third_node), true);
+        TS_ASSERT_EQUALS(nodes_list.DoesContainNode(&same_node), true);
+        TS_ASSERT_EQUALS(nodes_list.DoesContainNode(&other_node), false);
+        TS_ASSERT_EQUALS(nodes_list.DoesContainNode(&moved_node), false);
+
+        // Other regions check the node's location
+        ChasteCuboid<3> cuboid(point_a, point_b);
+        AbstractChasteRegion<3>* p_region = &cuboid;
+        TS_ASSERT_EQUALS(p_region->DoesContainNode(&first_node), true);
+        TS_ASSERT_EQUALS(p_region->DoesContainNode(&third_node), false);
+    }
+
+    void TestNodeAttributeRegion()
+    {
+        ChastePoint<2> point(0.0, 0.0);
+        Node<2> unlabelled_node(0u, point);
+        Node<2> lv_node(1u, point);
+        lv_node.AddNodeAttribute(1.0);
+        Node<2> rv_node(2u, point);
+        rv_node.AddNodeAttribute(2.0);
+        rv_node.AddNodeAttribute(5.0);
+
+        ChasteNodeAttributeRegion<2> lv_region(0u, 1.0);
+        TS_ASSERT_EQUALS(lv_region.GetAttributeIndex(), 0u);
+        TS_ASSERT_EQUALS(lv_region.GetAttributeValue(), 1.0);
+        TS_ASSERT_EQUALS(lv_region.DoesContainNode(&unlabelled_node), false);
+        TS_ASSERT_EQUALS(lv_region.DoesContainNode(&lv_node), true);
+        TS_ASSERT_EQUALS(lv_region.DoesContainNode(&rv_node), false);
+
+        ChasteNodeAttributeRegion<2> second_attribute_region(1u, 5.0);
+        TS_ASSERT_EQUALS(second_attribute_region.DoesContainNode(&lv_node), false);
+        TS_ASSERT_EQUALS(second_attribute_region.DoesContainNode(&rv_node), true);
+
+        TS_ASSERT_THROWS_THIS(lv_region.DoesContain(point),
+                              "A region defined by node attributes can only check whether it contains nodes, not points.");
     }
 
     void TestEllipsoidCreationAndContained()
@@ -47,6 +47,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "NodePartitioner.hpp"
 #include "QuadraticMesh.hpp"
 #include "TrianglesMeshReader.hpp"
+#include "TrianglesMeshWriter.hpp"
 #include "PetscTools.hpp"
 #include "ArchiveOpener.hpp"
 
@@ -386,6 +387,46 @@ public:
 
     }
 
+    void TestConvertedMeshWrittenAsBinary()
+    {
+        // Convert a linear mesh to quadratic, write it as binary and read it back in parallel
+        TrianglesMeshReader<3,3> linear_reader("mesh/test/data/cube_136_elements");
+        QuadraticMesh<3> converted_mesh;
+        converted_mesh.ConstructFromLinearMeshReader(linear_reader);
+
+        TrianglesMeshWriter<3,3> mesh_writer("TestDistributedQuadraticMesh", "converted_cube_binary");
+        mesh_writer.SetWriteFilesAsBinary();
+        mesh_writer.WriteFilesUsingMesh(converted_mesh);
+
+        std::string output_dir = mesh_writer.GetOutputDirectory();
+        TrianglesMeshReader<3,3> mesh_reader(output_dir + "converted_cube_binary", 2, 2);
+        TS_ASSERT(mesh_reader.IsFileFormatBinary());
+        DistributedQuadraticMesh<3> mesh; // PARMETIS_LIBRARY
+        mesh.ConstructFromMeshReader(mesh_reader);
+
+        TS_ASSERT_EQUALS(mesh.GetNumNodes(), 285u);
+        TS_ASSERT_EQUALS(mesh.GetNumElements(), 136u);
+        TS_ASSERT_EQUALS(mesh.GetNumBoundaryElements(), converted_mesh.GetNumBoundaryElements());
+
+        // Every local element and boundary element is fully quadratic, with internal nodes at edge midpoints
+        for (AbstractTetrahedralMesh<3,3>::ElementIterator iter = mesh.GetElementIteratorBegin();
+             iter != mesh.GetElementIteratorEnd();
+             ++iter)
+        {
+            TS_ASSERT_EQUALS(iter->GetNumNodes(), 10u);
+            c_vector<double, 3> midpoint = 0.5*(iter->GetNode(2)->rGetLocation() + iter->GetNode(3)->rGetLocation());
+            TS_ASSERT_DELTA(norm_2(iter->GetNode(9)->rGetLocation() - midpoint), 0.0, 1e-12);
+        }
+        for (AbstractTetrahedralMesh<3,3>::BoundaryElementIterator iter = mesh.GetBoundaryElementIteratorBegin();
+             iter != mesh.GetBoundaryElementIteratorEnd();
+             ++iter)
+        {
+            TS_ASSERT_EQUALS((*iter)->GetNumNodes(), 6u);
+            c_vector<double, 3> midpoint = 0.5*((*iter)->GetNode(0)->rGetLocation() + (*iter)->GetNode(1)->rGetLocation());
+            TS_ASSERT_DELTA(norm_2((*iter)->GetNode(5)->rGetLocation() - midpoint), 0.0, 1e-12);
+        }
+    }
+
     void TestArchiveOfReadMesh()
     {
         FileFinder archive_dir("distributed_quadratic_mesh_archive", RelativeTo::ChasteTestOutput);
@@ -43,6 +43,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "UblasCustomFunctions.hpp"
 #include "DistributedTetrahedralMesh.hpp"
+#include "NodePartitioner.hpp"
 #include "TetrahedralMesh.hpp"
 #include "TrianglesMeshReader.hpp"
 #include "TrianglesMeshWriter.hpp"
@@ -641,6 +642,85 @@ public:
         CompareMeshes( mesh, mesh_from_ncl );
     }
 
+    void TestCollectiveBinaryWriteMatchesSequentialWrite()
+    {
+        TrianglesMeshReader<3,3> mesh_reader("mesh/test/data/cube_136_elements");
+        TetrahedralMesh<3,3> sequential_mesh;
+        sequential_mesh.ConstructFromMeshReader(mesh_reader);
+        mesh_reader.Reset();
+        DistributedTetrahedralMesh<3,3> distributed_mesh(DistributedTetrahedralMeshPartitionType::DUMB);
+        distributed_mesh.ConstructFromMeshReader(mesh_reader);
+
+        // The distributed mesh is written by each process directly (with MPI-IO)
+        TrianglesMeshWriter<3,3> sequential_writer("TestCollectiveBinaryWrite", "sequential");
+        sequential_writer.SetWriteFilesAsBinary();
+        sequential_writer.WriteFilesUsingMesh(sequential_mesh);
+        TrianglesMeshWriter<3,3> distributed_writer("TestCollectiveBinaryWrite", "distributed", false);
+        distributed_writer.SetWriteFilesAsBinary();
+        distributed_writer.WriteFilesUsingMesh(distributed_mesh);
+
+        std::string output_dir = sequential_writer.GetOutputDirectory();
+        std::string extensions[3] = {".node", ".ele", ".face"};
+        for (unsigned i=0; i<3; i++)
+        {
+            std::ifstream sequential_file((output_dir + "sequential" + extensions[i]).c_str(), std::ios::binary);
+            std::ifstream distributed_file((output_dir + "distributed" + extensions[i]).c_str(), std::ios::binary);
+            std::string sequential_contents((std::istreambuf_iterator<char>(sequential_file)), std::istreambuf_iterator<char>());
+            std::string distributed_contents((std::istreambuf_iterator<char>(distributed_file)), std::istreambuf_iterator<char>());
+            TS_ASSERT(!sequential_contents.empty());
+            TS_ASSERT(sequential_contents == distributed_contents);
+        }
+
+        TrianglesMeshReader<3,3> reader(output_dir + "distributed");
+        DistributedTetrahedralMesh<3,3> mesh_from_file(DistributedTetrahedralMeshPartitionType::DUMB);
+        mesh_from_file.ConstructFromMeshReader(reader);
+        CompareMeshes(distributed_mesh, mesh_from_file);
+    }
+
+    void TestGlobalToLocalIndexMap()
+    {
+        GlobalToLocalIndexMap map;
+        TS_ASSERT_EQUALS(map.GetSize(), 0u);
+        TS_ASSERT_EQUALS(map.Contains(0u), false);
+
+        // In order, out of order, and replacing an existing entry
+        map.Insert(10u, 0u);
+        map.Insert(20u, 1u);
+        map.Insert(5u, 2u);
+        map.Insert(15u, 3u);
+        map.Insert(20u, 4u);
+        TS_ASSERT_EQUALS(map.GetSize(), 4u);
+
+        unsigned local_index = UINT_MAX;
+        TS_ASSERT_EQUALS(map.Find(5u, local_index), true);
+        TS_ASSERT_EQUALS(local_index, 2u);
+        TS_ASSERT_EQUALS(map.Find(10u, local_index), true);
+        TS_ASSERT_EQUALS(local_index, 0u);
+        TS_ASSERT_EQUALS(map.Find(15u, local_index), true);
+        TS_ASSERT_EQUALS(local_index, 3u);
+        TS_ASSERT_EQUALS(map.Find(20u, local_index), true);
+        TS_ASSERT_EQUALS(local_index, 4u);
+        TS_ASSERT_EQUALS(map.Contains(12u), false);
+        TS_ASSERT_EQUALS(map.Contains(25u), false);
+
+        std::vector<unsigned> global_indices;
+        global_indices.push_back(7u);
+        global_indices.push_back(3u);
+        global_indices.push_back(9u);
+        map.Rebuild(global_indices);
+        TS_ASSERT_EQUALS(map.GetSize(), 3u);
+        TS_ASSERT_EQUALS(map.Contains(10u), false);
+        for (unsigned i=0; i<global_indices.size(); i++)
+        {
+            TS_ASSERT_EQUALS(map.Find(global_indices[i], local_index), true);
+            TS_ASSERT_EQUALS(local_index, i);
+        }
+
+        map.Clear();
+        TS_ASSERT_EQUALS(map.GetSize(), 0u);
+        TS_ASSERT_EQUALS(map.Contains(7u), false);
+    }
+
     void TestRandomShuffle()
     {
         unsigned num_elts = 200;
@@ -829,6 +909,153 @@ public:
         }
     }
 
+    void TestWeightedPartitioning()
+    {
+        TrianglesMeshReader<3,3> mesh_reader("mesh/test/data/cube_136_elements");
+
+        // Nodes in one half of the cube are ten times as expensive as the others
+        std::vector<double> weights(mesh_reader.GetNumNodes());
+        for (unsigned i=0; i<weights.size(); i++)
+        {
+            weights[i] = (mesh_reader.GetNextNode()[0] < 0.5) ? 10.0 : 1.0;
+        }
+        mesh_reader.Reset();
+
+        {
+            DistributedTetrahedralMesh<3,3> mesh(DistributedTetrahedralMeshPartitionType::PARMETIS_LIBRARY);
+            TS_ASSERT(mesh.rGetNodeWeights().empty());
+            mesh.SetNodeWeights(weights);
+            TS_ASSERT_EQUALS(mesh.rGetNodeWeights().size(), weights.size());
+            mesh.ConstructFromMeshReader(mesh_reader);
+
+            TS_ASSERT_EQUALS(mesh.GetNumNodes(), mesh_reader.GetNumNodes());
+            TS_ASSERT_EQUALS(mesh.GetNumElements(), mesh_reader.GetNumElements());
+            CheckEverythingIsAssigned<3,3>(mesh);
+        }
+
+        if (PetscTools::HasParMetis())
+        {
+            mesh_reader.Reset();
+            DistributedTetrahedralMesh<3,3> mesh(DistributedTetrahedralMeshPartitionType::PETSC_MAT_PARTITION);
+            mesh.SetNodeWeights(weights);
+            mesh.ConstructFromMeshReader(mesh_reader);
+            CheckEverythingIsAssigned<3,3>(mesh);
+        }
+
+        // Weights are converted to positive integers relative to the heaviest
+        TS_ASSERT_EQUALS((NodePartitioner<3,3>::ConvertToPartitionWeight(10.0, 10.0)), MAX_PARTITION_WEIGHT);
+        TS_ASSERT_EQUALS((NodePartitioner<3,3>::ConvertToPartitionWeight(1.0, 10.0)), MAX_PARTITION_WEIGHT/10);
+        TS_ASSERT_EQUALS((NodePartitioner<3,3>::ConvertToPartitionWeight(0.0, 10.0)), 1u);
+
+        // Bad weights
+        DistributedTetrahedralMesh<3,3> mesh;
+        std::vector<double> bad_weights(2, 1.0);
+        bad_weights[1] = -1.0;
+        TS_ASSERT_THROWS_THIS(mesh.SetNodeWeights(bad_weights),
+                              "Node weights for mesh partitioning must be non-negative.");
+        bad_weights[1] = 0.0;
+        bad_weights[0] = 0.0;
+        TS_ASSERT_THROWS_THIS(mesh.SetNodeWeights(bad_weights),
+                              "At least one node weight for mesh partitioning must be positive.");
+        bad_weights[0] = 1.0;
+        mesh.SetNodeWeights(bad_weights);
+        mesh_reader.Reset();
+        TS_ASSERT_THROWS_THIS(mesh.ConstructFromMeshReader(mesh_reader),
+                              "The number of node weights does not match the number of nodes in the mesh.");
+    }
+
+    void TestWeightedDumbPartitioning()
+    {
+        // The first half of the nodes are ten times as expensive as the others
+        std::vector<double> weights(100, 1.0);
+        double total_weight = 0.0;
+        for (unsigned i=0; i<weights.size(); i++)
+        {
+            if (i < 50u)
+            {
+                weights[i] = 10.0;
+            }
+            total_weight += weights[i];
+        }
+
+        std::set<unsigned> nodes_owned;
+        unsigned num_owned = NodePartitioner<2,2>::WeightedDumbPartitioning(weights, nodes_owned);
+        TS_ASSERT_EQUALS(nodes_owned.size(), num_owned);
+        double local_weight = 0.0;
+        for (std::set<unsigned>::iterator it = nodes_owned.begin(); it != nodes_owned.end(); ++it)
+        {
+            local_weight += weights[*it];
+        }
+        if (num_owned > 0u)
+        {
+            // A contiguous range, with no more than its share of the weight (give or take a node)
+            TS_ASSERT_EQUALS(*nodes_owned.rbegin() - *nodes_owned.begin() + 1u, num_owned);
+            TS_ASSERT_LESS_THAN_EQUALS(local_weight, total_weight/PetscTools::GetNumProcs() + 10.0);
+        }
+        unsigned total_owned;
+        MPI_Allreduce(&num_owned, &total_owned, 1, MPI_UNSIGNED, MPI_SUM, PETSC_COMM_WORLD);
+        TS_ASSERT_EQUALS(total_owned, weights.size());
+    }
+
+    void TestRepartitioningOnLoad()
+    {
+        FileFinder archive_dir("distributed_tetrahedral_mesh_repartition", RelativeTo::ChasteTestOutput);
+        std::string archive_file = "distributed_tetrahedral_mesh.arch";
+        ArchiveLocationInfo::SetMeshFilename("distributed_tetrahedral_mesh");
+
+        TrianglesMeshReader<2,2> mesh_reader("mesh/test/data/disk_984_elements");
+        std::vector<unsigned> permutation;
+        {
+            DistributedTetrahedralMesh<2,2> mesh(DistributedTetrahedralMeshPartitionType::PARMETIS_LIBRARY);
+            mesh.ConstructFromMeshReader(mesh_reader);
+            permutation = mesh.rGetNodePermutation();
+
+            ArchiveOpener<boost::archive::text_oarchive, std::ofstream> arch_opener(archive_dir, archive_file);
+            boost::archive::text_oarchive* p_arch = arch_opener.GetCommonArchive();
+            AbstractTetrahedralMesh<2,2>* const p_mesh_abstract = &mesh;
+            (*p_arch) << p_mesh_abstract;
+        }
+
+        // Nodes in the left half of the disk are ten times as expensive as the others
+        mesh_reader.Reset();
+        std::vector<double> weights(mesh_reader.GetNumNodes());
+        double total_weight = 0.0;
+        for (unsigned i=0; i<weights.size(); i++)
+        {
+            weights[i] = (mesh_reader.GetNextNode()[0] < 0.0) ? 10.0 : 1.0;
+            total_weight += weights[i];
+        }
+
+        std::vector<double> bad_weights(1, -1.0);
+        TS_ASSERT_THROWS_THIS(DistributedTetrahedralMesh<2,2>::SetNodeWeightsOnLoad(bad_weights),
+                              "Node weights for mesh partitioning must be non-negative.");
+        DistributedTetrahedralMesh<2,2>::SetNodeWeightsOnLoad(weights);
+        {
+            ArchiveOpener<boost::archive::text_iarchive, std::ifstream> arch_opener(archive_dir, archive_file);
+            boost::archive::text_iarchive* p_arch = arch_opener.GetCommonArchive();
+            AbstractTetrahedralMesh<2,2>* p_mesh_abstract;
+            (*p_arch) >> p_mesh_abstract;
+            DistributedTetrahedralMesh<2,2>* p_mesh = static_cast<DistributedTetrahedralMesh<2,2>*>(p_mesh_abstract);
+
+            // The node numbering is kept, but the ownership is balanced by weight
+            TS_ASSERT_EQUALS(p_mesh->rGetNodePermutation().size(), permutation.size());
+            TS_ASSERT_EQUALS(p_mesh->rGetNodeWeights().size(), weights.size());
+            CheckEverythingIsAssigned<2,2>(*p_mesh);
+            DistributedVectorFactory* p_factory = p_mesh->GetDistributedVectorFactory();
+            double local_weight = 0.0;
+            for (unsigned i=0; i<weights.size(); i++)
+            {
+                unsigned index = permutation.empty() ? i : permutation[i];
+                if (p_factory->IsGlobalIndexLocal(index))
+                {
+                    local_weight += weights[i];
+                }
+            }
+            TS_ASSERT_LESS_THAN_EQUALS(local_weight, total_weight/PetscTools::GetNumProcs() + 10.0);
+            delete p_mesh;
+        }
+        DistributedTetrahedralMesh<2,2>::SetNodeWeightsOnLoad(std::vector<double>());
+    }
 
     void TestConstruct3DWithRegions()
     {
@@ -948,6 +1175,133 @@ public:
         }
     }
 
+    void TestHilbertCurvePartition()
+    {
+        // The curve visits the corners of a 2x2 grid in order
+        std::vector<uint64_t> corner(2, 0u);
+        TS_ASSERT_EQUALS((NodePartitioner<2,2>::CalculateHilbertIndex(corner, 1u)), 0u);
+        corner[1] = 1u;
+        TS_ASSERT_EQUALS((NodePartitioner<2,2>::CalculateHilbertIndex(corner, 1u)), 1u);
+        corner[0] = 1u;
+        TS_ASSERT_EQUALS((NodePartitioner<2,2>::CalculateHilbertIndex(corner, 1u)), 2u);
+        corner[1] = 0u;
+        TS_ASSERT_EQUALS((NodePartitioner<2,2>::CalculateHilbertIndex(corner, 1u)), 3u);
+
+        // Consecutive points along the curve are neighbours on the grid
+        const unsigned num_bits = 3u;
+        const unsigned grid_size = 1u << num_bits;
+        std::vector<std::vector<uint64_t> > points_on_curve(grid_size*grid_size*grid_size);
+        std::vector<uint64_t> point(3);
+        for (point[0]=0; point[0]<grid_size; point[0]++)
+        {
+            for (point[1]=0; point[1]<grid_size; point[1]++)
+            {
+                for (point[2]=0; point[2]<grid_size; point[2]++)
+                {
+                    uint64_t index = NodePartitioner<3,3>::CalculateHilbertIndex(point, num_bits);
+                    TS_ASSERT_LESS_THAN(index, points_on_curve.size());
+                    TS_ASSERT(points_on_curve[index].empty());
+                    points_on_curve[index] = point;
+                }
+            }
+        }
+        for (unsigned i=1; i<points_on_curve.size(); i++)
+        {
+            unsigned distance = 0;
+            for (unsigned d=0; d<3; d++)
+            {
+                distance += std::abs((int)points_on_curve[i][d] - (int)points_on_curve[i-1][d]);
+            }
+            TS_ASSERT_EQUALS(distance, 1u);
+        }
+
+        // Partition a mesh, which should share the nodes out evenly
+        TrianglesMeshReader<3,3> mesh_reader("mesh/test/data/cube_136_elements");
+        {
+            DistributedTetrahedralMesh<3,3> mesh(DistributedTetrahedralMeshPartitionType::HILBERT_CURVE);
+            mesh.ConstructFromMeshReader(mesh_reader);
+
+            TS_ASSERT_EQUALS(mesh.GetNumNodes(), mesh_reader.GetNumNodes());
+            TS_ASSERT_EQUALS(mesh.GetNumElements(), mesh_reader.GetNumElements());
+            TS_ASSERT_EQUALS(mesh.GetNumBoundaryElements(), mesh_reader.GetNumFaces());
+            CheckEverythingIsAssigned<3,3>(mesh);
+
+            unsigned num_procs = PetscTools::GetNumProcs();
+            unsigned num_local_nodes = mesh.GetNumLocalNodes();
+            TS_ASSERT_LESS_THAN_EQUALS(num_local_nodes, mesh.GetNumNodes()/num_procs + 1u);
+            TS_ASSERT_LESS_THAN_EQUALS(mesh.GetNumNodes()/num_procs, num_local_nodes + 1u);
+        }
+
+        // Nodes with x<0.5 are ten times as expensive, so fewer of them should be owned by each process
+        mesh_reader.Reset();
+        std::vector<double> weights(mesh_reader.GetNumNodes());
+        for (unsigned i=0; i<weights.size(); i++)
+        {
+            weights[i] = (mesh_reader.GetNextNode()[0] < 0.5) ? 10.0 : 1.0;
+        }
+        mesh_reader.Reset();
+        {
+            DistributedTetrahedralMesh<3,3> mesh(DistributedTetrahedralMeshPartitionType::HILBERT_CURVE);
+            mesh.SetNodeWeights(weights);
+            mesh.ConstructFromMeshReader(mesh_reader);
+            CheckEverythingIsAssigned<3,3>(mesh);
+        }
+
+        // The Hilbert partition is also allowed for 1D meshes
+        TrianglesMeshReader<1,3> mesh_reader_1d("mesh/test/data/branched_1d_in_3d_mesh");
+        DistributedTetrahedralMesh<1,3> mesh_1d(DistributedTetrahedralMeshPartitionType::HILBERT_CURVE);
+        mesh_1d.ConstructFromMeshReader(mesh_reader_1d);
+        TS_ASSERT_EQUALS(mesh_1d.GetNumNodes(), 31u);
+        TS_ASSERT_EQUALS(mesh_1d.GetNumElements(), 30u);
+        TS_ASSERT_EQUALS(mesh_1d.GetNumBoundaryElements(), 3u);
+    }
+
+    void TestReorderLocalNodes()
+    {
+        TrianglesMeshReader<3,3> mesh_reader("mesh/test/data/cube_136_elements");
+        DistributedTetrahedralMesh<3,3> mesh(DistributedTetrahedralMeshPartitionType::PARMETIS_LIBRARY);
+        TS_ASSERT_EQUALS(mesh.GetReorderLocalNodes(), false);
+        mesh.SetReorderLocalNodes();
+        TS_ASSERT_EQUALS(mesh.GetReorderLocalNodes(), true);
+        mesh.ConstructFromMeshReader(mesh_reader);
+
+        TS_ASSERT_EQUALS(mesh.GetNumNodes(), mesh_reader.GetNumNodes());
+        TS_ASSERT_EQUALS(mesh.GetNumElements(), mesh_reader.GetNumElements());
+        CheckEverythingIsAssigned<3,3>(mesh);
+
+        // Each process still owns a contiguous range of indices, in the order of mNodes
+        DistributedVectorFactory* p_factory = mesh.GetDistributedVectorFactory();
+        unsigned local_index = 0;
+        for (AbstractTetrahedralMesh<3,3>::NodeIterator node_iter = mesh.GetNodeIteratorBegin();
+             node_iter != mesh.GetNodeIteratorEnd();
+             ++node_iter)
+        {
+            TS_ASSERT_EQUALS(node_iter->GetIndex(), p_factory->GetLow() + local_index);
+            local_index++;
+        }
+        TS_ASSERT_EQUALS(local_index, p_factory->GetLocalOwnership());
+
+        // The node permutation maps the original file ordering onto the new one
+        const std::vector<unsigned>& r_permutation = mesh.rGetNodePermutation();
+        if (PetscTools::IsParallel())
+        {
+            TS_ASSERT_EQUALS(r_permutation.size(), mesh.GetNumNodes());
+        }
+        mesh_reader.Reset();
+        for (unsigned old_index=0; old_index<mesh_reader.GetNumNodes(); old_index++)
+        {
+            std::vector<double> location = mesh_reader.GetNextNode();
+            unsigned new_index = r_permutation.empty() ? old_index : r_permutation[old_index];
+            if (p_factory->IsGlobalIndexLocal(new_index))
+            {
+                for (unsigned d=0; d<3; d++)
+                {
+                    TS_ASSERT_DELTA(mesh.GetNode(new_index)->rGetLocation()[d], location[d], 1e-12);
+                }
+            }
+        }
+    }
+
 
     void TestArchiving()
     {
@@ -0,0 +1,125 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTMESHBENCHMARKS_HPP_
+#define TESTMESHBENCHMARKS_HPP_
+
+#include <cxxtest/TestSuite.h>
+
+#include <sstream>
+
+#include "BenchmarkRecorder.hpp"
+#include "DistributedTetrahedralMesh.hpp"
+#include "HoneycombVertexMeshGenerator.hpp"
+#include "MutableVertexMesh.hpp"
+#include "OutputFileHandler.hpp"
+#include "RandomNumberGenerator.hpp"
+#include "TetrahedralMesh.hpp"
+#include "TrianglesMeshReader.hpp"
+#include "TrianglesMeshWriter.hpp"
+#include "PetscSetupAndFinalize.hpp"
+
+/**
+ * Benchmarks of mesh reading and vertex remeshing at several problem sizes.
+ * Results are written to Benchmarks/MeshBenchmarks.json.
+ */
+class TestMeshBenchmarks : public CxxTest::TestSuite
+{
+public:
+
+    void TestMeshReading()
+    {
+        BenchmarkRecorder recorder("MeshBenchmarks");
+        OutputFileHandler handler("TestMeshBenchmarks");
+
+        const unsigned num_elements_across[3] = {10u, 20u, 40u};
+        for (unsigned i=0; i<3; i++)
+        {
+            std::stringstream base_name;
+            base_name << "cube_" << num_elements_across[i];
+            unsigned num_nodes;
+            {
+                TetrahedralMesh<3,3> mesh;
+                mesh.ConstructRegularSlabMesh(1.0/num_elements_across[i], 1.0, 1.0, 1.0);
+                num_nodes = mesh.GetNumNodes();
+                TrianglesMeshWriter<3,3> writer("TestMeshBenchmarks", base_name.str(), false);
+                writer.WriteFilesUsingMesh(mesh);
+            }
+
+            TrianglesMeshReader<3,3> reader(handler.GetOutputDirectoryFullPath() + base_name.str());
+            recorder.Begin("read_distributed_tetrahedral_mesh", num_nodes);
+            DistributedTetrahedralMesh<3,3> mesh;
+            mesh.ConstructFromMeshReader(reader);
+            recorder.End();
+            TS_ASSERT_EQUALS(mesh.GetNumNodes(), num_nodes);
+        }
+
+        recorder.WriteResults();
+    }
+
+    void TestVertexRemeshing()
+    {
+        BenchmarkRecorder recorder("VertexMeshBenchmarks");
+        RandomNumberGenerator* p_gen = RandomNumberGenerator::Instance();
+        p_gen->Reseed(0);
+
+        const unsigned sizes[3] = {20u, 40u, 80u};
+        for (unsigned i=0; i<3; i++)
+        {
+            HoneycombVertexMeshGenerator generator(sizes[i], sizes[i]);
+            MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+
+            // Jiggle the nodes slightly, as between time steps of a simulation
+            recorder.Begin("remesh_x10", p_mesh->GetNumElements());
+            for (unsigned repeat=0; repeat<10; repeat++)
+            {
+                for (unsigned node=0; node<p_mesh->GetNumNodes(); node++)
+                {
+                    c_vector<double, 2>& r_location = p_mesh->GetNode(node)->rGetModifiableLocation();
+                    r_location[0] += 0.002*(p_gen->ranf()-0.5);
+                    r_location[1] += 0.002*(p_gen->ranf()-0.5);
+                }
+                p_mesh->ReMesh();
+            }
+            recorder.End();
+        }
+
+        TS_ASSERT_EQUALS(recorder.GetNumberOfResults(), 3u);
+        recorder.WriteResults();
+        RandomNumberGenerator::Destroy();
+    }
+};
+
+#endif /*TESTMESHBENCHMARKS_HPP_*/
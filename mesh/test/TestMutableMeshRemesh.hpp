@@ -643,6 +643,87 @@ public:
         TS_ASSERT_EQUALS(mesh.GetNumBoundaryNodes(), 4u);
     }
 
+    void TestIncrementalRemesh2D()
+    {
+        // A 6 by 6 grid of nodes, with the interior nodes perturbed to avoid cocircular nodes
+        std::vector<Node<2> *> nodes;
+        for (unsigned j=0; j<6; j++)
+        {
+            for (unsigned i=0; i<6; i++)
+            {
+                unsigned index = 6*j + i;
+                bool is_boundary = (i==0 || i==5 || j==0 || j==5);
+                double perturbation = is_boundary ? 0.0 : 0.1*sin(1.0 + index);
+                nodes.push_back(new Node<2>(index, is_boundary, i + perturbation, j + 0.5*perturbation));
+            }
+        }
+        MutableMesh<2,2> mesh(nodes);
+        TS_ASSERT_EQUALS(mesh.GetUseIncrementalReMesh(), false);
+        TS_ASSERT_EQUALS(mesh.GetLastReMeshWasIncremental(), false);
+        TS_ASSERT_EQUALS(mesh.GetNumElements(), 50u);
+        TS_ASSERT_EQUALS(mesh.GetNumBoundaryElements(), 20u);
+        TS_ASSERT_EQUALS(mesh.CheckIsVoronoi(), true);
+
+        mesh.SetUseIncrementalReMesh();
+        TS_ASSERT_EQUALS(mesh.GetUseIncrementalReMesh(), true);
+
+        // Move an interior node far enough to make some edges non-Delaunay, but without inverting any element
+        c_vector<double, 2>& r_location = mesh.GetNode(14)->rGetModifiableLocation();
+        r_location[0] += 0.3;
+        r_location[1] += 0.2;
+
+        NodeMap map(1);
+        mesh.ReMesh(map);
+        TS_ASSERT_EQUALS(mesh.GetLastReMeshWasIncremental(), true);
+        TS_ASSERT_EQUALS(map.GetSize(), 36u);
+        TS_ASSERT_EQUALS(map.IsIdentityMap(), true);
+        TS_ASSERT_EQUALS(mesh.GetNumNodes(), 36u);
+        TS_ASSERT_EQUALS(mesh.GetNumElements(), 50u);
+        TS_ASSERT_DELTA(mesh.GetVolume(), 25.0, 1e-9);
+        TS_ASSERT_EQUALS(mesh.CheckIsVoronoi(), true);
+
+        // Add a node inside an element; it is inserted by splitting that element
+        c_vector<double, 2> centroid = mesh.GetElement(10)->CalculateCentroid();
+        mesh.AddNode(new Node<2>(mesh.GetNumNodes(), centroid));
+        mesh.ReMesh(map);
+        TS_ASSERT_EQUALS(mesh.GetLastReMeshWasIncremental(), true);
+        TS_ASSERT_EQUALS(map.IsIdentityMap(), true);
+        TS_ASSERT_EQUALS(mesh.GetNumNodes(), 37u);
+        TS_ASSERT_EQUALS(mesh.GetNumElements(), 52u);
+        TS_ASSERT_EQUALS(mesh.GetNode(36)->GetNumContainingElements() > 2u, true);
+        TS_ASSERT_DELTA(mesh.GetVolume(), 25.0, 1e-9);
+        TS_ASSERT_EQUALS(mesh.CheckIsVoronoi(), true);
+
+        // Move a boundary node inside the convex hull; it becomes an interior node
+        mesh.GetNode(2)->rGetModifiableLocation()[1] = 0.3;
+        mesh.ReMesh(map);
+        TS_ASSERT_EQUALS(mesh.GetLastReMeshWasIncremental(), true);
+        TS_ASSERT_EQUALS(map.IsIdentityMap(), true);
+        TS_ASSERT_EQUALS(mesh.GetNumElements(), 53u);
+        TS_ASSERT_EQUALS(mesh.GetNumBoundaryElements(), 19u);
+        TS_ASSERT_EQUALS(mesh.GetNumBoundaryNodes(), 19u);
+        TS_ASSERT_EQUALS(mesh.GetNode(2)->IsBoundaryNode(), false);
+        TS_ASSERT_DELTA(mesh.GetVolume(), 25.0, 1e-9);
+        TS_ASSERT_DELTA(mesh.GetSurfaceArea(), 20.0, 1e-9);
+        TS_ASSERT_EQUALS(mesh.CheckIsVoronoi(), true);
+
+        // An inverted element cannot be repaired by edge flips, so the mesh is rebuilt in full
+        mesh.GetNode(21)->rGetModifiableLocation()[0] -= 2.0;
+        mesh.ReMesh(map);
+        TS_ASSERT_EQUALS(mesh.GetLastReMeshWasIncremental(), false);
+        TS_ASSERT_EQUALS(mesh.GetNumNodes(), 37u);
+        TS_ASSERT_DELTA(mesh.GetVolume(), 25.0, 1e-9);
+        TS_ASSERT_EQUALS(mesh.CheckIsVoronoi(), true);
+
+        // Deleting a node also requires the mesh to be rebuilt in full
+        mesh.DeleteNodePriorToReMesh(36);
+        mesh.ReMesh(map);
+        TS_ASSERT_EQUALS(mesh.GetLastReMeshWasIncremental(), false);
+        TS_ASSERT_EQUALS(map.IsDeleted(36), true);
+        TS_ASSERT_EQUALS(mesh.GetNumNodes(), 36u);
+        TS_ASSERT_EQUALS(mesh.CheckIsVoronoi(), true);
+    }
+
     void TestRemeshWithLibraryMethod2D()
     {
         TrianglesMeshReader<2,2> mesh_reader("mesh/test/data/disk_984_elements");
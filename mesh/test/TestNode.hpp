@@ -270,6 +270,75 @@ public:
         TS_ASSERT_DELTA(node.GetRadius(), 1.6, 1e-4);
     }
 
+    void TestNodeWithAttributesStore()
+    {
+        NodeAttributesStore<3> store;
+
+        // Attributes set up before attaching to the store are moved across
+        Node<3> node(0, false, 0.0, 1.0, 2.0);
+        node.AddNodeAttribute(2.5);
+        node.SetRadius(0.7);
+        node.SetRegion(3u);
+        node.AddNeighbour(4u);
+        TS_ASSERT(!node.UsesAttributesStore());
+
+        node.UseAttributesStore(&store);
+        TS_ASSERT(node.UsesAttributesStore());
+        TS_ASSERT(node.HasNodeAttributes());
+        TS_ASSERT_EQUALS(store.GetNumSlots(), 1u);
+        TS_ASSERT_EQUALS(node.GetNumNodeAttributes(), 1u);
+        TS_ASSERT_DELTA(node.rGetNodeAttributes()[0], 2.5, 1e-12);
+        TS_ASSERT_DELTA(node.GetRadius(), 0.7, 1e-12);
+        TS_ASSERT_EQUALS(node.GetRegion(), 3u);
+        TS_ASSERT_EQUALS(node.rGetNeighbours().size(), 1u);
+
+        {
+            // A node without attributes gets defaults from the store
+            Node<3> other_node(1, false, 1.0, 1.0, 1.0);
+            other_node.UseAttributesStore(&store);
+            TS_ASSERT_EQUALS(store.GetNumSlots(), 2u);
+            TS_ASSERT(other_node.HasNodeAttributes());
+            TS_ASSERT_EQUALS(other_node.GetRegion(), 0u);
+            TS_ASSERT_DELTA(other_node.GetRadius(), 0.0, 1e-12);
+            TS_ASSERT_EQUALS(other_node.IsParticle(), false);
+            TS_ASSERT_EQUALS(other_node.GetNeighboursSetUp(), false);
+
+            c_vector<double, 3> force_contribution = scalar_vector<double>(3, 1.0);
+            other_node.AddAppliedForceContribution(force_contribution);
+            other_node.AddAppliedForceContribution(force_contribution);
+            TS_ASSERT_DELTA(other_node.rGetAppliedForce()[2], 2.0, 1e-12);
+            other_node.ClearAppliedForce();
+            TS_ASSERT_DELTA(other_node.rGetAppliedForce()[2], 0.0, 1e-12);
+
+            other_node.SetIsParticle(true);
+            other_node.SetNeighboursSetUp(true);
+            TS_ASSERT_EQUALS(other_node.IsParticle(), true);
+            TS_ASSERT_EQUALS(other_node.GetNeighboursSetUp(), true);
+
+            other_node.AddNeighbour(2u);
+            other_node.AddNeighbour(2u);
+            other_node.RemoveDuplicateNeighbours();
+            TS_ASSERT_EQUALS(other_node.rGetNeighbours().size(), 1u);
+            other_node.ClearNeighbours();
+            TS_ASSERT_EQUALS(other_node.NeighboursIsEmpty(), true);
+
+            TS_ASSERT_THROWS_THIS(other_node.SetRadius(-1.0), "Trying to set node attributes mRadius to a negative value.");
+
+            // The first node is unaffected
+            TS_ASSERT_EQUALS(node.IsParticle(), false);
+            TS_ASSERT_DELTA(node.GetRadius(), 0.7, 1e-12);
+        }
+
+        // Destroying a node frees its slot, which is then reused with default values
+        TS_ASSERT_EQUALS(store.GetNumFreeSlots(), 1u);
+        Node<3> new_node(2, false, 2.0, 2.0, 2.0);
+        new_node.UseAttributesStore(&store);
+        TS_ASSERT_EQUALS(store.GetNumSlots(), 2u);
+        TS_ASSERT_EQUALS(store.GetNumFreeSlots(), 0u);
+        TS_ASSERT_EQUALS(new_node.IsParticle(), false);
+        TS_ASSERT_EQUALS(new_node.GetNumNodeAttributes(), 0u);
+    }
+
     void TestArchiveNode()
     {
         EXIT_IF_PARALLEL;
@@ -127,6 +127,47 @@ public:
         }
     }
 
+    void TestCompactNodeAttributes()
+    {
+        std::vector<Node<2>*> nodes;
+        for (unsigned i=0; i<4; i++)
+        {
+            nodes.push_back(new Node<2>(i, false, (double)i, 0.0));
+        }
+        nodes[0]->AddNodeAttribute(9.81);
+
+        NodesOnlyMesh<2> mesh;
+        mesh.ConstructNodesWithoutMesh(nodes, 1.5);
+        TS_ASSERT(!mesh.HasCompactNodeAttributes());
+
+        mesh.UseCompactNodeAttributes();
+        TS_ASSERT(mesh.HasCompactNodeAttributes());
+
+        for (AbstractMesh<2,2>::NodeIterator node_iter = mesh.GetNodeIteratorBegin();
+             node_iter != mesh.GetNodeIteratorEnd();
+             ++node_iter)
+        {
+            TS_ASSERT(node_iter->UsesAttributesStore());
+            TS_ASSERT_DELTA(node_iter->GetRadius(), 0.5, 1e-12);
+        }
+
+        if (PetscTools::IsSequential())
+        {
+            TS_ASSERT_EQUALS(mesh.GetNode(0)->rGetNodeAttributes().size(), 1u);
+            TS_ASSERT_DELTA(mesh.GetNode(0)->rGetNodeAttributes()[0], 9.81, 1e-12);
+
+            // Nodes added later use the store too
+            unsigned new_index = mesh.AddNode(new Node<2>(0, false, 0.5, 0.5));
+            TS_ASSERT(mesh.GetNode(new_index)->UsesAttributesStore());
+            TS_ASSERT_DELTA(mesh.GetNode(new_index)->GetRadius(), 0.5, 1e-12);
+        }
+
+        for (unsigned i=0; i<nodes.size(); i++)
+        {
+            delete nodes[i];
+        }
+    }
+
     void TestConstructNodesWithoutMeshSharedPtr()
     {
         std::vector<boost::shared_ptr<Node<3> > > nodes;
@@ -732,6 +773,51 @@ public:
         }
     }
 
+    void TestDeleteManyNodesAndRemesh()
+    {
+        EXIT_IF_PARALLEL;    // Node ownership depends on the number of processes
+
+        std::vector<Node<2>*> nodes;
+        for (unsigned i=0; i<20; i++)
+        {
+            nodes.push_back(new Node<2>(i, false, 0.1*i, 0.0));
+        }
+
+        NodesOnlyMesh<2> mesh;
+        mesh.ConstructNodesWithoutMesh(nodes, 1.5);
+
+        // Delete every other node, so that the remaining nodes must all be moved
+        for (unsigned i=0; i<20; i+=2)
+        {
+            mesh.DeleteNode(i);
+        }
+
+        NodeMap map(mesh.GetMaximumNodeIndex());
+        mesh.ReMesh(map);
+
+        TS_ASSERT_EQUALS(mesh.GetNumNodes(), 10u);
+        for (unsigned i=0; i<20; i++)
+        {
+            if (i%2 == 0)
+            {
+                TS_ASSERT(map.IsDeleted(i));
+                TS_ASSERT_THROWS_CONTAINS(mesh.SolveNodeMapping(i), " does not belong to process ");
+            }
+            else
+            {
+                // Global indices are unchanged and the live nodes keep their order
+                TS_ASSERT_EQUALS(map.GetNewIndex(i), i);
+                TS_ASSERT_EQUALS(mesh.SolveNodeMapping(i), i/2);
+                TS_ASSERT_DELTA(mesh.GetNode(i)->rGetLocation()[0], 0.1*i, 1e-12);
+            }
+        }
+
+        for (unsigned i=0; i<nodes.size(); i++)
+        {
+            delete nodes[i];
+        }
+    }
+
     void TestCleanDeleteAndAddNode()
     {
         std::vector<Node<2>*> nodes;
@@ -1917,6 +1917,214 @@ public:
         }
     }
 
+    void TestElementGeometryCache()
+    {
+        TrianglesMeshReader<3,3> mesh_reader("mesh/test/data/cube_136_elements");
+        TetrahedralMesh<3,3> mesh;
+        mesh.ConstructFromMeshReader(mesh_reader);
+        TS_ASSERT_EQUALS(mesh.GetUseElementGeometryCache(), false);
+
+        c_matrix<double, 3, 3> jacobian, cached_jacobian;
+        c_matrix<double, 3, 3> inverse_jacobian, cached_inverse_jacobian;
+        c_matrix<double, 3, 4> grad_phi, cached_grad_phi;
+        double det, cached_det;
+
+        // Without the cache each call works from the current node locations
+        unsigned element_index = 17;
+        mesh.GetElementGeometry(element_index, jacobian, det, inverse_jacobian, grad_phi);
+
+        // The basis function gradients sum to zero and reproduce the gradient of x
+        c_vector<double, 3> grad_sum = zero_vector<double>(3);
+        c_matrix<double, 3, 3> grad_x = zero_matrix<double>(3,3);
+        Element<3,3>* p_element = mesh.GetElement(element_index);
+        for (unsigned j=0; j<4; j++)
+        {
+            grad_sum += column(grad_phi, j);
+            grad_x += outer_prod(p_element->GetNode(j)->rGetLocation(), column(grad_phi, j));
+        }
+        for (unsigned i=0; i<3; i++)
+        {
+            TS_ASSERT_DELTA(grad_sum(i), 0.0, 1e-12);
+            for (unsigned k=0; k<3; k++)
+            {
+                TS_ASSERT_DELTA(grad_x(i,k), (i==k ? 1.0 : 0.0), 1e-12);
+            }
+        }
+
+        mesh.SetUseElementGeometryCache();
+        TS_ASSERT_EQUALS(mesh.GetUseElementGeometryCache(), true);
+        mesh.GetElementGeometry(element_index, cached_jacobian, cached_det, cached_inverse_jacobian, cached_grad_phi);
+        TS_ASSERT_DELTA(cached_det, det, 1e-15);
+        for (unsigned i=0; i<3; i++)
+        {
+            for (unsigned j=0; j<3; j++)
+            {
+                TS_ASSERT_DELTA(cached_jacobian(i,j), jacobian(i,j), 1e-15);
+                TS_ASSERT_DELTA(cached_inverse_jacobian(i,j), inverse_jacobian(i,j), 1e-15);
+            }
+            for (unsigned j=0; j<4; j++)
+            {
+                TS_ASSERT_DELTA(cached_grad_phi(i,j), grad_phi(i,j), 1e-15);
+            }
+        }
+
+        // Moving the nodes through the mesh discards the cache
+        mesh.Scale(2.0, 2.0, 2.0);
+        mesh.GetElementGeometry(element_index, cached_jacobian, cached_det, cached_inverse_jacobian, cached_grad_phi);
+        TS_ASSERT_DELTA(cached_det, 8.0*det, 1e-12);
+        for (unsigned i=0; i<3; i++)
+        {
+            for (unsigned j=0; j<4; j++)
+            {
+                TS_ASSERT_DELTA(cached_grad_phi(i,j), 0.5*grad_phi(i,j), 1e-12);
+            }
+        }
+
+        // Moving them directly needs an explicit invalidation
+        for (unsigned i=0; i<mesh.GetNumNodes(); i++)
+        {
+            mesh.GetNode(i)->rGetModifiableLocation() *= 0.5;
+        }
+        mesh.GetElementGeometry(element_index, cached_jacobian, cached_det, cached_inverse_jacobian, cached_grad_phi);
+        TS_ASSERT_DELTA(cached_det, 8.0*det, 1e-12);
+        mesh.InvalidateElementGeometryCache();
+        mesh.GetElementGeometry(element_index, cached_jacobian, cached_det, cached_inverse_jacobian, cached_grad_phi);
+        TS_ASSERT_DELTA(cached_det, det, 1e-12);
+    }
+
+    void TestTopologyCache()
+    {
+        TrianglesMeshReader<3,3> mesh_reader("mesh/test/data/cube_136_elements");
+        TetrahedralMesh<3,3> mesh;
+        mesh.ConstructFromMeshReader(mesh_reader);
+
+        typedef TetrahedralMesh<3,3>::TopologyIterator TopologyIterator;
+
+        // The node tables agree with the sets held by each node
+        for (unsigned node_index=0; node_index<mesh.GetNumNodes(); node_index++)
+        {
+            Node<3>* p_node = mesh.GetNode(node_index);
+            std::pair<TopologyIterator, TopologyIterator> elements = mesh.GetNodeContainingElements(node_index);
+            std::set<unsigned> cached_elements(elements.first, elements.second);
+            TS_ASSERT_EQUALS((unsigned)(elements.second - elements.first), p_node->GetNumContainingElements());
+            TS_ASSERT(cached_elements == p_node->rGetContainingElementIndices());
+
+            std::set<unsigned> expected_neighbours;
+            for (std::set<unsigned>::const_iterator it = cached_elements.begin(); it != cached_elements.end(); ++it)
+            {
+                for (unsigned j=0; j<4; j++)
+                {
+                    expected_neighbours.insert(mesh.GetElement(*it)->GetNodeGlobalIndex(j));
+                }
+            }
+            expected_neighbours.erase(node_index);
+            std::pair<TopologyIterator, TopologyIterator> neighbours = mesh.GetNodeNeighbours(node_index);
+            TS_ASSERT_EQUALS((unsigned)(neighbours.second - neighbours.first), expected_neighbours.size());
+            TS_ASSERT(std::equal(neighbours.first, neighbours.second, expected_neighbours.begin()));
+        }
+        TS_ASSERT_THROWS_THIS(mesh.GetNodeNeighbours(mesh.GetNumNodes()),
+                              "Requested node 136 does not belong to processor 0");
+
+        // Neighbours are symmetric, share the face, and the faces without one are the boundary
+        unsigned num_boundary_faces = 0;
+        for (unsigned element_index=0; element_index<mesh.GetNumElements(); element_index++)
+        {
+            Element<3,3>* p_element = mesh.GetElement(element_index);
+            for (unsigned face=0; face<4; face++)
+            {
+                unsigned neighbour_index = mesh.GetElementNeighbour(element_index, face);
+                if (neighbour_index == UINT_MAX)
+                {
+                    num_boundary_faces++;
+                    continue;
+                }
+                TS_ASSERT_DIFFERS(neighbour_index, element_index);
+                Element<3,3>* p_neighbour = mesh.GetElement(neighbour_index);
+                unsigned num_shared = 0;
+                for (unsigned i=0; i<4; i++)
+                {
+                    for (unsigned j=0; j<4; j++)
+                    {
+                        if (i != face && p_element->GetNodeGlobalIndex(i) == p_neighbour->GetNodeGlobalIndex(j))
+                        {
+                            num_shared++;
+                        }
+                    }
+                }
+                TS_ASSERT_EQUALS(num_shared, 3u);
+                unsigned back_face = 0;
+                while (back_face<4 && mesh.GetElementNeighbour(neighbour_index, back_face) != element_index)
+                {
+                    back_face++;
+                }
+                TS_ASSERT_LESS_THAN(back_face, 4u);
+            }
+        }
+        TS_ASSERT_EQUALS(num_boundary_faces, mesh.GetNumBoundaryElements());
+
+        // Refreshing the mesh discards the tables, which are rebuilt on demand
+        unsigned neighbour_of_zero = mesh.GetElementNeighbour(0, 0);
+        mesh.RefreshMesh();
+        TS_ASSERT_EQUALS(mesh.GetElementNeighbour(0, 0), neighbour_of_zero);
+    }
+
+    void TestSpatialSearch()
+    {
+        TrianglesMeshReader<2,2> mesh_reader("mesh/test/data/disk_522_elements");
+        TetrahedralMesh<2,2> mesh;
+        mesh.ConstructFromMeshReader(mesh_reader);
+        TS_ASSERT(!mesh.GetUseSpatialSearch());
+
+        // Random points in and around the disk, and the answers of the linear searches
+        RandomNumberGenerator* p_gen = RandomNumberGenerator::Instance();
+        std::vector<ChastePoint<2> > points;
+        std::vector<unsigned> nearest_nodes;
+        std::vector<unsigned> containing_elements;
+        std::vector<unsigned> nearest_elements;
+        for (unsigned i=0; i<200; i++)
+        {
+            ChastePoint<2> point(-1.2 + 2.4*p_gen->ranf(), -1.2 + 2.4*p_gen->ranf());
+            points.push_back(point);
+            nearest_nodes.push_back(mesh.GetNearestNodeIndex(point));
+            std::vector<unsigned> elements = mesh.GetContainingElementIndices(point);
+            containing_elements.push_back(elements.empty() ? UINT_MAX : elements[0]);
+            nearest_elements.push_back(mesh.GetNearestElementIndex(point));
+        }
+
+        // The batch methods always use the search structures
+        TS_ASSERT(mesh.GetNearestNodeIndices(points) == nearest_nodes);
+        TS_ASSERT(mesh.GetContainingElementIndicesForPoints(points) == containing_elements);
+
+        mesh.SetUseSpatialSearch();
+        TS_ASSERT(mesh.GetUseSpatialSearch());
+        for (unsigned i=0; i<points.size(); i++)
+        {
+            TS_ASSERT_EQUALS(mesh.GetNearestNodeIndex(points[i]), nearest_nodes[i]);
+            if (containing_elements[i] != UINT_MAX)
+            {
+                TS_ASSERT_EQUALS(mesh.GetNearestElementIndex(points[i]), nearest_elements[i]);
+                TS_ASSERT_EQUALS(mesh.GetContainingElementIndex(points[i]), containing_elements[i]);
+                TS_ASSERT_EQUALS(mesh.GetContainingElementIndexWithInitialGuess(points[i], 0u), containing_elements[i]);
+                TS_ASSERT_EQUALS(mesh.GetContainingElementIndices(points[i])[0], containing_elements[i]);
+            }
+            else
+            {
+                TS_ASSERT_THROWS_CONTAINS(mesh.GetContainingElementIndex(points[i]), "is not in mesh - all elements tested");
+                TS_ASSERT_THROWS_CONTAINS(mesh.GetContainingElementIndexWithInitialGuess(points[i], 0u), "is not in mesh - all elements tested");
+            }
+        }
+
+        // Moving the mesh discards the structures, so searches see the new locations
+        mesh.Translate(10.0, 0.0);
+        ChastePoint<2> moved_point(10.0 + points[0][0], points[0][1]);
+        TS_ASSERT_EQUALS(mesh.GetNearestNodeIndex(moved_point), nearest_nodes[0]);
+        if (containing_elements[0] != UINT_MAX)
+        {
+            TS_ASSERT_EQUALS(mesh.GetContainingElementIndex(moved_point), containing_elements[0]);
+        }
+        TS_ASSERT_THROWS_CONTAINS(mesh.GetContainingElementIndex(points[0]), "is not in mesh - all elements tested");
+    }
+
     void TestConstructSlabMeshWithDimensionSplit()
     {
         double step = 1.0;
@@ -0,0 +1,169 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef TESTPERIODICNODESONLYMESH_HPP_
+#define TESTPERIODICNODESONLYMESH_HPP_
+
+#include <cxxtest/TestSuite.h>
+
+#include <boost/archive/text_oarchive.hpp>
+#include <boost/archive/text_iarchive.hpp>
+
+#include "PeriodicNodesOnlyMesh.hpp"
+#include "ArchiveOpener.hpp"
+#include "PetscSetupAndFinalize.hpp"
+
+class TestPeriodicNodesOnlyMesh : public CxxTest::TestSuite
+{
+public:
+
+    void TestPeriodicNodesOnlyMesh3d()
+    {
+        EXIT_IF_PARALLEL;    // PeriodicNodesOnlyMesh doesn't work in parallel
+
+        std::vector<Node<3>*> nodes;
+        nodes.push_back(new Node<3>(0, false, 0.2, 0.5, 0.5));
+        nodes.push_back(new Node<3>(1, false, 1.5, 0.5, 0.5));
+        nodes.push_back(new Node<3>(2, false, 2.8, 0.5, 0.5));
+        nodes.push_back(new Node<3>(3, false, 2.9, 1.2, 0.5));
+
+        double periodic_width = 3.0;
+        PeriodicNodesOnlyMesh<3>* p_mesh = new PeriodicNodesOnlyMesh<3>(periodic_width);
+
+        TS_ASSERT_THROWS_THIS(p_mesh->ConstructNodesWithoutMesh(nodes, 0.7),
+                              "The periodic width must be a multiple of cut off length.");
+        TS_ASSERT_THROWS_THIS(p_mesh->ConstructNodesWithoutMesh(nodes, 1.5),
+                              "The periodic domain width cannot be 2*CutOffLength.");
+
+        p_mesh->ConstructNodesWithoutMesh(nodes, 1.0);
+        TS_ASSERT_DELTA(p_mesh->GetWidth(0), 3.0, 1e-12);
+        TS_ASSERT_DELTA(p_mesh->GetWidth(1), 0.7, 1e-12);
+
+        // The box collection spans the periodic width in x
+        DistributedBoxCollection<3>* p_box_collection = p_mesh->GetBoxCollection();
+        TS_ASSERT(p_box_collection->GetIsPeriodicInX());
+        TS_ASSERT_DELTA(p_box_collection->rGetDomainSize()[0], 0.0, 1e-12);
+        TS_ASSERT_DELTA(p_box_collection->rGetDomainSize()[1], 3.0, 1e-12);
+
+        // Vectors between nodes use the nearest periodic image
+        c_vector<double, 3> vector = p_mesh->GetVectorFromAtoB(p_mesh->GetNode(0)->rGetLocation(), p_mesh->GetNode(2)->rGetLocation());
+        TS_ASSERT_DELTA(vector[0], -0.4, 1e-12);
+        TS_ASSERT_DELTA(vector[1], 0.0, 1e-12);
+        TS_ASSERT_DELTA(p_mesh->GetDistanceBetweenNodes(0, 3), sqrt(0.09 + 0.49), 1e-12);
+
+        // Node pairs are found across the periodic boundary, each exactly once
+        p_mesh->UpdateBoxCollection();
+        std::vector<std::pair<Node<3>*, Node<3>*> > node_pairs;
+        p_mesh->CalculateInteriorNodePairs(node_pairs);
+        p_mesh->CalculateBoundaryNodePairs(node_pairs);
+
+        std::set<std::pair<unsigned, unsigned> > pairs;
+        for (unsigned i=0; i<node_pairs.size(); i++)
+        {
+            unsigned a = node_pairs[i].first->GetIndex();
+            unsigned b = node_pairs[i].second->GetIndex();
+            pairs.insert(std::pair<unsigned, unsigned>(std::min(a,b), std::max(a,b)));
+        }
+        TS_ASSERT_EQUALS(pairs.size(), node_pairs.size());
+        TS_ASSERT_EQUALS(pairs.count(std::pair<unsigned, unsigned>(0, 2)), 1u);
+        TS_ASSERT_EQUALS(pairs.count(std::pair<unsigned, unsigned>(0, 3)), 1u);
+
+        // Nodes moved or added outside the domain are moved back into it
+        ChastePoint<3> point(-0.1, 0.5, 0.5);
+        p_mesh->SetNode(0, point);
+        TS_ASSERT_DELTA(p_mesh->GetNode(0)->rGetLocation()[0], 2.9, 1e-12);
+
+        point.SetCoordinate(0, 3.2);
+        p_mesh->SetNode(1, point);
+        TS_ASSERT_DELTA(p_mesh->GetNode(1)->rGetLocation()[0], 0.2, 1e-12);
+
+        point.SetCoordinate(0, -0.3);
+        unsigned new_index = p_mesh->AddNode(new Node<3>(0, point));
+        TS_ASSERT_DELTA(p_mesh->GetNode(new_index)->rGetLocation()[0], 2.7, 1e-12);
+
+        for (unsigned i=0; i<nodes.size(); i++)
+        {
+            delete nodes[i];
+        }
+        delete p_mesh;
+    }
+
+    void TestArchiving()
+    {
+        EXIT_IF_PARALLEL;    // PeriodicNodesOnlyMesh doesn't work in parallel
+
+        FileFinder archive_dir("archive", RelativeTo::ChasteTestOutput);
+        std::string archive_file = "periodic_nodes_only_mesh.arch";
+        ArchiveLocationInfo::SetMeshFilename("periodic_nodes_only_mesh");
+
+        std::vector<Node<2>*> nodes;
+        nodes.push_back(new Node<2>(0, false, 0.5, 0.5));
+        nodes.push_back(new Node<2>(1, false, 3.5, 0.5));
+
+        AbstractMesh<2,2>* const p_saved_mesh = new PeriodicNodesOnlyMesh<2>(4.0);
+        static_cast<PeriodicNodesOnlyMesh<2>*>(p_saved_mesh)->ConstructNodesWithoutMesh(nodes, 1.0);
+
+        {
+            ArchiveOpener<boost::archive::text_oarchive, std::ofstream> arch_opener(archive_dir, archive_file);
+            boost::archive::text_oarchive* p_arch = arch_opener.GetCommonArchive();
+            (*p_arch) << p_saved_mesh;
+        }
+
+        {
+            AbstractMesh<2,2>* p_loaded_mesh;
+
+            ArchiveOpener<boost::archive::text_iarchive, std::ifstream> arch_opener(archive_dir, archive_file);
+            boost::archive::text_iarchive* p_arch = arch_opener.GetCommonArchive();
+            (*p_arch) >> p_loaded_mesh;
+
+            PeriodicNodesOnlyMesh<2>* p_mesh = dynamic_cast<PeriodicNodesOnlyMesh<2>*>(p_loaded_mesh);
+            TS_ASSERT(p_mesh != nullptr);
+            TS_ASSERT_DELTA(p_mesh->GetWidth(0), 4.0, 1e-12);
+            TS_ASSERT_EQUALS(p_mesh->GetNumNodes(), 2u);
+            TS_ASSERT_DELTA(p_mesh->GetDistanceBetweenNodes(0, 1), 1.0, 1e-12);
+
+            delete p_loaded_mesh;
+        }
+
+        for (unsigned i=0; i<nodes.size(); i++)
+        {
+            delete nodes[i];
+        }
+        delete p_saved_mesh;
+    }
+};
+
+#endif /*TESTPERIODICNODESONLYMESH_HPP_*/
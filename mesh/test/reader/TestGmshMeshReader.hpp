@@ -41,6 +41,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "GmshMeshReader.hpp"
 #include "TetrahedralMesh.hpp"
+#include "DistributedTetrahedralMesh.hpp"
 #include "GenericMeshReader.hpp"
 #include "TrianglesMeshWriter.hpp"
 #include "UblasVectorInclude.hpp"
@@ -235,6 +236,50 @@ public:
         TS_ASSERT_EQUALS(mesh.GetNumBoundaryElements(), 24u);
     }
 
+    void TestReadBinaryMesh(void)
+    {
+        // The same mesh as square_4_elements_gmsh.msh, written in the version 4.1 binary format
+        READER_2D reader("mesh/test/data/square_4_elements_gmsh_binary.msh");
+        TS_ASSERT(reader.IsFileFormatBinary());
+        TS_ASSERT_EQUALS(reader.GetNumNodes(), 5u);
+        TS_ASSERT_EQUALS(reader.GetNumElements(), 4u);
+        TS_ASSERT_EQUALS(reader.GetNumFaces(), 4u);
+
+        std::vector<double> expected_coords(2);
+        expected_coords[0] = 0.0; expected_coords[1] = 0.0;
+        TS_ASSERT_EQUALS(reader.GetNextNode(), expected_coords);
+        expected_coords[0] = 1.0; expected_coords[1] = 0.0;
+        TS_ASSERT_EQUALS(reader.GetNextNode(), expected_coords);
+
+        std::vector<unsigned> expected_node_indices(3);
+        expected_node_indices[0] = 0; expected_node_indices[1] = 1; expected_node_indices[2] = 4;
+        TS_ASSERT_EQUALS(reader.GetNextElementData().NodeIndices, expected_node_indices);
+
+        // Random access, including across entity blocks
+        expected_coords[0] = 0.5; expected_coords[1] = 0.5;
+        TS_ASSERT_EQUALS(reader.GetNode(4), expected_coords);
+        expected_node_indices[0] = 0; expected_node_indices[1] = 4; expected_node_indices[2] = 3;
+        TS_ASSERT_EQUALS(reader.GetElementData(3).NodeIndices, expected_node_indices);
+        expected_node_indices.resize(2);
+        expected_node_indices[0] = 3; expected_node_indices[1] = 0;
+        TS_ASSERT_EQUALS(reader.GetFaceData(3).NodeIndices, expected_node_indices);
+
+        TS_ASSERT_THROWS_THIS(reader.GetNode(5), "Node does not exist - not enough nodes.");
+        TS_ASSERT_THROWS_THIS(reader.GetElementData(4), "Element 4 does not exist - not enough elements (only 4).");
+
+        READER_2D ascii_reader("mesh/test/data/square_4_elements_gmsh.msh");
+        TS_ASSERT_THROWS_THIS(ascii_reader.GetNode(0), "Random access is only implemented in mesh readers for binary mesh files.");
+
+        // Each process reads only the nodes and elements it needs
+        std::shared_ptr<AbstractMeshReader<2,2> > p_reader = GenericMeshReader<2,2>("mesh/test/data/square_4_elements_gmsh_binary.msh");
+        DistributedTetrahedralMesh<2,2> mesh;
+        mesh.ConstructFromMeshReader(*p_reader);
+        TS_ASSERT_EQUALS(mesh.GetNumNodes(), 5u);
+        TS_ASSERT_EQUALS(mesh.GetNumElements(), 4u);
+        TS_ASSERT_EQUALS(mesh.GetNumBoundaryElements(), 4u);
+        TS_ASSERT_DELTA(mesh.GetVolume(), 1.0, 1e-15);
+    }
+
     void TestRead3dQuadraticMeshes(void)
     {
        READER_3D reader("mesh/test/data/quad_cube_gmsh.msh",2,2);
@@ -552,6 +552,12 @@ public:
         TS_ASSERT( mesh_reader.IsFileFormatBinary() );
         TS_ASSERT( ! mesh_reader_ascii.IsFileFormatBinary() );
 
+        // Binary element data are read from a memory-mapped file where possible
+#ifndef _MSC_VER
+        TS_ASSERT( mesh_reader.IsElementsFileMemoryMapped() );
+#endif
+        TS_ASSERT( ! mesh_reader_ascii.IsElementsFileMemoryMapped() );
+
         /*
          * Check node locations
          */
@@ -0,0 +1,166 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef _TESTUNIFORMLYREFINEDMESHREADER_HPP_
+#define _TESTUNIFORMLYREFINEDMESHREADER_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include "UniformlyRefinedMeshReader.hpp"
+#include "TrianglesMeshReader.hpp"
+#include "TetrahedralMesh.hpp"
+#include "DistributedTetrahedralMesh.hpp"
+
+#include "PetscSetupAndFinalize.hpp"
+
+class TestUniformlyRefinedMeshReader : public CxxTest::TestSuite
+{
+public:
+
+    void TestRefine1DMeshWithAttributes()
+    {
+        TrianglesMeshReader<1,1> coarse_reader("mesh/test/data/1D_0_to_1_10_elements_with_attributes");
+        UniformlyRefinedMeshReader<1,1> fine_reader(coarse_reader);
+
+        TS_ASSERT_EQUALS(fine_reader.GetNumNodes(), 21u);
+        TS_ASSERT_EQUALS(fine_reader.GetNumElements(), 20u);
+        TS_ASSERT_EQUALS(fine_reader.GetNumFaces(), 2u);
+        TS_ASSERT_EQUALS(fine_reader.GetNumElementAttributes(), 1u);
+        TS_ASSERT_EQUALS(fine_reader.GetNumChildrenPerElement(), 2u);
+        TS_ASSERT_EQUALS(fine_reader.GetNumElementsPerParentElement(), 2u);
+        TS_ASSERT(fine_reader.IsFileFormatBinary());
+
+        // New nodes come after the coarse ones, one per edge in order of their end nodes
+        TS_ASSERT_DELTA(fine_reader.GetNode(10)[0], 1.0, 1e-12);
+        TS_ASSERT_DELTA(fine_reader.GetNode(11)[0], 0.05, 1e-12);
+        TS_ASSERT_DELTA(fine_reader.GetNode(20)[0], 0.95, 1e-12);
+
+        ElementData element = fine_reader.GetElementData(5);
+        TS_ASSERT_EQUALS(fine_reader.GetParentElementIndex(5), 2u);
+        TS_ASSERT_EQUALS(element.NodeIndices[0], 13u);
+        TS_ASSERT_EQUALS(element.NodeIndices[1], 3u);
+
+        TetrahedralMesh<1,1> mesh;
+        mesh.ConstructFromMeshReader(fine_reader);
+        TS_ASSERT_EQUALS(mesh.GetNumElements(), 20u);
+        TS_ASSERT_EQUALS(mesh.GetNumBoundaryElements(), 2u);
+        TS_ASSERT_DELTA(mesh.GetVolume(), 1.0, 1e-12);
+        TS_ASSERT_EQUALS(mesh.GetNumElementsPerParentElement(), 2u);
+        for (unsigned i=0; i<mesh.GetNumElements(); i++)
+        {
+            // Coarse element i has attribute i+1
+            TS_ASSERT_EQUALS(mesh.GetElement(i)->GetAttribute(), i/2 + 1.0);
+        }
+
+        TS_ASSERT_THROWS_THIS(fine_reader.GetNode(21), "Node does not exist - not enough nodes.");
+        TS_ASSERT_THROWS_THIS(fine_reader.GetElementData(20), "Element 20 does not exist - not enough elements (only 20).");
+        TS_ASSERT_THROWS_THIS(fine_reader.GetFaceData(2), "Face does not exist - not enough faces.");
+
+        TrianglesMeshReader<1,1> quadratic_reader("mesh/test/data/1D_0_to_1_10_elements_quadratic", 2);
+        TS_ASSERT_THROWS_THIS(UniformlyRefinedMeshReader<1,1> bad_reader(quadratic_reader),
+                              "Only linear meshes can be uniformly refined.");
+    }
+
+    void TestRefine2DMesh()
+    {
+        TrianglesMeshReader<2,2> coarse_reader("mesh/test/data/2D_0_to_1mm_200_elements");
+        TetrahedralMesh<2,2> coarse_mesh;
+        coarse_mesh.ConstructFromMeshReader(coarse_reader);
+
+        UniformlyRefinedMeshReader<2,2> fine_reader(coarse_reader);
+        TetrahedralMesh<2,2> fine_mesh;
+        fine_mesh.ConstructFromMeshReader(fine_reader);
+
+        // Euler's formula: a new node for each of the N+E-1 edges
+        unsigned num_edges = coarse_mesh.GetNumNodes() + coarse_mesh.GetNumElements() - 1;
+        TS_ASSERT_EQUALS(fine_mesh.GetNumNodes(), coarse_mesh.GetNumNodes() + num_edges);
+        TS_ASSERT_EQUALS(fine_mesh.GetNumElements(), 4*coarse_mesh.GetNumElements());
+        TS_ASSERT_EQUALS(fine_mesh.GetNumBoundaryElements(), 2*coarse_mesh.GetNumBoundaryElements());
+        TS_ASSERT_DELTA(fine_mesh.GetVolume(), coarse_mesh.GetVolume(), 1e-12);
+        TS_ASSERT_DELTA(fine_mesh.GetSurfaceArea(), coarse_mesh.GetSurfaceArea(), 1e-12);
+
+        // Each child has a quarter of the area of its parent
+        c_matrix<double, 2, 2> jacobian;
+        double coarse_determinant;
+        double fine_determinant;
+        for (unsigned i=0; i<fine_mesh.GetNumElements(); i++)
+        {
+            coarse_mesh.GetElement(i/4)->CalculateJacobian(jacobian, coarse_determinant);
+            fine_mesh.GetElement(i)->CalculateJacobian(jacobian, fine_determinant);
+            TS_ASSERT_DELTA(fine_determinant, 0.25*coarse_determinant, 1e-15);
+        }
+    }
+
+    void TestRefine3DMeshTwiceInParallel()
+    {
+        TrianglesMeshReader<3,3> coarse_reader("mesh/test/data/cube_136_elements");
+        UniformlyRefinedMeshReader<3,3> fine_reader(coarse_reader);
+        UniformlyRefinedMeshReader<3,3> finer_reader(static_cast<AbstractMeshReader<3,3>&>(fine_reader));
+
+        TS_ASSERT_EQUALS(fine_reader.GetNumElements(), 136u*8u);
+        TS_ASSERT_EQUALS(fine_reader.GetNumFaces(), 96u*4u);
+        TS_ASSERT_EQUALS(finer_reader.GetNumElements(), 136u*64u);
+        TS_ASSERT_EQUALS(finer_reader.GetNumFaces(), 96u*16u);
+        TS_ASSERT_EQUALS(finer_reader.GetNumElementsPerParentElement(), 64u);
+
+        // Every process refines identically, then keeps its own part of the fine mesh
+        DistributedTetrahedralMesh<3,3> mesh;
+        mesh.ConstructFromMeshReader(finer_reader);
+        TS_ASSERT_EQUALS(mesh.GetNumNodes(), finer_reader.GetNumNodes());
+        TS_ASSERT_EQUALS(mesh.GetNumElements(), 136u*64u);
+        TS_ASSERT_EQUALS(mesh.GetNumBoundaryElements(), 96u*16u);
+        TS_ASSERT_EQUALS(mesh.GetNumElementsPerParentElement(), 64u);
+
+        // The children fill the unit cube, all with the orientation of their parents
+        c_matrix<double, 3, 3> jacobian;
+        double determinant;
+        double local_volume = 0.0;
+        for (AbstractTetrahedralMesh<3,3>::ElementIterator iter = mesh.GetElementIteratorBegin();
+             iter != mesh.GetElementIteratorEnd();
+             ++iter)
+        {
+            iter->CalculateJacobian(jacobian, determinant);
+            TS_ASSERT_LESS_THAN(0.0, determinant);
+            if (iter->GetOwnership())
+            {
+                local_volume += iter->GetVolume(determinant);
+            }
+        }
+        double volume;
+        MPI_Allreduce(&local_volume, &volume, 1, MPI_DOUBLE, MPI_SUM, PETSC_COMM_WORLD);
+        TS_ASSERT_DELTA(volume, 1.0, 1e-12);
+    }
+};
+
+#endif /*_TESTUNIFORMLYREFINEDMESHREADER_HPP_*/
@@ -35,6 +35,8 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef TESTDISTANCEMAPCALCULATOR_
 #define TESTDISTANCEMAPCALCULATOR_
 
+#include <algorithm>
+
 #include "TrianglesMeshReader.hpp"
 #include "DistanceMapCalculator.hpp"
 #include "TetrahedralMesh.hpp"
@@ -321,6 +323,59 @@ public:
             TS_ASSERT_EQUALS(parallel_distances[index], DBL_MAX);
         }
     }
+
+    void TestSeveralMapsAtOnce()
+    {
+        TrianglesMeshReader<3,3> mesh_reader("mesh/test/data/cube_21_nodes_side/Cube21"); // 5x5x5mm cube (internode distance = 0.25mm)
+
+        DistributedTetrahedralMesh<3,3> parallel_mesh;
+        parallel_mesh.ConstructFromMeshReader(mesh_reader);
+
+        // Left face, a far corner, and nothing
+        std::vector<std::vector<unsigned> > sources(3);
+        for (unsigned index=0; index<parallel_mesh.GetNumNodes(); index++)
+        {
+            try
+            {
+                c_vector<double, 3> node = parallel_mesh.GetNode(index)->rGetLocation();
+                if (node[0] + 0.25 < 1e-6)
+                {
+                    sources[0].push_back(index);
+                }
+            }
+            catch (Exception&)
+            {
+            }
+        }
+        sources[1].push_back(parallel_mesh.GetNumNodes()-1);
+
+        DistanceMapCalculator<3,3> batch_calculator(parallel_mesh);
+        std::vector<std::vector<double> > batch_distances;
+        batch_calculator.ComputeDistanceMaps(sources, batch_distances);
+        TS_ASSERT_EQUALS(batch_distances.size(), 3u);
+
+        // Same answers as computing the maps one at a time
+        DistanceMapCalculator<3,3> single_calculator(parallel_mesh);
+        unsigned total_pops = 0;
+        unsigned max_rounds = 0;
+        for (unsigned map=0; map<3; map++)
+        {
+            std::vector<double> distances;
+            single_calculator.ComputeDistanceMap(sources[map], distances);
+            total_pops += single_calculator.mPopCounter;
+            max_rounds = std::max(max_rounds, single_calculator.mRoundCounter);
+
+            TS_ASSERT_EQUALS(batch_distances[map].size(), 9261u);
+            for (unsigned index=0; index<distances.size(); index++)
+            {
+                TS_ASSERT_EQUALS(batch_distances[map][index], distances[index]);
+            }
+        }
+
+        // The same work, in no more communication rounds than the slowest map needs
+        TS_ASSERT_EQUALS(batch_calculator.mPopCounter, total_pops);
+        TS_ASSERT_EQUALS(batch_calculator.mRoundCounter, max_rounds);
+    }
 };
 
 #endif /*TESTDISTANCEMAPCALCULATOR_*/
@@ -1956,6 +1956,89 @@ public:
     }
 
 
+    void TestPairsReturned3dPeriodic()
+    {
+        EXIT_IF_PARALLEL;
+
+        double cut_off_length = 1.0;
+        double width = 4.0;
+
+        // Scatter nodes quasi-randomly through the domain
+        std::vector<Node<3>* > nodes;
+        for (unsigned i=0; i<60; i++)
+        {
+            double x = fmod(0.5 + i*0.6180339887, 1.0)*width;
+            double y = fmod(0.5 + i*0.7548776662, 1.0)*width;
+            double z = fmod(0.5 + i*0.5698402910, 1.0)*width;
+            nodes.push_back(new Node<3>(i, false, x, y, z));
+        }
+
+        c_vector<double, 2*3> domain_size;
+        for (unsigned d=0; d<3; d++)
+        {
+            domain_size(2*d) = 0.0;
+            domain_size(2*d+1) = width;
+        }
+
+        DistributedBoxCollection<3> box_collection(cut_off_length, domain_size, true); // Periodic in X
+        box_collection.SetupLocalBoxesHalfOnly();
+
+        for (unsigned i=0; i<nodes.size(); i++)
+        {
+            unsigned box_index = box_collection.CalculateContainingBox(nodes[i]);
+            box_collection.rGetBox(box_index).AddNode(nodes[i]);
+        }
+
+        std::vector< std::pair<Node<3>*, Node<3>* > > pairs_returned_vector;
+        box_collection.CalculateNodePairs(nodes, pairs_returned_vector);
+
+        // No pair should be returned twice, in either order
+        std::set< std::pair<unsigned, unsigned> > pairs_returned;
+        for (unsigned i=0; i<pairs_returned_vector.size(); i++)
+        {
+            unsigned a = pairs_returned_vector[i].first->GetIndex();
+            unsigned b = pairs_returned_vector[i].second->GetIndex();
+            TS_ASSERT_DIFFERS(a, b);
+            pairs_returned.insert(std::pair<unsigned, unsigned>(std::min(a,b), std::max(a,b)));
+        }
+        TS_ASSERT_EQUALS(pairs_returned.size(), pairs_returned_vector.size());
+
+        // Every pair closer than the cut-off length, measuring x periodically, should be returned
+        unsigned num_close_pairs = 0;
+        for (unsigned i=0; i<nodes.size(); i++)
+        {
+            for (unsigned j=i+1; j<nodes.size(); j++)
+            {
+                c_vector<double, 3> difference = nodes[j]->rGetLocation() - nodes[i]->rGetLocation();
+                difference[0] -= width*round(difference[0]/width);
+                if (norm_2(difference) < cut_off_length)
+                {
+                    num_close_pairs++;
+                    TS_ASSERT_EQUALS(pairs_returned.count(std::pair<unsigned, unsigned>(i, j)), 1u);
+                }
+            }
+        }
+
+        // Make sure the test checks some pairs that are only close across the periodic boundary
+        TS_ASSERT_LESS_THAN(0u, num_close_pairs);
+        bool found_periodic_pair = false;
+        for (std::set< std::pair<unsigned, unsigned> >::iterator iter = pairs_returned.begin();
+             iter != pairs_returned.end();
+             ++iter)
+        {
+            if (fabs(nodes[iter->first]->rGetLocation()[0] - nodes[iter->second]->rGetLocation()[0]) > 2.0*cut_off_length)
+            {
+                found_periodic_pair = true;
+            }
+        }
+        TS_ASSERT(found_periodic_pair);
+
+        for (unsigned i=0; i<nodes.size(); i++)
+        {
+            delete nodes[i];
+        }
+    }
+
     void TestBoxGeneration3d()
     {
         // Create a mesh
@@ -2255,6 +2338,90 @@ public:
         }
     }
 
+    void TestCalculateBalancedPartition()
+    {
+        // Equal loads with rows split 2, 2, 5: balanced in one go, rather than one row at a time
+        std::vector<int> loads(9, 10);
+        std::vector<unsigned> starts;
+        starts.push_back(0);
+        starts.push_back(2);
+        starts.push_back(4);
+        starts.push_back(9);
+
+        std::vector<unsigned> new_starts = DistributedBoxCollection<1>::CalculateBalancedPartition(loads, starts);
+        TS_ASSERT_EQUALS(new_starts.size(), 4u);
+        TS_ASSERT_EQUALS(new_starts[0], 0u);
+        TS_ASSERT_EQUALS(new_starts[1], 3u);
+        TS_ASSERT_EQUALS(new_starts[2], 6u);
+        TS_ASSERT_EQUALS(new_starts[3], 9u);
+
+        // A partition that is already balanced is left alone
+        new_starts = DistributedBoxCollection<1>::CalculateBalancedPartition(loads, new_starts);
+        TS_ASSERT_EQUALS(new_starts[1], 3u);
+        TS_ASSERT_EQUALS(new_starts[2], 6u);
+
+        /*
+         * All the load in the first row: each process keeps at least two rows, and
+         * no boundary moves beyond the rows of the processes either side of it, so
+         * that nodes only move to neighbouring processes.
+         */
+        loads.assign(12, 1);
+        loads[0] = 100;
+        starts[1] = 4;
+        starts[2] = 8;
+        starts[3] = 12;
+
+        new_starts = DistributedBoxCollection<1>::CalculateBalancedPartition(loads, starts);
+        TS_ASSERT_EQUALS(new_starts[0], 0u);
+        TS_ASSERT_EQUALS(new_starts[1], 2u);
+        TS_ASSERT_EQUALS(new_starts[2], 4u);
+        TS_ASSERT_EQUALS(new_starts[3], 12u);
+
+        // A single process keeps all the rows
+        starts.resize(2);
+        starts[1] = 12;
+        new_starts = DistributedBoxCollection<1>::CalculateBalancedPartition(loads, starts);
+        TS_ASSERT_EQUALS(new_starts.size(), 2u);
+        TS_ASSERT_EQUALS(new_starts[0], 0u);
+        TS_ASSERT_EQUALS(new_starts[1], 12u);
+    }
+
+    void TestLoadBalanceGlobally()
+    {
+        // This test is designed for 3 process environment, with the same loads as TestLoadBalanceFunction()
+        if (PetscTools::GetNumProcs() == 3)
+        {
+            double cut_off_length = 1.0;
+
+            c_vector<double, 2> domain_size;
+            domain_size(0) = 0.0;
+            domain_size(1) = 9.0;
+
+            DistributedBoxCollection<1> box_collection(cut_off_length, domain_size);
+
+            std::vector<int> local_loads(PetscTools::AmTopMost() ? 5 : 2, 10);
+
+            // Equilibrium is reached in a single call
+            int local_rows = box_collection.LoadBalanceGlobally(local_loads);
+            TS_ASSERT_EQUALS(local_rows, 3);
+        }
+        else if (PetscTools::IsSequential())
+        {
+            double cut_off_length = 1.0;
+
+            c_vector<double, 2> domain_size;
+            domain_size(0) = 0.0;
+            domain_size(1) = 9.0;
+
+            DistributedBoxCollection<1> box_collection(cut_off_length, domain_size);
+
+            // A single process keeps all the rows
+            std::vector<int> local_loads(box_collection.GetNumRowsOfBoxes(), 10);
+            int local_rows = box_collection.LoadBalanceGlobally(local_loads);
+            TS_ASSERT_EQUALS(local_rows, (int)box_collection.GetNumRowsOfBoxes());
+        }
+    }
+
     void TestGetDistributionOfNodes()
     {
         double cut_off_length = 1.0;
@@ -0,0 +1,194 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTELEMENTBOUNDINGVOLUMEHIERARCHY_HPP_
+#define TESTELEMENTBOUNDINGVOLUMEHIERARCHY_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include <cfloat>
+#include <climits>
+
+#include "ElementBoundingVolumeHierarchy.hpp"
+#include "TetrahedralMesh.hpp"
+#include "RandomNumberGenerator.hpp"
+#include "PetscSetupAndFinalize.hpp"
+
+class TestElementBoundingVolumeHierarchy : public CxxTest::TestSuite
+{
+private:
+
+    /**
+     * Check the hierarchy on all the elements of a mesh against a search of the whole
+     * mesh, for random points in and around the mesh.
+     */
+    template<unsigned DIM>
+    void CheckAgainstWholeMeshSearch(TetrahedralMesh<DIM,DIM>& rMesh, unsigned numPoints)
+    {
+        std::set<unsigned> all_elements;
+        for (unsigned i=0; i<rMesh.GetNumElements(); i++)
+        {
+            all_elements.insert(i);
+        }
+        ElementBoundingVolumeHierarchy<DIM> hierarchy(rMesh, all_elements);
+        TS_ASSERT_EQUALS(hierarchy.GetNumElements(), rMesh.GetNumElements());
+
+        // Every leaf holds at most MAX_ELEMENTS_PER_LEAF elements, and each element is in one leaf
+        unsigned num_in_leaves = 0;
+        for (unsigned i=0; i<hierarchy.mTreeNodes.size(); i++)
+        {
+            TS_ASSERT_LESS_THAN_EQUALS(hierarchy.mTreeNodes[i].Count, ElementBoundingVolumeHierarchy<DIM>::MAX_ELEMENTS_PER_LEAF);
+            num_in_leaves += hierarchy.mTreeNodes[i].Count;
+        }
+        TS_ASSERT_EQUALS(num_in_leaves, rMesh.GetNumElements());
+
+        ChasteCuboid<DIM> bounding_box = rMesh.CalculateBoundingBox();
+        RandomNumberGenerator* p_gen = RandomNumberGenerator::Instance();
+        for (unsigned i=0; i<numPoints; i++)
+        {
+            c_vector<double, DIM> location;
+            for (unsigned d=0; d<DIM; d++)
+            {
+                double width = bounding_box.GetWidth(d);
+                location[d] = bounding_box.rGetLowerCorner()[d] - 0.1*width + 1.2*width*p_gen->ranf();
+            }
+            ChastePoint<DIM> point(location);
+
+            std::set<unsigned> candidates;
+            hierarchy.GetCandidateContainingElements(location, candidates);
+
+            std::vector<unsigned> containing_elements = rMesh.GetContainingElementIndices(point);
+            if (!containing_elements.empty())
+            {
+                // The lowest-indexed containing element is found from the candidates
+                TS_ASSERT_EQUALS(rMesh.GetContainingElementIndex(point, false, candidates, true), containing_elements[0]);
+            }
+            else
+            {
+                // Outside the mesh: the element with the nearest bounding box must be a candidate nearest element
+                TS_ASSERT_THROWS_CONTAINS(rMesh.GetContainingElementIndex(point, false, candidates, true), "is not in set of elements given");
+
+                std::set<unsigned> nearest_candidates;
+                hierarchy.GetCandidateNearestElements(location, nearest_candidates);
+
+                double min_distance = DBL_MAX;
+                unsigned nearest_element = UINT_MAX;
+                for (unsigned elem_index=0; elem_index<rMesh.GetNumElements(); elem_index++)
+                {
+                    double distance_squared = 0.0;
+                    for (unsigned d=0; d<DIM; d++)
+                    {
+                        double lower = DBL_MAX;
+                        double upper = -DBL_MAX;
+                        for (unsigned j=0; j<DIM+1; j++)
+                        {
+                            lower = std::min(lower, rMesh.GetElement(elem_index)->GetNodeLocation(j, d));
+                            upper = std::max(upper, rMesh.GetElement(elem_index)->GetNodeLocation(j, d));
+                        }
+                        double outside = std::max(0.0, std::max(lower - location[d], location[d] - upper));
+                        distance_squared += outside*outside;
+                    }
+                    if (distance_squared < min_distance)
+                    {
+                        min_distance = distance_squared;
+                        nearest_element = elem_index;
+                    }
+                }
+                TS_ASSERT_EQUALS(nearest_candidates.count(nearest_element), 1u);
+            }
+        }
+    }
+
+public:
+
+    void TestEmptyHierarchy()
+    {
+        TetrahedralMesh<2,2> mesh;
+        mesh.ConstructRegularSlabMesh(0.5, 1.0, 1.0);
+
+        ElementBoundingVolumeHierarchy<2> hierarchy(mesh, std::set<unsigned>());
+        TS_ASSERT_EQUALS(hierarchy.GetNumElements(), 0u);
+
+        c_vector<double, 2> location = zero_vector<double>(2);
+        std::set<unsigned> candidates;
+        hierarchy.GetCandidateContainingElements(location, candidates);
+        hierarchy.GetCandidateNearestElements(location, candidates);
+        TS_ASSERT(candidates.empty());
+    }
+
+    void TestSubsetOfElements()
+    {
+        TetrahedralMesh<1,1> mesh;
+        mesh.ConstructRegularSlabMesh(0.1, 1.0);
+
+        std::set<unsigned> some_elements;
+        some_elements.insert(2);
+        some_elements.insert(3);
+        ElementBoundingVolumeHierarchy<1> hierarchy(mesh, some_elements);
+        TS_ASSERT_EQUALS(hierarchy.GetNumElements(), 2u);
+
+        // A point on the shared node is in the boxes of both elements
+        c_vector<double, 1> location;
+        location[0] = 0.3;
+        std::set<unsigned> candidates;
+        hierarchy.GetCandidateContainingElements(location, candidates);
+        TS_ASSERT_EQUALS(candidates.size(), 2u);
+
+        // Elements not in the hierarchy aren't returned
+        location[0] = 0.75;
+        candidates.clear();
+        hierarchy.GetCandidateContainingElements(location, candidates);
+        TS_ASSERT(candidates.empty());
+
+        hierarchy.GetCandidateNearestElements(location, candidates);
+        TS_ASSERT_EQUALS(candidates.count(3u), 1u);
+    }
+
+    void TestAgainstWholeMeshSearch()
+    {
+        TetrahedralMesh<1,1> mesh_1d;
+        mesh_1d.ConstructRegularSlabMesh(0.01, 1.0);
+        CheckAgainstWholeMeshSearch(mesh_1d, 200);
+
+        TetrahedralMesh<2,2> mesh_2d;
+        mesh_2d.ConstructRegularSlabMesh(0.05, 1.0, 0.5);
+        CheckAgainstWholeMeshSearch(mesh_2d, 500);
+
+        TetrahedralMesh<3,3> mesh_3d;
+        mesh_3d.ConstructRegularSlabMesh(0.1, 1.0, 0.5, 0.3);
+        CheckAgainstWholeMeshSearch(mesh_3d, 500);
+    }
+};
+
+#endif /*TESTELEMENTBOUNDINGVOLUMEHIERARCHY_HPP_*/
@@ -0,0 +1,278 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTMULTILEVELNODEGRID_HPP_
+#define TESTMULTILEVELNODEGRID_HPP_
+
+#include <cxxtest/TestSuite.h>
+
+#include <algorithm>
+#include <set>
+
+#include "MultiLevelNodeGrid.hpp"
+#include "DistributedBoxCollection.hpp"
+#include "RandomNumberGenerator.hpp"
+
+#include "PetscSetupAndFinalize.hpp"
+
+class TestMultiLevelNodeGrid : public CxxTest::TestSuite
+{
+private:
+
+    /**
+     * Scatter points over a cube of the given side, most of them small and one in ten large,
+     * and check the grid finds exactly the pairs a brute force search does.
+     */
+    template <unsigned DIM>
+    void DoCompareWithBruteForce(double side, unsigned numPoints, double skin)
+    {
+        RandomNumberGenerator* p_gen = RandomNumberGenerator::Instance();
+        p_gen->Reseed(DIM);
+
+        std::vector<c_vector<double, DIM> > locations(numPoints);
+        std::vector<double> radii(numPoints);
+        for (unsigned i=0; i<numPoints; i++)
+        {
+            for (unsigned d=0; d<DIM; d++)
+            {
+                locations[i][d] = side*p_gen->ranf();
+            }
+            radii[i] = (i%10 == 0) ? 1.0*p_gen->ranf() : 0.05*p_gen->ranf();
+        }
+
+        MultiLevelNodeGrid<DIM> grid(2.0 + skin);
+        grid.Build(locations, radii, skin);
+        TS_ASSERT_LESS_THAN(1u, grid.GetNumLevels());
+
+        std::vector<std::pair<unsigned, unsigned> > pairs;
+        grid.CalculatePairs(pairs);
+
+        std::set<std::pair<unsigned, unsigned> > pairs_found;
+        for (unsigned k=0; k<pairs.size(); k++)
+        {
+            std::pair<unsigned, unsigned> pair(std::min(pairs[k].first, pairs[k].second),
+                                               std::max(pairs[k].first, pairs[k].second));
+            TS_ASSERT_DIFFERS(pair.first, pair.second);
+
+            // Each pair is only given once
+            TS_ASSERT_EQUALS(pairs_found.count(pair), 0u);
+            pairs_found.insert(pair);
+        }
+
+        std::set<std::pair<unsigned, unsigned> > pairs_expected;
+        for (unsigned i=0; i<numPoints; i++)
+        {
+            for (unsigned j=i+1; j<numPoints; j++)
+            {
+                if (norm_2(locations[i] - locations[j]) <= radii[i] + radii[j] + skin)
+                {
+                    pairs_expected.insert(std::make_pair(i, j));
+                }
+            }
+        }
+        TS_ASSERT_LESS_THAN(0u, pairs_expected.size());
+        TS_ASSERT(pairs_found == pairs_expected);
+    }
+
+public:
+
+    void TestLevels()
+    {
+        std::vector<c_vector<double, 2> > locations(4, zero_vector<double>(2));
+        locations[1][0] = 0.3;
+        locations[2][1] = 0.7;
+        locations[3][0] = 5.0;
+        std::vector<double> radii(4);
+        radii[0] = 0.5;   // Diameter 1, on the coarsest level
+        radii[1] = 0.2;   // Diameter 0.4, on level 1 (width 0.5)
+        radii[2] = 0.06;  // Diameter 0.12, on level 3 (width 0.125)
+        radii[3] = 0.25;  // Diameter exactly 0.5, on level 1
+
+        MultiLevelNodeGrid<2> grid(1.0);
+        grid.Build(locations, radii);
+
+        // No finer levels are made than the smallest point needs
+        TS_ASSERT_EQUALS(grid.GetNumLevels(), 4u);
+        TS_ASSERT_EQUALS(grid.GetLevel(0), 0u);
+        TS_ASSERT_EQUALS(grid.GetLevel(1), 1u);
+        TS_ASSERT_EQUALS(grid.GetLevel(2), 3u);
+        TS_ASSERT_EQUALS(grid.GetLevel(3), 1u);
+
+        // Only 0 and 1 overlap; 0 and 2 are 0.7 apart, more than 0.56
+        std::vector<std::pair<unsigned, unsigned> > pairs;
+        grid.CalculatePairs(pairs);
+        TS_ASSERT_EQUALS(pairs.size(), 1u);
+        TS_ASSERT_EQUALS(std::min(pairs[0].first, pairs[0].second), 0u);
+        TS_ASSERT_EQUALS(std::max(pairs[0].first, pairs[0].second), 1u);
+
+        // With a skin of 0.2, 0 and 2 are close enough; the skin also moves points to coarser levels
+        MultiLevelNodeGrid<2> skin_grid(1.2);
+        skin_grid.Build(locations, radii, 0.2);
+        TS_ASSERT_EQUALS(skin_grid.GetNumLevels(), 2u);
+        TS_ASSERT_EQUALS(skin_grid.GetLevel(2), 1u);
+        skin_grid.CalculatePairs(pairs);
+        TS_ASSERT_EQUALS(pairs.size(), 2u);
+
+        // The number of levels can be capped
+        MultiLevelNodeGrid<2> capped_grid(1.0, 2u);
+        capped_grid.Build(locations, radii);
+        TS_ASSERT_EQUALS(capped_grid.GetNumLevels(), 2u);
+        TS_ASSERT_EQUALS(capped_grid.GetLevel(2), 1u);
+        capped_grid.CalculatePairs(pairs);
+        TS_ASSERT_EQUALS(pairs.size(), 1u);
+
+        // No points
+        grid.Build(std::vector<c_vector<double, 2> >(), std::vector<double>());
+        grid.CalculatePairs(pairs);
+        TS_ASSERT(pairs.empty());
+    }
+
+    void TestExceptions()
+    {
+        TS_ASSERT_THROWS_THIS(MultiLevelNodeGrid<3> grid(0.0), "The width of the coarsest grid must be positive.");
+        TS_ASSERT_THROWS_THIS(MultiLevelNodeGrid<3> grid(1.0, 0u), "A multi-level grid needs at least one level.");
+
+        MultiLevelNodeGrid<1> grid(1.0);
+        std::vector<c_vector<double, 1> > locations(1, zero_vector<double>(1));
+        std::vector<double> radii(1, 0.6);
+        TS_ASSERT_THROWS_THIS(grid.Build(locations, radii),
+                              "A point has interaction diameter 1.2, which is wider than the coarsest grid (1).");
+    }
+
+    void TestCompareWithBruteForce()
+    {
+        DoCompareWithBruteForce<1>(50.0, 300, 0.0);
+        DoCompareWithBruteForce<2>(15.0, 600, 0.1);
+        DoCompareWithBruteForce<3>(8.0, 800, 0.1);
+    }
+
+    void TestMultiLevelPairSearchInBoxCollection()
+    {
+        // A few large nodes among many small ones, so the box width is set by the large ones
+        RandomNumberGenerator* p_gen = RandomNumberGenerator::Instance();
+        p_gen->Reseed(0);
+
+        std::vector<Node<2>*> nodes;
+        for (unsigned i=0; i<400; i++)
+        {
+            Node<2>* p_node = new Node<2>(i, false, 10.0*p_gen->ranf(), 10.0*p_gen->ranf());
+            p_node->SetRadius((i%20 == 0) ? 0.5 : 0.05);
+            nodes.push_back(p_node);
+        }
+
+        c_vector<double, 2*2> domain_size;
+        domain_size(0) = 0.0;
+        domain_size(1) = 10.0;
+        domain_size(2) = 0.0;
+        domain_size(3) = 10.0;
+
+        // Interaction distance 1.0 (two large radii), plus a skin of 0.1
+        DistributedBoxCollection<2> box_collection(1.1, domain_size);
+        box_collection.SetupLocalBoxesHalfOnly();
+        box_collection.SetVerletSkin(0.1);
+        for (unsigned i=0; i<nodes.size(); i++)
+        {
+            unsigned box_index = box_collection.CalculateContainingBox(nodes[i]);
+            if (box_collection.IsBoxOwned(box_index))
+            {
+                box_collection.rGetBox(box_index).AddNode(nodes[i]);
+            }
+        }
+
+        // The box search, keeping only pairs within the sum of the radii plus the skin
+        std::vector<std::pair<Node<2>*, Node<2>*> > box_pairs;
+        box_collection.CalculateNodePairs(nodes, box_pairs);
+        std::vector<std::pair<Node<2>*, Node<2>*> > expected_pairs;
+        for (unsigned k=0; k<box_pairs.size(); k++)
+        {
+            Node<2>* p_node_a = box_pairs[k].first;
+            Node<2>* p_node_b = box_pairs[k].second;
+            if (norm_2(p_node_a->rGetLocation() - p_node_b->rGetLocation()) <= p_node_a->GetRadius() + p_node_b->GetRadius() + 0.1)
+            {
+                expected_pairs.push_back(box_pairs[k]);
+            }
+        }
+        TS_ASSERT_LESS_THAN(expected_pairs.size(), box_pairs.size());
+
+        // The multi-level search gives the same pairs, each the same way round
+        TS_ASSERT_EQUALS(box_collection.GetUseMultiLevelPairSearch(), false);
+        box_collection.SetUseMultiLevelPairSearch(true);
+        TS_ASSERT_EQUALS(box_collection.GetUseMultiLevelPairSearch(), true);
+        std::vector<std::pair<Node<2>*, Node<2>*> > multi_level_pairs;
+        box_collection.CalculateNodePairs(nodes, multi_level_pairs);
+
+        std::sort(expected_pairs.begin(), expected_pairs.end());
+        std::sort(multi_level_pairs.begin(), multi_level_pairs.end());
+        TS_ASSERT(multi_level_pairs == expected_pairs);
+
+        // Each node's neighbours are the other members of its pairs
+        for (unsigned i=0; i<nodes.size(); i++)
+        {
+            if (box_collection.IsOwned(nodes[i]))
+            {
+                std::set<unsigned> expected_neighbours;
+                for (unsigned k=0; k<expected_pairs.size(); k++)
+                {
+                    if (expected_pairs[k].first == nodes[i])
+                    {
+                        expected_neighbours.insert(expected_pairs[k].second->GetIndex());
+                    }
+                    if (expected_pairs[k].second == nodes[i])
+                    {
+                        expected_neighbours.insert(expected_pairs[k].first->GetIndex());
+                    }
+                }
+                std::vector<unsigned>& r_neighbours = nodes[i]->rGetNeighbours();
+                TS_ASSERT(std::set<unsigned>(r_neighbours.begin(), r_neighbours.end()) == expected_neighbours);
+            }
+        }
+
+        // The pairs can't be reused once a node has grown
+        box_collection.RecordNodeLocationsForNodePairs(nodes);
+        if (PetscTools::IsSequential())
+        {
+            TS_ASSERT(box_collection.AreNodePairsStillValid(nodes));
+        }
+        nodes[1]->SetRadius(0.06);
+        TS_ASSERT(!box_collection.AreNodePairsStillValid(nodes));
+
+        for (unsigned i=0; i<nodes.size(); i++)
+        {
+            delete nodes[i];
+        }
+    }
+};
+
+#endif /*TESTMULTILEVELNODEGRID_HPP_*/
@@ -0,0 +1,160 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTNODEKDTREE_HPP_
+#define TESTNODEKDTREE_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include <cfloat>
+#include <climits>
+
+#include "NodeKdTree.hpp"
+#include "RandomNumberGenerator.hpp"
+#include "PetscSetupAndFinalize.hpp"
+
+class TestNodeKdTree : public CxxTest::TestSuite
+{
+private:
+
+    /**
+     * @return the position of the nearest location to a point by a linear search,
+     * taking the first of equally near locations.
+     */
+    template<unsigned DIM>
+    unsigned LinearSearch(const std::vector<c_vector<double, DIM> >& rLocations, const c_vector<double, DIM>& rPoint)
+    {
+        unsigned best_index = UINT_MAX;
+        double best_distance = DBL_MAX;
+        for (unsigned i=0; i<rLocations.size(); i++)
+        {
+            double distance = norm_2(rLocations[i] - rPoint);
+            if (distance < best_distance)
+            {
+                best_distance = distance;
+                best_index = i;
+            }
+        }
+        return best_index;
+    }
+
+    template<unsigned DIM>
+    void CheckRandomPoints(unsigned numLocations, unsigned numPoints)
+    {
+        RandomNumberGenerator* p_gen = RandomNumberGenerator::Instance();
+        std::vector<c_vector<double, DIM> > locations(numLocations);
+        for (unsigned i=0; i<numLocations; i++)
+        {
+            for (unsigned d=0; d<DIM; d++)
+            {
+                locations[i][d] = p_gen->ranf();
+            }
+        }
+
+        NodeKdTree<DIM> tree(locations);
+        TS_ASSERT_EQUALS(tree.GetNumPoints(), numLocations);
+
+        // Every leaf holds at most MAX_POINTS_PER_LEAF points, and each point is in one leaf
+        unsigned num_in_leaves = 0;
+        for (unsigned i=0; i<tree.mTreeNodes.size(); i++)
+        {
+            TS_ASSERT_LESS_THAN_EQUALS(tree.mTreeNodes[i].Count, NodeKdTree<DIM>::MAX_POINTS_PER_LEAF);
+            num_in_leaves += tree.mTreeNodes[i].Count;
+        }
+        TS_ASSERT_EQUALS(num_in_leaves, numLocations);
+
+        // Points both among and around the locations
+        for (unsigned i=0; i<numPoints; i++)
+        {
+            c_vector<double, DIM> point;
+            for (unsigned d=0; d<DIM; d++)
+            {
+                point[d] = -0.2 + 1.4*p_gen->ranf();
+            }
+            TS_ASSERT_EQUALS(tree.GetNearestPoint(point), LinearSearch(locations, point));
+        }
+    }
+
+public:
+
+    void TestAgainstLinearSearch()
+    {
+        CheckRandomPoints<1>(100, 200);
+        CheckRandomPoints<2>(500, 200);
+        CheckRandomPoints<3>(1000, 200);
+    }
+
+    void TestTiesGoToLowestIndex()
+    {
+        // A regular grid, with each location given twice so that every query has a tie
+        std::vector<c_vector<double, 2> > locations;
+        for (unsigned copy=0; copy<2; copy++)
+        {
+            for (unsigned i=0; i<10; i++)
+            {
+                for (unsigned j=0; j<10; j++)
+                {
+                    c_vector<double, 2> location;
+                    location[0] = i;
+                    location[1] = j;
+                    locations.push_back(location);
+                }
+            }
+        }
+        NodeKdTree<2> tree(locations);
+
+        // Exactly at grid points, and halfway between four of them
+        for (unsigned i=0; i<9; i++)
+        {
+            c_vector<double, 2> point;
+            point[0] = i;
+            point[1] = 8.0 - i;
+            TS_ASSERT_EQUALS(tree.GetNearestPoint(point), LinearSearch(locations, point));
+            TS_ASSERT_LESS_THAN(tree.GetNearestPoint(point), 100u);
+
+            point[0] += 0.5;
+            point[1] += 0.5;
+            TS_ASSERT_EQUALS(tree.GetNearestPoint(point), LinearSearch(locations, point));
+        }
+    }
+
+    void TestEmptyTree()
+    {
+        NodeKdTree<3> tree(std::vector<c_vector<double, 3> >());
+        TS_ASSERT_EQUALS(tree.GetNumPoints(), 0u);
+        TS_ASSERT_EQUALS(tree.GetNearestPoint(zero_vector<double>(3)), UINT_MAX);
+    }
+};
+
+#endif /*TESTNODEKDTREE_HPP_*/
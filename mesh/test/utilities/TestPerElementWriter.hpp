@@ -38,10 +38,12 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define _TESTPERELEMENTWRITER_HPP_
 
 #include <cxxtest/TestSuite.h>
+#include <fstream>
 #include <iostream>
 
 #include "AbstractPerElementWriter.hpp"
 #include "DistributedTetrahedralMesh.hpp"
+#include "TetrahedralMesh.hpp"
 #include "NumericFileComparison.hpp"
 #include "PetscSetupAndFinalize.hpp"
 
@@ -120,6 +122,45 @@ public:
         NumericFileComparison(handler.GetOutputDirectoryFullPath() + "/centroid_indexed.dat",
                               "mesh/test/data/TestUtilities/centroid_indexed.dat").CompareFiles();
     }
+
+    void TestPerElementBinary()
+    {
+        DistributedTetrahedralMesh<3,3> mesh;
+        mesh.ConstructCuboid(2, 3, 4);
+        OutputFileHandler handler("TestPerElementWriterBinary");
+
+        // Binary files are written by all processes collectively
+        CentroidWriter writer(&mesh);
+        writer.SetWriteFileAsBinary();
+        writer.WriteData(handler, "centroid.bin");
+
+        PetscTools::Barrier("TestPerElementBinary");
+        FileFinder file = handler.FindFile("centroid.bin");
+        std::ifstream data_file(file.GetAbsolutePath().c_str(), std::ios::binary);
+        TS_ASSERT(data_file.is_open());
+        std::string header;
+        std::getline(data_file, header);
+        TS_ASSERT_EQUALS(header, "\tBIN");
+
+        // Every element's centroid, in global element index order
+        TetrahedralMesh<3,3> serial_mesh;
+        serial_mesh.ConstructCuboid(2, 3, 4);
+        for (unsigned element_index=0; element_index<serial_mesh.GetNumElements(); element_index++)
+        {
+            c_vector<double, 3> centroid;
+            data_file.read((char*)&centroid[0], 3*sizeof(double));
+            c_vector<double, 3> expected = serial_mesh.GetElement(element_index)->CalculateCentroid();
+            for (unsigned i=0; i<3; i++)
+            {
+                TS_ASSERT_DELTA(centroid[i], expected[i], 1e-12);
+            }
+        }
+
+        // Followed by the provenance footer
+        std::string footer;
+        std::getline(data_file, footer);
+        TS_ASSERT_EQUALS(footer.substr(0, 2), "# ");
+    }
 };
 
 #endif //_TESTPERELEMENTWRITER_HPP_
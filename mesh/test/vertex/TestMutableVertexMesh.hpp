@@ -376,6 +376,75 @@ public:
         TS_ASSERT_DELTA(point3[1], 1.9, 1e-6);
     }
 
+    void TestCompactConnectivityAndCachedElementGeometry()
+    {
+        HoneycombVertexMeshGenerator generator(3, 3);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+
+        // The element-node connectivity should match the nodes stored in each element
+        const std::vector<unsigned>& r_element_node_offsets = p_mesh->rGetElementNodeOffsets();
+        const std::vector<unsigned>& r_element_node_indices = p_mesh->rGetElementNodeIndices();
+        TS_ASSERT_EQUALS(r_element_node_offsets.size(), p_mesh->GetNumAllElements() + 1);
+        for (unsigned elem_index=0; elem_index<p_mesh->GetNumElements(); elem_index++)
+        {
+            VertexElement<2,2>* p_element = p_mesh->GetElement(elem_index);
+            TS_ASSERT_EQUALS(r_element_node_offsets[elem_index + 1] - r_element_node_offsets[elem_index], p_element->GetNumNodes());
+            for (unsigned local_index=0; local_index<p_element->GetNumNodes(); local_index++)
+            {
+                TS_ASSERT_EQUALS(r_element_node_indices[r_element_node_offsets[elem_index] + local_index],
+                                 p_element->GetNodeGlobalIndex(local_index));
+            }
+        }
+
+        // The node-element connectivity should match the containing elements of each node, in the same order
+        const std::vector<unsigned>& r_node_element_offsets = p_mesh->rGetNodeElementOffsets();
+        const std::vector<unsigned>& r_node_element_indices = p_mesh->rGetNodeElementIndices();
+        const std::vector<unsigned>& r_node_element_local_indices = p_mesh->rGetNodeElementLocalIndices();
+        TS_ASSERT_EQUALS(r_node_element_offsets.size(), p_mesh->GetNumAllNodes() + 1);
+        for (unsigned node_index=0; node_index<p_mesh->GetNumNodes(); node_index++)
+        {
+            const std::set<unsigned>& r_containing_elements = p_mesh->GetNode(node_index)->rGetContainingElementIndices();
+            TS_ASSERT_EQUALS(r_node_element_offsets[node_index + 1] - r_node_element_offsets[node_index], r_containing_elements.size());
+
+            unsigned entry = r_node_element_offsets[node_index];
+            for (std::set<unsigned>::const_iterator it = r_containing_elements.begin(); it != r_containing_elements.end(); ++it, ++entry)
+            {
+                TS_ASSERT_EQUALS(r_node_element_indices[entry], *it);
+                TS_ASSERT_EQUALS(r_node_element_local_indices[entry], p_mesh->GetElement(*it)->GetNodeLocalIndex(node_index));
+            }
+        }
+
+        // The cached areas and perimeters should match those computed directly
+        for (unsigned elem_index=0; elem_index<p_mesh->GetNumElements(); elem_index++)
+        {
+            TS_ASSERT_DELTA(p_mesh->GetCachedVolumeOfElement(elem_index), p_mesh->GetVolumeOfElement(elem_index), 1e-12);
+            TS_ASSERT_DELTA(p_mesh->GetCachedSurfaceAreaOfElement(elem_index), p_mesh->GetSurfaceAreaOfElement(elem_index), 1e-12);
+        }
+
+        // Moving a node using SetNode() updates the cache
+        unsigned node_index = p_mesh->GetElement(4)->GetNodeGlobalIndex(0);
+        double old_area = p_mesh->GetCachedVolumeOfElement(4);
+        ChastePoint<2> point = p_mesh->GetNode(node_index)->GetPoint();
+        point.SetCoordinate(1, point[1] - 0.1);
+        p_mesh->SetNode(node_index, point);
+        TS_ASSERT_DELTA(p_mesh->GetCachedVolumeOfElement(4), p_mesh->GetVolumeOfElement(4), 1e-12);
+        TS_ASSERT_DELTA(p_mesh->GetCachedSurfaceAreaOfElement(4), p_mesh->GetSurfaceAreaOfElement(4), 1e-12);
+        TS_ASSERT_DIFFERS(p_mesh->GetCachedVolumeOfElement(4), old_area);
+
+        // Moving a node directly requires the cache to be invalidated
+        p_mesh->GetNode(node_index)->rGetModifiableLocation()[1] += 0.1;
+        p_mesh->InvalidateCachedElementData();
+        TS_ASSERT_DELTA(p_mesh->GetCachedVolumeOfElement(4), old_area, 1e-12);
+
+        // Dividing an element updates the connectivity
+        unsigned num_elements = p_mesh->GetNumElements();
+        unsigned new_element_index = p_mesh->DivideElementAlongShortAxis(p_mesh->GetElement(4), true);
+        TS_ASSERT_EQUALS(p_mesh->rGetElementNodeOffsets().size(), num_elements + 2);
+        TS_ASSERT_EQUALS(p_mesh->rGetElementNodeOffsets()[new_element_index + 1] - p_mesh->rGetElementNodeOffsets()[new_element_index],
+                         p_mesh->GetElement(new_element_index)->GetNumNodes());
+        TS_ASSERT_DELTA(p_mesh->GetCachedVolumeOfElement(4) + p_mesh->GetCachedVolumeOfElement(new_element_index), old_area, 1e-12);
+    }
+
     void TestAddNodeAndReMesh()
     {
         // Create mesh
@@ -40,6 +40,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "VertexMeshWriter.hpp"
 #include "MutableVertexMesh.hpp"
+#include "HoneycombVertexMeshGenerator.hpp"
 #include "FileComparison.hpp"
 #include "Warnings.hpp"
 
@@ -1181,6 +1182,98 @@ public:
         TS_ASSERT(comparer2.CompareFiles());
     }
 
+    void TestCheckForSwapsFromShortEdgesPerformsIndependentSwapsTogether()
+    {
+        HoneycombVertexMeshGenerator generator(8, 8);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+        p_mesh->SetCellRearrangementThreshold(0.1);
+
+        // Shorten one edge of each of two internal elements that are far apart
+        unsigned element_indices[2] = {9, 54};
+        unsigned node_a_indices[2];
+        unsigned node_b_indices[2];
+        for (unsigned i=0; i<2; i++)
+        {
+            VertexElement<2,2>* p_element = p_mesh->GetElement(element_indices[i]);
+            node_a_indices[i] = p_element->GetNodeGlobalIndex(0);
+            node_b_indices[i] = p_element->GetNodeGlobalIndex(1);
+
+            c_vector<double, 2> location_a = p_mesh->GetNode(node_a_indices[i])->rGetLocation();
+            c_vector<double, 2> edge = p_mesh->GetNode(node_b_indices[i])->rGetLocation() - location_a;
+            c_vector<double, 2> new_location_b = location_a + 0.05*edge/norm_2(edge);
+            p_mesh->SetNode(node_b_indices[i], ChastePoint<2>(new_location_b));
+        }
+
+        // Both swaps are performed in a single search of the mesh...
+        TS_ASSERT_EQUALS(p_mesh->CheckForSwapsFromShortEdges(), true);
+        TS_ASSERT_EQUALS(p_mesh->GetLocationsOfT1Swaps().size(), 2u);
+        for (unsigned i=0; i<2; i++)
+        {
+            TS_ASSERT_DELTA(p_mesh->GetDistanceBetweenNodes(node_a_indices[i], node_b_indices[i]),
+                            p_mesh->GetCellRearrangementRatio()*p_mesh->GetCellRearrangementThreshold(), 1e-6);
+        }
+
+        // ...so no further swaps are found
+        TS_ASSERT_EQUALS(p_mesh->CheckForSwapsFromShortEdges(), false);
+        TS_ASSERT_EQUALS(p_mesh->GetLocationsOfT1Swaps().size(), 2u);
+    }
+
+    void TestIncrementalSwapChecksGiveSameReMesh()
+    {
+        HoneycombVertexMeshGenerator generator_full(6, 6);
+        MutableVertexMesh<2,2>* p_mesh_full = generator_full.GetMesh();
+        HoneycombVertexMeshGenerator generator_incremental(6, 6);
+        MutableVertexMesh<2,2>* p_mesh_incremental = generator_incremental.GetMesh();
+
+        TS_ASSERT_EQUALS(p_mesh_incremental->GetUseIncrementalSwapChecks(), false);
+        p_mesh_incremental->SetUseIncrementalSwapChecks(true);
+        TS_ASSERT_EQUALS(p_mesh_incremental->GetUseIncrementalSwapChecks(), true);
+
+        MutableVertexMesh<2,2>* meshes[2] = {p_mesh_full, p_mesh_incremental};
+        for (unsigned step=0; step<20; step++)
+        {
+            for (unsigned m=0; m<2; m++)
+            {
+                // Jiggle the nodes slightly, and every few steps shorten an edge so that a T1 swap occurs
+                for (unsigned node_index=0; node_index<meshes[m]->GetNumNodes(); node_index++)
+                {
+                    c_vector<double, 2> location = meshes[m]->GetNode(node_index)->rGetLocation();
+                    location[0] += 0.002*sin(double(node_index + 3*step));
+                    location[1] += 0.002*cos(double(2*node_index + step));
+                    meshes[m]->SetNode(node_index, ChastePoint<2>(location));
+                }
+                if (step%5 == 4)
+                {
+                    VertexElement<2,2>* p_element = meshes[m]->GetElement(7 + 4*step/5);
+                    unsigned node_a = p_element->GetNodeGlobalIndex(0);
+                    unsigned node_b = p_element->GetNodeGlobalIndex(1);
+                    c_vector<double, 2> location_a = meshes[m]->GetNode(node_a)->rGetLocation();
+                    c_vector<double, 2> edge = meshes[m]->GetNode(node_b)->rGetLocation() - location_a;
+                    meshes[m]->SetNode(node_b, ChastePoint<2>(location_a + 0.005*edge/norm_2(edge)));
+                }
+                meshes[m]->ReMesh();
+            }
+
+            // Both meshes should have been changed in exactly the same way
+            TS_ASSERT_EQUALS(p_mesh_incremental->GetNumNodes(), p_mesh_full->GetNumNodes());
+            TS_ASSERT_EQUALS(p_mesh_incremental->GetNumElements(), p_mesh_full->GetNumElements());
+            TS_ASSERT_EQUALS(p_mesh_incremental->GetLocationsOfT1Swaps().size(), p_mesh_full->GetLocationsOfT1Swaps().size());
+            for (unsigned node_index=0; node_index<p_mesh_full->GetNumNodes(); node_index++)
+            {
+                for (unsigned d=0; d<2; d++)
+                {
+                    TS_ASSERT_DELTA(p_mesh_incremental->GetNode(node_index)->rGetLocation()[d],
+                                    p_mesh_full->GetNode(node_index)->rGetLocation()[d], 1e-12);
+                }
+            }
+            for (unsigned elem_index=0; elem_index<p_mesh_full->GetNumElements(); elem_index++)
+            {
+                TS_ASSERT_EQUALS(p_mesh_incremental->GetElement(elem_index)->GetNumNodes(),
+                                 p_mesh_full->GetElement(elem_index)->GetNumNodes());
+            }
+        }
+    }
+
     void TestReMeshExceptionWhenNonBoundaryNodesAreContainedOnlyInTwoElements()
     {
         /*
@@ -0,0 +1,96 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef _ABSTRACTODESOLUTIONSINK_HPP_
+#define _ABSTRACTODESOLUTIONSINK_HPP_
+
+#include <string>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#include "AbstractOdeSystemInformation.hpp"
+
+/**
+ * Interface for objects that receive the samples of an ODE solution as they are computed,
+ * see the sink version of AbstractIvpOdeSolver::Solve.
+ *
+ * This lets the caller decide what is kept: OdeSolution stores every sample, while other
+ * sinks can decimate the samples, keep only some variables, or compute statistics on the
+ * fly, so long simulations don't need to hold their full solution in memory.
+ */
+class AbstractOdeSolutionSink
+{
+public:
+    /**
+     * Virtual destructor since we have virtual methods.
+     */
+    virtual ~AbstractOdeSolutionSink()
+    {
+    }
+
+    /**
+     * Called once before the first sample of a solve is added. Does nothing by default.
+     *
+     * @param pOdeSystemInfo  information about the ODE system being solved
+     * @param rSolverName  the name of the ODE solver being used
+     * @param estimatedNumTimeSteps  an estimate of the number of sampling intervals (there will
+     *     be one more sample than this, since the initial condition is also added)
+     */
+    virtual void BeginSolve(boost::shared_ptr<const AbstractOdeSystemInformation> pOdeSystemInfo,
+                            const std::string& rSolverName,
+                            unsigned estimatedNumTimeSteps)
+    {
+    }
+
+    /**
+     * Add the solution at a sampling time.
+     *
+     * @param time  the time of the sample
+     * @param rYValues  the state variables at this time
+     */
+    virtual void AddSample(double time, const std::vector<double>& rYValues)=0;
+
+    /**
+     * Called once after the last sample of a solve has been added. Does nothing by default.
+     *
+     * @param numTimeSteps  the number of sampling intervals that were taken
+     */
+    virtual void EndSolve(unsigned numTimeSteps)
+    {
+    }
+};
+
+#endif // _ABSTRACTODESOLUTIONSINK_HPP_
@@ -103,6 +103,17 @@ public:
         mPdeSolution = pdeSolution;
     }
 
+    /**
+     * Set #mPdeSolution from #mPdeSolutionSize consecutive values, without
+     * creating a temporary vector.
+     *
+     * @param pPdeSolution pointer to the PDE solution at a point in space
+     */
+    void SetPdeSolution(const double* pPdeSolution)
+    {
+        mPdeSolution.assign(pPdeSolution, pPdeSolution + mPdeSolutionSize);
+    }
+
     /**
      * @return #mPdeSolutionSize.
      */
@@ -0,0 +1,92 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "DecimatingOdeSolutionSink.hpp"
+
+#include "Exception.hpp"
+
+DecimatingOdeSolutionSink::DecimatingOdeSolutionSink(AbstractOdeSolutionSink& rTarget, unsigned samplesPerOutput)
+    : mrTarget(rTarget),
+      mSamplesPerOutput(samplesPerOutput),
+      mNumSamplesReceived(0u),
+      mNumSamplesPassedOn(0u),
+      mLastTime(0.0),
+      mLastSamplePassedOn(true)
+{
+    if (samplesPerOutput == 0u)
+    {
+        EXCEPTION("The number of samples per output must be positive.");
+    }
+}
+
+void DecimatingOdeSolutionSink::BeginSolve(boost::shared_ptr<const AbstractOdeSystemInformation> pOdeSystemInfo,
+                                           const std::string& rSolverName,
+                                           unsigned estimatedNumTimeSteps)
+{
+    mNumSamplesReceived = 0u;
+    mNumSamplesPassedOn = 0u;
+    mLastSamplePassedOn = true;
+    // Round up, since the last sample is always passed on
+    mrTarget.BeginSolve(pOdeSystemInfo, rSolverName, (estimatedNumTimeSteps + mSamplesPerOutput - 1)/mSamplesPerOutput);
+}
+
+void DecimatingOdeSolutionSink::AddSample(double time, const std::vector<double>& rYValues)
+{
+    if (mNumSamplesReceived % mSamplesPerOutput == 0u)
+    {
+        mrTarget.AddSample(time, rYValues);
+        mNumSamplesPassedOn++;
+        mLastSamplePassedOn = true;
+    }
+    else
+    {
+        mLastTime = time;
+        mLastYValues = rYValues;
+        mLastSamplePassedOn = false;
+    }
+    mNumSamplesReceived++;
+}
+
+void DecimatingOdeSolutionSink::EndSolve(unsigned numTimeSteps)
+{
+    if (!mLastSamplePassedOn)
+    {
+        mrTarget.AddSample(mLastTime, mLastYValues);
+        mNumSamplesPassedOn++;
+        mLastSamplePassedOn = true;
+    }
+    // The initial condition is a sample but not a time step
+    mrTarget.EndSolve(mNumSamplesPassedOn > 0u ? mNumSamplesPassedOn - 1u : 0u);
+}
@@ -0,0 +1,107 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef _DECIMATINGODESOLUTIONSINK_HPP_
+#define _DECIMATINGODESOLUTIONSINK_HPP_
+
+#include "AbstractOdeSolutionSink.hpp"
+
+/**
+ * An ODE solution sink which passes on only every n-th sample it is given to another sink,
+ * for example an OdeSolution, which can then be written to file with OdeSolution::WriteToFile
+ * as usual. The first and last samples of each solve are always passed on.
+ */
+class DecimatingOdeSolutionSink : public AbstractOdeSolutionSink
+{
+private:
+    /** The sink to pass samples on to */
+    AbstractOdeSolutionSink& mrTarget;
+
+    /** Samples are passed on every this number of samples */
+    unsigned mSamplesPerOutput;
+
+    /** The number of samples received in the current solve */
+    unsigned mNumSamplesReceived;
+
+    /** The number of samples passed on in the current solve */
+    unsigned mNumSamplesPassedOn;
+
+    /** The time of the most recent sample, if it wasn't passed on */
+    double mLastTime;
+
+    /** The state variables of the most recent sample, if it wasn't passed on */
+    std::vector<double> mLastYValues;
+
+    /** Whether the most recent sample was passed on */
+    bool mLastSamplePassedOn;
+
+public:
+    /**
+     * Constructor.
+     *
+     * @param rTarget  the sink to pass samples on to
+     * @param samplesPerOutput  samples are passed on every this number of samples
+     */
+    DecimatingOdeSolutionSink(AbstractOdeSolutionSink& rTarget, unsigned samplesPerOutput);
+
+    /**
+     * Pass on to the target sink, with a reduced estimate of the number of samples.
+     *
+     * @param pOdeSystemInfo  information about the ODE system being solved
+     * @param rSolverName  the name of the ODE solver being used
+     * @param estimatedNumTimeSteps  an estimate of the number of sampling intervals
+     */
+    void BeginSolve(boost::shared_ptr<const AbstractOdeSystemInformation> pOdeSystemInfo,
+                    const std::string& rSolverName,
+                    unsigned estimatedNumTimeSteps);
+
+    /**
+     * Pass the sample on if it is the first of a block of #mSamplesPerOutput samples.
+     *
+     * @param time  the time of the sample
+     * @param rYValues  the state variables at this time
+     */
+    void AddSample(double time, const std::vector<double>& rYValues);
+
+    /**
+     * Pass on the last sample, if it hasn't been already, and tell the target sink how many
+     * samples it was given.
+     *
+     * @param numTimeSteps  the number of sampling intervals that were taken
+     */
+    void EndSolve(unsigned numTimeSteps);
+};
+
+#endif // _DECIMATINGODESOLUTIONSINK_HPP_
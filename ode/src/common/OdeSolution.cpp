@@ -47,6 +47,28 @@ OdeSolution::OdeSolution()
     mpOdeSystemInformation()
 {}
 
+void OdeSolution::BeginSolve(
+    boost::shared_ptr<const AbstractOdeSystemInformation> pOdeSystemInfo,
+    const std::string& rSolverName,
+    unsigned estimatedNumTimeSteps)
+{
+  SetNumberOfTimeSteps(estimatedNumTimeSteps);
+  SetOdeSystemInformation(pOdeSystemInfo);
+  SetSolverName(rSolverName);
+}
+
+void OdeSolution::AddSample(double time, const std::vector<double>& rYValues)
+{
+  mSolutions.push_back(rYValues);
+  mTimes.push_back(time);
+}
+
+void OdeSolution::EndSolve(unsigned numTimeSteps)
+{
+  // The estimate given to BeginSolve() may have been an overestimate
+  SetNumberOfTimeSteps(numTimeSteps);
+}
+
 
 unsigned OdeSolution::GetNumberOfTimeSteps() const
 {
@@ -44,6 +44,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <boost/shared_ptr.hpp>
 
+#include "AbstractOdeSolutionSink.hpp"
 #include "AbstractOdeSystemInformation.hpp"
 #include "AbstractParameterisedSystem.hpp"
 
@@ -57,8 +58,11 @@ class AbstractOdeSystem;  // Avoid cyclic include issues
 /**
  * A class that that stores the output data from solving a system of
  * ODEs, and allows us to save it to file.
+ *
+ * This is also the ODE solution sink which keeps every sample; wrap it
+ * in a DecimatingOdeSolutionSink to keep fewer.
  */
-class OdeSolution
+class OdeSolution : public AbstractOdeSolutionSink
 {
  private:
   /** Variable for the number of timesteps. */
@@ -94,6 +98,35 @@ class OdeSolution
    */
   OdeSolution();
 
+  /**
+   * Set the ODE system information and solver name, and reserve space
+   * for the samples.
+   *
+   * @param pOdeSystemInfo  information about the ODE system being solved
+   * @param rSolverName  the name of the ODE solver being used
+   * @param estimatedNumTimeSteps  an estimate of the number of sampling
+   *        intervals
+   */
+  void BeginSolve(
+      boost::shared_ptr<const AbstractOdeSystemInformation> pOdeSystemInfo,
+      const std::string& rSolverName,
+      unsigned estimatedNumTimeSteps);
+
+  /**
+   * Store a sample of the solution.
+   *
+   * @param time  the time of the sample
+   * @param rYValues  the state variables at this time
+   */
+  void AddSample(double time, const std::vector<double>& rYValues);
+
+  /**
+   * Set the number of timesteps to the number actually taken.
+   *
+   * @param numTimeSteps  the number of sampling intervals that were taken
+   */
+  void EndSolve(unsigned numTimeSteps);
+
   /**
    * Get the number of timesteps.
    *
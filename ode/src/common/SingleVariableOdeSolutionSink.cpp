@@ -0,0 +1,114 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "SingleVariableOdeSolutionSink.hpp"
+
+#include <cassert>
+#include <cfloat>
+
+#include "Exception.hpp"
+
+SingleVariableOdeSolutionSink::SingleVariableOdeSolutionSink(unsigned variableIndex)
+    : mVariableIndex(variableIndex),
+      mMinimum(DBL_MAX),
+      mMaximum(-DBL_MAX),
+      mTimeOfMaximum(0.0)
+{
+}
+
+void SingleVariableOdeSolutionSink::BeginSolve(boost::shared_ptr<const AbstractOdeSystemInformation> pOdeSystemInfo,
+                                               const std::string& rSolverName,
+                                               unsigned estimatedNumTimeSteps)
+{
+    if (pOdeSystemInfo && mVariableIndex >= pOdeSystemInfo->rGetStateVariableNames().size()
+        && !pOdeSystemInfo->rGetStateVariableNames().empty())
+    {
+        EXCEPTION("Variable index " << mVariableIndex << " is not a state variable of this ODE system.");
+    }
+    mTimes.reserve(mTimes.size() + estimatedNumTimeSteps + 1u);
+    mValues.reserve(mValues.size() + estimatedNumTimeSteps + 1u);
+}
+
+void SingleVariableOdeSolutionSink::AddSample(double time, const std::vector<double>& rYValues)
+{
+    assert(mVariableIndex < rYValues.size());
+    const double value = rYValues[mVariableIndex];
+
+    // Consecutive solves repeat the sample at the shared end/start time
+    if (!mTimes.empty() && mTimes.back() == time)
+    {
+        mValues.back() = value;
+    }
+    else
+    {
+        mTimes.push_back(time);
+        mValues.push_back(value);
+    }
+
+    if (value < mMinimum)
+    {
+        mMinimum = value;
+    }
+    if (value > mMaximum)
+    {
+        mMaximum = value;
+        mTimeOfMaximum = time;
+    }
+}
+
+const std::vector<double>& SingleVariableOdeSolutionSink::rGetTimes() const
+{
+    return mTimes;
+}
+
+const std::vector<double>& SingleVariableOdeSolutionSink::rGetValues() const
+{
+    return mValues;
+}
+
+double SingleVariableOdeSolutionSink::GetMinimum() const
+{
+    return mMinimum;
+}
+
+double SingleVariableOdeSolutionSink::GetMaximum() const
+{
+    return mMaximum;
+}
+
+double SingleVariableOdeSolutionSink::GetTimeOfMaximum() const
+{
+    return mTimeOfMaximum;
+}
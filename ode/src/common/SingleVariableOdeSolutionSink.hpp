@@ -0,0 +1,112 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef _SINGLEVARIABLEODESOLUTIONSINK_HPP_
+#define _SINGLEVARIABLEODESOLUTIONSINK_HPP_
+
+#include "AbstractOdeSolutionSink.hpp"
+
+/**
+ * An ODE solution sink which keeps only the trace of a single state variable (e.g. the
+ * transmembrane potential of a cell model), rather than the full state at every sample.
+ *
+ * The trace can be passed to CellProperties to analyse action potentials. The extremes of
+ * the variable are also tracked as samples are added.
+ */
+class SingleVariableOdeSolutionSink : public AbstractOdeSolutionSink
+{
+private:
+    /** The index of the state variable to keep */
+    unsigned mVariableIndex;
+
+    /** The sampling times */
+    std::vector<double> mTimes;
+
+    /** The value of the variable at each sampling time */
+    std::vector<double> mValues;
+
+    /** The smallest value of the variable seen so far */
+    double mMinimum;
+
+    /** The largest value of the variable seen so far */
+    double mMaximum;
+
+    /** The time at which #mMaximum occurred */
+    double mTimeOfMaximum;
+
+public:
+    /**
+     * Constructor.
+     *
+     * @param variableIndex  the index of the state variable to keep
+     */
+    SingleVariableOdeSolutionSink(unsigned variableIndex);
+
+    /**
+     * Reserve space for the samples.
+     *
+     * @param pOdeSystemInfo  information about the ODE system being solved
+     * @param rSolverName  the name of the ODE solver being used
+     * @param estimatedNumTimeSteps  an estimate of the number of sampling intervals
+     */
+    void BeginSolve(boost::shared_ptr<const AbstractOdeSystemInformation> pOdeSystemInfo,
+                    const std::string& rSolverName,
+                    unsigned estimatedNumTimeSteps);
+
+    /**
+     * Store the time and the value of the variable.
+     *
+     * @param time  the time of the sample
+     * @param rYValues  the state variables at this time
+     */
+    void AddSample(double time, const std::vector<double>& rYValues);
+
+    /** @return the sampling times (over all solves using this sink) */
+    const std::vector<double>& rGetTimes() const;
+
+    /** @return the value of the variable at each sampling time */
+    const std::vector<double>& rGetValues() const;
+
+    /** @return the smallest value of the variable */
+    double GetMinimum() const;
+
+    /** @return the largest value of the variable */
+    double GetMaximum() const;
+
+    /** @return the time at which the variable took its largest value */
+    double GetTimeOfMaximum() const;
+};
+
+#endif // _SINGLEVARIABLEODESOLUTIONSINK_HPP_
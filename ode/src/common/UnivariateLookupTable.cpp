@@ -0,0 +1,157 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "UnivariateLookupTable.hpp"
+
+#include <cassert>
+#include <cmath>
+
+#include "Exception.hpp"
+
+UnivariateLookupTable::UnivariateLookupTable(const std::string& rKeyingVariableName, double min, double step, double max)
+    : mKeyingVariableName(rKeyingVariableName),
+      mClampToBounds(false)
+{
+    SetTableProperties(min, step, max);
+}
+
+unsigned UnivariateLookupTable::AddFunction(FunctionType function)
+{
+    mFunctions.push_back(function);
+    GenerateTables();
+    return mFunctions.size() - 1;
+}
+
+unsigned UnivariateLookupTable::GetNumberOfFunctions() const
+{
+    return mFunctions.size();
+}
+
+void UnivariateLookupTable::SetTableProperties(double min, double step, double max)
+{
+    if (step <= 0.0 || max <= min)
+    {
+        EXCEPTION("Table step must be positive and the upper table limit must exceed the lower one.");
+    }
+    // Check inputs, as for AbstractLookupTableCollection
+    unsigned num_steps = (unsigned) ((max-min)/step+0.5);
+    if (fabs(max - min - num_steps*step) > 1e-10)
+    {
+        EXCEPTION("Table step size does not divide range between table limits.");
+    }
+    mMin = min;
+    mStep = step;
+    mStepInverse = 1.0/step;
+    mMax = max;
+    mNumSteps = num_steps;
+    GenerateTables();
+}
+
+void UnivariateLookupTable::GetTableProperties(double& rMin, double& rStep, double& rMax) const
+{
+    rMin = mMin;
+    rStep = mStep;
+    rMax = mMax;
+}
+
+void UnivariateLookupTable::SetClampToBounds(bool clamp)
+{
+    mClampToBounds = clamp;
+}
+
+void UnivariateLookupTable::GenerateTables()
+{
+    const unsigned num_functions = mFunctions.size();
+    mTables.resize((mNumSteps + 2) * num_functions);
+    for (unsigned i=0; i<=mNumSteps; i++)
+    {
+        const double x = mMin + i*mStep;
+        for (unsigned j=0; j<num_functions; j++)
+        {
+            mTables[i*num_functions + j] = mFunctions[j](x);
+        }
+    }
+    // Duplicate the last row, so interpolating at the upper bound reads valid memory
+    for (unsigned j=0; j<num_functions; j++)
+    {
+        mTables[(mNumSteps+1)*num_functions + j] = mTables[mNumSteps*num_functions + j];
+    }
+}
+
+const double* UnivariateLookupTable::FindRow(double x, double& rFactor) const
+{
+    if (x < mMin || x > mMax)
+    {
+        if (!mClampToBounds)
+        {
+            EXCEPTION(mKeyingVariableName << " = " << x << " outside lookup table range ["
+                      << mMin << ", " << mMax << "]");
+        }
+        x = (x < mMin) ? mMin : mMax;
+    }
+    const double offset_over_step = (x - mMin) * mStepInverse;
+    unsigned index = (unsigned) offset_over_step;
+    // Rounding may put the upper bound just past the last row
+    if (index > mNumSteps)
+    {
+        index = mNumSteps;
+    }
+    rFactor = offset_over_step - index;
+    return &mTables[index * mFunctions.size()];
+}
+
+double UnivariateLookupTable::LookUp(unsigned functionIndex, double x) const
+{
+    assert(functionIndex < mFunctions.size());
+    double factor;
+    const double* p_row = FindRow(x, factor);
+    const double y1 = p_row[functionIndex];
+    const double y2 = p_row[mFunctions.size() + functionIndex];
+    return y1 + (y2-y1)*factor;
+}
+
+void UnivariateLookupTable::LookUpAll(double x, std::vector<double>& rValues) const
+{
+    const unsigned num_functions = mFunctions.size();
+    rValues.resize(num_functions);
+    double factor;
+    const double* p_row = FindRow(x, factor);
+    for (unsigned j=0; j<num_functions; j++)
+    {
+        const double y1 = p_row[j];
+        const double y2 = p_row[num_functions + j];
+        rValues[j] = y1 + (y2-y1)*factor;
+    }
+}
@@ -0,0 +1,176 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef _UNIVARIATELOOKUPTABLE_HPP_
+#define _UNIVARIATELOOKUPTABLE_HPP_
+
+#include <string>
+#include <vector>
+
+#include <boost/function.hpp>
+
+/**
+ * A set of lookup tables for functions of a single variable, for use by any ODE system whose
+ * right-hand side evaluates expensive functions (exp, pow, ...) of a variable with known bounds.
+ * This provides for general ODE systems what AbstractLookupTableCollection provides for cardiac
+ * cell models generated by PyCml.
+ *
+ * Several functions may be tabulated against the same keying variable; they share the table
+ * index computation, so looking them all up at once with LookUpAll() is cheaper than looking
+ * each up separately. Values are found by linear interpolation between table entries. Looking up
+ * a value outside the table bounds throws an exception, unless SetClampToBounds() has been called,
+ * in which case the value at the nearest bound is used.
+ *
+ * A typical ODE system would hold a table as a (possibly static) member, add its functions in its
+ * constructor, and call LookUp() in EvaluateYDerivatives().
+ */
+class UnivariateLookupTable
+{
+public:
+    /** The type of functions which can be tabulated. */
+    typedef boost::function<double (double)> FunctionType;
+
+    /**
+     * Constructor.
+     *
+     * @param rKeyingVariableName  the name of the variable the tables are indexed by (used in error messages)
+     * @param min  the lower table bound
+     * @param step  the table spacing; must divide the interval between min and max exactly
+     * @param max  the upper table bound
+     */
+    UnivariateLookupTable(const std::string& rKeyingVariableName, double min, double step, double max);
+
+    /**
+     * Add a function to be tabulated, and generate its table.
+     *
+     * @param function  the function
+     * @return the index of the function, for use with LookUp()
+     */
+    unsigned AddFunction(FunctionType function);
+
+    /**
+     * @return the number of functions tabulated
+     */
+    unsigned GetNumberOfFunctions() const;
+
+    /**
+     * Change the table bounds and spacing, and regenerate the tables.
+     *
+     * @param min  the lower table bound
+     * @param step  the table spacing; must divide the interval between min and max exactly
+     * @param max  the upper table bound
+     */
+    void SetTableProperties(double min, double step, double max);
+
+    /**
+     * Get the table bounds and spacing.
+     *
+     * @param rMin  will be filled with the lower table bound
+     * @param rStep  will be filled with the table spacing
+     * @param rMax  will be filled with the upper table bound
+     */
+    void GetTableProperties(double& rMin, double& rStep, double& rMax) const;
+
+    /**
+     * @param clamp  whether values outside the table bounds are looked up at the nearest bound,
+     *     rather than throwing an exception (defaults to false)
+     */
+    void SetClampToBounds(bool clamp=true);
+
+    /**
+     * @return the interpolated value of a tabulated function.
+     *
+     * @param functionIndex  the index of the function, as returned by AddFunction()
+     * @param x  the value of the keying variable
+     */
+    double LookUp(unsigned functionIndex, double x) const;
+
+    /**
+     * Look up the interpolated values of all the tabulated functions.
+     *
+     * @param x  the value of the keying variable
+     * @param rValues  will be filled with the value of each function, in the order they were added
+     */
+    void LookUpAll(double x, std::vector<double>& rValues) const;
+
+private:
+    /**
+     * Generate all the tables from the current properties.
+     */
+    void GenerateTables();
+
+    /**
+     * Find the table row and the interpolation factor for a value of the keying variable,
+     * checking the bounds.
+     *
+     * @param x  the value of the keying variable
+     * @param rFactor  will be filled with the position of x between this row and the next, in [0,1]
+     * @return a pointer to the start of the table row below x
+     */
+    const double* FindRow(double x, double& rFactor) const;
+
+    /** The name of the variable the tables are indexed by */
+    std::string mKeyingVariableName;
+
+    /** Lower table bound */
+    double mMin;
+
+    /** Table spacing */
+    double mStep;
+
+    /** The reciprocal of #mStep */
+    double mStepInverse;
+
+    /** Upper table bound */
+    double mMax;
+
+    /** The number of intervals between table entries */
+    unsigned mNumSteps;
+
+    /** Whether out of bounds values are clamped to the bounds, rather than throwing */
+    bool mClampToBounds;
+
+    /** The tabulated functions */
+    std::vector<FunctionType> mFunctions;
+
+    /**
+     * The tables, stored by row: entry i*N+j is function j at mMin+i*mStep (where there are N
+     * functions). An extra copy of the last row is stored so that interpolation at mMax needs
+     * no special case.
+     */
+    std::vector<double> mTables;
+};
+
+#endif // _UNIVARIATELOOKUPTABLE_HPP_
@@ -0,0 +1,209 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef _ABSTRACTFIXEDSIZEIVPODESOLVER_HPP_
+#define _ABSTRACTFIXEDSIZEIVPODESOLVER_HPP_
+
+#include <cassert>
+#include <vector>
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+
+#include "AbstractOneStepIvpOdeSolver.hpp"
+#include "TimeStepper.hpp"
+
+/**
+ * Base class for one step ODE solvers which are specialised at compile time for a particular
+ * concrete ODE system class and number of state variables.
+ *
+ * The generic one step solvers call the virtual CalculateNextYValue() for every timestep,
+ * which in turn calls the virtual EvaluateYDerivatives() of the ODE system, and (for some
+ * methods) allocate temporary vectors. For small systems, such as those used by subcellular
+ * reaction network and cell-cycle models, this overhead can be larger than the arithmetic.
+ * Here, the timestepping loop calls the method's step (SOLVER::CalculateFixedSizeNextYValue)
+ * and the system's EvaluateYDerivatives() directly, so they can be inlined; all working
+ * memory has the fixed size SIZE and is allocated once; and the loops over state variables
+ * have a compile-time length.
+ *
+ * The solvers are used like any other AbstractIvpOdeSolver, but can only be given ODE systems
+ * of type ODE_SYSTEM. For example, a cell-cycle model can use
+ *
+ *     CellCycleModelOdeSolver<MyCellCycleModel, FixedSizeRungeKutta4IvpOdeSolver<MyOdeSystem, 6> >::Instance()
+ *
+ * in place of the generic RungeKutta4IvpOdeSolver.
+ *
+ * Since these are templates they are not exported for serialization (or GetIdentifier())
+ * automatically: to checkpoint a simulation using one, make a typedef for the instantiation
+ * and pass it to CHASTE_CLASS_EXPORT.
+ *
+ * @tparam ODE_SYSTEM  the concrete ODE system class to be solved
+ * @tparam SIZE  the number of state variables of ODE_SYSTEM
+ * @tparam SOLVER  the concrete solver class which derives from this one, which must define a
+ *     public CalculateFixedSizeNextYValue() method with the same arguments as CalculateNextYValue()
+ *     but taking an ODE_SYSTEM
+ */
+template <class ODE_SYSTEM, unsigned SIZE, class SOLVER>
+class AbstractFixedSizeIvpOdeSolver : public AbstractOneStepIvpOdeSolver
+{
+private:
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Archive the abstract IVP Solver, never used directly - boost uses this.
+     *
+     * @param archive the archive
+     * @param version the current version of this class
+     */
+    template <class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        // This calls serialize on the base class.
+        archive & boost::serialization::base_object<AbstractOneStepIvpOdeSolver>(*this);
+    }
+
+    /**
+     * @return the given ODE system as its concrete type
+     * @param pAbstractOdeSystem  the ODE system
+     */
+    static ODE_SYSTEM& rGetOdeSystem(AbstractOdeSystem* pAbstractOdeSystem)
+    {
+        assert(dynamic_cast<ODE_SYSTEM*>(pAbstractOdeSystem) != nullptr);
+        assert(pAbstractOdeSystem->GetNumberOfStateVariables() == SIZE);
+        return *static_cast<ODE_SYSTEM*>(pAbstractOdeSystem);
+    }
+
+protected:
+    /**
+     * Method that actually performs the solving on behalf of the public Solve methods.
+     * This is the same as the base class version, but without virtual calls inside the loop.
+     *
+     * @param pAbstractOdeSystem  the ODE system to solve, which must be an ODE_SYSTEM
+     * @param rCurrentYValues  the current (initial) state; results will also be returned
+     *                         in here
+     * @param rWorkingMemory  working memory; same size as rCurrentYValues
+     * @param startTime  initial time
+     * @param endTime  time to solve to
+     * @param timeStep  dt
+     */
+    void InternalSolve(AbstractOdeSystem* pAbstractOdeSystem,
+                       std::vector<double>& rCurrentYValues,
+                       std::vector<double>& rWorkingMemory,
+                       double startTime,
+                       double endTime,
+                       double timeStep)
+    {
+        ODE_SYSTEM& r_ode_system = rGetOdeSystem(pAbstractOdeSystem);
+        SOLVER& r_solver = *static_cast<SOLVER*>(this);
+        assert(rCurrentYValues.size() == SIZE);
+        assert(rWorkingMemory.size() == SIZE);
+
+        TimeStepper stepper(startTime, endTime, timeStep);
+
+        // Which of our vectors holds the current solution?
+        // If this is true, it's in rCurrentYValues, otherwise it's in rWorkingMemory.
+        bool curr_is_curr = false;
+
+        // should never get here if this bool has been set to true;
+        assert(!mStoppingEventOccurred);
+        while (!stepper.IsTimeAtEnd() && !mStoppingEventOccurred)
+        {
+            curr_is_curr = !curr_is_curr;
+            r_solver.CalculateFixedSizeNextYValue(r_ode_system,
+                                                  stepper.GetNextTimeStep(),
+                                                  stepper.GetTime(),
+                                                  curr_is_curr ? rCurrentYValues : rWorkingMemory,
+                                                  curr_is_curr ? rWorkingMemory : rCurrentYValues);
+            stepper.AdvanceOneTimeStep();
+            if (r_ode_system.ODE_SYSTEM::CalculateStoppingEvent(stepper.GetTime(),
+                                                                curr_is_curr ? rWorkingMemory : rCurrentYValues))
+            {
+                mStoppingTime = stepper.GetTime();
+                mStoppingEventOccurred = true;
+            }
+        }
+        // Final answer must be in rCurrentYValues
+        if (curr_is_curr)
+        {
+            rCurrentYValues.assign(rWorkingMemory.begin(), rWorkingMemory.end());
+        }
+    }
+
+    /**
+     * Calculate the solution to the ODE system at the next timestep, by calling the
+     * concrete solver's CalculateFixedSizeNextYValue().
+     *
+     * @param pAbstractOdeSystem  the ODE system to solve, which must be an ODE_SYSTEM
+     * @param timeStep  dt
+     * @param time  the current time
+     * @param rCurrentYValues  the current (initial) state
+     * @param rNextYValues  the state at the next timestep
+     */
+    void CalculateNextYValue(AbstractOdeSystem* pAbstractOdeSystem,
+                             double timeStep,
+                             double time,
+                             std::vector<double>& rCurrentYValues,
+                             std::vector<double>& rNextYValues)
+    {
+        static_cast<SOLVER*>(this)->CalculateFixedSizeNextYValue(rGetOdeSystem(pAbstractOdeSystem),
+                                                                 timeStep, time, rCurrentYValues, rNextYValues);
+    }
+
+    /**
+     * Evaluate the derivatives of the ODE system without virtual dispatch.
+     *
+     * @param rOdeSystem  the ODE system
+     * @param time  the time
+     * @param rY  the state variables
+     * @param rDY  filled in with the derivatives
+     */
+    static void EvaluateYDerivatives(ODE_SYSTEM& rOdeSystem,
+                                     double time,
+                                     const std::vector<double>& rY,
+                                     std::vector<double>& rDY)
+    {
+        rOdeSystem.ODE_SYSTEM::EvaluateYDerivatives(time, rY, rDY);
+    }
+
+public:
+    /**
+     * Virtual destructor since we have virtual methods.
+     */
+    virtual ~AbstractFixedSizeIvpOdeSolver()
+    {
+    }
+};
+
+#endif //_ABSTRACTFIXEDSIZEIVPODESOLVER_HPP_
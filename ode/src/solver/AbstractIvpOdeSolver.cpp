@@ -63,6 +63,29 @@ void AbstractIvpOdeSolver::SolveAndUpdateStateVariable(
       startTime, endTime, timeStep);
 }
 
+void AbstractIvpOdeSolver::Solve(
+    AbstractOdeSystem* pAbstractOdeSystem
+  , std::vector<double>& rYValues
+  , double startTime
+  , double endTime
+  , double timeStep
+  , double timeSampling
+  , AbstractOdeSolutionSink& rSink)
+{
+  OdeSolution solution = Solve(pAbstractOdeSystem, rYValues, startTime,
+      endTime, timeStep, timeSampling);
+  const std::vector<double>& r_times = solution.rGetTimes();
+  const std::vector<std::vector<double> >& r_solutions =
+      solution.rGetSolutions();
+
+  rSink.BeginSolve(pAbstractOdeSystem->GetSystemInformation(),
+      GetIdentifier(), solution.GetNumberOfTimeSteps());
+  for (unsigned i = 0; i < r_times.size(); ++i) {
+    rSink.AddSample(r_times[i], r_solutions[i]);
+  }
+  rSink.EndSolve(solution.GetNumberOfTimeSteps());
+}
+
 bool AbstractIvpOdeSolver::StoppingEventOccurred()
 {
   return mStoppingEventOccurred;
@@ -42,6 +42,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ClassIsAbstract.hpp"
 #include "Identifiable.hpp"
 
+#include "AbstractOdeSolutionSink.hpp"
 #include "OdeSolution.hpp"
 #include "AbstractOdeSystem.hpp"
 
@@ -105,6 +106,32 @@ public:
                               double timeStep,
                               double timeSampling)=0;
 
+    /**
+     * Sink version of Solve. Solves a system of ODEs as for the version returning
+     * an OdeSolution, but passes each sample of the solution to the given sink as
+     * it is computed, so that the caller decides what is stored.
+     *
+     * The default implementation just passes on the samples of an OdeSolution once
+     * it has been computed; solvers should override it to stream samples directly.
+     *
+     * @param pAbstractOdeSystem  pointer to the concrete ODE system to be solved
+     * @param rYValues  a standard vector specifying the intial condition of each
+     *                  solution variable in the system (this can be the initial
+     *                  conditions vector stored in the ODE system)
+     * @param startTime  the time at which the initial conditions are specified
+     * @param endTime  the time to which the system should be solved
+     * @param timeStep  the time interval to be used by the solver
+     * @param timeSampling  the interval at which to sample the solution to the ODE system
+     * @param rSink  the sink to give the samples to
+     */
+    virtual void Solve(AbstractOdeSystem* pAbstractOdeSystem,
+                       std::vector<double>& rYValues,
+                       double startTime,
+                       double endTime,
+                       double timeStep,
+                       double timeSampling,
+                       AbstractOdeSolutionSink& rSink);
+
     /**
      * Second version of Solve. Solves a system of ODEs using a specified one-step
      * ODE solver. This method does not return the solution and therefore does not
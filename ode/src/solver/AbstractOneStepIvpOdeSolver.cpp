@@ -44,6 +44,19 @@ OdeSolution AbstractOneStepIvpOdeSolver::Solve(AbstractOdeSystem* pOdeSystem,
                                                double endTime,
                                                double timeStep,
                                                double timeSampling)
+{
+    OdeSolution solutions;
+    Solve(pOdeSystem, rYValues, startTime, endTime, timeStep, timeSampling, solutions);
+    return solutions;
+}
+
+void AbstractOneStepIvpOdeSolver::Solve(AbstractOdeSystem* pOdeSystem,
+                                        std::vector<double>& rYValues,
+                                        double startTime,
+                                        double endTime,
+                                        double timeStep,
+                                        double timeSampling,
+                                        AbstractOdeSolutionSink& rSink)
 {
     assert(rYValues.size()==pOdeSystem->GetNumberOfStateVariables());
     assert(endTime > startTime);
@@ -57,13 +70,9 @@ OdeSolution AbstractOneStepIvpOdeSolver::Solve(AbstractOdeSystem* pOdeSystem,
     }
     TimeStepper stepper(startTime, endTime, timeSampling);
 
-    // setup solutions if output is required
-    OdeSolution solutions;
-    solutions.SetNumberOfTimeSteps(stepper.EstimateTimeSteps());
-    solutions.rGetSolutions().push_back(rYValues);
-    solutions.rGetTimes().push_back(startTime);
-    solutions.SetOdeSystemInformation(pOdeSystem->GetSystemInformation());
-    solutions.SetSolverName( GetIdentifier() );
+    // give the initial condition to the sink
+    rSink.BeginSolve(pOdeSystem->GetSystemInformation(), GetIdentifier(), stepper.EstimateTimeSteps());
+    rSink.AddSample(startTime, rYValues);
 
     mWorkingMemory.resize(rYValues.size());
 
@@ -72,22 +81,12 @@ OdeSolution AbstractOneStepIvpOdeSolver::Solve(AbstractOdeSystem* pOdeSystem,
     {
         InternalSolve(pOdeSystem, rYValues, mWorkingMemory, stepper.GetTime(), stepper.GetNextTime(), timeStep);
         stepper.AdvanceOneTimeStep();
-        // write current solution into solutions
-        solutions.rGetSolutions().push_back(rYValues);
-        // Push back new time into the time solution vector
-        if (mStoppingEventOccurred)
-        {
-            solutions.rGetTimes().push_back(mStoppingTime);
-        }
-        else
-        {
-            solutions.rGetTimes().push_back(stepper.GetTime());
-        }
+        // give the current solution to the sink, at the stopping time if a stopping event occurred
+        rSink.AddSample(mStoppingEventOccurred ? mStoppingTime : stepper.GetTime(), rYValues);
     }
 
     // stepper.EstimateTimeSteps may have been an overestimate...
-    solutions.SetNumberOfTimeSteps(stepper.GetTotalTimeStepsTaken());
-    return solutions;
+    rSink.EndSolve(stepper.GetTotalTimeStepsTaken());
 }
 
 void AbstractOneStepIvpOdeSolver::Solve(
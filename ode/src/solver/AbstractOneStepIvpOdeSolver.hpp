@@ -142,6 +142,34 @@ public:
                               double timeStep,
                               double timeSampling);
 
+    /**
+     * Sink version of Solve, which passes each sample of the solution to the given
+     * sink as it is computed rather than storing it.
+     *
+     * An example, which keeps only every 10th sample:
+     *
+     *     OdeSolution solution;
+     *     DecimatingOdeSolutionSink sink(solution, 10);
+     *     solver.Solve(&ode, init_cond, 0, 1, 0.01, 0.01, sink);
+     *
+     * @param pAbstractOdeSystem  pointer to the concrete ODE system to be solved
+     * @param rYValues  a standard vector specifying the intial condition of each
+     *                  solution variable in the system (this can be the initial
+     *                  conditions vector stored in the ODE system)
+     * @param startTime  the time at which the initial conditions are specified
+     * @param endTime  the time to which the system should be solved
+     * @param timeStep  the time interval to be used by the solver
+     * @param timeSampling  the interval at which to sample the solution to the ODE system
+     * @param rSink  the sink to give the samples to
+     */
+    virtual void Solve(AbstractOdeSystem* pAbstractOdeSystem,
+                       std::vector<double>& rYValues,
+                       double startTime,
+                       double endTime,
+                       double timeStep,
+                       double timeSampling,
+                       AbstractOdeSolutionSink& rSink);
+
     /**
      * Second version of Solve. Solves a system of ODEs using a specified one-step
      * ODE solver. This method does not return the solution and therefore does not
@@ -274,6 +274,9 @@ public:
      */
     void ResetSolver();
 
+    /* Don't hide the sink version of Solve */
+    using AbstractIvpOdeSolver::Solve;
+
     /**
      * Solve the given ODE system, returning the solution at sampling intervals.
      *
@@ -0,0 +1,331 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifdef CHASTE_CVODE
+
+#include <cassert>
+#include <sstream>
+
+#include "CvodeEnsembleSolver.hpp"
+#include "CvodeAdaptor.hpp" // For CvodeErrorHandler
+#include "Exception.hpp"
+#include "MathsCustomFunctions.hpp" // For tolerance comparison
+#include "VectorHelperFunctions.hpp"
+
+// CVODE headers
+#include <cvode/cvode.h>
+#include <sundials/sundials_nvector.h>
+
+#if CHASTE_SUNDIALS_VERSION >= 30000
+#include <cvode/cvode_direct.h> /* access to CVDls interface            */
+#else
+#include <cvode/cvode_band.h>
+#endif
+
+/**
+ * Callback function provided to CVODE to evaluate the derivatives of every system in an ensemble.
+ *
+ * @param t  current time
+ * @param y  state variable vector
+ * @param ydot  derivatives vector to be filled in
+ * @param pData  pointer to the ensemble being simulated
+ */
+int CvodeEnsembleSolverRhsAdaptor(realtype t, N_Vector y, N_Vector ydot, void* pData)
+{
+    assert(pData != nullptr);
+    CvodeEnsembleSolver* p_ensemble = (CvodeEnsembleSolver*)pData;
+    try
+    {
+        p_ensemble->EvaluateYDerivatives(t, y, ydot);
+    }
+    catch (const Exception& e)
+    {
+        std::cerr << "CVODE RHS Exception: " << e.GetMessage()
+                  << std::endl
+                  << std::flush;
+        return -1;
+    }
+    return 0;
+}
+
+CvodeEnsembleSolver::CvodeEnsembleSolver()
+        : mNumStateVariablesPerSystem(0u),
+          mStateVariables(nullptr),
+          mLastSolutionState(nullptr),
+          mLastSolutionTime(0.0),
+          mBlockY(nullptr),
+          mBlockYDot(nullptr),
+          mpCvodeMem(nullptr),
+#if CHASTE_SUNDIALS_VERSION >= 30000
+          mpSundialsBandMatrix(nullptr),
+          mpSundialsLinearSolver(nullptr),
+#endif
+          mMaxSteps(0)
+{
+    SetTolerances(); // Set the tolerances to the defaults.
+}
+
+CvodeEnsembleSolver::~CvodeEnsembleSolver()
+{
+    FreeCvodeMemory();
+}
+
+void CvodeEnsembleSolver::AddSystem(AbstractCvodeSystem* pSystem)
+{
+    assert(pSystem != nullptr);
+    if (mSystems.empty())
+    {
+        mNumStateVariablesPerSystem = pSystem->GetNumberOfStateVariables();
+    }
+    else if (pSystem->GetNumberOfStateVariables() != mNumStateVariablesPerSystem)
+    {
+        EXCEPTION("All systems in a CVODE ensemble must have the same number of state variables.");
+    }
+    mSystems.push_back(pSystem);
+
+    // The size of the combined system has changed
+    FreeCvodeMemory();
+}
+
+unsigned CvodeEnsembleSolver::GetNumSystems() const
+{
+    return mSystems.size();
+}
+
+void CvodeEnsembleSolver::EvaluateYDerivatives(realtype time, N_Vector y, N_Vector ydot)
+{
+    realtype* p_y = NV_DATA_S(y);
+    realtype* p_ydot = NV_DATA_S(ydot);
+    for (unsigned i = 0; i < mSystems.size(); i++)
+    {
+        NV_DATA_S(mBlockY) = p_y + i * mNumStateVariablesPerSystem;
+        NV_DATA_S(mBlockYDot) = p_ydot + i * mNumStateVariablesPerSystem;
+        mSystems[i]->EvaluateYDerivatives(time, mBlockY, mBlockYDot);
+    }
+}
+
+void CvodeEnsembleSolver::Solve(realtype tStart, realtype tEnd, realtype maxDt)
+{
+    assert(tEnd >= tStart);
+    if (mSystems.empty())
+    {
+        EXCEPTION("No systems have been added to the CVODE ensemble.");
+    }
+
+    SetupCvode(tStart, maxDt);
+
+    // This should stop CVODE going past the end of where we wanted and interpolating back.
+    int ierr = CVodeSetStopTime(mpCvodeMem, tEnd);
+    assert(ierr == CV_SUCCESS);
+    UNUSED_OPT(ierr); // avoid unused var warning
+
+    double cvode_stopped_at = tStart;
+    ierr = CVode(mpCvodeMem, tEnd, mStateVariables, &cvode_stopped_at, CV_NORMAL);
+    if (ierr < 0)
+    {
+        std::stringstream err;
+        char* p_flag_name = CVodeGetReturnFlagName(ierr);
+        err << "CVODE failed to solve ensemble of " << mSystems.size() << " systems: " << p_flag_name
+            << "\nGot from time " << tStart << " to time " << cvode_stopped_at
+            << ", was supposed to finish at time " << tEnd << "\n";
+        free(p_flag_name);
+        FreeCvodeMemory();
+        EXCEPTION(err.str());
+    }
+    // Not root finding, so should have reached requested time
+    assert(fabs(cvode_stopped_at - tEnd) < DBL_EPSILON);
+
+    // Copy the results back into the systems, and remember where we got to
+    const unsigned total_size = NV_LENGTH_S(mStateVariables);
+    for (unsigned i = 0; i < mSystems.size(); i++)
+    {
+        N_Vector& r_state = mSystems[i]->rGetStateVariables();
+        for (unsigned j = 0; j < mNumStateVariablesPerSystem; j++)
+        {
+            NV_Ith_S(r_state, j) = NV_Ith_S(mStateVariables, i * mNumStateVariablesPerSystem + j);
+        }
+#ifndef NDEBUG
+        mSystems[i]->VerifyStateVariables();
+#endif
+    }
+    CreateVectorIfEmpty(mLastSolutionState, total_size);
+    for (unsigned i = 0; i < total_size; i++)
+    {
+        NV_Ith_S(mLastSolutionState, i) = NV_Ith_S(mStateVariables, i);
+    }
+    mLastSolutionTime = cvode_stopped_at;
+}
+
+void CvodeEnsembleSolver::ResetSolver()
+{
+    DeleteVector(mLastSolutionState);
+}
+
+void CvodeEnsembleSolver::SetTolerances(double relTol, double absTol)
+{
+    mRelTol = relTol;
+    mAbsTol = absTol;
+    ResetSolver();
+}
+
+void CvodeEnsembleSolver::SetMaxSteps(long int numSteps)
+{
+    mMaxSteps = numSteps;
+}
+
+void CvodeEnsembleSolver::SetupCvode(realtype tStart, realtype maxDt)
+{
+    assert(maxDt >= 0.0);
+    const unsigned size = mNumStateVariablesPerSystem;
+    const unsigned total_size = size * mSystems.size();
+
+    // Gather the current state of each system
+    CreateVectorIfEmpty(mStateVariables, total_size);
+    for (unsigned i = 0; i < mSystems.size(); i++)
+    {
+        N_Vector& r_state = mSystems[i]->rGetStateVariables();
+        for (unsigned j = 0; j < size; j++)
+        {
+            NV_Ith_S(mStateVariables, i * size + j) = NV_Ith_S(r_state, j);
+        }
+    }
+
+    // Find out if we need to (re-)initialise
+    bool reinit = !mpCvodeMem || !mLastSolutionState || !CompareDoubles::WithinAnyTolerance(tStart, mLastSolutionTime);
+    if (!reinit)
+    {
+        for (unsigned i = 0; i < total_size; i++)
+        {
+            if (!CompareDoubles::WithinAnyTolerance(NV_Ith_S(mLastSolutionState, i), NV_Ith_S(mStateVariables, i)))
+            {
+                reinit = true;
+                break;
+            }
+        }
+    }
+
+    if (!mpCvodeMem)
+    {
+        mBlockY = N_VMake_Serial(size, NV_DATA_S(mStateVariables));
+        mBlockYDot = N_VMake_Serial(size, NV_DATA_S(mStateVariables));
+
+        mpCvodeMem = CVodeCreate(CV_BDF, CV_NEWTON);
+        if (mpCvodeMem == nullptr) EXCEPTION("Failed to SetupCvode CVODE"); // in one line to avoid coverage problem!
+
+        // Set error handler
+        CVodeSetErrHandlerFn(mpCvodeMem, CvodeErrorHandler, nullptr);
+// Set the user data
+#if CHASTE_SUNDIALS_VERSION >= 20400
+        CVodeSetUserData(mpCvodeMem, (void*)(this));
+#else
+        CVodeSetFdata(mpCvodeMem, (void*)(this));
+#endif
+// Setup CVODE
+#if CHASTE_SUNDIALS_VERSION >= 20400
+        CVodeInit(mpCvodeMem, CvodeEnsembleSolverRhsAdaptor, tStart, mStateVariables);
+        CVodeSStolerances(mpCvodeMem, mRelTol, mAbsTol);
+#else
+        CVodeMalloc(mpCvodeMem, CvodeEnsembleSolverRhsAdaptor, tStart, mStateVariables,
+                    CV_SS, mRelTol, &mAbsTol);
+#endif
+
+        // The Jacobian is block diagonal, so lies within a band of one block either side of the diagonal
+        const unsigned half_bandwidth = size - 1;
+#if CHASTE_SUNDIALS_VERSION >= 30000
+        /* Create band SUNMatrix for use in linear solves; it needs extra storage for the LU factors */
+        mpSundialsBandMatrix = SUNBandMatrix(total_size, half_bandwidth, half_bandwidth, 2 * half_bandwidth);
+
+        /* Create band SUNLinearSolver object for use by CVode */
+        mpSundialsLinearSolver = SUNBandLinearSolver(mStateVariables, mpSundialsBandMatrix);
+
+        /* Call CVDlsSetLinearSolver to attach the matrix and linear solver to CVode */
+        CVDlsSetLinearSolver(mpCvodeMem, mpSundialsLinearSolver, mpSundialsBandMatrix);
+#else
+        // Attach a linear solver for Newton iteration
+        CVBand(mpCvodeMem, total_size, half_bandwidth, half_bandwidth);
+#endif
+    }
+    else if (reinit)
+    {
+#if CHASTE_SUNDIALS_VERSION >= 20400
+        CVodeReInit(mpCvodeMem, tStart, mStateVariables);
+        CVodeSStolerances(mpCvodeMem, mRelTol, mAbsTol);
+#else
+        CVodeReInit(mpCvodeMem, CvodeEnsembleSolverRhsAdaptor, tStart, mStateVariables,
+                    CV_SS, mRelTol, &mAbsTol);
+#endif
+    }
+
+    // Set max dt and change max steps if wanted
+    CVodeSetMaxStep(mpCvodeMem, maxDt);
+    if (mMaxSteps > 0)
+    {
+        CVodeSetMaxNumSteps(mpCvodeMem, mMaxSteps);
+        CVodeSetMaxErrTestFails(mpCvodeMem, 15);
+    }
+}
+
+void CvodeEnsembleSolver::FreeCvodeMemory()
+{
+    if (mpCvodeMem)
+    {
+        CVodeFree(&mpCvodeMem);
+    }
+    mpCvodeMem = nullptr;
+
+#if CHASTE_SUNDIALS_VERSION >= 30000
+    if (mpSundialsLinearSolver)
+    {
+        /* Free the linear solver memory */
+        SUNLinSolFree(mpSundialsLinearSolver);
+    }
+    mpSundialsLinearSolver = nullptr;
+
+    if (mpSundialsBandMatrix)
+    {
+        /* Free the matrix memory */
+        SUNMatDestroy(mpSundialsBandMatrix);
+    }
+    mpSundialsBandMatrix = nullptr;
+#endif
+
+    // The block wrappers don't own their data
+    DeleteVector(mBlockY);
+    DeleteVector(mBlockYDot);
+    DeleteVector(mStateVariables);
+    DeleteVector(mLastSolutionState);
+}
+
+#endif // CHASTE_CVODE
@@ -0,0 +1,199 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifdef CHASTE_CVODE
+#ifndef _CVODEENSEMBLESOLVER_HPP_
+#define _CVODEENSEMBLESOLVER_HPP_
+
+#include <vector>
+#include <boost/utility.hpp>
+
+#include "AbstractCvodeSystem.hpp"
+
+// CVODE headers
+#include <nvector/nvector_serial.h>
+
+#if CHASTE_SUNDIALS_VERSION >= 30000
+#include <sunlinsol/sunlinsol_band.h> /* access to band SUNLinearSolver      */
+#include <sunmatrix/sunmatrix_band.h> /* access to band SUNMatrix            */
+#endif
+
+/**
+ * Solve many independent CVODE systems (e.g. all the cells of one model owned by
+ * a process) as a single CVODE problem.
+ *
+ * The state variables of each system are packed one after the other into a single
+ * N_Vector, so the Jacobian of the combined system is block diagonal.  CVODE is given
+ * a band linear solver whose bandwidth is that of one block, so the cost of forming
+ * and factorising the Jacobian grows linearly with the number of systems, and the
+ * difference-quotient Jacobian needs only 2n-1 evaluations of the right-hand side
+ * (for systems of size n) however many systems are added.  This replaces the
+ * per-system CVODE memory, N_Vectors, dense matrix and linear solver, which dominate
+ * the memory use of tissues of small CVODE cells.
+ *
+ * The systems take a common time step and the error test is applied to the combined
+ * state vector, so results will differ slightly from solving each system on its own.
+ * Analytic Jacobians of the individual systems are not used.
+ *
+ * The solver does not own the systems.  Each system's state variables are copied in
+ * at the start of each Solve call and copied back out at the end.
+ */
+class CvodeEnsembleSolver : boost::noncopyable
+{
+private:
+    friend class TestCvodeEnsembleSolver;
+
+    /** The systems being solved. */
+    std::vector<AbstractCvodeSystem*> mSystems;
+
+    /** The number of state variables in each system. */
+    unsigned mNumStateVariablesPerSystem;
+
+    /** The state variables of all the systems, one after the other. */
+    N_Vector mStateVariables;
+
+    /** Where the last solve got to, so we know whether to re-initialise. */
+    N_Vector mLastSolutionState;
+
+    /** The time the last solve finished at. */
+    double mLastSolutionTime;
+
+    /** Wrapper giving one system access to its block of the state vector in right-hand side evaluations. */
+    N_Vector mBlockY;
+
+    /** Wrapper giving one system access to its block of the derivatives in right-hand side evaluations. */
+    N_Vector mBlockYDot;
+
+    /** CVODE's internal data. */
+    void* mpCvodeMem;
+
+#if CHASTE_SUNDIALS_VERSION >= 30000
+    /** Working memory for CVODE to store a band matrix */
+    SUNMatrix mpSundialsBandMatrix;
+    /** Working memory for CVODE's linear solver */
+    SUNLinearSolver mpSundialsLinearSolver;
+#endif
+
+    /** Relative tolerance for solver. */
+    double mRelTol;
+
+    /** Absolute tolerance for solver. */
+    double mAbsTol;
+
+    /**
+     * The maximum number of steps to be taken by the solver
+     * in its attempt to reach the next output time.
+     */
+    long int mMaxSteps;
+
+    /**
+     * Set up the CVODE data structures, re-initialising if the state variables or time
+     * are not where the last solve left them.
+     *
+     * @param tStart  start time of simulation
+     * @param maxDt  maximum time step to take
+     */
+    void SetupCvode(realtype tStart, realtype maxDt);
+
+    /** Free CVODE memory and the combined state vectors. */
+    void FreeCvodeMemory();
+
+public:
+    /**
+     * Constructor.  Systems must be added with AddSystem before solving.
+     */
+    CvodeEnsembleSolver();
+
+    /**
+     * Destructor; frees CVODE memory but not the systems.
+     */
+    ~CvodeEnsembleSolver();
+
+    /**
+     * Add a system to the ensemble.  All systems must have the same number of state variables.
+     *
+     * @param pSystem  the system, which must outlive this solver
+     */
+    void AddSystem(AbstractCvodeSystem* pSystem);
+
+    /**
+     * @return the number of systems in the ensemble.
+     */
+    unsigned GetNumSystems() const;
+
+    /**
+     * Evaluate the derivatives of every system, for CVODE.
+     *
+     * @param time  the current time
+     * @param y  the current values of the state variables of all the systems
+     * @param ydot  storage for the derivatives; will be filled in on return
+     */
+    void EvaluateYDerivatives(realtype time, N_Vector y, N_Vector ydot);
+
+    /**
+     * Simulate all the systems, updating their internal state variables.
+     *
+     * @param tStart  start time of simulation
+     * @param tEnd  end time of simulation
+     * @param maxDt  maximum time step to be taken by the adaptive solver
+     *   (set this appropriately to avoid missing a stimulus)
+     */
+    void Solve(realtype tStart, realtype tEnd, realtype maxDt);
+
+    /**
+     * Force CVODE to be re-initialised on the next Solve call.  See AbstractCvodeSystem::ResetSolver.
+     */
+    void ResetSolver();
+
+    /**
+     * Set relative and absolute tolerances; both scalars.
+     * If no parameters are given, tolerances will be reset to default values.
+     *
+     * @param relTol  the relative tolerance for the solver (defaults to 1e-5)
+     * @param absTol  the absolute tolerance for the solver (defaults to 1e-7)
+     */
+    void SetTolerances(double relTol = 1e-5, double absTol = 1e-7);
+
+    /**
+     * Change the maximum number of steps to be taken by the solver
+     * in its attempt to reach the next output time.  Default is 500 (set by CVODE).
+     *
+     * @param numSteps new maximum
+     */
+    void SetMaxSteps(long int numSteps);
+};
+
+#endif // _CVODEENSEMBLESOLVER_HPP_
+#endif // CHASTE_CVODE
@@ -0,0 +1,95 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef _FIXEDSIZEEULERIVPODESOLVER_HPP_
+#define _FIXEDSIZEEULERIVPODESOLVER_HPP_
+
+#include "AbstractFixedSizeIvpOdeSolver.hpp"
+
+/**
+ * A forward Euler solver, as EulerIvpOdeSolver, specialised for a particular ODE system class and size.
+ *
+ * This gives the same results as the generic solver, see AbstractFixedSizeIvpOdeSolver.
+ *
+ * @tparam ODE_SYSTEM  the concrete ODE system class to be solved
+ * @tparam SIZE  the number of state variables of ODE_SYSTEM
+ */
+template <class ODE_SYSTEM, unsigned SIZE>
+class FixedSizeEulerIvpOdeSolver : public AbstractFixedSizeIvpOdeSolver<ODE_SYSTEM, SIZE, FixedSizeEulerIvpOdeSolver<ODE_SYSTEM, SIZE> >
+{
+private:
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Archive the abstract IVP Solver, never used directly - boost uses this.
+     *
+     * @param archive the archive
+     * @param version the current version of this class
+     */
+    template <class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        // This calls serialize on the base class.
+        archive & boost::serialization::base_object<AbstractFixedSizeIvpOdeSolver<ODE_SYSTEM, SIZE, FixedSizeEulerIvpOdeSolver<ODE_SYSTEM, SIZE> > >(*this);
+    }
+
+public:
+    /**
+     * Calculate the solution to the ODE system at the next timestep.
+     *
+     * @param rOdeSystem  the ODE system to solve
+     * @param timeStep  dt
+     * @param time  the current time
+     * @param rCurrentYValues  the current (initial) state
+     * @param rNextYValues  the state at the next timestep
+     */
+    void CalculateFixedSizeNextYValue(ODE_SYSTEM& rOdeSystem,
+                                      double timeStep,
+                                      double time,
+                                      std::vector<double>& rCurrentYValues,
+                                      std::vector<double>& rNextYValues)
+    {
+        // Yes, this looks weird, but it makes good use of memory!
+        this->EvaluateYDerivatives(rOdeSystem, time, rCurrentYValues, rNextYValues /*dydt is stored here*/);
+
+        for (unsigned i=0; i<SIZE; i++)
+        {
+            // rNextYValues contains dY/dt until here
+            rNextYValues[i] = rCurrentYValues[i] + timeStep * rNextYValues[i];
+        }
+    }
+};
+
+#endif //_FIXEDSIZEEULERIVPODESOLVER_HPP_
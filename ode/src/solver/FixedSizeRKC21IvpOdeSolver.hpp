@@ -0,0 +1,123 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef _FIXEDSIZERKC21IVPODESOLVER_HPP_
+#define _FIXEDSIZERKC21IVPODESOLVER_HPP_
+
+#include "AbstractFixedSizeIvpOdeSolver.hpp"
+
+/**
+ * A Runge Kutta Chebyshev 1st order 2 stage solver, as RKC21IvpOdeSolver, specialised for a particular ODE system class and size.
+ *
+ * This gives the same results as the generic solver, see AbstractFixedSizeIvpOdeSolver.
+ * Unlike RKC21IvpOdeSolver, the working memory is allocated once rather than for every timestep.
+ *
+ * @tparam ODE_SYSTEM  the concrete ODE system class to be solved
+ * @tparam SIZE  the number of state variables of ODE_SYSTEM
+ */
+template <class ODE_SYSTEM, unsigned SIZE>
+class FixedSizeRKC21IvpOdeSolver : public AbstractFixedSizeIvpOdeSolver<ODE_SYSTEM, SIZE, FixedSizeRKC21IvpOdeSolver<ODE_SYSTEM, SIZE> >
+{
+private:
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Archive the abstract IVP Solver, never used directly - boost uses this.
+     *
+     * @param archive the archive
+     * @param version the current version of this class
+     */
+    template <class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        // This calls serialize on the base class.
+        archive & boost::serialization::base_object<AbstractFixedSizeIvpOdeSolver<ODE_SYSTEM, SIZE, FixedSizeRKC21IvpOdeSolver<ODE_SYSTEM, SIZE> > >(*this);
+    }
+
+    std::vector<double> mW1; /**< Working memory: the first stage w1 of the RKC method. */
+    std::vector<double> mF0; /**< Working memory: the derivatives F0 at the start of the step. */
+
+public:
+    /**
+     * Constructor, which allocates the working memory.
+     */
+    FixedSizeRKC21IvpOdeSolver()
+        : mW1(SIZE),
+          mF0(SIZE)
+    {
+    }
+
+public:
+    /**
+     * Calculate the solution to the ODE system at the next timestep.
+     *
+     * @param rOdeSystem  the ODE system to solve
+     * @param timeStep  dt
+     * @param time  the current time
+     * @param rCurrentYValues  the current (initial) state
+     * @param rNextYValues  the state at the next timestep
+     */
+    void CalculateFixedSizeNextYValue(ODE_SYSTEM& rOdeSystem,
+                                      double timeStep,
+                                      double time,
+                                      std::vector<double>& rCurrentYValues,
+                                      std::vector<double>& rNextYValues)
+    {
+        // RKC coefficients, as in RKC21IvpOdeSolver
+        const double mu1_tilde = 0.256134735558604;
+        const double mu2 = 1.952097590002976;
+        const double mu2_tilde = 0.500000000000000;
+
+        std::vector<double>& w0 = rCurrentYValues; // alias
+        std::vector<double>& w2 = rNextYValues; // alias
+        std::vector<double>& F1 = rNextYValues;
+
+        // Work out w1
+        this->EvaluateYDerivatives(rOdeSystem, time, w0, mF0);
+        for (unsigned i=0; i<SIZE; i++)
+        {
+            mW1[i] = w0[i] + mu1_tilde * timeStep * mF0[i];
+        }
+
+        // Work next step
+        this->EvaluateYDerivatives(rOdeSystem, time + mu1_tilde * timeStep, mW1, F1);
+        for (unsigned i=0; i<SIZE; i++)
+        {
+            w2[i] = (1-mu2) * w0[i] + mu2 * mW1[i] + mu2_tilde * timeStep * F1[i];
+        }
+    }
+};
+
+#endif //_FIXEDSIZERKC21IVPODESOLVER_HPP_
@@ -0,0 +1,135 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef _FIXEDSIZERUNGEKUTTA4IVPODESOLVER_HPP_
+#define _FIXEDSIZERUNGEKUTTA4IVPODESOLVER_HPP_
+
+#include "AbstractFixedSizeIvpOdeSolver.hpp"
+
+/**
+ * A 4th order Runge Kutta solver, as RungeKutta4IvpOdeSolver, specialised for a particular ODE system class and size.
+ *
+ * This gives the same results as the generic solver, see AbstractFixedSizeIvpOdeSolver.
+ *
+ * @tparam ODE_SYSTEM  the concrete ODE system class to be solved
+ * @tparam SIZE  the number of state variables of ODE_SYSTEM
+ */
+template <class ODE_SYSTEM, unsigned SIZE>
+class FixedSizeRungeKutta4IvpOdeSolver : public AbstractFixedSizeIvpOdeSolver<ODE_SYSTEM, SIZE, FixedSizeRungeKutta4IvpOdeSolver<ODE_SYSTEM, SIZE> >
+{
+private:
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Archive the abstract IVP Solver, never used directly - boost uses this.
+     *
+     * @param archive the archive
+     * @param version the current version of this class
+     */
+    template <class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        // This calls serialize on the base class.
+        archive & boost::serialization::base_object<AbstractFixedSizeIvpOdeSolver<ODE_SYSTEM, SIZE, FixedSizeRungeKutta4IvpOdeSolver<ODE_SYSTEM, SIZE> > >(*this);
+    }
+
+    std::vector<double> k1;  /**< Working memory: expression k1 in the RK4 method. */
+    std::vector<double> k2;  /**< Working memory: expression k2 in the RK4 method. */
+    std::vector<double> k3;  /**< Working memory: expression k3 in the RK4 method. */
+    std::vector<double> k4;  /**< Working memory: expression k4 in the RK4 method. */
+    std::vector<double> yki; /**< Working memory: expression yki in the RK4 method. */
+
+public:
+    /**
+     * Constructor, which allocates the working memory.
+     */
+    FixedSizeRungeKutta4IvpOdeSolver()
+        : k1(SIZE),
+          k2(SIZE),
+          k3(SIZE),
+          k4(SIZE),
+          yki(SIZE)
+    {
+    }
+
+public:
+    /**
+     * Calculate the solution to the ODE system at the next timestep.
+     *
+     * @param rOdeSystem  the ODE system to solve
+     * @param timeStep  dt
+     * @param time  the current time
+     * @param rCurrentYValues  the current (initial) state
+     * @param rNextYValues  the state at the next timestep
+     */
+    void CalculateFixedSizeNextYValue(ODE_SYSTEM& rOdeSystem,
+                                      double timeStep,
+                                      double time,
+                                      std::vector<double>& rCurrentYValues,
+                                      std::vector<double>& rNextYValues)
+    {
+        std::vector<double>& dy = rNextYValues; // re-use memory
+
+        this->EvaluateYDerivatives(rOdeSystem, time, rCurrentYValues, dy);
+        for (unsigned i=0; i<SIZE; i++)
+        {
+            k1[i] = timeStep*dy[i];
+            yki[i] = rCurrentYValues[i] + 0.5*k1[i];
+        }
+
+        this->EvaluateYDerivatives(rOdeSystem, time+0.5*timeStep, yki, dy);
+        for (unsigned i=0; i<SIZE; i++)
+        {
+            k2[i] = timeStep*dy[i];
+            yki[i] = rCurrentYValues[i] + 0.5*k2[i];
+        }
+
+        this->EvaluateYDerivatives(rOdeSystem, time+0.5*timeStep, yki, dy);
+        for (unsigned i=0; i<SIZE; i++)
+        {
+            k3[i] = timeStep*dy[i];
+            yki[i] = rCurrentYValues[i] + k3[i];
+        }
+
+        this->EvaluateYDerivatives(rOdeSystem, time+timeStep, yki, dy);
+        for (unsigned i=0; i<SIZE; i++)
+        {
+            k4[i] = timeStep*dy[i];
+            rNextYValues[i] = rCurrentYValues[i] + (k1[i]+2*k2[i]+2*k3[i]+k4[i])/6.0;
+        }
+    }
+};
+
+#endif //_FIXEDSIZERUNGEKUTTA4IVPODESOLVER_HPP_
@@ -176,6 +176,9 @@ public:
      */
     RungeKuttaFehlbergIvpOdeSolver();
 
+    /* Don't hide the sink version of Solve */
+    using AbstractIvpOdeSolver::Solve;
+
     /**
      * Solves a system of ODEs using a specified one-step ODE solver and returns
      * the solution as an OdeSolution object.
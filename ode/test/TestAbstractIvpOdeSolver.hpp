@@ -49,6 +49,9 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "RungeKutta2IvpOdeSolver.hpp"
 #include "RungeKutta4IvpOdeSolver.hpp"
 #include "OdeSolution.hpp"
+#include "DecimatingOdeSolutionSink.hpp"
+#include "SingleVariableOdeSolutionSink.hpp"
+#include "RungeKuttaFehlbergIvpOdeSolver.hpp"
 
 #include "Ode1.hpp"
 #include "Ode2.hpp"
@@ -602,6 +605,82 @@ public:
         TS_ASSERT_DELTA(testvalue_rk4, exact_solution, global_error_rk4);
     }
 
+    void TestSolvingToSinks()
+    {
+        OdeSecondOrder ode_system;
+        EulerIvpOdeSolver solver;
+
+        // The full solution, for comparison
+        std::vector<double> state_variables = ode_system.GetInitialConditions();
+        OdeSolution full_solution = solver.Solve(&ode_system, state_variables, 0.0, 1.05, 0.01, 0.01);
+        TS_ASSERT_EQUALS(full_solution.GetNumberOfTimeSteps(), 105u);
+
+        // An OdeSolution is itself a sink, so this is the same as above
+        OdeSolution sink_solution;
+        state_variables = ode_system.GetInitialConditions();
+        solver.Solve(&ode_system, state_variables, 0.0, 1.05, 0.01, 0.01, sink_solution);
+        TS_ASSERT_EQUALS(sink_solution.GetNumberOfTimeSteps(), 105u);
+        TS_ASSERT_EQUALS(sink_solution.rGetTimes().size(), 106u);
+        TS_ASSERT_EQUALS(sink_solution.GetSolverName(), "EulerIvpOdeSolver");
+        TS_ASSERT_DELTA(sink_solution.rGetSolutions().back()[0], full_solution.rGetSolutions().back()[0], 1e-12);
+
+        // Keep every 10th sample, plus the last one
+        TS_ASSERT_THROWS_THIS(DecimatingOdeSolutionSink bad_sink(sink_solution, 0u),
+                              "The number of samples per output must be positive.");
+        OdeSolution decimated_solution;
+        DecimatingOdeSolutionSink decimating_sink(decimated_solution, 10u);
+        state_variables = ode_system.GetInitialConditions();
+        solver.Solve(&ode_system, state_variables, 0.0, 1.05, 0.01, 0.01, decimating_sink);
+        TS_ASSERT_EQUALS(decimated_solution.GetNumberOfTimeSteps(), 11u);
+        TS_ASSERT_EQUALS(decimated_solution.rGetTimes().size(), 12u);
+        for (unsigned i=0; i<11u; i++)
+        {
+            TS_ASSERT_DELTA(decimated_solution.rGetTimes()[i], full_solution.rGetTimes()[10*i], 1e-12);
+            TS_ASSERT_DELTA(decimated_solution.rGetSolutions()[i][1], full_solution.rGetSolutions()[10*i][1], 1e-12);
+        }
+        TS_ASSERT_DELTA(decimated_solution.rGetTimes().back(), 1.05, 1e-12);
+        TS_ASSERT_DELTA(decimated_solution.rGetSolutions().back()[0], full_solution.rGetSolutions().back()[0], 1e-12);
+
+        // The decimated solution can be written to file as usual
+        decimated_solution.WriteToFile("OdeSolution", "OdeSecondOrderDecimated", "time");
+
+        // Keep only the first variable
+        SingleVariableOdeSolutionSink trace(0u);
+        state_variables = ode_system.GetInitialConditions();
+        solver.Solve(&ode_system, state_variables, 0.0, 1.05, 0.01, 0.01, trace);
+        std::vector<double> full_trace = full_solution.GetVariableAtIndex(0u);
+        TS_ASSERT_EQUALS(trace.rGetValues().size(), full_trace.size());
+        TS_ASSERT_EQUALS(trace.rGetTimes().size(), full_trace.size());
+        for (unsigned i=0; i<full_trace.size(); i++)
+        {
+            TS_ASSERT_DELTA(trace.rGetValues()[i], full_trace[i], 1e-12);
+        }
+        // y0 = sin(t) increases over this interval
+        TS_ASSERT_DELTA(trace.GetMinimum(), 0.0, 1e-12);
+        TS_ASSERT_DELTA(trace.GetMaximum(), full_trace.back(), 1e-12);
+        TS_ASSERT_DELTA(trace.GetTimeOfMaximum(), 1.05, 1e-12);
+
+        // Continuing the solve adds to the trace, without repeating the shared time
+        solver.Solve(&ode_system, state_variables, 1.05, 2.05, 0.01, 0.01, trace);
+        TS_ASSERT_EQUALS(trace.rGetTimes().size(), 206u);
+        TS_ASSERT_DELTA(trace.GetTimeOfMaximum(), M_PI/2.0, 0.02);
+
+        SingleVariableOdeSolutionSink bad_trace(2u);
+        TS_ASSERT_THROWS_THIS(solver.Solve(&ode_system, state_variables, 0.0, 1.0, 0.01, 0.01, bad_trace),
+                              "Variable index 2 is not a state variable of this ODE system.");
+
+        // Solvers that don't stream samples pass on a complete solution
+        RungeKuttaFehlbergIvpOdeSolver rkf_solver;
+        OdeSolution rkf_solution;
+        state_variables = ode_system.GetInitialConditions();
+        OdeSolution rkf_full_solution = rkf_solver.Solve(&ode_system, state_variables, 0.0, 1.0, 0.1, 1e-5);
+        state_variables = ode_system.GetInitialConditions();
+        rkf_solver.Solve(&ode_system, state_variables, 0.0, 1.0, 0.1, 1e-5, rkf_solution);
+        TS_ASSERT_EQUALS(rkf_solution.rGetTimes().size(), rkf_full_solution.rGetTimes().size());
+        TS_ASSERT_EQUALS(rkf_solution.GetNumberOfTimeSteps(), rkf_full_solution.GetNumberOfTimeSteps());
+        TS_ASSERT_DELTA(rkf_solution.rGetSolutions().back()[0], rkf_full_solution.rGetSolutions().back()[0], 1e-12);
+    }
+
     void TestArchivingSolvers()
     {
         OutputFileHandler handler("archive",false);
@@ -0,0 +1,146 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef _TESTCVODEENSEMBLESOLVER_HPP_
+#define _TESTCVODEENSEMBLESOLVER_HPP_
+
+#include <cxxtest/TestSuite.h>
+
+#include <cmath>
+#include <vector>
+
+#include "CvodeEnsembleSolver.hpp"
+#include "Cvode1.hpp"
+#include "ParameterisedCvode.hpp"
+#include "TwoDimCvodeSystem.hpp"
+#include "VectorHelperFunctions.hpp"
+
+#include "FakePetscSetup.hpp"
+
+class TestCvodeEnsembleSolver : public CxxTest::TestSuite
+{
+public:
+    void TestSolveEnsemble()
+    {
+#ifdef CHASTE_CVODE
+        // dy/dt = y with different initial conditions in each system
+        const unsigned num_systems = 10u;
+        std::vector<TwoDimCvodeSystem*> systems;
+        CvodeEnsembleSolver ensemble;
+        for (unsigned i = 0; i < num_systems; i++)
+        {
+            systems.push_back(new TwoDimCvodeSystem);
+            SetVectorComponent(systems[i]->rGetStateVariables(), 0, 1.0 + i);
+            ensemble.AddSystem(systems[i]);
+        }
+        TS_ASSERT_EQUALS(ensemble.GetNumSystems(), num_systems);
+        ensemble.SetTolerances(1e-8, 1e-10);
+
+        ensemble.Solve(0.0, 0.5, 0.1);
+        // Carry on without re-initialising
+        TS_ASSERT(ensemble.mLastSolutionState != NULL);
+        ensemble.Solve(0.5, 1.0, 0.1);
+
+        for (unsigned i = 0; i < num_systems; i++)
+        {
+            TS_ASSERT_DELTA(GetVectorComponent(systems[i]->rGetStateVariables(), 0), (1.0 + i) * exp(1.0), 1e-5);
+            TS_ASSERT_DELTA(GetVectorComponent(systems[i]->rGetStateVariables(), 1), 2.0 * exp(1.0), 1e-5);
+        }
+
+        // Changing a system's state between solves is picked up
+        SetVectorComponent(systems[0]->rGetStateVariables(), 0, 1.0);
+        ensemble.Solve(1.0, 2.0, 0.1);
+        TS_ASSERT_DELTA(GetVectorComponent(systems[0]->rGetStateVariables(), 0), exp(1.0), 1e-5);
+        TS_ASSERT_DELTA(GetVectorComponent(systems[1]->rGetStateVariables(), 0), 2.0 * exp(2.0), 1e-4);
+
+        for (unsigned i = 0; i < num_systems; i++)
+        {
+            delete systems[i];
+        }
+#else
+        std::cout << "Cvode is not enabled.\n";
+#endif // CHASTE_CVODE
+    }
+
+    void TestEnsembleMatchesIndividualSolves()
+    {
+#ifdef CHASTE_CVODE
+        // dy/dt = a, with a different in each system
+        std::vector<ParameterisedCvode*> systems;
+        CvodeEnsembleSolver ensemble;
+        for (unsigned i = 0; i < 3u; i++)
+        {
+            systems.push_back(new ParameterisedCvode);
+            systems[i]->SetParameter("a", 0.5 * i);
+            ensemble.AddSystem(systems[i]);
+        }
+        ensemble.Solve(0.0, 2.0, 0.1);
+
+        for (unsigned i = 0; i < 3u; i++)
+        {
+            ParameterisedCvode single_system;
+            single_system.SetParameter("a", 0.5 * i);
+            single_system.Solve(0.0, 2.0, 0.1);
+
+            TS_ASSERT_DELTA(GetVectorComponent(systems[i]->rGetStateVariables(), 0), 1.0 * i, 1e-6);
+            TS_ASSERT_DELTA(GetVectorComponent(systems[i]->rGetStateVariables(), 0),
+                            GetVectorComponent(single_system.rGetStateVariables(), 0), 1e-6);
+            delete systems[i];
+        }
+#else
+        std::cout << "Cvode is not enabled.\n";
+#endif // CHASTE_CVODE
+    }
+
+    void TestExceptions()
+    {
+#ifdef CHASTE_CVODE
+        CvodeEnsembleSolver ensemble;
+        TS_ASSERT_THROWS_THIS(ensemble.Solve(0.0, 1.0, 0.1),
+                              "No systems have been added to the CVODE ensemble.");
+
+        TwoDimCvodeSystem two_dim_system;
+        Cvode1 one_dim_system;
+        ensemble.AddSystem(&two_dim_system);
+        TS_ASSERT_THROWS_THIS(ensemble.AddSystem(&one_dim_system),
+                              "All systems in a CVODE ensemble must have the same number of state variables.");
+        TS_ASSERT_EQUALS(ensemble.GetNumSystems(), 1u);
+#else
+        std::cout << "Cvode is not enabled.\n";
+#endif // CHASTE_CVODE
+    }
+};
+
+#endif // _TESTCVODEENSEMBLESOLVER_HPP_
@@ -0,0 +1,141 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef _TESTFIXEDSIZEIVPODESOLVERS_HPP_
+#define _TESTFIXEDSIZEIVPODESOLVERS_HPP_
+
+#include <cxxtest/TestSuite.h>
+
+#include "EulerIvpOdeSolver.hpp"
+#include "FixedSizeEulerIvpOdeSolver.hpp"
+#include "FixedSizeRKC21IvpOdeSolver.hpp"
+#include "FixedSizeRungeKutta4IvpOdeSolver.hpp"
+#include "RKC21IvpOdeSolver.hpp"
+#include "RungeKutta4IvpOdeSolver.hpp"
+
+#include "OdeSecondOrder.hpp"
+#include "OdeSecondOrderWithEvents.hpp"
+#include "OdeThirdOrder.hpp"
+
+#include "FakePetscSetup.hpp"
+
+class TestFixedSizeIvpOdeSolvers : public CxxTest::TestSuite
+{
+private:
+    /**
+     * Check that a fixed size solver gives the same results as the equivalent generic one.
+     */
+    template <class ODE_SYSTEM>
+    void CompareSolvers(AbstractIvpOdeSolver& rGenericSolver, AbstractIvpOdeSolver& rFixedSizeSolver)
+    {
+        ODE_SYSTEM generic_ode;
+        ODE_SYSTEM fixed_size_ode;
+
+        std::vector<double> generic_state = generic_ode.GetInitialConditions();
+        std::vector<double> fixed_size_state = fixed_size_ode.GetInitialConditions();
+
+        rGenericSolver.Solve(&generic_ode, generic_state, 0.0, 2.0, 0.01);
+        rFixedSizeSolver.Solve(&fixed_size_ode, fixed_size_state, 0.0, 2.0, 0.01);
+
+        TS_ASSERT_EQUALS(fixed_size_state.size(), generic_state.size());
+        for (unsigned i=0; i<generic_state.size(); i++)
+        {
+            TS_ASSERT_DELTA(fixed_size_state[i], generic_state[i], 1e-12);
+        }
+
+        // Solving in place in the ODE system, with an odd number of steps
+        generic_ode.SetStateVariables(generic_ode.GetInitialConditions());
+        fixed_size_ode.SetStateVariables(fixed_size_ode.GetInitialConditions());
+        rGenericSolver.SolveAndUpdateStateVariable(&generic_ode, 0.0, 1.03, 0.01);
+        rFixedSizeSolver.SolveAndUpdateStateVariable(&fixed_size_ode, 0.0, 1.03, 0.01);
+        for (unsigned i=0; i<generic_state.size(); i++)
+        {
+            TS_ASSERT_DELTA(fixed_size_ode.rGetStateVariables()[i], generic_ode.rGetStateVariables()[i], 1e-12);
+        }
+    }
+
+public:
+    void TestEulerSolver()
+    {
+        EulerIvpOdeSolver generic_solver;
+        FixedSizeEulerIvpOdeSolver<OdeSecondOrder, 2> fixed_size_solver;
+        CompareSolvers<OdeSecondOrder>(generic_solver, fixed_size_solver);
+
+        FixedSizeEulerIvpOdeSolver<OdeThirdOrder, 3> fixed_size_solver_3;
+        CompareSolvers<OdeThirdOrder>(generic_solver, fixed_size_solver_3);
+    }
+
+    void TestRungeKutta4Solver()
+    {
+        RungeKutta4IvpOdeSolver generic_solver;
+        FixedSizeRungeKutta4IvpOdeSolver<OdeSecondOrder, 2> fixed_size_solver;
+        CompareSolvers<OdeSecondOrder>(generic_solver, fixed_size_solver);
+
+        FixedSizeRungeKutta4IvpOdeSolver<OdeThirdOrder, 3> fixed_size_solver_3;
+        CompareSolvers<OdeThirdOrder>(generic_solver, fixed_size_solver_3);
+    }
+
+    void TestRKC21Solver()
+    {
+        RKC21IvpOdeSolver generic_solver;
+        FixedSizeRKC21IvpOdeSolver<OdeSecondOrder, 2> fixed_size_solver;
+        CompareSolvers<OdeSecondOrder>(generic_solver, fixed_size_solver);
+
+        FixedSizeRKC21IvpOdeSolver<OdeThirdOrder, 3> fixed_size_solver_3;
+        CompareSolvers<OdeThirdOrder>(generic_solver, fixed_size_solver_3);
+    }
+
+    void TestStoppingEvents()
+    {
+        // Solutions are circles, and the stopping event is the first variable becoming negative
+        OdeSecondOrderWithEvents generic_ode;
+        OdeSecondOrderWithEvents fixed_size_ode;
+        RungeKutta4IvpOdeSolver generic_solver;
+        FixedSizeRungeKutta4IvpOdeSolver<OdeSecondOrderWithEvents, 2> fixed_size_solver;
+
+        std::vector<double> generic_state = generic_ode.GetInitialConditions();
+        std::vector<double> fixed_size_state = fixed_size_ode.GetInitialConditions();
+        generic_solver.Solve(&generic_ode, generic_state, 0.0, 2.0, 0.001);
+        fixed_size_solver.Solve(&fixed_size_ode, fixed_size_state, 0.0, 2.0, 0.001);
+
+        TS_ASSERT(fixed_size_solver.StoppingEventOccurred());
+        TS_ASSERT_DELTA(fixed_size_solver.GetStoppingTime(), M_PI/2.0, 0.001);
+        TS_ASSERT_DELTA(fixed_size_solver.GetStoppingTime(), generic_solver.GetStoppingTime(), 1e-12);
+        TS_ASSERT_DELTA(fixed_size_state[0], generic_state[0], 1e-12);
+        TS_ASSERT_DELTA(fixed_size_state[1], generic_state[1], 1e-12);
+    }
+};
+
+#endif // _TESTFIXEDSIZEIVPODESOLVERS_HPP_
@@ -0,0 +1,161 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef _TESTUNIVARIATELOOKUPTABLE_HPP_
+#define _TESTUNIVARIATELOOKUPTABLE_HPP_
+
+#include <cxxtest/TestSuite.h>
+
+#include <cmath>
+#include <vector>
+
+#include "AbstractOdeSystem.hpp"
+#include "OdeSystemInformation.hpp"
+#include "RungeKutta4IvpOdeSolver.hpp"
+#include "UnivariateLookupTable.hpp"
+
+#include "FakePetscSetup.hpp"
+
+/** dy/dt = -exp(y), with the exponential looked up; y(t) = -log(1+t) when y(0)=0 */
+class LookupTableOde : public AbstractOdeSystem
+{
+private:
+    UnivariateLookupTable mTable;
+    unsigned mExpIndex;
+
+    static double Exp(double x)
+    {
+        return exp(x);
+    }
+
+public:
+    LookupTableOde()
+        : AbstractOdeSystem(1),
+          mTable("y", -5.0, 0.0001, 0.0)
+    {
+        mpSystemInfo = OdeSystemInformation<LookupTableOde>::Instance();
+        mExpIndex = mTable.AddFunction(&LookupTableOde::Exp);
+    }
+
+    void EvaluateYDerivatives(double time, const std::vector<double>& rY, std::vector<double>& rDY)
+    {
+        rDY[0] = -mTable.LookUp(mExpIndex, rY[0]);
+    }
+};
+
+template <>
+void OdeSystemInformation<LookupTableOde>::Initialise()
+{
+    this->mVariableNames.push_back("y");
+    this->mVariableUnits.push_back("dimensionless");
+    this->mInitialConditions.push_back(0.0);
+
+    this->mInitialised = true;
+}
+
+/** A second function to tabulate */
+double Square(double x)
+{
+    return x*x;
+}
+
+class TestUnivariateLookupTable : public CxxTest::TestSuite
+{
+public:
+    void TestLookUpAndInterpolation()
+    {
+        UnivariateLookupTable table("x", 0.0, 0.5, 2.0);
+        TS_ASSERT_EQUALS(table.GetNumberOfFunctions(), 0u);
+        TS_ASSERT_EQUALS(table.AddFunction(&Square), 0u);
+        TS_ASSERT_EQUALS(table.AddFunction(static_cast<double (*)(double)>(&exp)), 1u);
+        TS_ASSERT_EQUALS(table.GetNumberOfFunctions(), 2u);
+
+        double min, step, max;
+        table.GetTableProperties(min, step, max);
+        TS_ASSERT_DELTA(min, 0.0, 1e-12);
+        TS_ASSERT_DELTA(step, 0.5, 1e-12);
+        TS_ASSERT_DELTA(max, 2.0, 1e-12);
+
+        // Exact at table entries, including both bounds
+        TS_ASSERT_DELTA(table.LookUp(0u, 0.0), 0.0, 1e-12);
+        TS_ASSERT_DELTA(table.LookUp(0u, 1.5), 2.25, 1e-12);
+        TS_ASSERT_DELTA(table.LookUp(0u, 2.0), 4.0, 1e-12);
+        TS_ASSERT_DELTA(table.LookUp(1u, 2.0), exp(2.0), 1e-12);
+
+        // Linear interpolation in between
+        TS_ASSERT_DELTA(table.LookUp(0u, 0.75), 0.5*(0.25 + 1.0), 1e-12);
+        TS_ASSERT_DELTA(table.LookUp(1u, 1.25), 0.5*(exp(1.0) + exp(1.5)), 1e-12);
+
+        std::vector<double> values;
+        table.LookUpAll(0.75, values);
+        TS_ASSERT_EQUALS(values.size(), 2u);
+        TS_ASSERT_DELTA(values[0], table.LookUp(0u, 0.75), 1e-12);
+        TS_ASSERT_DELTA(values[1], table.LookUp(1u, 0.75), 1e-12);
+
+        // Making the table finer makes it more accurate
+        table.SetTableProperties(0.0, 0.001, 2.0);
+        TS_ASSERT_DELTA(table.LookUp(1u, 1.2345), exp(1.2345), 1e-6);
+    }
+
+    void TestBoundsAndExceptions()
+    {
+        UnivariateLookupTable table("x", -1.0, 0.25, 1.0);
+        table.AddFunction(&Square);
+
+        TS_ASSERT_THROWS_THIS(table.LookUp(0u, 1.5), "x = 1.5 outside lookup table range [-1, 1]");
+        std::vector<double> values;
+        TS_ASSERT_THROWS_THIS(table.LookUpAll(-2.0, values), "x = -2 outside lookup table range [-1, 1]");
+
+        table.SetClampToBounds();
+        TS_ASSERT_DELTA(table.LookUp(0u, 1.5), 1.0, 1e-12);
+        TS_ASSERT_DELTA(table.LookUp(0u, -2.0), 1.0, 1e-12);
+
+        TS_ASSERT_THROWS_THIS(table.SetTableProperties(0.0, 0.3, 1.0),
+                              "Table step size does not divide range between table limits.");
+        TS_ASSERT_THROWS_THIS(UnivariateLookupTable bad_table("x", 1.0, 0.1, 0.0),
+                              "Table step must be positive and the upper table limit must exceed the lower one.");
+    }
+
+    void TestUseInOdeSystem()
+    {
+        LookupTableOde ode;
+        RungeKutta4IvpOdeSolver solver;
+        std::vector<double> state = ode.GetInitialConditions();
+        solver.Solve(&ode, state, 0.0, 2.0, 0.01);
+        TS_ASSERT_DELTA(state[0], -log(3.0), 1e-6);
+    }
+};
+
+#endif // _TESTUNIVARIATELOOKUPTABLE_HPP_
@@ -213,7 +213,7 @@ double AbstractFunctionalCalculator<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::Calcul
     PetscTools::ReplicateException(false);
 
     double final_result;
-    MPI_Allreduce(&local_result, &final_result, 1, MPI_DOUBLE, MPI_SUM, PETSC_COMM_WORLD);
+    MPI_Allreduce(&local_result, &final_result, 1, MPI_DOUBLE, MPI_SUM, PetscTools::GetWorld());
     return final_result;
 }
 
@@ -84,6 +84,18 @@ public:
     {
     }
 
+    /** @return the minimum timestep to be used */
+    double GetMinimumTimeStep() const
+    {
+        return mMinimumTimeStep;
+    }
+
+    /** @return the maximum timestep to be used */
+    double GetMaximumTimeStep() const
+    {
+        return mMaximumTimeStep;
+    }
+
     /**
      * @return the actual timestep to be used.
      *
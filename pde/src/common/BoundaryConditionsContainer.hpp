@@ -38,6 +38,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <set>
 #include <map>
+#include <vector>
 #include "ChasteSerialization.hpp"
 #include <boost/serialization/split_member.hpp>
 #include <boost/serialization/map.hpp>
@@ -52,6 +53,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ChastePoint.hpp"
 #include "ConstBoundaryCondition.hpp"
 #include "DistributedVectorFactory.hpp"
+#include "ReplicatableVector.hpp"
 
 /**
  * Boundary Conditions Container.
@@ -61,6 +63,14 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  * elements on the Neumann boundary and associated Neumann boundary
  * conditions.
  *
+ * When applying Dirichlet conditions the maps are not traversed:
+ * the global rows and values are cached in dense arrays, which are
+ * rebuilt only when a Dirichlet condition is added. Only the values
+ * of conditions that are not ConstBoundaryConditions are recomputed
+ * on each application. Constant conditions can be shared via
+ * GetConstantBoundaryCondition(), so that one object is created per
+ * distinct value rather than per node.
+ *
  * \todo #1321
  * Various operations are currently very inefficient - there is
  * certainly scope for optimisation here!
@@ -115,6 +125,86 @@ class BoundaryConditionsContainer :
    */
   bool mLoadedFromArchive;
 
+  /**
+   * Shared constant boundary conditions, one per value, created by
+   * GetConstantBoundaryCondition(). These are owned by this container
+   * (whatever the deleteConditions constructor argument).
+   */
+  std::map<double, ConstBoundaryCondition<SPACE_DIM>*> mConstantConditions;
+
+  /**
+   * Whether #mDirichletRows and #mDirichletValues reflect the current
+   * Dirichlet maps.
+   */
+  bool mDirichletArraysUpToDate;
+
+  /**
+   * The global row (PROBLEM_DIM*node_index + index_of_unknown) of each
+   * locally known Dirichlet condition, ordered by unknown and then by
+   * node index.
+   */
+  std::vector<unsigned> mDirichletRows;
+
+  /** The value of each condition in #mDirichletRows. */
+  std::vector<double> mDirichletValues;
+
+  /**
+   * The conditions for unknown i are entries mDirichletUnknownOffsets[i]
+   * to mDirichletUnknownOffsets[i+1]-1 of #mDirichletRows.
+   */
+  unsigned mDirichletUnknownOffsets[PROBLEM_DIM+1];
+
+  /**
+   * The entries of #mDirichletRows whose conditions are not constant, so
+   * whose values are recomputed whenever the conditions are applied.
+   */
+  std::vector<unsigned> mNonConstantDirichletEntries;
+
+  /**
+   * The node and condition for each entry of #mNonConstantDirichletEntries.
+   */
+  std::vector<std::pair<const Node<SPACE_DIM>*,
+      const AbstractBoundaryCondition<SPACE_DIM>*> >
+      mNonConstantDirichletConditions;
+
+  /**
+   * Whether #mLiftingRows etc. hold the Dirichlet columns of the matrix
+   * to which conditions were last applied symmetrically.
+   */
+  bool mHaveDirichletLifting;
+
+  /**
+   * The locally owned rows of the entries removed from the matrix when
+   * Dirichlet conditions were last applied symmetrically. Together with
+   * #mLiftingColumns and #mLiftingCoefficients this is the sparse
+   * operator mapping boundary values to the RHS correction.
+   */
+  std::vector<unsigned> mLiftingRows;
+
+  /** The column (boundary row) of each entry in #mLiftingRows. */
+  std::vector<unsigned> mLiftingColumns;
+
+  /** The matrix value of each entry in #mLiftingRows. */
+  std::vector<double> mLiftingCoefficients;
+
+  /**
+   * Set the Dirichlet boundary conditions vector of a symmetric system
+   * to minus the stored matrix columns times the given boundary values.
+   *
+   * @param bcsVector the vector to set
+   * @param rDirichletValues the boundary value for each global row
+   *        (entries for rows without conditions are not read)
+   */
+  void ApplyDirichletLifting(Vec bcsVector,
+      ReplicatableVector& rDirichletValues);
+
+  /**
+   * Bring the dense Dirichlet arrays up to date: rebuild them from the
+   * Dirichlet maps if a condition has been added since they were last
+   * built, and recompute the values of non-constant conditions.
+   */
+  void UpdateDirichletArrays();
+
  public:
   /**
    * Constructor calls base constuctor and allocates memory for the
@@ -152,6 +242,33 @@ class BoundaryConditionsContainer :
     , unsigned indexOfUnknown = 0
     , bool checkIfBoundaryNode = true);
 
+  /**
+   * Add constant Dirichlet boundary conditions on many nodes at once.
+   * The conditions are shared ConstBoundaryConditions (see
+   * GetConstantBoundaryCondition()), so no object is created per node.
+   *
+   * @param rBoundaryNodes Pointers to nodes on the boundary.
+   * @param rValues The value of the condition at each node.
+   * @param indexOfUnknown defaults to 0
+   * @param checkIfBoundaryNode defaults to true
+   */
+  void AddConstantDirichletBoundaryConditions(
+      const std::vector<const Node<SPACE_DIM>*>& rBoundaryNodes
+    , const std::vector<double>& rValues
+    , unsigned indexOfUnknown = 0
+    , bool checkIfBoundaryNode = true);
+
+  /**
+   * @return a constant boundary condition with the given value, owned
+   *         by this container and shared by every caller asking for the
+   *         same value. It may be passed to any of the Add methods, and
+   *         must not be deleted by the caller.
+   *
+   * @param value the value of the condition
+   */
+  const ConstBoundaryCondition<SPACE_DIM>* GetConstantBoundaryCondition(
+      double value);
+
   /**
    * Add a Neumann boundary condition specifying two parameters, a
    * pointer to a surface element, and a pointer to a boundary
@@ -247,6 +364,12 @@ class BoundaryConditionsContainer :
    *        time steps.
    * @param applyToRhsVector Similarly, whether to apply the changes to
    *        the RHS vector (b in Ax=b).
+   *
+   * When the matrix is symmetric, the columns removed from it are stored,
+   * so that if the conditions are later applied to the RHS vector only,
+   * the correction for the removed columns is recomputed from the current
+   * boundary values (when any condition is not constant) without any
+   * further column operations on the matrix.
    */
   void ApplyDirichletToLinearProblem(
       LinearSystem& rLinearSystem
@@ -56,6 +56,8 @@ BoundaryConditionsContainer<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
             PROBLEM_DIM>(deleteConditions)
 {
   mLoadedFromArchive = false;
+  mDirichletArraysUpToDate = false;
+  mHaveDirichletLifting = false;
 
   for (unsigned index_of_unknown = 0; index_of_unknown < PROBLEM_DIM;
       ++index_of_unknown) {
@@ -80,8 +82,14 @@ template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
 BoundaryConditionsContainer<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
     ~BoundaryConditionsContainer()
 {
-  // Keep track of what boundary condition objects we've deleted
+  // Keep track of what boundary condition objects we've deleted.
+  // Shared constant conditions are deleted separately below.
   std::set<const AbstractBoundaryCondition<SPACE_DIM>*> deleted_conditions;
+  for (typename std::map<double, ConstBoundaryCondition<SPACE_DIM>*>::
+      iterator it = mConstantConditions.begin();
+      it != mConstantConditions.end(); ++it) {
+    deleted_conditions.insert(it->second);
+  }
   for (unsigned i = 0; i < PROBLEM_DIM; ++i) {
     NeumannMapIterator neumann_iterator = mpNeumannMap[i]->begin();
     while (neumann_iterator != mpNeumannMap[i]->end()) {
@@ -102,6 +110,12 @@ BoundaryConditionsContainer<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
 
   if (this->mDeleteConditions)
       this->DeleteDirichletBoundaryConditions(deleted_conditions);
+
+  for (typename std::map<double, ConstBoundaryCondition<SPACE_DIM>*>::
+      iterator it = mConstantConditions.begin();
+      it != mConstantConditions.end(); ++it) {
+    delete it->second;
+  }
 }
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
@@ -117,6 +131,81 @@ void BoundaryConditionsContainer<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
 
   (*(this->mpDirichletMap[indexOfUnknown]))[pBoundaryNode] =
       pBoundaryCondition;
+  mDirichletArraysUpToDate = false;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
+void BoundaryConditionsContainer<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
+    AddConstantDirichletBoundaryConditions(
+        const std::vector<const Node<SPACE_DIM>*>& rBoundaryNodes
+      , const std::vector<double>& rValues
+      , unsigned indexOfUnknown
+      , bool checkIfBoundaryNode)
+{
+  assert(rBoundaryNodes.size() == rValues.size());
+  for (unsigned i = 0; i < rBoundaryNodes.size(); ++i) {
+    AddDirichletBoundaryCondition(rBoundaryNodes[i],
+        GetConstantBoundaryCondition(rValues[i]), indexOfUnknown,
+        checkIfBoundaryNode);
+  }
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
+const ConstBoundaryCondition<SPACE_DIM>*
+    BoundaryConditionsContainer<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
+    GetConstantBoundaryCondition(double value)
+{
+  ConstBoundaryCondition<SPACE_DIM>*& rp_condition =
+      mConstantConditions[value];
+  if (rp_condition == nullptr)
+      rp_condition = new ConstBoundaryCondition<SPACE_DIM>(value);
+  return rp_condition;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
+void BoundaryConditionsContainer<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
+    UpdateDirichletArrays()
+{
+  if (!mDirichletArraysUpToDate) {
+    unsigned num_conditions = 0;
+    for (unsigned index_of_unknown = 0; index_of_unknown < PROBLEM_DIM;
+        ++index_of_unknown) {
+      num_conditions += this->mpDirichletMap[index_of_unknown]->size();
+    }
+    mDirichletRows.resize(num_conditions);
+    mDirichletValues.resize(num_conditions);
+    mNonConstantDirichletEntries.clear();
+    mNonConstantDirichletConditions.clear();
+
+    unsigned entry = 0;
+    for (unsigned index_of_unknown = 0; index_of_unknown < PROBLEM_DIM;
+        ++index_of_unknown) {
+      mDirichletUnknownOffsets[index_of_unknown] = entry;
+      for (typename BaseClassType::DirichletIteratorType it =
+          this->mpDirichletMap[index_of_unknown]->begin();
+          it != this->mpDirichletMap[index_of_unknown]->end(); ++it) {
+        mDirichletRows[entry] =
+            PROBLEM_DIM*it->first->GetIndex() + index_of_unknown;
+        mDirichletValues[entry] = it->second->GetValue(
+            it->first->GetPoint());
+        if (dynamic_cast<const ConstBoundaryCondition<SPACE_DIM>*>(
+            it->second) == nullptr) {
+          mNonConstantDirichletEntries.push_back(entry);
+          mNonConstantDirichletConditions.push_back(*it);
+        }
+        ++entry;
+      }
+    }
+    mDirichletUnknownOffsets[PROBLEM_DIM] = entry;
+    mDirichletArraysUpToDate = true;
+  }
+  else {
+    for (unsigned i = 0; i < mNonConstantDirichletEntries.size(); ++i) {
+      mDirichletValues[mNonConstantDirichletEntries[i]] =
+          mNonConstantDirichletConditions[i].second->GetValue(
+              mNonConstantDirichletConditions[i].first->GetPoint());
+    }
+  }
 }
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
@@ -201,8 +290,8 @@ void BoundaryConditionsContainer<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
   // the boundary exists
   assert(PetscTools::ReplicateBool(pMesh->GetNumBoundaryNodes() > 0));
 
-  ConstBoundaryCondition<SPACE_DIM>* p_boundary_condition =
-      new ConstBoundaryCondition<SPACE_DIM>(value);
+  const ConstBoundaryCondition<SPACE_DIM>* p_boundary_condition =
+      GetConstantBoundaryCondition(value);
 
   typename AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::
       BoundaryNodeIterator iter;
@@ -225,8 +314,8 @@ void BoundaryConditionsContainer<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
   // In applying a condition to the boundary, we need to be sure that
   // the boundary exists
   assert(pMesh->GetNumBoundaryElements() > 0);
-  ConstBoundaryCondition<SPACE_DIM>* p_zero_boundary_condition =
-      new ConstBoundaryCondition<SPACE_DIM>(0.0);
+  const ConstBoundaryCondition<SPACE_DIM>* p_zero_boundary_condition =
+      GetConstantBoundaryCondition(0.0);
 
   typename AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::
       BoundaryElementIterator iter;
@@ -283,6 +372,8 @@ void BoundaryConditionsContainer<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
 {
   HeartEventHandler::BeginEvent(HeartEventHandler::DIRICHLET_BCS);
 
+  UpdateDirichletArrays();
+
   if (applyToMatrix) {
     if (!this->HasDirichletBoundaryConditions()) {
       // Short-circuit the replication if there are no conditions
@@ -304,8 +395,8 @@ void BoundaryConditionsContainer<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
           VecDuplicate(rLinearSystem.rGetRhsVector(), &r_bcs_vec);
       PetscVecTools::Zero(r_bcs_vec);
       /*
-       * If the matrix is symmetric, calls to GetMatrixRowDistributed()
-       * require the matrix to be in assembled state. Otherwise we can
+       * If the matrix is symmetric, reading its columns with
+       * GetEntriesInColumns() requires it to be in assembled state. Otherwise we can
        * defer it.
        */
       rLinearSystem.AssembleFinalLinearSystem();
@@ -325,23 +416,9 @@ void BoundaryConditionsContainer<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
     // there's a condition
     for (unsigned i = lo; i < hi; ++i) dirichlet_conditions[i] = DBL_MAX;
     // Now fill in the ones we know
-    for (unsigned index_of_unknown = 0; index_of_unknown < PROBLEM_DIM;
-        ++index_of_unknown) {
-      this->mDirichIterator =
-          this->mpDirichletMap[index_of_unknown]->begin();
-
-      while (this->mDirichIterator !=
-          this->mpDirichletMap[index_of_unknown]->end()) {
-        unsigned node_index = this->mDirichIterator->first->GetIndex();
-        double value = this->mDirichIterator->second->GetValue(
-            this->mDirichIterator->first->GetPoint());
-        assert(value != DBL_MAX);
-
-        unsigned row = PROBLEM_DIM*node_index + index_of_unknown;
-        dirichlet_conditions[row] = value;
-
-        this->mDirichIterator++;
-      }
+    for (unsigned i = 0; i < mDirichletRows.size(); ++i) {
+      assert(mDirichletValues[i] != DBL_MAX);
+      dirichlet_conditions[mDirichletRows[i]] = mDirichletValues[i];
     }
 
     // And replicate
@@ -354,36 +431,24 @@ void BoundaryConditionsContainer<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
     }
 
     if (matrix_is_symmetric) {
-      // Modify the matrix columns
-      for (unsigned i = 0; i < rows_to_zero.size(); ++i) {
-        unsigned col = rows_to_zero[i];
-        double minus_value = -dirichlet_conditions[col];
-
-        /*
-         * Get a vector which will store the column of the matrix
-         * (column d, where d is the index of the row (and column) to
-         * be altered for the boundary condition. Since the matrix is
-         * symmetric when get row number "col" and treat it as a
-         * column. PETSc uses compressed row format and therefore
-         * getting rows is far more efficient than getting columns.
-         */
-        Vec matrix_col = rLinearSystem.GetMatrixRowDistributed(col);
-
-        // Zero the correct entry of the column
-        PetscVecTools::SetElement(matrix_col, col, 0.0);
-
-        /*
-         * Set up the RHS Dirichlet boundary conditions vector.
-         * Assuming one boundary at the zeroth node (x_0 = value), this
-         * is equal to
-         *   -value*[0 a_21 a_31 .. a_N1]
-         * and will be added to the RHS.
-         */
-        PetscVecTools::AddScaledVector(
-            rLinearSystem.rGetDirichletBoundaryConditionsVector(),
-            matrix_col, minus_value);
-        PetscTools::Destroy(matrix_col);
-      }
+      /*
+       * Store the entries of the columns to be zeroed (the "lifting" of
+       * the boundary conditions), found in one pass over the local rows.
+       * The RHS Dirichlet boundary conditions vector is then
+       *   -SUM_d v_d a'_d
+       * and can be recomputed from these for new boundary values, without
+       * touching the matrix again.
+       */
+      PetscMatTools::GetEntriesInColumns(rLinearSystem.rGetLhsMatrix(),
+          rows_to_zero, mLiftingRows, mLiftingColumns,
+          mLiftingCoefficients);
+      mHaveDirichletLifting = true;
+      ApplyDirichletLifting(
+          rLinearSystem.rGetDirichletBoundaryConditionsVector(),
+          dirichlet_conditions);
+    }
+    else {
+      mHaveDirichletLifting = false;
     }
 
     /*
@@ -402,6 +467,25 @@ void BoundaryConditionsContainer<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
   }
 
   if (applyToRhsVector) {
+    /*
+     * If the matrix was set up on an earlier call, recompute the RHS
+     * modification for the current boundary values, unless they are all
+     * constant (on every process).
+     */
+    if (!applyToMatrix && mHaveDirichletLifting &&
+        PetscTools::ReplicateBool(!mNonConstantDirichletEntries.empty())) {
+      ReplicatableVector dirichlet_values(rLinearSystem.GetSize());
+      PetscInt lo, hi;
+      rLinearSystem.GetOwnershipRange(lo, hi);
+      for (unsigned i = 0; i < mDirichletRows.size(); ++i) {
+        dirichlet_values[mDirichletRows[i]] = mDirichletValues[i];
+      }
+      dirichlet_values.Replicate(lo, hi);
+      ApplyDirichletLifting(
+          rLinearSystem.rGetDirichletBoundaryConditionsVector(),
+          dirichlet_values);
+    }
+
     // Apply the RHS boundary conditions modification if required.
     if (rLinearSystem.rGetDirichletBoundaryConditionsVector()) {
       PetscVecTools::AddScaledVector(rLinearSystem.rGetRhsVector(),
@@ -412,27 +496,32 @@ void BoundaryConditionsContainer<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
      * Apply the actual boundary condition to the RHS, note this must be
      * done after the modification to the RHS vector.
      */
-    for (unsigned index_of_unknown = 0; index_of_unknown < PROBLEM_DIM;
-        ++index_of_unknown) {
-      this->mDirichIterator =
-          this->mpDirichletMap[index_of_unknown]->begin();
+    rLinearSystem.SetRhsVectorElements(mDirichletRows, mDirichletValues);
+  }
 
-      while (this->mDirichIterator !=
-          this->mpDirichletMap[index_of_unknown]->end()) {
-        unsigned node_index = this->mDirichIterator->first->GetIndex();
-        double value = this->mDirichIterator->second->GetValue(
-            this->mDirichIterator->first->GetPoint());
+  HeartEventHandler::EndEvent(HeartEventHandler::DIRICHLET_BCS);
+}
 
-        unsigned row = PROBLEM_DIM*node_index + index_of_unknown;
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
+void BoundaryConditionsContainer<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
+    ApplyDirichletLifting(
+        Vec bcsVector
+      , ReplicatableVector& rDirichletValues)
+{
+  PetscInt lo, hi;
+  PetscVecTools::GetOwnershipRange(bcsVector, lo, hi);
 
-        rLinearSystem.SetRhsVectorElement(row, value);
+  std::vector<unsigned> local_rows(hi - lo);
+  std::vector<double> local_values(hi - lo, 0.0);
+  for (PetscInt row = lo; row < hi; ++row) local_rows[row - lo] = row;
 
-        this->mDirichIterator++;
-      }
-    }
+  for (unsigned i = 0; i < mLiftingRows.size(); ++i) {
+    local_values[mLiftingRows[i] - lo] -= mLiftingCoefficients[i]*
+        rDirichletValues[mLiftingColumns[i]];
   }
 
-  HeartEventHandler::EndEvent(HeartEventHandler::DIRICHLET_BCS);
+  PetscVecTools::SetElements(bcsVector, local_rows, local_values);
+  PetscVecTools::Finalise(bcsVector);
 }
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
@@ -507,31 +596,26 @@ void BoundaryConditionsContainer<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
       , Vec residual
       , DistributedVectorFactory& rFactory)
 {
+  UpdateDirichletArrays();
+
   for (unsigned index_of_unknown = 0; index_of_unknown < PROBLEM_DIM;
       ++index_of_unknown) {
-    this->mDirichIterator = this->mpDirichletMap[index_of_unknown]->begin();
-
     DistributedVector solution_distributed =
         rFactory.CreateDistributedVector(currentSolution, true/*Read-only*/);
     DistributedVector residual_distributed =
         rFactory.CreateDistributedVector(residual);
-
-
-    while (this->mDirichIterator !=
-        this->mpDirichletMap[index_of_unknown]->end()) {
-      DistributedVector::Stripe solution_stripe(solution_distributed,
-          index_of_unknown);
-      DistributedVector::Stripe residual_stripe(residual_distributed,
-          index_of_unknown);
-
-      unsigned node_index = this->mDirichIterator->first->GetIndex();
-
-      double value = this->mDirichIterator->second->GetValue(
-          this->mDirichIterator->first->GetPoint());
-
-      if (solution_distributed.IsGlobalIndexLocal(node_index))
-          residual_stripe[node_index] = solution_stripe[node_index] - value;
-      this->mDirichIterator++;
+    DistributedVector::Stripe solution_stripe(solution_distributed,
+        index_of_unknown);
+    DistributedVector::Stripe residual_stripe(residual_distributed,
+        index_of_unknown);
+
+    for (unsigned i = mDirichletUnknownOffsets[index_of_unknown];
+        i < mDirichletUnknownOffsets[index_of_unknown + 1]; ++i) {
+      unsigned node_index = mDirichletRows[i]/PROBLEM_DIM;
+      if (solution_distributed.IsGlobalIndexLocal(node_index)) {
+        residual_stripe[node_index] = solution_stripe[node_index] -
+            mDirichletValues[i];
+      }
     }
     // Don't restore the read-only one: solution_distributed.Restore();
     residual_distributed.Restore();
@@ -542,29 +626,10 @@ template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
 void BoundaryConditionsContainer<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
     ApplyDirichletToNonlinearJacobian(Mat jacobian)
 {
-  unsigned num_boundary_conditions = 0;
-  for (unsigned index_of_unknown = 0; index_of_unknown < PROBLEM_DIM;
-      ++index_of_unknown) {
-    num_boundary_conditions +=
-        this->mpDirichletMap[index_of_unknown]->size();
-  }
-
-  std::vector<unsigned> rows_to_zero(num_boundary_conditions);
+  UpdateDirichletArrays();
 
-  unsigned counter = 0;
-  for (unsigned index_of_unknown = 0; index_of_unknown < PROBLEM_DIM;
-      ++index_of_unknown) {
-    this->mDirichIterator = this->mpDirichletMap[index_of_unknown]->begin();
-
-    while (this->mDirichIterator !=
-        this->mpDirichletMap[index_of_unknown]->end()) {
-      unsigned node_index = this->mDirichIterator->first->GetIndex();
-      rows_to_zero[counter++] = PROBLEM_DIM * node_index + index_of_unknown;
-      this->mDirichIterator++;
-    }
-  }
   PetscMatTools::Finalise(jacobian);
-  PetscMatTools::ZeroRowsWithValueOnDiagonal(jacobian, rows_to_zero, 1.0);
+  PetscMatTools::ZeroRowsWithValueOnDiagonal(jacobian, mDirichletRows, 1.0);
 }
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
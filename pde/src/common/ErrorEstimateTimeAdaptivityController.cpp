@@ -0,0 +1,199 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include <algorithm>
+#include <cmath>
+
+#include "ErrorEstimateTimeAdaptivityController.hpp"
+#include "Exception.hpp"
+#include "PetscTools.hpp"
+
+ErrorEstimateTimeAdaptivityController::ErrorEstimateTimeAdaptivityController(double minimumTimeStep,
+                                                                             double maximumTimeStep,
+                                                                             double initialTimeStep,
+                                                                             double absoluteTolerance,
+                                                                             double relativeTolerance)
+    : AbstractTimeAdaptivityController(minimumTimeStep, maximumTimeStep),
+      mInitialTimeStep(initialTimeStep),
+      mAbsoluteTolerance(absoluteTolerance),
+      mRelativeTolerance(relativeTolerance),
+      mSafetyFactor(0.9),
+      mMinimumFactor(0.2),
+      mMaximumFactor(2.0),
+      mPreviousSolution(nullptr),
+      mPreviousSlope(nullptr),
+      mWorkVector(nullptr),
+      mPreviousTime(0.0),
+      mPreviousStepSize(0.0),
+      mLastTimeStep(initialTimeStep),
+      mLastErrorRatio(-1.0)
+{
+    if (initialTimeStep <= 0.0)
+    {
+        EXCEPTION("Initial time step has to be greater than zero");
+    }
+    if (absoluteTolerance < 0.0 || relativeTolerance < 0.0 || absoluteTolerance + relativeTolerance <= 0.0)
+    {
+        EXCEPTION("Tolerances must be non-negative, and not both zero");
+    }
+}
+
+ErrorEstimateTimeAdaptivityController::~ErrorEstimateTimeAdaptivityController()
+{
+    Reset();
+}
+
+void ErrorEstimateTimeAdaptivityController::SetStepChangeFactors(double minimumFactor, double maximumFactor)
+{
+    if (minimumFactor <= 0.0 || minimumFactor > 1.0 || maximumFactor < 1.0)
+    {
+        EXCEPTION("Step change factors must satisfy 0 < minimum <= 1 <= maximum");
+    }
+    mMinimumFactor = minimumFactor;
+    mMaximumFactor = maximumFactor;
+}
+
+void ErrorEstimateTimeAdaptivityController::SetSafetyFactor(double safetyFactor)
+{
+    if (safetyFactor <= 0.0 || safetyFactor > 1.0)
+    {
+        EXCEPTION("Safety factor must be in (0, 1]");
+    }
+    mSafetyFactor = safetyFactor;
+}
+
+double ErrorEstimateTimeAdaptivityController::GetLastErrorRatio() const
+{
+    return mLastErrorRatio;
+}
+
+void ErrorEstimateTimeAdaptivityController::Reset()
+{
+    if (mPreviousSolution)
+    {
+        PetscTools::Destroy(mPreviousSolution);
+        mPreviousSolution = nullptr;
+    }
+    if (mPreviousSlope)
+    {
+        PetscTools::Destroy(mPreviousSlope);
+        mPreviousSlope = nullptr;
+    }
+    if (mWorkVector)
+    {
+        PetscTools::Destroy(mWorkVector);
+        mWorkVector = nullptr;
+    }
+    mLastTimeStep = mInitialTimeStep;
+    mLastErrorRatio = -1.0;
+}
+
+double ErrorEstimateTimeAdaptivityController::ComputeTimeStep(double currentTime, Vec currentSolution)
+{
+    if (mPreviousSolution)
+    {
+        if (fabs(currentTime - mPreviousTime) <= 1e-12*std::max(1.0, fabs(currentTime)))
+        {
+            // Asked again about the same step (e.g. at the start of the next call to Solve())
+            return mLastTimeStep;
+        }
+        PetscInt current_size, previous_size;
+        VecGetSize(currentSolution, &current_size);
+        VecGetSize(mPreviousSolution, &previous_size);
+        if (currentTime < mPreviousTime || current_size != previous_size)
+        {
+            // A new simulation, or a new mesh
+            Reset();
+        }
+    }
+
+    if (!mPreviousSolution)
+    {
+        // Only the initial condition so far
+        VecDuplicate(currentSolution, &mPreviousSolution);
+        VecCopy(currentSolution, mPreviousSolution);
+        mPreviousTime = currentTime;
+        mLastTimeStep = std::min(std::max(mInitialTimeStep, GetMinimumTimeStep()), GetMaximumTimeStep());
+        return mLastTimeStep;
+    }
+
+    // Slope over the step just taken
+    double dt = currentTime - mPreviousTime;
+    if (!mWorkVector)
+    {
+        VecDuplicate(currentSolution, &mWorkVector);
+    }
+    VecWAXPY(mWorkVector, -1.0, mPreviousSolution, currentSolution);
+    VecScale(mWorkVector, 1.0/dt);
+
+    if (mPreviousSlope)
+    {
+        // The local error is about (dt^2/2)|u''|, with u'' estimated from the change in slope
+        VecAXPY(mPreviousSlope, -1.0, mWorkVector);
+        double slope_change;
+        VecNorm(mPreviousSlope, NORM_INFINITY, &slope_change);
+        double error = dt*dt*slope_change/(dt + mPreviousStepSize);
+
+        double solution_norm;
+        VecNorm(currentSolution, NORM_INFINITY, &solution_norm);
+        mLastErrorRatio = error/(mAbsoluteTolerance + mRelativeTolerance*solution_norm);
+
+        /*
+         * The error scales with dt^2, so the optimal step is dt*sqrt(1/ratio).
+         * This doesn't depend on the size of the step just taken, which may
+         * have been trimmed to hit an end time, so the change is limited
+         * relative to the last timestep suggested instead.
+         */
+        double new_dt = mLastTimeStep*mMaximumFactor;
+        if (mLastErrorRatio > 0.0)
+        {
+            new_dt = std::min(new_dt, mSafetyFactor*dt/sqrt(mLastErrorRatio));
+        }
+        new_dt = std::max(new_dt, mLastTimeStep*mMinimumFactor);
+        mLastTimeStep = std::min(std::max(new_dt, GetMinimumTimeStep()), GetMaximumTimeStep());
+    }
+    else
+    {
+        VecDuplicate(currentSolution, &mPreviousSlope);
+    }
+
+    // Keep this step's slope and solution for next time
+    std::swap(mPreviousSlope, mWorkVector);
+    VecCopy(currentSolution, mPreviousSolution);
+    mPreviousTime = currentTime;
+    mPreviousStepSize = dt;
+
+    return mLastTimeStep;
+}
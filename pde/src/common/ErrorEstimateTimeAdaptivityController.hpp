@@ -0,0 +1,154 @@
+/*
+
+Copyright (c) 2005-2018, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef ERRORESTIMATETIMEADAPTIVITYCONTROLLER_HPP_
+#define ERRORESTIMATETIMEADAPTIVITYCONTROLLER_HPP_
+
+#include "AbstractTimeAdaptivityController.hpp"
+
+/**
+ * A time adaptivity controller which chooses the timestep from an estimate of
+ * the local truncation error, computed from successive solutions.
+ *
+ * For a first order (backward Euler) time discretisation the local error of a
+ * step of size dt is about (dt^2/2)|u''|. The second derivative is estimated by
+ * differencing the slopes of the last two steps, and the next timestep is the
+ * last one scaled by safety*sqrt(tolerance/error), with the change in each step
+ * limited to a given range of factors. The tolerance is
+ * absoluteTolerance + relativeTolerance*|u|, using infinity norms.
+ *
+ * Until three solutions have been seen the initial timestep is used. The
+ * controller keeps a copy of the previous solution and of the previous slope. It is designed to be
+ * called once per timestep, as AbstractDynamicLinearPdeSolver does; repeated
+ * calls at the same time return the same timestep, and calls at an earlier
+ * time or with a solution of a different size start afresh.
+ */
+class ErrorEstimateTimeAdaptivityController : public AbstractTimeAdaptivityController
+{
+private:
+
+    /** The timestep to use while there is too little history to estimate the error. */
+    double mInitialTimeStep;
+
+    /** Absolute tolerance on the local error. */
+    double mAbsoluteTolerance;
+
+    /** Relative tolerance on the local error. */
+    double mRelativeTolerance;
+
+    /** Factor applied to the optimal timestep to make rejections of the estimate unlikely. */
+    double mSafetyFactor;
+
+    /** Smallest factor by which the timestep may change from one step to the next. */
+    double mMinimumFactor;
+
+    /** Largest factor by which the timestep may change from one step to the next. */
+    double mMaximumFactor;
+
+    /** The solution at the last call; null until the first call. */
+    Vec mPreviousSolution;
+
+    /** The slope (u_n - u_{n-1})/dt over the last step; null until two calls have been made. */
+    Vec mPreviousSlope;
+
+    /** Work vector for the slope over the step just taken. */
+    Vec mWorkVector;
+
+    /** The time at the last call. */
+    double mPreviousTime;
+
+    /** The size of the step over which mPreviousSlope was computed. */
+    double mPreviousStepSize;
+
+    /** The timestep returned by the last call. */
+    double mLastTimeStep;
+
+    /** The most recent error estimate, relative to the tolerance. */
+    double mLastErrorRatio;
+
+    /**
+     * @return the next timestep, based on the error in the step just taken.
+     *
+     * @param currentTime current time
+     * @param currentSolution current solution
+     */
+    double ComputeTimeStep(double currentTime, Vec currentSolution);
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param minimumTimeStep minimum timestep to be used
+     * @param maximumTimeStep maximum timestep to be used
+     * @param initialTimeStep timestep to use while the error cannot yet be estimated
+     * @param absoluteTolerance absolute tolerance on the local error per step
+     * @param relativeTolerance relative tolerance on the local error per step
+     */
+    ErrorEstimateTimeAdaptivityController(double minimumTimeStep,
+                                          double maximumTimeStep,
+                                          double initialTimeStep,
+                                          double absoluteTolerance,
+                                          double relativeTolerance=0.0);
+
+    /** Destructor. Frees the stored solutions. */
+    ~ErrorEstimateTimeAdaptivityController();
+
+    /**
+     * Set the range of factors by which the timestep may change between steps.
+     *
+     * @param minimumFactor smallest factor (defaults to 0.2)
+     * @param maximumFactor largest factor (defaults to 2.0)
+     */
+    void SetStepChangeFactors(double minimumFactor, double maximumFactor);
+
+    /**
+     * Set the safety factor applied to the optimal timestep.
+     *
+     * @param safetyFactor the factor (defaults to 0.9)
+     */
+    void SetSafetyFactor(double safetyFactor);
+
+    /**
+     * @return the most recent error estimate divided by the tolerance, or a
+     * negative number if no estimate has been made yet
+     */
+    double GetLastErrorRatio() const;
+
+    /** Forget the stored solutions, so the next call starts with the initial timestep. */
+    void Reset();
+};
+
+#endif /*ERRORESTIMATETIMEADAPTIVITYCONTROLLER_HPP_*/
@@ -35,12 +35,23 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "FineCoarseMeshPair.hpp"
 
+#include <cfloat>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include "DistributedTetrahedralMesh.hpp"
+#include "FileFinder.hpp"
+#include "OutputFileHandler.hpp"
+
 template <unsigned DIM>
 FineCoarseMeshPair<DIM>::FineCoarseMeshPair(AbstractTetrahedralMesh<DIM,DIM>& rFineMesh, AbstractTetrahedralMesh<DIM,DIM>& rCoarseMesh)
     : mrFineMesh(rFineMesh),
       mrCoarseMesh(rCoarseMesh),
       mpFineMeshBoxCollection(nullptr),
-      mpCoarseMeshBoxCollection(nullptr)
+      mpCoarseMeshBoxCollection(nullptr),
+      mpFineMeshHierarchy(nullptr),
+      mpCoarseMeshHierarchy(nullptr)
 {
     ResetStatisticsVariables();
 }
@@ -72,6 +83,11 @@ void FineCoarseMeshPair<DIM>::DeleteFineBoxCollection()
         delete mpFineMeshBoxCollection;
         mpFineMeshBoxCollection = nullptr;
     }
+    if (mpFineMeshHierarchy != nullptr)
+    {
+        delete mpFineMeshHierarchy;
+        mpFineMeshHierarchy = nullptr;
+    }
 }
 
 template <unsigned DIM>
@@ -82,6 +98,11 @@ void FineCoarseMeshPair<DIM>::DeleteCoarseBoxCollection()
         delete mpCoarseMeshBoxCollection;
         mpCoarseMeshBoxCollection = nullptr;
     }
+    if (mpCoarseMeshHierarchy != nullptr)
+    {
+        delete mpCoarseMeshHierarchy;
+        mpCoarseMeshHierarchy = nullptr;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////////
@@ -91,25 +112,31 @@ void FineCoarseMeshPair<DIM>::DeleteCoarseBoxCollection()
 template <unsigned DIM>
 void FineCoarseMeshPair<DIM>::SetUpBoxesOnFineMesh(double boxWidth)
 {
-    SetUpBoxes(mrFineMesh, boxWidth, mpFineMeshBoxCollection);
+    SetUpBoxes(mrFineMesh, boxWidth, mpFineMeshBoxCollection, mpFineMeshHierarchy);
 }
 
 template <unsigned DIM>
 void FineCoarseMeshPair<DIM>::SetUpBoxesOnCoarseMesh(double boxWidth)
 {
-    SetUpBoxes(mrCoarseMesh, boxWidth, mpCoarseMeshBoxCollection);
+    SetUpBoxes(mrCoarseMesh, boxWidth, mpCoarseMeshBoxCollection, mpCoarseMeshHierarchy);
 }
 
 template <unsigned DIM>
 void FineCoarseMeshPair<DIM>::SetUpBoxes(AbstractTetrahedralMesh<DIM, DIM>& rMesh,
                                          double boxWidth,
-                                         DistributedBoxCollection<DIM>*& rpBoxCollection)
+                                         DistributedBoxCollection<DIM>*& rpBoxCollection,
+                                         ElementBoundingVolumeHierarchy<DIM>*& rpHierarchy)
 {
     if (rpBoxCollection)
     {
         delete rpBoxCollection;
         rpBoxCollection = nullptr;
     }
+    if (rpHierarchy)
+    {
+        delete rpHierarchy;
+        rpHierarchy = nullptr;
+    }
 
     // Compute min and max values for the fine mesh nodes
     ChasteCuboid<DIM> bounding_box = rMesh.CalculateBoundingBox();
@@ -151,9 +178,13 @@ void FineCoarseMeshPair<DIM>::SetUpBoxes(AbstractTetrahedralMesh<DIM, DIM>& rMes
     rpBoxCollection->SetupAllLocalBoxes();
 
     // For each element, if ANY of its nodes are physically in a box, put that element in that box
-    for (unsigned i=0; i<rMesh.GetNumElements(); i++)
+    // (with a distributed mesh, only the elements on this process are considered)
+    std::set<unsigned> elements_in_owned_boxes;
+    for (typename AbstractTetrahedralMesh<DIM,DIM>::ElementIterator elem_iter = rMesh.GetElementIteratorBegin();
+         elem_iter != rMesh.GetElementIteratorEnd();
+         ++elem_iter)
     {
-        Element<DIM,DIM>* p_element = rMesh.GetElement(i);
+        Element<DIM,DIM>* p_element = &(*elem_iter);
 
         std::set<unsigned> box_indices_each_node_this_elem;
         for (unsigned j=0; j<DIM+1; j++) // num vertices per element
@@ -173,7 +204,22 @@ void FineCoarseMeshPair<DIM>::SetUpBoxes(AbstractTetrahedralMesh<DIM, DIM>& rMes
             assert(rpBoxCollection->IsBoxOwned( *iter ));
             rpBoxCollection->rGetBox( *iter ).AddElement(p_element);
         }
+        if (!box_indices_each_node_this_elem.empty())
+        {
+            elements_in_owned_boxes.insert(p_element->GetIndex());
+        }
     }
+
+    // Points in owned boxes are located using a hierarchy over the elements in those boxes
+    rpHierarchy = new ElementBoundingVolumeHierarchy<DIM>(rMesh, elements_in_owned_boxes);
+}
+
+template <unsigned DIM>
+void FineCoarseMeshPair<DIM>::SetMappingCacheDirectory(const std::string& rDirectory)
+{
+    // Creates the directory (collectively) if necessary
+    OutputFileHandler handler(rDirectory, false);
+    mMappingCacheDirectory = rDirectory;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////
@@ -195,6 +241,7 @@ void FineCoarseMeshPair<DIM>::ComputeFineElementsAndWeightsForCoarseQuadPoints(G
 
     // Get the quad point (physical) positions
     QuadraturePointsGroup<DIM> quad_point_posns(mrCoarseMesh, rQuadRule);
+    ShareQuadPointPositions(quad_point_posns);
 
     // Resize the elements and weights vector.
     mFineMeshElementsAndWeights.resize(quad_point_posns.Size());
@@ -215,6 +262,16 @@ void FineCoarseMeshPair<DIM>::ComputeFineElementsAndWeightsForCoarseQuadPoints(G
 
 
     ResetStatisticsVariables();
+    std::string cache_file_name = GetMappingCacheFileName("quad", quad_point_posns.Size(), safeMode);
+    if (LoadFineElementDataFromCache(cache_file_name))
+    {
+        if (mStatisticsCounters[1] > 0)
+        {
+            WARNING(mStatisticsCounters[1] << " of " << quad_point_posns.Size() << " coarse-mesh quadrature points were outside the fine mesh");
+        }
+        return;
+    }
+
     for (unsigned i=0; i<quad_point_posns.Size(); i++)
     {
         // LCOV_EXCL_START
@@ -240,6 +297,7 @@ void FineCoarseMeshPair<DIM>::ComputeFineElementsAndWeightsForCoarseQuadPoints(G
         }
     }
     ShareFineElementData();
+    SaveFineElementDataToCache(cache_file_name);
     if (mStatisticsCounters[1] > 0)
     {
         WARNING(mStatisticsCounters[1] << " of " << quad_point_posns.Size() << " coarse-mesh quadrature points were outside the fine mesh");
@@ -272,6 +330,12 @@ void FineCoarseMeshPair<DIM>::ComputeFineElementsAndWeightsForCoarseNodes(bool s
 
 
     ResetStatisticsVariables();
+    std::string cache_file_name = GetMappingCacheFileName("nodes", mrCoarseMesh.GetNumNodes(), safeMode);
+    if (LoadFineElementDataFromCache(cache_file_name))
+    {
+        return;
+    }
+
     for (unsigned i=0; i<mrCoarseMesh.GetNumNodes(); i++)
     {
         // LCOV_EXCL_START
@@ -294,6 +358,7 @@ void FineCoarseMeshPair<DIM>::ComputeFineElementsAndWeightsForCoarseNodes(bool s
         }
     }
     ShareFineElementData();
+    SaveFineElementDataToCache(cache_file_name);
 }
 
 /**
@@ -308,23 +373,18 @@ void FineCoarseMeshPair<DIM>::ComputeFineElementAndWeightForGivenPoint(ChastePoi
                                                                        unsigned boxForThisPoint,
                                                                        unsigned index)
 {
-    std::set<unsigned> test_element_indices;
-
     /*
-     * The elements to try (initially) are those contained in the box the point is in.
-     *
-     * Note: it is possible the point to be in an element not 'in' this box, as it is
-     * possible for all element nodes to be in different boxes.
+     * The elements to try are those whose bounding boxes contain the point, out of
+     * the elements in owned boxes (that is, with a node in an owned box).
      */
-    CollectElementsInContainingBox(mpFineMeshBoxCollection, boxForThisPoint, test_element_indices);
+    std::set<unsigned> test_element_indices;
+    mpFineMeshHierarchy->GetCandidateContainingElements(rPoint.rGetLocation(), test_element_indices);
 
     unsigned elem_index;
     c_vector<double,DIM+1> weight;
 
     try
     {
-        //std::cout << "\n" << "# test elements initially " << test_element_indices.size() << "\n";
-        // Try these elements only, initially
         elem_index = mrFineMesh.GetContainingElementIndex(rPoint,
                                                           false,
                                                           test_element_indices,
@@ -332,62 +392,48 @@ void FineCoarseMeshPair<DIM>::ComputeFineElementAndWeightForGivenPoint(ChastePoi
         weight = mrFineMesh.GetElement(elem_index)->CalculateInterpolationWeights(rPoint);
 
         mStatisticsCounters[0]++;
+        mFineMeshElementsAndWeights[index].ElementNum = elem_index;
+        mFineMeshElementsAndWeights[index].Weights = weight;
+        return;
     }
-    catch(Exception&) //not_in_box
+    catch(Exception&) // not_in_owned_boxes
     {
-        // Now try all elements, trying the elements contained in the boxes local to this element first
-        test_element_indices.clear();
-
-        CollectElementsInLocalBoxes(mpFineMeshBoxCollection, boxForThisPoint, test_element_indices);
+    }
 
+    /*
+     * Only if the hierarchy does not contain every element can the point be in
+     * the rest of the mesh. If safeMode==false, immediately assume it isn't - this
+     * should be the case assuming the box width was chosen suitably.
+     */
+    if (safeMode && mpFineMeshHierarchy->GetNumElements() < mrFineMesh.GetNumElements())
+    {
         try
         {
-            elem_index = mrFineMesh.GetContainingElementIndex(rPoint, false, test_element_indices, true);
+            elem_index = mrFineMesh.GetContainingElementIndex(rPoint, false);
             weight = mrFineMesh.GetElement(elem_index)->CalculateInterpolationWeights(rPoint);
+
             mStatisticsCounters[0]++;
+            mFineMeshElementsAndWeights[index].ElementNum = elem_index;
+            mFineMeshElementsAndWeights[index].Weights = weight;
+            return;
         }
-        catch(Exception&) //not_in_local_boxes
+        catch (Exception&) // not_in_mesh
         {
-            if (safeMode)
-            {
-                // Try the remaining elements
-                try
-                {
-                    elem_index = mrFineMesh.GetContainingElementIndex(rPoint, false);
-                    weight = mrFineMesh.GetElement(elem_index)->CalculateInterpolationWeights(rPoint);
-                    mStatisticsCounters[0]++;
-
-                }
-                catch (Exception&) // not_in_mesh
-                {
-                    // The point is not in ANY element, so store the nearest element and corresponding weights
-                    elem_index = mrFineMesh.GetNearestElementIndexFromTestElements(rPoint,test_element_indices);
-                    weight = mrFineMesh.GetElement(elem_index)->CalculateInterpolationWeights(rPoint);
-
-                    mNotInMesh.push_back(index);
-                    mNotInMeshNearestElementWeights.push_back(weight);
-                    mStatisticsCounters[1]++;
-                }
-            }
-            else
-            {
-                assert(test_element_indices.size() > 0); // boxes probably too small if this fails
-
-                /*
-                 * Immediately assume it isn't in the rest of the mesh - this should be the
-                 * case assuming the box width was chosen suitably. Store the nearest element
-                 * and corresponding weights.
-                 */
-                elem_index = mrFineMesh.GetNearestElementIndexFromTestElements(rPoint,test_element_indices);
-                weight = mrFineMesh.GetElement(elem_index)->CalculateInterpolationWeights(rPoint);
-
-                mNotInMesh.push_back(index);
-                mNotInMeshNearestElementWeights.push_back(weight);
-                mStatisticsCounters[1]++;
-            }
         }
     }
 
+    // The point is not in ANY element, so store the nearest element in the local boxes and corresponding weights
+    test_element_indices.clear();
+    CollectElementsInLocalBoxes(mpFineMeshBoxCollection, boxForThisPoint, test_element_indices);
+    assert(test_element_indices.size() > 0); // boxes probably too small if this fails
+
+    elem_index = mrFineMesh.GetNearestElementIndexFromTestElements(rPoint,test_element_indices);
+    weight = mrFineMesh.GetElement(elem_index)->CalculateInterpolationWeights(rPoint);
+
+    mNotInMesh.push_back(index);
+    mNotInMeshNearestElementWeights.push_back(weight);
+    mStatisticsCounters[1]++;
+
     mFineMeshElementsAndWeights[index].ElementNum = elem_index;
     mFineMeshElementsAndWeights[index].Weights = weight;
 }
@@ -418,6 +464,12 @@ void FineCoarseMeshPair<DIM>::ComputeCoarseElementsForFineNodes(bool safeMode)
     mCoarseElementsForFineNodes.resize(mrFineMesh.GetNumNodes(), 0.0);
 
     ResetStatisticsVariables();
+    std::string cache_file_name = GetMappingCacheFileName("fine_nodes", mCoarseElementsForFineNodes.size(), safeMode);
+    if (LoadCoarseElementDataFromCache(cache_file_name, mCoarseElementsForFineNodes))
+    {
+        return;
+    }
+
     for (unsigned i=0; i<mCoarseElementsForFineNodes.size(); i++)
     {
         // LCOV_EXCL_START
@@ -437,6 +489,7 @@ void FineCoarseMeshPair<DIM>::ComputeCoarseElementsForFineNodes(bool safeMode)
         }
     }
     ShareCoarseElementData();
+    SaveCoarseElementDataToCache(cache_file_name, mCoarseElementsForFineNodes);
 }
 
 template <unsigned DIM>
@@ -458,6 +511,12 @@ void FineCoarseMeshPair<DIM>::ComputeCoarseElementsForFineElementCentroids(bool
     mCoarseElementsForFineElementCentroids.resize(mrFineMesh.GetNumElements(), 0.0);
 
     ResetStatisticsVariables();
+    std::string cache_file_name = GetMappingCacheFileName("fine_centroids", mCoarseElementsForFineElementCentroids.size(), safeMode);
+    if (LoadCoarseElementDataFromCache(cache_file_name, mCoarseElementsForFineElementCentroids))
+    {
+        return;
+    }
+
     for (unsigned i=0; i<mrFineMesh.GetNumElements(); i++)
     {
         // LCOV_EXCL_START
@@ -479,6 +538,7 @@ void FineCoarseMeshPair<DIM>::ComputeCoarseElementsForFineElementCentroids(bool
         }
     }
     ShareCoarseElementData();
+    SaveCoarseElementDataToCache(cache_file_name, mCoarseElementsForFineElementCentroids);
 }
 
 template <unsigned DIM>
@@ -493,63 +553,42 @@ unsigned FineCoarseMeshPair<DIM>::ComputeCoarseElementForGivenPoint(ChastePoint<
      * element, and that method saves information in mStatisticsCounters.
      */
     std::set<unsigned> test_element_indices;
-    CollectElementsInContainingBox(mpCoarseMeshBoxCollection, boxForThisPoint, test_element_indices);
-
-    unsigned elem_index;
+    mpCoarseMeshHierarchy->GetCandidateContainingElements(rPoint.rGetLocation(), test_element_indices);
 
     try
     {
-        elem_index = mrCoarseMesh.GetContainingElementIndex(rPoint,
-                                                            false,
-                                                            test_element_indices,
-                                                            true /* quit if not in test_elements */);
-
+        unsigned elem_index = mrCoarseMesh.GetContainingElementIndex(rPoint,
+                                                                     false,
+                                                                     test_element_indices,
+                                                                     true /* quit if not in test_elements */);
         mStatisticsCounters[0]++;
+        return elem_index;
     }
-    catch(Exception&) // not_in_box
+    catch(Exception&) // not_in_owned_boxes
     {
-        // Now try all elements, trying the elements contained in the boxes local to this element first
-        test_element_indices.clear();
-        CollectElementsInLocalBoxes(mpCoarseMeshBoxCollection, boxForThisPoint, test_element_indices);
+    }
 
+    if (safeMode && mpCoarseMeshHierarchy->GetNumElements() < mrCoarseMesh.GetNumElements())
+    {
         try
         {
-            elem_index = mrCoarseMesh.GetContainingElementIndex(rPoint, false, test_element_indices, true);
+            unsigned elem_index = mrCoarseMesh.GetContainingElementIndex(rPoint, false);
             mStatisticsCounters[0]++;
+            return elem_index;
         }
-        catch(Exception&) // not_in_local_boxes
+        catch (Exception&) // not_in_mesh
         {
-            if (safeMode)
-            {
-                // Try the remaining elements
-                try
-                {
-                    elem_index = mrCoarseMesh.GetContainingElementIndex(rPoint, false);
-
-                    mStatisticsCounters[0]++;
-                }
-                catch (Exception&) // not_in_mesh
-                {
-                    // The point is not in ANY element, so store the nearest element and corresponding weights
-                    elem_index = mrCoarseMesh.GetNearestElementIndexFromTestElements(rPoint,test_element_indices);
-                    mStatisticsCounters[1]++;
-                }
-            }
-            else
-            {
-                assert(test_element_indices.size() > 0); // boxes probably too small if this fails
-
-                /*
-                 * Immediately assume it isn't in the rest of the mesh - this should be the
-                 * case assuming the box width was chosen suitably. Store the nearest element
-                 * and corresponding weights.
-                 */
-                elem_index = mrCoarseMesh.GetNearestElementIndexFromTestElements(rPoint,test_element_indices);
-                mStatisticsCounters[1]++;
-            }
         }
     }
 
+    // The point is not in ANY element, so return the nearest element in the local boxes
+    test_element_indices.clear();
+    CollectElementsInLocalBoxes(mpCoarseMeshBoxCollection, boxForThisPoint, test_element_indices);
+    assert(test_element_indices.size() > 0); // boxes probably too small if this fails
+
+    unsigned elem_index = mrCoarseMesh.GetNearestElementIndexFromTestElements(rPoint,test_element_indices);
+    mStatisticsCounters[1]++;
+
     return elem_index;
 }
 
@@ -557,19 +596,6 @@ unsigned FineCoarseMeshPair<DIM>::ComputeCoarseElementForGivenPoint(ChastePoint<
 // Helper methods for code
 ////////////////////////////////////////////////////////////////////////////////////
 
-template <unsigned DIM>
-void FineCoarseMeshPair<DIM>::CollectElementsInContainingBox(DistributedBoxCollection<DIM>*& rpBoxCollection,
-                                                             unsigned boxIndex,
-                                                             std::set<unsigned>& rElementIndices)
-{
-    for (typename std::set<Element<DIM,DIM>*>::iterator elem_iter = rpBoxCollection->rGetBox(boxIndex).rGetElementsContained().begin();
-         elem_iter != rpBoxCollection->rGetBox(boxIndex).rGetElementsContained().end();
-         ++elem_iter)
-    {
-        rElementIndices.insert((*elem_iter)->GetIndex());
-    }
-}
-
 template <unsigned DIM>
 void FineCoarseMeshPair<DIM>::CollectElementsInLocalBoxes(DistributedBoxCollection<DIM>*& rpBoxCollection,
                                                           unsigned boxIndex,
@@ -589,6 +615,300 @@ void FineCoarseMeshPair<DIM>::CollectElementsInLocalBoxes(DistributedBoxCollecti
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////////
+// Mapping cache methods
+////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Fold some bytes into a 64-bit FNV-1a hash.
+ *
+ * @param hash  the hash so far
+ * @param pData  the bytes
+ * @param size  the number of bytes
+ * @return the new hash
+ */
+static unsigned long long HashBytes(unsigned long long hash, const void* pData, std::size_t size)
+{
+    const unsigned char* p_bytes = static_cast<const unsigned char*>(pData);
+    for (std::size_t i=0; i<size; i++)
+    {
+        hash ^= p_bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+template <unsigned DIM>
+unsigned long long FineCoarseMeshPair<DIM>::CalculateMeshHash(AbstractTetrahedralMesh<DIM,DIM>& rMesh)
+{
+    /*
+     * Hash each node and element separately and sum the hashes, so the result does not
+     * depend on the order in which they are visited. Each node and element is only hashed
+     * by the process that owns it, as replicated meshes and halos hold them on several
+     * processes, and nodes are hashed by their original index, as partitioning may
+     * renumber them.
+     */
+    const std::vector<unsigned>& r_permutation = rMesh.rGetNodePermutation();
+    std::vector<unsigned> original_indices(r_permutation.size());
+    for (unsigned i=0; i<r_permutation.size(); i++)
+    {
+        original_indices[r_permutation[i]] = i;
+    }
+    DistributedVectorFactory* p_factory = rMesh.GetDistributedVectorFactory();
+
+    const unsigned long long offset_basis = 14695981039346656037ull;
+    unsigned long long local_hash = 0ull;
+    for (typename AbstractMesh<DIM,DIM>::NodeIterator iter = rMesh.GetNodeIteratorBegin();
+         iter != rMesh.GetNodeIteratorEnd();
+         ++iter)
+    {
+        unsigned index = iter->GetIndex();
+        if (!p_factory->IsGlobalIndexLocal(index))
+        {
+            continue;
+        }
+        if (!original_indices.empty())
+        {
+            index = original_indices[index];
+        }
+        unsigned long long node_hash = HashBytes(offset_basis, &index, sizeof(index));
+        node_hash = HashBytes(node_hash, &(iter->rGetLocation()[0]), DIM*sizeof(double));
+        local_hash += node_hash;
+    }
+    for (typename AbstractTetrahedralMesh<DIM,DIM>::ElementIterator iter = rMesh.GetElementIteratorBegin();
+         iter != rMesh.GetElementIteratorEnd();
+         ++iter)
+    {
+        unsigned index = iter->GetIndex();
+        if (!rMesh.CalculateDesignatedOwnershipOfElement(index))
+        {
+            continue;
+        }
+        unsigned long long element_hash = HashBytes(offset_basis, &index, sizeof(index));
+        for (unsigned j=0; j<iter->GetNumNodes(); j++)
+        {
+            unsigned node_index = iter->GetNodeGlobalIndex(j);
+            if (!original_indices.empty())
+            {
+                node_index = original_indices[node_index];
+            }
+            element_hash = HashBytes(element_hash, &node_index, sizeof(node_index));
+        }
+        local_hash += element_hash;
+    }
+
+    unsigned long long hash = local_hash;
+    if (!PetscTools::IsSequential())
+    {
+        MPI_Allreduce(&local_hash, &hash, 1, MPI_UNSIGNED_LONG_LONG, MPI_SUM, PetscTools::GetWorld());
+    }
+    return hash;
+}
+
+template <unsigned DIM>
+std::string FineCoarseMeshPair<DIM>::GetMappingCacheFileName(const std::string& rMethod, unsigned numPoints, bool safeMode)
+{
+    if (mMappingCacheDirectory.empty())
+    {
+        return "";
+    }
+
+    std::stringstream file_name;
+    file_name << "mesh_pair_" << rMethod << "_" << DIM << "d_"
+              << std::hex << CalculateMeshHash(mrFineMesh) << "_" << CalculateMeshHash(mrCoarseMesh)
+              << std::dec << "_" << numPoints << (safeMode ? "_safe" : "") << ".dat";
+    return file_name.str();
+}
+
+template <unsigned DIM>
+bool FineCoarseMeshPair<DIM>::LoadFineElementDataFromCache(const std::string& rFileName)
+{
+    if (rFileName.empty())
+    {
+        return false;
+    }
+    FileFinder cache_file(mMappingCacheDirectory + "/" + rFileName, RelativeTo::ChasteTestOutput);
+    if (!cache_file.IsFile())
+    {
+        return false;
+    }
+
+    std::ifstream file(cache_file.GetAbsolutePath().c_str());
+    unsigned num_points;
+    unsigned num_not_in_mesh;
+    file >> num_points >> mStatisticsCounters[0] >> mStatisticsCounters[1] >> num_not_in_mesh;
+    if (!file || num_points != mFineMeshElementsAndWeights.size())
+    {
+        EXCEPTION("Mapping cache file " << cache_file.GetAbsolutePath() << " is corrupt; delete it to recompute the mapping");
+    }
+    for (unsigned i=0; i<num_points; i++)
+    {
+        file >> mFineMeshElementsAndWeights[i].ElementNum;
+        for (unsigned j=0; j<DIM+1; j++)
+        {
+            file >> mFineMeshElementsAndWeights[i].Weights[j];
+        }
+    }
+    mNotInMesh.resize(num_not_in_mesh);
+    mNotInMeshNearestElementWeights.resize(num_not_in_mesh);
+    for (unsigned i=0; i<num_not_in_mesh; i++)
+    {
+        file >> mNotInMesh[i];
+        for (unsigned j=0; j<DIM+1; j++)
+        {
+            file >> mNotInMeshNearestElementWeights[i][j];
+        }
+    }
+    if (!file)
+    {
+        EXCEPTION("Mapping cache file " << cache_file.GetAbsolutePath() << " is corrupt; delete it to recompute the mapping");
+    }
+    return true;
+}
+
+template <unsigned DIM>
+void FineCoarseMeshPair<DIM>::SaveFineElementDataToCache(const std::string& rFileName)
+{
+    if (rFileName.empty())
+    {
+        return;
+    }
+
+    /*
+     * Every process has all the data after ShareFineElementData(), except that in
+     * parallel mNotInMesh only holds the points found by this process, so gather those.
+     */
+    std::vector<unsigned> not_in_mesh = mNotInMesh;
+    std::vector<c_vector<double,DIM+1> > not_in_mesh_weights = mNotInMeshNearestElementWeights;
+    if (!PetscTools::IsSequential())
+    {
+        std::vector<int> counts(PetscTools::GetNumProcs());
+        int local_count = mNotInMesh.size();
+        MPI_Allgather(&local_count, 1, MPI_INT, &counts[0], 1, MPI_INT, PetscTools::GetWorld());
+        std::vector<int> displacements(counts.size(), 0);
+        for (unsigned proc=1; proc<counts.size(); proc++)
+        {
+            displacements[proc] = displacements[proc-1] + counts[proc-1];
+        }
+        unsigned total = displacements.back() + counts.back();
+
+        not_in_mesh.resize(total);
+        std::vector<double> local_weights(local_count*(DIM+1));
+        for (int i=0; i<local_count; i++)
+        {
+            for (unsigned j=0; j<DIM+1; j++)
+            {
+                local_weights[i*(DIM+1)+j] = mNotInMeshNearestElementWeights[i][j];
+            }
+        }
+        std::vector<double> all_weights(total*(DIM+1));
+        std::vector<int> weight_counts(counts.size());
+        std::vector<int> weight_displacements(counts.size());
+        for (unsigned proc=0; proc<counts.size(); proc++)
+        {
+            weight_counts[proc] = counts[proc]*(DIM+1);
+            weight_displacements[proc] = displacements[proc]*(DIM+1);
+        }
+        MPI_Allgatherv(local_count > 0 ? &mNotInMesh[0] : nullptr, local_count, MPI_UNSIGNED,
+                       total > 0 ? &not_in_mesh[0] : nullptr, &counts[0], &displacements[0], MPI_UNSIGNED, PetscTools::GetWorld());
+        MPI_Allgatherv(local_count > 0 ? &local_weights[0] : nullptr, local_count*(DIM+1), MPI_DOUBLE,
+                       total > 0 ? &all_weights[0] : nullptr, &weight_counts[0], &weight_displacements[0], MPI_DOUBLE, PetscTools::GetWorld());
+        not_in_mesh_weights.resize(total);
+        for (unsigned i=0; i<total; i++)
+        {
+            for (unsigned j=0; j<DIM+1; j++)
+            {
+                not_in_mesh_weights[i][j] = all_weights[i*(DIM+1)+j];
+            }
+        }
+    }
+
+    OutputFileHandler handler(mMappingCacheDirectory, false);
+    if (PetscTools::AmMaster())
+    {
+        out_stream p_file = handler.OpenOutputFile(rFileName);
+        *p_file << std::setprecision(17);
+        *p_file << mFineMeshElementsAndWeights.size() << " " << mStatisticsCounters[0] << " "
+                << mStatisticsCounters[1] << " " << not_in_mesh.size() << "\n";
+        for (unsigned i=0; i<mFineMeshElementsAndWeights.size(); i++)
+        {
+            *p_file << mFineMeshElementsAndWeights[i].ElementNum;
+            for (unsigned j=0; j<DIM+1; j++)
+            {
+                *p_file << " " << mFineMeshElementsAndWeights[i].Weights[j];
+            }
+            *p_file << "\n";
+        }
+        for (unsigned i=0; i<not_in_mesh.size(); i++)
+        {
+            *p_file << not_in_mesh[i];
+            for (unsigned j=0; j<DIM+1; j++)
+            {
+                *p_file << " " << not_in_mesh_weights[i][j];
+            }
+            *p_file << "\n";
+        }
+        p_file->close();
+    }
+    PetscTools::Barrier("FineCoarseMeshPair::SaveFineElementDataToCache");
+}
+
+template <unsigned DIM>
+bool FineCoarseMeshPair<DIM>::LoadCoarseElementDataFromCache(const std::string& rFileName,
+                                                             std::vector<unsigned>& rCoarseElements)
+{
+    if (rFileName.empty())
+    {
+        return false;
+    }
+    FileFinder cache_file(mMappingCacheDirectory + "/" + rFileName, RelativeTo::ChasteTestOutput);
+    if (!cache_file.IsFile())
+    {
+        return false;
+    }
+
+    std::ifstream file(cache_file.GetAbsolutePath().c_str());
+    unsigned num_points;
+    file >> num_points >> mStatisticsCounters[0] >> mStatisticsCounters[1];
+    if (!file || num_points != rCoarseElements.size())
+    {
+        EXCEPTION("Mapping cache file " << cache_file.GetAbsolutePath() << " is corrupt; delete it to recompute the mapping");
+    }
+    for (unsigned i=0; i<num_points; i++)
+    {
+        file >> rCoarseElements[i];
+    }
+    if (!file)
+    {
+        EXCEPTION("Mapping cache file " << cache_file.GetAbsolutePath() << " is corrupt; delete it to recompute the mapping");
+    }
+    return true;
+}
+
+template <unsigned DIM>
+void FineCoarseMeshPair<DIM>::SaveCoarseElementDataToCache(const std::string& rFileName,
+                                                           const std::vector<unsigned>& rCoarseElements)
+{
+    if (rFileName.empty())
+    {
+        return;
+    }
+
+    // Every process has all the data after ShareCoarseElementData()
+    OutputFileHandler handler(mMappingCacheDirectory, false);
+    if (PetscTools::AmMaster())
+    {
+        out_stream p_file = handler.OpenOutputFile(rFileName);
+        *p_file << rCoarseElements.size() << " " << mStatisticsCounters[0] << " " << mStatisticsCounters[1] << "\n";
+        for (unsigned i=0; i<rCoarseElements.size(); i++)
+        {
+            *p_file << rCoarseElements[i] << "\n";
+        }
+        p_file->close();
+    }
+    PetscTools::Barrier("FineCoarseMeshPair::SaveCoarseElementDataToCache");
+}
+
 ////////////////////////////////////////////////////////////////////////////////////
 // Statistics related methods
 ////////////////////////////////////////////////////////////////////////////////////
@@ -612,7 +932,7 @@ void FineCoarseMeshPair<DIM>::ShareFineElementData()
     // This sums the results so it isn't idempotent: you get a different result if you call this method twice
     // Should not matter: the methods which call this helper method have reset everything which is about to be shared
     std::vector<unsigned> local_counters = mStatisticsCounters;
-    MPI_Allreduce(&local_counters[0], &mStatisticsCounters[0], 2u, MPI_UNSIGNED, MPI_SUM, PETSC_COMM_WORLD);
+    MPI_Allreduce(&local_counters[0], &mStatisticsCounters[0], 2u, MPI_UNSIGNED, MPI_SUM, PetscTools::GetWorld());
 
 
     // Get all the element number and weights into a contiguous format
@@ -632,8 +952,8 @@ void FineCoarseMeshPair<DIM>::ShareFineElementData()
     // Copy and share
     std::vector<unsigned> local_all_element_indices = all_element_indices;
     std::vector<double> local_all_weights = all_weights;
-    MPI_Allreduce(&local_all_element_indices[0], &all_element_indices[0], elements_size, MPI_UNSIGNED, MPI_SUM, PETSC_COMM_WORLD);
-    MPI_Allreduce( &local_all_weights[0], &all_weights[0], weights_size, MPI_DOUBLE, MPI_SUM, PETSC_COMM_WORLD);
+    MPI_Allreduce(&local_all_element_indices[0], &all_element_indices[0], elements_size, MPI_UNSIGNED, MPI_SUM, PetscTools::GetWorld());
+    MPI_Allreduce( &local_all_weights[0], &all_weights[0], weights_size, MPI_DOUBLE, MPI_SUM, PetscTools::GetWorld());
 
     // Put back into the regular data structure
     for (unsigned index=0; index<mFineMeshElementsAndWeights.size(); index++)
@@ -646,6 +966,37 @@ void FineCoarseMeshPair<DIM>::ShareFineElementData()
     }
 }
 
+template <unsigned DIM>
+void FineCoarseMeshPair<DIM>::ShareQuadPointPositions(QuadraturePointsGroup<DIM>& rQuadPointPositions)
+{
+    if (PetscTools::IsSequential() || dynamic_cast<DistributedTetrahedralMesh<DIM,DIM>*>(&mrCoarseMesh) == nullptr)
+    {
+        return;
+    }
+
+    // Positions not known on this process are DOUBLE_UNSET; those that are known are the same on every
+    // process which knows them, so taking the maximum fills them all in
+    std::vector<double> local_positions(rQuadPointPositions.Size()*DIM);
+    for (unsigned i=0; i<rQuadPointPositions.Size(); i++)
+    {
+        for (unsigned j=0; j<DIM; j++)
+        {
+            double value = rQuadPointPositions.rGet(i)(j);
+            local_positions[i*DIM+j] = (value == DOUBLE_UNSET) ? -DBL_MAX : value;
+        }
+    }
+    std::vector<double> positions(local_positions.size());
+    MPI_Allreduce(&local_positions[0], &positions[0], positions.size(), MPI_DOUBLE, MPI_MAX, PetscTools::GetWorld());
+
+    for (unsigned i=0; i<rQuadPointPositions.Size(); i++)
+    {
+        for (unsigned j=0; j<DIM; j++)
+        {
+            rQuadPointPositions.rGet(i)(j) = positions[i*DIM+j];
+        }
+    }
+}
+
 template <unsigned DIM>
 void FineCoarseMeshPair<DIM>::ShareCoarseElementData()
 {
@@ -657,18 +1008,18 @@ void FineCoarseMeshPair<DIM>::ShareCoarseElementData()
     // This sums the results so it isn't idempotent: you get a different result if you call this method twice
     // Should not matter: the methods which call this helper method have reset #mStatisticsCounters
     std::vector<unsigned> local_counters = mStatisticsCounters;
-    MPI_Allreduce(&local_counters[0], &mStatisticsCounters[0], 2u, MPI_UNSIGNED, MPI_SUM, PETSC_COMM_WORLD);
+    MPI_Allreduce(&local_counters[0], &mStatisticsCounters[0], 2u, MPI_UNSIGNED, MPI_SUM, PetscTools::GetWorld());
 
     // The rest uses "max" so it is idempotent.  You can safely re-share results between processes without them changing.
     if (mCoarseElementsForFineNodes.empty() == false)
     {
         std::vector<unsigned> temp_coarse_elements = mCoarseElementsForFineNodes;
-        MPI_Allreduce( &temp_coarse_elements[0], &mCoarseElementsForFineNodes[0], mCoarseElementsForFineNodes.size(), MPI_UNSIGNED, MPI_MAX, PETSC_COMM_WORLD);
+        MPI_Allreduce( &temp_coarse_elements[0], &mCoarseElementsForFineNodes[0], mCoarseElementsForFineNodes.size(), MPI_UNSIGNED, MPI_MAX, PetscTools::GetWorld());
     }
     if (mCoarseElementsForFineElementCentroids.empty() == false)
     {
         std::vector<unsigned> temp_coarse_elements = mCoarseElementsForFineElementCentroids;
-        MPI_Allreduce( &temp_coarse_elements[0], &mCoarseElementsForFineElementCentroids[0], mCoarseElementsForFineElementCentroids.size(), MPI_UNSIGNED, MPI_MAX, PETSC_COMM_WORLD);
+        MPI_Allreduce( &temp_coarse_elements[0], &mCoarseElementsForFineElementCentroids[0], mCoarseElementsForFineElementCentroids.size(), MPI_UNSIGNED, MPI_MAX, PetscTools::GetWorld());
     }
 }
 
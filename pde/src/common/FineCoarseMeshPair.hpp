@@ -38,6 +38,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "AbstractTetrahedralMesh.hpp"
 #include "DistributedBoxCollection.hpp"
+#include "ElementBoundingVolumeHierarchy.hpp"
 #include "QuadraturePointsGroup.hpp"
 #include "GaussianQuadratureRule.hpp"
 #include "Warnings.hpp"
@@ -101,6 +102,9 @@ struct ElementAndWeights
  * To see progression for any of these methods, run test from the command line with '-mesh_pair_verbose' as
  * a command line parameter
  *
+ * The results of any of the Compute methods can be cached on disk, to be reused by later simulations on the same
+ * pair of meshes, by calling SetMappingCacheDirectory() first.
+ *
  */
 template <unsigned DIM>
 class FineCoarseMeshPair
@@ -126,6 +130,24 @@ private:
      */
     DistributedBoxCollection<DIM>* mpCoarseMeshBoxCollection;
 
+    /**
+     * Bounding volume hierarchy over the fine mesh elements in the owned boxes of
+     * mpFineMeshBoxCollection, used to find the element containing a given point.
+     */
+    ElementBoundingVolumeHierarchy<DIM>* mpFineMeshHierarchy;
+
+    /**
+     * Bounding volume hierarchy over the coarse mesh elements in the owned boxes of
+     * mpCoarseMeshBoxCollection, used to find the element containing a given point.
+     */
+    ElementBoundingVolumeHierarchy<DIM>* mpCoarseMeshHierarchy;
+
+    /**
+     * Directory (relative to CHASTE_TEST_OUTPUT) in which the results of the Compute methods
+     * are cached, or empty (the default) for no caching. See SetMappingCacheDirectory().
+     */
+    std::string mMappingCacheDirectory;
+
     /**
      * The containing elements and corresponding weights in the fine
      * mesh for the set of points given. The points may have been
@@ -193,32 +215,22 @@ private:
                                                unsigned boxForThisPoint);
 
     /**
-     * Set up a box collection on the given mesh. Should only be called using either
-     *   SetUpBoxes(*mpFineMesh, boxWidth, mpFineBoxCollection)  (from SetUpBoxesOnFineMesh)
+     * Set up a box collection, and a bounding volume hierarchy over the elements in its
+     * owned boxes, on the given mesh. Should only be called using either
+     *   SetUpBoxes(*mpFineMesh, boxWidth, mpFineBoxCollection, mpFineMeshHierarchy)  (from SetUpBoxesOnFineMesh)
      * or
-     *   SetUpBoxes(*mpCoarseMesh, boxWidth, mpCoarseBoxCollection)  (from SetUpBoxesOnCoarseMesh)
+     *   SetUpBoxes(*mpCoarseMesh, boxWidth, mpCoarseBoxCollection, mpCoarseMeshHierarchy)  (from SetUpBoxesOnCoarseMesh)
      *
      * @param rMesh The mesh, either *mpFineMesh or *mpCoarseMesh)
      * @param boxWidth box width (see SetUpBoxesOnCoarseMesh() dox)
      * @param rpBoxCollection reference to either mpFineBoxCollection or mpCoarseBoxCollection
+     * @param rpHierarchy reference to either mpFineMeshHierarchy or mpCoarseMeshHierarchy
      */
     void SetUpBoxes(AbstractTetrahedralMesh<DIM,DIM>& rMesh,
                     double boxWidth,
-                    DistributedBoxCollection<DIM>*& rpBoxCollection);
+                    DistributedBoxCollection<DIM>*& rpBoxCollection,
+                    ElementBoundingVolumeHierarchy<DIM>*& rpHierarchy);
 
-    /**
-     * Helper method. Gets all the elements in the given box, in the given box collection
-     * and puts them in the returned std::vector.
-     *
-     * @param rpBoxCollection Reference to the box collection to use (either mpFineBoxCollection
-     *  or mpCoarseBoxCollection)
-     * @param boxIndex box index
-     * @param rElementIndices The returned vector of element indices in that box of the box collection. Not
-     *  cleared before use.
-     */
-    void CollectElementsInContainingBox(DistributedBoxCollection<DIM>*& rpBoxCollection,
-                                        unsigned boxIndex,
-                                        std::set<unsigned>& rElementIndices);
     /**
      * Helper method. Gets all the elements in the given box, or in a box local to the given box,
      * in the given box collection, and puts them in the returned std::vector.
@@ -242,11 +254,74 @@ private:
      * In parallel: share mStatisticsCounters and all the "fine element weights for..." information
      */
     void ShareFineElementData();
+    /**
+     * In parallel with a distributed coarse mesh: share the positions of the quadrature points,
+     * each of which is only computed on the processes that have its element.
+     *
+     * @param rQuadPointPositions the quadrature points of the coarse mesh
+     */
+    void ShareQuadPointPositions(QuadraturePointsGroup<DIM>& rQuadPointPositions);
+
     /**
      * In parallel: share mStatisticsCounters and all the "this coarse element index for..." information
      */
     void ShareCoarseElementData();
 
+    /**
+     * @return a hash of the node locations and element connectivity of a mesh, which is
+     * independent of the partitioning of the mesh, and of the number of processes it is
+     * distributed over. This method is collective.
+     *
+     * @param rMesh The mesh
+     */
+    static unsigned long long CalculateMeshHash(AbstractTetrahedralMesh<DIM,DIM>& rMesh);
+
+    /**
+     * @return the name of the file in which the results of a Compute method are cached,
+     * or an empty string if SetMappingCacheDirectory() has not been called. The name
+     * identifies the meshes and the arguments of the method. This method is collective.
+     *
+     * @param rMethod  a short name for the Compute method
+     * @param numPoints  the number of points being located
+     * @param safeMode  the safeMode argument of the method
+     */
+    std::string GetMappingCacheFileName(const std::string& rMethod, unsigned numPoints, bool safeMode);
+
+    /**
+     * Read mFineMeshElementsAndWeights, mNotInMesh, mNotInMeshNearestElementWeights and
+     * mStatisticsCounters from a cache file, if it exists.
+     *
+     * @param rFileName  the cache file name, from GetMappingCacheFileName()
+     * @return whether the data was read
+     */
+    bool LoadFineElementDataFromCache(const std::string& rFileName);
+
+    /**
+     * Write mFineMeshElementsAndWeights, mNotInMesh, mNotInMeshNearestElementWeights and
+     * mStatisticsCounters to a cache file. This method is collective.
+     *
+     * @param rFileName  the cache file name, from GetMappingCacheFileName()
+     */
+    void SaveFineElementDataToCache(const std::string& rFileName);
+
+    /**
+     * Read coarse element indices and mStatisticsCounters from a cache file, if it exists.
+     *
+     * @param rFileName  the cache file name, from GetMappingCacheFileName()
+     * @param rCoarseElements  either mCoarseElementsForFineNodes or mCoarseElementsForFineElementCentroids,
+     *     already of the right size
+     * @return whether the data was read
+     */
+    bool LoadCoarseElementDataFromCache(const std::string& rFileName, std::vector<unsigned>& rCoarseElements);
+
+    /**
+     * Write coarse element indices and mStatisticsCounters to a cache file. This method is collective.
+     *
+     * @param rFileName  the cache file name, from GetMappingCacheFileName()
+     * @param rCoarseElements  either mCoarseElementsForFineNodes or mCoarseElementsForFineElementCentroids
+     */
+    void SaveCoarseElementDataToCache(const std::string& rFileName, const std::vector<unsigned>& rCoarseElements);
+
 public:
 
     /**
@@ -290,6 +365,21 @@ public:
      */
     void SetUpBoxesOnCoarseMesh(double boxWidth = -1);
 
+    /**
+     * Cache the results of the Compute methods in the given directory, and reuse them when a
+     * Compute method is called with the same arguments on the same pair of meshes (for example
+     * by a later simulation). Cache files are identified by hashes of the node locations and
+     * element connectivity of both meshes, so they are invalidated by any change to either mesh.
+     *
+     * The boxes must still be set up before calling the Compute methods.
+     *
+     * This method is collective.
+     *
+     * @param rDirectory  the cache directory, relative to CHASTE_TEST_OUTPUT. It is
+     *     created if necessary, and not cleaned.
+     */
+    void SetMappingCacheDirectory(const std::string& rDirectory);
+
     /**
      * Set up the containing (fine) elements and corresponding weights for all the
      * quadrature points in the coarse mesh. Call GetElementsAndWeights() after calling this
@@ -394,13 +484,13 @@ public:
     }
 
     /**
-     * Destroy the box collection for the fine mesh - can be used to free memory once
+     * Destroy the box collection (and bounding volume hierarchy) for the fine mesh - can be used to free memory once
      * ComputeFineElementsAndWeightsForCoarseQuadPoints (etc) has been called.
      */
     void DeleteFineBoxCollection();
 
     /**
-     * Destroy the box collection for the coarse mesh - can be used to free memory once
+     * Destroy the box collection (and bounding volume hierarchy) for the coarse mesh - can be used to free memory once
      * ComputeCoarseElementsForFineNodes (etc) has been called.
      */
     void DeleteCoarseBoxCollection();
@@ -34,8 +34,13 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "AbstractHdf5Converter.hpp"
+#include "DistributedVectorFactory.hpp"
+#include "PetscTools.hpp"
 #include "Version.hpp"
 
+#include <algorithm>
+#include <cassert>
+
 
 /*
  * Operator function to be called by H5Literate [HDF5 1.8.x] or H5Giterate [HDF5 1.6.x] (in TestListingDatasetsInAnHdf5File).
@@ -57,7 +62,8 @@ AbstractHdf5Converter<ELEMENT_DIM, SPACE_DIM>::AbstractHdf5Converter(const FileF
       mOpenDatasetIndex(UNSIGNED_UNSET),
       mpMesh(pMesh),
       mRelativeSubdirectory(rSubdirectoryName),
-      mPrecision(precision)
+      mPrecision(precision),
+      mConcentratedData(nullptr)
 {
     GenerateListOfDatasets(mrH5Folder, mFileBaseName);
 
@@ -88,12 +94,11 @@ void AbstractHdf5Converter<ELEMENT_DIM, SPACE_DIM>::WriteInfoFile()
         }
         out_stream p_file = mpOutputFileHandler->OpenOutputFile(time_info_filename);
 
-        std::vector<double> time_values = mpReader->GetUnlimitedDimensionValues();
-        unsigned num_timesteps = time_values.size();
-        double first_timestep = time_values.front();
-        double last_timestep = time_values.back();
+        unsigned num_timesteps = mTimeValues.size();
+        double first_timestep = mTimeValues.front();
+        double last_timestep = mTimeValues.back();
 
-        double timestep = num_timesteps > 1 ? time_values[1] - time_values[0] : DOUBLE_UNSET;
+        double timestep = num_timesteps > 1 ? mTimeValues[1] - mTimeValues[0] : DOUBLE_UNSET;
 
         *p_file << "Number of timesteps " << num_timesteps << std::endl;
         *p_file << "timestep " << timestep << std::endl;
@@ -108,6 +113,11 @@ void AbstractHdf5Converter<ELEMENT_DIM, SPACE_DIM>::WriteInfoFile()
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 AbstractHdf5Converter<ELEMENT_DIM,SPACE_DIM>::~AbstractHdf5Converter()
 {
+    if (mConcentratedData != nullptr)
+    {
+        VecScatterDestroy(PETSC_DESTROY_PARAM(mToMaster));
+        PetscTools::Destroy(mConcentratedData);
+    }
     delete mpOutputFileHandler;
 }
 
@@ -148,11 +158,94 @@ bool AbstractHdf5Converter<ELEMENT_DIM,SPACE_DIM>::MoveOntoNextDataset()
         delete mpOutputFileHandler;
         EXCEPTION("Mesh and HDF5 file have a different number of nodes");
     }
+    mTimeValues = mpReader->GetUnlimitedDimensionValues();
     WriteInfoFile();
 
     return true;
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned AbstractHdf5Converter<ELEMENT_DIM,SPACE_DIM>::ReadTimestepBlock(unsigned firstTimestep, Vec data, Hdf5DataBlock& rBlock)
+{
+    unsigned num_timesteps = mTimeValues.size();
+    assert(firstTimestep < num_timesteps);
+    unsigned num_timesteps_to_read = std::min(mpReader->GetNumberOfTimestepsPerChunk(), num_timesteps - firstTimestep);
+
+    PetscInt lo, hi;
+    VecGetOwnershipRange(data, &lo, &hi);
+    mpReader->GetBlock(firstTimestep, num_timesteps_to_read, lo, hi, rBlock);
+
+    return num_timesteps_to_read;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractHdf5Converter<ELEMENT_DIM,SPACE_DIM>::CopyBlockToVec(const Hdf5DataBlock& rBlock, unsigned timestep, unsigned variableIndex, Vec data)
+{
+    PetscInt lo, hi;
+    VecGetOwnershipRange(data, &lo, &hi);
+    assert(rBlock.mLowerNode == (unsigned)lo && rBlock.mUpperNode == (unsigned)hi);
+
+    double* p_data;
+    VecGetArray(data, &p_data);
+    for (unsigned node_index=(unsigned)lo; node_index<(unsigned)hi; node_index++)
+    {
+        p_data[node_index-lo] = rBlock.GetValue(timestep, node_index, variableIndex);
+    }
+    VecRestoreArray(data, &p_data);
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractHdf5Converter<ELEMENT_DIM,SPACE_DIM>::ConcentrateVecOnMaster(Vec data, std::vector<double>& rValues)
+{
+    if (mConcentratedData == nullptr)
+    {
+        // This creates mToMaster (the scatter context) and mConcentratedData (to store values)
+        VecScatterCreateToZero(data, &mToMaster, &mConcentratedData);
+    }
+
+//PETSc-3.x.x or PETSc-2.3.3
+#if ((PETSC_VERSION_MAJOR == 3) || (PETSC_VERSION_MAJOR == 2 && PETSC_VERSION_MINOR == 3 && PETSC_VERSION_SUBMINOR == 3)) //2.3.3 or 3.x.x
+    VecScatterBegin(mToMaster, data, mConcentratedData, INSERT_VALUES, SCATTER_FORWARD);
+    VecScatterEnd(mToMaster, data, mConcentratedData, INSERT_VALUES, SCATTER_FORWARD);
+#else
+//PETSc-2.3.2 or previous
+    VecScatterBegin(data, mConcentratedData, INSERT_VALUES, SCATTER_FORWARD, mToMaster);
+    VecScatterEnd(data, mConcentratedData, INSERT_VALUES, SCATTER_FORWARD, mToMaster);
+#endif
+
+    // Only the master's copy has any entries
+    PetscInt local_size;
+    VecGetLocalSize(mConcentratedData, &local_size);
+    rValues.resize(local_size);
+    double* p_data;
+    VecGetArray(mConcentratedData, &p_data);
+    for (PetscInt i=0; i<local_size; i++)
+    {
+        rValues[i] = p_data[i];
+    }
+    VecRestoreArray(mConcentratedData, &p_data);
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractHdf5Converter<ELEMENT_DIM,SPACE_DIM>::GetLocalTimestepRange(unsigned& rLow, unsigned& rHigh)
+{
+    // Use PETSc's default split, as for the nodes of a mesh
+    DistributedVectorFactory time_factory(mTimeValues.size());
+    rLow = time_factory.GetLow();
+    rHigh = time_factory.GetHigh();
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned AbstractHdf5Converter<ELEMENT_DIM,SPACE_DIM>::ReadWholeTimestepBlock(unsigned firstTimestep, unsigned endTimestep, Hdf5DataBlock& rBlock)
+{
+    assert(firstTimestep < endTimestep && endTimestep <= mTimeValues.size());
+    unsigned num_timesteps_to_read = std::min(mpReader->GetNumberOfTimestepsPerChunk(), endTimestep - firstTimestep);
+
+    mpReader->GetBlock(firstTimestep, num_timesteps_to_read, 0u, mpReader->GetNumberOfRows(), rBlock);
+
+    return num_timesteps_to_read;
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void AbstractHdf5Converter<ELEMENT_DIM,SPACE_DIM>::GenerateListOfDatasets(const FileFinder& rH5Folder,
                                                                           const std::string& rFileName)
@@ -37,6 +37,8 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define ABSTRACTHDF5CONVERTER_HPP_
 
 #include <string>
+#include <vector>
+#include <petscvec.h>
 #include "AbstractTetrahedralMesh.hpp"
 #include "OutputFileHandler.hpp"
 #include "Hdf5DataReader.hpp"
@@ -69,6 +71,12 @@ protected:
     /** Number of variables to output. Read from the reader. */
     unsigned mNumVariables;
 
+    /**
+     * The values of the unlimited dimension (usually time) in the open dataset.
+     * Read once when the dataset is opened, since the reader goes back to the file on every request.
+     */
+    std::vector<double> mTimeValues;
+
     /** Base name for the files: [basename].vtu, [basename].dat etc.*/
     std::string mFileBaseName;
 
@@ -103,6 +111,12 @@ protected:
      */
     unsigned mPrecision;
 
+    /** Vector holding a copy of a distributed vector on the master process (created on first use). */
+    Vec mConcentratedData;
+
+    /** Scatter context used to fill in #mConcentratedData. */
+    VecScatter mToMaster;
+
     /**
      * Close the existing dataset and open a new one.
      *
@@ -112,6 +126,64 @@ protected:
      */
     bool MoveOntoNextDataset();
 
+    /**
+     * Read one chunk's worth of time steps (as laid out in the file) for the part of the open
+     * dataset owned by this process, so that converters stream through the file in on-disk
+     * order rather than making one small read per time step and variable.
+     *
+     * @param firstTimestep  the first time step to read
+     * @param data  a vector with the parallel layout of the data to be read
+     * @param rBlock  filled in with every variable for the locally owned nodes
+     * @return the number of time steps read
+     */
+    unsigned ReadTimestepBlock(unsigned firstTimestep, Vec data, Hdf5DataBlock& rBlock);
+
+    /**
+     * Copy the locally owned values of one variable at one time step from a block
+     * read by ReadTimestepBlock() into a vector.
+     *
+     * @param rBlock  the block
+     * @param timestep  the time step, which must lie within the block
+     * @param variableIndex  the index of the variable in the reader's list of variable names
+     * @param data  the vector to fill in, with the same layout as that given to ReadTimestepBlock()
+     */
+    void CopyBlockToVec(const Hdf5DataBlock& rBlock, unsigned timestep, unsigned variableIndex, Vec data);
+
+    /**
+     * Gather a distributed vector onto the master process only, for formats that are written
+     * by the master alone.  This avoids copying every time step onto every process, which is
+     * what a ReplicatableVector would do.
+     *
+     * @note This method is collective, and must be called by all processes.
+     *
+     * @param data  the distributed vector, which must always have the same parallel layout
+     * @param rValues  filled in with the whole vector on the master process, and left empty elsewhere
+     */
+    void ConcentrateVecOnMaster(Vec data, std::vector<double>& rValues);
+
+    /**
+     * Share the time steps of the open dataset out between processes.  Formats which write a
+     * separate file for each time step use this so that each process converts its own time steps
+     * for the whole mesh, rather than all processes working through every time step together.
+     *
+     * @note This method is collective, and must be called by all processes.
+     *
+     * @param rLow  set to the first time step this process should convert
+     * @param rHigh  set to one past the last time step this process should convert
+     */
+    void GetLocalTimestepRange(unsigned& rLow, unsigned& rHigh);
+
+    /**
+     * Read up to one chunk's worth of time steps for every node of the open dataset.  Unlike
+     * ReadTimestepBlock() this is not collective, and is used along with GetLocalTimestepRange().
+     *
+     * @param firstTimestep  the first time step to read
+     * @param endTimestep  one past the last time step that may be read
+     * @param rBlock  filled in with every variable for every node
+     * @return the number of time steps read
+     */
+    unsigned ReadWholeTimestepBlock(unsigned firstTimestep, unsigned endTimestep, Hdf5DataBlock& rBlock);
+
 public:
 
     /**
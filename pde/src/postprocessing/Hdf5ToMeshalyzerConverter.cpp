@@ -39,53 +39,67 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "UblasCustomFunctions.hpp"
 #include "PetscTools.hpp"
 #include "Exception.hpp"
-#include "ReplicatableVector.hpp"
 #include "DistributedVector.hpp"
 #include "DistributedVectorFactory.hpp"
 #include "Version.hpp"
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
-void Hdf5ToMeshalyzerConverter<ELEMENT_DIM,SPACE_DIM>::Write(std::string type)
+void Hdf5ToMeshalyzerConverter<ELEMENT_DIM,SPACE_DIM>::Write()
 {
+    std::vector<std::string> variable_names = this->mpReader->GetVariableNames();
 
-    std::string filename = "";
-    if (this->mDatasetNames[this->mOpenDatasetIndex] == "Data")
-    {
-        filename += this->mFileBaseName + "_";
-    }
-    filename += type + ".dat";
-
-    out_stream p_file = out_stream(nullptr);
+    // Open one file per variable, so that the HDF5 file is streamed through only once
+    std::vector<out_stream> files(variable_names.size());
     if (PetscTools::AmMaster())
     {
-        p_file = this->mpOutputFileHandler->OpenOutputFile(filename);
-
-        // Check how many digits are to be output in the solution (0 goes to default value of digits)
-        if (this->mPrecision != 0)
+        for (unsigned var_index=0; var_index<variable_names.size(); var_index++)
         {
-           p_file->precision(this->mPrecision);
+            std::string filename = "";
+            if (this->mDatasetNames[this->mOpenDatasetIndex] == "Data")
+            {
+                filename += this->mFileBaseName + "_";
+            }
+            filename += variable_names[var_index] + ".dat";
+
+            files[var_index] = this->mpOutputFileHandler->OpenOutputFile(filename);
+
+            // Check how many digits are to be output in the solution (0 goes to default value of digits)
+            if (this->mPrecision != 0)
+            {
+               files[var_index]->precision(this->mPrecision);
+            }
         }
     }
 
     unsigned num_nodes = this->mpReader->GetNumberOfRows();
-    unsigned num_timesteps = this->mpReader->GetUnlimitedDimensionValues().size();
+    unsigned num_timesteps = this->mTimeValues.size();
 
     DistributedVectorFactory factory(num_nodes);
 
+    // Each process reads its own nodes; only the master, which writes the files, sees them all
     Vec data = factory.CreateVec();
-    ReplicatableVector repl_data(num_nodes);
+    std::vector<double> master_data;
+    Hdf5DataBlock block;
+    unsigned end_of_block = 0;
     for (unsigned time_step=0; time_step<num_timesteps; time_step++)
     {
-        this->mpReader->GetVariableOverNodes(data, type, time_step);
-        repl_data.ReplicatePetscVector(data);
-
-        assert(repl_data.GetSize() == num_nodes);
+        if (time_step == end_of_block)
+        {
+            end_of_block += this->ReadTimestepBlock(time_step, data, block);
+        }
 
-        if (PetscTools::AmMaster())
+        for (unsigned var_index=0; var_index<variable_names.size(); var_index++)
         {
-            for (unsigned i=0; i<num_nodes; i++)
+            this->CopyBlockToVec(block, time_step, var_index, data);
+            this->ConcentrateVecOnMaster(data, master_data);
+
+            if (PetscTools::AmMaster())
             {
-                *p_file << repl_data[i] << "\n";
+                assert(master_data.size() == num_nodes);
+                for (unsigned i=0; i<num_nodes; i++)
+                {
+                    *files[var_index] << master_data[i] << "\n";
+                }
             }
         }
     }
@@ -93,8 +107,11 @@ void Hdf5ToMeshalyzerConverter<ELEMENT_DIM,SPACE_DIM>::Write(std::string type)
     if (PetscTools::AmMaster())
     {
         std::string comment = "# " + ChasteBuildInfo::GetProvenanceString();
-        *p_file << comment;
-        p_file->close();
+        for (unsigned var_index=0; var_index<variable_names.size(); var_index++)
+        {
+            *files[var_index] << comment;
+            files[var_index]->close();
+        }
     }
 }
 
@@ -108,11 +125,7 @@ Hdf5ToMeshalyzerConverter<ELEMENT_DIM,SPACE_DIM>::Hdf5ToMeshalyzerConverter(cons
 {
     do
     {
-        std::vector<std::string> variable_names = this->mpReader->GetVariableNames();
-        for (unsigned i=0; i<variable_names.size(); i++)
-        {
-            Write(variable_names[i]);
-        }
+        Write();
     }
     while ( this->MoveOntoNextDataset() );
 
@@ -63,13 +63,10 @@ class Hdf5ToMeshalyzerConverter : public AbstractHdf5Converter<ELEMENT_DIM, SPAC
 private:
 
     /**
-     * A helper method which takes in a string, which must be 'V' or 'Phi_e'
-     * and reads the data corresponding to that string, writing it out in
-     * meshalyzer format.
-     *
-     * @param type the type of data stored in this file (V/Phi_e)
+     * A helper method which reads every variable in the open dataset (e.g. 'V' and 'Phi_e')
+     * in a single pass through the file, writing each out to its own file in meshalyzer format.
      */
-    void Write(std::string type);
+    void Write();
 
 public:
 
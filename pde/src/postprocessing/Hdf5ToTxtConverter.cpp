@@ -37,9 +37,6 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "Hdf5ToTxtConverter.hpp"
 #include "PetscTools.hpp"
 #include "Exception.hpp"
-#include "ReplicatableVector.hpp"
-#include "DistributedVector.hpp"
-#include "DistributedVectorFactory.hpp"
 #include "DistributedTetrahedralMesh.hpp"
 #include "Warnings.hpp"
 
@@ -56,43 +53,40 @@ Hdf5ToTxtConverter<ELEMENT_DIM, SPACE_DIM>::Hdf5ToTxtConverter(const FileFinder&
     OutputFileHandler handler(output_directory);
 
     unsigned num_nodes = pMesh->GetNumNodes();
-    unsigned num_timesteps = this->mpReader->GetUnlimitedDimensionValues().size();
 
-    DistributedVectorFactory* p_factory = pMesh->GetDistributedVectorFactory();
-    Vec data = p_factory->CreateVec();
-    ReplicatableVector repl_data(num_nodes);
+    // There is one file per time step and variable, so each process converts its own share of
+    // the time steps for the whole mesh
+    unsigned lo, hi;
+    this->GetLocalTimestepRange(lo, hi);
+    std::vector<std::string> variable_names = this->mpReader->GetVariableNames();
 
-    // Loop over time steps
-    for (unsigned time_step=0; time_step<num_timesteps; time_step++)
+    // Loop over time steps, reading a chunk's worth of them at a time
+    Hdf5DataBlock block;
+    unsigned end_of_block = lo;
+    for (unsigned time_step=lo; time_step<hi; time_step++)
     {
+        if (time_step == end_of_block)
+        {
+            end_of_block += this->ReadWholeTimestepBlock(time_step, hi, block);
+        }
+
         // Loop over variables
         for (unsigned var_index=0; var_index<this->mNumVariables; var_index++)
         {
-            std::string variable_name = this->mpReader->GetVariableNames()[var_index];
-
             // Create a .txt file for this time step and this variable
             std::stringstream file_name;
-            file_name << rFileBaseName << "_" << variable_name << "_" << time_step << ".txt";
+            file_name << rFileBaseName << "_" << variable_names[var_index] << "_" << time_step << ".txt";
             out_stream p_file = handler.OpenOutputFile(file_name.str());
 
-            this->mpReader->GetVariableOverNodes(data, variable_name, time_step);
-            repl_data.ReplicatePetscVector(data);
-
-            assert(repl_data.GetSize() == num_nodes);
-
-            if (PetscTools::AmMaster())
+            for (unsigned i=0; i<num_nodes; i++)
             {
-                for (unsigned i=0; i<num_nodes; i++)
-                {
-                    *p_file << repl_data[i] << "\n";
-                }
+                *p_file << block.GetValue(time_step, i, var_index) << "\n";
             }
             p_file->close();
         }
     }
 
-    // Tidy up
-    PetscTools::Destroy(data);
+    PetscTools::Barrier("Hdf5ToTxtConverter");
 }
 
 // Explicit instantiation
@@ -41,7 +41,6 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "Hdf5ToVtkConverter.hpp"
 #include "PetscTools.hpp"
 #include "Exception.hpp"
-#include "ReplicatableVector.hpp"
 #include "DistributedVector.hpp"
 #include "DistributedVectorFactory.hpp"
 #include "VtkMeshWriter.hpp"
@@ -111,27 +110,31 @@ Hdf5ToVtkConverter<ELEMENT_DIM, SPACE_DIM>::Hdf5ToVtkConverter(
     // HDF5 dataset.
     assert(this->mpReader->GetNumberOfRows() == pMesh->GetNumNodes());
 
-    unsigned num_timesteps =
-        this->mpReader->GetUnlimitedDimensionValues().size();
+    unsigned num_timesteps = this->mTimeValues.size();
 
-    // Loop over time steps
+    // Loop over time steps, reading a chunk's worth of them at a time
+    Hdf5DataBlock block;
+    unsigned end_of_block = 0;
     for (unsigned time_step = 0; time_step < num_timesteps; time_step++) {
+      if (time_step == end_of_block) {
+        end_of_block += this->ReadTimestepBlock(time_step, data, block);
+      }
       // Loop over variables
       for (unsigned variable = 0; variable < this->mNumVariables; variable++) {
         std::string variable_name =
             this->mpReader->GetVariableNames()[variable];
 
-        // Gets variable at this time step from HDF5 archive
-        this->mpReader->GetVariableOverNodes(data, variable_name, time_step);
+        // Gets variable at this time step from the block read from HDF5
+        this->CopyBlockToVec(block, time_step, variable, data);
 
         std::vector<double> data_for_vtk;
-        data_for_vtk.resize(num_nodes);
         std::ostringstream variable_point_data_name;
         variable_point_data_name << variable_name << "_" << std::setw(6) <<
             std::setfill('0') << time_step;
 
         if (parallelVtk) {
           // Parallel VTU files
+          data_for_vtk.resize(num_nodes);
           double *p_data;
           VecGetArray(data, &p_data);
           for (unsigned index = 0; index < num_nodes; index++) {
@@ -140,11 +143,13 @@ Hdf5ToVtkConverter<ELEMENT_DIM, SPACE_DIM>::Hdf5ToVtkConverter(
           VecRestoreArray(data, &p_data);
         }
         else {
-          // One VTU file
-          ReplicatableVector repl_data(data);
-          for (unsigned index = 0; index < num_nodes; index++) {
-            data_for_vtk[index] = repl_data[index];
+          // One VTU file, which only the master writes, so only the
+          // master needs to hold the data
+          this->ConcentrateVecOnMaster(data, data_for_vtk);
+          if (!PetscTools::AmMaster()) {
+            continue;
           }
+          assert(data_for_vtk.size() == num_nodes);
         }
         // Add this variable into the node "point" data
         vtk_writer.AddPointData(variable_point_data_name.str(),
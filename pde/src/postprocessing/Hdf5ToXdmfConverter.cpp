@@ -43,14 +43,14 @@ Hdf5ToXdmfConverter<ELEMENT_DIM, SPACE_DIM>::Hdf5ToXdmfConverter(const FileFinde
       XdmfMeshWriter<ELEMENT_DIM,SPACE_DIM>(rInputDirectory.GetRelativePath(FileFinder("", RelativeTo::ChasteTestOutput)) + "/xdmf_output",
                                             rFileBaseName, false /* Not cleaning directory*/)
 {
-    // Set number of time steps
-    std::vector<double> time_values = this->mpReader->GetUnlimitedDimensionValues();
-    unsigned num_timesteps = time_values.size();
+    // Set number of time steps. The data themselves are never copied: the master file just
+    // describes hyperslabs of the original HDF5 dataset.
+    unsigned num_timesteps = this->mTimeValues.size();
     this->mNumberOfTimePoints = num_timesteps;
     // Set time step size
     if (num_timesteps > 1)
     {
-        this->mTimeStep = time_values[1] - time_values[0];
+        this->mTimeStep = this->mTimeValues[1] - this->mTimeValues[0];
     }
     // Write
     this->WriteFilesUsingMesh(*pMesh);
@@ -66,12 +66,14 @@ void Hdf5ToXdmfConverter<ELEMENT_DIM, SPACE_DIM>::AddDataOnNodes(XERCES_CPP_NAME
     // Use xerces namespace for convenience
     XERCES_CPP_NAMESPACE_USE
 
-    unsigned num_timesteps = this->mpReader->GetUnlimitedDimensionValues().size();
+    // Called for every time step, so use the cached time values rather than going back to the file
+    unsigned num_timesteps = this->mTimeValues.size();
+    std::vector<std::string> variable_names = this->mpReader->GetVariableNames();
 
     // Loop over variables
     for (unsigned var_index=0; var_index<this->mNumVariables; var_index++)
     {
-        std::string variable_name = this->mpReader->GetVariableNames()[var_index];
+        const std::string& variable_name = variable_names[var_index];
 
         /*
          * e.g. <Attribute Center="Node" Name="V">
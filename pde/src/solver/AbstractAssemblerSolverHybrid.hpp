@@ -141,8 +141,8 @@ void AbstractAssemblerSolverHybrid<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM, INTERPOL
     pLinearSystem->FinaliseRhsVector();
     pLinearSystem->SwitchWriteModeLhsMatrix();
 
-    // add Dirichlet BCs
-    mpBoundaryConditions->ApplyDirichletToLinearProblem(*pLinearSystem, true);
+    // add Dirichlet BCs (the matrix only needs modifying if it has just been assembled)
+    mpBoundaryConditions->ApplyDirichletToLinearProblem(*pLinearSystem, computeMatrix);
 
 //// #2033 - see Test2dHeatEquationWithPeriodicBcs in TestSimpleLinearEllipticSolver.hpp
     //mpBoundaryConditions->ApplyPeriodicBcsToLinearProblem(*pLinearSystem, true);
@@ -48,6 +48,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "Hdf5DataWriter.hpp"
 #include "Hdf5ToVtkConverter.hpp"
 #include "Hdf5ToTxtConverter.hpp"
+#include "InitialGuessGenerator.hpp"
 
 /**
  * Abstract class for dynamic linear PDE solves.
@@ -140,6 +141,64 @@ class AbstractDynamicLinearPdeSolver :
   /** List of variable column IDs as written to HDF5 file. */
   std::vector<int> mVariableColumnIds;
 
+  /**
+   * Generates the initial guess for each linear solve from previous
+   * solutions. Defaults to using the previous solution.
+   */
+  InitialGuessGenerator mInitialGuessGenerator;
+
+  /**
+   * Whether to update the LHS matrix from stored parts when the time
+   * adaptivity controller changes the timestep, rather than
+   * reassembling it. Defaults to true.
+   */
+  bool mUpdateMatrixOnTimeStepChange;
+
+  /**
+   * The LHS matrix from the first full assembly, kept until a second
+   * assembly at a different timestep lets it be split into M and K
+   * (see UpdateMatrixForTimeStep()).
+   */
+  Mat mFirstAssembledLhs;
+
+  /** The timestep at which #mFirstAssembledLhs was assembled. */
+  double mFirstAssembledTimeStep;
+
+  /** The part M of the LHS matrix A = M/dt + K that scales with 1/dt. */
+  Mat mTimeDerivativeMatrix;
+
+  /** The part K of the LHS matrix A = M/dt + K that doesn't depend on dt. */
+  Mat mTimeIndependentMatrix;
+
+  /**
+   * @return whether the LHS matrix can be split into M/dt + K and
+   * updated from the parts: the matrix must be constant apart from
+   * the timestep, assembled (not matrix-free), used to build the
+   * preconditioner, and without symmetric Dirichlet conditions (whose
+   * lifting is computed from the unmodified matrix).
+   */
+  bool CanUpdateMatrixForTimeStep();
+
+  /**
+   * Record the LHS matrix just assembled at timestep dt. Once matrices
+   * at two sufficiently different timesteps have been seen, the
+   * LHS is split into M and K.
+   *
+   * @param dt  the timestep the matrix was assembled for
+   */
+  void StoreAssembledMatrix(double dt);
+
+  /**
+   * Set the LHS matrix to M/dt + K, if it has been split.
+   *
+   * @param dt  the new timestep
+   * @return whether the matrix was updated
+   */
+  bool UpdateMatrixForTimeStep(double dt);
+
+  /** Free the stored parts of the LHS matrix. */
+  void ClearStoredMatrices();
+
   /**
    * Create and initialise the HDF5 writer.
    * Called by Solve() if results are to be output.
@@ -165,6 +224,9 @@ class AbstractDynamicLinearPdeSolver :
     explicit AbstractDynamicLinearPdeSolver(
         AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>* pMesh);
 
+    /** Destructor. */
+    virtual ~AbstractDynamicLinearPdeSolver();
+
     /**
      * Set the times to solve between.
      *
@@ -209,6 +271,19 @@ class AbstractDynamicLinearPdeSolver :
     void SetTimeAdaptivityController(
         AbstractTimeAdaptivityController* pTimeAdaptivityController);
 
+    /**
+     * Set whether, when the time adaptivity controller changes the
+     * timestep of a constant matrix, the LHS matrix is formed as
+     * M/dt + K from parts stored on the first change, rather than
+     * reassembled. The parts are found from full assemblies at two
+     * different timesteps, and cost two extra matrices of storage.
+     * This is skipped automatically when it isn't valid (see
+     * CanUpdateMatrixForTimeStep()).
+     *
+     * @param update  whether to update the matrix (defaults to true)
+     */
+    void SetUpdateMatrixOnTimeStepChange(bool update);
+
     /**
      * @param output whether to output to VTK (.vtu) file
      */
@@ -239,6 +314,22 @@ class AbstractDynamicLinearPdeSolver :
      * other files.
      */
     void SetPrintingTimestepMultiple(unsigned multiple);
+
+    /**
+     * Set how the initial guess for each linear solve is formed from
+     * previous solutions. The history is kept across calls to Solve()
+     * as long as each call starts where the previous one ended.
+     *
+     * @param type how to form the initial guess
+     * @param numPreviousSolutions the number of previous solutions
+     * kept by the PROJECTION method
+     */
+    void SetInitialGuessType(
+        InitialGuessType type
+      , unsigned numPreviousSolutions = 4u);
+
+    /** @return how the initial guess for each linear solve is formed */
+    InitialGuessType GetInitialGuessType() const;
 };
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
@@ -302,9 +393,111 @@ AbstractDynamicLinearPdeSolver<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
         mOutputDirectory(""),
         mFilenamePrefix(""),
         mPrintingTimestepMultiple(1),
-        mpHdf5Writer(nullptr)
+        mpHdf5Writer(nullptr),
+        mUpdateMatrixOnTimeStepChange(true),
+        mFirstAssembledLhs(nullptr),
+        mFirstAssembledTimeStep(0.0),
+        mTimeDerivativeMatrix(nullptr),
+        mTimeIndependentMatrix(nullptr)
 {}
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
+AbstractDynamicLinearPdeSolver<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
+    ~AbstractDynamicLinearPdeSolver()
+{
+  ClearStoredMatrices();
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
+bool AbstractDynamicLinearPdeSolver<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
+    CanUpdateMatrixForTimeStep()
+{
+  if (!mUpdateMatrixOnTimeStepChange || !mMatrixIsConstant ||
+      mpTimeAdaptivityController == nullptr) {
+    return false;
+  }
+  PetscBool lhs_is_shell;
+  PetscObjectTypeCompare((PetscObject)this->mpLinearSystem->rGetLhsMatrix(),
+      MATSHELL, &lhs_is_shell);
+  return !lhs_is_shell &&
+      !this->mpLinearSystem->IsPrecondMatrixDifferentFromLhs() &&
+      this->mpLinearSystem->rGetDirichletBoundaryConditionsVector() ==
+          nullptr;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
+void AbstractDynamicLinearPdeSolver<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
+    StoreAssembledMatrix(double dt)
+{
+  if (mTimeDerivativeMatrix != nullptr || !CanUpdateMatrixForTimeStep()) {
+    return;
+  }
+  this->mpLinearSystem->FinaliseLhsMatrix();
+  Mat& r_lhs = this->mpLinearSystem->rGetLhsMatrix();
+
+  /*
+   * A = M/dt + K, so from A1 at dt1 and A2 at dt2
+   *   M = (A2 - A1)/(1/dt2 - 1/dt1),  K = A2 - M/dt2.
+   * Matrices at nearly equal timesteps would give M with large
+   * cancellation errors, so wait for a change of at least 1%.
+   */
+  double inverse_dt_change = (mFirstAssembledLhs == nullptr) ? 0.0 :
+      1.0/dt - 1.0/mFirstAssembledTimeStep;
+  if (fabs(inverse_dt_change)*dt < 1e-2) {
+    if (mFirstAssembledLhs == nullptr) {
+      MatDuplicate(r_lhs, MAT_COPY_VALUES, &mFirstAssembledLhs);
+    }
+    else {
+      MatCopy(r_lhs, mFirstAssembledLhs, SAME_NONZERO_PATTERN);
+    }
+    mFirstAssembledTimeStep = dt;
+    return;
+  }
+
+  MatDuplicate(r_lhs, MAT_COPY_VALUES, &mTimeDerivativeMatrix);
+  MatAXPY(mTimeDerivativeMatrix, -1.0, mFirstAssembledLhs,
+      SAME_NONZERO_PATTERN);
+  MatScale(mTimeDerivativeMatrix, 1.0/inverse_dt_change);
+
+  MatDuplicate(r_lhs, MAT_COPY_VALUES, &mTimeIndependentMatrix);
+  MatAXPY(mTimeIndependentMatrix, -1.0/dt, mTimeDerivativeMatrix,
+      SAME_NONZERO_PATTERN);
+
+  PetscTools::Destroy(mFirstAssembledLhs);
+  mFirstAssembledLhs = nullptr;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
+bool AbstractDynamicLinearPdeSolver<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
+    UpdateMatrixForTimeStep(double dt)
+{
+  if (mTimeDerivativeMatrix == nullptr || !CanUpdateMatrixForTimeStep()) {
+    return false;
+  }
+  Mat& r_lhs = this->mpLinearSystem->rGetLhsMatrix();
+  MatCopy(mTimeIndependentMatrix, r_lhs, SAME_NONZERO_PATTERN);
+  MatAXPY(r_lhs, 1.0/dt, mTimeDerivativeMatrix, SAME_NONZERO_PATTERN);
+  return true;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
+void AbstractDynamicLinearPdeSolver<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
+    ClearStoredMatrices()
+{
+  if (mFirstAssembledLhs != nullptr) {
+    PetscTools::Destroy(mFirstAssembledLhs);
+    mFirstAssembledLhs = nullptr;
+  }
+  if (mTimeDerivativeMatrix != nullptr) {
+    PetscTools::Destroy(mTimeDerivativeMatrix);
+    mTimeDerivativeMatrix = nullptr;
+  }
+  if (mTimeIndependentMatrix != nullptr) {
+    PetscTools::Destroy(mTimeIndependentMatrix);
+    mTimeIndependentMatrix = nullptr;
+  }
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
 void AbstractDynamicLinearPdeSolver<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
     SetTimes(
@@ -381,6 +574,18 @@ Vec AbstractDynamicLinearPdeSolver<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
 
   this->InitialiseForSolve(mInitialCondition);
 
+  // Keep the history of solutions only if we are carrying on from where
+  // the last call to Solve() ended
+  bool use_guess_generator =
+      (mInitialGuessGenerator.GetType() != PREVIOUS_SOLUTION);
+  if (use_guess_generator) {
+    if (mInitialGuessGenerator.GetNumStoredSolutions() == 0 ||
+        fabs(mInitialGuessGenerator.GetLastTime() - mTstart) > 1e-10) {
+      mInitialGuessGenerator.Reset();
+      mInitialGuessGenerator.AddSolution(mInitialCondition, mTstart);
+    }
+  }
+
   // hasn't been set, so a controller must have been given
   if (mIdealTimeStep < 0) {
     mIdealTimeStep = mpTimeAdaptivityController->GetNextTimeStep(mTstart,
@@ -400,6 +605,10 @@ Vec AbstractDynamicLinearPdeSolver<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
 
   Vec solution = mInitialCondition;
   Vec next_solution;
+  Vec guess = nullptr;
+  if (use_guess_generator) {
+    VecDuplicate(mInitialCondition, &guess);
+  }
 
   while (!stepper.IsTimeAtEnd()) {
     bool timestep_changed = false;
@@ -459,21 +668,43 @@ Vec AbstractDynamicLinearPdeSolver<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
         PetscTools::Destroy(solution);
         HeartEventHandler::EndEvent(HeartEventHandler::COMMUNICATION);
       }
+      if (guess != nullptr) {
+        PetscTools::Destroy(guess);
+      }
       throw e;
     }
 
     bool compute_matrix = (!mMatrixIsConstant || !mMatrixIsAssembled ||
         timestep_changed);
 
+    // A change of timestep alone may not need the matrix reassembling
+    bool matrix_updated = false;
+    if (timestep_changed && mMatrixIsConstant && mMatrixIsAssembled) {
+      matrix_updated = UpdateMatrixForTimeStep(new_dt);
+      compute_matrix = !matrix_updated;
+    }
+
     this->SetupLinearSystem(solution, compute_matrix);
 
     this->FinaliseLinearSystem(solution);
 
-    if (compute_matrix) {
+    if (compute_matrix && mMatrixIsConstant) {
+      StoreAssembledMatrix(new_dt);
+    }
+
+    if (compute_matrix || matrix_updated) {
       this->mpLinearSystem->ResetKspSolver();
     }
 
-    next_solution = this->mpLinearSystem->Solve(solution);
+    if (use_guess_generator) {
+      mInitialGuessGenerator.ComputeGuess(guess, stepper.GetNextTime(),
+          this->mpLinearSystem->rGetLhsMatrix(),
+          this->mpLinearSystem->rGetRhsVector());
+      next_solution = this->mpLinearSystem->Solve(guess);
+    }
+    else {
+      next_solution = this->mpLinearSystem->Solve(solution);
+    }
 
     if (mMatrixIsConstant) {
       mMatrixIsAssembled = true;
@@ -481,6 +712,11 @@ Vec AbstractDynamicLinearPdeSolver<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
 
     this->FollowingSolveLinearSystem(next_solution);
 
+    if (use_guess_generator) {
+      mInitialGuessGenerator.AddSolution(next_solution,
+          stepper.GetNextTime());
+    }
+
     stepper.AdvanceOneTimeStep();
 
     // Avoid memory leaks
@@ -501,6 +737,9 @@ Vec AbstractDynamicLinearPdeSolver<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
   }
 
   // Avoid memory leaks
+  if (guess != nullptr) {
+    PetscTools::Destroy(guess);
+  }
   if (mpHdf5Writer != nullptr) {
     delete mpHdf5Writer;
     mpHdf5Writer = nullptr;
@@ -532,6 +771,8 @@ void AbstractDynamicLinearPdeSolver<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
     SetMatrixIsNotAssembled()
 {
   mMatrixIsAssembled = false;
+  // The stored parts of the matrix may be out of date too
+  ClearStoredMatrices();
 }
 
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
@@ -544,6 +785,16 @@ void AbstractDynamicLinearPdeSolver<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
   mpTimeAdaptivityController = pTimeAdaptivityController;
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
+void AbstractDynamicLinearPdeSolver<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
+    SetUpdateMatrixOnTimeStepChange(bool update)
+{
+  mUpdateMatrixOnTimeStepChange = update;
+  if (!update) {
+    ClearStoredMatrices();
+  }
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
 void AbstractDynamicLinearPdeSolver<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
     SetOutputToVtk(bool output)
@@ -582,4 +833,20 @@ void AbstractDynamicLinearPdeSolver<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
   mPrintingTimestepMultiple = multiple;
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
+void AbstractDynamicLinearPdeSolver<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::
+    SetInitialGuessType(
+        InitialGuessType type
+      , unsigned numPreviousSolutions)
+{
+  mInitialGuessGenerator.SetType(type, numPreviousSolutions);
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
+InitialGuessType AbstractDynamicLinearPdeSolver<ELEMENT_DIM, SPACE_DIM,
+    PROBLEM_DIM>::GetInitialGuessType() const
+{
+  return mInitialGuessGenerator.GetType();
+}
+
 #endif /*ABSTRACTDYNAMICLINEARPDESOLVER_HPP_*/
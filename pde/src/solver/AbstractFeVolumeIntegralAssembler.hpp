@@ -36,11 +36,17 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef ABSTRACTFEVOLUMEINTEGRALASSEMBLER_HPP_
 #define ABSTRACTFEVOLUMEINTEGRALASSEMBLER_HPP_
 
+#include <algorithm>
+#include <vector>
+
 #include "AbstractFeAssemblerCommon.hpp"
 #include "GaussianQuadratureRule.hpp"
+#include "OpenMpExceptionCollector.hpp"
 #include "BoundaryConditionsContainer.hpp"
 #include "PetscVecTools.hpp"
 #include "PetscMatTools.hpp"
+#include "PetscMatSlotMap.hpp"
+#include "PetscVecHaloScatter.hpp"
 
 /**
  *
@@ -250,7 +256,187 @@ class AbstractFeVolumeIntegralAssembler :
     return true;
   }
 
+  /**
+   * @return true if AssembleOnElement() may be called for different
+   *         elements at the same time (see SetNumberOfAssemblyThreads()).
+   *         This holds as long as ComputeMatrixTerm(), ComputeVectorTerm()
+   *         and GetCurrentSolutionOrGuessValue() only read shared data.
+   *         Concrete assemblers which store interpolated quantities in
+   *         members (see ResetInterpolatedQuantities()) must return false.
+   */
+  virtual bool IsThreadSafe() const
+  {
+    return true;
+  }
+
+ private:
+  /** Number of threads computing element contributions in DoAssemble(). */
+  unsigned mNumAssemblyThreads;
+
+  /** Whether to add element matrices through mpMatrixSlotMap. */
+  bool mUsePrecomputedSparsityPattern;
+
+  /**
+   * Positions of the element matrix entries in the values of the matrix
+   * being assembled, if mUsePrecomputedSparsityPattern is set.
+   */
+  PetscMatSlotMap* mpMatrixSlotMap;
+
+  /** Global indices of the elements mpMatrixSlotMap was built for, in order. */
+  std::vector<unsigned> mSlotMapElementIndices;
+
+  /**
+   * Threaded version of the element loop in DoAssemble(). Element
+   * contributions are computed concurrently in batches, then added to
+   * the PETSc matrix/vector by a single thread, since PETSc insertion is
+   * not thread safe.
+   *
+   * @param rElements The elements to assemble on.
+   * @param pSlotMap The slot map to add element matrices with, or nullptr.
+   */
+  void DoAssembleWithThreads(
+      const std::vector<Element<ELEMENT_DIM, SPACE_DIM>*>& rElements
+    , PetscMatSlotMap* pSlotMap);
+
+  /**
+   * Add the contribution of one element to the matrix and/or vector
+   * being assembled.
+   *
+   * @param rElement The element.
+   * @param elementOrdinal The position of the element in the list of
+   *        elements being assembled on.
+   * @param rAElem The element matrix.
+   * @param rBElem The element vector.
+   * @param pSlotMap The slot map to add the element matrix with, or
+   *        nullptr to use MatSetValues().
+   */
+  void AddElementContribution(
+      Element<ELEMENT_DIM, SPACE_DIM>& rElement
+    , unsigned elementOrdinal
+    , c_matrix<double, PROBLEM_DIM * (ELEMENT_DIM + 1),
+          PROBLEM_DIM * (ELEMENT_DIM + 1)>& rAElem
+    , c_vector<double, PROBLEM_DIM * (ELEMENT_DIM + 1)>& rBElem
+    , PetscMatSlotMap* pSlotMap);
+
+  /**
+   * @return the slot map to add element matrices with during this
+   *         assembly, building it if necessary, or nullptr if
+   *         MatSetValues() has to be used.
+   *
+   * @param rElements The elements to be assembled on, in order.
+   */
+  PetscMatSlotMap* GetMatrixSlotMap(
+      const std::vector<Element<ELEMENT_DIM, SPACE_DIM>*>& rElements);
+
+  /**
+   * Fetches the entries of the input of a matrix-free product that the
+   * locally owned elements need from other processes. Built on the first
+   * product, and again if the layout of the input changes.
+   */
+  PetscVecHaloScatter* mpMatrixFreeHalo;
+
+  /**
+   * Loop over the locally owned elements, computing the element matrix
+   * on the fly, and either add A*x (if pInput is given) or the diagonal
+   * of A into the locally owned entries of the output.
+   *
+   * @param pInput The vector to multiply, with its halo fetched, or
+   *        nullptr to compute the diagonal.
+   * @param output The distributed output vector.
+   */
+  void ApplyElementMatrices(PetscVecHaloScatter* pInput, Vec output);
+
+  /**
+   * MATOP_MULT callback for the shell matrix created by
+   * CreateMatrixFreeOperator().
+   *
+   * @param matrix The shell matrix, whose context is the assembler.
+   * @param x The vector to multiply.
+   * @param y The result.
+   * @return PETSc error code.
+   */
+  static PetscErrorCode MatrixFreeMult(Mat matrix, Vec x, Vec y);
+
+  /**
+   * MATOP_GET_DIAGONAL callback for the shell matrix created by
+   * CreateMatrixFreeOperator(), so that Jacobi preconditioning can be
+   * used without assembling the matrix.
+   *
+   * @param matrix The shell matrix, whose context is the assembler.
+   * @param diagonal The diagonal.
+   * @return PETSc error code.
+   */
+  static PetscErrorCode MatrixFreeGetDiagonal(Mat matrix, Vec diagonal);
+
  public:
+  /**
+   * Compute y = A*x, where A is the matrix that AssembleMatrix() would
+   * assemble, by applying the element matrices on the fly. A is never
+   * stored, trading repeated element integration for memory.
+   *
+   * Only the entries of x that the locally owned elements reference are
+   * fetched from other processes, through a scatter that is built on the
+   * first product and then reused.
+   *
+   * @param x The vector to multiply.
+   * @param y The result, with the same parallel layout as x.
+   */
+  void MultiplyMatrixFree(Vec x, Vec y);
+
+  /**
+   * Compute the diagonal of the matrix that AssembleMatrix() would
+   * assemble, without storing the matrix.
+   *
+   * @param diagonal The diagonal, filled in.
+   */
+  void GetMatrixFreeDiagonal(Vec diagonal);
+
+  /**
+   * Create a PETSc shell matrix whose action is that of the matrix this
+   * assembler would assemble (see MultiplyMatrixFree()). The shell also
+   * provides its diagonal, so it may be used with the "jacobi" and "none"
+   * preconditioners. The assembler must outlive the shell matrix, which
+   * the caller is responsible for destroying.
+   *
+   * @param rMatrix The shell matrix to create.
+   * @param templateVector A vector with the layout of the unknowns.
+   */
+  void CreateMatrixFreeOperator(Mat& rMatrix, Vec templateVector);
+
+  /**
+   * Set the number of threads used to compute element contributions
+   * during assembly. This only has an effect if Chaste was built with
+   * Chaste_USE_OPENMP and the concrete assembler IsThreadSafe();
+   * otherwise elements are assembled serially.
+   *
+   * @param numThreads  the number of threads (at least 1)
+   */
+  void SetNumberOfAssemblyThreads(unsigned numThreads);
+
+  /** @return the number of threads used for assembly. */
+  unsigned GetNumberOfAssemblyThreads() const
+  {
+    return mNumAssemblyThreads;
+  }
+
+  /**
+   * Re-assemble the matrix by adding element matrices straight into its
+   * compressed row storage, at positions looked up once (see
+   * PetscMatSlotMap), instead of calling MatSetValues() per element.
+   *
+   * The positions are looked up at the first assembly after the matrix
+   * has been assembled and finalised, so the first assembly always uses
+   * MatSetValues(). They are looked up again if a different matrix or
+   * set of elements is assembled. If the matrix is not AIJ, or does not
+   * contain every element entry, MatSetValues() is used as before.
+   *
+   * Call this method again if the nonzero structure of the matrix is
+   * changed by other means.
+   *
+   * @param usePattern Whether to use the precomputed pattern.
+   */
+  void SetUsePrecomputedSparsityPattern(bool usePattern = true);
+
     /**
      * Constructor.
      *
@@ -265,6 +451,8 @@ class AbstractFeVolumeIntegralAssembler :
     virtual ~AbstractFeVolumeIntegralAssembler()
     {
       delete mpQuadRule;
+      delete mpMatrixSlotMap;
+      delete mpMatrixFreeHalo;
     }
 };
 
@@ -277,7 +465,11 @@ AbstractFeVolumeIntegralAssembler<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM,
         AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>* pMesh)
       : AbstractFeAssemblerCommon<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM,
             CAN_ASSEMBLE_VECTOR, CAN_ASSEMBLE_MATRIX, INTERPOLATION_LEVEL>(),
-        mpMesh(pMesh)
+        mpMesh(pMesh),
+        mNumAssemblyThreads(1u),
+        mUsePrecomputedSparsityPattern(false),
+        mpMatrixSlotMap(nullptr),
+        mpMatrixFreeHalo(nullptr)
 {
   assert(pMesh);
   // Default to 2nd order quadrature.  Our default basis functions are
@@ -316,17 +508,248 @@ void AbstractFeVolumeIntegralAssembler<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM,
   if (this->mAssembleMatrix && this->mZeroMatrixBeforeAssembly)
       PetscMatTools::Zero(this->mMatrixToAssemble);
 
+  // Test for ownership first, since it's pointless to test the
+  // criterion on something which we might know nothing about.
+  std::vector<Element<ELEMENT_DIM, SPACE_DIM>*> elements;
+  for (auto iter = mpMesh->GetElementIteratorBegin();
+      iter != mpMesh->GetElementIteratorEnd(); ++iter) {
+    if (iter->GetOwnership() == true &&
+        ElementAssemblyCriterion(*iter) == true) {
+      elements.push_back(&(*iter));
+    }
+  }
+
+  PetscMatSlotMap* p_slot_map = GetMatrixSlotMap(elements);
+  if (p_slot_map) p_slot_map->BeginAdding();
+
+  try {
+#ifdef CHASTE_OPENMP
+    if (mNumAssemblyThreads > 1u && IsThreadSafe()) {
+      DoAssembleWithThreads(elements, p_slot_map);
+    }
+    else
+#endif  // CHASTE_OPENMP
+    {
+      const size_t STENCIL_SIZE = PROBLEM_DIM * (ELEMENT_DIM + 1);
+      c_matrix<double, STENCIL_SIZE, STENCIL_SIZE> a_elem;
+      c_vector<double, STENCIL_SIZE> b_elem;
+
+      // Loop over elements
+      for (auto i = 0u; i < elements.size(); ++i) {
+        AssembleOnElement(*elements[i], a_elem, b_elem);
+        AddElementContribution(*elements[i], i, a_elem, b_elem,
+            p_slot_map);
+      }
+    }
+  }
+  catch (...) {
+    // Give the matrix values back before passing the error on
+    if (p_slot_map) p_slot_map->EndAdding();
+    throw;
+  }
+
+  if (p_slot_map) p_slot_map->EndAdding();
+
+  HeartEventHandler::EndEvent(assemble_event);
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM,
+    bool CAN_ASSEMBLE_VECTOR, bool CAN_ASSEMBLE_MATRIX,
+    InterpolationLevel INTERPOLATION_LEVEL>
+void AbstractFeVolumeIntegralAssembler<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM,
+    CAN_ASSEMBLE_VECTOR, CAN_ASSEMBLE_MATRIX, INTERPOLATION_LEVEL>::
+    AddElementContribution(
+        Element<ELEMENT_DIM, SPACE_DIM>& rElement
+      , unsigned elementOrdinal
+      , c_matrix<double, PROBLEM_DIM * (ELEMENT_DIM + 1),
+            PROBLEM_DIM * (ELEMENT_DIM + 1)>& rAElem
+      , c_vector<double, PROBLEM_DIM * (ELEMENT_DIM + 1)>& rBElem
+      , PetscMatSlotMap* pSlotMap)
+{
+  const size_t STENCIL_SIZE = PROBLEM_DIM * (ELEMENT_DIM + 1);
+  unsigned p_indices[STENCIL_SIZE];
+  rElement.GetStiffnessMatrixGlobalIndices(PROBLEM_DIM, p_indices);
+
+  if (this->mAssembleMatrix) {
+    if (pSlotMap) {
+      pSlotMap->AddStencil<STENCIL_SIZE>(elementOrdinal, rAElem);
+    }
+    else {
+      PetscMatTools::AddMultipleValues<STENCIL_SIZE>(
+          this->mMatrixToAssemble, p_indices, rAElem);
+    }
+  }
+  if (this->mAssembleVector) {
+    PetscVecTools::AddMultipleValues<STENCIL_SIZE>(
+        this->mVectorToAssemble, p_indices, rBElem);
+  }
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM,
+    bool CAN_ASSEMBLE_VECTOR, bool CAN_ASSEMBLE_MATRIX,
+    InterpolationLevel INTERPOLATION_LEVEL>
+PetscMatSlotMap* AbstractFeVolumeIntegralAssembler<ELEMENT_DIM, SPACE_DIM,
+    PROBLEM_DIM, CAN_ASSEMBLE_VECTOR, CAN_ASSEMBLE_MATRIX,
+    INTERPOLATION_LEVEL>::GetMatrixSlotMap(
+        const std::vector<Element<ELEMENT_DIM, SPACE_DIM>*>& rElements)
+{
+  if (!mUsePrecomputedSparsityPattern || !this->mAssembleMatrix)
+      return nullptr;
+
+  // Until the matrix has been assembled once its nonzero structure is not
+  // known, and once MatSetValues() has been called on it the values
+  // arrays cannot be written to directly
+  PetscBool is_assembled;
+  MatAssembled(this->mMatrixToAssemble, &is_assembled);
+  if (!is_assembled)
+      return nullptr;
+
+  // Re-use the existing map if it was built for this matrix and these
+  // elements, in this order
+  bool rebuild = (mpMatrixSlotMap == nullptr ||
+      mpMatrixSlotMap->GetMatrix() != this->mMatrixToAssemble ||
+      mSlotMapElementIndices.size() != rElements.size());
+  for (auto i = 0u; !rebuild && i < rElements.size(); ++i)
+      rebuild = (mSlotMapElementIndices[i] != rElements[i]->GetIndex());
+
+  if (rebuild) {
+    const size_t STENCIL_SIZE = PROBLEM_DIM * (ELEMENT_DIM + 1);
+    std::vector<PetscInt> stencil_indices;
+    stencil_indices.reserve(STENCIL_SIZE * rElements.size());
+    mSlotMapElementIndices.resize(rElements.size());
+    for (auto i = 0u; i < rElements.size(); ++i) {
+      unsigned p_indices[STENCIL_SIZE];
+      rElements[i]->GetStiffnessMatrixGlobalIndices(PROBLEM_DIM, p_indices);
+      stencil_indices.insert(stencil_indices.end(), p_indices,
+          p_indices + STENCIL_SIZE);
+      mSlotMapElementIndices[i] = rElements[i]->GetIndex();
+    }
+    delete mpMatrixSlotMap;
+    mpMatrixSlotMap = new PetscMatSlotMap(this->mMatrixToAssemble,
+        stencil_indices, STENCIL_SIZE);
+  }
+
+  return mpMatrixSlotMap->IsValid() ? mpMatrixSlotMap : nullptr;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM,
+    bool CAN_ASSEMBLE_VECTOR, bool CAN_ASSEMBLE_MATRIX,
+    InterpolationLevel INTERPOLATION_LEVEL>
+void AbstractFeVolumeIntegralAssembler<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM,
+    CAN_ASSEMBLE_VECTOR, CAN_ASSEMBLE_MATRIX, INTERPOLATION_LEVEL>::
+    SetUsePrecomputedSparsityPattern(bool usePattern)
+{
+  mUsePrecomputedSparsityPattern = usePattern;
+  delete mpMatrixSlotMap;
+  mpMatrixSlotMap = nullptr;
+  mSlotMapElementIndices.clear();
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM,
+    bool CAN_ASSEMBLE_VECTOR, bool CAN_ASSEMBLE_MATRIX,
+    InterpolationLevel INTERPOLATION_LEVEL>
+void AbstractFeVolumeIntegralAssembler<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM,
+    CAN_ASSEMBLE_VECTOR, CAN_ASSEMBLE_MATRIX, INTERPOLATION_LEVEL>::
+    DoAssembleWithThreads(
+        const std::vector<Element<ELEMENT_DIM, SPACE_DIM>*>& rElements
+      , PetscMatSlotMap* pSlotMap)
+{
+  const int num_elements = static_cast<int>(rElements.size());
+
+  // Fill the mesh's geometry cache now, rather than from inside the
+  // threads
+  if (num_elements > 0 && mpMesh->GetUseElementGeometryCache()) {
+    c_matrix<double, SPACE_DIM, ELEMENT_DIM> jacobian;
+    c_matrix<double, ELEMENT_DIM, SPACE_DIM> inverse_jacobian;
+    c_matrix<double, SPACE_DIM, ELEMENT_DIM + 1> grad_phi;
+    double jacobian_determinant;
+    mpMesh->GetElementGeometry(rElements[0]->GetIndex(), jacobian,
+        jacobian_determinant, inverse_jacobian, grad_phi);
+  }
+
+  // Element contributions are buffered a batch at a time, so the extra
+  // memory does not grow with the mesh
+  const size_t STENCIL_SIZE = PROBLEM_DIM * (ELEMENT_DIM + 1);
+  const int batch_size = 256 * static_cast<int>(mNumAssemblyThreads);
+  std::vector<c_matrix<double, STENCIL_SIZE, STENCIL_SIZE> > a_elems(
+      std::min(batch_size, num_elements));
+  std::vector<c_vector<double, STENCIL_SIZE> > b_elems(a_elems.size());
+
+  for (int batch_start = 0; batch_start < num_elements;
+      batch_start += batch_size) {
+    const int batch_end = std::min(batch_start + batch_size, num_elements);
+
+    // The first exception thrown by any thread is re-thrown once all
+    // threads have finished
+    OpenMpExceptionCollector exception_collector;
+#ifdef CHASTE_OPENMP
+#pragma omp parallel for schedule(static) num_threads(mNumAssemblyThreads)
+#endif  // CHASTE_OPENMP
+    for (int i = batch_start; i < batch_end; ++i) {
+      try {
+        AssembleOnElement(*rElements[i], a_elems[i - batch_start],
+            b_elems[i - batch_start]);
+      }
+      catch (...) {
+        exception_collector.Capture();
+      }
+    }
+    exception_collector.RethrowIfAny();
+
+    for (int i = batch_start; i < batch_end; ++i) {
+      AddElementContribution(*rElements[i], i, a_elems[i - batch_start],
+          b_elems[i - batch_start], pSlotMap);
+    }
+  }
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM,
+    bool CAN_ASSEMBLE_VECTOR, bool CAN_ASSEMBLE_MATRIX,
+    InterpolationLevel INTERPOLATION_LEVEL>
+void AbstractFeVolumeIntegralAssembler<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM,
+    CAN_ASSEMBLE_VECTOR, CAN_ASSEMBLE_MATRIX, INTERPOLATION_LEVEL>::
+    SetNumberOfAssemblyThreads(unsigned numThreads)
+{
+  if (numThreads == 0u)
+      EXCEPTION("The number of assembly threads must be at least one.");
+  mNumAssemblyThreads = numThreads;
+}
+
+
+///////////////////////////////////////////////////////////////////////
+// Implementation - matrix-free operators
+///////////////////////////////////////////////////////////////////////
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM,
+    bool CAN_ASSEMBLE_VECTOR, bool CAN_ASSEMBLE_MATRIX,
+    InterpolationLevel INTERPOLATION_LEVEL>
+void AbstractFeVolumeIntegralAssembler<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM,
+    CAN_ASSEMBLE_VECTOR, CAN_ASSEMBLE_MATRIX, INTERPOLATION_LEVEL>::
+    ApplyElementMatrices(PetscVecHaloScatter* pInput, Vec output)
+{
+  assert(CAN_ASSEMBLE_MATRIX);
+
+  // Only compute element matrices, whatever this assembler was last
+  // asked to do
+  const bool assemble_matrix = this->mAssembleMatrix;
+  const bool assemble_vector = this->mAssembleVector;
+  this->mAssembleMatrix = true;
+  this->mAssembleVector = false;
+
+  PetscVecTools::Zero(output);
+  PetscInt lo, hi;
+  VecGetOwnershipRange(output, &lo, &hi);
+  double* p_output;
+  VecGetArray(output, &p_output);
+
   const size_t STENCIL_SIZE = PROBLEM_DIM * (ELEMENT_DIM + 1);
   c_matrix<double, STENCIL_SIZE, STENCIL_SIZE> a_elem;
   c_vector<double, STENCIL_SIZE> b_elem;
 
-  // Loop over elements
   for (auto iter = mpMesh->GetElementIteratorBegin();
       iter != mpMesh->GetElementIteratorEnd(); ++iter) {
     Element<ELEMENT_DIM, SPACE_DIM>& r_element = *iter;
 
-    // Test for ownership first, since it's pointless to test the
-    // criterion on something which we might know nothing about.
     if (r_element.GetOwnership() == true &&
         ElementAssemblyCriterion(r_element) == true) {
       AssembleOnElement(r_element, a_elem, b_elem);
@@ -334,20 +757,119 @@ void AbstractFeVolumeIntegralAssembler<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM,
       unsigned p_indices[STENCIL_SIZE];
       r_element.GetStiffnessMatrixGlobalIndices(PROBLEM_DIM, p_indices);
 
-      if (this->mAssembleMatrix) {
-        PetscMatTools::AddMultipleValues<STENCIL_SIZE>(
-            this->mMatrixToAssemble, p_indices, a_elem);
+      // As in PetscMatTools::AddMultipleValues(), only rows owned by this
+      // process are accumulated, so shared elements are not double counted
+      for (auto row = 0u; row < STENCIL_SIZE; ++row) {
+        const PetscInt global_row = p_indices[row];
+        if (global_row >= lo && global_row < hi) {
+          if (pInput) {
+            double value = 0.0;
+            for (auto col = 0u; col < STENCIL_SIZE; ++col)
+                value += a_elem(row, col) * (*pInput)[p_indices[col]];
+            p_output[global_row - lo] += value;
+          }
+          else {
+            p_output[global_row - lo] += a_elem(row, row);
+          }
+        }
       }
-      if (this->mAssembleVector) {
-        PetscVecTools::AddMultipleValues<STENCIL_SIZE>(
-            this->mVectorToAssemble, p_indices, b_elem);
+    }
+  }
+
+  VecRestoreArray(output, &p_output);
+
+  this->mAssembleMatrix = assemble_matrix;
+  this->mAssembleVector = assemble_vector;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM,
+    bool CAN_ASSEMBLE_VECTOR, bool CAN_ASSEMBLE_MATRIX,
+    InterpolationLevel INTERPOLATION_LEVEL>
+void AbstractFeVolumeIntegralAssembler<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM,
+    CAN_ASSEMBLE_VECTOR, CAN_ASSEMBLE_MATRIX, INTERPOLATION_LEVEL>::
+    MultiplyMatrixFree(Vec x, Vec y)
+{
+  if (mpMatrixFreeHalo == nullptr || !mpMatrixFreeHalo->IsCompatible(x)) {
+    // Every column the locally owned elements reference
+    const size_t STENCIL_SIZE = PROBLEM_DIM * (ELEMENT_DIM + 1);
+    std::vector<PetscInt> columns;
+    for (auto iter = mpMesh->GetElementIteratorBegin();
+        iter != mpMesh->GetElementIteratorEnd(); ++iter) {
+      if (iter->GetOwnership() == true &&
+          ElementAssemblyCriterion(*iter) == true) {
+        unsigned p_indices[STENCIL_SIZE];
+        iter->GetStiffnessMatrixGlobalIndices(PROBLEM_DIM, p_indices);
+        columns.insert(columns.end(), p_indices, p_indices + STENCIL_SIZE);
       }
     }
+    delete mpMatrixFreeHalo;
+    mpMatrixFreeHalo = new PetscVecHaloScatter(x, columns);
   }
 
-  HeartEventHandler::EndEvent(assemble_event);
+  mpMatrixFreeHalo->BeginAccess(x);
+  ApplyElementMatrices(mpMatrixFreeHalo, y);
+  mpMatrixFreeHalo->EndAccess();
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM,
+    bool CAN_ASSEMBLE_VECTOR, bool CAN_ASSEMBLE_MATRIX,
+    InterpolationLevel INTERPOLATION_LEVEL>
+void AbstractFeVolumeIntegralAssembler<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM,
+    CAN_ASSEMBLE_VECTOR, CAN_ASSEMBLE_MATRIX, INTERPOLATION_LEVEL>::
+    GetMatrixFreeDiagonal(Vec diagonal)
+{
+  ApplyElementMatrices(nullptr, diagonal);
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM,
+    bool CAN_ASSEMBLE_VECTOR, bool CAN_ASSEMBLE_MATRIX,
+    InterpolationLevel INTERPOLATION_LEVEL>
+PetscErrorCode AbstractFeVolumeIntegralAssembler<ELEMENT_DIM, SPACE_DIM,
+    PROBLEM_DIM, CAN_ASSEMBLE_VECTOR, CAN_ASSEMBLE_MATRIX,
+    INTERPOLATION_LEVEL>::MatrixFreeMult(Mat matrix, Vec x, Vec y)
+{
+  void* p_context;
+  MatShellGetContext(matrix, &p_context);
+  static_cast<AbstractFeVolumeIntegralAssembler*>(p_context)->
+      MultiplyMatrixFree(x, y);
+  return 0;
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM,
+    bool CAN_ASSEMBLE_VECTOR, bool CAN_ASSEMBLE_MATRIX,
+    InterpolationLevel INTERPOLATION_LEVEL>
+PetscErrorCode AbstractFeVolumeIntegralAssembler<ELEMENT_DIM, SPACE_DIM,
+    PROBLEM_DIM, CAN_ASSEMBLE_VECTOR, CAN_ASSEMBLE_MATRIX,
+    INTERPOLATION_LEVEL>::MatrixFreeGetDiagonal(Mat matrix, Vec diagonal)
+{
+  void* p_context;
+  MatShellGetContext(matrix, &p_context);
+  static_cast<AbstractFeVolumeIntegralAssembler*>(p_context)->
+      GetMatrixFreeDiagonal(diagonal);
+  return 0;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM,
+    bool CAN_ASSEMBLE_VECTOR, bool CAN_ASSEMBLE_MATRIX,
+    InterpolationLevel INTERPOLATION_LEVEL>
+void AbstractFeVolumeIntegralAssembler<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM,
+    CAN_ASSEMBLE_VECTOR, CAN_ASSEMBLE_MATRIX, INTERPOLATION_LEVEL>::
+    CreateMatrixFreeOperator(Mat& rMatrix, Vec templateVector)
+{
+  if (!CAN_ASSEMBLE_MATRIX)
+      EXCEPTION("This assembler cannot assemble a matrix, so cannot be used as a matrix-free operator");
+
+  PetscInt size, lo, hi;
+  VecGetSize(templateVector, &size);
+  VecGetOwnershipRange(templateVector, &lo, &hi);
+
+  MatCreateShell(PetscTools::GetWorld(), hi - lo, hi - lo, size, size,
+      static_cast<void*>(this), &rMatrix);
+  MatShellSetOperation(rMatrix, MATOP_MULT,
+      (void(*)(void)) MatrixFreeMult);
+  MatShellSetOperation(rMatrix, MATOP_GET_DIAGONAL,
+      (void(*)(void)) MatrixFreeGetDiagonal);
+}
 
 ///////////////////////////////////////////////////////////////////////
 // Implementation - AssembleOnElement and smaller
@@ -364,7 +886,8 @@ void AbstractFeVolumeIntegralAssembler<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM,
       , c_matrix<double, SPACE_DIM, ELEMENT_DIM + 1>& rReturnValue)
 {
   assert(ELEMENT_DIM < 4 && ELEMENT_DIM > 0);
-  static c_matrix<double, ELEMENT_DIM, ELEMENT_DIM + 1> grad_phi;
+  // Not static, so that elements can be assembled concurrently
+  c_matrix<double, ELEMENT_DIM, ELEMENT_DIM + 1> grad_phi;
 
   LinearBasisFunction<ELEMENT_DIM>::ComputeBasisFunctionDerivatives(rPoint,
       grad_phi);
@@ -391,8 +914,22 @@ void AbstractFeVolumeIntegralAssembler<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM,
   c_matrix<double, ELEMENT_DIM, SPACE_DIM> inverse_jacobian;
   double jacobian_determinant;
 
-  mpMesh->GetInverseJacobianForElement(rElement.GetIndex(), jacobian,
-      jacobian_determinant, inverse_jacobian);
+  // Allocate memory for the basis functions values and derivative
+  // values
+  c_vector<double, ELEMENT_DIM + 1> phi;
+  c_matrix<double, SPACE_DIM, ELEMENT_DIM + 1> grad_phi;
+
+  // With linear bases grad_phi is the same at every Gauss point, so the
+  // mesh can hand back a cached copy along with the Jacobian
+  const bool use_geometry_cache = mpMesh->GetUseElementGeometryCache();
+  if (use_geometry_cache) {
+    mpMesh->GetElementGeometry(rElement.GetIndex(), jacobian,
+        jacobian_determinant, inverse_jacobian, grad_phi);
+  }
+  else {
+    mpMesh->GetInverseJacobianForElement(rElement.GetIndex(), jacobian,
+        jacobian_determinant, inverse_jacobian);
+  }
 
   if (this->mAssembleMatrix) rAElem.clear();
 
@@ -400,11 +937,6 @@ void AbstractFeVolumeIntegralAssembler<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM,
 
   const auto num_nodes = rElement.GetNumNodes();
 
-  // Allocate memory for the basis functions values and derivative
-  // values
-  c_vector<double, ELEMENT_DIM + 1> phi;
-  c_matrix<double, SPACE_DIM, ELEMENT_DIM + 1> grad_phi;
-
   // Loop over Gauss points
   for (auto quad_index = 0u; quad_index < mpQuadRule->GetNumQuadPoints();
       ++quad_index) {
@@ -412,7 +944,8 @@ void AbstractFeVolumeIntegralAssembler<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM,
 
     BasisFunction::ComputeBasisFunctions(quad_point, phi);
 
-    if (this->mAssembleMatrix || INTERPOLATION_LEVEL == NONLINEAR) {
+    if (!use_geometry_cache &&
+        (this->mAssembleMatrix || INTERPOLATION_LEVEL == NONLINEAR)) {
       ComputeTransformedBasisFunctionDerivatives(quad_point,
           inverse_jacobian, grad_phi);
     }
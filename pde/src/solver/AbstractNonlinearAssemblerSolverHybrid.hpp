@@ -376,8 +376,7 @@ void AbstractNonlinearAssemblerSolverHybrid<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>
         ComputeResidual(current_guess_copy, perturbed_residual);
 
         // result = (perturbed_residual - residual) / h
-        PetscVecTools::WAXPY(result, -1.0, residual, perturbed_residual);
-        PetscVecTools::Scale(result, 1.0/h);
+        PetscVecTools::WAXPBY(result, 1.0/h, perturbed_residual, -1.0/h, residual);
 
         double* p_result;
         ///\todo This loop is setting the column "global_index_outer" of
@@ -43,9 +43,16 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "AbstractOdeSystemForCoupledPdeSystem.hpp"
 #include "CvodeAdaptor.hpp"
 #include "BackwardEulerIvpOdeSolver.hpp"
+#include "EulerIvpOdeSolver.hpp"
+#include "HeunIvpOdeSolver.hpp"
+#include "RungeKutta2IvpOdeSolver.hpp"
+#include "RungeKutta4IvpOdeSolver.hpp"
 #include "Warnings.hpp"
+#include "OpenMpExceptionCollector.hpp"
 #include "VtkMeshWriter.hpp"
 
+#include <algorithm>
+#include <typeinfo>
 #include <boost/shared_ptr.hpp>
 
 /**
@@ -56,6 +63,12 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  * d/dt (v_j) = g_j(x, u_1, ..., u_p, v_1, ..., v_q),  j=1,...,q.
  *
  * The solver class is templated over spatial dimension and PDE problem dimension (p).
+ *
+ * After each PDE timestep the ODE systems at all the nodes are integrated, and
+ * their state variables are gathered into one contiguous array from which they
+ * are interpolated during assembly. The nodes may be split into contiguous
+ * blocks that are integrated concurrently (see SetNumberOfOdeThreads()), each
+ * block using its own copy of the ODE solver.
  */
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM=ELEMENT_DIM, unsigned PROBLEM_DIM=1>
 class LinearParabolicPdeSystemWithCoupledOdeSystemSolver
@@ -79,6 +92,32 @@ private:
     /** The ODE solver. */
     boost::shared_ptr<AbstractIvpOdeSolver> mpOdeSolver;
 
+    /** Whether mpOdeSolver was created by this class, rather than passed in to the constructor. */
+    bool mOdeSolverIsDefault;
+
+    /**
+     * The ODE state variables at every node, stored contiguously: the state
+     * variables of the ODE system at node i start at entry i*q, where q is the
+     * number of state variables. Updated each time the ODEs are solved.
+     */
+    std::vector<double> mOdeStateVariablesAtNodes;
+
+    /** The number of threads used to solve the ODEs at the nodes. Defaults to 1. */
+    unsigned mNumOdeThreads;
+
+    /**
+     * Whether the ODEs at all nodes are solved in turn by mpOdeSolver, whatever
+     * the number of threads. Defaults to false.
+     */
+    bool mUseSingleOdeSolver;
+
+    /**
+     * Independent copies of mpOdeSolver, one for each block of nodes solved by
+     * a single thread. Created when first needed; left empty if mpOdeSolver
+     * cannot be copied.
+     */
+    std::vector<boost::shared_ptr<AbstractIvpOdeSolver> > mBlockOdeSolvers;
+
     /**
      * A sampling timestep for writing results to file. Set to
      * PdeSimulationTime::GetPdeTimeStep() in the constructor;
@@ -103,6 +142,25 @@ private:
      */
     void WriteVtkResultsToFile();
 
+    /**
+     * Create a new ODE solver of the same type as mpOdeSolver, which does not
+     * share any working memory with it. Only the built-in fixed-step solvers,
+     * and the default solver created by the constructor, can be copied like
+     * this; for any other solver an empty pointer is returned.
+     *
+     * @return a new, independent ODE solver, or an empty pointer.
+     */
+    boost::shared_ptr<AbstractIvpOdeSolver> CreateIndependentOdeSolver();
+
+    /**
+     * Copy the current state variables of the ODE system at each node in the
+     * range [lo, hi) into mOdeStateVariablesAtNodes.
+     *
+     * @param lo the first node index
+     * @param hi one past the last node index
+     */
+    void GatherOdeStateVariables(unsigned lo, unsigned hi);
+
     /**
      * @return the term to be added to the element stiffness matrix.
      *
@@ -153,6 +211,15 @@ private:
      */
     void IncrementInterpolatedQuantities(double phiI, const Node<SPACE_DIM>* pNode);
 
+    /**
+     * @return false, as the interpolated quantities are stored in members,
+     * so elements cannot be assembled concurrently.
+     */
+    bool IsThreadSafe() const
+    {
+        return false;
+    }
+
     /**
      * Initialise method: sets up the linear system (using the mesh to
      * determine the number of unknowns per row to preallocate) if it is not
@@ -241,6 +308,38 @@ public:
      * @return mOdeSystemsAtNodes[index]
      */
     AbstractOdeSystemForCoupledPdeSystem* GetOdeSystemAtNode(unsigned index);
+
+    /**
+     * @return the ODE state variables at every node, stored contiguously (see
+     * mOdeStateVariablesAtNodes).
+     */
+    const std::vector<double>& rGetOdeStateVariablesAtNodes() const;
+
+    /**
+     * Set the number of threads used to solve the ODEs at the nodes. The nodes
+     * are split into this many contiguous blocks, each solved with its own copy
+     * of the ODE solver; the blocks are solved concurrently if Chaste was built
+     * with OpenMP (Chaste_USE_OPENMP). If the ODE solver cannot be copied, the
+     * nodes are solved in turn by the shared solver. The results do not depend
+     * on the number of threads.
+     *
+     * @param numThreads the number of threads (at least 1)
+     */
+    void SetNumberOfOdeThreads(unsigned numThreads);
+
+    /**
+     * @return the number of threads used to solve the ODEs at the nodes.
+     */
+    unsigned GetNumberOfOdeThreads() const;
+
+    /**
+     * Set whether the ODEs at all nodes should be solved in turn by the single
+     * ODE solver passed to the constructor (or created by default), whatever
+     * the number of threads.
+     *
+     * @param useSingleOdeSolver whether to use a single, shared ODE solver
+     */
+    void SetUseSingleOdeSolver(bool useSingleOdeSolver);
 };
 
 ///////////////////////////////////////////////////////////////////////////////////
@@ -326,11 +425,12 @@ void LinearParabolicPdeSystemWithCoupledOdeSystemSolver<ELEMENT_DIM, SPACE_DIM,
 {
     if (mOdeSystemsPresent)
     {
-        unsigned num_state_variables = mOdeSystemsAtNodes[0]->GetNumberOfStateVariables();
+        unsigned num_state_variables = mInterpolatedOdeStateVariables.size();
+        const double* p_state_variables = &mOdeStateVariablesAtNodes[pNode->GetIndex()*num_state_variables];
 
         for (unsigned i=0; i<num_state_variables; i++)
         {
-            mInterpolatedOdeStateVariables[i] += phiI * mOdeSystemsAtNodes[pNode->GetIndex()]->rGetStateVariables()[i];
+            mInterpolatedOdeStateVariables[i] += phiI * p_state_variables[i];
         }
     }
 }
@@ -380,6 +480,9 @@ LinearParabolicPdeSystemWithCoupledOdeSystemSolver<ELEMENT_DIM, SPACE_DIM, PROBL
       mpPdeSystem(pPdeSystem),
       mOdeSystemsAtNodes(odeSystemsAtNodes),
       mpOdeSolver(pOdeSolver),
+      mOdeSolverIsDefault(false),
+      mNumOdeThreads(1),
+      mUseSingleOdeSolver(false),
       mSamplingTimeStep(DOUBLE_UNSET),
       mOdeSystemsPresent(false),
       mClearOutputDirectory(false)
@@ -407,7 +510,11 @@ LinearParabolicPdeSystemWithCoupledOdeSystemSolver<ELEMENT_DIM, SPACE_DIM, PROBL
 #else
             mpOdeSolver.reset(new BackwardEulerIvpOdeSolver(mOdeSystemsAtNodes[0]->GetNumberOfStateVariables()));
 #endif //CHASTE_CVODE
+            mOdeSolverIsDefault = true;
         }
+
+        mOdeStateVariablesAtNodes.resize(mOdeSystemsAtNodes.size()*mOdeSystemsAtNodes[0]->GetNumberOfStateVariables());
+        GatherOdeStateVariables(0, mOdeSystemsAtNodes.size());
     }
 }
 
@@ -432,25 +539,122 @@ void LinearParabolicPdeSystemWithCoupledOdeSystemSolver<ELEMENT_DIM, SPACE_DIM,
         double next_time = PdeSimulationTime::GetNextTime();
         double dt = PdeSimulationTime::GetPdeTimeStep();
 
-        ReplicatableVector soln_repl(currentPdeSolution);
-        std::vector<double> current_soln_this_node(PROBLEM_DIM);
+        unsigned num_nodes = mpMesh->GetNumNodes();
+
+        /*
+         * Every process solves the ODEs at all the nodes, since the ODE state
+         * variables at halo nodes are needed during assembly. On a single
+         * process the PDE solution is read directly from the PETSc vector;
+         * otherwise it is first replicated.
+         */
+        const double* p_soln;
+        ReplicatableVector soln_repl;
+        bool is_sequential = PetscTools::IsSequential();
+        if (is_sequential)
+        {
+            VecGetArrayRead(currentPdeSolution, &p_soln);
+        }
+        else
+        {
+            soln_repl.ReplicatePetscVector(currentPdeSolution);
+            p_soln = &soln_repl[0];
+        }
 
-        // Loop over nodes
-        for (unsigned node_index=0; node_index<mpMesh->GetNumNodes(); node_index++)
+        // Split the nodes into blocks, each solved with its own copy of the ODE solver
+        if (!mUseSingleOdeSolver && mNumOdeThreads > 1 && mBlockOdeSolvers.empty())
         {
-            // Store the current solution to the PDE system at this node
-            for (unsigned pde_index=0; pde_index<PROBLEM_DIM; pde_index++)
+            for (unsigned block=0; block<mNumOdeThreads; block++)
             {
-                double current_soln_this_pde_this_node = soln_repl[PROBLEM_DIM*node_index + pde_index];
-                current_soln_this_node[pde_index] = current_soln_this_pde_this_node;
+                boost::shared_ptr<AbstractIvpOdeSolver> p_solver = CreateIndependentOdeSolver();
+                if (!p_solver)
+                {
+                    mBlockOdeSolvers.clear();
+                    break;
+                }
+                mBlockOdeSolvers.push_back(p_solver);
             }
+        }
+        bool use_block_solvers = !mUseSingleOdeSolver && !mBlockOdeSolvers.empty();
+        const int num_blocks = use_block_solvers ? static_cast<int>(mBlockOdeSolvers.size()) : 1;
+
+        // The first exception thrown by any block is re-thrown once all have finished
+        OpenMpExceptionCollector exception_collector;
+#ifdef CHASTE_OPENMP
+#pragma omp parallel for schedule(static) num_threads(mNumOdeThreads)
+#endif // CHASTE_OPENMP
+        for (int block=0; block<num_blocks; block++)
+        {
+            try
+            {
+                AbstractIvpOdeSolver* p_solver = use_block_solvers ? mBlockOdeSolvers[block].get() : mpOdeSolver.get();
+                unsigned lo = (block*num_nodes)/num_blocks;
+                unsigned hi = ((block + 1)*num_nodes)/num_blocks;
+
+                for (unsigned node_index=lo; node_index<hi; node_index++)
+                {
+                    // Pass the current solution to the PDE system at this node into the ODE system, and solve it
+                    AbstractOdeSystemForCoupledPdeSystem* p_ode_system = mOdeSystemsAtNodes[node_index];
+                    p_ode_system->SetPdeSolution(p_soln + PROBLEM_DIM*node_index);
+                    p_solver->SolveAndUpdateStateVariable(p_ode_system, time, next_time, dt);
+                }
+                GatherOdeStateVariables(lo, hi);
+            }
+            catch (...)
+            {
+                exception_collector.Capture();
+            }
+        }
 
-            // Pass it into the ODE system at this node
-            mOdeSystemsAtNodes[node_index]->SetPdeSolution(current_soln_this_node);
-
-            // Solve ODE system at this node
-            mpOdeSolver->SolveAndUpdateStateVariable(mOdeSystemsAtNodes[node_index], time, next_time, dt);
+        if (is_sequential)
+        {
+            VecRestoreArrayRead(currentPdeSolution, &p_soln);
         }
+        exception_collector.RethrowIfAny();
+    }
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
+boost::shared_ptr<AbstractIvpOdeSolver> LinearParabolicPdeSystemWithCoupledOdeSystemSolver<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::CreateIndependentOdeSolver()
+{
+    boost::shared_ptr<AbstractIvpOdeSolver> p_solver;
+
+    // Compare exact types, so that subclasses are not copied
+    const std::type_info& r_type = typeid(*mpOdeSolver);
+    if (r_type == typeid(EulerIvpOdeSolver))
+    {
+        p_solver.reset(new EulerIvpOdeSolver);
+    }
+    else if (r_type == typeid(HeunIvpOdeSolver))
+    {
+        p_solver.reset(new HeunIvpOdeSolver);
+    }
+    else if (r_type == typeid(RungeKutta2IvpOdeSolver))
+    {
+        p_solver.reset(new RungeKutta2IvpOdeSolver);
+    }
+    else if (r_type == typeid(RungeKutta4IvpOdeSolver))
+    {
+        p_solver.reset(new RungeKutta4IvpOdeSolver);
+    }
+    else if (mOdeSolverIsDefault)
+    {
+#ifdef CHASTE_CVODE
+        p_solver.reset(new CvodeAdaptor);
+#else
+        p_solver.reset(new BackwardEulerIvpOdeSolver(mOdeSystemsAtNodes[0]->GetNumberOfStateVariables()));
+#endif //CHASTE_CVODE
+    }
+    return p_solver;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
+void LinearParabolicPdeSystemWithCoupledOdeSystemSolver<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::GatherOdeStateVariables(unsigned lo, unsigned hi)
+{
+    for (unsigned node_index=lo; node_index<hi; node_index++)
+    {
+        const std::vector<double>& r_state_variables = mOdeSystemsAtNodes[node_index]->rGetStateVariables();
+        std::copy(r_state_variables.begin(), r_state_variables.end(),
+                  mOdeStateVariablesAtNodes.begin() + node_index*r_state_variables.size());
     }
 }
 
@@ -633,4 +837,33 @@ AbstractOdeSystemForCoupledPdeSystem* LinearParabolicPdeSystemWithCoupledOdeSyst
     return mOdeSystemsAtNodes[index];
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
+const std::vector<double>& LinearParabolicPdeSystemWithCoupledOdeSystemSolver<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::rGetOdeStateVariablesAtNodes() const
+{
+    return mOdeStateVariablesAtNodes;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
+void LinearParabolicPdeSystemWithCoupledOdeSystemSolver<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::SetNumberOfOdeThreads(unsigned numThreads)
+{
+    if (numThreads == 0)
+    {
+        EXCEPTION("The number of ODE threads must be at least 1.");
+    }
+    mNumOdeThreads = numThreads;
+    mBlockOdeSolvers.clear();
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
+unsigned LinearParabolicPdeSystemWithCoupledOdeSystemSolver<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::GetNumberOfOdeThreads() const
+{
+    return mNumOdeThreads;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
+void LinearParabolicPdeSystemWithCoupledOdeSystemSolver<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM>::SetUseSingleOdeSolver(bool useSingleOdeSolver)
+{
+    mUseSingleOdeSolver = useSingleOdeSolver;
+}
+
 #endif /*LINEARPARABOLICPDESYSTEMWITHCOUPLEDODESYSTEMSOLVER_HPP_*/
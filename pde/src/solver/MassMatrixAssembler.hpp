@@ -83,7 +83,7 @@ public:
                 Element<ELEMENT_DIM,SPACE_DIM>* pElement)
     {
         c_matrix<double, ELEMENT_DIM+1, ELEMENT_DIM+1> mass_matrix;
-        mass_matrix = outer_prod(rPhi, rPhi);
+        mass_matrix = OuterProduct(rPhi, rPhi);
 
         if (mUseMassLumping)
         {
@@ -49,12 +49,12 @@ c_matrix<double, 1*(ELEMENT_DIM+1), 1*(ELEMENT_DIM+1)>SimpleLinearEllipticSolver
     // This if statement just saves computing phi*phi^T if it is to be multiplied by zero
     if (mpEllipticPde->ComputeLinearInUCoeffInSourceTerm(rX,pElement)!=0)
     {
-        return   prod( trans(rGradPhi), c_matrix<double, SPACE_DIM, ELEMENT_DIM+1>(prod(pde_diffusion_term, rGradPhi)) )
-               - mpEllipticPde->ComputeLinearInUCoeffInSourceTerm(rX,pElement)*outer_prod(rPhi,rPhi);
+        return   WeightedTransposeProduct(rGradPhi, pde_diffusion_term)
+               - mpEllipticPde->ComputeLinearInUCoeffInSourceTerm(rX,pElement)*OuterProduct(rPhi, rPhi);
     }
     else
     {
-        return   prod( trans(rGradPhi), c_matrix<double, SPACE_DIM, ELEMENT_DIM+1>(prod(pde_diffusion_term, rGradPhi)) );
+        return   WeightedTransposeProduct(rGradPhi, pde_diffusion_term);
     }
 }
 
@@ -300,6 +300,76 @@ public:
         PetscTools::Destroy(result);
     }
 
+    void TestOdeSystemsSolvedInBlocks()
+    {
+        TrianglesMeshReader<2,2> mesh_reader("mesh/test/data/square_4096_elements");
+        TetrahedralMesh<2,2> mesh;
+        mesh.ConstructFromMeshReader(mesh_reader);
+
+        HeatEquationForCoupledOdeSystem<2> pde;
+        BoundaryConditionsContainer<2,2,1> bcc;
+        bcc.DefineZeroDirichletOnMeshBoundary(&mesh);
+
+        std::vector<double> init_cond(mesh.GetNumNodes());
+        for (unsigned i=0; i<mesh.GetNumNodes(); i++)
+        {
+            double x = mesh.GetNode(i)->GetPoint()[0];
+            double y = mesh.GetNode(i)->GetPoint()[1];
+            init_cond[i] = sin(M_PI*x)*sin(M_PI*y);
+        }
+        Vec initial_condition = PetscTools::CreateVec(init_cond);
+
+        // Solve the same problem with one shared ODE solver, and with the nodes split into three blocks
+        std::vector<AbstractOdeSystemForCoupledPdeSystem*> ode_systems_single;
+        std::vector<AbstractOdeSystemForCoupledPdeSystem*> ode_systems_blocks;
+        for (unsigned i=0; i<mesh.GetNumNodes(); i++)
+        {
+            ode_systems_single.push_back(new OdeSystemForCoupledHeatEquation(5.0));
+            ode_systems_blocks.push_back(new OdeSystemForCoupledHeatEquation(5.0));
+        }
+
+        LinearParabolicPdeSystemWithCoupledOdeSystemSolver<2,2,1> solver_single(&mesh, &pde, &bcc, ode_systems_single);
+        solver_single.SetUseSingleOdeSolver(true);
+        solver_single.SetNumberOfOdeThreads(3);
+
+        LinearParabolicPdeSystemWithCoupledOdeSystemSolver<2,2,1> solver_blocks(&mesh, &pde, &bcc, ode_systems_blocks);
+        TS_ASSERT_EQUALS(solver_blocks.GetNumberOfOdeThreads(), 1u);
+        TS_ASSERT_THROWS_THIS(solver_blocks.SetNumberOfOdeThreads(0), "The number of ODE threads must be at least 1.");
+        solver_blocks.SetNumberOfOdeThreads(3);
+        TS_ASSERT_EQUALS(solver_blocks.GetNumberOfOdeThreads(), 3u);
+
+        // Before solving, the contiguous ODE state variables are the initial conditions
+        TS_ASSERT_EQUALS(solver_blocks.rGetOdeStateVariablesAtNodes().size(), mesh.GetNumNodes());
+        TS_ASSERT_DELTA(solver_blocks.rGetOdeStateVariablesAtNodes()[0], 1.0, 1e-12);
+
+        solver_single.SetTimes(0, 0.01);
+        solver_single.SetTimeStep(0.001);
+        solver_single.SetInitialCondition(initial_condition);
+        Vec result_single = solver_single.Solve();
+        ReplicatableVector result_single_repl(result_single);
+
+        solver_blocks.SetTimes(0, 0.01);
+        solver_blocks.SetTimeStep(0.001);
+        solver_blocks.SetInitialCondition(initial_condition);
+        Vec result_blocks = solver_blocks.Solve();
+        ReplicatableVector result_blocks_repl(result_blocks);
+
+        // The results do not depend on how the ODEs are solved
+        const std::vector<double>& r_states = solver_blocks.rGetOdeStateVariablesAtNodes();
+        for (unsigned i=0; i<mesh.GetNumNodes(); i++)
+        {
+            TS_ASSERT_DELTA(result_blocks_repl[i], result_single_repl[i], 1e-12);
+            TS_ASSERT_DELTA(ode_systems_blocks[i]->rGetStateVariables()[0], ode_systems_single[i]->rGetStateVariables()[0], 1e-12);
+            TS_ASSERT_DELTA(r_states[i], ode_systems_blocks[i]->rGetStateVariables()[0], 1e-12);
+            TS_ASSERT_DELTA(ode_systems_blocks[i]->rGetPdeSolution()[0], ode_systems_single[i]->rGetPdeSolution()[0], 1e-12);
+        }
+
+        // Tidy up
+        PetscTools::Destroy(initial_condition);
+        PetscTools::Destroy(result_single);
+        PetscTools::Destroy(result_blocks);
+    }
+
     void TestSolveAndWriteResultsToFileMethod()
     {
         // Create mesh of the domain [0,1]x[0,1]
@@ -58,6 +58,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "FemlabMeshReader.hpp"
 #include "HeatEquation.hpp"
 #include "HeatEquationWithSourceTerm.hpp"
+#include "ErrorEstimateTimeAdaptivityController.hpp"
 #include "PetscSetupAndFinalize.hpp"
 #include "PetscTools.hpp"
 #include "CompareHdf5ResultsFiles.hpp"
@@ -214,6 +215,67 @@ public:
         PetscTools::Destroy(result);
     }
 
+    void TestSimpleLinearParabolicSolverWithInitialGuessTypes()
+    {
+        TrianglesMeshReader<1,1> mesh_reader("mesh/test/data/1D_0_to_1_10_elements");
+        TetrahedralMesh<1,1> mesh;
+        mesh.ConstructFromMeshReader(mesh_reader);
+
+        HeatEquation<1> pde;
+
+        BoundaryConditionsContainer<1,1,1> bcc;
+        ConstBoundaryCondition<1>* p_boundary_condition = new ConstBoundaryCondition<1>(0.0);
+        bcc.AddDirichletBoundaryCondition(mesh.GetNode(0), p_boundary_condition);
+        bcc.AddDirichletBoundaryCondition(mesh.GetNode( mesh.GetNumNodes()-1 ), p_boundary_condition);
+
+        std::vector<double> init_cond(mesh.GetNumNodes());
+        for (unsigned i=0; i<mesh.GetNumNodes(); i++)
+        {
+            double x = mesh.GetNode(i)->GetPoint()[0];
+            init_cond[i] = sin(x*M_PI);
+        }
+        Vec initial_condition = PetscTools::CreateVec(init_cond);
+
+        Vec reference = nullptr;
+        InitialGuessType types[4] = {PREVIOUS_SOLUTION, LINEAR_EXTRAPOLATION, QUADRATIC_EXTRAPOLATION, PROJECTION};
+        for (unsigned type=0; type<4; type++)
+        {
+            SimpleLinearParabolicSolver<1,1> solver(&mesh,&pde,&bcc);
+            solver.SetInitialGuessType(types[type], 3u);
+            TS_ASSERT_EQUALS(solver.GetInitialGuessType(), types[type]);
+            solver.SetTimeStep(0.01);
+
+            // Solve in two parts, so that the history of solutions is carried over
+            solver.SetTimes(0.0, 0.05);
+            solver.SetInitialCondition(initial_condition);
+            Vec halfway = solver.Solve();
+
+            solver.SetTimes(0.05, 0.1);
+            solver.SetInitialCondition(halfway);
+            Vec result = solver.Solve();
+            PetscTools::Destroy(halfway);
+
+            // The initial guess only affects the solution to within the solver tolerance
+            if (reference == nullptr)
+            {
+                reference = result;
+            }
+            else
+            {
+                ReplicatableVector result_repl(result);
+                ReplicatableVector reference_repl(reference);
+                for (unsigned i=0; i<result_repl.GetSize(); i++)
+                {
+                    TS_ASSERT_DELTA(result_repl[i], reference_repl[i], 1e-5);
+                }
+                PetscTools::Destroy(result);
+            }
+        }
+
+        PetscTools::Destroy(initial_condition);
+        PetscTools::Destroy(reference);
+    }
+
     void TestSimpleLinearParabolicSolver1DZeroDirichWithSourceTerm()
     {
         // Create mesh from mesh reader
@@ -1021,6 +1083,69 @@ public:
         PetscTools::Destroy(initial_condition);
         PetscTools::Destroy(result);
     }
+
+    /*
+     * The same problem again, with timesteps chosen from an estimate of the local error.
+     * The solution decays, so the timestep grows, and after the first change the LHS
+     * matrix is formed from its stored mass and stiffness parts rather than reassembled.
+     */
+    void Test1DProblemUsingErrorEstimateController()
+    {
+        TrianglesMeshReader<1,1> mesh_reader("mesh/test/data/1D_0_to_1_10_elements");
+        TetrahedralMesh<1,1> mesh;
+        mesh.ConstructFromMeshReader(mesh_reader);
+
+        HeatEquation<1> pde;
+
+        BoundaryConditionsContainer<1,1,1> bcc;
+        ConstBoundaryCondition<1>* p_boundary_condition = new ConstBoundaryCondition<1>(0.0);
+        bcc.AddDirichletBoundaryCondition(mesh.GetNode(0), p_boundary_condition);
+        bcc.AddDirichletBoundaryCondition(mesh.GetNode( mesh.GetNumNodes()-1 ), p_boundary_condition);
+
+        std::vector<double> init_cond(mesh.GetNumNodes());
+        for (unsigned i=0; i<mesh.GetNumNodes(); i++)
+        {
+            double x = mesh.GetNode(i)->GetPoint()[0];
+            init_cond[i] = sin(x*M_PI);
+        }
+        Vec initial_condition = PetscTools::CreateVec(init_cond);
+
+        double t_end = 0.5;
+        std::vector<Vec> results;
+        for (unsigned update=0; update<2; update++)
+        {
+            SimpleLinearParabolicSolver<1,1> solver(&mesh,&pde,&bcc);
+            solver.SetTimes(0, t_end);
+            solver.SetInitialCondition(initial_condition);
+
+            ErrorEstimateTimeAdaptivityController controller(1e-5, 0.1, 1e-3, 1e-4);
+            solver.SetTimeAdaptivityController(&controller);
+            solver.SetUpdateMatrixOnTimeStepChange(update == 1u);
+
+            results.push_back(solver.Solve());
+
+            // The timestep has grown as the solution decayed
+            TS_ASSERT_LESS_THAN(0.01, solver.mIdealTimeStep);
+            TS_ASSERT_EQUALS(solver.mTimeDerivativeMatrix != nullptr, update == 1u);
+        }
+
+        // Updating the matrix gives the same answer as reassembling it...
+        ReplicatableVector reassembled_repl(results[0]);
+        ReplicatableVector updated_repl(results[1]);
+        for (unsigned i=0; i<updated_repl.GetSize(); i++)
+        {
+            TS_ASSERT_DELTA(updated_repl[i], reassembled_repl[i], 1e-10);
+
+            // ...which is close to u = e^{-t*pi*pi} sin(x*pi)
+            double x = mesh.GetNode(i)->GetPoint()[0];
+            double u = exp(-t_end*M_PI*M_PI)*sin(x*M_PI);
+            TS_ASSERT_DELTA(updated_repl[i], u, 2e-3);
+        }
+
+        PetscTools::Destroy(initial_condition);
+        PetscTools::Destroy(results[0]);
+        PetscTools::Destroy(results[1]);
+    }
 };
 
 #endif //_TESTSIMPLELINEARPARABOLICSOLVER_HPP_
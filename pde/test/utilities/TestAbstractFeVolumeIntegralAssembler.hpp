@@ -587,6 +587,174 @@ public:
         PetscTools::Destroy(mat);
     }
 
+    void TestMatrixFreeOperator()
+    {
+        TetrahedralMesh<2,2> mesh;
+        mesh.ConstructRegularSlabMesh(0.1, 1.0, 0.5);
+        unsigned num_nodes = mesh.GetNumNodes();
+
+        // Assembled version
+        Mat assembled;
+        PetscTools::SetupMat(assembled, num_nodes, num_nodes, 9);
+        StiffnessMatrixAssembler<2,2> assembler(&mesh);
+        assembler.SetMatrixToAssemble(assembled);
+        assembler.Assemble();
+        PetscMatTools::Finalise(assembled);
+
+        // Matrix-free version, applied to x_i = sin(i)
+        Vec x = mesh.GetDistributedVectorFactory()->CreateVec();
+        PetscInt lo, hi;
+        VecGetOwnershipRange(x, &lo, &hi);
+        for (PetscInt i=lo; i<hi; i++)
+        {
+            PetscVecTools::SetElement(x, i, sin((double)i));
+        }
+        PetscVecTools::Finalise(x);
+
+        Mat matrix_free;
+        StiffnessMatrixAssembler<2,2> matrix_free_assembler(&mesh);
+        matrix_free_assembler.CreateMatrixFreeOperator(matrix_free, x);
+
+        Vec y_assembled;
+        VecDuplicate(x, &y_assembled);
+        Vec y_matrix_free;
+        VecDuplicate(x, &y_matrix_free);
+        MatMult(assembled, x, y_assembled);
+        MatMult(matrix_free, x, y_matrix_free);
+
+        for (PetscInt i=lo; i<hi; i++)
+        {
+            TS_ASSERT_DELTA(PetscVecTools::GetElement(y_matrix_free, i), PetscVecTools::GetElement(y_assembled, i), 1e-12);
+        }
+
+        // The diagonal is also available, for Jacobi preconditioning
+        MatGetDiagonal(assembled, y_assembled);
+        MatGetDiagonal(matrix_free, y_matrix_free);
+        for (PetscInt i=lo; i<hi; i++)
+        {
+            TS_ASSERT_DELTA(PetscVecTools::GetElement(y_matrix_free, i), PetscVecTools::GetElement(y_assembled, i), 1e-12);
+        }
+
+        PetscTools::Destroy(x);
+        PetscTools::Destroy(y_assembled);
+        PetscTools::Destroy(y_matrix_free);
+        PetscTools::Destroy(assembled);
+        PetscTools::Destroy(matrix_free);
+    }
+
+    void TestAssemblyWithElementGeometryCache()
+    {
+        TetrahedralMesh<3,3> mesh;
+        mesh.ConstructRegularSlabMesh(0.25, 1.0, 0.5, 0.5);
+        unsigned num_nodes = mesh.GetNumNodes();
+
+        Mat uncached;
+        PetscTools::SetupMat(uncached, num_nodes, num_nodes, 27);
+        StiffnessMatrixAssembler<3,3> assembler(&mesh);
+        assembler.SetMatrixToAssemble(uncached);
+        assembler.Assemble();
+        PetscMatTools::Finalise(uncached);
+
+        // Assemble twice with the cache, once to fill it and once to use it
+        mesh.SetUseElementGeometryCache();
+        Mat cached;
+        PetscTools::SetupMat(cached, num_nodes, num_nodes, 27);
+        assembler.SetMatrixToAssemble(cached, true);
+        for (unsigned i=0; i<2; i++)
+        {
+            assembler.Assemble();
+            PetscMatTools::Finalise(cached);
+        }
+
+        PetscInt lo, hi;
+        MatGetOwnershipRange(uncached, &lo, &hi);
+        for (PetscInt i=lo; i<hi; i++)
+        {
+            for (unsigned j=0; j<num_nodes; j++)
+            {
+                TS_ASSERT_DELTA(PetscMatTools::GetElement(cached, i, j), PetscMatTools::GetElement(uncached, i, j), 1e-12);
+            }
+        }
+
+        PetscTools::Destroy(uncached);
+        PetscTools::Destroy(cached);
+    }
+
+    void TestThreadedAssembly()
+    {
+        TetrahedralMesh<3,3> mesh;
+        mesh.ConstructRegularSlabMesh(0.1, 1.0, 0.5, 0.5);
+        unsigned num_nodes = mesh.GetNumNodes();
+
+        Mat serial;
+        PetscTools::SetupMat(serial, num_nodes, num_nodes, 27);
+        StiffnessMatrixAssembler<3,3> serial_assembler(&mesh);
+        TS_ASSERT_EQUALS(serial_assembler.GetNumberOfAssemblyThreads(), 1u);
+        serial_assembler.SetMatrixToAssemble(serial);
+        serial_assembler.Assemble();
+        PetscMatTools::Finalise(serial);
+
+        // More elements than one batch, so that several batches are used
+        Mat threaded;
+        PetscTools::SetupMat(threaded, num_nodes, num_nodes, 27);
+        StiffnessMatrixAssembler<3,3> threaded_assembler(&mesh);
+        TS_ASSERT_THROWS_THIS(threaded_assembler.SetNumberOfAssemblyThreads(0u),
+                "The number of assembly threads must be at least one.");
+        threaded_assembler.SetNumberOfAssemblyThreads(4u);
+        TS_ASSERT_EQUALS(threaded_assembler.GetNumberOfAssemblyThreads(), 4u);
+        threaded_assembler.SetMatrixToAssemble(threaded);
+        threaded_assembler.Assemble();
+        PetscMatTools::Finalise(threaded);
+
+        PetscInt lo, hi;
+        MatGetOwnershipRange(serial, &lo, &hi);
+        for (PetscInt i=lo; i<hi; i++)
+        {
+            for (unsigned j=0; j<num_nodes; j++)
+            {
+                TS_ASSERT_DELTA(PetscMatTools::GetElement(threaded, i, j), PetscMatTools::GetElement(serial, i, j), 1e-12);
+            }
+        }
+
+        PetscTools::Destroy(serial);
+        PetscTools::Destroy(threaded);
+    }
+
+    void TestAssemblyWithPrecomputedSparsityPattern()
+    {
+        TetrahedralMesh<3,3> mesh;
+        mesh.ConstructRegularSlabMesh(0.25, 1.0, 0.5, 0.5);
+        unsigned num_nodes = mesh.GetNumNodes();
+
+        Mat normal;
+        PetscTools::SetupMat(normal, num_nodes, num_nodes, 27);
+        StiffnessMatrixAssembler<3,3> normal_assembler(&mesh);
+        normal_assembler.SetMatrixToAssemble(normal);
+        normal_assembler.Assemble();
+        PetscMatTools::Finalise(normal);
+
+        // The first assembly fixes the nonzero structure, later ones write straight into it
+        Mat precomputed;
+        PetscTools::SetupMat(precomputed, num_nodes, num_nodes, 27);
+        StiffnessMatrixAssembler<3,3> assembler(&mesh);
+        assembler.SetUsePrecomputedSparsityPattern();
+        assembler.SetMatrixToAssemble(precomputed, true);
+        for (unsigned i=0; i<3; i++)
+        {
+            // Also check the slot map is used correctly by the threaded loop
+            if (i == 2)
+            {
+                assembler.SetNumberOfAssemblyThreads(2u);
+            }
+            assembler.Assemble();
+            PetscMatTools::Finalise(precomputed);
+            TS_ASSERT(PetscMatTools::CheckEquality(precomputed, normal));
+        }
+
+        PetscTools::Destroy(normal);
+        PetscTools::Destroy(precomputed);
+    }
+
     void TestInterpolationOfPositionAndCurrentSolution()
     {
         TetrahedralMesh<1,1> mesh;
@@ -48,6 +48,35 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ReplicatableVector.hpp"
 #include "PetscSetupAndFinalize.hpp"
 
+/**
+ * A boundary condition whose value can be changed, used to check that
+ * changing Dirichlet values are applied to a symmetric system.
+ */
+class VariableBoundaryCondition : public AbstractBoundaryCondition<1>
+{
+public:
+    /** The value returned by GetValue(). */
+    double mValue;
+
+    /**
+     * Constructor.
+     * @param value the initial value
+     */
+    VariableBoundaryCondition(double value)
+        : mValue(value)
+    {
+    }
+
+    /**
+     * @return the current value
+     * @param rX the point (unused)
+     */
+    double GetValue(const ChastePoint<1>& rX) const
+    {
+        return mValue;
+    }
+};
+
 class TestBoundaryConditionsContainer : public CxxTest::TestSuite
 {
 public:
@@ -328,6 +357,70 @@ public:
         PetscTools::Destroy(solution);
     }
 
+    void TestSharedConstantDirichletConditions()
+    {
+        const unsigned SIZE = 10;
+        LinearSystem linear_system(SIZE, SIZE);
+        for (unsigned i=0; i<SIZE; i++)
+        {
+            linear_system.SetMatrixElement(i, i, 2.0);
+            linear_system.SetRhsVectorElement(i, 4.0);
+        }
+        linear_system.AssembleIntermediateLinearSystem();
+
+        std::vector<Node<2>*> nodes;
+        for (unsigned i=0; i<SIZE; i++)
+        {
+            nodes.push_back(new Node<2>(i, true));
+        }
+
+        BoundaryConditionsContainer<2,2,1> bcc;
+
+        // Constant conditions are shared between callers asking for the same value
+        const ConstBoundaryCondition<2>* p_condition = bcc.GetConstantBoundaryCondition(3.0);
+        TS_ASSERT_EQUALS(bcc.GetConstantBoundaryCondition(3.0), p_condition);
+        TS_ASSERT_DIFFERS(bcc.GetConstantBoundaryCondition(5.0), p_condition);
+
+        // Add conditions on the first half of the nodes in one call
+        std::vector<const Node<2>*> boundary_nodes;
+        std::vector<double> values;
+        for (unsigned i=0; i<SIZE/2; i++)
+        {
+            boundary_nodes.push_back(nodes[i]);
+            values.push_back(i%2 == 0 ? 3.0 : 5.0);
+        }
+        bcc.AddConstantDirichletBoundaryConditions(boundary_nodes, values);
+        TS_ASSERT(bcc.HasDirichletBoundaryCondition(nodes[1]));
+        TS_ASSERT_DELTA(bcc.GetDirichletBCValue(nodes[1]), 5.0, 1e-12);
+
+        bcc.ApplyDirichletToLinearProblem(linear_system);
+        linear_system.AssembleFinalLinearSystem();
+        {
+            ReplicatableVector rhs(linear_system.rGetRhsVector());
+            for (unsigned i=0; i<SIZE; i++)
+            {
+                double expected = (i < SIZE/2) ? values[i] : 4.0;
+                TS_ASSERT_DELTA(rhs[i], expected, 1e-12);
+            }
+        }
+
+        // Conditions added after the first application are also applied
+        bcc.AddDirichletBoundaryCondition(nodes[SIZE-1], p_condition);
+        bcc.ApplyDirichletToLinearProblem(linear_system, false, true);
+        linear_system.AssembleFinalLinearSystem();
+        {
+            ReplicatableVector rhs(linear_system.rGetRhsVector());
+            TS_ASSERT_DELTA(rhs[SIZE-1], 3.0, 1e-12);
+            TS_ASSERT_DELTA(rhs[SIZE-2], 4.0, 1e-12);
+        }
+
+        // The shared conditions are deleted by the container, not here
+        for (unsigned i=0; i<SIZE; i++)
+        {
+            delete nodes[i];
+        }
+    }
+
     void TestApplyToSymmetricLinearSystem()
     {
         const int SIZE = 10;
@@ -409,6 +502,55 @@ public:
         PetscTools::Destroy(solution);
     }
 
+    void TestSymmetricDirichletLiftingWithChangingValues()
+    {
+        // A symmetric tridiagonal system with a condition u_0 = v on the first node
+        const unsigned SIZE = 3;
+        LinearSystem linear_system(SIZE, SIZE);
+        linear_system.SetMatrixIsSymmetric(true);
+        for (unsigned i=0; i<SIZE; i++)
+        {
+            linear_system.SetMatrixElement(i, i, 2.0);
+            if (i > 0)
+            {
+                linear_system.SetMatrixElement(i, i-1, -1.0);
+                linear_system.SetMatrixElement(i-1, i, -1.0);
+            }
+        }
+        linear_system.AssembleIntermediateLinearSystem();
+
+        Node<1> node(0, true);
+        BoundaryConditionsContainer<1,1,1> bcc;
+        VariableBoundaryCondition* p_condition = new VariableBoundaryCondition(3.0);
+        bcc.AddDirichletBoundaryCondition(&node, p_condition);
+
+        // Eliminate the column once; the solution is then (v, 2v/3, v/3)
+        bcc.ApplyDirichletToLinearProblem(linear_system);
+        linear_system.AssembleFinalLinearSystem();
+        {
+            Vec solution = linear_system.Solve();
+            ReplicatableVector solution_repl(solution);
+            TS_ASSERT_DELTA(solution_repl[0], 3.0, 1e-6);
+            TS_ASSERT_DELTA(solution_repl[1], 2.0, 1e-6);
+            TS_ASSERT_DELTA(solution_repl[2], 1.0, 1e-6);
+            PetscTools::Destroy(solution);
+        }
+
+        // Change the boundary value and apply it to a fresh RHS only, as in a time step
+        p_condition->mValue = 6.0;
+        linear_system.ZeroRhsVector();
+        bcc.ApplyDirichletToLinearProblem(linear_system, false, true);
+        linear_system.AssembleFinalLinearSystem();
+        {
+            Vec solution = linear_system.Solve();
+            ReplicatableVector solution_repl(solution);
+            TS_ASSERT_DELTA(solution_repl[0], 6.0, 1e-6);
+            TS_ASSERT_DELTA(solution_repl[1], 4.0, 1e-6);
+            TS_ASSERT_DELTA(solution_repl[2], 2.0, 1e-6);
+            PetscTools::Destroy(solution);
+        }
+    }
+
     void TestApplyToNonlinearSystem()
     {
         const int SIZE = 10;
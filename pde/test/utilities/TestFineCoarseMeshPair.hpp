@@ -39,7 +39,10 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <cxxtest/TestSuite.h>
 #include "FineCoarseMeshPair.hpp"
 #include "TetrahedralMesh.hpp"
+#include "DistributedTetrahedralMesh.hpp"
+#include "TrianglesMeshReader.hpp"
 #include "QuadraticMesh.hpp"
+#include "OutputFileHandler.hpp"
 #include "PetscSetupAndFinalize.hpp"
 
 class TestFineCoarseMeshPair : public CxxTest::TestSuite
@@ -589,6 +592,111 @@ public:
         TS_ASSERT_EQUALS(mesh_pair.mStatisticsCounters[0], 9u);
         TS_ASSERT_EQUALS(mesh_pair.mStatisticsCounters[1], 0u);
     }
+
+    void TestMappingCache()
+    {
+        TetrahedralMesh<2,2> fine_mesh;
+        fine_mesh.ConstructRegularSlabMesh(0.1, 1.0, 1.0);
+
+        QuadraticMesh<2> coarse_mesh(0.5, 1.0, 1.0);
+        coarse_mesh.Scale(1.03, 1.0); // a few points outside the fine mesh
+
+        GaussianQuadratureRule<2> quad_rule(3);
+        std::string cache_directory = "TestFineCoarseMeshPairCache";
+        OutputFileHandler handler(cache_directory); // clean the cache
+
+        // Compute the mappings and fill the cache
+        FineCoarseMeshPair<2> mesh_pair(fine_mesh, coarse_mesh);
+        mesh_pair.SetMappingCacheDirectory(cache_directory);
+        mesh_pair.SetUpBoxesOnFineMesh();
+        mesh_pair.ComputeFineElementsAndWeightsForCoarseQuadPoints(quad_rule, false);
+        std::vector<ElementAndWeights<2> > elements_and_weights = mesh_pair.rGetElementsAndWeights();
+        std::vector<unsigned> counters = mesh_pair.mStatisticsCounters;
+        TS_ASSERT_LESS_THAN(0u, counters[1]);
+        mesh_pair.SetUpBoxesOnCoarseMesh();
+        mesh_pair.ComputeCoarseElementsForFineNodes(false);
+        std::vector<unsigned> coarse_elements = mesh_pair.rGetCoarseElementsForFineNodes();
+
+        // There is a file for each mapping
+        FileFinder cache_dir(cache_directory, RelativeTo::ChasteTestOutput);
+        TS_ASSERT_EQUALS(cache_dir.FindMatches("mesh_pair_*").size(), 2u);
+        Warnings::Instance()->QuietDestroy();
+
+        // A second pair on the same meshes reads the cache, and gets the same results
+        FineCoarseMeshPair<2> mesh_pair2(fine_mesh, coarse_mesh);
+        mesh_pair2.SetMappingCacheDirectory(cache_directory);
+        mesh_pair2.SetUpBoxesOnFineMesh();
+        mesh_pair2.ComputeFineElementsAndWeightsForCoarseQuadPoints(quad_rule, false);
+        TS_ASSERT_EQUALS(mesh_pair2.rGetElementsAndWeights().size(), elements_and_weights.size());
+        for (unsigned i=0; i<elements_and_weights.size(); i++)
+        {
+            TS_ASSERT_EQUALS(mesh_pair2.rGetElementsAndWeights()[i].ElementNum, elements_and_weights[i].ElementNum);
+            for (unsigned j=0; j<3; j++)
+            {
+                TS_ASSERT_DELTA(mesh_pair2.rGetElementsAndWeights()[i].Weights(j), elements_and_weights[i].Weights(j), 1e-15);
+            }
+        }
+        TS_ASSERT_EQUALS(mesh_pair2.mStatisticsCounters[0], counters[0]);
+        TS_ASSERT_EQUALS(mesh_pair2.mStatisticsCounters[1], counters[1]);
+        TS_ASSERT_EQUALS(mesh_pair2.mNotInMesh.size(), counters[1]);
+        TS_ASSERT_EQUALS(Warnings::Instance()->GetNumWarnings(), 1u);
+        Warnings::Instance()->QuietDestroy();
+
+        mesh_pair2.SetUpBoxesOnCoarseMesh();
+        mesh_pair2.ComputeCoarseElementsForFineNodes(false);
+        TS_ASSERT_EQUALS(mesh_pair2.rGetCoarseElementsForFineNodes().size(), coarse_elements.size());
+        for (unsigned i=0; i<coarse_elements.size(); i++)
+        {
+            TS_ASSERT_EQUALS(mesh_pair2.rGetCoarseElementsForFineNodes()[i], coarse_elements[i]);
+        }
+
+        // Moving a node of the fine mesh changes its hash, so the mapping is recomputed
+        TS_ASSERT_DIFFERS(mesh_pair2.GetMappingCacheFileName("quad", 10u, false), "");
+        std::string file_name = mesh_pair2.GetMappingCacheFileName("quad", 10u, false);
+        fine_mesh.GetNode(0)->rGetModifiableLocation()[0] -= 0.01;
+        TS_ASSERT_DIFFERS(mesh_pair2.GetMappingCacheFileName("quad", 10u, false), file_name);
+
+        // A corrupt cache file is reported
+        if (PetscTools::AmMaster())
+        {
+            out_stream p_file = handler.OpenOutputFile(mesh_pair2.GetMappingCacheFileName("nodes", coarse_mesh.GetNumNodes(), false));
+            *p_file << "3 1\n";
+            p_file->close();
+        }
+        PetscTools::Barrier("TestMappingCache");
+        TS_ASSERT_THROWS_CONTAINS(mesh_pair2.ComputeFineElementsAndWeightsForCoarseNodes(false), "is corrupt");
+    }
+
+    void TestMeshHashIndependentOfProcessCount()
+    {
+        // The hash of the mesh on one process
+        unsigned long long sequential_hash;
+        PetscTools::IsolateProcesses(true);
+        {
+            TrianglesMeshReader<2,2> reader("mesh/test/data/square_128_elements");
+            TetrahedralMesh<2,2> mesh;
+            mesh.ConstructFromMeshReader(reader);
+            sequential_hash = FineCoarseMeshPair<2>::CalculateMeshHash(mesh);
+        }
+        PetscTools::IsolateProcesses(false);
+
+        // The same mesh replicated on every process
+        TrianglesMeshReader<2,2> reader("mesh/test/data/square_128_elements");
+        TetrahedralMesh<2,2> replicated_mesh;
+        replicated_mesh.ConstructFromMeshReader(reader);
+        TS_ASSERT_EQUALS(FineCoarseMeshPair<2>::CalculateMeshHash(replicated_mesh), sequential_hash);
+
+        // ... and distributed over the processes, which in parallel renumbers its nodes
+        TrianglesMeshReader<2,2> distributed_reader("mesh/test/data/square_128_elements");
+        DistributedTetrahedralMesh<2,2> distributed_mesh(DistributedTetrahedralMeshPartitionType::PARMETIS_LIBRARY);
+        distributed_mesh.ConstructFromMeshReader(distributed_reader);
+        TS_ASSERT_EQUALS(FineCoarseMeshPair<2>::CalculateMeshHash(distributed_mesh), sequential_hash);
+
+        // A different mesh has a different hash
+        TetrahedralMesh<2,2> other_mesh;
+        other_mesh.ConstructRegularSlabMesh(0.125, 1.0, 1.0);
+        TS_ASSERT_DIFFERS(FineCoarseMeshPair<2>::CalculateMeshHash(other_mesh), sequential_hash);
+    }
 };
 
 #endif /*TESTFINECOARSEMESHPAIR_HPP_*/
@@ -38,7 +38,11 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <cxxtest/TestSuite.h>
 
+#include <cmath>
+
 #include "AbstractTimeAdaptivityController.hpp"
+#include "ErrorEstimateTimeAdaptivityController.hpp"
+#include "PetscTools.hpp"
 
 #include "PetscSetupAndFinalize.hpp"
 
@@ -77,6 +81,68 @@ public:
         TS_ASSERT_EQUALS(controller.GetNextTimeStep(0.5,NULL), 0.2);
         TS_ASSERT_EQUALS(controller.GetNextTimeStep(1.5,NULL), 0.5);
         TS_ASSERT_EQUALS(controller.GetNextTimeStep(10 ,NULL), 1.0);
+        TS_ASSERT_EQUALS(controller.GetMinimumTimeStep(), 0.2);
+        TS_ASSERT_EQUALS(controller.GetMaximumTimeStep(), 1.0);
+    }
+
+    void TestErrorEstimateController()
+    {
+        TS_ASSERT_THROWS_THIS(ErrorEstimateTimeAdaptivityController(1e-4, 1.0, 0.0, 1e-4),
+                              "Initial time step has to be greater than zero");
+        TS_ASSERT_THROWS_THIS(ErrorEstimateTimeAdaptivityController(1e-4, 1.0, 1e-3, 0.0, 0.0),
+                              "Tolerances must be non-negative, and not both zero");
+
+        // Follow u(t) = exp(-t), for which the local error of a backward Euler step is
+        // about (dt^2/2)exp(-t), so the timestep should settle near 0.9*sqrt(2*tol*exp(t))
+        double tol = 1e-4;
+        ErrorEstimateTimeAdaptivityController controller(1e-4, 1.0, 1e-3, tol);
+        TS_ASSERT_THROWS_THIS(controller.SetSafetyFactor(1.5), "Safety factor must be in (0, 1]");
+        TS_ASSERT_THROWS_THIS(controller.SetStepChangeFactors(0.5, 0.9),
+                              "Step change factors must satisfy 0 < minimum <= 1 <= maximum");
+
+        Vec u = PetscTools::CreateAndSetVec(5, 1.0);
+        double t = 0.0;
+        double dt = controller.GetNextTimeStep(t, u);
+        TS_ASSERT_DELTA(dt, 1e-3, 1e-12);
+        TS_ASSERT_LESS_THAN(controller.GetLastErrorRatio(), 0.0);
+
+        // Asking again at the same time gives the same answer
+        TS_ASSERT_DELTA(controller.GetNextTimeStep(t, u), dt, 1e-12);
+
+        while (t < 1.0)
+        {
+            t += dt;
+            VecSet(u, exp(-t));
+            dt = controller.GetNextTimeStep(t, u);
+        }
+        TS_ASSERT_DELTA(dt, 0.9*sqrt(2.0*tol*exp(t)), 0.1*dt);
+        TS_ASSERT_DELTA(controller.GetLastErrorRatio(), 0.9*0.9, 0.1);
+
+        // A smaller tolerance gives a smaller step, and going back in time starts afresh
+        ErrorEstimateTimeAdaptivityController fine_controller(1e-4, 1.0, 1e-3, tol/100.0);
+        t = 0.0;
+        VecSet(u, 1.0);
+        double fine_dt = fine_controller.GetNextTimeStep(t, u);
+        while (t < 1.0)
+        {
+            t += fine_dt;
+            VecSet(u, exp(-t));
+            fine_dt = fine_controller.GetNextTimeStep(t, u);
+        }
+        TS_ASSERT_DELTA(fine_dt, dt/10.0, 0.1*fine_dt);
+
+        VecSet(u, 1.0);
+        TS_ASSERT_DELTA(controller.GetNextTimeStep(0.0, u), 1e-3, 1e-12);
+        TS_ASSERT_LESS_THAN(controller.GetLastErrorRatio(), 0.0);
+
+        // A constant solution has no error, so the step grows as fast as allowed, up to the maximum
+        for (unsigned i=1; i<20; i++)
+        {
+            dt = controller.GetNextTimeStep(0.01*i, u);
+        }
+        TS_ASSERT_DELTA(dt, 1.0, 1e-12);
+
+        PetscTools::Destroy(u);
     }
 };
 
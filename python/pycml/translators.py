@@ -1072,33 +1072,50 @@ class CellMLTranslator(object):
         
         If only_index is given, only generate tables using the given table index key.
         """
+        # Tables in a separate class get their memory from AbstractLookupTableCollection,
+        # which may share it between processes, in which case only one process fills it in.
+        use_collection_memory = getattr(self, 'separate_lut_class', False)
         # Don't use table lookups to generate the tables!
         self.use_lookup_tables = False
         # Allocate memory for tables
         for key, idx in self.doc.lookup_table_indexes.iteritems():
             if only_index is None or only_index == idx:
                 min, max, step, _ = self.lut_parameters(key)
+                num_tables = self.doc.lookup_tables_num_per_index[idx]
                 self.writeln(self.TYPE_CONST_UNSIGNED, '_table_size_', idx, self.EQ_ASSIGN,
                              self.lut_size_calculation(min, max, step), self.STMT_END)
-                self.writeln('_lookup_table_', idx, self.EQ_ASSIGN, 'new double[_table_size_', idx,
-                             '][', self.doc.lookup_tables_num_per_index[idx], ']', self.STMT_END)
+                if use_collection_memory:
+                    self.writeln('_lookup_table_', idx, self.EQ_ASSIGN, 'reinterpret_cast<double(*)[', num_tables,
+                                 ']>(AllocateTableMemory(', idx, ', _table_size_', idx, '*', num_tables, '))',
+                                 self.STMT_END)
+                else:
+                    self.writeln('_lookup_table_', idx, self.EQ_ASSIGN, 'new double[_table_size_', idx,
+                                 '][', num_tables, ']', self.STMT_END)
         # Generate each table in a separate loop
-        for expr in self.doc.lookup_tables:
-            var = expr.component.get_variable_by_name(expr.var)
-            key = (expr.min, expr.max, expr.step, var.get_source_variable(recurse=True))
-            idx = self.doc.lookup_table_indexes[key]
+        for key, idx in self.doc.lookup_table_indexes.iteritems():
             if only_index is not None and only_index != idx:
                 continue
-            min, max, step, _ = self.lut_parameters(key)
-            j = expr.table_name
-            self.writeln('for (unsigned i=0 ; i<_table_size_', idx, '; i++)')
-            self.open_block()
-            self.writeln(self.TYPE_CONST_DOUBLE, self.code_name(var), self.EQ_ASSIGN, min,
-                         ' + i*', step, self.STMT_END)
-            self.writeln(self.lut_access_code(idx, j, 'i'), self.EQ_ASSIGN, nl=False)
-            self.output_expr(expr, False)
-            self.writeln(self.STMT_END, indent=False)
-            self.close_block()
+            if use_collection_memory:
+                self.writeln('if (IsTableGenerator(', idx, '))')
+                self.open_block()
+            for expr in self.doc.lookup_tables:
+                var = expr.component.get_variable_by_name(expr.var)
+                if self.doc.lookup_table_indexes[(expr.min, expr.max, expr.step,
+                                                  var.get_source_variable(recurse=True))] != idx:
+                    continue
+                min, max, step, _ = self.lut_parameters(key)
+                j = expr.table_name
+                self.writeln('for (unsigned i=0 ; i<_table_size_', idx, '; i++)')
+                self.open_block()
+                self.writeln(self.TYPE_CONST_DOUBLE, self.code_name(var), self.EQ_ASSIGN, min,
+                             ' + i*', step, self.STMT_END)
+                self.writeln(self.lut_access_code(idx, j, 'i'), self.EQ_ASSIGN, nl=False)
+                self.output_expr(expr, False)
+                self.writeln(self.STMT_END, indent=False)
+                self.close_block()
+            if use_collection_memory:
+                self.close_block(blank_line=False)
+                self.writeln('TableGenerationFinished(', idx, ')', self.STMT_END)
         self.use_lookup_tables = True
 
     def output_lut_deletion(self, only_index=None):
@@ -1107,7 +1124,10 @@ class CellMLTranslator(object):
             if only_index is None or only_index == idx:
                 self.writeln('if (_lookup_table_', idx, ')')
                 self.open_block()
-                self.writeln('delete[] _lookup_table_', idx, self.STMT_END)
+                if getattr(self, 'separate_lut_class', False):
+                    self.writeln('FreeTableMemory(', idx, ')', self.STMT_END)
+                else:
+                    self.writeln('delete[] _lookup_table_', idx, self.STMT_END)
                 self.writeln('_lookup_table_', idx, self.EQ_ASSIGN, 'NULL', self.STMT_END)
                 self.close_block(blank_line=False)
 
@@ -1276,12 +1296,17 @@ class CellMLTranslator(object):
                 if self.config.options.check_lt_bounds:
                     self.writeln('// LCOV_EXCL_START', indent=False)
                     self.writeln('if (_oob_', idx, ')')
-                    if time_name is None:
-                        dump_state_args = 'rY'
+                    if getattr(self, 'writing_batch_class', False):
+                        # A batch has no single cell state to dump
+                        self.writeln('EXCEPTION("', self.var_display_name(key[-1]),
+                                     ' outside lookup table range");', indent_offset=1)
                     else:
-                        dump_state_args = 'rY, ' + time_name
-                    self.writeln('EXCEPTION(DumpState("', self.var_display_name(key[-1]),
-                                 ' outside lookup table range", ', dump_state_args,'));', indent_offset=1)
+                        if time_name is None:
+                            dump_state_args = 'rY'
+                        else:
+                            dump_state_args = 'rY, ' + time_name
+                        self.writeln('EXCEPTION(DumpState("', self.var_display_name(key[-1]),
+                                     ' outside lookup table range", ', dump_state_args,'));', indent_offset=1)
                     self.writeln('// LCOV_EXCL_STOP', indent=False)
                 self.output_table_index_generation_code(key, idx)
         self.writeln()
@@ -1374,6 +1399,9 @@ class CellMLToChasteTranslator(CellMLTranslator):
         # Some other default settings
         self.use_backward_euler = False
         self.include_serialization = False
+        # Whether to generate a batched solver class too, and whether we're writing it
+        self.generate_batch_class = False
+        self.writing_batch_class = False
         # Last method's access specification
         self._last_method_access = 'private'
         return super(CellMLToChasteTranslator, self).translate(*args, **kwargs)
@@ -1418,6 +1446,9 @@ class CellMLToChasteTranslator(CellMLTranslator):
         self.writeln('#include <cmath>')
         self.writeln('#include <cassert>')
         self.writeln('#include <memory>')
+        if self.generate_batch_class:
+            self.writeln('#include <typeinfo>')
+            self.writeln_hpp('#include "AbstractCardiacCellBatch.hpp"')
         if self.use_backward_euler:
             self.writeln_hpp('#include "AbstractBackwardEulerCardiacCell.hpp"')
             self.writeln('#include "CardiacNewtonSolver.hpp"')
@@ -1459,6 +1490,8 @@ class CellMLToChasteTranslator(CellMLTranslator):
         self.writeln('#include "HeartConfig.hpp"')
         self.writeln('#include "IsNan.hpp"')
         self.writeln('#include "MathsCustomFunctions.hpp"')
+        if self.options.vectorisable_maths:
+            self.writeln('#include "VectorisableMaths.hpp"')
         self.writeln()
         self.writeln_hpp()
         
@@ -1736,6 +1769,13 @@ class CellMLToChasteTranslator(CellMLTranslator):
             self.nonlinear_system_size = len(self.state_vars) - 1 - num_linear_odes
             nonlinear_entries = self.model.solver_info.xml_xpath(u'solver:jacobian/solver:entry/@var_j')
             self.nonlinear_system_vars = map(self.varobj, nonlinear_entries[:self.nonlinear_system_size])
+        # Batched solvers are only generated for forward Euler and Rush-Larsen cells
+        self.generate_batch_class = (getattr(self.options, 'batch', False)
+                                     and type(self) is CellMLToChasteTranslator
+                                     and not (self.use_backward_euler or self.options.grl1 or self.options.grl2)
+                                     and not (self.use_data_clamp or self.use_protocol)
+                                     and (not self.use_lookup_tables or (self.separate_lut_class and self.row_lookup_method))
+                                     and self.state_vars and self.v_index != -1)
         # Start output
         self.output_includes()
         
@@ -2357,7 +2397,8 @@ class CellMLToChasteTranslator(CellMLTranslator):
                     value = check_bound(low_prop, '<', var, value)
                     value = check_bound(high_prop, '>', var, value)
                 #2116 - use supplied fixed voltage if we're clamping
-                if var is self.v_variable:
+                # (a batch already holds the fixed voltage in rY)
+                if var is self.v_variable and not self.writing_batch_class:
                     value = '(mSetVoltageDerivativeToZero ? this->mFixedVoltage : %s)' % value
                 self.writeln(self.TYPE_DOUBLE, self.code_name(var),
                              self.EQ_ASSIGN, value, self.STMT_END)
@@ -2373,12 +2414,21 @@ class CellMLToChasteTranslator(CellMLTranslator):
         
         The modifier function takes 2 parameters: the current value of the variable,
         and the current time.  It returns a modified value for the variable.
+        Modifiers are skipped altogether while they are all DummyModifiers, and
+        Apply() avoids a virtual call for the common kinds of modifier.
         """
-        return ('mp_' + var.oxmeta_name + '_modifier->Calc(' +
-                current_value + ', ' + self.code_name(self.free_vars[0]) + ')')
+        return ('(this->mModifiersActive ? mp_' + var.oxmeta_name + '_modifier->Apply(' +
+                current_value + ', ' + self.code_name(self.free_vars[0]) + ') : ' +
+                current_value + ')')
     
     def vector_index(self, vector, i):
-        """Return code for accessing the i'th index of vector."""
+        """Return code for accessing the i'th index of vector.
+        
+        In a batch class, vectors hold entry i of every cell in turn (see
+        AbstractCardiacCellBatch), and we're within a loop over cells.
+        """
+        if self.writing_batch_class:
+            return vector + '[' + str(i) + '*mNumCells + cell]'
         return vector + '[' + str(i) + ']'
     
     def vector_create(self, vector, size):
@@ -2403,7 +2453,10 @@ class CellMLToChasteTranslator(CellMLTranslator):
         """Return code for getting Chaste's stimulus current."""
         expr = self.doc._cml_config.i_stim_var
         output = self.code_name(expr) + self.EQ_ASSIGN
-        get_stim = 'GetIntracellularAreaStimulus(' + self.code_name(self.free_vars[0]) + ')'
+        if self.writing_batch_class:
+            get_stim = 'rStimulus[cell]'
+        else:
+            get_stim = 'GetIntracellularAreaStimulus(' + self.code_name(self.free_vars[0]) + ')'
         if self.doc._cml_config.i_stim_negated:
             get_stim = '-' + get_stim
         return output + get_stim + self.STMT_END
@@ -2916,6 +2969,139 @@ class CellMLToChasteTranslator(CellMLTranslator):
                 self.writeln('rY[', i, '] += mDt * rDY[', i, '];')
         self.close_block()
     
+    def output_batch_class(self):
+        """Output a class for solving many cells of this model together.
+        
+        The class derives from AbstractCardiacCellBatch, which stores the state
+        variables and parameters of a batch of cells with one array per
+        variable.  We generate:
+         * IsModelCompatible  accepts only cells of exactly our class, without active modifiers
+         * EvaluateYDerivativesBatch  computes the derivatives of every cell in one loop
+        and for Rush-Larsen cells also:
+         * IsSolverCompatible  only requires the same time step, since the cells solve themselves
+         * AdvanceBatch  does the Rush-Larsen step of each cell, as the cell itself would
+        Modifiers are not applied, and parameters & the stimulus are read from the batch.
+        """
+        cell_class_name = self.class_name
+        self.class_name = cell_class_name + 'Batch'
+        use_modifiers = self.use_modifiers
+        self.use_modifiers = False
+        self.writing_batch_class = True
+        self._last_method_access = 'private'
+        self.output_doxygen('Solves many ', cell_class_name, ' cells together; see AbstractCardiacCellBatch.',
+                            subsidiary=True)
+        self.writeln_hpp('class ', self.class_name, ' : public AbstractCardiacCellBatch')
+        self.open_block(subsidiary=True)
+        # Constructor
+        self.output_method_start(self.class_name, ['unsigned maxBatchSize'], '', access='public', defaults=['256u'])
+        self.writeln('    : AbstractCardiacCellBatch(', len(self.state_vars), ', ', self.unsigned_v_index,
+                     ', maxBatchSize, ', len(self.cell_parameters), ')')
+        self.open_block()
+        self.close_block()
+        # Compatibility checks
+        self.set_access('protected')
+        self.writeln_hpp('bool IsModelCompatible(AbstractCardiacCellInterface* pCell) const;')
+        self.writeln('bool ', self.class_name, '::IsModelCompatible(AbstractCardiacCellInterface* pCell) const')
+        self.open_block()
+        self.output_comment('Subclasses may change the model, so only accept the class itself')
+        if use_modifiers:
+            self.writeln('return typeid(*pCell) == typeid(', cell_class_name, ')')
+            self.writeln('&& !static_cast<', cell_class_name, '*>(pCell)->AreModifiersActive();', indent_offset=2)
+        else:
+            self.writeln('return typeid(*pCell) == typeid(', cell_class_name, ');')
+        self.close_block()
+        if self.options.rush_larsen:
+            self.writeln_hpp('bool IsSolverCompatible(AbstractCardiacCellInterface* pCell) const;')
+            self.writeln('bool ', self.class_name, '::IsSolverCompatible(AbstractCardiacCellInterface* pCell) const')
+            self.open_block()
+            self.writeln('return HasSameTimestep(pCell);')
+            self.close_block()
+        # Derivatives
+        self.output_method_start('EvaluateYDerivativesBatch',
+                                 [self.TYPE_DOUBLE + self.code_name(self.free_vars[0]),
+                                  'const ' + self.TYPE_VECTOR_REF + 'rY',
+                                  'const ' + self.TYPE_VECTOR_REF + 'rStimulus',
+                                  self.TYPE_VECTOR_REF + 'rDY'],
+                                 'void')
+        self.open_block()
+        self.writeln('for (unsigned cell=0; cell<mNumCells; cell++)')
+        self.open_block()
+        self.output_derivative_calculations(self.state_vars)
+        for i, var in enumerate(self.state_vars):
+            self.writeln(self.vector_index('rDY', i), self.EQ_ASSIGN, self.code_name(var, True), self.STMT_END)
+        self.close_block(blank_line=False)
+        self.close_block()
+        if self.options.rush_larsen:
+            self.output_batch_rush_larsen_step()
+        # End class
+        self.set_indent(offset=-1)
+        self.writeln_hpp('};\n')
+        self.writing_batch_class = False
+        self.use_modifiers = use_modifiers
+        if self.dynamically_loadable:
+            # Write the C function to create batches for this cell model
+            self.writeln('extern "C"')
+            self.open_block()
+            self.writeln('AbstractCardiacCellBatch* MakeCardiacCellBatch(unsigned maxBatchSize)')
+            self.open_block()
+            self.writeln('return new ', self.class_name, '(maxBatchSize);')
+            self.close_block()
+            self.close_block()
+        self.class_name = cell_class_name
+
+    def output_batch_rush_larsen_step(self):
+        """Output the AdvanceBatch method for a Rush-Larsen batch class.
+        
+        This updates the state of each cell in turn just as
+        EvaluateEquations, UpdateTransmembranePotential and
+        ComputeOneStepExceptVoltage would for the cell itself.
+        """
+        rl_vars = self.doc._cml_rush_larsen
+        self.output_method_start('AdvanceBatch',
+                                 [self.TYPE_DOUBLE + self.code_name(self.free_vars[0]), 'double dt'],
+                                 'void')
+        self.open_block()
+        self.writeln(self.TYPE_VECTOR_REF, 'rY = mStateVariables;')
+        if self.use_chaste_stimulus:
+            self.writeln('const ', self.TYPE_VECTOR_REF, 'rStimulus = mStimulus;')
+        self.writeln('for (unsigned cell=0; cell<mNumCells; cell++)')
+        self.open_block()
+        normal_vars = [v for v in self.state_vars if not v in rl_vars]
+        nodes, table_nodes = set(), set()
+        for _, alpha_or_tau, beta_or_inf, _ in rl_vars.itervalues():
+            table_nodes.add(alpha_or_tau)
+            nodes.update(self._vars_in(alpha_or_tau))
+            table_nodes.add(beta_or_inf)
+            nodes.update(self._vars_in(beta_or_inf))
+        self.output_derivative_calculations(normal_vars, False, nodes, table_nodes)
+        # All the right-hand sides use the state read above, so we can update rY as we go
+        for i, var in enumerate(self.state_vars):
+            y = self.vector_index('rY', i)
+            if var in rl_vars:
+                conv = rl_vars[var][3] or ''
+                if conv: conv = '*' + str(conv)
+                self.open_block()
+                self.writeln(self.TYPE_CONST_DOUBLE, 'alpha_or_tau', self.EQ_ASSIGN, nl=False)
+                self.output_expr(rl_vars[var][1], False)
+                self.writeln(self.STMT_END, indent=False)
+                self.writeln(self.TYPE_CONST_DOUBLE, 'beta_or_inf', self.EQ_ASSIGN, nl=False)
+                self.output_expr(rl_vars[var][2], False)
+                self.writeln(self.STMT_END, indent=False)
+                if rl_vars[var][0] == 'ab':
+                    # Alpha & beta formulation
+                    self.writeln(self.TYPE_CONST_DOUBLE, 'tau_inv = alpha_or_tau + beta_or_inf;')
+                    self.writeln(self.TYPE_CONST_DOUBLE, 'y_inf = alpha_or_tau / tau_inv;')
+                    self.writeln(y, ' = y_inf + (', y, ' - y_inf)*exp(-dt', conv, '*tau_inv);')
+                else:
+                    # Tau & inf formulation
+                    self.writeln(y, ' = beta_or_inf + (', y, ' - beta_or_inf)*exp(-dt', conv, '/alpha_or_tau);')
+                self.close_block(blank_line=False)
+            else:
+                # Forward Euler update, including V (whose derivative is zero if clamped)
+                self.writeln(y, ' += dt * ', self.code_name(var, True), self.STMT_END)
+        self.close_block(blank_line=False)
+        self.close_block()
+
     #Megan E. Marsh, Raymond J. Spiteri 
     #Numerical Simulation Laboratory 
     #University of Saskatchewan 
@@ -3361,6 +3547,8 @@ class CellMLToChasteTranslator(CellMLTranslator):
             self.writeln('return new ', self.class_name, '(pSolver, pStimulus);')
             self.close_block()
             self.close_block()
+        if self.generate_batch_class:
+            self.output_batch_class()
         # End file
         self.writeln_hpp('#endif // ', self.include_guard)
         return
@@ -3394,14 +3582,23 @@ class CellMLToChasteTranslator(CellMLTranslator):
                 self.write(prefix + varname)
         return
 
+    # Replacements for C++ maths functions when generating code with --vectorisable-maths;
+    # see VectorisableMaths.hpp.
+    vectorisable_function_map = {'exp': 'VecExp', 'log': 'VecLog', 'pow': 'VecPow', 'tanh': 'VecTanh'}
+
     def output_function(self, func_name, args, *posargs, **kwargs):
         """Override base class method for special case of abs with 2 arguments.
         
         This comes from Maple's Jacobians, and should generate signum of the second argument.
+        Also replaces calls to transcendental functions by the VectorisableMaths.hpp wrappers
+        if the --vectorisable-maths option is given.
         """
         args = list(args)
         if func_name == 'fabs' and len(args) == 2:
             super(CellMLToChasteTranslator, self).output_function('Signum', [args[1]], *posargs, **kwargs)
+        elif self.options.vectorisable_maths and func_name in self.vectorisable_function_map:
+            super(CellMLToChasteTranslator, self).output_function(self.vectorisable_function_map[func_name],
+                                                                  args, *posargs, **kwargs)
         else:
             super(CellMLToChasteTranslator, self).output_function(func_name, args, *posargs, **kwargs)
     
@@ -3648,11 +3845,12 @@ class CellMLToCvodeTranslator(CellMLToChasteTranslator):
         self.include_serialization = True
         self.use_backward_euler = False
         
+        self.use_analytic_jacobian = (self.model.get_option('maple_output') and hasattr(self.model.solver_info, u'jacobian'))
         if self.use_data_clamp:
-            self.use_analytic_jacobian = False # Todo - data current not included in analytic jacobian yet.
+            # The analytic Jacobian doesn't include the data clamp current, so the base class
+            # switches to a numerical Jacobian while the clamp is turned on.
             self.output_includes(base_class='AbstractCvodeCellWithDataClamp')
         else:
-            self.use_analytic_jacobian = (self.model.get_option('maple_output') and hasattr(self.model.solver_info, u'jacobian'))
             self.output_includes(base_class='AbstractCvodeCell')
         
         # Separate class for lookup tables?
@@ -6362,6 +6560,36 @@ class ConfigurationStore(object):
                 annotate(var)
             DEBUG('translate', "+++ Exposed all variables")
     
+    def fix_parameters(self):
+        """Fix the values of any parameters given with --fix-parameter.
+
+        Each parameter becomes an ordinary constant with the given value, rather than
+        one that can be changed at run-time, so that partial evaluation (if done) can
+        fold it into the expressions that use it.
+        """
+        for setting in self.options.fix_parameter:
+            parts = setting.split('=')
+            if len(parts) != 2:
+                raise ConfigurationError('Fixed parameters must be given as NAME=VALUE, not "' + setting + '"')
+            name, value = parts[0].strip(), parts[1].strip()
+            try:
+                value = float(value)
+            except ValueError:
+                raise ConfigurationError('The value "' + value + '" given for fixed parameter ' + name + ' is not a number')
+            if ',' in name:
+                var = self._find_variable(unicode(name))
+            else:
+                var = self.doc.model.get_variable_by_oxmeta_name(name, throw=False)
+            if not var:
+                raise ConfigurationError('No variable ' + name + ' to fix the value of')
+            if var.get_type() != VarTypes.Constant or var in [self.V_variable, self.Cm_variable, self.i_stim_var]:
+                raise ConfigurationError('The variable ' + name + ' is not a parameter that can be fixed')
+            var.initial_value = unicode(repr(value))
+            var.set_is_modifiable_parameter(False)
+            var.set_pe_keep(False)
+            DEBUG('translate', "+++ Fixed", var.fullname(), "=", value)
+        return
+
     def annotate_metadata_for_pe(self):
         "Annotate all vars tagged with metadata so PE doesn't remove them."
         for var in self.metadata_vars:
@@ -6586,6 +6814,10 @@ def get_options(args, default_options=None):
     group.add_option('--no-timestamp',
                      action='store_true', default=False,
                      help="don't add a timestamp comment to generated files")
+    group.add_option('--vectorisable-maths',
+                     action='store_true', default=False,
+                     help="call the wrappers in VectorisableMaths.hpp instead of exp, log, pow and tanh,"
+                     " so that a SIMD maths library (SLEEF) can be used if Chaste is built with it")
     parser.add_option_group(group)
     # Options specific to Maple output
     group = optparse.OptionGroup(parser, 'Maple options', "Options specific to Maple code output")
@@ -6609,6 +6841,11 @@ def get_options(args, default_options=None):
                      action='store_true', default=False,
                      help="add code to allow the model to be compiled to a shared library and dynamically loaded"
                      " (only works if -t Chaste is used)")
+    group.add_option('--batch',
+                     action='store_true', default=False,
+                     help="also generate a class deriving from AbstractCardiacCellBatch, for solving many cells"
+                     " of the model together.  Only done for forward Euler and Rush-Larsen cells"
+                     " (only works if -t Chaste is used)")
     group.add_option('--use-chaste-stimulus',
                      action='store_true', default=False,
                      help="when generating Chaste code, use Chaste's stimulus rather than that defined in the model")
@@ -6660,6 +6897,10 @@ def get_options(args, default_options=None):
     group.add_option('--expose-named-parameters',
                      action='store_true', default=False,
                      help="expose all constant variables with 'name' annotations for access as model parameters")
+    group.add_option('--fix-parameter', action='append', default=[], metavar='NAME=VALUE',
+                     help="fix the value of a parameter (given by oxmeta name, or as component,variable),"
+                     " so that it is not modifiable at run-time and partial evaluation can fold it into"
+                     " the model.  May be given multiple times.")
     parser.add_option_group(group)
     # Settings for lookup tables
     group = optparse.OptionGroup(parser, 'Lookup tables options', "Options specific to the lookup tables optimisation")
@@ -6820,6 +7061,8 @@ def run():
         DEBUG('translate', "+++ Annotated variables")
     # Deal with the 'expose' options
     config.expose_variables()
+    # Specialise the model for any parameters with fixed values
+    config.fix_parameters()
 
     class_name = options.class_name
     if not class_name:
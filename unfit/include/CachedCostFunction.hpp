@@ -0,0 +1,243 @@
+// Unfit: Data fitting and optimization software
+//
+// Copyright (C) 2012- Dr Martin Buist & Dr Alberto Corrias
+// Contacts: martin.buist _at_ nus.edu.sg; alberto _at_ nus.edu.sg
+//
+// See the 'Contributors' file for a list of those who have contributed
+// to this work.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+#ifndef UNFIT_INCLUDE_CACHEDCOSTFUNCTION_HPP_
+#define UNFIT_INCLUDE_CACHEDCOSTFUNCTION_HPP_
+
+#include <cmath>
+#include <cstddef>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "GenericCostFunction.hpp"
+
+namespace Unfit
+{
+/**
+ * A cost function that wraps another cost function and remembers the
+ * residuals it has already computed. Optimizers such as NelderMead (shrink
+ * steps, restarts) and LevenbergMarquardt (finite difference Jacobians around
+ * an unchanged point) often ask for the same, or almost the same, parameter
+ * vector more than once; when each evaluation is a full simulation these
+ * repeats are worth avoiding.
+ *
+ * Parameter vectors are matched after quantising each entry to a given number
+ * of significant bits, so values that differ only in the last few bits of
+ * their mantissa share a cache entry. The cache can be saved to and loaded
+ * from a file, so that it survives restarts of a fitting job.
+ *
+ * Lookups and insertions are protected by a mutex, so the wrapper may be used
+ * with options.SetUseMultiThreaded(true) provided the wrapped cost function
+ * is itself thread safe. Concurrent requests for the same new point may both
+ * evaluate it.
+ *
+ * Intended use:
+ *   CachedCostFunction cached(my_cost_function);
+ *   cached.LoadCache("fit.cache");  // if resuming
+ *   optimizer.FindMin(cached, coordinates);
+ *   cached.SaveCache("fit.cache");
+ */
+class CachedCostFunction : public GenericCostFunction
+{
+ public:
+  /**
+   * Constructor.
+   *
+   * \param cost_function The cost function whose results are cached. It must
+   *        outlive this object.
+   * \param significant_bits The number of bits of each parameter's mantissa
+   *        that are used to identify it (at most 52). The default of 40 treats
+   *        parameters that agree to about 12 significant figures as equal.
+   */
+  explicit CachedCostFunction(GenericCostFunction &cost_function,
+      unsigned significant_bits = 40)
+    : cost_function_(cost_function),
+      significant_bits_(significant_bits > 52u ? 52u : significant_bits),
+      hits_(0),
+      misses_(0)
+  {}
+
+  /**
+   * Returns the cached residuals for x if there are any, otherwise evaluates
+   * the wrapped cost function and caches its result.
+   *
+   * \param x A vector containing the current estimates of the unknown model
+   *        parameters
+   * \return A vector of residuals, r[] = data[] - model[].
+   */
+  std::vector<double> operator()(const std::vector<double> &x) override
+  {
+    const std::vector<long long> key = Quantise(x);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = cache_.find(key);
+      if (it != cache_.end()) {
+        ++hits_;
+        return it->second.second;
+      }
+      ++misses_;
+    }
+    std::vector<double> residuals = cost_function_(x);
+    std::lock_guard<std::mutex> lock(mutex_);
+    cache_[key] = std::make_pair(x, residuals);
+    return residuals;
+  }
+
+  /**
+   * Empties the cache and resets the hit and miss counts.
+   */
+  void ClearCache()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cache_.clear();
+    hits_ = 0;
+    misses_ = 0;
+  }
+
+  /**
+   * \return The number of distinct parameter vectors in the cache
+   */
+  std::size_t GetCacheSize() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cache_.size();
+  }
+
+  /**
+   * \return The number of evaluations that were answered from the cache
+   */
+  std::size_t GetNumberOfHits() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+  }
+
+  /**
+   * \return The number of evaluations that called the wrapped cost function
+   */
+  std::size_t GetNumberOfMisses() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+  }
+
+  /**
+   * Writes the cache to a text file, one entry per line, as the number of
+   * parameters, the parameters, the number of residuals and the residuals.
+   * Values are written at full precision.
+   *
+   * \param filename The file to write
+   * \return True if the file could be written, otherwise false
+   */
+  bool SaveCache(const std::string &filename) const
+  {
+    std::ofstream file(filename);
+    if (!file) return false;
+    file << std::setprecision(std::numeric_limits<double>::max_digits10);
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto &entry : cache_) {
+      const std::vector<double> &x = entry.second.first;
+      const std::vector<double> &r = entry.second.second;
+      file << x.size();
+      for (double value : x) file << " " << value;
+      file << " " << r.size();
+      for (double value : r) file << " " << value;
+      file << "\n";
+    }
+    return static_cast<bool>(file);
+  }
+
+  /**
+   * Adds the entries in a file written by SaveCache to the cache. Entries are
+   * re-keyed with this object's number of significant bits.
+   *
+   * \param filename The file to read
+   * \return True if the file could be read, otherwise false
+   */
+  bool LoadCache(const std::string &filename)
+  {
+    std::ifstream file(filename);
+    if (!file) return false;
+    std::size_t num_parameters;
+    while (file >> num_parameters) {
+      std::vector<double> x(num_parameters);
+      for (auto &value : x) file >> value;
+      std::size_t num_residuals;
+      file >> num_residuals;
+      std::vector<double> r(num_residuals);
+      for (auto &value : r) file >> value;
+      if (!file) return false;
+      std::lock_guard<std::mutex> lock(mutex_);
+      cache_[Quantise(x)] = std::make_pair(x, r);
+    }
+    return file.eof();
+  }
+
+ private:
+  /**
+   * Quantises a parameter vector into a cache key: each entry becomes its
+   * binary exponent and its mantissa rounded to significant_bits_ bits.
+   * Non-finite entries are kept exactly via a special exponent.
+   *
+   * \param x The parameter vector
+   * \return The cache key
+   */
+  std::vector<long long> Quantise(const std::vector<double> &x) const
+  {
+    std::vector<long long> key;
+    key.reserve(2 * x.size());
+    for (double value : x) {
+      if (!std::isfinite(value)) {
+        key.push_back(std::numeric_limits<long long>::max());
+        key.push_back(std::isnan(value) ? 0 : (value > 0 ? 1 : -1));
+        continue;
+      }
+      int exponent = 0;
+      const double mantissa = std::frexp(value, &exponent);
+      key.push_back(value == 0.0 ? 0 : exponent);
+      key.push_back(std::llround(std::ldexp(mantissa,
+          static_cast<int>(significant_bits_))));
+    }
+    return key;
+  }
+
+  /** The cost function whose results are cached */
+  GenericCostFunction &cost_function_;
+  /** The number of mantissa bits used to identify each parameter */
+  unsigned significant_bits_;
+  /** The cached parameter vectors and residuals, by quantised key */
+  std::map<std::vector<long long>,
+      std::pair<std::vector<double>, std::vector<double>>> cache_;
+  /** Number of evaluations answered from the cache */
+  std::size_t hits_;
+  /** Number of evaluations passed on to the wrapped cost function */
+  std::size_t misses_;
+  /** Protects the cache and the counters */
+  mutable std::mutex mutex_;
+};
+
+}  // namespace Unfit
+
+#endif
@@ -32,6 +32,15 @@ namespace Unfit
  * methods. This means that any methods defined here must be implemented in
  * a derived class. It also means that this class cannot be instantiated
  * directly.
+ *
+ * If the population based optimizers (DifferentialEvolution, GeneticAlgorithm,
+ * ParticleSwarm) are run with options.SetUseMultiThreaded(true), operator() is
+ * called concurrently for different population members. It must then be safe
+ * to call from several threads at once: any per-evaluation state (e.g. the cell
+ * model and ODE solver used for a paced simulation) should be created inside
+ * operator() rather than shared through member variables, and any random
+ * numbers should come from the per-member engines of the optimizer rather than
+ * from a shared generator.
  */
 class GenericCostFunction
 {
@@ -0,0 +1,245 @@
+// Unfit: Data fitting and optimization software
+//
+// Copyright (C) 2012- Dr Martin Buist & Dr Alberto Corrias
+// Contacts: martin.buist _at_ nus.edu.sg; alberto _at_ nus.edu.sg
+//
+// See the 'Contributors' file for a list of those who have contributed
+// to this work.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+#ifndef UNFIT_INCLUDE_MATRIXKERNELS_HPP_
+#define UNFIT_INCLUDE_MATRIXKERNELS_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include "Matrix.hpp"
+
+namespace Unfit
+{
+/**
+ * Calculates (J^T)J for a Jacobian J stored row-wise (one row per residual,
+ * one column per parameter), working directly on the matrix storage. The
+ * rows of J are processed in blocks, and within a block each row contributes
+ * a rank one update to the upper triangle of the result, so both J and the
+ * result are read contiguously. The lower triangle is filled in at the end.
+ *
+ * Intended use:
+ *   auto jtj = BlockedTransposeProduct(jacobian);
+ *
+ * \param jacobian The matrix J (num_residuals x num_parameters)
+ * \param block_size (optional) The number of rows of J per block
+ * \return The matrix (J^T)J (num_parameters x num_parameters)
+ */
+inline Matrix BlockedTransposeProduct(const Matrix &jacobian,
+    std::size_t block_size = 64)
+{
+  const std::size_t num_rows = jacobian.GetNumberOfRows();
+  const std::size_t n = jacobian.GetNumberOfColumns();
+  Matrix result(n, n, 0.0);
+  if (block_size == 0) block_size = 1;
+  const double *j = jacobian.values_.data();
+  double *r = result.values_.data();
+  for (std::size_t block = 0; block < num_rows; block += block_size) {
+    const std::size_t block_end = std::min(block + block_size, num_rows);
+    for (std::size_t i = 0; i < n; ++i) {
+      double *r_row = r + i * n;
+      for (std::size_t row = block; row < block_end; ++row) {
+        const double *j_row = j + row * n;
+        const double j_ri = j_row[i];
+        if (j_ri == 0.0) continue;
+        for (std::size_t k = i; k < n; ++k) {
+          r_row[k] += j_ri * j_row[k];
+        }
+      }
+    }
+  }
+  for (std::size_t i = 0; i < n; ++i) {
+    for (std::size_t k = 0; k < i; ++k) {
+      r[i * n + k] = r[k * n + i];
+    }
+  }
+  return result;
+}
+
+/**
+ * Solves Ax = b for a symmetric positive definite matrix A (such as the
+ * damped (J^T)J + lambda*I of a Levenberg-Marquardt step) by a Cholesky
+ * factorisation A = (L)(L^T) followed by forward and back substitution.
+ * Only the lower triangle of A is read.
+ *
+ * Intended use:
+ *   auto rc = CholeskySolve(x, a, b);
+ *
+ * \param x On output, contains the solution vector
+ * \param a A square, symmetric, positive definite matrix of size (n x n)
+ * \param b The right-hand-side vector
+ * \return an error code, 0 means success, 1 signifies invalid input,
+ *         2 signifies that the matrix is not positive definite
+ */
+inline int CholeskySolve(std::vector<double> &x, const Matrix &a,
+    const std::vector<double> &b)
+{
+  const std::size_t n = a.GetNumberOfRows();
+  if (n == 0 || a.GetNumberOfColumns() != n || b.size() != n) return 1;
+
+  // Factorise, storing L row-wise
+  std::vector<double> l(n * n, 0.0);
+  const double *a_values = a.values_.data();
+  for (std::size_t i = 0; i < n; ++i) {
+    for (std::size_t k = 0; k <= i; ++k) {
+      double sum = a_values[i * n + k];
+      for (std::size_t m = 0; m < k; ++m) {
+        sum -= l[i * n + m] * l[k * n + m];
+      }
+      if (i == k) {
+        if (!(sum > 0.0)) return 2;
+        l[i * n + i] = std::sqrt(sum);
+      }
+      else {
+        l[i * n + k] = sum / l[k * n + k];
+      }
+    }
+  }
+
+  // Forward substitution: L y = b
+  x.assign(n, 0.0);
+  for (std::size_t i = 0; i < n; ++i) {
+    double sum = b[i];
+    for (std::size_t m = 0; m < i; ++m) sum -= l[i * n + m] * x[m];
+    x[i] = sum / l[i * n + i];
+  }
+  // Back substitution: L^T x = y
+  for (std::size_t i = n; i-- > 0;) {
+    double sum = x[i];
+    for (std::size_t m = i + 1; m < n; ++m) sum -= l[m * n + i] * x[m];
+    x[i] = sum / l[i * n + i];
+  }
+  return 0;
+}
+
+/**
+ * A sparse matrix in compressed row storage, intended for Jacobians of
+ * problems where each parameter only affects a few of the residuals. Rows are
+ * appended one at a time, giving the columns and values of their non-zero
+ * entries.
+ */
+class SparseMatrix
+{
+ public:
+  /**
+   * Constructor: Creates an empty matrix with the given number of columns.
+   *
+   * \param num_cols The number of columns (e.g. parameters)
+   */
+  explicit SparseMatrix(std::size_t num_cols)
+    : number_of_columns_(num_cols),
+      row_starts_(1, 0)
+  {}
+
+  /**
+   * Appends a row to the matrix. Columns outside the matrix are ignored.
+   *
+   * \param cols The column indices of the non-zero entries in the row
+   * \param vals The values of the non-zero entries in the row
+   */
+  void AddRow(const std::vector<std::size_t> &cols,
+      const std::vector<double> &vals)
+  {
+    const std::size_t num_entries = std::min(cols.size(), vals.size());
+    for (std::size_t e = 0; e < num_entries; ++e) {
+      if (cols[e] < number_of_columns_) {
+        columns_.push_back(cols[e]);
+        values_.push_back(vals[e]);
+      }
+    }
+    row_starts_.push_back(columns_.size());
+  }
+
+  /**
+   * \return the number of rows added so far
+   */
+  std::size_t GetNumberOfRows() const noexcept
+  {
+    return row_starts_.size() - 1;
+  }
+
+  /**
+   * \return the number of columns
+   */
+  std::size_t GetNumberOfColumns() const noexcept
+  {
+    return number_of_columns_;
+  }
+
+  /**
+   * Calculates (J^T)J, where J is this matrix, as a dense matrix. The cost is
+   * proportional to the sum over rows of the square of the number of non-zero
+   * entries, rather than to num_rows * num_cols^2.
+   *
+   * \return The matrix (J^T)J (num_cols x num_cols)
+   */
+  Matrix TransposeProduct() const
+  {
+    const std::size_t n = number_of_columns_;
+    Matrix result(n, n, 0.0);
+    double *r = result.values_.data();
+    for (std::size_t row = 0; row + 1 < row_starts_.size(); ++row) {
+      for (std::size_t e = row_starts_[row]; e < row_starts_[row + 1]; ++e) {
+        const std::size_t i = columns_[e];
+        for (std::size_t f = row_starts_[row]; f < row_starts_[row + 1]; ++f) {
+          r[i * n + columns_[f]] += values_[e] * values_[f];
+        }
+      }
+    }
+    return result;
+  }
+
+  /**
+   * Calculates (J^T)v, where J is this matrix, e.g. the gradient (J^T)r of a
+   * sum of squared residuals r.
+   *
+   * \param v A vector with one entry per row
+   * \return The vector (J^T)v, with one entry per column, or an empty vector
+   *         if v is the wrong size
+   */
+  std::vector<double> TransposeInnerProduct(const std::vector<double> &v) const
+  {
+    if (v.size() != GetNumberOfRows()) return std::vector<double>();
+    std::vector<double> result(number_of_columns_, 0.0);
+    for (std::size_t row = 0; row < v.size(); ++row) {
+      for (std::size_t e = row_starts_[row]; e < row_starts_[row + 1]; ++e) {
+        result[columns_[e]] += values_[e] * v[row];
+      }
+    }
+    return result;
+  }
+
+ private:
+  /** Number of columns in the matrix */
+  std::size_t number_of_columns_;
+  /** Index into columns_ and values_ of the first entry of each row, plus
+   * one past the end */
+  std::vector<std::size_t> row_starts_;
+  /** Column index of each non-zero entry */
+  std::vector<std::size_t> columns_;
+  /** Value of each non-zero entry */
+  std::vector<double> values_;
+};
+
+}  // namespace Unfit
+
+#endif
@@ -22,10 +22,12 @@
 #ifndef UNFIT_HPP_
 #define UNFIT_HPP_
 
+#include "CachedCostFunction.hpp"
 #include "DataFileReader.hpp"
 #include "DifferentialEvolution.hpp"
 #include "GeneticAlgorithm.hpp"
 #include "LevenbergMarquardt.hpp"
+#include "MatrixKernels.hpp"
 #include "NelderMead.hpp"
 #include "ParticleSwarm.hpp"
 #include "SimulatedAnnealing.hpp"